@@ -44,6 +44,7 @@
 #include <linux/delay.h>
 #include <linux/uaccess.h>
 #include <linux/gpio.h>
+#include <linux/poll.h>
 #ifdef CONFIG_COMPAT
 #include <linux/compat.h>
 #endif
@@ -103,6 +104,8 @@ static irqreturn_t i2c_irq_handler(int irq, void *dev_id)
 
 	i2c_disable_irq(nfc_dev);
 	wake_up(&nfc_dev->read_wq);
+	if (READ_ONCE(i2c_dev->rx_ahead))
+		queue_work(system_highpri_wq, &i2c_dev->rx_work);
 
 	return IRQ_HANDLED;
 }
@@ -180,8 +183,11 @@ int i2c_read(struct nfc_dev *nfc_dev, char *buf, size_t count, int timeout)
 	}
 
 	memset(buf, 0x00, count);
-	/* Read data */
-	ret = i2c_master_recv(nfc_dev->i2c_dev.client, buf, count);
+	/* Read data, read_kbuf is kmalloc'ed and safe to hand to the DMA engine */
+	if (buf == nfc_dev->read_kbuf)
+		ret = i2c_master_recv_dmasafe(i2c_dev->client, buf, count);
+	else
+		ret = i2c_master_recv(i2c_dev->client, buf, count);
 	NFCLOG_IPC(nfc_dev, false, "%s of %d bytes, ret %d", __func__, count,
 								ret);
 	if (ret <= 0) {
@@ -267,6 +273,151 @@ int i2c_write(struct nfc_dev *nfc_dev, const char *buf, size_t count,
 	return ret;
 }
 
+/**
+ * i2c_rx_work() - fetch pending NCI frames into the read-ahead ring
+ * @work:	rx_work of the i2c device
+ *
+ * Queued from the IRQ handler while read-ahead is active. Frames are
+ * read header first and then payload, for as long as the NFCC keeps IRQ
+ * asserted. If the ring cannot take a maximum sized frame, IRQ is left
+ * disabled so the NFCC holds on to its data, and the reader restarts the
+ * work once it has drained the ring.
+ */
+static void i2c_rx_work(struct work_struct *work)
+{
+	struct i2c_dev *i2c_dev = container_of(work, struct i2c_dev, rx_work);
+	struct nfc_dev *nfc_dev = container_of(i2c_dev, struct nfc_dev,
+					       i2c_dev);
+	struct platform_gpio *nfc_gpio = &nfc_dev->configs.gpio;
+	uint8_t *frame = i2c_dev->rx_frame;
+	unsigned int len;
+	int ret;
+
+	while (1) {
+		/* leave the data to the regular read path */
+		if (!READ_ONCE(i2c_dev->rx_ahead) ||
+		    nfc_dev->nfc_state != NFC_STATE_NCI) {
+			wake_up(&nfc_dev->read_wq);
+			return;
+		}
+		if (!gpio_get_value(nfc_gpio->irq))
+			break;
+
+		if (kfifo_avail(&i2c_dev->rx_ring) < MAX_NCI_BUFFER_SIZE) {
+			WRITE_ONCE(i2c_dev->rx_stalled, true);
+			/* pairs with the barrier in i2c_read_ring() */
+			smp_mb();
+			if (kfifo_avail(&i2c_dev->rx_ring) <
+			    MAX_NCI_BUFFER_SIZE) {
+				i2c_dev->rx_stalls++;
+				return;
+			}
+			WRITE_ONCE(i2c_dev->rx_stalled, false);
+		}
+
+		ret = i2c_master_recv_dmasafe(i2c_dev->client, frame,
+					      NCI_HDR_LEN);
+		if (ret != NCI_HDR_LEN)
+			goto err;
+
+		/* cold reset response goes to esepowermanager, see i2c_read() */
+		if (nfc_dev->cold_reset.rsp_pending && nfc_dev->cold_reset.cmd_buf
+			&& (frame[0] == PROP_NCI_RSP_GID)
+			&& (frame[1] == nfc_dev->cold_reset.cmd_buf[1])) {
+			read_cold_reset_rsp(nfc_dev, frame);
+			nfc_dev->cold_reset.rsp_pending = false;
+			wake_up_interruptible(&nfc_dev->cold_reset.read_wq);
+			continue;
+		}
+
+		len = frame[NCI_PAYLOAD_LEN_IDX];
+		if (len) {
+			ret = i2c_master_recv_dmasafe(i2c_dev->client,
+						      frame + NCI_HDR_LEN, len);
+			if (ret != (int)len)
+				goto err;
+		}
+		len += NCI_HDR_LEN;
+		NFCLOG_IPC(nfc_dev, false, "%s of %u bytes", __func__, len);
+
+		kfifo_in(&i2c_dev->rx_ring, frame, len);
+		i2c_dev->rx_frames++;
+		i2c_dev->rx_ring_hwm = max(i2c_dev->rx_ring_hwm,
+					   kfifo_len(&i2c_dev->rx_ring));
+		wake_up(&nfc_dev->read_wq);
+	}
+	i2c_enable_irq(nfc_dev);
+	return;
+err:
+	i2c_dev->rx_errors++;
+	pr_err("%s: read failed %d\n", __func__, ret);
+	i2c_enable_irq(nfc_dev);
+}
+
+/* called with read_mutex held */
+static void i2c_rx_ring_start(struct nfc_dev *nfc_dev)
+{
+	struct i2c_dev *i2c_dev = &nfc_dev->i2c_dev;
+
+	cancel_work_sync(&i2c_dev->rx_work);
+	kfifo_reset(&i2c_dev->rx_ring);
+	i2c_dev->rx_stalled = false;
+	WRITE_ONCE(i2c_dev->rx_ahead, true);
+}
+
+static void i2c_rx_ring_stop(struct nfc_dev *nfc_dev)
+{
+	struct i2c_dev *i2c_dev = &nfc_dev->i2c_dev;
+
+	WRITE_ONCE(i2c_dev->rx_ahead, false);
+	cancel_work_sync(&i2c_dev->rx_work);
+	kfifo_reset(&i2c_dev->rx_ring);
+}
+
+/**
+ * i2c_read_ring() - serve a read from the read-ahead ring
+ * @nfc_dev:	nfc device data structure
+ * @count:	number of bytes requested
+ * @nonblock:	return -EAGAIN instead of waiting for data
+ *
+ * Called with read_mutex held. Returns 0 when the read is released by
+ * flush or the device leaves NCI state, the HAL then reads again.
+ */
+static int i2c_read_ring(struct nfc_dev *nfc_dev, size_t count,
+			 bool nonblock)
+{
+	struct i2c_dev *i2c_dev = &nfc_dev->i2c_dev;
+	unsigned int len;
+	int ret;
+
+	if (kfifo_is_empty(&i2c_dev->rx_ring)) {
+		if (nonblock)
+			return -EAGAIN;
+		/* flush may have left IRQ disabled, let the worker rearm it */
+		queue_work(system_highpri_wq, &i2c_dev->rx_work);
+		ret = wait_event_interruptible(nfc_dev->read_wq,
+				!kfifo_is_empty(&i2c_dev->rx_ring) ||
+				nfc_dev->release_read ||
+				nfc_dev->nfc_state != NFC_STATE_NCI);
+		if (ret)
+			return ret;
+		if (kfifo_is_empty(&i2c_dev->rx_ring)) {
+			pr_debug("%s: releasing read\n", __func__);
+			return 0;
+		}
+	}
+
+	len = kfifo_out(&i2c_dev->rx_ring, nfc_dev->read_kbuf, count);
+	/* pairs with the barrier in i2c_rx_work() */
+	smp_mb();
+	if (READ_ONCE(i2c_dev->rx_stalled) &&
+	    kfifo_avail(&i2c_dev->rx_ring) >= MAX_NCI_BUFFER_SIZE) {
+		WRITE_ONCE(i2c_dev->rx_stalled, false);
+		queue_work(system_highpri_wq, &i2c_dev->rx_work);
+	}
+	return len;
+}
+
 ssize_t nfc_i2c_dev_read(struct file *filp, char __user *buf, size_t count,
 			 loff_t *offset)
 {
@@ -281,12 +432,25 @@ ssize_t nfc_i2c_dev_read(struct file *filp, char __user *buf, size_t count,
 	if (count > MAX_NCI_BUFFER_SIZE)
 		count = MAX_NCI_BUFFER_SIZE;
 
+	/* frames are only read ahead in NCI mode, never during download */
+	if (nfc_dev->nfc_state == NFC_STATE_NCI) {
+		if (!nfc_dev->i2c_dev.rx_ahead)
+			i2c_rx_ring_start(nfc_dev);
+		ret = i2c_read_ring(nfc_dev, count,
+				    filp->f_flags & O_NONBLOCK);
+		goto copy;
+	}
+	if (nfc_dev->i2c_dev.rx_ahead)
+		i2c_rx_ring_stop(nfc_dev);
+
 	if (filp->f_flags & O_NONBLOCK) {
-		ret = i2c_master_recv(nfc_dev->i2c_dev.client, nfc_dev->read_kbuf, count);
+		ret = i2c_master_recv_dmasafe(nfc_dev->i2c_dev.client,
+					      nfc_dev->read_kbuf, count);
 		pr_debug("%s: NONBLOCK read ret = %d\n", __func__, ret);
 	} else {
 		ret = i2c_read(nfc_dev, nfc_dev->read_kbuf, count, 0);
 	}
+copy:
 	if (ret > 0) {
 		if (copy_to_user(buf, nfc_dev->read_kbuf, ret)) {
 			pr_warn("%s: failed to copy to user space\n", __func__);
@@ -297,6 +461,50 @@ ssize_t nfc_i2c_dev_read(struct file *filp, char __user *buf, size_t count,
 	return ret;
 }
 
+static __poll_t nfc_i2c_dev_poll(struct file *filp, poll_table *wait)
+{
+	struct nfc_dev *nfc_dev = (struct nfc_dev *)filp->private_data;
+	struct i2c_dev *i2c_dev;
+
+	if (!nfc_dev)
+		return EPOLLERR;
+	i2c_dev = &nfc_dev->i2c_dev;
+
+	poll_wait(filp, &nfc_dev->read_wq, wait);
+	if (!READ_ONCE(i2c_dev->rx_ahead))
+		return gpio_get_value(nfc_dev->configs.gpio.irq) ?
+			(EPOLLIN | EPOLLRDNORM) : 0;
+	if (!kfifo_is_empty(&i2c_dev->rx_ring))
+		return EPOLLIN | EPOLLRDNORM;
+	queue_work(system_highpri_wq, &i2c_dev->rx_work);
+	return 0;
+}
+
+static int nfc_i2c_dev_close(struct inode *inode, struct file *filp)
+{
+	struct nfc_dev *nfc_dev = container_of(inode->i_cdev, struct nfc_dev,
+					       c_dev);
+
+	/* last user is gone, drop whatever was read ahead for it */
+	if (nfc_dev->dev_ref_count == 1)
+		i2c_rx_ring_stop(nfc_dev);
+
+	return nfc_dev_close(inode, filp);
+}
+
+static ssize_t rx_ring_stats_show(struct device *dev,
+				  struct device_attribute *attr, char *buf)
+{
+	struct nfc_dev *nfc_dev = dev_get_drvdata(dev);
+	struct i2c_dev *i2c_dev = &nfc_dev->i2c_dev;
+
+	return sysfs_emit(buf, "frames %u stalls %u errors %u hwm %u/%u\n",
+			  i2c_dev->rx_frames, i2c_dev->rx_stalls,
+			  i2c_dev->rx_errors, i2c_dev->rx_ring_hwm,
+			  kfifo_size(&i2c_dev->rx_ring));
+}
+static DEVICE_ATTR_RO(rx_ring_stats);
+
 ssize_t nfc_i2c_dev_write(struct file *filp, const char __user *buf,
 			  size_t count, loff_t *offset)
 {
@@ -327,9 +535,10 @@ static const struct file_operations nfc_i2c_dev_fops = {
 	.llseek = no_llseek,
 	.read = nfc_i2c_dev_read,
 	.write = nfc_i2c_dev_write,
+	.poll = nfc_i2c_dev_poll,
 	.open = nfc_dev_open,
 	.flush = nfc_dev_flush,
-	.release = nfc_dev_close,
+	.release = nfc_i2c_dev_close,
 	.unlocked_ioctl = nfc_dev_ioctl,
 #ifdef CONFIG_COMPAT
 	.compat_ioctl = nfc_dev_compat_ioctl,
@@ -372,6 +581,17 @@ int nfc_i2c_dev_probe(struct i2c_client *client, const struct i2c_device_id *id)
 		ret = -ENOMEM;
 		goto err_free_read_kbuf;
 	}
+	nfc_dev->i2c_dev.rx_frame = kzalloc(MAX_NCI_BUFFER_SIZE,
+					    GFP_DMA | GFP_KERNEL);
+	if (!nfc_dev->i2c_dev.rx_frame) {
+		ret = -ENOMEM;
+		goto err_free_write_kbuf;
+	}
+	ret = kfifo_alloc(&nfc_dev->i2c_dev.rx_ring, NFC_RX_RING_SIZE,
+			  GFP_KERNEL);
+	if (ret)
+		goto err_free_rx_frame;
+	INIT_WORK(&nfc_dev->i2c_dev.rx_work, i2c_rx_work);
 	nfc_dev->interface = PLATFORM_IF_I2C;
 	nfc_dev->nfc_state = NFC_STATE_NCI;
 	nfc_dev->i2c_dev.client = client;
@@ -439,6 +659,8 @@ int nfc_i2c_dev_probe(struct i2c_client *client, const struct i2c_device_id *id)
 
 	device_init_wakeup(&client->dev, true);
 	i2c_set_clientdata(client, nfc_dev);
+	if (device_create_file(&client->dev, &dev_attr_rx_ring_stats))
+		pr_warn("%s: unable to create rx_ring_stats\n", __func__);
 	i2c_dev->irq_wake_up = false;
 	nfc_dev->is_ese_session_active = false;
 
@@ -456,6 +678,10 @@ err_mutex_destroy:
 	mutex_destroy(&nfc_dev->write_mutex);
 err_free_gpio:
 	gpio_free_all(nfc_dev);
+	kfifo_free(&nfc_dev->i2c_dev.rx_ring);
+err_free_rx_frame:
+	kfree(nfc_dev->i2c_dev.rx_frame);
+err_free_write_kbuf:
 	kfree(nfc_dev->write_kbuf);
 err_free_read_kbuf:
 	kfree(nfc_dev->read_kbuf);
@@ -491,8 +717,10 @@ int nfc_i2c_dev_remove(struct i2c_client *client)
 		regulator_put(nfc_dev->reg);
 	}
 
+	device_remove_file(&client->dev, &dev_attr_rx_ring_stats);
 	device_init_wakeup(&client->dev, false);
 	free_irq(client->irq, nfc_dev);
+	cancel_work_sync(&nfc_dev->i2c_dev.rx_work);
 	nfc_misc_unregister(nfc_dev, DEV_COUNT);
 	mutex_destroy(&nfc_dev->dev_ref_mutex);
 	mutex_destroy(&nfc_dev->read_mutex);
@@ -500,6 +728,8 @@ int nfc_i2c_dev_remove(struct i2c_client *client)
 	gpio_free_all(nfc_dev);
 	kfree(nfc_dev->read_kbuf);
 	kfree(nfc_dev->write_kbuf);
+	kfifo_free(&nfc_dev->i2c_dev.rx_ring);
+	kfree(nfc_dev->i2c_dev.rx_frame);
 	kfree(nfc_dev);
 	return ret;
 }
@@ -25,10 +25,15 @@
 #define _I2C_DRV_H_
 
 #include <linux/i2c.h>
+#include <linux/kfifo.h>
+#include <linux/workqueue.h>
 
 #define NFC_I2C_DRV_STR   "qcom,sn-nci"	/*kept same as dts */
 #define NFC_I2C_DEV_ID	  "sn-i2c"
 
+/* NCI read-ahead ring size in bytes, must be a power of 2 */
+#define NFC_RX_RING_SIZE  (4096)
+
 struct nfc_dev;
 
 /* Interface specific parameters */
@@ -39,6 +44,17 @@ struct i2c_dev {
 	spinlock_t irq_enabled_lock;
 	/* NFC_IRQ wake-up state */
 	bool irq_wake_up;
+	/* NCI read-ahead, see i2c_rx_work() */
+	bool rx_ahead;
+	bool rx_stalled;
+	uint8_t *rx_frame;
+	struct kfifo rx_ring;
+	struct work_struct rx_work;
+	/* read-ahead statistics */
+	u32 rx_frames;
+	u32 rx_stalls;
+	u32 rx_errors;
+	u32 rx_ring_hwm;
 };
 
 long nfc_i2c_dev_ioctl(struct file *pfile, unsigned int cmd, unsigned long arg);
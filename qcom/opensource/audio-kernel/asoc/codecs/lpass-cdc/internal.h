@@ -82,6 +82,9 @@ struct lpass_cdc_priv {
 			u16 macro_id, u16 reg, u8 *val);
 	int (*write_dev)(struct lpass_cdc_priv *priv,
 			 u16 macro_id, u16 reg, u8 val);
+	int (*bulk_write_dev)(struct lpass_cdc_priv *priv,
+			      u16 macro_id, u16 reg, const u8 *val,
+			      size_t count);
 	struct platform_device *pdev_child_devices
 			[LPASS_CDC_CHILD_DEVICES_MAX];
 	u16 child_count;
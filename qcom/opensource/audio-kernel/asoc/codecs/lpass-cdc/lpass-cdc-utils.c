@@ -122,6 +122,23 @@ static int regmap_bus_gather_write(void *context,
 		return 0;
 
 	mutex_lock(&priv->io_lock);
+	/*
+	 * regcache sync coalesces contiguous dirty registers into one raw
+	 * write, so write the whole run with a single device access.
+	 */
+	if (val_size > 1 && priv->bulk_write_dev) {
+		__reg = reg_p[0] - macro_id_base_offset[macro_id];
+		ret = priv->bulk_write_dev(priv, macro_id, __reg, val,
+					   val_size);
+		if (ret < 0)
+			dev_err_ratelimited(dev,
+			"%s: Codec bulk write failed (%d), reg:0x%x, size:%zd\n",
+			__func__, ret, reg_p[0], val_size);
+		dev_dbg(dev, "Write %zd regs from reg 0x%x\n", val_size,
+			reg_p[0]);
+		mutex_unlock(&priv->io_lock);
+		return ret;
+	}
 	for (i = 0; i < val_size; i++) {
 		__reg = (reg_p[0] + i * 4) - macro_id_base_offset[macro_id];
 		ret = priv->write_dev(priv, macro_id, __reg, ((u8 *)val)[i]);
@@ -12,6 +12,7 @@
 #include <linux/delay.h>
 #include <linux/kernel.h>
 #include <linux/clk.h>
+#include <linux/async.h>
 #include <soc/snd_event.h>
 #include <linux/pm_runtime.h>
 #include <soc/swr-common.h>
@@ -126,10 +127,16 @@ ssr_err:
 	return ret;
 }
 
-static int __lpass_cdc_reg_write(struct lpass_cdc_priv *priv,
-			      u16 macro_id, u16 reg, u8 val)
+/*
+ * Write count registers starting at reg, 4 bytes apart, with a single
+ * SSR check and a single LPASS core vote for the whole run.
+ */
+static int __lpass_cdc_reg_bulk_write(struct lpass_cdc_priv *priv,
+				   u16 macro_id, u16 reg, const u8 *val,
+				   size_t count)
 {
 	int ret = 0;
+	size_t i;
 
 	mutex_lock(&priv->clk_lock);
 	if (!priv->dev_up) {
@@ -146,8 +153,10 @@ static int __lpass_cdc_reg_write(struct lpass_cdc_priv *priv,
 			goto vote_err;
 		}
 	}
-	lpass_cdc_ahb_write_device(
-		priv->macro_params[macro_id].io_base, reg, val);
+	for (i = 0; i < count; i++)
+		lpass_cdc_ahb_write_device(
+			priv->macro_params[macro_id].io_base, reg + i * 4,
+			val[i]);
 
 vote_err:
 	if (priv->macro_params[VA_MACRO].dev) {
@@ -160,6 +169,12 @@ ssr_err:
 	return ret;
 }
 
+static int __lpass_cdc_reg_write(struct lpass_cdc_priv *priv,
+			      u16 macro_id, u16 reg, u8 val)
+{
+	return __lpass_cdc_reg_bulk_write(priv, macro_id, reg, &val, 1);
+}
+
 static int lpass_cdc_update_wcd_event(void *handle, u16 event, u32 data)
 {
 	struct lpass_cdc_priv *priv = (struct lpass_cdc_priv *)handle;
@@ -835,9 +850,26 @@ static ssize_t lpass_cdc_version_read(struct snd_info_entry *entry,
 	return simple_read_from_buffer(buf, count, &pos, buffer, len);
 }
 
+struct lpass_cdc_ssr_up_work {
+	struct lpass_cdc_priv *priv;
+	int macro_idx;
+};
+
+static ASYNC_DOMAIN_EXCLUSIVE(lpass_cdc_ssr_domain);
+
+static void lpass_cdc_macro_ssr_up(void *data, async_cookie_t cookie)
+{
+	struct lpass_cdc_ssr_up_work *work = data;
+	struct lpass_cdc_priv *priv = work->priv;
+
+	priv->macro_params[work->macro_idx].event_handler(priv->component,
+				LPASS_CDC_MACRO_EVT_SSR_UP, 0x0);
+}
+
 static int lpass_cdc_ssr_enable(struct device *dev, void *data)
 {
 	struct lpass_cdc_priv *priv = data;
+	struct lpass_cdc_ssr_up_work work[MAX_MACRO];
 	int macro_idx;
 
 	if (priv->initial_boot) {
@@ -882,14 +914,19 @@ static int lpass_cdc_ssr_enable(struct device *dev, void *data)
 	usleep_range(100,110);
 	lpass_cdc_clk_rsc_enable_all_clocks(priv->clk_dev, false);
 	TRACE_PRINTK("%s: regcache_sync done\n", __func__);
-	/* call ssr event for supported macros */
+	/*
+	 * call ssr event for supported macros, each macro restarts its own
+	 * soundwire master so let them wait for their masters in parallel
+	 */
 	for (macro_idx = START_MACRO; macro_idx < MAX_MACRO; macro_idx++) {
 		if (!priv->macro_params[macro_idx].event_handler)
 			continue;
-		priv->macro_params[macro_idx].event_handler(
-			priv->component,
-			LPASS_CDC_MACRO_EVT_SSR_UP, 0x0);
+		work[macro_idx].priv = priv;
+		work[macro_idx].macro_idx = macro_idx;
+		async_schedule_domain(lpass_cdc_macro_ssr_up, &work[macro_idx],
+				      &lpass_cdc_ssr_domain);
 	}
+	async_synchronize_full_domain(&lpass_cdc_ssr_domain);
 	TRACE_PRINTK("%s: SSR up events processed by all macros\n", __func__);
 	lpass_cdc_notifier_call(priv, LPASS_CDC_WCD_EVT_SSR_UP);
 	return 0;
@@ -1317,6 +1354,7 @@ static int lpass_cdc_probe(struct platform_device *pdev)
 
 	priv->read_dev = __lpass_cdc_reg_read;
 	priv->write_dev = __lpass_cdc_reg_write;
+	priv->bulk_write_dev = __lpass_cdc_reg_bulk_write;
 
 	priv->plat_data.handle = (void *) priv;
 	priv->plat_data.update_wcd_event = lpass_cdc_update_wcd_event;
@@ -28,6 +28,12 @@
 #define WCD_MBHC_ADC_HPH_THRESHOLD_MV   75
 #define WCD_MBHC_ADC_MICBIAS_MV         1800
 #define WCD_MBHC_FAKE_INS_RETRY         4
+#define WCD_MBHC_ADC_POLL_MS            200
+
+static int plug_settle_cnt = 5;
+module_param(plug_settle_cnt, int, 0664);
+MODULE_PARM_DESC(plug_settle_cnt,
+	"stop plug correction after this many matching polls, 0 to disable");
 
 static int wcd_mbhc_get_micbias(struct wcd_mbhc *mbhc)
 {
@@ -513,7 +519,13 @@ static bool wcd_is_special_headset(struct wcd_mbhc *mbhc)
 		}
 		delay += 50;
 		/* Wait for 50ms for FSM to update result */
-		msleep(50);
+		if (wait_event_timeout(mbhc->hs_detect_wq,
+				       mbhc->hs_detect_work_stop,
+				       msecs_to_jiffies(50))) {
+			pr_debug("%s: stop requested: %d\n", __func__,
+					mbhc->hs_detect_work_stop);
+			break;
+		}
 		output_mv = wcd_measure_adc_once(mbhc, MUX_CTL_IN2P);
 		if (output_mv <= adc_threshold) {
 			pr_debug("%s: Special headset detected in %d msecs\n",
@@ -583,6 +595,7 @@ static void wcd_cancel_hs_detect_plug(struct wcd_mbhc *mbhc,
 {
 	pr_debug("%s: Canceling correct_plug_swch\n", __func__);
 	mbhc->hs_detect_work_stop = true;
+	wake_up(&mbhc->hs_detect_wq);
 	WCD_MBHC_RSC_UNLOCK(mbhc);
 	if (cancel_work_sync(work)) {
 		pr_debug("%s: correct_plug_swch is canceled\n",
@@ -666,6 +679,7 @@ static void wcd_correct_swch_plug(struct work_struct *work)
 	int output_mv = 0;
 	int cross_conn;
 	int try = 0;
+	int settle_cnt = 0;
 	int hs_threshold, micbias_mv;
 
 	pr_debug("%s: enter\n", __func__);
@@ -736,16 +750,18 @@ correct_plug_type:
 			goto exit;
 		}
 
-		/* allow sometime and re-check stop requested again */
-		msleep(20);
-		if (mbhc->hs_detect_work_stop) {
+		/*
+		 * allow sometime before the next measurement, a removal
+		 * wakes us up right away instead of at the end of the poll
+		 */
+		if (wait_event_timeout(mbhc->hs_detect_wq,
+				       mbhc->hs_detect_work_stop,
+				       msecs_to_jiffies(WCD_MBHC_ADC_POLL_MS))) {
 			pr_debug("%s: stop requested: %d\n", __func__,
 					mbhc->hs_detect_work_stop);
 			wcd_micbias_disable(mbhc);
 			goto exit;
 		}
-
-		msleep(180);
 		/*
 		 * Use ADC single mode to minimize the chance of missing out
 		 * btn press/release for HEADSET type during correct work.
@@ -757,6 +773,8 @@ correct_plug_type:
 		 * sometime and re-check stop request again.
 		 */
 		plug_type = wcd_mbhc_get_plug_from_adc(mbhc, output_mv);
+		if (plug_type != mbhc->current_plug)
+			settle_cnt = 0;
 
 		if ((output_mv > hs_threshold) &&
 		    (spl_hs_count < WCD_MBHC_SPL_HS_CNT)) {
@@ -867,6 +885,18 @@ correct_plug_type:
 							"special ":""));
 					goto report;
 				}
+				/*
+				 * The reported plug keeps reading back the
+				 * same, stop polling once it has settled.
+				 */
+				if (plug_settle_cnt &&
+				    plug_type == mbhc->current_plug &&
+				    ++settle_cnt >= plug_settle_cnt) {
+					pr_debug("%s: plug type %d settled\n",
+						 __func__, plug_type);
+					wrk_complete = false;
+					break;
+				}
 			}
 			wrk_complete = false;
 		}
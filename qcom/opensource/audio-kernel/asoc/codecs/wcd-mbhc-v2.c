@@ -18,6 +18,8 @@
 #include <linux/input.h>
 #include <linux/firmware.h>
 #include <linux/completion.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #if IS_ENABLED(CONFIG_QCOM_WCD_USBSS_I2C)
 #include <linux/soc/qcom/wcd939x-i2c.h>
 #endif
@@ -842,6 +844,29 @@ void wcd_mbhc_elec_hs_report_unplug(struct wcd_mbhc *mbhc)
 }
 EXPORT_SYMBOL(wcd_mbhc_elec_hs_report_unplug);
 
+static void wcd_mbhc_update_plug_stats(struct wcd_mbhc *mbhc)
+{
+	struct wcd_mbhc_plug_stats *stats = &mbhc->plug_stats;
+	u32 lat_us;
+
+	/* only the first report after an insertion counts */
+	if (!mbhc->plug_start)
+		return;
+
+	lat_us = ktime_us_delta(ktime_get(), mbhc->plug_start);
+	mbhc->plug_start = 0;
+
+	stats->last_us = lat_us;
+	if (!stats->count || lat_us < stats->min_us)
+		stats->min_us = lat_us;
+	if (lat_us > stats->max_us)
+		stats->max_us = lat_us;
+	stats->total_us += lat_us;
+	stats->count++;
+	pr_debug("%s: plug reported %u usecs after insertion\n",
+		 __func__, lat_us);
+}
+
 void wcd_mbhc_find_plug_and_report(struct wcd_mbhc *mbhc,
 				   enum wcd_mbhc_plug_type plug_type)
 {
@@ -927,6 +952,7 @@ void wcd_mbhc_find_plug_and_report(struct wcd_mbhc *mbhc,
 		WARN(1, "Unexpected current plug_type %d, plug_type %d\n",
 		     mbhc->current_plug, plug_type);
 	}
+	wcd_mbhc_update_plug_stats(mbhc);
 exit:
 	pr_debug("%s: leave\n", __func__);
 }
@@ -1067,6 +1093,7 @@ static void wcd_mbhc_swch_irq_handler(struct wcd_mbhc *mbhc)
 			mbhc->mbhc_cb->enable_mb_source(mbhc, true);
 		mbhc->btn_press_intr = false;
 		mbhc->is_btn_press = false;
+		mbhc->plug_start = ktime_get();
 		if (mbhc->mbhc_fn)
 			mbhc->mbhc_fn->wcd_mbhc_detect_plug_type(mbhc);
 	} else if ((mbhc->current_plug != MBHC_PLUG_TYPE_NONE)
@@ -1918,6 +1945,52 @@ EXPORT_SYMBOL(wcd_mbhc_stop);
  *
  * NOTE: mbhc->mbhc_cfg is not YET configure so shouldn't be used
  */
+#ifdef CONFIG_DEBUG_FS
+static int wcd_mbhc_plug_stats_show(struct seq_file *s, void *unused)
+{
+	struct wcd_mbhc *mbhc = s->private;
+	struct wcd_mbhc_plug_stats stats;
+
+	WCD_MBHC_RSC_LOCK(mbhc);
+	stats = mbhc->plug_stats;
+	WCD_MBHC_RSC_UNLOCK(mbhc);
+
+	seq_printf(s, "count: %u\n", stats.count);
+	seq_printf(s, "last_us: %u\n", stats.last_us);
+	seq_printf(s, "min_us: %u\n", stats.min_us);
+	seq_printf(s, "max_us: %u\n", stats.max_us);
+	seq_printf(s, "avg_us: %llu\n", stats.count ?
+		   div_u64(stats.total_us, stats.count) : 0);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(wcd_mbhc_plug_stats);
+
+static void wcd_mbhc_debugfs_init(struct wcd_mbhc *mbhc)
+{
+	if (mbhc->debugfs_plug_stats)
+		return;
+
+	mbhc->debugfs_plug_stats = debugfs_create_file("mbhc_plug_latency",
+				0400, mbhc->component->debugfs_root, mbhc,
+				&wcd_mbhc_plug_stats_fops);
+}
+
+static void wcd_mbhc_debugfs_deinit(struct wcd_mbhc *mbhc)
+{
+	debugfs_remove(mbhc->debugfs_plug_stats);
+	mbhc->debugfs_plug_stats = NULL;
+}
+#else
+static void wcd_mbhc_debugfs_init(struct wcd_mbhc *mbhc)
+{
+}
+
+static void wcd_mbhc_debugfs_deinit(struct wcd_mbhc *mbhc)
+{
+}
+#endif
+
 int wcd_mbhc_init(struct wcd_mbhc *mbhc, struct snd_soc_component *component,
 		      const struct wcd_mbhc_cb *mbhc_cb,
 		      const struct wcd_mbhc_intr *mbhc_cdc_intr_ids,
@@ -2069,6 +2142,7 @@ int wcd_mbhc_init(struct wcd_mbhc *mbhc, struct snd_soc_component *component,
 	}
 
 	init_waitqueue_head(&mbhc->wait_btn_press);
+	init_waitqueue_head(&mbhc->hs_detect_wq);
 	mutex_init(&mbhc->codec_resource_lock);
 
 	switch (mbhc->mbhc_detection_logic) {
@@ -2181,6 +2255,7 @@ int wcd_mbhc_init(struct wcd_mbhc *mbhc, struct snd_soc_component *component,
 			goto err_ext_dev;
 		}
 	}
+	wcd_mbhc_debugfs_init(mbhc);
 	mbhc->deinit_in_progress = false;
 	pr_debug("%s: leave ret %d\n", __func__, ret);
 	return ret;
@@ -2238,6 +2313,7 @@ void wcd_mbhc_deinit(struct wcd_mbhc *mbhc)
 					&mbhc->correct_plug_swch);
 		WCD_MBHC_RSC_UNLOCK(mbhc);
 	}
+	wcd_mbhc_debugfs_deinit(mbhc);
 	mutex_destroy(&mbhc->codec_resource_lock);
 }
 EXPORT_SYMBOL(wcd_mbhc_deinit);
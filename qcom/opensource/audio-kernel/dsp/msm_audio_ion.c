@@ -12,6 +12,7 @@
 #include <linux/slab.h>
 #include <linux/mutex.h>
 #include <linux/list.h>
+#include <linux/hashtable.h>
 #include <linux/dma-mapping.h>
 #include <linux/dma-buf.h>
 #include <linux/dma-buf-map.h>
@@ -40,11 +41,14 @@
 #define TZ_PIL_CLEAR_PROTECT_MEM_SUBSYS_ID 0x0D
 #define MSM_AUDIO_ION_DRIVER_NAME "msm_audio_ion"
 #define MINOR_NUMBER_COUNT 1
+#define MSM_AUDIO_ION_FD_HASH_BITS 6
 struct msm_audio_ion_private {
 	bool smmu_enabled;
 	struct device *cb_dev;
 	u8 device_status;
 	struct list_head alloc_list;
+	/* alloc_list indexed by dma_buf */
+	DECLARE_HASHTABLE(alloc_hash, MSM_AUDIO_ION_FD_HASH_BITS);
 	struct mutex list_mutex;
 	u64 smmu_sid_bits;
 	u32 smmu_version;
@@ -64,12 +68,15 @@ struct msm_audio_alloc_data {
 	struct dma_buf_attachment *attach;
 	struct sg_table *table;
 	struct list_head list;
+	struct hlist_node hnode;
 };
 
 struct msm_audio_ion_fd_list_private {
 	struct mutex list_mutex;
 	/*list to store fd, phy. addr and handle data */
 	struct list_head fd_list;
+	/* fd indexed view of fd_list for lookups on the map/stream paths */
+	DECLARE_HASHTABLE(fd_hash, MSM_AUDIO_ION_FD_HASH_BITS);
 };
 
 static struct msm_audio_ion_fd_list_private msm_audio_ion_fd_list = {0,};
@@ -83,6 +90,9 @@ struct msm_audio_fd_data {
 	void *vaddr;
 	struct device *dev;
 	struct list_head list;
+	struct hlist_node hnode;
+	/* number of IOCTL_MAP_PHYS_ADDR calls sharing this mapping */
+	u32 map_cnt;
 	bool hyp_assign;
 };
 
@@ -98,9 +108,26 @@ static void msm_audio_ion_add_allocation(
 	mutex_lock(&(msm_audio_ion_data->list_mutex));
 	list_add_tail(&(alloc_data->list),
 		      &(msm_audio_ion_data->alloc_list));
+	hash_add(msm_audio_ion_data->alloc_hash, &alloc_data->hnode,
+		 (unsigned long)alloc_data->dma_buf);
 	mutex_unlock(&(msm_audio_ion_data->list_mutex));
 }
 
+/* This function is called with ion_data list mutex lock */
+static struct msm_audio_alloc_data *msm_audio_alloc_lookup(
+	struct msm_audio_ion_private *ion_data, struct dma_buf *dma_buf)
+{
+	struct msm_audio_alloc_data *alloc_data = NULL;
+
+	hash_for_each_possible(ion_data->alloc_hash, alloc_data, hnode,
+			       (unsigned long)dma_buf) {
+		if (alloc_data->dma_buf == dma_buf)
+			return alloc_data;
+	}
+
+	return NULL;
+}
+
 /* This function is called with ion_data list mutex lock */
 static int msm_audio_ion_map_kernel(struct dma_buf *dma_buf,
 	struct msm_audio_ion_private *ion_data, struct dma_buf_map *dma_vmap)
@@ -127,13 +154,9 @@ static int msm_audio_ion_map_kernel(struct dma_buf *dma_buf,
 	 * for mapping kernel virtual address is available.
 	 */
 	mutex_lock(&(ion_data->list_mutex));
-	list_for_each_entry(alloc_data, &(ion_data->alloc_list),
-			    list) {
-		if (alloc_data->dma_buf == dma_buf) {
-			alloc_data->vmap = dma_vmap;
-			break;
-		}
-	}
+	alloc_data = msm_audio_alloc_lookup(ion_data, dma_buf);
+	if (alloc_data)
+		alloc_data->vmap = dma_vmap;
 	mutex_unlock(&(ion_data->list_mutex));
 
 exit:
@@ -225,41 +248,25 @@ static int msm_audio_dma_buf_unmap(struct dma_buf *dma_buf, struct msm_audio_ion
 {
 	int rc = 0;
 	struct msm_audio_alloc_data *alloc_data = NULL;
-	struct list_head *ptr, *next;
-	bool found = false;
 	struct device *cb_dev = ion_data->cb_dev;
 
-	/*
-	 * Though list_for_each_safe is delete safe, lock
-	 * should be explicitly acquired to avoid race condition
-	 * on adding elements to the list.
-	 */
-	list_for_each_safe(ptr, next,
-			    &(ion_data->alloc_list)) {
-
-		alloc_data = list_entry(ptr, struct msm_audio_alloc_data,
-					list);
-
-		if (alloc_data->dma_buf == dma_buf) {
-			found = true;
-			dma_buf_unmap_attachment(alloc_data->attach,
-						 alloc_data->table,
-						 DMA_BIDIRECTIONAL);
+	alloc_data = msm_audio_alloc_lookup(ion_data, dma_buf);
+	if (alloc_data) {
+		dma_buf_unmap_attachment(alloc_data->attach,
+					 alloc_data->table,
+					 DMA_BIDIRECTIONAL);
 
-			dma_buf_detach(alloc_data->dma_buf,
-				       alloc_data->attach);
+		dma_buf_detach(alloc_data->dma_buf,
+			       alloc_data->attach);
 
-			dma_buf_put(alloc_data->dma_buf);
+		dma_buf_put(alloc_data->dma_buf);
 
-			list_del(&(alloc_data->list));
-			kfree(alloc_data->vmap);
-			kfree(alloc_data);
-			alloc_data = NULL;
-			break;
-		}
-	}
-
-	if (!found) {
+		list_del(&(alloc_data->list));
+		hash_del(&alloc_data->hnode);
+		kfree(alloc_data->vmap);
+		kfree(alloc_data);
+		alloc_data = NULL;
+	} else {
 		dev_err(cb_dev,
 			"%s: cannot find allocation, dma_buf %pK",
 			__func__, dma_buf);
@@ -302,13 +309,9 @@ static int msm_audio_ion_unmap_kernel(struct dma_buf *dma_buf, struct msm_audio_
 	 * TBD: remove the below section once new API
 	 * for unmapping kernel virtual address is available.
 	 */
-	list_for_each_entry(alloc_data, &(ion_data->alloc_list),
-			    list) {
-		if (alloc_data->dma_buf == dma_buf) {
-			dma_vmap = alloc_data->vmap;
-			break;
-		}
-	}
+	alloc_data = msm_audio_alloc_lookup(ion_data, dma_buf);
+	if (alloc_data)
+		dma_vmap = alloc_data->vmap;
 
 	if (!dma_vmap) {
 		dev_err(cb_dev,
@@ -367,6 +370,20 @@ err:
 	return rc;
 }
 
+/* This function is called with fd_list mutex lock */
+static struct msm_audio_fd_data *msm_audio_fd_lookup(int fd)
+{
+	struct msm_audio_fd_data *msm_audio_fd_data = NULL;
+
+	hash_for_each_possible(msm_audio_ion_fd_list.fd_hash,
+			       msm_audio_fd_data, hnode, fd) {
+		if (msm_audio_fd_data->fd == fd)
+			return msm_audio_fd_data;
+	}
+
+	return NULL;
+}
+
 void msm_audio_fd_list_debug(void)
 {
 	struct msm_audio_fd_data *msm_audio_fd_data = NULL;
@@ -381,19 +398,17 @@ void msm_audio_fd_list_debug(void)
 
 void msm_audio_update_fd_list(struct msm_audio_fd_data *msm_audio_fd_data)
 {
-	struct msm_audio_fd_data *msm_audio_fd_data1 = NULL;
-
 	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
-	list_for_each_entry(msm_audio_fd_data1,
-			&msm_audio_ion_fd_list.fd_list, list) {
-		if (msm_audio_fd_data1->fd == msm_audio_fd_data->fd) {
-			pr_err("%s fd already present, not updating the list",
-				__func__);
-			mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
-			return;
-		}
+	if (msm_audio_fd_lookup(msm_audio_fd_data->fd)) {
+		pr_err("%s fd already present, not updating the list",
+			__func__);
+		mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
+		return;
 	}
+	msm_audio_fd_data->map_cnt = 1;
 	list_add_tail(&msm_audio_fd_data->list, &msm_audio_ion_fd_list.fd_list);
+	hash_add(msm_audio_ion_fd_list.fd_hash, &msm_audio_fd_data->hnode,
+		 msm_audio_fd_data->fd);
 	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
 }
 
@@ -416,6 +431,7 @@ void msm_audio_delete_fd_entry(void *handle)
 			pr_debug("%s deleting handle %pK entry from list\n",
 				__func__, handle);
 			list_del(&(msm_audio_fd_data->list));
+			hash_del(&msm_audio_fd_data->hnode);
 			kfree(msm_audio_fd_data);
 			break;
 		}
@@ -434,18 +450,14 @@ int msm_audio_get_buf_addr(int fd, dma_addr_t *paddr, void **vaddr, size_t *pa_l
 	}
 	pr_debug("%s, fd %d\n", __func__, fd);
 	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
-	list_for_each_entry(msm_audio_fd_data,
-			&msm_audio_ion_fd_list.fd_list, list) {
-		if (msm_audio_fd_data->fd == fd) {
-			*paddr  = msm_audio_fd_data->paddr;
-			*vaddr  = msm_audio_fd_data->vaddr;
-			*pa_len = msm_audio_fd_data->plen;
-			status  = 0;
-			pr_debug("%s Found fd %d paddr %pK\n",
-				__func__, fd, paddr);
-			mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
-			return status;
-		}
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data) {
+		*paddr  = msm_audio_fd_data->paddr;
+		*vaddr  = msm_audio_fd_data->vaddr;
+		*pa_len = msm_audio_fd_data->plen;
+		status  = 0;
+		pr_debug("%s Found fd %d paddr %pK\n",
+			__func__, fd, paddr);
 	}
 	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
 	return status;
@@ -463,17 +475,13 @@ int msm_audio_get_phy_addr(int fd, dma_addr_t *paddr, size_t *pa_len)
 	}
 	pr_debug("%s, fd %d\n", __func__, fd);
 	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
-	list_for_each_entry(msm_audio_fd_data,
-			&msm_audio_ion_fd_list.fd_list, list) {
-		if (msm_audio_fd_data->fd == fd) {
-			*paddr = msm_audio_fd_data->paddr;
-			*pa_len = msm_audio_fd_data->plen;
-			status = 0;
-			pr_debug("%s Found fd %d paddr %pK\n",
-				__func__, fd, paddr);
-			mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
-			return status;
-		}
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data) {
+		*paddr = msm_audio_fd_data->paddr;
+		*pa_len = msm_audio_fd_data->plen;
+		status = 0;
+		pr_debug("%s Found fd %d paddr %pK\n",
+			__func__, fd, paddr);
 	}
 	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
 	return status;
@@ -487,15 +495,11 @@ static int msm_audio_set_hyp_assign(int fd, bool assign)
 	pr_debug("%s, fd %d\n", __func__, fd);
 
 	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
-	list_for_each_entry(msm_audio_fd_data,
-			&msm_audio_ion_fd_list.fd_list, list) {
-		if (msm_audio_fd_data->fd == fd) {
-			status = 0;
-			pr_debug("%s Found fd %d\n", __func__, fd);
-			msm_audio_fd_data->hyp_assign = assign;
-			mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
-			return status;
-		}
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data) {
+		status = 0;
+		pr_debug("%s Found fd %d\n", __func__, fd);
+		msm_audio_fd_data->hyp_assign = assign;
 	}
 	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
 	return status;
@@ -508,13 +512,10 @@ void msm_audio_get_handle(int fd, void **handle)
 	pr_debug("%s fd %d\n", __func__, fd);
 	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
 	*handle = NULL;
-	list_for_each_entry(msm_audio_fd_data,
-			&msm_audio_ion_fd_list.fd_list, list) {
-		if (msm_audio_fd_data->fd == fd) {
-			*handle = (struct dma_buf *)msm_audio_fd_data->handle;
-			pr_debug("%s handle %pK\n", __func__, *handle);
-			break;
-		}
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data) {
+		*handle = (struct dma_buf *)msm_audio_fd_data->handle;
+		pr_debug("%s handle %pK\n", __func__, *handle);
 	}
 	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
 }
@@ -684,6 +685,7 @@ void msm_audio_ion_crash_handler(void)
 							list);
 			if(msm_audio_fd_data) {
 				list_del(&(msm_audio_fd_data->list));
+				hash_del(&msm_audio_fd_data->hnode);
 				kfree(msm_audio_fd_data);
 			}
 		}
@@ -692,6 +694,54 @@ void msm_audio_ion_crash_handler(void)
 }
 EXPORT_SYMBOL(msm_audio_ion_crash_handler);
 
+/*
+ * Reuse the mapping of an fd which is already in the list, provided the
+ * fd still refers to the same dma_buf. This spares the import and SMMU
+ * map for clients which map the same buffer for every stream open.
+ */
+static bool msm_audio_get_mapping(int fd)
+{
+	struct msm_audio_fd_data *msm_audio_fd_data = NULL;
+	struct dma_buf *dma_buf = NULL;
+	bool found = false;
+
+	dma_buf = dma_buf_get(fd);
+	if (IS_ERR_OR_NULL(dma_buf))
+		return false;
+
+	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data && msm_audio_fd_data->handle == dma_buf) {
+		msm_audio_fd_data->map_cnt++;
+		found = true;
+		pr_debug("%s fd %d map_cnt %u\n", __func__, fd,
+			msm_audio_fd_data->map_cnt);
+	}
+	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
+	dma_buf_put(dma_buf);
+
+	return found;
+}
+
+/* Returns true while other users still hold the mapping of fd */
+static bool msm_audio_put_mapping(int fd)
+{
+	struct msm_audio_fd_data *msm_audio_fd_data = NULL;
+	bool in_use = false;
+
+	mutex_lock(&(msm_audio_ion_fd_list.list_mutex));
+	msm_audio_fd_data = msm_audio_fd_lookup(fd);
+	if (msm_audio_fd_data && msm_audio_fd_data->map_cnt > 1) {
+		msm_audio_fd_data->map_cnt--;
+		in_use = true;
+		pr_debug("%s fd %d map_cnt %u\n", __func__, fd,
+			msm_audio_fd_data->map_cnt);
+	}
+	mutex_unlock(&(msm_audio_ion_fd_list.list_mutex));
+
+	return in_use;
+}
+
 static int msm_audio_ion_open(struct inode *inode, struct file *file)
 {
 	int ret = 0;
@@ -738,6 +788,8 @@ static long msm_audio_ion_ioctl(struct file *file, unsigned int ioctl_num,
 	pr_debug("%s ioctl num %u\n", __func__, ioctl_num);
 	switch (ioctl_num) {
 	case IOCTL_MAP_PHYS_ADDR:
+		if (msm_audio_get_mapping((int)ioctl_param))
+			break;
 		dma_vmap = kzalloc(sizeof(struct msm_audio_fd_data), GFP_KERNEL);
 		if (!dma_vmap)
 			return -ENOMEM;
@@ -764,6 +816,8 @@ static long msm_audio_ion_ioctl(struct file *file, unsigned int ioctl_num,
 		msm_audio_update_fd_list(msm_audio_fd_data);
 		break;
 	case IOCTL_UNMAP_PHYS_ADDR:
+		if (msm_audio_put_mapping((int)ioctl_param))
+			break;
 		msm_audio_get_handle((int)ioctl_param, &mem_handle);
 		ret = msm_audio_ion_free(mem_handle, ion_data);
 		if (ret < 0) {
@@ -977,10 +1031,12 @@ static int msm_audio_ion_probe(struct platform_device *pdev)
 	dev_set_drvdata(dev, msm_audio_ion_data);
 	if (!msm_audio_ion_fd_list_init) {
 		INIT_LIST_HEAD(&msm_audio_ion_fd_list.fd_list);
+		hash_init(msm_audio_ion_fd_list.fd_hash);
 		mutex_init(&(msm_audio_ion_fd_list.list_mutex));
 		msm_audio_ion_fd_list_init = true;
 	}
 	INIT_LIST_HEAD(&msm_audio_ion_data->alloc_list);
+	hash_init(msm_audio_ion_data->alloc_hash);
 	mutex_init(&(msm_audio_ion_data->list_mutex));
 	rc = msm_audio_ion_reg_chrdev(msm_audio_ion_data);
 	if (rc) {
@@ -6,6 +6,7 @@
 #define __WCD_MBHC_V2_H__
 
 #include <linux/wait.h>
+#include <linux/ktime.h>
 #include <linux/stringify.h>
 #include <linux/power_supply.h>
 #include <linux/extcon.h>
@@ -534,6 +535,15 @@ struct wcd_mbhc_cb {
 	void (*zdet_leakage_resistance)(struct wcd_mbhc *mbhc, bool enable);
 };
 
+/* insertion to plug report latency, in usecs */
+struct wcd_mbhc_plug_stats {
+	u32 count;
+	u32 last_us;
+	u32 min_us;
+	u32 max_us;
+	u64 total_us;
+};
+
 struct wcd_mbhc_fn {
 	irqreturn_t (*wcd_mbhc_hs_ins_irq)(int irq, void *data);
 	irqreturn_t (*wcd_mbhc_hs_rem_irq)(int irq, void *data);
@@ -628,6 +638,12 @@ struct wcd_mbhc {
 	struct notifier_block aatc_dev_nb;
 
 	struct extcon_dev *extdev;
+
+	/* woken when the correct plug work is asked to stop */
+	wait_queue_head_t hs_detect_wq;
+	ktime_t plug_start;
+	struct wcd_mbhc_plug_stats plug_stats;
+	struct dentry *debugfs_plug_stats;
 };
 
 void wcd_mbhc_find_plug_and_report(struct wcd_mbhc *mbhc,
@@ -282,6 +282,7 @@ void gpr_driver_unregister(struct gpr_driver *drv);
 			gpr_driver_unregister)
 
 int gpr_send_pkt(struct gpr_device *adev, struct gpr_pkt *pkt);
+int gpr_send_pkts(struct gpr_device *adev, struct gpr_pkt **pkts, int num_pkts);
 
 enum gpr_subsys_state gpr_get_modem_state(void);
 enum gpr_subsys_state gpr_get_q6_state(void);
@@ -11,6 +11,8 @@ enum {
 	SND_EVENT_UP,
 };
 
+#define SND_EVENT_MAX_DEPS 4
+
 struct snd_event_clients;
 
 struct snd_event_ops {
@@ -23,6 +25,8 @@ int snd_event_client_register(struct device *dev,
 			      const struct snd_event_ops *snd_ev_ops,
 			      void *data);
 int snd_event_client_deregister(struct device *dev);
+int snd_event_client_set_async(struct device *dev, struct device **deps,
+			       size_t num_deps);
 int snd_event_master_register(struct device *dev,
 			      const struct snd_event_ops *ops,
 			      struct snd_event_clients *clients,
@@ -48,6 +52,11 @@ static inline int snd_event_client_deregister(struct device *dev)
 {
 	return 0;
 }
+static inline int snd_event_client_set_async(struct device *dev,
+			      struct device **deps, size_t num_deps)
+{
+	return 0;
+}
 static inline int snd_event_master_register(struct device *dev,
 			      const struct snd_event_ops *ops,
 			      struct snd_event_clients *clients,
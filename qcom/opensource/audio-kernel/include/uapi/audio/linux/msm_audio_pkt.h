@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+/*
+ * Copyright (c) 2023, Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _UAPI_LINUX_MSM_AUDIO_PKT_H
+#define _UAPI_LINUX_MSM_AUDIO_PKT_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+/*
+ * Shared packet ring of the audio-pkt device.
+ *
+ * The memory mapped from the audio-pkt device starts with a struct audio_pkt_ring_ctrl,
+ * followed by the rx slots (ADSP to client) at rx_offset and the tx slots (client to ADSP)
+ * at tx_offset, as returned by AUDIO_PKT_IOCTL_RING_SETUP. Each slot holds one GPR packet.
+ *
+ * head and tail are free running counters, the slot in use is (counter & (slots - 1)).
+ * The kernel is the producer of the rx ring and the consumer of the tx ring, the client is the
+ * consumer of the rx ring and the producer of the tx ring. The client signals new tx packets
+ * with AUDIO_PKT_IOCTL_RING_TX_KICK and waits for rx packets with poll().
+ *
+ * If the rx ring is full, packets are queued to read() instead. Packets in the rx ring are
+ * always older than the ones returned by read(), so the ring must be drained first.
+ */
+
+#define AUDIO_PKT_RING_SLOT_SIZE	4096
+#define AUDIO_PKT_RING_MAX_SLOTS	64
+
+struct audio_pkt_ring_idx {
+	__u32 head;
+	__u32 tail;
+	__u32 reserved[14];
+};
+
+struct audio_pkt_ring_ctrl {
+	struct audio_pkt_ring_idx rx;
+	struct audio_pkt_ring_idx tx;
+};
+
+struct audio_pkt_ring_slot {
+	__u32 len;
+	__u32 reserved;
+	__u8 data[AUDIO_PKT_RING_SLOT_SIZE - 2 * sizeof(__u32)];
+};
+
+/**
+ * struct audio_pkt_ring_config - shared ring configuration
+ * @rx_slots: number of rx slots, power of 2 up to AUDIO_PKT_RING_MAX_SLOTS
+ * @tx_slots: number of tx slots, power of 2 up to AUDIO_PKT_RING_MAX_SLOTS
+ * @rx_offset: returned offset of the rx slots in the mapping
+ * @tx_offset: returned offset of the tx slots in the mapping
+ * @size: returned size to be mapped
+ * @reserved: must be zero
+ */
+struct audio_pkt_ring_config {
+	__u32 rx_slots;
+	__u32 tx_slots;
+	__u32 rx_offset;
+	__u32 tx_offset;
+	__u32 size;
+	__u32 reserved;
+};
+
+#define AUDIO_PKT_IOCTL_MAGIC 'P'
+
+#define AUDIO_PKT_IOCTL_RING_SETUP	_IOWR(AUDIO_PKT_IOCTL_MAGIC, 1, \
+						struct audio_pkt_ring_config)
+#define AUDIO_PKT_IOCTL_RING_TX_KICK	_IO(AUDIO_PKT_IOCTL_MAGIC, 2)
+
+#endif /* _UAPI_LINUX_MSM_AUDIO_PKT_H */
@@ -27,6 +27,10 @@
 #include <linux/fs.h>
 #include <linux/uaccess.h>
 #include <linux/termios.h>
+#include <linux/vmalloc.h>
+#include <linux/log2.h>
+#include <linux/mm.h>
+#include <linux/msm_audio_pkt.h>
 #include <ipc/gpr-lite.h>
 #include <dsp/spf-core.h>
 #include <dsp/msm_audio_ion.h>
@@ -73,6 +77,33 @@ enum audio_pkt_state {
 	AUDIO_PKT_DEINIT,
 };
 
+/**
+ * struct audio_pkt_ring - packet ring shared with the client through mmap
+ * @base:	vmalloc_user memory holding the control block and the slots
+ * @size:	size of @base
+ * @ctrl:	control block with the ring indexes, at the start of @base
+ * @rx_slots:	rx slots, written by the gpr callback
+ * @tx_slots:	tx slots, written by the client
+ * @rx_num:	number of rx slots
+ * @tx_num:	number of tx slots
+ * @map_cnt:	number of vmas mapping @base, the ring is only reconfigured when zero
+ * @tx_buf:	buffers where tx packets are copied before they are validated and sent,
+ *		MAX_PACKET_SIZE bytes for each tx slot
+ * @tx_pkts:	packets of a tx kick, sent to gpr as one batch
+ */
+struct audio_pkt_ring {
+	void *base;
+	size_t size;
+	struct audio_pkt_ring_ctrl *ctrl;
+	struct audio_pkt_ring_slot *rx_slots;
+	struct audio_pkt_ring_slot *tx_slots;
+	u32 rx_num;
+	u32 tx_num;
+	atomic_t map_cnt;
+	void *tx_buf;
+	struct gpr_pkt **tx_pkts;
+};
+
 /**
  * struct audio_pkt_device - driver context, relates to platform dev
  * @dev:	audio pkt device
@@ -85,6 +116,7 @@ enum audio_pkt_state {
  * @ch_name:	audio channel to match to
  * @audio_pkt_major: Major number of audio pkt driver
  * @audio_pkt_class: audio pkt class pointer
+ * @ring:	shared packet ring, valid once configured by the client
  */
 struct audio_pkt_device {
 	struct device *dev;
@@ -100,6 +132,8 @@ struct audio_pkt_device {
 
 	dev_t audio_pkt_major;
 	struct class *audio_pkt_class;
+
+	struct audio_pkt_ring ring;
 };
 
 struct audio_pkt_priv {
@@ -191,6 +225,9 @@ int audio_pkt_release(struct inode *inode, struct file *file)
 		skb = skb_dequeue(&audpkt_dev->queue);
 		kfree_skb(skb);
 	}
+	/* Discard the packets in the shared ring */
+	if (audpkt_dev->ring.base)
+		memset(audpkt_dev->ring.ctrl, 0, sizeof(*audpkt_dev->ring.ctrl));
 	wake_up_interruptible(&audpkt_dev->readq);
 	spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
 
@@ -322,6 +359,64 @@ int audpkt_chk_and_update_physical_addr(struct audio_gpr_pkt *gpr_pkt)
 	return ret;
 }
 
+/**
+ * audio_pkt_prepare() - validate a GPR packet before it is sent to the ADSP
+ * kbuf:	Kernel copy of the packet, the physical address may be updated.
+ * count:	Size of the packet.
+ */
+static int audio_pkt_prepare(void *kbuf, size_t count)
+{
+	struct gpr_hdr *audpkt_hdr = (struct gpr_hdr *) kbuf;
+	int ret;
+
+	/* validate packet size */
+	if ((count > MAX_PACKET_SIZE) || (count < sizeof(struct gpr_pkt)) ||
+	    (count < GPR_PKT_GET_PACKET_BYTE_SIZE(audpkt_hdr->header))) {
+		AUDIO_PKT_ERR("Invalid count %zu\n", count);
+		return -EINVAL;
+	}
+
+	if (audpkt_hdr->opcode == APM_CMD_SHARED_MEM_MAP_REGIONS) {
+		if (count < sizeof(struct audio_gpr_pkt)) {
+			AUDIO_PKT_ERR("Invalid count %zu\n", count);
+			return -EINVAL;
+		}
+		ret = audpkt_chk_and_update_physical_addr((struct audio_gpr_pkt *) audpkt_hdr);
+		if (ret < 0) {
+			AUDIO_PKT_ERR("Update Physical Address Failed -%d\n", ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * audio_pkt_send() - validate a GPR packet and send it to the ADSP
+ * ap_priv:	Pointer to the audio pkt private data.
+ * kbuf:	Kernel copy of the packet, the physical address may be updated.
+ * count:	Size of the packet.
+ *
+ * Called with the audio pkt device lock held.
+ */
+static int audio_pkt_send(struct audio_pkt_priv *ap_priv, void *kbuf, size_t count)
+{
+	int ret;
+
+	ret = audio_pkt_prepare(kbuf, count);
+	if (ret < 0)
+		return ret;
+
+	ret = gpr_send_pkt(ap_priv->adev, (struct gpr_pkt *) kbuf);
+	if (ret < 0) {
+		AUDIO_PKT_ERR("APR Send Packet Failed ret -%d\n", ret);
+		if (ret == -ECONNRESET)
+			ret = -ENETRESET;
+	}
+
+	return ret;
+}
+
 /**
  * audio_pkt_write() - write() syscall for the audio_pkt device
  * file:	Pointer to the file structure.
@@ -338,7 +433,6 @@ ssize_t audio_pkt_write(struct file *file, const char __user *buf,
 {
 	struct audio_pkt_priv *ap_priv = NULL;
 	struct audio_pkt_device *audpkt_dev = NULL;
-	struct gpr_hdr *audpkt_hdr = NULL;
 	void *kbuf;
 	int ret;
 
@@ -371,50 +465,301 @@ ssize_t audio_pkt_write(struct file *file, const char __user *buf,
 	if (IS_ERR(kbuf))
 		return PTR_ERR(kbuf);
 
-	audpkt_hdr = (struct gpr_hdr *) kbuf;
-
-	/* validate packet size */
-	if ((count > MAX_PACKET_SIZE) || (count < GPR_PKT_GET_PACKET_BYTE_SIZE(audpkt_hdr->header)))
-	{
-		ret = -EINVAL;
+	if (mutex_lock_interruptible(&audpkt_dev->lock)) {
+		ret = -ERESTARTSYS;
 		goto free_kbuf;
 	}
+	ret = audio_pkt_send(ap_priv, kbuf, count);
+	mutex_unlock(&audpkt_dev->lock);
 
-	if (audpkt_hdr->opcode == APM_CMD_SHARED_MEM_MAP_REGIONS) {
-		if (count < sizeof(struct audio_gpr_pkt)) {
-			AUDIO_PKT_ERR("Invalid count %zu\n", count);
+free_kbuf:
+	kfree(kbuf);
+	return ret < 0 ? ret : count;
+}
+
+static bool audio_pkt_ring_rx_pending(struct audio_pkt_ring *ring)
+{
+	return ring->base && ring->ctrl->rx.head != READ_ONCE(ring->ctrl->rx.tail);
+}
+
+/* Called with the queue lock held, returns false if the packet must go to the skb queue */
+static bool audio_pkt_ring_rx_put(struct audio_pkt_device *audpkt_dev,
+				  void *data, uint16_t pkt_size)
+{
+	struct audio_pkt_ring *ring = &audpkt_dev->ring;
+	struct audio_pkt_ring_slot *slot;
+	u32 head, tail;
+
+	/* keep the ring entries older than the ones queued for read() */
+	if (!ring->base || !skb_queue_empty(&audpkt_dev->queue) ||
+	    pkt_size > sizeof(slot->data))
+		return false;
+
+	head = ring->ctrl->rx.head;
+	tail = smp_load_acquire(&ring->ctrl->rx.tail);
+	if (head - tail >= ring->rx_num)
+		return false;
+
+	slot = &ring->rx_slots[head & (ring->rx_num - 1)];
+	memcpy(slot->data, data, pkt_size);
+	slot->len = pkt_size;
+
+	/* publish the slot before the index */
+	smp_store_release(&ring->ctrl->rx.head, head + 1);
+
+	return true;
+}
+
+static void audio_pkt_ring_free(struct audio_pkt_ring *ring)
+{
+	vfree(ring->base);
+	kvfree(ring->tx_buf);
+	kfree(ring->tx_pkts);
+	ring->base = NULL;
+	ring->tx_buf = NULL;
+	ring->tx_pkts = NULL;
+	ring->ctrl = NULL;
+	ring->size = 0;
+}
+
+/**
+ * audio_pkt_ring_setup() - configure the shared packet ring
+ * audpkt_dev:	Pointer to the audio pkt device.
+ * arg:		Userspace pointer to the struct audio_pkt_ring_config.
+ *
+ * Allocates the ring, replacing the current one if it is not mapped, and returns the layout
+ * of the memory to be mapped by the client.
+ */
+static int audio_pkt_ring_setup(struct audio_pkt_device *audpkt_dev, void __user *arg)
+{
+	struct audio_pkt_ring *ring = &audpkt_dev->ring;
+	struct audio_pkt_ring_config cfg;
+	unsigned long flags;
+	size_t size;
+	void *base, *tx_buf;
+	struct gpr_pkt **tx_pkts;
+
+	if (copy_from_user(&cfg, arg, sizeof(cfg)))
+		return -EFAULT;
+
+	if (!cfg.rx_slots || !cfg.tx_slots || cfg.reserved ||
+	    !is_power_of_2(cfg.rx_slots) || !is_power_of_2(cfg.tx_slots) ||
+	    cfg.rx_slots > AUDIO_PKT_RING_MAX_SLOTS ||
+	    cfg.tx_slots > AUDIO_PKT_RING_MAX_SLOTS) {
+		AUDIO_PKT_ERR("Invalid ring config rx %u tx %u\n",
+			      cfg.rx_slots, cfg.tx_slots);
+		return -EINVAL;
+	}
+
+	if (atomic_read(&ring->map_cnt)) {
+		AUDIO_PKT_ERR("ring is mapped, can't be reconfigured\n");
+		return -EBUSY;
+	}
+
+	cfg.rx_offset = PAGE_ALIGN(sizeof(struct audio_pkt_ring_ctrl));
+	cfg.tx_offset = cfg.rx_offset + cfg.rx_slots * sizeof(struct audio_pkt_ring_slot);
+	size = PAGE_ALIGN(cfg.tx_offset + cfg.tx_slots * sizeof(struct audio_pkt_ring_slot));
+	cfg.size = size;
+
+	base = vmalloc_user(size);
+	if (!base)
+		return -ENOMEM;
+
+	tx_buf = kvzalloc(cfg.tx_slots * MAX_PACKET_SIZE, GFP_KERNEL);
+	tx_pkts = kcalloc(cfg.tx_slots, sizeof(*tx_pkts), GFP_KERNEL);
+	if (!tx_buf || !tx_pkts) {
+		vfree(base);
+		kvfree(tx_buf);
+		kfree(tx_pkts);
+		return -ENOMEM;
+	}
+
+	spin_lock_irqsave(&audpkt_dev->queue_lock, flags);
+	swap(ring->base, base);
+	swap(ring->tx_buf, tx_buf);
+	swap(ring->tx_pkts, tx_pkts);
+	ring->size = size;
+	ring->ctrl = ring->base;
+	ring->rx_slots = ring->base + cfg.rx_offset;
+	ring->tx_slots = ring->base + cfg.tx_offset;
+	ring->rx_num = cfg.rx_slots;
+	ring->tx_num = cfg.tx_slots;
+	spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
+
+	/* free the previous ring, if any */
+	vfree(base);
+	kvfree(tx_buf);
+	kfree(tx_pkts);
+
+	AUDIO_PKT_INFO("ring rx %u tx %u size %zu\n", cfg.rx_slots, cfg.tx_slots, size);
+
+	if (copy_to_user(arg, &cfg, sizeof(cfg)))
+		return -EFAULT;
+
+	return 0;
+}
+
+/**
+ * audio_pkt_ring_tx_kick() - send the packets queued in the tx ring
+ * ap_priv:	Pointer to the audio pkt private data.
+ *
+ * Each packet is copied out of the shared memory before it is validated, so the client can't
+ * modify it after the checks, and all of them are sent to gpr as one batch. Responses are
+ * matched by the client through the packet tokens. Returns the number of packets sent, or an
+ * error if none was sent; a packet that fails validation is consumed and ends the batch.
+ */
+static long audio_pkt_ring_tx_kick(struct audio_pkt_priv *ap_priv)
+{
+	struct audio_pkt_device *audpkt_dev = ap_priv->ap_dev;
+	struct audio_pkt_ring *ring = &audpkt_dev->ring;
+	struct audio_pkt_ring_slot *slot;
+	u32 head, tail, len;
+	int num = 0, ret = 0, sent = 0;
+	void *kbuf;
+
+	if (!ring->base)
+		return -EINVAL;
+
+	head = smp_load_acquire(&ring->ctrl->tx.head);
+	tail = ring->ctrl->tx.tail;
+	if (head - tail > ring->tx_num) {
+		AUDIO_PKT_ERR("Invalid tx ring head %u tail %u\n", head, tail);
+		return -EINVAL;
+	}
+
+	while (tail + num != head) {
+		slot = &ring->tx_slots[(tail + num) & (ring->tx_num - 1)];
+		kbuf = ring->tx_buf + num * MAX_PACKET_SIZE;
+		len = READ_ONCE(slot->len);
+		if (len > sizeof(slot->data)) {
+			AUDIO_PKT_ERR("Invalid tx len %u\n", len);
 			ret = -EINVAL;
-			goto free_kbuf;
+			break;
 		}
-		ret = audpkt_chk_and_update_physical_addr((struct audio_gpr_pkt *) audpkt_hdr);
-		if (ret < 0) {
-			AUDIO_PKT_ERR("Update Physical Address Failed -%d\n", ret);
-			goto free_kbuf;
+		memcpy(kbuf, slot->data, len);
+		ret = audio_pkt_prepare(kbuf, len);
+		if (ret < 0)
+			break;
+		ring->tx_pkts[num++] = kbuf;
+	}
+
+	if (num) {
+		sent = gpr_send_pkts(ap_priv->adev, ring->tx_pkts, num);
+		if (sent < 0) {
+			AUDIO_PKT_ERR("APR Send Packets Failed ret -%d\n", sent);
+			ret = sent == -ECONNRESET ? -ENETRESET : sent;
+			sent = 0;
 		}
 	}
 
-	if (mutex_lock_interruptible(&audpkt_dev->lock)) {
-		ret = -ERESTARTSYS;
-		goto free_kbuf;
+	/* consume the packets sent and the one that failed validation, if any */
+	tail += sent;
+	if (sent == num && ret < 0)
+		tail++;
+	smp_store_release(&ring->ctrl->tx.tail, tail);
+
+	return sent ? sent : ret;
+}
+
+/**
+ * audio_pkt_ioctl() - ioctl() syscall for the audio_pkt device
+ * file:	Pointer to the file structure.
+ * cmd:		ioctl command.
+ * arg:		ioctl argument.
+ */
+static long audio_pkt_ioctl(struct file *file, unsigned int cmd,
+			    unsigned long arg)
+{
+	struct audio_pkt_priv *ap_priv = file->private_data;
+	struct audio_pkt_device *audpkt_dev = ap_priv->ap_dev;
+	long ret;
+
+	if (!audpkt_dev) {
+		AUDIO_PKT_ERR("invalid device handle\n");
+		return -EINVAL;
 	}
-	if (count < sizeof(struct gpr_pkt )) {
-		AUDIO_PKT_ERR("Invalid count %zu\n", count);
-		ret = -EINVAL;
-		mutex_unlock(&audpkt_dev->lock);
-		goto free_kbuf;
+
+	mutex_lock(&ap_priv->lock);
+	if (AUDIO_PKT_PROBED != ap_priv->status) {
+		mutex_unlock(&ap_priv->lock);
+		AUDIO_PKT_ERR("dev is in reset\n");
+		return -ENETRESET;
 	}
+	mutex_unlock(&ap_priv->lock);
 
-	ret = gpr_send_pkt(ap_priv->adev, (struct gpr_pkt *) kbuf);
-	if (ret < 0) {
-		AUDIO_PKT_ERR("APR Send Packet Failed ret -%d\n", ret);
-		if (ret == -ECONNRESET)
-			ret = -ENETRESET;
+	if (mutex_lock_interruptible(&audpkt_dev->lock))
+		return -ERESTARTSYS;
+
+	switch (cmd) {
+	case AUDIO_PKT_IOCTL_RING_SETUP:
+		ret = audio_pkt_ring_setup(audpkt_dev, (void __user *)arg);
+		break;
+	case AUDIO_PKT_IOCTL_RING_TX_KICK:
+		ret = audio_pkt_ring_tx_kick(ap_priv);
+		break;
+	default:
+		ret = -ENOTTY;
+		break;
 	}
 	mutex_unlock(&audpkt_dev->lock);
 
-free_kbuf:
-	kfree(kbuf);
-	return ret < 0 ? ret : count;
+	return ret;
+}
+
+static void audio_pkt_vm_open(struct vm_area_struct *vma)
+{
+	struct audio_pkt_device *audpkt_dev = vma->vm_private_data;
+
+	atomic_inc(&audpkt_dev->ring.map_cnt);
+}
+
+static void audio_pkt_vm_close(struct vm_area_struct *vma)
+{
+	struct audio_pkt_device *audpkt_dev = vma->vm_private_data;
+
+	atomic_dec(&audpkt_dev->ring.map_cnt);
+}
+
+static const struct vm_operations_struct audio_pkt_vm_ops = {
+	.open = audio_pkt_vm_open,
+	.close = audio_pkt_vm_close,
+};
+
+/**
+ * audio_pkt_mmap() - mmap() syscall for the audio_pkt device
+ * file:	Pointer to the file structure.
+ * vma:		Pointer to the vma to map the shared packet ring to.
+ */
+static int audio_pkt_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct audio_pkt_priv *ap_priv = file->private_data;
+	struct audio_pkt_device *audpkt_dev = ap_priv->ap_dev;
+	struct audio_pkt_ring *ring;
+	int ret;
+
+	if (!audpkt_dev) {
+		AUDIO_PKT_ERR("invalid device handle\n");
+		return -EINVAL;
+	}
+	ring = &audpkt_dev->ring;
+
+	mutex_lock(&audpkt_dev->lock);
+	if (!ring->base || vma->vm_pgoff ||
+	    vma->vm_end - vma->vm_start != ring->size) {
+		ret = -EINVAL;
+		goto done;
+	}
+
+	ret = remap_vmalloc_range(vma, ring->base, 0);
+	if (ret)
+		goto done;
+
+	vma->vm_private_data = audpkt_dev;
+	vma->vm_ops = &audio_pkt_vm_ops;
+	audio_pkt_vm_open(vma);
+done:
+	mutex_unlock(&audpkt_dev->lock);
+	return ret;
 }
 
 /**
@@ -441,7 +786,8 @@ static unsigned int audio_pkt_poll(struct file *file, poll_table *wait)
 	mutex_lock(&audpkt_dev->lock);
 
 	spin_lock_irqsave(&audpkt_dev->queue_lock, flags);
-	if (!skb_queue_empty(&audpkt_dev->queue))
+	if (!skb_queue_empty(&audpkt_dev->queue) ||
+	    audio_pkt_ring_rx_pending(&audpkt_dev->ring))
 		mask |= POLLIN | POLLRDNORM;
 
 	spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
@@ -457,6 +803,9 @@ static const struct file_operations audio_pkt_fops = {
 	.read = audio_pkt_read,
 	.write = audio_pkt_write,
 	.poll = audio_pkt_poll,
+	.unlocked_ioctl = audio_pkt_ioctl,
+	.compat_ioctl = audio_pkt_ioctl,
+	.mmap = audio_pkt_mmap,
 };
 
 /**
@@ -482,6 +831,13 @@ static int audio_pkt_srvc_callback(struct gpr_device *adev,
     AUDIO_PKT_INFO("%s: header %d packet %d \n",
 		__func__,hdr_size, pkt_size);
 
+	spin_lock_irqsave(&audpkt_dev->queue_lock, flags);
+	if (audio_pkt_ring_rx_put(audpkt_dev, data, pkt_size)) {
+		spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
+		goto wake_up;
+	}
+	spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
+
 	skb = alloc_skb(pkt_size, GFP_ATOMIC);
 	if (!skb)
 		return -ENOMEM;
@@ -492,6 +848,8 @@ static int audio_pkt_srvc_callback(struct gpr_device *adev,
 	skb_queue_tail(&audpkt_dev->queue, skb);
 	spin_unlock_irqrestore(&audpkt_dev->queue_lock, flags);
 
+wake_up:
+
 	/* wake up any blocking processes, waiting for new data */
 	wake_up_interruptible(&audpkt_dev->readq);
 	return 0;
@@ -715,6 +1073,7 @@ static int audio_pkt_platform_driver_remove(struct platform_device *adev)
 	audio_pkt_internal_release(adev);
 
 	if (audpkt_dev) {
+		audio_pkt_ring_free(&audpkt_dev->ring);
 		cdev_del(&audpkt_dev->cdev);
 		device_destroy(audpkt_dev->audio_pkt_class,audpkt_dev->audio_pkt_major);
 		class_destroy(audpkt_dev->audio_pkt_class);
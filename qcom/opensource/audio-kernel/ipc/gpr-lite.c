@@ -79,38 +79,26 @@ void gpr_subsys_notif_deregister(char *client_name)
 			__func__, client_name);
 }
 
-/**
- * gpr_send_pkt() - Send a gpr message from gpr device
- *
- * @adev: Pointer to previously registered gpr device.
- * @pkt: Pointer to gpr packet to send
- *
- * Return: Will be an negative and/or packet size on success.
- */
-int gpr_send_pkt(struct gpr_device *adev, struct gpr_pkt *pkt)
+static struct gpr *gpr_get_send_ctx(struct gpr_device *adev)
 {
 	struct gpr *gpr;
-	struct gpr_hdr *hdr;
-	unsigned long flags;
-	uint32_t pkt_size;
-	int ret;
 
 	if (gpr_get_q6_state() == GPR_SUBSYS_DOWN) {
 		pr_err_ratelimited("%s: q6 state is down\n", __func__, adev);
-		return -EINVAL;
+		return ERR_PTR(-EINVAL);
 	}
 
 	if(!adev)
 	{
 		pr_err_ratelimited("%s: enter pointer adev[%pK] \n", __func__, adev);
-		return -EINVAL;
+		return ERR_PTR(-EINVAL);
 	}
 
 	if(!(adev->dev.parent))
 	{
 		pr_err_ratelimited("%s: enter pointer adev->dev.parent[%pK] \n",
 			__func__, adev->dev.parent);
-		return -EINVAL;
+		return ERR_PTR(-EINVAL);
 	}
 
 	gpr = dev_get_drvdata(adev->dev.parent);
@@ -118,21 +106,30 @@ int gpr_send_pkt(struct gpr_device *adev, struct gpr_pkt *pkt)
 	if (!gpr) {
 		pr_err_ratelimited("%s: Failed to get gpr dev pointer : gpr[%pK] \n",
 			__func__, gpr);
-		return -EINVAL;
+		return ERR_PTR(-EINVAL);
 	}
 
 	if ((adev->domain_id == GPR_DOMAIN_ADSP) &&
 	    (gpr_get_q6_state() != GPR_SUBSYS_LOADED)) {
 		dev_err_ratelimited(gpr->dev, "%s:  Still Dsp is not Up\n", __func__);
-		return -ENETRESET;
+		return ERR_PTR(-ENETRESET);
 	} else if ((adev->domain_id == GPR_DOMAIN_MODEM) &&
 		   (gpr_get_modem_state() == GPR_SUBSYS_DOWN)) {
 		dev_err_ratelimited(gpr->dev, "%s:  Still Modem is not Up\n",
 			__func__);
-		return -ENETRESET;
+		return ERR_PTR(-ENETRESET);
 	}
 
-	spin_lock_irqsave(&adev->lock, flags);
+	return gpr;
+}
+
+/* Called with the gpr device lock held */
+static int __gpr_send_pkt(struct gpr *gpr, struct gpr_device *adev,
+			  struct gpr_pkt *pkt)
+{
+	struct gpr_hdr *hdr;
+	uint32_t pkt_size;
+	int ret;
 
 	hdr = &pkt->hdr;
 	hdr->dst_domain_id = adev->domain_id;
@@ -141,11 +138,78 @@ int gpr_send_pkt(struct gpr_device *adev, struct gpr_pkt *pkt)
 	dev_dbg(gpr->dev, "SVC_ID %d %s packet size %d\n",
 		adev->svc_id, __func__, pkt_size);
 	ret = rpmsg_trysend(gpr->ch, pkt, pkt_size);
-	spin_unlock_irqrestore(&adev->lock, flags);
 	return ret ? ret : pkt_size;
 }
+
+/**
+ * gpr_send_pkt() - Send a gpr message from gpr device
+ *
+ * @adev: Pointer to previously registered gpr device.
+ * @pkt: Pointer to gpr packet to send
+ *
+ * Return: Will be an negative and/or packet size on success.
+ */
+int gpr_send_pkt(struct gpr_device *adev, struct gpr_pkt *pkt)
+{
+	struct gpr *gpr;
+	unsigned long flags;
+	int ret;
+
+	gpr = gpr_get_send_ctx(adev);
+	if (IS_ERR(gpr))
+		return PTR_ERR(gpr);
+
+	spin_lock_irqsave(&adev->lock, flags);
+	ret = __gpr_send_pkt(gpr, adev, pkt);
+	spin_unlock_irqrestore(&adev->lock, flags);
+	return ret;
+}
 EXPORT_SYMBOL_GPL(gpr_send_pkt);
 
+/**
+ * gpr_send_pkts() - Send a batch of gpr messages from gpr device
+ *
+ * @adev: Pointer to previously registered gpr device.
+ * @pkts: Array of pointers to the gpr packets to send
+ * @num_pkts: Number of packets in @pkts
+ *
+ * The packets are sent back to back in order, checking the remote state and
+ * taking the device lock once for the whole batch. Responses are matched by
+ * the caller through the token of each packet, so the next packet doesn't
+ * wait for the response of the previous one. Sending stops at the first
+ * packet that fails.
+ *
+ * Return: Number of packets sent, or a negative error if none was sent.
+ */
+int gpr_send_pkts(struct gpr_device *adev, struct gpr_pkt **pkts, int num_pkts)
+{
+	struct gpr *gpr;
+	unsigned long flags;
+	int i, ret = 0;
+
+	if (!pkts || num_pkts <= 0)
+		return -EINVAL;
+
+	gpr = gpr_get_send_ctx(adev);
+	if (IS_ERR(gpr))
+		return PTR_ERR(gpr);
+
+	spin_lock_irqsave(&adev->lock, flags);
+	for (i = 0; i < num_pkts; i++) {
+		ret = __gpr_send_pkt(gpr, adev, pkts[i]);
+		if (ret < 0)
+			break;
+	}
+	spin_unlock_irqrestore(&adev->lock, flags);
+
+	if (i < num_pkts)
+		dev_err_ratelimited(gpr->dev, "%s: sent %d of %d packets, ret %d\n",
+			__func__, i, num_pkts, ret);
+
+	return i ? i : ret;
+}
+EXPORT_SYMBOL_GPL(gpr_send_pkts);
+
  /**
   * apr_set_modem_state - Update modem load status.
   *
@@ -23,8 +23,10 @@ static int regmap_swr_gather_write(void *context,
 	struct regmap *map = dev_get_regmap(dev, NULL);
 	size_t addr_bytes;
 	size_t val_bytes;
+	size_t num_regs;
 	int i, ret = 0;
 	u16 reg_addr = 0;
+	u16 *regs;
 	u8 *value;
 
 	if (map == NULL) {
@@ -43,8 +45,28 @@ static int regmap_swr_gather_write(void *context,
 	}
 	reg_addr = *(u16 *)reg;
 	val_bytes = map->format.val_bytes;
+	num_regs = val_len / val_bytes;
+
+	/* write a range of registers through the master command fifo at once */
+	if (num_regs > 1 && val_bytes == 1) {
+		regs = kcalloc(num_regs, sizeof(u16), GFP_KERNEL);
+		if (!regs)
+			return -ENOMEM;
+		for (i = 0; i < num_regs; i++)
+			regs[i] = reg_addr + i;
+		ret = swr_bulk_write(swr, swr->dev_num, regs, val, num_regs);
+		kfree(regs);
+		if (ret != -EOPNOTSUPP) {
+			if (ret)
+				dev_err_ratelimited(dev, "%s: bulk write reg 0x%x failed, err %d\n",
+					__func__, reg_addr, ret);
+			return ret;
+		}
+		ret = 0;
+	}
+
 	/* val_len = val_bytes * val_count */
-	for (i = 0; i < (val_len / val_bytes); i++) {
+	for (i = 0; i < num_regs; i++) {
 		value = (u8 *)val + (val_bytes * i);
 		ret = swr_write(swr, swr->dev_num, (reg_addr + i), value);
 		if (ret < 0) {
@@ -8,6 +8,7 @@
 #include <linux/slab.h>
 #include <linux/module.h>
 #include <linux/of_device.h>
+#include <linux/async.h>
 #include <soc/snd_event.h>
 
 struct snd_event_client {
@@ -19,6 +20,14 @@ struct snd_event_client {
 
 	bool attached;
 	bool state;
+
+	/* enable may run alongside other async clients once deps are up */
+	bool async;
+	bool queued;
+	bool enabled;
+	int enable_ret;
+	size_t num_deps;
+	struct device *deps[SND_EVENT_MAX_DEPS];
 };
 
 struct snd_event_client_array {
@@ -47,6 +56,7 @@ struct snd_master {
 static DEFINE_MUTEX(snd_event_mutex);
 static LIST_HEAD(snd_event_client_list);
 static struct snd_master *master;
+static ASYNC_DOMAIN_EXCLUSIVE(snd_event_async_domain);
 
 static struct snd_event_client *find_snd_event_client(struct device *dev)
 {
@@ -59,6 +69,113 @@ static struct snd_event_client *find_snd_event_client(struct device *dev)
 	return NULL;
 }
 
+static void snd_event_client_enable_async(void *data, async_cookie_t cookie)
+{
+	struct snd_event_client *c = data;
+
+	c->enable_ret = c->ops->enable(c->dev, c->data);
+}
+
+static bool snd_event_deps_enabled(struct snd_event_client *c)
+{
+	struct snd_event_client *d;
+	int i, j;
+
+	for (i = 0; i < c->num_deps; i++) {
+		for (j = 0; j < master->clients->num_clients; j++) {
+			d = master->clients->cl_arr[j].clnt;
+			if (d->dev == c->deps[i] && !d->enabled)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Enable the clients of the master. Clients which did not opt in through
+ * snd_event_client_set_async() are enabled first, one by one and in the
+ * order the master listed them. The async clients follow in waves: each
+ * wave runs every client whose dependencies are enabled in parallel and
+ * waits for all of them before resolving the next wave.
+ */
+static int snd_event_enable_clients(void)
+{
+	struct snd_event_client *c;
+	size_t pending = 0;
+	size_t queued;
+	bool in_order = false;
+	int ret = 0;
+	int i = 0;
+
+	for (i = 0; i < master->clients->num_clients; i++) {
+		c = master->clients->cl_arr[i].clnt;
+		c->enabled = false;
+		c->queued = false;
+		c->enable_ret = 0;
+		if (c->async) {
+			pending++;
+			continue;
+		}
+		if (c->ops->enable) {
+			ret = c->ops->enable(c->dev, c->data);
+			if (ret) {
+				dev_err_ratelimited(c->dev,
+					"%s: enable failed\n", __func__);
+				return ret;
+			}
+		}
+		c->enabled = true;
+	}
+
+	while (pending) {
+		queued = 0;
+		for (i = 0; i < master->clients->num_clients; i++) {
+			c = master->clients->cl_arr[i].clnt;
+			if (!c->async || c->queued)
+				continue;
+			if (!in_order && !snd_event_deps_enabled(c))
+				continue;
+			c->queued = true;
+			queued++;
+			if (c->ops->enable)
+				async_schedule_domain(
+					snd_event_client_enable_async, c,
+					&snd_event_async_domain);
+			/* one at a time once the graph could not be resolved */
+			if (in_order)
+				break;
+		}
+
+		if (!queued) {
+			pr_warn_ratelimited("%s: unresolved client dependencies, enabling in order\n",
+				__func__);
+			in_order = true;
+			continue;
+		}
+		async_synchronize_full_domain(&snd_event_async_domain);
+
+		for (i = 0; i < master->clients->num_clients; i++) {
+			c = master->clients->cl_arr[i].clnt;
+			if (!c->queued || c->enabled)
+				continue;
+			if (c->enable_ret) {
+				dev_err_ratelimited(c->dev,
+					"%s: enable failed\n", __func__);
+				if (!ret)
+					ret = c->enable_ret;
+				continue;
+			}
+			c->enabled = true;
+		}
+		if (ret)
+			return ret;
+		pending -= queued;
+	}
+
+	return 0;
+}
+
 static int check_and_update_fwk_state(void)
 {
 	bool new_fwk_state = true;
@@ -74,18 +191,9 @@ static int check_and_update_fwk_state(void)
 
 	if (master->fwk_state ^ new_fwk_state) {
 		if (new_fwk_state) {
-			for (i = 0; i < master->clients->num_clients; i++) {
-				c = master->clients->cl_arr[i].clnt;
-				if (c->ops->enable) {
-					ret = c->ops->enable(c->dev, c->data);
-					if (ret) {
-						dev_err_ratelimited(c->dev,
-							"%s: enable failed\n",
-							__func__);
-						goto dev_en_failed;
-					}
-				}
-			}
+			ret = snd_event_enable_clients();
+			if (ret)
+				goto dev_en_failed;
 			if (master->ops->enable) {
 				ret = master->ops->enable(master->dev,
 							  master->data);
@@ -93,7 +201,7 @@ static int check_and_update_fwk_state(void)
 					dev_err_ratelimited(master->dev,
 						"%s: enable failed\n",
 						__func__);
-					goto mstr_en_failed;
+					goto dev_en_failed;
 				}
 			}
 		} else {
@@ -110,13 +218,12 @@ static int check_and_update_fwk_state(void)
 	}
 	goto exit;
 
-mstr_en_failed:
-	i = master->clients->num_clients;
 dev_en_failed:
-	for (; i > 0; i--) {
+	for (i = master->clients->num_clients; i > 0; i--) {
 		c = master->clients->cl_arr[i - 1].clnt;
-		if (c->ops->disable)
+		if (c->enabled && c->ops->disable)
 			c->ops->disable(c->dev, c->data);
+		c->enabled = false;
 	}
 exit:
 	return ret;
@@ -215,6 +322,51 @@ exit:
 }
 EXPORT_SYMBOL(snd_event_client_register);
 
+/*
+ * snd_event_client_set_async - Let a client be enabled in parallel
+ *
+ * @dev: Pointer to the "struct device" associated with the client
+ * @deps: Devices of other clients whose enable must complete first
+ * @num_deps: Number of entries in @deps, up to SND_EVENT_MAX_DEPS
+ *
+ * Once the framework comes up, clients opted in this way are enabled
+ * after the in-order clients, in parallel with every other async client
+ * whose dependencies are met. Dependencies on devices which are not
+ * clients of the master are ignored.
+ *
+ * Returns 0 on success or error on failure.
+ */
+int snd_event_client_set_async(struct device *dev, struct device **deps,
+			       size_t num_deps)
+{
+	struct snd_event_client *c;
+	int ret = 0;
+	int i = 0;
+
+	if (!dev || (num_deps && !deps) || num_deps > SND_EVENT_MAX_DEPS) {
+		pr_err_ratelimited("%s: invalid params\n", __func__);
+		return -EINVAL;
+	}
+
+	mutex_lock(&snd_event_mutex);
+	c = find_snd_event_client(dev);
+	if (!c) {
+		dev_dbg(dev, "%s: No matching snd dev found\n", __func__);
+		ret = -ENODEV;
+		goto exit;
+	}
+
+	for (i = 0; i < num_deps; i++)
+		c->deps[i] = deps[i];
+	c->num_deps = num_deps;
+	c->async = true;
+
+exit:
+	mutex_unlock(&snd_event_mutex);
+	return ret;
+}
+EXPORT_SYMBOL(snd_event_client_set_async);
+
 /*
  * snd_event_client_deregister - Remove a client from the SND event FW
  *
@@ -82,6 +82,7 @@
 #define SWRM_DP_PORT_CTRL_OFFSET1_SHFT    0x08
 
 #define SWR_OVERFLOW_RETRY_COUNT 30
+#define SWR_PIPELINE_RETRY_COUNT 300
 
 #define CPU_IDLE_LATENCY 10
 
@@ -93,6 +94,32 @@ static int auto_suspend_timer = 500;
 module_param(auto_suspend_timer, int, 0664);
 MODULE_PARM_DESC(auto_suspend_timer, "timer for auto suspend");
 
+/* fill the write fifo to its depth on bulk writes instead of pacing each command */
+static bool wr_fifo_pipeline = true;
+module_param(wr_fifo_pipeline, bool, 0664);
+MODULE_PARM_DESC(wr_fifo_pipeline, "pipeline bulk writes through the command fifo");
+
+/* run the bus at the lowest clock that carries the active ports */
+static bool bus_clk_solver = true;
+module_param(bus_clk_solver, bool, 0664);
+MODULE_PARM_DESC(bus_clk_solver, "pick bus clock from active port bandwidth");
+
+/*
+ * Bus clocks derived from a 9.6MHz mclk, lowest first, with the usecase
+ * whose port params program that clock. Entries marked need_pp are only
+ * used when the slaves supplied port params for their usecase.
+ */
+static const struct swrm_bus_clk_cfg {
+	int bus_clk;
+	int uc;
+	bool need_pp;
+} swrm_bus_clk_tbl[] = {
+	{ SWR_CLK_RATE_0P6MHZ, SWR_UC3, false },
+	{ SWR_CLK_RATE_1P2MHZ, SWR_UC2, true },
+	{ SWR_CLK_RATE_4P8MHZ, SWR_UC1, false },
+	{ SWR_CLK_RATE_9P6MHZ, SWR_UC0, false },
+};
+
 enum {
 	SWR_NOT_PRESENT, /* Device is detached/not present on the bus */
 	SWR_ATTACHED_OK, /* Device is attached */
@@ -135,6 +162,8 @@ static u32 swr_master_read(struct swr_mstr_ctrl *swrm, unsigned int reg_addr);
 static void swr_master_write(struct swr_mstr_ctrl *swrm, u16 reg_addr, u32 val);
 static int swrm_runtime_resume(struct device *dev);
 static void swrm_wait_for_fifo_avail(struct swr_mstr_ctrl *swrm, int swrm_rd_wr);
+static u32 swrm_wait_for_wr_fifo_space(struct swr_mstr_ctrl *swrm,
+				       u32 delay_us, u32 retry_count);
 
 static u8 swrm_get_clk_div(int mclk_freq, int bus_clk_freq)
 {
@@ -672,9 +701,29 @@ static int swr_master_bulk_write(struct swr_mstr_ctrl *swrm, u32 *reg_addr,
 {
 	int i = 0;
 
+	u32 fifo_space = 0;
+
 	if (swrm->bulk_write)
 		swrm->bulk_write(swrm->handle, reg_addr, val, length);
-	else {
+	else if (wr_fifo_pipeline && swrm->wr_fifo_depth) {
+		/*
+		 * Queue as many commands as the write fifo has room for and
+		 * only check the fifo status again once that room is used up.
+		 */
+		mutex_lock(&swrm->iolock);
+		for (i = 0; i < length; i++) {
+			if (reg_addr[i] == SWRM_CMD_FIFO_WR_CMD(swrm->ee_val)) {
+				if (!fifo_space)
+					fifo_space = swrm_wait_for_wr_fifo_space(swrm,
+						50, SWR_PIPELINE_RETRY_COUNT);
+				if (fifo_space)
+					fifo_space--;
+			}
+			swr_master_write(swrm, reg_addr[i], val[i]);
+		}
+		usleep_range(100, 110);
+		mutex_unlock(&swrm->iolock);
+	} else {
 		mutex_lock(&swrm->iolock);
 		for (i = 0; i < length; i++) {
 		/* wait for FIFO WR command to complete to avoid overflow */
@@ -875,6 +924,35 @@ static u32 swrm_get_packed_reg_val(u8 *cmd_id, u8 cmd_data,
 	return val;
 }
 
+/*
+ * Wait until the write fifo has room for at least one command, polling every
+ * delay_us up to retry_count times, and return the number of free entries.
+ */
+static u32 swrm_wait_for_wr_fifo_space(struct swr_mstr_ctrl *swrm,
+				       u32 delay_us, u32 retry_count)
+{
+	u32 fifo_outstanding_cmd;
+
+	/* Check no of outstanding commands in fifo before write */
+	fifo_outstanding_cmd = ((swr_master_read(swrm,
+				 SWRM_CMD_FIFO_STATUS(swrm->ee_val)) & 0x00001F00)
+				 >> 8);
+	while (fifo_outstanding_cmd >= swrm->wr_fifo_depth && retry_count) {
+		usleep_range(delay_us, delay_us + 10);
+		fifo_outstanding_cmd =
+		((swr_master_read(swrm, SWRM_CMD_FIFO_STATUS(swrm->ee_val))
+		  & 0x00001F00) >> 8);
+		retry_count--;
+	}
+	if (fifo_outstanding_cmd >= swrm->wr_fifo_depth) {
+		dev_err_ratelimited(swrm->dev,
+				"%s err write overflow\n", __func__);
+		return 0;
+	}
+
+	return swrm->wr_fifo_depth - fifo_outstanding_cmd;
+}
+
 static void swrm_wait_for_fifo_avail(struct swr_mstr_ctrl *swrm, int swrm_rd_wr)
 {
 	u32 fifo_outstanding_cmd;
@@ -902,24 +980,7 @@ static void swrm_wait_for_fifo_avail(struct swr_mstr_ctrl *swrm, int swrm_rd_wr)
 					"%s err read underflow\n", __func__);
 	} else {
 		/* Check for fifo overflow during write */
-		/* Check no of outstanding commands in fifo before write */
-		fifo_outstanding_cmd = ((swr_master_read(swrm,
-					 SWRM_CMD_FIFO_STATUS(swrm->ee_val)) & 0x00001F00)
-					 >> 8);
-		if (fifo_outstanding_cmd == swrm->wr_fifo_depth) {
-			while (fifo_retry_count) {
-				usleep_range(500, 510);
-				fifo_outstanding_cmd =
-				((swr_master_read(swrm, SWRM_CMD_FIFO_STATUS(swrm->ee_val))
-				  & 0x00001F00) >> 8);
-				fifo_retry_count--;
-				if (fifo_outstanding_cmd < swrm->wr_fifo_depth)
-					break;
-			}
-		}
-		if (fifo_outstanding_cmd == swrm->wr_fifo_depth)
-			dev_err_ratelimited(swrm->dev,
-					"%s err write overflow\n", __func__);
+		swrm_wait_for_wr_fifo_space(swrm, 500, fifo_retry_count);
 	}
 }
 
@@ -1264,20 +1325,49 @@ int swrm_get_clk_div_rate(int mclk_freq, int bus_clk_freq)
 	return bus_clk_freq;
 }
 
-static int swrm_update_bus_clk(struct swr_mstr_ctrl *swrm)
+static int swrm_solve_bus_clk(struct swr_mstr_ctrl *swrm, int agg_clk)
+{
+	int i;
+
+	if (!bus_clk_solver || !swrm->pp_uc_mask ||
+	    swrm->mclk_freq != SWR_CLK_RATE_9P6MHZ)
+		return swrm_get_clk_div_rate(swrm->mclk_freq, agg_clk);
+
+	for (i = 0; i < ARRAY_SIZE(swrm_bus_clk_tbl); i++) {
+		if (swrm_bus_clk_tbl[i].bus_clk < agg_clk)
+			continue;
+		if (swrm_bus_clk_tbl[i].need_pp &&
+		    !(swrm->pp_uc_mask & (1 << swrm_bus_clk_tbl[i].uc)))
+			continue;
+		return swrm_bus_clk_tbl[i].bus_clk;
+	}
+
+	return swrm->mclk_freq;
+}
+
+static int swrm_update_bus_clk(struct swr_mstr_ctrl *swrm, bool scale_down)
 {
 	int ret = 0;
 	int agg_clk = 0;
+	int bus_clk;
 	int i;
 
 	for (i = 0; i < SWR_MSTR_PORT_LEN; i++)
 		agg_clk += swrm->mport_cfg[i].ch_rate;
 
 	if (agg_clk)
-		swrm->bus_clk = swrm_get_clk_div_rate(swrm->mclk_freq,
-							agg_clk);
+		bus_clk = swrm_solve_bus_clk(swrm, agg_clk);
 	else
-		swrm->bus_clk = swrm->mclk_freq;
+		bus_clk = swrm->mclk_freq;
+
+	/*
+	 * Ports left running across a disconnect keep the sample interval
+	 * and offsets of the current clock, so only scale down once the
+	 * next connect reprograms every active port.
+	 */
+	if (bus_clk_solver && !scale_down && agg_clk && bus_clk < swrm->bus_clk)
+		bus_clk = swrm->bus_clk;
+	swrm->bus_clk = bus_clk;
 
 	dev_dbg(swrm->dev, "%s: all_port_clk: %d, bus_clk: %d\n",
 		__func__, agg_clk, swrm->bus_clk);
@@ -1918,7 +2008,7 @@ static int swrm_connect_port(struct swr_master *master,
 		if (swrm->clk_stop_mode0_supp &&
 				swrm->dynamic_port_map_supported) {
 			mport->ch_rate += portinfo->ch_rate[i];
-			swrm_update_bus_clk(swrm);
+			swrm_update_bus_clk(swrm, true);
 		} else {
 			/*
 			 * Fallback to assign slave port ch_rate
@@ -1995,7 +2085,7 @@ static int swrm_disconnect_port(struct swr_master *master,
 				swrm->dynamic_port_map_supported &&
 				!mport->req_ch) {
 			mport->ch_rate = 0;
-			swrm_update_bus_clk(swrm);
+			swrm_update_bus_clk(swrm, false);
 		}
 		num_port++;
 	}
@@ -2543,6 +2633,8 @@ static int swrm_init_port_params(struct swr_master *mstr, u32 dev_num,
 			port_id_offset = (dev_num - 1) * SWR_MAX_DEV_PORT_NUM + j;
 			swrm->pp[i][port_id_offset].offset1 = uc_arr[i].pp[j].offset1;
 			swrm->pp[i][port_id_offset].lane_ctrl = uc_arr[i].pp[j].lane_ctrl;
+			if (uc_arr[i].pp[j].offset1 || uc_arr[i].pp[j].lane_ctrl)
+				swrm->pp_uc_mask |= (1 << i);
 		}
 	}
 	return 0;
@@ -199,6 +199,7 @@ struct swr_mstr_ctrl {
 	u32 is_always_on;
 	bool clk_stop_wakeup;
 	struct swr_port_params pp[SWR_UC_MAX][SWR_MAX_MSTR_PORT_NUM];/*max_devNum * max_ports 11 * 14 */
+	u32 pp_uc_mask; /* usecases for which slaves supplied port params */
 #ifdef CONFIG_DEBUG_FS
 	struct dentry *debugfs_swrm_dent;
 	struct dentry *debugfs_peek;
@@ -18,7 +18,8 @@
 enum bt_power_modes {
 	BT_POWER_DISABLE = 0,
 	BT_POWER_ENABLE,
-	BT_POWER_RETENTION
+	BT_POWER_RETENTION,
+	BT_POWER_STANDBY
 };
 
 struct log_index {
@@ -34,6 +35,7 @@ struct bt_power_vreg_data {
 	u32 load_curr;          /* current */
 	bool is_enabled;        /* is this regulator enabled? */
 	bool is_retention_supp; /* does this regulator support retention mode */
+	bool is_parked;         /* enabled but held at retention level */
 	struct log_index indx;  /* Index for reg. w.r.t init & crash */
 };
 
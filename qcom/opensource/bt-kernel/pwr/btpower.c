@@ -252,6 +252,15 @@ static int bt_major;
 static int soc_id;
 static bool probe_finished;
 
+/*
+ * Park retention capable regulators at retention on BT power off instead
+ * of switching them off, so the next power on only has to restore the
+ * voltage and load votes rather than run the full ramp up.
+ */
+static bool warm_standby;
+module_param(warm_standby, bool, 0644);
+MODULE_PARM_DESC(warm_standby, "Park BT regulators at retention on power off");
+
 static int btpower_get_temperature(struct btpower_platform_data *pdata,
 				   int *temp)
 {
@@ -387,7 +396,7 @@ static int bt_vreg_enable(struct bt_power_vreg_data *vreg)
 
 	pr_debug("%s: vreg_en for : %s\n", __func__, vreg->name);
 
-	if (!vreg->is_enabled) {
+	if (!vreg->is_enabled || vreg->is_parked) {
 		if ((vreg->min_vol != 0) && (vreg->max_vol != 0)) {
 			rc = regulator_set_voltage(vreg->reg,
 						vreg->min_vol,
@@ -409,6 +418,12 @@ static int bt_vreg_enable(struct bt_power_vreg_data *vreg)
 			}
 		}
 
+		/* Parked regulators are still on, only the votes changed */
+		if (vreg->is_parked) {
+			vreg->is_parked = false;
+			goto out;
+		}
+
 		rc = regulator_enable(vreg->reg);
 		if (rc < 0) {
 			pr_err("%s: regulator_enable(%s) failed. rc=%d\n",
@@ -445,8 +460,10 @@ static int bt_vreg_enable_retention(struct bt_power_vreg_data *vreg)
 			if (rc < 0) {
 				pr_err("%s: regulator_set_load(%s) failed rc=%d\n",
 				__func__, vreg->name, rc);
+				goto out;
 			}
 		}
+		vreg->is_parked = true;
 	}
 out:
 	return rc;
@@ -469,6 +486,7 @@ static int bt_vreg_disable(struct bt_power_vreg_data *vreg)
 			goto out;
 		}
 		vreg->is_enabled = false;
+		vreg->is_parked = false;
 
 		if ((vreg->min_vol != 0) && (vreg->max_vol != 0)) {
 			/* Set the min voltage to 0 */
@@ -785,6 +803,7 @@ static int bt_configure_gpios(int on)
 static int bluetooth_power(int on)
 {
 	int rc = 0;
+	bool standby = false;
 
 	pr_debug("%s: on: %d\n", __func__, on);
 
@@ -826,6 +845,7 @@ static int bluetooth_power(int on)
 		}
 	} else if (on == 0) {
 		// Power Off
+		standby = warm_standby;
 		if (bt_power_pdata->bt_gpio_sys_rst > 0) {
 			if (bt_power_pdata->bt_sec_hw_disable) {
 				pr_err("%s: secure hw mode on, not allowed to access gpio",
@@ -843,7 +863,7 @@ gpio_fail:
 			bt_clk_disable(bt_power_pdata->bt_chip_clk);
 clk_fail:
 regulator_fail:
-		bt_power_vreg_set(BT_POWER_DISABLE);
+		bt_power_vreg_set(standby ? BT_POWER_STANDBY : BT_POWER_DISABLE);
 	} else if (on == 2) {
 		/* Retention mode */
 		bt_power_vreg_set(BT_POWER_RETENTION);
@@ -1083,6 +1103,14 @@ static int bt_power_vreg_set(enum bt_power_modes mode)
 			vreg_info = &bt_power_pdata->vreg_info[i];
 			ret = bt_vreg_enable_retention(vreg_info);
 		}
+	} else if (mode == BT_POWER_STANDBY) {
+		for (; i < num_vregs; i++) {
+			vreg_info = &bt_power_pdata->vreg_info[i];
+			if (vreg_info->is_retention_supp)
+				ret = bt_vreg_enable_retention(vreg_info);
+			else
+				ret = bt_vreg_disable(vreg_info);
+		}
 	} else {
 		pr_err("%s: Invalid power mode: %d\n", __func__, mode);
 		ret = -1;
@@ -1312,6 +1340,8 @@ static int bt_power_remove(struct platform_device *pdev)
 
 	probe_finished = false;
 	btpower_rfkill_remove(pdev);
+	/* Drop regulators left parked by warm standby */
+	bt_power_vreg_set(BT_POWER_DISABLE);
 	bt_power_vreg_put();
 
 	kfree(bt_power_pdata);
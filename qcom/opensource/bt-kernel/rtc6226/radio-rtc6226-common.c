@@ -127,6 +127,17 @@
 /* 1: 50 us (Europe, Australia, Japan) */
 static unsigned short de;
 
+/* Vendor init patches written after every chip unlock */
+static const struct rtc6226_reg_val rtc6226_init_patch[] = {
+	{ 0x40, 0x0038 },
+	{ 0x8E, 0xC100 },
+};
+
+/* Config registers replayed from the shadow copy on power up */
+static const u8 rtc6226_power_up_regs[] = {
+	MPXCFG, SYSCFG, PADCFG, I2SCFG,
+};
+
 wait_queue_head_t rtc6226_wq;
 int rtc6226_wq_flag = NO_WAIT;
 #ifdef New_VolumeControl
@@ -548,7 +559,6 @@ int rtc6226_start(struct rtc6226_device *radio)
 {
 	int retval;
 	u8 i2c_error;
-	u16 initbuf[] = {0x0000};
 
 	radio->registers[BANKCFG] = 0x0000;
 	i2c_error = 0;
@@ -583,6 +593,14 @@ int rtc6226_start(struct rtc6226_device *radio)
 		FMDERR("%s set to fail 0x96AA %d\n", __func__, retval);
 	msleep(30);
 
+	/*
+	 * Supplies stayed up since the last successful power up, so the
+	 * shadow copy still matches the chip and the ID and full register
+	 * reads can be skipped.
+	 */
+	if (radio->init_cached)
+		goto patch;
+
 	/* get device and chip versions */
 	rtc6226_get_register(radio, DEVICEID);
 	rtc6226_get_register(radio, CHIPID);
@@ -618,15 +636,10 @@ int rtc6226_start(struct rtc6226_device *radio)
 		radio->registers[DEVICEID], radio->registers[CHIPID],
 		radio->client->addr);
 
-	/* initial patch 01 */
-	initbuf[0] = 0x0038;
-	retval = rtc6226_set_serial_registers(radio, initbuf, 0x40);
-	if (retval < 0)
-		goto done;
-
-	/* initial patch 02 */
-	initbuf[0] = 0xC100;
-	retval = rtc6226_set_serial_registers(radio, initbuf, 0x8E);
+patch:
+	/* initial patch 01 and 02 */
+	retval = rtc6226_write_reg_seq(radio, rtc6226_init_patch,
+			ARRAY_SIZE(rtc6226_init_patch));
 	if (retval < 0)
 		goto done;
 
@@ -1450,27 +1463,20 @@ int rtc6226_power_up(struct rtc6226_device *radio)
 	radio->registers[MPXCFG] = 0x000c |
 		MPXCFG_CSR0_DIS_MUTE |
 		((de << 12) & MPXCFG_CSR0_DEEM);
-	retval = rtc6226_set_register(radio, MPXCFG);
-	if (retval < 0)
-		goto done;
 
 	/* enable RDS / STC interrupt */
 	radio->registers[SYSCFG] |= SYSCFG_CSR0_RDSIRQEN;
 	radio->registers[SYSCFG] |= SYSCFG_CSR0_STDIRQEN;
 	/*radio->registers[SYSCFG] |= SYSCFG_CSR0_RDS_EN;*/
-	retval = rtc6226_set_register(radio, SYSCFG);
-	if (retval < 0)
-		goto done;
 
 	radio->registers[PADCFG] &= ~PADCFG_CSR0_GPIO;
 	radio->registers[PADCFG] |= 0x1 << 2;
-	retval = rtc6226_set_register(radio, PADCFG);
-	if (retval < 0)
-		goto done;
 
 	/* I2S salve */
 	radio->registers[I2SCFG] = 0x2480;
-	retval = rtc6226_set_register(radio, I2SCFG);
+
+	retval = rtc6226_set_registers(radio, rtc6226_power_up_regs,
+			ARRAY_SIZE(rtc6226_power_up_regs));
 	if (retval < 0)
 		goto done;
 
@@ -1509,6 +1515,8 @@ int rtc6226_power_up(struct rtc6226_device *radio)
 		radio->registers[14], radio->registers[15]);
 
 done:
+	/* Only trust the shadow copy on the next start if this one worked */
+	radio->init_cached = (retval >= 0);
 	FMDBG("%s exit %d\n", __func__, retval);
 	mutex_unlock(&radio->lock);
 	return retval;
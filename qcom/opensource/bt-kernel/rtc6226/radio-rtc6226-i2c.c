@@ -168,6 +168,60 @@ int rtc6226_set_serial_registers(struct rtc6226_device *radio,
 	return 0;
 }
 
+/*
+ * rtc6226_write_reg_seq - write a register sequence in one transfer
+ *
+ * Each register write stays a separate message, so the chip sees the
+ * same START/addr/data framing as rtc6226_set_register(), but the whole
+ * sequence is queued to the adapter at once instead of paying a bus
+ * arbitration and a context switch per register.
+ */
+int rtc6226_write_reg_seq(struct rtc6226_device *radio,
+	const struct rtc6226_reg_val *seq, int cnt)
+{
+	u8 buf[RTC6226_MAX_SEQ_REGS][WRITE_REG_NUM];
+	struct i2c_msg msgs[RTC6226_MAX_SEQ_REGS];
+	int i;
+
+	if (cnt <= 0 || cnt > RTC6226_MAX_SEQ_REGS)
+		return -EINVAL;
+
+	for (i = 0; i < cnt; i++) {
+		buf[i][0] = seq[i].reg;
+		buf[i][1] = (u8)((seq[i].val >> 8) & 0xFF);
+		buf[i][2] = (u8)(seq[i].val & 0xFF);
+		msgs[i].addr = radio->client->addr;
+		msgs[i].flags = 0;
+		msgs[i].len = sizeof(u8) * WRITE_REG_NUM;
+		msgs[i].buf = buf[i];
+	}
+
+	if (i2c_transfer(radio->client->adapter, msgs, cnt) != cnt)
+		return -EIO;
+
+	return 0;
+}
+
+/*
+ * rtc6226_set_registers - replay shadow registers in one transfer
+ */
+int rtc6226_set_registers(struct rtc6226_device *radio,
+	const u8 *regnrs, int cnt)
+{
+	struct rtc6226_reg_val seq[RTC6226_MAX_SEQ_REGS];
+	int i;
+
+	if (cnt <= 0 || cnt > RTC6226_MAX_SEQ_REGS)
+		return -EINVAL;
+
+	for (i = 0; i < cnt; i++) {
+		seq[i].reg = regnrs[i];
+		seq[i].val = radio->registers[regnrs[i] & 0xFF];
+	}
+
+	return rtc6226_write_reg_seq(radio, seq, cnt);
+}
+
 /**************************************************************************
  * General Driver Functions - ENTIRE REGISTERS
  **************************************************************************/
@@ -573,6 +627,7 @@ int rtc6226_fops_open(struct file *file)
 
 open_err_req_irq:
 	rtc6226_fm_power_cfg(radio, TURNING_OFF);
+	radio->init_cached = false;
 open_err_setup:
 	atomic_dec(&radio->users);
 	return retval;
@@ -594,6 +649,8 @@ int rtc6226_fops_release(struct file *file)
 	rtc6226_disable_irq(radio);
 	atomic_dec(&radio->users);
 	retval = rtc6226_fm_power_cfg(radio, TURNING_OFF);
+	/* Supplies are gone, the chip starts from reset on next open */
+	radio->init_cached = false;
 	if (retval < 0)
 		FMDERR("%s: failed to apply voltage\n", __func__);
 	return retval;
@@ -222,6 +222,8 @@
 
 /* Write starts with the upper byte of register 0x02 */
 #define WRITE_REG_NUM       3
+/* Max register writes issued in a single i2c_transfer */
+#define RTC6226_MAX_SEQ_REGS 8
 #define WRITE_INDEX(i)      ((i + 0x02)%16)
 
 /* Read starts with the upper byte of register 0x0a */
@@ -490,6 +492,8 @@ struct rtc6226_device {
 	u8 rssi_th;
 	/* Richwave internal registers (0..15) */
 	unsigned short registers[RADIO_REGISTER_NUM];
+	/* shadow registers still match the chip since the last power up */
+	bool init_cached;
 
 	/* RDS receive buffer */
 	wait_queue_head_t read_queue;
@@ -557,6 +561,11 @@ struct rtc6226_device {
 	int lna_gain;
 };
 
+struct rtc6226_reg_val {
+	u8 reg;
+	u16 val;
+};
+
 enum radio_state_t {
 	FM_OFF,
 	FM_RECV,
@@ -678,6 +687,10 @@ extern int rtc6226_get_register(struct rtc6226_device *radio, int regnr);
 extern int rtc6226_set_register(struct rtc6226_device *radio, int regnr);
 extern int rtc6226_set_serial_registers(struct rtc6226_device *radio,
 	u16 *data, int bytes);
+extern int rtc6226_write_reg_seq(struct rtc6226_device *radio,
+	const struct rtc6226_reg_val *seq, int cnt);
+extern int rtc6226_set_registers(struct rtc6226_device *radio,
+	const u8 *regnrs, int cnt);
 int rtc6226_i2c_init(void);
 int rtc6226_reset_rds_data(struct rtc6226_device *radio);
 int rtc6226_set_freq(struct rtc6226_device *radio, unsigned int freq);
@@ -14,6 +14,7 @@
 #include <linux/ratelimit.h>
 #include <linux/slab.h>
 #include <linux/fs.h>
+#include <linux/ktime.h>
 #include <sound/pcm.h>
 #include <sound/pcm_params.h>
 #include <sound/soc.h>
@@ -38,6 +39,94 @@ static int btfm_num_ports_open;
 
 static bool is_registered = false;
 
+/* keep the slave enumerated and streams prepared across stream switches */
+static bool port_reuse;
+module_param(port_reuse, bool, 0664);
+MODULE_PARM_DESC(port_reuse, "keep slimbus ports configured across stream switches");
+
+static void btfm_slim_update_stats(struct btfmslim_switch_stats *stats,
+	ktime_t start, bool reused)
+{
+	uint32_t lat_us = ktime_us_delta(ktime_get(), start);
+
+	stats->count++;
+	if (reused)
+		stats->reused++;
+	stats->last_us = lat_us;
+	if (lat_us > stats->max_us)
+		stats->max_us = lat_us;
+	stats->total_us += lat_us;
+	BTFMSLIM_INFO("%u usecs (reused %d), count %u reused %u max %u avg %llu",
+		lat_us, reused, stats->count, stats->reused, stats->max_us,
+		div_u64(stats->total_us, stats->count));
+}
+
+/* Free the ports of a parked stream and forget its configuration */
+static void btfm_slim_release_parked_ch(struct btfmslim_ch *ch)
+{
+	int ret;
+
+	if (!ch->dai.parked)
+		return;
+
+	BTFMSLIM_INFO("releasing parked port: %d", ch->port);
+	ret = slim_stream_unprepare_disconnect_port(ch->dai.sruntime, false, true);
+	if (ret != 0)
+		BTFMSLIM_ERR("slim_stream_unprepare failed returned val = %d", ret);
+
+	ch->dai.sconfig.port_mask = 0;
+	kfree(ch->dai.sconfig.chs);
+	ch->dai.sconfig.chs = NULL;
+	ch->dai.sruntime = NULL;
+	ch->dai.parked = false;
+}
+
+static void btfm_slim_release_parked_chs(struct btfmslim *btfmslim)
+{
+	struct btfmslim_ch *ch;
+
+	for (ch = btfmslim->rx_chs; ch && ch->id != BTFM_SLIM_NUM_CODEC_DAIS; ch++)
+		btfm_slim_release_parked_ch(ch);
+	for (ch = btfmslim->tx_chs; ch && ch->id != BTFM_SLIM_NUM_CODEC_DAIS; ch++)
+		btfm_slim_release_parked_ch(ch);
+}
+
+/* Re-enable a parked stream whose configuration matches the request */
+static int btfm_slim_resume_parked_ch(struct btfmslim *btfmslim,
+	struct btfmslim_ch *chan, uint8_t rxport, uint32_t rates, uint8_t nchan)
+{
+	struct btfmslim_ch *ch = chan;
+	int ret = 0;
+	int i;
+
+	if (chan->dai.sconfig.rate != rates ||
+	    chan->dai.sconfig.ch_count != nchan ||
+	    chan->dai.sconfig.bps != btfmslim->bps ||
+	    chan->dai.sconfig.direction != btfmslim->direction)
+		return -EINVAL;
+
+	for (i = 0; i < nchan; i++, ch++) {
+		if (btfmslim->vendor_port_en) {
+			ret = btfmslim->vendor_port_en(btfmslim, ch->port,
+					rxport, 1);
+			if (ret < 0) {
+				BTFMSLIM_ERR("vendor_port_en failed ret[%d]",
+					ret);
+				return ret;
+			}
+		}
+	}
+
+	ret = slim_stream_enable(chan->dai.sruntime);
+	if (ret) {
+		BTFMSLIM_ERR("slim_stream_enable failed = %d", ret);
+		return ret;
+	}
+	chan->dai.parked = false;
+
+	return 0;
+}
+
 int btfm_slim_write(struct btfmslim *btfmslim,
 		uint16_t reg, uint8_t reg_val, uint8_t pgd)
 {
@@ -99,12 +188,27 @@ int btfm_slim_enable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 	int i = 0;
 	struct btfmslim_ch *chan = ch;
 	int chipset_ver;
+	ktime_t start = ktime_get();
 
 	if (!btfmslim || !ch)
 		return -EINVAL;
 
 	BTFMSLIM_DBG("port: %d ch: %d", ch->port, ch->ch);
 
+	if (chan->dai.parked) {
+		ret = btfm_slim_resume_parked_ch(btfmslim, chan, rxport,
+				rates, nchan);
+		if (ret == 0) {
+			btfm_num_ports_open++;
+			BTFMSLIM_INFO("reused port: %d, btfm_num_ports_open: %d",
+				chan->port, btfm_num_ports_open);
+			btfm_slim_update_stats(&btfmslim->open_stats, start, true);
+			return 0;
+		}
+		/* configuration changed, set the stream up from scratch */
+		btfm_slim_release_parked_ch(chan);
+	}
+
 	chan->dai.sruntime = slim_stream_allocate(btfmslim->slim_pgd, "BTFM_SLIM");
 	if (chan->dai.sruntime == NULL) {
 		BTFMSLIM_ERR("slim_stream_allocate failed");
@@ -161,6 +265,7 @@ int btfm_slim_enable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 	if (ret == 0)
 		btfm_num_ports_open++;
 	BTFMSLIM_INFO("btfm_num_ports_open: %d", btfm_num_ports_open);
+	btfm_slim_update_stats(&btfmslim->open_stats, start, false);
 	return ret;
 error:
 	BTFMSLIM_INFO("error %d while opening port, btfm_num_ports_open: %d",
@@ -176,17 +281,23 @@ int btfm_slim_disable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 	int ret = -1;
 	int i = 0;
 	int chipset_ver = 0;
+	struct btfmslim_ch *chan = ch;
+	bool park = port_reuse;
+	ktime_t start = ktime_get();
+
 	if (!btfmslim || !ch)
 		return -EINVAL;
 
 	BTFMSLIM_INFO("port:%d ", ch->port);
-	if (ch->dai.sruntime == NULL) {
+	if (ch->dai.sruntime == NULL || ch->dai.parked) {
 		BTFMSLIM_ERR("Channel not enabled yet. returning");
 		return -EINVAL;
 	}
 
 	if (rxport && (btfmslim->sample_rate == 44100 ||
 		btfmslim->sample_rate == 88200)) {
+		/* the ports are disconnected below, nothing left to reuse */
+		park = false;
 		BTFMSLIM_INFO("disconnecting the ports, removing the channel");
 		/* disconnect the ports of the stream */
 		ret = slim_stream_unprepare_disconnect_port(ch->dai.sruntime,
@@ -198,6 +309,7 @@ int btfm_slim_disable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 	ret = slim_stream_disable(ch->dai.sruntime);
 	if (ret != 0) {
 		BTFMSLIM_ERR("slim_stream_disable failed returned val = %d", ret);
+		park = false;
 		if ((btfmslim->sample_rate != 44100) && (btfmslim->sample_rate != 88200)) {
 			/* disconnect the ports of the stream */
 			ret = slim_stream_unprepare_disconnect_port(ch->dai.sruntime,
@@ -207,10 +319,13 @@ int btfm_slim_disable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 		}
 	}
 
-	/* free the ports allocated to the stream */
-	ret = slim_stream_unprepare_disconnect_port(ch->dai.sruntime, false, true);
-	if (ret != 0)
-		BTFMSLIM_ERR("slim_stream_unprepare failed returned val = %d", ret);
+	/* free the ports allocated to the stream, unless kept for reuse */
+	if (!park) {
+		ret = slim_stream_unprepare_disconnect_port(ch->dai.sruntime,
+				false, true);
+		if (ret != 0)
+			BTFMSLIM_ERR("slim_stream_unprepare failed returned val = %d", ret);
+	}
 
 	/* Disable port through registration setting */
 	for (i = 0; i < nchan; i++, ch++) {
@@ -223,19 +338,23 @@ int btfm_slim_disable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 			}
 		}
 	}
-	ch->dai.sconfig.port_mask = 0;
-	if (ch->dai.sconfig.chs != NULL) {
-		kfree(ch->dai.sconfig.chs);
-		BTFMSLIM_INFO("setting ch->dai.sconfig.chs to NULL");
-		ch->dai.sconfig.chs = NULL;
-	} else
-		BTFMSLIM_ERR("ch->dai.sconfig.chs is already NULL");
+	if (park) {
+		BTFMSLIM_INFO("parking port: %d for reuse", chan->port);
+		chan->dai.parked = true;
+	} else {
+		chan->dai.sconfig.port_mask = 0;
+		if (chan->dai.sconfig.chs != NULL) {
+			kfree(chan->dai.sconfig.chs);
+			BTFMSLIM_INFO("setting ch->dai.sconfig.chs to NULL");
+			chan->dai.sconfig.chs = NULL;
+		} else
+			BTFMSLIM_ERR("ch->dai.sconfig.chs is already NULL");
+		chan->dai.sruntime = NULL;
+	}
 
 	if (btfm_num_ports_open > 0)
 		btfm_num_ports_open--;
 
-	ch->dai.sruntime = NULL;
-
 	BTFMSLIM_INFO("btfm_num_ports_open: %d", btfm_num_ports_open);
 
 	chipset_ver = btpower_get_chipset_version();
@@ -254,6 +373,7 @@ int btfm_slim_disable_ch(struct btfmslim *btfmslim, struct btfmslim_ch *ch,
 		msleep(DELAY_FOR_PORT_OPEN_MS);
 	}
 
+	btfm_slim_update_stats(&btfmslim->close_stats, start, park);
 	return ret;
 }
 
@@ -519,6 +639,14 @@ int btfm_slim_hw_deinit(struct btfmslim *btfmslim)
 		BTFMSLIM_DBG("Already disabled");
 		return 0;
 	}
+	/*
+	 * The logical addresses and vendor init survive while the slave
+	 * stays on the bus, btfm_slim_status() drops them when it leaves.
+	 */
+	if (port_reuse) {
+		BTFMSLIM_DBG("keeping slave enabled for reuse");
+		return 0;
+	}
 	mutex_lock(&btfmslim->io_lock);
 	btfmslim->enabled = 0;
 	mutex_unlock(&btfmslim->io_lock);
@@ -594,6 +722,15 @@ static int btfm_slim_status(struct slim_device *sdev,
 	struct btfmslim *btfm_slim;
 	btfm_slim = dev_get_drvdata(dev);
 
+	if (status != SLIM_DEVICE_STATUS_UP && btfm_slim) {
+		BTFMSLIM_INFO("slave status %d, dropping cached port state",
+			status);
+		mutex_lock(&btfm_slim->io_lock);
+		btfm_slim->enabled = 0;
+		btfm_slim_release_parked_chs(btfm_slim);
+		mutex_unlock(&btfm_slim->io_lock);
+	}
+
 #if IS_ENABLED(CONFIG_BTFM_SLIM)
 	if (!is_registered) {
 		ret = btfm_slim_register_codec(btfm_slim);
@@ -43,6 +43,8 @@ enum {
 struct btfm_slim_codec_dai_data {
 	struct slim_stream_config sconfig;
 	struct slim_stream_runtime *sruntime;
+	/* stream disabled but left prepared for the next open */
+	bool parked;
 };
 
 struct btfmslim_ch {
@@ -56,6 +58,15 @@ struct btfmslim_ch {
 /* Slimbus Port defines - This should be redefined in specific device file */
 #define BTFM_SLIM_PGD_PORT_LAST				0xFF
 
+/* time taken to open or close a stream, in usecs */
+struct btfmslim_switch_stats {
+	uint32_t count;
+	uint32_t reused;
+	uint32_t last_us;
+	uint32_t max_us;
+	uint64_t total_us;
+};
+
 struct btfmslim {
 	struct device *dev;
 	struct slim_device *slim_pgd; //Physical address
@@ -73,6 +84,8 @@ struct btfmslim {
 	int (*vendor_init)(struct btfmslim *btfmslim);
 	int (*vendor_port_en)(struct btfmslim *btfmslim, uint8_t port_num,
 		uint8_t rxport, uint8_t enable);
+	struct btfmslim_switch_stats open_stats;
+	struct btfmslim_switch_stats close_stats;
 #if IS_ENABLED(CONFIG_SLIM_BTFM_CODEC)
 	int device_id;
 #endif
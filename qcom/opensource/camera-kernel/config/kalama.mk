@@ -21,3 +21,6 @@ KBUILD_CPPFLAGS += -DCONFIG_MSM_MMRM=1
 ifeq ($(CONFIG_QCOM_VA_MINIDUMP), y)
 KBUILD_CPPFLAGS += -DCONFIG_QCOM_VA_MINIDUMP=1
 endif
+ifeq ($(CONFIG_QTI_HW_FENCE), y)
+KBUILD_CPPFLAGS += -DCONFIG_QTI_HW_FENCE=1
+endif
@@ -7,11 +7,236 @@
 #include <linux/slab.h>
 #include <linux/uaccess.h>
 #include <linux/refcount.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/sort.h>
 
 #include "cam_context.h"
 #include "cam_debug_util.h"
 #include "cam_node.h"
 #include "cam_context_utils.h"
+#include "cam_trace.h"
+
+static struct dentry *cam_ctx_latency_root;
+static DEFINE_MUTEX(cam_ctx_latency_mutex);
+
+static const char *cam_ctx_latency_stage_names[CAM_CTX_LATENCY_MAX] = {
+	"submit", "prepare", "apply", "sof", "buf_done", "signal",
+};
+
+static inline struct cam_ctx_latency_record *__cam_context_latency_slot(
+	struct cam_context *ctx, uint64_t req_id)
+{
+	return &ctx->lat_ring[req_id % CAM_CTX_LATENCY_RING_SIZE];
+}
+
+void cam_context_latency_begin(struct cam_context *ctx, uint64_t req_id)
+{
+	struct cam_ctx_latency_record *rec;
+	unsigned long flags;
+
+	if (!ctx->lat_ring || !req_id)
+		return;
+
+	spin_lock_irqsave(&ctx->lat_lock, flags);
+	rec = __cam_context_latency_slot(ctx, req_id);
+	memset(rec, 0, sizeof(*rec));
+	rec->req_id = req_id;
+	rec->ts[CAM_CTX_LATENCY_SUBMIT] = ctx->lat_submit_ts ?
+		ctx->lat_submit_ts : ktime_get_ns();
+	rec->ts[CAM_CTX_LATENCY_PREPARE] = ktime_get_ns();
+	spin_unlock_irqrestore(&ctx->lat_lock, flags);
+
+	trace_cam_req_latency(ctx, req_id, CAM_CTX_LATENCY_PREPARE,
+		rec->ts[CAM_CTX_LATENCY_PREPARE] - rec->ts[CAM_CTX_LATENCY_SUBMIT]);
+}
+
+void cam_context_latency_mark(struct cam_context *ctx, uint64_t req_id,
+	enum cam_ctx_latency_stage stage)
+{
+	struct cam_ctx_latency_record *rec;
+	unsigned long flags;
+	uint64_t delta = 0;
+	bool marked = false;
+
+	if (!ctx->lat_ring || !req_id || stage >= CAM_CTX_LATENCY_MAX)
+		return;
+
+	spin_lock_irqsave(&ctx->lat_lock, flags);
+	rec = __cam_context_latency_slot(ctx, req_id);
+	if ((rec->req_id == req_id) && !rec->ts[stage]) {
+		rec->ts[stage] = ktime_get_ns();
+		delta = rec->ts[stage] - rec->ts[CAM_CTX_LATENCY_SUBMIT];
+		marked = true;
+	}
+	spin_unlock_irqrestore(&ctx->lat_lock, flags);
+
+	if (marked)
+		trace_cam_req_latency(ctx, req_id, stage, delta);
+}
+
+static int __cam_context_latency_snapshot(struct cam_context *ctx,
+	struct cam_ctx_latency_record *buf)
+{
+	struct cam_ctx_latency_record *rec;
+	unsigned long flags;
+	uint64_t max_req = 0;
+	int i, num = 0;
+
+	spin_lock_irqsave(&ctx->lat_lock, flags);
+	for (i = 0; i < CAM_CTX_LATENCY_RING_SIZE; i++)
+		max_req = max(max_req, ctx->lat_ring[i].req_id);
+
+	/* Walk the slots oldest first starting after the latest request */
+	for (i = 1; i <= CAM_CTX_LATENCY_RING_SIZE; i++) {
+		rec = __cam_context_latency_slot(ctx, max_req + i);
+		if (rec->req_id)
+			buf[num++] = *rec;
+	}
+	spin_unlock_irqrestore(&ctx->lat_lock, flags);
+
+	return num;
+}
+
+static ssize_t cam_context_latency_read(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct cam_context *ctx = file->private_data;
+	struct cam_ctx_latency_record *buf;
+	ssize_t rc;
+	int num;
+
+	buf = kcalloc(CAM_CTX_LATENCY_RING_SIZE, sizeof(*buf), GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	num = __cam_context_latency_snapshot(ctx, buf);
+	rc = simple_read_from_buffer(ubuf, count, ppos, buf,
+		num * sizeof(*buf));
+	kfree(buf);
+
+	return rc;
+}
+
+static const struct file_operations cam_context_latency_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.read = cam_context_latency_read,
+	.llseek = default_llseek,
+};
+
+static int __cam_context_latency_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int cam_context_latency_pct_show(struct seq_file *m, void *unused)
+{
+	struct cam_context *ctx = m->private;
+	struct cam_ctx_latency_record *buf;
+	uint64_t *delta;
+	int i, j, n, num;
+
+	buf = kcalloc(CAM_CTX_LATENCY_RING_SIZE, sizeof(*buf), GFP_KERNEL);
+	delta = kcalloc(CAM_CTX_LATENCY_RING_SIZE, sizeof(*delta), GFP_KERNEL);
+	if (!buf || !delta) {
+		kfree(buf);
+		kfree(delta);
+		return -ENOMEM;
+	}
+
+	num = __cam_context_latency_snapshot(ctx, buf);
+	seq_printf(m, "%s ctx %u: %d requests, latency from submit in us\n",
+		ctx->dev_name, ctx->ctx_id, num);
+	seq_printf(m, "%-10s %8s %8s %8s %8s %8s\n", "stage", "count",
+		"p50", "p90", "p99", "max");
+
+	for (i = CAM_CTX_LATENCY_PREPARE; i < CAM_CTX_LATENCY_MAX; i++) {
+		for (j = 0, n = 0; j < num; j++) {
+			if (!buf[j].ts[i] || !buf[j].ts[CAM_CTX_LATENCY_SUBMIT])
+				continue;
+			delta[n++] = div_u64(buf[j].ts[i] -
+				buf[j].ts[CAM_CTX_LATENCY_SUBMIT], 1000);
+		}
+
+		if (!n) {
+			seq_printf(m, "%-10s %8d\n",
+				cam_ctx_latency_stage_names[i], 0);
+			continue;
+		}
+
+		sort(delta, n, sizeof(*delta), __cam_context_latency_cmp, NULL);
+		seq_printf(m, "%-10s %8d %8llu %8llu %8llu %8llu\n",
+			cam_ctx_latency_stage_names[i], n,
+			delta[(n * 50) / 100], delta[(n * 90) / 100],
+			delta[(n * 99) / 100], delta[n - 1]);
+	}
+
+	kfree(delta);
+	kfree(buf);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cam_context_latency_pct);
+
+static void cam_context_latency_init(struct cam_context *ctx)
+{
+	char name[CAM_CTX_DEV_NAME_MAX_LENGTH + 16];
+
+	spin_lock_init(&ctx->lat_lock);
+	ctx->lat_ring = kcalloc(CAM_CTX_LATENCY_RING_SIZE,
+		sizeof(*ctx->lat_ring), GFP_KERNEL);
+	if (!ctx->lat_ring) {
+		CAM_WARN(CAM_CORE, "[%s][%u] no latency records",
+			ctx->dev_name, ctx->ctx_id);
+		return;
+	}
+
+	if (!cam_debugfs_available())
+		return;
+
+	mutex_lock(&cam_ctx_latency_mutex);
+	if (!cam_ctx_latency_root &&
+		cam_debugfs_create_subdir("ctx_latency", &cam_ctx_latency_root))
+		cam_ctx_latency_root = NULL;
+	mutex_unlock(&cam_ctx_latency_mutex);
+
+	if (!cam_ctx_latency_root)
+		return;
+
+	snprintf(name, sizeof(name), "%s_%u", ctx->dev_name, ctx->ctx_id);
+	ctx->lat_dentry = debugfs_create_file(name, 0400,
+		cam_ctx_latency_root, ctx, &cam_context_latency_fops);
+
+	snprintf(name, sizeof(name), "%s_%u_pct", ctx->dev_name, ctx->ctx_id);
+	ctx->lat_pct_dentry = debugfs_create_file(name, 0400,
+		cam_ctx_latency_root, ctx, &cam_context_latency_pct_fops);
+}
+
+static void cam_context_latency_deinit(struct cam_context *ctx)
+{
+	debugfs_remove(ctx->lat_pct_dentry);
+	debugfs_remove(ctx->lat_dentry);
+	ctx->lat_pct_dentry = NULL;
+	ctx->lat_dentry = NULL;
+
+	kfree(ctx->lat_ring);
+	ctx->lat_ring = NULL;
+}
+
+static void cam_context_latency_reset(struct cam_context *ctx)
+{
+	unsigned long flags;
+
+	if (!ctx->lat_ring)
+		return;
+
+	spin_lock_irqsave(&ctx->lat_lock, flags);
+	memset(ctx->lat_ring, 0,
+		CAM_CTX_LATENCY_RING_SIZE * sizeof(*ctx->lat_ring));
+	spin_unlock_irqrestore(&ctx->lat_lock, flags);
+}
 
 static int cam_context_handle_hw_event(void *context, uint32_t evt_id,
 	void *evt_data)
@@ -381,6 +606,9 @@ int cam_context_handle_acquire_dev(struct cam_context *ctx,
 		rc = -EPROTO;
 	}
 
+	if (!rc)
+		cam_context_latency_reset(ctx);
+
 	INIT_LIST_HEAD(&ctx->active_req_list);
 	INIT_LIST_HEAD(&ctx->wait_req_list);
 	INIT_LIST_HEAD(&ctx->pending_req_list);
@@ -528,6 +756,7 @@ int cam_context_handle_config_dev(struct cam_context *ctx,
 	}
 
 	mutex_lock(&ctx->ctx_mutex);
+	ctx->lat_submit_ts = ktime_get_ns();
 	if (ctx->state_machine[ctx->state].ioctl_ops.config_dev) {
 		rc = ctx->state_machine[ctx->state].ioctl_ops.config_dev(
 			ctx, cmd);
@@ -536,6 +765,7 @@ int cam_context_handle_config_dev(struct cam_context *ctx,
 			ctx->dev_hdl, ctx->state);
 		rc = -EPROTO;
 	}
+	ctx->lat_submit_ts = 0;
 	mutex_unlock(&ctx->ctx_mutex);
 
 	return rc;
@@ -746,6 +976,8 @@ int cam_context_init(struct cam_context *ctx,
 	ctx->dbg_frame     = 0;
 	ctx->exlink        =-1;
 	ctx->batchsize     = 1;
+
+	cam_context_latency_init(ctx);
 	return 0;
 }
 
@@ -762,6 +994,7 @@ int cam_context_deinit(struct cam_context *ctx)
 	if (ctx->state != CAM_CTX_AVAILABLE)
 		CAM_ERR(CAM_CORE, "Device did not shutdown cleanly");
 
+	cam_context_latency_deinit(ctx);
 	memset(ctx, 0, sizeof(*ctx));
 
 	return 0;
@@ -39,6 +39,29 @@ struct cam_context;
 /* Number of words to be dumped for context*/
 #define CAM_CTXT_DUMP_NUM_WORDS 10
 
+/* Number of request latency records kept per context */
+#define CAM_CTX_LATENCY_RING_SIZE 32
+
+/**
+ * enum cam_ctx_latency_stage - Request stages tracked for latency
+ *
+ * @CAM_CTX_LATENCY_SUBMIT:   Config ioctl received from userspace
+ * @CAM_CTX_LATENCY_PREPARE:  Packet prepared by the hw manager
+ * @CAM_CTX_LATENCY_APPLY:    Request applied by the request manager
+ * @CAM_CTX_LATENCY_SOF:      First SOF reported for the request
+ * @CAM_CTX_LATENCY_BUF_DONE: First buf done received for the request
+ * @CAM_CTX_LATENCY_SIGNAL:   All output fences of the request signaled
+ */
+enum cam_ctx_latency_stage {
+	CAM_CTX_LATENCY_SUBMIT,
+	CAM_CTX_LATENCY_PREPARE,
+	CAM_CTX_LATENCY_APPLY,
+	CAM_CTX_LATENCY_SOF,
+	CAM_CTX_LATENCY_BUF_DONE,
+	CAM_CTX_LATENCY_SIGNAL,
+	CAM_CTX_LATENCY_MAX,
+};
+
 /**
  * enum cam_ctx_state -  context top level states
  *
@@ -226,6 +249,11 @@ struct cam_ctx_ops {
  * @out_map_entries:       Out map entry
  * @mini dump cb:          Mini dump cb
  * @img_iommu_hdl:         Image IOMMU handle
+ * @lat_ring:              Per request latency records, indexed by request id
+ * @lat_lock:              Spin lock protecting the latency records
+ * @lat_submit_ts:         Timestamp of the config ioctl being processed
+ * @lat_dentry:            Debugfs entry exporting the latency records
+ * @lat_pct_dentry:        Debugfs entry exporting the latency percentiles
  *
  */
 struct cam_context {
@@ -272,6 +300,11 @@ struct cam_context {
 	struct cam_hw_fence_map_entry **out_map_entries;
 	cam_ctx_mini_dump_cb_func      mini_dump_cb;
 	int                            img_iommu_hdl;
+	struct cam_ctx_latency_record *lat_ring;
+	spinlock_t                     lat_lock;
+	uint64_t                       lat_submit_ts;
+	struct dentry                 *lat_dentry;
+	struct dentry                 *lat_pct_dentry;
 	/*xiaomi added*/
 	uint64_t                       dbg_timestamp;
 	uint64_t                       dbg_frame;
@@ -280,6 +313,17 @@ struct cam_context {
 
 };
 
+/**
+ * struct cam_ctx_latency_record - Timestamps of one request
+ *
+ * @req_id:      Request id the record belongs to
+ * @ts:          Monotonic timestamp in ns for each stage, 0 if not reached
+ */
+struct cam_ctx_latency_record {
+	uint64_t  req_id;
+	uint64_t  ts[CAM_CTX_LATENCY_MAX];
+};
+
 /**
  * struct cam_context_dump_header -  Function for context dump header
  *
@@ -591,6 +635,32 @@ int cam_context_init(struct cam_context *ctx,
 		struct cam_ctx_request *req_list,
 		uint32_t req_size, int img_iommu_hdl);
 
+/**
+ * cam_context_latency_begin()
+ *
+ * @brief:        Start the latency record of a request, stamping the
+ *                submit and prepare stages
+ *
+ * @ctx:          Object pointer for cam_context
+ * @req_id:       Request id being prepared
+ *
+ */
+void cam_context_latency_begin(struct cam_context *ctx, uint64_t req_id);
+
+/**
+ * cam_context_latency_mark()
+ *
+ * @brief:        Stamp a stage in the latency record of a request. Only the
+ *                first occurrence of a stage is recorded.
+ *
+ * @ctx:          Object pointer for cam_context
+ * @req_id:       Request id the stage belongs to
+ * @stage:        Stage reached by the request
+ *
+ */
+void cam_context_latency_mark(struct cam_context *ctx, uint64_t req_id,
+	enum cam_ctx_latency_stage stage);
+
 /**
  * cam_context_putref()
  *
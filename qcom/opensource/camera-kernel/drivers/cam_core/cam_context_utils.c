@@ -194,6 +194,8 @@ int cam_context_buf_done_from_hw(struct cam_context *ctx,
 		struct cam_ctx_request, list);
 
 	trace_cam_buf_done("UTILS", ctx, req);
+	cam_context_latency_mark(ctx, req->request_id,
+		CAM_CTX_LATENCY_BUF_DONE);
 
 	if (done->request_id != req->request_id) {
 		CAM_ERR(CAM_CTXT,
@@ -245,6 +247,8 @@ int cam_context_buf_done_from_hw(struct cam_context *ctx,
 			done->evt_param);
 		req->out_map_entries[j].sync_id = -1;
 	}
+	cam_context_latency_mark(ctx, req->request_id,
+		CAM_CTX_LATENCY_SIGNAL);
 
 	if (cam_debug_ctx_req_list & ctx->dev_id)
 		CAM_INFO(CAM_CTXT,
@@ -308,6 +312,9 @@ static int cam_context_apply_req_to_hw(struct cam_ctx_request *req,
 			CAM_INFO(CAM_CTXT,
 				"[%s][%d] : Moving req[%llu] from active_list to free_list",
 				ctx->dev_name, ctx->ctx_id, req->request_id);
+	} else {
+		cam_context_latency_mark(ctx, req->request_id,
+			CAM_CTX_LATENCY_APPLY);
 	}
 
 end:
@@ -561,6 +568,7 @@ int32_t cam_context_prepare_dev_to_hw(struct cam_context *ctx,
 	req->request_id = packet->header.request_id;
 	req->status = 1;
 	req->req_priv = cfg.priv;
+	cam_context_latency_begin(ctx, req->request_id);
 
 	for (i = 0; i < req->num_out_map_entries; i++) {
 		rc = cam_sync_get_obj_ref(req->out_map_entries[i].sync_id);
@@ -10,6 +10,7 @@
 #include <linux/pm_opp.h>
 #include <linux/slab.h>
 #include <linux/module.h>
+#include <linux/seq_file.h>
 
 #include "cam_cpas_hw.h"
 #include "cam_cpas_hw_intf.h"
@@ -1575,6 +1576,78 @@ unlock_tree:
 	return rc;
 }
 
+/*
+ * Sample the camnoc queued fill levels and adapt the global scale of
+ * client ab votes: step down while all ports stay nearly empty, go back
+ * to the declared votes as soon as any port starts to back up.
+ */
+static void cam_cpas_bw_feedback_sample(struct cam_hw_info *cpas_hw,
+	uint32_t client_handle)
+{
+	struct cam_cpas *cpas_core = (struct cam_cpas *) cpas_hw->core_info;
+	struct cam_camnoc_info *camnoc_info =
+		(struct cam_camnoc_info *) cpas_core->camnoc_info;
+	struct cam_cpas_bw_feedback *bw_fb = &cpas_core->bw_fb;
+	uint32_t val = 0, max_fill = 0;
+	ktime_t now = ktime_get();
+	int i;
+
+	if (!camnoc_info ||
+		(ktime_ms_delta(now, bw_fb->last_sample) < bw_fb->sample_ms))
+		return;
+
+	bw_fb->last_sample = now;
+
+	for (i = 0; i < camnoc_info->specific_size; i++) {
+		if ((!camnoc_info->specific[i].enable) ||
+			(!camnoc_info->specific[i].maxwr_low.enable))
+			continue;
+
+		if (cam_cpas_hw_reg_read(cpas_hw, client_handle,
+			CAM_CPAS_REG_CAMNOC,
+			camnoc_info->specific[i].maxwr_low.offset, false, &val))
+			return;
+
+		max_fill = max_t(uint32_t, max_fill, val & 0x7FF);
+	}
+
+	bw_fb->last_max_fill = max_fill;
+	if (max_fill >= bw_fb->high_fill)
+		bw_fb->scale_pct = 100;
+	else if ((max_fill <= bw_fb->low_fill) &&
+		(bw_fb->scale_pct > bw_fb->min_pct))
+		bw_fb->scale_pct = max_t(uint32_t, bw_fb->min_pct,
+			bw_fb->scale_pct - CAM_CPAS_BW_FB_STEP_PCT);
+
+	CAM_DBG(CAM_PERF, "bw feedback max fill %u scale %u%%",
+		max_fill, bw_fb->scale_pct);
+}
+
+static void cam_cpas_bw_feedback_apply(struct cam_cpas *cpas_core,
+	struct cam_cpas_client *cpas_client, struct cam_axi_vote *axi_vote)
+{
+	uint32_t scale_pct = cpas_core->bw_fb.enable ?
+		clamp_t(uint32_t, cpas_core->bw_fb.scale_pct,
+			cpas_core->bw_fb.min_pct, 100) : 100;
+	uint64_t ab_bw;
+	int i;
+
+	cpas_client->declared_ab_bw = 0;
+	cpas_client->applied_ab_bw = 0;
+
+	for (i = 0; i < axi_vote->num_paths; i++) {
+		ab_bw = axi_vote->axi_path[i].mnoc_ab_bw;
+		cpas_client->declared_ab_bw += ab_bw;
+
+		if ((scale_pct < 100) && (ab_bw > CAM_CPAS_AXI_MIN_MNOC_AB_BW))
+			ab_bw = max_t(uint64_t, CAM_CPAS_AXI_MIN_MNOC_AB_BW,
+				div_u64(ab_bw * scale_pct, 100));
+
+		axi_vote->axi_path[i].mnoc_ab_bw = ab_bw;
+		cpas_client->applied_ab_bw += ab_bw;
+	}
+}
+
 static int cam_cpas_hw_update_axi_vote(struct cam_hw_info *cpas_hw,
 	uint32_t client_handle, struct cam_axi_vote *client_axi_vote)
 {
@@ -1628,6 +1701,10 @@ static int cam_cpas_hw_update_axi_vote(struct cam_hw_info *cpas_hw,
 	cam_cpas_dump_axi_vote_info(cpas_core->cpas_client[client_indx],
 		"Translated Vote", axi_vote);
 
+	if (cpas_core->bw_fb.enable)
+		cam_cpas_bw_feedback_sample(cpas_hw, client_handle);
+	cam_cpas_bw_feedback_apply(cpas_core, cpas_client, axi_vote);
+
 	rc = cam_cpas_util_apply_client_axi_vote(cpas_hw,
 		cpas_core->cpas_client[client_indx], axi_vote, CAM_CPAS_APPLY_TYPE_UPDATE);
 
@@ -3346,6 +3423,32 @@ static int cam_cpas_util_get_internal_ops(struct platform_device *pdev,
 	return rc;
 }
 
+static int cam_cpas_bw_feedback_show(struct seq_file *m, void *unused)
+{
+	struct cam_cpas *cpas_core = m->private;
+	struct cam_cpas_client *cpas_client;
+	int i;
+
+	seq_printf(m, "enable %d scale %u%% last max fill %u\n",
+		cpas_core->bw_fb.enable, cpas_core->bw_fb.scale_pct,
+		cpas_core->bw_fb.last_max_fill);
+
+	for (i = 0; i < cpas_core->num_clients; i++) {
+		cpas_client = cpas_core->cpas_client[i];
+		if (!cpas_client || !cpas_client->registered)
+			continue;
+
+		seq_printf(m, "%s%d: declared ab %llu applied ab %llu\n",
+			cpas_client->data.identifier,
+			cpas_client->data.cell_index,
+			cpas_client->declared_ab_bw,
+			cpas_client->applied_ab_bw);
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cam_cpas_bw_feedback);
+
 static int cam_cpas_util_create_debugfs(struct cam_cpas *cpas_core)
 {
 	int rc = 0;
@@ -3374,6 +3477,21 @@ static int cam_cpas_util_create_debugfs(struct cam_cpas *cpas_core)
 
 	debugfs_create_bool("force_hlos_drv", 0644,
 		cpas_core->dentry, &cpas_core->force_hlos_drv);
+
+	debugfs_create_bool("bw_feedback_enable", 0644,
+		cpas_core->dentry, &cpas_core->bw_fb.enable);
+
+	debugfs_create_u32("bw_feedback_min_pct", 0644,
+		cpas_core->dentry, &cpas_core->bw_fb.min_pct);
+
+	debugfs_create_u32("bw_feedback_low_fill", 0644,
+		cpas_core->dentry, &cpas_core->bw_fb.low_fill);
+
+	debugfs_create_u32("bw_feedback_high_fill", 0644,
+		cpas_core->dentry, &cpas_core->bw_fb.high_fill);
+
+	debugfs_create_file("bw_feedback", 0444,
+		cpas_core->dentry, cpas_core, &cam_cpas_bw_feedback_fops);
 end:
 	return rc;
 }
@@ -3420,6 +3538,11 @@ int cam_cpas_hw_probe(struct platform_device *pdev,
 	cpas_core->ahb_bus_scaling_disable = false;
 	cpas_core->full_state_dump = true;
 	cpas_core->smart_qos_dump = false;
+	cpas_core->bw_fb.sample_ms = CAM_CPAS_BW_FB_SAMPLE_MS;
+	cpas_core->bw_fb.min_pct = CAM_CPAS_BW_FB_MIN_PCT;
+	cpas_core->bw_fb.low_fill = CAM_CPAS_BW_FB_LOW_FILL;
+	cpas_core->bw_fb.high_fill = CAM_CPAS_BW_FB_HIGH_FILL;
+	cpas_core->bw_fb.scale_pct = 100;
 
 	atomic64_set(&cpas_core->monitor_head, -1);
 
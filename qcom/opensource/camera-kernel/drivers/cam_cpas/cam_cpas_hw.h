@@ -25,6 +25,12 @@
 #define CAM_CPAS_TRANSACTION_MAX             2
 #define CAM_CAMNOC_FILL_LVL_REG_INFO_MAX     6
 
+#define CAM_CPAS_BW_FB_SAMPLE_MS             100
+#define CAM_CPAS_BW_FB_MIN_PCT               80
+#define CAM_CPAS_BW_FB_STEP_PCT              5
+#define CAM_CPAS_BW_FB_LOW_FILL              8
+#define CAM_CPAS_BW_FB_HIGH_FILL             64
+
 #define CAM_CPAS_AXI_MIN_MNOC_AB_BW   (2048 * 1024)
 #define CAM_CPAS_AXI_MIN_MNOC_IB_BW   (2048 * 1024)
 #define CAM_CPAS_AXI_MIN_CAMNOC_AB_BW (2048 * 1024)
@@ -190,6 +196,8 @@ struct cam_cpas_reg {
  * @axi_vote: Determined/Applied axi vote for the client
  * @axi_port: Client's parent axi port
  * @tree_node: All granular path voting nodes for the client
+ * @declared_ab_bw: Sum of mnoc ab bw of the last vote as requested by client
+ * @applied_ab_bw: Sum of mnoc ab bw of the last vote after bw feedback
  *
  */
 struct cam_cpas_client {
@@ -203,6 +211,31 @@ struct cam_cpas_client {
 	struct cam_cpas_axi_port *axi_port;
 	struct cam_cpas_tree_node *tree_node[CAM_CPAS_PATH_DATA_MAX]
 		[CAM_CPAS_TRANSACTION_MAX];
+	uint64_t declared_ab_bw;
+	uint64_t applied_ab_bw;
+};
+
+/**
+ * struct cam_cpas_bw_feedback : Bandwidth feedback from camnoc fill levels
+ *
+ * @enable: Whether client mnoc ab votes are scaled by measured traffic
+ * @sample_ms: Min interval between two camnoc fill level samples
+ * @min_pct: Lower bound of the applied ab vote in percent of declared
+ * @low_fill: Max fill level below which votes are stepped down
+ * @high_fill: Fill level at which votes are restored to declared
+ * @scale_pct: Currently applied percentage of declared ab votes
+ * @last_max_fill: Max queued fill level across ports at the last sample
+ * @last_sample: Timestamp of the last sample
+ */
+struct cam_cpas_bw_feedback {
+	bool enable;
+	uint32_t sample_ms;
+	uint32_t min_pct;
+	uint32_t low_fill;
+	uint32_t high_fill;
+	uint32_t scale_pct;
+	uint32_t last_max_fill;
+	ktime_t last_sample;
 };
 
 /**
@@ -349,6 +382,7 @@ struct cam_cpas_monitor {
  *                    config issues
  * @smmu_fault_handled: Handled address decode error, on fault at SMMU
  * @force_hlos_drv: Whether to force disable DRV voting
+ * @bw_fb: Bandwidth feedback state
  */
 struct cam_cpas {
 	struct cam_cpas_hw_caps hw_caps;
@@ -380,6 +414,7 @@ struct cam_cpas {
 	bool slave_err_irq_en;
 	bool smmu_fault_handled;
 	bool force_hlos_drv;
+	struct cam_cpas_bw_feedback bw_fb;
 };
 
 int cam_camsstop_get_internal_ops(struct cam_cpas_internal_ops *internal_ops);
@@ -930,18 +930,8 @@ static int32_t cam_cre_mgr_process_msg(void *priv, void *data)
 static int cam_cre_get_actual_clk_rate_idx(
 	struct cam_cre_ctx *ctx_data, uint32_t base_clk)
 {
-	int i;
-
-	for (i = 0; i < CAM_MAX_VOTE; i++)
-		if (ctx_data->clk_info.clk_rate[i] >= base_clk)
-			return i;
-
-	/*
-	 * Caller has to ensure returned index is within array
-	 * size bounds while accessing that index.
-	 */
-
-	return i;
+	return cam_common_util_get_clk_rate_idx(ctx_data->clk_info.clk_rate,
+		CAM_MAX_VOTE, base_clk);
 }
 
 static bool cam_cre_is_over_clk(struct cam_cre_hw_mgr *hw_mgr,
@@ -970,36 +960,15 @@ static bool cam_cre_is_over_clk(struct cam_cre_hw_mgr *hw_mgr,
 static int cam_cre_get_lower_clk_rate(struct cam_cre_hw_mgr *hw_mgr,
 	struct cam_cre_ctx *ctx_data, uint32_t base_clk)
 {
-	int i;
-
-	i = cam_cre_get_actual_clk_rate_idx(ctx_data, base_clk);
-
-	while (i > 0) {
-		if (ctx_data->clk_info.clk_rate[i - 1])
-			return ctx_data->clk_info.clk_rate[i - 1];
-		i--;
-	}
-
-	CAM_DBG(CAM_CRE, "Already clk at lower level");
-
-	return base_clk;
+	return cam_common_util_get_lower_clk_rate(ctx_data->clk_info.clk_rate,
+		CAM_MAX_VOTE, base_clk);
 }
 
 static int cam_cre_get_next_clk_rate(struct cam_cre_hw_mgr *hw_mgr,
 	struct cam_cre_ctx *ctx_data, uint32_t base_clk)
 {
-	int i;
-
-	i = cam_cre_get_actual_clk_rate_idx(ctx_data, base_clk);
-
-	while (i < CAM_MAX_VOTE - 1) {
-		if (ctx_data->clk_info.clk_rate[i + 1])
-			return ctx_data->clk_info.clk_rate[i + 1];
-		i++;
-	}
-
-	CAM_DBG(CAM_CRE, "Already clk at higher level");
-	return base_clk;
+	return cam_common_util_get_next_clk_rate(ctx_data->clk_info.clk_rate,
+		CAM_MAX_VOTE, base_clk);
 }
 
 static bool cam_cre_update_clk_overclk_free(struct cam_cre_hw_mgr *hw_mgr,
@@ -1072,13 +1041,8 @@ static int cam_cre_calc_total_clk(struct cam_cre_hw_mgr *hw_mgr,
 static int cam_cre_get_actual_clk_rate(struct cam_cre_hw_mgr *hw_mgr,
 	struct cam_cre_ctx *ctx_data, uint32_t base_clk)
 {
-	int i;
-
-	for (i = 0; i < CAM_MAX_VOTE; i++)
-		if (ctx_data->clk_info.clk_rate[i] >= base_clk)
-			return ctx_data->clk_info.clk_rate[i];
-
-	return base_clk;
+	return cam_common_util_get_actual_clk_rate(ctx_data->clk_info.clk_rate,
+		CAM_MAX_VOTE, base_clk);
 }
 
 static bool cam_cre_update_clk_busy(struct cam_cre_hw_mgr *hw_mgr,
@@ -1184,16 +1148,7 @@ static bool cam_cre_update_clk_free(struct cam_cre_hw_mgr *hw_mgr,
 static uint32_t cam_cre_mgr_calc_base_clk(uint32_t frame_cycles,
 	uint64_t budget)
 {
-	uint64_t mul = 1000000000;
-	uint64_t base_clk = frame_cycles * mul;
-
-	do_div(base_clk, budget);
-
-	CAM_DBG(CAM_CRE, "budget = %lld fc = %d ib = %lld base_clk = %lld",
-		budget, frame_cycles,
-		(long long)(frame_cycles * mul), base_clk);
-
-	return base_clk;
+	return cam_common_util_calc_base_clk(frame_cycles, budget);
 }
 
 static bool cam_cre_check_clk_update(struct cam_cre_hw_mgr *hw_mgr,
@@ -950,6 +950,8 @@ static int32_t cam_fd_mgr_workq_irq_cb(void *priv, void *data)
 	struct cam_fd_mgr_frame_request *frame_req = NULL;
 	enum cam_fd_hw_irq_type irq_type;
 	uint32_t evt_id = CAM_CTX_EVT_ID_ERROR;
+	bool next_submitted = false;
+	int submit_rc = 0;
 	int rc;
 
 	if (!data || !priv) {
@@ -1020,6 +1022,21 @@ static int32_t cam_fd_mgr_workq_irq_cb(void *priv, void *data)
 		}
 
 		evt_id = CAM_CTX_EVT_ID_SUCCESS;
+
+		/*
+		 * Results are out of the HW registers now, so start the next
+		 * pending frame before signalling this one. The HW then runs
+		 * while the context does its buffer done handling instead of
+		 * waiting for it.
+		 */
+		mutex_lock(&hw_device->lock);
+		hw_device->ready_to_process = true;
+		hw_device->req_id = -1;
+		hw_device->cur_hw_ctx = NULL;
+		mutex_unlock(&hw_device->lock);
+
+		submit_rc = cam_fd_mgr_util_submit_frame(hw_mgr, NULL);
+		next_submitted = true;
 	}
 
 	trace_cam_irq_handled("FD", irq_type);
@@ -1051,12 +1068,15 @@ notify_context:
 	 * reading current frame's results. Also, we need to set to IDLE state
 	 * in case some error happens after getting this irq callback
 	 */
-	mutex_lock(&hw_device->lock);
-	hw_device->ready_to_process = true;
-	hw_device->req_id = -1;
-	hw_device->cur_hw_ctx = NULL;
-	CAM_DBG(CAM_FD, "ready_to_process=%d", hw_device->ready_to_process);
-	mutex_unlock(&hw_device->lock);
+	if (!next_submitted) {
+		mutex_lock(&hw_device->lock);
+		hw_device->ready_to_process = true;
+		hw_device->req_id = -1;
+		hw_device->cur_hw_ctx = NULL;
+		CAM_DBG(CAM_FD, "ready_to_process=%d",
+			hw_device->ready_to_process);
+		mutex_unlock(&hw_device->lock);
+	}
 
 put_req_in_free_list:
 	rc = cam_fd_mgr_util_put_frame_req(&hw_mgr->frame_free_list,
@@ -1066,6 +1086,13 @@ put_req_in_free_list:
 		/* continue */
 	}
 
+	if (next_submitted) {
+		if (submit_rc)
+			CAM_ERR(CAM_FD, "Error while submit frame, rc=%d",
+				submit_rc);
+		return submit_rc;
+	}
+
 submit_next_frame:
 	/* Check if there are any frames pending for processing and submit */
 	rc = cam_fd_mgr_util_submit_frame(hw_mgr, NULL);
@@ -275,6 +275,8 @@ struct hfi_qtbl {
  * @msg_q_state: State of message queue
  * @priv: device private data
  * @dbg_lvl: debug level set to FW
+ * @cmd_q_reserve_idx: Command queue index up to which space has been
+ *                     reserved by writers, ahead of the published write index
  */
 struct hfi_info {
 	struct hfi_mem_info map;
@@ -289,6 +291,7 @@ struct hfi_info {
 	bool msg_q_state;
 	void *priv;
 	u64 dbg_lvl;
+	uint32_t cmd_q_reserve_idx;
 };
 
 #endif /* _CAM_HFI_REG_H_ */
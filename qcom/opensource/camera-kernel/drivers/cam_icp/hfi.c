@@ -12,6 +12,7 @@
 #include <linux/timer.h>
 #include <media/cam_icp.h>
 #include <linux/iopoll.h>
+#include <linux/rwsem.h>
 
 #include "cam_presil_hw_access.h"
 #include "cam_io_util.h"
@@ -42,8 +43,19 @@
 static struct hfi_info *g_hfi;
 unsigned int g_icp_mmu_hdl;
 
-static DEFINE_MUTEX(hfi_cmd_q_mutex);
+/*
+ * Command queue writers share the read side of hfi_cmd_q_rwsem and
+ * reserve space locklessly, init/deinit take the write side. The
+ * message and debug queues have independent readers.
+ */
+static DECLARE_RWSEM(hfi_cmd_q_rwsem);
 static DEFINE_MUTEX(hfi_msg_q_mutex);
+static DEFINE_MUTEX(hfi_dbg_q_mutex);
+
+static inline struct mutex *hfi_read_q_mutex(uint8_t q_id)
+{
+	return (q_id == Q_DBG) ? &hfi_dbg_q_mutex : &hfi_msg_q_mutex;
+}
 
 static int cam_hfi_presil_setup(struct hfi_mem_info *hfi_mem);
 static int cam_hfi_presil_set_init_request(void);
@@ -176,6 +188,7 @@ void cam_hfi_queue_dump(bool dump_queue_data)
 int hfi_write_cmd(void *cmd_ptr)
 {
 	uint32_t size_in_words, empty_space, new_write_idx, read_idx, temp;
+	uint32_t start_idx, q_size;
 	uint32_t *write_q, *write_ptr;
 	struct hfi_qtbl *q_tbl;
 	struct hfi_q_hdr *q;
@@ -186,7 +199,7 @@ int hfi_write_cmd(void *cmd_ptr)
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_read(&hfi_cmd_q_rwsem);
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "HFI interface not setup");
 		rc = -ENODEV;
@@ -203,6 +216,7 @@ int hfi_write_cmd(void *cmd_ptr)
 
 	q_tbl = (struct hfi_qtbl *)g_hfi->map.qtbl.kva;
 	q = &q_tbl->q_hdr[Q_CMD];
+	q_size = q->qhdr_q_size;
 
 	write_q = (uint32_t *)g_hfi->map.cmd_q.kva;
 
@@ -213,26 +227,39 @@ int hfi_write_cmd(void *cmd_ptr)
 		goto err;
 	}
 
-	read_idx = q->qhdr_read_idx;
-	empty_space = (q->qhdr_write_idx >= read_idx) ?
-		(q->qhdr_q_size - (q->qhdr_write_idx - read_idx)) :
-		(read_idx - q->qhdr_write_idx);
-	if (empty_space <= size_in_words) {
-		CAM_ERR(CAM_HFI, "failed: empty space %u, size_in_words %u",
-			empty_space, size_in_words);
-		rc = -EIO;
-		goto err;
-	}
+	/*
+	 * Writers stay on cpu between reserving their slot and publishing
+	 * it, so a later writer never waits on a preempted earlier one.
+	 */
+	preempt_disable();
+	do {
+		start_idx = READ_ONCE(g_hfi->cmd_q_reserve_idx);
+		read_idx = READ_ONCE(q->qhdr_read_idx);
+		empty_space = (start_idx >= read_idx) ?
+			(q_size - (start_idx - read_idx)) :
+			(read_idx - start_idx);
+		if (empty_space <= size_in_words) {
+			preempt_enable();
+			CAM_ERR(CAM_HFI,
+				"failed: empty space %u, size_in_words %u",
+				empty_space, size_in_words);
+			rc = -EIO;
+			goto err;
+		}
 
-	new_write_idx = q->qhdr_write_idx + size_in_words;
-	write_ptr = (uint32_t *)(write_q + q->qhdr_write_idx);
+		new_write_idx = start_idx + size_in_words;
+		if (new_write_idx >= q_size)
+			new_write_idx -= q_size;
+	} while (cmpxchg(&g_hfi->cmd_q_reserve_idx, start_idx,
+		new_write_idx) != start_idx);
 
-	if (new_write_idx < q->qhdr_q_size) {
+	write_ptr = (uint32_t *)(write_q + start_idx);
+
+	if (start_idx + size_in_words < q_size) {
 		memcpy(write_ptr, (uint8_t *)cmd_ptr,
 			size_in_words << BYTE_WORD_SHIFT);
 	} else {
-		new_write_idx -= q->qhdr_q_size;
-		temp = (size_in_words - new_write_idx) << BYTE_WORD_SHIFT;
+		temp = (q_size - start_idx) << BYTE_WORD_SHIFT;
 		memcpy(write_ptr, (uint8_t *)cmd_ptr, temp);
 		memcpy(write_q, (uint8_t *)cmd_ptr + temp,
 			new_write_idx << BYTE_WORD_SHIFT);
@@ -244,7 +271,12 @@ int hfi_write_cmd(void *cmd_ptr)
 	 */
 	wmb();
 
-	q->qhdr_write_idx = new_write_idx;
+	/* Publish in reservation order, earlier writers are still copying */
+	while (READ_ONCE(q->qhdr_write_idx) != start_idx)
+		cpu_relax();
+
+	WRITE_ONCE(q->qhdr_write_idx, new_write_idx);
+	preempt_enable();
 
 	/*
 	 * Before raising interrupt make sure command data is ready for
@@ -256,7 +288,7 @@ int hfi_write_cmd(void *cmd_ptr)
 	/* Ensure HOST2ICP trigger is received by FW */
 	wmb();
 err:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_read(&hfi_cmd_q_rwsem);
 	return rc;
 }
 
@@ -280,7 +312,7 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_msg_q_mutex);
+	mutex_lock(hfi_read_q_mutex(q_id));
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "hfi not set up yet");
 		rc = -ENODEV;
@@ -349,7 +381,7 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 	 */
 	wmb();
 err:
-	mutex_unlock(&hfi_msg_q_mutex);
+	mutex_unlock(hfi_read_q_mutex(q_id));
 	return rc;
 }
 #endif /* #ifndef CONFIG_CAM_PRESIL */
@@ -763,8 +795,9 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_write(&hfi_cmd_q_rwsem);
 	mutex_lock(&hfi_msg_q_mutex);
+	mutex_lock(&hfi_dbg_q_mutex);
 
 	if (!g_hfi) {
 		g_hfi = kzalloc(sizeof(struct hfi_info), GFP_KERNEL);
@@ -801,6 +834,7 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 	cmd_q_hdr->qhdr_pkt_drop_cnt = RESET;
 	cmd_q_hdr->qhdr_read_idx = RESET;
 	cmd_q_hdr->qhdr_write_idx = RESET;
+	g_hfi->cmd_q_reserve_idx = RESET;
 
 	/* setup firmware-to-Host message queue */
 	msg_q_hdr = &qtbl->q_hdr[Q_MSG];
@@ -980,16 +1014,18 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 
 	hfi_irq_enable(g_hfi);
 
-	mutex_unlock(&hfi_cmd_q_mutex);
+	mutex_unlock(&hfi_dbg_q_mutex);
 	mutex_unlock(&hfi_msg_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 
 	return rc;
 regions_fail:
 	kfree(g_hfi);
 	g_hfi = NULL;
 alloc_fail:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	mutex_unlock(&hfi_dbg_q_mutex);
 	mutex_unlock(&hfi_msg_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 	return rc;
 }
 
@@ -1000,8 +1036,9 @@ void cam_hfi_deinit(void)
 		hfi_send_system_cmd(HFI_CMD_SYS_RESET, 0, 0);
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_write(&hfi_cmd_q_rwsem);
 	mutex_lock(&hfi_msg_q_mutex);
+	mutex_lock(&hfi_dbg_q_mutex);
 
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "hfi path not established yet");
@@ -1015,8 +1052,9 @@ void cam_hfi_deinit(void)
 	g_hfi = NULL;
 
 err:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	mutex_unlock(&hfi_dbg_q_mutex);
 	mutex_unlock(&hfi_msg_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 }
 
 
@@ -1059,7 +1097,7 @@ int hfi_write_cmd(void *cmd_ptr)
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_write(&hfi_cmd_q_rwsem);
 
 	presil_rc = cam_presil_hfi_write_cmd(cmd_ptr, (*(uint32_t *)cmd_ptr),
 		CAM_PRESIL_CLIENT_ID_CAMERA);
@@ -1071,7 +1109,7 @@ int hfi_write_cmd(void *cmd_ptr)
 		CAM_DBG(CAM_HFI, "presil rc %d", presil_rc);
 	}
 
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 	return rc;
 }
 
@@ -1090,7 +1128,7 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 		CAM_ERR(CAM_HFI, "Invalid q :%u", q_id);
 		return -EINVAL;
 	}
-	mutex_lock(&hfi_msg_q_mutex);
+	mutex_lock(hfi_read_q_mutex(q_id));
 
 	memset(pmsg, 0x0, sizeof(uint32_t) * 256 /* ICP_MSG_BUF_SIZE */);
 	*words_read = 0;
@@ -1105,7 +1143,7 @@ int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 		CAM_DBG(CAM_HFI, "presil rc %d", presil_rc);
 	}
 
-	mutex_unlock(&hfi_msg_q_mutex);
+	mutex_unlock(hfi_read_q_mutex(q_id));
 	return rc;
 }
 #else
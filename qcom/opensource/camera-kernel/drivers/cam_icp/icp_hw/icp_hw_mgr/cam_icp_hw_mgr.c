@@ -18,6 +18,8 @@
 #include <linux/delay.h>
 #include <linux/debugfs.h>
 #include <linux/rwsem.h>
+#include <linux/seq_file.h>
+#include <linux/wait.h>
 #include <media/cam_defs.h>
 #include <media/cam_icp.h>
 #include <media/cam_cpas.h>
@@ -2012,6 +2014,94 @@ static int cam_icp_get_irq_line_test(void *data, u64 *val)
 DEFINE_SIMPLE_ATTRIBUTE(cam_icp_irq_line_test, cam_icp_get_irq_line_test,
 	cam_icp_set_irq_line_test, "%08llu");
 
+static uint32_t cam_icp_sched_class_from_dev_type(uint32_t dev_type)
+{
+	switch (dev_type) {
+	case CAM_ICP_RES_TYPE_BPS_RT:
+	case CAM_ICP_RES_TYPE_IPE_RT:
+		return CAM_ICP_SCHED_CLASS_RT;
+	case CAM_ICP_RES_TYPE_BPS_SEMI_RT:
+	case CAM_ICP_RES_TYPE_IPE_SEMI_RT:
+		return CAM_ICP_SCHED_CLASS_SEMI_RT;
+	default:
+		return CAM_ICP_SCHED_CLASS_OFFLINE;
+	}
+}
+
+static inline bool cam_icp_mgr_sched_can_submit(
+	struct cam_icp_sched_info *sched, uint32_t sched_class,
+	uint32_t budget)
+{
+	return !atomic_read(&sched->inflight[CAM_ICP_SCHED_CLASS_RT]) ||
+		(atomic_read(&sched->inflight[sched_class]) < budget);
+}
+
+/*
+ * Hold back a non realtime submitter while realtime frames are inflight
+ * and its class already used up its budget, at most for the class
+ * deadline. Called without hw_mgr_mutex so other clients keep going.
+ */
+static void cam_icp_mgr_sched_throttle(struct cam_icp_hw_mgr *hw_mgr,
+	struct cam_icp_hw_ctx_data *ctx_data)
+{
+	struct cam_icp_sched_info *sched = &hw_mgr->sched;
+	uint32_t sched_class = ctx_data->sched_class;
+	uint32_t budget = READ_ONCE(sched->budget[sched_class]);
+	long rem;
+
+	if (!budget || cam_icp_mgr_sched_can_submit(sched, sched_class, budget))
+		return;
+
+	atomic64_inc(&sched->num_throttled[sched_class]);
+	rem = wait_event_timeout(sched->wq,
+		cam_icp_mgr_sched_can_submit(sched, sched_class, budget),
+		msecs_to_jiffies(READ_ONCE(sched->deadline_ms[sched_class])));
+	if (!rem) {
+		atomic64_inc(&sched->num_deadline_miss[sched_class]);
+		CAM_DBG(CAM_ICP, "[%s] sched deadline hit, inflight rt %d own %d",
+			ctx_data->ctx_id_string,
+			atomic_read(&sched->inflight[CAM_ICP_SCHED_CLASS_RT]),
+			atomic_read(&sched->inflight[sched_class]));
+	}
+}
+
+static inline void cam_icp_mgr_sched_get(struct cam_icp_hw_ctx_data *ctx_data,
+	int idx)
+{
+	if (!ctx_data->hfi_frame_process.fw_process_flag[idx])
+		atomic_inc(&icp_hw_mgr.sched.inflight[ctx_data->sched_class]);
+}
+
+static inline void cam_icp_mgr_sched_put(struct cam_icp_hw_ctx_data *ctx_data,
+	int idx)
+{
+	if (!ctx_data->hfi_frame_process.fw_process_flag[idx])
+		return;
+
+	atomic_dec(&icp_hw_mgr.sched.inflight[ctx_data->sched_class]);
+	wake_up_all(&icp_hw_mgr.sched.wq);
+}
+
+static int cam_icp_sched_stats_show(struct seq_file *m, void *unused)
+{
+	struct cam_icp_sched_info *sched = &icp_hw_mgr.sched;
+	static const char * const names[CAM_ICP_SCHED_CLASS_MAX] = {
+		"rt", "semi_rt", "offline" };
+	int i;
+
+	seq_printf(m, "%-8s %8s %8s %8s %12s %12s\n", "class", "inflight",
+		"budget", "deadline", "throttled", "deadline_hit");
+	for (i = 0; i < CAM_ICP_SCHED_CLASS_MAX; i++)
+		seq_printf(m, "%-8s %8d %8u %8u %12lld %12lld\n", names[i],
+			atomic_read(&sched->inflight[i]), sched->budget[i],
+			sched->deadline_ms[i],
+			atomic64_read(&sched->num_throttled[i]),
+			atomic64_read(&sched->num_deadline_miss[i]));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cam_icp_sched_stats);
+
 static int cam_icp_hw_mgr_create_debugfs_entry(void)
 {
 	int rc = 0;
@@ -2053,6 +2143,18 @@ static int cam_icp_hw_mgr_create_debugfs_entry(void)
 	debugfs_create_bool("disable_ubwc_comp", 0644,
 		icp_hw_mgr.dentry, &icp_hw_mgr.disable_ubwc_comp);
 
+	debugfs_create_u32("sched_offline_budget", 0644, icp_hw_mgr.dentry,
+		&icp_hw_mgr.sched.budget[CAM_ICP_SCHED_CLASS_OFFLINE]);
+
+	debugfs_create_u32("sched_offline_deadline_ms", 0644, icp_hw_mgr.dentry,
+		&icp_hw_mgr.sched.deadline_ms[CAM_ICP_SCHED_CLASS_OFFLINE]);
+
+	debugfs_create_u32("sched_semi_rt_budget", 0644, icp_hw_mgr.dentry,
+		&icp_hw_mgr.sched.budget[CAM_ICP_SCHED_CLASS_SEMI_RT]);
+
+	debugfs_create_file("sched_stats", 0444, icp_hw_mgr.dentry, NULL,
+		&cam_icp_sched_stats_fops);
+
 	#ifdef CONFIG_CAM_TEST_ICP_FW_DOWNLOAD
 		debugfs_create_file("icp_fw_load_unload", 0644,
 			icp_hw_mgr.dentry, NULL, &cam_icp_hw_mgr_fw_load_options);
@@ -2109,6 +2211,7 @@ static int cam_icp_mgr_cleanup_ctx(struct cam_icp_hw_ctx_data *ctx_data)
 				ctx_data->hfi_frame_process.in_resource[i]);
 			ctx_data->hfi_frame_process.in_resource[i] = 0;
 		}
+		cam_icp_mgr_sched_put(ctx_data, i);
 		hfi_frame_process->fw_process_flag[i] = false;
 		clear_bit(i, ctx_data->hfi_frame_process.bitmap);
 	}
@@ -2441,6 +2544,7 @@ static int cam_icp_mgr_handle_frame_process(uint32_t *msg_ptr, int flag)
 		ctx_data->hfi_frame_process.in_resource[idx] = 0;
 	}
 	clear_bit(idx, ctx_data->hfi_frame_process.bitmap);
+	cam_icp_mgr_sched_put(ctx_data, idx);
 	hfi_frame_process->fw_process_flag[idx] = false;
 
 	mutex_unlock(&ctx_data->ctx_mutex);
@@ -4595,6 +4699,7 @@ static int cam_icp_mgr_handle_config_err(
 		&icp_evt_data);
 
 	ctx_data->hfi_frame_process.request_id[idx] = 0;
+	cam_icp_mgr_sched_put(ctx_data, idx);
 	ctx_data->hfi_frame_process.fw_process_flag[idx] = false;
 	clear_bit(idx, ctx_data->hfi_frame_process.bitmap);
 
@@ -4611,6 +4716,8 @@ static int cam_icp_mgr_enqueue_config(struct cam_icp_hw_mgr *hw_mgr,
 	struct hfi_cmd_ipebps_async *hfi_cmd;
 	struct cam_hw_update_entry *hw_update_entries;
 	struct icp_frame_info *frame_info = NULL;
+	struct cam_icp_hw_ctx_data *ctx_data = config_args->ctxt_to_hw_map;
+	enum crm_task_priority priority;
 
 	frame_info = (struct icp_frame_info *)config_args->priv;
 	request_id = frame_info->request_id;
@@ -4629,8 +4736,11 @@ static int cam_icp_mgr_enqueue_config(struct cam_icp_hw_mgr *hw_mgr,
 	task_data->request_id = request_id;
 	task_data->type = ICP_WORKQ_TASK_CMD_TYPE;
 	task->process_cb = cam_icp_mgr_process_cmd;
-	rc = cam_req_mgr_workq_enqueue_task(task, &icp_hw_mgr,
-		CRM_TASK_PRIORITY_0);
+
+	/* Realtime frames overtake queued offline frames in the cmd workq */
+	priority = (ctx_data->sched_class == CAM_ICP_SCHED_CLASS_OFFLINE) ?
+		CRM_TASK_PRIORITY_1 : CRM_TASK_PRIORITY_0;
+	rc = cam_req_mgr_workq_enqueue_task(task, &icp_hw_mgr, priority);
 
 	return rc;
 }
@@ -4759,6 +4869,8 @@ static int cam_icp_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 		msleep(100);
 	}
 
+	cam_icp_mgr_sched_throttle(hw_mgr, ctx_data);
+
 	mutex_lock(&hw_mgr->hw_mgr_mutex);
 	mutex_lock(&ctx_data->ctx_mutex);
 	if (ctx_data->state != CAM_ICP_CTX_STATE_ACQUIRED) {
@@ -4781,6 +4893,7 @@ static int cam_icp_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 	}
 
 	cam_icp_mgr_ipe_bps_clk_update(hw_mgr, ctx_data, idx);
+	cam_icp_mgr_sched_get(ctx_data, idx);
 	ctx_data->hfi_frame_process.fw_process_flag[idx] = true;
 	ctx_data->hfi_frame_process.submit_timestamp[idx] = ktime_get();
 
@@ -6398,6 +6511,8 @@ static int cam_icp_mgr_acquire_hw(void *hw_mgr_priv, void *acquire_hw_args)
 
 	icp_dev_acquire_info = ctx_data->icp_dev_acquire_info;
 	ctx_data->unified_dev_type = cam_icp_unify_dev_type(icp_dev_acquire_info->dev_type);
+	ctx_data->sched_class = cam_icp_sched_class_from_dev_type(
+		icp_dev_acquire_info->dev_type);
 
 	scnprintf(ctx_data->ctx_id_string, sizeof(ctx_data->ctx_id_string),
 		"%s_ctx[%d]_hwmgrctx[%d]_Submit",
@@ -6998,6 +7113,13 @@ int cam_icp_hw_mgr_init(struct device_node *of_node, uint64_t *hw_mgr_hdl,
 	icp_hw_mgr.mini_dump_cb = mini_dump_cb;
 	mutex_init(&icp_hw_mgr.hw_mgr_mutex);
 	spin_lock_init(&icp_hw_mgr.hw_mgr_lock);
+	init_waitqueue_head(&icp_hw_mgr.sched.wq);
+	icp_hw_mgr.sched.budget[CAM_ICP_SCHED_CLASS_OFFLINE] =
+		CAM_ICP_SCHED_OFFLINE_BUDGET;
+	icp_hw_mgr.sched.deadline_ms[CAM_ICP_SCHED_CLASS_OFFLINE] =
+		CAM_ICP_SCHED_OFFLINE_DEADLINE_MS;
+	icp_hw_mgr.sched.deadline_ms[CAM_ICP_SCHED_CLASS_SEMI_RT] =
+		CAM_ICP_SCHED_OFFLINE_DEADLINE_MS;
 
 	atomic_set(&icp_hw_mgr.frame_in_process, 0);
 	icp_hw_mgr.frame_in_process_ctx_id = -1;
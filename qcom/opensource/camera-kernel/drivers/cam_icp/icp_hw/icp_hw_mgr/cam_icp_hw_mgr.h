@@ -77,6 +77,12 @@
  */
 #define CAM_ICP_CTX_RESPONSE_TIME_THRESHOLD   300000
 
+/* Default offline frames allowed inflight next to realtime frames */
+#define CAM_ICP_SCHED_OFFLINE_BUDGET          2
+
+/* Default max wait of a throttled offline submitter */
+#define CAM_ICP_SCHED_OFFLINE_DEADLINE_MS     100
+
 struct hfi_mini_dump_info;
 
 /**
@@ -288,6 +294,7 @@ struct cam_ctx_clk_info {
  * @unified_dev_type: Unified dev type which does not hold any priority info.
  *                    It's either IPE/BPS
  * @abort_timed_out: Indicates if abort timed out
+ * @sched_class: Scheduling class derived from the acquired device type
  */
 struct cam_icp_hw_ctx_data {
 	void *context_priv;
@@ -315,6 +322,7 @@ struct cam_icp_hw_ctx_data {
 	struct cam_icp_ctx_perf_stats perf_stats;
 	uint32_t unified_dev_type;
 	bool abort_timed_out;
+	uint32_t sched_class;
 };
 
 /**
@@ -359,6 +367,38 @@ struct cam_icp_clk_info {
 	uint32_t watch_dog_reset_counter;
 };
 
+/**
+ * enum cam_icp_sched_class - Frame scheduling class of an ICP context
+ * @CAM_ICP_SCHED_CLASS_RT:      Realtime IPE/BPS contexts
+ * @CAM_ICP_SCHED_CLASS_SEMI_RT: Semi realtime IPE/BPS contexts
+ * @CAM_ICP_SCHED_CLASS_OFFLINE: Offline reprocessing contexts
+ */
+enum cam_icp_sched_class {
+	CAM_ICP_SCHED_CLASS_RT,
+	CAM_ICP_SCHED_CLASS_SEMI_RT,
+	CAM_ICP_SCHED_CLASS_OFFLINE,
+	CAM_ICP_SCHED_CLASS_MAX,
+};
+
+/**
+ * struct cam_icp_sched_info - Frame scheduler state of the hw manager
+ * @wq: Waitqueue for submitters throttled by their class budget
+ * @inflight: Frames submitted to firmware and not yet done, per class
+ * @budget: Max inflight frames while realtime frames are inflight,
+ *          0 means unlimited
+ * @deadline_ms: Max time a throttled submitter waits for its budget
+ * @num_throttled: Number of submissions that had to wait, per class
+ * @num_deadline_miss: Number of waits that ran into the deadline, per class
+ */
+struct cam_icp_sched_info {
+	wait_queue_head_t wq;
+	atomic_t inflight[CAM_ICP_SCHED_CLASS_MAX];
+	uint32_t budget[CAM_ICP_SCHED_CLASS_MAX];
+	uint32_t deadline_ms[CAM_ICP_SCHED_CLASS_MAX];
+	atomic64_t num_throttled[CAM_ICP_SCHED_CLASS_MAX];
+	atomic64_t num_deadline_miss[CAM_ICP_SCHED_CLASS_MAX];
+};
+
 /**
  * struct cam_icp_hw_mgr
  * @hw_mgr_mutex: Mutex for ICP hardware manager
@@ -412,6 +452,7 @@ struct cam_icp_clk_info {
  *            re-downloaded for new camera session.
  * @frame_in_process: Counter for frames in process
  * @frame_in_process_ctx_id: Contxt id processing frame
+ * @sched: Frame scheduler for realtime vs offline contexts
  */
 struct cam_icp_hw_mgr {
 	struct mutex hw_mgr_mutex;
@@ -465,6 +506,7 @@ struct cam_icp_hw_mgr {
 	uint64_t icp_svs_clk;
 	atomic_t frame_in_process;
 	int frame_in_process_ctx_id;
+	struct cam_icp_sched_info sched;
 };
 
 /**
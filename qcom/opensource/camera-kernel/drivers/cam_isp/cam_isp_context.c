@@ -418,6 +418,13 @@ static void __cam_isp_ctx_update_state_monitor_array(
 		req_id;
 	ctx_isp->cam_isp_ctx_state_monitor[iterator].evt_time_stamp =
 		jiffies_to_msecs(jiffies) - ctx_isp->init_timestamp;
+
+	if (trigger_type == CAM_ISP_STATE_CHANGE_TRIGGER_APPLIED)
+		cam_context_latency_mark(ctx_isp->base, req_id,
+			CAM_CTX_LATENCY_APPLY);
+	else if (trigger_type == CAM_ISP_STATE_CHANGE_TRIGGER_SOF)
+		cam_context_latency_mark(ctx_isp->base, req_id,
+			CAM_CTX_LATENCY_SOF);
 }
 
 static const char *__cam_isp_ctx_substate_val_to_type(
@@ -1526,6 +1533,7 @@ static int __cam_isp_ctx_handle_buf_done_for_req_list(
 	req_isp = (struct cam_isp_ctx_req *) req->req_priv;
 	ctx_isp->active_req_cnt--;
 	buf_done_req_id = req->request_id;
+	cam_context_latency_mark(ctx, buf_done_req_id, CAM_CTX_LATENCY_SIGNAL);
 
 	if ((TRUE == ctx_isp->process_rdi_mismatch) && 
 		(buf_done_req_id == ctx_isp->request_mismatched) && 
@@ -1649,6 +1657,7 @@ static int __cam_isp_ctx_handle_buf_done_for_request(
 	const char *handle_type;
 
 	trace_cam_buf_done("ISP", ctx, req);
+	cam_context_latency_mark(ctx, req->request_id, CAM_CTX_LATENCY_BUF_DONE);
 
 	req_isp = (struct cam_isp_ctx_req *) req->req_priv;
 
@@ -1926,6 +1935,7 @@ static int __cam_isp_ctx_handle_buf_done_for_request_verify_addr(
 	struct cam_isp_hw_done_event_data unhandled_done = {0};
 
 	trace_cam_buf_done("ISP", ctx, req);
+	cam_context_latency_mark(ctx, req->request_id, CAM_CTX_LATENCY_BUF_DONE);
 
 	req_isp = (struct cam_isp_ctx_req *) req->req_priv;
 
@@ -6264,6 +6274,7 @@ static int __cam_isp_ctx_config_dev_in_top_state(
 
 	req->request_id = packet->header.request_id;
 	req->status = 1;
+	cam_context_latency_begin(ctx, req->request_id);
 
 	if (req_isp->hw_update_data.packet_opcode_type ==
 		CAM_ISP_PACKET_INIT_DEV) {
@@ -109,6 +109,11 @@ struct cam_vfe_bus_ver3_common_data {
 	int                        rup_irq_handle[CAM_VFE_BUS_VER3_SRC_GRP_MAX];
 	uint32_t                                    pack_align_shift;
 	uint32_t                                    max_bw_counter_limit;
+
+	/* Buf done events per frame, rolled over at every RUP */
+	uint32_t                                    frame_buf_done_cnt;
+	uint32_t                                    last_frame_buf_done_cnt;
+	uint32_t                                    max_frame_buf_done_cnt;
 };
 
 struct cam_vfe_bus_ver3_wm_resource_data {
@@ -154,6 +159,11 @@ struct cam_vfe_bus_ver3_wm_resource_data {
 	uint32_t             acquired_height;
 	uint32_t             default_line_based;
 	bool                 use_wm_pack;
+
+	/* Last values put in the cdm stream, valid once init_cfg_done */
+	uint32_t             last_image_cfg_0;
+	uint32_t             last_h_init;
+	uint32_t             last_frame_inc;
 };
 
 struct cam_vfe_bus_ver3_comp_grp_data {
@@ -682,6 +692,14 @@ static int cam_vfe_bus_ver3_handle_rup_top_half(uint32_t evt_id,
 
 	trace_cam_log_event("RUP", "RUP_IRQ", irq_status, 0);
 
+	rsrc_data->common_data->last_frame_buf_done_cnt =
+		rsrc_data->common_data->frame_buf_done_cnt;
+	if (rsrc_data->common_data->frame_buf_done_cnt >
+		rsrc_data->common_data->max_frame_buf_done_cnt)
+		rsrc_data->common_data->max_frame_buf_done_cnt =
+			rsrc_data->common_data->frame_buf_done_cnt;
+	rsrc_data->common_data->frame_buf_done_cnt = 0;
+
 	th_payload->evt_payload_priv = evt_payload;
 
 	return rc;
@@ -771,6 +789,10 @@ static int cam_vfe_bus_ver3_handle_rup_bottom_half(void *handler_priv,
 	evt_info.hw_idx = rsrc_data->common_data->core_index;
 	evt_info.res_type = CAM_ISP_RESOURCE_VFE_IN;
 
+	CAM_DBG(CAM_ISP, "VFE:%d buf done events last frame: %u max: %u",
+		evt_info.hw_idx, rsrc_data->common_data->last_frame_buf_done_cnt,
+		rsrc_data->common_data->max_frame_buf_done_cnt);
+
 	if (!rsrc_data->common_data->is_lite) {
 		if (irq_status & 0x1) {
 			CAM_DBG(CAM_ISP, "VFE:%d Received CAMIF RUP",
@@ -2405,6 +2427,7 @@ static int cam_vfe_bus_ver3_handle_vfe_out_done_top_half(uint32_t evt_id,
 		rsrc_data->common_data->comp_done_shift)) {
 		trace_cam_log_event("bufdone", "bufdone_IRQ",
 			status_0, resource_data->comp_grp_type);
+		rsrc_data->common_data->frame_buf_done_cnt++;
 	}
 
 	if (status_0 & 0x1)
@@ -3038,6 +3061,11 @@ static int cam_vfe_bus_ver3_err_irq_bottom_half(
 		"Image Size violation status 0x%X CCIF violation status 0x%X",
 		evt_payload->image_size_violation_status,
 		evt_payload->ccif_violation_status);
+	CAM_INFO(CAM_ISP,
+		"VFE:%d buf done events current frame: %u last frame: %u max: %u",
+		common_data->core_index, common_data->frame_buf_done_cnt,
+		common_data->last_frame_buf_done_cnt,
+		common_data->max_frame_buf_done_cnt);
 
 	if (image_size_violation || constraint_violation) {
 		status = evt_payload->image_size_violation_status;
@@ -3546,10 +3574,13 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 			reg_val_pair[j-1]);
 
 		val = (wm_data->height << 16) | wm_data->width;
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->image_cfg_0, val);
-		CAM_DBG(CAM_ISP, "WM:%d image height and width 0x%X",
-			wm_data->index, reg_val_pair[j-1]);
+		if (wm_data->last_image_cfg_0 != val || !wm_data->init_cfg_done) {
+			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
+				wm_data->hw_regs->image_cfg_0, val);
+			wm_data->last_image_cfg_0 = val;
+			CAM_DBG(CAM_ISP, "WM:%d image height and width 0x%X",
+				wm_data->index, reg_val_pair[j-1]);
+		}
 
 		/* For initial configuration program all bus registers */
 		if (update_buf->use_scratch_cfg) {
@@ -3614,9 +3645,12 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 			}
 		}
 
-		if (!(wm_data->en_cfg & (0x3 << 16))) {
+		if (!(wm_data->en_cfg & (0x3 << 16)) &&
+			(wm_data->last_h_init != wm_data->h_init ||
+			!wm_data->init_cfg_done)) {
 			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
 				wm_data->hw_regs->image_cfg_1, wm_data->h_init);
+			wm_data->last_h_init = wm_data->h_init;
 			CAM_DBG(CAM_ISP, "WM:%d h_init 0x%X",
 				wm_data->index, reg_val_pair[j-1]);
 		}
@@ -3658,11 +3692,14 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 
 		update_buf->wm_update->image_buf_offset[i] = image_buf_offset;
 
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->frame_incr, frame_inc);
-		CAM_DBG(CAM_ISP, "WM:%d frame_inc: %d expanded_mem: %s",
-			wm_data->index, reg_val_pair[j-1],
-			CAM_BOOL_TO_YESNO(cam_smmu_is_expanded_memory));
+		if (wm_data->last_frame_inc != frame_inc || !wm_data->init_cfg_done) {
+			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
+				wm_data->hw_regs->frame_incr, frame_inc);
+			wm_data->last_frame_inc = frame_inc;
+			CAM_DBG(CAM_ISP, "WM:%d frame_inc: %d expanded_mem: %s",
+				wm_data->index, reg_val_pair[j-1],
+				CAM_BOOL_TO_YESNO(cam_smmu_is_expanded_memory));
+		}
 
 		/* enable the WM */
 		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
@@ -4195,6 +4232,9 @@ static int cam_vfe_bus_ver3_init_hw(void *hw_priv,
 			bus_priv->common_data.bus_irq_controller;
 
 	bus_priv->common_data.hw_init = true;
+	bus_priv->common_data.frame_buf_done_cnt = 0;
+	bus_priv->common_data.last_frame_buf_done_cnt = 0;
+	bus_priv->common_data.max_frame_buf_done_cnt = 0;
 
 	CAM_DBG(CAM_ISP, "VFE:%d bus-wr hw-version:0x%x",
 		bus_priv->common_data.core_index,
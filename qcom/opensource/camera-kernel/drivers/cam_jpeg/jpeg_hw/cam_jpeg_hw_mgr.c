@@ -371,6 +371,20 @@ end_error:
 	return rc;
 }
 
+static bool cam_jpeg_mgr_next_req_pending(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type)
+{
+	struct cam_jpeg_hw_cfg_req *p_cfg_req;
+
+	if (list_empty(&hw_mgr->hw_config_req_list))
+		return false;
+
+	p_cfg_req = list_first_entry(&hw_mgr->hw_config_req_list,
+		struct cam_jpeg_hw_cfg_req, list);
+
+	return (p_cfg_req->dev_type == dev_type);
+}
+
 static int cam_jpeg_mgr_bottom_half_irq(void *priv, void *data)
 {
 	int                                                      rc = 0;
@@ -385,6 +399,7 @@ static int cam_jpeg_mgr_bottom_half_irq(void *priv, void *data)
 	struct cam_jpeg_hw_cfg_req                              *p_cfg_req = NULL;
 	struct crm_workq_task                                   *task;
 	struct cam_jpeg_process_frame_work_data_t               *wq_task_data;
+	struct cam_jpeg_process_frame_work_data_t                next_task_data;
 	struct cam_jpeg_request_data                            *jpeg_req;
 	struct cam_req_mgr_message                               v4l2_msg = {0};
 	struct cam_ctx_request                                  *req;
@@ -536,6 +551,37 @@ exit:
 		goto err;
 	}
 
+	/*
+	 * When the next queued request is for the same core, start it right
+	 * here instead of bouncing through the frame workq. The new request
+	 * takes its own init reference before the finished one is dropped,
+	 * so the core stays powered in between.
+	 */
+	if (cam_jpeg_mgr_next_req_pending(&g_jpeg_hw_mgr, dev_type)) {
+		g_jpeg_hw_mgr.device_in_use[dev_type][0] = false;
+		g_jpeg_hw_mgr.dev_hw_cfg_args[dev_type][0] = NULL;
+		list_add_tail(&p_cfg_req->list, &g_jpeg_hw_mgr.free_req_list);
+		mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+
+		next_task_data.data = NULL;
+		next_task_data.request_id = 0;
+		next_task_data.type = CAM_JPEG_WORKQ_TASK_CMD_TYPE;
+		rc = cam_jpeg_mgr_process_hw_update_entries(&g_jpeg_hw_mgr,
+			&next_task_data);
+		if (rc)
+			CAM_ERR(CAM_JPEG, "Failed to start next request %d", rc);
+
+		if (g_jpeg_hw_mgr.devices[dev_type][0]->hw_ops.deinit) {
+			if (g_jpeg_hw_mgr.devices[dev_type][0]->hw_ops.deinit(
+				g_jpeg_hw_mgr.devices[dev_type][0]->hw_priv,
+				NULL, 0))
+				CAM_ERR(CAM_JPEG, "Failed to Deinit %lu HW",
+					dev_type);
+		}
+
+		return rc;
+	}
+
 	if (g_jpeg_hw_mgr.devices[dev_type][0]->hw_ops.deinit) {
 		rc = g_jpeg_hw_mgr.devices[dev_type][0]->hw_ops.deinit(
 			g_jpeg_hw_mgr.devices[dev_type][0]->hw_priv, NULL, 0);
@@ -503,6 +503,7 @@ static int cam_lrme_mgr_cb(void *data,
 	uint32_t evt_id = CAM_CTX_EVT_ID_ERROR;
 	struct cam_lrme_frame_request *frame_req;
 	struct cam_lrme_device *hw_device;
+	bool stage_next = false;
 
 	if (!data || !cb_args) {
 		CAM_ERR(CAM_LRME, "Invalid input args");
@@ -525,10 +526,21 @@ static int cam_lrme_mgr_cb(void *data,
 	if (cb_args->cb_type & CAM_LRME_CB_COMP_REG_UPDATE) {
 		cb_args->cb_type &= ~CAM_LRME_CB_COMP_REG_UPDATE;
 		CAM_DBG(CAM_LRME, "Reg update");
+		/*
+		 * The frame in flight latched its registers, so the submit
+		 * slot is free. Stage the next request behind it now; the
+		 * core kicks it from the idle irq without another round
+		 * trip through this manager.
+		 */
+		stage_next = true;
 	}
 
-	if (!frame_req)
+	if (!frame_req) {
+		if (stage_next)
+			rc = cam_lrme_mgr_util_schedule_frame_req(hw_mgr,
+				hw_device);
 		return rc;
+	}
 
 	if (cb_args->cb_type & CAM_LRME_CB_BUF_DONE) {
 		cb_args->cb_type &= ~CAM_LRME_CB_BUF_DONE;
@@ -240,6 +240,7 @@ int cam_mem_mgr_init(void)
 	bitmap_zero(tbl.bitmap, tbl.bits);
 	/* We need to reserve slot 0 because 0 is invalid */
 	set_bit(0, tbl.bitmap);
+	tbl.slot_hint = 1;
 
 	for (i = 1; i < CAM_MEM_BUFQ_MAX; i++) {
 		tbl.bufq[i].fd = -1;
@@ -267,12 +268,20 @@ static int32_t cam_mem_get_slot(void)
 	int32_t idx;
 
 	mutex_lock(&tbl.m_lock);
-	idx = find_first_zero_bit(tbl.bitmap, tbl.bits);
+	/*
+	 * Search next fit from the last allocated slot so that allocation
+	 * stays cheap with many live buffers and a released handle is not
+	 * handed out again right away.
+	 */
+	idx = find_next_zero_bit(tbl.bitmap, CAM_MEM_BUFQ_MAX, tbl.slot_hint);
+	if (idx >= CAM_MEM_BUFQ_MAX)
+		idx = find_next_zero_bit(tbl.bitmap, CAM_MEM_BUFQ_MAX, 1);
 	if (idx >= CAM_MEM_BUFQ_MAX || idx <= 0) {
 		mutex_unlock(&tbl.m_lock);
 		return -ENOMEM;
 	}
 
+	tbl.slot_hint = idx + 1;
 	set_bit(idx, tbl.bitmap);
 	tbl.bufq[idx].active = true;
 	CAM_GET_TIMESTAMP((tbl.bufq[idx].timestamp));
@@ -1472,6 +1481,7 @@ static int cam_mem_mgr_cleanup_table(void)
 	bitmap_zero(tbl.bitmap, tbl.bits);
 	/* We need to reserve slot 0 because 0 is invalid */
 	set_bit(0, tbl.bitmap);
+	tbl.slot_hint = 1;
 	mutex_unlock(&tbl.m_lock);
 
 	return 0;
@@ -73,6 +73,8 @@ void cam_req_mgr_core_link_reset(struct cam_req_mgr_core_link *link)
 	atomic_set(&link->eof_event_cnt, 0);
 	link->properties_mask = CAM_LINK_PROPERTY_NONE;
 	link->cont_empty_slots = 0;
+	link->lookahead_req_id = -1;
+	link->lag_frame_cnt = 0;
 	__cam_req_mgr_reset_apply_data(link);
 
 	for (i = 0; i < MAXIMUM_LINKS_PER_SESSION - 1; i++)
@@ -357,6 +359,18 @@ static int __cam_req_mgr_notify_frame_skip(
 			(!slot->ops.apply_at_eof))
 			continue;
 
+		/*
+		 * While the HAL lags the sensor would write the same skip
+		 * settings on every SOF, the first write already holds them
+		 * until the next request is applied.
+		 */
+		if (g_crm_core_dev->collapse_frame_skip &&
+			(link->lag_frame_cnt > 1) &&
+			(dev->dev_info.dev_id == CAM_REQ_MGR_DEVICE_SENSOR)) {
+			atomic_inc(&g_crm_core_dev->num_collapsed_skips);
+			continue;
+		}
+
 		frame_skip.dev_hdl = dev->dev_hdl;
 		frame_skip.link_hdl = link->link_hdl;
 		frame_skip.request_id =
@@ -1382,6 +1396,53 @@ static int __cam_req_mgr_check_link_is_ready(struct cam_req_mgr_core_link *link,
 	return rc;
 }
 
+/**
+ * __cam_req_mgr_lookahead()
+ *
+ * @brief    : Once a request is applied, checks whether the request in the
+ *             next slot is already ready on all pipeline delay tables so the
+ *             validation pass can be skipped at the next SOF. Only the
+ *             no-sync path is handled, sync links need the peer state at
+ *             the time of the trigger.
+ * @link     : pointer to link whose next slot is checked
+ *
+ */
+static void __cam_req_mgr_lookahead(struct cam_req_mgr_core_link *link)
+{
+	int                            rc;
+	int32_t                        idx;
+	struct cam_req_mgr_traverse    traverse_data;
+	struct cam_req_mgr_req_queue  *in_q = link->req.in_q;
+	struct cam_req_mgr_slot       *slot;
+
+	link->lookahead_req_id = -1;
+	if (!g_crm_core_dev->apply_lookahead)
+		return;
+
+	idx = in_q->rd_idx;
+	__cam_req_mgr_inc_idx(&idx, 1, in_q->num_slots);
+	slot = &in_q->slot[idx];
+	if ((slot->status != CRM_SLOT_STATUS_REQ_ADDED) ||
+		(slot->sync_mode == CAM_REQ_MGR_SYNC_MODE_SYNC) ||
+		(slot->req_id < 0))
+		return;
+
+	memset(&traverse_data, 0, sizeof(traverse_data));
+	traverse_data.apply_data = link->req.apply_data;
+	traverse_data.idx = idx;
+	traverse_data.tbl = link->req.l_tbl;
+	traverse_data.in_q = in_q;
+	traverse_data.validate_only = true;
+	traverse_data.open_req_cnt = link->open_req_cnt;
+
+	rc = __cam_req_mgr_traverse(&traverse_data);
+	if (!rc && traverse_data.result == link->pd_mask)
+		link->lookahead_req_id = slot->req_id;
+
+	CAM_DBG(CAM_CRM, "link %x lookahead req %lld idx %d result %x rc %d",
+		link->link_hdl, slot->req_id, idx, traverse_data.result, rc);
+}
+
 /**
  * __cam_req_mgr_check_sync_for_mslave()
  *
@@ -2037,11 +2098,19 @@ static int __cam_req_mgr_process_req(struct cam_req_mgr_core_link *link,
 		if (slot->status == CRM_SLOT_STATUS_NO_REQ) {
 			CAM_DBG(CAM_CRM, "No Pending req");
 			rc = 0;
+			link->lag_frame_cnt++;
+			atomic_inc(&g_crm_core_dev->num_skipped_frames);
 			__cam_req_mgr_notify_frame_skip(link,
 				trigger);
 			goto end;
 		}
 
+		if (link->lag_frame_cnt) {
+			CAM_DBG(CAM_CRM, "link_hdl %x caught up after %u frames",
+				link->link_hdl, link->lag_frame_cnt);
+			link->lag_frame_cnt = 0;
+		}
+
 		/*
 		 * Update the timestamp in session lock protection
 		 * to avoid timing issue.
@@ -2107,10 +2176,19 @@ static int __cam_req_mgr_process_req(struct cam_req_mgr_core_link *link,
 
 			/*
 			 * Validate that if the req is ready to apply before
-			 * checking the inject delay.
+			 * checking the inject delay, unless the lookahead
+			 * already did it while the previous req was applied.
 			 */
-			rc = __cam_req_mgr_check_link_is_ready(link,
-				slot->idx, true);
+			if ((link->lookahead_req_id >= 0) &&
+				(link->lookahead_req_id == slot->req_id)) {
+				CAM_DBG(CAM_CRM, "req %lld validated ahead on link %x",
+					slot->req_id, link->link_hdl);
+				rc = 0;
+			} else {
+				rc = __cam_req_mgr_check_link_is_ready(link,
+					slot->idx, true);
+			}
+			link->lookahead_req_id = -1;
 
 			if (!rc) {
 				rc = __cam_req_mgr_inject_delay(link->req.l_tbl,
@@ -2308,6 +2386,8 @@ static int __cam_req_mgr_process_req(struct cam_req_mgr_core_link *link,
 				&idx, reset_step + 1,
 				in_q->num_slots);
 			__cam_req_mgr_reset_req_slot(link, idx);
+
+			__cam_req_mgr_lookahead(link);
 		}
 	}
 end:
@@ -3000,6 +3080,7 @@ int cam_req_mgr_process_flush_req(void *priv, void *data)
 		break;
 	}
 
+	link->lookahead_req_id = -1;
 	complete(&link->workq_comp);
 	mutex_unlock(&link->req.lock);
 
@@ -4639,7 +4720,8 @@ int cam_req_mgr_link(struct cam_req_mgr_ver_info *link_info)
 	/* Create worker for current link */
 	snprintf(buf, sizeof(buf), "%x-%x",
 		link_info->u.link_info_v1.session_hdl, link->link_hdl);
-	wq_flag = CAM_WORKQ_FLAG_HIGH_PRIORITY | CAM_WORKQ_FLAG_SERIAL;
+	wq_flag = CAM_WORKQ_FLAG_HIGH_PRIORITY | CAM_WORKQ_FLAG_SERIAL |
+		CAM_WORKQ_FLAG_RT_WORKER;
 	rc = cam_req_mgr_workq_create(buf, CRM_WORKQ_NUM_TASKS,
 		&link->workq, CRM_WORKQ_USAGE_NON_IRQ, wq_flag,
 		cam_req_mgr_process_workq_link_worker);
@@ -4751,7 +4833,8 @@ int cam_req_mgr_link_v2(struct cam_req_mgr_ver_info *link_info)
 	/* Create worker for current link */
 	snprintf(buf, sizeof(buf), "%x-%x",
 		link_info->u.link_info_v2.session_hdl, link->link_hdl);
-	wq_flag = CAM_WORKQ_FLAG_HIGH_PRIORITY | CAM_WORKQ_FLAG_SERIAL;
+	wq_flag = CAM_WORKQ_FLAG_HIGH_PRIORITY | CAM_WORKQ_FLAG_SERIAL |
+		CAM_WORKQ_FLAG_RT_WORKER;
 	rc = cam_req_mgr_workq_create(buf, CRM_WORKQ_NUM_TASKS,
 		&link->workq, CRM_WORKQ_USAGE_NON_IRQ, wq_flag,
 		cam_req_mgr_process_workq_link_worker);
@@ -5470,6 +5553,9 @@ static unsigned long cam_req_mgr_core_mini_dump_cb(void *dst,
 
 		md_link->workq.workq_scheduled_ts =
 					    link->workq->workq_scheduled_ts;
+		md_link->workq.max_queue_latency_us =
+				link->workq->max_queue_latency_us;
+		md_link->workq.num_late_tasks = link->workq->num_late_tasks;
 		md_link->workq.task.pending_cnt =
 				atomic_read(&link->workq->task.pending_cnt);
 		md_link->workq.task.free_cnt =
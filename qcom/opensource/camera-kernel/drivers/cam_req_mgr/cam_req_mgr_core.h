@@ -412,6 +412,9 @@ struct cam_req_mgr_connected_device {
  * @try_for_internal_recovery : If the link stalls try for RT internal recovery
  * @properties_mask      : Indicates if current link enables some special properties
  * cont_empty_slots     : Continuous empty slots
+ * @lookahead_req_id     : Next request found ready by the apply lookahead
+ *                         while the current one was in flight, -1 if none
+ * @lag_frame_cnt        : Consecutive SOFs without a pending request
  */
 struct cam_req_mgr_core_link {
 	int32_t                              link_hdl;
@@ -455,6 +458,8 @@ struct cam_req_mgr_core_link {
 	uint32_t                             cont_empty_slots;
 	bool 								 print_on;
 	uint32_t                             rdi_mismatch_retry;
+	int64_t                              lookahead_req_id;
+	uint32_t                             lag_frame_cnt;
 };
 
 /**
@@ -488,11 +493,21 @@ struct cam_req_mgr_core_session {
  * @session_head : list head holding sessions
  * @crm_lock     : mutex lock to protect session creation & destruction
  * @recovery_on_apply_fail : Recovery on apply failure using debugfs.
+ * @apply_lookahead        : Validate request N+1 once request N is applied
+ *                           so the next SOF only has to apply it
+ * @collapse_frame_skip    : Notify sensors of a frame skip only on the first
+ *                           SOF of a run without pending requests
+ * @num_skipped_frames     : SOFs seen without a pending request
+ * @num_collapsed_skips    : Sensor frame skip notifications left out
  */
 struct cam_req_mgr_core_device {
 	struct list_head             session_head;
 	struct mutex                 crm_lock;
 	bool                         recovery_on_apply_fail;
+	bool                         apply_lookahead;
+	bool                         collapse_frame_skip;
+	atomic_t                     num_skipped_frames;
+	atomic_t                     num_collapsed_skips;
 };
 
 /**
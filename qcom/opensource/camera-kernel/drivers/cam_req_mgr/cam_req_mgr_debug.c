@@ -135,6 +135,14 @@ int cam_req_mgr_debug_register(struct cam_req_mgr_core_device *core_dev)
 		debugfs_root, core_dev, &bubble_recovery);
 	debugfs_create_bool("recovery_on_apply_fail", 0644,
 		debugfs_root, &core_dev->recovery_on_apply_fail);
+	debugfs_create_bool("apply_lookahead", 0644,
+		debugfs_root, &core_dev->apply_lookahead);
+	debugfs_create_bool("collapse_frame_skip", 0644,
+		debugfs_root, &core_dev->collapse_frame_skip);
+	debugfs_create_atomic_t("num_skipped_frames", 0444,
+		debugfs_root, &core_dev->num_skipped_frames);
+	debugfs_create_atomic_t("num_collapsed_skips", 0444,
+		debugfs_root, &core_dev->num_collapsed_skips);
 	debugfs_create_u32("delay_detect_count", 0644, debugfs_root,
 		&cam_debug_mgr_delay_detect);
 end:
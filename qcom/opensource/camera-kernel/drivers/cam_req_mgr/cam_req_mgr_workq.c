@@ -7,6 +7,10 @@
 #include "cam_debug_util.h"
 #include "cam_common_util.h"
 
+/* Optional CPU mask for real time workers, 0 leaves them unbound */
+static uint crm_workq_rt_cpumask;
+module_param(crm_workq_rt_cpumask, uint, 0644);
+
 #define WORKQ_ACQUIRE_LOCK(workq, flags) {\
 	if ((workq)->in_irq) \
 		spin_lock_irqsave(&(workq)->lock_bh, (flags)); \
@@ -72,7 +76,10 @@ void cam_req_mgr_workq_flush(struct cam_req_mgr_core_workq *workq)
 	}
 
 	atomic_set(&workq->flush, 1);
-	cancel_work_sync(&workq->work);
+	if (workq->rt_worker)
+		kthread_cancel_work_sync(&workq->rt_work);
+	else
+		cancel_work_sync(&workq->work);
 	atomic_set(&workq->flush, 0);
 }
 
@@ -83,11 +90,22 @@ void cam_req_mgr_workq_flush(struct cam_req_mgr_core_workq *workq)
 static int cam_req_mgr_process_task(struct crm_workq_task *task)
 {
 	struct cam_req_mgr_core_workq *workq = NULL;
+	s64 latency;
 
 	if (!task)
 		return -EINVAL;
 
 	workq = (struct cam_req_mgr_core_workq *)task->parent;
+	latency = ktime_us_delta(ktime_get(), task->enqueue_ts);
+	workq->last_queue_latency_us = latency;
+	if (latency > workq->max_queue_latency_us)
+		workq->max_queue_latency_us = latency;
+	if (latency > (CAM_WORKQ_SCHEDULE_TIME_THRESHOLD * USEC_PER_MSEC)) {
+		workq->num_late_tasks++;
+		CAM_DBG(CAM_CRM, "workq %s task %pK waited %lld us",
+			workq->workq_name, task, latency);
+	}
+
 	if (task->process_cb)
 		task->process_cb(task->priv, task->payload);
 	else
@@ -97,25 +115,13 @@ static int cam_req_mgr_process_task(struct crm_workq_task *task)
 	return 0;
 }
 
-/**
- * cam_req_mgr_process_workq() - main loop handling
- * @w: workqueue task pointer
- */
-void cam_req_mgr_process_workq(struct work_struct *w)
+static void __cam_req_mgr_process_workq(struct cam_req_mgr_core_workq *workq)
 {
-	struct cam_req_mgr_core_workq *workq = NULL;
 	struct crm_workq_task         *task;
 	int32_t                        i = CRM_TASK_PRIORITY_0;
 	unsigned long                  flags = 0;
 	ktime_t                        sched_start_time;
 
-	if (!w) {
-		CAM_ERR(CAM_CRM, "NULL task pointer can not schedule");
-		return;
-	}
-	workq = (struct cam_req_mgr_core_workq *)
-		container_of(w, struct cam_req_mgr_core_workq, work);
-
 	cam_common_util_thread_switch_delay_detect(
 		"CRM workq schedule",
 		workq->workq_scheduled_ts,
@@ -144,6 +150,64 @@ void cam_req_mgr_process_workq(struct work_struct *w)
 		CAM_WORKQ_EXE_TIME_THRESHOLD);
 }
 
+/**
+ * cam_req_mgr_process_workq() - main loop handling
+ * @w: workqueue task pointer
+ */
+void cam_req_mgr_process_workq(struct work_struct *w)
+{
+	struct cam_req_mgr_core_workq *workq = NULL;
+
+	if (!w) {
+		CAM_ERR(CAM_CRM, "NULL task pointer can not schedule");
+		return;
+	}
+	workq = (struct cam_req_mgr_core_workq *)
+		container_of(w, struct cam_req_mgr_core_workq, work);
+
+	__cam_req_mgr_process_workq(workq);
+}
+
+static void cam_req_mgr_process_rt_workq(struct kthread_work *w)
+{
+	struct cam_req_mgr_core_workq *workq =
+		container_of(w, struct cam_req_mgr_core_workq, rt_work);
+
+	__cam_req_mgr_process_workq(workq);
+}
+
+static int cam_req_mgr_workq_create_rt_worker(
+	struct cam_req_mgr_core_workq *crm_workq, const char *name)
+{
+	struct kthread_worker *worker;
+	struct cpumask mask;
+	int cpu;
+
+	worker = kthread_create_worker(0, "%s", name);
+	if (IS_ERR(worker)) {
+		CAM_ERR(CAM_CRM, "failed to create rt worker %s rc %ld",
+			name, PTR_ERR(worker));
+		return PTR_ERR(worker);
+	}
+
+	sched_set_fifo(worker->task);
+
+	if (crm_workq_rt_cpumask) {
+		cpumask_clear(&mask);
+		for_each_online_cpu(cpu)
+			if (crm_workq_rt_cpumask & BIT(cpu))
+				cpumask_set_cpu(cpu, &mask);
+
+		if (!cpumask_empty(&mask))
+			set_cpus_allowed_ptr(worker->task, &mask);
+	}
+
+	kthread_init_work(&crm_workq->rt_work, cam_req_mgr_process_rt_workq);
+	crm_workq->rt_worker = worker;
+
+	return 0;
+}
+
 int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 	void *priv, int32_t prio)
 {
@@ -171,7 +235,7 @@ int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 		? prio : CRM_TASK_PRIORITY_0;
 
 	WORKQ_ACQUIRE_LOCK(workq, flags);
-	if (!workq->job) {
+	if (!workq->job && !workq->rt_worker) {
 		rc = -EINVAL;
 		WORKQ_RELEASE_LOCK(workq, flags);
 		goto abort;
@@ -185,7 +249,11 @@ int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 		task, atomic_read(&workq->task.pending_cnt));
 
 	workq->workq_scheduled_ts = ktime_get();
-	queue_work(workq->job, &workq->work);
+	task->enqueue_ts = workq->workq_scheduled_ts;
+	if (workq->rt_worker)
+		kthread_queue_work(workq->rt_worker, &workq->rt_work);
+	else
+		queue_work(workq->job, &workq->work);
 	WORKQ_RELEASE_LOCK(workq, flags);
 
 	return rc;
@@ -219,16 +287,24 @@ int cam_req_mgr_workq_create(char *name, int32_t num_tasks,
 
 		strlcat(buf, name, sizeof(buf));
 		CAM_DBG(CAM_CRM, "create workque crm_workq-%s", name);
-		crm_workq->job = alloc_workqueue(buf,
-			wq_flags, max_active_tasks, NULL);
-		if (!crm_workq->job) {
-			kfree(crm_workq);
-			return -ENOMEM;
+		if (flags & CAM_WORKQ_FLAG_RT_WORKER) {
+			/* A kthread worker runs its works serially */
+			if (cam_req_mgr_workq_create_rt_worker(crm_workq, buf)) {
+				kfree(crm_workq);
+				return -ENOMEM;
+			}
+		} else {
+			crm_workq->job = alloc_workqueue(buf,
+				wq_flags, max_active_tasks, NULL);
+			if (!crm_workq->job) {
+				kfree(crm_workq);
+				return -ENOMEM;
+			}
+			INIT_WORK(&crm_workq->work, func);
 		}
 
 		/* Workq attributes initialization */
 		strlcpy(crm_workq->workq_name, buf, sizeof(crm_workq->workq_name));
-		INIT_WORK(&crm_workq->work, func);
 		spin_lock_init(&crm_workq->lock_bh);
 		CAM_DBG(CAM_CRM, "LOCK_DBG workq %s lock %pK",
 			name, &crm_workq->lock_bh);
@@ -248,6 +324,10 @@ int cam_req_mgr_workq_create(char *name, int32_t num_tasks,
 			CAM_WARN(CAM_CRM, "Insufficient memory %zu",
 				sizeof(struct crm_workq_task) *
 				crm_workq->task.num_task);
+			if (crm_workq->rt_worker)
+				kthread_destroy_worker(crm_workq->rt_worker);
+			else
+				destroy_workqueue(crm_workq->job);
 			kfree(crm_workq);
 			return -ENOMEM;
 		}
@@ -271,6 +351,7 @@ void cam_req_mgr_workq_destroy(struct cam_req_mgr_core_workq **crm_workq)
 {
 	unsigned long flags = 0;
 	struct workqueue_struct   *job;
+	struct kthread_worker     *rt_worker;
 	struct cam_req_mgr_core_workq *workq;
 	int i;
 
@@ -287,6 +368,17 @@ void cam_req_mgr_workq_destroy(struct cam_req_mgr_core_workq **crm_workq)
 			destroy_workqueue(job);
 			WORKQ_ACQUIRE_LOCK(workq, flags);
 		}
+		if (workq->rt_worker) {
+			rt_worker = workq->rt_worker;
+			workq->rt_worker = NULL;
+			WORKQ_RELEASE_LOCK(workq, flags);
+			kthread_cancel_work_sync(&workq->rt_work);
+			kthread_destroy_worker(rt_worker);
+			WORKQ_ACQUIRE_LOCK(workq, flags);
+		}
+		CAM_DBG(CAM_CRM, "workq %s max queue latency %u us late tasks %u",
+			workq->workq_name, workq->max_queue_latency_us,
+			workq->num_late_tasks);
 		/* Destroy workq payload data */
 		kfree(workq->task.pool[0].payload);
 		kfree(workq->task.pool);
@@ -11,6 +11,7 @@
 #include<linux/init.h>
 #include<linux/sched.h>
 #include <linux/workqueue.h>
+#include <linux/kthread.h>
 #include <linux/slab.h>
 #include <linux/timer.h>
 
@@ -30,6 +31,13 @@
  */
 #define CAM_WORKQ_FLAG_SERIAL                    (1 << 1)
 
+/*
+ * This flag backs the workq with a dedicated SCHED_FIFO
+ * kthread worker instead of the shared unbound pool, so
+ * one workq is never queued behind work of another.
+ */
+#define CAM_WORKQ_FLAG_RT_WORKER                 (1 << 2)
+
 /* Task priorities, lower the number higher the priority*/
 enum crm_task_priority {
 	CRM_TASK_PRIORITY_0,
@@ -56,6 +64,7 @@ enum crm_workq_context {
  * @priv       : when task is enqueuer caller can attach priv along which
  *               it will get in process callback
  * @ret        : return value in future to use for blocking calls
+ * @enqueue_ts : time at which the task was enqueued
  */
 struct crm_workq_task {
 	int32_t                    priority;
@@ -66,6 +75,7 @@ struct crm_workq_task {
 	uint8_t                    cancel;
 	void                      *priv;
 	int32_t                    ret;
+	ktime_t                    enqueue_ts;
 };
 
 /** struct cam_req_mgr_core_workq
@@ -76,6 +86,13 @@ struct crm_workq_task {
  * @flush       : used to track if flush has been called on workqueue
  * @work_q_name : name of the workq
  * @workq_scheduled_ts: enqueue time of workq
+ * @rt_worker   : dedicated kthread worker if created with
+ *                CAM_WORKQ_FLAG_RT_WORKER
+ * @rt_work     : work token used by @rt_worker
+ * @max_queue_latency_us : worst enqueue to run latency of a task
+ * @last_queue_latency_us: enqueue to run latency of the last task
+ * @num_late_tasks       : # of tasks that waited longer than
+ *                         CAM_WORKQ_SCHEDULE_TIME_THRESHOLD
  * task -
  * @lock        : Current task's lock handle
  * @pending_cnt : # of tasks left in queue
@@ -94,6 +111,11 @@ struct cam_req_mgr_core_workq {
 	ktime_t                    workq_scheduled_ts;
 	atomic_t                   flush;
 	char                       workq_name[128];
+	struct kthread_worker     *rt_worker;
+	struct kthread_work        rt_work;
+	uint32_t                   max_queue_latency_us;
+	uint32_t                   last_queue_latency_us;
+	uint32_t                   num_late_tasks;
 
 	/* tasks */
 	struct {
@@ -111,6 +133,8 @@ struct cam_req_mgr_core_workq {
 /**
  * struct cam_req_mgr_core_workq_mini_dump
  * @workq_scheduled_ts: scheduled ts
+ * @max_queue_latency_us : worst enqueue to run latency of a task
+ * @num_late_tasks       : # of tasks scheduled later than threshold
  * task -
  * @pending_cnt : # of tasks left in queue
  * @free_cnt    : # of free/available tasks
@@ -118,6 +142,8 @@ struct cam_req_mgr_core_workq {
  */
 struct cam_req_mgr_core_workq_mini_dump {
 	ktime_t                    workq_scheduled_ts;
+	uint32_t                   max_queue_latency_us;
+	uint32_t                   num_late_tasks;
 	/* tasks */
 	struct {
 		uint32_t               pending_cnt;
@@ -141,6 +167,8 @@ void cam_req_mgr_process_workq(struct work_struct *w);
  * @in_irq   : Set to one if workq might be used in irq context
  * @flags    : Bitwise OR of Flags for workq behavior.
  *             e.g. CAM_REQ_MGR_WORKQ_HIGH_PRIORITY | CAM_REQ_MGR_WORKQ_SERIAL
+ *             CAM_WORKQ_FLAG_RT_WORKER creates a dedicated real time
+ *             worker, @func is not used in that case
  * @func     : function pointer for cam_req_mgr_process_workq wrapper function
  * This function will allocate and create workqueue and pass
  * the workq pointer to caller.
@@ -1089,6 +1089,58 @@ end:
 	return rc;
 }
 
+static uint32_t cam_eeprom_cal_map_crc(struct cam_eeprom_memory_block_t *block)
+{
+	return crc32(~0, block->map,
+		block->num_map * sizeof(struct cam_eeprom_memory_map_t));
+}
+
+/**
+ * cam_eeprom_cal_cache_lookup - fill map data from the calibration cache
+ * @e_ctrl:     ctrl structure
+ *
+ * The calibration data of a module does not change between camera
+ * sessions, so a read with the same memory map as the cached one is
+ * served from the cache without powering up the eeprom.
+ *
+ * Returns true if the map data was filled from the cache
+ */
+static bool cam_eeprom_cal_cache_lookup(struct cam_eeprom_ctrl_t *e_ctrl)
+{
+	struct cam_eeprom_cal_cache_t *cache = &e_ctrl->cal_cache;
+
+	if (!cache->data || (cache->size != e_ctrl->cal_data.num_data) ||
+		(cache->map_crc != cam_eeprom_cal_map_crc(&e_ctrl->cal_data)))
+		return false;
+
+	memcpy(e_ctrl->cal_data.mapdata, cache->data, cache->size);
+	return true;
+}
+
+static void cam_eeprom_cal_cache_update(struct cam_eeprom_ctrl_t *e_ctrl)
+{
+	struct cam_eeprom_cal_cache_t *cache = &e_ctrl->cal_cache;
+
+	cam_eeprom_free_cal_cache(e_ctrl);
+
+	cache->data = vmalloc(e_ctrl->cal_data.num_data);
+	if (!cache->data)
+		return;
+
+	memcpy(cache->data, e_ctrl->cal_data.mapdata,
+		e_ctrl->cal_data.num_data);
+	cache->size = e_ctrl->cal_data.num_data;
+	cache->map_crc = cam_eeprom_cal_map_crc(&e_ctrl->cal_data);
+}
+
+void cam_eeprom_free_cal_cache(struct cam_eeprom_ctrl_t *e_ctrl)
+{
+	vfree(e_ctrl->cal_cache.data);
+	e_ctrl->cal_cache.data = NULL;
+	e_ctrl->cal_cache.size = 0;
+	e_ctrl->cal_cache.map_crc = 0;
+}
+
 /**
  * cam_eeprom_get_cal_data - parse the userspace IO config and
  *                                        copy read data to share with userspace
@@ -1309,6 +1361,12 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 			goto error;
 		}
 
+		if (cam_eeprom_cal_cache_lookup(e_ctrl)) {
+			CAM_DBG(CAM_EEPROM, "Using cached calibration data");
+			rc = cam_eeprom_get_cal_data(e_ctrl, csl_packet);
+			goto release_cal_data;
+		}
+
 		if (e_ctrl->eeprom_device_type == MSM_CAMERA_SPI_DEVICE) {
 			rc = cam_eeprom_match_id(e_ctrl);
 			if (rc) {
@@ -1336,12 +1394,14 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 				rc = cam_eeprom_power_down(e_ctrl);
 				usleep_range(10*1000, 11*1000);
 			} else {
+				cam_eeprom_cal_cache_update(e_ctrl);
 				rc = cam_eeprom_get_cal_data(e_ctrl, csl_packet);
 				rc = cam_eeprom_power_down(e_ctrl);
 				break;
 			}
 		}
 		/* xiaomi add eeprom read retry - end */
+release_cal_data:
 		e_ctrl->cam_eeprom_state = CAM_EEPROM_ACQUIRE;
 		vfree(e_ctrl->cal_data.mapdata);
 		vfree(e_ctrl->cal_data.map);
@@ -1358,6 +1418,9 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 		struct i2c_settings_array *i2c_reg_settings =
 			&e_ctrl->wr_settings;
 
+		/* The contents are about to change, read them again next time */
+		cam_eeprom_free_cal_cache(e_ctrl);
+
 		i2c_reg_settings->is_settings_valid = 1;
 		rc = cam_eeprom_parse_write_memory_packet(
 			csl_packet, e_ctrl);
@@ -18,6 +18,13 @@ int32_t cam_eeprom_parse_read_memory_map(struct device_node *of_node,
  */
 void cam_eeprom_shutdown(struct cam_eeprom_ctrl_t *e_ctrl);
 
+/**
+ * @e_ctrl: EEPROM ctrl structure
+ *
+ * This API drops the calibration data cached across sessions
+ */
+void cam_eeprom_free_cal_cache(struct cam_eeprom_ctrl_t *e_ctrl);
+
 struct completion *cam_eeprom_get_i3c_completion(uint32_t index);
 
 #endif
@@ -316,6 +316,7 @@ static void cam_eeprom_i2c_component_unbind(struct device *dev,
 	cam_eeprom_shutdown(e_ctrl);
 	mutex_unlock(&(e_ctrl->eeprom_mutex));
 	mutex_destroy(&(e_ctrl->eeprom_mutex));
+	cam_eeprom_free_cal_cache(e_ctrl);
 	cam_unregister_subdev(&(e_ctrl->v4l2_dev_str));
 	kfree(soc_private);
 	v4l2_set_subdevdata(&e_ctrl->v4l2_dev_str.sd, NULL);
@@ -481,6 +482,7 @@ static int cam_eeprom_spi_driver_remove(struct spi_device *sdev)
 	cam_eeprom_shutdown(e_ctrl);
 	mutex_unlock(&(e_ctrl->eeprom_mutex));
 	mutex_destroy(&(e_ctrl->eeprom_mutex));
+	cam_eeprom_free_cal_cache(e_ctrl);
 	cam_unregister_subdev(&(e_ctrl->v4l2_dev_str));
 	kfree(e_ctrl->io_master_info.spi_client);
 	e_ctrl->io_master_info.spi_client = NULL;
@@ -620,6 +622,7 @@ static void cam_eeprom_component_unbind(struct device *dev,
 	cam_eeprom_shutdown(e_ctrl);
 	mutex_unlock(&(e_ctrl->eeprom_mutex));
 	mutex_destroy(&(e_ctrl->eeprom_mutex));
+	cam_eeprom_free_cal_cache(e_ctrl);
 	cam_unregister_subdev(&(e_ctrl->v4l2_dev_str));
 	/* xiaomi add for cci debug start */
 	cam_cci_dev_remove_debugfs_entry((void *)e_ctrl->cci_debug);
@@ -94,6 +94,19 @@ struct cam_eeprom_memory_block_t {
 	uint32_t num_data;
 };
 
+/**
+ * struct cam_eeprom_cal_cache_t - calibration data kept across sessions
+ * @data            :   copy of the last successfully read map data
+ * @size            :   size of the cached data
+ * @map_crc         :   crc of the memory map the data was read with
+ *
+ */
+struct cam_eeprom_cal_cache_t {
+	uint8_t *data;
+	uint32_t size;
+	uint32_t map_crc;
+};
+
 /**
  * struct cam_eeprom_cmm_t - camera multimodule
  * @cmm_support     :   cmm support flag
@@ -172,6 +185,7 @@ struct eebin_info {
  * @cam_eeprom_state    :   eeprom_device_state
  * @userspace_probe     :   flag indicates userspace or kernel probe
  * @cal_data            :   Calibration data
+ * @cal_cache           :   Calibration data cached from the last read
  * @device_name         :   Device name
  * @is_multimodule_mode :   To identify multimodule node
  * @wr_settings         :   I2C write settings
@@ -195,6 +209,7 @@ struct cam_eeprom_ctrl_t {
 	enum cam_eeprom_state cam_eeprom_state;
 	bool userspace_probe;
 	struct cam_eeprom_memory_block_t cal_data;
+	struct cam_eeprom_cal_cache_t cal_cache;
 	uint16_t is_multimodule_mode;
 	struct i2c_settings_array wr_settings;
 	struct eebin_info eebin_info;
@@ -573,6 +573,36 @@ static int32_t cam_sensor_i2c_modes_util(
 	return rc;
 }
 
+/*
+ * Random writes of consecutive settings arrays are queued and written
+ * together, any other operation first writes out what is queued.
+ */
+static int32_t cam_sensor_i2c_modes_util_batched(
+	struct camera_io_master *io_master_info,
+	struct i2c_settings_list *i2c_list,
+	struct camera_io_batch *batch)
+{
+	int32_t rc;
+
+	if (i2c_list->op_code == CAM_SENSOR_I2C_WRITE_RANDOM) {
+		rc = camera_io_dev_write_batched(io_master_info, batch,
+			&(i2c_list->i2c_settings));
+		if (rc < 0)
+			CAM_ERR(CAM_SENSOR,
+				"Failed to random write I2C settings: %d", rc);
+		return rc;
+	}
+
+	rc = camera_io_dev_flush_batch(io_master_info, batch);
+	if (rc < 0) {
+		CAM_ERR(CAM_SENSOR,
+			"Failed to random write I2C settings: %d", rc);
+		return rc;
+	}
+
+	return cam_sensor_i2c_modes_util(io_master_info, i2c_list);
+}
+
 int32_t cam_sensor_update_i2c_info(struct cam_cmd_i2c_info *i2c_info,
 	struct cam_sensor_ctrl_t *s_ctrl)
 {
@@ -1758,6 +1788,7 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 	struct i2c_settings_array *i2c_set = NULL;
 	struct i2c_settings_list *i2c_list;
 	int32_t j = 0; // xiaomi add
+	struct camera_io_batch batch = {0};
 
 	if (req_id == 0) {
 		switch (opcode) {
@@ -1847,9 +1878,9 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 				default:
 					break;
 				} /* xiaomi add I2C trace end */
-				rc = cam_sensor_i2c_modes_util(
+				rc = cam_sensor_i2c_modes_util_batched(
 					&(s_ctrl->io_master_info),
-					i2c_list);
+					i2c_list, &batch);
 				if (rc < 0) {
 					CAM_ERR(CAM_SENSOR,
 						"Failed to apply settings: %d",
@@ -1857,6 +1888,13 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 					return rc;
 				}
 			}
+			rc = camera_io_dev_flush_batch(
+				&(s_ctrl->io_master_info), &batch);
+			if (rc < 0) {
+				CAM_ERR(CAM_SENSOR,
+					"Failed to apply settings: %d", rc);
+				return rc;
+			}
 		}
 	} else if (req_id > 0) {
 		offset = req_id % MAX_PER_FRAME_ARRAY;
@@ -1894,9 +1932,9 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 				default:
 					break;
 				} /* xiaomi add I2C trace end */
-				rc = cam_sensor_i2c_modes_util(
+				rc = cam_sensor_i2c_modes_util_batched(
 					&(s_ctrl->io_master_info),
-					i2c_list);
+					i2c_list, &batch);
 				if (rc < 0) {
 					CAM_ERR(CAM_SENSOR,
 						"Failed to apply settings: %d",
@@ -1904,6 +1942,13 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 					return rc;
 				}
 			}
+			rc = camera_io_dev_flush_batch(
+				&(s_ctrl->io_master_info), &batch);
+			if (rc < 0) {
+				CAM_ERR(CAM_SENSOR,
+					"Failed to apply settings: %d", rc);
+				return rc;
+			}
 			CAM_DBG(CAM_SENSOR, "applied req_id: %llu", req_id);
 		} else {
 			CAM_DBG(CAM_SENSOR,
@@ -4,6 +4,8 @@
  * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/mm.h>
+
 #include "cam_sensor_io.h"
 #include "cam_sensor_i2c.h"
 #include "cam_sensor_i3c.h"
@@ -186,6 +188,111 @@ int32_t camera_io_dev_write_continuous(struct camera_io_master *io_master_info,
 	return -EINVAL;
 }
 
+static int32_t camera_io_dev_write_merged(
+	struct camera_io_master *io_master_info,
+	struct camera_io_batch *batch)
+{
+	struct cam_sensor_i2c_reg_setting merged;
+	struct cam_sensor_i2c_reg_setting *last =
+		batch->settings[batch->num_settings - 1];
+	uint32_t i, size = 0;
+	int32_t rc;
+
+	for (i = 0; i < batch->num_settings; i++)
+		size += batch->settings[i]->size;
+
+	merged.reg_setting = kvcalloc(size,
+		sizeof(struct cam_sensor_i2c_reg_array), GFP_KERNEL);
+	if (!merged.reg_setting)
+		return -ENOMEM;
+
+	for (i = 0, size = 0; i < batch->num_settings; i++) {
+		memcpy(&merged.reg_setting[size],
+			batch->settings[i]->reg_setting,
+			batch->settings[i]->size *
+			sizeof(struct cam_sensor_i2c_reg_array));
+		size += batch->settings[i]->size;
+	}
+
+	merged.size = size;
+	merged.addr_type = last->addr_type;
+	merged.data_type = last->data_type;
+	merged.delay = last->delay;
+
+	CAM_DBG(CAM_SENSOR, "merged %u settings into %u writes",
+		batch->num_settings, size);
+
+	rc = cam_cci_i2c_write_table(io_master_info, &merged);
+	kvfree(merged.reg_setting);
+
+	return rc;
+}
+
+int32_t camera_io_dev_flush_batch(struct camera_io_master *io_master_info,
+	struct camera_io_batch *batch)
+{
+	int32_t rc = 0;
+	uint32_t i;
+
+	if (!batch || !io_master_info) {
+		CAM_ERR(CAM_SENSOR,
+			"Input parameters not valid batch: %pK ioinfo: %pK",
+			batch, io_master_info);
+		return -EINVAL;
+	}
+
+	if (!batch->num_settings)
+		return 0;
+
+	if ((batch->num_settings > 1) &&
+		(io_master_info->master_type == CCI_MASTER)) {
+		rc = camera_io_dev_write_merged(io_master_info, batch);
+	} else {
+		for (i = 0; i < batch->num_settings; i++) {
+			rc = camera_io_dev_write(io_master_info,
+				batch->settings[i]);
+			if (rc < 0)
+				break;
+		}
+	}
+
+	batch->num_settings = 0;
+	return rc;
+}
+
+int32_t camera_io_dev_write_batched(struct camera_io_master *io_master_info,
+	struct camera_io_batch *batch,
+	struct cam_sensor_i2c_reg_setting *write_setting)
+{
+	struct cam_sensor_i2c_reg_setting *first;
+	int32_t rc = 0;
+
+	if (!batch || !write_setting || !write_setting->reg_setting) {
+		CAM_ERR(CAM_SENSOR, "Input parameters not valid batch: %pK ws: %pK",
+			batch, write_setting);
+		return -EINVAL;
+	}
+
+	if (batch->num_settings) {
+		first = batch->settings[0];
+		if ((first->addr_type != write_setting->addr_type) ||
+			(first->data_type != write_setting->data_type)) {
+			rc = camera_io_dev_flush_batch(io_master_info, batch);
+			if (rc < 0)
+				return rc;
+		}
+	}
+
+	batch->settings[batch->num_settings++] = write_setting;
+
+	/* A delay has to follow its own setting, so it ends the batch */
+	if (write_setting->delay ||
+		(batch->num_settings == CAMERA_IO_MAX_BATCH))
+		rc = camera_io_dev_flush_batch(io_master_info, batch);
+
+	return rc;
+}
+
 int32_t camera_io_init(struct camera_io_master *io_master_info)
 {
 	if (!io_master_info) {
@@ -10,6 +10,8 @@
 #include <media/cam_sensor.h>
 #include "cam_sensor_cmn_header.h"
 
+#define CAMERA_IO_MAX_BATCH 16
+
 /* Master Types */
 #define CCI_MASTER           1
 #define I2C_MASTER           2
@@ -98,6 +100,40 @@ int32_t camera_io_dev_write_continuous(struct camera_io_master *io_master_info,
 	struct cam_sensor_i2c_reg_setting *write_setting,
 	uint8_t cam_sensor_i2c_write_flag);
 
+/**
+ * struct camera_io_batch - Random write settings queued for one transfer
+ * @settings: Queued settings arrays, all sharing addr and data type
+ * @num_settings: Number of queued settings arrays
+ */
+struct camera_io_batch {
+	struct cam_sensor_i2c_reg_setting *settings[CAMERA_IO_MAX_BATCH];
+	uint32_t num_settings;
+};
+
+/**
+ * @io_master_info: I2C/SPI master information
+ * @batch: Batch the write setting is queued to
+ * @write_setting: Random write settings information
+ *
+ * This API queues a random write setting to the batch. The batch is
+ * flushed first if the setting cannot be merged with it, and right
+ * after queueing if the setting carries a delay or the batch is full.
+ */
+int32_t camera_io_dev_write_batched(struct camera_io_master *io_master_info,
+	struct camera_io_batch *batch,
+	struct cam_sensor_i2c_reg_setting *write_setting);
+
+/**
+ * @io_master_info: I2C/SPI master information
+ * @batch: Batch to write out
+ *
+ * This API writes all queued settings of the batch. On CCI masters the
+ * arrays are merged into one table so contiguous registers across arrays
+ * are packed together and a single queue report is waited for.
+ */
+int32_t camera_io_dev_flush_batch(struct camera_io_master *io_master_info,
+	struct camera_io_batch *batch);
+
 int32_t camera_io_dev_erase(struct camera_io_master *io_master_info,
 	uint32_t addr, uint32_t size);
 /**
@@ -15,6 +15,7 @@
 #include <linux/msm_dma_iommu_mapping.h>
 #include <linux/workqueue.h>
 #include <linux/genalloc.h>
+#include <linux/hashtable.h>
 #include <linux/debugfs.h>
 #include <linux/dma-iommu.h>
 
@@ -126,6 +127,8 @@ struct cam_smmu_debug {
 	uint32_t fatal_pf_mask;
 };
 
+#define CAM_SMMU_BUF_HASH_BITS 7
+
 struct cam_context_bank_info {
 	struct device *dev;
 	struct iommu_domain *domain;
@@ -163,6 +166,8 @@ struct cam_context_bank_info {
 
 	struct list_head smmu_buf_list;
 	struct list_head smmu_buf_kernel_list;
+	/* index of non secure user and kernel mappings keyed by inode */
+	DECLARE_HASHTABLE(buf_hash, CAM_SMMU_BUF_HASH_BITS);
 	struct mutex lock;
 	int handle;
 	enum cam_smmu_ops_param state;
@@ -184,7 +189,7 @@ struct cam_context_bank_info {
 	size_t discard_iova_len;
 
 	atomic64_t monitor_head;
-	struct cam_smmu_monitor monitor_entries[CAM_SMMU_MONITOR_MAX_ENTRIES];
+	struct cam_smmu_monitor *monitor_entries;
 };
 
 struct cam_iommu_cb_set {
@@ -217,6 +222,7 @@ struct cam_dma_buff_info {
 	int ref_count;
 	dma_addr_t paddr;
 	struct list_head list;
+	struct hlist_node hlist;
 	int ion_fd;
 	unsigned long i_ino;
 	size_t len;
@@ -361,23 +367,54 @@ static int cam_smmu_probe(struct platform_device *pdev);
 
 static uint32_t cam_smmu_find_closest_mapping(int idx, void *vaddr, bool *in_map_region);
 
+/*
+ * Most context banks never see a mapping on a given use case, so the
+ * monitor array is only allocated on the first map of the bank.
+ */
+static struct cam_smmu_monitor *cam_smmu_get_monitor_entries(
+	struct cam_context_bank_info *cb_info)
+{
+	struct cam_smmu_monitor *entries;
+
+	entries = READ_ONCE(cb_info->monitor_entries);
+	if (entries)
+		return entries;
+
+	entries = kcalloc(CAM_SMMU_MONITOR_MAX_ENTRIES,
+		sizeof(struct cam_smmu_monitor), GFP_KERNEL);
+	if (!entries)
+		return NULL;
+
+	if (cmpxchg(&cb_info->monitor_entries, NULL, entries)) {
+		kfree(entries);
+		entries = READ_ONCE(cb_info->monitor_entries);
+	}
+
+	return entries;
+}
+
 static void cam_smmu_update_monitor_array(
 	struct cam_context_bank_info *cb_info,
 	bool is_map,
 	struct cam_dma_buff_info *mapping_info)
 {
 	int iterator;
+	struct cam_smmu_monitor *entries;
+
+	entries = cam_smmu_get_monitor_entries(cb_info);
+	if (!entries)
+		return;
 
 	CAM_SMMU_INC_MONITOR_HEAD(&cb_info->monitor_head, &iterator);
 
-	CAM_GET_TIMESTAMP(cb_info->monitor_entries[iterator].timestamp);
+	CAM_GET_TIMESTAMP(entries[iterator].timestamp);
 
-	cb_info->monitor_entries[iterator].is_map = is_map;
-	cb_info->monitor_entries[iterator].ion_fd = mapping_info->ion_fd;
-	cb_info->monitor_entries[iterator].i_ino = mapping_info->i_ino;
-	cb_info->monitor_entries[iterator].paddr = mapping_info->paddr;
-	cb_info->monitor_entries[iterator].len = mapping_info->len;
-	cb_info->monitor_entries[iterator].region_id = mapping_info->region_id;
+	entries[iterator].is_map = is_map;
+	entries[iterator].ion_fd = mapping_info->ion_fd;
+	entries[iterator].i_ino = mapping_info->i_ino;
+	entries[iterator].paddr = mapping_info->paddr;
+	entries[iterator].len = mapping_info->len;
+	entries[iterator].region_id = mapping_info->region_id;
 }
 
 static void cam_smmu_dump_monitor_array(
@@ -390,7 +427,7 @@ static void cam_smmu_dump_monitor_array(
 
 	state_head = atomic64_read(&cb_info->monitor_head);
 
-	if (state_head == -1) {
+	if ((state_head == -1) || !cb_info->monitor_entries) {
 		return;
 	} else if (state_head < CAM_SMMU_MONITOR_MAX_ENTRIES) {
 		num_entries = state_head;
@@ -980,6 +1017,7 @@ void cam_smmu_reset_iommu_table(enum cam_smmu_init_dir ops)
 		iommu_cb_set.cb_info[i].handle = HANDLE_INIT;
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_list);
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_kernel_list);
+		hash_init(iommu_cb_set.cb_info[i].buf_hash);
 		iommu_cb_set.cb_info[i].state = CAM_SMMU_DETACH;
 		iommu_cb_set.cb_info[i].dev = NULL;
 		iommu_cb_set.cb_info[i].cb_count = 0;
@@ -1229,6 +1267,32 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_virt_address(int idx,
 	return NULL;
 }
 
+/*
+ * Look up a non secure mapping in the context bank index. User mappings
+ * match on fd and inode, kernel mappings (ion_fd < 0) on the dma_buf.
+ */
+static struct cam_dma_buff_info *cam_smmu_lookup_mapping(int idx,
+	int ion_fd, struct dma_buf *dmabuf)
+{
+	struct cam_dma_buff_info *mapping;
+	unsigned long i_ino;
+
+	i_ino = file_inode(dmabuf->file)->i_ino;
+
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].buf_hash, mapping,
+		hlist, i_ino) {
+		if (ion_fd < 0) {
+			if ((mapping->ion_fd < 0) && (mapping->buf == dmabuf))
+				return mapping;
+		} else if ((mapping->ion_fd == ion_fd) &&
+			(mapping->i_ino == i_ino)) {
+			return mapping;
+		}
+	}
+
+	return NULL;
+}
+
 static struct cam_dma_buff_info *cam_smmu_find_mapping_by_ion_index(int idx,
 	int ion_fd, struct dma_buf *dmabuf)
 {
@@ -1242,13 +1306,10 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_ion_index(int idx,
 
 	i_ino = file_inode(dmabuf->file)->i_ino;
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_list,
-			list) {
-		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
-			CAM_DBG(CAM_SMMU, "find ion_fd %d i_ino %lu", ion_fd, i_ino);
-			return mapping;
-		}
+	mapping = cam_smmu_lookup_mapping(idx, ion_fd, dmabuf);
+	if (mapping) {
+		CAM_DBG(CAM_SMMU, "find ion_fd %d i_ino %lu", ion_fd, i_ino);
+		return mapping;
 	}
 
 	CAM_ERR(CAM_SMMU, "Error: Cannot find entry by index %d, fd %d i_ino %lu",
@@ -1267,13 +1328,10 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_dma_buf(int idx,
 		return NULL;
 	}
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list,
-			list) {
-		if (mapping->buf == buf) {
-			CAM_DBG(CAM_SMMU, "find dma_buf %pK", buf);
-			return mapping;
-		}
+	mapping = cam_smmu_lookup_mapping(idx, -1, buf);
+	if (mapping) {
+		CAM_DBG(CAM_SMMU, "find dma_buf %pK", buf);
+		return mapping;
 	}
 
 	CAM_ERR(CAM_SMMU, "Error: Cannot find entry by index %d", idx);
@@ -2343,6 +2401,8 @@ static int cam_smmu_map_buffer_and_add_to_list(int idx, int ion_fd,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_list);
+	hash_add(iommu_cb_set.cb_info[idx].buf_hash, &mapping_info->hlist,
+		mapping_info->i_ino);
 
 	CAM_DBG(CAM_SMMU, "fd %d i_ino %lu dmabuf %pK", ion_fd, mapping_info->i_ino, buf);
 
@@ -2375,6 +2435,8 @@ static int cam_smmu_map_kernel_buffer_and_add_to_list(int idx,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list);
+	hash_add(iommu_cb_set.cb_info[idx].buf_hash, &mapping_info->hlist,
+		mapping_info->i_ino);
 
 	CAM_DBG(CAM_SMMU, "fd %d i_ino %lu dmabuf %pK",
 		mapping_info->ion_fd, mapping_info->i_ino, buf);
@@ -2469,6 +2531,7 @@ static int cam_smmu_unmap_buf_and_remove_from_list(
 	mapping_info->buf = NULL;
 
 	list_del_init(&mapping_info->list);
+	hash_del(&mapping_info->hlist);
 
 	/* free one buffer */
 	kfree(mapping_info);
@@ -2480,21 +2543,16 @@ static enum cam_smmu_buf_state cam_smmu_check_fd_in_list(int idx,
 	struct timespec64 **ts_mapping)
 {
 	struct cam_dma_buff_info *mapping;
-	unsigned long i_ino;
 
-	i_ino = file_inode(dmabuf->file)->i_ino;
+	mapping = cam_smmu_lookup_mapping(idx, ion_fd, dmabuf);
+	if (!mapping)
+		return CAM_SMMU_BUFF_NOT_EXIST;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
-		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			*ts_mapping = &mapping->ts;
-			return CAM_SMMU_BUFF_EXIST;
-		}
-	}
+	*paddr_ptr = mapping->paddr;
+	*len_ptr = mapping->len;
+	*ts_mapping = &mapping->ts;
 
-	return CAM_SMMU_BUFF_NOT_EXIST;
+	return CAM_SMMU_BUFF_EXIST;
 }
 
 static enum cam_smmu_buf_state cam_smmu_user_reuse_fd_in_list(int idx,
@@ -2502,22 +2560,17 @@ static enum cam_smmu_buf_state cam_smmu_user_reuse_fd_in_list(int idx,
 	struct timespec64 **ts_mapping)
 {
 	struct cam_dma_buff_info *mapping;
-	unsigned long i_ino;
 
-	i_ino = file_inode(dmabuf->file)->i_ino;
+	mapping = cam_smmu_lookup_mapping(idx, ion_fd, dmabuf);
+	if (!mapping)
+		return CAM_SMMU_BUFF_NOT_EXIST;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
-		if ((mapping->ion_fd == ion_fd) && (mapping->i_ino == i_ino)) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			*ts_mapping = &mapping->ts;
-			mapping->ref_count++;
-			return CAM_SMMU_BUFF_EXIST;
-		}
-	}
+	*paddr_ptr = mapping->paddr;
+	*len_ptr = mapping->len;
+	*ts_mapping = &mapping->ts;
+	mapping->ref_count++;
 
-	return CAM_SMMU_BUFF_NOT_EXIST;
+	return CAM_SMMU_BUFF_EXIST;
 }
 
 static enum cam_smmu_buf_state cam_smmu_check_dma_buf_in_list(int idx,
@@ -2525,16 +2578,14 @@ static enum cam_smmu_buf_state cam_smmu_check_dma_buf_in_list(int idx,
 {
 	struct cam_dma_buff_info *mapping;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list, list) {
-		if (mapping->buf == buf) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			return CAM_SMMU_BUFF_EXIST;
-		}
-	}
+	mapping = cam_smmu_lookup_mapping(idx, -1, buf);
+	if (!mapping)
+		return CAM_SMMU_BUFF_NOT_EXIST;
 
-	return CAM_SMMU_BUFF_NOT_EXIST;
+	*paddr_ptr = mapping->paddr;
+	*len_ptr = mapping->len;
+
+	return CAM_SMMU_BUFF_EXIST;
 }
 
 static enum cam_smmu_buf_state cam_smmu_check_secure_fd_in_list(int idx,
@@ -3790,6 +3841,10 @@ static void cam_smmu_deinit_cb(struct cam_context_bank_info *cb)
 		kfree(cb->scratch_map.bitmap);
 		cb->scratch_map.bitmap = NULL;
 	}
+
+	kfree(cb->monitor_entries);
+	cb->monitor_entries = NULL;
+	atomic64_set(&cb->monitor_head, -1);
 }
 
 static void cam_smmu_release_cb(struct platform_device *pdev)
@@ -4377,7 +4432,7 @@ static void cam_smmu_mini_dump_entries(
 
 	state_head = atomic64_read(&src->monitor_head);
 
-	if (state_head == -1) {
+	if ((state_head == -1) || !src->monitor_entries) {
 		return;
 	} else if (state_head < CAM_SMMU_MONITOR_MAX_ENTRIES) {
 		num_entries = state_head;
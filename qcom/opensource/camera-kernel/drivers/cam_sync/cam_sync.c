@@ -10,6 +10,8 @@
 #include <linux/module.h>
 #include <linux/platform_device.h>
 #include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/math64.h>
 #if IS_REACHABLE(CONFIG_MSM_GLOBAL_SYNX)
 #include <synx_api.h>
 #endif
@@ -122,8 +124,8 @@ int cam_sync_create(int32_t *sync_obj, const char *name)
 	return cam_sync_create_util(sync_obj, name, NULL);
 }
 
-int cam_sync_register_callback(sync_callback cb_func,
-	void *userdata, int32_t sync_obj)
+static int __cam_sync_register_callback(sync_callback cb_func,
+	void *userdata, int32_t sync_obj, bool inline_cb)
 {
 	struct sync_callback_info *sync_cb;
 	struct sync_table_row *row = NULL;
@@ -155,7 +157,7 @@ int cam_sync_register_callback(sync_callback cb_func,
 		(row->state == CAM_SYNC_STATE_SIGNALED_ERROR) ||
 		(row->state == CAM_SYNC_STATE_SIGNALED_CANCEL)) &&
 		(!row->remaining)) {
-		if (trigger_cb_without_switch) {
+		if (trigger_cb_without_switch || inline_cb) {
 			CAM_DBG(CAM_SYNC, "Invoke callback for sync object:%s[%d]",
 				row->name,
 				sync_obj);
@@ -185,6 +187,7 @@ int cam_sync_register_callback(sync_callback cb_func,
 	sync_cb->callback_func = cb_func;
 	sync_cb->cb_data = userdata;
 	sync_cb->sync_obj = sync_obj;
+	sync_cb->inline_cb = inline_cb;
 	INIT_WORK(&sync_cb->cb_dispatch_work, cam_sync_util_cb_dispatch);
 	list_add_tail(&sync_cb->list, &row->callback_list);
 	spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
@@ -192,6 +195,18 @@ int cam_sync_register_callback(sync_callback cb_func,
 	return 0;
 }
 
+int cam_sync_register_callback(sync_callback cb_func,
+	void *userdata, int32_t sync_obj)
+{
+	return __cam_sync_register_callback(cb_func, userdata, sync_obj, false);
+}
+
+int cam_sync_register_callback_inline(sync_callback cb_func,
+	void *userdata, int32_t sync_obj)
+{
+	return __cam_sync_register_callback(cb_func, userdata, sync_obj, true);
+}
+
 int cam_sync_deregister_callback(sync_callback cb_func,
 	void *userdata, int32_t sync_obj)
 {
@@ -260,7 +275,8 @@ static inline int cam_sync_signal_dma_fence_util(
 }
 
 static void cam_sync_signal_parent_util(int32_t status,
-	uint32_t event_cause, struct list_head *parents_list)
+	uint32_t event_cause, struct list_head *parents_list,
+	struct list_head *inline_cbs)
 {
 	int rc;
 	struct sync_table_row *parent_row = NULL;
@@ -291,7 +307,7 @@ static void cam_sync_signal_parent_util(int32_t status,
 		if (!parent_row->remaining)
 			cam_sync_util_dispatch_signaled_cb(
 				parent_info->sync_id, parent_row->state,
-				event_cause);
+				event_cause, inline_cbs);
 
 		spin_unlock_bh(&sync_dev->row_spinlocks[parent_info->sync_id]);
 		list_del_init(&parent_info->list);
@@ -340,6 +356,7 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 {
 	struct sync_table_row *row = NULL;
 	struct list_head parents_list;
+	struct list_head inline_cbs;
 	int rc = 0;
 
 	if (sync_obj >= CAM_SYNC_MAX_OBJS || sync_obj <= 0) {
@@ -378,17 +395,20 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 				row->dma_fence_info.dma_fence_fd, row->name, sync_obj);
 	}
 
-	cam_sync_util_dispatch_signaled_cb(sync_obj, status, event_cause);
+	INIT_LIST_HEAD(&inline_cbs);
+	cam_sync_util_dispatch_signaled_cb(sync_obj, status, event_cause,
+		&inline_cbs);
 
 	/* copy parent list to local and release child lock */
 	INIT_LIST_HEAD(&parents_list);
 	list_splice_init(&row->parents_list, &parents_list);
 	spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
 
-	if (list_empty(&parents_list))
-		return 0;
+	if (!list_empty(&parents_list))
+		cam_sync_signal_parent_util(status, event_cause, &parents_list,
+			&inline_cbs);
 
-	cam_sync_signal_parent_util(status, event_cause, &parents_list);
+	cam_sync_util_run_inline_cbs(&inline_cbs);
 
 	return 0;
 }
@@ -926,7 +946,8 @@ static int cam_sync_dma_fence_cb(
 
 	row->state = status;
 
-	cam_sync_util_dispatch_signaled_cb(sync_obj, status, 0);
+	/* Invoked under the dma fence lock, no inline callbacks here */
+	cam_sync_util_dispatch_signaled_cb(sync_obj, status, 0, NULL);
 
 	INIT_LIST_HEAD(&parents_list);
 	list_splice_init(&row->parents_list, &parents_list);
@@ -935,7 +956,7 @@ static int cam_sync_dma_fence_cb(
 	if (list_empty(&parents_list))
 		return 0;
 
-	cam_sync_signal_parent_util(status, 0x0, &parents_list);
+	cam_sync_signal_parent_util(status, 0x0, &parents_list, NULL);
 	return 0;
 
 end:
@@ -1805,6 +1826,133 @@ static void cam_sync_init_entity(struct sync_device *sync_dev)
 }
 #endif
 
+enum cam_sync_bench_stage {
+	CAM_SYNC_BENCH_CREATE,
+	CAM_SYNC_BENCH_REGISTER_CB,
+	CAM_SYNC_BENCH_SIGNAL,
+	CAM_SYNC_BENCH_DESTROY,
+	CAM_SYNC_BENCH_MAX,
+};
+
+static const char *cam_sync_bench_stage_names[CAM_SYNC_BENCH_MAX] = {
+	"create",
+	"register_cb",
+	"signal",
+	"destroy",
+};
+
+/**
+ * struct cam_sync_bench_result - Result of the last sync object benchmark
+ *
+ * @iterations: Number of create/register/signal/destroy rounds run
+ * @num_cb:     Number of inline callbacks that fired
+ * @total_ns:   Time spent per stage
+ * @max_ns:     Slowest single call per stage
+ */
+struct cam_sync_bench_result {
+	uint32_t iterations;
+	atomic_t num_cb;
+	uint64_t total_ns[CAM_SYNC_BENCH_MAX];
+	uint64_t max_ns[CAM_SYNC_BENCH_MAX];
+};
+
+static struct cam_sync_bench_result sync_bench;
+static DEFINE_MUTEX(sync_bench_mutex);
+
+static void cam_sync_bench_cb(int32_t sync_obj, int status, void *data)
+{
+	atomic_inc(&sync_bench.num_cb);
+}
+
+static inline void cam_sync_bench_account(enum cam_sync_bench_stage stage,
+	uint64_t start_ns)
+{
+	uint64_t delta = ktime_get_ns() - start_ns;
+
+	sync_bench.total_ns[stage] += delta;
+	if (delta > sync_bench.max_ns[stage])
+		sync_bench.max_ns[stage] = delta;
+}
+
+/*
+ * Drive sync objects through their whole life cycle in a loop, so the
+ * CPU cost of the sync path can be compared between builds without any
+ * camera hardware.
+ */
+static int cam_sync_bench_run(void *data, u64 val)
+{
+	int32_t sync_obj;
+	uint64_t start;
+	uint32_t i;
+	int rc = 0;
+
+	if (!val || (val > CAM_SYNC_MAX_OBJS))
+		return -EINVAL;
+
+	mutex_lock(&sync_bench_mutex);
+	memset(&sync_bench, 0, sizeof(sync_bench));
+
+	for (i = 0; i < val; i++) {
+		start = ktime_get_ns();
+		rc = cam_sync_create(&sync_obj, "sync_bench");
+		if (rc)
+			break;
+		cam_sync_bench_account(CAM_SYNC_BENCH_CREATE, start);
+
+		start = ktime_get_ns();
+		rc = cam_sync_register_callback_inline(cam_sync_bench_cb, NULL,
+			sync_obj);
+		cam_sync_bench_account(CAM_SYNC_BENCH_REGISTER_CB, start);
+		if (rc)
+			goto destroy;
+
+		start = ktime_get_ns();
+		rc = cam_sync_signal(sync_obj, CAM_SYNC_STATE_SIGNALED_SUCCESS,
+			CAM_SYNC_COMMON_EVENT_SUCCESS);
+		cam_sync_bench_account(CAM_SYNC_BENCH_SIGNAL, start);
+
+destroy:
+		start = ktime_get_ns();
+		cam_sync_destroy(sync_obj);
+		cam_sync_bench_account(CAM_SYNC_BENCH_DESTROY, start);
+		if (rc)
+			break;
+
+		sync_bench.iterations++;
+	}
+
+	mutex_unlock(&sync_bench_mutex);
+
+	if (rc)
+		CAM_ERR(CAM_SYNC, "Benchmark stopped after %u rounds rc: %d",
+			sync_bench.iterations, rc);
+
+	return rc;
+}
+
+DEFINE_SIMPLE_ATTRIBUTE(cam_sync_bench_run_fops, NULL,
+	cam_sync_bench_run, "%llu\n");
+
+static int cam_sync_bench_show(struct seq_file *m, void *unused)
+{
+	int i;
+
+	mutex_lock(&sync_bench_mutex);
+	seq_printf(m, "iterations: %u callbacks: %d\n",
+		sync_bench.iterations, atomic_read(&sync_bench.num_cb));
+	for (i = 0; i < CAM_SYNC_BENCH_MAX; i++)
+		seq_printf(m, "%-12s avg_ns: %llu max_ns: %llu\n",
+			cam_sync_bench_stage_names[i],
+			sync_bench.iterations ? div_u64(sync_bench.total_ns[i],
+			sync_bench.iterations) : 0,
+			sync_bench.max_ns[i]);
+	mutex_unlock(&sync_bench_mutex);
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(cam_sync_bench);
+
 static int cam_sync_create_debugfs(void)
 {
 	int rc = 0;
@@ -1824,6 +1972,10 @@ static int cam_sync_create_debugfs(void)
 
 	debugfs_create_bool("trigger_cb_without_switch", 0644,
 		sync_dev->dentry, &trigger_cb_without_switch);
+	debugfs_create_file("bench_run", 0200, sync_dev->dentry, NULL,
+		&cam_sync_bench_run_fops);
+	debugfs_create_file("bench_result", 0444, sync_dev->dentry, NULL,
+		&cam_sync_bench_fops);
 
 end:
 	return rc;
@@ -50,6 +50,26 @@ int cam_sync_create(int32_t *sync_obj, const char *name);
 int cam_sync_register_callback(sync_callback cb_func,
 	void *userdata, int32_t sync_obj);
 
+/**
+ * @brief: Registers a callback that runs in the signaling context
+ *
+ * Same as cam_sync_register_callback() but the callback is invoked directly
+ * by cam_sync_signal() after all sync locks are dropped, instead of being
+ * bounced through the sync workqueue. If the object is signaled from
+ * interrupt context or through an external dma fence the callback falls
+ * back to the workqueue. Only use this if the producer signals from a
+ * context where the callback may sleep and the callback does not take
+ * locks the producer can hold while signaling.
+ *
+ * @param cb_func:  Pointer to callback to be registered
+ * @param userdata: Opaque pointer which will be passed back with callback.
+ * @param sync_obj: int referencing the sync object.
+ *
+ * @return Status of operation. Zero in case of success.
+ */
+int cam_sync_register_callback_inline(sync_callback cb_func,
+	void *userdata, int32_t sync_obj);
+
 /**
  * @brief: De-registers a callback with a sync object
  *
@@ -4,6 +4,16 @@
  */
 #include "cam_sync_dma_fence.h"
 
+#if IS_REACHABLE(CONFIG_QTI_HW_FENCE)
+/*
+ * Camera fences are signaled by the CPU on behalf of IFE, the tx queue
+ * update is followed by an ipc signal from the IFE0 physical client to
+ * the apps virtual client to let the fence controller process it.
+ */
+#define CAM_DMA_FENCE_HW_FENCE_TX_CLIENT  11
+#define CAM_DMA_FENCE_HW_FENCE_RX_CLIENT  8
+#endif
+
 /**
  * struct cam_dma_fence_row - DMA fence row
  */
@@ -18,6 +28,8 @@ struct cam_dma_fence_row {
 	bool                            cb_registered_for_sync;
 	bool                            ext_dma_fence;
 	bool                            sync_signal_dma;
+	bool                            hw_fence;
+	uint64_t                        hw_fence_idx;
 };
 
 /**
@@ -29,6 +41,10 @@ struct cam_dma_fence_device {
 	spinlock_t row_spinlocks[CAM_DMA_FENCE_MAX_FENCES];
 	struct mutex dev_lock;
 	DECLARE_BITMAP(bitmap, CAM_DMA_FENCE_MAX_FENCES);
+#if IS_REACHABLE(CONFIG_QTI_HW_FENCE)
+	void *hw_fence_handle;
+	struct msm_hw_fence_mem_addr hw_fence_mem;
+#endif
 };
 
 static atomic64_t g_cam_dma_fence_seq_no;
@@ -136,6 +152,117 @@ static void __cam_dma_fence_init_row(const char *name,
 	spin_unlock_bh(&g_cam_dma_fence_dev->row_spinlocks[idx]);
 }
 
+#if IS_REACHABLE(CONFIG_QTI_HW_FENCE)
+static void __cam_dma_fence_hw_fence_register(void)
+{
+	void *handle;
+
+	if (!IS_ERR_OR_NULL(g_cam_dma_fence_dev->hw_fence_handle))
+		return;
+
+	handle = msm_hw_fence_register(HW_FENCE_CLIENT_ID_IFE0,
+		&g_cam_dma_fence_dev->hw_fence_mem);
+	if (IS_ERR_OR_NULL(handle)) {
+		CAM_DBG(CAM_DMA_FENCE, "hw fence client not registered rc: %ld",
+			PTR_ERR(handle));
+		handle = NULL;
+	}
+
+	g_cam_dma_fence_dev->hw_fence_handle = handle;
+}
+
+static void __cam_dma_fence_hw_fence_deregister(void)
+{
+	if (IS_ERR_OR_NULL(g_cam_dma_fence_dev->hw_fence_handle))
+		return;
+
+	msm_hw_fence_deregister(g_cam_dma_fence_dev->hw_fence_handle);
+	g_cam_dma_fence_dev->hw_fence_handle = NULL;
+}
+
+static void __cam_dma_fence_hw_fence_create(struct dma_fence *dma_fence,
+	uint32_t idx)
+{
+	struct msm_hw_fence_create_params params;
+	struct cam_dma_fence_row *row;
+	uint64_t hw_fence_idx;
+	int rc;
+
+	if (!g_cam_dma_fence_dev->hw_fence_handle)
+		return;
+
+	params.fence = dma_fence;
+	params.handle = &hw_fence_idx;
+
+	/* Consumers fall back to a sw wait if this fence has no hw fence */
+	rc = msm_hw_fence_create(g_cam_dma_fence_dev->hw_fence_handle, &params);
+	if (rc) {
+		CAM_DBG(CAM_DMA_FENCE, "hw fence not created for seqno: %llu rc: %d",
+			dma_fence->seqno, rc);
+		return;
+	}
+
+	spin_lock_bh(&g_cam_dma_fence_dev->row_spinlocks[idx]);
+	row = &g_cam_dma_fence_dev->rows[idx];
+	row->hw_fence = true;
+	row->hw_fence_idx = hw_fence_idx;
+	spin_unlock_bh(&g_cam_dma_fence_dev->row_spinlocks[idx]);
+}
+
+static void __cam_dma_fence_hw_fence_signal(struct cam_dma_fence_row *row,
+	int32_t status)
+{
+	int rc;
+
+	if (!row->hw_fence)
+		return;
+
+	rc = msm_hw_fence_update_txq(g_cam_dma_fence_dev->hw_fence_handle,
+		row->hw_fence_idx, 0, (uint32_t)abs(status));
+	if (rc) {
+		CAM_WARN_RATE_LIMIT(CAM_DMA_FENCE,
+			"Failed to update hw fence txq seqno: %llu rc: %d",
+			row->fence->seqno, rc);
+		return;
+	}
+
+	msm_hw_fence_trigger_signal(g_cam_dma_fence_dev->hw_fence_handle,
+		CAM_DMA_FENCE_HW_FENCE_TX_CLIENT, CAM_DMA_FENCE_HW_FENCE_RX_CLIENT, 0);
+}
+
+static void __cam_dma_fence_hw_fence_destroy(struct cam_dma_fence_row *row)
+{
+	if (!row->hw_fence)
+		return;
+
+	msm_hw_fence_destroy(g_cam_dma_fence_dev->hw_fence_handle, row->fence);
+	row->hw_fence = false;
+}
+#else
+static inline void __cam_dma_fence_hw_fence_register(void)
+{
+}
+
+static inline void __cam_dma_fence_hw_fence_deregister(void)
+{
+}
+
+static inline void __cam_dma_fence_hw_fence_create(
+	struct dma_fence *dma_fence, uint32_t idx)
+{
+}
+
+static inline void __cam_dma_fence_hw_fence_signal(
+	struct cam_dma_fence_row *row, int32_t status)
+{
+}
+
+static inline void __cam_dma_fence_hw_fence_destroy(
+	struct cam_dma_fence_row *row)
+{
+}
+#endif
+
 void __cam_dma_fence_signal_cb(
 	struct dma_fence *fence, struct dma_fence_cb *cb)
 {
@@ -386,6 +513,8 @@ int cam_dma_fence_internal_signal(
 		return 0;
 	}
 
+	/* Release hw waiters before the sw fence callbacks run */
+	__cam_dma_fence_hw_fence_signal(row, signal_dma_fence->status);
 	rc = __cam_dma_fence_signal_fence(dma_fence, signal_dma_fence->status);
 	if (rc)
 		CAM_WARN(CAM_DMA_FENCE,
@@ -441,6 +570,8 @@ int cam_dma_fence_signal_fd(struct cam_dma_fence_signal *signal_dma_fence)
 		return 0;
 	}
 
+	/* Release hw waiters before the sw fence callbacks run */
+	__cam_dma_fence_hw_fence_signal(row, signal_dma_fence->status);
 	rc = __cam_dma_fence_signal_fence(dma_fence, signal_dma_fence->status);
 	if (rc)
 		CAM_WARN(CAM_DMA_FENCE,
@@ -503,6 +634,7 @@ static int __cam_dma_fence_get_fd(int32_t *row_idx,
 
 	*row_idx = idx;
 	__cam_dma_fence_init_row(name, dma_fence, fd, idx, false);
+	__cam_dma_fence_hw_fence_create(dma_fence, idx);
 
 	CAM_DBG(CAM_DMA_FENCE, "Created dma fence fd: %d[%s] seqno: %llu row_idx: %u ref_cnt: %u",
 		fd, name, dma_fence->seqno, idx, kref_read(&dma_fence->refcount));
@@ -558,8 +690,10 @@ static int __cam_dma_fence_release(int32_t dma_row_idx)
 		CAM_WARN(CAM_DMA_FENCE,
 			"Unsignaled fence being released name: %s seqno: %llu fd:%d",
 			row->name, dma_fence->seqno, row->fd);
+		__cam_dma_fence_hw_fence_signal(row, -ECANCELED);
 		__cam_dma_fence_signal_fence(dma_fence, -ECANCELED);
 	}
+	__cam_dma_fence_hw_fence_destroy(row);
 
 	CAM_DBG(CAM_DMA_FENCE,
 		"Releasing dma fence with fd: %d[%s] row_idx: %u current ref_cnt: %u",
@@ -633,8 +767,11 @@ void cam_dma_fence_close(void)
 
 			/* Signal and put if the dma fence is created from camera */
 			if (!row->ext_dma_fence) {
-				if (row->state != CAM_DMA_FENCE_STATE_SIGNALED)
+				if (row->state != CAM_DMA_FENCE_STATE_SIGNALED) {
+					__cam_dma_fence_hw_fence_signal(row, -EADV);
 					__cam_dma_fence_signal_fence(row->fence, -EADV);
+				}
+				__cam_dma_fence_hw_fence_destroy(row);
 				dma_fence_put(row->fence);
 			}
 
@@ -654,6 +791,7 @@ void cam_dma_fence_open(void)
 
 	/* DMA fence seqno reset */
 	atomic64_set(&g_cam_dma_fence_seq_no, 0);
+	__cam_dma_fence_hw_fence_register();
 	mutex_unlock(&g_cam_dma_fence_dev->dev_lock);
 	CAM_DBG(CAM_DMA_FENCE, "Camera DMA fence driver opened");
 }
@@ -679,6 +817,7 @@ int cam_dma_fence_driver_init(void)
 
 void cam_dma_fence_driver_deinit(void)
 {
+	__cam_dma_fence_hw_fence_deregister();
 	kfree(g_cam_dma_fence_dev);
 	g_cam_dma_fence_dev = NULL;
 	CAM_DBG(CAM_DMA_FENCE, "Camera DMA fence driver deinitialized");
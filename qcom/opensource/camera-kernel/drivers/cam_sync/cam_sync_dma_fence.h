@@ -14,6 +14,10 @@
 #include "cam_sync.h"
 #include "cam_debug_util.h"
 
+#if IS_REACHABLE(CONFIG_QTI_HW_FENCE)
+#include <linux/soc/qcom/msm_hw_fence.h>
+#endif
+
 #define CAM_DMA_FENCE_MAX_FENCES  128
 #define CAM_DMA_FENCE_NAME_LEN    128
 
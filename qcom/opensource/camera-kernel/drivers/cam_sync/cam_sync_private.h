@@ -104,12 +104,15 @@ struct sync_child_info {
  * @workq_scheduled_ts : workqueue scheduled timestamp
  * @cb_dispatch_work   : Work representing the call dispatch
  * @list               : List member used to append this node to a linked list
+ * @inline_cb          : Invoke the callback in the signaling context instead
+ *                       of the sync workqueue when possible
  */
 struct sync_callback_info {
 	sync_callback callback_func;
 	void *cb_data;
 	int status;
 	int32_t sync_obj;
+	bool inline_cb;
 	ktime_t workq_scheduled_ts;
 	struct work_struct cb_dispatch_work;
 	struct list_head list;
@@ -323,8 +323,29 @@ void cam_sync_util_cb_dispatch(struct work_struct *cb_dispatch_work)
 	kfree(cb_info);
 }
 
+void cam_sync_util_run_inline_cbs(struct list_head *inline_cbs)
+{
+	struct sync_callback_info *sync_cb, *temp_sync_cb;
+
+	list_for_each_entry_safe(sync_cb, temp_sync_cb, inline_cbs, list) {
+		list_del_init(&sync_cb->list);
+
+		/* Kernel callbacks may sleep, never run them from interrupts */
+		if (in_interrupt()) {
+			sync_cb->workq_scheduled_ts = ktime_get();
+			queue_work(sync_dev->work_queue,
+				&sync_cb->cb_dispatch_work);
+			continue;
+		}
+
+		sync_cb->callback_func(sync_cb->sync_obj, sync_cb->status,
+			sync_cb->cb_data);
+		kfree(sync_cb);
+	}
+}
+
 void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
-	uint32_t status, uint32_t event_cause)
+	uint32_t status, uint32_t event_cause, struct list_head *inline_cbs)
 {
 	struct sync_callback_info  *sync_cb;
 	struct sync_user_payload   *payload_info;
@@ -344,6 +365,11 @@ void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
 	list_for_each_entry_safe(sync_cb,
 		temp_sync_cb, &signalable_row->callback_list, list) {
 		sync_cb->status = status;
+		if (sync_cb->inline_cb && inline_cbs) {
+			list_move_tail(&sync_cb->list, inline_cbs);
+			continue;
+		}
+
 		list_del_init(&sync_cb->list);
 		queue_work(sync_dev->work_queue,
 			&sync_cb->cb_dispatch_work);
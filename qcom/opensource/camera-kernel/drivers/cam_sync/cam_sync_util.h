@@ -103,11 +103,26 @@ void cam_sync_util_cb_dispatch(struct work_struct *cb_dispatch_work);
  * @sync_obj    : Sync object that is signaled
  * @status      : Status of the signaled object
  * @evt_param   : Event paramaeter
+ * @inline_cbs  : List to collect inline callbacks on, to be run with
+ *                cam_sync_util_run_inline_cbs() once the row lock is
+ *                dropped. If NULL all callbacks go to the workqueue.
  *
  * @return None
  */
 void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
-	uint32_t status, uint32_t evt_param);
+	uint32_t status, uint32_t evt_param, struct list_head *inline_cbs);
+
+/**
+ * @brief: Function to run inline callbacks collected while signaling
+ *
+ * Must be called without any row lock held. Callbacks are bounced to the
+ * workqueue if the caller is in interrupt context.
+ *
+ * @inline_cbs  : List of callbacks filled by the dispatch
+ *
+ * @return None
+ */
+void cam_sync_util_run_inline_cbs(struct list_head *inline_cbs);
 
 /**
  * @brief: Function to send V4L event to user space
@@ -10,6 +10,7 @@
 #include <linux/completion.h>
 #include <linux/module.h>
 #include <linux/iopoll.h>
+#include <linux/math64.h>
 #include <linux/moduleparam.h>
 #include "cam_common_util.h"
 #include "cam_debug_util.h"
@@ -66,6 +67,81 @@ uint32_t cam_common_util_remove_duplicate_arr(int32_t *arr, uint32_t num)
 	return wr_idx;
 }
 
+int cam_common_util_get_clk_rate_idx(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate)
+{
+	int i;
+
+	for (i = 0; i < num_rates; i++)
+		if (clk_rate[i] >= rate)
+			return i;
+
+	return i;
+}
+
+uint32_t cam_common_util_get_actual_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate)
+{
+	int i;
+
+	i = cam_common_util_get_clk_rate_idx(clk_rate, num_rates, rate);
+	if (i < num_rates)
+		return clk_rate[i];
+
+	return rate;
+}
+
+uint32_t cam_common_util_get_lower_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate)
+{
+	int i;
+
+	i = cam_common_util_get_clk_rate_idx(clk_rate, num_rates, rate);
+
+	while (i > 0) {
+		if (clk_rate[i - 1])
+			return clk_rate[i - 1];
+		i--;
+	}
+
+	CAM_DBG(CAM_UTIL, "Already clk at lower level");
+
+	return rate;
+}
+
+uint32_t cam_common_util_get_next_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate)
+{
+	int i;
+
+	i = cam_common_util_get_clk_rate_idx(clk_rate, num_rates, rate);
+
+	while (i < (int)num_rates - 1) {
+		if (clk_rate[i + 1])
+			return clk_rate[i + 1];
+		i++;
+	}
+
+	CAM_DBG(CAM_UTIL, "Already clk at higher level");
+
+	return rate;
+}
+
+uint32_t cam_common_util_calc_base_clk(uint32_t frame_cycles,
+	uint64_t budget)
+{
+	uint64_t mul = 1000000000;
+	uint64_t base_clk = frame_cycles * mul;
+
+	do_div(base_clk, budget);
+
+	CAM_DBG(CAM_UTIL, "budget = %lld fc = %d ib = %lld base_clk = %lld",
+		budget, frame_cycles,
+		(long long)(frame_cycles * mul), base_clk);
+
+	return base_clk;
+}
+
 unsigned long cam_common_wait_for_completion_timeout(
 	struct completion   *complete,
 	unsigned long        timeout_jiffies)
@@ -220,6 +220,81 @@ int cam_common_util_get_string_index(const char **strings,
 uint32_t cam_common_util_remove_duplicate_arr(int32_t *array,
 	uint32_t num);
 
+/**
+ * cam_common_util_get_clk_rate_idx()
+ *
+ * @brief                  Find the lowest level of a clock table which is
+ *                         at least the requested rate
+ *
+ * @clk_rate:              Clock rates indexed by level
+ * @num_rates:             Number of levels in 'clk_rate'
+ * @rate:                  Requested clock rate
+ *
+ * @return:                Matching level, 'num_rates' if the rate is above
+ *                         every level. Caller has to bound check it.
+ */
+int cam_common_util_get_clk_rate_idx(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate);
+
+/**
+ * cam_common_util_get_actual_clk_rate()
+ *
+ * @brief                  Round a clock rate up to a level of the table
+ *
+ * @clk_rate:              Clock rates indexed by level
+ * @num_rates:             Number of levels in 'clk_rate'
+ * @rate:                  Requested clock rate
+ *
+ * @return:                Rate of the matching level, 'rate' if the rate
+ *                         is above every level
+ */
+uint32_t cam_common_util_get_actual_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate);
+
+/**
+ * cam_common_util_get_lower_clk_rate()
+ *
+ * @brief                  Get the rate of the level below a clock rate
+ *
+ * @clk_rate:              Clock rates indexed by level
+ * @num_rates:             Number of levels in 'clk_rate'
+ * @rate:                  Current clock rate
+ *
+ * @return:                Rate of the lower level, 'rate' if already at
+ *                         the lowest level
+ */
+uint32_t cam_common_util_get_lower_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate);
+
+/**
+ * cam_common_util_get_next_clk_rate()
+ *
+ * @brief                  Get the rate of the level above a clock rate
+ *
+ * @clk_rate:              Clock rates indexed by level
+ * @num_rates:             Number of levels in 'clk_rate'
+ * @rate:                  Current clock rate
+ *
+ * @return:                Rate of the next level, 'rate' if already at
+ *                         the highest level
+ */
+uint32_t cam_common_util_get_next_clk_rate(const int32_t *clk_rate,
+	uint32_t num_rates, uint32_t rate);
+
+/**
+ * cam_common_util_calc_base_clk()
+ *
+ * @brief                  Predict the clock rate which processes a frame
+ *                         within its time budget
+ *
+ * @frame_cycles:          Clock cycles needed for the frame
+ * @budget:                Frame time budget in ns
+ *
+ * @return:                Clock rate in Hz
+ */
+uint32_t cam_common_util_calc_base_clk(uint32_t frame_cycles,
+	uint64_t budget);
+
 /**
  * cam_common_wait_for_completion_timeout()
  *
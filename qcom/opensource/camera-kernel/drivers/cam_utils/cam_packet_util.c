@@ -324,6 +324,7 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 	int        rc = 0;
 	uint32_t   flags = 0;
 	int32_t    hdl;
+	int32_t    dst_hdl = 0;
 	struct cam_patch_unique_src_buf_tbl
 		tbl[CAM_UNIQUE_SRC_HDL_MAX];
 
@@ -360,11 +361,18 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 
 		temp = iova_addr;
 
-		rc = cam_mem_get_cpu_buf(patch_desc[i].dst_buf_hdl,
-			&cpu_addr, &dst_buf_len);
-		if (rc < 0 || !cpu_addr || (dst_buf_len == 0)) {
-			CAM_ERR(CAM_UTIL, "unable to get dst buf address");
-			return rc;
+		/*
+		 * Patches are usually grouped by destination command buffer,
+		 * only look up the kernel mapping when the handle changes.
+		 */
+		if (!dst_hdl || (dst_hdl != patch_desc[i].dst_buf_hdl)) {
+			rc = cam_mem_get_cpu_buf(patch_desc[i].dst_buf_hdl,
+				&cpu_addr, &dst_buf_len);
+			if (rc < 0 || !cpu_addr || (dst_buf_len == 0)) {
+				CAM_ERR(CAM_UTIL, "unable to get dst buf address");
+				return rc;
+			}
+			dst_hdl = patch_desc[i].dst_buf_hdl;
 		}
 		dst_cpu_addr = (uint32_t *)cpu_addr;
 
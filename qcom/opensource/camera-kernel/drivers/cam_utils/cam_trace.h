@@ -214,6 +214,33 @@ TRACE_EVENT(cam_buf_done,
 	)
 );
 
+TRACE_EVENT(cam_req_latency,
+	TP_PROTO(struct cam_context *ctx, uint64_t req_id, uint32_t stage,
+		uint64_t delta_ns),
+	TP_ARGS(ctx, req_id, stage, delta_ns),
+	TP_STRUCT__entry(
+		__field(void*, ctx)
+		__field(uint32_t, ctx_id)
+		__field(int32_t, link_hdl)
+		__field(uint64_t, request)
+		__field(uint32_t, stage)
+		__field(uint64_t, delta_ns)
+	),
+	TP_fast_assign(
+		__entry->ctx = ctx;
+		__entry->ctx_id = ctx->ctx_id;
+		__entry->link_hdl = ctx->link_hdl;
+		__entry->request = req_id;
+		__entry->stage = stage;
+		__entry->delta_ns = delta_ns;
+	),
+	TP_printk(
+		"ReqLatency ctx=%p ctx_id=%u request=%llu link_hdl=0x%x stage=%u delta_ns=%llu",
+			__entry->ctx, __entry->ctx_id, __entry->request,
+			__entry->link_hdl, __entry->stage, __entry->delta_ns
+	)
+);
+
 TRACE_EVENT(cam_apply_req,
 	TP_PROTO(const char *entity, uint32_t id, uint64_t req_id,int32_t link_hdl),
 	TP_ARGS(entity, id, req_id, link_hdl),
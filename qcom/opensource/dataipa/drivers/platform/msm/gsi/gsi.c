@@ -13,6 +13,7 @@
 #include <linux/platform_device.h>
 #include <linux/delay.h>
 #include <linux/msi.h>
+#include <linux/prefetch.h>
 #include <linux/smp.h>
 #include "gsi.h"
 #include "gsi_emulation.h"
@@ -743,6 +744,16 @@ static void gsi_process_chan(struct gsi_xfer_compl_evt *evt,
 	}
 }
 
+static inline void gsi_prefetch_next_evt_re(struct gsi_evt_ctx *ctx)
+{
+	uint64_t next = ctx->ring.rp_local + ctx->ring.elem_sz;
+
+	if (next == ctx->ring.end)
+		next = ctx->ring.base;
+
+	prefetch((void *)(ctx->ring.base_va + next - ctx->ring.base));
+}
+
 static void gsi_process_evt_re(struct gsi_evt_ctx *ctx,
 		struct gsi_chan_xfer_notify *notify, bool callback)
 {
@@ -4475,8 +4486,16 @@ int gsi_poll_n_channel(unsigned long chan_hdl,
 	if (*actual_num > expected_num)
 		*actual_num = expected_num;
 
-	for (i = 0; i < *actual_num; i++)
+	for (i = 0; i < *actual_num; i++) {
+		/*
+		 * The event ring is written by the HW, so the next element
+		 * is a cache miss. Start fetching it while this one is
+		 * being processed.
+		 */
+		if (i + 1 < *actual_num)
+			gsi_prefetch_next_evt_re(ctx->evtr);
 		gsi_process_evt_re(ctx->evtr, notify + i, false);
+	}
 
 	spin_unlock_irqrestore(&ctx->evtr->ring.slock, flags);
 	ctx->stats.poll_ok++;
@@ -5755,6 +5774,41 @@ void gsi_update_almst_empty_thrshold(unsigned long chan_hdl, unsigned short thre
 }
 EXPORT_SYMBOL(gsi_update_almst_empty_thrshold);
 
+int gsi_update_evt_ring_int_mod(unsigned long evt_ring_hdl,
+	uint16_t int_modt, uint8_t int_modc)
+{
+	struct gsihal_reg_ev_ch_k_cntxt_8 ev_ch_k_cntxt_8;
+	struct gsi_evt_ctx *ctx;
+
+	if (!gsi_ctx) {
+		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
+		return -GSI_STATUS_NODEV;
+	}
+
+	if (evt_ring_hdl >= gsi_ctx->max_ev) {
+		GSIERR("bad params evt_ring_hdl=%lu\n", evt_ring_hdl);
+		return -GSI_STATUS_INVALID_PARAMS;
+	}
+
+	ctx = &gsi_ctx->evtr[evt_ring_hdl];
+
+	if (ctx->state != GSI_EVT_RING_STATE_ALLOCATED) {
+		GSIERR("bad state %d\n", ctx->state);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	ctx->props.int_modt = int_modt;
+	ctx->props.int_modc = int_modc;
+
+	ev_ch_k_cntxt_8.int_modt = int_modt;
+	ev_ch_k_cntxt_8.int_modc = int_modc;
+	gsihal_write_reg_nk_fields(GSI_EE_n_EV_CH_k_CNTXT_8,
+		gsi_ctx->per.ee, evt_ring_hdl, &ev_ch_k_cntxt_8);
+
+	return GSI_STATUS_SUCCESS;
+}
+EXPORT_SYMBOL(gsi_update_evt_ring_int_mod);
+
 static union __packed gsi_channel_scratch __gsi_update_mhi_channel_scratch(
 	unsigned long chan_hdl, struct __packed gsi_mhi_channel_scratch mscr)
 {
@@ -2496,6 +2496,21 @@ int gsi_query_device_msi_addr(u64 *addr);
 */
 void gsi_update_almst_empty_thrshold(unsigned long chan_hdl, unsigned short threshold);
 
+/**
+* gsi_update_evt_ring_int_mod - update interrupt moderation of an event ring
+*
+* @evt_ring_hdl: Client handle previously obtained from gsi_alloc_evt_ring
+* @int_modt: cycles base interrupt moderation (32KHz clock)
+* @int_modc: interrupt moderation packet counter
+*
+* Only the moderation context register is rewritten, the event ring is not
+* reset. Does not sleep so it can be called from the NAPI poll.
+*
+* @Return gsi_status
+*/
+int gsi_update_evt_ring_int_mod(unsigned long evt_ring_hdl,
+	uint16_t int_modt, uint8_t int_modc);
+
 /**
 * gsi_dump_ch_info - channel information.
 *
@@ -5886,6 +5886,8 @@ int _ipa_init_rt4_v3(void)
 	int i;
 	int rc = 0;
 
+	ipa3_fltrt_img_invalidate(&ipa3_ctx->rt_img_cache[IPA_IP_v4]);
+
 	for (i = IPA_MEM_PART(v4_modem_rt_index_lo);
 		i <= IPA_MEM_PART(v4_modem_rt_index_hi);
 		i++)
@@ -5960,6 +5962,8 @@ int _ipa_init_rt6_v3(void)
 	int i;
 	int rc = 0;
 
+	ipa3_fltrt_img_invalidate(&ipa3_ctx->rt_img_cache[IPA_IP_v6]);
+
 	for (i = IPA_MEM_PART(v6_modem_rt_index_lo);
 		i <= IPA_MEM_PART(v6_modem_rt_index_hi);
 		i++)
@@ -6033,6 +6037,8 @@ int _ipa_init_flt4_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	ipa3_fltrt_img_invalidate(&ipa3_ctx->flt_img_cache[IPA_IP_v4]);
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v4_flt_hash_size),
 		IPA_MEM_PART(v4_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -6101,6 +6107,8 @@ int _ipa_init_flt6_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	ipa3_fltrt_img_invalidate(&ipa3_ctx->flt_img_cache[IPA_IP_v6]);
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v6_flt_hash_size),
 		IPA_MEM_PART(v6_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -9480,6 +9488,9 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	/* Enable ipa3_ctx->enable_napi_chain */
 	ipa3_ctx->enable_napi_chain = 1;
 
+	/* Enable ipa3_ctx->tx_db_batch */
+	ipa3_ctx->tx_db_batch = 1;
+
 	/* Initialize Page poll threshold. */
 	ipa3_ctx->page_poll_threshold = IPA_PAGE_POLL_DEFAULT_THRESHOLD;
 
@@ -1561,7 +1561,10 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		"num_buff_below_thresh_for_ll_pipe_notified=%u\n"
 		"num_free_page_task_scheduled=%u\n"
 		"pipe_setup_fail_cnt=%u\n"
-		"ttl_count=%u\n",
+		"ttl_count=%u\n"
+		"tx_db_deferred=%u\n"
+		"tx_db_timer_flush=%u\n"
+		"rmnet_ll_busy_poll=%u\n",
 		ipa3_ctx->stats.tx_sw_pkts,
 		ipa3_ctx->stats.tx_hw_pkts,
 		ipa3_ctx->stats.tx_non_linear,
@@ -1592,7 +1595,10 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		atomic_read(&ipa3_ctx->stats.num_buff_below_thresh_for_ll_pipe_notified),
 		atomic_read(&ipa3_ctx->stats.num_free_page_task_scheduled),
 		ipa3_ctx->stats.pipe_setup_fail_cnt,
-		ipa3_ctx->stats.ttl_cnt
+		ipa3_ctx->stats.ttl_cnt,
+		ipa3_ctx->stats.tx_db_deferred,
+		ipa3_ctx->stats.tx_db_timer_flush,
+		ipa3_ctx->stats.rmnet_ll_busy_poll
 		);
 	cnt += nbytes;
 
@@ -1623,11 +1629,15 @@ static ssize_t ipa3_read_odlstats(struct file *file, char __user *ubuf,
 			"ODL received pkt =%u\n"
 			"ODL processed pkt to DIAG=%u\n"
 			"ODL dropped pkt =%u\n"
-			"ODL packet in queue  =%u\n",
+			"ODL packet in queue  =%u\n"
+			"ODL pkt to mmap ring =%u\n"
+			"ODL mmap ring dropped pkt =%u\n",
 			ipa3_odl_ctx->stats.odl_rx_pkt,
 			ipa3_odl_ctx->stats.odl_tx_diag_pkt,
 			ipa3_odl_ctx->stats.odl_drop_pkt,
-			atomic_read(&ipa3_odl_ctx->stats.numer_in_queue));
+			atomic_read(&ipa3_odl_ctx->stats.numer_in_queue),
+			ipa3_odl_ctx->stats.odl_mmap_pkt,
+			ipa3_odl_ctx->stats.odl_mmap_drop_pkt);
 
 	cnt += nbytes;
 
@@ -1647,11 +1657,13 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		"COAL   : Number of page recycled packets  =%llu\n"
 		"COAL   : Number of tmp alloc packets  =%llu\n"
 		"COAL   : Number of times tasklet scheduled  =%llu\n"
+		"COAL   : Number of busy pages rotated  =%llu\n"
 
 		"DEF    : Total number of packets replenished =%llu\n"
 		"DEF    : Number of page recycled packets =%llu\n"
 		"DEF    : Number of tmp alloc packets  =%llu\n"
 		"DEF    : Number of times tasklet scheduled  =%llu\n"
+		"DEF    : Number of busy pages rotated  =%llu\n"
 
 		"COMMON : Number of page recycled in tasklet  =%llu\n"
 		"COMMON : Number of times free pages not found in tasklet =%llu\n",
@@ -1660,11 +1672,13 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[0],
+		ipa3_ctx->stats.page_recycle_stats[0].busy_rotated,
 
 		ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
 		ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[1],
+		ipa3_ctx->stats.page_recycle_stats[1].busy_rotated,
 
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
 		ipa3_ctx->stats.num_of_times_wq_reschd);
@@ -1684,6 +1698,53 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static ssize_t ipa3_read_fltrt_commit_stats(struct file *file,
+		char __user *ubuf, size_t count, loff_t *ppos)
+{
+	int nbytes;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"RT  v4: full commits=%u skipped=%u\n"
+		"RT  v6: full commits=%u skipped=%u\n"
+		"FLT v4: full commits=%u skipped=%u\n"
+		"FLT v6: full commits=%u skipped=%u\n",
+		ipa3_ctx->rt_img_cache[IPA_IP_v4].num_commit,
+		ipa3_ctx->rt_img_cache[IPA_IP_v4].num_skip,
+		ipa3_ctx->rt_img_cache[IPA_IP_v6].num_commit,
+		ipa3_ctx->rt_img_cache[IPA_IP_v6].num_skip,
+		ipa3_ctx->flt_img_cache[IPA_IP_v4].num_commit,
+		ipa3_ctx->flt_img_cache[IPA_IP_v4].num_skip,
+		ipa3_ctx->flt_img_cache[IPA_IP_v6].num_commit,
+		ipa3_ctx->flt_img_cache[IPA_IP_v6].num_skip);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
+static ssize_t ipa3_read_rx_cpu_stats(struct file *file,
+		char __user *ubuf, size_t count, loff_t *ppos)
+{
+	struct ipa3_rx_cpu_stats *stats;
+	int nbytes;
+	int cnt = 0;
+	int cpu;
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"CPU  COAL polls/frames  DEF polls/frames  LL polls/frames\n");
+	cnt += nbytes;
+
+	for_each_possible_cpu(cpu) {
+		stats = ipa3_get_rx_cpu_stats(cpu);
+		nbytes = scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+			"%-4d %llu/%llu  %llu/%llu  %llu/%llu\n", cpu,
+			stats->napi_polls[0], stats->frames[0],
+			stats->napi_polls[1], stats->frames[1],
+			stats->napi_polls[2], stats->frames[2]);
+		cnt += nbytes;
+	}
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
 static ssize_t ipa3_read_lan_coal_stats(
 	struct file *file,
 	char __user *ubuf,
@@ -2982,6 +3043,16 @@ done:
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static ssize_t ipa3_read_mhip_db_mod(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	int cnt;
+
+	cnt = ipa_mpm_db_mod_stats(dbg_buff, IPA_MAX_MSG_LEN);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
 static ssize_t ipa3_read_usb_gsi_stats(struct file *file,
 	char __user *ubuf, size_t count, loff_t *ppos)
 {
@@ -3811,6 +3882,14 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"page_recycle_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_page_recycle_stats,
 		}
+	}, {
+		"rx_cpu_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_rx_cpu_stats,
+		}
+	}, {
+		"fltrt_commit_stats", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_fltrt_commit_stats,
+		}
 	}, {
 		"lan_coal_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_lan_coal_stats,
@@ -3884,6 +3963,10 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"mhip_gsi_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_mhip_gsi_stats,
 		}
+	}, {
+		"mhip_db_mod", IPA_READ_ONLY_MODE, NULL, {
+			.read = ipa3_read_mhip_db_mod,
+		}
 	}, {
 		"usb_gsi_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_read_usb_gsi_stats,
@@ -3965,6 +4048,24 @@ void ipa3_debugfs_init(void)
 	debugfs_create_u32("enable_napi_chain", IPA_READ_WRITE_MODE,
 		dent, &ipa3_ctx->enable_napi_chain);
 
+	debugfs_create_u32("rx_adaptive_int_mod", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->rx_adaptive_int_mod);
+
+	debugfs_create_u32("mpm_adaptive_db_mod", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->mpm_adaptive_db_mod);
+
+	debugfs_create_u32("mpm_burst_mode", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->mpm_burst_mode);
+
+	debugfs_create_u32("tx_db_batch", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->tx_db_batch);
+
+	debugfs_create_u32("pm_predictive_scaling", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->pm_predictive_scaling);
+
+	debugfs_create_u32("rmnet_ll_busy_poll", IPA_READ_WRITE_MODE,
+		dent, &ipa3_ctx->rmnet_ll_busy_poll);
+
 	debugfs_create_u32("clock_scaling_bw_threshold_nominal_mbps",
 		IPA_READ_WRITE_MODE, dent,
 		&ipa3_ctx->ctrl->clock_scaling_bw_threshold_nominal);
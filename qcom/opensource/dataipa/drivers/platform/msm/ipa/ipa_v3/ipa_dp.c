@@ -19,6 +19,7 @@
 #include <linux/msm_gsi.h>
 #include <net/sock.h>
 #include <net/ipv6.h>
+#include <net/busy_poll.h>
 #include <asm/page.h>
 #include <linux/mutex.h>
 #include "gsi.h"
@@ -82,6 +83,36 @@
 #define IPA_GSI_EVT_RING_INT_MODT (16) /* 0.5ms under 32KHz clock */
 #define IPA_GSI_EVT_RING_INT_MODC (20)
 
+#define IPA_RX_INT_MOD_WINDOW_MS (20)
+
+/**
+ * struct ipa3_rx_int_mod_level - one step of the adaptive RX moderation
+ * @min_rate: packets per msec from which this level is selected
+ * @modt: GSI interrupt moderation timer (32KHz cycles)
+ * @modc: GSI interrupt moderation counter
+ */
+struct ipa3_rx_int_mod_level {
+	u32 min_rate;
+	u16 modt;
+	u8 modc;
+};
+
+static DEFINE_PER_CPU(struct ipa3_rx_cpu_stats, ipa3_rx_cpu_stats);
+
+static const struct ipa3_rx_int_mod_level ipa3_rx_int_mod_levels[] = {
+	{ .min_rate = 0, .modt = 0, .modc = 1 },
+	{ .min_rate = 20, .modt = 8, .modc = 8 },
+	{ .min_rate = 100, .modt = 16, .modc = 20 },
+	{ .min_rate = 250, .modt = 32, .modc = 48 },
+};
+
+/* Low latency pipes never hold an interrupt for more than 0.25ms */
+static const struct ipa3_rx_int_mod_level ipa3_rx_ll_int_mod_levels[] = {
+	{ .min_rate = 0, .modt = 0, .modc = 1 },
+	{ .min_rate = 50, .modt = 4, .modc = 4 },
+	{ .min_rate = 200, .modt = 8, .modc = 8 },
+};
+
 #define IPA_GSI_CH_20_WA_NUM_CH_TO_ALLOC 10
 /* The below virtual channel cannot be used by any entity */
 #define IPA_GSI_CH_20_WA_VIRT_CHAN 29
@@ -94,6 +125,10 @@
 
 #define IPA_TX_SEND_COMPL_NOP_DELAY_NS (2 * 1000 * 1000)
 
+#define IPA_TX_DB_BATCH_PKTS (8)
+#define IPA_TX_DB_BATCH_BYTES (32 * 1024)
+#define IPA_TX_DB_FLUSH_DELAY_NS (50 * 1000)
+
 #define IPA_APPS_BW_FOR_PM 700
 
 #define IPA_SEND_MAX_DESC (20)
@@ -314,11 +349,15 @@ static void ipa3_collect_low_lat_data_recycle_stats_wq(struct work_struct *work)
  * @tx_pkt: the first tx_pkt_warpper related to a certain skb
  * @sys:points to the ipa3_sys_context the EOT was received on
  * returns the number of tx_pkt_wrappers that were freed
+ *
+ * The wrappers are unlinked, and later recycled, as one batch so the
+ * sys spinlock is taken twice per skb rather than twice per descriptor.
  */
 static int ipa3_write_done_common(struct ipa3_sys_context *sys,
 				struct ipa3_tx_pkt_wrapper *tx_pkt)
 {
 	struct ipa3_tx_pkt_wrapper *next_pkt;
+	LIST_HEAD(done_list);
 	int i, cnt;
 	void *user1;
 	int user2;
@@ -330,16 +369,21 @@ static int ipa3_write_done_common(struct ipa3_sys_context *sys,
 	}
 
 	cnt = tx_pkt->cnt;
+	spin_lock_bh(&sys->spinlock);
 	for (i = 0; i < cnt; i++) {
-		spin_lock_bh(&sys->spinlock);
 		if (unlikely(list_empty(&sys->head_desc_list))) {
-			spin_unlock_bh(&sys->spinlock);
 			IPAERR_RL("list is empty missing descriptors");
-			return i;
+			break;
 		}
 		next_pkt = list_next_entry(tx_pkt, link);
-		list_del(&tx_pkt->link);
+		list_move_tail(&tx_pkt->link, &done_list);
 		sys->len--;
+		tx_pkt = next_pkt;
+	}
+	spin_unlock_bh(&sys->spinlock);
+
+	/* descriptors are unmapped and completed in submission order */
+	list_for_each_entry(tx_pkt, &done_list, link) {
 		if (!tx_pkt->no_unmap_dma) {
 			if (tx_pkt->type != IPA_DATA_DESC_SKB_PAGED) {
 				dma_unmap_single(ipa3_ctx->pdev,
@@ -356,21 +400,27 @@ static int ipa3_write_done_common(struct ipa3_sys_context *sys,
 		callback = tx_pkt->callback;
 		user1 = tx_pkt->user1;
 		user2 = tx_pkt->user2;
-		if (sys->avail_tx_wrapper >=
-			ipa3_ctx->tx_wrapper_cache_max_size ||
-			sys->ep->client == IPA_CLIENT_APPS_CMD_PROD) {
-			kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache,
-				tx_pkt);
-		} else {
-			list_add_tail(&tx_pkt->link,
+		if (callback)
+			(*callback)(user1, user2);
+	}
+
+	/* refill the wrapper cache first, whatever does not fit is freed */
+	if (sys->ep->client != IPA_CLIENT_APPS_CMD_PROD) {
+		spin_lock_bh(&sys->spinlock);
+		list_for_each_entry_safe(tx_pkt, next_pkt, &done_list, link) {
+			if (sys->avail_tx_wrapper >=
+				ipa3_ctx->tx_wrapper_cache_max_size)
+				break;
+			list_move_tail(&tx_pkt->link,
 				&sys->avail_tx_wrapper_list);
 			sys->avail_tx_wrapper++;
 		}
 		spin_unlock_bh(&sys->spinlock);
-		if (callback)
-			(*callback)(user1, user2);
-		tx_pkt = next_pkt;
 	}
+
+	list_for_each_entry_safe(tx_pkt, next_pkt, &done_list, link)
+		kmem_cache_free(ipa3_ctx->tx_pkt_wrapper_cache, tx_pkt);
+
 	return i;
 }
 
@@ -592,12 +642,31 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 }
 
 
+static enum hrtimer_restart ipa3_db_flush_timer_fn(struct hrtimer *param)
+{
+	struct ipa3_sys_context *sys = container_of(param,
+		struct ipa3_sys_context, db_flush_timer);
+
+	spin_lock(&sys->spinlock);
+	if (sys->db_pend_pkts) {
+		/* ring the doorbell for the xfers queued so far */
+		if (!gsi_queue_xfer(sys->ep->gsi_chan_hdl, 0, NULL, true))
+			IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_db_timer_flush);
+		sys->db_pend_pkts = 0;
+		sys->db_pend_bytes = 0;
+	}
+	spin_unlock(&sys->spinlock);
+
+	return HRTIMER_NORESTART;
+}
+
 /**
- * ipa3_send() - Send multiple descriptors in one HW transaction
+ * __ipa3_send() - Send multiple descriptors in one HW transaction
  * @sys: system pipe context
  * @num_desc: number of packets
  * @desc: packets to send (may be immediate command or data)
  * @in_atomic:  whether caller is in atomic context
+ * @defer_db: more packets follow, the doorbell may be rung later
  *
  * This function is used for GPI connection.
  * - ipa3_tx_pkt_wrapper will be used for each ipa
@@ -609,10 +678,11 @@ static void ipa3_send_nop_desc(struct work_struct *work)
  *
  * Return codes: 0: success, -EFAULT: failure
  */
-int ipa3_send(struct ipa3_sys_context *sys,
+static int __ipa3_send(struct ipa3_sys_context *sys,
 		u32 num_desc,
 		struct ipa3_desc *desc,
-		bool in_atomic)
+		bool in_atomic,
+		bool defer_db)
 {
 	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
 	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
@@ -624,6 +694,8 @@ int ipa3_send(struct ipa3_sys_context *sys,
 	u32 mem_flag = GFP_ATOMIC;
 	const struct ipa_gsi_ep_config *gsi_ep_cfg;
 	bool send_nop = false;
+	bool ring_db = true;
+	u32 bytes = 0;
 	unsigned int max_desc;
 
 	if (unlikely(!in_atomic))
@@ -761,6 +833,7 @@ int ipa3_send(struct ipa3_sys_context *sys,
 			gsi_xfer[i].len = desc[i].len;
 			gsi_xfer[i].type =
 				GSI_XFER_ELEM_DATA;
+			bytes += desc[i].len;
 		}
 
 		if (i == (num_desc - 1)) {
@@ -784,15 +857,35 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		}
 	}
 
+	/*
+	 * When the caller has more packets lined up, leave the doorbell to
+	 * the last one or to the packet/byte threshold, whichever comes
+	 * first. The flush timer rings it if nothing else follows.
+	 */
+	if (defer_db && ipa3_ctx->tx_db_batch)
+		ring_db = sys->db_pend_pkts + 1 >= IPA_TX_DB_BATCH_PKTS ||
+			sys->db_pend_bytes + bytes >= IPA_TX_DB_BATCH_BYTES;
+
 	IPADBG_LOW("ch:%lu queue xfer\n", sys->ep->gsi_chan_hdl);
 	result = gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_desc,
-			gsi_xfer, true);
+			gsi_xfer, ring_db);
 	if (result != GSI_STATUS_SUCCESS) {
 		IPAERR_RL("GSI xfer failed.\n");
 		result = -EFAULT;
 		goto failure;
 	}
 
+	if (ring_db) {
+		if (sys->db_pend_pkts)
+			hrtimer_try_to_cancel(&sys->db_flush_timer);
+		sys->db_pend_pkts = 0;
+		sys->db_pend_bytes = 0;
+	} else {
+		sys->db_pend_pkts++;
+		sys->db_pend_bytes += bytes;
+		IPA_STATS_INC_CNT(ipa3_ctx->stats.tx_db_deferred);
+	}
+
 	if (send_nop && !sys->nop_pending)
 		sys->nop_pending = true;
 	else
@@ -810,6 +903,11 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		hrtimer_start(&sys->db_timer, time, HRTIMER_MODE_REL);
 	}
 
+	if (!ring_db && !hrtimer_active(&sys->db_flush_timer))
+		hrtimer_start(&sys->db_flush_timer,
+			ns_to_ktime(IPA_TX_DB_FLUSH_DELAY_NS),
+			HRTIMER_MODE_REL_SOFT);
+
 	/* make sure TAG process is sent before clocks are gated */
 	ipa3_ctx->tag_process_before_gating = true;
 
@@ -846,6 +944,25 @@ failure:
 	return result;
 }
 
+/**
+ * ipa3_send() - Send multiple descriptors in one HW transaction
+ * @sys: system pipe context
+ * @num_desc: number of packets
+ * @desc: packets to send (may be immediate command or data)
+ * @in_atomic:  whether caller is in atomic context
+ *
+ * Same as __ipa3_send() with the doorbell rung for this transaction.
+ *
+ * Return codes: 0: success, -EFAULT: failure
+ */
+int ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool in_atomic)
+{
+	return __ipa3_send(sys, num_desc, desc, in_atomic, false);
+}
+
 /**
  * ipa3_send_one() - Send a single descriptor
  * @sys:	system pipe context
@@ -1536,6 +1653,9 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 		hrtimer_init(&ep->sys->db_timer, CLOCK_MONOTONIC,
 			HRTIMER_MODE_REL);
 		ep->sys->db_timer.function = ipa3_ring_doorbell_timer_fn;
+		hrtimer_init(&ep->sys->db_flush_timer, CLOCK_MONOTONIC,
+			HRTIMER_MODE_REL_SOFT);
+		ep->sys->db_flush_timer.function = ipa3_db_flush_timer_fn;
 
 		/* create IPA PM resources for handling polling mode */
 		if (sys_in->client == IPA_CLIENT_APPS_WAN_CONS &&
@@ -2024,6 +2144,8 @@ int ipa3_teardown_sys_pipe(u32 clnt_hdl)
 
 	if (IPA_CLIENT_IS_CONS(ep->client))
 		cancel_delayed_work_sync(&ep->sys->replenish_rx_work);
+	else
+		hrtimer_cancel(&ep->sys->db_flush_timer);
 	flush_workqueue(ep->sys->wq);
 	if (IPA_CLIENT_IS_PROD(ep->client))
 		atomic_set(&ep->sys->workqueue_flushed, 1);
@@ -2291,6 +2413,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 	const struct ipa_gsi_ep_config *gsi_ep;
 	int data_idx;
 	unsigned int max_desc;
+	/* only meaningful when called from ndo_start_xmit */
+	bool xmit_more = skb->dev && netdev_xmit_more();
 
 	if (unlikely(!ipa3_ctx)) {
 		IPAERR("IPA3 driver was not initialized\n");
@@ -2454,7 +2578,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[skb_idx].callback = NULL;
 		}
 
-		if (ipa3_send(sys, num_frags + data_idx, desc, true)) {
+		if (__ipa3_send(sys, num_frags + data_idx, desc, true,
+			xmit_more)) {
 			IPAERR_RL("fail to send skb %pK num_frags %u SWP\n",
 				skb, num_frags);
 			goto fail_send;
@@ -2485,7 +2610,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx].dma_address = meta->dma_address;
 		}
 		if (num_frags == 0) {
-			if (ipa3_send(sys, data_idx + 1, desc, true)) {
+			if (__ipa3_send(sys, data_idx + 1, desc, true,
+				xmit_more)) {
 				IPAERR_RL("fail to send skb %pK HWP\n", skb);
 				goto fail_mem;
 			}
@@ -2504,8 +2630,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx+f].user2 = desc[data_idx].user2;
 			desc[data_idx].callback = NULL;
 
-			if (ipa3_send(sys, num_frags + data_idx + 1,
-				desc, true)) {
+			if (__ipa3_send(sys, num_frags + data_idx + 1,
+				desc, true, xmit_more)) {
 				IPAERR_RL("fail to send skb %pK num_frags %u\n",
 					skb, num_frags);
 				goto fail_mem;
@@ -2796,9 +2922,11 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
 	struct ipa3_rx_pkt_wrapper *tmp = NULL;
 	struct page *cur_page;
+	struct list_head busy_head;
 	int i = 0;
 	u8 LOOP_THRESHOLD = ipa3_ctx->page_poll_threshold;
 
+	INIT_LIST_HEAD(&busy_head);
 	spin_lock_bh(&sys->common_sys->spinlock);
 	list_for_each_entry_safe(rx_pkt, tmp,
 		&sys->page_recycle_repl->page_repl_head, link) {
@@ -2811,11 +2939,20 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 			list_del_init(&rx_pkt->link);
 			++ipa3_ctx->stats.page_recycle_cnt[stats_i][i];
 			sys->common_sys->napi_sort_page_thrshld_cnt = 0;
+			list_splice_tail(&busy_head,
+				&sys->page_recycle_repl->page_repl_head);
 			spin_unlock_bh(&sys->common_sys->spinlock);
 			return rx_pkt;
 		}
+		/*
+		 * Pages still held by the stack are moved to the tail so the
+		 * next lookup starts with pages that had more time to be freed.
+		 */
+		list_move_tail(&rx_pkt->link, &busy_head);
+		ipa3_ctx->stats.page_recycle_stats[stats_i].busy_rotated++;
 		i++;
 	}
+	list_splice_tail(&busy_head, &sys->page_recycle_repl->page_repl_head);
 	spin_unlock_bh(&sys->common_sys->spinlock);
 	IPADBG_LOW("napi_sort_page_thrshld_cnt = %d ipa_max_napi_sort_page_thrshld = %d\n",
 			sys->common_sys->napi_sort_page_thrshld_cnt,
@@ -3745,13 +3882,22 @@ static void ipa3_cleanup_rx(struct ipa3_sys_context *sys)
 	}
 }
 
-static struct sk_buff *ipa3_skb_copy_for_client(struct sk_buff *skb, int len)
+static struct sk_buff *ipa3_skb_copy_for_client(struct ipa3_sys_context *sys,
+	struct sk_buff *skb, int len)
 {
 	struct sk_buff *skb2 = NULL;
 
 	if (!ipa3_ctx->lan_rx_napi_enable)
 		skb2 = __dev_alloc_skb(len + IPA_RX_BUFF_CLIENT_HEADROOM,
 					GFP_KERNEL);
+	else if (sys->napi_obj && in_softirq())
+		/*
+		 * Exception packets are copied out one by one while the NAPI
+		 * poll runs; take them from the per-CPU NAPI frag cache
+		 * instead of a kmalloc backed head per packet.
+		 */
+		skb2 = napi_alloc_skb(sys->napi_obj,
+					len + IPA_RX_BUFF_CLIENT_HEADROOM);
 	else
 		skb2 = __dev_alloc_skb(len + IPA_RX_BUFF_CLIENT_HEADROOM,
 					GFP_ATOMIC);
@@ -3998,7 +4144,7 @@ begin:
 				sys->drop_packet = true;
 			}
 
-			skb2 = ipa3_skb_copy_for_client(skb,
+			skb2 = ipa3_skb_copy_for_client(sys, skb,
 				min(status.pkt_len + pkt_status_sz, skb->len));
 			if (likely(skb2)) {
 				if (skb->len < len + pkt_status_sz) {
@@ -5441,6 +5587,14 @@ static void ipa3_rx_napi_chain(struct ipa3_sys_context *sys,
 
 			/* this is always true for EOTs */
 			if (rx_skb) {
+				/*
+				 * Tag low latency frames with their NAPI so a
+				 * busy polling socket can drive this channel.
+				 */
+				if (sys->ep->client ==
+					IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS)
+					skb_mark_napi_id(rx_skb, &sys->napi_rx);
+
 				if (!first_skb)
 					first_skb = rx_skb;
 
@@ -6414,7 +6568,11 @@ static void ipa_gsi_irq_rx_notify_cb(struct gsi_chan_xfer_notify *notify)
 	case GSI_CHAN_EVT_EOT:
 	case GSI_CHAN_EVT_EOB:
 		atomic_set(&ipa3_ctx->transport_pm.eot_activity, 1);
-		if (!atomic_read(&sys->curr_polling_state)) {
+		/*
+		 * Claim the polling state atomically, a socket busy polling
+		 * the low latency channel may be racing with this interrupt.
+		 */
+		if (!atomic_cmpxchg(&sys->curr_polling_state, 0, 1)) {
 			/* put the gsi channel into polling mode */
 			gsi_config_channel_mode(sys->ep->gsi_chan_hdl,
 				GSI_CHAN_MODE_POLL);
@@ -6715,6 +6873,13 @@ static int ipa_gsi_setup_event_ring(struct ipa3_ep_context *ep,
 		ep->client,
 		gsi_evt_ring_props.int_modt,
 		gsi_evt_ring_props.int_modc);
+	if (ep->sys) {
+		ep->sys->int_mod.def_modt = gsi_evt_ring_props.int_modt;
+		ep->sys->int_mod.def_modc = gsi_evt_ring_props.int_modc;
+		ep->sys->int_mod.level = -1;
+		ep->sys->int_mod.win_start = jiffies;
+		ep->sys->int_mod.win_pkts = 0;
+	}
 	if (ipa3_ctx->ipa_gpi_event_rp_ddr) {
 		gsi_evt_ring_props.rp_update_vaddr =
 			dma_alloc_coherent(ipa3_ctx->pdev,
@@ -7091,6 +7256,90 @@ start_poll:
 	return cnt;
 }
 
+/**
+ * ipa3_get_rx_cpu_stats() - Get the WAN RX NAPI stats of a CPU
+ * @cpu: CPU to get the stats for
+ *
+ * Return: pointer to the per CPU stats
+ */
+struct ipa3_rx_cpu_stats *ipa3_get_rx_cpu_stats(int cpu)
+{
+	return per_cpu_ptr(&ipa3_rx_cpu_stats, cpu);
+}
+
+/**
+ * ipa3_rx_adapt_int_mod() - Tune the event ring moderation to the RX rate
+ * @sys: RX pipe that was just polled
+ * @cnt: number of packets handled by the poll
+ *
+ * The polled packets are accumulated over a short window. At the end of the
+ * window the packet rate selects a moderation level: a higher rate holds the
+ * interrupt longer so each NAPI poll finds a full batch, a lower rate
+ * interrupts on every event to keep the latency down. Moving to a lower level
+ * requires the rate to drop a quarter below the current level to avoid
+ * bouncing between two levels.
+ */
+static void ipa3_rx_adapt_int_mod(struct ipa3_sys_context *sys, int cnt)
+{
+	struct ipa3_rx_int_mod_ctx *mod = &sys->int_mod;
+	const struct ipa3_rx_int_mod_level *levels;
+	unsigned long elapsed;
+	int num_levels;
+	int level;
+	u32 rate;
+
+	if (sys->ep->gsi_evt_ring_hdl == ~0)
+		return;
+
+	if (!ipa3_ctx->rx_adaptive_int_mod) {
+		if (mod->level < 0)
+			return;
+		/* Feature turned off, go back to the allocation values */
+		if (!gsi_update_evt_ring_int_mod(sys->ep->gsi_evt_ring_hdl,
+			mod->def_modt, mod->def_modc))
+			mod->level = -1;
+		return;
+	}
+
+	if (cnt > 0)
+		mod->win_pkts += cnt;
+
+	elapsed = jiffies - mod->win_start;
+	if (elapsed < msecs_to_jiffies(IPA_RX_INT_MOD_WINDOW_MS))
+		return;
+
+	if (IPA_CLIENT_IS_LOW_LAT_CONS(sys->ep->client)) {
+		levels = ipa3_rx_ll_int_mod_levels;
+		num_levels = ARRAY_SIZE(ipa3_rx_ll_int_mod_levels);
+	} else {
+		levels = ipa3_rx_int_mod_levels;
+		num_levels = ARRAY_SIZE(ipa3_rx_int_mod_levels);
+	}
+
+	rate = mod->win_pkts / max(jiffies_to_msecs(elapsed), 1U);
+	mod->win_start = jiffies;
+	mod->win_pkts = 0;
+
+	level = max(mod->level, 0);
+	while (level + 1 < num_levels && rate >= levels[level + 1].min_rate)
+		level++;
+	while (level > 0 && rate < levels[level].min_rate * 3 / 4)
+		level--;
+
+	if (level == mod->level)
+		return;
+
+	if (gsi_update_evt_ring_int_mod(sys->ep->gsi_evt_ring_hdl,
+		levels[level].modt, levels[level].modc))
+		return;
+
+	IPADBG_LOW("client=%d rate=%u level=%d modt=%u modc=%u\n",
+		sys->ep->client, rate, level, levels[level].modt,
+		levels[level].modc);
+	mod->level = level;
+	mod->num_updates++;
+}
+
 /**
  * ipa3_rx_poll() - Poll the WAN rx packets from IPA HW. This
  * function is exectued in the softirq context
@@ -7109,6 +7358,7 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 	int num = 0;
 	int remain_aggr_weight;
 	int ipa_ep_idx;
+	int stats_i;
 	struct ipa_active_client_logging_info log;
 	static struct gsi_chan_xfer_notify notify[IPA_WAN_NAPI_MAX_FRAMES];
 
@@ -7141,6 +7391,8 @@ int ipa3_rx_poll(u32 clnt_hdl, int weight)
 	}
 
 	ep->sys->common_sys->napi_sort_page_thrshld_cnt++;
+	stats_i = (ep->client == IPA_CLIENT_APPS_WAN_COAL_CONS) ? 0 : 1;
+	this_cpu_inc(ipa3_rx_cpu_stats.napi_polls[stats_i]);
 start_poll:
 	/*
 	 * it is guaranteed we already have clock here.
@@ -7163,6 +7415,7 @@ start_poll:
 		trace_ipa3_napi_rx_poll_num(ep->client, num);
 		ipa3_rx_napi_chain(ep->sys, notify, num);
 		remain_aggr_weight -= num;
+		this_cpu_add(ipa3_rx_cpu_stats.frames[stats_i], num);
 
 		trace_ipa3_napi_rx_poll_cnt(ep->client, ep->sys->len);
 		if (ep->sys->len == 0) {
@@ -7172,6 +7425,7 @@ start_poll:
 		}
 	}
 	cnt += weight - remain_aggr_weight * ipa3_ctx->ipa_wan_aggr_pkt_cnt;
+	ipa3_rx_adapt_int_mod(ep->sys, cnt);
 	/* call repl_hdlr before napi_reschedule / napi_complete */
 	ep->sys->repl_hdlr(ep->sys);
 	wan_def_sys->repl_hdlr(wan_def_sys);
@@ -7353,6 +7607,39 @@ start_poll:
 	IPA_ACTIVE_CLIENTS_DEC_EP_NO_BLOCK(sys->ep->client);
 }
 
+/**
+ * ipa3_rmnet_ll_busy_poll_start() - move the low latency data channel
+ * to polling mode on behalf of a busy polling socket
+ * @sys: [in] low latency data sys context
+ *
+ * Called when the NAPI poll runs without a prior IEOB interrupt, which only
+ * happens from napi_busy_loop(). Takes the same clock vote and wakelock the
+ * interrupt path takes so the regular poll exit path can release them.
+ *
+ * Return: true if the caller may poll the channel
+ */
+static bool ipa3_rmnet_ll_busy_poll_start(struct ipa3_sys_context *sys)
+{
+	if (!ipa3_ctx->rmnet_ll_busy_poll)
+		return false;
+
+	/* the interrupt already moved the channel to polling mode */
+	if (atomic_cmpxchg(&sys->curr_polling_state, 0, 1))
+		return true;
+
+	if (IPA_ACTIVE_CLIENTS_INC_EP_NO_BLOCK(sys->ep->client)) {
+		atomic_set(&sys->curr_polling_state, 0);
+		return false;
+	}
+
+	gsi_config_channel_mode(sys->ep->gsi_chan_hdl, GSI_CHAN_MODE_POLL);
+	__ipa3_update_curr_poll_state(sys->ep->client, 1);
+	ipa3_inc_acquire_wakelock();
+	IPA_STATS_INC_CNT(ipa3_ctx->stats.rmnet_ll_busy_poll);
+
+	return true;
+}
+
 static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget)
 {
 	struct ipa3_sys_context *sys = container_of(napi_rx,
@@ -7375,8 +7662,14 @@ static int ipa3_rmnet_ll_rx_poll(struct napi_struct *napi_rx, int budget)
 	}
 
 	sys->napi_sort_page_thrshld_cnt++;
+	this_cpu_inc(ipa3_rx_cpu_stats.napi_polls[2]);
 
 	trace_ipa3_napi_poll_entry(sys->ep->client);
+	if (!atomic_read(&sys->curr_polling_state) &&
+		!ipa3_rmnet_ll_busy_poll_start(sys)) {
+		napi_complete(napi_rx);
+		return 0;
+	}
 start_poll:
 	/*
 	 * it is guaranteed we already have clock here.
@@ -7394,6 +7687,7 @@ start_poll:
 		trace_ipa3_napi_rx_poll_num(sys->ep->client, num);
 		ipa3_rx_napi_chain(sys, notify, num);
 		remain_aggr_weight -= num;
+		this_cpu_add(ipa3_rx_cpu_stats.frames[2], num);
 
 		trace_ipa3_napi_rx_poll_cnt(sys->ep->client, sys->len);
 		if (sys->len == 0) {
@@ -7403,6 +7697,7 @@ start_poll:
 		}
 	}
 	cnt += budget - remain_aggr_weight * ipa3_ctx->ipa_wan_aggr_pkt_cnt;
+	ipa3_rx_adapt_int_mod(sys, cnt);
 	/* call repl_hdlr before napi_reschedule / napi_complete */
 	sys->repl_hdlr(sys);
 	/* Scheduling RMNET LOW LAT DATA collect stats work queue */
@@ -597,6 +597,14 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		goto prep_failed;
 	}
 
+	if (ipa3_fltrt_img_unchanged(&ipa3_ctx->flt_img_cache[ip],
+		&alloc_params)) {
+		IPADBG_LOW("FLT images unchanged, skip commit. IP %d\n", ip);
+		__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
+		__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
+		goto fail_size_valid;
+	}
+
 	/* +4: 2 for bodies (hashable and non-hashable), 1 for flushing and 1
 	 * for closing the colaescing frame
 	 */
@@ -819,11 +827,13 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 
 		if (ipa3_send_cmd(num_cmd_to_send, desc_to_send)) {
 			IPAERR("fail to send immediate command batch\n");
+			ipa3_fltrt_img_invalidate(&ipa3_ctx->flt_img_cache[ip]);
 			rc = -EFAULT;
 			goto fail_imm_cmd_construct;
 		}
 		desc_to_send += num_cmd_to_send;
 	}
+	ipa3_fltrt_img_save(&ipa3_ctx->flt_img_cache[ip], &alloc_params);
 
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
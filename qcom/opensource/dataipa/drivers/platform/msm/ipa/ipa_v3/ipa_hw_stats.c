@@ -674,6 +674,57 @@ destroy_init_pyld:
 	return ret;
 }
 
+/*
+ * update the driver cache from a quota stats buffer read from hardware
+ * with clear_after_read
+ */
+static int ipa_quota_stats_update_cache(void *base)
+{
+	struct ipahal_stats_quota_all *stats;
+	int i;
+	int ret;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (!stats)
+		return -ENOMEM;
+
+	ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
+		&ipa3_ctx->hw_stats->quota.init, base, stats);
+	if (ret) {
+		IPAERR("failed to parse stats (error %d)\n", ret);
+		goto free_stats;
+	}
+
+	/*
+	 * update driver cache.
+	 * the stats were read from hardware with clear_after_read meaning
+	 * hardware stats are 0 now
+	 */
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa3_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_bytes +=
+			stats->stats[ep_idx].num_ipv4_bytes;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_pkts +=
+			stats->stats[ep_idx].num_ipv4_pkts;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_bytes +=
+			stats->stats[ep_idx].num_ipv6_bytes;
+		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_pkts +=
+			stats->stats[ep_idx].num_ipv6_pkts;
+	}
+
+	ret = 0;
+free_stats:
+	kfree(stats);
+	return ret;
+}
+
 int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 {
 	int i;
@@ -684,7 +735,6 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
 	struct ipa_mem_buffer mem;
 	struct ipa3_desc desc[2];
-	struct ipahal_stats_quota_all *stats;
 	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
@@ -753,49 +803,13 @@ int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 		goto destroy_imm;
 	}
 
-	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
-		ret = -ENOMEM;
+	ret = ipa_quota_stats_update_cache(mem.base);
+	if (ret)
 		goto destroy_imm;
-	}
-
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_QUOTA,
-		&ipa3_ctx->hw_stats->quota.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
-	}
-
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa3_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_bytes +=
-			stats->stats[ep_idx].num_ipv4_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv4_pkts +=
-			stats->stats[ep_idx].num_ipv4_pkts;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_bytes +=
-			stats->stats[ep_idx].num_ipv6_bytes;
-		ipa3_ctx->hw_stats->quota.stats.client[i].num_ipv6_pkts +=
-			stats->stats[ep_idx].num_ipv6_pkts;
-	}
 
 	/* copy results to out parameter */
 	if (out)
 		*out = ipa3_ctx->hw_stats->quota.stats;
-	ret = 0;
-free_stats:
-	kfree(stats);
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -1071,105 +1085,33 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_teth_stats(void)
+/*
+ * update the driver cache from a tethering stats buffer read from hardware
+ * with clear_after_read
+ */
+static int ipa_teth_stats_update_cache(void *base)
 {
 	int i, j;
 	int prod_reg, cons_reg;
 	int ret;
-	struct ipahal_stats_get_offset_tethering get_offset;
-	struct ipahal_stats_offset offset = {0};
-	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
-	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
-	struct ipa_mem_buffer mem;
-	struct ipa3_desc desc[2];
 	struct ipahal_stats_tethering_all *stats_all;
 	struct ipa_hw_stats_teth *sw_stats;
 	struct ipahal_stats_tethering *stats;
 	struct ipa_quota_stats *quota_stats;
 	struct ipahal_stats_init_tethering *init;
-	int num_cmd = 0;
-
-	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
-		ipa3_ctx->hw_stats->teth_stats_enabled))
-		return 0;
 
 	sw_stats = &ipa3_ctx->hw_stats->teth;
 	init = (struct ipahal_stats_init_tethering *)
 			&ipa3_ctx->hw_stats->teth.init;
 
-	memset(desc, 0, sizeof(desc));
-	memset(cmd_pyld, 0, sizeof(cmd_pyld));
-	memset(&get_offset, 0, sizeof(get_offset));
-
-	get_offset.init = ipa3_ctx->hw_stats->teth.init;
-	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_TETHERING, &get_offset,
-		&offset);
-	if (ret) {
-		IPAERR("failed to get offset from hal %d\n", ret);
-		return ret;
-	}
-
-	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
-
-	if (offset.size == 0)
-		return 0;
-
-	mem.size = offset.size;
-	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
-		mem.size,
-		&mem.phys_base,
-		GFP_KERNEL);
-	if (!mem.base) {
-		IPAERR("fail to alloc DMA memory\n");
-		return ret;
-	}
-
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
-		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
-		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			ret = -ENOMEM;
-			goto free_dma_mem;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	cmd.is_read = true;
-	cmd.clear_after_read = true;
-	cmd.skip_pipeline_clear = false;
-	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-	cmd.size = mem.size;
-	cmd.system_addr = mem.phys_base;
-	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
-		IPA_MEM_PART(stats_tethering_ofst) + offset.offset;
-	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
-	if (!cmd_pyld[num_cmd]) {
-		IPAERR("failed to construct dma_shared_mem imm cmd\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
-	}
-	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-	++num_cmd;
-
-	ret = ipa3_send_cmd(num_cmd, desc);
-	if (ret) {
-		IPAERR("failed to send immediate command (error %d)\n", ret);
-		goto destroy_imm;
-	}
-
 	stats_all = vmalloc(sizeof(*stats_all));
 	if (!stats_all) {
 		IPADBG("failed to alloc memory\n");
-		ret = -ENOMEM;
-		goto destroy_imm;
+		return -ENOMEM;
 	}
 
 	ret = ipahal_parse_stats(IPAHAL_HW_STATS_TETHERING,
-		&ipa3_ctx->hw_stats->teth.init, mem.base, stats_all);
+		&ipa3_ctx->hw_stats->teth.init, base, stats_all);
 	if (ret) {
 		IPAERR("failed to parse stats_all (error %d)\n", ret);
 		goto free_stats;
@@ -1249,7 +1191,91 @@ int ipa_get_teth_stats(void)
 	ret = 0;
 free_stats:
 	vfree(stats_all);
-	stats = NULL;
+	return ret;
+}
+
+int ipa_get_teth_stats(void)
+{
+	int i;
+	int ret;
+	struct ipahal_stats_get_offset_tethering get_offset;
+	struct ipahal_stats_offset offset = {0};
+	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
+	struct ipa_mem_buffer mem;
+	struct ipa3_desc desc[2];
+	int num_cmd = 0;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled &&
+		ipa3_ctx->hw_stats->teth_stats_enabled))
+		return 0;
+
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+	memset(&get_offset, 0, sizeof(get_offset));
+
+	get_offset.init = ipa3_ctx->hw_stats->teth.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_TETHERING, &get_offset,
+		&offset);
+	if (ret) {
+		IPAERR("failed to get offset from hal %d\n", ret);
+		return ret;
+	}
+
+	IPADBG_LOW("offset = %d size = %d\n", offset.offset, offset.size);
+
+	if (offset.size == 0)
+		return 0;
+
+	mem.size = offset.size;
+	mem.base = dma_alloc_coherent(ipa3_ctx->pdev,
+		mem.size,
+		&mem.phys_base,
+		GFP_KERNEL);
+	if (!mem.base) {
+		IPAERR("fail to alloc DMA memory\n");
+		return ret;
+	}
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
+		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			ret = -ENOMEM;
+			goto free_dma_mem;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	cmd.is_read = true;
+	cmd.clear_after_read = true;
+	cmd.skip_pipeline_clear = false;
+	cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+	cmd.size = mem.size;
+	cmd.system_addr = mem.phys_base;
+	cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
+		IPA_MEM_PART(stats_tethering_ofst) + offset.offset;
+	cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+		IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+	if (!cmd_pyld[num_cmd]) {
+		IPAERR("failed to construct dma_shared_mem imm cmd\n");
+		ret = -ENOMEM;
+		goto destroy_imm;
+	}
+	ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+	++num_cmd;
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	ret = ipa_teth_stats_update_cache(mem.base);
+
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -2100,6 +2126,53 @@ fail_free_desc:
 	return ret;
 }
 
+/*
+ * update the driver cache from a drop stats buffer read from hardware
+ * with clear_after_read
+ */
+static int ipa_drop_stats_update_cache(void *base)
+{
+	struct ipahal_stats_drop_all *stats;
+	int i;
+	int ret;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (!stats)
+		return -ENOMEM;
+
+	ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
+		&ipa3_ctx->hw_stats->drop.init, base, stats);
+	if (ret) {
+		IPAERR("failed to parse stats (error %d)\n", ret);
+		goto free_stats;
+	}
+
+	/*
+	 * update driver cache.
+	 * the stats were read from hardware with clear_after_read meaning
+	 * hardware stats are 0 now
+	 */
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		int ep_idx = ipa3_get_ep_mapping(i);
+
+		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
+			continue;
+
+		if (ipa3_ctx->ep[ep_idx].client != i)
+			continue;
+
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
+			stats->stats[ep_idx].drop_byte_cnt;
+		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
+			stats->stats[ep_idx].drop_packet_cnt;
+	}
+
+	ret = 0;
+free_stats:
+	kfree(stats);
+	return ret;
+}
+
 int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 {
 	int i;
@@ -2110,7 +2183,6 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 	struct ipahal_imm_cmd_pyld *cmd_pyld[2];
 	struct ipa_mem_buffer mem;
 	struct ipa3_desc desc[2];
-	struct ipahal_stats_drop_all *stats;
 	int num_cmd = 0;
 
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
@@ -2179,51 +2251,13 @@ int ipa_get_drop_stats(struct ipa_drop_stats_all *out)
 		goto destroy_imm;
 	}
 
-	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
-	if (!stats) {
-		ret = -ENOMEM;
+	ret = ipa_drop_stats_update_cache(mem.base);
+	if (ret)
 		goto destroy_imm;
-	}
-
-	ret = ipahal_parse_stats(IPAHAL_HW_STATS_DROP,
-		&ipa3_ctx->hw_stats->drop.init, mem.base, stats);
-	if (ret) {
-		IPAERR("failed to parse stats (error %d)\n", ret);
-		goto free_stats;
-	}
-
-	/*
-	 * update driver cache.
-	 * the stats were read from hardware with clear_after_read meaning
-	 * hardware stats are 0 now
-	 */
-	for (i = 0; i < IPA_CLIENT_MAX; i++) {
-		int ep_idx = ipa3_get_ep_mapping(i);
-
-		if (ep_idx == -1 || ep_idx >= ipa3_get_max_num_pipes())
-			continue;
-
-		if (ipa3_ctx->ep[ep_idx].client != i)
-			continue;
-
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_byte_cnt +=
-			stats->stats[ep_idx].drop_byte_cnt;
-		ipa3_ctx->hw_stats->drop.stats.client[i].drop_packet_cnt +=
-			stats->stats[ep_idx].drop_packet_cnt;
-	}
-
-
-	if (!out) {
-		ret = 0;
-		goto free_stats;
-	}
 
 	/* copy results to out parameter */
-	*out = ipa3_ctx->hw_stats->drop.stats;
-
-	ret = 0;
-free_stats:
-	kfree(stats);
+	if (out)
+		*out = ipa3_ctx->hw_stats->drop.stats;
 destroy_imm:
 	for (i = 0; i < num_cmd; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
@@ -2281,6 +2315,177 @@ int ipa_reset_all_drop_stats(void)
 }
 
 
+/*
+ * struct ipa_hw_stats_region - one stats region read by a snapshot
+ * @smem_ofst: start of the region in IPA SRAM
+ * @offset: offset and size of the enabled part of the region
+ * @buf_ofst: where the region lands in the snapshot DMA buffer
+ * @update_cache: parses the region into the driver cache
+ */
+struct ipa_hw_stats_region {
+	u32 smem_ofst;
+	struct ipahal_stats_offset offset;
+	u32 buf_ofst;
+	int (*update_cache)(void *base);
+};
+
+/**
+ * ipa_hw_stats_snapshot() - refresh the quota, tethering and drop stats
+ * caches with a single immediate command batch
+ *
+ * Reading all the regions with one descriptor chain costs a single coal
+ * frame close and pipeline clear, instead of one per stats type when the
+ * getters are called one after the other.
+ * The caches are then read by the regular ipa_get_*_stats users; a
+ * successful snapshot bumps hw_stats->snapshot_seq.
+ *
+ * Must be called with ipa3_ctx->lock held, like the per type getters.
+ *
+ * Returns: 0 on success, negative on failure
+ */
+int ipa_hw_stats_snapshot(void)
+{
+	struct ipahal_stats_get_offset_quota quota_offset = { { 0 } };
+	struct ipahal_stats_get_offset_tethering teth_offset;
+	struct ipahal_stats_get_offset_drop drop_offset = { { 0 } };
+	struct ipa_hw_stats_region region[3];
+	struct ipahal_imm_cmd_dma_shared_mem cmd = { 0 };
+	struct ipahal_imm_cmd_pyld *cmd_pyld[ARRAY_SIZE(region) + 1];
+	struct ipa3_desc desc[ARRAY_SIZE(region) + 1];
+	struct ipa_mem_buffer mem;
+	int num_region = 0;
+	int num_cmd = 0;
+	int i, ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	memset(region, 0, sizeof(region));
+	memset(desc, 0, sizeof(desc));
+	memset(cmd_pyld, 0, sizeof(cmd_pyld));
+	memset(&teth_offset, 0, sizeof(teth_offset));
+
+	quota_offset.init = ipa3_ctx->hw_stats->quota.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_QUOTA, &quota_offset,
+		&region[num_region].offset);
+	if (ret) {
+		IPAERR("failed to get quota offset from hal %d\n", ret);
+		return ret;
+	}
+	region[num_region].smem_ofst = IPA_MEM_PART(stats_quota_ap_ofst);
+	region[num_region].update_cache = ipa_quota_stats_update_cache;
+	if (region[num_region].offset.size)
+		num_region++;
+
+	if (ipa3_ctx->hw_stats->teth_stats_enabled) {
+		teth_offset.init = ipa3_ctx->hw_stats->teth.init;
+		ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_TETHERING,
+			&teth_offset, &region[num_region].offset);
+		if (ret) {
+			IPAERR("failed to get teth offset from hal %d\n", ret);
+			return ret;
+		}
+		region[num_region].smem_ofst =
+			IPA_MEM_PART(stats_tethering_ofst);
+		region[num_region].update_cache = ipa_teth_stats_update_cache;
+		if (region[num_region].offset.size)
+			num_region++;
+	}
+
+	drop_offset.init = ipa3_ctx->hw_stats->drop.init;
+	ret = ipahal_stats_get_offset(IPAHAL_HW_STATS_DROP, &drop_offset,
+		&region[num_region].offset);
+	if (ret) {
+		IPAERR("failed to get drop offset from hal %d\n", ret);
+		return ret;
+	}
+	region[num_region].smem_ofst = IPA_MEM_PART(stats_drop_ofst);
+	region[num_region].update_cache = ipa_drop_stats_update_cache;
+	if (region[num_region].offset.size)
+		num_region++;
+
+	if (!num_region)
+		return 0;
+
+	/* one DMA buffer, each region 8B aligned as stats are 64 bit */
+	mem.size = 0;
+	for (i = 0; i < num_region; i++) {
+		region[i].buf_ofst = mem.size;
+		mem.size += ALIGN(region[i].offset.size, 8);
+	}
+
+	mem.base = dma_alloc_coherent(ipa3_ctx->pdev, mem.size,
+		&mem.phys_base, GFP_KERNEL);
+	if (!mem.base) {
+		IPAERR("fail to alloc DMA memory\n");
+		return -ENOMEM;
+	}
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) !=
+		IPA_EP_NOT_ALLOCATED && !ipa3_ctx->ulso_wa) {
+		ipa_close_coal_frame(&cmd_pyld[num_cmd]);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			ret = -ENOMEM;
+			goto free_dma_mem;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	for (i = 0; i < num_region; i++) {
+		cmd.is_read = true;
+		cmd.clear_after_read = true;
+		/* the first read clears the pipeline for all of them */
+		cmd.skip_pipeline_clear = (i != 0);
+		cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		cmd.size = region[i].offset.size;
+		cmd.system_addr = mem.phys_base + region[i].buf_ofst;
+		cmd.local_addr = ipa3_ctx->smem_restricted_bytes +
+			region[i].smem_ofst + region[i].offset.offset;
+		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_DMA_SHARED_MEM, &cmd, false);
+		if (!cmd_pyld[num_cmd]) {
+			IPAERR("failed to construct dma_shared_mem imm cmd\n");
+			ret = -ENOMEM;
+			goto destroy_imm;
+		}
+		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
+		++num_cmd;
+	}
+
+	ret = ipa3_send_cmd(num_cmd, desc);
+	if (ret) {
+		IPAERR("failed to send immediate command (error %d)\n", ret);
+		goto destroy_imm;
+	}
+
+	/*
+	 * all regions were cleared by the read, keep parsing on failure so
+	 * the other caches don't lose their counts
+	 */
+	for (i = 0; i < num_region; i++) {
+		int res = region[i].update_cache(
+			(u8 *)mem.base + region[i].buf_ofst);
+
+		if (res && !ret)
+			ret = res;
+	}
+
+	if (!ret) {
+		ipa3_ctx->hw_stats->snapshot_seq++;
+		ipa3_ctx->hw_stats->snapshot_ts = ktime_get_boottime();
+	}
+
+destroy_imm:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+free_dma_mem:
+	dma_free_coherent(ipa3_ctx->pdev, mem.size, mem.base, mem.phys_base);
+	return ret;
+}
+
 #ifndef CONFIG_DEBUG_FS
 int ipa_debugfs_init_stats(struct dentry *parent) { return 0; }
 #else
@@ -2808,6 +3013,32 @@ bail:
 	return ret;
 }
 
+static ssize_t ipa_debugfs_print_snapshot(struct file *file,
+	char __user *ubuf, size_t count, loff_t *ppos)
+{
+	int nbytes;
+	int res;
+
+	mutex_lock(&ipa3_ctx->lock);
+	res = ipa_hw_stats_snapshot();
+	if (res) {
+		mutex_unlock(&ipa3_ctx->lock);
+		return res;
+	}
+
+	nbytes = scnprintf(dbg_buff, IPA_MAX_MSG_LEN,
+		"snapshot seq %u at %lld ms\n",
+		ipa3_ctx->hw_stats->snapshot_seq,
+		ktime_to_ms(ipa3_ctx->hw_stats->snapshot_ts));
+	mutex_unlock(&ipa3_ctx->lock);
+
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, nbytes);
+}
+
+static const struct file_operations ipa3_snapshot_ops = {
+	.read = ipa_debugfs_print_snapshot,
+};
+
 static const struct file_operations ipa3_quota_ops = {
 	.read = ipa_debugfs_print_quota_stats,
 	.write = ipa_debugfs_reset_quota_stats,
@@ -2835,6 +3066,7 @@ static const struct file_operations ipa3_enable_drop_ops = {
 int ipa_debugfs_init_stats(struct dentry *parent)
 {
 	const mode_t read_write_mode = 0664;
+	const mode_t read_mode = 0444;
 	const mode_t write_mode = 0220;
 	struct dentry *file;
 	struct dentry *dent;
@@ -2883,6 +3115,13 @@ int ipa_debugfs_init_stats(struct dentry *parent)
 		goto fail;
 	}
 
+	file = debugfs_create_file("snapshot", read_mode, dent, NULL,
+		&ipa3_snapshot_ops);
+	if (IS_ERR_OR_NULL(file)) {
+		IPAERR("fail to create file %s\n", "snapshot");
+		goto fail;
+	}
+
 	return 0;
 fail:
 	debugfs_remove_recursive(dent);
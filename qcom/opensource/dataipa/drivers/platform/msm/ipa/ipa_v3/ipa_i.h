@@ -1171,6 +1171,24 @@ struct ipa3_page_repl_ctx {
 	atomic_t pending;
 };
 
+/**
+ * struct ipa3_rx_int_mod_ctx - adaptive RX interrupt moderation state
+ * @def_modt: moderation timer the event ring was allocated with
+ * @def_modc: moderation counter the event ring was allocated with
+ * @level: index of the moderation level in use, -1 for the defaults
+ * @win_start: jiffies at the start of the current sampling window
+ * @win_pkts: packets polled in the current sampling window
+ * @num_updates: number of times the moderation was reprogrammed
+ */
+struct ipa3_rx_int_mod_ctx {
+	u32 def_modt;
+	u32 def_modc;
+	int level;
+	unsigned long win_start;
+	u32 win_pkts;
+	u32 num_updates;
+};
+
 /**
  * struct ipa3_sys_context - IPA GPI pipes context
  * @head_desc_list: header descriptors list
@@ -1188,6 +1206,9 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @int_mod: adaptive interrupt moderation state of the event ring
+ * @db_pend_pkts: TX transactions queued without ringing the doorbell
+ * @db_pend_bytes: bytes queued without ringing the doorbell
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1236,6 +1257,9 @@ struct ipa3_sys_context {
 	struct ipa3_sys_context *common_sys;
 	atomic_t page_avilable;
 	u32 napi_sort_page_thrshld_cnt;
+	struct ipa3_rx_int_mod_ctx int_mod;
+	u32 db_pend_pkts;
+	u32 db_pend_bytes;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1245,6 +1269,7 @@ struct ipa3_sys_context {
 	u32 avail_tx_wrapper;
 	spinlock_t spinlock;
 	struct hrtimer db_timer;
+	struct hrtimer db_flush_timer;
 	struct workqueue_struct *wq;
 	struct workqueue_struct *repl_wq;
 	struct ipa3_status_stats *status_stat;
@@ -1567,6 +1592,7 @@ struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 busy_rotated;
 };
 
 struct ipa3_cache_recycle_stats {
@@ -1593,6 +1619,32 @@ struct lan_coal_stats {
 	u64 coal_udp_bytes;
 };
 
+/**
+ * struct ipa3_rx_cpu_stats - per CPU WAN RX NAPI stats
+ * @napi_polls: NAPI polls run on the CPU, indexed COAL / DEF / LL
+ * @frames: aggregated frames delivered by those polls
+ */
+struct ipa3_rx_cpu_stats {
+	u64 napi_polls[3];
+	u64 frames[3];
+};
+
+/**
+ * struct ipa3_fltrt_img_cache - copy of the last committed flt/rt images
+ * @valid: the copies match the apps tables in IPA SRAM
+ * @base: copies of the hash hdr, nhash hdr, hash body and nhash body images
+ * @size: size of each copy
+ * @num_commit: number of commits that rewrote the tables
+ * @num_skip: number of commits skipped since nothing changed
+ */
+struct ipa3_fltrt_img_cache {
+	bool valid;
+	void *base[4];
+	u32 size[4];
+	u32 num_commit;
+	u32 num_skip;
+};
+
 struct ipa3_stats {
 	u32 tx_sw_pkts;
 	u32 tx_hw_pkts;
@@ -1622,6 +1674,9 @@ struct ipa3_stats {
 	u32 rx_page_drop_cnt;
 	u64 lower_order;
 	u32 pipe_setup_fail_cnt;
+	u32 tx_db_deferred;
+	u32 tx_db_timer_flush;
+	u32 rmnet_ll_busy_poll;
 	struct ipa3_page_recycle_stats page_recycle_stats[3];
 	struct ipa3_cache_recycle_stats cache_recycle_stats[3];
 	u64 page_recycle_cnt[3][IPA_PAGE_POLL_THRESHOLD_MAX];
@@ -1974,6 +2029,8 @@ struct ipa_hw_stats {
 	struct ipa_hw_stats_flt_rt flt_rt;
 	struct ipa_hw_stats_drop drop;
 	bool teth_stats_enabled;
+	u32 snapshot_seq;
+	ktime_t snapshot_ts;
 };
 
 struct ipa_cne_evt {
@@ -2292,6 +2349,9 @@ enum ipa_per_usb_enum_type_e {
  * @mpm_ring_size_ul: MHIP all UL pipe's ring size
  * @mpm_teth_aggr_size: MHIP teth aggregation byte size
  * @mpm_uc_thresh: uc threshold for enabling uc flow control
+ * @mpm_adaptive_db_mod: adapt MHIP doorbell moderation to the ring load
+ * @mpm_burst_mode: MHIP directions requesting MHI burst mode on the next
+ *	channel setup, bit 0 for UL and bit 1 for DL
  * @ipa_client_apps_wan_cons_agg_gro: RMNET_IOCTL_INGRESS_FORMAT_AGG_DATA
  * @apply_rg10_wa: Indicates whether to use register group 10 workaround
  * @gsi_ch20_wa: Indicates whether to apply GSI physical channel 20 workaround
@@ -2378,6 +2438,8 @@ struct ipa3_context {
 	bool flt_tbl_hash_lcl[IPA_IP_MAX];
 	bool flt_tbl_nhash_lcl[IPA_IP_MAX];
 	struct list_head flt_tbl_nhash_lcl_list[IPA_IP_MAX];
+	struct ipa3_fltrt_img_cache rt_img_cache[IPA_IP_MAX];
+	struct ipa3_fltrt_img_cache flt_img_cache[IPA_IP_MAX];
 	struct ipa3_active_clients ipa3_active_clients;
 	struct ipa3_active_clients_log_ctx ipa3_active_clients_logging;
 	struct workqueue_struct *power_mgmt_wq;
@@ -2431,6 +2493,10 @@ struct ipa3_context {
 	spinlock_t idr_lock;
 	u32 enable_clock_scaling;
 	u32 enable_napi_chain;
+	u32 rx_adaptive_int_mod;
+	u32 tx_db_batch;
+	u32 pm_predictive_scaling;
+	u32 rmnet_ll_busy_poll;
 	u32 curr_ipa_clk_rate;
 	bool q6_proxy_clk_vote_valid;
 	struct mutex q6_proxy_clk_vote_mutex;
@@ -2455,6 +2521,8 @@ struct ipa3_context {
 	int mpm_ring_size_ul;
 	int mpm_teth_aggr_size;
 	int mpm_uc_thresh;
+	u32 mpm_adaptive_db_mod;
+	u32 mpm_burst_mode;
 	unsigned long gsi_dev_hdl;
 	u32 ee;
 	bool apply_rg10_wa;
@@ -3417,6 +3485,7 @@ bool ipa_is_modem_pipe(int pipe_idx);
 
 int ipa3_send_one(struct ipa3_sys_context *sys, struct ipa3_desc *desc,
 		bool in_atomic);
+struct ipa3_rx_cpu_stats *ipa3_get_rx_cpu_stats(int cpu);
 int ipa3_send(struct ipa3_sys_context *sys,
 		u32 num_desc,
 		struct ipa3_desc *desc,
@@ -3518,6 +3587,11 @@ int _ipa_init_flt6_v3(void);
 
 int __ipa_commit_flt_v3(enum ipa_ip_type ip);
 int __ipa_commit_rt_v3(enum ipa_ip_type ip);
+bool ipa3_fltrt_img_unchanged(struct ipa3_fltrt_img_cache *cache,
+	struct ipahal_fltrt_alloc_imgs_params *params);
+void ipa3_fltrt_img_save(struct ipa3_fltrt_img_cache *cache,
+	struct ipahal_fltrt_alloc_imgs_params *params);
+void ipa3_fltrt_img_invalidate(struct ipa3_fltrt_img_cache *cache);
 
 int __ipa_commit_hdr_v3_0(void);
 void ipa3_skb_recycle(struct sk_buff *skb);
@@ -3637,6 +3711,8 @@ int ipa_reset_drop_stats(enum ipa_client_type client);
 
 int ipa_reset_all_drop_stats(void);
 
+int ipa_hw_stats_snapshot(void);
+
 int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in);
 
 int ipa_get_teth_stats(void);
@@ -3828,6 +3904,7 @@ int ipa_mpm_reset_dma_mode(enum ipa_client_type src_pipe,
 int ipa_mpm_panic_handler(char *buf, int size);
 int ipa3_mpm_enable_adpl_over_odl(bool enable);
 int ipa3_get_mhip_gsi_stats(struct ipa_uc_dbg_ring_stats *stats);
+int ipa_mpm_db_mod_stats(char *buf, int size);
 #else /* IS_ENABLED(CONFIG_IPA3_MHI_PRIME_MANAGER) */
 static inline int ipa_mpm_init(void)
 {
@@ -3871,6 +3948,11 @@ static inline int ipa3_get_mhip_gsi_stats(struct ipa_uc_dbg_ring_stats *stats)
 	return 0;
 }
 
+static inline int ipa_mpm_db_mod_stats(char *buf, int size)
+{
+	return 0;
+}
+
 static inline int ipa3_mpm_enable_adpl_over_odl(bool enable)
 {
 	return 0;
@@ -77,6 +77,9 @@
 #define IPA_MPM_FLOW_CTRL_ADD 1
 #define IPA_MPM_FLOW_CTRL_DELETE 0
 #define IPA_MPM_NUM_OF_INIT_CMD_DESC 2
+#define IPA_MPM_DB_MOD_WINDOW_MS 100
+/* MHI channel context BRSTMODE, 0 leaves it to the device default */
+#define IPA_MPM_MHI_BRSTMODE_ENABLE 3
 
 enum mhip_re_type {
 	MHIP_RE_XFER = 0x2,
@@ -174,7 +177,9 @@ struct __packed mhi_p_desc {
  */
 struct ipa_mpm_channel_context_type {
 	u32 chstate : 8;
-	u32 reserved1 : 24;
+	u32 brstmode : 2;
+	u32 pollcfg : 6;
+	u32 reserved1 : 16;
 	u32 chtype;
 	u32 erindex;
 	u64 rbase;
@@ -337,12 +342,56 @@ enum ipa_mpm_remote_state {
 	MPM_MHIP_REMOTE_ERR,
 };
 
+/**
+ * struct ipa_mpm_db_mod_level - one step of the adaptive doorbell moderation
+ * @min_util: ring utilization (percent) from which this level is selected
+ * @threshold: events GSI accumulates before ringing the remote doorbell
+ * @timer: moderation timer flushing a partial batch
+ */
+struct ipa_mpm_db_mod_level {
+	u32 min_util;
+	u8 threshold;
+	u8 timer;
+};
+
+static const struct ipa_mpm_db_mod_level ipa_mpm_db_mod_levels[] = {
+	{ .min_util = 0, .threshold = 1, .timer = 0 },
+	{ .min_util = 25, .threshold = 2, .timer = 1 },
+	{ .min_util = 50, .threshold = 4, .timer = 2 },
+	{ .min_util = 75, .threshold = 8, .timer = 4 },
+};
+
+/**
+ * struct ipa_mpm_db_mod - per channel doorbell moderation state and stats
+ * @level: index in ipa_mpm_db_mod_levels, -1 for the allocation values
+ * @num_updates: number of moderation changes written to GSI
+ * @primed: last_* hold a valid uC sample
+ * @last_full: uC ring full count at the previous sample
+ * @last_high: uC ring usage high count at the previous sample
+ * @last_low: uC ring usage low count at the previous sample
+ * @util: share of uC samples above the high watermark in the last window
+ * @util_max: highest @util seen
+ * @full_events: ring full events seen while tethering
+ */
+struct ipa_mpm_db_mod {
+	int level;
+	u32 num_updates;
+	bool primed;
+	u32 last_full;
+	u32 last_high;
+	u32 last_low;
+	u32 util;
+	u32 util_max;
+	u64 full_events;
+};
+
 struct ipa_mpm_channel {
 	struct ipa_mpm_channel_props chan_props;
 	struct ipa_mpm_event_props evt_props;
 	enum ipa_mpm_gsi_state gsi_state;
 	dma_addr_t db_host_iova;
 	dma_addr_t db_device_iova;
+	struct ipa_mpm_db_mod db_mod;
 };
 
 enum ipa_mpm_teth_state {
@@ -414,6 +463,7 @@ struct ipa_mpm_context {
 	struct device *parent_pdev;
 	struct ipa_smmu_cb_ctx carved_smmu_cb;
 	struct device *mhi_parent_dev;
+	struct delayed_work db_mod_work;
 };
 
 #define IPA_MPM_DESC_SIZE (sizeof(struct mhi_p_desc))
@@ -1117,7 +1167,10 @@ static int ipa_mpm_connect_mhip_gsi_pipe(enum ipa_client_type mhip_client,
 	gsi_params.evt_ring_params.user_data = NULL;
 
 	/* Evt Scratch Params */
-	/* Disable the Moderation for ringing doorbells */
+	/*
+	 * Disable the Moderation for ringing doorbells, the adaptive
+	 * moderation raises it once tethering traffic builds up.
+	 */
 	gsi_params.evt_scratch.mhip.rp_mod_threshold = 1;
 	gsi_params.evt_scratch.mhip.rp_mod_timer = 0;
 	gsi_params.evt_scratch.mhip.rp_mod_counter = 0;
@@ -2146,6 +2199,153 @@ static void ipa_mpm_change_teth_state(int probe_id,
 	IPA_MPM_DBG("next_state = %d\n", next_state);
 }
 
+/* index of an MHIP pipe in the uC debug ring stats */
+static int ipa_mpm_uc_ring_idx(enum ipa_client_type client)
+{
+	switch (client) {
+	case IPA_CLIENT_MHI_PRIME_TETH_PROD:
+		return 0;
+	case IPA_CLIENT_MHI_PRIME_TETH_CONS:
+		return 1;
+	case IPA_CLIENT_MHI_PRIME_RMNET_PROD:
+		return 2;
+	case IPA_CLIENT_MHI_PRIME_RMNET_CONS:
+		return 3;
+	default:
+		return -EINVAL;
+	}
+}
+
+static int ipa_mpm_write_db_mod(enum ipa_client_type client,
+	u8 threshold, u8 timer)
+{
+	union __packed gsi_evt_scratch scratch;
+	int ipa_ep_idx;
+	struct ipa3_ep_context *ep;
+
+	ipa_ep_idx = ipa3_get_ep_mapping(client);
+	if (ipa_ep_idx == IPA_EP_NOT_ALLOCATED)
+		return -EINVAL;
+
+	ep = &ipa3_ctx->ep[ipa_ep_idx];
+	if (!ep->valid || ep->gsi_evt_ring_hdl == ~0)
+		return -EINVAL;
+
+	memset(&scratch, 0, sizeof(scratch));
+	scratch.mhip.rp_mod_threshold = threshold;
+	scratch.mhip.rp_mod_timer = timer;
+	scratch.mhip.fixed_buffer_sz = TRE_BUFF_SIZE;
+
+	return gsi_write_evt_ring_scratch(ep->gsi_evt_ring_hdl, scratch);
+}
+
+/**
+ * ipa_mpm_adapt_db_mod() - Tune the doorbell moderation of one MHIP channel
+ * @ch: MHIP channel
+ * @client: IPA client of the channel
+ * @stats: uC ring stats of this window, NULL once tethering stopped
+ *
+ * The AP does not see the MHIP traffic itself, so the load is taken from
+ * the uC ring usage samples: the share of samples above the high watermark
+ * in the window selects how many events GSI batches before it rings the
+ * device doorbell over PCIe. Stepping down requires the utilization to
+ * fall a quarter below the current level so the moderation does not
+ * bounce between two levels.
+ */
+static void ipa_mpm_adapt_db_mod(struct ipa_mpm_channel *ch,
+	enum ipa_client_type client, struct ipa_uc_dbg_ring_stats *stats)
+{
+	struct ipa_mpm_db_mod *mod = &ch->db_mod;
+	const struct ipa_mpm_db_mod_level *levels = ipa_mpm_db_mod_levels;
+	int num_levels = ARRAY_SIZE(ipa_mpm_db_mod_levels);
+	u32 full, high, low;
+	int level;
+	int idx;
+
+	idx = ipa_mpm_uc_ring_idx(client);
+	if (idx < 0 || ch->gsi_state != GSI_STARTED)
+		return;
+
+	if (!stats || !ipa3_ctx->mpm_adaptive_db_mod) {
+		/* go back to the allocation values */
+		if (mod->level >= 0 &&
+			!ipa_mpm_write_db_mod(client, levels[0].threshold,
+				levels[0].timer))
+			mod->level = -1;
+		if (!stats) {
+			mod->primed = false;
+			return;
+		}
+	}
+
+	full = stats->u.ring[idx].ringFull;
+	high = stats->u.ring[idx].ringUsageHigh;
+	low = stats->u.ring[idx].ringUsageLow;
+	if (!mod->primed) {
+		mod->primed = true;
+		goto save;
+	}
+
+	mod->full_events += full - mod->last_full;
+	if ((high - mod->last_high) + (low - mod->last_low))
+		mod->util = (high - mod->last_high) * 100 /
+			((high - mod->last_high) + (low - mod->last_low));
+	else
+		mod->util = 0;
+	mod->util_max = max(mod->util_max, mod->util);
+
+	if (!ipa3_ctx->mpm_adaptive_db_mod)
+		goto save;
+
+	level = max(mod->level, 0);
+	/* ring full means the doorbells can't keep up, go straight to max */
+	if (full != mod->last_full)
+		level = num_levels - 1;
+	while (level + 1 < num_levels && mod->util >= levels[level + 1].min_util)
+		level++;
+	while (level > 0 && mod->util < levels[level].min_util * 3 / 4)
+		level--;
+
+	if (level != mod->level &&
+		!ipa_mpm_write_db_mod(client, levels[level].threshold,
+			levels[level].timer)) {
+		IPA_MPM_DBG_LOW("client %d util %u level %d\n",
+			client, mod->util, level);
+		mod->level = level;
+		mod->num_updates++;
+	}
+save:
+	mod->last_full = full;
+	mod->last_high = high;
+	mod->last_low = low;
+}
+
+static void ipa_mpm_db_mod_work_fn(struct work_struct *work)
+{
+	struct ipa_uc_dbg_ring_stats stats;
+	bool active;
+	int i;
+
+	active = atomic_read(&ipa_mpm_ctx->active_teth_count) > 0 &&
+		!ipa3_get_mhip_gsi_stats(&stats);
+
+	for (i = 0; i < IPA_MPM_MHIP_CH_ID_MAX; i++) {
+		mutex_lock(&ipa_mpm_ctx->md[i].mutex);
+		ipa_mpm_adapt_db_mod(&ipa_mpm_ctx->md[i].ul_prod,
+			ipa_mpm_pipes[i].ul_prod.ipa_client,
+			active ? &stats : NULL);
+		ipa_mpm_adapt_db_mod(&ipa_mpm_ctx->md[i].dl_cons,
+			ipa_mpm_pipes[i].dl_cons.ipa_client,
+			active ? &stats : NULL);
+		mutex_unlock(&ipa_mpm_ctx->md[i].mutex);
+	}
+
+	if (active)
+		queue_delayed_work(system_power_efficient_wq,
+			&ipa_mpm_ctx->db_mod_work,
+			msecs_to_jiffies(IPA_MPM_DB_MOD_WINDOW_MS));
+}
+
 static void ipa_mpm_read_channel(enum ipa_client_type chan)
 {
 	struct gsi_chan_info chan_info;
@@ -2287,6 +2487,10 @@ static int ipa_mpm_mhi_probe_cb(struct mhi_device *mhi_dev,
 		/* Fill Channel Conext to be sent to Device side */
 		ch->chan_props.ch_ctx.chtype =
 			IPA_MPM_MHI_HOST_UL_CHANNEL;
+		ch->chan_props.ch_ctx.brstmode =
+			(ipa3_ctx->mpm_burst_mode & BIT(IPA_MPM_MHIP_CHAN_UL)) ?
+			IPA_MPM_MHI_BRSTMODE_ENABLE : 0;
+		ch->db_mod.level = -1;
 		ch->chan_props.ch_ctx.erindex =
 			mhi_dev->ul_event_id;
 		ch->chan_props.ch_ctx.rlen = (ipa3_ctx->mpm_ring_size_ul) *
@@ -2342,6 +2546,10 @@ static int ipa_mpm_mhi_probe_cb(struct mhi_device *mhi_dev,
 		ch->chan_props.ch_ctx.chstate = 1;
 		ch->chan_props.ch_ctx.chtype =
 			IPA_MPM_MHI_HOST_DL_CHANNEL;
+		ch->chan_props.ch_ctx.brstmode =
+			(ipa3_ctx->mpm_burst_mode & BIT(IPA_MPM_MHIP_CHAN_DL)) ?
+			IPA_MPM_MHI_BRSTMODE_ENABLE : 0;
+		ch->db_mod.level = -1;
 		ch->chan_props.ch_ctx.erindex = mhi_dev->dl_event_id;
 		ch->chan_props.ch_ctx.rlen = (ipa3_ctx->mpm_ring_size_dl) *
 			GSI_EVT_RING_RE_SIZE_16B;
@@ -3266,6 +3474,7 @@ static int ipa_mpm_probe(struct platform_device *pdev)
 	atomic_set(&ipa_mpm_ctx->flow_ctrl_mask, 0);
 	atomic_set(&ipa_mpm_ctx->active_teth_count, 0);
 	atomic_set(&ipa_mpm_ctx->voted_before, 1);
+	INIT_DELAYED_WORK(&ipa_mpm_ctx->db_mod_work, ipa_mpm_db_mod_work_fn);
 
 	for (idx = 0; idx < IPA_MPM_MHIP_CH_ID_MAX; idx++) {
 		ipa_mpm_ctx->md[idx].ul_prod.gsi_state = GSI_INIT;
@@ -3292,6 +3501,8 @@ static int ipa_mpm_remove(struct platform_device *pdev)
 {
 	IPA_MPM_FUNC_ENTRY();
 
+	if (ipa_mpm_ctx)
+		cancel_delayed_work_sync(&ipa_mpm_ctx->db_mod_work);
 	mhi_driver_unregister(&mhi_driver);
 	IPA_MPM_FUNC_EXIT();
 	return 0;
@@ -3371,6 +3582,58 @@ int ipa_mpm_panic_handler(char *buf, int size)
 	return cnt;
 }
 
+/**
+ * ipa_mpm_db_mod_stats() - Print the MHIP doorbell moderation state
+ * @buf:	[out] buffer to print into
+ * @size:	[in] size of @buf
+ *
+ * For every MHIP channel, prints the ring utilization over the last
+ * window and the peak, the ring full events, which stand for PCIe side
+ * back pressure, and the moderation level and its doorbell batch.
+ *
+ * Returns:	number of characters printed
+ */
+int ipa_mpm_db_mod_stats(char *buf, int size)
+{
+	struct ipa_mpm_channel *ch;
+	enum ipa_client_type client;
+	int cnt = 0;
+	int i, j;
+
+	if (!ipa_mpm_ctx)
+		return scnprintf(buf, size, "MPM not probed\n");
+
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"adaptive=%u burst_mode=0x%x window=%ums\n",
+		ipa3_ctx->mpm_adaptive_db_mod, ipa3_ctx->mpm_burst_mode,
+		IPA_MPM_DB_MOD_WINDOW_MS);
+
+	for (i = 0; i < IPA_MPM_MHIP_CH_ID_MAX; i++) {
+		mutex_lock(&ipa_mpm_ctx->md[i].mutex);
+		for (j = 0; j < 2; j++) {
+			ch = j ? &ipa_mpm_ctx->md[i].dl_cons :
+				&ipa_mpm_ctx->md[i].ul_prod;
+			client = j ? ipa_mpm_pipes[i].dl_cons.ipa_client :
+				ipa_mpm_pipes[i].ul_prod.ipa_client;
+			if (ipa_mpm_uc_ring_idx(client) < 0)
+				continue;
+			cnt += scnprintf(buf + cnt, size - cnt,
+				"%s: burst=%u util=%u%% util_max=%u%% ring_full=%llu level=%d db_batch=%u updates=%u\n",
+				ipa_clients_strings[client],
+				ch->chan_props.ch_ctx.brstmode ==
+					IPA_MPM_MHI_BRSTMODE_ENABLE,
+				ch->db_mod.util, ch->db_mod.util_max,
+				ch->db_mod.full_events, ch->db_mod.level,
+				ipa_mpm_db_mod_levels[
+					max(ch->db_mod.level, 0)].threshold,
+				ch->db_mod.num_updates);
+		}
+		mutex_unlock(&ipa_mpm_ctx->md[i].mutex);
+	}
+
+	return cnt;
+}
+
 /**
  * ipa3_get_mhip_gsi_stats() - Query MHIP gsi stats from uc
  * @stats:	[inout] stats blob from client populated by driver
@@ -3555,6 +3818,9 @@ int ipa3_qmi_reg_dereg_for_bw(bool bw_reg)
 				return false;
 			}
 			IPA_MPM_DBG("QMI BW regst success");
+			queue_delayed_work(system_power_efficient_wq,
+				&ipa_mpm_ctx->db_mod_work,
+				msecs_to_jiffies(IPA_MPM_DB_MOD_WINDOW_MS));
 		} else {
 			IPA_MPM_DBG("bw_change to %d no-op, teth_count = %d",
 				bw_reg,
@@ -9,6 +9,8 @@
 #include <linux/msm_ipa.h>
 #include <linux/sched/signal.h>
 #include <linux/poll.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
 
 struct ipa_odl_context *ipa3_odl_ctx;
 
@@ -223,6 +225,60 @@ static void delete_first_node(void)
 	}
 }
 
+static struct ipa_odl_mmap_slot *ipa3_odl_mmap_slot(u32 idx)
+{
+	return ipa3_odl_ctx->adpl_mmap_buf + PAGE_SIZE +
+		(idx % IPA_ODL_MMAP_NUM_SLOTS) * IPA_ODL_MMAP_SLOT_SZ;
+}
+
+/**
+ * ipa3_odl_push_mmap() - copy an ODL frame into the mmap ring
+ * @skb: aggregated frame received on the ODL pipe
+ *
+ * Once user-space has mapped /dev/ipa_adpl, frames bypass the message
+ * list and land straight in the next free slot. Slots not yet consumed
+ * belong to user-space, so a full ring drops the new frame.
+ *
+ * Returns: true if the frame was consumed by the ring (or dropped),
+ * false if no ring is mapped
+ */
+static bool ipa3_odl_push_mmap(struct sk_buff *skb)
+{
+	struct ipa_odl_mmap_ctrl *ctrl;
+	struct ipa_odl_mmap_slot *slot;
+	u32 prod, cons;
+
+	mutex_lock(&ipa3_odl_ctx->adpl_msg_lock);
+	ctrl = ipa3_odl_ctx->adpl_mmap_buf;
+	if (!ctrl) {
+		mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
+		return false;
+	}
+
+	prod = ipa3_odl_ctx->adpl_mmap_prod;
+	/* a bogus index from user-space only makes the ring look full */
+	cons = smp_load_acquire(&ctrl->cons_idx);
+	if (prod - cons >= IPA_ODL_MMAP_NUM_SLOTS ||
+		skb->len > IPA_ODL_MMAP_SLOT_SZ - sizeof(*slot)) {
+		ctrl->drop_cnt++;
+		IPA_STATS_INC_CNT(ipa3_odl_ctx->stats.odl_mmap_drop_pkt);
+		mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
+		return true;
+	}
+
+	slot = ipa3_odl_mmap_slot(prod);
+	memcpy(slot->data, skb->data, skb->len);
+	slot->len = skb->len;
+	slot->seq = prod;
+	ipa3_odl_ctx->adpl_mmap_prod = ++prod;
+	smp_store_release(&ctrl->prod_idx, prod);
+	IPA_STATS_INC_CNT(ipa3_odl_ctx->stats.odl_mmap_pkt);
+	mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
+
+	wake_up(&ipa3_odl_ctx->adpl_msg_waitq);
+	return true;
+}
+
 int ipa3_send_adpl_msg(unsigned long skb_data)
 {
 	struct ipa3_push_msg_odl *msg;
@@ -230,6 +286,11 @@ int ipa3_send_adpl_msg(unsigned long skb_data)
 	void *data;
 
 	IPADBG_LOW("Processing DPL data\n");
+	if (ipa3_odl_push_mmap(skb)) {
+		IPA_STATS_INC_CNT(ipa3_odl_ctx->stats.odl_rx_pkt);
+		return 0;
+	}
+
 	msg = kzalloc(sizeof(struct ipa3_push_msg_odl), GFP_KERNEL);
 	if (msg == NULL) {
 		IPADBG("Memory allocation failed\n");
@@ -395,6 +456,8 @@ int ipa3_odl_pipe_open(void)
 	atomic_set(&ipa3_odl_ctx->stats.numer_in_queue, 0);
 	ipa3_odl_ctx->stats.odl_rx_pkt = 0;
 	ipa3_odl_ctx->stats.odl_tx_diag_pkt = 0;
+	ipa3_odl_ctx->stats.odl_mmap_pkt = 0;
+	ipa3_odl_ctx->stats.odl_mmap_drop_pkt = 0;
 	/*
 	 * Send signal to ipa_odl_ctl_fops_read,
 	 * to send ODL ep open notification
@@ -465,6 +528,12 @@ static int ipa_adpl_release(struct inode *inode, struct file *filp)
 			IPAERR("mpm failed to disable ADPL over ODL\n");
 
 	}
+
+	/* the mapping holds a file reference, so no vma is left by now */
+	mutex_lock(&ipa3_odl_ctx->adpl_msg_lock);
+	vfree(ipa3_odl_ctx->adpl_mmap_buf);
+	ipa3_odl_ctx->adpl_mmap_buf = NULL;
+	mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
 	mutex_unlock(&ipa3_odl_ctx->pipe_lock);
 
 	return ret;
@@ -522,6 +591,8 @@ void ipa3_odl_pipe_cleanup(bool is_ssr)
 	atomic_set(&ipa3_odl_ctx->stats.numer_in_queue, 0);
 	ipa3_odl_ctx->stats.odl_rx_pkt = 0;
 	ipa3_odl_ctx->stats.odl_tx_diag_pkt = 0;
+	ipa3_odl_ctx->stats.odl_mmap_pkt = 0;
+	ipa3_odl_ctx->stats.odl_mmap_drop_pkt = 0;
 	IPADBG("Wake up odl ctl\n");
 	wake_up_interruptible(&odl_ctl_msg_wq);
 
@@ -618,6 +689,82 @@ static ssize_t ipa_adpl_read(struct file *filp, char __user *buf, size_t count,
 	return ret;
 }
 
+/**
+ * ipa_adpl_mmap() - map the ODL frame ring into user-space
+ * @filp:	[in] file pointer
+ * @vma:	[in] vma covering the whole ring, IPA_ODL_MMAP_SIZE bytes
+ *
+ * The first mapping allocates the ring and from then on every ODL frame
+ * is copied directly into it; read() keeps returning only the frames that
+ * were queued before. User-space waits with poll() and returns slots by
+ * advancing cons_idx in the control page.
+ *
+ * Returns:	0 on success, negative on failure
+ */
+static int ipa_adpl_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct ipa_odl_mmap_ctrl *ctrl;
+	void *buf;
+	int ret;
+
+	if (vma->vm_pgoff ||
+		vma->vm_end - vma->vm_start != IPA_ODL_MMAP_SIZE) {
+		IPAERR("invalid adpl mmap size %lu\n",
+			vma->vm_end - vma->vm_start);
+		return -EINVAL;
+	}
+
+	mutex_lock(&ipa3_odl_ctx->adpl_msg_lock);
+	buf = ipa3_odl_ctx->adpl_mmap_buf;
+	if (buf) {
+		ret = remap_vmalloc_range(vma, buf, 0);
+		goto unlock;
+	}
+
+	buf = vmalloc_user(IPA_ODL_MMAP_SIZE);
+	if (!buf) {
+		ret = -ENOMEM;
+		goto unlock;
+	}
+
+	ctrl = buf;
+	ctrl->version = IPA_ODL_MMAP_VERSION;
+	ctrl->slot_size = IPA_ODL_MMAP_SLOT_SZ;
+	ctrl->num_slots = IPA_ODL_MMAP_NUM_SLOTS;
+	ctrl->data_offset = PAGE_SIZE;
+
+	ret = remap_vmalloc_range(vma, buf, 0);
+	if (ret) {
+		vfree(buf);
+		goto unlock;
+	}
+
+	ipa3_odl_ctx->adpl_mmap_prod = 0;
+	ipa3_odl_ctx->adpl_mmap_buf = buf;
+	IPADBG("adpl mmap ring of %u slots ready\n", IPA_ODL_MMAP_NUM_SLOTS);
+unlock:
+	mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
+	return ret;
+}
+
+static unsigned int ipa_adpl_poll(struct file *filp, poll_table *wait)
+{
+	struct ipa_odl_mmap_ctrl *ctrl;
+	unsigned int mask = 0;
+
+	poll_wait(filp, &ipa3_odl_ctx->adpl_msg_waitq, wait);
+
+	mutex_lock(&ipa3_odl_ctx->adpl_msg_lock);
+	ctrl = ipa3_odl_ctx->adpl_mmap_buf;
+	if (!list_empty(&ipa3_odl_ctx->adpl_msg_list) ||
+		(ctrl && READ_ONCE(ctrl->cons_idx) !=
+			ipa3_odl_ctx->adpl_mmap_prod))
+		mask |= POLLIN | POLLRDNORM;
+	mutex_unlock(&ipa3_odl_ctx->adpl_msg_lock);
+
+	return mask;
+}
+
 static long ipa_adpl_ioctl(struct file *filp,
 	unsigned int cmd, unsigned long arg)
 {
@@ -670,6 +817,8 @@ static const struct file_operations ipa_adpl_fops = {
 	.release = ipa_adpl_release,
 	.read = ipa_adpl_read,
 	.unlocked_ioctl = ipa_adpl_ioctl,
+	.mmap = ipa_adpl_mmap,
+	.poll = ipa_adpl_poll,
 };
 
 int ipa_odl_init(void)
@@ -13,11 +13,58 @@
 #define ODL_EP_TYPE_HSUSB 2
 #define ODL_EP_PERIPHERAL_IFACE_ID 3
 
+/*
+ * mmap ring of /dev/ipa_adpl: one control page followed by
+ * IPA_ODL_MMAP_NUM_SLOTS slots, each holding one aggregated ODL frame
+ * behind a struct ipa_odl_mmap_slot header.
+ */
+#define IPA_ODL_MMAP_VERSION 1
+#define IPA_ODL_MMAP_SLOT_SZ (16 * 1024)
+#define IPA_ODL_MMAP_NUM_SLOTS 256
+#define IPA_ODL_MMAP_SIZE (PAGE_SIZE + \
+	IPA_ODL_MMAP_NUM_SLOTS * IPA_ODL_MMAP_SLOT_SZ)
+
 struct ipa3_odlstats {
 	u32 odl_rx_pkt;
 	u32 odl_tx_diag_pkt;
 	u32 odl_drop_pkt;
 	atomic_t numer_in_queue;
+	u32 odl_mmap_pkt;
+	u32 odl_mmap_drop_pkt;
+};
+
+/**
+ * struct ipa_odl_mmap_ctrl - control page at the start of the mmap ring
+ * @version: layout version, IPA_ODL_MMAP_VERSION
+ * @slot_size: size of one slot in bytes, header included
+ * @num_slots: number of slots in the ring
+ * @data_offset: offset of the first slot from the start of the mapping
+ * @prod_idx: free running count of slots filled, written by the driver
+ * @cons_idx: free running count of slots consumed, written by user-space
+ * @drop_cnt: frames dropped because the ring was full or frame too big
+ *
+ * User-space consumes slot (cons_idx % num_slots) while cons_idx differs
+ * from prod_idx, then advances cons_idx to hand the slot back.
+ */
+struct ipa_odl_mmap_ctrl {
+	u32 version;
+	u32 slot_size;
+	u32 num_slots;
+	u32 data_offset;
+	u32 prod_idx;
+	u32 cons_idx;
+	u32 drop_cnt;
+};
+
+/**
+ * struct ipa_odl_mmap_slot - header of every slot in the mmap ring
+ * @len: length of the frame following the header
+ * @seq: value of prod_idx when the slot was filled
+ */
+struct ipa_odl_mmap_slot {
+	u32 len;
+	u32 seq;
+	u8 data[];
 };
 
 struct odl_state_bit_mask {
@@ -59,6 +106,8 @@ struct ipa_odl_context {
 	struct ipa3_odlstats stats;
 	u32 odl_pm_hdl;
 	wait_queue_head_t adpl_msg_waitq;
+	void *adpl_mmap_buf;
+	u32 adpl_mmap_prod;
 };
 
 struct ipa3_push_msg_odl {
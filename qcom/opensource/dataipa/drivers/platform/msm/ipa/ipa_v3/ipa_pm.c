@@ -74,6 +74,14 @@ struct ipa_pm_exception_list {
  * @cur_vote: idx of the threshold
  * @default_threshold: the thresholds used if no exception passes
  * @current_threshold: the current threshold of the clock plan
+ * @down_work: re-evaluates the vote once a held scale down expires
+ * @tput_ewma: moving average of the aggregated tput, for the prediction
+ * @last_up_jiffies: last time the tput required the current vote
+ * @num_votes: number of clock plan changes
+ * @num_predicted_up: scale ups done before the threshold was crossed
+ * @num_held_down: scale downs postponed by the hysteresis
+ * @last_ramp_us: time the last scale up took to be applied
+ * @max_ramp_us: longest time a scale up took to be applied
  */
 struct clk_scaling_db {
 	spinlock_t lock;
@@ -85,8 +93,24 @@ struct clk_scaling_db {
 	int cur_vote;
 	int default_threshold[IPA_PM_THRESHOLD_MAX];
 	int *current_threshold;
+	struct delayed_work down_work;
+	int tput_ewma;
+	unsigned long last_up_jiffies;
+	u32 num_votes;
+	u32 num_predicted_up;
+	u32 num_held_down;
+	u32 last_ramp_us;
+	u32 max_ramp_us;
 };
 
+/*
+ * Predictive clock scaling: the vote is taken for the tput the clients are
+ * heading to (current tput plus its rise over the moving average) and is
+ * only lowered once the tput did not need it for IPA_PM_SCALE_DOWN_HOLD_MS.
+ */
+#define IPA_PM_TPUT_EWMA_SHIFT 2
+#define IPA_PM_SCALE_DOWN_HOLD_MS 200
+
 /*
  * ipa_pm state names
  *
@@ -347,6 +371,62 @@ static void set_current_threshold(void)
 	spin_unlock_irqrestore(&ipa_pm_ctx->clk_scaling.lock, flags);
 }
 
+static int tput_to_th_idx(struct clk_scaling_db *clk_scaling, int tput)
+{
+	int i, th_idx = 1;
+
+	for (i = 0; i < clk_scaling->threshold_size; i++) {
+		if (tput >= clk_scaling->current_threshold[i])
+			th_idx++;
+	}
+
+	return th_idx;
+}
+
+/**
+ * predict_th_idx() - pick the vote for the tput the clients are heading to
+ * @clk_scaling: clock scaling database
+ * @tput: the aggregated tput just calculated
+ * @new_th_idx: [in] the vote for @tput, [out] the vote to apply
+ *
+ * Must be called with client_mutex held.
+ */
+static void predict_th_idx(struct clk_scaling_db *clk_scaling, int tput,
+	int *new_th_idx)
+{
+	int rise, pred_idx;
+
+	rise = tput - clk_scaling->tput_ewma;
+	clk_scaling->tput_ewma += rise >> IPA_PM_TPUT_EWMA_SHIFT;
+
+	if (!ipa3_ctx->pm_predictive_scaling)
+		return;
+
+	/* rising tput: vote for where it will be, not where it is */
+	if (rise > 0) {
+		pred_idx = tput_to_th_idx(clk_scaling, tput + rise);
+		if (pred_idx > *new_th_idx) {
+			clk_scaling->num_predicted_up++;
+			*new_th_idx = pred_idx;
+		}
+	}
+
+	if (*new_th_idx >= clk_scaling->cur_vote) {
+		clk_scaling->last_up_jiffies = jiffies;
+		return;
+	}
+
+	/* hold the higher vote for a while, bursts tend to come back */
+	if (time_before(jiffies, clk_scaling->last_up_jiffies +
+		msecs_to_jiffies(IPA_PM_SCALE_DOWN_HOLD_MS))) {
+		clk_scaling->num_held_down++;
+		*new_th_idx = clk_scaling->cur_vote;
+		queue_delayed_work(ipa_pm_ctx->wq, &clk_scaling->down_work,
+			clk_scaling->last_up_jiffies +
+			msecs_to_jiffies(IPA_PM_SCALE_DOWN_HOLD_MS) - jiffies);
+	}
+}
+
 /**
  * do_clk_scaling() - set the clock based on the activated clients
  *
@@ -354,8 +434,10 @@ static void set_current_threshold(void)
  */
 static int do_clk_scaling(void)
 {
-	int i, tput;
-	int new_th_idx = 1;
+	int tput;
+	int new_th_idx;
+	ktime_t start;
+	u32 ramp_us;
 	struct clk_scaling_db *clk_scaling;
 
 	if (atomic_read(&ipa3_ctx->ipa_clk_vote) == 0) {
@@ -371,19 +453,27 @@ static int do_clk_scaling(void)
 	ipa_pm_ctx->aggregated_tput = tput;
 	set_current_threshold();
 
-	mutex_unlock(&ipa_pm_ctx->client_mutex);
+	new_th_idx = tput_to_th_idx(clk_scaling, tput);
+	predict_th_idx(clk_scaling, tput, &new_th_idx);
 
-	for (i = 0; i < clk_scaling->threshold_size; i++) {
-		if (tput >= clk_scaling->current_threshold[i])
-			new_th_idx++;
-	}
+	mutex_unlock(&ipa_pm_ctx->client_mutex);
 
 	IPA_PM_DBG_LOW("old idx was at %d\n", ipa_pm_ctx->clk_scaling.cur_vote);
 
 
 	if (ipa_pm_ctx->clk_scaling.cur_vote != new_th_idx) {
+		bool up = new_th_idx > ipa_pm_ctx->clk_scaling.cur_vote;
+
 		ipa_pm_ctx->clk_scaling.cur_vote = new_th_idx;
+		start = ktime_get();
 		ipa3_set_clock_plan_from_pm(ipa_pm_ctx->clk_scaling.cur_vote);
+		clk_scaling->num_votes++;
+		if (up) {
+			ramp_us = ktime_us_delta(ktime_get(), start);
+			clk_scaling->last_ramp_us = ramp_us;
+			clk_scaling->max_ramp_us = max(clk_scaling->max_ramp_us,
+				ramp_us);
+		}
 	}
 
 	IPA_PM_DBG_LOW("new idx is at %d\n", ipa_pm_ctx->clk_scaling.cur_vote);
@@ -663,6 +753,7 @@ int ipa_pm_init(struct ipa_pm_init_params *params)
 	clk_scaling->threshold_size = params->threshold_size;
 	clk_scaling->exception_size = params->exception_size;
 	INIT_WORK(&clk_scaling->work, clock_scaling_func);
+	INIT_DELAYED_WORK(&clk_scaling->down_work, clock_scaling_func);
 
 	for (i = 0; i < params->threshold_size; i++)
 		clk_scaling->default_threshold[i] =
@@ -718,6 +809,7 @@ int ipa_pm_destroy(void)
 		return -EPERM;
 	}
 
+	cancel_delayed_work_sync(&ipa_pm_ctx->clk_scaling.down_work);
 	destroy_workqueue(ipa_pm_ctx->wq);
 
 	kfree(ipa_pm_ctx);
@@ -1385,6 +1477,14 @@ int ipa_pm_stat(char *buf, int size)
 		ipa_pm_ctx->aggregated_tput, clk->cur_vote);
 	cnt += result;
 
+	result = scnprintf(buf + cnt, size - cnt,
+		"\nPredictive scaling: %s, tput avg: %d, votes: %u, predicted up: %u, held down: %u\n"
+		"Ramp up latency (us): last %u max %u",
+		ipa3_ctx->pm_predictive_scaling ? "on" : "off",
+		clk->tput_ewma, clk->num_votes, clk->num_predicted_up,
+		clk->num_held_down, clk->last_ramp_us, clk->max_ramp_us);
+	cnt += result;
+
 	result = scnprintf(buf + cnt, size - cnt, "\n\nRegistered Clients:\n");
 	cnt += result;
 
@@ -571,6 +571,13 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		goto fail_size_valid;
 	}
 
+	if (ipa3_fltrt_img_unchanged(&ipa3_ctx->rt_img_cache[ip],
+		&alloc_params)) {
+		IPADBG_LOW("RT images unchanged, skip commit. IP %d\n", ip);
+		__ipa_reap_sys_rt_tbls(ip);
+		goto fail_size_valid;
+	}
+
 	/* IC to close the coal frame before HPS Clear if coal is enabled */
 	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
 		&& !ipa3_ctx->ulso_wa) {
@@ -732,9 +739,11 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 
 	if (ipa3_send_cmd(num_cmd, desc)) {
 		IPAERR_RL("fail to send immediate command\n");
+		ipa3_fltrt_img_invalidate(&ipa3_ctx->rt_img_cache[ip]);
 		rc = -EFAULT;
 		goto fail_imm_cmd_construct;
 	}
+	ipa3_fltrt_img_save(&ipa3_ctx->rt_img_cache[ip], &alloc_params);
 
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
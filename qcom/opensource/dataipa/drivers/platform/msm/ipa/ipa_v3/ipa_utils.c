@@ -14252,3 +14252,89 @@ error:
 	mutex_unlock(&ipa3_ctx->act_tbl_lock);
 	return res;
 }
+
+static void ipa3_fltrt_img_bufs(struct ipahal_fltrt_alloc_imgs_params *params,
+	struct ipa_mem_buffer *bufs[4])
+{
+	bufs[0] = &params->hash_hdr;
+	bufs[1] = &params->nhash_hdr;
+	bufs[2] = &params->hash_bdy;
+	bufs[3] = &params->nhash_bdy;
+}
+
+/**
+ * ipa3_fltrt_img_unchanged() - Check a generated image against the last commit
+ * @cache: copy of the last committed images
+ * @params: images generated for the new commit
+ *
+ * Tables in DDR are reallocated on every commit, so their addresses in the
+ * headers make the images differ whenever a DDR table is involved. Equal
+ * images therefore mean IPA SRAM already holds the tables being committed.
+ *
+ * Return: true if the commit can be skipped
+ */
+bool ipa3_fltrt_img_unchanged(struct ipa3_fltrt_img_cache *cache,
+	struct ipahal_fltrt_alloc_imgs_params *params)
+{
+	struct ipa_mem_buffer *bufs[4];
+	int i;
+
+	if (!cache->valid)
+		return false;
+
+	ipa3_fltrt_img_bufs(params, bufs);
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		if (cache->size[i] != bufs[i]->size)
+			return false;
+		if (bufs[i]->size &&
+			memcmp(cache->base[i], bufs[i]->base, bufs[i]->size))
+			return false;
+	}
+
+	cache->num_skip++;
+	return true;
+}
+
+/**
+ * ipa3_fltrt_img_save() - Keep a copy of the images that were committed
+ * @cache: copy of the last committed images
+ * @params: images that were just committed
+ */
+void ipa3_fltrt_img_save(struct ipa3_fltrt_img_cache *cache,
+	struct ipahal_fltrt_alloc_imgs_params *params)
+{
+	struct ipa_mem_buffer *bufs[4];
+	int i;
+
+	cache->num_commit++;
+	cache->valid = false;
+
+	ipa3_fltrt_img_bufs(params, bufs);
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		if (cache->size[i] != bufs[i]->size) {
+			kfree(cache->base[i]);
+			cache->base[i] = NULL;
+			cache->size[i] = 0;
+			if (bufs[i]->size) {
+				cache->base[i] = kmalloc(bufs[i]->size,
+					GFP_KERNEL);
+				if (!cache->base[i])
+					return;
+			}
+			cache->size[i] = bufs[i]->size;
+		}
+		if (bufs[i]->size)
+			memcpy(cache->base[i], bufs[i]->base, bufs[i]->size);
+	}
+
+	cache->valid = true;
+}
+
+/**
+ * ipa3_fltrt_img_invalidate() - Force the next commit to rewrite the tables
+ * @cache: copy of the last committed images
+ */
+void ipa3_fltrt_img_invalidate(struct ipa3_fltrt_img_cache *cache)
+{
+	cache->valid = false;
+}
@@ -314,6 +314,11 @@ int ipa_nati_get_sram_size(
 int ipa_nati_clear_ipv4_tbl(
 	uint32_t tbl_hdl );
 
+int ipa_nati_get_expn_fill(
+	uint32_t  tbl_hdl,
+	uint16_t* used_ptr,
+	uint16_t* total_ptr );
+
 int ipa_nati_copy_ipv4_tbl(
 	uint32_t          src_tbl_hdl,
 	uint32_t          dst_tbl_hdl,
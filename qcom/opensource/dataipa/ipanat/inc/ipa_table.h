@@ -170,6 +170,12 @@ typedef struct
 	uint16_t                   cur_tbl_cnt;
 	uint16_t                   cur_expn_tbl_cnt;
 
+	/*
+	 * Absolute index at which the search for a free expansion slot
+	 * starts. Only a hint: the slot is checked before it is used.
+	 */
+	uint16_t                   expn_free_hint;
+
 	ipa_table_entry_interface* entry_interface;
 
 	ipa_table_dma_cmd_helper*  dma_help[HELP_UPDATE_MAX];
@@ -2272,6 +2272,69 @@ bail:
 	return ret;
 }
 
+/*
+ * Report how many expansion slots of the NAT table are in use. Cheap
+ * enough to be called on every rule add, unlike ipa_NATI_ipv4_tbl_stats()
+ * which walks the table.
+ */
+int ipa_nati_get_expn_fill(
+	uint32_t  tbl_hdl,
+	uint16_t* used_ptr,
+	uint16_t* total_ptr )
+{
+	enum ipa3_nat_mem_in            nmi;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+	int ret = 0;
+
+	IPADBG("In\n");
+
+	if ( ! used_ptr || ! total_ptr ) {
+		IPAERR("Bad arg: used_ptr(%p) and/or total_ptr(%p)\n",
+			   used_ptr, total_ptr);
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) ) {
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	if (pthread_mutex_lock(&nat_mutex)) {
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	if ( ! nat_cache_ptr->table_cnt ) {
+		IPAERR("No initialized table in NAT cache\n");
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	nat_table = &nat_cache_ptr->ip4_tbl[tbl_hdl - 1];
+
+	*used_ptr  = nat_table->table.cur_expn_tbl_cnt;
+	*total_ptr = nat_table->table.expn_table_entries;
+
+unlock:
+	if (pthread_mutex_unlock(&nat_mutex)) {
+		IPAERR("unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 int ipa_nati_copy_ipv4_tbl(
 	uint32_t          src_tbl_hdl,
 	uint32_t          dst_tbl_hdl,
@@ -27,13 +27,20 @@
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <map>
+#include <unordered_map>
 #include <iterator>
 
 #include "ipa_nat_utils.h"
 
 #include "ipa_nat_map.h"
 
-static std::map<uint32_t, uint32_t> map_array[MAP_NUM_MAX];
+/*
+ * The maps are hit on every rule add and delete in hybrid mode, but are
+ * only walked in order when dumped, so keep them hashed...
+ */
+typedef std::unordered_map<uint32_t, uint32_t> ipa_nat_hash_map;
+
+static ipa_nat_hash_map map_array[MAP_NUM_MAX];
 
 /******************************************************************************/
 
@@ -44,7 +51,7 @@ int ipa_nat_map_add(
 {
 	int ret_val = 0;
 
-	std::pair<std::map<uint32_t, uint32_t>::iterator, bool> ret;
+	std::pair<ipa_nat_hash_map::iterator, bool> ret;
 
 	IPADBG("In\n");
 
@@ -83,7 +90,7 @@ int ipa_nat_map_find(
 {
 	int ret_val = 0;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	ipa_nat_hash_map::iterator it;
 
 	IPADBG("In\n");
 
@@ -132,7 +139,7 @@ int ipa_nat_map_del(
 {
 	int ret_val = 0;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	ipa_nat_hash_map::iterator it;
 
 	IPADBG("In\n");
 
@@ -198,6 +205,7 @@ bail:
 int ipa_nat_map_dump(
 	ipa_which_map which )
 {
+	std::map<uint32_t, uint32_t> sorted;
 	std::map<uint32_t, uint32_t>::iterator it;
 
 	int ret_val = 0;
@@ -213,8 +221,13 @@ int ipa_nat_map_dump(
 
 	printf("Dumping: %s\n", ipa_which_map_as_str(which));
 
-	for ( it  = map_array[which].begin();
-		  it != map_array[which].end();
+	/*
+	 * Dump in key order, as before the maps were hashed...
+	 */
+	sorted.insert(map_array[which].begin(), map_array[which].end());
+
+	for ( it  = sorted.begin();
+		  it != sorted.end();
 		  it++ )
 	{
 		printf("  Key[%u|0x%08X] -> Value[%u|0x%08X]\n",
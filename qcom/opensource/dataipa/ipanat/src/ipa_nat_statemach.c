@@ -74,6 +74,15 @@
 #define PRCNT_OF(v) \
 	((.25) * (v))
 
+/*
+ * Once this share of the SRAM expansion table is in use, the chains
+ * are long enough that the (larger) DDR table is the better place for
+ * the rules, even though SRAM is not full yet.
+ */
+#undef EXPN_SWITCH_PRCNT_OF
+#define EXPN_SWITCH_PRCNT_OF(v) \
+	((.75) * (v))
+
 #undef  CHOOSE_MEM_SUB
 #define CHOOSE_MEM_SUB() \
 	(nati_obj.curr_state == NATI_STATE_HYBRID) ? \
@@ -1702,6 +1711,8 @@ static int _smAddRuleHybrid(
 
 	uint32_t orig2new_map, new2orig_map;
 
+	uint16_t expn_used, expn_total;
+
 	int ret;
 
 	IPADBG("In\n");
@@ -1739,6 +1750,31 @@ static int _smAddRuleHybrid(
 		{
 			ret = ipa_nat_map_add(new2orig_map, *rule_hdl, *rule_hdl);
 		}
+
+		if ( ret == 0
+			 &&
+			 nati_obj_ptr->curr_state == NATI_STATE_HYBRID
+			 &&
+			 ! nati_obj_ptr->hold_state
+			 &&
+			 ipa_nati_get_expn_fill(tbl_hdl, &expn_used, &expn_total) == 0
+			 &&
+			 expn_used > EXPN_SWITCH_PRCNT_OF(expn_total) )
+		{
+			/*
+			 * The rule made it into SRAM, but the expansion chains
+			 * are getting long and lookups slow down with them.
+			 * Move everything, including this rule, to DDR now
+			 * rather than waiting for SRAM to fill up...
+			 */
+			IPAINFO("SRAM expansion table at (%u/%u)...attempting table switch\n",
+					expn_used, expn_total);
+
+			if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0) == 0 )
+			{
+				SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID_DDR);
+			}
+		}
 	}
 	else
 	{
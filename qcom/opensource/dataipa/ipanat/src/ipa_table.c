@@ -405,6 +405,11 @@ void ipa_table_erase_entry(
 	else
 	{
 		--table->cur_expn_tbl_cnt;
+
+		/*
+		 * The slot just freed is the cheapest one to hand out next...
+		 */
+		table->expn_free_hint = index;
 	}
 
 	IPADBG("Out\n");
@@ -999,6 +1004,7 @@ static int FindExpnTblFreeEntry(
 	void**     free_entry,
 	uint16_t*  entry_index )
 {
+	uint16_t start_index;
 	int ret;
 
 	IPADBG("In\n");
@@ -1016,15 +1022,43 @@ static int FindExpnTblFreeEntry(
 	*free_entry  = NULL;
 
 	/*
-	 * The following will start walk at expansion slots
-	 * (ie. just after table->table_entries)...
+	 * No need to walk the whole expansion table to find out it's
+	 * full...
 	 */
-	ret = ipa_table_walk(table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
+	ret = 0;
+
+	if ( table->cur_expn_tbl_cnt < table->expn_table_entries )
+	{
+		start_index = table->expn_free_hint;
+
+		if ( start_index <  table->table_entries ||
+			 start_index >= table->tot_tbl_ents )
+		{
+			start_index = table->table_entries;
+		}
+
+		/*
+		 * Start the walk where we last allocated or freed a slot,
+		 * rather than at the first expansion slot (ie. just after
+		 * table->table_entries), so that a table filling up doesn't
+		 * rescan all the used slots on every add. If nothing is free
+		 * past the hint, go around once from the beginning...
+		 */
+		ret = ipa_table_walk(table, start_index, WHEN_SLOT_EMPTY, mt_slot, 0);
+
+		if ( ret == 0 && start_index != table->table_entries )
+		{
+			ret = ipa_table_walk(
+				table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
+		}
+	}
 
 	if ( ret > 0 )
 	{
 		*entry_index = (uint16_t) ret;
 
+		table->expn_free_hint = *entry_index + 1;
+
 		*free_entry = GOTO_REC(table, *entry_index);
 
 		IPADBG("%s: entry_index val (%u) free_entry val (%p)\n",
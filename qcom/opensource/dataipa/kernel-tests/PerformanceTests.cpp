@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2023 The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *  * Neither the name of The Linux Foundation nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include <vector>
+#include <algorithm>
+
+#include "PipeTestFixture.h"
+#include "Constants.h"
+#include "TestsUtils.h"
+#include "linux/msm_ipa.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+#define PERF_TEST_DEFAULT_PACKETS 20000
+#define PERF_TEST_MAX_WINDOW 32
+
+static uint64_t NowNs()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*Count the CPU cycles this process spends, in user and kernel mode
+ *(most of the per packet cost is in the driver). Falls back to user
+ *mode only when the kernel doesn't allow profiling it, and returns -1
+ *when the PMU can't be used at all.
+ */
+static int OpenCycleCounter()
+{
+	struct perf_event_attr attr;
+	int fd;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CPU_CYCLES;
+	attr.disabled = 1;
+	attr.exclude_hv = 1;
+
+	fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	if (fd < 0) {
+		attr.exclude_kernel = 1;
+		fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		if (fd >= 0)
+			LOG_MSG_INFO("Kernel cycles can't be counted, reporting user cycles only\n");
+	}
+
+	return fd;
+}
+
+/*This class is the base of the Pipe benchmarks. They are not pass/fail tests
+ *of the data path but measure it: packets are looped through the DMA test
+ *pipes with at most m_nWindow packets in flight and the throughput, CPU
+ *cycles per packet and round trip latency percentiles are reported.
+ *Packets are still checked on the way back so that a broken data path
+ *doesn't show up as a fast one.
+ *The number of packets can be changed with the IPA_PERF_TEST_PACKETS
+ *environment variable.
+ */
+class PipePerformanceTest: public PipeTestFixture {
+public:
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	PipePerformanceTest(size_t nPacketSize, int nWindow) :
+		m_nPacketSize(nPacketSize),
+		m_nWindow(nWindow) {
+		char name[64];
+
+		snprintf(name, sizeof(name), "PipePerformanceTest%zuB_W%d",
+			 nPacketSize, nWindow);
+		m_name = name;
+		m_description = "Measure throughput, CPU cycles per packet and latency "
+				"of the DMA test pipes";
+		m_testSuiteName.push_back("Performance");
+		m_runInRegression = false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+	bool Run() {
+		const char *pEnv = getenv("IPA_PERF_TEST_PACKETS");
+		int nPackets = pEnv ? atoi(pEnv) : PERF_TEST_DEFAULT_PACKETS;
+		std::vector<Byte> send(m_nPacketSize * m_nWindow);
+		std::vector<Byte> receive(m_nPacketSize);
+		std::vector<uint64_t> latency;
+		uint64_t sendTime[PERF_TEST_MAX_WINDOW];
+		uint64_t start, elapsed;
+		long long cycles = 0;
+		int nCycleFd;
+		int nSent = 0;
+
+		if (nPackets <= 0 || m_nWindow <= 0 || m_nWindow > PERF_TEST_MAX_WINDOW) {
+			LOG_MSG_ERROR("Bad packets(%d)/window(%d)\n", nPackets, m_nWindow);
+			return false;
+		}
+
+		latency.reserve(nPackets);
+
+		srand(123);
+		for (size_t i = 0; i < send.size(); i++)
+			send[i] = rand() % 0x100;
+
+		nCycleFd = OpenCycleCounter();
+		if (nCycleFd >= 0) {
+			ioctl(nCycleFd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(nCycleFd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+
+		start = NowNs();
+
+		while (nSent < nPackets) {
+			int nBurst = std::min(m_nWindow, nPackets - nSent);
+
+			//Fill the window, then drain it
+			for (int i = 0; i < nBurst; i++) {
+				sendTime[i] = NowNs();
+				if ((int)m_nPacketSize != m_UsbToIpaPipe.Send(
+						&send[i * m_nPacketSize], m_nPacketSize)) {
+					LOG_MSG_ERROR("Send failed after %d packets\n", nSent + i);
+					goto fail;
+				}
+			}
+
+			for (int i = 0; i < nBurst; i++) {
+				if ((int)m_nPacketSize != m_IpaToUsbPipe.Receive(
+						&receive[0], m_nPacketSize)) {
+					LOG_MSG_ERROR("Receive failed after %d packets\n", nSent + i);
+					goto fail;
+				}
+				latency.push_back(NowNs() - sendTime[i]);
+
+				if (memcmp(&receive[0], &send[i * m_nPacketSize], m_nPacketSize)) {
+					LOG_MSG_ERROR("Packet %d came back corrupted\n", nSent + i);
+					goto fail;
+				}
+			}
+
+			nSent += nBurst;
+		}
+
+		elapsed = NowNs() - start;
+
+		if (nCycleFd >= 0) {
+			ioctl(nCycleFd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(nCycleFd, &cycles, sizeof(cycles)) != sizeof(cycles))
+				cycles = 0;
+			close(nCycleFd);
+		}
+
+		Report(nSent, elapsed, cycles, latency);
+		return true;
+
+	fail:
+		if (nCycleFd >= 0)
+			close(nCycleFd);
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////
+
+private:
+	void Report(int nPackets, uint64_t nElapsedNs, long long nCycles,
+		    std::vector<uint64_t> &latency) {
+		double seconds = nElapsedNs / 1e9;
+
+		std::sort(latency.begin(), latency.end());
+
+		printf("%s: %d packets of %zu bytes, window %d\n",
+		       m_name.c_str(), nPackets, m_nPacketSize, m_nWindow);
+		printf("  throughput: %.3f Mpps, %.1f Mbps\n",
+		       nPackets / seconds / 1e6,
+		       nPackets * m_nPacketSize * 8 / seconds / 1e6);
+		if (nCycles > 0)
+			printf("  cpu: %.0f cycles/packet\n", (double)nCycles / nPackets);
+		else
+			printf("  cpu: cycle counter not available\n");
+		printf("  latency (us): p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f\n",
+		       Percentile(latency, 50.0) / 1e3,
+		       Percentile(latency, 90.0) / 1e3,
+		       Percentile(latency, 99.0) / 1e3,
+		       Percentile(latency, 99.9) / 1e3,
+		       latency.back() / 1e3);
+	}
+
+	static double Percentile(const std::vector<uint64_t> &sorted, double p) {
+		size_t idx = (size_t)(p / 100.0 * (sorted.size() - 1));
+
+		return sorted[idx];
+	}
+
+	size_t m_nPacketSize;
+	int m_nWindow;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+//Those tests should be run with configuration number 1 which has one input pipe and
+//one output pipe.
+//Window 1 gives the unloaded round trip latency, the larger windows keep the
+//pipes busy and give the sustained rates.
+static PipePerformanceTest pipePerformanceTest64B_W1(64, 1);
+static PipePerformanceTest pipePerformanceTest64B_W32(64, PERF_TEST_MAX_WINDOW);
+static PipePerformanceTest pipePerformanceTest512B_W32(512, PERF_TEST_MAX_WINDOW);
+static PipePerformanceTest pipePerformanceTest1500B_W1(1500, 1);
+static PipePerformanceTest pipePerformanceTest1500B_W32(1500, PERF_TEST_MAX_WINDOW);
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                  EOF                                      ////
+/////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 #include <linux/moduleparam.h>
 #include <linux/ip.h>
 #include <linux/ipv6.h>
+#include <linux/rculist.h>
 
 #define NLMSG_FLOW_ACTIVATE 1
 #define NLMSG_FLOW_DEACTIVATE 2
@@ -174,7 +175,8 @@ qmi_rmnet_get_flow_map(struct qos_info *qos, u32 flow_id, int ip_type)
 	if (!qos)
 		return NULL;
 
-	list_for_each_entry(itm, &qos->flow_head, list) {
+	/* Called with either qos_lock or the RCU read lock held */
+	list_for_each_entry_rcu(itm, &qos->flow_head, list) {
 		if ((itm->flow_id == flow_id) && (itm->ip_type == ip_type))
 			return itm;
 	}
@@ -202,7 +204,7 @@ static void qmi_rmnet_update_flow_map(struct rmnet_flow_map *itm,
 	itm->bearer_id = new_map->bearer_id;
 	itm->flow_id = new_map->flow_id;
 	itm->ip_type = new_map->ip_type;
-	itm->mq_idx = new_map->mq_idx;
+	WRITE_ONCE(itm->mq_idx, new_map->mq_idx);
 }
 
 int qmi_rmnet_flow_control(struct net_device *dev, u32 mq_idx, int enable)
@@ -302,6 +304,8 @@ void qmi_rmnet_watchdog_remove(struct rmnet_bearer_map *bearer)
 static void qmi_rmnet_bearer_clean(struct qos_info *qos)
 {
 	if (qos->removed_bearer) {
+		/* Queue selection may still be looking at the bearer */
+		synchronize_rcu();
 		qos->removed_bearer->watchdog_quit = true;
 		del_timer_sync(&qos->removed_bearer->watchdog);
 		qos->removed_bearer->ch_switch.timer_quit = true;
@@ -423,7 +427,7 @@ static int __qmi_rmnet_rebind_flow(struct net_device *dev,
 		return -ENOMEM;
 
 	qmi_rmnet_update_flow_map(itm, new_map);
-	itm->bearer = bearer;
+	WRITE_ONCE(itm->bearer, bearer);
 
 	__qmi_rmnet_update_mq(dev, qos_info, bearer, itm);
 
@@ -487,7 +491,7 @@ again:
 	}
 
 	qmi_rmnet_update_flow_map(itm, &new_map);
-	list_add(&itm->list, &qos_info->flow_head);
+	list_add_rcu(&itm->list, &qos_info->flow_head);
 
 	/* Create or update bearer map */
 	bearer = __qmi_rmnet_bearer_get(qos_info, new_map.bearer_id);
@@ -496,7 +500,7 @@ again:
 		goto done;
 	}
 
-	itm->bearer = bearer;
+	WRITE_ONCE(itm->bearer, bearer);
 
 	__qmi_rmnet_update_mq(dev, qos_info, bearer, itm);
 
@@ -540,8 +544,8 @@ qmi_rmnet_del_flow(struct net_device *dev, struct tcmsg *tcm,
 		__qmi_rmnet_bearer_put(dev, qos_info, itm->bearer, true);
 
 		/* Remove from flow map */
-		list_del(&itm->list);
-		kfree(itm);
+		list_del_rcu(&itm->list);
+		kfree_rcu(itm, rcu);
 	}
 
 	if (list_empty(&qos_info->flow_head))
@@ -1016,6 +1020,7 @@ static inline bool qmi_rmnet_is_tcp_ack(struct sk_buff *skb)
 
 static int qmi_rmnet_get_queue_sa(struct qos_info *qos, struct sk_buff *skb)
 {
+	struct rmnet_bearer_map *bearer;
 	struct rmnet_flow_map *itm;
 	int ip_type;
 	int txq = DEFAULT_MQ_NUM;
@@ -1030,20 +1035,24 @@ static int qmi_rmnet_get_queue_sa(struct qos_info *qos, struct sk_buff *skb)
 
 	ip_type = (skb->protocol == htons(ETH_P_IPV6)) ? AF_INET6 : AF_INET;
 
-	spin_lock_bh(&qos->qos_lock);
+	/* Flow maps are RCU protected and removed bearers are only freed
+	 * after a grace period, so no need for qos_lock on this hot path.
+	 */
+	rcu_read_lock();
 
 	itm = qmi_rmnet_get_flow_map(qos, skb->mark, ip_type);
 	if (unlikely(!itm))
 		goto done;
 
 	/* Put the packet in the assigned mq except TCP ack */
-	if (likely(itm->bearer) && qmi_rmnet_is_tcp_ack(skb))
-		txq = itm->bearer->ack_mq_idx;
+	bearer = READ_ONCE(itm->bearer);
+	if (likely(bearer) && qmi_rmnet_is_tcp_ack(skb))
+		txq = READ_ONCE(bearer->ack_mq_idx);
 	else
-		txq = itm->mq_idx;
+		txq = READ_ONCE(itm->mq_idx);
 
 done:
-	spin_unlock_bh(&qos->qos_lock);
+	rcu_read_unlock();
 	return txq;
 }
 
@@ -1062,13 +1071,13 @@ int qmi_rmnet_get_queue(struct net_device *dev, struct sk_buff *skb)
 
 	ip_type = (skb->protocol == htons(ETH_P_IPV6)) ? AF_INET6 : AF_INET;
 
-	spin_lock_bh(&qos->qos_lock);
+	rcu_read_lock();
 
 	itm = qmi_rmnet_get_flow_map(qos, mark, ip_type);
 	if (itm)
-		txq = itm->mq_idx;
+		txq = READ_ONCE(itm->mq_idx);
 
-	spin_unlock_bh(&qos->qos_lock);
+	rcu_read_unlock();
 
 	return txq;
 }
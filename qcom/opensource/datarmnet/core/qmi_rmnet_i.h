@@ -105,6 +105,7 @@ struct rmnet_flow_map {
 	int ip_type;
 	u32 mq_idx;
 	struct rmnet_bearer_map *bearer;
+	struct rcu_head rcu;
 };
 
 struct svc_info {
@@ -57,6 +57,8 @@ struct rmnet_endpoint {
 struct rmnet_agg_stats {
 	u64 ul_agg_reuse;
 	u64 ul_agg_alloc;
+	u64 ul_agg_sg_frags;
+	u64 ul_agg_ack_flush;
 };
 
 struct rmnet_port_priv_stats {
@@ -104,6 +106,8 @@ struct rmnet_aggregation_state {
 	int agg_state;
 	u8 agg_count;
 	u8 agg_size_order;
+	u32 agg_sg_off;
+	u64 agg_gap_ewma;
 	struct list_head agg_list;
 	struct rmnet_agg_page *agg_head;
 	struct rmnet_agg_stats *stats;
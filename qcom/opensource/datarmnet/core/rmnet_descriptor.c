@@ -19,6 +19,7 @@
 #include <linux/inet.h>
 #include <net/ipv6.h>
 #include <net/ip6_checksum.h>
+#include <net/busy_poll.h>
 #include "rmnet_config.h"
 #include "rmnet_descriptor.h"
 #include "rmnet_handlers.h"
@@ -51,6 +52,40 @@ typedef void (*rmnet_perf_tether_ingress_hook_t)(struct tcphdr *tp, struct sk_bu
 rmnet_perf_tether_ingress_hook_t rmnet_perf_tether_ingress_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_ingress_hook);
 
+static struct rmnet_fragment *
+rmnet_frag_alloc(struct rmnet_frag_descriptor *frag_desc)
+{
+	struct rmnet_fragment *frag;
+	int i;
+
+	for (i = 0; i < RMNET_FRAG_DESC_INLINE_FRAGS; i++) {
+		if (frag_desc->inline_frags_used & BIT(i))
+			continue;
+
+		frag_desc->inline_frags_used |= BIT(i);
+		frag = &frag_desc->inline_frags[i];
+		memset(frag, 0, sizeof(*frag));
+		return frag;
+	}
+
+	return kzalloc(sizeof(*frag), GFP_ATOMIC);
+}
+
+static void rmnet_frag_free(struct rmnet_frag_descriptor *frag_desc,
+			    struct rmnet_fragment *frag)
+{
+	int i;
+
+	for (i = 0; i < RMNET_FRAG_DESC_INLINE_FRAGS; i++) {
+		if (frag == &frag_desc->inline_frags[i]) {
+			frag_desc->inline_frags_used &= ~BIT(i);
+			return;
+		}
+	}
+
+	kfree(frag);
+}
+
 struct rmnet_frag_descriptor *
 rmnet_get_frag_descriptor(struct rmnet_port *port)
 {
@@ -96,7 +131,7 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 			put_page(page);
 
 		list_del(&frag->list);
-		kfree(frag);
+		rmnet_frag_free(frag_desc, frag);
 	}
 
 	memset(frag_desc, 0, sizeof(*frag_desc));
@@ -136,7 +171,7 @@ void *rmnet_frag_pull(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			size -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -186,7 +221,7 @@ void *rmnet_frag_trim(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			eat -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag_desc, frag);
 			continue;
 		}
 
@@ -280,7 +315,7 @@ int rmnet_frag_descriptor_add_frag(struct rmnet_frag_descriptor *frag_desc,
 {
 	struct rmnet_fragment *frag;
 
-	frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+	frag = rmnet_frag_alloc(frag_desc);
 	if (!frag)
 		return -ENOMEM;
 
@@ -638,6 +673,9 @@ static int rmnet_frag_deaggregate_one(struct sk_buff *skb,
 		return -1;
 
 	frag_desc->priority = priority;
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	frag_desc->napi_id = skb->napi_id;
+#endif
 	pkt_len += sizeof(*maph);
 	if (port->data_format & RMNET_FLAGS_INGRESS_MAP_CKSUMV4) {
 		pkt_len += sizeof(struct rmnet_map_dl_csum_trailer);
@@ -1023,6 +1061,12 @@ skip_frags:
 	/* Propagate original priority value */
 	head_skb->priority = frag_desc->priority;
 
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	/* Let sockets busy poll the NAPI context the frame came from */
+	if (frag_desc->napi_id >= MIN_NAPI_ID)
+		head_skb->napi_id = frag_desc->napi_id;
+#endif
+
 	if (trace_print_tcp_rx_enabled()) {
 		char saddr[INET6_ADDRSTRLEN], daddr[INET6_ADDRSTRLEN];
 
@@ -1103,8 +1147,20 @@ void rmnet_frag_deliver(struct rmnet_frag_descriptor *frag_desc,
 }
 EXPORT_SYMBOL(rmnet_frag_deliver);
 
+/* Header values shared by every segment of a coalesced frame. These are
+ * parsed once per frame instead of once per segment.
+ */
+struct rmnet_frag_coal_hdrs {
+	u32 tcp_seq;
+	u16 ip_id;
+	__be16 tcp_flags;
+	bool clear_tcp_flags;
+	bool zero_csum;
+};
+
 static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 				      struct rmnet_port *port,
+				      const struct rmnet_frag_coal_hdrs *hdrs,
 				      struct list_head *list, u8 pkt_id,
 				      bool csum_valid)
 {
@@ -1123,6 +1179,7 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 	memcpy(new_desc, coal_desc, sizeof(*coal_desc));
 	INIT_LIST_HEAD(&new_desc->list);
 	INIT_LIST_HEAD(&new_desc->frags);
+	new_desc->inline_frags_used = 0;
 	new_desc->len = 0;
 
 	/* Add the header fragments */
@@ -1139,56 +1196,25 @@ static void __rmnet_frag_segment_data(struct rmnet_frag_descriptor *coal_desc,
 
 	/* Update protocol-specific metadata */
 	if (coal_desc->trans_proto == IPPROTO_TCP) {
-		struct tcphdr *th, __th;
-
-		th = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
-					   sizeof(*th), &__th);
-		if (!th)
-			goto recycle;
-
 		new_desc->tcp_seq_set = 1;
-		new_desc->tcp_seq = htonl(ntohl(th->seq) +
+		new_desc->tcp_seq = htonl(hdrs->tcp_seq +
 					  coal_desc->data_offset);
 
 		/* Don't allow any dangerous flags to appear in any segments
 		 * other than the last.
 		 */
-		if (th->fin || th->psh) {
-			if (offset + dlen < coal_desc->len) {
-				__be32 flag_word = tcp_flag_word(th);
-
-				/* Clear the FIN and PSH flags from this
-				 * segment.
-				 */
-				flag_word &= ~TCP_FLAG_FIN;
-				flag_word &= ~TCP_FLAG_PSH;
-
-				new_desc->tcp_flags_set = 1;
-				new_desc->tcp_flags = *((__be16 *)&flag_word);
-			}
+		if (hdrs->clear_tcp_flags && offset + dlen < coal_desc->len) {
+			new_desc->tcp_flags_set = 1;
+			new_desc->tcp_flags = hdrs->tcp_flags;
 		}
 	} else if (coal_desc->trans_proto == IPPROTO_UDP) {
-		struct udphdr *uh, __uh;
-
-		uh = rmnet_frag_header_ptr(coal_desc, coal_desc->ip_len,
-					   sizeof(*uh), &__uh);
-		if (!uh)
-			goto recycle;
-
-		if (coal_desc->ip_proto == 4 && !uh->check)
+		if (hdrs->zero_csum)
 			csum_valid = true;
 	}
 
 	if (coal_desc->ip_proto == 4) {
-		struct iphdr *iph, __iph;
-
-		iph = rmnet_frag_header_ptr(coal_desc, 0, sizeof(*iph),
-					    &__iph);
-		if (!iph)
-			goto recycle;
-
 		new_desc->ip_id_set = 1;
-		new_desc->ip_id = htons(ntohs(iph->id) + coal_desc->pkt_id);
+		new_desc->ip_id = htons(hdrs->ip_id + coal_desc->pkt_id);
 	}
 
 	new_desc->csum_valid = csum_valid;
@@ -1252,6 +1278,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 {
 	struct rmnet_priv *priv = netdev_priv(coal_desc->dev);
 	struct rmnet_map_v5_coal_header coal_hdr;
+	struct rmnet_frag_coal_hdrs hdrs = {};
 	struct rmnet_fragment *frag;
 	u8 *version;
 	u16 pkt_len;
@@ -1293,6 +1320,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		coal_desc->ip_proto = 4;
 		coal_desc->ip_len = iph->ihl * 4;
 		coal_desc->trans_proto = iph->protocol;
+		hdrs.ip_id = ntohs(iph->id);
 
 		/* Don't allow coalescing of any packets with IP options */
 		if (iph->ihl != 5)
@@ -1357,6 +1385,19 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 			return;
 
 		coal_desc->trans_len = th->doff * 4;
+		hdrs.tcp_seq = ntohl(th->seq);
+		if (th->fin || th->psh) {
+			__be32 flag_word = tcp_flag_word(th);
+
+			/* Precompute the flags for every segment but the last
+			 * one, which must not carry FIN or PSH.
+			 */
+			flag_word &= ~TCP_FLAG_FIN;
+			flag_word &= ~TCP_FLAG_PSH;
+			hdrs.tcp_flags = *((__be16 *)&flag_word);
+			hdrs.clear_tcp_flags = true;
+		}
+
 		priv->stats.coal.coal_tcp++;
 		priv->stats.coal.coal_tcp_bytes += coal_desc->len;
 	} else if (coal_desc->trans_proto == IPPROTO_UDP) {
@@ -1378,6 +1419,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		return;
 	}
 
+	hdrs.zero_csum = zero_csum;
 	coal_desc->hdrs_valid = 1;
 	coal_desc->coal_bytes = coal_desc->len;
 	rmnet_descriptor_for_each_frag(frag, coal_desc)
@@ -1427,7 +1469,8 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 					priv->stats.coal.coal_csum_err++;
 
 				__rmnet_frag_segment_data(coal_desc, port,
-							  list, total_pkt,
+							  &hdrs, list,
+							  total_pkt,
 							  !csum_err);
 				continue;
 			}
@@ -1439,6 +1482,7 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 				if (coal_desc->gso_segs)
 					__rmnet_frag_segment_data(coal_desc,
 								  port,
+								  &hdrs,
 								  list,
 								  total_pkt,
 								  true);
@@ -1446,8 +1490,8 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 				/* Segment out the bad checksum */
 				coal_desc->gso_segs = 1;
 				__rmnet_frag_segment_data(coal_desc, port,
-							  list, total_pkt,
-							  false);
+							  &hdrs, list,
+							  total_pkt, false);
 			} else {
 				coal_desc->gso_segs++;
 			}
@@ -1458,8 +1502,8 @@ rmnet_frag_segment_coal_data(struct rmnet_frag_descriptor *coal_desc,
 		 * when the packet length changes.
 		 */
 		if (coal_desc->gso_segs)
-			__rmnet_frag_segment_data(coal_desc, port, list,
-						  total_pkt, true);
+			__rmnet_frag_segment_data(coal_desc, port, &hdrs,
+						  list, total_pkt, true);
 	}
 }
 
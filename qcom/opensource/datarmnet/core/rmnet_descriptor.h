@@ -33,6 +33,12 @@ struct rmnet_fragment {
 	skb_frag_t frag;
 };
 
+/* Number of fragments stored within the descriptor itself. Deaggregated and
+ * segmented packets rarely need more than a header and a data fragment, so
+ * this keeps the fast path free of per-fragment slab allocations.
+ */
+#define RMNET_FRAG_DESC_INLINE_FRAGS 2
+
 struct rmnet_frag_descriptor {
 	struct list_head list;
 	struct list_head frags;
@@ -42,6 +48,7 @@ struct rmnet_frag_descriptor {
 	u32 len;
 	u32 hash;
 	u32 priority;
+	unsigned int napi_id;
 	__be32 tcp_seq;
 	__be16 ip_id;
 	__be16 tcp_flags;
@@ -60,6 +67,8 @@ struct rmnet_frag_descriptor {
 	   flush_shs:1,
 	   tcp_flags_set:1,
 	   reserved:2;
+	u8 inline_frags_used;
+	struct rmnet_fragment inline_frags[RMNET_FRAG_DESC_INLINE_FRAGS];
 };
 
 /* Descriptor management */
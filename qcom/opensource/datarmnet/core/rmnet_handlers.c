@@ -401,7 +401,9 @@ static int rmnet_map_egress_handler(struct sk_buff *skb,
 		    rmnet_map_tx_agg_skip(skb, required_headroom) || tso)
 			goto done;
 
-		rmnet_map_tx_aggregate(skb, port, low_latency);
+		rmnet_map_tx_aggregate(skb, port, low_latency,
+				       rmnet_map_tx_agg_pure_ack(skb,
+							required_headroom));
 		return -EINPROGRESS;
 	}
 
@@ -1230,6 +1230,17 @@ int rmnet_map_process_next_hdr_packet(struct sk_buff *skb,
 
 long rmnet_agg_time_limit __read_mostly = 1000000L;
 long rmnet_agg_bypass_time __read_mostly = 10000000L;
+/* Page fragments allowed in a scatter-gather aggregate. IPA linearizes
+ * anything that does not fit in the TLV FIFO of the producer pipe.
+ */
+int rmnet_agg_sg_max_frags __read_mostly = 8;
+
+/* Adaptive flush time is this many average packet gaps, bounded below by
+ * rmnet_agg_adapt_min_time and above by the configured aggregation time.
+ */
+#define RMNET_AGG_ADAPT_GAPS 4
+#define RMNET_AGG_ADAPT_EWMA_SHIFT 3
+long rmnet_agg_adapt_min_time __read_mostly = 100000L;
 
 int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 {
@@ -1259,6 +1270,70 @@ int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 	return is_icmp;
 }
 
+/* Pure TCP ACKs are latency sensitive for the peer, so adaptive aggregation
+ * ships them out right away instead of holding them for the flush timer.
+ */
+bool rmnet_map_tx_agg_pure_ack(struct sk_buff *skb, int offset)
+{
+	u8 *packet_start = skb->data + offset;
+	unsigned int ip_len, pkt_len;
+	struct tcphdr *th;
+
+	if (skb->protocol == htons(ETH_P_IP)) {
+		struct iphdr *ip4h = (struct iphdr *)(packet_start);
+
+		if (skb_headlen(skb) < offset + sizeof(*ip4h) ||
+		    ip4h->protocol != IPPROTO_TCP ||
+		    (ip4h->frag_off & htons(IP_OFFSET | IP_MF)))
+			return false;
+
+		ip_len = ip4h->ihl * 4;
+		pkt_len = ntohs(ip4h->tot_len);
+	} else if (skb->protocol == htons(ETH_P_IPV6)) {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)(packet_start);
+
+		if (skb_headlen(skb) < offset + sizeof(*ip6h) ||
+		    ip6h->nexthdr != IPPROTO_TCP)
+			return false;
+
+		ip_len = sizeof(*ip6h);
+		pkt_len = ntohs(ip6h->payload_len) + sizeof(*ip6h);
+	} else {
+		return false;
+	}
+
+	if (skb_headlen(skb) < offset + ip_len + sizeof(*th))
+		return false;
+
+	th = (struct tcphdr *)(packet_start + ip_len);
+	if (th->syn || th->fin || th->rst || !th->ack)
+		return false;
+
+	return pkt_len == ip_len + th->doff * 4;
+}
+
+/* Track the average packet gap and derive the flush time from it. Waiting
+ * longer than a few gaps rarely adds another packet to the aggregate.
+ */
+static u64 rmnet_map_agg_flush_time(struct rmnet_aggregation_state *state,
+				    struct timespec64 *diff)
+{
+	s64 gap = timespec64_to_ns(diff);
+	u64 flush_time;
+
+	if (!(state->params.agg_features & RMNET_AGG_ADAPTIVE))
+		return state->params.agg_time;
+
+	gap = clamp_t(s64, gap, 0, rmnet_agg_bypass_time);
+	state->agg_gap_ewma += (gap >> RMNET_AGG_ADAPT_EWMA_SHIFT) -
+			       (state->agg_gap_ewma >>
+				RMNET_AGG_ADAPT_EWMA_SHIFT);
+
+	flush_time = state->agg_gap_ewma * RMNET_AGG_ADAPT_GAPS;
+	return clamp_t(u64, flush_time, rmnet_agg_adapt_min_time,
+		       state->params.agg_time);
+}
+
 static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 {
 	struct sk_buff *skb = NULL;
@@ -1437,6 +1512,101 @@ rmnet_map_build_skb(struct rmnet_aggregation_state *state)
 	return skb;
 }
 
+/* Only reference the pages of packets whose data can't change under us */
+static bool rmnet_map_sg_can_ref(struct sk_buff *skb)
+{
+	return skb_shinfo(skb)->nr_frags &&
+	       skb_shinfo(skb)->nr_frags < rmnet_agg_sg_max_frags &&
+	       !skb_has_frag_list(skb) && !skb_zcopy(skb);
+}
+
+/* Append page data to a scatter-gather aggregate, extending the last
+ * fragment if the new data directly follows it.
+ */
+static void rmnet_map_sg_add_frag(struct sk_buff *agg_skb, struct page *page,
+				  unsigned int off, unsigned int len)
+{
+	int i = skb_shinfo(agg_skb)->nr_frags;
+
+	if (skb_can_coalesce(agg_skb, i, page, off)) {
+		skb_coalesce_rx_frag(agg_skb, i - 1, len, len);
+		return;
+	}
+
+	get_page(page);
+	skb_add_rx_frag(agg_skb, i, page, off, len, len);
+}
+
+/* Check whether the packet still fits into the current aggregate */
+static bool rmnet_map_agg_fits(struct rmnet_aggregation_state *state,
+			       struct sk_buff *skb)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+	unsigned int copy = skb->len;
+	int frags = 1;
+
+	if (!(state->params.agg_features & RMNET_PAGE_SG))
+		return skb->len <= skb_tailroom(agg_skb);
+
+	if (skb->len > state->params.agg_size - agg_skb->len)
+		return false;
+
+	if (rmnet_map_sg_can_ref(skb)) {
+		copy = skb_headlen(skb);
+		frags += skb_shinfo(skb)->nr_frags;
+	}
+
+	/* Still aggregating into the linear area */
+	if (!skb_shinfo(agg_skb)->nr_frags && skb->len <= skb_tailroom(agg_skb))
+		return true;
+
+	return skb_shinfo(agg_skb)->nr_frags + frags <= rmnet_agg_sg_max_frags &&
+	       state->agg_sg_off + copy <= skb_end_offset(agg_skb);
+}
+
+/* Add a packet to the current aggregate. In scatter-gather mode only the
+ * linear part of the packet is copied into the aggregation page, the page
+ * fragments are referenced and handed to the lower layer as they are.
+ */
+static void rmnet_map_agg_append(struct rmnet_aggregation_state *state,
+				 struct sk_buff *skb)
+{
+	struct sk_buff *agg_skb = state->agg_skb;
+	unsigned int copy;
+	int i;
+
+	if (!(state->params.agg_features & RMNET_PAGE_SG)) {
+		rmnet_map_linearize_copy(agg_skb, skb);
+		return;
+	}
+
+	copy = rmnet_map_sg_can_ref(skb) ? skb_headlen(skb) : skb->len;
+	if (!skb_shinfo(agg_skb)->nr_frags) {
+		skb_copy_bits(skb, 0, skb_put(agg_skb, copy), copy);
+		state->agg_sg_off = skb_tail_pointer(agg_skb) - agg_skb->head;
+	} else {
+		/* The linear area is closed once fragments are attached, so
+		 * copy into the unused part of the aggregation page instead.
+		 */
+		skb_copy_bits(skb, 0, agg_skb->head + state->agg_sg_off, copy);
+		rmnet_map_sg_add_frag(agg_skb, virt_to_head_page(agg_skb->head),
+				      state->agg_sg_off, copy);
+		state->agg_sg_off += copy;
+	}
+
+	if (copy == skb->len)
+		return;
+
+	for (i = 0; i < skb_shinfo(skb)->nr_frags; i++) {
+		skb_frag_t *frag = &skb_shinfo(skb)->frags[i];
+
+		rmnet_map_sg_add_frag(agg_skb, skb_frag_page(frag),
+				      skb_frag_off(frag), skb_frag_size(frag));
+	}
+
+	state->stats->ul_agg_sg_frags += skb_shinfo(skb)->nr_frags;
+}
+
 void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 {
 	struct sk_buff *agg_skb;
@@ -1458,10 +1628,11 @@ void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 }
 
 void rmnet_map_tx_aggregate(struct sk_buff *skb, struct rmnet_port *port,
-			    bool low_latency)
+			    bool low_latency, bool flush)
 {
 	struct rmnet_aggregation_state *state;
 	struct timespec64 diff, last;
+	u64 flush_time = 0;
 	int size;
 
 	state = &port->agg_state[(low_latency) ? RMNET_LL_AGG_STATE :
@@ -1471,6 +1642,12 @@ new_packet:
 	spin_lock_bh(&state->agg_lock);
 	memcpy(&last, &state->agg_last, sizeof(last));
 	ktime_get_real_ts64(&state->agg_last);
+	diff = timespec64_sub(state->agg_last, last);
+	/* Only sample the packet gap once if we had to flush and retry */
+	if (!flush_time)
+		flush_time = rmnet_map_agg_flush_time(state, &diff);
+	if (!(state->params.agg_features & RMNET_AGG_ADAPTIVE))
+		flush = false;
 
 	if ((port->data_format & RMNET_EGRESS_FORMAT_PRIORITY) &&
 	    (RMNET_LLM(skb->priority) || RMNET_APS_LLB(skb->priority))) {
@@ -1486,7 +1663,6 @@ new_packet:
 		/* Check to see if we should agg first. If the traffic is very
 		 * sparse, don't aggregate. We will need to tune this later
 		 */
-		diff = timespec64_sub(state->agg_last, last);
 		size = state->params.agg_size - skb->len;
 
 		if (diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_bypass_time ||
@@ -1508,7 +1684,7 @@ new_packet:
 			return;
 		}
 
-		rmnet_map_linearize_copy(state->agg_skb, skb);
+		rmnet_map_agg_append(state, skb);
 		state->agg_skb->dev = skb->dev;
 		state->agg_skb->protocol = htons(ETH_P_MAP);
 		state->agg_count = 1;
@@ -1517,24 +1693,28 @@ new_packet:
 		goto schedule;
 	}
 	diff = timespec64_sub(state->agg_last, state->agg_time);
-	size = skb_tailroom(state->agg_skb);
 
-	if (skb->len > size ||
+	if (!rmnet_map_agg_fits(state, skb) ||
 	    state->agg_count >= state->params.agg_count ||
 	    diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_time_limit) {
 		rmnet_map_send_agg_skb(state);
 		goto new_packet;
 	}
 
-	rmnet_map_linearize_copy(state->agg_skb, skb);
+	rmnet_map_agg_append(state, skb);
 	state->agg_count++;
 	dev_kfree_skb_any(skb);
 
 schedule:
+	if (flush) {
+		state->stats->ul_agg_ack_flush++;
+		rmnet_map_send_agg_skb(state);
+		return;
+	}
+
 	if (state->agg_state != -EINPROGRESS) {
 		state->agg_state = -EINPROGRESS;
-		hrtimer_start(&state->hrtimer,
-			      ns_to_ktime(state->params.agg_time),
+		hrtimer_start(&state->hrtimer, ns_to_ktime(flush_time),
 			      HRTIMER_MODE_REL);
 	}
 	spin_unlock_bh(&state->agg_lock);
@@ -1563,7 +1743,7 @@ void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 	size -= SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
 	state->params.agg_size = size;
 
-	if (state->params.agg_features == RMNET_PAGE_RECYCLE)
+	if (state->params.agg_features & RMNET_PAGE_RECYCLE)
 		rmnet_alloc_agg_pages(state);
 
 done:
@@ -561,6 +561,8 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL trailer pkts received",
 	"UL agg reuse",
 	"UL agg alloc",
+	"UL agg SG frags",
+	"UL agg ACK flush",
 	"DL chaining [0-10)",
 	"DL chaining [10-20)",
 	"DL chaining [20-30)",
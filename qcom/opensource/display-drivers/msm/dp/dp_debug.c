@@ -1338,6 +1338,85 @@ error:
 	return rc;
 }
 
+static ssize_t dp_debug_read_mst_bw_info(struct file *file,
+		char __user *user_buff, size_t count, loff_t *ppos)
+{
+	struct dp_debug_private *debug = file->private_data;
+	struct drm_connector_list_iter conn_iter;
+	struct drm_connector *connector;
+	struct sde_connector *sde_conn;
+	struct dp_display *display;
+	struct dp_panel *panel;
+	const u32 tot_slots = 63;
+	u32 slots_in_use = 0;
+	u64 link_kbps, stream_kbps;
+	char *buf;
+	int len = 0, ret = 0, max_size = SZ_4K;
+	ssize_t rc;
+
+	if (!debug)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	buf = kzalloc(SZ_4K, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	/* 8b/10b channel coding: 8 data bits per link symbol */
+	link_kbps = (u64)debug->panel->link_info.rate *
+			debug->panel->link_info.num_lanes * 8;
+
+	ret = scnprintf(buf + len, max_size,
+			"link_rate=%u num_lanes=%u payload_kbps=%llu\n",
+			debug->panel->link_info.rate,
+			debug->panel->link_info.num_lanes, link_kbps);
+	if (dp_debug_check_buffer_overflow(ret, &max_size, &len))
+		goto copy;
+
+	drm_connector_list_iter_begin((*debug->connector)->dev, &conn_iter);
+	drm_for_each_connector_iter(connector, &conn_iter) {
+		sde_conn = to_sde_connector(connector);
+		display = sde_conn->display;
+		panel = sde_conn->drv_panel;
+		if (!sde_conn->mst_port || !panel ||
+				display->base_connector != (*debug->connector))
+			continue;
+
+		if (panel->stream_id >= DP_STREAM_MAX ||
+				!panel->channel_total_slots)
+			continue;
+
+		slots_in_use += panel->channel_total_slots;
+		stream_kbps = div_u64(link_kbps * panel->channel_total_slots,
+				tot_slots + 1);
+
+		ret = scnprintf(buf + len, max_size,
+				"conn:%d stream:%d vcpi:%d start_slot:%u slots:%u pbn:%u dsc:%d util:%u%% kbps:%llu\n",
+				connector->base.id, panel->stream_id,
+				panel->vcpi, panel->channel_start_slot,
+				panel->channel_total_slots, panel->pbn,
+				panel->pinfo.comp_info.enabled,
+				panel->channel_total_slots * 100 / tot_slots,
+				stream_kbps);
+		if (dp_debug_check_buffer_overflow(ret, &max_size, &len))
+			break;
+	}
+	drm_connector_list_iter_end(&conn_iter);
+
+	ret = scnprintf(buf + len, max_size,
+			"slots_in_use:%u free_slots:%u util:%u%%\n",
+			slots_in_use, tot_slots - min(slots_in_use, tot_slots),
+			min(slots_in_use, tot_slots) * 100 / tot_slots);
+	dp_debug_check_buffer_overflow(ret, &max_size, &len);
+copy:
+	rc = simple_read_from_buffer(user_buff, count, ppos, buf, len);
+	kfree(buf);
+
+	return rc;
+}
+
 static ssize_t dp_debug_read_info(struct file *file, char __user *user_buff,
 		size_t count, loff_t *ppos)
 {
@@ -1926,6 +2005,11 @@ static const struct file_operations mst_conn_info_fops = {
 	.read = dp_debug_read_mst_conn_info,
 };
 
+static const struct file_operations mst_bw_info_fops = {
+	.open = simple_open,
+	.read = dp_debug_read_mst_bw_info,
+};
+
 static const struct file_operations mst_con_id_fops = {
 	.open = simple_open,
 	.read = dp_debug_read_mst_con_id,
@@ -2061,6 +2145,15 @@ static int dp_debug_init_mst(struct dp_debug_private *debug, struct dentry *dir)
 		return rc;
 	}
 
+	file = debugfs_create_file("mst_bw_info", 0444, dir,
+					debug, &mst_bw_info_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		rc = PTR_ERR(file);
+		DP_ERR("[%s] debugfs create mst_bw_info failed, rc=%d\n",
+		       DEBUG_NAME, rc);
+		return rc;
+	}
+
 	file = debugfs_create_file("mst_con_add", 0644, dir,
 					debug, &mst_con_add_fops);
 	if (IS_ERR_OR_NULL(file)) {
@@ -13,6 +13,7 @@
 
 #include "dsi_panel.h"
 #include "dsi_ctrl_hw.h"
+#include "dsi_ctrl.h"
 #include "dsi_parser.h"
 #include "sde_dbg.h"
 #include "sde_dsc_helper.h"
@@ -2407,6 +2408,68 @@ error_free_payloads:
 	return rc;
 }
 
+static void dsi_panel_cmd_end_batch(struct dsi_cmd_desc *cmd)
+{
+	cmd->msg.flags &= ~MIPI_DSI_MSG_BATCH_COMMAND;
+	cmd->last_command = true;
+}
+
+static bool dsi_panel_cmd_is_read(struct dsi_cmd_desc *cmd)
+{
+	switch (cmd->msg.type) {
+	case MIPI_DSI_DCS_READ:
+	case MIPI_DSI_GENERIC_READ_REQUEST_0_PARAM:
+	case MIPI_DSI_GENERIC_READ_REQUEST_1_PARAM:
+	case MIPI_DSI_GENERIC_READ_REQUEST_2_PARAM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void dsi_panel_batch_cmd_set(struct dsi_panel_cmd_set *set)
+{
+	struct dsi_cmd_desc *cmd;
+	u32 i, len, batch_len = 0;
+	bool standalone;
+
+	if (!set || !set->cmds)
+		return;
+
+	for (i = 0; i < set->count; i++) {
+		cmd = &set->cmds[i];
+
+		/* header plus payload, padded to 32 bits as in the DMA buffer */
+		len = 4;
+		if (mipi_dsi_packet_format_is_long(cmd->msg.type))
+			len += ALIGN(cmd->msg.tx_len, 4);
+
+		/*
+		 * Reads need their own BTA and large packets go out in non
+		 * embedded mode, neither can share the buffer with others.
+		 */
+		standalone = dsi_panel_cmd_is_read(cmd) ||
+			(cmd->msg.tx_len > DSI_EMBEDDED_MODE_DMA_MAX_SIZE_BYTES);
+
+		if (batch_len && (standalone ||
+				(batch_len + len + 4) > SZ_4K)) {
+			dsi_panel_cmd_end_batch(&set->cmds[i - 1]);
+			batch_len = 0;
+		}
+
+		/* a post wait has to start after the batch has been sent */
+		if (standalone || cmd->post_wait_ms || (i == set->count - 1)) {
+			dsi_panel_cmd_end_batch(cmd);
+			batch_len = 0;
+			continue;
+		}
+
+		cmd->msg.flags |= MIPI_DSI_MSG_BATCH_COMMAND;
+		cmd->last_command = false;
+		batch_len += len;
+	}
+}
+
 void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set)
 {
 	u32 i = 0;
@@ -2507,6 +2570,7 @@ static int dsi_panel_parse_cmd_sets(
 {
 	int rc = 0;
 	struct dsi_panel_cmd_set *set;
+	bool batching;
 	u32 i;
 
 	if (!priv_info) {
@@ -2514,6 +2578,9 @@ static int dsi_panel_parse_cmd_sets(
 		return -EINVAL;
 	}
 
+	batching = utils->read_bool(utils->data,
+			"qcom,mdss-dsi-cmd-set-batching");
+
 	for (i = DSI_CMD_SET_PRE_ON; i < DSI_CMD_SET_MAX; i++) {
 		set = &priv_info->cmd_sets[i];
 		set->type = i;
@@ -2529,6 +2596,8 @@ static int dsi_panel_parse_cmd_sets(
 			rc = dsi_panel_parse_cmd_sets_sub(set, i, utils);
 			if (rc)
 				DSI_DEBUG("failed to parse set %d\n", i);
+			else if (batching)
+				dsi_panel_batch_cmd_set(set);
 		}
 	}
 
@@ -428,6 +428,18 @@ int dsi_panel_create_cmd_packets(const char *data, u32 length, u32 count,
 
 void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set);
 
+/**
+ * dsi_panel_batch_cmd_set() - pack a command set into as few DMA transfers
+ *				as possible
+ * @set:	command set to update
+ *
+ * Marks the packets of @set so that consecutive writes are queued into the
+ * command DMA buffer and triggered once. A batch is closed before reads and
+ * non embedded packets, at packets with a post wait, when the buffer would
+ * overflow and at the end of the set.
+ */
+void dsi_panel_batch_cmd_set(struct dsi_panel_cmd_set *set);
+
 void dsi_panel_dealloc_cmd_packets(struct dsi_panel_cmd_set *set);
 
 int dsi_panel_get_cmd_pkt_count(const char *data, u32 length, u32 *cnt);
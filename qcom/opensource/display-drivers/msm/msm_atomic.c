@@ -35,8 +35,40 @@ struct msm_commit {
 	uint32_t plane_mask;
 	bool nonblock;
 	struct kthread_work commit_work;
+	struct msm_drm_thread *thread;
+	ktime_t stage_start;
+	u64 stage_us[MSM_COMMIT_STAGE_MAX];
 };
 
+/* Account the time since the last stage boundary to @stage */
+static void _msm_commit_stage_end(struct msm_commit *c,
+		enum msm_commit_stage stage)
+{
+	ktime_t now = ktime_get();
+
+	c->stage_us[stage] = ktime_us_delta(now, c->stage_start);
+	c->stage_start = now;
+}
+
+static void _msm_commit_timing_update(struct msm_commit *c)
+{
+	struct msm_commit_timing *timing;
+	int i;
+
+	if (!c->thread)
+		return;
+
+	timing = &c->thread->timing;
+
+	for (i = 0; i < MSM_COMMIT_STAGE_MAX; i++) {
+		timing->last_us[i] = c->stage_us[i];
+		timing->max_us[i] = max(timing->max_us[i], c->stage_us[i]);
+		timing->total_us[i] += c->stage_us[i];
+	}
+
+	timing->count++;
+}
+
 static inline bool _msm_seamless_for_crtc(struct drm_atomic_state *state,
 			struct drm_crtc_state *crtc_state, bool enable)
 {
@@ -540,8 +572,12 @@ static void complete_commit(struct msm_commit *c)
 	struct msm_drm_private *priv = dev->dev_private;
 	struct msm_kms *kms = priv->kms;
 
+	_msm_commit_stage_end(c, MSM_COMMIT_STAGE_DISPATCH);
+
 	drm_atomic_helper_wait_for_fences(dev, state, false);
 
+	_msm_commit_stage_end(c, MSM_COMMIT_STAGE_FENCE);
+
 	kms->funcs->prepare_commit(kms, state);
 
 	msm_atomic_helper_commit_modeset_disables(dev, state);
@@ -564,8 +600,13 @@ static void complete_commit(struct msm_commit *c)
 	 * not be critical path)
 	 */
 
+	_msm_commit_stage_end(c, MSM_COMMIT_STAGE_PROGRAM);
+
 	msm_atomic_wait_for_commit_done(dev, state);
 
+	_msm_commit_stage_end(c, MSM_COMMIT_STAGE_DONE);
+	_msm_commit_timing_update(c);
+
 	drm_atomic_helper_cleanup_planes(dev, state);
 
 	kms->funcs->complete_commit(kms, state);
@@ -626,6 +667,7 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 			if (priv->disp_thread[j].crtc_id ==
 						crtc->base.id) {
 				if (priv->disp_thread[j].thread) {
+					commit->thread = &priv->disp_thread[j];
 					kthread_queue_work(
 						&priv->disp_thread[j].worker,
 							&commit->commit_work);
@@ -758,6 +800,7 @@ retry:
 	 */
 
 	/* Start Atomic */
+	c->stage_start = ktime_get();
 	spin_lock(&priv->pending_crtcs_event.lock);
 	ret = wait_event_interruptible_locked(priv->pending_crtcs_event,
 			!(priv->pending_crtcs & c->crtc_mask) &&
@@ -772,6 +815,8 @@ retry:
 	if (ret)
 		goto err_free;
 
+	_msm_commit_stage_end(c, MSM_COMMIT_STAGE_QUEUE);
+
 	WARN_ON(drm_atomic_helper_swap_state(state, false) < 0);
 
 	/*
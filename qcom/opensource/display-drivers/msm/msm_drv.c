@@ -524,6 +524,8 @@ static int msm_drm_uninit(struct device *dev)
 		priv->kms = NULL;
 	}
 
+	msm_gem_pool_drain(ddev);
+
 	if (priv->vram.paddr) {
 		unsigned long attrs = DMA_ATTR_NO_KERNEL_MAPPING;
 		drm_mm_takedown(&priv->vram.mm);
@@ -912,6 +914,8 @@ static int msm_drm_component_init(struct device *dev)
 	INIT_LIST_HEAD(&priv->inactive_list);
 	INIT_LIST_HEAD(&priv->vm_client_list);
 	mutex_init(&priv->mm_lock);
+	INIT_LIST_HEAD(&priv->gem_pool.entries);
+	mutex_init(&priv->gem_pool.lock);
 
 	mutex_init(&priv->vm_client_lock);
 
@@ -1012,6 +1016,7 @@ static int msm_drm_component_init(struct device *dev)
 		DISP_DEV_ERR(dev, "failed to reg sde dbg debugfs: %d\n", ret);
 		goto fail;
 	}
+	msm_gem_pool_debugfs_init(ddev, priv->debug_root);
 
 	/* perform subdriver post initialization */
 	if (kms && kms->funcs && kms->funcs->postinit) {
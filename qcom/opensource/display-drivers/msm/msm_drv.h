@@ -953,12 +953,45 @@ struct msm_drm_event {
 	struct drm_msm_event_resp event;
 };
 
+/**
+ * enum msm_commit_stage - stages of an atomic commit tracked for timing
+ * @MSM_COMMIT_STAGE_QUEUE: waiting for earlier commits on the same crtcs
+ * @MSM_COMMIT_STAGE_DISPATCH: waiting for the commit thread to pick it up
+ * @MSM_COMMIT_STAGE_FENCE: waiting for the input fences
+ * @MSM_COMMIT_STAGE_PROGRAM: programming the hardware
+ * @MSM_COMMIT_STAGE_DONE: waiting for the hardware to pick up the frame
+ * @MSM_COMMIT_STAGE_MAX: number of stages
+ */
+enum msm_commit_stage {
+	MSM_COMMIT_STAGE_QUEUE,
+	MSM_COMMIT_STAGE_DISPATCH,
+	MSM_COMMIT_STAGE_FENCE,
+	MSM_COMMIT_STAGE_PROGRAM,
+	MSM_COMMIT_STAGE_DONE,
+	MSM_COMMIT_STAGE_MAX,
+};
+
+/**
+ * struct msm_commit_timing - per stage timing of the commits on a crtc
+ * @count: number of commits completed
+ * @last_us: time spent in each stage by the last commit
+ * @max_us: longest time spent in each stage
+ * @total_us: total time spent in each stage
+ */
+struct msm_commit_timing {
+	u64 count;
+	u64 last_us[MSM_COMMIT_STAGE_MAX];
+	u64 max_us[MSM_COMMIT_STAGE_MAX];
+	u64 total_us[MSM_COMMIT_STAGE_MAX];
+};
+
 /* Commit/Event thread specific structure */
 struct msm_drm_thread {
 	struct drm_device *dev;
 	struct task_struct *thread;
 	unsigned int crtc_id;
 	struct kthread_worker worker;
+	struct msm_commit_timing timing;
 };
 
 struct msm_drm_private {
@@ -1013,6 +1046,18 @@ struct msm_drm_private {
 	struct list_head inactive_list;
 	struct mutex mm_lock;
 
+	/*
+	 * Backing pages of freed GEM objects, kept to back new objects of
+	 * the same size without going through shmem allocation again.
+	 */
+	struct {
+		struct list_head entries;
+		struct mutex lock;
+		size_t bytes;
+		u64 hits;
+		u64 misses;
+	} gem_pool;
+
 	struct workqueue_struct *wq;
 
 	/* crtcs pending async atomic updates: */
@@ -1242,6 +1287,8 @@ int msm_gem_madvise(struct drm_gem_object *obj, unsigned madv);
 int msm_gem_cpu_prep(struct drm_gem_object *obj, uint32_t op, ktime_t *timeout);
 int msm_gem_cpu_fini(struct drm_gem_object *obj);
 void msm_gem_free_object(struct drm_gem_object *obj);
+void msm_gem_pool_drain(struct drm_device *dev);
+void msm_gem_pool_debugfs_init(struct drm_device *dev, struct dentry *root);
 int msm_gem_new_handle(struct drm_device *dev, struct drm_file *file,
 		uint32_t size, uint32_t flags, uint32_t *handle, char *name);
 struct drm_gem_object *msm_gem_new(struct drm_device *dev,
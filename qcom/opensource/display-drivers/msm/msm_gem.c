@@ -20,6 +20,7 @@
 #include <linux/qcom-dma-mapping.h>
 #include <linux/spinlock.h>
 #include <linux/shmem_fs.h>
+#include <linux/debugfs.h>
 #include <linux/dma-buf.h>
 #include <linux/pfn_t.h>
 #include <linux/version.h>
@@ -37,6 +38,25 @@
 
 static void msm_gem_vunmap_locked(struct drm_gem_object *obj);
 
+/* upper bound of backing storage kept in the gem pool */
+#define MSM_GEM_POOL_MAX_BYTES	SZ_32M
+
+/**
+ * struct msm_gem_pool_entry - backing storage of a freed gem object
+ * @list: node in the gem pool
+ * @base: carries the shmem file and size that own @pages
+ * @pages: pinned backing pages
+ * @sgt: scatter list of @pages
+ * @flags: flags of the object the storage was allocated for
+ */
+struct msm_gem_pool_entry {
+	struct list_head list;
+	struct drm_gem_object base;
+	struct page **pages;
+	struct sg_table *sgt;
+	uint32_t flags;
+};
+
 
 static dma_addr_t physaddr(struct drm_gem_object *obj)
 {
@@ -171,6 +191,143 @@ static void put_pages(struct drm_gem_object *obj)
 	}
 }
 
+/* Called with msm_obj->lock locked, takes over the pages on success */
+static bool msm_gem_pool_put(struct drm_gem_object *obj)
+{
+	struct msm_gem_object *msm_obj = to_msm_bo(obj);
+	struct msm_drm_private *priv = obj->dev->dev_private;
+	struct msm_gem_pool_entry *entry;
+
+	if (!use_pages(obj) || !obj->filp || !msm_obj->pages || !msm_obj->sgt ||
+			msm_obj->vaddr || msm_obj->madv != MSM_MADV_WILLNEED ||
+			obj->size > MSM_GEM_POOL_MAX_BYTES / 4)
+		return false;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return false;
+
+	mutex_lock(&priv->gem_pool.lock);
+	if (priv->gem_pool.bytes + obj->size > MSM_GEM_POOL_MAX_BYTES) {
+		mutex_unlock(&priv->gem_pool.lock);
+		kfree(entry);
+		return false;
+	}
+
+	entry->base.filp = obj->filp;
+	entry->base.size = obj->size;
+	entry->pages = msm_obj->pages;
+	entry->sgt = msm_obj->sgt;
+	entry->flags = msm_obj->flags;
+	list_add(&entry->list, &priv->gem_pool.entries);
+	priv->gem_pool.bytes += obj->size;
+	mutex_unlock(&priv->gem_pool.lock);
+
+	/* the pool now owns the pages and the shmem file backing them */
+	msm_obj->pages = NULL;
+	msm_obj->sgt = NULL;
+	obj->filp = NULL;
+
+	return true;
+}
+
+/* Back a new object with pooled storage of the same size and cache type */
+static bool msm_gem_pool_get(struct drm_gem_object *obj, uint32_t size)
+{
+	struct msm_gem_object *msm_obj = to_msm_bo(obj);
+	struct msm_drm_private *priv = obj->dev->dev_private;
+	struct msm_gem_pool_entry *entry, *found = NULL;
+	struct device *aspace_dev;
+	int i;
+
+	mutex_lock(&priv->gem_pool.lock);
+	list_for_each_entry(entry, &priv->gem_pool.entries, list) {
+		if (entry->base.size == size &&
+				(entry->flags & MSM_BO_CACHE_MASK) ==
+				(msm_obj->flags & MSM_BO_CACHE_MASK)) {
+			found = entry;
+			list_del(&entry->list);
+			priv->gem_pool.bytes -= size;
+			break;
+		}
+	}
+
+	if (found)
+		priv->gem_pool.hits++;
+	else
+		priv->gem_pool.misses++;
+	mutex_unlock(&priv->gem_pool.lock);
+
+	if (!found)
+		return false;
+
+	drm_gem_private_object_init(obj->dev, obj, size);
+	obj->filp = found->base.filp;
+	msm_obj->pages = found->pages;
+	msm_obj->sgt = found->sgt;
+	msm_obj->flags |= found->flags & MSM_BO_EXTBUF;
+	kfree(found);
+
+	/* never hand the contents of the previous owner to a new one */
+	for (i = 0; i < (size >> PAGE_SHIFT); i++)
+		clear_highpage(msm_obj->pages[i]);
+
+	/* non-cached buffers must reach the device clean, as in get_pages() */
+	if (msm_obj->flags & MSM_BO_EXTBUF) {
+		aspace_dev = msm_gem_get_aspace_device(msm_obj->aspace);
+		if (aspace_dev)
+			dma_sync_sg_for_device(aspace_dev, msm_obj->sgt->sgl,
+				msm_obj->sgt->nents, DMA_BIDIRECTIONAL);
+	}
+
+	return true;
+}
+
+void msm_gem_pool_drain(struct drm_device *dev)
+{
+	struct msm_drm_private *priv = dev->dev_private;
+	struct msm_gem_pool_entry *entry, *tmp;
+
+	mutex_lock(&priv->gem_pool.lock);
+	list_for_each_entry_safe(entry, tmp, &priv->gem_pool.entries, list) {
+		list_del(&entry->list);
+		sg_free_table(entry->sgt);
+		kfree(entry->sgt);
+		drm_gem_put_pages(&entry->base, entry->pages, true, false);
+		fput(entry->base.filp);
+		kfree(entry);
+	}
+	priv->gem_pool.bytes = 0;
+	mutex_unlock(&priv->gem_pool.lock);
+}
+
+#if IS_ENABLED(CONFIG_DEBUG_FS)
+static int msm_gem_pool_show(struct seq_file *s, void *data)
+{
+	struct msm_drm_private *priv = s->private;
+
+	mutex_lock(&priv->gem_pool.lock);
+	seq_printf(s, "bytes:%zu max:%u hits:%llu misses:%llu\n",
+			priv->gem_pool.bytes, MSM_GEM_POOL_MAX_BYTES,
+			priv->gem_pool.hits, priv->gem_pool.misses);
+	mutex_unlock(&priv->gem_pool.lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(msm_gem_pool);
+
+void msm_gem_pool_debugfs_init(struct drm_device *dev, struct dentry *root)
+{
+	if (root)
+		debugfs_create_file("gem_pool", 0400, root, dev->dev_private,
+				&msm_gem_pool_fops);
+}
+#else
+void msm_gem_pool_debugfs_init(struct drm_device *dev, struct dentry *root)
+{
+}
+#endif /* CONFIG_DEBUG_FS */
+
 struct page **msm_gem_get_pages(struct drm_gem_object *obj)
 {
 	struct msm_gem_object *msm_obj = to_msm_bo(obj);
@@ -903,7 +1060,8 @@ void msm_gem_free_object(struct drm_gem_object *obj)
 		drm_prime_gem_destroy(obj, msm_obj->sgt);
 	} else {
 		msm_gem_vunmap_locked(obj);
-		put_pages(obj);
+		if (!msm_gem_pool_put(obj))
+			put_pages(obj);
 	}
 
 	if (msm_obj->resv == &msm_obj->_resv)
@@ -1088,7 +1246,7 @@ static struct drm_gem_object *_msm_gem_new(struct drm_device *dev,
 		}
 
 		vma->iova = physaddr(obj);
-	} else {
+	} else if (!msm_gem_pool_get(obj, size)) {
 		ret = drm_gem_object_init(dev, obj, size);
 		if (ret)
 			goto fail;
@@ -1780,6 +1780,8 @@ static int _sde_connector_set_prop_retire_fence(struct drm_connector *connector,
 
 			if (drm_enc && !sde_encoder_in_clone_mode(drm_enc))
 				hw_ctl = sde_encoder_get_hw_ctl(c_conn);
+			else if (drm_enc && c_conn->hwfence_wb_retire_fences_enable)
+				c_conn->wb_cwb_sw_fence_cnt++;
 		}
 
 		rc = sde_fence_create(c_conn->retire_fence,
@@ -2584,6 +2586,23 @@ static const struct file_operations conn_cmd_rx_fops = {
 };
 
 #if IS_ENABLED(CONFIG_DEBUG_FS)
+static int _sde_debugfs_conn_wb_hw_fence_stats_show(struct seq_file *s, void *data)
+{
+	struct sde_connector *c_conn = s->private;
+	struct sde_fence_context *ctx = c_conn->retire_fence;
+
+	if (!ctx)
+		return 0;
+
+	/* fences counted here without a hw-fence are waited on by the cpu */
+	seq_printf(s, "retire_fences: %u\n", READ_ONCE(ctx->fence_cnt));
+	seq_printf(s, "hw_fences: %u\n", READ_ONCE(ctx->hw_fence_cnt));
+	seq_printf(s, "cwb_sw_fences: %u\n", READ_ONCE(c_conn->wb_cwb_sw_fence_cnt));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(_sde_debugfs_conn_wb_hw_fence_stats);
+
 /**
  * sde_connector_init_debugfs - initialize connector debugfs
  * @connector: Pointer to drm connector
@@ -2634,9 +2653,12 @@ static int sde_connector_init_debugfs(struct drm_connector *connector)
 	}
 
 	if (sde_connector->connector_type == DRM_MODE_CONNECTOR_VIRTUAL &&
-			sde_kms->catalog->hw_fence_rev)
+			sde_kms->catalog->hw_fence_rev) {
 		debugfs_create_bool("wb_hw_fence_enable", 0600, connector->debugfs_entry,
 			&sde_connector->hwfence_wb_retire_fences_enable);
+		debugfs_create_file("wb_hw_fence_stats", 0400, connector->debugfs_entry,
+			sde_connector, &_sde_debugfs_conn_wb_hw_fence_stats_fops);
+	}
 
 	return 0;
 }
@@ -560,6 +560,8 @@ struct sde_misr_sign {
  * @misr_event_notify_enabled: Flag to indicate if misr event notify is enabled or not
  * @previous_misr_sign: store previous misr signature
  * @hwfence_wb_retire_fences_enable: enable hw-fences for wb retire-fence
+ * @wb_cwb_sw_fence_cnt: wb retire-fences that fell back to sw signaling since
+ *	the wb was in cwb mode and does not own a hw ctl
  */
 struct sde_connector {
 	struct drm_connector base;
@@ -642,6 +644,7 @@ struct sde_connector {
 	struct sde_misr_sign previous_misr_sign;
 
 	bool hwfence_wb_retire_fences_enable;
+	u32 wb_cwb_sw_fence_cnt;
 
 	/* xiaomi add */
 	struct mi_sde_cdev *mi_cdev;
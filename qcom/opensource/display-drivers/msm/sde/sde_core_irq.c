@@ -6,36 +6,55 @@
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
+#include <linux/bitmap.h>
 #include <linux/debugfs.h>
 #include <linux/irqdomain.h>
 #include <linux/irq.h>
 #include <linux/kthread.h>
+#include <linux/log2.h>
+#include <linux/sched/clock.h>
 
 #include "sde_core_irq.h"
 #include "sde_power_handle.h"
 
+static void _sde_core_irq_report_no_cb(int irq_idx, int enable_counts)
+{
+	/*
+	 * If enable count is zero and callback list is empty, then it's
+	 * not a fatal issue. Log this case as debug. If the enable
+	 * count is nonzero and callback list is empty, then its a real
+	 * issue. Log this case as error to ensure we don't have silent
+	 * IRQs running.
+	 */
+	if (!enable_counts) {
+		SDE_DEBUG("irq has no callback, idx %d enables %d\n",
+				irq_idx, enable_counts);
+		SDE_EVT32_IRQ(irq_idx, enable_counts);
+	} else {
+		SDE_ERROR("irq has no callback, idx %d enables %d\n",
+				irq_idx, enable_counts);
+		SDE_EVT32_IRQ(irq_idx, enable_counts, SDE_EVTLOG_ERROR);
+	}
+}
+
 /**
- * sde_core_irq_callback_handler - dispatch core interrupts
- * @arg:		private data of callback handler
+ * _sde_core_irq_run_callbacks - run the registered callbacks of an interrupt
+ * @irq_obj:		Pointer to the irq object, cb_lock must be held
  * @irq_idx:		interrupt index
+ * @enable_counts:	set to the enable count if no callback is registered
+ * Returns:		true if the callback list was empty
  */
-static void sde_core_irq_callback_handler(void *arg, int irq_idx)
+static bool _sde_core_irq_run_callbacks(struct sde_irq *irq_obj, int irq_idx,
+		int *enable_counts)
 {
-	struct sde_kms *sde_kms = arg;
-	struct sde_irq *irq_obj = &sde_kms->irq_obj;
 	struct sde_irq_callback *cb;
-	unsigned long irq_flags;
 	bool cb_tbl_error = false;
-	int enable_counts = 0;
-
-	pr_debug("irq_idx=%d\n", irq_idx);
+	u64 start, cost;
+	u32 bucket;
 
-	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	if (list_empty(&irq_obj->irq_cb_tbl[irq_idx])) {
-		/* print error outside lock */
 		cb_tbl_error = true;
-		enable_counts = atomic_read(
-				&sde_kms->irq_obj.enable_counts[irq_idx]);
+		*enable_counts = atomic_read(&irq_obj->enable_counts[irq_idx]);
 	}
 
 	atomic_inc(&irq_obj->irq_counts[irq_idx]);
@@ -43,30 +62,45 @@ static void sde_core_irq_callback_handler(void *arg, int irq_idx)
 	/*
 	 * Perform registered function callback
 	 */
+	start = local_clock();
 	list_for_each_entry(cb, &irq_obj->irq_cb_tbl[irq_idx], list)
 		if (cb->func)
 			cb->func(cb->arg, irq_idx);
-	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
 
-	if (cb_tbl_error) {
-		/*
-		 * If enable count is zero and callback list is empty, then it's
-		 * not a fatal issue. Log this case as debug. If the enable
-		 * count is nonzero and callback list is empty, then its a real
-		 * issue. Log this case as error to ensure we don't have silent
-		 * IRQs running.
-		 */
-		if (!enable_counts) {
-			SDE_DEBUG("irq has no callback, idx %d enables %d\n",
-					irq_idx, enable_counts);
-			SDE_EVT32_IRQ(irq_idx, enable_counts);
-		} else {
-			SDE_ERROR("irq has no callback, idx %d enables %d\n",
-					irq_idx, enable_counts);
-			SDE_EVT32_IRQ(irq_idx, enable_counts, SDE_EVTLOG_ERROR);
-		}
+	if (irq_obj->irq_cost) {
+		cost = div_u64(local_clock() - start, NSEC_PER_USEC);
+		bucket = cost ? min_t(u32, ilog2(cost) + 1,
+				SDE_IRQ_COST_BUCKETS - 1) : 0;
+		irq_obj->irq_cost[irq_idx][bucket]++;
 	}
 
+	return cb_tbl_error;
+}
+
+/**
+ * sde_core_irq_callback_handler - dispatch core interrupts
+ * @arg:		private data of callback handler
+ * @irq_idx:		interrupt index
+ */
+static void sde_core_irq_callback_handler(void *arg, int irq_idx)
+{
+	struct sde_kms *sde_kms = arg;
+	struct sde_irq *irq_obj = &sde_kms->irq_obj;
+	unsigned long irq_flags;
+	bool cb_tbl_error;
+	int enable_counts = 0;
+
+	pr_debug("irq_idx=%d\n", irq_idx);
+
+	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
+	cb_tbl_error = _sde_core_irq_run_callbacks(irq_obj, irq_idx,
+			&enable_counts);
+	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+
+	/* print error outside lock */
+	if (cb_tbl_error)
+		_sde_core_irq_report_no_cb(irq_idx, enable_counts);
+
 	/*
 	 * Clear pending interrupt status in HW.
 	 * NOTE: sde_core_irq_callback_handler is protected by top-level
@@ -77,6 +111,63 @@ static void sde_core_irq_callback_handler(void *arg, int irq_idx)
 			irq_idx);
 }
 
+/**
+ * sde_core_irq_batch_handler - collect core interrupts for batched dispatch
+ * @arg:		private data of callback handler
+ * @irq_idx:		interrupt index
+ */
+static void sde_core_irq_batch_handler(void *arg, int irq_idx)
+{
+	struct sde_kms *sde_kms = arg;
+
+	/* serialized by the hw_intr irq_lock held across the dispatch */
+	__set_bit(irq_idx, sde_kms->irq_obj.batch_mask);
+
+	sde_kms->hw_intr->ops.clear_intr_status_nolock(
+			sde_kms->hw_intr,
+			irq_idx);
+}
+
+/**
+ * _sde_core_irq_batch_dispatch - read all pending interrupts, then run the
+ *	callbacks of every fired interrupt under a single callback lock hold
+ * @sde_kms:		Pointer to sde kms context
+ *
+ * Callbacks are run in irq_idx order, which keeps the interrupts of one
+ * status register, and so of one interface or writeback block, together.
+ * The added latency is bounded by a single scan of the status registers.
+ */
+static void _sde_core_irq_batch_dispatch(struct sde_kms *sde_kms)
+{
+	struct sde_irq *irq_obj = &sde_kms->irq_obj;
+	struct sde_hw_intr *intr = sde_kms->hw_intr;
+	unsigned long irq_flags;
+	int irq_idx, enable_counts;
+	u64 start, defer;
+
+	start = local_clock();
+	intr->ops.dispatch_irqs(intr, sde_core_irq_batch_handler, sde_kms);
+
+	/*
+	 * Callbacks expect the hw_intr lock to be held, as in the direct
+	 * dispatch, since some of them disable their irq with the nolock api.
+	 */
+	spin_lock_irqsave(&intr->irq_lock, irq_flags);
+	spin_lock(&irq_obj->cb_lock);
+	defer = local_clock() - start;
+	if (defer > irq_obj->batch_max_defer_ns)
+		irq_obj->batch_max_defer_ns = defer;
+
+	for_each_set_bit(irq_idx, irq_obj->batch_mask, irq_obj->total_irqs) {
+		__clear_bit(irq_idx, irq_obj->batch_mask);
+		enable_counts = 0;
+		if (_sde_core_irq_run_callbacks(irq_obj, irq_idx, &enable_counts))
+			_sde_core_irq_report_no_cb(irq_idx, enable_counts);
+	}
+	spin_unlock(&irq_obj->cb_lock);
+	spin_unlock_irqrestore(&intr->irq_lock, irq_flags);
+}
+
 int sde_core_irq_idx_lookup(struct sde_kms *sde_kms,
 		enum sde_intr_type intr_type, u32 instance_idx)
 {
@@ -398,12 +489,51 @@ static int sde_debugfs_core_irq_show(struct seq_file *s, void *v)
 
 DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_core_irq);
 
+static int sde_debugfs_core_irq_cost_show(struct seq_file *s, void *v)
+{
+	struct sde_irq *irq_obj = s->private;
+	u32 cost[SDE_IRQ_COST_BUCKETS];
+	unsigned long irq_flags;
+	int i, j;
+
+	if (!irq_obj || !irq_obj->irq_cost) {
+		SDE_ERROR("invalid parameters\n");
+		return 0;
+	}
+
+	seq_printf(s, "batch:%d max_defer_ns:%llu\n", irq_obj->batch_enable,
+			irq_obj->batch_max_defer_ns);
+	seq_puts(s, "idx:   <1us    <2us    <4us    <8us   <16us   <32us   <64us  >=64us\n");
+
+	for (i = 0; i < irq_obj->total_irqs; i++) {
+		spin_lock_irqsave(&irq_obj->cb_lock, irq_flags);
+		memcpy(cost, irq_obj->irq_cost[i], sizeof(cost));
+		spin_unlock_irqrestore(&irq_obj->cb_lock, irq_flags);
+
+		if (!atomic_read(&irq_obj->irq_counts[i]))
+			continue;
+
+		seq_printf(s, "%3d:", i);
+		for (j = 0; j < SDE_IRQ_COST_BUCKETS; j++)
+			seq_printf(s, " %7u", cost[j]);
+		seq_puts(s, "\n");
+	}
+
+	return 0;
+}
+
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_core_irq_cost);
+
 int sde_debugfs_core_irq_init(struct sde_kms *sde_kms,
 		struct dentry *parent)
 {
 	sde_kms->irq_obj.debugfs_file = debugfs_create_file("core_irq", 0400,
 			parent, &sde_kms->irq_obj,
 			&sde_debugfs_core_irq_fops);
+	debugfs_create_file("core_irq_cost", 0400, parent, &sde_kms->irq_obj,
+			&sde_debugfs_core_irq_cost_fops);
+	debugfs_create_bool("core_irq_batch", 0600, parent,
+			&sde_kms->irq_obj.batch_enable);
 
 	return 0;
 }
@@ -464,6 +594,14 @@ void sde_core_irq_preinstall(struct sde_kms *sde_kms)
 			|| !sde_kms->irq_obj.irq_counts)
 		return;
 
+	/* batching and cost tracking are optional, the irq path checks them */
+	sde_kms->irq_obj.irq_cost = kcalloc(sde_kms->irq_obj.total_irqs,
+			sizeof(*sde_kms->irq_obj.irq_cost), GFP_KERNEL);
+	sde_kms->irq_obj.batch_mask = bitmap_zalloc(sde_kms->irq_obj.total_irqs,
+			GFP_KERNEL);
+	sde_kms->irq_obj.batch_enable = false;
+	sde_kms->irq_obj.batch_max_defer_ns = 0;
+
 	for (i = 0; i < sde_kms->irq_obj.total_irqs; i++) {
 		if (sde_kms->irq_obj.irq_cb_tbl)
 			INIT_LIST_HEAD(&sde_kms->irq_obj.irq_cb_tbl[i]);
@@ -510,9 +648,13 @@ void sde_core_irq_uninstall(struct sde_kms *sde_kms)
 	kfree(sde_kms->irq_obj.irq_cb_tbl);
 	kfree(sde_kms->irq_obj.enable_counts);
 	kfree(sde_kms->irq_obj.irq_counts);
+	kfree(sde_kms->irq_obj.irq_cost);
+	bitmap_free(sde_kms->irq_obj.batch_mask);
 	sde_kms->irq_obj.irq_cb_tbl = NULL;
 	sde_kms->irq_obj.enable_counts = NULL;
 	sde_kms->irq_obj.irq_counts = NULL;
+	sde_kms->irq_obj.irq_cost = NULL;
+	sde_kms->irq_obj.batch_mask = NULL;
 	sde_kms->irq_obj.total_irqs = 0;
 	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
 }
@@ -624,7 +766,15 @@ irqreturn_t sde_core_irq(struct sde_kms *sde_kms)
 	 * callback, and do the interrupt status clearing once the registered
 	 * callback is finished.
 	 * Function will also clear the interrupt status after reading.
+	 * In batched mode the callbacks of all fired interrupts are run
+	 * together once the status registers have been read.
 	 */
+	if (READ_ONCE(sde_kms->irq_obj.batch_enable) &&
+			sde_kms->irq_obj.batch_mask) {
+		_sde_core_irq_batch_dispatch(sde_kms);
+		return IRQ_HANDLED;
+	}
+
 	sde_kms->hw_intr->ops.dispatch_irqs(
 			sde_kms->hw_intr,
 			sde_core_irq_callback_handler,
@@ -505,6 +505,28 @@ void sde_core_perf_crtc_update_llcc(struct drm_crtc *crtc)
 	mutex_unlock(&sde_core_perf_lock);
 };
 
+bool sde_core_perf_plane_cache_allowed(struct sde_kms *kms, u32 fb_reuse_cnt)
+{
+	u32 threshold;
+
+	if (!kms)
+		return false;
+
+	/*
+	 * Layers that keep their buffer, e.g. a wallpaper, are worth keeping
+	 * in the cache, while frequently updated layers like video would only
+	 * evict them and are left to read from ddr.
+	 */
+	threshold = READ_ONCE(kms->perf.llcc_reuse_threshold);
+	if (!threshold || fb_reuse_cnt >= threshold) {
+		kms->perf.llcc_planes_cached++;
+		return true;
+	}
+
+	kms->perf.llcc_planes_bypassed++;
+	return false;
+}
+
 static void _sde_core_uidle_setup_wd(struct sde_kms *kms,
 	bool enable)
 {
@@ -922,6 +944,33 @@ static u64 _sde_core_perf_get_core_clk_rate(struct sde_kms *kms)
 	return clk_rate;
 }
 
+/*
+ * _sde_core_perf_hold_vote - check if a lower vote is close enough to the
+ *	current vote to keep the current vote in place
+ * @kms: Pointer to the kms
+ * @new: new vote being requested
+ * @old: vote currently in place
+ *
+ * Frames with a similar layer mix produce slightly different bandwidth and
+ * clock requirements. Without hysteresis every small drop is voted at the
+ * end of the commit and raised again before the next kickoff. Hold the
+ * current vote while the drop stays within the hysteresis percentage.
+ */
+static bool _sde_core_perf_hold_vote(struct sde_kms *kms, u64 new, u64 old)
+{
+	u32 pct = min_t(u32, kms->perf.hysteresis_pct, 100);
+
+	if (!pct || !new)
+		return false;
+
+	if (new >= old - div_u64(old * pct, 100)) {
+		kms->perf.votes_held++;
+		return true;
+	}
+
+	return false;
+}
+
 static void _sde_core_perf_crtc_update_check(struct drm_crtc *crtc,
 		int params_changed,
 		int *update_bus, int *update_clk)
@@ -950,7 +999,9 @@ static void _sde_core_perf_crtc_update_check(struct drm_crtc *crtc,
 		if ((params_changed &&
 				(new->bw_ctl[i] > old->bw_ctl[i])) ||
 				(!params_changed &&
-				(new->bw_ctl[i] < old->bw_ctl[i]))) {
+				(new->bw_ctl[i] < old->bw_ctl[i]) &&
+				!_sde_core_perf_hold_vote(kms,
+					new->bw_ctl[i], old->bw_ctl[i]))) {
 
 			SDE_DEBUG(
 				"crtc=%d p=%d new_bw=%llu,old_bw=%llu\n",
@@ -965,7 +1016,10 @@ static void _sde_core_perf_crtc_update_check(struct drm_crtc *crtc,
 				 old->max_per_pipe_ib[i])) ||
 				(!params_changed &&
 				(new->max_per_pipe_ib[i] <
-				old->max_per_pipe_ib[i]))) {
+				old->max_per_pipe_ib[i]) &&
+				!_sde_core_perf_hold_vote(kms,
+					new->max_per_pipe_ib[i],
+					old->max_per_pipe_ib[i]))) {
 
 			SDE_DEBUG(
 				"crtc=%d p=%d new_ib=%llu,old_ib=%llu\n",
@@ -1006,7 +1060,9 @@ static void _sde_core_perf_crtc_update_check(struct drm_crtc *crtc,
 	if ((params_changed &&
 			(new->core_clk_rate > old->core_clk_rate)) ||
 			(!params_changed && new->core_clk_rate &&
-			(new->core_clk_rate < old->core_clk_rate)) ||
+			(new->core_clk_rate < old->core_clk_rate) &&
+			!_sde_core_perf_hold_vote(kms, new->core_clk_rate,
+				old->core_clk_rate)) ||
 			kms->perf.perf_tune.mode_changed) {
 		old->core_clk_rate = new->core_clk_rate;
 		*update_clk = 1;
@@ -1338,6 +1394,265 @@ static ssize_t _sde_core_perf_mmrm_read(struct file *file,
 	return len;
 }
 
+static ssize_t _sde_core_perf_llcc_policy_read(struct file *file,
+			char __user *buff, size_t count, loff_t *ppos)
+{
+	struct sde_core_perf *perf = file->private_data;
+	struct drm_crtc *crtc;
+	u64 saved_bw = 0;
+	int len = 0;
+	char buf[256] = {'\0'};
+
+	if (!perf || !perf->dev)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;	/* the end */
+
+	drm_for_each_crtc(crtc, perf->dev)
+		saved_bw += READ_ONCE(to_sde_crtc(crtc)->llcc_saved_bw);
+
+	len = snprintf(buf, sizeof(buf),
+			"reuse_threshold:%u cached:%llu bypassed:%llu ddr_saved_bw:%llu\n",
+			perf->llcc_reuse_threshold, perf->llcc_planes_cached,
+			perf->llcc_planes_bypassed, saved_bw);
+	if (len < 0 || len >= sizeof(buf))
+		return 0;
+
+	if ((count < sizeof(buf)) || copy_to_user(buff, buf, len))
+		return -EFAULT;
+
+	*ppos += len;   /* increase offset */
+
+	return len;
+}
+
+static const struct file_operations sde_core_perf_llcc_policy_fops = {
+	.open = simple_open,
+	.read = _sde_core_perf_llcc_policy_read,
+};
+
+#define SDE_PERF_SIM_MAX_PLANES	SDE_STAGE_MAX
+
+/**
+ * struct sde_core_perf_sim_plane - synthetic plane of the perf simulation
+ * @src_w: source width in pixels
+ * @src_h: source height in pixels
+ * @dst_w: destination width in pixels
+ * @dst_h: destination height in pixels
+ * @bpp: bits per pixel of the fetched format
+ * @yuv: true for yuv formats
+ */
+struct sde_core_perf_sim_plane {
+	u32 src_w;
+	u32 src_h;
+	u32 dst_w;
+	u32 dst_h;
+	u32 bpp;
+	bool yuv;
+};
+
+/**
+ * struct sde_core_perf_sim - synthetic layer stack of the perf simulation
+ * @hdisplay: active width of the simulated mode
+ * @vdisplay: active height of the simulated mode
+ * @vtotal: total lines of the simulated mode
+ * @fps: refresh rate of the simulated mode
+ * @num_planes: number of valid entries in @planes
+ * @planes: synthetic planes composed on the simulated mode
+ */
+struct sde_core_perf_sim {
+	u32 hdisplay;
+	u32 vdisplay;
+	u32 vtotal;
+	u32 fps;
+	u32 num_planes;
+	struct sde_core_perf_sim_plane planes[SDE_PERF_SIM_MAX_PLANES];
+};
+
+/*
+ * Bandwidth and clock votes are computed by user space and only checked
+ * against the catalog limits in sde_core_perf_crtc_check(), so the
+ * simulation estimates the votes a layer stack needs with the usual
+ * fetch rate model and reports the margins left against the catalog.
+ */
+static int _sde_core_perf_sim_show(struct sde_core_perf *perf, char *buf,
+		size_t size)
+{
+	struct sde_mdss_cfg *catalog = perf->catalog;
+	struct sde_core_perf_sim *sim = perf->sim;
+	struct sde_perf_cfg *cfg = &catalog->perf;
+	u64 ab = 0, ib, max_ib = 0, clk, max_clk, line_rate;
+	u32 vscale, prefill, max_prefill = 0, vblank;
+	u32 maxdwnscale = 0, pipes = 0, lms;
+	int i, len;
+	bool fail = false;
+
+	if (catalog->sspp_count && catalog->sspp[0].sblk)
+		maxdwnscale = catalog->sspp[0].sblk->maxdwnscale;
+
+	line_rate = (u64)sim->vtotal * sim->fps;
+	max_clk = (u64)sim->hdisplay * line_rate;
+	vblank = sim->vtotal > sim->vdisplay ? sim->vtotal - sim->vdisplay : 0;
+	lms = catalog->max_mixer_width ?
+		DIV_ROUND_UP(sim->hdisplay, catalog->max_mixer_width) : 1;
+
+	len = scnprintf(buf, size, "mode:%ux%u vtotal:%u fps:%u planes:%u\n",
+			sim->hdisplay, sim->vdisplay, sim->vtotal, sim->fps,
+			sim->num_planes);
+
+	for (i = 0; i < sim->num_planes; i++) {
+		struct sde_core_perf_sim_plane *p = &sim->planes[i];
+
+		/* fetch rate scales with the vertical downscale ratio */
+		vscale = max_t(u32, 1000, mult_frac(p->src_h, 1000, p->dst_h));
+		ib = div_u64((u64)p->src_w * p->bpp * line_rate * vscale, 8 * 1000);
+		ab += div_u64((u64)p->src_w * p->src_h * p->bpp * sim->fps, 8);
+		max_ib = max(max_ib, ib);
+
+		clk = div_u64((u64)sim->hdisplay * line_rate * vscale, 1000);
+		max_clk = max(max_clk, clk);
+
+		prefill = cfg->min_prefill_lines + cfg->xtra_prefill_lines +
+			(p->yuv ? cfg->yuv_nv12_prefill_lines :
+			cfg->linear_prefill_lines);
+		if (vscale > 1000)
+			prefill += cfg->downscaling_prefill_lines;
+		max_prefill = max(max_prefill, prefill);
+
+		/* wide sources are split across a pair of pipes */
+		pipes += (p->src_w > catalog->max_sspp_linewidth) ? 2 : 1;
+		if (p->src_w > 2 * catalog->max_sspp_linewidth ||
+				(maxdwnscale && (p->src_w > p->dst_w * maxdwnscale ||
+				p->src_h > p->dst_h * maxdwnscale))) {
+			len += scnprintf(buf + len, size - len,
+					"plane%d: unsupported scaling or width\n", i);
+			fail = true;
+		}
+
+		len += scnprintf(buf + len, size - len,
+				"plane%d: %ux%u->%ux%u bpp:%u ib:%llu prefill:%u\n",
+				i, p->src_w, p->src_h, p->dst_w, p->dst_h, p->bpp,
+				ib, prefill);
+	}
+
+	if (div_u64(ab, 1000) > cfg->max_bw_high || max_clk > perf->max_core_clk_rate ||
+			max_prefill > vblank || pipes > catalog->sspp_count ||
+			lms > catalog->mixer_count ||
+			sim->num_planes > catalog->max_mixer_blendstages)
+		fail = true;
+
+	len += scnprintf(buf + len, size - len,
+			"ab:%llu/%llu ib:%llu clk:%llu/%llu prefill:%u/%u pipes:%u/%u lms:%u/%u\n",
+			ab, (u64)cfg->max_bw_high * 1000, max_ib, max_clk,
+			perf->max_core_clk_rate, max_prefill, vblank, pipes,
+			catalog->sspp_count, lms, catalog->mixer_count);
+	len += scnprintf(buf + len, size - len, "result:%s\n",
+			fail ? "fail" : "pass");
+
+	return len;
+}
+
+static ssize_t _sde_core_perf_sim_write(struct file *file,
+		    const char __user *user_buf, size_t count, loff_t *ppos)
+{
+	struct sde_core_perf *perf = file->private_data;
+	struct sde_core_perf_sim *sim;
+	char *buf, *cur, *token;
+	u32 yuv;
+	int ret = count;
+
+	if (!perf || !perf->catalog)
+		return -ENODEV;
+
+	if (!count || count >= SZ_4K)
+		return -EINVAL;
+
+	buf = memdup_user_nul(user_buf, count);
+	if (IS_ERR(buf))
+		return PTR_ERR(buf);
+
+	sim = kzalloc(sizeof(*sim), GFP_KERNEL);
+	if (!sim) {
+		ret = -ENOMEM;
+		goto end;
+	}
+
+	/* <hdisplay> <vdisplay> <vtotal> <fps>;<sw>,<sh>,<dw>,<dh>,<bpp>[,<yuv>];... */
+	cur = strim(buf);
+	token = strsep(&cur, ";");
+	if (sscanf(token, "%u %u %u %u", &sim->hdisplay, &sim->vdisplay,
+			&sim->vtotal, &sim->fps) != 4 || !sim->hdisplay ||
+			!sim->vdisplay || sim->vtotal < sim->vdisplay || !sim->fps) {
+		ret = -EINVAL;
+		goto end;
+	}
+
+	while ((token = strsep(&cur, ";")) != NULL) {
+		struct sde_core_perf_sim_plane *p;
+
+		if (!*strim(token))
+			continue;
+
+		if (sim->num_planes >= SDE_PERF_SIM_MAX_PLANES) {
+			ret = -E2BIG;
+			goto end;
+		}
+
+		p = &sim->planes[sim->num_planes];
+		yuv = 0;
+		if (sscanf(token, "%u,%u,%u,%u,%u,%u", &p->src_w, &p->src_h,
+				&p->dst_w, &p->dst_h, &p->bpp, &yuv) < 5 ||
+				!p->src_w || !p->src_h || !p->dst_w || !p->dst_h ||
+				!p->bpp) {
+			ret = -EINVAL;
+			goto end;
+		}
+		p->yuv = !!yuv;
+		sim->num_planes++;
+	}
+
+	mutex_lock(&sde_core_perf_lock);
+	swap(perf->sim, sim);
+	mutex_unlock(&sde_core_perf_lock);
+
+end:
+	kfree(sim);
+	kfree(buf);
+	return ret;
+}
+
+static ssize_t _sde_core_perf_sim_read(struct file *file,
+			char __user *buff, size_t count, loff_t *ppos)
+{
+	struct sde_core_perf *perf = file->private_data;
+	ssize_t len = 0;
+	char *buf;
+
+	if (!perf || !perf->catalog)
+		return -ENODEV;
+
+	buf = kzalloc(SZ_4K, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	mutex_lock(&sde_core_perf_lock);
+	if (perf->sim)
+		len = _sde_core_perf_sim_show(perf, buf, SZ_4K);
+	mutex_unlock(&sde_core_perf_lock);
+
+	len = simple_read_from_buffer(buff, count, ppos, buf, len);
+	kfree(buf);
+
+	return len;
+}
+
+static const struct file_operations sde_core_perf_sim_fops = {
+	.open = simple_open,
+	.read = _sde_core_perf_sim_read,
+	.write = _sde_core_perf_sim_write,
+};
+
 static const struct file_operations sde_core_perf_threshold_high_fops = {
 	.open = simple_open,
 	.read = _sde_core_perf_threshold_high_read,
@@ -1360,6 +1675,8 @@ static void sde_core_perf_debugfs_destroy(struct sde_core_perf *perf)
 {
 	debugfs_remove_recursive(perf->debugfs_root);
 	perf->debugfs_root = NULL;
+	kfree(perf->sim);
+	perf->sim = NULL;
 }
 
 int sde_core_perf_debugfs_init(struct sde_core_perf *perf,
@@ -1413,6 +1730,16 @@ int sde_core_perf_debugfs_init(struct sde_core_perf *perf,
 			&perf->fix_core_ab_vote);
 	debugfs_create_u32("sys_cache_enable", 0600, perf->debugfs_root,
 			&perf->sys_cache_enabled);
+	debugfs_create_u32("hysteresis_pct", 0600, perf->debugfs_root,
+			&perf->hysteresis_pct);
+	debugfs_create_u64("votes_held", 0400, perf->debugfs_root,
+			&perf->votes_held);
+	debugfs_create_u32("llcc_reuse_threshold", 0600, perf->debugfs_root,
+			&perf->llcc_reuse_threshold);
+	debugfs_create_file("llcc_policy", 0400, perf->debugfs_root,
+			perf, &sde_core_perf_llcc_policy_fops);
+	debugfs_create_file("perf_sim", 0600, perf->debugfs_root,
+			perf, &sde_core_perf_sim_fops);
 
 	debugfs_create_u32("uidle_perf_cnt", 0600, perf->debugfs_root,
 			&sde_kms->catalog->uidle_cfg.debugfs_perf);
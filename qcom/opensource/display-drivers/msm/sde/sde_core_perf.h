@@ -14,6 +14,9 @@
 #include "sde_hw_catalog.h"
 #include "sde_power_handle.h"
 
+struct sde_kms;
+struct sde_core_perf_sim;
+
 #define SDE_PERF_DEFAULT_MAX_CORE_CLK_RATE	320000000
 
 /**
@@ -78,6 +81,15 @@ struct sde_core_perf_tune {
  * @uidle_enabled: indicates if uidle is already enabled
  * @core_clk_reserve_rate: reserve core clk rate for built-in display
  * @sys_cache_enabled: override system cache enable state
+ * @hysteresis_pct: percentage below the current vote that a lower bandwidth
+ *                  or clock request must reach before the vote is reduced
+ * @votes_held: number of vote reductions skipped due to @hysteresis_pct
+ * @llcc_reuse_threshold: number of consecutive commits a plane must keep the
+ *                        same framebuffer before it is allowed into the
+ *                        static display system cache, 0 caches all planes
+ * @llcc_planes_cached: planes admitted to the static display system cache
+ * @llcc_planes_bypassed: planes kept out of it by @llcc_reuse_threshold
+ * @sim: synthetic layer stack evaluated through the perf_sim debugfs node
  */
 struct sde_core_perf {
 	struct drm_device *dev;
@@ -100,6 +112,12 @@ struct sde_core_perf {
 	bool uidle_enabled;
 	u64 core_clk_reserve_rate;
 	u32 sys_cache_enabled;
+	u32 hysteresis_pct;
+	u64 votes_held;
+	u32 llcc_reuse_threshold;
+	u64 llcc_planes_cached;
+	u64 llcc_planes_bypassed;
+	struct sde_core_perf_sim *sim;
 };
 
 /**
@@ -108,6 +126,14 @@ struct sde_core_perf {
  */
 void sde_core_perf_crtc_update_llcc(struct drm_crtc *crtc);
 
+/**
+ * sde_core_perf_plane_cache_allowed - apply the per plane system cache policy
+ * @kms: Pointer to the kms
+ * @fb_reuse_cnt: consecutive commits the plane kept its framebuffer
+ * return: true if the plane may read through the static display cache
+ */
+bool sde_core_perf_plane_cache_allowed(struct sde_kms *kms, u32 fb_reuse_cnt);
+
 /**
  * sde_core_perf_crtc_check - validate performance of the given crtc state
  * @crtc: Pointer to crtc
@@ -21,6 +21,7 @@
 #include <linux/sort.h>
 #include <linux/debugfs.h>
 #include <linux/ktime.h>
+#include <linux/vmalloc.h>
 #include <drm/sde_drm.h>
 #include <drm/drm_mode.h>
 #include <drm/drm_crtc.h>
@@ -633,6 +634,7 @@ static void sde_crtc_destroy(struct drm_crtc *crtc)
 
 	sde_fence_deinit(sde_crtc->output_fence);
 	_sde_crtc_deinit_events(sde_crtc);
+	vfree(sde_crtc->frame_log);
 
 	drm_crtc_cleanup(crtc);
 	mutex_destroy(&sde_crtc->crtc_lock);
@@ -1358,8 +1360,208 @@ static int _sde_crtc_check_planes_within_crtc_roi(struct drm_crtc *crtc,
 	return 0;
 }
 
+/*
+ * _sde_crtc_update_idle_frame - flag frames identical to the previous one
+ * A frame is identical when the same planes are staged and none of them,
+ * nor the crtc, changed framebuffer, geometry or properties.
+ */
+static void _sde_crtc_update_idle_frame(struct drm_crtc *crtc,
+		struct drm_crtc_state *state)
+{
+	struct sde_crtc_state *cstate = to_sde_crtc_state(state);
+	struct drm_plane_state *old_pstate, *new_pstate;
+	struct drm_crtc_state *old_state;
+	struct sde_plane_state *pstate;
+	struct drm_plane *plane;
+	int i;
+
+	cstate->idle_frame = false;
+
+	old_state = drm_atomic_get_old_crtc_state(state->state, crtc);
+	if (!old_state || drm_atomic_crtc_needs_modeset(state) ||
+			old_state->plane_mask != state->plane_mask ||
+			!list_empty(&cstate->property_state.dirty_list))
+		return;
+
+	for_each_oldnew_plane_in_state(state->state, plane, old_pstate,
+			new_pstate, i) {
+		if (new_pstate->crtc != crtc && old_pstate->crtc != crtc)
+			continue;
+
+		pstate = to_sde_plane_state(new_pstate);
+		if (new_pstate->fb != old_pstate->fb ||
+				new_pstate->crtc_x != old_pstate->crtc_x ||
+				new_pstate->crtc_y != old_pstate->crtc_y ||
+				new_pstate->crtc_w != old_pstate->crtc_w ||
+				new_pstate->crtc_h != old_pstate->crtc_h ||
+				new_pstate->src_x != old_pstate->src_x ||
+				new_pstate->src_y != old_pstate->src_y ||
+				new_pstate->src_w != old_pstate->src_w ||
+				new_pstate->src_h != old_pstate->src_h ||
+				!list_empty(&pstate->property_state.dirty_list))
+			return;
+	}
+
+	cstate->idle_frame = true;
+}
+
+static void _sde_crtc_clear_auto_roi(struct drm_crtc_state *state,
+		struct sde_connector_state *c_state)
+{
+	struct sde_crtc_state *cstate = to_sde_crtc_state(state);
+
+	memset(&cstate->user_roi_list, 0, sizeof(cstate->user_roi_list));
+	if (c_state)
+		memset(&c_state->rois, 0, sizeof(c_state->rois));
+	cstate->auto_roi = false;
+}
+
+static u32 _sde_crtc_roi_align(u32 val, u32 align)
+{
+	return align > 1 ? rounddown(val, align) : val;
+}
+
+/**
+ * _sde_crtc_set_auto_roi - derive a partial update roi from the planes
+ * @crtc: Pointer to drm crtc
+ * @state: Pointer to drm crtc state
+ * @roi_caps: Partial update capabilities of the connected panel
+ *
+ * Only clients that program the roi properties get partial updates on
+ * command mode panels. When the client leaves them alone, transfer the
+ * aligned bounding box of all staged planes instead of the full frame.
+ * The roi has to contain every plane entirely, so this only helps when the
+ * planes leave part of the screen uncovered, e.g. AOD or static UI with a
+ * solid background. Returns 0 on success, and when no roi is derived.
+ */
+static int _sde_crtc_set_auto_roi(struct drm_crtc *crtc,
+		struct drm_crtc_state *state, struct msm_roi_caps *roi_caps)
+{
+	struct sde_crtc *sde_crtc = to_sde_crtc(crtc);
+	struct sde_crtc_state *cstate = to_sde_crtc_state(state);
+	const struct msm_roi_alignment *align = &roi_caps->align;
+	struct sde_connector_state *c_state;
+	struct drm_connector_state *conn_state;
+	struct sde_connector *c_conn;
+	const struct drm_plane_state *pstate;
+	struct drm_plane *plane;
+	struct drm_clip_rect box = { U16_MAX, U16_MAX, 0, 0 };
+	u32 crtc_width, crtc_height, w, h;
+
+	if (cstate->num_connectors != 1 || !cstate->connectors[0])
+		return 0;
+
+	c_conn = to_sde_connector(cstate->connectors[0]);
+	conn_state = drm_atomic_get_connector_state(state->state,
+			cstate->connectors[0]);
+	if (IS_ERR(conn_state))
+		return PTR_ERR(conn_state);
+	c_state = to_sde_connector_state(conn_state);
+
+	if (!sde_crtc->auto_roi_enable || sde_crtc->num_mixers != 1 ||
+			cstate->num_dim_layers || cstate->user_roi_list.num_rects ||
+			c_state->rois.num_rects || sde_crtc_is_crtc_roi_dirty(state) ||
+			msm_property_is_dirty(&c_conn->property_info,
+				&c_state->property_state, CONNECTOR_PROP_ROI_V1) ||
+			sde_connector_get_property(conn_state,
+				CONNECTOR_PROP_AUTOREFRESH) ||
+			!c_conn->encoder ||
+			sde_encoder_get_intf_mode(c_conn->encoder) != INTF_MODE_CMD)
+		return 0;
+
+	sde_crtc_get_resolution(crtc, state, &state->adjusted_mode,
+			&crtc_width, &crtc_height);
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		if (IS_ERR_OR_NULL(pstate))
+			return 0;
+
+		/* planes clipped by the crtc can not be within a roi */
+		if (pstate->crtc_x < 0 || pstate->crtc_y < 0 ||
+				pstate->crtc_x + pstate->crtc_w > crtc_width ||
+				pstate->crtc_y + pstate->crtc_h > crtc_height)
+			return 0;
+
+		box.x1 = min_t(u16, box.x1, pstate->crtc_x);
+		box.y1 = min_t(u16, box.y1, pstate->crtc_y);
+		box.x2 = max_t(u16, box.x2, pstate->crtc_x + pstate->crtc_w);
+		box.y2 = max_t(u16, box.y2, pstate->crtc_y + pstate->crtc_h);
+	}
+
+	if (box.x2 <= box.x1 || box.y2 <= box.y1)
+		return 0;
+
+	box.x1 = _sde_crtc_roi_align(box.x1, align->xstart_pix_align);
+	box.y1 = _sde_crtc_roi_align(box.y1, align->ystart_pix_align);
+	w = max_t(u32, box.x2 - box.x1, align->min_width);
+	h = max_t(u32, box.y2 - box.y1, align->min_height);
+	if (align->width_pix_align > 1)
+		w = roundup(w, align->width_pix_align);
+	if (align->height_pix_align > 1)
+		h = roundup(h, align->height_pix_align);
+
+	if (box.x1 + w > crtc_width || box.y1 + h > crtc_height ||
+			(w == crtc_width && h == crtc_height))
+		return 0;
+
+	box.x2 = box.x1 + w;
+	box.y2 = box.y1 + h;
+
+	cstate->user_roi_list.num_rects = 1;
+	cstate->user_roi_list.roi[0] = box;
+	c_state->rois.num_rects = 1;
+	c_state->rois.roi[0] = box;
+	cstate->auto_roi = true;
+
+	SDE_DEBUG("%s: auto roi (%d,%d) (%d,%d)\n", sde_crtc->name,
+			box.x1, box.y1, box.x2, box.y2);
+	SDE_EVT32_VERBOSE(DRMID(crtc), box.x1, box.y1, box.x2, box.y2);
+
+	return 0;
+}
+
+static int __sde_crtc_check_rois(struct drm_crtc *crtc,
+		struct drm_crtc_state *state, bool allow_auto_roi);
+
 static int _sde_crtc_check_rois(struct drm_crtc *crtc,
 		struct drm_crtc_state *state)
+{
+	struct sde_crtc_state *cstate = to_sde_crtc_state(state);
+	struct drm_connector_state *conn_state;
+	struct sde_connector_state *c_state;
+	int rc;
+
+	_sde_crtc_update_idle_frame(crtc, state);
+
+	/* rois derived for the previous frame are carried over, drop them */
+	if (cstate->auto_roi) {
+		c_state = NULL;
+		if (cstate->num_connectors && cstate->connectors[0]) {
+			conn_state = drm_atomic_get_connector_state(state->state,
+					cstate->connectors[0]);
+			if (IS_ERR(conn_state))
+				return PTR_ERR(conn_state);
+			c_state = to_sde_connector_state(conn_state);
+		}
+		_sde_crtc_clear_auto_roi(state, c_state);
+	}
+
+	rc = __sde_crtc_check_rois(crtc, state, true);
+	if (rc && cstate->auto_roi) {
+		/* a derived roi must never fail the commit, send the full frame */
+		SDE_DEBUG("crtc%d: auto roi rejected %d\n", DRMID(crtc), rc);
+		conn_state = drm_atomic_get_new_connector_state(state->state,
+				cstate->connectors[0]);
+		_sde_crtc_clear_auto_roi(state, conn_state ?
+				to_sde_connector_state(conn_state) : NULL);
+		rc = __sde_crtc_check_rois(crtc, state, false);
+	}
+
+	return rc;
+}
+
+static int __sde_crtc_check_rois(struct drm_crtc *crtc,
+		struct drm_crtc_state *state, bool allow_auto_roi)
 {
 	struct sde_crtc *sde_crtc;
 	struct sde_crtc_state *sde_crtc_state;
@@ -1435,6 +1637,13 @@ static int _sde_crtc_check_rois(struct drm_crtc *crtc,
 		if (!mode_info->roi_caps.enabled)
 			continue;
 
+		if (allow_auto_roi) {
+			rc = _sde_crtc_set_auto_roi(crtc, state,
+					&mode_info->roi_caps);
+			if (rc)
+				goto end;
+		}
+
 		if (sde_crtc_state->user_roi_list.num_rects >
 				mode_info->roi_caps.num_roi) {
 			SDE_ERROR("roi count is exceeding limit, %d > %d\n",
@@ -2791,6 +3000,138 @@ void sde_crtc_get_frame_data(struct drm_crtc *crtc)
 		_sde_crtc_frame_data_notify(crtc, data);
 }
 
+static struct sde_crtc_frame_record *_sde_crtc_frame_log_rec(
+		struct sde_crtc *sde_crtc, u64 seq)
+{
+	u32 idx;
+
+	div_u64_rem(seq, SDE_CRTC_FRAME_LOG_ENTRIES, &idx);
+
+	return &sde_crtc->frame_log->rec[idx];
+}
+
+static void _sde_crtc_frame_log_begin(struct sde_crtc *sde_crtc)
+{
+	struct sde_crtc_frame_log *log = sde_crtc->frame_log;
+	struct sde_crtc_frame_record *rec;
+	unsigned long flags;
+	u64 seq;
+
+	if (!log)
+		return;
+
+	spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+	seq = log->head + 1;
+	rec = _sde_crtc_frame_log_rec(sde_crtc, seq);
+
+	/* invalidate the slot before reusing it for lockless readers */
+	WRITE_ONCE(rec->seq, 0);
+	smp_wmb();
+	memset(rec->ts, 0, sizeof(rec->ts));
+	rec->flags = 0;
+	rec->underrun_cnt = 0;
+	rec->ts[SDE_CRTC_FRAME_STAGE_COMMIT] = ktime_get_ns();
+	smp_wmb();
+	WRITE_ONCE(rec->seq, seq);
+	WRITE_ONCE(log->head, seq);
+	spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+}
+
+static void _sde_crtc_frame_log_stamp(struct sde_crtc *sde_crtc,
+		enum sde_crtc_frame_stage stage, ktime_t ts)
+{
+	struct sde_crtc_frame_log *log = sde_crtc->frame_log;
+	struct sde_crtc_frame_record *rec;
+	unsigned long flags;
+
+	if (!log)
+		return;
+
+	spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+	if (!log->head)
+		goto end;
+
+	rec = _sde_crtc_frame_log_rec(sde_crtc, log->head);
+	rec->ts[stage] = ktime_to_ns(ts);
+
+	if (stage == SDE_CRTC_FRAME_STAGE_KICKOFF)
+		sde_crtc->frame_kickoff_seq = log->head;
+end:
+	spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+}
+
+static void _sde_crtc_frame_log_vsync(struct sde_crtc *sde_crtc, ktime_t ts)
+{
+	struct sde_crtc_frame_record *rec;
+	unsigned long flags;
+
+	if (!sde_crtc->frame_log)
+		return;
+
+	spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+	if (!sde_crtc->frame_kickoff_seq)
+		goto end;
+
+	/* only the first vsync after the kickoff belongs to the frame */
+	rec = _sde_crtc_frame_log_rec(sde_crtc, sde_crtc->frame_kickoff_seq);
+	if (rec->seq == sde_crtc->frame_kickoff_seq &&
+			!rec->ts[SDE_CRTC_FRAME_STAGE_VSYNC])
+		rec->ts[SDE_CRTC_FRAME_STAGE_VSYNC] = ktime_to_ns(ts);
+end:
+	spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+}
+
+static void _sde_crtc_frame_log_complete(struct sde_crtc *sde_crtc,
+		enum sde_crtc_frame_stage stage, u64 *cursor, ktime_t ts,
+		u32 rec_flags)
+{
+	struct sde_crtc_frame_record *rec;
+	unsigned long flags;
+
+	if (!sde_crtc->frame_log)
+		return;
+
+	spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+
+	/* completions arrive in kickoff order, skip commits never kicked off */
+	while (*cursor < sde_crtc->frame_kickoff_seq) {
+		(*cursor)++;
+		rec = _sde_crtc_frame_log_rec(sde_crtc, *cursor);
+		if (rec->seq != *cursor ||
+				!rec->ts[SDE_CRTC_FRAME_STAGE_KICKOFF])
+			continue;
+
+		rec->ts[stage] = ktime_to_ns(ts);
+		rec->flags |= rec_flags;
+		break;
+	}
+
+	spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+}
+
+void sde_crtc_frame_log_underrun(struct drm_crtc *crtc)
+{
+	struct sde_crtc *sde_crtc;
+	struct sde_crtc_frame_record *rec;
+	unsigned long flags;
+
+	if (!crtc)
+		return;
+
+	sde_crtc = to_sde_crtc(crtc);
+	if (!sde_crtc->frame_log)
+		return;
+
+	spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+	if (sde_crtc->frame_kickoff_seq) {
+		rec = _sde_crtc_frame_log_rec(sde_crtc,
+				sde_crtc->frame_kickoff_seq);
+		rec->flags |= SDE_CRTC_FRAME_REC_UNDERRUN;
+		rec->underrun_cnt++;
+	}
+	spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+}
+
 static void sde_crtc_frame_event_cb(void *data, u32 event, ktime_t ts)
 {
 	struct drm_crtc *crtc = (struct drm_crtc *)data;
@@ -2860,6 +3201,7 @@ void sde_crtc_prepare_commit(struct drm_crtc *crtc,
 	SDE_EVT32_VERBOSE(DRMID(crtc), cstate->cwb_enc_mask);
 
 	SDE_ATRACE_BEGIN("sde_crtc_prepare_commit");
+	_sde_crtc_frame_log_begin(sde_crtc);
 
 	/* identify connectors attached to this crtc */
 	cstate->num_connectors = 0;
@@ -3016,6 +3358,7 @@ static void sde_crtc_vblank_cb(void *data, ktime_t ts)
 
 	sde_crtc->vblank_last_cb_time = ts;
 	sysfs_notify_dirent(sde_crtc->vsync_event_sf);
+	_sde_crtc_frame_log_vsync(sde_crtc, ts);
 
 	drm_crtc_handle_vblank(crtc);
 	DRM_DEBUG_VBL("crtc%d, ts:%llu\n", crtc->base.id, ktime_to_us(ts));
@@ -3162,6 +3505,22 @@ static void sde_crtc_frame_event_work(struct kthread_work *work)
 		}
 	}
 
+	if (!in_clone_mode && (fevent->event &
+			SDE_ENCODER_FRAME_EVENT_SIGNAL_RELEASE_FENCE))
+		_sde_crtc_frame_log_complete(sde_crtc,
+				SDE_CRTC_FRAME_STAGE_DONE,
+				&sde_crtc->frame_done_seq, fevent->ts,
+				((fevent->event & SDE_ENCODER_FRAME_EVENT_ERROR) ?
+				SDE_CRTC_FRAME_REC_ERROR : 0) |
+				((fevent->event & SDE_ENCODER_FRAME_EVENT_PANEL_DEAD) ?
+				SDE_CRTC_FRAME_REC_PANEL_DEAD : 0));
+
+	if (!in_clone_mode && (fevent->event &
+			SDE_ENCODER_FRAME_EVENT_SIGNAL_RETIRE_FENCE))
+		_sde_crtc_frame_log_complete(sde_crtc,
+				SDE_CRTC_FRAME_STAGE_RETIRE,
+				&sde_crtc->frame_retire_seq, fevent->ts, 0);
+
 	if (fevent->event & SDE_ENCODER_FRAME_EVENT_SIGNAL_RELEASE_FENCE) {
 		SDE_ATRACE_BEGIN("signal_release_fence");
 		sde_fence_signal(sde_crtc->output_fence, fevent->ts,
@@ -4403,6 +4762,9 @@ static void sde_crtc_atomic_flush_common(struct drm_crtc *crtc,
 		sde_plane_flush(plane);
 	}
 
+	_sde_crtc_frame_log_stamp(sde_crtc, SDE_CRTC_FRAME_STAGE_PREPARE,
+			ktime_get());
+
 	/* Kickoff will be scheduled by outer layer */
 	SDE_ATRACE_END("sde_crtc_atomic_flush");
 }
@@ -4654,6 +5016,25 @@ int sde_crtc_reset_hw(struct drm_crtc *crtc, struct drm_crtc_state *old_state,
 	return !recovery_events ? 0 : -EAGAIN;
 }
 
+static void _sde_crtc_update_pu_stats(struct drm_crtc *crtc)
+{
+	struct sde_crtc *sde_crtc = to_sde_crtc(crtc);
+	struct sde_crtc_state *cstate = to_sde_crtc_state(crtc->state);
+	u32 width, height;
+
+	if (cstate->idle_frame)
+		sde_crtc->idle_frames++;
+
+	if (!cstate->auto_roi)
+		return;
+
+	sde_crtc_get_resolution(crtc, crtc->state, &crtc->state->adjusted_mode,
+			&width, &height);
+	sde_crtc->auto_roi_frames++;
+	sde_crtc->pixels_saved += (u64)width * height -
+			(u64)cstate->crtc_roi.w * cstate->crtc_roi.h;
+}
+
 void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 		struct drm_crtc_state *old_state)
 {
@@ -4738,6 +5119,7 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 	_sde_crtc_flush_frame_events(crtc);
 	SDE_ATRACE_END("flush_event_thread");
 	sde_crtc->plane_mask_old = crtc->state->plane_mask;
+	_sde_crtc_update_pu_stats(crtc);
 
 	if (atomic_inc_return(&sde_crtc->frame_pending) == 1) {
 		/* acquire bandwidth and other resources */
@@ -4771,6 +5153,8 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 		sde_encoder_kickoff(encoder, true);
 	}
 	sde_crtc->kickoff_in_progress = false;
+	_sde_crtc_frame_log_stamp(sde_crtc, SDE_CRTC_FRAME_STAGE_KICKOFF,
+			ktime_get());
 
 	/* store the event after frame trigger */
 	if (sde_crtc->event) {
@@ -7471,6 +7855,116 @@ static int sde_crtc_debugfs_state_show(struct seq_file *s, void *v)
 }
 DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_crtc_debugfs_state);
 
+static int sde_crtc_debugfs_commit_timing_show(struct seq_file *s, void *v)
+{
+	static const char * const stages[MSM_COMMIT_STAGE_MAX] = {
+		[MSM_COMMIT_STAGE_QUEUE] = "queue",
+		[MSM_COMMIT_STAGE_DISPATCH] = "dispatch",
+		[MSM_COMMIT_STAGE_FENCE] = "fence",
+		[MSM_COMMIT_STAGE_PROGRAM] = "program",
+		[MSM_COMMIT_STAGE_DONE] = "done",
+	};
+	struct drm_crtc *crtc = (struct drm_crtc *) s->private;
+	struct msm_drm_private *priv = crtc->dev->dev_private;
+	struct msm_commit_timing *timing = NULL;
+	int i;
+
+	for (i = 0; i < priv->num_crtcs; i++) {
+		if (priv->disp_thread[i].crtc_id == crtc->base.id) {
+			timing = &priv->disp_thread[i].timing;
+			break;
+		}
+	}
+
+	if (!timing)
+		return -ENODEV;
+
+	seq_printf(s, "commits: %llu\n", timing->count);
+	seq_puts(s, "stage      last_us    max_us     avg_us\n");
+	for (i = 0; i < MSM_COMMIT_STAGE_MAX; i++)
+		seq_printf(s, "%-10s %-10llu %-10llu %llu\n", stages[i],
+			timing->last_us[i], timing->max_us[i],
+			timing->count ? div64_u64(timing->total_us[i],
+				timing->count) : 0);
+
+	return 0;
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_crtc_debugfs_commit_timing);
+
+#define FRAME_LOG_DELTA_US(rec, stage) \
+	((rec)->ts[stage] ? div_u64((rec)->ts[stage] - \
+		(rec)->ts[SDE_CRTC_FRAME_STAGE_COMMIT], 1000) : 0)
+
+static int sde_crtc_debugfs_frame_log_show(struct seq_file *s, void *v)
+{
+	struct sde_crtc *sde_crtc = s->private;
+	struct sde_crtc_frame_log *log = sde_crtc->frame_log;
+	struct sde_crtc_frame_record *rec, copy;
+	unsigned long flags;
+	u64 head, seq;
+
+	if (!log)
+		return -ENOMEM;
+
+	seq_puts(s, "seq        commit_ns          prepare_us kickoff_us vsync_us   done_us    retire_us  flags underruns\n");
+
+	head = READ_ONCE(log->head);
+	seq = head > SDE_CRTC_FRAME_LOG_ENTRIES ?
+			head - SDE_CRTC_FRAME_LOG_ENTRIES + 1 : 1;
+	for (; seq && seq <= head; seq++) {
+		spin_lock_irqsave(&sde_crtc->frame_log_lock, flags);
+		rec = _sde_crtc_frame_log_rec(sde_crtc, seq);
+		copy = *rec;
+		spin_unlock_irqrestore(&sde_crtc->frame_log_lock, flags);
+
+		if (copy.seq != seq)
+			continue;
+
+		seq_printf(s, "%-10llu %-18llu %-10llu %-10llu %-10llu %-10llu %-10llu 0x%-3x %u\n",
+			copy.seq, copy.ts[SDE_CRTC_FRAME_STAGE_COMMIT],
+			FRAME_LOG_DELTA_US(&copy, SDE_CRTC_FRAME_STAGE_PREPARE),
+			FRAME_LOG_DELTA_US(&copy, SDE_CRTC_FRAME_STAGE_KICKOFF),
+			FRAME_LOG_DELTA_US(&copy, SDE_CRTC_FRAME_STAGE_VSYNC),
+			FRAME_LOG_DELTA_US(&copy, SDE_CRTC_FRAME_STAGE_DONE),
+			FRAME_LOG_DELTA_US(&copy, SDE_CRTC_FRAME_STAGE_RETIRE),
+			copy.flags, copy.underrun_cnt);
+	}
+
+	return 0;
+}
+
+static int sde_crtc_debugfs_frame_log_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, sde_crtc_debugfs_frame_log_show,
+			inode->i_private);
+}
+
+static int sde_crtc_debugfs_frame_log_mmap(struct file *file,
+		struct vm_area_struct *vma)
+{
+	struct seq_file *s = file->private_data;
+	struct sde_crtc *sde_crtc = s->private;
+
+	if (!sde_crtc->frame_log)
+		return -ENOMEM;
+
+	/* the log is owned by the driver, userspace only gets to look */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+	return remap_vmalloc_range(vma, sde_crtc->frame_log, vma->vm_pgoff);
+}
+
+static const struct file_operations sde_crtc_debugfs_frame_log_fops = {
+	.owner = THIS_MODULE,
+	.open = sde_crtc_debugfs_frame_log_open,
+	.release = single_release,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.mmap = sde_crtc_debugfs_frame_log_mmap,
+};
+
 static int _sde_debugfs_fence_status_show(struct seq_file *s, void *data)
 {
 	struct drm_crtc *crtc;
@@ -7613,6 +8107,19 @@ static int _sde_crtc_init_debugfs(struct drm_crtc *crtc)
 					sde_crtc, &debugfs_fps_fops);
 	debugfs_create_file("fence_status", 0400, sde_crtc->debugfs_root,
 					sde_crtc, &debugfs_fence_fops);
+	debugfs_create_file("commit_timing", 0400, sde_crtc->debugfs_root,
+					&sde_crtc->base,
+					&sde_crtc_debugfs_commit_timing_fops);
+	debugfs_create_file("frame_log", 0400, sde_crtc->debugfs_root,
+					sde_crtc, &sde_crtc_debugfs_frame_log_fops);
+	debugfs_create_bool("auto_partial_update", 0600, sde_crtc->debugfs_root,
+			&sde_crtc->auto_roi_enable);
+	debugfs_create_u32("auto_roi_frames", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->auto_roi_frames);
+	debugfs_create_u32("idle_frames", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->idle_frames);
+	debugfs_create_u64("pixels_saved", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->pixels_saved);
 
 	if (sde_kms->catalog->hw_fence_rev) {
 		debugfs_create_file("hwfence_features_mask", 0600, sde_crtc->debugfs_root,
@@ -7863,6 +8370,7 @@ void sde_crtc_static_img_control(struct drm_crtc *crtc,
 	struct drm_plane *plane;
 	struct sde_crtc *sde_crtc;
 	struct sde_kms *sde_kms;
+	u64 saved_bw;
 
 	if (!crtc || !crtc->dev)
 		return;
@@ -7915,8 +8423,16 @@ void sde_crtc_static_img_control(struct drm_crtc *crtc,
 	SDE_EVT32(DRMID(crtc), state, sde_crtc->cache_state, sde_crtc->cache_type);
 
 	sde_crtc->cache_state = state;
-	drm_atomic_crtc_for_each_plane(plane, crtc)
+	saved_bw = 0;
+	drm_atomic_crtc_for_each_plane(plane, crtc) {
 		sde_plane_static_img_control(plane, sde_crtc->cache_state, sde_crtc->cache_type);
+		if (state == CACHE_STATE_FRAME_READ)
+			saved_bw += sde_plane_get_cached_fetch_bytes(plane);
+	}
+
+	if (crtc->state)
+		saved_bw *= drm_mode_vrefresh(&crtc->state->adjusted_mode);
+	WRITE_ONCE(sde_crtc->llcc_saved_bw, saved_bw);
 }
 
 /*
@@ -8041,6 +8557,7 @@ struct drm_crtc *sde_crtc_init(struct drm_device *dev, struct drm_plane *plane)
 	mutex_init(&sde_crtc->crtc_lock);
 	spin_lock_init(&sde_crtc->spin_lock);
 	spin_lock_init(&sde_crtc->fevent_spin_lock);
+	spin_lock_init(&sde_crtc->frame_log_lock);
 	atomic_set(&sde_crtc->frame_pending, 0);
 
 	sde_crtc->enabled = false;
@@ -8119,6 +8636,13 @@ struct drm_crtc *sde_crtc_init(struct drm_device *dev, struct drm_plane *plane)
 	kthread_init_delayed_work(&sde_crtc->static_cache_read_work,
 			__sde_crtc_static_cache_read_work);
 
+	/* frame log is best effort, the crtc works without it */
+	sde_crtc->frame_log = vmalloc_user(sizeof(*sde_crtc->frame_log));
+	if (sde_crtc->frame_log) {
+		sde_crtc->frame_log->version = SDE_CRTC_FRAME_LOG_VERSION;
+		sde_crtc->frame_log->entries = SDE_CRTC_FRAME_LOG_ENTRIES;
+	}
+
 	SDE_DEBUG("%s: successfully initialized crtc, hwfence_out:%d, hwfence_in:%d\n",
 		sde_crtc->name,
 		test_bit(HW_FENCE_OUT_FENCES_ENABLE, sde_crtc->hwfence_features_mask),
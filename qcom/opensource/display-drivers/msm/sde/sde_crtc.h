@@ -193,6 +193,66 @@ struct sde_ltm_buffer {
 	struct list_head node;
 };
 
+/* number of frame records kept per crtc, sized so the log fills 4 pages */
+#define SDE_CRTC_FRAME_LOG_ENTRIES	255
+#define SDE_CRTC_FRAME_LOG_VERSION	1
+
+#define SDE_CRTC_FRAME_REC_UNDERRUN	BIT(0)
+#define SDE_CRTC_FRAME_REC_ERROR	BIT(1)
+#define SDE_CRTC_FRAME_REC_PANEL_DEAD	BIT(2)
+
+/**
+ * enum sde_crtc_frame_stage - pipeline stages recorded in the frame log
+ * @SDE_CRTC_FRAME_STAGE_COMMIT:	commit started on the crtc
+ * @SDE_CRTC_FRAME_STAGE_PREPARE:	hardware programming done
+ * @SDE_CRTC_FRAME_STAGE_KICKOFF:	frame triggered
+ * @SDE_CRTC_FRAME_STAGE_VSYNC:		first vsync/TE after the kickoff
+ * @SDE_CRTC_FRAME_STAGE_DONE:		frame done, release fence signaled
+ * @SDE_CRTC_FRAME_STAGE_RETIRE:	retire fence signaled
+ */
+enum sde_crtc_frame_stage {
+	SDE_CRTC_FRAME_STAGE_COMMIT,
+	SDE_CRTC_FRAME_STAGE_PREPARE,
+	SDE_CRTC_FRAME_STAGE_KICKOFF,
+	SDE_CRTC_FRAME_STAGE_VSYNC,
+	SDE_CRTC_FRAME_STAGE_DONE,
+	SDE_CRTC_FRAME_STAGE_RETIRE,
+	SDE_CRTC_FRAME_STAGE_MAX
+};
+
+/**
+ * struct sde_crtc_frame_record - timestamps of one frame through the pipeline
+ * @seq:          frame sequence number, 0 while the record is being reset
+ * @ts:           CLOCK_MONOTONIC timestamp in ns for each stage, 0 if not
+ *                reached (yet)
+ * @flags:        SDE_CRTC_FRAME_REC_* flags
+ * @underrun_cnt: underruns reported while this frame was on screen
+ */
+struct sde_crtc_frame_record {
+	u64 seq;
+	u64 ts[SDE_CRTC_FRAME_STAGE_MAX];
+	u32 flags;
+	u32 underrun_cnt;
+};
+
+/**
+ * struct sde_crtc_frame_log - frame record ring shared read only with
+ *                             userspace through debugfs mmap
+ * @version: layout version, SDE_CRTC_FRAME_LOG_VERSION
+ * @entries: number of records in @rec
+ * @head:    sequence number of the most recent record, which lives at
+ *           rec[head % entries]. A record is consistent if its seq reads
+ *           the same before and after copying it.
+ * @rec:     record ring
+ */
+struct sde_crtc_frame_log {
+	u32 version;
+	u32 entries;
+	u64 head;
+	u64 reserved[6];
+	struct sde_crtc_frame_record rec[SDE_CRTC_FRAME_LOG_ENTRIES];
+};
+
 /**
  * struct sde_crtc_misr_info - structure for misr information
  * @misr_enable : enable/disable flag
@@ -335,6 +395,13 @@ enum sde_crtc_hw_fence_flags {
  * @static_cache_read_work: delayed worker to transition cache state to read
  * @cache_state     : Current static image cache state
  * @cache_type      : Current static image cache type to use
+ * @llcc_saved_bw   : estimated ddr read bandwidth served from the system cache
+ *                    while the static image is read from it, in bytes/sec
+ * @frame_log       : per frame pipeline timestamps, NULL if allocation failed
+ * @frame_log_lock  : spinlock protecting @frame_log and the cursors below
+ * @frame_kickoff_seq : sequence number of the last kicked off frame
+ * @frame_done_seq  : sequence number of the last frame done frame
+ * @frame_retire_seq : sequence number of the last retired frame
  * @dspp_blob_info  : blob containing dspp hw capability information
  * @cached_encoder_mask : cached encoder_mask for vblank work
  * @valid_skip_blend_plane: flag to indicate if skip blend plane is valid
@@ -349,6 +416,11 @@ enum sde_crtc_hw_fence_flags {
  *                          sde_crtc_hw_fence_flags for available fields.
  * @hwfence_out_fences_skip: number of frames to skip before create a new hw-fence, this can be
  *                   used to slow-down creation of output hw-fences for debugging purposes.
+ * @auto_roi_enable : derive a partial update roi from the planes when the
+ *                    client does not program one
+ * @auto_roi_frames : number of frames kicked off with a derived roi
+ * @idle_frames     : number of kicked off frames identical to the previous one
+ * @pixels_saved    : number of pixels not transferred due to derived rois
  */
 struct sde_crtc {
 	struct drm_crtc base;
@@ -444,6 +516,13 @@ struct sde_crtc {
 	struct kthread_delayed_work static_cache_read_work;
 	enum sde_sys_cache_state cache_state;
 	enum sde_sys_cache_type cache_type;
+	u64 llcc_saved_bw;
+
+	struct sde_crtc_frame_log *frame_log;
+	spinlock_t frame_log_lock;
+	u64 frame_kickoff_seq;
+	u64 frame_done_seq;
+	u64 frame_retire_seq;
 
 	struct drm_property_blob *dspp_blob_info;
 	u32 cached_encoder_mask;
@@ -461,6 +540,11 @@ struct sde_crtc {
 
 	DECLARE_BITMAP(hwfence_features_mask, HW_FENCE_FEATURES_MAX);
 	u32 hwfence_out_fences_skip;
+
+	bool auto_roi_enable;
+	u32 auto_roi_frames;
+	u32 idle_frames;
+	u64 pixels_saved;
 };
 
 enum sde_crtc_dirty_flags {
@@ -524,6 +608,8 @@ struct sde_line_insertion_param {
  * @cont_splash_populated: State was populated as part of cont. splash
  * @param: sde line insertion parameters
  * @hwfence_in_fences_set: input hw fences are configured for the commit
+ * @auto_roi: user_roi_list and connector rois were derived from the planes
+ * @idle_frame: no plane or crtc state changed compared to the previous frame
  */
 struct sde_crtc_state {
 	struct drm_crtc_state base;
@@ -566,6 +652,8 @@ struct sde_crtc_state {
 	bool cont_splash_populated;
 	struct sde_line_insertion_param line_insertion;
 	bool hwfence_in_fences_set;
+	bool auto_roi;
+	bool idle_frame;
 };
 
 enum sde_crtc_irq_state {
@@ -1169,4 +1257,10 @@ bool sde_crtc_is_line_insertion_supported(struct drm_crtc *crtc);
 void sde_crtc_calc_vpadding_param(struct drm_crtc_state *state, u32 crtc_y, u32 crtc_h,
 				  u32 *padding_y, u32 *padding_start, u32 *padding_height);
 
+/**
+ * sde_crtc_frame_log_underrun - flag an underrun on the frame on screen
+ * @crtc: Pointer to drm crtc structure
+ */
+void sde_crtc_frame_log_underrun(struct drm_crtc *crtc);
+
 #endif /* _SDE_CRTC_H_ */
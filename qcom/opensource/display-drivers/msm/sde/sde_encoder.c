@@ -3800,6 +3800,7 @@ static void sde_encoder_underrun_callback(struct drm_encoder *drm_enc,
 
 	trace_sde_encoder_underrun(DRMID(drm_enc),
 		atomic_read(&phy_enc->underrun_cnt));
+	sde_crtc_frame_log_underrun(sde_enc->crtc);
 
 	if (phy_enc->sde_kms &&
 			phy_enc->sde_kms->catalog->uidle_cfg.debugfs_perf)
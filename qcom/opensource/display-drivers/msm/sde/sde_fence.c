@@ -883,14 +883,17 @@ static int _sde_fence_create_fd(void *fence_ctx, uint32_t val, struct sde_hw_ctl
 	}
 
 	/* If ctl_id is valid, try to create a hw-fence */
-	if (hw_ctl)
-		sde_fence_create_hw_fence(hw_ctl, sde_fence);
+	if (hw_ctl && sde_fence_create_hw_fence(hw_ctl, sde_fence))
+		hw_ctl = NULL;
 
 	fd_install(fd, sync_file->file);
 	sde_fence->fd = fd;
 
 	spin_lock(&ctx->list_lock);
 	list_add_tail(&sde_fence->fence_list, &ctx->fence_list_head);
+	ctx->fence_cnt++;
+	if (hw_ctl)
+		ctx->hw_fence_cnt++;
 	spin_unlock(&ctx->list_lock);
 
 exit:
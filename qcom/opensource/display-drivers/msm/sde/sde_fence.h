@@ -36,6 +36,8 @@
  * @context: fence context
  * @list_head: fence list to hold all the fence created on this context
  * @name: name of fence context/timeline
+ * @fence_cnt: number of fences created on this context
+ * @hw_fence_cnt: number of those fences that are also backed by a hw-fence
  */
 struct sde_fence_context {
 	unsigned int commit_count;
@@ -47,6 +49,8 @@ struct sde_fence_context {
 	u64 context;
 	struct list_head fence_list_head;
 	char name[SDE_FENCE_NAME_SIZE];
+	u32 fence_cnt;
+	u32 hw_fence_cnt;
 };
 
 /**
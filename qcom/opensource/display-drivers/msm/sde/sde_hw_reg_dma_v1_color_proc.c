@@ -4,6 +4,7 @@
  * Copyright (c) 2017-2021, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/xxhash.h>
 #include <drm/msm_drm_pp.h>
 #include "sde_reg_dma.h"
 #include "sde_hw_reg_dma_v1_color_proc.h"
@@ -134,6 +135,24 @@ static struct sde_reg_dma_buffer
 	*sspp_buf[SDE_SSPP_RECT_MAX][REG_DMA_FEATURES_MAX][SSPP_MAX];
 static struct sde_reg_dma_buffer *ltm_buf[REG_DMA_FEATURES_MAX][LTM_MAX];
 
+/**
+ * struct reg_dma_payload_cache - describes the payload last built into a
+ *                               dspp reg dma buffer
+ * @hash: xxh64 hash of the user payload
+ * @len: length of the user payload
+ * @blk: dspp blocks the buffer was built for
+ * @valid: true if the buffer still holds the payload described here
+ */
+struct reg_dma_payload_cache {
+	u64 hash;
+	u32 len;
+	u32 blk;
+	bool valid;
+};
+
+static struct reg_dma_payload_cache
+	dspp_buf_cache[REG_DMA_FEATURES_MAX][DSPP_MAX];
+
 static u32 feature_map[SDE_DSPP_MAX] = {
 	[SDE_DSPP_VLUT] = VLUT,
 	[SDE_DSPP_GAMUT] = GAMUT,
@@ -874,6 +893,38 @@ void reg_dmav1_setup_dspp_3d_gamutv42(struct sde_hw_dspp *ctx, void *cfg)
 	}
 }
 
+static void _reg_dma_dspp_buf_cache_clear(u32 feature, enum sde_dspp idx)
+{
+	dspp_buf_cache[feature][idx].valid = false;
+}
+
+/*
+ * Returns true if the dspp buffer for the feature already holds the commands
+ * for this payload, in which case it can be kicked off again as is. The hash
+ * of the payload is returned so it can be recorded once the buffer is rebuilt.
+ */
+static bool _reg_dma_dspp_buf_cached(u32 feature, enum sde_dspp idx, u32 blk,
+		void *payload, u32 len, u64 *hash)
+{
+	struct reg_dma_payload_cache *cache = &dspp_buf_cache[feature][idx];
+
+	*hash = xxh64(payload, len, 0);
+
+	return cache->valid && cache->hash == *hash && cache->len == len &&
+		cache->blk == blk;
+}
+
+static void _reg_dma_dspp_buf_cache_set(u32 feature, enum sde_dspp idx,
+		u32 blk, u32 len, u64 hash)
+{
+	struct reg_dma_payload_cache *cache = &dspp_buf_cache[feature][idx];
+
+	cache->hash = hash;
+	cache->len = len;
+	cache->blk = blk;
+	cache->valid = true;
+}
+
 void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct drm_msm_pgc_lut *lut_cfg;
@@ -885,6 +936,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 	u32 reg;
 	u32 *addr[GC_TBL_NUM];
 	u32 num_of_mixers, blk = 0;
+	u64 hash;
 
 	rc = reg_dma_dspp_check(ctx, cfg, GC);
 	if (rc)
@@ -914,6 +966,11 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 
 	lut_cfg = hw_cfg->payload;
 	dma_ops = sde_reg_dma_get_ops();
+	if (_reg_dma_dspp_buf_cached(GC, ctx->idx, blk, hw_cfg->payload,
+			hw_cfg->len, &hash))
+		goto kickoff;
+
+	_reg_dma_dspp_buf_cache_clear(GC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[GC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, GC, dspp_buf[GC][ctx->idx]);
@@ -973,6 +1030,9 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
+	_reg_dma_dspp_buf_cache_set(GC, ctx->idx, blk, hw_cfg->len, hash);
+
+kickoff:
 	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GC][ctx->idx],
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE, GC);
 	LOG_FEATURE_ON;
@@ -1003,6 +1063,7 @@ static void _dspp_igcv31_off(struct sde_hw_dspp *ctx, void *cfg)
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
+	_reg_dma_dspp_buf_cache_clear(IGC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, IGC, dspp_buf[IGC][ctx->idx]);
@@ -1044,6 +1105,7 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 	u32 offset = 0;
 	u32 reg;
 	u32 index, num_of_mixers, dspp_sel, blk = 0;
+	u64 hash;
 
 	rc = reg_dma_dspp_check(ctx, cfg, IGC);
 	if (rc)
@@ -1083,6 +1145,12 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 	lut_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
+	/* hash the payload before the lut entries are tagged below */
+	if (_reg_dma_dspp_buf_cached(IGC, ctx->idx, blk, hw_cfg->payload,
+			hw_cfg->len, &hash))
+		goto kickoff;
+
+	_reg_dma_dspp_buf_cache_clear(IGC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, DSPP_IGC, IGC, dspp_buf[IGC][ctx->idx]);
@@ -1152,6 +1220,9 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
+	_reg_dma_dspp_buf_cache_set(IGC, ctx->idx, blk, hw_cfg->len, hash);
+
+kickoff:
 	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[IGC][ctx->idx],
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE, IGC);
 	LOG_FEATURE_ON;
@@ -1264,6 +1335,7 @@ static void _dspp_pcc_common_off(struct sde_hw_dspp *ctx, void *cfg)
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
+	_reg_dma_dspp_buf_cache_clear(PCC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, PCC, dspp_buf[PCC][ctx->idx]);
@@ -1304,6 +1376,7 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 	int rc, i = 0;
 	u32 reg = 0;
 	u32 num_of_mixers, blk = 0;
+	u64 hash;
 
 	rc = reg_dma_dspp_check(ctx, cfg, PCC);
 	if (rc)
@@ -1333,6 +1406,11 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 
 	pcc_cfg = hw_cfg->payload;
 	dma_ops = sde_reg_dma_get_ops();
+	if (_reg_dma_dspp_buf_cached(PCC, ctx->idx, blk, hw_cfg->payload,
+			hw_cfg->len, &hash))
+		goto kickoff;
+
+	_reg_dma_dspp_buf_cache_clear(PCC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, PCC, dspp_buf[PCC][ctx->idx]);
@@ -1407,6 +1485,9 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 		goto exit;
 	}
 
+	_reg_dma_dspp_buf_cache_set(PCC, ctx->idx, blk, hw_cfg->len, hash);
+
+kickoff:
 	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[PCC][ctx->idx],
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE, PCC);
 	LOG_FEATURE_ON;
@@ -1984,6 +2065,7 @@ int reg_dmav1_deinit_dspp_ops(enum sde_dspp idx)
 			continue;
 		dma_ops->dealloc_reg_dma(dspp_buf[i][idx]);
 		dspp_buf[i][idx] = NULL;
+		_reg_dma_dspp_buf_cache_clear(i, idx);
 	}
 	return 0;
 }
@@ -4380,6 +4462,7 @@ static void _dspp_igcv4_off(struct sde_hw_dspp *ctx, void *cfg)
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
+	_reg_dma_dspp_buf_cache_clear(IGC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, IGC, dspp_buf[IGC][ctx->idx]);
@@ -4445,6 +4528,7 @@ void reg_dmav2_setup_dspp_igcv4(struct sde_hw_dspp *ctx, void *cfg)
 	lut_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
+	_reg_dma_dspp_buf_cache_clear(IGC, ctx->idx);
 	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, IGC, dspp_buf[IGC][ctx->idx]);
@@ -218,6 +218,9 @@ struct sde_irq_callback {
 	void *arg;
 };
 
+/* number of log2 buckets, in microseconds, of the irq callback cost histogram */
+#define SDE_IRQ_COST_BUCKETS	8
+
 /**
  * struct sde_irq: IRQ structure contains callback registration info
  * @total_irq:    total number of irq_idx obtained from HW interrupts mapping
@@ -225,6 +228,12 @@ struct sde_irq_callback {
  * @enable_counts array of IRQ enable counts
  * @cb_lock:      callback lock
  * @debugfs_file: debugfs file for irq statistics
+ * @irq_cost:     per irq_idx histogram of the time spent in its callbacks
+ * @batch_mask:   irq_idx fired within the current batched dispatch
+ * @batch_enable: collect all pending irqs first and run their callbacks in
+ *                one pass under a single callback lock hold
+ * @batch_max_defer_ns: longest delay seen between reading the status of a
+ *                batched irq and running its callbacks
  */
 struct sde_irq {
 	u32 total_irqs;
@@ -233,6 +242,10 @@ struct sde_irq {
 	atomic_t *irq_counts;
 	spinlock_t cb_lock;
 	struct dentry *debugfs_file;
+	u32 (*irq_cost)[SDE_IRQ_COST_BUCKETS];
+	unsigned long *batch_mask;
+	bool batch_enable;
+	u64 batch_max_defer_ns;
 };
 
 /**
@@ -2755,6 +2755,14 @@ static int _sde_plane_atomic_check(struct drm_plane *plane,
 
 	SDE_DEBUG_PLANE(psde, "\n");
 
+	/* reuse history feeding the system cache policy */
+	if (state->fb && plane->state && state->fb == plane->state->fb) {
+		if (pstate->fb_reuse_cnt < U32_MAX)
+			pstate->fb_reuse_cnt++;
+	} else {
+		pstate->fb_reuse_cnt = 0;
+	}
+
 	ret = sde_plane_rot_atomic_check(plane, state);
 	if (ret)
 		goto exit;
@@ -2873,7 +2881,9 @@ static void _sde_plane_sspp_setup_sys_cache(struct sde_plane *psde,
 	 */
 	if (test_bit(SDE_SYS_CACHE_DISP, psde->catalog->sde_sys_cache_type_map)
 			&& ((cache_state == CACHE_STATE_FRAME_WRITE)
-				|| (cache_state == CACHE_STATE_FRAME_READ))) {
+				|| (cache_state == CACHE_STATE_FRAME_READ))
+			&& sde_core_perf_plane_cache_allowed(_sde_plane_get_kms(&psde->base),
+				pstate->fb_reuse_cnt)) {
 		cfg->type = pstate->static_cache_type;
 		cfg->rd_en = true;
 		cfg->rd_scid = sc_cfg[cfg->type].llcc_scid;
@@ -3625,6 +3635,24 @@ bool sde_plane_is_cache_required(struct drm_plane *plane,
 	return false;
 }
 
+u64 sde_plane_get_cached_fetch_bytes(struct drm_plane *plane)
+{
+	struct drm_plane_state *state;
+	struct sde_plane_state *pstate;
+
+	if (!plane || !plane->state || !plane->state->fb)
+		return 0;
+
+	state = plane->state;
+	pstate = to_sde_plane_state(state);
+	if (!pstate->sc_cfg.rd_en)
+		return 0;
+
+	/* first color plane only, static cached layers are rgb in practice */
+	return (u64)(state->src_w >> 16) * (state->src_h >> 16) *
+			state->fb->format->cpp[0];
+}
+
 static void _sde_plane_install_master_only_properties(struct sde_plane *psde)
 {
 	char feature_name[256];
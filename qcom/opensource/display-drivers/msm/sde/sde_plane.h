@@ -153,6 +153,7 @@ enum sde_plane_sclcheck_state {
  * @scaler_check_state: indicates status of user provided pixel extension data
  * @pre_down:		pre down scale configuration
  * @sc_cfg:		system cache configuration
+ * @fb_reuse_cnt:	consecutive commits the plane kept the same framebuffer
  * @rotation:		rotation cache state
  * @static_cache_state:	plane cache state for static image
  * @cdp_cfg:	CDP configuration
@@ -190,6 +191,7 @@ struct sde_plane_state {
 
 	/* @sc_cfg: system_cache configuration */
 	struct sde_hw_pipe_sc_cfg sc_cfg;
+	u32 fb_reuse_cnt;
 	uint32_t rotation;
 	uint32_t static_cache_state;
 	uint32_t static_cache_type;
@@ -408,6 +410,15 @@ void sde_plane_set_sid(struct drm_plane *plane, u32 vm);
 bool sde_plane_is_cache_required(struct drm_plane *plane,
 		enum sde_sys_cache_type type);
 
+/**
+ * sde_plane_get_cached_fetch_bytes - bytes fetched per frame through the
+ *	system cache by the plane
+ * @plane: Pointer to DRM plane object
+ * Returns: estimated bytes read per frame if the plane reads from the
+ *	system cache, otherwise 0
+ */
+u64 sde_plane_get_cached_fetch_bytes(struct drm_plane *plane);
+
 /**
  * sde_plane_static_img_control - Switch the static image state
  * @plane: Pointer to drm plane structure
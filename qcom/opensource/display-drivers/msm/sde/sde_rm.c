@@ -38,6 +38,9 @@
 #define RM_RQ_DCWB(r) ((r)->top_ctrl & BIT(SDE_RM_TOPCTL_DCWB))
 #define RM_RQ_DNSC_BLUR(r) ((r)->top_ctrl & BIT(SDE_RM_TOPCTL_DNSC_BLUR))
 #define RM_RQ_CDM(r) ((r)->top_ctrl & BIT(SDE_RM_TOPCTL_CDM))
+#define RM_RQ_KEY_TOP_CTRL(r) ((r)->top_ctrl & \
+		~(BIT(SDE_RM_TOPCTL_RESERVE_LOCK) | \
+		BIT(SDE_RM_TOPCTL_RESERVE_CLEAR)))
 #define RM_IS_TOPOLOGY_MATCH(t, r) ((t).num_lm == (r).num_lm && \
 				(t).num_comp_enc == (r).num_enc && \
 				(t).num_intf == (r).num_intf && \
@@ -141,6 +144,22 @@ struct sde_rm_requirements {
 	u32 conn_lm_mask;
 };
 
+/**
+ * struct sde_rm_rsvp_key - Requirements a reservation was made for
+ * @top_ctrl:  topology control preference, without the LOCK/CLEAR requests
+ * @top_name:  selected topology for the display
+ * @conn_lm_mask:  preferred LM mask of cwb requested display
+ * @hw_res:	   Hardware resources reported by the encoder, less comp_info
+ * @comp_info: Compression info reported by the encoder
+ */
+struct sde_rm_rsvp_key {
+	uint64_t top_ctrl;
+	enum sde_rm_topology_name top_name;
+	u32 conn_lm_mask;
+	struct sde_encoder_hw_resources hw_res;
+	struct msm_compression_info comp_info;
+};
+
 /**
  * struct sde_rm_rsvp - Use Case Reservation tagging structure
  *	Used to tag HW blocks as reserved by a CRTC->Encoder->Connector chain
@@ -155,6 +174,7 @@ struct sde_rm_requirements {
  *		An encoder or connector id identifies the display path.
  * @topology:	DRM<->HW topology use case
  * @pending:	True for pending rsvp-nxt, cleared when the rsvp is committed
+ * @key:	Requirements the reservation was made for
  */
 struct sde_rm_rsvp {
 	struct list_head list;
@@ -162,6 +182,7 @@ struct sde_rm_rsvp {
 	uint32_t enc_id;
 	enum sde_rm_topology_name topology;
 	bool pending;
+	struct sde_rm_rsvp_key key;
 };
 
 /**
@@ -885,6 +906,7 @@ static int _sde_rm_status_show(struct seq_file *s, void *data)
 		seq_printf(s, "type:%d blk:%s allocated:%d unallocated:%d\n",
 			type, sde_hw_blk_str[type], allocated, unallocated);
 	}
+	seq_printf(s, "rsvp_reuse:%u\n", rm->rsvp_reuse_cnt);
 
 	return 0;
 }
@@ -2724,6 +2746,73 @@ static void _sde_rm_populate_dp_lm_mask(struct sde_rm *rm,
 	SDE_EVT32(c_conn->encoder->base.id, conn->base.id, c_conn->lm_mask);
 }
 
+static void _sde_rm_make_rsvp_key(struct sde_rm_requirements *reqs,
+		struct sde_rm_rsvp_key *key)
+{
+	memset(key, 0, sizeof(*key));
+	key->top_ctrl = RM_RQ_KEY_TOP_CTRL(reqs);
+	key->top_name = reqs->topology->top_name;
+	key->conn_lm_mask = reqs->conn_lm_mask;
+	memcpy(key->hw_res.intfs, reqs->hw_res.intfs,
+			sizeof(key->hw_res.intfs));
+	memcpy(key->hw_res.wbs, reqs->hw_res.wbs, sizeof(key->hw_res.wbs));
+	key->hw_res.needs_cdm = reqs->hw_res.needs_cdm;
+	key->hw_res.display_num_of_h_tiles =
+			reqs->hw_res.display_num_of_h_tiles;
+	key->hw_res.display_type = reqs->hw_res.display_type;
+	key->hw_res.topology = reqs->hw_res.topology;
+	if (reqs->hw_res.comp_info)
+		memcpy(&key->comp_info, reqs->hw_res.comp_info,
+				sizeof(key->comp_info));
+}
+
+static bool _sde_rm_rsvp_key_match(struct sde_rm_rsvp *rsvp,
+		struct sde_rm_rsvp_key *key)
+{
+	return !memcmp(&rsvp->key, key, sizeof(*key));
+}
+
+/*
+ * Re-tag the blocks held by the current reservation of an encoder for a
+ * new reservation made with the same requirements, instead of searching
+ * all blocks again. Fails if any of those blocks is already claimed by a
+ * pending reservation so that the caller falls back to a full search.
+ * call this only after rm_mutex held
+ */
+static int _sde_rm_reuse_rsvp(struct sde_rm *rm, struct drm_encoder *enc,
+		struct sde_rm_rsvp *rsvp_cur, struct sde_rm_rsvp *rsvp)
+{
+	struct sde_rm_hw_blk *blk;
+	enum sde_hw_blk_type type;
+
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		list_for_each_entry(blk, &rm->hw_blks[type], list) {
+			if (blk->rsvp == rsvp_cur && blk->rsvp_nxt)
+				return -EBUSY;
+		}
+	}
+
+	rsvp->seq = ++rm->rsvp_next_seq;
+	rsvp->enc_id = enc->base.id;
+	rsvp->topology = rsvp_cur->topology;
+	rsvp->pending = true;
+	list_add_tail(&rsvp->list, &rm->rsvps);
+
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		list_for_each_entry(blk, &rm->hw_blks[type], list) {
+			if (blk->rsvp == rsvp_cur)
+				blk->rsvp_nxt = rsvp;
+		}
+	}
+
+	rm->rsvp_reuse_cnt++;
+	SDE_DEBUG("reuse rsvp[s%de%d] as rsvp[s%de%d]\n", rsvp_cur->seq,
+			rsvp_cur->enc_id, rsvp->seq, rsvp->enc_id);
+	SDE_EVT32(enc->base.id, rsvp_cur->seq, rsvp->seq, rsvp->topology);
+
+	return 0;
+}
+
 /* call this only after rm_mutex held */
 struct sde_rm_rsvp *_sde_rm_poll_get_rsvp_nxt_locked(struct sde_rm *rm,
 		struct drm_encoder *enc)
@@ -2757,9 +2846,11 @@ int sde_rm_reserve(
 {
 	struct sde_rm_rsvp *rsvp_cur, *rsvp_nxt;
 	struct sde_rm_requirements reqs = {0,};
+	struct sde_rm_rsvp_key *key;
 	struct msm_drm_private *priv;
 	struct sde_kms *sde_kms;
 	struct msm_compression_info *comp_info;
+	bool splash;
 	int ret = 0;
 
 	if (!rm || !enc || !crtc_state || !conn_state) {
@@ -2779,14 +2870,20 @@ int sde_rm_reserve(
 	sde_kms = to_sde_kms(priv->kms);
 
 	/* Check if this is just a page-flip */
-	if (!_sde_rm_is_display_in_cont_splash(sde_kms, enc) &&
-			!msm_atomic_needs_modeset(crtc_state, conn_state))
+	splash = _sde_rm_is_display_in_cont_splash(sde_kms, enc);
+	if (!splash && !msm_atomic_needs_modeset(crtc_state, conn_state))
 		return 0;
 
 	comp_info = kzalloc(sizeof(*comp_info), GFP_KERNEL);
 	if (!comp_info)
 		return -ENOMEM;
 
+	key = kzalloc(sizeof(*key), GFP_KERNEL);
+	if (!key) {
+		kfree(comp_info);
+		return -ENOMEM;
+	}
+
 	SDE_DEBUG("reserving hw for conn %d enc %d crtc %d test_only %d\n",
 			conn_state->connector->base.id, enc->base.id,
 			crtc_state->crtc->base.id, test_only);
@@ -2799,6 +2896,31 @@ int sde_rm_reserve(
 	rsvp_cur = _sde_rm_get_rsvp_cur(rm, enc);
 	rsvp_nxt = _sde_rm_get_rsvp_nxt(rm, enc);
 
+	if (!test_only && rsvp_nxt)
+		goto commit_rsvp;
+
+	reqs.hw_res.comp_info = comp_info;
+	ret = _sde_rm_populate_requirements(rm, enc, crtc_state,
+			conn_state, sde_kms->catalog, &reqs);
+	if (ret) {
+		SDE_ERROR("failed to populate hw requirements\n");
+		goto end;
+	}
+	_sde_rm_make_rsvp_key(&reqs, key);
+
+	/*
+	 * A pending reservation made for the same requirements already
+	 * proves this check can be satisfied, and it gets committed by the
+	 * commit that is in flight for it, so there is no need to wait.
+	 */
+	if (test_only && rsvp_nxt && !splash && !RM_RQ_CLEAR(&reqs) &&
+			!RM_RQ_LOCK(&reqs) && _sde_rm_rsvp_key_match(rsvp_nxt, key)) {
+		SDE_DEBUG("test_only: pending rsvp[s%de%d] matches\n",
+				rsvp_nxt->seq, rsvp_nxt->enc_id);
+		rm->rsvp_reuse_cnt++;
+		goto end;
+	}
+
 	/*
 	 * RM currently relies on rsvp_nxt assigned to the hw blocks to
 	 * commit rsvps. This rsvp_nxt can be cleared by a back to back
@@ -2821,17 +2943,6 @@ int sde_rm_reserve(
 		}
 	}
 
-	if (!test_only && rsvp_nxt)
-		goto commit_rsvp;
-
-	reqs.hw_res.comp_info = comp_info;
-	ret = _sde_rm_populate_requirements(rm, enc, crtc_state,
-			conn_state, sde_kms->catalog, &reqs);
-	if (ret) {
-		SDE_ERROR("failed to populate hw requirements\n");
-		goto end;
-	}
-
 	/*
 	 * We only support one active reservation per-hw-block. But to implement
 	 * transactional semantics for test-only, and for allowing failure while
@@ -2861,9 +2972,18 @@ int sde_rm_reserve(
 		_sde_rm_print_rsvps(rm, SDE_RM_STAGE_AFTER_CLEAR);
 	}
 
-	/* Check the proposed reservation, store it in hw's "next" field */
-	ret = _sde_rm_make_next_rsvp(rm, enc, crtc_state, conn_state,
-			rsvp_nxt, &reqs);
+	/*
+	 * Check the proposed reservation, store it in hw's "next" field.
+	 * If the requirements did not change since the current reservation
+	 * was made, the blocks it holds are known to satisfy them.
+	 */
+	if (rsvp_cur && !splash && _sde_rm_rsvp_key_match(rsvp_cur, key) &&
+			!_sde_rm_reuse_rsvp(rm, enc, rsvp_cur, rsvp_nxt))
+		ret = 0;
+	else
+		ret = _sde_rm_make_next_rsvp(rm, enc, crtc_state, conn_state,
+				rsvp_nxt, &reqs);
+	memcpy(&rsvp_nxt->key, key, sizeof(*key));
 
 	_sde_rm_print_rsvps(rm, SDE_RM_STAGE_AFTER_RSVPNEXT);
 
@@ -2893,6 +3013,7 @@ commit_rsvp:
 	_sde_rm_populate_dp_lm_mask(rm, conn_state->connector);
 
 end:
+	kfree(key);
 	kfree(comp_info);
 	_sde_rm_print_rsvps(rm, SDE_RM_STAGE_FINAL);
 	mutex_unlock(&rm->rm_lock);
@@ -174,6 +174,7 @@ struct sde_rm_topology_def {
  * @rsvp_next_seq: sequence number for next reservation for debugging purposes
  * @rm_lock: resource manager mutex
  * @avail_res: Pointer with curr available resources
+ * @rsvp_reuse_cnt: number of reservations satisfied without a block search
  */
 struct sde_rm {
 	struct drm_device *dev;
@@ -185,6 +186,7 @@ struct sde_rm {
 	struct mutex rm_lock;
 	const struct sde_rm_topology_def *topology_tbl;
 	struct msm_resource_caps_info avail_res;
+	u32 rsvp_reuse_cnt;
 };
 
 /**
@@ -643,8 +643,14 @@ static int sde_md_notify_handler(struct notifier_block *this,
 	sde_mini_dump_add_va_region("msm_drm_priv", sizeof(*priv), priv);
 	sde_mini_dump_add_va_region("sde_evtlog",
 			sizeof(*sde_dbg_base_evtlog), sde_dbg_base_evtlog);
+	sde_mini_dump_add_va_region("sde_evtlog_rings",
+			nr_cpu_ids * sizeof(*sde_dbg_base_evtlog->rings),
+			sde_dbg_base_evtlog->rings);
 	sde_mini_dump_add_va_region("sde_reglog",
 			sizeof(*sde_dbg_base_reglog), sde_dbg_base_reglog);
+	sde_mini_dump_add_va_region("sde_reglog_rings",
+			nr_cpu_ids * sizeof(*sde_dbg_base_reglog->rings),
+			sde_dbg_base_reglog->rings);
 
 	sde_mini_dump_add_va_region("sde_reg_dump", reg_dump_size, dbg_base->reg_dump_base);
 
@@ -1560,9 +1566,6 @@ static int sde_dbg_debugfs_open(struct inode *inode, struct file *file)
 	file->private_data = inode->i_private;
 	mutex_lock(&sde_dbg_base.mutex);
 	sde_dbg_base.cur_evt_index = 0;
-	sde_dbg_base.evtlog->first = (u32)atomic_add_return(0, &sde_dbg_base.evtlog->curr) + 1;
-	sde_dbg_base.evtlog->last =
-		sde_dbg_base.evtlog->first + SDE_EVTLOG_ENTRY;
 	mutex_unlock(&sde_dbg_base.mutex);
 	return 0;
 }
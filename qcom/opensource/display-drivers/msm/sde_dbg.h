@@ -10,6 +10,7 @@
 #include <stdarg.h>
 #include <linux/debugfs.h>
 #include <linux/list.h>
+#include <asm/local.h>
 #include <soc/qcom/minidump.h>
 #include <drm/drm_print.h>
 
@@ -136,6 +137,12 @@ enum sde_dbg_dump_context {
 #define SDE_EVTLOG_ENTRY	(SDE_EVTLOG_PRINT_ENTRY * 32)
 #endif /* IS_ENABLED(CONFIG_DRM_MSM_LOW_MEM_FOOTPRINT) */
 
+/*
+ * Each cpu logs into a private ring of this many entries so that logging an
+ * event never contends with other cpus. Dumps merge the rings by timestamp.
+ */
+#define SDE_EVTLOG_CPU_ENTRY	(SDE_EVTLOG_ENTRY / 4)
+
 #define SDE_EVTLOG_MAX_DATA 15
 #define SDE_EVTLOG_BUF_MAX 512
 #define SDE_EVTLOG_BUF_ALIGN 32
@@ -157,16 +164,30 @@ struct sde_dbg_evtlog_log {
 };
 
 /**
+ * struct sde_dbg_evtlog_ring - per cpu event log ring
+ * @logs: Ring of log entries
+ * @head: Number of entries ever written by this cpu
+ * @first: Index of next entry to be output during evtlog dumps
  * @last_dump: Index of last entry to be output during evtlog dumps
- * @filter_list: Linked list of currently active filter strings
+ * @next: Index of first entry not yet output by any dump
  */
-struct sde_dbg_evtlog {
-	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_ENTRY];
+struct sde_dbg_evtlog_ring {
+	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_CPU_ENTRY];
+	local_t head;
 	u32 first;
-	u32 last;
 	u32 last_dump;
-	atomic_t curr;
 	u32 next;
+};
+
+/**
+ * @rings: Per cpu event log rings, indexed by cpu id
+ * @prev_time: Timestamp of the last entry output during evtlog dumps
+ * @spin_lock: Serializes dumps and filter updates, never taken when logging
+ * @filter_list: Linked list of currently active filter strings
+ */
+struct sde_dbg_evtlog {
+	struct sde_dbg_evtlog_ring *rings;
+	s64 prev_time;
 	u32 enable;
 	u32 dump_mode;
 	char *dumped_evtlog;
@@ -197,16 +218,20 @@ struct sde_dbg_reglog_log {
 };
 
 /**
- * @last_dump: Index of last entry to be output during reglog dumps
- * @filter_list: Linked list of currently active filter strings
+ * struct sde_dbg_reglog_ring - per cpu register log ring
+ * @logs: Ring of log entries
+ * @head: Number of entries ever written by this cpu
  */
-struct sde_dbg_reglog {
+struct sde_dbg_reglog_ring {
 	struct sde_dbg_reglog_log logs[SDE_REGLOG_ENTRY];
-	u32 first;
-	u32 last;
-	u32 last_dump;
-	atomic64_t curr;
-	u32 next;
+	local_t head;
+};
+
+/**
+ * @rings: Per cpu register log rings, indexed by cpu id
+ */
+struct sde_dbg_reglog {
+	struct sde_dbg_reglog_ring *rings;
 	u32 enable;
 	u32 enable_mask;
 };
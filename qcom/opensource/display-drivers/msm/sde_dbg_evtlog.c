@@ -59,8 +59,9 @@ bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
 void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 		int flag, ...)
 {
-	int i, val = 0;
+	int i, val = 0, cpu;
 	va_list args;
+	struct sde_dbg_evtlog_ring *ring;
 	struct sde_dbg_evtlog_log *log;
 	u32 index;
 
@@ -68,15 +69,21 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 			_sde_evtlog_is_filtered_no_lock(evtlog, name))
 		return;
 
-	index = abs(atomic_inc_return(&evtlog->curr) % SDE_EVTLOG_ENTRY);
+	/*
+	 * Interrupts on this cpu may log while the entry is being filled in,
+	 * the local increment hands each of them a separate slot.
+	 */
+	cpu = get_cpu();
+	ring = &evtlog->rings[cpu];
+	index = (u32)local_inc_return(&ring->head) - 1;
 
-	log = &evtlog->logs[index];
+	log = &ring->logs[index % SDE_EVTLOG_CPU_ENTRY];
 	log->time = local_clock();
 	log->name = name;
 	log->line = line;
 	log->data_cnt = 0;
 	log->pid = current->pid;
-	log->cpu = raw_smp_processor_id();
+	log->cpu = cpu;
 
 	va_start(args, flag);
 	for (i = 0; i < SDE_EVTLOG_MAX_DATA; i++) {
@@ -89,29 +96,57 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 	}
 	va_end(args);
 	log->data_cnt = i;
-	evtlog->last++;
+	put_cpu();
 
 	trace_sde_evtlog(name, line, log->data_cnt, log->data);
 }
 
 void sde_reglog_log(u8 blk_id, u32 val, u32 addr)
 {
+	struct sde_dbg_reglog_ring *ring;
 	struct sde_dbg_reglog_log *log;
 	struct sde_dbg_reglog *reglog = sde_dbg_base_reglog;
-	int index;
+	u32 index;
 
 	if (!reglog || !reglog->enable)
 		return;
 
-	index = abs(atomic64_inc_return(&reglog->curr) % SDE_REGLOG_ENTRY);
+	ring = &reglog->rings[get_cpu()];
+	index = (u32)local_inc_return(&ring->head) - 1;
 
-	log = &reglog->logs[index];
+	log = &ring->logs[index % SDE_REGLOG_ENTRY];
 	log->blk_id = blk_id;
 	log->val = val;
 	log->addr = addr;
 	log->time = local_clock();
 	log->pid = current->pid;
-	reglog->last++;
+	put_cpu();
+}
+
+static inline struct sde_dbg_evtlog_log *_sde_evtlog_ring_entry(
+		struct sde_dbg_evtlog_ring *ring, u32 index)
+{
+	return &ring->logs[index % SDE_EVTLOG_CPU_ENTRY];
+}
+
+/* return the ring holding the oldest entry left to dump, if any */
+static struct sde_dbg_evtlog_ring *_sde_evtlog_oldest_ring(
+		struct sde_dbg_evtlog *evtlog)
+{
+	struct sde_dbg_evtlog_ring *ring, *oldest = NULL;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		ring = &evtlog->rings[cpu];
+		if (ring->first == ring->last_dump)
+			continue;
+
+		if (!oldest || _sde_evtlog_ring_entry(ring, ring->first)->time <
+				_sde_evtlog_ring_entry(oldest, oldest->first)->time)
+			oldest = ring;
+	}
+
+	return oldest;
 }
 
 /* always dump the last entries which are not dumped yet */
@@ -119,31 +154,44 @@ static bool _sde_evtlog_dump_calc_range(struct sde_dbg_evtlog *evtlog,
 		bool update_last_entry, bool full_dump)
 {
 	int max_entries = full_dump ? SDE_EVTLOG_ENTRY : SDE_EVTLOG_PRINT_ENTRY;
+	struct sde_dbg_evtlog_ring *ring;
+	u32 total = 0, skip;
+	int cpu;
 
 	if (!evtlog)
 		return false;
 
-	evtlog->first = evtlog->next;
+	if (!update_last_entry)
+		return _sde_evtlog_oldest_ring(evtlog) != NULL;
 
-	if (update_last_entry)
-		evtlog->last_dump = evtlog->last;
+	for_each_possible_cpu(cpu) {
+		ring = &evtlog->rings[cpu];
+		ring->first = ring->next;
+		ring->last_dump = (u32)local_read(&ring->head);
 
-	if (evtlog->last_dump == evtlog->first)
-		return false;
+		/* entries older than one ring length have been overwritten */
+		if ((ring->last_dump - ring->first) > SDE_EVTLOG_CPU_ENTRY)
+			ring->first = ring->last_dump - SDE_EVTLOG_CPU_ENTRY;
 
-	if (evtlog->last_dump < evtlog->first) {
-		evtlog->first %= SDE_EVTLOG_ENTRY;
-		if (evtlog->last_dump < evtlog->first)
-			evtlog->last_dump += SDE_EVTLOG_ENTRY;
+		total += ring->last_dump - ring->first;
 	}
 
-	if ((evtlog->last_dump - evtlog->first) > max_entries) {
-		pr_info("evtlog skipping %d entries, last=%d\n",
-			evtlog->last_dump - evtlog->first -
-			max_entries, evtlog->last_dump - 1);
-		evtlog->first = evtlog->last_dump - max_entries;
+	if (total > max_entries) {
+		skip = total - max_entries;
+		pr_info("evtlog skipping %d entries\n", skip);
+
+		while (skip--) {
+			ring = _sde_evtlog_oldest_ring(evtlog);
+			ring->first++;
+			ring->next = ring->first;
+		}
 	}
-	evtlog->next = evtlog->first + 1;
+
+	ring = _sde_evtlog_oldest_ring(evtlog);
+	if (!ring)
+		return false;
+
+	evtlog->prev_time = _sde_evtlog_ring_entry(ring, ring->first)->time;
 
 	return true;
 }
@@ -154,7 +202,8 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 {
 	int i;
 	ssize_t off = 0;
-	struct sde_dbg_evtlog_log *log, *prev_log;
+	struct sde_dbg_evtlog_ring *ring;
+	struct sde_dbg_evtlog_log *log;
 	unsigned long flags;
 
 	if (!evtlog || !evtlog_buf)
@@ -166,9 +215,8 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump))
 		goto exit;
 
-	log = &evtlog->logs[evtlog->first % SDE_EVTLOG_ENTRY];
-
-	prev_log = &evtlog->logs[(evtlog->first - 1) % SDE_EVTLOG_ENTRY];
+	ring = _sde_evtlog_oldest_ring(evtlog);
+	log = _sde_evtlog_ring_entry(ring, ring->first);
 
 	off = snprintf((evtlog_buf + off), (evtlog_buf_size - off), "%s:%-4d",
 		log->name, log->line);
@@ -179,14 +227,18 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	}
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
-		"=>[%-8d:%-11llu:%9llu][%-4d]:[%-4d]:", evtlog->first,
-		log->time, (log->time - prev_log->time), log->pid, log->cpu);
+		"=>[%-8d:%-11llu:%9llu][%-4d]:[%-4d]:", ring->first,
+		log->time, (log->time - evtlog->prev_time), log->pid, log->cpu);
 
 	for (i = 0; i < log->data_cnt; i++)
 		off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
 			"%x ", log->data[i]);
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off), "\n");
+
+	evtlog->prev_time = log->time;
+	ring->first++;
+	ring->next = ring->first;
 exit:
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
@@ -195,32 +247,20 @@ exit:
 
 u32 sde_evtlog_count(struct sde_dbg_evtlog *evtlog)
 {
-	u32 first, next, last, last_dump;
+	struct sde_dbg_evtlog_ring *ring;
+	u32 count = 0, pending;
+	int cpu;
 
 	if (!evtlog)
 		return 0;
 
-	first = evtlog->first;
-	next = evtlog->next;
-	last = evtlog->last;
-	last_dump = evtlog->last_dump;
-
-	first = next;
-	last_dump = last;
-
-	if (last_dump == first)
-		return 0;
-
-	if (last_dump < first) {
-		first %= SDE_EVTLOG_ENTRY;
-		if (last_dump < first)
-			last_dump += SDE_EVTLOG_ENTRY;
+	for_each_possible_cpu(cpu) {
+		ring = &evtlog->rings[cpu];
+		pending = (u32)local_read(&ring->head) - ring->next;
+		count += min_t(u32, pending, SDE_EVTLOG_CPU_ENTRY);
 	}
 
-	if ((last_dump - first) > SDE_EVTLOG_ENTRY)
-		return SDE_EVTLOG_ENTRY;
-
-	return last_dump - first;
+	return min_t(u32, count, SDE_EVTLOG_ENTRY);
 }
 
 struct sde_dbg_evtlog *sde_evtlog_init(void)
@@ -231,8 +271,13 @@ struct sde_dbg_evtlog *sde_evtlog_init(void)
 	if (!evtlog)
 		return ERR_PTR(-ENOMEM);
 
+	evtlog->rings = vzalloc(array_size(nr_cpu_ids, sizeof(*evtlog->rings)));
+	if (!evtlog->rings) {
+		vfree(evtlog);
+		return ERR_PTR(-ENOMEM);
+	}
+
 	spin_lock_init(&evtlog->spin_lock);
-	atomic_set(&evtlog->curr, 0);
 	evtlog->enable = SDE_EVTLOG_DEFAULT_ENABLE;
 	evtlog->dump_mode = SDE_DBG_DEFAULT_DUMP_MODE;
 
@@ -249,7 +294,11 @@ struct sde_dbg_reglog *sde_reglog_init(void)
 	if (!reglog)
 		return ERR_PTR(-ENOMEM);
 
-	atomic64_set(&reglog->curr, 0);
+	reglog->rings = vzalloc(array_size(nr_cpu_ids, sizeof(*reglog->rings)));
+	if (!reglog->rings) {
+		vfree(reglog);
+		return ERR_PTR(-ENOMEM);
+	}
 #if IS_ENABLED(CONFIG_DEBUG_FS)
 	reglog->enable = true;
 #else
@@ -358,6 +407,7 @@ void sde_evtlog_destroy(struct sde_dbg_evtlog *evtlog)
 		list_del(&filter_node->list);
 		kfree(filter_node);
 	}
+	vfree(evtlog->rings);
 	vfree(evtlog);
 }
 
@@ -366,5 +416,6 @@ void sde_reglog_destroy(struct sde_dbg_reglog *reglog)
 	if (!reglog)
 		return;
 
+	vfree(reglog->rings);
 	vfree(reglog);
 }
@@ -19,6 +19,7 @@
 #include <linux/errno.h>
 #include <linux/kthread.h>
 #include <linux/kfifo.h>
+#include <linux/ktime.h>
 
 #include "sde_hdcp_2x.h"
 
@@ -46,6 +47,26 @@
 /* Temporary define to override wrong TZ value */
 #define AKE_SEND_CERT_MSG_DELAY 100
 
+/**
+ * struct sde_hdcp_2x_auth_stats - authentication timing across sessions
+ * @auth_cnt:       successful authentications
+ * @stored_km_cnt:  authentications the TA completed with a stored km
+ * @fail_cnt:       sessions that stopped before authenticating
+ * @last_start_ms:  TA load and session setup time of the last session
+ * @last_auth_ms:   AKE_Init to encryption time of the last authentication
+ * @max_auth_ms:    slowest authentication seen
+ * @total_auth_ms:  sum of all authentication times, for the average
+ */
+struct sde_hdcp_2x_auth_stats {
+	u32 auth_cnt;
+	u32 stored_km_cnt;
+	u32 fail_cnt;
+	u32 last_start_ms;
+	u32 last_auth_ms;
+	u32 max_auth_ms;
+	u64 total_auth_ms;
+};
+
 struct sde_hdcp_2x_ctrl {
 	DECLARE_KFIFO(cmd_q, enum sde_hdcp_2x_wakeup_cmd, 8);
 	wait_queue_head_t wait_q;
@@ -55,6 +76,7 @@ struct sde_hdcp_2x_ctrl {
 	u32 total_message_length;
 	atomic_t enable_pending;
 	bool no_stored_km;
+	bool stored_km;
 	bool feature_supported;
 	bool force_encryption;
 	bool authenticated;
@@ -74,6 +96,9 @@ struct sde_hdcp_2x_ctrl {
 
 	struct task_struct *thread;
 	struct completion response_completion;
+
+	ktime_t auth_start;
+	struct sde_hdcp_2x_auth_stats stats;
 };
 
 static void sde_hdcp_2x_clean(struct sde_hdcp_2x_ctrl *hdcp);
@@ -351,6 +376,33 @@ static void sde_hdcp_2x_force_encryption(void *data, bool enable)
 	pr_info("force_encryption=%d\n", hdcp->force_encryption);
 }
 
+static void sde_hdcp_2x_auth_done(struct sde_hdcp_2x_ctrl *hdcp)
+{
+	struct sde_hdcp_2x_auth_stats *stats = &hdcp->stats;
+	u32 auth_ms;
+
+	hdcp->authenticated = true;
+	if (!hdcp->auth_start)
+		return;
+
+	auth_ms = ktime_ms_delta(ktime_get(), hdcp->auth_start);
+	hdcp->auth_start = 0;
+
+	stats->auth_cnt++;
+	if (hdcp->stored_km)
+		stats->stored_km_cnt++;
+	stats->last_auth_ms = auth_ms;
+	stats->max_auth_ms = max(stats->max_auth_ms, auth_ms);
+	stats->total_auth_ms += auth_ms;
+
+	SDE_EVT32_EXTERNAL(auth_ms, stats->last_start_ms, hdcp->stored_km);
+	pr_info("authenticated in %u ms (%s km, start %u ms), avg %llu ms, stored km %u/%u, failed %u\n",
+		auth_ms, hdcp->stored_km ? "stored" : "new",
+		stats->last_start_ms,
+		div_u64(stats->total_auth_ms, stats->auth_cnt),
+		stats->stored_km_cnt, stats->auth_cnt, stats->fail_cnt);
+}
+
 static void sde_hdcp_2x_clean(struct sde_hdcp_2x_ctrl *hdcp)
 {
 	struct list_head *element;
@@ -360,6 +412,11 @@ static void sde_hdcp_2x_clean(struct sde_hdcp_2x_ctrl *hdcp)
 	SDE_EVT32_EXTERNAL(SDE_EVTLOG_FUNC_ENTRY, hdcp->authenticated);
 	hdcp->authenticated = false;
 
+	if (hdcp->auth_start) {
+		hdcp->stats.fail_cnt++;
+		hdcp->auth_start = 0;
+	}
+
 	cdata.context = hdcp->client_data;
 	cdata.cmd = HDCP_TRANSPORT_CMD_STATUS_FAILED;
 
@@ -494,7 +551,7 @@ static void sde_hdcp_2x_msg_sent(struct sde_hdcp_2x_ctrl *hdcp)
 	case SKE_SEND_TYPE_ID:
 		if (!hdcp2_app_comm(hdcp->hdcp2_ctx,
 				HDCP2_CMD_EN_ENCRYPTION, &hdcp->app_data)) {
-			hdcp->authenticated = true;
+			sde_hdcp_2x_auth_done(hdcp);
 
 			if (hdcp->force_encryption)
 				hdcp2_force_encryption(hdcp->hdcp2_ctx, 1);
@@ -549,9 +606,15 @@ exit:
 static void sde_hdcp_2x_init(struct sde_hdcp_2x_ctrl *hdcp)
 {
 	int rc;
+	ktime_t start = ktime_get();
+
 	rc = hdcp2_app_comm(hdcp->hdcp2_ctx, HDCP2_CMD_START, &hdcp->app_data);
-	if (rc)
+	if (rc) {
 		sde_hdcp_2x_clean(hdcp);
+		return;
+	}
+
+	hdcp->stats.last_start_ms = ktime_ms_delta(ktime_get(), start);
 }
 
 static void sde_hdcp_2x_start_auth(struct sde_hdcp_2x_ctrl *hdcp)
@@ -559,6 +622,7 @@ static void sde_hdcp_2x_start_auth(struct sde_hdcp_2x_ctrl *hdcp)
 	int rc;
 
 	SDE_EVT32_EXTERNAL(SDE_EVTLOG_FUNC_ENTRY, hdcp->authenticated);
+	hdcp->auth_start = ktime_get();
 	rc = hdcp2_app_comm(hdcp->hdcp2_ctx, HDCP2_CMD_START_AUTH,
 		&hdcp->app_data);
 	if (rc) {
@@ -663,7 +727,7 @@ static void sde_hdcp_2x_msg_recvd(struct sde_hdcp_2x_ctrl *hdcp)
 					HDCP2_CMD_EN_ENCRYPTION,
 					&hdcp->app_data);
 			if (!rc) {
-				hdcp->authenticated = true;
+				sde_hdcp_2x_auth_done(hdcp);
 
 				if (hdcp->force_encryption)
 					hdcp2_force_encryption(
@@ -694,6 +758,10 @@ static void sde_hdcp_2x_msg_recvd(struct sde_hdcp_2x_ctrl *hdcp)
 	else
 		hdcp->no_stored_km = false;
 
+	/* the TA paired with this receiver before and reuses its km */
+	if (out_msg == AKE_STORED_KM)
+		hdcp->stored_km = true;
+
 	if (out_msg == SKE_SEND_EKS) {
 		hdcp->repeater_flag = hdcp->app_data.repeater_flag;
 		hdcp->update_stream = true;
@@ -900,6 +968,7 @@ static int sde_hdcp_2x_wakeup(struct sde_hdcp_2x_wakeup_data *data)
 		break;
 	case HDCP_2X_CMD_START:
 		hdcp->no_stored_km = false;
+		hdcp->stored_km = false;
 		hdcp->repeater_flag = false;
 		hdcp->update_stream = false;
 		hdcp->authenticated = false;
@@ -1491,6 +1491,61 @@ static void sde_rotator_release_entry(struct sde_rot_mgr *mgr,
 	sde_rotator_unassign_queue(mgr, entry);
 }
 
+/*
+ * sde_rotator_prepare_data - attach iommu and map/check the entry buffers
+ * @entry: Pointer to rotator entry
+ *
+ * On failure the iommu reference taken here is dropped again; the caller
+ * releases any buffer already mapped when the entry is released.
+ */
+static int sde_rotator_prepare_data(struct sde_rot_entry *entry)
+{
+	int ret;
+
+	ATRACE_INT("sde_smmu_ctrl", 0);
+	ret = sde_smmu_ctrl(1);
+	if (ret < 0) {
+		SDEROT_ERR("IOMMU attach failed\n");
+		return ret;
+	}
+	ATRACE_INT("sde_smmu_ctrl", 1);
+
+	ret = sde_rotator_map_and_check_data(entry);
+	if (ret) {
+		SDEROT_ERR("fail to prepare input/output data %d\n", ret);
+		sde_smmu_ctrl(0);
+	}
+
+	return ret;
+}
+
+/*
+ * sde_rotator_can_premap - check if entry buffers can be mapped up front
+ * @mgr: Pointer to rotator manager
+ * @entry: Pointer to rotator entry
+ *
+ * Mapping may switch the secure camera context, which must not happen
+ * while earlier entries are still running, so only entries matching the
+ * current secure state are mapped ahead of hardware acquisition.
+ */
+static bool sde_rotator_can_premap(struct sde_rot_mgr *mgr,
+		struct sde_rot_entry *entry)
+{
+	struct sde_rot_data_type *mdata = sde_rot_get_mdata();
+	bool secure;
+
+	if (!mgr->pipeline_enable)
+		return false;
+
+	if (!test_bit(SDE_CAPS_SEC_ATTACH_DETACH_SMMU, mdata->sde_caps_map))
+		return true;
+
+	secure = (entry->item.flags & SDE_ROTATION_SECURE_CAMERA) ?
+			true : false;
+
+	return secure == !!mdata->sec_cam_en;
+}
+
 /*
  * sde_rotator_commit_handler - Commit workqueue handler.
  * @file: Pointer to work struct.
@@ -1508,6 +1563,7 @@ static void sde_rotator_commit_handler(struct kthread_work *work)
 	struct sde_rot_mgr *mgr;
 	struct sched_param param = { .sched_priority = 5 };
 	struct sde_rot_trace_entry rot_trace;
+	bool premapped;
 	int ret;
 
 	entry = container_of(work, struct sde_rot_entry, commit_work);
@@ -1547,9 +1603,23 @@ static void sde_rotator_commit_handler(struct kthread_work *work)
 
 	sde_rot_mgr_lock(mgr);
 
+	/*
+	 * In pipelined mode, attach and map the buffers of this entry before
+	 * waiting for a free hardware context, so that the setup runs while
+	 * the entries already queued to the hardware are still executing.
+	 */
+	premapped = sde_rotator_can_premap(mgr, entry);
+	if (premapped) {
+		ret = sde_rotator_prepare_data(entry);
+		if (ret)
+			goto get_hw_res_err;
+	}
+
 	hw = sde_rotator_get_hw_resource(entry->commitq, entry);
 	if (!hw) {
 		SDEROT_ERR("no hw for the queue\n");
+		if (premapped)
+			sde_smmu_ctrl(0);
 		goto get_hw_res_err;
 	}
 
@@ -1577,18 +1647,10 @@ static void sde_rotator_commit_handler(struct kthread_work *work)
 	trace_rot_entry_commit(
 		entry->item.session_id, entry->item.sequence_id, &rot_trace);
 
-	ATRACE_INT("sde_smmu_ctrl", 0);
-	ret = sde_smmu_ctrl(1);
-	if (ret < 0) {
-		SDEROT_ERR("IOMMU attach failed\n");
-		goto smmu_error;
-	}
-	ATRACE_INT("sde_smmu_ctrl", 1);
-
-	ret = sde_rotator_map_and_check_data(entry);
-	if (ret) {
-		SDEROT_ERR("fail to prepare input/output data %d\n", ret);
-		goto error;
+	if (!premapped) {
+		ret = sde_rotator_prepare_data(entry);
+		if (ret)
+			goto smmu_error;
 	}
 
 	ret = mgr->ops_config_hw(hw, entry);
@@ -430,6 +430,8 @@ struct sde_rot_bus_data_type {
  * @rdot_limit: current read OT limit
  * @wrot_limit: current write OT limit
  * @hwacquire_timeout: maximum wait time for hardware availability in msec
+ * @pipeline_enable: map buffers of the next entry before acquiring hardware,
+ *	so that its setup overlaps execution of the entries already queued
  * @pixel_per_clk: rotator hardware performance in pixel for clock
  * @fudge_factor: fudge factor for clock calculation
  * @overhead: software overhead for offline rotation in msec
@@ -477,6 +479,7 @@ struct sde_rot_mgr {
 	u32 wrot_limit;
 
 	u32 hwacquire_timeout;
+	u32 pipeline_enable;
 	struct sde_mult_factor pixel_per_clk;
 	struct sde_mult_factor fudge_factor;
 	struct sde_mult_factor overhead;
@@ -720,6 +720,9 @@ void sde_rot_evtlog(const char *name, int line, int flag, ...)
 }
 #endif
 
+/* per request stages between the fence and retire timestamps */
+#define SDE_ROTATOR_NUM_STAGES	(SDE_ROTATOR_TS_RETIRE - SDE_ROTATOR_TS_FENCE)
+
 /*
  * sde_rotator_stat_show - Show statistics on read to this debugfs file
  * @s: Pointer to sequence file structure
@@ -734,6 +737,11 @@ static int sde_rotator_stat_show(struct seq_file *s, void *data)
 	int num_events;
 	s64 proc_max, proc_min, proc_avg;
 	s64 swoh_max, swoh_min, swoh_avg;
+	s64 stage_max[SDE_ROTATOR_NUM_STAGES] = { 0 };
+	s64 stage_sum[SDE_ROTATOR_NUM_STAGES] = { 0 };
+	static const char * const stage_name[SDE_ROTATOR_NUM_STAGES] = {
+		"fe", "q", "c", "st", "fl", "d",
+	};
 
 	proc_max = 0;
 	proc_min = S64_MAX;
@@ -764,6 +772,17 @@ static int sde_rotator_stat_show(struct seq_file *s, void *data)
 		s64 sw_overhead_time =
 			ktime_to_us(ktime_sub(ts[SDE_ROTATOR_TS_FLUSH],
 					start_time));
+		int j;
+
+		/* stages from fence signal to retire, in timestamp order */
+		for (j = 0; j < SDE_ROTATOR_NUM_STAGES; j++) {
+			s64 t = ktime_to_us(ktime_sub(
+					ts[SDE_ROTATOR_TS_QUEUE + j],
+					ts[SDE_ROTATOR_TS_FENCE + j]));
+
+			stage_max[j] = max(stage_max[j], t);
+			stage_sum[j] += t;
+		}
 
 		seq_printf(s,
 			"s:%d sq:%lld dq:%lld fe:%lld q:%lld c:%lld st:%lld fl:%lld d:%lld sdq:%lld ddq:%lld t:%lld oht:%lld\n",
@@ -813,6 +832,12 @@ static int sde_rotator_stat_show(struct seq_file *s, void *data)
 	seq_printf(s, "swoh_min:%lld\n", swoh_min);
 	seq_printf(s, "swoh_avg:%lld\n", swoh_avg);
 
+	for (i = 0; i < SDE_ROTATOR_NUM_STAGES; i++)
+		seq_printf(s, "%s_max:%lld %s_avg:%lld\n",
+			stage_name[i], stage_max[i], stage_name[i],
+			(num_events) ? (s64)DIV_ROUND_CLOSEST_ULL(
+					stage_sum[i], num_events) : 0);
+
 	return 0;
 }
 
@@ -904,6 +929,8 @@ static int sde_rotator_core_create_debugfs(
 
 	debugfs_create_u32("hwacquire_timeout", 0400, debugfs_root, &mgr->hwacquire_timeout);
 
+	debugfs_create_u32("pipeline_enable", 0644, debugfs_root, &mgr->pipeline_enable);
+
 	debugfs_create_u32("ppc_numer", 0644, debugfs_root, &mgr->pixel_per_clk.numer);
 
 	debugfs_create_u32("ppc_denom", 0600, debugfs_root, &mgr->pixel_per_clk.denom);
@@ -55,6 +55,13 @@
 
 #define EVA_KMD_FLUSH_FRAME	(EVA_KMD_CMD_START + 71)
 
+/*
+ * EVA_KMD_SEND_CMD_PKT_BATCH - this argument type is used to submit
+ *          up to EVA_KMD_MAX_BATCH_PKTS frame packets with a single
+ *          call. it passes struct eva_kmd_hfi_batch {}
+ */
+#define EVA_KMD_SEND_CMD_PKT_BATCH	(EVA_KMD_CMD_START + 72)
+
 /* flags */
 #define EVA_KMD_FLAG_UNSECURE			0x00000000
 #define EVA_KMD_FLAG_SECURE			0x00000001
@@ -64,6 +71,7 @@
 #define EVA_KMD_BUFTYPE_OUTPUT			0x00000002
 #define EVA_KMD_BUFTYPE_INTERNAL_1		0x00000003
 #define EVA_KMD_BUFTYPE_INTERNAL_2		0x00000004
+#define EVA_KMD_BUFTYPE_WNCC_METADATA		0x00000005
 
 
 /**
@@ -177,6 +185,32 @@ struct eva_kmd_hfi_packet {
 	struct eva_kmd_oob_buf *oob_buf;
 };
 
+#define EVA_KMD_MAX_BATCH_PKTS	8
+
+/**
+ * struct eva_kmd_hfi_batch_entry - one frame packet of a batch
+ * @buf_offset:    offset to buffer list in the packet
+ * @buf_num:       number of buffers in the packet
+ * @pkt:           HFI packet created by user library
+ */
+struct eva_kmd_hfi_batch_entry {
+	__u32 buf_offset;
+	__u32 buf_num;
+	struct eva_kmd_hfi_packet pkt;
+};
+
+/**
+ * struct eva_kmd_hfi_batch - batch of frame packets
+ * @num_pkts:      number of entries, at most EVA_KMD_MAX_BATCH_PKTS
+ * @num_sent:      number of entries queued to firmware, set by driver
+ * @entries:       user pointer to struct eva_kmd_hfi_batch_entry array
+ */
+struct eva_kmd_hfi_batch {
+	__u32 num_pkts;
+	__u32 num_sent;
+	__u64 entries;
+};
+
 #define EVA_KMD_PROP_HFI_VERSION	1
 #define EVA_KMD_PROP_SESSION_TYPE	2
 #define EVA_KMD_PROP_SESSION_KERNELMASK	3
@@ -185,6 +219,7 @@ struct eva_kmd_hfi_packet {
 #define EVA_KMD_PROP_SESSION_DSPMASK	6
 #define EVA_KMD_PROP_SESSION_DUMPOFFSET	7
 #define EVA_KMD_PROP_SESSION_DUMPSIZE	8
+#define EVA_KMD_PROP_SESSION_DEADLINE	9
 
 #define EVA_KMD_PROP_PWR_FDU	0x10
 #define EVA_KMD_PROP_PWR_ICA	0x11
@@ -277,6 +312,7 @@ struct eva_kmd_hfi_synx_packet {
  * @hfi_pkt:       HFI packet created by user library
  * @sys_properties System properties read or set by user library
  * @hfi_fence_pkt: HFI fence packet created by user library
+ * @hfi_batch:     batch of HFI frame packets created by user library
  */
 struct eva_kmd_arg {
 	__u32 type;
@@ -292,6 +328,7 @@ struct eva_kmd_arg {
 		struct eva_kmd_hfi_fence_packet hfi_fence_pkt;
 		struct eva_kmd_hfi_synx_packet hfi_synx_pkt;
 		struct eva_kmd_session_control session_ctrl;
+		struct eva_kmd_hfi_batch hfi_batch;
 		__u64 frame_id;
 	} data;
 };
@@ -2465,6 +2465,62 @@ err_send_pkt:
 	return rc;
 }
 
+/*
+ * Writes all packets to the cmdq back to back and raises at most one
+ * interrupt for the whole batch. Stops at the first packet that cannot
+ * be queued; packets already written are still signalled to firmware.
+ */
+static int iris_hfi_session_send_batch(void *sess,
+		struct eva_kmd_hfi_packet **in_pkts, u32 num_pkts,
+		u32 *num_sent)
+{
+	int rc = 0;
+	u32 i;
+	bool needs_interrupt = false, irq;
+	struct eva_kmd_hfi_packet pkt;
+	struct cvp_hal_session *session = sess;
+	struct iris_hfi_device *device;
+
+	if (!session || !session->device || !in_pkts || !num_sent) {
+		dprintk(CVP_ERR, "invalid session");
+		return -ENODEV;
+	}
+
+	*num_sent = 0;
+	device = session->device;
+	mutex_lock(&device->lock);
+
+	if (!__is_session_valid(device, session, __func__)) {
+		rc = -ECONNRESET;
+		goto err_send_pkt;
+	}
+
+	for (i = 0; i < num_pkts; i++) {
+		rc = call_hfi_pkt_op(device, session_send,
+				&pkt, session, in_pkts[i]);
+		if (rc) {
+			dprintk(CVP_ERR,
+				"failed to create batch pkt %u\n", i);
+			break;
+		}
+
+		irq = false;
+		if (__iface_cmdq_write_relaxed(device, &pkt, &irq)) {
+			rc = -ENOTEMPTY;
+			break;
+		}
+		needs_interrupt |= irq;
+		(*num_sent)++;
+	}
+
+	if (needs_interrupt)
+		__write_register(device, CVP_CPU_CS_H2ASOFTINT, 1);
+
+err_send_pkt:
+	mutex_unlock(&device->lock);
+	return rc;
+}
+
 static int iris_hfi_session_flush(void *sess)
 {
 	struct cvp_hal_session *session = sess;
@@ -4741,6 +4797,7 @@ static void iris_init_hfi_callbacks(struct cvp_hfi_device *hdev)
 	hdev->session_set_buffers = iris_hfi_session_set_buffers;
 	hdev->session_release_buffers = iris_hfi_session_release_buffers;
 	hdev->session_send = iris_hfi_session_send;
+	hdev->session_send_batch = iris_hfi_session_send_batch;
 	hdev->session_flush = iris_hfi_session_flush;
 	hdev->scale_clocks = iris_hfi_scale_clocks;
 	hdev->vote_bus = iris_hfi_vote_buses;
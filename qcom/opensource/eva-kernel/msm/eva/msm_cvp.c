@@ -3,6 +3,7 @@
  * Copyright (c) 2018-2021, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/uaccess.h>
 #include "msm_cvp.h"
 #include "cvp_hfi.h"
 #include "cvp_core_hfi.h"
@@ -261,6 +262,150 @@ exit:
 	return rc;
 }
 
+static int cvp_validate_batch_pkt(struct msm_cvp_inst *inst,
+	struct eva_kmd_hfi_batch_entry *entry)
+{
+	struct cvp_hal_session_cmd_pkt *hdr;
+	struct cvp_hfi_cmd_session_hdr *cmd_hdr;
+	int pkt_idx;
+
+	hdr = (struct cvp_hal_session_cmd_pkt *)&entry->pkt;
+	if (hdr->size > MAX_HFI_PKT_SIZE * sizeof(unsigned int))
+		return -EINVAL;
+
+	pkt_idx = get_pkt_index(hdr);
+	if (pkt_idx < 0)
+		return -EINVAL;
+
+	/* Only frame packets may be batched, they never wait on a response */
+	if (cvp_hfi_defs[pkt_idx].is_config_pkt ||
+		cvp_hfi_defs[pkt_idx].resp != HAL_NO_RESP ||
+		cvp_find_map_type(hdr->packet_type) != MAP_FRAME)
+		return -EINVAL;
+
+	if (!is_buf_param_valid(entry->buf_num, entry->buf_offset))
+		return -EINVAL;
+
+	/* The kdata will be overriden by transaction ID if the cmd has buf */
+	cmd_hdr = (struct cvp_hfi_cmd_session_hdr *)&entry->pkt;
+	cmd_hdr->client_data.kdata = pkt_idx;
+	return 0;
+}
+
+static int msm_cvp_session_process_hfi_batch(struct msm_cvp_inst *inst,
+	struct eva_kmd_hfi_batch *batch)
+{
+	int rc = 0;
+	u32 i, num_mapped = 0, num_sent = 0;
+	struct cvp_hfi_device *hdev;
+	struct cvp_session_queue *sq;
+	struct msm_cvp_inst *s;
+	struct eva_kmd_hfi_batch_entry *entries;
+	struct eva_kmd_hfi_packet *pkts[EVA_KMD_MAX_BATCH_PKTS];
+	struct cvp_hfi_cmd_session_hdr *cmd_hdr;
+	bool mapped[EVA_KMD_MAX_BATCH_PKTS] = {false};
+
+	if (!inst || !inst->core || !batch) {
+		dprintk(CVP_ERR, "%s: invalid params\n", __func__);
+		return -EINVAL;
+	}
+
+	if (!batch->num_pkts || batch->num_pkts > EVA_KMD_MAX_BATCH_PKTS) {
+		dprintk(CVP_ERR, "%s: invalid batch size %u\n",
+			__func__, batch->num_pkts);
+		return -EINVAL;
+	}
+
+	s = cvp_get_inst_validate(inst->core, inst);
+	if (!s)
+		return -ECONNRESET;
+
+	hdev = inst->core->device;
+	if (!hdev->session_send_batch) {
+		rc = -ENOTSUPP;
+		goto exit;
+	}
+
+	entries = kcalloc(batch->num_pkts, sizeof(*entries), GFP_KERNEL);
+	if (!entries) {
+		rc = -ENOMEM;
+		goto exit;
+	}
+
+	if (copy_from_user(entries, u64_to_user_ptr(batch->entries),
+			batch->num_pkts * sizeof(*entries))) {
+		rc = -EFAULT;
+		goto free_entries;
+	}
+
+	/* Frame packets are not allowed before session starts */
+	sq = &inst->session_queue;
+	spin_lock(&sq->lock);
+	if (sq->state != QUEUE_START) {
+		spin_unlock(&sq->lock);
+		dprintk(CVP_ERR, "%s: invalid queue state %d\n",
+			__func__, sq->state);
+		rc = -EINVAL;
+		goto free_entries;
+	}
+	spin_unlock(&sq->lock);
+
+	/* Validate the whole batch before pinning anything */
+	for (i = 0; i < batch->num_pkts; i++) {
+		rc = cvp_validate_batch_pkt(inst, &entries[i]);
+		if (rc) {
+			dprintk(CVP_ERR, "%s: incorrect packet %u: %x, %x\n",
+				__func__, i, entries[i].pkt.pkt_data[0],
+				entries[i].pkt.pkt_data[1]);
+			goto free_entries;
+		}
+	}
+
+	for (i = 0; i < batch->num_pkts; i++) {
+		rc = msm_cvp_proc_oob(inst, &entries[i].pkt);
+		if (rc) {
+			dprintk(CVP_ERR, "%s: failed to process OOB buffer %u\n",
+				__func__, i);
+			goto unmap_frames;
+		}
+
+		rc = msm_cvp_map_frame(inst, &entries[i].pkt,
+				entries[i].buf_offset, entries[i].buf_num);
+		if (rc)
+			goto unmap_frames;
+
+		/* map_frame only tags packets that actually carry buffers */
+		mapped[i] = entries[i].buf_offset && entries[i].buf_num;
+		pkts[i] = &entries[i].pkt;
+		num_mapped++;
+	}
+
+	rc = call_hfi_op(hdev, session_send_batch, (void *)inst->session,
+			pkts, num_mapped, &num_sent);
+	if (rc)
+		dprintk(CVP_ERR, "%s: sent %u of %u packets, rc %d\n",
+			__func__, num_sent, num_mapped, rc);
+
+	/* A partially queued batch is reported through num_sent */
+	if (num_sent)
+		rc = 0;
+
+unmap_frames:
+	for (i = num_sent; i < num_mapped; i++) {
+		if (!mapped[i])
+			continue;
+		cmd_hdr = (struct cvp_hfi_cmd_session_hdr *)&entries[i].pkt;
+		msm_cvp_unmap_frame(inst, cmd_hdr->client_data.kdata);
+	}
+	batch->num_sent = num_sent;
+
+free_entries:
+	kfree(entries);
+exit:
+	cvp_put_inst(inst);
+	return rc;
+}
+
 static bool cvp_fence_wait(struct cvp_fence_queue *q,
 			struct cvp_fence_command **fence,
 			enum queue_state *state)
@@ -457,6 +602,86 @@ static int cvp_check_clock(struct msm_cvp_inst *inst,
 	return rc;
 }
 
+/* Must be called with core->clk_lock held */
+static void cvp_deadline_step_clock(struct msm_cvp_core *core, bool up)
+{
+	struct allowed_clock_rates_table *tbl;
+	unsigned int tbl_size;
+	unsigned long tmp = core->curr_freq;
+	u32 j;
+	int rc;
+
+	tbl = core->resources.allowed_clks_tbl;
+	tbl_size = core->resources.allowed_clks_tbl_size;
+	if (!tbl_size)
+		return;
+
+	for (j = 0; j < tbl_size - 1; j++)
+		if (core->curr_freq <= tbl[j].clock_rate)
+			break;
+
+	if (up) {
+		if (j == tbl_size - 1 && core->curr_freq >= tbl[j].clock_rate)
+			return;
+		core->curr_freq = (core->curr_freq < tbl[j].clock_rate) ?
+			tbl[j].clock_rate : tbl[j + 1].clock_rate;
+	} else {
+		if (!j)
+			return;
+		core->curr_freq = tbl[j - 1].clock_rate;
+	}
+
+	dprintk(CVP_PWR, "%s: deadline %s, clk %lu -> %lu\n", __func__,
+		up ? "missed" : "relaxed", tmp, core->curr_freq);
+
+	rc = msm_cvp_set_clocks(core);
+	if (rc) {
+		dprintk(CVP_ERR, "%s: failed to set clock rate %lu: %d\n",
+			__func__, core->curr_freq, rc);
+		core->curr_freq = tmp;
+	}
+}
+
+static void cvp_check_deadline(struct msm_cvp_inst *inst, u32 latency_us)
+{
+	struct msm_cvp_core *core = inst->core;
+	struct cvp_deadline_stat *ds = &inst->deadline;
+	u32 deadline_us = inst->prop.deadline_us;
+
+	mutex_lock(&core->clk_lock);
+	ds->frames++;
+	ds->total_frames++;
+	if (latency_us > deadline_us) {
+		ds->misses++;
+		ds->total_misses++;
+	}
+	ds->max_us = max(ds->max_us, latency_us);
+
+	if (ds->frames < CVP_DEADLINE_WINDOW)
+		goto exit;
+
+	dprintk(CVP_PWR, "%s: sess %#x deadline %u max %u misses %u/%u\n",
+		__func__, hash32_ptr(inst->session), deadline_us,
+		ds->max_us, ds->misses, ds->frames);
+
+	if (ds->misses) {
+		core->dyn_clk.last_miss = jiffies;
+		cvp_deadline_step_clock(core, true);
+	} else if (ds->max_us <
+			(u64)deadline_us * CVP_DEADLINE_RELAX_PCT / 100 &&
+			time_after(jiffies, core->dyn_clk.last_miss +
+			msecs_to_jiffies(CVP_DEADLINE_HOLD_MS))) {
+		/* Only lower clocks once no session missed for a while */
+		cvp_deadline_step_clock(core, false);
+	}
+
+	ds->frames = 0;
+	ds->misses = 0;
+	ds->max_us = 0;
+exit:
+	mutex_unlock(&core->clk_lock);
+}
+
 static int cvp_fence_proc(struct msm_cvp_inst *inst,
 			struct cvp_fence_command *fc,
 			struct cvp_hfi_cmd_session_hdr *pkt)
@@ -469,7 +694,9 @@ static int cvp_fence_proc(struct msm_cvp_inst *inst,
 	struct cvp_session_queue *sq;
 	u32 hfi_err = HFI_ERR_NONE;
 	struct cvp_hfi_msg_session_hdr_ext hdr;
-	bool clock_check = false;
+	bool clock_check = false, deadline_check = false;
+	ktime_t submit_time;
+	u32 latency_us = 0;
 
 	dprintk(CVP_SYNX, "%s %s\n", current->comm, __func__);
 
@@ -487,6 +714,7 @@ static int cvp_fence_proc(struct msm_cvp_inst *inst,
 		goto exit;
 	}
 
+	submit_time = ktime_get();
 	rc = call_hfi_op(hdev, session_send, (void *)inst->session,
 			(struct eva_kmd_hfi_packet *)pkt);
 	if (rc) {
@@ -499,6 +727,7 @@ static int cvp_fence_proc(struct msm_cvp_inst *inst,
 	timeout = msecs_to_jiffies(CVP_MAX_WAIT_TIME);
 	rc = cvp_wait_process_message(inst, sq, &ktid, timeout,
 				(struct eva_kmd_hfi_packet *)&hdr);
+	latency_us = (u32)ktime_us_delta(ktime_get(), submit_time);
 
 	/* Only FD support dcvs at certain FW */
 	if (!msm_cvp_dcvs_disable &&
@@ -531,6 +760,9 @@ static int cvp_fence_proc(struct msm_cvp_inst *inst,
 		synx_state = SYNX_STATE_SIGNALED_ERROR;
 		goto exit;
 	}
+	if (!msm_cvp_dcvs_disable && inst->prop.deadline_us &&
+		hfi_err != HFI_ERR_SESSION_FLUSHED)
+		deadline_check = true;
 	if (hfi_err == HFI_ERR_SESSION_FLUSHED) {
 		dprintk(CVP_SYNX, "%s %s: cvp_wait_process_message flushed\n",
 			current->comm, __func__);
@@ -551,6 +783,8 @@ exit:
 	if (clock_check)
 		cvp_check_clock(inst,
 			(struct cvp_hfi_msg_session_hdr_ext *)&hdr);
+	if (deadline_check)
+		cvp_check_deadline(inst, latency_us);
 	return rc;
 }
 
@@ -1521,6 +1755,10 @@ static int msm_cvp_set_sysprop(struct msm_cvp_inst *inst,
 		case EVA_KMD_PROP_SESSION_DUMPSIZE:
 			session_prop->dump_size = prop_array[i].data;
 			break;
+		case EVA_KMD_PROP_SESSION_DEADLINE:
+			session_prop->deadline_us = prop_array[i].data;
+			memset(&inst->deadline, 0, sizeof(inst->deadline));
+			break;
 		default:
 			dprintk(CVP_ERR,
 				"unrecognized sys property to set %d\n",
@@ -1782,6 +2020,12 @@ int msm_cvp_handle_syscall(struct msm_cvp_inst *inst, struct eva_kmd_arg *arg)
 		rc = msm_cvp_session_process_hfi_fence(inst, arg);
 		break;
 	}
+	case EVA_KMD_SEND_CMD_PKT_BATCH:
+	{
+		rc = msm_cvp_session_process_hfi_batch(inst,
+				&arg->data.hfi_batch);
+		break;
+	}
 	case EVA_KMD_SESSION_CONTROL:
 		rc = msm_cvp_session_ctrl(inst, arg);
 		break;
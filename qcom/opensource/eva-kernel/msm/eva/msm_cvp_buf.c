@@ -33,8 +33,9 @@
 	} while (0)
 
 static void _wncc_print_cvpwnccbufs_table(struct msm_cvp_inst* inst);
-static int _wncc_unmap_metadata_bufs(struct eva_kmd_hfi_packet* in_pkt,
-	struct eva_kmd_oob_wncc* wncc_oob, struct eva_kmd_wncc_metadata** wncc_metadata);
+static int _wncc_unmap_metadata_bufs(struct msm_cvp_inst *inst,
+	struct cvp_wncc_meta_buf **meta_bufs,
+	struct eva_kmd_wncc_metadata **wncc_metadata);
 
 void msm_cvp_print_inst_bufs(struct msm_cvp_inst *inst, bool log);
 
@@ -835,16 +836,107 @@ static int _wncc_copy_oob_from_user(struct eva_kmd_hfi_packet* in_pkt,
 	return rc;
 }
 
-static int _wncc_map_metadata_bufs(struct eva_kmd_hfi_packet* in_pkt,
-	struct eva_kmd_oob_wncc* wncc_oob, struct eva_kmd_wncc_metadata** wncc_metadata)
+/* Must be called with wnccmetabufs.lock held */
+static void _wncc_meta_free(struct msm_cvp_inst *inst,
+	struct cvp_wncc_meta_buf *mbuf)
+{
+	list_del(&mbuf->list);
+	inst->wnccmetabufs_num--;
+	dma_buf_vunmap(mbuf->dma_buf, &mbuf->map);
+	dma_buf_put(mbuf->dma_buf);
+	kfree(mbuf);
+}
+
+/* Must be called with wnccmetabufs.lock held */
+static void _wncc_meta_evict(struct msm_cvp_inst *inst)
+{
+	struct cvp_wncc_meta_buf *mbuf, *dummy;
+
+	list_for_each_entry_safe_reverse(mbuf, dummy,
+			&inst->wnccmetabufs.list, list) {
+		if (inst->wnccmetabufs_num < CVP_WNCC_META_CACHE_SIZE)
+			break;
+		if (mbuf->users || mbuf->persist)
+			continue;
+		dprintk(CVP_MEM, "%s: evict wncc metadata dma_buf %pK",
+			__func__, mbuf->dma_buf);
+		_wncc_meta_free(inst, mbuf);
+	}
+}
+
+/*
+ * Looks up the kernel mapping of a metadata buffer, creating it on a
+ * miss. Takes over the caller's dma_buf reference either way.
+ */
+static struct cvp_wncc_meta_buf *_wncc_meta_get(struct msm_cvp_inst *inst,
+	struct dma_buf *dmabuf, bool persist)
+{
+	struct cvp_wncc_meta_buf *mbuf;
+	int rc;
+
+	mutex_lock(&inst->wnccmetabufs.lock);
+	list_for_each_entry(mbuf, &inst->wnccmetabufs.list, list) {
+		if (mbuf->dma_buf == dmabuf) {
+			list_move(&mbuf->list, &inst->wnccmetabufs.list);
+			mbuf->users++;
+			mbuf->persist |= persist;
+			mutex_unlock(&inst->wnccmetabufs.lock);
+			dma_buf_put(dmabuf);
+			return mbuf;
+		}
+	}
+
+	mbuf = kzalloc(sizeof(*mbuf), GFP_KERNEL);
+	if (!mbuf) {
+		mutex_unlock(&inst->wnccmetabufs.lock);
+		dma_buf_put(dmabuf);
+		return ERR_PTR(-ENOMEM);
+	}
+
+	rc = dma_buf_vmap(dmabuf, &mbuf->map);
+	if (rc) {
+		mutex_unlock(&inst->wnccmetabufs.lock);
+		dprintk(CVP_ERR, "%s: dma_buf_vmap() failed, rc %d",
+			__func__, rc);
+		kfree(mbuf);
+		dma_buf_put(dmabuf);
+		return ERR_PTR(rc);
+	}
+	dprintk(CVP_DBG, "%s: wncc metadata map.is_iomem is %d",
+		__func__, mbuf->map.is_iomem);
+
+	_wncc_meta_evict(inst);
+	mbuf->dma_buf = dmabuf;
+	mbuf->users = 1;
+	mbuf->persist = persist;
+	list_add(&mbuf->list, &inst->wnccmetabufs.list);
+	inst->wnccmetabufs_num++;
+	mutex_unlock(&inst->wnccmetabufs.lock);
+
+	return mbuf;
+}
+
+static void _wncc_meta_put(struct msm_cvp_inst *inst,
+	struct cvp_wncc_meta_buf *mbuf)
+{
+	mutex_lock(&inst->wnccmetabufs.lock);
+	mbuf->users--;
+	mutex_unlock(&inst->wnccmetabufs.lock);
+}
+
+static int _wncc_map_metadata_bufs(struct msm_cvp_inst *inst,
+	struct eva_kmd_hfi_packet *in_pkt,
+	struct eva_kmd_oob_wncc *wncc_oob,
+	struct cvp_wncc_meta_buf **meta_bufs,
+	struct eva_kmd_wncc_metadata **wncc_metadata)
 {
 	int rc = 0, i;
 	struct cvp_buf_type* wncc_metadata_bufs;
+	struct cvp_wncc_meta_buf *mbuf;
 	struct dma_buf* dmabuf;
-	struct dma_buf_map map;
 	__u32 num_layers;
 
-	if (!in_pkt || !wncc_metadata || !wncc_oob) {
+	if (!inst || !in_pkt || !wncc_metadata || !wncc_oob || !meta_bufs) {
 		dprintk(CVP_ERR, "%s: invalid params", __func__);
 		return -EINVAL;
 	}
@@ -878,91 +970,120 @@ static int _wncc_map_metadata_bufs(struct eva_kmd_hfi_packet* in_pkt,
 			break;
 		}
 
-		rc = dma_buf_begin_cpu_access(dmabuf, DMA_TO_DEVICE);
-		if (rc) {
+		mbuf = _wncc_meta_get(inst, dmabuf, false);
+		if (IS_ERR(mbuf)) {
+			rc = PTR_ERR(mbuf);
 			dprintk(CVP_ERR,
-				"%s: dma_buf_begin_cpu_access() failed "
-				"for wncc_metadata_bufs[%d], rc %d",
-				__func__, i, rc);
-			dma_buf_put(dmabuf);
+				"%s: failed to map wncc_metadata_bufs[%d]",
+				__func__, i);
 			break;
 		}
 
-		rc = dma_buf_vmap(dmabuf, &map);
+		rc = dma_buf_begin_cpu_access(mbuf->dma_buf, DMA_TO_DEVICE);
 		if (rc) {
 			dprintk(CVP_ERR,
-				"%s: dma_buf_vmap() failed for "
-				"wncc_metadata_bufs[%d]",
-				__func__, i);
-			dma_buf_end_cpu_access(dmabuf, DMA_TO_DEVICE);
-			dma_buf_put(dmabuf);
+				"%s: dma_buf_begin_cpu_access() failed "
+				"for wncc_metadata_bufs[%d], rc %d",
+				__func__, i, rc);
+			_wncc_meta_put(inst, mbuf);
 			break;
 		}
-		dprintk(CVP_DBG,
-			"%s: wncc_metadata_bufs[%d] map.is_iomem is %d",
-			__func__, i, map.is_iomem);
-		wncc_metadata[i] = (struct eva_kmd_wncc_metadata*)map.vaddr;
-
-		dma_buf_put(dmabuf);
+		meta_bufs[i] = mbuf;
+		wncc_metadata[i] = (struct eva_kmd_wncc_metadata*)mbuf->map.vaddr;
 	}
 
 	if (rc)
-		_wncc_unmap_metadata_bufs(in_pkt, wncc_oob, wncc_metadata);
+		_wncc_unmap_metadata_bufs(inst, meta_bufs, wncc_metadata);
 
 	return rc;
 }
 
-static int _wncc_unmap_metadata_bufs(struct eva_kmd_hfi_packet* in_pkt,
-	struct eva_kmd_oob_wncc* wncc_oob, struct eva_kmd_wncc_metadata** wncc_metadata)
+static int _wncc_unmap_metadata_bufs(struct msm_cvp_inst *inst,
+	struct cvp_wncc_meta_buf **meta_bufs,
+	struct eva_kmd_wncc_metadata **wncc_metadata)
 {
-	int rc = 0, i;
-	struct cvp_buf_type* wncc_metadata_bufs;
-	struct dma_buf* dmabuf;
-	struct dma_buf_map map;
-	__u32 num_layers;
+	int rc = 0, ret, i;
 
-	if (!in_pkt || !wncc_metadata || !wncc_oob) {
+	if (!inst || !wncc_metadata || !meta_bufs) {
 		dprintk(CVP_ERR, "%s: invalid params", __func__);
 		return -EINVAL;
 	}
 
-	num_layers = wncc_oob->num_layers;
-	if (num_layers < 1 || num_layers > EVA_KMD_WNCC_MAX_LAYERS) {
-		dprintk(CVP_ERR, "%s: invalid wncc num layers", __func__);
-		return -EINVAL;
-	}
-
-	wncc_metadata_bufs = (struct cvp_buf_type*)
-		&in_pkt->pkt_data[EVA_KMD_WNCC_HFI_METADATA_BUFS_OFFSET];
-	for (i = 0; i < num_layers; i++) {
-		if (!wncc_metadata[i]) {
+	for (i = 0; i < EVA_KMD_WNCC_MAX_LAYERS; i++) {
+		if (!meta_bufs[i])
 			continue;
-		}
 
-		dmabuf = dma_buf_get(wncc_metadata_bufs[i].fd);
-		if (IS_ERR(dmabuf)) {
-			rc = -PTR_ERR(dmabuf);
+		ret = dma_buf_end_cpu_access(meta_bufs[i]->dma_buf,
+				DMA_TO_DEVICE);
+		if (ret) {
 			dprintk(CVP_ERR,
-				"%s: dma_buf_get() failed for "
-				"wncc_metadata_bufs[%d], rc %d",
-				__func__, i, rc);
-			break;
+				"%s: dma_buf_end_cpu_access() failed "
+				"for wncc_metadata_bufs[%d], rc %d",
+				__func__, i, ret);
+			rc = ret;
 		}
-
-		dma_buf_map_set_vaddr(&map, wncc_metadata[i]);
-		dma_buf_vunmap(dmabuf, &map);
+		_wncc_meta_put(inst, meta_bufs[i]);
+		meta_bufs[i] = NULL;
 		wncc_metadata[i] = NULL;
+	}
 
-		rc = dma_buf_end_cpu_access(dmabuf, DMA_TO_DEVICE);
-		dma_buf_put(dmabuf);
-		if (rc) {
-			dprintk(CVP_ERR,
-				"%s: dma_buf_end_cpu_access() failed "
-				"for wncc_metadata_bufs[%d], rc %d",
-				__func__, i, rc);
+	return rc;
+}
+
+int msm_cvp_register_wncc_metadata(struct msm_cvp_inst *inst,
+	struct eva_kmd_buffer *buf)
+{
+	struct cvp_wncc_meta_buf *mbuf;
+	struct dma_buf *dmabuf;
+
+	if (!inst || !buf) {
+		dprintk(CVP_ERR, "%s: invalid params", __func__);
+		return -EINVAL;
+	}
+
+	dmabuf = msm_cvp_smem_get_dma_buf(buf->fd);
+	if (!dmabuf)
+		return -EINVAL;
+
+	mbuf = _wncc_meta_get(inst, dmabuf, true);
+	if (IS_ERR(mbuf))
+		return PTR_ERR(mbuf);
+	_wncc_meta_put(inst, mbuf);
+
+	return 0;
+}
+
+int msm_cvp_unregister_wncc_metadata(struct msm_cvp_inst *inst,
+	struct eva_kmd_buffer *buf)
+{
+	struct cvp_wncc_meta_buf *mbuf;
+	struct dma_buf *dmabuf;
+	int rc = -EINVAL;
+
+	if (!inst || !buf) {
+		dprintk(CVP_ERR, "%s: invalid params", __func__);
+		return -EINVAL;
+	}
+
+	dmabuf = msm_cvp_smem_get_dma_buf(buf->fd);
+	if (!dmabuf)
+		return -EINVAL;
+
+	mutex_lock(&inst->wnccmetabufs.lock);
+	list_for_each_entry(mbuf, &inst->wnccmetabufs.list, list) {
+		if (mbuf->dma_buf == dmabuf && mbuf->persist) {
+			mbuf->persist = false;
+			if (!mbuf->users)
+				_wncc_meta_free(inst, mbuf);
+			rc = 0;
 			break;
 		}
 	}
+	mutex_unlock(&inst->wnccmetabufs.lock);
+	msm_cvp_smem_put_dma_buf(dmabuf);
+
+	if (rc)
+		dprintk(CVP_ERR, "%s: fd %d not registered", __func__, buf->fd);
 
 	return rc;
 }
@@ -973,6 +1094,7 @@ static int msm_cvp_proc_oob_wncc(struct msm_cvp_inst* inst,
 	int rc = 0;
 	struct eva_kmd_oob_wncc* wncc_oob;
 	struct eva_kmd_wncc_metadata* wncc_metadata[EVA_KMD_WNCC_MAX_LAYERS];
+	struct cvp_wncc_meta_buf *meta_bufs[EVA_KMD_WNCC_MAX_LAYERS];
 	unsigned int i, j;
 	bool empty = false;
 	u32 buf_id, buf_idx, buf_offset, iova;
@@ -993,7 +1115,9 @@ static int msm_cvp_proc_oob_wncc(struct msm_cvp_inst* inst,
 	}
 
 	memset(wncc_metadata, 0, sizeof(*wncc_metadata) * EVA_KMD_WNCC_MAX_LAYERS);
-	rc = _wncc_map_metadata_bufs(in_pkt, wncc_oob, wncc_metadata);
+	memset(meta_bufs, 0, sizeof(*meta_bufs) * EVA_KMD_WNCC_MAX_LAYERS);
+	rc = _wncc_map_metadata_bufs(inst, in_pkt, wncc_oob, meta_bufs,
+			wncc_metadata);
 	if (rc) {
 		dprintk(CVP_ERR, "%s: failed to map wncc metadata bufs",
 			__func__);
@@ -1061,7 +1185,7 @@ static int msm_cvp_proc_oob_wncc(struct msm_cvp_inst* inst,
 		_wncc_print_metadata_buf(wncc_oob->num_layers,
 			wncc_oob->layers[0].num_addrs, wncc_metadata);
 
-	if (_wncc_unmap_metadata_bufs(in_pkt, wncc_oob, wncc_metadata)) {
+	if (_wncc_unmap_metadata_bufs(inst, meta_bufs, wncc_metadata)) {
 		dprintk(CVP_ERR, "%s: failed to unmap wncc metadata bufs",
 			__func__);
 	}
@@ -1629,6 +1753,7 @@ int msm_cvp_session_deinit_buffers(struct msm_cvp_inst *inst)
 	int rc = 0, i;
 	struct cvp_internal_buf *cbuf, *dummy;
 	struct msm_cvp_frame *frame, *dummy1;
+	struct cvp_wncc_meta_buf *mbuf, *dummy2;
 	struct msm_cvp_smem *smem;
 	struct cvp_hal_session *session;
 	struct eva_kmd_buffer buf;
@@ -1747,6 +1872,15 @@ int msm_cvp_session_deinit_buffers(struct msm_cvp_inst *inst)
 	}
 	mutex_unlock(&inst->cvpwnccbufs.lock);
 
+	mutex_lock(&inst->wnccmetabufs.lock);
+	list_for_each_entry_safe(mbuf, dummy2, &inst->wnccmetabufs.list, list) {
+		if (mbuf->users)
+			dprintk(CVP_WARN, "%s: wncc metadata %pK in use",
+				__func__, mbuf->dma_buf);
+		_wncc_meta_free(inst, mbuf);
+	}
+	mutex_unlock(&inst->wnccmetabufs.lock);
+
 	return rc;
 }
 
@@ -2075,7 +2209,9 @@ int msm_cvp_register_buffer(struct msm_cvp_inst *inst,
 	hdev = inst->core->device;
 	print_client_buffer(CVP_HFI, "register", inst, buf);
 
-	if (buf->index)
+	if (buf->type == EVA_KMD_BUFTYPE_WNCC_METADATA)
+		rc = msm_cvp_register_wncc_metadata(inst, buf);
+	else if (buf->index)
 		rc = msm_cvp_map_buf_dsp(inst, buf);
 	else
 		rc = msm_cvp_map_buf_wncc(inst, buf);
@@ -2103,7 +2239,9 @@ int msm_cvp_unregister_buffer(struct msm_cvp_inst *inst,
 
 	print_client_buffer(CVP_HFI, "unregister", inst, buf);
 
-	if (buf->index)
+	if (buf->type == EVA_KMD_BUFTYPE_WNCC_METADATA)
+		rc = msm_cvp_unregister_wncc_metadata(inst, buf);
+	else if (buf->index)
 		rc = msm_cvp_unmap_buf_dsp(inst, buf);
 	else
 		rc = msm_cvp_unmap_buf_wncc(inst, buf);
@@ -87,6 +87,22 @@ struct msm_cvp_wncc_buffer {
 	u32 size;
 };
 
+/*
+ * Kernel mapping of a wncc metadata buffer, kept across frames so
+ * steady state frames only sync caches. Entries are kept in LRU order;
+ * persist entries come from EVA_KMD_REGISTER_BUFFER and are never
+ * evicted, entries with users are being written and are skipped.
+ */
+#define CVP_WNCC_META_CACHE_SIZE 16
+
+struct cvp_wncc_meta_buf {
+	struct list_head list;
+	struct dma_buf *dma_buf;
+	struct dma_buf_map map;
+	u32 users;
+	bool persist;
+};
+
 struct cvp_dmamap_cache {
 	unsigned long usage_bitmap;
 	struct mutex lock;
@@ -202,6 +218,10 @@ int msm_cvp_map_buf_wncc(struct msm_cvp_inst* inst,
 			struct eva_kmd_buffer* buf);
 int msm_cvp_unmap_buf_wncc(struct msm_cvp_inst* inst,
 			struct eva_kmd_buffer* buf);
+int msm_cvp_register_wncc_metadata(struct msm_cvp_inst *inst,
+			struct eva_kmd_buffer *buf);
+int msm_cvp_unregister_wncc_metadata(struct msm_cvp_inst *inst,
+			struct eva_kmd_buffer *buf);
 int msm_cvp_proc_oob(struct msm_cvp_inst* inst,
 			struct eva_kmd_hfi_packet* in_pkt);
 void msm_cvp_cache_operations(struct msm_cvp_smem *smem,
@@ -106,6 +106,8 @@ static void __init_fence_queue(struct msm_cvp_inst *inst)
 	init_waitqueue_head(&inst->fence_cmd_queue.wq);
 	inst->fence_cmd_queue.state = QUEUE_ACTIVE;
 	inst->fence_cmd_queue.mode = OP_NORMAL;
+	atomic_set(&inst->fence_cmd_queue.nr_fast_wait, 0);
+	atomic_set(&inst->fence_cmd_queue.nr_sw_wait, 0);
 
 	spin_lock_init(&inst->session_queue_fence.lock);
 	INIT_LIST_HEAD(&inst->session_queue_fence.msgs);
@@ -193,10 +195,12 @@ void *msm_cvp_open(int core_id, int session_type, struct task_struct *task)
 	INIT_DMAMAP_CACHE(&inst->dma_cache);
 	INIT_MSM_CVP_LIST(&inst->cvpdspbufs);
 	INIT_MSM_CVP_LIST(&inst->cvpwnccbufs);
+	INIT_MSM_CVP_LIST(&inst->wnccmetabufs);
 	INIT_MSM_CVP_LIST(&inst->frames);
 
 	inst->cvpwnccbufs_num = 0;
 	inst->cvpwnccbufs_table = NULL;
+	inst->wnccmetabufs_num = 0;
 
 	init_waitqueue_head(&inst->event_handler.wq);
 
@@ -257,6 +261,7 @@ fail_init:
 	DEINIT_DMAMAP_CACHE(&inst->dma_cache);
 	DEINIT_MSM_CVP_LIST(&inst->cvpdspbufs);
 	DEINIT_MSM_CVP_LIST(&inst->cvpwnccbufs);
+	DEINIT_MSM_CVP_LIST(&inst->wnccmetabufs);
 	DEINIT_MSM_CVP_LIST(&inst->frames);
 
 	kfree(inst);
@@ -397,6 +402,7 @@ int msm_cvp_destroy(struct msm_cvp_inst *inst)
 	DEINIT_DMAMAP_CACHE(&inst->dma_cache);
 	DEINIT_MSM_CVP_LIST(&inst->cvpdspbufs);
 	DEINIT_MSM_CVP_LIST(&inst->cvpwnccbufs);
+	DEINIT_MSM_CVP_LIST(&inst->wnccmetabufs);
 	DEINIT_MSM_CVP_LIST(&inst->frames);
 
 	kfree(inst->cvpwnccbufs_table);
@@ -532,6 +532,12 @@ static ssize_t inst_info_read(struct file *file, char __user *buf,
 	cur += write_str(cur, end - cur, "state: %d\n", inst->state);
 	cur += write_str(cur, end - cur, "secure: %d\n",
 		!!(inst->flags & CVP_SECURE));
+	cur += write_str(cur, end - cur, "deadline: %u us, frames %u, misses %u\n",
+		inst->prop.deadline_us, inst->deadline.total_frames,
+		inst->deadline.total_misses);
+	cur += write_str(cur, end - cur, "fence wait: fast %d, sw %d\n",
+		atomic_read(&inst->fence_cmd_queue.nr_fast_wait),
+		atomic_read(&inst->fence_cmd_queue.nr_sw_wait));
 	for (i = SESSION_MSG_START; i < SESSION_MSG_END; i++) {
 		cur += write_str(cur, end - cur, "completions[%d]: %s\n", i,
 		completion_done(&inst->completions[SESSION_MSG_INDEX(i)]) ?
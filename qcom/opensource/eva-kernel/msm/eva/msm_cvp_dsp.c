@@ -1604,6 +1604,31 @@ dsp_fail_delete:
 	return;
 }
 
+/*
+ * DSP sessions submit frames straight into the DSP HFI queue, so power
+ * requests are the only per pipeline traffic that still reaches APPS.
+ * DSP clients tend to resend the same vote; skip re-aggregating clocks
+ * and bandwidth when nothing changed.
+ */
+static bool __dsp_power_req_changed(struct msm_cvp_inst *inst,
+		struct eva_power_req *req)
+{
+	return inst->prop.fdu_cycles != req->clock_fdu ||
+		inst->prop.ica_cycles != req->clock_ica ||
+		inst->prop.od_cycles != req->clock_od ||
+		inst->prop.mpu_cycles != req->clock_mpu ||
+		inst->prop.fw_cycles != req->clock_fw ||
+		inst->prop.ddr_bw != req->bw_ddr ||
+		inst->prop.ddr_cache != req->bw_sys_cache ||
+		inst->prop.fdu_op_cycles != req->op_clock_fdu ||
+		inst->prop.ica_op_cycles != req->op_clock_ica ||
+		inst->prop.od_op_cycles != req->op_clock_od ||
+		inst->prop.mpu_op_cycles != req->op_clock_mpu ||
+		inst->prop.fw_op_cycles != req->op_clock_fw ||
+		inst->prop.ddr_op_bw != req->op_bw_ddr ||
+		inst->prop.ddr_op_cache != req->op_bw_sys_cache;
+}
+
 static void __dsp_cvp_power_req(struct cvp_dsp_cmd_msg *cmd)
 {
 	struct cvp_dsp_apps *me = &gfa_cv;
@@ -1629,6 +1654,13 @@ static void __dsp_cvp_power_req(struct cvp_dsp_cmd_msg *cmd)
 
 	print_power(&dsp2cpu_cmd->power_req);
 
+	if (!__dsp_power_req_changed(inst, &dsp2cpu_cmd->power_req)) {
+		me->power_req_skipped++;
+		dprintk(CVP_DSP, "%s unchanged power request, skipped %u\n",
+			__func__, me->power_req_skipped);
+		goto dsp_fail_power_req;
+	}
+
 	inst->prop.fdu_cycles = dsp2cpu_cmd->power_req.clock_fdu;
 	inst->prop.ica_cycles =	dsp2cpu_cmd->power_req.clock_ica;
 	inst->prop.od_cycles =	dsp2cpu_cmd->power_req.clock_od;
@@ -212,6 +212,8 @@ struct cvp_dsp_apps {
 	/* dsp buffer mapping, set of dma function pointer */
 	const struct file_operations *dmabuf_f_op;
 	uint32_t buf_num;
+	/* DSP2CPU_POWER_REQUEST served without touching clocks */
+	uint32_t power_req_skipped;
 	struct msm_cvp_list fastrpc_driver_list;
 	struct driver_name cvp_fastrpc_name[MAX_FASTRPC_DRIVER_NUM];
 };
@@ -241,6 +241,8 @@ struct cvp_cycle_info {
 	u32 lo_ctrl_lim[HFI_MAX_HW_THREADS];
 	struct cvp_cycle_stat cycle[HFI_MAX_HW_THREADS];
 	unsigned long conf_freq;
+	/* jiffies of the last window with a deadline miss, any session */
+	unsigned long last_miss;
 };
 
 struct cvp_session_prop {
@@ -267,6 +269,24 @@ struct cvp_session_prop {
 	u32 fps[HFI_MAX_HW_THREADS];
 	u32 dump_offset;
 	u32 dump_size;
+	u32 deadline_us;
+};
+
+/*
+ * Per session frame latency against prop.deadline_us, measured on the
+ * fence path from submission to firmware response. Clocks are stepped
+ * once every CVP_DEADLINE_WINDOW frames.
+ */
+#define CVP_DEADLINE_WINDOW	16
+#define CVP_DEADLINE_RELAX_PCT	70
+#define CVP_DEADLINE_HOLD_MS	500
+
+struct cvp_deadline_stat {
+	u32 frames;
+	u32 misses;
+	u32 max_us;
+	u32 total_frames;
+	u32 total_misses;
 };
 
 enum cvp_event_t {
@@ -406,6 +426,8 @@ struct msm_cvp_inst {
 	struct msm_cvp_list frames;
 	u32 cvpwnccbufs_num;
 	struct msm_cvp_wncc_buffer* cvpwnccbufs_table;
+	struct msm_cvp_list wnccmetabufs;
+	u32 wnccmetabufs_num;
 	struct completion completions[SESSION_MSG_END - SESSION_MSG_START + 1];
 	struct dentry *debugfs_root;
 	struct msm_cvp_debug debug;
@@ -414,6 +436,7 @@ struct msm_cvp_inst {
 	struct msm_cvp_capability capability;
 	struct kref kref;
 	struct cvp_session_prop prop;
+	struct cvp_deadline_stat deadline;
 	/* error_code will be cleared after being returned to user mode */
 	u32 error_code;
 	/* prev_error_code saves value of error_code before it's cleared */
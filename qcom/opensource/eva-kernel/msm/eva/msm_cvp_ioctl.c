@@ -429,6 +429,18 @@ static int convert_from_user(struct eva_kmd_arg *kp,
 		}
 		break;
 	}
+	case EVA_KMD_SEND_CMD_PKT_BATCH:
+	{
+		struct eva_kmd_hfi_batch *k, *u;
+
+		k = &kp->data.hfi_batch;
+		u = &up->data.hfi_batch;
+		if (get_user(k->num_pkts, &u->num_pkts) ||
+			get_user(k->entries, &u->entries))
+			return -EFAULT;
+		k->num_sent = 0;
+		break;
+	}
 	case EVA_KMD_FLUSH_ALL:
 	case EVA_KMD_UPDATE_POWER:
 		break;
@@ -567,6 +579,13 @@ static int convert_to_user(struct eva_kmd_arg *kp, unsigned long arg)
 		rc = _copy_fence_pkt_to_user(kp, up);
 		break;
 	}
+	case EVA_KMD_SEND_CMD_PKT_BATCH:
+	{
+		if (put_user(kp->data.hfi_batch.num_sent,
+				&up->data.hfi_batch.num_sent))
+			return -EFAULT;
+		break;
+	}
 	case EVA_KMD_SESSION_CONTROL:
 	{
 		struct eva_kmd_session_control *k, *u;
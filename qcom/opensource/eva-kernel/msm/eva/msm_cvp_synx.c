@@ -188,8 +188,8 @@ static int cvp_cancel_synx(struct msm_cvp_inst *inst, enum cvp_synx_type type,
 	return cvp_cancel_synx_impl(inst, type, fc, synx_state);
 }
 
-static int cvp_wait_synx(struct synx_session ssid, u32 *synx, u32 num_synx,
-		u32 *synx_state)
+static int cvp_wait_synx(struct cvp_fence_queue *q, struct synx_session ssid,
+		u32 *synx, u32 num_synx, u32 *synx_state)
 {
 	int i = 0, rc = 0;
 	unsigned long timeout_ms = 2000;
@@ -198,6 +198,17 @@ static int cvp_wait_synx(struct synx_session ssid, u32 *synx, u32 num_synx,
 	while (i < num_synx) {
 		h_synx = synx[i];
 		if (h_synx) {
+			/*
+			 * Producers usually run ahead of EVA; when the fence
+			 * already signaled skip the synx_wait round trip.
+			 */
+			if (synx_get_status(ssid, h_synx) ==
+					SYNX_STATE_SIGNALED_SUCCESS) {
+				atomic_inc(&q->nr_fast_wait);
+				++i;
+				continue;
+			}
+			atomic_inc(&q->nr_sw_wait);
 			rc = synx_wait(ssid, h_synx, timeout_ms);
 			if (rc) {
 				*synx_state = synx_get_status(ssid, h_synx);
@@ -257,8 +268,8 @@ static int cvp_synx_ops_v1(struct msm_cvp_inst *inst, enum cvp_synx_type type,
 	}
 
 	if (type == CVP_INPUT_SYNX) {
-		return cvp_wait_synx(ssid, fc->synx, fc->output_index,
-				synx_state);
+		return cvp_wait_synx(&inst->fence_cmd_queue, ssid, fc->synx,
+				fc->output_index, synx_state);
 	} else if (type == CVP_OUTPUT_SYNX) {
 		return cvp_signal_synx(ssid, &fc->synx[fc->output_index],
 				(fc->num_fences - fc->output_index),
@@ -19,6 +19,10 @@ struct cvp_fence_queue {
 	struct list_head wait_list;
 	wait_queue_head_t wq;
 	struct list_head sched_list;
+	/* input fences found already signaled, no synx_wait needed */
+	atomic_t nr_fast_wait;
+	/* input fences that had to block in synx_wait */
+	atomic_t nr_sw_wait;
 };
 
 struct cvp_fence_type {
@@ -296,6 +296,8 @@ struct adreno_protected_regs {
  * usesgmem: enable GMEM save/restore across preemption (for 6XX)
  * count: Track the number of preemptions triggered
  * @postamble_len: Number of dwords in KMD postamble pm4 packet
+ * @urgent_level: The level of preemption used when the incoming ringbuffer
+ * is close to its latency target (for 6XX)
  */
 struct adreno_preemption {
 	atomic_t state;
@@ -303,6 +305,7 @@ struct adreno_preemption {
 	struct timer_list timer;
 	struct work_struct work;
 	unsigned int preempt_level;
+	u32 urgent_level;
 	bool skipsaverestore;
 	bool usesgmem;
 	unsigned int count;
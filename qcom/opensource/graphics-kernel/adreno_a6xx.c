@@ -1875,6 +1875,7 @@ int a6xx_probe_common(struct platform_device *pdev,
 	adreno_dev->uche_client_pf = 1;
 
 	adreno_dev->preempt.preempt_level = 1;
+	adreno_dev->preempt.urgent_level = 1;
 	adreno_dev->preempt.skipsaverestore = true;
 	adreno_dev->preempt.usesgmem = true;
 
@@ -162,6 +162,14 @@ static void log_profiling_info(struct adreno_device *adreno_dev, u32 *rcvd)
 
 	trace_adreno_cmdbatch_retired(context, &info, 0, 0, 0);
 
+	kgsl_latency_hist_add_ticks(&ADRENO_CONTEXT(context)->latency,
+		KGSL_LATENCY_SUBMIT_START, cmd->submitted_to_rb, cmd->sop);
+	kgsl_latency_hist_add_ticks(&ADRENO_CONTEXT(context)->latency,
+		KGSL_LATENCY_START_RETIRE, cmd->sop, cmd->eop);
+
+	kgsl_pwrscale_frame_busy(&ADRENO_CONTEXT(context)->frame_hist,
+		info.active);
+
 	log_kgsl_cmdbatch_retired_event(context->id, cmd->ts, context->priority,
 		0, cmd->sop, cmd->eop);
 
@@ -1466,6 +1474,11 @@ static void a6xx_add_profile_events(struct adreno_device *adreno_dev,
 
 	cmdobj->submit_ticks = time->ticks;
 
+	if (cmdobj->queue_time && time->ktime > cmdobj->queue_time)
+		kgsl_latency_hist_add(&ADRENO_CONTEXT(context)->latency,
+			KGSL_LATENCY_QUEUE_SUBMIT,
+			time->ktime - cmdobj->queue_time);
+
 	msm_perf_events_update(MSM_PERF_GFX, MSM_PERF_SUBMIT,
 		pid_nr(context->proc_priv->pid),
 		context->id, drawobj->timestamp,
@@ -140,6 +140,8 @@ static void _a6xx_preemption_done(struct adreno_device *adreno_dev)
 	trace_adreno_preempt_done(adreno_dev->cur_rb, adreno_dev->next_rb,
 		status);
 
+	adreno_ringbuffer_preempt_done(adreno_dev->next_rb);
+
 	/* Clean up all the bits */
 	adreno_dev->prev_rb = adreno_dev->cur_rb;
 	adreno_dev->cur_rb = adreno_dev->next_rb;
@@ -373,7 +375,7 @@ void a6xx_preemption_trigger(struct adreno_device *adreno_dev, bool atomic)
 	mod_timer(&adreno_dev->preempt.timer,
 		jiffies + msecs_to_jiffies(ADRENO_PREEMPT_TIMEOUT));
 
-	cntl = (preempt->preempt_level << 6) | 0x01;
+	cntl = (adreno_preempt_level(adreno_dev, next) << 6) | 0x01;
 
 	/* Skip save/restore during L1 preemption */
 	if (preempt->skipsaverestore)
@@ -454,6 +456,8 @@ void a6xx_preemption_callback(struct adreno_device *adreno_dev, int bit)
 	trace_adreno_preempt_done(adreno_dev->cur_rb, adreno_dev->next_rb,
 		status);
 
+	adreno_ringbuffer_preempt_done(adreno_dev->next_rb);
+
 	adreno_dev->prev_rb = adreno_dev->cur_rb;
 	adreno_dev->cur_rb = adreno_dev->next_rb;
 	adreno_dev->next_rb = NULL;
@@ -81,30 +81,29 @@ static void adreno_ib_merge_range(struct adreno_ib_object *ib_obj,
 }
 
 /*
- * adreno_ib_check_overlap() - Checks if an address range overlap
- * @gpuaddr: The start address range to check for overlap
- * @size: Size of the address range
+ * adreno_ib_find_entry() - Find the object for a memory entry
+ * @entry: The memory entry to look up
  * @type: The type of address range
- * @ib_obj_list: The list of address ranges to check for overlap
+ * @ib_obj_list: The list of address ranges to search
  *
- * Checks if an address range overlaps with a list of address ranges
- * Returns the entry from list which overlaps else NULL
+ * Every object in the list covers the whole of its memory entry and entries
+ * in a process never overlap, so an address range can only overlap an object
+ * that belongs to the same entry. Look that object up in the hash instead of
+ * walking the whole list.
+ * Returns the matching object from the list else NULL
  */
-static struct adreno_ib_object *adreno_ib_check_overlap(uint64_t gpuaddr,
-		uint64_t size, int type,
+static struct adreno_ib_object *adreno_ib_find_entry(
+		struct kgsl_mem_entry *entry, int type,
 		struct adreno_ib_object_list *ib_obj_list)
 {
 	struct adreno_ib_object *ib_obj;
-	int i;
 
-	for (i = 0; i < ib_obj_list->num_objs; i++) {
-		ib_obj = &(ib_obj_list->obj_list[i]);
-		if ((type == ib_obj->snapshot_obj_type) &&
-			kgsl_addr_range_overlap(ib_obj->gpuaddr, ib_obj->size,
-			gpuaddr, size))
-			/* regions overlap */
+	hash_for_each_possible(ib_obj_list->hash, ib_obj, node,
+			(unsigned long) entry) {
+		if (ib_obj->entry == entry && ib_obj->snapshot_obj_type == type)
 			return ib_obj;
 	}
+
 	return NULL;
 }
 
@@ -144,13 +143,15 @@ static int adreno_ib_add(struct kgsl_process_private *process,
 	size = entry->memdesc.size;
 	gpuaddr = entry->memdesc.gpuaddr;
 
-	ib_obj = adreno_ib_check_overlap(gpuaddr, size, type, ib_obj_list);
+	ib_obj = adreno_ib_find_entry(entry, type, ib_obj_list);
 	if (ib_obj) {
 		adreno_ib_merge_range(ib_obj, gpuaddr, size);
 		kgsl_mem_entry_put(entry);
 	} else {
-		adreno_ib_init_ib_obj(gpuaddr, size, type, entry,
-			&(ib_obj_list->obj_list[ib_obj_list->num_objs]));
+		ib_obj = &(ib_obj_list->obj_list[ib_obj_list->num_objs]);
+		adreno_ib_init_ib_obj(gpuaddr, size, type, entry, ib_obj);
+		hash_add(ib_obj_list->hash, &ib_obj->node,
+			(unsigned long) entry);
 		ib_obj_list->num_objs++;
 		/* Skip reclaim for the memdesc until it is dumped */
 		entry->memdesc.priv |= KGSL_MEMDESC_SKIP_RECLAIM;
@@ -777,8 +778,6 @@ static int adreno_cp_parse_ib2(struct kgsl_device *device,
 			struct adreno_ib_object_list *ib_obj_list,
 			int ib_level)
 {
-	int i;
-
 	/*
 	 * We can only expect an IB2 in IB1, if we are
 	 * already processing an IB2 then return error
@@ -789,20 +788,11 @@ static int adreno_cp_parse_ib2(struct kgsl_device *device,
 	/* Save current IB2 statically */
 	if (ib2base == gpuaddr)
 		kgsl_snapshot_push_object(device, process, gpuaddr, dwords);
+
 	/*
-	 * only try to find sub objects iff this IB has
-	 * not been processed already
+	 * adreno_ib_find_objs() only tries to find sub objects iff this IB
+	 * has not been processed already
 	 */
-	for (i = 0; i < ib_obj_list->num_objs; i++) {
-		struct adreno_ib_object *ib_obj = &(ib_obj_list->obj_list[i]);
-
-		if ((ib_obj->snapshot_obj_type == SNAPSHOT_GPU_OBJECT_IB) &&
-			(gpuaddr >= ib_obj->gpuaddr) &&
-			(gpuaddr + dwords * sizeof(unsigned int) <=
-			ib_obj->gpuaddr + ib_obj->size))
-			return 0;
-	}
-
 	return adreno_ib_find_objs(device, process, gpuaddr, dwords, ib2base,
 		SNAPSHOT_GPU_OBJECT_IB, ib_obj_list, 2);
 }
@@ -838,16 +828,6 @@ static int adreno_ib_find_objs(struct kgsl_device *device,
 	struct kgsl_mem_entry *entry;
 	struct adreno_device *adreno_dev = ADRENO_DEVICE(device);
 
-	/* check that this IB is not already on list */
-	for (i = 0; i < ib_obj_list->num_objs; i++) {
-		ib_obj = &(ib_obj_list->obj_list[i]);
-		if ((obj_type == ib_obj->snapshot_obj_type) &&
-			(ib_obj->gpuaddr <= gpuaddr) &&
-			((ib_obj->gpuaddr + ib_obj->size) >=
-			(gpuaddr + (dwords << 2))))
-			return 0;
-	}
-
 	entry = kgsl_sharedmem_find(process, gpuaddr);
 	if (!entry)
 		return -EINVAL;
@@ -857,6 +837,13 @@ static int adreno_ib_find_objs(struct kgsl_device *device,
 		return -EINVAL;
 	}
 
+	/* check that this IB is not already on list */
+	ib_obj = adreno_ib_find_entry(entry, obj_type, ib_obj_list);
+	if (ib_obj) {
+		kgsl_mem_entry_put(entry);
+		return 0;
+	}
+
 	src = kgsl_gpuaddr_to_vaddr(&entry->memdesc, gpuaddr);
 	if (!src) {
 		kgsl_mem_entry_put(entry);
@@ -1015,6 +1002,8 @@ int adreno_ib_create_object_list(struct kgsl_device *device,
 		return -ENOMEM;
 	}
 
+	hash_init(ib_obj_list->hash);
+
 	ret = adreno_ib_find_objs(device, process, gpuaddr, dwords, ib2base,
 		SNAPSHOT_GPU_OBJECT_IB, ib_obj_list, 1);
 
@@ -6,6 +6,8 @@
 #ifndef __ADRENO_IB_PARSER__
 #define __ADRENO_IB_PARSER__
 
+#include <linux/hashtable.h>
+
 #include "adreno.h"
 
 extern const unsigned int a3xx_cp_addr_regs[];
@@ -18,22 +20,26 @@ extern const unsigned int a4xx_cp_addr_regs[];
  * @size: Size of the range
  * @snapshot_obj_type - Type of range used in snapshot
  * @entry: The memory entry in which this range is found
+ * @node: Node in the object list hash table
  */
 struct adreno_ib_object {
 	uint64_t gpuaddr;
 	uint64_t size;
 	int snapshot_obj_type;
 	struct kgsl_mem_entry *entry;
+	struct hlist_node node;
 };
 
 /*
  * struct adreno_ib_object_list - List of address ranges found in IB
  * @obj_list: The address range list
  * @num_objs: Number of objects in list
+ * @hash: Objects in @obj_list hashed by their memory entry
  */
 struct adreno_ib_object_list {
 	struct adreno_ib_object *obj_list;
 	int num_objs;
+	DECLARE_HASHTABLE(hash, 8);
 };
 
 /*
@@ -407,6 +407,87 @@ adreno_context_debugfs_init(struct adreno_device *adreno_dev,
 				adreno_dev->ctx_d_debugfs, ctx, &ctx_fops);
 }
 
+/*
+ * Dump the latency histograms of all the contexts in a binary format that can
+ * be read without ftrace: a struct kgsl_latency_hist_header followed by one
+ * struct kgsl_latency_hist_record per context.
+ */
+static int latency_hist_open(struct inode *inode, struct file *file)
+{
+	struct kgsl_device *device = inode->i_private;
+	struct kgsl_latency_hist_header *header;
+	struct kgsl_latency_hist_record *record;
+	struct kgsl_context *context;
+	u32 count = 0, max = 0;
+	size_t size;
+	int id;
+
+	read_lock(&device->context_lock);
+	idr_for_each_entry(&device->context_idr, context, id)
+		max++;
+	read_unlock(&device->context_lock);
+
+	size = sizeof(*header) + (max * sizeof(*record));
+
+	header = kvzalloc(size, GFP_KERNEL);
+	if (!header)
+		return -ENOMEM;
+
+	record = (struct kgsl_latency_hist_record *) (header + 1);
+
+	read_lock(&device->context_lock);
+	idr_for_each_entry(&device->context_idr, context, id) {
+		if (count == max)
+			break;
+
+		/* The context might be partially created or going away */
+		if (!context || kgsl_context_detached(context))
+			continue;
+
+		record->id = context->id;
+		record->pid = pid_nr(context->proc_priv->pid);
+		memcpy(&record->hist, &ADRENO_CONTEXT(context)->latency,
+			sizeof(record->hist));
+
+		record++;
+		count++;
+	}
+	read_unlock(&device->context_lock);
+
+	header->magic = KGSL_LATENCY_HIST_MAGIC;
+	header->version = KGSL_LATENCY_HIST_VERSION;
+	header->stages = KGSL_LATENCY_STAGES;
+	header->buckets = KGSL_LATENCY_BUCKETS;
+	header->records = count;
+
+	file->private_data = header;
+
+	return 0;
+}
+
+static ssize_t latency_hist_read(struct file *file, char __user *buf,
+		size_t count, loff_t *ppos)
+{
+	struct kgsl_latency_hist_header *header = file->private_data;
+
+	return simple_read_from_buffer(buf, count, ppos, header,
+		sizeof(*header) + (header->records *
+			sizeof(struct kgsl_latency_hist_record)));
+}
+
+static int latency_hist_release(struct inode *inode, struct file *file)
+{
+	kvfree(file->private_data);
+	return 0;
+}
+
+static const struct file_operations latency_hist_fops = {
+	.open = latency_hist_open,
+	.read = latency_hist_read,
+	.llseek = default_llseek,
+	.release = latency_hist_release,
+};
+
 static int _bcl_sid0_set(void *data, u64 val)
 {
 	struct kgsl_device *device = data;
@@ -561,16 +642,60 @@ static int _preempt_level_show(void *data, u64 *val)
 
 DEFINE_DEBUGFS_ATTRIBUTE(preempt_level_fops, _preempt_level_show, _preempt_level_store, "%llu\n");
 
+static int _urgent_preempt_level_store(void *data, u64 val)
+{
+	struct adreno_device *adreno_dev = data;
+
+	adreno_dev->preempt.urgent_level = min_t(u64, val, 2);
+	return 0;
+}
+
+static int _urgent_preempt_level_show(void *data, u64 *val)
+{
+	struct adreno_device *adreno_dev = data;
+
+	*val = (u64) adreno_dev->preempt.urgent_level;
+	return 0;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(urgent_preempt_level_fops, _urgent_preempt_level_show,
+	_urgent_preempt_level_store, "%llu\n");
+
+static int preempt_stats_show(struct seq_file *s, void *unused)
+{
+	struct adreno_device *adreno_dev = s->private;
+	struct adreno_ringbuffer *rb;
+	int i;
+
+	seq_puts(s, "rb target_us count avg_us max_us missed urgent\n");
+
+	FOR_EACH_RINGBUFFER(adreno_dev, rb, i) {
+		struct adreno_rb_preempt_stats *stats = &rb->preempt_stats;
+
+		seq_printf(s, "%d %u %llu %llu %llu %llu %llu\n", rb->id,
+			rb->preempt_target_us, stats->count,
+			stats->count ? div64_u64(stats->total_us, stats->count) : 0,
+			stats->max_us, stats->missed, stats->urgent);
+	}
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(preempt_stats);
+
 void adreno_debugfs_init(struct adreno_device *adreno_dev)
 {
 	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
 	struct dentry *snapshot_dir;
+	int i;
 
 	if (IS_ERR_OR_NULL(device->d_debugfs))
 		return;
 
 	debugfs_create_file("active_cnt", 0444, device->d_debugfs, device,
 			    &_active_count_fops);
+	debugfs_create_file("latency_histogram", 0444, device->d_debugfs,
+			    device, &latency_hist_fops);
 	adreno_dev->ctx_d_debugfs = debugfs_create_dir("ctx",
 							device->d_debugfs);
 	snapshot_dir = debugfs_lookup("snapshot", kgsl_debugfs_dir);
@@ -612,5 +737,20 @@ void adreno_debugfs_init(struct adreno_device *adreno_dev)
 			&usesgmem_fops);
 		debugfs_create_file("skipsaverestore", 0644, adreno_dev->preemption_debugfs_dir,
 			device, &skipsaverestore_fops);
+		debugfs_create_file("urgent_preempt_level", 0644,
+			adreno_dev->preemption_debugfs_dir, device,
+			&urgent_preempt_level_fops);
+		debugfs_create_file("stats", 0444, adreno_dev->preemption_debugfs_dir,
+			device, &preempt_stats_fops);
+
+		/* The ringbuffers are set up later, create a target for each */
+		for (i = 0; i < ARRAY_SIZE(adreno_dev->ringbuffers); i++) {
+			char name[16];
+
+			snprintf(name, sizeof(name), "rb%d_target_us", i);
+			debugfs_create_u32(name, 0644,
+				adreno_dev->preemption_debugfs_dir,
+				&adreno_dev->ringbuffers[i].preempt_target_us);
+		}
 	}
 }
@@ -4,6 +4,7 @@
  * Copyright (c) 2022-2023 Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/sched/clock.h>
 #include <linux/slab.h>
 #include <linux/sysfs.h>
 #include <soc/qcom/msm_performance.h>
@@ -25,6 +26,9 @@ static unsigned int _context_queue_wait = 10000;
 /* Number of drawobjs sent at a time from a single context */
 static unsigned int _context_drawobj_burst = 5;
 
+/* Maximum number of drawobjs pulled off a context queue at once */
+#define ADRENO_DISPATCH_BATCH_MAX 16
+
 /*
  * GFT throttle parameters. If GFT recovered more than
  * X times in Y ms invalidate the context and do not attempt recovery.
@@ -274,25 +278,22 @@ static void _retire_timestamp(struct kgsl_drawobj *drawobj)
 	kgsl_drawobj_destroy(drawobj);
 }
 
+/*
+ * The queued count is only ever modified under the context lock but it is
+ * read locklessly here so that neither the dispatcher nor a sleeping submitter
+ * has to fight the other for the lock just to find out if there is room.
+ */
 static int _check_context_queue(struct adreno_context *drawctxt, u32 count)
 {
-	int ret;
-
-	spin_lock(&drawctxt->lock);
-
 	/*
 	 * Wake up if there is room in the context or if the whole thing got
 	 * invalidated while we were asleep
 	 */
-
 	if (kgsl_context_invalid(&drawctxt->base))
-		ret = 1;
-	else
-		ret = ((drawctxt->queued + count) < _context_drawqueue_size) ? 1 : 0;
-
-	spin_unlock(&drawctxt->lock);
+		return 1;
 
-	return ret;
+	return ((READ_ONCE(drawctxt->queued) + count) <
+		_context_drawqueue_size) ? 1 : 0;
 }
 
 /*
@@ -312,7 +313,7 @@ static inline void _pop_drawobj(struct adreno_context *drawctxt)
 {
 	drawctxt->drawqueue_head = DRAWQUEUE_NEXT(drawctxt->drawqueue_head,
 		ADRENO_CONTEXT_DRAWQUEUE_SIZE);
-	drawctxt->queued--;
+	WRITE_ONCE(drawctxt->queued, drawctxt->queued - 1);
 }
 
 static int dispatch_retire_markerobj(struct kgsl_drawobj *drawobj,
@@ -467,12 +468,10 @@ static struct kgsl_drawobj *_process_drawqueue_get_next_drawobj(
  * being submitted so if a failure happens, push it back on the head of the the
  * context queue to be reconsidered again unless the context got detached.
  */
-static inline int adreno_dispatcher_requeue_cmdobj(
-		struct adreno_context *drawctxt,
-		struct kgsl_drawobj_cmd *cmdobj)
+static inline int __requeue_drawobj(struct adreno_context *drawctxt,
+		struct kgsl_drawobj *drawobj)
 {
 	unsigned int prev;
-	struct kgsl_drawobj *drawobj = DRAWOBJ(cmdobj);
 
 	spin_lock(&drawctxt->lock);
 
@@ -495,15 +494,92 @@ static inline int adreno_dispatcher_requeue_cmdobj(
 	WARN_ON(prev == drawctxt->drawqueue_tail);
 
 	drawctxt->drawqueue[prev] = drawobj;
-	drawctxt->queued++;
+	WRITE_ONCE(drawctxt->queued, drawctxt->queued + 1);
 
 	/* Reset the command queue head to reflect the newly requeued change */
 	drawctxt->drawqueue_head = prev;
-	cmdobj->requeue_cnt++;
 	spin_unlock(&drawctxt->lock);
 	return 0;
 }
 
+static inline int adreno_dispatcher_requeue_cmdobj(
+		struct adreno_context *drawctxt,
+		struct kgsl_drawobj_cmd *cmdobj)
+{
+	int ret = __requeue_drawobj(drawctxt, DRAWOBJ(cmdobj));
+
+	if (!ret)
+		cmdobj->requeue_cnt++;
+
+	return ret;
+}
+
+/*
+ * Put back the drawobjs of a batch that were never tried. Go in reverse order
+ * so that the oldest one ends up at the head of the context queue again.
+ */
+static void _requeue_batch(struct adreno_context *drawctxt,
+		struct kgsl_drawobj **batch, int count)
+{
+	while (count--)
+		__requeue_drawobj(drawctxt, batch[count]);
+}
+
+/*
+ * Each drawobj pulled off the context queue frees a slot that a submitter can
+ * fill before we get around to sending it. Every drawobj in a batch has to be
+ * able to go back on the queue if the submit fails, so never take more than
+ * the slack between the ring and the maximum number of queued commands.
+ */
+static int _drawqueue_batch_size(struct adreno_dispatcher_drawqueue *dispatch_q,
+		int inflight, int sent)
+{
+	int count = min_t(int, _context_drawobj_burst - sent,
+		inflight - dispatch_q->inflight);
+
+	count = min_t(int, count,
+		ADRENO_CONTEXT_DRAWQUEUE_SIZE - _context_drawqueue_size);
+
+	return min_t(int, count, ADRENO_DISPATCH_BATCH_MAX);
+}
+
+/*
+ * Pull up to @max drawobjs that are ready to go to the ringbuffer off the
+ * context queue while holding the context lock only once. Return the number
+ * of drawobjs in the batch and set @ret if the queue is blocked.
+ */
+static int _drawqueue_get_batch(struct adreno_context *drawctxt,
+		struct kgsl_drawobj **batch, int max, int *ret)
+{
+	int count = 0;
+
+	spin_lock(&drawctxt->lock);
+
+	while (count < max) {
+		struct kgsl_drawobj *drawobj =
+			_process_drawqueue_get_next_drawobj(drawctxt);
+
+		/*
+		 * _process_drawqueue_get_next_drawobj() returns -EAGAIN if the
+		 * current drawobj has pending sync points so no more to do
+		 * here. When the sync points are satisfied then the context
+		 * will get reqeueued
+		 */
+		if (IS_ERR_OR_NULL(drawobj)) {
+			if (IS_ERR(drawobj))
+				*ret = PTR_ERR(drawobj);
+			break;
+		}
+
+		_pop_drawobj(drawctxt);
+		batch[count++] = drawobj;
+	}
+
+	spin_unlock(&drawctxt->lock);
+
+	return count;
+}
+
 /**
  * dispatcher_queue_context() - Queue a context in the dispatcher pending list
  * @dispatcher: Pointer to the adreno dispatcher struct
@@ -680,10 +756,17 @@ static int sendcmd(struct adreno_device *adreno_dev,
 	log_kgsl_cmdbatch_submitted_event(context->id, drawobj->timestamp,
 		context->priority, drawobj->flags);
 
+	adreno_ringbuffer_preempt_wait(adreno_dev, drawctxt->rb, time.ktime);
+
 	mutex_unlock(&device->mutex);
 
 	cmdobj->submit_ticks = time.ticks;
 
+	if (cmdobj->queue_time && time.ktime > cmdobj->queue_time)
+		kgsl_latency_hist_add(&drawctxt->latency,
+			KGSL_LATENCY_QUEUE_SUBMIT,
+			time.ktime - cmdobj->queue_time);
+
 	dispatch_q->cmd_q[dispatch_q->tail] = cmdobj;
 	dispatch_q->tail = (dispatch_q->tail + 1) %
 		ADRENO_DISPATCH_DRAWQUEUE_SIZE;
@@ -714,6 +797,9 @@ static int sendcmd(struct adreno_device *adreno_dev,
  * @drawctxt: Pointer to the adreno context to dispatch commands from
  *
  * Dequeue and send a burst of commands from the specified context to the GPU
+ * Commands are pulled off the context queue in batches so that the context
+ * lock is not bounced between the dispatcher and the submitting threads once
+ * per command.
  * Returns postive if the context needs to be put back on the pending queue
  * 0 if the context is empty or detached and negative on error
  */
@@ -722,6 +808,7 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 {
 	struct adreno_dispatcher_drawqueue *dispatch_q =
 					&(drawctxt->rb->dispatch_q);
+	struct kgsl_drawobj *batch[ADRENO_DISPATCH_BATCH_MAX];
 	int count = 0;
 	int ret = 0;
 	int inflight = _drawqueue_inflight(dispatch_q);
@@ -739,65 +826,66 @@ static int dispatcher_context_sendcmds(struct adreno_device *adreno_dev,
 	 */
 	while ((count < _context_drawobj_burst) &&
 		(dispatch_q->inflight < inflight)) {
-		struct kgsl_drawobj *drawobj;
-		struct kgsl_drawobj_cmd *cmdobj;
-		struct kgsl_context *context;
+		int i, nr;
 
 		if (adreno_gpu_fault(adreno_dev) != 0)
 			break;
 
-		spin_lock(&drawctxt->lock);
-		drawobj = _process_drawqueue_get_next_drawobj(drawctxt);
+		nr = _drawqueue_get_batch(drawctxt, batch,
+			_drawqueue_batch_size(dispatch_q, inflight, count), &ret);
 
-		/*
-		 * adreno_context_get_drawobj returns -EAGAIN if the current
-		 * drawobj has pending sync points so no more to do here.
-		 * When the sync points are satisfied then the context will get
-		 * reqeueued
-		 */
+		for (i = 0; i < nr; i++) {
+			struct kgsl_drawobj *drawobj = batch[i];
+			struct kgsl_drawobj_cmd *cmdobj = CMDOBJ(drawobj);
+			struct kgsl_context *context = drawobj->context;
 
-		if (IS_ERR_OR_NULL(drawobj)) {
-			if (IS_ERR(drawobj))
-				ret = PTR_ERR(drawobj);
-			spin_unlock(&drawctxt->lock);
-			break;
-		}
-		_pop_drawobj(drawctxt);
-		spin_unlock(&drawctxt->lock);
+			if (adreno_gpu_fault(adreno_dev) != 0) {
+				_requeue_batch(drawctxt, &batch[i], nr - i);
+				break;
+			}
 
-		timestamp = drawobj->timestamp;
-		cmdobj = CMDOBJ(drawobj);
-		context = drawobj->context;
-		trace_adreno_cmdbatch_ready(context->id, context->priority,
-			drawobj->timestamp, cmdobj->requeue_cnt);
-		ret = sendcmd(adreno_dev, cmdobj);
+			timestamp = drawobj->timestamp;
+			trace_adreno_cmdbatch_ready(context->id,
+				context->priority, drawobj->timestamp,
+				cmdobj->requeue_cnt);
+			ret = sendcmd(adreno_dev, cmdobj);
 
-		/*
-		 * On error from sendcmd() try to requeue the cmdobj
-		 * unless we got back -ENOENT which means that the context has
-		 * been detached and there will be no more deliveries from here
-		 */
-		if (ret != 0) {
-			/* Destroy the cmdobj on -ENOENT */
-			if (ret == -ENOENT)
-				kgsl_drawobj_destroy(drawobj);
-			else {
-				/*
-				 * If the requeue returns an error, return that
-				 * instead of whatever sendcmd() sent us
-				 */
-				int r = adreno_dispatcher_requeue_cmdobj(
-					drawctxt, cmdobj);
-				if (r)
-					ret = r;
+			/*
+			 * On error from sendcmd() try to requeue the cmdobj
+			 * unless we got back -ENOENT which means that the
+			 * context has been detached and there will be no more
+			 * deliveries from here
+			 */
+			if (ret != 0) {
+				_requeue_batch(drawctxt, &batch[i + 1],
+					nr - i - 1);
+
+				/* Destroy the cmdobj on -ENOENT */
+				if (ret == -ENOENT)
+					kgsl_drawobj_destroy(drawobj);
+				else {
+					/*
+					 * If the requeue returns an error,
+					 * return that instead of whatever
+					 * sendcmd() sent us
+					 */
+					int r = adreno_dispatcher_requeue_cmdobj(
+						drawctxt, cmdobj);
+					if (r)
+						ret = r;
+				}
+
+				break;
 			}
 
-			break;
-		}
+			drawctxt->submitted_timestamp = timestamp;
 
-		drawctxt->submitted_timestamp = timestamp;
+			count++;
+		}
 
-		count++;
+		/* Stop if the queue ran dry, got blocked or a submit failed */
+		if (!nr || i < nr || ret)
+			break;
 	}
 
 	/*
@@ -1151,7 +1239,11 @@ static void _queue_drawobj(struct adreno_context *drawctxt,
 	drawctxt->drawqueue[drawctxt->drawqueue_tail] = drawobj;
 	drawctxt->drawqueue_tail = (drawctxt->drawqueue_tail + 1) %
 			ADRENO_CONTEXT_DRAWQUEUE_SIZE;
-	drawctxt->queued++;
+	WRITE_ONCE(drawctxt->queued, drawctxt->queued + 1);
+
+	if (drawobj->type == CMDOBJ_TYPE || drawobj->type == MARKEROBJ_TYPE)
+		CMDOBJ(drawobj)->queue_time = local_clock();
+
 	msm_perf_events_update(MSM_PERF_GFX, MSM_PERF_QUEUE,
 				pid_nr(context->proc_priv->pid),
 				context->id, drawobj->timestamp,
@@ -2263,6 +2355,22 @@ static void retire_cmdobj(struct adreno_device *adreno_dev,
 	log_kgsl_cmdbatch_retired_event(context->id, drawobj->timestamp,
 		context->priority, drawobj->flags, start, end);
 
+	kgsl_latency_hist_add_ticks(&drawctxt->latency,
+		KGSL_LATENCY_SUBMIT_START, cmdobj->submit_ticks, start);
+	kgsl_latency_hist_add_ticks(&drawctxt->latency,
+		KGSL_LATENCY_START_RETIRE, start, end);
+
+	adreno_profile_sample_retire(adreno_dev);
+
+	kgsl_pwrscale_frame_busy(&drawctxt->frame_hist, active);
+	if (drawobj->flags & KGSL_DRAWOBJ_END_OF_FRAME)
+		kgsl_pwrscale_frame_end(KGSL_DEVICE(adreno_dev),
+			&drawctxt->frame_hist);
+	if (cmdobj->queue_time)
+		kgsl_latency_hist_add(&drawctxt->latency,
+			KGSL_LATENCY_QUEUE_RETIRE,
+			local_clock() - cmdobj->queue_time);
+
 	drawctxt->submit_retire_ticks[drawctxt->ticks_index] =
 		end - cmdobj->submit_ticks;
 
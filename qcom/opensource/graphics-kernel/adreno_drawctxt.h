@@ -9,6 +9,7 @@
 #include <linux/types.h>
 
 #include "kgsl_device.h"
+#include "kgsl_eventlog.h"
 
 struct adreno_context_type {
 	unsigned int type;
@@ -86,6 +87,10 @@ struct adreno_context {
 	u32 hw_fence_ts;
 	/** @hw_fence_count: Number of hardware fences not yet sent to Tx Queue */
 	u32 hw_fence_count;
+	/** @latency: Histogram of command latencies for this context */
+	struct kgsl_latency_hist latency;
+	/** @frame_hist: Frame aligned GPU busy history for predictive DCVS */
+	struct kgsl_frame_history frame_hist;
 };
 
 /* Flag definitions for flag field in adreno_context */
@@ -1424,6 +1424,7 @@ int gen7_probe_common(struct platform_device *pdev,
 		const struct adreno_gen7_core *gen7_core = to_gen7_core(adreno_dev);
 
 		adreno_dev->preempt.preempt_level = gen7_core->preempt_level;
+		adreno_dev->preempt.urgent_level = gen7_core->preempt_level;
 		adreno_dev->preempt.skipsaverestore = true;
 		adreno_dev->preempt.usesgmem = true;
 		set_bit(ADRENO_DEVICE_PREEMPTION, &adreno_dev->priv);
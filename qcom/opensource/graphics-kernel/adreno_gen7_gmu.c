@@ -221,14 +221,12 @@ int gen7_load_pdc_ucode(struct adreno_device *adreno_dev)
 }
 
 /* Configure and enable GMU low power mode */
-static void gen7_gmu_power_config(struct adreno_device *adreno_dev)
+static void gen7_gmu_power_config(struct kgsl_regmap_batch *batch)
 {
-	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
-
 	/* Disable GMU WB/RB buffer and caches at boot */
-	gmu_core_regwrite(device, GEN7_GMU_SYS_BUS_CONFIG, 0x1);
-	gmu_core_regwrite(device, GEN7_GMU_ICACHE_CONFIG, 0x1);
-	gmu_core_regwrite(device, GEN7_GMU_DCACHE_CONFIG, 0x1);
+	kgsl_regmap_batch_write(batch, 0x1, GEN7_GMU_SYS_BUS_CONFIG);
+	kgsl_regmap_batch_write(batch, 0x1, GEN7_GMU_ICACHE_CONFIG);
+	kgsl_regmap_batch_write(batch, 0x1, GEN7_GMU_DCACHE_CONFIG);
 }
 
 static void gmu_ao_sync_event(struct adreno_device *adreno_dev)
@@ -866,63 +864,82 @@ int gen7_gmu_itcm_shadow(struct adreno_device *adreno_dev)
 	return 0;
 }
 
-void gen7_gmu_register_config(struct adreno_device *adreno_dev)
+/*
+ * Record the register writes that only depend on buffers that live as long as
+ * the device. They are the same for every boot so build the list once and
+ * replay it with a single barrier instead of one barrier per write.
+ */
+static void gen7_gmu_build_boot_seq(struct adreno_device *adreno_dev)
 {
 	struct gen7_gmu_device *gmu = to_gen7_gmu(adreno_dev);
-	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+	struct kgsl_regmap_batch *batch = &gmu->boot_seq;
 	u32 val;
 
-	/* Clear any previously set cm3 fault */
-	atomic_set(&gmu->cm3_fault, 0);
-
-	/* Vote veto for FAL10 */
-	gmu_core_regwrite(device, GEN7_GPU_GMU_CX_GMU_CX_FALNEXT_INTF, 0x1);
-	gmu_core_regwrite(device, GEN7_GPU_GMU_CX_GMU_CX_FAL_INTF, 0x1);
-
-	/* Turn on TCM retention */
-	adreno_cx_misc_regwrite(adreno_dev, GEN7_GPU_CX_MISC_TCM_RET_CNTL, 1);
+	kgsl_regmap_batch_init(batch, gmu->boot_seq_list,
+		ARRAY_SIZE(gmu->boot_seq_list));
 
 	/* Clear init result to make sure we are getting fresh value */
-	gmu_core_regwrite(device, GEN7_GMU_CM3_FW_INIT_RESULT, 0);
-	gmu_core_regwrite(device, GEN7_GMU_CM3_BOOT_CONFIG, 0x2);
+	kgsl_regmap_batch_write(batch, 0, GEN7_GMU_CM3_FW_INIT_RESULT);
+	kgsl_regmap_batch_write(batch, 0x2, GEN7_GMU_CM3_BOOT_CONFIG);
 
-	gmu_core_regwrite(device, GEN7_GMU_HFI_QTBL_ADDR,
-			gmu->hfi.hfi_mem->gmuaddr);
-	gmu_core_regwrite(device, GEN7_GMU_HFI_QTBL_INFO, 1);
+	kgsl_regmap_batch_write(batch, gmu->hfi.hfi_mem->gmuaddr,
+		GEN7_GMU_HFI_QTBL_ADDR);
+	kgsl_regmap_batch_write(batch, 1, GEN7_GMU_HFI_QTBL_INFO);
 
-	gmu_core_regwrite(device, GEN7_GMU_AHB_FENCE_RANGE_0, BIT(31) |
-			FIELD_PREP(GENMASK(30, 18), 0x32) |
-			FIELD_PREP(GENMASK(17, 0), 0x8a0));
+	kgsl_regmap_batch_write(batch, BIT(31) |
+		FIELD_PREP(GENMASK(30, 18), 0x32) |
+		FIELD_PREP(GENMASK(17, 0), 0x8a0), GEN7_GMU_AHB_FENCE_RANGE_0);
 
 	/*
 	 * Make sure that CM3 state is at reset value. Snapshot is changing
 	 * NMI bit and if we boot up GMU with NMI bit set GMU will boot
 	 * straight in to NMI handler without executing __main code
 	 */
-	gmu_core_regwrite(device, GEN7_GMU_CM3_CFG, 0x4052);
+	kgsl_regmap_batch_write(batch, 0x4052, GEN7_GMU_CM3_CFG);
 
 	/**
 	 * We may have asserted gbif halt as part of reset sequence which may
 	 * not get cleared if the gdsc was not reset. So clear it before
 	 * attempting GMU boot.
 	 */
-	kgsl_regwrite(device, GEN7_GBIF_HALT, 0x0);
-
-	/* Set the log wptr index */
-	gmu_core_regwrite(device, GEN7_GMU_GENERAL_9,
-			gmu->log_wptr_retention);
+	kgsl_regmap_batch_write(batch, 0x0, GEN7_GBIF_HALT);
 
 	/* Pass chipid to GMU FW, must happen before starting GMU */
-	gmu_core_regwrite(device, GEN7_GMU_GENERAL_10,
-			ADRENO_GMU_REV(ADRENO_GPUREV(adreno_dev)));
+	kgsl_regmap_batch_write(batch, ADRENO_GMU_REV(ADRENO_GPUREV(adreno_dev)),
+		GEN7_GMU_GENERAL_10);
 
 	/* Log size is encoded in (number of 4K units - 1) */
 	val = (gmu->gmu_log->gmuaddr & GENMASK(31, 12)) |
 		((GMU_LOG_SIZE/SZ_4K - 1) & GENMASK(7, 0));
-	gmu_core_regwrite(device, GEN7_GMU_GENERAL_8, val);
+	kgsl_regmap_batch_write(batch, val, GEN7_GMU_GENERAL_8);
 
 	/* Configure power control and bring the GMU out of reset */
-	gen7_gmu_power_config(adreno_dev);
+	gen7_gmu_power_config(batch);
+}
+
+void gen7_gmu_register_config(struct adreno_device *adreno_dev)
+{
+	struct gen7_gmu_device *gmu = to_gen7_gmu(adreno_dev);
+	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+
+	/* Clear any previously set cm3 fault */
+	atomic_set(&gmu->cm3_fault, 0);
+
+	/* Vote veto for FAL10 */
+	gmu_core_regwrite(device, GEN7_GPU_GMU_CX_GMU_CX_FALNEXT_INTF, 0x1);
+	gmu_core_regwrite(device, GEN7_GPU_GMU_CX_GMU_CX_FAL_INTF, 0x1);
+
+	/* Turn on TCM retention */
+	adreno_cx_misc_regwrite(adreno_dev, GEN7_GPU_CX_MISC_TCM_RET_CNTL, 1);
+
+	if (!gmu->boot_seq.count)
+		gen7_gmu_build_boot_seq(adreno_dev);
+
+	kgsl_regmap_batch_replay(&device->regmap, &gmu->boot_seq);
+
+	/* Set the log wptr index */
+	gmu_core_regwrite(device, GEN7_GMU_GENERAL_9,
+			gmu->log_wptr_retention);
 
 	/*
 	 * Enable BCL throttling -
@@ -102,6 +102,10 @@ struct gen7_gmu_device {
 	struct notifier_block gdsc_nb;
 	/** @gdsc_gate: Completion to signal cx gdsc collapse status */
 	struct completion gdsc_gate;
+	/** @boot_seq: Static register writes replayed before each GMU boot */
+	struct kgsl_regmap_batch boot_seq;
+	/** @boot_seq_list: Storage for @boot_seq */
+	struct kgsl_regmap_list boot_seq_list[16];
 };
 
 struct gmu_mem_type_desc {
@@ -1394,6 +1394,7 @@ const struct adreno_hwsched_ops gen7_hwsched_ops = {
 	.submit_drawobj = gen7_hwsched_submit_drawobj,
 	.preempt_count = gen7_hwsched_preempt_count_get,
 	.send_hw_fence = gen7_hwsched_send_hw_fence,
+	.flush_doorbell = gen7_hwsched_flush_doorbell,
 };
 
 int gen7_hwsched_probe(struct platform_device *pdev,
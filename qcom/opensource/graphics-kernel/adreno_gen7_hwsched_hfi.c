@@ -175,6 +175,14 @@ static void log_profiling_info(struct adreno_device *adreno_dev, u32 *rcvd)
 
 	trace_adreno_cmdbatch_retired(context, &info, 0, 0, 0);
 
+	kgsl_latency_hist_add_ticks(&ADRENO_CONTEXT(context)->latency,
+		KGSL_LATENCY_SUBMIT_START, cmd->submitted_to_rb, cmd->sop);
+	kgsl_latency_hist_add_ticks(&ADRENO_CONTEXT(context)->latency,
+		KGSL_LATENCY_START_RETIRE, cmd->sop, cmd->eop);
+
+	kgsl_pwrscale_frame_busy(&ADRENO_CONTEXT(context)->frame_hist,
+		info.active);
+
 	log_kgsl_cmdbatch_retired_event(context->id, cmd->ts,
 		context->priority, 0, cmd->sop, cmd->eop);
 
@@ -1684,6 +1692,11 @@ static void gen7_add_profile_events(struct adreno_device *adreno_dev,
 
 	cmdobj->submit_ticks = time->ticks;
 
+	if (cmdobj->queue_time && time->ktime > cmdobj->queue_time)
+		kgsl_latency_hist_add(&ADRENO_CONTEXT(context)->latency,
+			KGSL_LATENCY_QUEUE_SUBMIT,
+			time->ktime - cmdobj->queue_time);
+
 	msm_perf_events_update(MSM_PERF_GFX, MSM_PERF_SUBMIT,
 		pid_nr(context->proc_priv->pid),
 		context->id, drawobj->timestamp,
@@ -2182,6 +2195,7 @@ static int gen7_hfi_dispatch_queue_write(struct adreno_device *adreno_dev, u32 q
 int gen7_hwsched_submit_drawobj(struct adreno_device *adreno_dev, struct kgsl_drawobj *drawobj)
 {
 	struct gen7_hfi *hfi = to_gen7_hfi(adreno_dev);
+	struct adreno_hwsched *hwsched = &adreno_dev->hwsched;
 	int ret = 0;
 	u32 cmd_sizebytes;
 	struct kgsl_drawobj_cmd *cmdobj = CMDOBJ(drawobj);
@@ -2266,13 +2280,37 @@ skipib:
 	if (ret)
 		return ret;
 
-	/* Send interrupt to GMU to receive the message */
-	gmu_core_regwrite(KGSL_DEVICE(adreno_dev), GEN7_GMU_HOST2GMU_INTR_SET,
-		DISPQ_IRQ_BIT(get_irq_bit(adreno_dev, drawobj)));
+	/*
+	 * Send interrupt to GMU to receive the message. If the dispatcher is
+	 * batching then only remember which queue needs to be looked at and
+	 * let the GMU pick up several submissions with a single interrupt.
+	 */
+	if (hwsched->doorbell_batching) {
+		hwsched->doorbell_mask |=
+			DISPQ_IRQ_BIT(get_irq_bit(adreno_dev, drawobj));
+
+		if (++hwsched->doorbell_count >= READ_ONCE(hwsched->batch_size))
+			gen7_hwsched_flush_doorbell(adreno_dev);
+	} else
+		gmu_core_regwrite(KGSL_DEVICE(adreno_dev),
+			GEN7_GMU_HOST2GMU_INTR_SET,
+			DISPQ_IRQ_BIT(get_irq_bit(adreno_dev, drawobj)));
 
 	return process_hw_fence_queue(adreno_dev, drawctxt, drawobj->timestamp);
 }
 
+void gen7_hwsched_flush_doorbell(struct adreno_device *adreno_dev)
+{
+	struct adreno_hwsched *hwsched = &adreno_dev->hwsched;
+
+	if (hwsched->doorbell_mask)
+		gmu_core_regwrite(KGSL_DEVICE(adreno_dev),
+			GEN7_GMU_HOST2GMU_INTR_SET, hwsched->doorbell_mask);
+
+	hwsched->doorbell_mask = 0;
+	hwsched->doorbell_count = 0;
+}
+
 int gen7_hwsched_send_recurring_cmdobj(struct adreno_device *adreno_dev,
 	struct kgsl_drawobj_cmd *cmdobj)
 {
@@ -128,6 +128,16 @@ int gen7_hfi_send_cmd_async(struct adreno_device *adreno_dev, void *data);
 int gen7_hwsched_submit_drawobj(struct adreno_device *adreno_dev,
 		struct kgsl_drawobj *drawobj);
 
+/**
+ * gen7_hwsched_flush_doorbell - Interrupt the GMU for batched submissions
+ * @adreno_dev: Pointer to adreno device structure
+ *
+ * Send a single interrupt to the GMU covering all the dispatch queues that
+ * were written to since the last flush. Must be called with the device mutex
+ * held.
+ */
+void gen7_hwsched_flush_doorbell(struct adreno_device *adreno_dev);
+
 /**
  * gen7_hwsched_context_detach - Unregister a context with GMU
  * @drawctxt: Pointer to the adreno context
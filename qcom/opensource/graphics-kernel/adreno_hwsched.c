@@ -5,6 +5,7 @@
  */
 
 #include <dt-bindings/soc/qcom,ipcc.h>
+#include <linux/sched/clock.h>
 #include <linux/soc/qcom/msm_hw_fence.h>
 #include <soc/qcom/msm_performance.h>
 
@@ -715,8 +716,28 @@ static void hwsched_issuecmds(struct adreno_device *adreno_dev)
 	struct adreno_hwsched *hwsched = &adreno_dev->hwsched;
 	int i;
 
+	/*
+	 * Let the target batch up the GMU interrupts for all the submissions
+	 * from this pass, across all contexts, instead of sending one for each
+	 */
+	hwsched->doorbell_batching = hwsched->hwsched_ops->flush_doorbell &&
+		(hwsched->batch_size > 1);
+
 	for (i = 0; i < ARRAY_SIZE(hwsched->jobs); i++)
 		hwsched_handle_jobs(adreno_dev, i);
+
+	if (!hwsched->doorbell_batching)
+		return;
+
+	hwsched->doorbell_batching = false;
+
+	if (hwsched->doorbell_mask) {
+		struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+
+		mutex_lock(&device->mutex);
+		hwsched->hwsched_ops->flush_doorbell(adreno_dev);
+		mutex_unlock(&device->mutex);
+	}
 }
 
 void adreno_hwsched_trigger(struct adreno_device *adreno_dev)
@@ -845,6 +866,10 @@ static void _queue_drawobj(struct adreno_context *drawctxt,
 	drawctxt->drawqueue_tail = (drawctxt->drawqueue_tail + 1) %
 			ADRENO_CONTEXT_DRAWQUEUE_SIZE;
 	drawctxt->queued++;
+
+	if (drawobj->type == CMDOBJ_TYPE || drawobj->type == MARKEROBJ_TYPE)
+		CMDOBJ(drawobj)->queue_time = local_clock();
+
 	msm_perf_events_update(MSM_PERF_GFX, MSM_PERF_QUEUE,
 		pid_nr(context->proc_priv->pid),
 		context->id, drawobj->timestamp,
@@ -1114,6 +1139,17 @@ void adreno_hwsched_retire_cmdobj(struct adreno_hwsched *hwsched,
 		atomic_inc(&drawobj->context->proc_priv->period->frames);
 	}
 
+	if (cmdobj->queue_time)
+		kgsl_latency_hist_add(&ADRENO_CONTEXT(context)->latency,
+			KGSL_LATENCY_QUEUE_RETIRE,
+			local_clock() - cmdobj->queue_time);
+
+	if (drawobj->flags & KGSL_DRAWOBJ_END_OF_FRAME)
+		kgsl_pwrscale_frame_end(drawobj->device,
+			&ADRENO_CONTEXT(context)->frame_hist);
+
+	adreno_profile_sample_retire(ADRENO_DEVICE(drawobj->device));
+
 	entry = cmdobj->profiling_buf_entry;
 	if (entry) {
 		profile_buffer = kgsl_gpuaddr_to_vaddr(&entry->memdesc,
@@ -1247,14 +1283,30 @@ static bool _ft_long_ib_detect_show(struct adreno_device *adreno_dev)
 	return adreno_dev->long_ib_detect;
 }
 
+static int _hwsched_batch_size_store(struct adreno_device *adreno_dev, u32 val)
+{
+	if (!val || val > HWSCHED_MAX_BATCH_SIZE)
+		return -EINVAL;
+
+	WRITE_ONCE(adreno_dev->hwsched.batch_size, val);
+	return 0;
+}
+
+static u32 _hwsched_batch_size_show(struct adreno_device *adreno_dev)
+{
+	return adreno_dev->hwsched.batch_size;
+}
+
 static ADRENO_SYSFS_BOOL(preemption);
 static ADRENO_SYSFS_RO_U32(preempt_count);
 static ADRENO_SYSFS_BOOL(ft_long_ib_detect);
+static ADRENO_SYSFS_U32(hwsched_batch_size);
 
 static const struct attribute *_hwsched_attr_list[] = {
 	&adreno_attr_preemption.attr.attr,
 	&adreno_attr_preempt_count.attr.attr,
 	&adreno_attr_ft_long_ib_detect.attr.attr,
+	&adreno_attr_hwsched_batch_size.attr.attr,
 	NULL,
 };
 
@@ -2054,6 +2106,8 @@ int adreno_hwsched_init(struct adreno_device *adreno_dev,
 	INIT_LIST_HEAD(&hwsched->cmd_list);
 	INIT_LIST_HEAD(&hwsched->hw_fence_list);
 
+	hwsched->batch_size = 8;
+
 	for (i = 0; i < ARRAY_SIZE(hwsched->jobs); i++) {
 		init_llist_head(&hwsched->jobs[i]);
 		init_llist_head(&hwsched->requeue[i]);
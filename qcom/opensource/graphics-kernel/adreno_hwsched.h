@@ -43,7 +43,11 @@ struct adreno_hwsched_ops {
 	 */
 	int (*send_hw_fence)(struct adreno_device *adreno_dev,
 		struct adreno_hw_fence_entry *entry);
-
+	/**
+	 * @flush_doorbell - Target specific function to interrupt the GMU
+	 * for all the submissions batched up since the last flush
+	 */
+	void (*flush_doorbell)(struct adreno_device *adreno_dev);
 };
 
 /**
@@ -101,9 +105,22 @@ struct adreno_hwsched {
 	struct list_head hw_fence_list;
 	/** @hw_fence_count: Number of hardware fences that haven't yet been sent to Tx Queue */
 	u32 hw_fence_count;
-
+	/**
+	 * @doorbell_batching: Set while the dispatcher is issuing commands so
+	 * that the GMU interrupt can be deferred to the end of the pass
+	 */
+	bool doorbell_batching;
+	/** @doorbell_mask: Dispatch queue interrupt bits not yet sent to the GMU */
+	u32 doorbell_mask;
+	/** @doorbell_count: Number of submissions covered by @doorbell_mask */
+	u32 doorbell_count;
+	/** @batch_size: Maximum number of submissions per GMU interrupt */
+	u32 batch_size;
 };
 
+/* Maximum number of submissions that can share one GMU interrupt */
+#define HWSCHED_MAX_BATCH_SIZE 32
+
 /*
  * This value is based on maximum number of IBs that can fit
  * in the ringbuffer.
@@ -5,7 +5,9 @@
 
 #include <linux/ctype.h>
 #include <linux/debugfs.h>
+#include <linux/mm.h>
 #include <linux/sched/signal.h>
+#include <linux/vmalloc.h>
 
 #include "adreno.h"
 #include "adreno_hwsched.h"
@@ -976,6 +978,253 @@ static int profile_groups_show(struct seq_file *s, void *unused)
 
 DEFINE_SHOW_ATTRIBUTE(profile_groups);
 
+static bool _profile_sampling(struct adreno_profile *profile)
+{
+	return profile->sample_ms || profile->sample_retire;
+}
+
+static int _profile_sample_ring_alloc(struct adreno_profile *profile)
+{
+	if (!profile->sample_ring)
+		profile->sample_ring =
+			vmalloc_user(ADRENO_PROFILE_SAMPLE_RING_SIZE);
+
+	return profile->sample_ring ? 0 : -ENOMEM;
+}
+
+/* Lay out the ring for the current assignments. Called with device->mutex */
+static int _profile_sample_setup(struct adreno_device *adreno_dev)
+{
+	struct adreno_profile *profile = &adreno_dev->profile;
+	struct adreno_profile_sample_header *hdr;
+	struct adreno_profile_assigns_list *entry;
+	u32 count = 0;
+	int ret;
+
+	if (!adreno_profile_has_assignments(profile))
+		return -EINVAL;
+
+	ret = _profile_sample_ring_alloc(profile);
+	if (ret)
+		return ret;
+
+	hdr = profile->sample_ring;
+
+	list_for_each_entry(entry, &profile->assignments_list, list) {
+		if (count == ADRENO_PROFILE_SAMPLE_MAX_COUNTERS)
+			break;
+
+		profile->sample_groupid[count] = entry->groupid;
+		profile->sample_countable[count] = entry->countable;
+		hdr->groupid[count] = entry->groupid;
+		hdr->countable[count] = entry->countable;
+		count++;
+	}
+
+	profile->sample_count = count;
+	profile->sample_size = (count + 1) * sizeof(u64);
+	profile->sample_entries = (ADRENO_PROFILE_SAMPLE_RING_SIZE -
+		PAGE_SIZE) / profile->sample_size;
+	profile->sample_head = 0;
+
+	hdr->magic = ADRENO_PROFILE_SAMPLE_MAGIC;
+	hdr->entry_size = profile->sample_size;
+	hdr->nr_entries = profile->sample_entries;
+	hdr->nr_counters = count;
+	hdr->dropped = 0;
+	WRITE_ONCE(hdr->tail, 0);
+	WRITE_ONCE(hdr->head, 0);
+
+	return 0;
+}
+
+static void _profile_sample(struct adreno_device *adreno_dev)
+{
+	struct kgsl_device *device = KGSL_DEVICE(adreno_dev);
+	struct adreno_profile *profile = &adreno_dev->profile;
+	const struct adreno_perfcounters *counters =
+		ADRENO_PERFCOUNTERS(adreno_dev);
+	struct adreno_profile_sample_header *hdr;
+	u64 *sample, head;
+	int i, j;
+
+	mutex_lock(&device->mutex);
+
+	hdr = profile->sample_ring;
+	head = profile->sample_head;
+
+	if (!hdr || !_profile_sampling(profile) || !profile->sample_count)
+		goto out;
+
+	/* Don't wake up the GPU to sample counters that aren't counting */
+	if (!kgsl_state_is_awake(device))
+		goto out;
+
+	/* Never wait for the reader, drop the sample if the ring is full */
+	if (head - READ_ONCE(hdr->tail) >= profile->sample_entries) {
+		hdr->dropped++;
+		goto out;
+	}
+
+	if (adreno_perfcntr_active_oob_get(adreno_dev))
+		goto out;
+
+	sample = (u64 *) ((u8 *) hdr + PAGE_SIZE +
+		(head % profile->sample_entries) * profile->sample_size);
+
+	sample[0] = ktime_get_ns();
+
+	for (i = 0; i < profile->sample_count; i++) {
+		const struct adreno_perfcount_group *group =
+			&counters->groups[profile->sample_groupid[i]];
+
+		sample[i + 1] = 0;
+
+		for (j = 0; j < group->reg_count; j++) {
+			if (group->regs[j].countable ==
+				profile->sample_countable[i]) {
+				sample[i + 1] = adreno_perfcounter_read(
+					adreno_dev, profile->sample_groupid[i],
+					j);
+				break;
+			}
+		}
+	}
+
+	adreno_perfcntr_active_oob_put(adreno_dev);
+
+	/* Make sure the sample is visible before the new head */
+	smp_wmb();
+	profile->sample_head = head + 1;
+	WRITE_ONCE(hdr->head, profile->sample_head);
+out:
+	mutex_unlock(&device->mutex);
+}
+
+static void profile_sample_work(struct work_struct *work)
+{
+	struct adreno_profile *profile = container_of(to_delayed_work(work),
+		struct adreno_profile, sample_work);
+	struct adreno_device *adreno_dev = container_of(profile,
+		struct adreno_device, profile);
+	unsigned int ms;
+
+	_profile_sample(adreno_dev);
+
+	ms = READ_ONCE(profile->sample_ms);
+	if (ms)
+		queue_delayed_work(kgsl_driver.workqueue, &profile->sample_work,
+			msecs_to_jiffies(ms));
+}
+
+static void profile_sample_retire_work(struct work_struct *work)
+{
+	struct adreno_profile *profile = container_of(work,
+		struct adreno_profile, sample_retire_work);
+
+	_profile_sample(container_of(profile, struct adreno_device, profile));
+}
+
+void adreno_profile_sample_retire(struct adreno_device *adreno_dev)
+{
+	struct adreno_profile *profile = &adreno_dev->profile;
+
+	/* A retire that lands while a sample is pending is simply dropped */
+	if (READ_ONCE(profile->sample_retire))
+		kgsl_schedule_work(&profile->sample_retire_work);
+}
+
+static int profile_sample_ms_get(void *data, u64 *val)
+{
+	struct kgsl_device *device = data;
+
+	*val = ADRENO_DEVICE(device)->profile.sample_ms;
+	return 0;
+}
+
+static int profile_sample_ms_set(void *data, u64 val)
+{
+	struct kgsl_device *device = data;
+	struct adreno_profile *profile = &ADRENO_DEVICE(device)->profile;
+	int ret = 0;
+
+	if (val > MSEC_PER_SEC)
+		return -EINVAL;
+
+	mutex_lock(&device->mutex);
+	if (val && !_profile_sampling(profile))
+		ret = _profile_sample_setup(ADRENO_DEVICE(device));
+	if (!ret)
+		WRITE_ONCE(profile->sample_ms, val);
+	mutex_unlock(&device->mutex);
+
+	if (ret)
+		return ret;
+
+	if (val)
+		mod_delayed_work(kgsl_driver.workqueue, &profile->sample_work,
+			msecs_to_jiffies(val));
+	else
+		cancel_delayed_work(&profile->sample_work);
+
+	return 0;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(profile_sample_ms_fops,
+			profile_sample_ms_get,
+			profile_sample_ms_set, "%llu\n");
+
+static int profile_sample_retire_get(void *data, u64 *val)
+{
+	struct kgsl_device *device = data;
+
+	*val = ADRENO_DEVICE(device)->profile.sample_retire;
+	return 0;
+}
+
+static int profile_sample_retire_set(void *data, u64 val)
+{
+	struct kgsl_device *device = data;
+	struct adreno_profile *profile = &ADRENO_DEVICE(device)->profile;
+	int ret = 0;
+
+	mutex_lock(&device->mutex);
+	if (val && !_profile_sampling(profile))
+		ret = _profile_sample_setup(ADRENO_DEVICE(device));
+	if (!ret)
+		WRITE_ONCE(profile->sample_retire, !!val);
+	mutex_unlock(&device->mutex);
+
+	return ret;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(profile_sample_retire_fops,
+			profile_sample_retire_get,
+			profile_sample_retire_set, "%llu\n");
+
+static int profile_samples_mmap(struct file *filep, struct vm_area_struct *vma)
+{
+	struct kgsl_device *device = (struct kgsl_device *) filep->private_data;
+	struct adreno_profile *profile = &ADRENO_DEVICE(device)->profile;
+	int ret;
+
+	mutex_lock(&device->mutex);
+	ret = _profile_sample_ring_alloc(profile);
+	if (!ret)
+		ret = remap_vmalloc_range(vma, profile->sample_ring,
+			vma->vm_pgoff);
+	mutex_unlock(&device->mutex);
+
+	return ret;
+}
+
+static const struct file_operations profile_samples_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.mmap = profile_samples_mmap,
+	.llseek = noop_llseek,
+};
+
 static const struct file_operations profile_pipe_fops = {
 	.owner = THIS_MODULE,
 	.open = simple_open,
@@ -1014,6 +1263,8 @@ void adreno_profile_init(struct adreno_device *adreno_dev)
 	}
 
 	INIT_LIST_HEAD(&profile->assignments_list);
+	INIT_DELAYED_WORK(&profile->sample_work, profile_sample_work);
+	INIT_WORK(&profile->sample_retire_work, profile_sample_retire_work);
 
 	/* Create perf counter debugfs */
 	profile_dir = debugfs_create_dir("profiling", device->d_debugfs);
@@ -1028,6 +1279,12 @@ void adreno_profile_init(struct adreno_device *adreno_dev)
 			&profile_pipe_fops);
 	debugfs_create_file("assignments", 0644, profile_dir, device,
 			&profile_assignments_fops);
+	debugfs_create_file("sample_ms", 0644, profile_dir, device,
+			&profile_sample_ms_fops);
+	debugfs_create_file("sample_retire", 0644, profile_dir, device,
+			&profile_sample_retire_fops);
+	debugfs_create_file("samples", 0644, profile_dir, device,
+			&profile_samples_fops);
 }
 
 void adreno_profile_close(struct adreno_device *adreno_dev)
@@ -1036,6 +1293,16 @@ void adreno_profile_close(struct adreno_device *adreno_dev)
 	struct adreno_profile_assigns_list *entry, *tmp;
 
 	profile->enabled = false;
+
+	WRITE_ONCE(profile->sample_ms, 0);
+	WRITE_ONCE(profile->sample_retire, false);
+	if (profile->shared_size) {
+		cancel_delayed_work_sync(&profile->sample_work);
+		cancel_work_sync(&profile->sample_retire_work);
+	}
+	vfree(profile->sample_ring);
+	profile->sample_ring = NULL;
+
 	vfree(profile->log_buffer);
 	profile->log_buffer = NULL;
 	profile->log_head = NULL;
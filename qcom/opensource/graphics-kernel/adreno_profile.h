@@ -22,6 +22,38 @@ struct adreno_profile_assigns_list {
 	unsigned int offset_hi; /* HI offset */
 };
 
+#define ADRENO_PROFILE_SAMPLE_MAGIC 0x4b505352
+#define ADRENO_PROFILE_SAMPLE_MAX_COUNTERS 32
+/* One header page followed by the samples */
+#define ADRENO_PROFILE_SAMPLE_RING_SIZE (64 * PAGE_SIZE)
+
+/**
+ * struct adreno_profile_sample_header - Header page of the sample ring
+ * @magic: ADRENO_PROFILE_SAMPLE_MAGIC
+ * @entry_size: Size of each sample in bytes
+ * @nr_entries: Number of samples that fit in the ring
+ * @nr_counters: Number of counter values in each sample
+ * @head: Number of samples written so far, updated by the kernel
+ * @tail: Number of samples consumed so far, updated by the reader
+ * @dropped: Number of samples dropped because the ring was full
+ * @groupid: Perfcounter group of each counter value
+ * @countable: Countable of each counter value
+ *
+ * Sample n lives at offset PAGE_SIZE + (n % @nr_entries) * @entry_size and
+ * holds a u64 CPU timestamp in ns followed by @nr_counters u64 values.
+ */
+struct adreno_profile_sample_header {
+	u32 magic;
+	u32 entry_size;
+	u32 nr_entries;
+	u32 nr_counters;
+	u64 head;
+	u64 tail;
+	u64 dropped;
+	u32 groupid[ADRENO_PROFILE_SAMPLE_MAX_COUNTERS];
+	u32 countable[ADRENO_PROFILE_SAMPLE_MAX_COUNTERS];
+};
+
 struct adreno_profile {
 	struct list_head assignments_list; /* list of all assignments */
 	unsigned int assignment_count;  /* Number of assigned counters */
@@ -43,6 +75,19 @@ struct adreno_profile {
 	unsigned int shared_head;
 	unsigned int shared_tail;
 	unsigned int shared_size;
+	/* Periodic sampling of the assigned counters into an mmap-able ring */
+	struct adreno_profile_sample_header *sample_ring;
+	unsigned int sample_ms;
+	bool sample_retire;
+	/* Kernel copy of the ring layout, the mapped header is not trusted */
+	u32 sample_count;
+	u32 sample_size;
+	u32 sample_entries;
+	u64 sample_head;
+	u32 sample_groupid[ADRENO_PROFILE_SAMPLE_MAX_COUNTERS];
+	u32 sample_countable[ADRENO_PROFILE_SAMPLE_MAX_COUNTERS];
+	struct delayed_work sample_work;
+	struct work_struct sample_retire_work;
 };
 
 #define ADRENO_PROFILE_SHARED_BUF_SIZE_DWORDS (48 * 4096 / sizeof(uint))
@@ -61,6 +106,7 @@ u64 adreno_profile_preib_processing(struct adreno_device *adreno_dev,
 		struct adreno_context *drawctxt, u32 *dwords);
 u64 adreno_profile_postib_processing(struct  adreno_device *adreno_dev,
 		struct adreno_context *drawctxt, u32 *dwords);
+void adreno_profile_sample_retire(struct adreno_device *adreno_dev);
 #else
 static inline void adreno_profile_init(struct adreno_device *adreno_dev) { }
 static inline void adreno_profile_close(struct adreno_device *adreno_dev) { }
@@ -84,6 +130,9 @@ adreno_profile_postib_processing(struct adreno_device *adreno_dev,
 	return 0;
 }
 
+static inline void adreno_profile_sample_retire(
+		struct adreno_device *adreno_dev) { }
+
 #endif
 
 static inline bool adreno_profile_enabled(struct adreno_profile *profile)
@@ -169,6 +169,62 @@ void adreno_preemption_timer(struct timer_list *t)
 	queue_work(system_unbound_wq, &adreno_dev->preempt.work);
 }
 
+void adreno_ringbuffer_preempt_wait(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *rb, u64 now)
+{
+	if (!adreno_is_preemption_enabled(adreno_dev) ||
+		rb == adreno_dev->cur_rb)
+		return;
+
+	/* Keep the time of the oldest submission that is waiting */
+	if (!READ_ONCE(rb->preempt_wait))
+		WRITE_ONCE(rb->preempt_wait, now);
+}
+
+void adreno_ringbuffer_preempt_done(struct adreno_ringbuffer *rb)
+{
+	struct adreno_rb_preempt_stats *stats = &rb->preempt_stats;
+	u64 wait = READ_ONCE(rb->preempt_wait);
+	u32 target = READ_ONCE(rb->preempt_target_us);
+	u64 us;
+
+	if (!wait)
+		return;
+
+	WRITE_ONCE(rb->preempt_wait, 0);
+
+	us = div_u64(local_clock() - wait, NSEC_PER_USEC);
+
+	stats->count++;
+	stats->total_us += us;
+	stats->max_us = max(stats->max_us, us);
+
+	if (target && us > target)
+		stats->missed++;
+}
+
+u32 adreno_preempt_level(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *next)
+{
+	struct adreno_preemption *preempt = &adreno_dev->preempt;
+	u64 wait = READ_ONCE(next->preempt_wait);
+	u32 target = READ_ONCE(next->preempt_target_us);
+
+	/*
+	 * Strict priority still picks the RB. Once the RB has burnt through
+	 * half of its latency target switch at the urgent level so that the
+	 * CP doesn't keep running the current RB until a coarse preemption
+	 * point.
+	 */
+	if (wait && target &&
+		(local_clock() - wait) * 2 >= (u64) target * NSEC_PER_USEC) {
+		next->preempt_stats.urgent++;
+		return preempt->urgent_level;
+	}
+
+	return preempt->preempt_level;
+}
+
 void adreno_drawobj_set_constraint(struct kgsl_device *device,
 			struct kgsl_drawobj *drawobj)
 {
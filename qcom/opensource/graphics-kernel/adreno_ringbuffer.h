@@ -72,6 +72,22 @@ struct adreno_submit_time {
  */
 #define ADRENO_RB_SET_PSEUDO_DONE 0
 
+/**
+ * struct adreno_rb_preempt_stats - Preemption latency statistics for a RB
+ * @count: Number of times the RB was switched in after waiting for it
+ * @total_us: Total time the RB waited to be switched in
+ * @max_us: Longest time the RB waited to be switched in
+ * @missed: Number of switches that took longer than the latency target
+ * @urgent: Number of switches triggered at the urgent preemption level
+ */
+struct adreno_rb_preempt_stats {
+	u64 count;
+	u64 total_us;
+	u64 max_us;
+	u64 missed;
+	u64 urgent;
+};
+
 /**
  * struct adreno_ringbuffer - Definition for an adreno ringbuffer object
  * @flags: Internal control flags for the ringbuffer
@@ -137,11 +153,49 @@ struct adreno_ringbuffer {
 	 * enough.
 	 */
 	u32 profile_index;
+	/**
+	 * @preempt_target_us: Latency target for switching to this RB once it
+	 * has work, 0 for no target
+	 */
+	u32 preempt_target_us;
+	/**
+	 * @preempt_wait: local_clock() time at which work was first submitted
+	 * to this RB while another RB was current, 0 if it isn't waiting
+	 */
+	u64 preempt_wait;
+	/** @preempt_stats: Preemption latency statistics for this RB */
+	struct adreno_rb_preempt_stats preempt_stats;
 };
 
 /* Returns the current ringbuffer */
 #define ADRENO_CURRENT_RINGBUFFER(a)	((a)->cur_rb)
 
+/**
+ * adreno_ringbuffer_preempt_wait - Note that a RB is waiting to be switched in
+ * @adreno_dev: An Adreno GPU device handle
+ * @rb: The ringbuffer that work was submitted to
+ * @now: local_clock() time of the submission
+ */
+void adreno_ringbuffer_preempt_wait(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *rb, u64 now);
+
+/**
+ * adreno_ringbuffer_preempt_done - Account a completed switch to a RB
+ * @rb: The ringbuffer that was switched in
+ */
+void adreno_ringbuffer_preempt_done(struct adreno_ringbuffer *rb);
+
+/**
+ * adreno_preempt_level - Pick the preemption level for a switch
+ * @adreno_dev: An Adreno GPU device handle
+ * @next: The ringbuffer that is about to be switched in
+ *
+ * Return: The urgent preemption level if @next has used up half of its
+ * latency target, otherwise the default preemption level.
+ */
+u32 adreno_preempt_level(struct adreno_device *adreno_dev,
+		struct adreno_ringbuffer *next);
+
 int adreno_ringbuffer_issueibcmds(struct kgsl_device_private *dev_priv,
 				struct kgsl_context *context,
 				struct kgsl_drawobj *drawobj,
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023, Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+#include <linux/devfreq.h>
+#include <linux/math64.h>
+#include <linux/of_platform.h>
+#include <linux/sched/clock.h>
+
+#include "governor.h"
+#include "msm_adreno_devfreq.h"
+
+#define TAG "msm_adreno_predict: "
+
+/*
+ * The predictive governor picks the GPU frequency from the frame aligned
+ * busy history that KGSL keeps for each context. Whenever a context finishes
+ * a frame KGSL predicts the cycles needed for the next one and publishes the
+ * frequency that fits those cycles into the frame period at the target load.
+ * When no context has produced a frame recently the governor falls back to
+ * scaling the current frequency with the measured load.
+ */
+
+static ssize_t prediction_error_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+		READ_ONCE(priv->predict.error));
+}
+
+static ssize_t predicted_freq_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+
+	return scnprintf(buf, PAGE_SIZE, "%lu\n",
+		READ_ONCE(priv->predict.freq));
+}
+
+static ssize_t target_load_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+	unsigned int val;
+	int ret;
+
+	ret = kstrtou32(buf, 0, &val);
+	if (ret)
+		return ret;
+
+	WRITE_ONCE(priv->predict.target_load, clamp_t(u32, val, 10, 100));
+
+	return count;
+}
+
+static ssize_t target_load_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct devfreq *devfreq = to_devfreq(dev);
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", priv->predict.target_load);
+}
+
+static DEVICE_ATTR_RO(prediction_error);
+static DEVICE_ATTR_RO(predicted_freq);
+static DEVICE_ATTR_RW(target_load);
+
+static const struct device_attribute *adreno_predict_attr_list[] = {
+		&dev_attr_prediction_error,
+		&dev_attr_predicted_freq,
+		&dev_attr_target_load,
+		NULL
+};
+
+static int predict_get_target_freq(struct devfreq *devfreq, unsigned long *freq)
+{
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+	struct devfreq_dev_status *stats = &devfreq->last_status;
+	unsigned long target;
+	int result, level;
+
+	if (!priv)
+		return 0;
+
+	result = devfreq_update_stats(devfreq);
+	if (result) {
+		pr_err(TAG "get_status failed %d\n", result);
+		return result;
+	}
+
+	*freq = stats->current_frequency;
+
+	if (local_clock() < READ_ONCE(priv->predict.expires))
+		target = READ_ONCE(priv->predict.freq);
+	else if (stats->total_time)
+		target = div64_u64((u64) stats->current_frequency *
+			stats->busy_time * 100, stats->total_time *
+			READ_ONCE(priv->predict.target_load));
+	else
+		return 0;
+
+	/* Pick the lowest frequency that fits the target */
+	for (level = devfreq->profile->max_state - 1; level > 0; level--)
+		if (devfreq->profile->freq_table[level] >= target)
+			break;
+
+	*freq = devfreq->profile->freq_table[level];
+	return 0;
+}
+
+static int predict_start(struct devfreq *devfreq)
+{
+	struct msm_adreno_extended_profile *gpu_profile = container_of(
+					(devfreq->profile),
+					struct msm_adreno_extended_profile,
+					profile);
+	struct devfreq_msm_adreno_tz_data *priv;
+	int i;
+
+	/* Same single instance assumption as the msm-adreno-tz governor */
+	devfreq->data = gpu_profile->private_data;
+	priv = devfreq->data;
+
+	priv->predict.freq = 0;
+	priv->predict.expires = 0;
+	priv->predict.error = 0;
+	WRITE_ONCE(priv->predict.enabled, true);
+
+	for (i = 0; adreno_predict_attr_list[i] != NULL; i++)
+		device_create_file(&devfreq->dev, adreno_predict_attr_list[i]);
+
+	return 0;
+}
+
+static int predict_stop(struct devfreq *devfreq)
+{
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+	int i;
+
+	for (i = 0; adreno_predict_attr_list[i] != NULL; i++)
+		device_remove_file(&devfreq->dev, adreno_predict_attr_list[i]);
+
+	if (priv)
+		WRITE_ONCE(priv->predict.enabled, false);
+
+	devfreq->data = NULL;
+	return 0;
+}
+
+static int predict_handler(struct devfreq *devfreq, unsigned int event,
+		void *data)
+{
+	struct devfreq_msm_adreno_tz_data *priv = devfreq->data;
+	struct device_node *node = devfreq->dev.parent->of_node;
+
+	if (!of_device_is_compatible(node, "qcom,kgsl-3d0"))
+		return -EINVAL;
+
+	switch (event) {
+	case DEVFREQ_GOV_START:
+		return predict_start(devfreq);
+	case DEVFREQ_GOV_STOP:
+		return predict_stop(devfreq);
+	case DEVFREQ_GOV_SUSPEND:
+		/* The history is stale once the GPU has been idle */
+		if (priv)
+			WRITE_ONCE(priv->predict.expires, 0);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static struct devfreq_governor msm_adreno_predict = {
+	.name = "msm-adreno-predict",
+	.get_target_freq = predict_get_target_freq,
+	.event_handler = predict_handler,
+};
+
+int msm_adreno_predict_init(void)
+{
+	return devfreq_add_governor(&msm_adreno_predict);
+}
+
+void msm_adreno_predict_exit(void)
+{
+	int ret = devfreq_remove_governor(&msm_adreno_predict);
+
+	if (ret)
+		pr_err(TAG "failed to remove governor %d\n", ret);
+}
@@ -352,6 +352,7 @@ enum kgsl_timestamp_type {
 #define KGSL_PROP_VK_DEVICE_ID		0x2A
 #define KGSL_PROP_IS_LPAC_ENABLED	0x2B
 #define KGSL_PROP_GPU_VA64_SIZE		0x2C
+#define KGSL_PROP_TIMELINE_SHADOW	0x2D
 
 /*
  * kgsl_capabilities_properties returns a list of supported properties.
@@ -1918,6 +1919,24 @@ struct kgsl_timeline_val {
 	__u32 padding;
 };
 
+/**
+ * struct kgsl_timeline_shadowprop - Description of the timeline shadow page
+ * @offset: mmap() offset to use to map the page
+ * @size: Size of the page in bytes
+ * @count: Number of 64 bit slots in the page
+ *
+ * Returned by KGSL_PROP_TIMELINE_SHADOW. The page holds the current value of
+ * each timeline at the slot matching the timeline identifier. Timelines with
+ * an identifier of @count or higher are not shadowed and must be queried with
+ * IOCTL_KGSL_TIMELINE_QUERY. The page is read only and @size is zero if the
+ * shadow is not available.
+ */
+struct kgsl_timeline_shadowprop {
+	__u64 offset;
+	__u32 size;
+	__u32 count;
+};
+
 #define KGSL_TIMELINE_WAIT_ALL 1
 #define KGSL_TIMELINE_WAIT_ANY 2
 
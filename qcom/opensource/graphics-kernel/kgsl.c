@@ -37,6 +37,7 @@
 #include "kgsl_reclaim.h"
 #include "kgsl_sync.h"
 #include "kgsl_sysfs.h"
+#include "kgsl_timeline.h"
 #include "kgsl_trace.h"
 /* Instantiate tracepoints */
 #define CREATE_TRACE_POINTS
@@ -259,6 +260,7 @@ static struct kgsl_mem_entry *kgsl_mem_entry_create(void)
 		/* put this ref in userspace memory alloc and map ioctls */
 		kref_get(&entry->refcount);
 		atomic_set(&entry->map_count, 0);
+		entry->last_used = jiffies;
 	}
 
 	return entry;
@@ -420,11 +422,93 @@ static void _deferred_destroy(struct work_struct *work)
 	kgsl_mem_entry_destroy(&entry->refcount);
 }
 
+/* Maximum number of entries waiting in the deferred free batch queue */
+#define KGSL_DEFERRED_FREE_MAX_BACKLOG 1024
+
+static LLIST_HEAD(kgsl_deferred_free_list);
+
+/*
+ * Return true if the GPU mapping of the memdesc can be torn down ahead of
+ * kgsl_mem_entry_destroy() without a TLB flush of its own. Only plain paged
+ * memory released through kgsl_unmap_and_put_gpuaddr() qualifies.
+ */
+static bool kgsl_memdesc_can_batch_unmap(struct kgsl_memdesc *memdesc)
+{
+	if (!memdesc->pagetable || !memdesc->gpuaddr || !memdesc->ops)
+		return false;
+
+	if (memdesc->ops->put_gpuaddr != kgsl_unmap_and_put_gpuaddr)
+		return false;
+
+	if (!(memdesc->priv & KGSL_MEMDESC_MAPPED) ||
+		kgsl_memdesc_is_global(memdesc) ||
+		kgsl_memdesc_is_reclaimed(memdesc))
+		return false;
+
+	return !(memdesc->flags & KGSL_MEMFLAGS_VBO);
+}
+
+static void _deferred_free_batch(struct work_struct *work)
+{
+	struct llist_node *list = llist_del_all(&kgsl_deferred_free_list);
+	struct kgsl_mem_entry *entry, *tmp;
+	struct kgsl_mmu *mmu = NULL;
+	long count = 0;
+
+	if (!list)
+		return;
+
+	list = llist_reverse_order(list);
+
+	/* Tear down all the GPU mappings first and flush the TLB only once */
+	llist_for_each_entry(entry, list, free_node) {
+		struct kgsl_memdesc *memdesc = &entry->memdesc;
+
+		count++;
+
+		if (!kgsl_memdesc_can_batch_unmap(memdesc))
+			continue;
+
+		memdesc->priv |= KGSL_MEMDESC_SKIP_TLB_FLUSH;
+		if (!kgsl_mmu_unmap(memdesc->pagetable, memdesc))
+			mmu = memdesc->pagetable->mmu;
+		memdesc->priv &= ~KGSL_MEMDESC_SKIP_TLB_FLUSH;
+	}
+
+	if (mmu)
+		kgsl_mmu_flush_tlb(mmu);
+
+	/* Now release the GPU addresses and give the pages back to the pools */
+	llist_for_each_entry_safe(entry, tmp, list, free_node)
+		kgsl_mem_entry_destroy(&entry->refcount);
+
+	atomic_long_sub(count, &kgsl_driver.stats.deferred_free_pending);
+	atomic_long_add(count, &kgsl_driver.stats.deferred_free_entries);
+	atomic_long_inc(&kgsl_driver.stats.deferred_free_batches);
+}
+
+static DECLARE_WORK(kgsl_deferred_free_work, _deferred_free_batch);
+
 void kgsl_mem_entry_destroy_deferred(struct kref *kref)
 {
 	struct kgsl_mem_entry *entry =
 		container_of(kref, struct kgsl_mem_entry, refcount);
 
+	/*
+	 * Queue the entry for the next batch unless the backlog is full, in
+	 * which case destroy it on its own so that memory keeps getting freed
+	 */
+	if (atomic_long_inc_return(&kgsl_driver.stats.deferred_free_pending) <=
+		KGSL_DEFERRED_FREE_MAX_BACKLOG) {
+		llist_add(&entry->free_node, &kgsl_deferred_free_list);
+		queue_work(kgsl_driver.lockless_workqueue,
+			&kgsl_deferred_free_work);
+		return;
+	}
+
+	atomic_long_dec(&kgsl_driver.stats.deferred_free_pending);
+	atomic_long_inc(&kgsl_driver.stats.deferred_free_overflow);
+
 	INIT_WORK(&entry->work, _deferred_destroy);
 	queue_work(kgsl_driver.lockless_workqueue, &entry->work);
 }
@@ -1860,6 +1944,28 @@ static long kgsl_get_gpu_va64_size(struct kgsl_device_private *dev_priv,
 	return 0;
 }
 
+static long kgsl_prop_timeline_shadow(struct kgsl_device_private *dev_priv,
+		struct kgsl_device_getproperty *param)
+{
+	struct kgsl_device *device = dev_priv->device;
+	struct kgsl_timeline_shadowprop prop = { 0 };
+
+	if (param->sizebytes != sizeof(prop))
+		return -EINVAL;
+
+	if (device->timeline_shadow) {
+		/* Pass a dummy address to identify the timeline shadow */
+		prop.offset = KGSL_TIMELINE_TOKEN_ADDRESS;
+		prop.size = PAGE_SIZE;
+		prop.count = KGSL_TIMELINE_SHADOW_SLOTS;
+	}
+
+	if (copy_to_user(param->value, &prop, sizeof(prop)))
+		return -EFAULT;
+
+	return 0;
+}
+
 static const struct {
 	int type;
 	long (*func)(struct kgsl_device_private *dev_priv,
@@ -1872,6 +1978,7 @@ static const struct {
 	{ KGSL_PROP_QUERY_CAPABILITIES, kgsl_prop_query_capabilities },
 	{ KGSL_PROP_CONTEXT_PROPERTY, kgsl_get_ctxt_properties },
 	{ KGSL_PROP_GPU_VA64_SIZE, kgsl_get_gpu_va64_size },
+	{ KGSL_PROP_TIMELINE_SHADOW, kgsl_prop_timeline_shadow },
 };
 
 /*call all ioctl sub functions with driver locked*/
@@ -4400,6 +4507,31 @@ kgsl_mmap_memstore(struct file *file, struct kgsl_device *device,
 	return 0;
 }
 
+static int
+kgsl_mmap_timeline_shadow(struct kgsl_device *device,
+		struct vm_area_struct *vma)
+{
+	if (!device->timeline_shadow)
+		return -ENODEV;
+
+	/* The timeline shadow can only be mapped as read only */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	if (vma->vm_end - vma->vm_start != PAGE_SIZE) {
+		dev_err(device->dev, "Cannot partially map the timeline shadow\n");
+		return -EINVAL;
+	}
+
+	vma->vm_flags |= VM_DONTEXPAND | VM_DONTDUMP;
+
+	return remap_pfn_range(vma, vma->vm_start,
+		page_to_pfn(device->timeline_shadow), PAGE_SIZE,
+		vma->vm_page_prot);
+}
+
 /*
  * kgsl_gpumem_vm_open is called whenever a vma region is copied or split.
  * Increase the refcount to make sure that the accounting stays correct
@@ -4658,7 +4790,8 @@ kgsl_get_unmapped_area(struct file *file, unsigned long addr,
 	struct kgsl_device *device = dev_priv->device;
 	struct kgsl_mem_entry *entry = NULL;
 
-	if (vma_offset == (unsigned long) KGSL_MEMSTORE_TOKEN_ADDRESS)
+	if (vma_offset == (unsigned long) KGSL_MEMSTORE_TOKEN_ADDRESS ||
+		vma_offset == (unsigned long) KGSL_TIMELINE_TOKEN_ADDRESS)
 		return get_unmapped_area(NULL, addr, len, pgoff, flags);
 
 	val = get_mmap_entry(private, &entry, pgoff, len);
@@ -4712,6 +4845,9 @@ static int kgsl_mmap(struct file *file, struct vm_area_struct *vma)
 	if (vma_offset == (unsigned long) KGSL_MEMSTORE_TOKEN_ADDRESS)
 		return kgsl_mmap_memstore(file, device, vma);
 
+	if (vma_offset == (unsigned long) KGSL_TIMELINE_TOKEN_ADDRESS)
+		return kgsl_mmap_timeline_shadow(device, vma);
+
 	/*
 	 * The reference count on the entry that we get from
 	 * get_mmap_entry() will be held until kgsl_gpumem_vm_close().
@@ -4827,6 +4963,10 @@ struct kgsl_driver kgsl_driver  = {
 	.stats.secure = ATOMIC_LONG_INIT(0),
 	.stats.secure_max = ATOMIC_LONG_INIT(0),
 	.stats.mapped = ATOMIC_LONG_INIT(0),
+	.stats.deferred_free_pending = ATOMIC_LONG_INIT(0),
+	.stats.deferred_free_entries = ATOMIC_LONG_INIT(0),
+	.stats.deferred_free_batches = ATOMIC_LONG_INIT(0),
+	.stats.deferred_free_overflow = ATOMIC_LONG_INIT(0),
 	.stats.mapped_max = ATOMIC_LONG_INIT(0),
 };
 
@@ -5020,6 +5160,7 @@ int kgsl_device_platform_probe(struct kgsl_device *device)
 
 	idr_init(&device->timelines);
 	spin_lock_init(&device->timelines_lock);
+	kgsl_timeline_shadow_init(device);
 
 	kgsl_device_debugfs_init(device);
 
@@ -5060,6 +5201,7 @@ void kgsl_device_platform_remove(struct kgsl_device *device)
 
 	idr_destroy(&device->context_idr);
 	idr_destroy(&device->timelines);
+	kgsl_timeline_shadow_close(device);
 
 	kgsl_device_events_remove(device);
 
@@ -10,6 +10,7 @@
 #include <linux/compat.h>
 #include <linux/interrupt.h>
 #include <linux/kthread.h>
+#include <linux/llist.h>
 #include <linux/mm.h>
 #include <uapi/linux/msm_kgsl.h>
 #include <linux/uaccess.h>
@@ -187,6 +188,17 @@ struct kgsl_driver {
 		atomic_long_t secure_max;
 		atomic_long_t mapped;
 		atomic_long_t mapped_max;
+		/** @stats.deferred_free_pending: Entries waiting to be freed */
+		atomic_long_t deferred_free_pending;
+		/** @stats.deferred_free_entries: Entries freed in batches */
+		atomic_long_t deferred_free_entries;
+		/** @stats.deferred_free_batches: Number of batches freed */
+		atomic_long_t deferred_free_batches;
+		/**
+		 * @stats.deferred_free_overflow: Entries freed on their own
+		 * because the batch backlog was full
+		 */
+		atomic_long_t deferred_free_overflow;
 	} stats;
 	unsigned int full_cache_threshold;
 	struct workqueue_struct *workqueue;
@@ -241,6 +253,8 @@ struct kgsl_memdesc_ops {
 #define KGSL_MEMDESC_IOMEM BIT(13)
 /* The memdesc is hypassigned to HLOS*/
 #define KGSL_MEMDESC_HYPASSIGNED_HLOS BIT(14)
+/* Unmap the memdesc without a TLB flush, the caller will flush the TLB */
+#define KGSL_MEMDESC_SKIP_TLB_FLUSH BIT(15)
 
 /**
  * struct kgsl_memdesc - GPU memory object descriptor
@@ -332,6 +346,9 @@ struct kgsl_global_memdesc {
  * @dev_priv: back pointer to the device file that created this entry.
  * @metadata: String containing user specified metadata for the entry
  * @work: Work struct used to schedule kgsl_mem_entry_destroy()
+ * @free_node: Node in the list of entries to be destroyed in a batch
+ * @last_used: Time in jiffies when a submission last referenced the entry
+ * @reclaim_bucket: Idle time histogram bucket the entry was reclaimed from
  */
 struct kgsl_mem_entry {
 	struct kref refcount;
@@ -343,6 +360,9 @@ struct kgsl_mem_entry {
 	int pending_free;
 	char metadata[KGSL_GPUOBJ_ALLOC_METADATA_MAX + 1];
 	struct work_struct work;
+	struct llist_node free_node;
+	unsigned long last_used;
+	u32 reclaim_bucket;
 	/**
 	 * @map_count: Count how many vmas this object is mapped in - used for
 	 * debugfs accounting
@@ -272,6 +272,8 @@ struct kgsl_device {
 	bool snapshot_crashdumper;
 	/* Use HOST side register reads to get GPU snapshot*/
 	bool snapshot_legacy;
+	/* Hand each snapshot to devcoredump instead of the resident buffer */
+	bool snapshot_devcoredump;
 	/* Use to dump the context record in bytes */
 	u64 snapshot_ctxt_record_size;
 
@@ -311,6 +313,8 @@ struct kgsl_device {
 	struct idr timelines;
 	/** @timelines_lock: Spinlock to protect the timelines idr */
 	spinlock_t timelines_lock;
+	/** @timeline_shadow: Page of timeline values that userspace can map */
+	struct page *timeline_shadow;
 	/** @fence_trace_array: A local trace array for fence debugging */
 	struct trace_array *fence_trace_array;
 	/** @l3_vote: Enable/Disable l3 voting */
@@ -561,6 +565,8 @@ struct kgsl_device_private {
  * @sysfs_read: Count of current reads via sysfs
  * @first_read: True until the snapshot read is started
  * @recovered: True if GPU was recovered after previous snapshot
+ * @devcoredump: True if @start is owned by this instance and the snapshot is
+ * handed to devcoredump once the frozen objects are saved
  */
 struct kgsl_snapshot {
 	uint64_t ib1base;
@@ -591,6 +597,7 @@ struct kgsl_snapshot {
 	unsigned int sysfs_read;
 	bool first_read;
 	bool recovered;
+	bool devcoredump;
 	struct kgsl_device *device;
 };
 
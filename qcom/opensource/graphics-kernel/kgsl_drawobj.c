@@ -27,6 +27,7 @@
 #include "kgsl_device.h"
 #include "kgsl_drawobj.h"
 #include "kgsl_eventlog.h"
+#include "kgsl_reclaim.h"
 #include "kgsl_sync.h"
 #include "kgsl_timeline.h"
 #include "kgsl_trace.h"
@@ -1427,6 +1428,11 @@ int kgsl_drawobj_cmd_add_memlist(struct kgsl_device *device,
 				&obj);
 			if (ret)
 				return ret;
+
+			/* Let reclaim know that this buffer is still in use */
+			kgsl_reclaim_touch_memobj(
+				DRAWOBJ(cmdobj)->context->proc_priv,
+				obj.gpuaddr, obj.id);
 		}
 
 		ptr += sizeof(obj);
@@ -69,6 +69,7 @@ struct kgsl_drawobj {
  * buffer
  * @submit_ticks: Variable to hold ticks at the time of
  *     command obj submit.
+ * @queue_time: CPU time in ns when the command obj was queued to the context
 
  */
 struct kgsl_drawobj_cmd {
@@ -84,6 +85,7 @@ struct kgsl_drawobj_cmd {
 	uint64_t profiling_buffer_gpuaddr;
 	unsigned int profile_index;
 	uint64_t submit_ticks;
+	u64 queue_time;
 	/* @numibs: Number of ibs in this cmdobj */
 	u32 numibs;
 	/* @requeue_cnt: Number of times cmdobj was requeued before submission to dq succeeded */
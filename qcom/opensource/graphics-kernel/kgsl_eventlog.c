@@ -3,6 +3,7 @@
  * Copyright (c) 2021, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/log2.h>
 #include <linux/sched.h>
 #include <linux/sched/clock.h>
 #include <linux/slab.h>
@@ -107,6 +108,33 @@ void kgsl_eventlog_exit(void)
 	eventlog_wptr = 0;
 }
 
+/*
+ * Updates for a context only come from its dispatcher so a plain increment is
+ * enough here. Readers may see a slightly stale count which is fine for a
+ * histogram.
+ */
+void kgsl_latency_hist_add(struct kgsl_latency_hist *hist,
+		enum kgsl_latency_stage stage, u64 ns)
+{
+	u64 us = div_u64(ns, NSEC_PER_USEC);
+	u32 bucket = us ? min_t(u32, ilog2(us) + 1,
+			KGSL_LATENCY_BUCKETS - 1) : 0;
+
+	WRITE_ONCE(hist->count[stage][bucket],
+		hist->count[stage][bucket] + 1);
+}
+
+/* Add the latency between two GPU always on counter values */
+void kgsl_latency_hist_add_ticks(struct kgsl_latency_hist *hist,
+		enum kgsl_latency_stage stage, u64 start, u64 end)
+{
+	if (!start || end < start)
+		return;
+
+	/* The always on counter runs at the XO frequency of 19.2 MHz */
+	kgsl_latency_hist_add(hist, stage, div_u64((end - start) * 10000, 192));
+}
+
 void log_kgsl_fire_event(u32 id, u32 ts, u32 type, u32 age)
 {
 	struct {
@@ -6,6 +6,72 @@
 #ifndef _KGSL_EVENTLOG_H
 #define _KGSL_EVENTLOG_H
 
+#include <linux/types.h>
+
+/* Command latency stages tracked for each context */
+enum kgsl_latency_stage {
+	/** @KGSL_LATENCY_QUEUE_SUBMIT: Queued by the ioctl to sent to hardware */
+	KGSL_LATENCY_QUEUE_SUBMIT = 0,
+	/** @KGSL_LATENCY_SUBMIT_START: Sent to hardware to started on the GPU */
+	KGSL_LATENCY_SUBMIT_START,
+	/** @KGSL_LATENCY_START_RETIRE: Started on the GPU to retired */
+	KGSL_LATENCY_START_RETIRE,
+	/** @KGSL_LATENCY_QUEUE_RETIRE: Queued by the ioctl to retired */
+	KGSL_LATENCY_QUEUE_RETIRE,
+	KGSL_LATENCY_STAGES,
+};
+
+/*
+ * Latency buckets are log2 microseconds: bucket 0 counts anything below 1us,
+ * bucket n counts [2^(n-1), 2^n) us and the last bucket also counts anything
+ * longer than that.
+ */
+#define KGSL_LATENCY_BUCKETS 24
+
+/**
+ * struct kgsl_latency_hist - Per context histogram of command latencies
+ */
+struct kgsl_latency_hist {
+	/** @count: Number of commands in each latency bucket of each stage */
+	u32 count[KGSL_LATENCY_STAGES][KGSL_LATENCY_BUCKETS];
+};
+
+#define KGSL_LATENCY_HIST_MAGIC 0x4b4c4854
+#define KGSL_LATENCY_HIST_VERSION 1
+
+/**
+ * struct kgsl_latency_hist_header - Header of the binary latency histogram dump
+ * @magic: KGSL_LATENCY_HIST_MAGIC
+ * @version: KGSL_LATENCY_HIST_VERSION
+ * @stages: Number of stages in each record
+ * @buckets: Number of buckets in each stage
+ * @records: Number of struct kgsl_latency_hist_record following the header
+ */
+struct kgsl_latency_hist_header {
+	u32 magic;
+	u32 version;
+	u32 stages;
+	u32 buckets;
+	u32 records;
+} __packed;
+
+/**
+ * struct kgsl_latency_hist_record - Latency histogram of a single context
+ * @id: Context id
+ * @pid: Pid of the process owning the context
+ * @hist: Latency histogram of the context
+ */
+struct kgsl_latency_hist_record {
+	u32 id;
+	u32 pid;
+	struct kgsl_latency_hist hist;
+} __packed;
+
+void kgsl_latency_hist_add(struct kgsl_latency_hist *hist,
+		enum kgsl_latency_stage stage, u64 ns);
+void kgsl_latency_hist_add_ticks(struct kgsl_latency_hist *hist,
+		enum kgsl_latency_stage stage, u64 start, u64 end);
+
 void kgsl_eventlog_init(void);
 void kgsl_eventlog_exit(void);
 
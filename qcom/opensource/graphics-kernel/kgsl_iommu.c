@@ -268,18 +268,14 @@ static void kgsl_iommu_flush_tlb(struct kgsl_mmu *mmu)
 		iommu_flush_iotlb_all(to_iommu_domain(&iommu->lpac_context));
 }
 
-static int _iopgtbl_unmap(struct kgsl_iommu_pt *pt, u64 gpuaddr, size_t size)
+/* Remove the pagetable entries for the range without flushing the TLB */
+static int _iopgtbl_unmap_noflush(struct kgsl_iommu_pt *pt, u64 gpuaddr,
+		size_t size)
 {
-	struct kgsl_device *device = KGSL_MMU_DEVICE(pt->base.mmu);
 	struct io_pgtable_ops *ops = pt->pgtbl_ops;
-	int ret = 0;
 
-	if (ops->unmap_pages) {
-		ret = _iopgtbl_unmap_pages(pt, gpuaddr, size);
-		if (ret)
-			return ret;
-		goto flush;
-	}
+	if (ops->unmap_pages)
+		return _iopgtbl_unmap_pages(pt, gpuaddr, size);
 
 	while (size) {
 		if ((ops->unmap(ops, gpuaddr, PAGE_SIZE, NULL)) != PAGE_SIZE)
@@ -289,7 +285,18 @@ static int _iopgtbl_unmap(struct kgsl_iommu_pt *pt, u64 gpuaddr, size_t size)
 		size -= PAGE_SIZE;
 	}
 
-flush:
+	return 0;
+}
+
+static int _iopgtbl_unmap(struct kgsl_iommu_pt *pt, u64 gpuaddr, size_t size)
+{
+	struct kgsl_device *device = KGSL_MMU_DEVICE(pt->base.mmu);
+	int ret;
+
+	ret = _iopgtbl_unmap_noflush(pt, gpuaddr, size);
+	if (ret)
+		return ret;
+
 	/* Skip TLB Operations if GPU is in slumber */
 	if (mutex_trylock(&device->mutex)) {
 		if (device->state == KGSL_STATE_SLUMBER) {
@@ -327,17 +334,24 @@ static size_t _iopgtbl_map_sg(struct kgsl_iommu_pt *pt, u64 gpuaddr,
 		phys_addr_t phys = sg_phys(sg);
 
 		while (size) {
-			ret = ops->map(ops, addr, phys, PAGE_SIZE, prot, GFP_KERNEL);
+			/* Use block mappings for suitably aligned chunks */
+			size_t pgsize = iommu_pgsize(pt->info.cfg.pgsize_bitmap,
+				addr, phys, size, NULL);
+
+			if (!pgsize)
+				pgsize = PAGE_SIZE;
+
+			ret = ops->map(ops, addr, phys, pgsize, prot, GFP_KERNEL);
 
 			if (ret) {
 				_iopgtbl_unmap(pt, gpuaddr, mapped);
 				return 0;
 			}
 
-			phys += PAGE_SIZE;
-			mapped += PAGE_SIZE;
-			addr += PAGE_SIZE;
-			size -= PAGE_SIZE;
+			phys += pgsize;
+			mapped += pgsize;
+			addr += pgsize;
+			size -= pgsize;
 		}
 	}
 
@@ -378,6 +392,11 @@ kgsl_iopgtbl_unmap_range(struct kgsl_pagetable *pt, struct kgsl_memdesc *memdesc
 		(offset + length) > memdesc->size))
 		return -ERANGE;
 
+	/* The bind worker flushes the TLB once for the whole bind object */
+	if (memdesc->priv & KGSL_MEMDESC_SKIP_TLB_FLUSH)
+		return _iopgtbl_unmap_noflush(to_iommu_pt(pt),
+			memdesc->gpuaddr + offset, length);
+
 	return _iopgtbl_unmap(to_iommu_pt(pt), memdesc->gpuaddr + offset,
 			length);
 }
@@ -485,6 +504,11 @@ static int kgsl_iopgtbl_map(struct kgsl_pagetable *pagetable,
 static int kgsl_iopgtbl_unmap(struct kgsl_pagetable *pagetable,
 		struct kgsl_memdesc *memdesc)
 {
+	/* The caller flushes the TLB once for a whole batch of unmaps */
+	if (memdesc->priv & KGSL_MEMDESC_SKIP_TLB_FLUSH)
+		return _iopgtbl_unmap_noflush(to_iommu_pt(pagetable),
+			memdesc->gpuaddr, kgsl_memdesc_footprint(memdesc));
+
 	return _iopgtbl_unmap(to_iommu_pt(pagetable), memdesc->gpuaddr,
 		kgsl_memdesc_footprint(memdesc));
 }
@@ -2216,6 +2240,14 @@ static int kgsl_iommu_get_gpuaddr(struct kgsl_pagetable *pagetable,
 	align = max_t(uint64_t, 1 << kgsl_memdesc_get_align(memdesc),
 			PAGE_SIZE);
 
+	/*
+	 * If the memdesc is backed by 2MB pages align the GPU address to 2MB
+	 * as well so that the SMMU can use block mappings for them
+	 */
+	if (size >= SZ_2M && memdesc->pages && memdesc->page_count &&
+		compound_order(memdesc->pages[0]) >= get_order(SZ_2M))
+		align = max_t(uint64_t, align, SZ_2M);
+
 	if (memdesc->flags & KGSL_MEMFLAGS_FORCE_32BIT) {
 		start = pagetable->compat_va_start;
 		end = pagetable->compat_va_end;
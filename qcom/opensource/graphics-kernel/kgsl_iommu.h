@@ -27,6 +27,12 @@
 
 #define KGSL_MEMSTORE_TOKEN_ADDRESS	(KGSL_IOMMU_SECURE_BASE32 - SZ_4K)
 
+/*
+ * Dummy token address for the timeline shadow page. This is the start of the
+ * secure region which can never be mapped by the CPU.
+ */
+#define KGSL_TIMELINE_TOKEN_ADDRESS	KGSL_IOMMU_SECURE_BASE32
+
 #define KGSL_IOMMU_GLOBAL_MEM_BASE(__mmu)	\
 	(test_bit(KGSL_MMU_64BIT, &(__mmu)->features) ? \
 		KGSL_IOMMU_GLOBAL_MEM_BASE64 : KGSL_IOMMU_GLOBAL_MEM_BASE32)
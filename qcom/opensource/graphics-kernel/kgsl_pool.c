@@ -7,6 +7,7 @@
 #include <asm/cacheflush.h>
 #include <linux/debugfs.h>
 #include <linux/highmem.h>
+#include <linux/kthread.h>
 #include <linux/mempool.h>
 #include <linux/of.h>
 #include <linux/scatterlist.h>
@@ -17,6 +18,34 @@
 #include "kgsl_sharedmem.h"
 #include "kgsl_trace.h"
 
+/* Maximum number of pages a per-cpu magazine can hold */
+#define KGSL_POOL_MAGAZINE_MAX 16
+
+/* Upper bound on the memory cached by a single per-cpu magazine */
+#define KGSL_POOL_MAGAZINE_BYTES SZ_256K
+
+/* Order of the optional 2MB pool that backs SMMU block mappings */
+#define KGSL_POOL_HUGE_ORDER (ilog2(SZ_2M) - PAGE_SHIFT)
+
+/* Limit on the number of 2MB pages reserved for the huge pool */
+#define KGSL_POOL_HUGE_MAX_RESERVED 16
+
+/* page_private() tag for pooled pages that have already been zeroed */
+#define KGSL_POOL_PAGE_CLEAN 1UL
+
+/**
+ * struct kgsl_pool_magazine - Per-cpu page cache in front of a pool
+ * @lock: Spinlock for the magazine. It is only taken by the owning cpu except
+ * when the shrinker or the exit path drains the magazine
+ * @count: Number of pages currently held in the magazine
+ * @pages: Pages of the pool order cached on this cpu
+ */
+struct kgsl_pool_magazine {
+	spinlock_t lock;
+	unsigned int count;
+	struct page *pages[KGSL_POOL_MAGAZINE_MAX];
+};
+
 #ifdef CONFIG_QCOM_KGSL_SORT_POOL
 
 struct kgsl_pool_page_entry {
@@ -37,6 +66,13 @@ static struct kmem_cache *addr_page_cache;
  * @mempool: Mempool to pre-allocate tracking structs for pages in this pool
  * @debug_root: Pointer to the debugfs root for this pool
  * @max_pages: Limit on number of pages this pool can hold
+ * @magazines: Per-cpu page caches in front of @pool_rbtree
+ * @magazine_size: Number of pages each per-cpu magazine may hold
+ * @magazine_count: Number of pages held in all magazines of this pool
+ * @magazine_clean: Number of zeroed pages held in all magazines of this pool
+ * @clean_list: List of pages that were zeroed by the pool zeroing thread
+ * @clean_count: Number of pages in @clean_list, included in @page_count
+ * @kobj: Kobject for the sysfs directory of this pool
  */
 struct kgsl_page_pool {
 	unsigned int pool_order;
@@ -47,6 +83,13 @@ struct kgsl_page_pool {
 	mempool_t *mempool;
 	struct dentry *debug_root;
 	unsigned int max_pages;
+	struct kgsl_pool_magazine __percpu *magazines;
+	unsigned int magazine_size;
+	atomic_t magazine_count;
+	atomic_t magazine_clean;
+	struct list_head clean_list;
+	unsigned int clean_count;
+	struct kobject kobj;
 };
 
 static void *_pool_entry_alloc(gfp_t gfp_mask, void *arg)
@@ -146,6 +189,13 @@ static void kgsl_destroy_page_pool(struct kgsl_page_pool *pool)
  * @page_list: List of pages held/reserved in this pool
  * @debug_root: Pointer to the debugfs root for this pool
  * @max_pages: Limit on number of pages this pool can hold
+ * @magazines: Per-cpu page caches in front of @page_list
+ * @magazine_size: Number of pages each per-cpu magazine may hold
+ * @magazine_count: Number of pages held in all magazines of this pool
+ * @magazine_clean: Number of zeroed pages held in all magazines of this pool
+ * @clean_list: List of pages that were zeroed by the pool zeroing thread
+ * @clean_count: Number of pages in @clean_list, included in @page_count
+ * @kobj: Kobject for the sysfs directory of this pool
  */
 struct kgsl_page_pool {
 	unsigned int pool_order;
@@ -155,6 +205,13 @@ struct kgsl_page_pool {
 	struct list_head page_list;
 	struct dentry *debug_root;
 	unsigned int max_pages;
+	struct kgsl_pool_magazine __percpu *magazines;
+	unsigned int magazine_size;
+	atomic_t magazine_count;
+	atomic_t magazine_clean;
+	struct list_head clean_list;
+	unsigned int clean_count;
+	struct kobject kobj;
 };
 
 static int
@@ -204,6 +261,52 @@ static struct kgsl_page_pool kgsl_pools[6];
 static int kgsl_num_pools;
 static int kgsl_pool_max_pages;
 
+/* Background thread that zeroes the pages sitting in the pools */
+static struct task_struct *kgsl_pool_zero_task;
+static atomic_t kgsl_pool_zero_pending;
+static struct kobject *kgsl_pool_kobj;
+
+/* Wake up the zeroing thread to clean newly pooled pages */
+static void kgsl_pool_zero_kick(void)
+{
+	if (kgsl_pool_zero_task && !atomic_xchg(&kgsl_pool_zero_pending, 1))
+		wake_up_process(kgsl_pool_zero_task);
+}
+
+/* Return true if the page was zeroed in the pool. This clears the tag */
+static bool kgsl_pool_page_test_clear_clean(struct page *p)
+{
+	bool clean = (page_private(p) == KGSL_POOL_PAGE_CLEAN);
+
+	set_page_private(p, 0);
+	return clean;
+}
+
+/* Caller must hold the pool list_lock */
+static void
+__kgsl_pool_add_clean_page(struct kgsl_page_pool *pool, struct page *p)
+{
+	list_add_tail(&p->lru, &pool->clean_list);
+	pool->clean_count++;
+	pool->page_count++;
+}
+
+/* Caller must hold the pool list_lock */
+static struct page *
+__kgsl_pool_get_clean_page(struct kgsl_page_pool *pool)
+{
+	struct page *p;
+
+	p = list_first_entry_or_null(&pool->clean_list, struct page, lru);
+	if (p) {
+		list_del(&p->lru);
+		pool->clean_count--;
+		pool->page_count--;
+	}
+
+	return p;
+}
+
 /* Return the index of the pool for the specified order */
 static int kgsl_get_pool_index(int order)
 {
@@ -251,16 +354,20 @@ _kgsl_pool_add_page(struct kgsl_page_pool *pool, struct page *p)
 	trace_kgsl_pool_add_page(pool->pool_order, pool->page_count);
 	mod_node_page_state(page_pgdat(p),  NR_KERNEL_MISC_RECLAIMABLE,
 				(1 << pool->pool_order));
+
+	kgsl_pool_zero_kick();
 }
 
-/* Returns a page from specified pool */
+/* Returns a page from specified pool, preferring pages already zeroed */
 static struct page *
 _kgsl_pool_get_page(struct kgsl_page_pool *pool)
 {
 	struct page *p = NULL;
 
 	spin_lock(&pool->list_lock);
-	p = __kgsl_pool_get_page(pool);
+	p = __kgsl_pool_get_clean_page(pool);
+	if (!p)
+		p = __kgsl_pool_get_page(pool);
 	spin_unlock(&pool->list_lock);
 	if (p != NULL) {
 		trace_kgsl_pool_get_page(pool->pool_order, pool->page_count);
@@ -270,17 +377,27 @@ _kgsl_pool_get_page(struct kgsl_page_pool *pool)
 	return p;
 }
 
+/* Returns the number of pool entries held in the pool and its magazines */
+static unsigned int _kgsl_pool_entries(struct kgsl_page_pool *pool)
+{
+	return READ_ONCE(pool->page_count) +
+		atomic_read(&pool->magazine_count);
+}
+
 int kgsl_pool_size_total(void)
 {
 	int i;
 	int total = 0;
 
+	/*
+	 * This is called on every page free so don't take the pool locks.
+	 * A slightly stale total is good enough for the pool size limits.
+	 */
 	for (i = 0; i < kgsl_num_pools; i++) {
 		struct kgsl_page_pool *kgsl_pool = &kgsl_pools[i];
 
-		spin_lock(&kgsl_pool->list_lock);
-		total += kgsl_pool->page_count * (1 << kgsl_pool->pool_order);
-		spin_unlock(&kgsl_pool->list_lock);
+		total += _kgsl_pool_entries(kgsl_pool) <<
+				kgsl_pool->pool_order;
 	}
 
 	return total;
@@ -300,11 +417,223 @@ static unsigned long kgsl_pool_size_nonreserved(void)
 			total += (pool->page_count - pool->reserved_pages) *
 					(1 << pool->pool_order);
 		spin_unlock(&pool->list_lock);
+
+		/* Pages cached in the magazines are never reserved */
+		total += atomic_read(&pool->magazine_count) <<
+				pool->pool_order;
 	}
 
 	return total;
 }
 
+/*
+ * Move up to half a magazine worth of pages from the shared pool into
+ * the magazine while holding the pool lock only once. Pages stay accounted
+ * as reclaimable while they sit in the magazine.
+ */
+static void _kgsl_pool_magazine_refill(struct kgsl_page_pool *pool,
+		struct kgsl_pool_magazine *mag)
+{
+	unsigned int batch = max_t(unsigned int, pool->magazine_size >> 1, 1);
+
+	spin_lock(&pool->list_lock);
+	while (mag->count < batch) {
+		struct page *p = __kgsl_pool_get_clean_page(pool);
+
+		if (p)
+			atomic_inc(&pool->magazine_clean);
+		else
+			p = __kgsl_pool_get_page(pool);
+
+		if (!p)
+			break;
+
+		mag->pages[mag->count++] = p;
+		atomic_inc(&pool->magazine_count);
+	}
+	spin_unlock(&pool->list_lock);
+}
+
+/* Move half of a full magazine back to the shared pool */
+static void _kgsl_pool_magazine_drain(struct kgsl_page_pool *pool,
+		struct kgsl_pool_magazine *mag)
+{
+	unsigned int batch = max_t(unsigned int, pool->magazine_size >> 1, 1);
+
+	while (batch-- && mag->count) {
+		struct page *p = mag->pages[--mag->count];
+
+		atomic_dec(&pool->magazine_count);
+
+		if (page_private(p) == KGSL_POOL_PAGE_CLEAN) {
+			atomic_dec(&pool->magazine_clean);
+			spin_lock(&pool->list_lock);
+			__kgsl_pool_add_clean_page(pool, p);
+			spin_unlock(&pool->list_lock);
+			continue;
+		}
+
+		if (__kgsl_pool_add_page(pool, p)) {
+			mod_node_page_state(page_pgdat(p),
+				NR_KERNEL_MISC_RECLAIMABLE,
+				-(1 << pool->pool_order));
+			__free_pages(p, pool->pool_order);
+			trace_kgsl_pool_free_page(pool->pool_order);
+		}
+	}
+
+	kgsl_pool_zero_kick();
+}
+
+/* Returns a page from the magazine of the current cpu */
+static struct page *
+_kgsl_pool_magazine_get(struct kgsl_page_pool *pool)
+{
+	struct kgsl_pool_magazine *mag;
+	struct page *p = NULL;
+
+	if (!pool->magazines)
+		return NULL;
+
+	mag = get_cpu_ptr(pool->magazines);
+	spin_lock(&mag->lock);
+
+	if (!mag->count)
+		_kgsl_pool_magazine_refill(pool, mag);
+
+	if (mag->count) {
+		p = mag->pages[--mag->count];
+		atomic_dec(&pool->magazine_count);
+		if (page_private(p) == KGSL_POOL_PAGE_CLEAN)
+			atomic_dec(&pool->magazine_clean);
+	}
+
+	spin_unlock(&mag->lock);
+	put_cpu_ptr(pool->magazines);
+
+	if (p != NULL) {
+		trace_kgsl_pool_get_page(pool->pool_order,
+			_kgsl_pool_entries(pool));
+		mod_node_page_state(page_pgdat(p), NR_KERNEL_MISC_RECLAIMABLE,
+				-(1 << pool->pool_order));
+	}
+
+	return p;
+}
+
+/* Add a page to the magazine of the current cpu. Return true on success */
+static bool
+_kgsl_pool_magazine_put(struct kgsl_page_pool *pool, struct page *p)
+{
+	struct kgsl_pool_magazine *mag;
+	bool added = false;
+
+	if (!pool->magazines)
+		return false;
+
+	/*
+	 * Sanity check to make sure we don't re-pool a page that
+	 * somebody else has a reference to.
+	 */
+	if (WARN_ON(unlikely(page_count(p) > 1)))
+		return false;
+
+	mag = get_cpu_ptr(pool->magazines);
+	spin_lock(&mag->lock);
+
+	if (mag->count == pool->magazine_size)
+		_kgsl_pool_magazine_drain(pool, mag);
+
+	if (mag->count < pool->magazine_size) {
+		mag->pages[mag->count++] = p;
+		atomic_inc(&pool->magazine_count);
+		added = true;
+	}
+
+	spin_unlock(&mag->lock);
+	put_cpu_ptr(pool->magazines);
+
+	if (added) {
+		trace_kgsl_pool_add_page(pool->pool_order,
+			_kgsl_pool_entries(pool));
+		mod_node_page_state(page_pgdat(p), NR_KERNEL_MISC_RECLAIMABLE,
+				(1 << pool->pool_order));
+	}
+
+	return added;
+}
+
+/*
+ * Free up to num_entries pool entries from the magazines of all cpus and
+ * return the number of pages released to the system.
+ */
+static unsigned int
+_kgsl_pool_magazine_shrink(struct kgsl_page_pool *pool,
+		unsigned int num_entries)
+{
+	unsigned int pcount = 0;
+	int cpu;
+
+	if (!pool->magazines)
+		return 0;
+
+	for_each_possible_cpu(cpu) {
+		struct kgsl_pool_magazine *mag =
+			per_cpu_ptr(pool->magazines, cpu);
+
+		spin_lock(&mag->lock);
+		while (num_entries && mag->count) {
+			struct page *p = mag->pages[--mag->count];
+
+			atomic_dec(&pool->magazine_count);
+			if (kgsl_pool_page_test_clear_clean(p))
+				atomic_dec(&pool->magazine_clean);
+			mod_node_page_state(page_pgdat(p),
+				NR_KERNEL_MISC_RECLAIMABLE,
+				-(1 << pool->pool_order));
+			__free_pages(p, pool->pool_order);
+			trace_kgsl_pool_free_page(pool->pool_order);
+
+			pcount += (1 << pool->pool_order);
+			num_entries--;
+		}
+		spin_unlock(&mag->lock);
+
+		if (!num_entries)
+			break;
+	}
+
+	return pcount;
+}
+
+static void kgsl_pool_magazine_init(struct kgsl_page_pool *pool)
+{
+	int cpu;
+
+	atomic_set(&pool->magazine_count, 0);
+	atomic_set(&pool->magazine_clean, 0);
+
+	pool->magazine_size = min_t(unsigned int, KGSL_POOL_MAGAZINE_MAX,
+		KGSL_POOL_MAGAZINE_BYTES >> (PAGE_SHIFT + pool->pool_order));
+
+	/* Large orders would pin too much memory per cpu */
+	if (!pool->magazine_size)
+		return;
+
+	pool->magazines = alloc_percpu(struct kgsl_pool_magazine);
+	if (!pool->magazines)
+		return;
+
+	for_each_possible_cpu(cpu)
+		spin_lock_init(&per_cpu_ptr(pool->magazines, cpu)->lock);
+}
+
+static void kgsl_pool_magazine_destroy(struct kgsl_page_pool *pool)
+{
+	free_percpu(pool->magazines);
+	pool->magazines = NULL;
+}
+
 /*
  * Returns a page from specified pool only if pool
  * currently holds more number of pages than reserved
@@ -321,7 +650,10 @@ _kgsl_pool_get_nonreserved_page(struct kgsl_page_pool *pool)
 		return NULL;
 	}
 
+	/* Give back dirty pages first as zeroed pages are worth more */
 	p = __kgsl_pool_get_page(pool);
+	if (!p)
+		p = __kgsl_pool_get_clean_page(pool);
 	spin_unlock(&pool->list_lock);
 	if (p != NULL) {
 		trace_kgsl_pool_get_page(pool->pool_order, pool->page_count);
@@ -350,6 +682,11 @@ _kgsl_pool_shrink(struct kgsl_page_pool *pool,
 	num_pages = (num_pages + (1 << pool->pool_order) - 1) >>
 				pool->pool_order;
 
+	/* Empty the per-cpu magazines first as they hold no reserved pages */
+	pcount = _kgsl_pool_magazine_shrink(pool, num_pages);
+	num_pages -= min_t(unsigned int, num_pages,
+			pcount >> pool->pool_order);
+
 	/* This is to ensure that we free reserved pages */
 	if (exit)
 		get_page = _kgsl_pool_get_page;
@@ -360,6 +697,7 @@ _kgsl_pool_shrink(struct kgsl_page_pool *pool,
 		if (!page)
 			break;
 
+		kgsl_pool_page_test_clear_clean(page);
 		__free_pages(page, pool->pool_order);
 		pcount += (1 << pool->pool_order);
 		trace_kgsl_pool_free_page(pool->pool_order);
@@ -384,6 +722,14 @@ kgsl_pool_reduce(int target_pages, bool exit)
 		if (target_pages <= 0)
 			return pcount;
 
+		/*
+		 * Huge pages are hard to get back once fragmentation sets in,
+		 * so don't give one up for a request smaller than a huge page
+		 */
+		if (!exit && kgsl_pools[i].pool_order >= KGSL_POOL_HUGE_ORDER &&
+			target_pages < (1 << kgsl_pools[i].pool_order))
+			continue;
+
 		/* Remove target_pages pages from this pool */
 		ret = _kgsl_pool_shrink(&kgsl_pools[i], target_pages, exit);
 		target_pages -= ret;
@@ -440,6 +786,11 @@ int kgsl_get_page_size(size_t size, unsigned int align)
 {
 	size_t pool;
 
+	/* Only use 2MB pages if the optional huge pool is configured */
+	if ((align >= ilog2(SZ_2M)) && (size >= SZ_2M) &&
+		(kgsl_get_pool_index(KGSL_POOL_HUGE_ORDER) >= 0))
+		return SZ_2M;
+
 	for (pool = SZ_1M; pool > PAGE_SIZE; pool >>= 1)
 		if ((align >= ilog2(pool)) && (size >= pool) &&
 			kgsl_pool_available(pool))
@@ -504,7 +855,9 @@ int kgsl_pool_alloc_page(int *page_size, struct page **pages,
 	}
 
 	pool_idx = kgsl_get_pool_index(order);
-	page = _kgsl_pool_get_page(pool);
+	page = _kgsl_pool_magazine_get(pool);
+	if (page == NULL)
+		page = _kgsl_pool_get_page(pool);
 
 	/* Allocate a new page if not allocated from pool */
 	if (page == NULL) {
@@ -525,7 +878,11 @@ int kgsl_pool_alloc_page(int *page_size, struct page **pages,
 	}
 
 done:
-	kgsl_zero_page(page, order, dev);
+	/* Pages zeroed by the pool thread only need the cache maintenance */
+	if (kgsl_pool_page_test_clear_clean(page))
+		kgsl_page_sync_for_device(dev, page, PAGE_SIZE << order);
+	else
+		kgsl_zero_page(page, order, dev);
 
 	for (j = 0; j < (*page_size >> PAGE_SHIFT); j++) {
 		p = nth_page(page, j);
@@ -555,8 +912,10 @@ void kgsl_pool_free_page(struct page *page)
 	if (!kgsl_pool_max_pages ||
 			(kgsl_pool_size_total() < kgsl_pool_max_pages)) {
 		pool = _kgsl_get_pool_from_order(page_order);
-		if (pool != NULL  && (pool->page_count < pool->max_pages)) {
-			_kgsl_pool_add_page(pool, page);
+		if (pool != NULL &&
+			(_kgsl_pool_entries(pool) < pool->max_pages)) {
+			if (!_kgsl_pool_magazine_put(pool, page))
+				_kgsl_pool_add_page(pool, page);
 			return;
 		}
 	}
@@ -566,6 +925,142 @@ void kgsl_pool_free_page(struct page *page)
 	trace_kgsl_pool_free_page(page_order);
 }
 
+/*
+ * Zero the dirty pages of a pool, one at a time so that the pool lock is
+ * never held across the memset and allocations can proceed meanwhile.
+ */
+static void kgsl_pool_zero_dirty_pages(struct kgsl_page_pool *pool)
+{
+	while (!kthread_should_stop()) {
+		struct page *p;
+
+		spin_lock(&pool->list_lock);
+		p = __kgsl_pool_get_page(pool);
+		spin_unlock(&pool->list_lock);
+
+		if (!p)
+			break;
+
+		kgsl_zero_page(p, pool->pool_order, NULL);
+		set_page_private(p, KGSL_POOL_PAGE_CLEAN);
+
+		spin_lock(&pool->list_lock);
+		__kgsl_pool_add_clean_page(pool, p);
+		spin_unlock(&pool->list_lock);
+
+		cond_resched();
+	}
+}
+
+static int kgsl_pool_zero_main(void *arg)
+{
+	/* Only run when there is nothing better to do */
+	set_user_nice(current, MAX_NICE);
+
+	while (1) {
+		int i;
+
+		set_current_state(TASK_INTERRUPTIBLE);
+
+		if (kthread_should_stop()) {
+			__set_current_state(TASK_RUNNING);
+			break;
+		}
+
+		if (!atomic_xchg(&kgsl_pool_zero_pending, 0)) {
+			schedule();
+			continue;
+		}
+
+		__set_current_state(TASK_RUNNING);
+
+		for (i = 0; i < kgsl_num_pools; i++)
+			kgsl_pool_zero_dirty_pages(&kgsl_pools[i]);
+	}
+
+	return 0;
+}
+
+struct kgsl_pool_attribute {
+	struct attribute attr;
+	ssize_t (*show)(struct kgsl_page_pool *pool, char *buf);
+};
+
+#define to_kgsl_pool_attr(a) \
+	container_of(a, struct kgsl_pool_attribute, attr)
+
+#define KGSL_POOL_ATTR(_name) \
+	static struct kgsl_pool_attribute kgsl_pool_attr_##_name = \
+		__ATTR(_name, 0444, _name##_show, NULL)
+
+static unsigned int kgsl_pool_clean_entries(struct kgsl_page_pool *pool)
+{
+	return READ_ONCE(pool->clean_count) +
+		atomic_read(&pool->magazine_clean);
+}
+
+static ssize_t clean_show(struct kgsl_page_pool *pool, char *buf)
+{
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+		kgsl_pool_clean_entries(pool));
+}
+
+static ssize_t dirty_show(struct kgsl_page_pool *pool, char *buf)
+{
+	unsigned int total = _kgsl_pool_entries(pool);
+	unsigned int clean = kgsl_pool_clean_entries(pool);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+		total > clean ? total - clean : 0);
+}
+
+KGSL_POOL_ATTR(clean);
+KGSL_POOL_ATTR(dirty);
+
+static struct attribute *kgsl_pool_attrs[] = {
+	&kgsl_pool_attr_clean.attr,
+	&kgsl_pool_attr_dirty.attr,
+	NULL,
+};
+
+ATTRIBUTE_GROUPS(kgsl_pool);
+
+static ssize_t kgsl_pool_sysfs_show(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	struct kgsl_page_pool *pool =
+		container_of(kobj, struct kgsl_page_pool, kobj);
+	struct kgsl_pool_attribute *pattr = to_kgsl_pool_attr(attr);
+
+	return pattr->show(pool, buf);
+}
+
+static void kgsl_pool_sysfs_release(struct kobject *kobj)
+{
+	/* The pools are static so there is nothing to free here */
+}
+
+static const struct sysfs_ops kgsl_pool_sysfs_ops = {
+	.show = kgsl_pool_sysfs_show,
+};
+
+static struct kobj_type ktype_kgsl_pool = {
+	.sysfs_ops = &kgsl_pool_sysfs_ops,
+	.release = kgsl_pool_sysfs_release,
+	.default_groups = kgsl_pool_groups,
+};
+
+static void kgsl_pool_init_sysfs(struct kgsl_page_pool *pool,
+		const char *name)
+{
+	if (!kgsl_pool_kobj)
+		return;
+
+	if (kobject_init_and_add(&pool->kobj, &ktype_kgsl_pool,
+		kgsl_pool_kobj, "%s", name))
+		pr_err("kgsl: Unable to add sysfs for pool %s\n", name);
+}
+
 /* Functions for the shrinker */
 
 static unsigned long
@@ -610,7 +1105,7 @@ int kgsl_pool_page_count_get(void *data, u64 *val)
 {
 	struct kgsl_page_pool *pool = data;
 
-	*val = (u64) pool->page_count;
+	*val = (u64) _kgsl_pool_entries(pool);
 	return 0;
 }
 
@@ -627,6 +1122,11 @@ static void kgsl_pool_reserve_pages(struct kgsl_page_pool *pool,
 	/* Limit the total number of reserved pages to 4096 */
 	pool->reserved_pages = min_t(u32, reserved, 4096);
 
+	/* Keep the huge pool reserve to a sane amount of memory */
+	if (pool->pool_order >= KGSL_POOL_HUGE_ORDER)
+		pool->reserved_pages = min_t(u32, pool->reserved_pages,
+				KGSL_POOL_HUGE_MAX_RESERVED);
+
 #if IS_ENABLED(CONFIG_QCOM_KGSL_SORT_POOL)
 	/*
 	 * Pre-allocate tracking structs for reserved_pages so that
@@ -657,7 +1157,7 @@ static int kgsl_of_parse_mempool(struct kgsl_page_pool *pool,
 
 	order = get_order(size);
 
-	if (order > 8) {
+	if (order > KGSL_POOL_HUGE_ORDER) {
 		pr_err("kgsl: %pOF: pool order %d is too big\n", node, order);
 		return -EINVAL;
 	}
@@ -669,11 +1169,15 @@ static int kgsl_of_parse_mempool(struct kgsl_page_pool *pool,
 
 	spin_lock_init(&pool->list_lock);
 	kgsl_pool_list_init(pool);
+	INIT_LIST_HEAD(&pool->clean_list);
 
 	kgsl_pool_reserve_pages(pool, node);
 
+	kgsl_pool_magazine_init(pool);
+
 	snprintf(name, sizeof(name), "%d_order", (pool->pool_order));
 	kgsl_pool_init_debugfs(pool->debug_root, name, (void *) pool);
+	kgsl_pool_init_sysfs(pool, name);
 
 	return 0;
 }
@@ -693,6 +1197,9 @@ void kgsl_probe_page_pools(void)
 
 	kgsl_pool_cache_init();
 
+	kgsl_pool_kobj = kobject_create_and_add("mempools",
+			&kgsl_driver.virtdev.kobj);
+
 	for_each_child_of_node(node, child) {
 		if (!kgsl_of_parse_mempool(&kgsl_pools[index], child))
 			index++;
@@ -708,12 +1215,31 @@ void kgsl_probe_page_pools(void)
 
 	/* Initialize shrinker */
 	register_shrinker(&kgsl_pool_shrinker);
+
+	if (!kgsl_num_pools)
+		return;
+
+	kgsl_pool_zero_task = kthread_run(kgsl_pool_zero_main, NULL,
+			"kgsl_pool_zero");
+	if (IS_ERR(kgsl_pool_zero_task)) {
+		pr_err("kgsl: Unable to start the pool zeroing thread\n");
+		kgsl_pool_zero_task = NULL;
+		return;
+	}
+
+	/* Zero the pages reserved at probe */
+	kgsl_pool_zero_kick();
 }
 
 void kgsl_exit_page_pools(void)
 {
 	int i;
 
+	if (kgsl_pool_zero_task) {
+		kthread_stop(kgsl_pool_zero_task);
+		kgsl_pool_zero_task = NULL;
+	}
+
 	/* Release all pages in pools, if any.*/
 	kgsl_pool_reduce(INT_MAX, true);
 
@@ -721,8 +1247,15 @@ void kgsl_exit_page_pools(void)
 	unregister_shrinker(&kgsl_pool_shrinker);
 
 	/* Destroy helper structures */
-	for (i = 0; i < kgsl_num_pools; i++)
+	for (i = 0; i < kgsl_num_pools; i++) {
+		kgsl_pool_magazine_destroy(&kgsl_pools[i]);
 		kgsl_destroy_page_pool(&kgsl_pools[i]);
+		if (kgsl_pool_kobj)
+			kobject_put(&kgsl_pools[i].kobj);
+	}
+
+	kobject_put(kgsl_pool_kobj);
+	kgsl_pool_kobj = NULL;
 
 	/* Destroy the kmem cache */
 	kgsl_pool_cache_destroy();
@@ -5,6 +5,7 @@
  */
 
 #include <linux/devfreq_cooling.h>
+#include <linux/sched/clock.h>
 #include <linux/slab.h>
 
 #include "kgsl_bus.h"
@@ -18,6 +19,9 @@ static struct devfreq_msm_adreno_tz_data adreno_tz_data = {
 		.floating = true,
 	},
 	.mod_percent = 100,
+	.predict = {
+		.target_load = 85,
+	},
 };
 
 static void do_devfreq_suspend(struct work_struct *work);
@@ -760,12 +764,21 @@ int kgsl_pwrscale_init(struct kgsl_device *device, struct platform_device *pdev,
 		return ret;
 	}
 
+	ret = msm_adreno_predict_init();
+	if (ret) {
+		dev_err(device->dev, "Failed to add adreno predict governor: %d\n", ret);
+		device->pwrscale.enabled = false;
+		msm_adreno_tz_exit();
+		return ret;
+	}
+
 	pwr->nb_max.notifier_call = thermal_max_notifier_call;
 	ret = dev_pm_qos_add_notifier(&pdev->dev, &pwr->nb_max, DEV_PM_QOS_MAX_FREQUENCY);
 
 	if (ret) {
 		dev_err(device->dev, "Unable to register notifier call for thermal: %d\n", ret);
 		device->pwrscale.enabled = false;
+		msm_adreno_predict_exit();
 		msm_adreno_tz_exit();
 		return ret;
 	}
@@ -774,6 +787,7 @@ int kgsl_pwrscale_init(struct kgsl_device *device, struct platform_device *pdev,
 			governor, &adreno_tz_data);
 	if (IS_ERR_OR_NULL(devfreq)) {
 		device->pwrscale.enabled = false;
+		msm_adreno_predict_exit();
 		msm_adreno_tz_exit();
 		return IS_ERR(devfreq) ? PTR_ERR(devfreq) : -EINVAL;
 	}
@@ -836,9 +850,106 @@ void kgsl_pwrscale_close(struct kgsl_device *device)
 	devfreq_remove_device(device->pwrscale.devfreqptr);
 	device->pwrscale.devfreqptr = NULL;
 	dev_pm_qos_remove_notifier(&device->pdev->dev, &pwr->nb_max, DEV_PM_QOS_MAX_FREQUENCY);
+	msm_adreno_predict_exit();
 	msm_adreno_tz_exit();
 }
 
+/* Frames further apart than this don't belong to the same sequence */
+#define KGSL_FRAME_MAX_PERIOD_US USEC_PER_SEC
+
+static u64 _frame_history_predict(struct kgsl_frame_history *hist,
+		u32 *period)
+{
+	u64 cycles = 0, max = 0, total = 0;
+	int i;
+
+	for (i = 0; i < hist->count; i++) {
+		cycles += hist->cycles[i];
+		total += hist->period[i];
+		max = max_t(u64, max, hist->cycles[i]);
+	}
+
+	*period = div_u64(total, hist->count);
+
+	/*
+	 * Lean towards the heavier frames, missing a deadline costs more than
+	 * running a level too high for a frame
+	 */
+	return (div_u64(cycles, hist->count) + max) >> 1;
+}
+
+void kgsl_pwrscale_frame_end(struct kgsl_device *device,
+		struct kgsl_frame_history *hist)
+{
+	struct devfreq_msm_adreno_tz_data *priv = &adreno_tz_data;
+	struct kgsl_pwrscale *pwrscale = &device->pwrscale;
+	u64 now = local_clock(), cycles, predicted, busy_us, period_us;
+	unsigned long freq, old;
+	u32 period;
+
+	if (!READ_ONCE(priv->predict.enabled))
+		return;
+
+	period_us = div_u64(now - hist->frame_start, NSEC_PER_USEC);
+
+	/* Start over if this is the first frame or the context went idle */
+	if (!hist->frame_start || period_us > KGSL_FRAME_MAX_PERIOD_US) {
+		hist->frame_start = now;
+		hist->active = 0;
+		hist->predicted = 0;
+		hist->count = 0;
+		hist->index = 0;
+		return;
+	}
+
+	/* The always on counter runs at 19.2 MHz */
+	busy_us = div_u64(hist->active * 10, 192);
+	cycles = div_u64(busy_us * kgsl_pwrctrl_active_freq(&device->pwrctrl),
+		USEC_PER_SEC);
+
+	if (hist->predicted && cycles) {
+		u64 diff = cycles > hist->predicted ? cycles - hist->predicted :
+			hist->predicted - cycles;
+		u32 err = min_t(u64, div64_u64(diff * 100, cycles), 1000);
+
+		WRITE_ONCE(priv->predict.error, (priv->predict.error * 7 + err) >> 3);
+	}
+
+	hist->cycles[hist->index] = cycles;
+	hist->period[hist->index] = period_us;
+	hist->index = (hist->index + 1) % KGSL_FRAME_HISTORY;
+	hist->count = min_t(u32, hist->count + 1, KGSL_FRAME_HISTORY);
+	hist->frame_start = now;
+	hist->active = 0;
+
+	predicted = _frame_history_predict(hist, &period);
+	hist->predicted = predicted;
+
+	if (!period)
+		return;
+
+	/* Frequency that fits the predicted cycles in the period at the target load */
+	freq = div64_u64(predicted * USEC_PER_SEC * 100,
+		(u64) period * READ_ONCE(priv->predict.target_load));
+
+	/*
+	 * The busiest context decides. A lighter one can only take over once
+	 * the prediction of the busiest one went stale.
+	 */
+	old = READ_ONCE(priv->predict.freq);
+	if (freq < old && priv->predict.owner != hist &&
+		now < READ_ONCE(priv->predict.expires))
+		return;
+
+	priv->predict.owner = hist;
+	WRITE_ONCE(priv->predict.freq, freq);
+	WRITE_ONCE(priv->predict.expires, now + (2ULL * period * NSEC_PER_USEC));
+
+	/* Move the clock now instead of waiting for the next devfreq poll */
+	if (freq != old && pwrscale->devfreq_wq)
+		queue_work(pwrscale->devfreq_wq, &pwrscale->devfreq_notify_ws);
+}
+
 static void do_devfreq_suspend(struct work_struct *work)
 {
 	struct kgsl_pwrscale *pwrscale = container_of(work,
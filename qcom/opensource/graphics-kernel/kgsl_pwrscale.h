@@ -20,6 +20,29 @@ struct kgsl_power_stats {
 	u64 ram_wait;
 };
 
+/* Number of frames of history kept for each context */
+#define KGSL_FRAME_HISTORY 8
+
+/**
+ * struct kgsl_frame_history - Frame aligned GPU busy history of a context
+ * @active: GPU busy always on counter ticks of the frame in progress
+ * @frame_start: local_clock() time at which the frame in progress started
+ * @predicted: GPU cycles predicted for the frame in progress
+ * @cycles: GPU cycles used by each of the last frames
+ * @period: Length in microseconds of each of the last frames
+ * @index: Slot in @cycles and @period for the next frame
+ * @count: Number of valid frames in the history
+ */
+struct kgsl_frame_history {
+	u64 active;
+	u64 frame_start;
+	u64 predicted;
+	u64 cycles[KGSL_FRAME_HISTORY];
+	u32 period[KGSL_FRAME_HISTORY];
+	u32 index;
+	u32 count;
+};
+
 /**
  * struct kgsl_pwrscale - Power scaling settings for a KGSL device
  * @devfreqptr - Pointer to the devfreq device
@@ -92,6 +115,28 @@ void kgsl_pwrscale_wake(struct kgsl_device *device);
 void kgsl_pwrscale_enable(struct kgsl_device *device);
 void kgsl_pwrscale_disable(struct kgsl_device *device, bool turbo);
 
+/**
+ * kgsl_pwrscale_frame_busy - Account GPU busy time to a context frame
+ * @hist: Frame history of the context
+ * @ticks: Always on counter ticks the GPU spent on a retired command
+ */
+static inline void kgsl_pwrscale_frame_busy(struct kgsl_frame_history *hist,
+		u64 ticks)
+{
+	hist->active += ticks;
+}
+
+/**
+ * kgsl_pwrscale_frame_end - Close the current frame of a context
+ * @device: A GPU device handle
+ * @hist: Frame history of the context
+ *
+ * Record the frame in the history of the context and publish the frequency
+ * predicted for its next frame to the predictive governor.
+ */
+void kgsl_pwrscale_frame_end(struct kgsl_device *device,
+		struct kgsl_frame_history *hist);
+
 int kgsl_devfreq_target(struct device *dev, unsigned long *freq, u32 flags);
 int kgsl_devfreq_get_dev_status(struct device *dev,
 			struct devfreq_dev_status *stat);
@@ -108,6 +153,10 @@ int msm_adreno_tz_reinit(struct devfreq *devfreq);
 
 void msm_adreno_tz_exit(void);
 
+int msm_adreno_predict_init(void);
+
+void msm_adreno_predict_exit(void);
+
 int devfreq_gpubw_init(void);
 
 void devfreq_gpubw_exit(void);
@@ -4,10 +4,13 @@
  * Copyright (c) 2022-2023, Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/debugfs.h>
 #include <linux/kthread.h>
+#include <linux/list_sort.h>
 #include <linux/notifier.h>
 #include <linux/shmem_fs.h>
 
+#include "kgsl_debugfs.h"
 #include "kgsl_reclaim.h"
 #include "kgsl_sharedmem.h"
 #include "kgsl_trace.h"
@@ -28,16 +31,64 @@ struct work_struct reclaim_work;
 
 static atomic_t kgsl_nr_to_reclaim;
 
+/* Entries that no submission referenced for this long are considered cold */
+static u32 kgsl_reclaim_cold_ms = 5000;
+
+/*
+ * Histogram of reclaimed and refaulted pages by how long the entry had been
+ * idle when it was reclaimed. Bucket 0 is for entries idle for less than a
+ * second and bucket n covers [2^(n-1), 2^n) seconds. The last bucket also
+ * holds everything older.
+ */
+#define KGSL_RECLAIM_HIST_BUCKETS 8
+
+static atomic_long_t kgsl_reclaim_hist_reclaimed[KGSL_RECLAIM_HIST_BUCKETS];
+static atomic_long_t kgsl_reclaim_hist_refaulted[KGSL_RECLAIM_HIST_BUCKETS];
+
+static u32 kgsl_reclaim_hist_bucket(struct kgsl_mem_entry *entry)
+{
+	unsigned long idle = jiffies - READ_ONCE(entry->last_used);
+	u32 secs = jiffies_to_msecs(idle) / MSEC_PER_SEC;
+
+	if (!secs)
+		return 0;
+
+	return min_t(u32, ilog2(secs) + 1, KGSL_RECLAIM_HIST_BUCKETS - 1);
+}
+
+static bool kgsl_reclaim_entry_is_cold(struct kgsl_mem_entry *entry)
+{
+	return time_after(jiffies, READ_ONCE(entry->last_used) +
+		msecs_to_jiffies(kgsl_reclaim_cold_ms));
+}
+
+void kgsl_reclaim_touch_memobj(struct kgsl_process_private *process,
+		u64 gpuaddr, u32 id)
+{
+	struct kgsl_mem_entry *entry;
+
+	entry = id ? kgsl_sharedmem_find_id(process, id) :
+		kgsl_sharedmem_find(process, gpuaddr);
+
+	if (entry) {
+		kgsl_reclaim_touch_entry(entry);
+		kgsl_mem_entry_put(entry);
+	}
+}
+
 static int kgsl_memdesc_get_reclaimed_pages(struct kgsl_mem_entry *entry)
 {
 	struct kgsl_memdesc *memdesc = &entry->memdesc;
 	int i, ret;
 	struct page *page;
+	long refaulted = 0;
 
 	for (i = 0; i < memdesc->page_count; i++) {
 		if (memdesc->pages[i])
 			continue;
 
+		refaulted++;
+
 		page = shmem_read_mapping_page_gfp(
 			memdesc->shmem_filp->f_mapping, i, kgsl_gfp_mask(0));
 
@@ -59,11 +110,15 @@ static int kgsl_memdesc_get_reclaimed_pages(struct kgsl_mem_entry *entry)
 		spin_unlock(&memdesc->lock);
 	}
 
+	atomic_long_add(refaulted,
+		&kgsl_reclaim_hist_refaulted[entry->reclaim_bucket]);
+
 	ret = kgsl_mmu_map(memdesc->pagetable, memdesc);
 	if (ret)
 		return ret;
 
 	trace_kgsl_reclaim_memdesc(entry, false);
+	kgsl_reclaim_touch_entry(entry);
 
 	memdesc->priv &= ~KGSL_MEMDESC_RECLAIMED;
 	memdesc->priv &= ~KGSL_MEMDESC_SKIP_RECLAIM;
@@ -208,8 +263,13 @@ ssize_t kgsl_nr_to_scan_show(struct device *dev,
 	return scnprintf(buf, PAGE_SIZE, "%d\n", kgsl_nr_to_scan);
 }
 
+/*
+ * Reclaim up to pages_to_reclaim pages from the process. If cold_only is set
+ * only entries which haven't been referenced by a submission recently are
+ * considered.
+ */
 static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
-		u32 pages_to_reclaim)
+		u32 pages_to_reclaim, bool cold_only)
 {
 	struct kgsl_memdesc *memdesc;
 	struct kgsl_mem_entry *entry, *valid_entry;
@@ -249,7 +309,8 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 		if (!entry->pending_free &&
 				(memdesc->priv & KGSL_MEMDESC_CAN_RECLAIM) &&
 				!(memdesc->priv & KGSL_MEMDESC_RECLAIMED) &&
-				!(memdesc->priv & KGSL_MEMDESC_SKIP_RECLAIM))
+				!(memdesc->priv & KGSL_MEMDESC_SKIP_RECLAIM) &&
+				(!cold_only || kgsl_reclaim_entry_is_cold(entry)))
 			valid_entry = kgsl_mem_entry_get(entry);
 		spin_unlock(&process->mem_lock);
 
@@ -274,6 +335,10 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 		if (!kgsl_mmu_unmap(memdesc->pagetable, memdesc)) {
 			int i;
 
+			entry->reclaim_bucket = kgsl_reclaim_hist_bucket(entry);
+			atomic_long_add(memdesc->page_count,
+				&kgsl_reclaim_hist_reclaimed[entry->reclaim_bucket]);
+
 			for (i = 0; i < memdesc->page_count; i++) {
 				set_page_dirty_lock(memdesc->pages[i]);
 				spin_lock(&memdesc->lock);
@@ -302,6 +367,33 @@ static u32 kgsl_reclaim_process(struct kgsl_process_private *process,
 	return (pages_to_reclaim - remaining);
 }
 
+/* Resident (allocated and not yet reclaimed) pages of a process */
+static u64 kgsl_reclaim_resident_pages(struct kgsl_process_private *process)
+{
+	u64 size = atomic64_read(&process->stats[KGSL_MEM_ENTRY_KERNEL].cur);
+	u64 pages = size >> PAGE_SHIFT;
+	u32 unpinned = atomic_read(&process->unpinned_page_count);
+
+	return pages > unpinned ? pages - unpinned : 0;
+}
+
+/* Sort the processes so that the biggest ones get reclaimed from first */
+static int kgsl_reclaim_process_cmp(void *priv, const struct list_head *a,
+		const struct list_head *b)
+{
+	struct kgsl_process_private *pa =
+		list_entry(a, struct kgsl_process_private, reclaim_list);
+	struct kgsl_process_private *pb =
+		list_entry(b, struct kgsl_process_private, reclaim_list);
+	u64 sa = kgsl_reclaim_resident_pages(pa);
+	u64 sb = kgsl_reclaim_resident_pages(pb);
+
+	if (sa == sb)
+		return 0;
+
+	return sa > sb ? -1 : 1;
+}
+
 static void kgsl_reclaim_background_work(struct work_struct *work)
 {
 	u32 bg_proc = 0, nr_pages = atomic_read(&kgsl_nr_to_reclaim);
@@ -321,13 +413,24 @@ static void kgsl_reclaim_background_work(struct work_struct *work)
 	}
 	read_unlock(&kgsl_driver.proclist_lock);
 
+	list_sort(NULL, &kgsl_reclaim_process_list, kgsl_reclaim_process_cmp);
+
+	/* Take the cold entries of the biggest background processes first */
+	list_for_each_entry(process, &kgsl_reclaim_process_list, reclaim_list) {
+		if (!nr_pages)
+			break;
+
+		nr_pages -= kgsl_reclaim_process(process, nr_pages, true);
+	}
+
+	/* Spread whatever is left over all background processes */
 	list_for_each_entry(process, &kgsl_reclaim_process_list, reclaim_list) {
 		if (!nr_pages)
 			break;
 
 		pp_nr_pages = nr_pages;
 		do_div(pp_nr_pages, bg_proc--);
-		nr_pages -= kgsl_reclaim_process(process, pp_nr_pages);
+		nr_pages -= kgsl_reclaim_process(process, pp_nr_pages, false);
 	}
 
 	list_for_each_entry_safe(process, next,
@@ -390,6 +493,46 @@ void kgsl_reclaim_proc_private_init(struct kgsl_process_private *process)
 	atomic_set(&process->unpinned_page_count, 0);
 }
 
+static int kgsl_reclaim_histogram_show(struct seq_file *s, void *unused)
+{
+	int i;
+
+	seq_printf(s, "%10s %16s %16s\n", "idle_secs", "reclaimed_pages",
+		"refaulted_pages");
+
+	for (i = 0; i < KGSL_RECLAIM_HIST_BUCKETS; i++) {
+		u32 lo = i ? (1 << (i - 1)) : 0;
+		char range[16];
+
+		if (i == KGSL_RECLAIM_HIST_BUCKETS - 1)
+			scnprintf(range, sizeof(range), "%u+", lo);
+		else
+			scnprintf(range, sizeof(range), "%u-%u", lo,
+				(1 << i) - 1);
+
+		seq_printf(s, "%10s %16ld %16ld\n", range,
+			atomic_long_read(&kgsl_reclaim_hist_reclaimed[i]),
+			atomic_long_read(&kgsl_reclaim_hist_refaulted[i]));
+	}
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(kgsl_reclaim_histogram);
+
+static void kgsl_reclaim_debugfs_init(void)
+{
+	struct dentry *root = kgsl_get_debugfs_dir();
+
+	if (IS_ERR_OR_NULL(root))
+		return;
+
+	debugfs_create_file("reclaim_histogram", 0444, root, NULL,
+		&kgsl_reclaim_histogram_fops);
+	debugfs_create_u32("reclaim_cold_ms", 0644, root,
+		&kgsl_reclaim_cold_ms);
+}
+
 int kgsl_reclaim_init(void)
 {
 	int ret;
@@ -401,6 +544,8 @@ int kgsl_reclaim_init(void)
 	else
 		INIT_WORK(&reclaim_work, kgsl_reclaim_background_work);
 
+	kgsl_reclaim_debugfs_init();
+
 	return ret;
 }
 
@@ -20,6 +20,21 @@ void kgsl_reclaim_close(void);
 int kgsl_reclaim_to_pinned_state(struct kgsl_process_private *priv);
 void kgsl_reclaim_proc_sysfs_init(struct kgsl_process_private *process);
 void kgsl_reclaim_proc_private_init(struct kgsl_process_private *process);
+void kgsl_reclaim_touch_memobj(struct kgsl_process_private *process,
+		u64 gpuaddr, u32 id);
+
+/**
+ * kgsl_reclaim_touch_entry - Mark a memory entry as recently used
+ * @entry: Memory entry referenced by a submission
+ *
+ * Reclaim prefers entries that have not been touched for a while.
+ */
+static inline void kgsl_reclaim_touch_entry(struct kgsl_mem_entry *entry)
+{
+	if (entry)
+		WRITE_ONCE(entry->last_used, jiffies);
+}
+
 ssize_t kgsl_proc_max_reclaim_limit_store(struct device *dev,
 		struct device_attribute *attr, const char *buf, size_t count);
 ssize_t kgsl_proc_max_reclaim_limit_show(struct device *dev,
@@ -48,5 +63,10 @@ static inline void kgsl_reclaim_proc_sysfs_init
 static inline void kgsl_reclaim_proc_private_init
 		(struct kgsl_process_private *process) { }
 
+static inline void kgsl_reclaim_touch_memobj(
+		struct kgsl_process_private *process, u64 gpuaddr, u32 id) { }
+
+static inline void kgsl_reclaim_touch_entry(struct kgsl_mem_entry *entry) { }
+
 #endif
 #endif /* __KGSL_RECLAIM_H */
@@ -184,6 +184,20 @@ void kgsl_regmap_multi_write(struct kgsl_regmap *regmap,
 	}
 }
 
+int kgsl_regmap_batch_write(struct kgsl_regmap_batch *batch, u32 value,
+		u32 offset)
+{
+	if (WARN(batch->count >= batch->size,
+		"Register batch is full, dropping offset: 0x%x\n", offset))
+		return -ENOSPC;
+
+	batch->list[batch->count].offset = offset;
+	batch->list[batch->count].val = value;
+	batch->count++;
+
+	return 0;
+}
+
 void kgsl_regmap_rmw(struct kgsl_regmap *regmap, u32 offset, u32 mask,
 		u32 or)
 {
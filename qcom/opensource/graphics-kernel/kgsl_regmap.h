@@ -64,6 +64,23 @@ struct kgsl_regmap_list {
 	u32 val;
 };
 
+/**
+ * struct kgsl_regmap_batch - A recorded list of register writes
+ *
+ * A batch records register writes into caller provided storage so they can
+ * be issued later with a single barrier in front of the whole list instead of
+ * one barrier for every write. A batch that only holds static values can be
+ * built once and replayed every time the hardware is powered up.
+ */
+struct kgsl_regmap_batch {
+	/** @list: Storage for the recorded writes */
+	struct kgsl_regmap_list *list;
+	/** @count: Number of writes recorded in @list */
+	u32 count;
+	/** @size: Number of entries that fit in @list */
+	u32 size;
+};
+
 /**
  * kgsl_regmap_init - Initialize a regmap
  * @pdev: Pointer to the platform device that owns @name
@@ -147,6 +164,50 @@ void kgsl_regmap_write(struct kgsl_regmap *regmap, u32 value, u32 offset);
 void kgsl_regmap_multi_write(struct kgsl_regmap *regmap,
 	const struct kgsl_regmap_list *list, int count);
 
+/**
+ * kgsl_regmap_batch_init - Initialize a register write batch
+ * @batch: The batch to initialize
+ * @list: Storage for the recorded writes
+ * @size: Number of entries that fit in @list
+ */
+static inline void kgsl_regmap_batch_init(struct kgsl_regmap_batch *batch,
+		struct kgsl_regmap_list *list, u32 size)
+{
+	batch->list = list;
+	batch->count = 0;
+	batch->size = size;
+}
+
+/**
+ * kgsl_regmap_batch_write - Record a register write in a batch
+ * @batch: The batch to record the write in
+ * @value: The value to write to @offset
+ * @offset: The dword offset to write
+ *
+ * Record the write without touching the hardware. Nothing is written until
+ * the batch is replayed with kgsl_regmap_batch_replay().
+ *
+ * Return: 0 on success or -ENOSPC if the batch is full.
+ */
+int kgsl_regmap_batch_write(struct kgsl_regmap_batch *batch, u32 value,
+		u32 offset);
+
+/**
+ * kgsl_regmap_batch_replay - Write all the registers recorded in a batch
+ * @regmap: The regmap to write to
+ * @batch: The batch to replay
+ *
+ * Write the recorded registers in order with a single barrier in front of the
+ * list. The batch is left intact so it can be replayed again. Callers that
+ * need the writes to land before a later access must provide the ordering
+ * themselves, the same as with kgsl_regmap_multi_write().
+ */
+static inline void kgsl_regmap_batch_replay(struct kgsl_regmap *regmap,
+		const struct kgsl_regmap_batch *batch)
+{
+	kgsl_regmap_multi_write(regmap, batch->list, batch->count);
+}
+
 /**
  * kgsl_regmap_rmw - read-modify-write a register in the regmap
  * @regmap: The regmap to write to
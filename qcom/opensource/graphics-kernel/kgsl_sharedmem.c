@@ -451,6 +451,14 @@ static ssize_t memstat_show(struct device *dev,
 		val = atomic_long_read(&kgsl_driver.stats.mapped);
 	else if (!strcmp(attr->attr.name, "mapped_max"))
 		val = atomic_long_read(&kgsl_driver.stats.mapped_max);
+	else if (!strcmp(attr->attr.name, "deferred_free_pending"))
+		val = atomic_long_read(&kgsl_driver.stats.deferred_free_pending);
+	else if (!strcmp(attr->attr.name, "deferred_free_entries"))
+		val = atomic_long_read(&kgsl_driver.stats.deferred_free_entries);
+	else if (!strcmp(attr->attr.name, "deferred_free_batches"))
+		val = atomic_long_read(&kgsl_driver.stats.deferred_free_batches);
+	else if (!strcmp(attr->attr.name, "deferred_free_overflow"))
+		val = atomic_long_read(&kgsl_driver.stats.deferred_free_overflow);
 
 	return scnprintf(buf, PAGE_SIZE, "%llu\n", val);
 }
@@ -488,6 +496,10 @@ static DEVICE_ATTR(secure, 0444, memstat_show, NULL);
 static DEVICE_ATTR(secure_max, 0444, memstat_show, NULL);
 static DEVICE_ATTR(mapped, 0444, memstat_show, NULL);
 static DEVICE_ATTR(mapped_max, 0444, memstat_show, NULL);
+static DEVICE_ATTR(deferred_free_pending, 0444, memstat_show, NULL);
+static DEVICE_ATTR(deferred_free_entries, 0444, memstat_show, NULL);
+static DEVICE_ATTR(deferred_free_batches, 0444, memstat_show, NULL);
+static DEVICE_ATTR(deferred_free_overflow, 0444, memstat_show, NULL);
 static DEVICE_ATTR_RW(full_cache_threshold);
 
 static const struct attribute *drv_attr_list[] = {
@@ -501,6 +513,10 @@ static const struct attribute *drv_attr_list[] = {
 	&dev_attr_secure_max.attr,
 	&dev_attr_mapped.attr,
 	&dev_attr_mapped_max.attr,
+	&dev_attr_deferred_free_pending.attr,
+	&dev_attr_deferred_free_entries.attr,
+	&dev_attr_deferred_free_batches.attr,
+	&dev_attr_deferred_free_overflow.attr,
 	&dev_attr_full_cache_threshold.attr,
 #ifdef CONFIG_QCOM_KGSL_PROCESS_RECLAIM
 	&dev_attr_max_reclaim_limit.attr,
@@ -1145,8 +1161,8 @@ static int _kgsl_alloc_pages(struct kgsl_memdesc *memdesc,
 		return count;
 	}
 
-	/* Start with 1MB alignment to get the biggest page we can */
-	align = ilog2(SZ_1M);
+	/* Start with 2MB alignment to get the biggest page we can */
+	align = ilog2(SZ_2M);
 
 	page_size = kgsl_get_page_size(len, align);
 
@@ -1246,9 +1262,11 @@ void kgsl_unmap_and_put_gpuaddr(struct kgsl_memdesc *memdesc)
 	/*
 	 * Don't release the GPU address if the memory fails to unmap because
 	 * the IOMMU driver will BUG later if we reallocated the address and
-	 * tried to map it
+	 * tried to map it. The mapping may already be gone if the memdesc was
+	 * unmapped as part of a deferred free batch.
 	 */
 	if (!kgsl_memdesc_is_reclaimed(memdesc) &&
+		(memdesc->priv & KGSL_MEMDESC_MAPPED) &&
 		kgsl_mmu_unmap(memdesc->pagetable, memdesc))
 		return;
 
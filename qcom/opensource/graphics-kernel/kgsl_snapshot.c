@@ -4,10 +4,12 @@
  * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/devcoredump.h>
 #include <linux/of.h>
 #include <linux/panic_notifier.h>
 #include <linux/slab.h>
 #include <linux/utsname.h>
+#include <linux/vmalloc.h>
 
 #include "adreno_cp_parser.h"
 #include "kgsl_device.h"
@@ -453,6 +455,9 @@ static void kgsl_free_snapshot(struct kgsl_snapshot *snapshot)
 	if (snapshot->mempool)
 		vfree(snapshot->mempool);
 
+	if (snapshot->devcoredump)
+		vfree(snapshot->start);
+
 	kfree(snapshot);
 	dev_err(device->dev, "snapshot: objects released\n");
 }
@@ -497,7 +502,7 @@ static void kgsl_device_snapshot_atomic(struct kgsl_device *device)
 	}
 
 	device->snapshot_memory_atomic.size = device->snapshot_memory.size;
-	if (!device->snapshot_faultcount) {
+	if (!device->snapshot_faultcount && device->snapshot_memory.ptr) {
 		/* Use non-atomic snapshot memory if it is unused */
 		device->snapshot_memory_atomic.ptr = device->snapshot_memory.ptr;
 	} else {
@@ -578,7 +583,8 @@ void kgsl_device_snapshot(struct kgsl_device *device,
 	if (device->ftbl->set_isdb_breakpoint_registers)
 		device->ftbl->set_isdb_breakpoint_registers(device);
 
-	if (device->snapshot_memory.ptr == NULL) {
+	if (device->snapshot_memory.ptr == NULL &&
+		!device->snapshot_devcoredump) {
 		dev_err(device->dev,
 			     "snapshot: no snapshot memory available\n");
 		return;
@@ -592,7 +598,12 @@ void kgsl_device_snapshot(struct kgsl_device *device,
 	device->snapshot_faultcount++;
 	device->gmu_fault = gmu_fault;
 
-	if (device->snapshot != NULL) {
+	/*
+	 * Devcoredump snapshots don't use the resident buffer so they never
+	 * replace the one held in device->snapshot. Devcoredump keeps the
+	 * first dump until it is read and drops the later ones for us.
+	 */
+	if (device->snapshot != NULL && !device->snapshot_devcoredump) {
 
 		/*
 		 * Snapshot over-write policy:
@@ -627,12 +638,30 @@ void kgsl_device_snapshot(struct kgsl_device *device,
 	INIT_LIST_HEAD(&snapshot->cp_list);
 	INIT_WORK(&snapshot->work, kgsl_snapshot_save_frozen_objs);
 
-	snapshot->start = device->snapshot_memory.ptr;
-	snapshot->ptr = device->snapshot_memory.ptr;
+	if (device->snapshot_devcoredump) {
+		/*
+		 * Only keep snapshot memory around while there is a snapshot
+		 * to read. It is released once userspace has read the dump
+		 * or devcoredump times it out.
+		 */
+		snapshot->start = vzalloc(device->snapshot_memory.size);
+		if (!snapshot->start) {
+			dev_err(device->dev,
+				"snapshot: failed to allocate snapshot memory\n");
+			kfree(snapshot);
+			return;
+		}
+		snapshot->devcoredump = true;
+	} else {
+		snapshot->start = device->snapshot_memory.ptr;
+	}
+
+	snapshot->ptr = snapshot->start;
 	snapshot->remain = device->snapshot_memory.size;
 	snapshot->recovered = false;
 	snapshot->first_read = true;
 	snapshot->sysfs_read = 0;
+	snapshot->device = device;
 
 	device->ftbl->snapshot(device, snapshot, context, context_lpac);
 
@@ -644,17 +673,22 @@ void kgsl_device_snapshot(struct kgsl_device *device,
 	getboottime64(&boot);
 	snapshot->timestamp = ktime_get_real_seconds() - boot.tv_sec;
 
-	/* Store the instance in the device until it gets dumped */
-	device->snapshot = snapshot;
-	snapshot->device = device;
+	if (snapshot->devcoredump) {
+		dev_err(device->dev, "%s snapshot created for devcoredump 0x%zx\n",
+			gmu_fault ? "GMU" : "GPU", snapshot->size);
+	} else {
+		/* Store the instance in the device until it gets dumped */
+		device->snapshot = snapshot;
 
-	/* log buffer info to aid in ramdump fault tolerance */
-	dev_err(device->dev, "%s snapshot created at pa %llx++0x%zx\n",
+		/* log buffer info to aid in ramdump fault tolerance */
+		dev_err(device->dev, "%s snapshot created at pa %llx++0x%zx\n",
 			gmu_fault ? "GMU" : "GPU", snapshot_phy_addr(device),
 			snapshot->size);
 
-	kgsl_add_to_minidump("GPU_SNAPSHOT", (u64) device->snapshot_memory.ptr,
+		kgsl_add_to_minidump("GPU_SNAPSHOT",
+			(u64) device->snapshot_memory.ptr,
 			snapshot_phy_addr(device), device->snapshot_memory.size);
+	}
 
 	if (device->skip_ib_capture)
 		BUG_ON(device->force_panic);
@@ -940,6 +974,28 @@ static ssize_t snapshot_legacy_store(struct kgsl_device *device,
 	return count;
 }
 
+static ssize_t snapshot_devcoredump_show(struct kgsl_device *device,
+	char *buf)
+{
+	return scnprintf(buf, PAGE_SIZE, "%d\n", device->snapshot_devcoredump);
+}
+
+static ssize_t snapshot_devcoredump_store(struct kgsl_device *device,
+	const char *buf, size_t count)
+{
+	bool val;
+
+	if (strtobool(buf, &val))
+		return -EINVAL;
+
+	/* The resident buffer isn't allocated when booting in devcoredump mode */
+	if (!val && !device->snapshot_memory.ptr)
+		return -EINVAL;
+
+	device->snapshot_devcoredump = val;
+	return count;
+}
+
 static struct bin_attribute snapshot_attr = {
 	.attr.name = "dump",
 	.attr.mode = 0444,
@@ -965,6 +1021,8 @@ static SNAPSHOT_ATTR(snapshot_legacy, 0644, snapshot_legacy_show,
 	snapshot_legacy_store);
 static SNAPSHOT_ATTR(skip_ib_capture, 0644, skip_ib_capture_show,
 		skip_ib_capture_store);
+static SNAPSHOT_ATTR(snapshot_devcoredump, 0644, snapshot_devcoredump_show,
+	snapshot_devcoredump_store);
 
 static ssize_t snapshot_sysfs_show(struct kobject *kobj,
 	struct attribute *attr, char *buf)
@@ -1011,6 +1069,7 @@ static const struct attribute *snapshot_attrs[] = {
 	&attr_snapshot_crashdumper.attr,
 	&attr_snapshot_legacy.attr,
 	&attr_skip_ib_capture.attr,
+	&attr_snapshot_devcoredump.attr,
 	NULL,
 };
 
@@ -1031,20 +1090,30 @@ void kgsl_device_snapshot_probe(struct kgsl_device *device, u32 size)
 {
 	device->snapshot_memory.size = size;
 
-	device->snapshot_memory.ptr = dma_alloc_coherent(&device->pdev->dev,
-		device->snapshot_memory.size, &device->snapshot_memory.dma_handle,
-		GFP_KERNEL);
 	/*
-	 * If we fail to allocate more than 1MB for snapshot fall back
-	 * to 1MB
+	 * In devcoredump mode the snapshot memory is allocated when a fault
+	 * happens and handed off to devcoredump, so don't reserve it here.
 	 */
-	if (WARN_ON((!device->snapshot_memory.ptr) && size > SZ_1M)) {
-		device->snapshot_memory.size = SZ_1M;
-		device->snapshot_memory.ptr = devm_kzalloc(&device->pdev->dev,
-			device->snapshot_memory.size, GFP_KERNEL);
+	device->snapshot_devcoredump = of_property_read_bool(
+		device->pdev->dev.of_node, "qcom,gpu-snapshot-devcoredump");
+
+	if (!device->snapshot_devcoredump) {
+		device->snapshot_memory.ptr = dma_alloc_coherent(
+			&device->pdev->dev, device->snapshot_memory.size,
+			&device->snapshot_memory.dma_handle, GFP_KERNEL);
+		/*
+		 * If we fail to allocate more than 1MB for snapshot fall back
+		 * to 1MB
+		 */
+		if (WARN_ON((!device->snapshot_memory.ptr) && size > SZ_1M)) {
+			device->snapshot_memory.size = SZ_1M;
+			device->snapshot_memory.ptr = devm_kzalloc(
+				&device->pdev->dev,
+				device->snapshot_memory.size, GFP_KERNEL);
+		}
 	}
 
-	if (!device->snapshot_memory.ptr) {
+	if (!device->snapshot_memory.ptr && !device->snapshot_devcoredump) {
 		dev_err(device->dev,
 			"KGSL failed to allocate memory for snapshot\n");
 		return;
@@ -1087,10 +1156,13 @@ void kgsl_device_snapshot_probe(struct kgsl_device *device, u32 size)
  */
 void kgsl_device_snapshot_close(struct kgsl_device *device)
 {
-	if (device->snapshot_memory.ptr == NULL)
+	if (device->snapshot_memory.ptr == NULL &&
+		!device->snapshot_devcoredump)
 		return;
 
-	kgsl_remove_from_minidump("GPU_SNAPSHOT", (u64) device->snapshot_memory.ptr,
+	if (device->snapshot_memory.ptr)
+		kgsl_remove_from_minidump("GPU_SNAPSHOT",
+			(u64) device->snapshot_memory.ptr,
 			snapshot_phy_addr(device), device->snapshot_memory.size);
 
 	sysfs_remove_bin_file(&device->snapshot_kobj, &snapshot_attr);
@@ -1169,6 +1241,53 @@ static size_t _mempool_add_object(struct kgsl_snapshot *snapshot, u8 *data,
 	return section->size;
 }
 
+/* Stream the snapshot sections to a devcoredump reader */
+static ssize_t kgsl_snapshot_devcd_read(char *buffer, loff_t offset,
+		size_t count, void *data, size_t datalen)
+{
+	struct kgsl_snapshot *snapshot = data;
+	struct kgsl_snapshot_section_header head;
+	struct snapshot_obj_itr itr;
+
+	obj_itr_init(&itr, buffer, offset, count);
+
+	if (!obj_itr_out(&itr, snapshot->start, snapshot->size))
+		goto done;
+
+	if (snapshot->mempool && !obj_itr_out(&itr, snapshot->mempool,
+			snapshot->mempool_size))
+		goto done;
+
+	head.magic = SNAPSHOT_SECTION_MAGIC;
+	head.id = KGSL_SNAPSHOT_SECTION_END;
+	head.size = sizeof(head);
+
+	obj_itr_out(&itr, &head, sizeof(head));
+done:
+	return itr.write;
+}
+
+static void kgsl_snapshot_devcd_free(void *data)
+{
+	kgsl_free_snapshot(data);
+}
+
+/**
+ * kgsl_snapshot_devcoredump() - Hand a finished snapshot to devcoredump
+ * @snapshot: The snapshot instance to hand over
+ *
+ * Devcoredump owns the snapshot from here on and frees it once userspace has
+ * read the dump or the dump times out.
+ */
+static void kgsl_snapshot_devcoredump(struct kgsl_snapshot *snapshot)
+{
+	size_t len = snapshot->size + snapshot->mempool_size +
+		sizeof(struct kgsl_snapshot_section_header);
+
+	dev_coredumpm(&snapshot->device->pdev->dev, THIS_MODULE, snapshot, len,
+		GFP_KERNEL, kgsl_snapshot_devcd_read, kgsl_snapshot_devcd_free);
+}
+
 /**
  * kgsl_snapshot_save_frozen_objs() - Save the objects frozen in snapshot into
  * memory so that the data reported in these objects is correct when snapshot
@@ -1236,4 +1355,7 @@ gmu_only:
 	BUG_ON(!snapshot->device->skip_ib_capture &&
 				snapshot->device->force_panic);
 	complete_all(&snapshot->dump_gate);
+
+	if (snapshot->devcoredump)
+		kgsl_snapshot_devcoredump(snapshot);
 }
@@ -94,6 +94,21 @@ err:
 	return ERR_PTR(ret);
 }
 
+void kgsl_timeline_shadow_init(struct kgsl_device *device)
+{
+	device->timeline_shadow = alloc_page(GFP_KERNEL | __GFP_ZERO);
+	if (!device->timeline_shadow)
+		dev_warn(device->dev, "Unable to allocate the timeline shadow\n");
+}
+
+void kgsl_timeline_shadow_close(struct kgsl_device *device)
+{
+	if (device->timeline_shadow)
+		__free_page(device->timeline_shadow);
+
+	device->timeline_shadow = NULL;
+}
+
 void kgsl_timeline_destroy(struct kref *kref)
 {
 	struct kgsl_timeline *timeline = container_of(kref,
@@ -145,6 +160,13 @@ static struct kgsl_timeline *kgsl_timeline_alloc(struct kgsl_device_private *dev
 	timeline->value = initial;
 	timeline->dev_priv = dev_priv;
 
+	if (device->timeline_shadow && id < KGSL_TIMELINE_SHADOW_SLOTS) {
+		u64 *slots = page_address(device->timeline_shadow);
+
+		timeline->shadow = &slots[id];
+		WRITE_ONCE(*timeline->shadow, initial);
+	}
+
 	snprintf((char *) timeline->name, sizeof(timeline->name),
 		"kgsl-sw-timeline-%d", id);
 
@@ -271,6 +293,10 @@ void kgsl_timeline_signal(struct kgsl_timeline *timeline, u64 seqno)
 
 	timeline->value = seqno;
 
+	/* Publish the new value for userspace before signaling the fences */
+	if (timeline->shadow)
+		smp_store_release(timeline->shadow, seqno);
+
 	spin_lock(&timeline->fence_lock);
 	list_for_each_entry_safe(fence, tmp, &timeline->fences, node)
 		if (timeline_fence_signaled(&fence->base) &&
@@ -556,6 +582,8 @@ long kgsl_ioctl_timeline_destroy(struct kgsl_device_private *dev_priv,
 	spin_unlock(&timeline->fence_lock);
 
 	spin_lock_irq(&timeline->lock);
+	/* The id can be reused so stop updating the shadow slot */
+	timeline->shadow = NULL;
 	list_for_each_entry_safe(fence, tmp, &temp, node) {
 		dma_fence_set_error(&fence->base, -ENOENT);
 		dma_fence_signal_locked(&fence->base);
@@ -6,6 +6,9 @@
 #ifndef __KGSL_TIMELINE_H
 #define __KGSL_TIMELINE_H
 
+/* Number of timelines that can be shadowed in the timeline shadow page */
+#define KGSL_TIMELINE_SHADOW_SLOTS (PAGE_SIZE / sizeof(u64))
+
 /**
  * struct kgsl_timeline - Container for a timeline object
  */
@@ -28,6 +31,8 @@ struct kgsl_timeline {
 	const char name[32];
 	/** @dev_priv: pointer to the owning device instance */
 	struct kgsl_device_private *dev_priv;
+	/** @shadow: Slot for the timeline in the timeline shadow page or NULL */
+	u64 *shadow;
 };
 
 /**
@@ -94,6 +99,21 @@ static inline void kgsl_timeline_put(struct kgsl_timeline *timeline)
 		kref_put(&timeline->ref, kgsl_timeline_destroy);
 }
 
+/**
+ * kgsl_timeline_shadow_init - Allocate the timeline shadow page
+ * @device: A KGSL device handle
+ *
+ * Allocate the page that mirrors the timeline values for userspace. The
+ * shadow is optional so failing to allocate it is not fatal.
+ */
+void kgsl_timeline_shadow_init(struct kgsl_device *device);
+
+/**
+ * kgsl_timeline_shadow_close - Free the timeline shadow page
+ * @device: A KGSL device handle
+ */
+void kgsl_timeline_shadow_close(struct kgsl_device *device);
+
 /**
  * kgsl_timelines_to_fence_array - Return a dma-fence array of timeline fences
  * @device: A KGSL device handle
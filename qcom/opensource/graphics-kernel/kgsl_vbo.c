@@ -12,12 +12,15 @@
 
 #include "kgsl_device.h"
 #include "kgsl_mmu.h"
+#include "kgsl_reclaim.h"
 #include "kgsl_sharedmem.h"
 #include "kgsl_trace.h"
 
 struct kgsl_memdesc_bind_range {
 	struct kgsl_mem_entry *entry;
 	struct interval_tree_node range;
+	/* Node in the list of ranges released once the TLB is flushed */
+	struct list_head node;
 };
 
 static struct kgsl_memdesc_bind_range *bind_to_range(struct interval_tree_node *node)
@@ -51,6 +54,22 @@ static u64 bind_range_len(struct kgsl_memdesc_bind_range *range)
 	return (range->range.last - range->range.start) + 1;
 }
 
+/*
+ * Ranges that were unmapped during a bind operation keep their child entry
+ * until the TLB has been flushed so that stale translations never point at
+ * freed pages.
+ */
+static void bind_range_release(struct list_head *released)
+{
+	struct kgsl_memdesc_bind_range *range, *tmp;
+
+	list_for_each_entry_safe(range, tmp, released, node) {
+		list_del(&range->node);
+		kgsl_mem_entry_put(range->entry);
+		kfree(range);
+	}
+}
+
 void kgsl_memdesc_print_vbo_ranges(struct kgsl_mem_entry *entry,
 		struct seq_file *s)
 {
@@ -82,7 +101,8 @@ void kgsl_memdesc_print_vbo_ranges(struct kgsl_mem_entry *entry,
 }
 
 static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
-		u64 start, u64 last, struct kgsl_mem_entry *entry)
+		u64 start, u64 last, struct kgsl_mem_entry *entry,
+		struct list_head *released)
 {
 	struct  interval_tree_node *node, *next;
 	struct kgsl_memdesc_bind_range *range;
@@ -113,8 +133,7 @@ static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
 			kgsl_mmu_map_zero_page_to_range(memdesc->pagetable,
 				memdesc, range->range.start, bind_range_len(range));
 
-			kgsl_mem_entry_put(range->entry);
-			kfree(range);
+			list_add_tail(&range->node, released);
 		}
 	}
 
@@ -122,7 +141,8 @@ static void kgsl_memdesc_remove_range(struct kgsl_mem_entry *target,
 }
 
 static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
-		u64 start, u64 last, struct kgsl_mem_entry *entry, u64 offset)
+		u64 start, u64 last, struct kgsl_mem_entry *entry, u64 offset,
+		struct list_head *released)
 {
 	struct  interval_tree_node *node, *next;
 	struct kgsl_memdesc *memdesc = &target->memdesc;
@@ -161,8 +181,7 @@ static int kgsl_memdesc_add_range(struct kgsl_mem_entry *target,
 
 		if (start <= cur->range.start) {
 			if (last >= cur->range.last) {
-				kgsl_mem_entry_put(cur->entry);
-				kfree(cur);
+				list_add_tail(&cur->node, released);
 				continue;
 			}
 			/* Adjust the start of the mapping */
@@ -296,6 +315,41 @@ static bool kgsl_memdesc_check_range(struct kgsl_memdesc *memdesc,
 		(offset + length) <= memdesc->size);
 }
 
+/*
+ * Merge a range operation into the previous one if it continues it: same
+ * operation and child, adjacent in the target and, for binds, contiguous in
+ * the child. Applying the merged operation has the same result as applying
+ * both of them in order. Return the new number of operations.
+ */
+static int kgsl_sharedmem_coalesce_bind_op(struct kgsl_sharedmem_bind_op *op,
+		int n)
+{
+	struct kgsl_sharedmem_bind_op_range *cur = &op->ops[n];
+	struct kgsl_sharedmem_bind_op_range *prev;
+
+	if (!n)
+		return 1;
+
+	prev = &op->ops[n - 1];
+
+	if (prev->op != cur->op || prev->entry != cur->entry ||
+		prev->last + 1 != cur->start)
+		return n + 1;
+
+	if (cur->op == KGSL_GPUMEM_RANGE_OP_BIND &&
+		(u64) prev->child_offset + (prev->last - prev->start + 1) !=
+		cur->child_offset)
+		return n + 1;
+
+	prev->last = cur->last;
+
+	/* Drop the duplicate reference on the child */
+	kgsl_mem_entry_put(cur->entry);
+	memset(cur, 0, sizeof(*cur));
+
+	return n;
+}
+
 static void kgsl_sharedmem_free_bind_op(struct kgsl_sharedmem_bind_op *op)
 {
 	int i;
@@ -319,7 +373,7 @@ kgsl_sharedmem_create_bind_op(struct kgsl_process_private *private,
 {
 	struct kgsl_sharedmem_bind_op *op;
 	struct kgsl_mem_entry *target;
-	int ret, i;
+	int ret, i, n = 0;
 
 	/* There must be at least one defined operation */
 	if (!ranges_nents)
@@ -390,26 +444,29 @@ kgsl_sharedmem_create_bind_op(struct kgsl_process_private *private,
 		 * child buffers) without supplying backing physical buffer information.
 		 */
 		if (range.child_id == 0 && range.op == KGSL_GPUMEM_RANGE_OP_UNBIND) {
-			op->ops[i].entry = NULL;
-			op->ops[i].start = range.target_offset;
-			op->ops[i].last = range.target_offset + range.length - 1;
+			op->ops[n].entry = NULL;
+			op->ops[n].start = range.target_offset;
+			op->ops[n].last = range.target_offset + range.length - 1;
 			/* Child offset doesn't matter for unbind. set it to 0 */
-			op->ops[i].child_offset = 0;
-			op->ops[i].op = range.op;
+			op->ops[n].child_offset = 0;
+			op->ops[n].op = range.op;
 
 			ranges += ranges_size;
+			n = kgsl_sharedmem_coalesce_bind_op(op, n);
 			continue;
 		}
 
 		/* Get the child object */
-		op->ops[i].entry = kgsl_sharedmem_find_id(private,
+		op->ops[n].entry = kgsl_sharedmem_find_id(private,
 			range.child_id);
-		entry = op->ops[i].entry;
+		entry = op->ops[n].entry;
 		if (!entry) {
 			ret = -ENOENT;
 			goto err;
 		}
 
+		kgsl_reclaim_touch_entry(entry);
+
 		/* Make sure the child is not a VBO */
 		if ((entry->memdesc.flags & KGSL_MEMFLAGS_VBO)) {
 			ret = -EINVAL;
@@ -445,15 +502,19 @@ kgsl_sharedmem_create_bind_op(struct kgsl_process_private *private,
 				goto err;
 		}
 
-		op->ops[i].entry = entry;
-		op->ops[i].start = range.target_offset;
-		op->ops[i].last = range.target_offset + range.length - 1;
-		op->ops[i].child_offset = range.child_offset;
-		op->ops[i].op = range.op;
+		op->ops[n].entry = entry;
+		op->ops[n].start = range.target_offset;
+		op->ops[n].last = range.target_offset + range.length - 1;
+		op->ops[n].child_offset = range.child_offset;
+		op->ops[n].op = range.op;
 
 		ranges += ranges_size;
+		n = kgsl_sharedmem_coalesce_bind_op(op, n);
 	}
 
+	/* Only the coalesced operations are left to apply */
+	op->nr_ops = n;
+
 	init_completion(&op->comp);
 	kref_init(&op->ref);
 
@@ -476,26 +537,41 @@ static void kgsl_sharedmem_bind_worker(struct work_struct *work)
 {
 	struct kgsl_sharedmem_bind_op *op = container_of(work,
 		struct kgsl_sharedmem_bind_op, work);
+	struct kgsl_memdesc *memdesc = &op->target->memdesc;
+	LIST_HEAD(released);
 	int i;
 
+	/* Defer the TLB invalidation until all the ranges are updated */
+	memdesc->priv |= KGSL_MEMDESC_SKIP_TLB_FLUSH;
+
 	for (i = 0; i < op->nr_ops; i++) {
 		if (op->ops[i].op == KGSL_GPUMEM_RANGE_OP_BIND)
 			kgsl_memdesc_add_range(op->target,
 				op->ops[i].start,
 				op->ops[i].last,
 				op->ops[i].entry,
-				op->ops[i].child_offset);
+				op->ops[i].child_offset,
+				&released);
 		else
 			kgsl_memdesc_remove_range(op->target,
 				op->ops[i].start,
 				op->ops[i].last,
-				op->ops[i].entry);
+				op->ops[i].entry,
+				&released);
 
 		/* Release the reference on the child entry */
 		kgsl_mem_entry_put(op->ops[i].entry);
 		op->ops[i].entry = NULL;
 	}
 
+	memdesc->priv &= ~KGSL_MEMDESC_SKIP_TLB_FLUSH;
+
+	/* Flush the TLB once for the whole bind object */
+	if (memdesc->pagetable)
+		kgsl_mmu_flush_tlb(memdesc->pagetable->mmu);
+
+	bind_range_release(&released);
+
 	/* Release the reference on the target entry */
 	kgsl_mem_entry_put(op->target);
 	op->target = NULL;
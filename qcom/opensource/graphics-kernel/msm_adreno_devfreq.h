@@ -58,6 +58,21 @@ struct devfreq_msm_adreno_tz_data {
 	u32 mod_percent;
 	/* Increase IB vote on high ddr stall */
 	bool fast_bus_hint;
+	/* Frame based prediction used by the msm-adreno-predict governor */
+	struct {
+		/* Set while the predictive governor is running */
+		bool enabled;
+		/* Frequency predicted to fit the next frame */
+		unsigned long freq;
+		/* local_clock() time after which @freq is stale */
+		u64 expires;
+		/* History that produced @freq, only used for comparison */
+		const void *owner;
+		/* Busy percentage the prediction aims for */
+		u32 target_load;
+		/* Running average of the prediction error in percent */
+		u32 error;
+	} predict;
 };
 
 struct msm_adreno_extended_profile {
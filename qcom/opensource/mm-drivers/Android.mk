@@ -9,6 +9,8 @@ endif
 
 ifeq ($(MM_DRV_DLKM_ENABLE), true)
 	include $(MM_DRIVER_PATH)/msm_ext_display/Android.mk
+	include $(MM_DRIVER_PATH)/dma_map_cache/Android.mk
+	include $(MM_DRIVER_PATH)/media_latency/Android.mk
 	ifneq ($(TARGET_BOARD_PLATFORM), taro)
 		include $(MM_DRIVER_PATH)/hw_fence/Android.mk
 		include $(MM_DRIVER_PATH)/sync_fence/Android.mk
@@ -7,3 +7,5 @@
 #define CONFIG_MSM_EXT_DISPLAY 1
 #define CONFIG_QCOM_SPEC_SYNC 1
 #define CONFIG_QTI_HW_FENCE 1
+#define CONFIG_MSM_DMA_MAP_CACHE 1
+#define CONFIG_MSM_MEDIA_LATENCY 1
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef __MSM_DMA_MAP_CACHE_H
+#define __MSM_DMA_MAP_CACHE_H
+
+#include <linux/device.h>
+#include <linux/dma-buf.h>
+#include <linux/dma-direction.h>
+#include <linux/err.h>
+#include <linux/scatterlist.h>
+
+/**
+ * struct msm_dma_map_cache_entry - mapping of one dma-buf on one device
+ *
+ * Opaque to clients. An entry is shared by every client that maps the
+ * same dma-buf on the same device with the same direction and attributes,
+ * and stays mapped for a while after the last client put it, so a buffer
+ * passed between subsystems is mapped once per device instead of once per
+ * import.
+ */
+struct msm_dma_map_cache_entry;
+
+#if IS_ENABLED(CONFIG_MSM_DMA_MAP_CACHE)
+
+/**
+ * msm_dma_map_cache_get() - get a mapping of a dma-buf on a device
+ * @dmabuf: buffer to map
+ * @dev: device, i.e. context bank, to map the buffer on
+ * @dir: dma direction of the mapping
+ * @attrs: dma attributes set on the attachment before mapping
+ *
+ * Returns an entry holding its own reference to @dmabuf, or an ERR_PTR.
+ * The mapping is valid until the matching msm_dma_map_cache_put().
+ */
+struct msm_dma_map_cache_entry *msm_dma_map_cache_get(struct dma_buf *dmabuf,
+	struct device *dev, enum dma_data_direction dir, unsigned long attrs);
+
+/**
+ * msm_dma_map_cache_put() - release a mapping taken with get
+ * @entry: entry returned by msm_dma_map_cache_get()
+ *
+ * The last put does not unmap: the entry is left idle until it is reused,
+ * expires, or is reclaimed by the shrinker.
+ */
+void msm_dma_map_cache_put(struct msm_dma_map_cache_entry *entry);
+
+/**
+ * msm_dma_map_cache_sgt() - scatterlist of a mapping
+ * @entry: entry returned by msm_dma_map_cache_get()
+ */
+struct sg_table *msm_dma_map_cache_sgt(struct msm_dma_map_cache_entry *entry);
+
+/**
+ * msm_dma_map_cache_flush_dev() - unmap every idle mapping of a device
+ * @dev: device going away or detaching its context bank
+ *
+ * Must be called before @dev's iommu domain is torn down.
+ */
+void msm_dma_map_cache_flush_dev(struct device *dev);
+
+#else
+
+static inline struct msm_dma_map_cache_entry *msm_dma_map_cache_get(
+	struct dma_buf *dmabuf, struct device *dev,
+	enum dma_data_direction dir, unsigned long attrs)
+{
+	return ERR_PTR(-ENODEV);
+}
+
+static inline void msm_dma_map_cache_put(struct msm_dma_map_cache_entry *entry)
+{
+}
+
+static inline struct sg_table *msm_dma_map_cache_sgt(
+	struct msm_dma_map_cache_entry *entry)
+{
+	return ERR_PTR(-ENODEV);
+}
+
+static inline void msm_dma_map_cache_flush_dev(struct device *dev)
+{
+}
+
+#endif /* CONFIG_MSM_DMA_MAP_CACHE */
+
+#endif /* __MSM_DMA_MAP_CACHE_H */
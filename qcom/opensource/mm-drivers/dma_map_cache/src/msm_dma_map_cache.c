@@ -0,0 +1,447 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#define pr_fmt(fmt)	"%s: " fmt, __func__
+
+#include <linux/debugfs.h>
+#include <linux/dma-buf.h>
+#include <linux/hashtable.h>
+#include <linux/jiffies.h>
+#include <linux/list.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/seq_file.h>
+#include <linux/shrinker.h>
+#include <linux/slab.h>
+#include <linux/types.h>
+#include <linux/workqueue.h>
+
+#include "msm_dma_map_cache.h"
+
+#define DMA_MAP_CACHE_HASH_BITS		8
+
+static uint idle_timeout_ms = 1000;
+module_param(idle_timeout_ms, uint, 0644);
+MODULE_PARM_DESC(idle_timeout_ms,
+	"time in ms an unused mapping is kept before it is unmapped");
+
+static uint max_idle = 256;
+module_param(max_idle, uint, 0644);
+MODULE_PARM_DESC(max_idle, "maximum number of unused mappings kept");
+
+struct msm_dma_map_cache_entry {
+	struct hlist_node node;
+	struct list_head lru;
+	struct dma_buf *dmabuf;
+	struct device *dev;
+	enum dma_data_direction dir;
+	unsigned long attrs;
+	struct dma_buf_attachment *attach;
+	struct sg_table *sgt;
+	u32 refcount;
+	unsigned long idle_since;
+};
+
+/**
+ * struct msm_dma_map_cache - mapping cache shared by all clients
+ * @entries: entries hashed by dma-buf
+ * @lru: idle entries, oldest first
+ * @lock: protects everything below and the entries' refcount and lru
+ * @expire_work: unmaps entries idle for longer than idle_timeout_ms
+ * @shrinker: unmaps idle entries under memory pressure
+ * @debugfs: debugfs directory
+ * @num_entries: entries in the cache
+ * @num_idle: entries on @lru
+ * @hits: gets served by an existing entry
+ * @idle_hits: part of @hits that revived an idle entry, i.e. saved a remap
+ * @misses: gets that had to map the buffer
+ * @expired: idle entries unmapped by @expire_work
+ * @evicted: idle entries unmapped to stay within max_idle
+ * @shrunk: idle entries unmapped by @shrinker
+ */
+struct msm_dma_map_cache {
+	DECLARE_HASHTABLE(entries, DMA_MAP_CACHE_HASH_BITS);
+	struct list_head lru;
+	struct mutex lock;
+	struct delayed_work expire_work;
+	struct shrinker shrinker;
+	struct dentry *debugfs;
+	u32 num_entries;
+	u32 num_idle;
+	u64 hits;
+	u64 idle_hits;
+	u64 misses;
+	u64 expired;
+	u64 evicted;
+	u64 shrunk;
+};
+
+static struct msm_dma_map_cache map_cache;
+
+static struct msm_dma_map_cache_entry *msm_dma_map_cache_create(
+	struct dma_buf *dmabuf, struct device *dev,
+	enum dma_data_direction dir, unsigned long attrs)
+{
+	struct msm_dma_map_cache_entry *entry;
+	int rc;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return ERR_PTR(-ENOMEM);
+
+	get_dma_buf(dmabuf);
+	entry->attach = dma_buf_attach(dmabuf, dev);
+	if (IS_ERR(entry->attach)) {
+		rc = PTR_ERR(entry->attach);
+		pr_err("failed to attach %s, rc=%d\n", dev_name(dev), rc);
+		goto put_buf;
+	}
+
+	entry->attach->dma_map_attrs = attrs;
+	entry->sgt = dma_buf_map_attachment(entry->attach, dir);
+	if (IS_ERR(entry->sgt)) {
+		rc = PTR_ERR(entry->sgt);
+		pr_err("failed to map on %s, rc=%d\n", dev_name(dev), rc);
+		goto detach;
+	}
+
+	INIT_LIST_HEAD(&entry->lru);
+	entry->dmabuf = dmabuf;
+	entry->dev = dev;
+	entry->dir = dir;
+	entry->attrs = attrs;
+	entry->refcount = 1;
+
+	return entry;
+
+detach:
+	dma_buf_detach(dmabuf, entry->attach);
+put_buf:
+	dma_buf_put(dmabuf);
+	kfree(entry);
+	return ERR_PTR(rc);
+}
+
+static void msm_dma_map_cache_destroy(struct msm_dma_map_cache_entry *entry)
+{
+	dma_buf_unmap_attachment(entry->attach, entry->sgt, entry->dir);
+	dma_buf_detach(entry->dmabuf, entry->attach);
+	dma_buf_put(entry->dmabuf);
+	kfree(entry);
+}
+
+static void msm_dma_map_cache_destroy_list(struct list_head *list)
+{
+	struct msm_dma_map_cache_entry *entry, *tmp;
+
+	list_for_each_entry_safe(entry, tmp, list, lru) {
+		list_del(&entry->lru);
+		msm_dma_map_cache_destroy(entry);
+	}
+}
+
+/* Unhash an idle entry and move it to @list, called with the lock held */
+static void msm_dma_map_cache_evict(struct msm_dma_map_cache_entry *entry,
+	struct list_head *list)
+{
+	hash_del(&entry->node);
+	list_move_tail(&entry->lru, list);
+	map_cache.num_idle--;
+	map_cache.num_entries--;
+}
+
+static struct msm_dma_map_cache_entry *msm_dma_map_cache_lookup(
+	struct dma_buf *dmabuf, struct device *dev,
+	enum dma_data_direction dir, unsigned long attrs)
+{
+	struct msm_dma_map_cache_entry *entry;
+
+	hash_for_each_possible(map_cache.entries, entry, node,
+			(unsigned long)dmabuf) {
+		if (entry->dmabuf != dmabuf || entry->dev != dev ||
+			entry->dir != dir || entry->attrs != attrs)
+			continue;
+
+		if (!entry->refcount++) {
+			list_del_init(&entry->lru);
+			map_cache.num_idle--;
+			map_cache.idle_hits++;
+		}
+		map_cache.hits++;
+		return entry;
+	}
+
+	return NULL;
+}
+
+struct msm_dma_map_cache_entry *msm_dma_map_cache_get(struct dma_buf *dmabuf,
+	struct device *dev, enum dma_data_direction dir, unsigned long attrs)
+{
+	struct msm_dma_map_cache_entry *entry, *new;
+
+	if (IS_ERR_OR_NULL(dmabuf) || !dev)
+		return ERR_PTR(-EINVAL);
+
+	mutex_lock(&map_cache.lock);
+	entry = msm_dma_map_cache_lookup(dmabuf, dev, dir, attrs);
+	if (!entry)
+		map_cache.misses++;
+	mutex_unlock(&map_cache.lock);
+	if (entry)
+		return entry;
+
+	/* map without the lock, other devices' lookups need not wait on it */
+	new = msm_dma_map_cache_create(dmabuf, dev, dir, attrs);
+	if (IS_ERR(new))
+		return new;
+
+	mutex_lock(&map_cache.lock);
+	entry = msm_dma_map_cache_lookup(dmabuf, dev, dir, attrs);
+	if (!entry) {
+		hash_add(map_cache.entries, &new->node, (unsigned long)dmabuf);
+		map_cache.num_entries++;
+	}
+	mutex_unlock(&map_cache.lock);
+
+	/* lost a race with another client mapping the same buffer */
+	if (entry) {
+		msm_dma_map_cache_destroy(new);
+		return entry;
+	}
+
+	return new;
+}
+EXPORT_SYMBOL(msm_dma_map_cache_get);
+
+void msm_dma_map_cache_put(struct msm_dma_map_cache_entry *entry)
+{
+	struct msm_dma_map_cache_entry *oldest;
+	LIST_HEAD(evict_list);
+
+	if (IS_ERR_OR_NULL(entry))
+		return;
+
+	mutex_lock(&map_cache.lock);
+	if (WARN_ON(!entry->refcount)) {
+		mutex_unlock(&map_cache.lock);
+		return;
+	}
+
+	if (--entry->refcount) {
+		mutex_unlock(&map_cache.lock);
+		return;
+	}
+
+	entry->idle_since = jiffies;
+	list_add_tail(&entry->lru, &map_cache.lru);
+	map_cache.num_idle++;
+
+	while (map_cache.num_idle > max_idle) {
+		oldest = list_first_entry(&map_cache.lru,
+			struct msm_dma_map_cache_entry, lru);
+		msm_dma_map_cache_evict(oldest, &evict_list);
+		map_cache.evicted++;
+	}
+
+	if (map_cache.num_idle && idle_timeout_ms)
+		queue_delayed_work(system_power_efficient_wq,
+			&map_cache.expire_work,
+			msecs_to_jiffies(idle_timeout_ms));
+	mutex_unlock(&map_cache.lock);
+
+	msm_dma_map_cache_destroy_list(&evict_list);
+}
+EXPORT_SYMBOL(msm_dma_map_cache_put);
+
+struct sg_table *msm_dma_map_cache_sgt(struct msm_dma_map_cache_entry *entry)
+{
+	if (IS_ERR_OR_NULL(entry))
+		return ERR_PTR(-EINVAL);
+
+	return entry->sgt;
+}
+EXPORT_SYMBOL(msm_dma_map_cache_sgt);
+
+void msm_dma_map_cache_flush_dev(struct device *dev)
+{
+	struct msm_dma_map_cache_entry *entry, *tmp;
+	struct hlist_node *node_tmp;
+	LIST_HEAD(evict_list);
+	u32 in_use = 0;
+	int bkt;
+
+	mutex_lock(&map_cache.lock);
+	list_for_each_entry_safe(entry, tmp, &map_cache.lru, lru) {
+		if (entry->dev == dev)
+			msm_dma_map_cache_evict(entry, &evict_list);
+	}
+
+	hash_for_each_safe(map_cache.entries, bkt, node_tmp, entry, node) {
+		if (entry->dev == dev)
+			in_use++;
+	}
+	mutex_unlock(&map_cache.lock);
+
+	if (in_use)
+		pr_warn("%s still has %u mappings in use\n", dev_name(dev),
+			in_use);
+
+	msm_dma_map_cache_destroy_list(&evict_list);
+}
+EXPORT_SYMBOL(msm_dma_map_cache_flush_dev);
+
+static void msm_dma_map_cache_expire_work(struct work_struct *work)
+{
+	struct msm_dma_map_cache_entry *entry, *tmp;
+	unsigned long timeout = msecs_to_jiffies(idle_timeout_ms);
+	LIST_HEAD(evict_list);
+
+	mutex_lock(&map_cache.lock);
+	list_for_each_entry_safe(entry, tmp, &map_cache.lru, lru) {
+		if (time_before(jiffies, entry->idle_since + timeout)) {
+			/* rest of the list is younger, revisit at the oldest */
+			queue_delayed_work(system_power_efficient_wq,
+				&map_cache.expire_work,
+				entry->idle_since + timeout - jiffies);
+			break;
+		}
+		msm_dma_map_cache_evict(entry, &evict_list);
+		map_cache.expired++;
+	}
+	mutex_unlock(&map_cache.lock);
+
+	msm_dma_map_cache_destroy_list(&evict_list);
+}
+
+static unsigned long msm_dma_map_cache_shrink_count(struct shrinker *shrinker,
+	struct shrink_control *sc)
+{
+	return READ_ONCE(map_cache.num_idle) ? : SHRINK_EMPTY;
+}
+
+static unsigned long msm_dma_map_cache_shrink_scan(struct shrinker *shrinker,
+	struct shrink_control *sc)
+{
+	struct msm_dma_map_cache_entry *entry, *tmp;
+	unsigned long freed = 0;
+	LIST_HEAD(evict_list);
+
+	if (!mutex_trylock(&map_cache.lock))
+		return SHRINK_STOP;
+
+	list_for_each_entry_safe(entry, tmp, &map_cache.lru, lru) {
+		if (freed >= sc->nr_to_scan)
+			break;
+		msm_dma_map_cache_evict(entry, &evict_list);
+		map_cache.shrunk++;
+		freed++;
+	}
+	mutex_unlock(&map_cache.lock);
+
+	msm_dma_map_cache_destroy_list(&evict_list);
+
+	return freed;
+}
+
+#if IS_ENABLED(CONFIG_DEBUG_FS)
+static int msm_dma_map_cache_stats_show(struct seq_file *s, void *unused)
+{
+	mutex_lock(&map_cache.lock);
+	seq_printf(s, "entries:   %u\n", map_cache.num_entries);
+	seq_printf(s, "idle:      %u\n", map_cache.num_idle);
+	seq_printf(s, "hits:      %llu\n", map_cache.hits);
+	seq_printf(s, "idle_hits: %llu\n", map_cache.idle_hits);
+	seq_printf(s, "misses:    %llu\n", map_cache.misses);
+	seq_printf(s, "expired:   %llu\n", map_cache.expired);
+	seq_printf(s, "evicted:   %llu\n", map_cache.evicted);
+	seq_printf(s, "shrunk:    %llu\n", map_cache.shrunk);
+	mutex_unlock(&map_cache.lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(msm_dma_map_cache_stats);
+
+static int msm_dma_map_cache_entries_show(struct seq_file *s, void *unused)
+{
+	struct msm_dma_map_cache_entry *entry;
+	int bkt;
+
+	mutex_lock(&map_cache.lock);
+	hash_for_each(map_cache.entries, bkt, entry, node)
+		seq_printf(s, "%-24s inode %lu size %zu dir %d refs %u\n",
+			dev_name(entry->dev), file_inode(entry->dmabuf->file)->i_ino,
+			entry->dmabuf->size, entry->dir, entry->refcount);
+	mutex_unlock(&map_cache.lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(msm_dma_map_cache_entries);
+
+static void msm_dma_map_cache_debugfs_init(void)
+{
+	map_cache.debugfs = debugfs_create_dir("msm_dma_map_cache", NULL);
+	if (IS_ERR_OR_NULL(map_cache.debugfs))
+		return;
+
+	debugfs_create_file("stats", 0444, map_cache.debugfs, NULL,
+		&msm_dma_map_cache_stats_fops);
+	debugfs_create_file("entries", 0444, map_cache.debugfs, NULL,
+		&msm_dma_map_cache_entries_fops);
+}
+#else
+static void msm_dma_map_cache_debugfs_init(void)
+{
+}
+#endif
+
+static int __init msm_dma_map_cache_init(void)
+{
+	int rc;
+
+	hash_init(map_cache.entries);
+	INIT_LIST_HEAD(&map_cache.lru);
+	mutex_init(&map_cache.lock);
+	INIT_DELAYED_WORK(&map_cache.expire_work,
+		msm_dma_map_cache_expire_work);
+
+	map_cache.shrinker.count_objects = msm_dma_map_cache_shrink_count;
+	map_cache.shrinker.scan_objects = msm_dma_map_cache_shrink_scan;
+	map_cache.shrinker.seeks = DEFAULT_SEEKS;
+	rc = register_shrinker(&map_cache.shrinker);
+	if (rc) {
+		pr_err("failed to register shrinker, rc=%d\n", rc);
+		return rc;
+	}
+
+	msm_dma_map_cache_debugfs_init();
+
+	return 0;
+}
+
+static void __exit msm_dma_map_cache_exit(void)
+{
+	struct msm_dma_map_cache_entry *entry, *tmp;
+	LIST_HEAD(evict_list);
+
+	debugfs_remove_recursive(map_cache.debugfs);
+	unregister_shrinker(&map_cache.shrinker);
+	cancel_delayed_work_sync(&map_cache.expire_work);
+
+	mutex_lock(&map_cache.lock);
+	list_for_each_entry_safe(entry, tmp, &map_cache.lru, lru)
+		msm_dma_map_cache_evict(entry, &evict_list);
+	WARN_ON(map_cache.num_entries);
+	mutex_unlock(&map_cache.lock);
+
+	msm_dma_map_cache_destroy_list(&evict_list);
+	mutex_destroy(&map_cache.lock);
+}
+
+module_init(msm_dma_map_cache_init);
+module_exit(msm_dma_map_cache_exit);
+
+MODULE_LICENSE("GPL v2");
+MODULE_DESCRIPTION("MSM shared dma-buf mapping cache");
+MODULE_IMPORT_NS(DMA_BUF);
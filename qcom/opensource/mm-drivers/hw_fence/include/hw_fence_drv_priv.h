@@ -24,6 +24,21 @@
 #define HW_FENCE_HASH_A_MULT	4969 /* a multiplier for Hash algorithm */
 #define HW_FENCE_HASH_C_MULT	907  /* c multiplier for Hash algorithm */
 
+/* max number of rx queue payloads buffered by a signal batch before they are flushed */
+#define HW_FENCE_SIGNAL_BATCH_MAX	8
+
+/* number of fence-array children tracked without allocating while creating a join-fence */
+#define HW_FENCE_JOIN_INLINE_CHILDREN	16
+
+/* number of log2 buckets tracked for the probe length histogram */
+#define HW_FENCE_PROBE_HIST_BINS	8
+
+/* per-client fence latency sampling: ring of last samples and log2 histograms in timer ticks */
+#define HW_FENCE_LATENCY_RING_SIZE	32
+#define HW_FENCE_LATENCY_HIST_BINS	16
+#define HW_FENCE_LATENCY_HIST_SHIFT	6 /* first bucket holds latencies below 1 << 6 ticks */
+#define HW_FENCE_LATENCY_SAMPLE_RATE	16 /* default, sample one of every N queue reads */
+
 /* number of queues per type (i.e. ctrl or client queues) */
 #define HW_FENCE_CTRL_QUEUES	2 /* Rx and Tx Queues */
 #define HW_FENCE_CLIENT_QUEUES	2 /* Rx and Tx Queues */
@@ -163,6 +178,49 @@ enum payload_type {
 	HW_FENCE_PAYLOAD_TYPE_1 = 1
 };
 
+/**
+ * enum hw_fence_latency_stage - Stages of the hw-fence path tracked by the latency histograms.
+ * HW_FENCE_LAT_CREATE_TO_SIGNAL: from fence creation to the signal written in the client queue
+ * HW_FENCE_LAT_SIGNAL_TO_READ: from the signal written in the client queue to the client read
+ * HW_FENCE_LAT_CREATE_TO_READ: end-to-end, from fence creation to the client read
+ */
+enum hw_fence_latency_stage {
+	HW_FENCE_LAT_CREATE_TO_SIGNAL,
+	HW_FENCE_LAT_SIGNAL_TO_READ,
+	HW_FENCE_LAT_CREATE_TO_READ,
+	HW_FENCE_LAT_STAGES
+};
+
+/**
+ * struct hw_fence_latency_sample - timestamps of a hw-fence read from a client queue.
+ * @hash: hash of the hw-fence
+ * @create_ts: timestamp when the hw-fence was created, zero if the fence was already released
+ * @signal_ts: timestamp written in the queue payload by the signaling core
+ * @read_ts: timestamp when the payload was read from the client queue
+ */
+struct hw_fence_latency_sample {
+	u64 hash;
+	u64 create_ts;
+	u64 signal_ts;
+	u64 read_ts;
+};
+
+/**
+ * struct hw_fence_client_latency - Structure holding the sampled latencies of a client.
+ * @lock: lock to serialize the queue reads recording samples with the debugfs dump
+ * @reads: number of payloads read from the client queues
+ * @samples: number of samples recorded
+ * @ring: last HW_FENCE_LATENCY_RING_SIZE samples, indexed by samples % ring size
+ * @hist: log2 histograms of the latency of each stage in timer ticks
+ */
+struct hw_fence_client_latency {
+	spinlock_t lock;
+	u32 reads;
+	u32 samples;
+	struct hw_fence_latency_sample ring[HW_FENCE_LATENCY_RING_SIZE];
+	u32 hist[HW_FENCE_LAT_STAGES][HW_FENCE_LATENCY_HIST_BINS];
+};
+
 /**
  * struct msm_hw_fence_client - Structure holding the per-Client allocated resources.
  * @client_id: internal client_id used within HW fence driver; index into the clients struct
@@ -177,6 +235,7 @@ enum payload_type {
  * @send_ipc: bool to indicate if client requires ipc interrupt for already signaled fences
  * @skip_txq_wr_idx: bool to indicate if update to tx queue write_index is skipped within hw fence
  *                   driver and hfi_header->tx_wm is updated instead
+ * @latency: sampled latencies of the fences read from this client queues
  * @wait_queue: wait queue for the validation clients
  * @val_signal: doorbell flag to signal the validation clients in the wait queue
  */
@@ -191,6 +250,7 @@ struct msm_hw_fence_client {
 	bool update_rxq;
 	bool send_ipc;
 	bool skip_txq_wr_idx;
+	struct hw_fence_client_latency latency;
 #if IS_ENABLED(CONFIG_DEBUG_FS)
 	wait_queue_head_t wait_queue;
 	atomic_t val_signal;
@@ -219,6 +279,8 @@ struct msm_hw_fence_mem_data {
  * @clients_list: list of debug clients registered
  * @clients_list_lock: lock to synchronize access to the clients list
  * @lock_wake_cnt: number of times that driver triggers wake-up ipcc to unlock inter-vm try-lock
+ * @latency_sample_rate: sample the latency of one of every N fences read from the client queues,
+ *                       zero disables the sampling
  */
 struct msm_hw_fence_dbg_data {
 	struct dentry *root;
@@ -234,6 +296,7 @@ struct msm_hw_fence_dbg_data {
 	struct mutex clients_list_lock;
 
 	u64 lock_wake_cnt;
+	u32 latency_sample_rate;
 };
 
 /**
@@ -270,6 +333,11 @@ struct hw_fence_client_queue_size_desc {
  * @clients_num: number of supported hw fence clients (configured based on device-tree)
  * @hw_fences_tbl: pointer to the hw-fences table
  * @hw_fences_tbl_cnt: number of elements in the hw-fence table
+ * @hw_fences_tags: driver-private array with one tag byte per hw-fence table entry, zero when
+ *                  the entry is free; lets lookups skip entries that cannot match
+ * @hw_fences_max_probe: longest probe distance used by any fence created so far
+ * @hw_fences_used: number of reserved entries in the hw-fence table
+ * @hw_fences_probe_hist: log2 histogram of the probe distance of created fences
  * @client_lock_tbl: pointer to the per-client locks table
  * @client_lock_tbl_cnt: number of elements in the locks table
  * @hw_fences_mem_desc: memory descriptor for the hw-fence table
@@ -326,6 +394,10 @@ struct hw_fence_driver_data {
 	/* HW Fences Table VA */
 	struct msm_hw_fence *hw_fences_tbl;
 	u32 hw_fences_tbl_cnt;
+	u8 *hw_fences_tags;
+	atomic_t hw_fences_max_probe;
+	atomic_t hw_fences_used;
+	atomic_t hw_fences_probe_hist[HW_FENCE_PROBE_HIST_BINS];
 
 	/* Table with a Per-Client Lock */
 	u64 *client_lock_tbl;
@@ -464,6 +536,48 @@ struct msm_hw_fence {
 	u64 client_data[HW_FENCE_MAX_CLIENTS_WITH_DATA];
 };
 
+/**
+ * struct hw_fence_signal_batch - signals accumulated to be sent to the clients at once
+ * @rxq_client: client whose rx queue payloads are currently buffered
+ * @payloads: rx queue payloads buffered for rxq_client
+ * @count: number of buffered payloads
+ * @db_mask: bitmask of client_ids that need an ipcc doorbell when the batch is flushed
+ * @val_mask: bitmask of validation client_ids to loopback when the batch is flushed
+ *
+ * Payloads for the same client are written to its rx queue with a single queue update and
+ * every destination client gets a single ipcc doorbell per batch, regardless of the number of
+ * fences signaled to it. See hw_fence_signal_batch_flush().
+ */
+struct hw_fence_signal_batch {
+	struct msm_hw_fence_client *rxq_client;
+	struct msm_hw_fence_queue_payload payloads[HW_FENCE_SIGNAL_BATCH_MAX];
+	u32 count;
+	u64 db_mask;
+	u64 val_mask;
+};
+
+/**
+ * struct hw_fence_join_state - children bookkeeping while a join-fence is created
+ * @num: number of children of the fence-array
+ * @signaled: number of children found already signaled
+ * @child_hash: hash of each child in the hw-fence table
+ * @linked: bitmap of the children linked to the join-fence as not signaled yet
+ * @inline_hash: storage for child_hash when num is small
+ * @inline_linked: storage for linked when num is small
+ *
+ * Each child is looked-up once; hashes are kept to unlink the children without a second lookup
+ * on failure, and already signaled children are discounted from the join-fence pending count
+ * at once.
+ */
+struct hw_fence_join_state {
+	u32 num;
+	u32 signaled;
+	u64 *child_hash;
+	unsigned long *linked;
+	u64 inline_hash[HW_FENCE_JOIN_INLINE_CHILDREN];
+	DECLARE_BITMAP(inline_linked, HW_FENCE_JOIN_INLINE_CHILDREN);
+};
+
 int hw_fence_init(struct hw_fence_driver_data *drv_data);
 int hw_fence_alloc_client_resources(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client,
@@ -485,19 +599,30 @@ int hw_fence_destroy_with_hash(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, u64 hash);
 int hw_fence_process_fence_array(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client,
-	struct dma_fence_array *array, u64 *hash_join_fence, u64 client_data);
+	struct dma_fence_array *array, u64 *hash_join_fence, u64 client_data,
+	struct hw_fence_signal_batch *batch);
 int hw_fence_process_fence(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, struct dma_fence *fence, u64 *hash,
-	u64 client_data);
+	u64 client_data, struct hw_fence_signal_batch *batch);
 int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, u64 ctxt_id, u64 seqno, u64 hash,
 	u64 flags, u64 client_data, u32 error, int queue_type);
+int hw_fence_update_queue_batch(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client,
+	struct msm_hw_fence_queue_payload *payloads, u32 count, int queue_type);
+void hw_fence_signal_batch_init(struct hw_fence_signal_batch *batch);
+void hw_fence_signal_batch_flush(struct hw_fence_driver_data *drv_data,
+	struct hw_fence_signal_batch *batch);
 inline u64 hw_fence_get_qtime(struct hw_fence_driver_data *drv_data);
-int hw_fence_read_queue(struct msm_hw_fence_client *hw_fence_client,
+int hw_fence_read_queue(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client,
 	struct msm_hw_fence_queue_payload *payload, int queue_type);
 int hw_fence_register_wait_client(struct hw_fence_driver_data *drv_data,
 	struct dma_fence *fence, struct msm_hw_fence_client *hw_fence_client, u64 context,
 	u64 seqno, u64 *hash, u64 client_data);
+int hw_fence_register_wait_client_batch(struct hw_fence_driver_data *drv_data,
+	struct dma_fence *fence, struct msm_hw_fence_client *hw_fence_client, u64 context,
+	u64 seqno, u64 *hash, u64 client_data, struct hw_fence_signal_batch *batch);
 struct msm_hw_fence *msm_hw_fence_find(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client,
 	u64 context, u64 seqno, u64 *hash);
@@ -149,12 +149,14 @@ int hw_fence_utils_map_ctl_start(struct hw_fence_driver_data *drv_data);
  * @hw_fence: hw-fence to cleanup
  * @hash: hash of the hw-fence to cleanup
  * @reset_flags: flags to determine how to handle the reset
+ * @batch: if not NULL, signals to the waiting clients are accumulated in this batch and are
+ *         sent when the caller flushes it
  *
  * Returns zero if success, otherwise returns negative error code.
  */
 int hw_fence_utils_cleanup_fence(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, struct msm_hw_fence *hw_fence, u64 hash,
-	u32 reset_flags);
+	u32 reset_flags, struct hw_fence_signal_batch *batch);
 
 /**
  * hw_fence_utils_get_client_id_priv() - Gets the index into clients struct within hw fence driver
@@ -692,6 +692,126 @@ exit:
 	return len;
 }
 
+/**
+ * hw_fence_dbg_table_stats_rd() - debugfs read to dump the hw-fences table occupancy.
+ * @file: file handler.
+ * @user_buf: user buffer content for debugfs.
+ * @user_buf_size: size of the user buffer.
+ * @ppos: position offset of the user buffer.
+ *
+ * This debugfs dumps the number of used entries and load factor of the hw-fence table, the
+ * longest probe distance and the log2 histogram of probe distances of the created fences.
+ */
+static ssize_t hw_fence_dbg_table_stats_rd(struct file *file, char __user *user_buf,
+	size_t user_buf_size, loff_t *ppos)
+{
+	struct hw_fence_driver_data *drv_data;
+	u32 used, entries;
+	char buf[512];
+	int len, i;
+
+	if (!file || !file->private_data) {
+		HWFNC_ERR("unexpected data %d\n", file);
+		return -EINVAL;
+	}
+	drv_data = file->private_data;
+
+	entries = drv_data->hw_fence_table_entries;
+	used = atomic_read(&drv_data->hw_fences_used);
+
+	len = scnprintf(buf, sizeof(buf), "entries:%u used:%u load:%u%% max_probe:%d\n",
+		entries, used, entries ? (u32)div_u64((u64)used * 100, entries) : 0,
+		atomic_read(&drv_data->hw_fences_max_probe));
+	for (i = 0; i < HW_FENCE_PROBE_HIST_BINS; i++)
+		len += scnprintf(buf + len, sizeof(buf) - len, "probe %s%u: %d\n",
+			i == HW_FENCE_PROBE_HIST_BINS - 1 ? ">=" : "<",
+			i == HW_FENCE_PROBE_HIST_BINS - 1 ? 1 << (i - 1) : 1 << i,
+			atomic_read(&drv_data->hw_fences_probe_hist[i]));
+
+	return simple_read_from_buffer(user_buf, user_buf_size, ppos, buf, len);
+}
+
+/**
+ * hw_fence_dbg_latency_rd() - debugfs read to dump the sampled per-client fence latencies.
+ * @file: file handler.
+ * @user_buf: user buffer content for debugfs.
+ * @user_buf_size: size of the user buffer.
+ * @ppos: position offset of the user buffer.
+ *
+ * This debugfs dumps, for each registered client that read fences from its queues, the log2
+ * histograms of the create-to-signal, signal-to-read and create-to-read latencies of the
+ * sampled fences, in timer ticks, followed by the timestamps of the last sample.
+ */
+static ssize_t hw_fence_dbg_latency_rd(struct file *file, char __user *user_buf,
+	size_t user_buf_size, loff_t *ppos)
+{
+	static const char * const stage_name[HW_FENCE_LAT_STAGES] = {
+		[HW_FENCE_LAT_CREATE_TO_SIGNAL] = "create->signal",
+		[HW_FENCE_LAT_SIGNAL_TO_READ] = "signal->read",
+		[HW_FENCE_LAT_CREATE_TO_READ] = "create->read",
+	};
+	struct hw_fence_driver_data *drv_data;
+	struct hw_fence_client_latency *lat;
+	struct hw_fence_latency_sample last = {0};
+	u32 hist[HW_FENCE_LAT_STAGES][HW_FENCE_LATENCY_HIST_BINS];
+	u32 reads, samples;
+	unsigned long flags;
+	int len, max_size = SZ_16K, i, j, k;
+	ssize_t ret;
+	char *buf;
+
+	if (!file || !file->private_data) {
+		HWFNC_ERR("unexpected data %d\n", file);
+		return -EINVAL;
+	}
+	drv_data = file->private_data;
+
+	buf = kzalloc(max_size, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	len = scnprintf(buf, max_size,
+		"sample_rate:%u bins: <%u ticks, then x2 per bin, last bin >=%u ticks\n",
+		drv_data->debugfs_data.latency_sample_rate, 1 << HW_FENCE_LATENCY_HIST_SHIFT,
+		1 << (HW_FENCE_LATENCY_HIST_SHIFT + HW_FENCE_LATENCY_HIST_BINS - 2));
+
+	mutex_lock(&drv_data->clients_register_lock);
+	for (i = 0; i < drv_data->clients_num; i++) {
+		if (!drv_data->clients[i])
+			continue;
+
+		lat = &drv_data->clients[i]->latency;
+		spin_lock_irqsave(&lat->lock, flags);
+		reads = lat->reads;
+		samples = lat->samples;
+		memcpy(hist, lat->hist, sizeof(hist));
+		if (samples)
+			last = lat->ring[(samples - 1) % HW_FENCE_LATENCY_RING_SIZE];
+		spin_unlock_irqrestore(&lat->lock, flags);
+
+		if (!samples)
+			continue;
+
+		len += scnprintf(buf + len, max_size - len, "client:%d reads:%u samples:%u\n", i,
+			reads, samples);
+		for (j = 0; j < HW_FENCE_LAT_STAGES; j++) {
+			len += scnprintf(buf + len, max_size - len, "  %-14s", stage_name[j]);
+			for (k = 0; k < HW_FENCE_LATENCY_HIST_BINS; k++)
+				len += scnprintf(buf + len, max_size - len, " %u", hist[j][k]);
+			len += scnprintf(buf + len, max_size - len, "\n");
+		}
+		len += scnprintf(buf + len, max_size - len,
+			"  last hash:%llu create:%llu signal:%llu read:%llu\n", last.hash,
+			last.create_ts, last.signal_ts, last.read_ts);
+	}
+	mutex_unlock(&drv_data->clients_register_lock);
+
+	ret = simple_read_from_buffer(user_buf, user_buf_size, ppos, buf, len);
+	kfree(buf);
+
+	return ret;
+}
+
 /**
  * hw_fence_dbg_dump_table_wr() - debugfs write to control the dump of the hw-fences table.
  * @file: file handler.
@@ -950,6 +1070,16 @@ static const struct file_operations hw_fence_dump_table_fops = {
 	.read = hw_fence_dbg_dump_table_rd,
 };
 
+static const struct file_operations hw_fence_table_stats_fops = {
+	.open = simple_open,
+	.read = hw_fence_dbg_table_stats_rd,
+};
+
+static const struct file_operations hw_fence_latency_fops = {
+	.open = simple_open,
+	.read = hw_fence_dbg_latency_rd,
+};
+
 static const struct file_operations hw_fence_dump_queues_fops = {
 	.open = simple_open,
 	.write = hw_fence_dbg_dump_queues_wr,
@@ -1001,6 +1131,13 @@ int hw_fence_debug_debugfs_register(struct hw_fence_driver_data *drv_data)
 	debugfs_create_u32("hw_fence_debug_level", 0600, debugfs_root, &msm_hw_fence_debug_level);
 	debugfs_create_file("hw_fence_dump_table", 0600, debugfs_root, drv_data,
 		&hw_fence_dump_table_fops);
+	debugfs_create_file("hw_fence_table_stats", 0400, debugfs_root, drv_data,
+		&hw_fence_table_stats_fops);
+	drv_data->debugfs_data.latency_sample_rate = HW_FENCE_LATENCY_SAMPLE_RATE;
+	debugfs_create_u32("hw_fence_latency_sample_rate", 0600, debugfs_root,
+		&drv_data->debugfs_data.latency_sample_rate);
+	debugfs_create_file("hw_fence_latency", 0400, debugfs_root, drv_data,
+		&hw_fence_latency_fops);
 	debugfs_create_file("hw_fence_dump_queues", 0600, debugfs_root, drv_data,
 		&hw_fence_dump_queues_fops);
 	debugfs_create_file("hw_sync", 0600, debugfs_root, NULL, &hw_sync_debugfs_fops);
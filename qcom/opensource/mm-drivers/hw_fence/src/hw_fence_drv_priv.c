@@ -6,6 +6,7 @@
 #include <linux/uaccess.h>
 #include <linux/of_platform.h>
 #include <linux/of_address.h>
+#include <asm/unaligned.h>
 
 #include "hw_fence_drv_priv.h"
 #include "hw_fence_drv_utils.h"
@@ -145,7 +146,61 @@ char *_get_queue_type(int queue_type)
 	return (queue_type == (HW_FENCE_RX_QUEUE - 1)) ? "RXQ" : "TXQ";
 }
 
-int hw_fence_read_queue(struct msm_hw_fence_client *hw_fence_client,
+static inline u32 _hw_fence_latency_bin(u64 delta)
+{
+	int bin = fls64(delta) - HW_FENCE_LATENCY_HIST_SHIFT;
+
+	return clamp(bin, 0, HW_FENCE_LATENCY_HIST_BINS - 1);
+}
+
+/*
+ * Samples the latency of a payload just read from a client queue. The signal timestamp is the
+ * one written in the payload by the core that signaled the fence and the create timestamp is
+ * taken from the hw-fence table, as long as the entry still holds the same fence.
+ */
+static void _hw_fence_latency_record(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client, struct msm_hw_fence_queue_payload *payload)
+{
+	struct hw_fence_client_latency *lat = &hw_fence_client->latency;
+	struct hw_fence_latency_sample *sample;
+	struct msm_hw_fence *hw_fence;
+	u32 rate = drv_data->debugfs_data.latency_sample_rate;
+	u64 read_ts, signal_ts, create_ts = 0;
+	unsigned long flags;
+
+	if (!rate || (lat->reads++ % rate))
+		return;
+
+	read_ts = hw_fence_get_qtime(drv_data);
+	signal_ts = ((u64)payload->timestamp_hi << 32) | payload->timestamp_lo;
+
+	if (payload->hash < drv_data->hw_fences_tbl_cnt) {
+		hw_fence = &drv_data->hw_fences_tbl[payload->hash];
+		if (hw_fence->valid && hw_fence->ctx_id == payload->ctxt_id &&
+				hw_fence->seq_id == payload->seqno)
+			create_ts = hw_fence->fence_create_time;
+	}
+
+	spin_lock_irqsave(&lat->lock, flags);
+	sample = &lat->ring[lat->samples % HW_FENCE_LATENCY_RING_SIZE];
+	sample->hash = payload->hash;
+	sample->create_ts = create_ts;
+	sample->signal_ts = signal_ts;
+	sample->read_ts = read_ts;
+	lat->samples++;
+
+	if (signal_ts && read_ts >= signal_ts)
+		lat->hist[HW_FENCE_LAT_SIGNAL_TO_READ][_hw_fence_latency_bin(read_ts - signal_ts)]++;
+	if (create_ts && signal_ts >= create_ts)
+		lat->hist[HW_FENCE_LAT_CREATE_TO_SIGNAL][_hw_fence_latency_bin(signal_ts -
+			create_ts)]++;
+	if (create_ts && read_ts >= create_ts)
+		lat->hist[HW_FENCE_LAT_CREATE_TO_READ][_hw_fence_latency_bin(read_ts - create_ts)]++;
+	spin_unlock_irqrestore(&lat->lock, flags);
+}
+
+int hw_fence_read_queue(struct hw_fence_driver_data *drv_data,
+		 struct msm_hw_fence_client *hw_fence_client,
 		 struct msm_hw_fence_queue_payload *payload, int queue_type)
 {
 	struct msm_hw_fence_hfi_queue_header *hfi_header;
@@ -158,7 +213,7 @@ int hw_fence_read_queue(struct msm_hw_fence_client *hw_fence_client,
 	u32 q_size_u32;
 	struct msm_hw_fence_queue_payload *read_ptr_payload;
 
-	if (queue_type >= HW_FENCE_CLIENT_QUEUES || !hw_fence_client || !payload) {
+	if (queue_type >= HW_FENCE_CLIENT_QUEUES || !drv_data || !hw_fence_client || !payload) {
 		HWFNC_ERR("Invalid queue type:%s hw_fence_client:0x%pK payload:0x%pK\n", queue_type,
 			hw_fence_client, payload);
 		return -EINVAL;
@@ -216,6 +271,8 @@ int hw_fence_read_queue(struct msm_hw_fence_client *hw_fence_client,
 	payload->flags = readq_relaxed(&read_ptr_payload->flags);
 	payload->client_data = readq_relaxed(&read_ptr_payload->client_data);
 	payload->error = readl_relaxed(&read_ptr_payload->error);
+	payload->timestamp_lo = readl_relaxed(&read_ptr_payload->timestamp_lo);
+	payload->timestamp_hi = readl_relaxed(&read_ptr_payload->timestamp_hi);
 
 	/* update the read index */
 	writel_relaxed(to_read_idx, &hfi_header->read_index);
@@ -223,17 +280,20 @@ int hw_fence_read_queue(struct msm_hw_fence_client *hw_fence_client,
 	/* update memory for the index */
 	wmb();
 
+	_hw_fence_latency_record(drv_data, hw_fence_client, payload);
+
 	/* Return one if queue still has contents after read */
 	return to_read_idx == write_idx ? 0 : 1;
 }
 
 /*
- * This function writes to the queue of the client. The 'queue_type' determines
- * if this function is writing to the rx or tx queue
+ * This function writes 'count' payloads to the queue of the client with a single update of the
+ * queue write index. The 'queue_type' determines if this function is writing to the rx or tx
+ * queue. If the queue cannot fit all the payloads, only the ones that fit are written.
  */
-int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
-	struct msm_hw_fence_client *hw_fence_client, u64 ctxt_id, u64 seqno, u64 hash,
-	u64 flags, u64 client_data, u32 error, int queue_type)
+int hw_fence_update_queue_batch(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client,
+	struct msm_hw_fence_queue_payload *payloads, u32 count, int queue_type)
 {
 	struct msm_hw_fence_hfi_queue_header *hfi_header;
 	struct msm_hw_fence_queue *queue;
@@ -245,10 +305,12 @@ int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
 	u32 *q_payload_write_ptr;
 	u32 payload_size, payload_size_u32;
 	struct msm_hw_fence_queue_payload *write_ptr_payload;
+	struct msm_hw_fence_queue_payload *payload;
 	bool lock_client = false;
 	u32 lock_idx;
 	u64 timestamp;
 	u32 *wr_ptr;
+	u32 i, fit;
 	int ret = 0;
 
 	if (queue_type >=
@@ -258,6 +320,9 @@ int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
 		return -EINVAL;
 	}
 
+	if (!payloads || !count)
+		return 0;
+
 	queue = &hw_fence_client->queues[queue_type];
 	hfi_header = queue->va_header;
 
@@ -308,58 +373,71 @@ int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
 		read_idx, write_idx, queue, queue_type,
 		hw_fence_client->skip_txq_wr_idx ? "true" : "false");
 
-	/* Check queue to make sure message will fit */
+	/* Check queue to make sure messages will fit */
 	q_free_u32 = read_idx <= write_idx ? (q_size_u32 - (write_idx - read_idx)) :
 		(read_idx - write_idx);
-	if (q_free_u32 <= payload_size_u32) {
-		HWFNC_ERR("cannot fit the message size:%d\n", payload_size_u32);
+	fit = q_free_u32 ? (q_free_u32 - 1) / payload_size_u32 : 0;
+	if (fit < count) {
+		HWFNC_ERR("cannot fit %u messages size:%d, free:%d\n", count - fit,
+			payload_size_u32, q_free_u32);
 		ret = -EINVAL;
-		goto exit;
+		count = fit;
+		if (!count)
+			goto exit;
 	}
-	HWFNC_DBG_Q("q_free_u32:%d payload_size_u32:%d\n", q_free_u32, payload_size_u32);
+	HWFNC_DBG_Q("q_free_u32:%d payload_size_u32:%d count:%u\n", q_free_u32, payload_size_u32,
+		count);
 
-	/* Move the pointer where we need to write and cast it */
-	q_payload_write_ptr = ((u32 *)queue->va_queue + write_idx);
-	write_ptr_payload = (struct msm_hw_fence_queue_payload *)q_payload_write_ptr;
-	HWFNC_DBG_Q("q_payload_write_ptr:0x%pK queue: va=0x%pK pa=0x%pK write_ptr_payload:0x%pK\n",
-		q_payload_write_ptr, queue->va_queue, queue->pa_queue, write_ptr_payload);
+	timestamp = hw_fence_get_qtime(drv_data);
 
-	/* calculate the index after the write */
-	to_write_idx = write_idx + payload_size_u32;
+	for (i = 0; i < count; i++) {
+		payload = &payloads[i];
 
-	HWFNC_DBG_Q("to_write_idx:%d write_idx:%d payload_size\n", to_write_idx, write_idx,
-		payload_size_u32);
-	HWFNC_DBG_L("client_id:%d update %s hash:%llu ctx_id:%llu seqno:%llu flags:%llu error:%u\n",
-		hw_fence_client->client_id, _get_queue_type(queue_type),
-		hash, ctxt_id, seqno, flags, error);
+		/* Move the pointer where we need to write and cast it */
+		q_payload_write_ptr = ((u32 *)queue->va_queue + write_idx);
+		write_ptr_payload = (struct msm_hw_fence_queue_payload *)q_payload_write_ptr;
+		HWFNC_DBG_Q("q_payload_write_ptr:0x%pK queue: va=0x%pK pa=0x%pK write_ptr_payload:0x%pK\n",
+			q_payload_write_ptr, queue->va_queue, queue->pa_queue, write_ptr_payload);
 
-	/*
-	 * wrap-around case, here we are writing to the last element of the queue, therefore
-	 * set to_write_idx, which is the index after the write, to the beginning of the
-	 * queue
-	 */
-	if (to_write_idx >= q_size_u32)
-		to_write_idx = 0;
-
-	/* Update Client Queue */
-	writeq_relaxed(payload_size, &write_ptr_payload->size);
-	writew_relaxed(HW_FENCE_PAYLOAD_TYPE_1, &write_ptr_payload->type);
-	writew_relaxed(HW_FENCE_PAYLOAD_REV(1, 0), &write_ptr_payload->version);
-	writeq_relaxed(ctxt_id, &write_ptr_payload->ctxt_id);
-	writeq_relaxed(seqno, &write_ptr_payload->seqno);
-	writeq_relaxed(hash, &write_ptr_payload->hash);
-	writeq_relaxed(flags, &write_ptr_payload->flags);
-	writeq_relaxed(client_data, &write_ptr_payload->client_data);
-	writel_relaxed(error, &write_ptr_payload->error);
-	timestamp = hw_fence_get_qtime(drv_data);
-	writel_relaxed(timestamp, &write_ptr_payload->timestamp_lo);
-	writel_relaxed(timestamp >> 32, &write_ptr_payload->timestamp_hi);
+		/* calculate the index after the write */
+		to_write_idx = write_idx + payload_size_u32;
+
+		HWFNC_DBG_Q("to_write_idx:%d write_idx:%d payload_size\n", to_write_idx, write_idx,
+			payload_size_u32);
+		HWFNC_DBG_L("client_id:%d update %s hash:%llu ctx_id:%llu seqno:%llu flags:%llu error:%u\n",
+			hw_fence_client->client_id, _get_queue_type(queue_type),
+			payload->hash, payload->ctxt_id, payload->seqno, payload->flags,
+			payload->error);
+
+		/*
+		 * wrap-around case, here we are writing to the last element of the queue, therefore
+		 * set to_write_idx, which is the index after the write, to the beginning of the
+		 * queue
+		 */
+		if (to_write_idx >= q_size_u32)
+			to_write_idx = 0;
+
+		/* Update Client Queue */
+		writeq_relaxed(payload_size, &write_ptr_payload->size);
+		writew_relaxed(HW_FENCE_PAYLOAD_TYPE_1, &write_ptr_payload->type);
+		writew_relaxed(HW_FENCE_PAYLOAD_REV(1, 0), &write_ptr_payload->version);
+		writeq_relaxed(payload->ctxt_id, &write_ptr_payload->ctxt_id);
+		writeq_relaxed(payload->seqno, &write_ptr_payload->seqno);
+		writeq_relaxed(payload->hash, &write_ptr_payload->hash);
+		writeq_relaxed(payload->flags, &write_ptr_payload->flags);
+		writeq_relaxed(payload->client_data, &write_ptr_payload->client_data);
+		writel_relaxed(payload->error, &write_ptr_payload->error);
+		writel_relaxed(timestamp, &write_ptr_payload->timestamp_lo);
+		writel_relaxed(timestamp >> 32, &write_ptr_payload->timestamp_hi);
+
+		write_idx = to_write_idx;
+	}
 
-	/* update memory for the message */
+	/* update memory for the messages */
 	wmb();
 
 	/* update the write index */
-	writel_relaxed(to_write_idx, wr_ptr);
+	writel_relaxed(write_idx, wr_ptr);
 
 	/* update memory for the index */
 	wmb();
@@ -371,6 +449,26 @@ exit:
 	return ret;
 }
 
+/*
+ * This function writes to the queue of the client. The 'queue_type' determines
+ * if this function is writing to the rx or tx queue
+ */
+int hw_fence_update_queue(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client, u64 ctxt_id, u64 seqno, u64 hash,
+	u64 flags, u64 client_data, u32 error, int queue_type)
+{
+	struct msm_hw_fence_queue_payload payload = {
+		.ctxt_id = ctxt_id,
+		.seqno = seqno,
+		.hash = hash,
+		.flags = flags,
+		.client_data = client_data,
+		.error = error,
+	};
+
+	return hw_fence_update_queue_batch(drv_data, hw_fence_client, &payload, 1, queue_type);
+}
+
 static int init_global_locks(struct hw_fence_driver_data *drv_data)
 {
 	struct msm_hw_fence_mem_addr *mem_descriptor;
@@ -401,6 +499,40 @@ static int init_global_locks(struct hw_fence_driver_data *drv_data)
 	return 0;
 }
 
+static inline u8 _hw_fence_tag(u64 context, u64 seqno)
+{
+	/* top seven bits of a mix of ctx and seqno, msb set so a used tag is never zero */
+	return (u8)(((context * 0x9E3779B97F4A7C15ULL) ^ (seqno * 0xC2B2AE3D27D4EB4FULL)) >> 57)
+		| 0x80;
+}
+
+static int init_hw_fences_tags(struct hw_fence_driver_data *drv_data)
+{
+	struct msm_hw_fence *hw_fence;
+	u32 i, used = 0;
+
+	drv_data->hw_fences_tags = devm_kcalloc(drv_data->dev, drv_data->hw_fence_table_entries,
+		sizeof(u8), GFP_KERNEL);
+	if (!drv_data->hw_fences_tags)
+		return -ENOMEM;
+
+	/* table memory can be inherited from a previous boot stage, sync tags with it */
+	for (i = 0; i < drv_data->hw_fence_table_entries && i < drv_data->hw_fences_tbl_cnt; i++) {
+		hw_fence = &drv_data->hw_fences_tbl[i];
+		if (!hw_fence->valid)
+			continue;
+		drv_data->hw_fences_tags[i] = _hw_fence_tag(hw_fence->ctx_id, hw_fence->seq_id);
+		used++;
+	}
+
+	/* probe distance of inherited entries is unknown, lookups must scan the whole table */
+	atomic_set(&drv_data->hw_fences_max_probe,
+		used ? drv_data->hw_fence_table_entries - 1 : 0);
+	atomic_set(&drv_data->hw_fences_used, used);
+
+	return 0;
+}
+
 static int init_hw_fences_table(struct hw_fence_driver_data *drv_data)
 {
 	struct msm_hw_fence_mem_addr *mem_descriptor;
@@ -432,7 +564,7 @@ static int init_hw_fences_table(struct hw_fence_driver_data *drv_data)
 	HWFNC_DBG_INIT("hw_fences_table:0x%pK cnt:%u\n", drv_data->hw_fences_tbl,
 		drv_data->hw_fences_tbl_cnt);
 
-	return 0;
+	return init_hw_fences_tags(drv_data);
 }
 
 static int init_ctrl_queue(struct hw_fence_driver_data *drv_data)
@@ -775,6 +907,7 @@ static void  _reserve_hw_fence(struct hw_fence_driver_data *drv_data,
 	hw_fence->fence_allocator = client_id;
 	hw_fence->fence_create_time = hw_fence_get_qtime(drv_data);
 	hw_fence->debug_refcount++;
+	drv_data->hw_fences_tags[hash] = _hw_fence_tag(context, seqno);
 
 	HWFNC_DBG_LUT("Reserved fence client:%d ctx:%llu seq:%llu hash:%llu\n",
 		client_id, context, seqno, hash);
@@ -789,6 +922,7 @@ static void  _unreserve_hw_fence(struct hw_fence_driver_data *drv_data,
 
 	/* unreserve this HW fence */
 	hw_fence->valid = 0;
+	drv_data->hw_fences_tags[hash] = 0;
 
 	HWFNC_DBG_LUT("Unreserved fence client:%d ctx:%llu seq:%llu hash:%llu\n",
 		client_id, context, seqno, hash);
@@ -811,6 +945,7 @@ static void  _reserve_join_fence(struct hw_fence_driver_data *drv_data,
 	hw_fence->debug_refcount++;
 
 	hw_fence->pending_child_cnt = pending_child_cnt;
+	drv_data->hw_fences_tags[hash] = _hw_fence_tag(context, seqno);
 
 	HWFNC_DBG_LUT("Reserved join fence client:%d ctx:%llu seq:%llu hash:%llu\n",
 		client_id, context, seqno, hash);
@@ -830,6 +965,66 @@ static void  _fence_found(struct hw_fence_driver_data *drv_data,
 		client_id, context, seqno, hash);
 }
 
+#define HW_FENCE_TAG_ONES	0x0101010101010101ULL
+#define HW_FENCE_TAG_HIGHS	0x8080808080808080ULL
+
+/* returns a mask with the msb set in the lowest byte of 'v' equal to 'tag' */
+static inline u64 _hw_fence_tag_match_mask(u64 v, u8 tag)
+{
+	u64 x = v ^ (HW_FENCE_TAG_ONES * tag);
+
+	return (x - HW_FENCE_TAG_ONES) & ~x & HW_FENCE_TAG_HIGHS;
+}
+
+/*
+ * Returns the first probe step in [step, max_steps) whose table entry has a tag equal to 'tag',
+ * or a free tag if 'want_free' is set; max_steps if there is none. Tags are compared eight at a
+ * time, the lowest byte of each group is exact, so the caller only locks actual candidates.
+ * Tags are a hint, the caller must still validate the entry with the hw fence lock held.
+ */
+static u64 _hw_fence_tag_scan(struct hw_fence_driver_data *drv_data, u64 start, u64 step,
+	u64 max_steps, u8 tag, bool want_free)
+{
+	u32 entries = drv_data->hw_fence_table_entries;
+	u8 *tags = drv_data->hw_fences_tags;
+	u64 idx, v, m;
+
+	while (step < max_steps) {
+		idx = (start + step) % entries;
+		if (idx + sizeof(u64) <= entries && step + sizeof(u64) <= max_steps) {
+			v = get_unaligned_le64(&tags[idx]);
+			m = _hw_fence_tag_match_mask(v, tag);
+			if (want_free)
+				m |= _hw_fence_tag_match_mask(v, 0);
+			if (m)
+				return step + (__ffs64(m) >> 3);
+			step += sizeof(u64);
+		} else {
+			if (tags[idx] == tag || (want_free && !tags[idx]))
+				return step;
+			step++;
+		}
+	}
+
+	return max_steps;
+}
+
+static void _hw_fence_update_probe_stats(struct hw_fence_driver_data *drv_data, u64 step)
+{
+	int max = atomic_read(&drv_data->hw_fences_max_probe);
+	int old;
+
+	while (step > max) {
+		old = atomic_cmpxchg(&drv_data->hw_fences_max_probe, max, step);
+		if (old == max)
+			break;
+		max = old;
+	}
+
+	atomic_inc(&drv_data->hw_fences_probe_hist[min_t(u32, fls64(step),
+		HW_FENCE_PROBE_HIST_BINS - 1)]);
+}
+
 char *_get_op_mode(enum hw_fence_lookup_ops op_code)
 {
 	switch (op_code) {
@@ -856,9 +1051,11 @@ struct msm_hw_fence *_hw_fence_lookup_and_process(struct hw_fence_driver_data *d
 	void (*process_fnc)(struct hw_fence_driver_data *drv_data, struct msm_hw_fence *hfence,
 			u32 client_id, u64 context, u64 seqno, u32 hash, u32 pending);
 	struct msm_hw_fence *hw_fence = NULL;
-	u64 step = 0;
+	u64 step = 0, start = 0, max_steps;
 	int ret = 0;
 	bool hw_fence_found = false;
+	bool create = false;
+	u8 tag;
 
 	if (!hash | !drv_data | !hw_fences_tbl) {
 		HWFNC_ERR("Invalid input for hw_fence_lookup\n");
@@ -891,15 +1088,35 @@ struct msm_hw_fence *_hw_fence_lookup_and_process(struct hw_fence_driver_data *d
 		return NULL;
 	}
 
-	while (!hw_fence_found && (step < drv_data->hw_fence_table_entries)) {
+	create = (op_code == HW_FENCE_LOOKUP_OP_CREATE ||
+		op_code == HW_FENCE_LOOKUP_OP_CREATE_JOIN);
+	tag = _hw_fence_tag(context, seqno);
+
+	/* existing fences were placed at most max_probe steps away from their home entry */
+	max_steps = drv_data->hw_fence_table_entries;
+	if (!create)
+		max_steps = min_t(u64, max_steps,
+			(u64)atomic_read(&drv_data->hw_fences_max_probe) + 1);
+
+	while (!hw_fence_found && (step < max_steps)) {
 
 		/* Calculate the Hash for the Fence */
-		ret = _calculate_hash(drv_data->hw_fence_table_entries, context, seqno, step, hash);
-		if (ret) {
-			HWFNC_ERR("error calculating hash ctx:%llu seqno:%llu hash:%llu\n",
-				context, seqno, *hash);
-			break;
+		if (step == 0) {
+			ret = _calculate_hash(drv_data->hw_fence_table_entries, context, seqno, 0,
+				hash);
+			if (ret) {
+				HWFNC_ERR("error calculating hash ctx:%llu seqno:%llu hash:%llu\n",
+					context, seqno, *hash);
+				break;
+			}
+			start = *hash;
 		}
+
+		/* skip all entries whose tag rules them out without taking their lock */
+		step = _hw_fence_tag_scan(drv_data, start, step, max_steps, tag, create);
+		if (step >= max_steps)
+			break;
+		*hash = (start + step) % drv_data->hw_fence_table_entries;
 		HWFNC_DBG_LUT("calculated hash:%llu [ctx:%llu seqno:%llu]\n", *hash, context,
 			seqno);
 
@@ -918,6 +1135,10 @@ struct msm_hw_fence *_hw_fence_lookup_and_process(struct hw_fence_driver_data *d
 		/* compare to either find a free fence or find an allocated fence */
 		if (compare_fnc(hw_fence, context, seqno)) {
 
+			/* publish the probe distance before the new fence can be looked up */
+			if (create)
+				_hw_fence_update_probe_stats(drv_data, step);
+
 			/* Process the hw fence found by the algorithm */
 			if (process_fnc) {
 				process_fnc(drv_data, hw_fence, client_id, context, seqno, *hash,
@@ -932,9 +1153,7 @@ struct msm_hw_fence *_hw_fence_lookup_and_process(struct hw_fence_driver_data *d
 
 			hw_fence_found = true;
 		} else {
-			if ((op_code == HW_FENCE_LOOKUP_OP_CREATE ||
-				op_code == HW_FENCE_LOOKUP_OP_CREATE_JOIN) &&
-				seqno == hw_fence->seq_id && context == hw_fence->ctx_id) {
+			if (create && seqno == hw_fence->seq_id && context == hw_fence->ctx_id) {
 				/* ctx & seqno must be unique creating a hw-fence */
 				HWFNC_ERR("cannot create hw fence with same ctx:%llu seqno:%llu\n",
 					context, seqno);
@@ -954,8 +1173,12 @@ struct msm_hw_fence *_hw_fence_lookup_and_process(struct hw_fence_driver_data *d
 
 	/* If we iterated through the whole list and didn't find the fence, return null */
 	if (!hw_fence_found) {
-		HWFNC_ERR("fail to create hw-fence step:%llu\n", step);
+		HWFNC_ERR("fail to %s hw-fence step:%llu\n", _get_op_mode(op_code), step);
 		hw_fence = NULL;
+	} else if (create) {
+		atomic_inc(&drv_data->hw_fences_used);
+	} else if (op_code == HW_FENCE_LOOKUP_OP_DESTROY) {
+		atomic_dec(&drv_data->hw_fences_used);
 	}
 
 	HWFNC_DBG_LUT("lookup:%d hw_fence:%pK ctx:%llu seqno:%llu hash:%llu flags:0x%llx\n",
@@ -1105,6 +1328,97 @@ struct msm_hw_fence *msm_hw_fence_find(struct hw_fence_driver_data *drv_data,
 	return hw_fence;
 }
 
+static inline bool _is_validation_client(struct msm_hw_fence_client *hw_fence_client)
+{
+	return hw_fence_client->client_id >= HW_FENCE_CLIENT_ID_VAL0 &&
+		hw_fence_client->client_id <= HW_FENCE_CLIENT_ID_VAL6;
+}
+
+void hw_fence_signal_batch_init(struct hw_fence_signal_batch *batch)
+{
+	batch->rxq_client = NULL;
+	batch->count = 0;
+	batch->db_mask = 0;
+	batch->val_mask = 0;
+}
+
+static void _signal_batch_flush_rxq(struct hw_fence_driver_data *drv_data,
+	struct hw_fence_signal_batch *batch)
+{
+	if (batch->rxq_client && batch->count)
+		hw_fence_update_queue_batch(drv_data, batch->rxq_client, batch->payloads,
+			batch->count, HW_FENCE_RX_QUEUE - 1);
+
+	batch->rxq_client = NULL;
+	batch->count = 0;
+}
+
+/*
+ * Writes the buffered rx queue payloads and then sends a single ipcc doorbell to each of the
+ * clients signaled through this batch. Must be called before the batch goes out of scope.
+ */
+void hw_fence_signal_batch_flush(struct hw_fence_driver_data *drv_data,
+	struct hw_fence_signal_batch *batch)
+{
+	u32 tx_client_id = drv_data->ipcc_client_pid; /* phys id for tx client */
+	struct msm_hw_fence_client *hw_fence_client;
+	u64 mask;
+	int client_id;
+
+	_signal_batch_flush_rxq(drv_data, batch);
+
+	for (mask = batch->db_mask; mask; mask &= mask - 1) {
+		client_id = __ffs64(mask);
+		hw_fence_client = client_id < drv_data->clients_num ?
+			drv_data->clients[client_id] : NULL;
+		if (!hw_fence_client)
+			continue;
+
+		/* Signal the hw fences now */
+		hw_fence_ipcc_trigger_signal(drv_data, tx_client_id,
+			hw_fence_client->ipc_client_vid, hw_fence_client->ipc_signal_id);
+	}
+
+#if IS_ENABLED(CONFIG_DEBUG_FS)
+	for (mask = batch->val_mask; mask; mask &= mask - 1)
+		process_validation_client_loopback(drv_data, __ffs64(mask));
+#endif /* CONFIG_DEBUG_FS */
+
+	batch->db_mask = 0;
+	batch->val_mask = 0;
+}
+
+static void _fence_ctl_signal_batch(struct hw_fence_driver_data *drv_data,
+	struct hw_fence_signal_batch *batch, struct msm_hw_fence_client *hw_fence_client,
+	struct msm_hw_fence *hw_fence, u64 hash, u64 flags, u64 client_data, u32 error)
+{
+	struct msm_hw_fence_queue_payload *payload;
+
+	HWFNC_DBG_H("Batch signal for client:%d hfence hash:%llu\n", hw_fence_client->client_id,
+		hash);
+
+	if (hw_fence_client->update_rxq) {
+		if (batch->rxq_client != hw_fence_client ||
+				batch->count >= HW_FENCE_SIGNAL_BATCH_MAX)
+			_signal_batch_flush_rxq(drv_data, batch);
+
+		batch->rxq_client = hw_fence_client;
+		payload = &batch->payloads[batch->count++];
+		payload->ctxt_id = hw_fence->ctx_id;
+		payload->seqno = hw_fence->seq_id;
+		payload->hash = hash;
+		payload->flags = flags;
+		payload->client_data = client_data;
+		payload->error = error;
+	}
+
+	if (hw_fence_client->send_ipc)
+		batch->db_mask |= BIT_ULL(hw_fence_client->client_id);
+
+	if (_is_validation_client(hw_fence_client))
+		batch->val_mask |= BIT_ULL(hw_fence_client->client_id);
+}
+
 static void _fence_ctl_signal(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, struct msm_hw_fence *hw_fence, u64 hash,
 	u64 flags, u64 client_data, u32 error)
@@ -1125,37 +1439,39 @@ static void _fence_ctl_signal(struct hw_fence_driver_data *drv_data,
 			hw_fence_client->ipc_signal_id);
 
 #if IS_ENABLED(CONFIG_DEBUG_FS)
-	if (hw_fence_client->client_id >= HW_FENCE_CLIENT_ID_VAL0
-			&& hw_fence_client->client_id <= HW_FENCE_CLIENT_ID_VAL6)
+	if (_is_validation_client(hw_fence_client))
 		process_validation_client_loopback(drv_data, hw_fence_client->client_id);
 #endif /* CONFIG_DEBUG_FS */
 }
 
+static inline void _fence_ctl_signal_or_batch(struct hw_fence_driver_data *drv_data,
+	struct hw_fence_signal_batch *batch, struct msm_hw_fence_client *hw_fence_client,
+	struct msm_hw_fence *hw_fence, u64 hash, u64 flags, u64 client_data, u32 error)
+{
+	if (batch)
+		_fence_ctl_signal_batch(drv_data, batch, hw_fence_client, hw_fence, hash, flags,
+			client_data, error);
+	else
+		_fence_ctl_signal(drv_data, hw_fence_client, hw_fence, hash, flags, client_data,
+			error);
+}
+
+/* unlink the children flagged in 'linked' from the parent join-fence */
 static void _cleanup_join_and_child_fences(struct hw_fence_driver_data *drv_data,
-	struct msm_hw_fence_client *hw_fence_client, int iteration, struct dma_fence_array *array,
-	struct msm_hw_fence *join_fence, u64 hash_join_fence)
+	struct msm_hw_fence_client *hw_fence_client, struct dma_fence_array *array,
+	struct hw_fence_join_state *join, u64 hash_join_fence)
 {
-	struct dma_fence *child_fence;
 	struct msm_hw_fence *hw_fence_child;
-	int idx, j;
-	u64 hash = 0;
-
-	if (!array->fences)
-		goto destroy_fence;
+	u32 idx;
+	int j;
 
 	/* cleanup the child-fences from the parent join-fence */
-	for (idx = iteration; idx >= 0; idx--) {
-		child_fence = array->fences[idx];
-		if (!child_fence) {
-			HWFNC_ERR("invalid child fence idx:%d\n", idx);
-			continue;
-		}
-
-		hw_fence_child = msm_hw_fence_find(drv_data, hw_fence_client, child_fence->context,
-			child_fence->seqno, &hash);
+	for_each_set_bit(idx, join->linked, join->num) {
+		hw_fence_child = _get_hw_fence(drv_data->hw_fence_table_entries,
+			drv_data->hw_fences_tbl, join->child_hash[idx]);
 		if (!hw_fence_child) {
-			HWFNC_ERR("Cannot cleanup child fence context:%lu seqno:%lu hash:%lu\n",
-				child_fence->context, child_fence->seqno, hash);
+			HWFNC_ERR("Cannot cleanup child fence idx:%u hash:%llu\n", idx,
+				join->child_hash[idx]);
 
 			/*
 			 * ideally this should not have happened, but if it did, try to keep
@@ -1188,114 +1504,101 @@ static void _cleanup_join_and_child_fences(struct hw_fence_driver_data *drv_data
 		GLOBAL_ATOMIC_STORE(drv_data, &hw_fence_child->lock, 0); /* unlock */
 	}
 
-destroy_fence:
 	/* destroy join fence */
 	_hw_fence_process_join_fence(drv_data, hw_fence_client, array, &hash_join_fence,
 		false);
 }
 
-int hw_fence_process_fence_array(struct hw_fence_driver_data *drv_data,
-	struct msm_hw_fence_client *hw_fence_client, struct dma_fence_array *array,
-	u64 *hash_join_fence, u64 client_data)
+static int _hw_fence_join_state_init(struct hw_fence_join_state *join, u32 num)
 {
-	struct msm_hw_fence *join_fence;
-	struct msm_hw_fence *hw_fence_child;
-	struct dma_fence *child_fence;
-	bool signal_join_fence = false;
-	u64 hash;
-	int i, ret = 0;
-	enum hw_fence_client_data_id data_id;
+	join->num = num;
+	join->signaled = 0;
 
-	if (client_data) {
-		data_id = hw_fence_get_client_data_id(hw_fence_client->client_id);
-		if (data_id >= HW_FENCE_MAX_CLIENTS_WITH_DATA) {
-			HWFNC_ERR("Populating non-zero client_data:%llu with invalid client:%d\n",
-				client_data, hw_fence_client->client_id);
-			return -EINVAL;
-		}
+	if (num <= HW_FENCE_JOIN_INLINE_CHILDREN) {
+		join->child_hash = join->inline_hash;
+		join->linked = join->inline_linked;
+		bitmap_zero(join->linked, num);
+		return 0;
 	}
 
-	/*
-	 * Create join fence from the join-fences table,
-	 * This function initializes:
-	 * join_fence->pending_child_count = array->num_fences
-	 */
-	join_fence = _hw_fence_process_join_fence(drv_data, hw_fence_client, array,
-		hash_join_fence, true);
-	if (!join_fence) {
-		HWFNC_ERR("cannot alloc hw fence for join fence array\n");
-		return -EINVAL;
+	join->child_hash = kcalloc(num, sizeof(*join->child_hash), GFP_KERNEL);
+	join->linked = bitmap_zalloc(num, GFP_KERNEL);
+	if (!join->child_hash || !join->linked) {
+		kfree(join->child_hash);
+		bitmap_free(join->linked);
+		return -ENOMEM;
 	}
 
-	/* update this as waiting client of the join-fence */
-	GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 1); /* lock */
-	join_fence->wait_client_mask |= BIT(hw_fence_client->client_id);
-	GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 0); /* unlock */
+	return 0;
+}
 
-	/* Iterate through fences of the array */
-	for (i = 0; i < array->num_fences; i++) {
+static void _hw_fence_join_state_release(struct hw_fence_join_state *join)
+{
+	if (join->child_hash == join->inline_hash)
+		return;
+
+	kfree(join->child_hash);
+	bitmap_free(join->linked);
+}
+
+/*
+ * Links all the children of the fence-array to the join-fence in a single pass. Children that
+ * are already signaled are only counted, so the join-fence is locked once for all of them
+ * instead of once per child.
+ */
+static int _hw_fence_join_link_children(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client, struct dma_fence_array *array,
+	struct hw_fence_join_state *join, u64 hash_join_fence)
+{
+	struct msm_hw_fence *hw_fence_child;
+	struct dma_fence *child_fence;
+	u32 i;
+
+	for (i = 0; i < join->num; i++) {
 		child_fence = array->fences[i];
 
 		/* Nested fence-arrays are not supported */
 		if (to_dma_fence_array(child_fence)) {
 			HWFNC_ERR("This is a nested fence, fail!\n");
-			ret = -EINVAL;
-			goto error_array;
+			return -EINVAL;
 		}
 
 		/* All elements in the fence-array must be hw-fences */
 		if (!test_bit(MSM_HW_FENCE_FLAG_ENABLED_BIT, &child_fence->flags)) {
 			HWFNC_ERR("DMA Fence in FenceArray is not a HW Fence\n");
-			ret = -EINVAL;
-			goto error_array;
+			return -EINVAL;
 		}
 
 		/* Find the HW Fence in the Global Table */
 		hw_fence_child = msm_hw_fence_find(drv_data, hw_fence_client, child_fence->context,
-			child_fence->seqno, &hash);
+			child_fence->seqno, &join->child_hash[i]);
 		if (!hw_fence_child) {
 			HWFNC_ERR("Cannot find child fence context:%lu seqno:%lu hash:%lu\n",
-				child_fence->context, child_fence->seqno, hash);
-			ret = -EINVAL;
-			goto error_array;
+				child_fence->context, child_fence->seqno, join->child_hash[i]);
+			return -EINVAL;
 		}
 
 		GLOBAL_ATOMIC_STORE(drv_data, &hw_fence_child->lock, 1); /* lock */
 		if (hw_fence_child->flags & MSM_HW_FENCE_FLAG_SIGNAL) {
 
-			/* child fence is already signaled */
-			GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 1); /* lock */
-			if (--join_fence->pending_child_cnt == 0)
-				signal_join_fence = true;
-
-			/* update memory for the table update */
-			wmb();
-
-			GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 0); /* unlock */
+			/* child fence is already signaled, account for it once all are linked */
+			join->signaled++;
 		} else {
 
 			/* child fence is not signaled */
-			hw_fence_child->parents_cnt++;
-
-			if (hw_fence_child->parents_cnt >= MSM_HW_FENCE_MAX_JOIN_PARENTS
-					|| hw_fence_child->parents_cnt < 1) {
+			if (hw_fence_child->parents_cnt + 1 >= MSM_HW_FENCE_MAX_JOIN_PARENTS) {
 
 				/* Max number of parents for a fence is exceeded */
 				HWFNC_ERR("DMA Fence in FenceArray exceeds parents:%d\n",
-					hw_fence_child->parents_cnt);
-				hw_fence_child->parents_cnt--;
-
-				/* update memory for the table update */
-				wmb();
+					hw_fence_child->parents_cnt + 1);
 
 				/* unlock */
 				GLOBAL_ATOMIC_STORE(drv_data, &hw_fence_child->lock, 0);
-				ret = -EINVAL;
-				goto error_array;
+				return -EINVAL;
 			}
 
-			hw_fence_child->parent_list[hw_fence_child->parents_cnt - 1] =
-				*hash_join_fence;
+			hw_fence_child->parent_list[hw_fence_child->parents_cnt++] = hash_join_fence;
+			set_bit(i, join->linked);
 
 			/* update memory for the table update */
 			wmb();
@@ -1303,15 +1606,96 @@ int hw_fence_process_fence_array(struct hw_fence_driver_data *drv_data,
 		GLOBAL_ATOMIC_STORE(drv_data, &hw_fence_child->lock, 0); /* unlock */
 	}
 
+	return 0;
+}
+
+int hw_fence_process_fence_array(struct hw_fence_driver_data *drv_data,
+	struct msm_hw_fence_client *hw_fence_client, struct dma_fence_array *array,
+	u64 *hash_join_fence, u64 client_data, struct hw_fence_signal_batch *batch)
+{
+	struct hw_fence_join_state join;
+	struct msm_hw_fence *join_fence;
+	bool signal_join_fence = false;
+	int ret = 0;
+	enum hw_fence_client_data_id data_id;
+
+	if (client_data) {
+		data_id = hw_fence_get_client_data_id(hw_fence_client->client_id);
+		if (data_id >= HW_FENCE_MAX_CLIENTS_WITH_DATA) {
+			HWFNC_ERR("Populating non-zero client_data:%llu with invalid client:%d\n",
+				client_data, hw_fence_client->client_id);
+			return -EINVAL;
+		}
+	}
+
+	if (!array->num_fences || !array->fences) {
+		/*
+		 * if the number of fences is not set in the fence-array, then fail here,
+		 * otherwise driver would create a join-fence with no-childs that won't be
+		 * signaled at all
+		 */
+		HWFNC_ERR("invalid fence-array ctx:%llu seqno:%llu without fences\n",
+			array->base.context, array->base.seqno);
+		return -EINVAL;
+	}
+
+	if (_hw_fence_join_state_init(&join, array->num_fences))
+		return -ENOMEM;
+
+	/*
+	 * Create join fence from the join-fences table,
+	 * This function initializes:
+	 * join_fence->pending_child_count = array->num_fences
+	 */
+	join_fence = _hw_fence_process_join_fence(drv_data, hw_fence_client, array,
+		hash_join_fence, true);
+	if (!join_fence) {
+		HWFNC_ERR("cannot alloc hw fence for join fence array\n");
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	/*
+	 * update this as waiting client of the join-fence, before any child is linked, since a
+	 * linked child can be signaled by the fence controller at any point from here
+	 */
+	GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 1); /* lock */
+	join_fence->wait_client_mask |= BIT(hw_fence_client->client_id);
 	if (client_data)
 		join_fence->client_data[data_id] = client_data;
+	wmb(); /* update memory for the table update */
+	GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 0); /* unlock */
+
+	ret = _hw_fence_join_link_children(drv_data, hw_fence_client, array, &join,
+		*hash_join_fence);
+	if (ret) {
+		_cleanup_join_and_child_fences(drv_data, hw_fence_client, array, &join,
+			*hash_join_fence);
+		goto exit;
+	}
+
+	/*
+	 * pending count still includes the already signaled children, so the fence controller
+	 * cannot reach zero before they are discounted here all at once
+	 */
+	if (join.signaled) {
+		GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 1); /* lock */
+		join_fence->pending_child_cnt -= min(join.signaled, join_fence->pending_child_cnt);
+		if (!join_fence->pending_child_cnt)
+			signal_join_fence = true;
+
+		/* update memory for the table update */
+		wmb();
+
+		GLOBAL_ATOMIC_STORE(drv_data, &join_fence->lock, 0); /* unlock */
+	}
 
 	/* all fences were signaled, signal client now */
 	if (signal_join_fence) {
 
 		/* signal the join hw fence */
-		_fence_ctl_signal(drv_data, hw_fence_client, join_fence, *hash_join_fence, 0, 0,
-			client_data);
+		_fence_ctl_signal_or_batch(drv_data, batch, hw_fence_client, join_fence,
+			*hash_join_fence, 0, 0, client_data);
 		set_bit(MSM_HW_FENCE_FLAG_SIGNALED_BIT, &array->base.flags);
 
 		/*
@@ -1321,29 +1705,17 @@ int hw_fence_process_fence_array(struct hw_fence_driver_data *drv_data,
 		 */
 		_hw_fence_process_join_fence(drv_data, hw_fence_client, array, hash_join_fence,
 			false);
-	} else if (!array->num_fences) {
-		/*
-		 * if we didn't signal the join-fence and the number of fences is not set in
-		 * the fence-array, then fail here, otherwise driver would create a join-fence
-		 * with no-childs that won't be signaled at all or an incomplete join-fence
-		 */
-		HWFNC_ERR("invalid fence-array ctx:%llu seqno:%llu without fences\n",
-			array->base.context, array->base.seqno);
-		goto error_array;
 	}
 
-	return ret;
-
-error_array:
-	_cleanup_join_and_child_fences(drv_data, hw_fence_client, i, array, join_fence,
-		*hash_join_fence);
+exit:
+	_hw_fence_join_state_release(&join);
 
-	return -EINVAL;
+	return ret;
 }
 
-int hw_fence_register_wait_client(struct hw_fence_driver_data *drv_data,
+int hw_fence_register_wait_client_batch(struct hw_fence_driver_data *drv_data,
 		struct dma_fence *fence, struct msm_hw_fence_client *hw_fence_client, u64 context,
-		u64 seqno, u64 *hash, u64 client_data)
+		u64 seqno, u64 *hash, u64 client_data, struct hw_fence_signal_batch *batch)
 {
 	struct msm_hw_fence *hw_fence;
 	enum hw_fence_client_data_id data_id;
@@ -1382,15 +1754,24 @@ int hw_fence_register_wait_client(struct hw_fence_driver_data *drv_data,
 	if (hw_fence->flags & MSM_HW_FENCE_FLAG_SIGNAL) {
 		if (fence != NULL)
 			set_bit(MSM_HW_FENCE_FLAG_SIGNALED_BIT, &fence->flags);
-		_fence_ctl_signal(drv_data, hw_fence_client, hw_fence, *hash, 0, client_data, 0);
+		_fence_ctl_signal_or_batch(drv_data, batch, hw_fence_client, hw_fence, *hash, 0,
+			client_data, 0);
 	}
 
 	return 0;
 }
 
+int hw_fence_register_wait_client(struct hw_fence_driver_data *drv_data,
+		struct dma_fence *fence, struct msm_hw_fence_client *hw_fence_client, u64 context,
+		u64 seqno, u64 *hash, u64 client_data)
+{
+	return hw_fence_register_wait_client_batch(drv_data, fence, hw_fence_client, context,
+		seqno, hash, client_data, NULL);
+}
+
 int hw_fence_process_fence(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client,
-	struct dma_fence *fence, u64 *hash, u64 client_data)
+	struct dma_fence *fence, u64 *hash, u64 client_data, struct hw_fence_signal_batch *batch)
 {
 	int ret = 0;
 
@@ -1404,8 +1785,8 @@ int hw_fence_process_fence(struct hw_fence_driver_data *drv_data,
 		return -EINVAL;
 	}
 
-	ret = hw_fence_register_wait_client(drv_data, fence, hw_fence_client, fence->context,
-		fence->seqno, hash, client_data);
+	ret = hw_fence_register_wait_client_batch(drv_data, fence, hw_fence_client,
+		fence->context, fence->seqno, hash, client_data, batch);
 	if (ret)
 		HWFNC_ERR("Error registering for wait client:%d\n", hw_fence_client->client_id);
 
@@ -1413,7 +1794,7 @@ int hw_fence_process_fence(struct hw_fence_driver_data *drv_data,
 }
 
 static void _signal_all_wait_clients(struct hw_fence_driver_data *drv_data,
-	struct msm_hw_fence *hw_fence, u64 hash, int error)
+	struct msm_hw_fence *hw_fence, u64 hash, int error, struct hw_fence_signal_batch *batch)
 {
 	enum hw_fence_client_id wait_client_id;
 	enum hw_fence_client_data_id data_id;
@@ -1430,8 +1811,8 @@ static void _signal_all_wait_clients(struct hw_fence_driver_data *drv_data,
 				client_data = hw_fence->client_data[data_id];
 
 			if (hw_fence_wait_client)
-				_fence_ctl_signal(drv_data, hw_fence_wait_client, hw_fence,
-					hash, 0, client_data, error);
+				_fence_ctl_signal_or_batch(drv_data, batch, hw_fence_wait_client,
+					hw_fence, hash, 0, client_data, error);
 		}
 	}
 }
@@ -1481,7 +1862,7 @@ void hw_fence_utils_reset_queues(struct hw_fence_driver_data *drv_data,
 
 int hw_fence_utils_cleanup_fence(struct hw_fence_driver_data *drv_data,
 	struct msm_hw_fence_client *hw_fence_client, struct msm_hw_fence *hw_fence, u64 hash,
-	u32 reset_flags)
+	u32 reset_flags, struct hw_fence_signal_batch *batch)
 {
 	int ret = 0;
 	int error = (reset_flags & MSM_HW_FENCE_RESET_WITHOUT_ERROR) ? 0 : MSM_HW_FENCE_ERROR_RESET;
@@ -1502,7 +1883,7 @@ int hw_fence_utils_cleanup_fence(struct hw_fence_driver_data *drv_data,
 
 		/* if fence is not signaled, signal with error all the waiting clients */
 		if (!(hw_fence->flags & MSM_HW_FENCE_FLAG_SIGNAL))
-			_signal_all_wait_clients(drv_data, hw_fence, hash, error);
+			_signal_all_wait_clients(drv_data, hw_fence, hash, error, batch);
 
 		if (reset_flags & MSM_HW_FENCE_RESET_WITHOUT_DESTROY)
 			goto skip_destroy;
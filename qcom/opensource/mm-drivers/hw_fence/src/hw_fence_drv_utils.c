@@ -212,8 +212,8 @@ static inline int _process_gfx_client_loopback(struct hw_fence_driver_data *drv_
 		 * 'client_id' is the loopback-client-id, not the hw-fence client_id,
 		 * so use GFX hw-fence client id, to get the client data
 		 */
-		read = hw_fence_read_queue(drv_data->clients[HW_FENCE_CLIENT_ID_CTX0], &payload,
-			queue_type);
+		read = hw_fence_read_queue(drv_data, drv_data->clients[HW_FENCE_CLIENT_ID_CTX0],
+			&payload, queue_type);
 		if (read < 0) {
 			HWFNC_ERR("unable to read gfx rxq\n");
 			break;
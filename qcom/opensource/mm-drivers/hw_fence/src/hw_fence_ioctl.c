@@ -14,6 +14,8 @@
 #include "hw_fence_drv_ipc.h"
 #include "hw_fence_drv_debug.h"
 
+extern struct hw_fence_driver_data *hw_fence_drv_data;
+
 #define HW_SYNC_IOCTL_COUNT		ARRAY_SIZE(hw_sync_debugfs_ioctls)
 #define HW_FENCE_ARRAY_SIZE		10
 #define HW_SYNC_IOC_MAGIC		'W'
@@ -596,7 +598,8 @@ static long hw_sync_ioctl_fence_wait(struct hw_sync_obj *obj, unsigned long arg)
 	atomic_set(&hw_fence_client->val_signal, 0);
 
 	while (read) {
-		read = hw_fence_read_queue(obj->client_handle, &payload, queue_type);
+		read = hw_fence_read_queue(hw_fence_drv_data, obj->client_handle, &payload,
+			queue_type);
 		if (read < 0) {
 			HWFNC_ERR("unable to read client rxq client_id:%d\n", obj->client_id);
 			break;
@@ -64,6 +64,7 @@ void *msm_hw_fence_register(enum hw_fence_client_id client_id_ext,
 
 	hw_fence_client->client_id = client_id;
 	hw_fence_client->client_id_ext = client_id_ext;
+	spin_lock_init(&hw_fence_client->latency.lock);
 	hw_fence_client->ipc_client_vid =
 		hw_fence_ipcc_get_client_virt_id(hw_fence_drv_data, client_id);
 	hw_fence_client->ipc_client_pid =
@@ -295,6 +296,7 @@ int msm_hw_fence_wait_update_v2(void *client_handle,
 	bool create)
 {
 	struct msm_hw_fence_client *hw_fence_client;
+	struct hw_fence_signal_batch batch;
 	struct dma_fence_array *array;
 	int i, ret = 0;
 	enum hw_fence_client_data_id data_id;
@@ -325,6 +327,9 @@ int msm_hw_fence_wait_update_v2(void *client_handle,
 
 	HWFNC_DBG_H("+\n");
 
+	/* already signaled fences are notified to the client all at once after the loop */
+	hw_fence_signal_batch_init(&batch);
+
 	/* Process all the list of fences */
 	for (i = 0; i < num_fences; i++) {
 		struct dma_fence *fence = fence_list[i];
@@ -337,18 +342,18 @@ int msm_hw_fence_wait_update_v2(void *client_handle,
 		array = to_dma_fence_array(fence);
 		if (array) {
 			ret = hw_fence_process_fence_array(hw_fence_drv_data, hw_fence_client,
-				array, &hash, client_data);
+				array, &hash, client_data, &batch);
 			if (ret) {
 				HWFNC_ERR("Failed to process FenceArray\n");
-				return ret;
+				goto exit;
 			}
 		} else {
 			/* Process individual Fence */
 			ret = hw_fence_process_fence(hw_fence_drv_data, hw_fence_client, fence,
-				&hash, client_data);
+				&hash, client_data, &batch);
 			if (ret) {
 				HWFNC_ERR("Failed to process Fence\n");
-				return ret;
+				goto exit;
 			}
 		}
 
@@ -358,7 +363,10 @@ int msm_hw_fence_wait_update_v2(void *client_handle,
 
 	HWFNC_DBG_H("-\n");
 
-	return 0;
+exit:
+	hw_fence_signal_batch_flush(hw_fence_drv_data, &batch);
+
+	return ret;
 }
 EXPORT_SYMBOL(msm_hw_fence_wait_update_v2);
 
@@ -373,6 +381,7 @@ EXPORT_SYMBOL(msm_hw_fence_wait_update);
 int msm_hw_fence_reset_client(void *client_handle, u32 reset_flags)
 {
 	struct msm_hw_fence_client *hw_fence_client;
+	struct hw_fence_signal_batch batch;
 	struct msm_hw_fence *hw_fences_tbl;
 	int i;
 
@@ -390,9 +399,11 @@ int msm_hw_fence_reset_client(void *client_handle, u32 reset_flags)
 	hw_fences_tbl = hw_fence_drv_data->hw_fences_tbl;
 
 	HWFNC_DBG_L("reset fences and queues for client:%d\n", hw_fence_client->client_id);
+	hw_fence_signal_batch_init(&batch);
 	for (i = 0; i < hw_fence_drv_data->hw_fences_tbl_cnt; i++)
 		hw_fence_utils_cleanup_fence(hw_fence_drv_data, hw_fence_client,
-			&hw_fences_tbl[i], i, reset_flags);
+			&hw_fences_tbl[i], i, reset_flags, &batch);
+	hw_fence_signal_batch_flush(hw_fence_drv_data, &batch);
 
 	hw_fence_utils_reset_queues(hw_fence_drv_data, hw_fence_client);
 
@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef __MSM_MEDIA_LATENCY_H
+#define __MSM_MEDIA_LATENCY_H
+
+#include <linux/dma-fence.h>
+#include <linux/types.h>
+#include <uapi/media_latency/msm_media_latency.h>
+
+#if IS_ENABLED(CONFIG_MSM_MEDIA_LATENCY)
+
+/**
+ * msm_media_latency_new_frame() - allocate a frame correlation id
+ *
+ * Called by the driver that brings a frame into the pipeline, e.g. camera
+ * at SOF. Ids are never 0.
+ */
+u64 msm_media_latency_new_frame(void);
+
+/**
+ * msm_media_latency_mark() - timestamp a frame at a hop
+ * @frame_id: id from msm_media_latency_new_frame(), nothing is recorded for 0
+ * @hop: pipeline point reached
+ * @data: driver defined, e.g. session or stream id
+ *
+ * Safe from any context, including hard irq.
+ */
+void msm_media_latency_mark(u64 frame_id, enum msm_media_latency_hop hop,
+	u32 data);
+
+/**
+ * msm_media_latency_tag_fence() - carry a frame id along a fence
+ * @fence: fence the next driver in the pipeline waits on
+ * @frame_id: id of the frame the fence completes
+ *
+ * Keyed by fence context and seqno, so the tag also matches the hw fence
+ * created for the same dma-fence. Tags are kept in a fixed size table
+ * where a later tag may replace an earlier one, so consumers look them up
+ * while the frame is in flight.
+ */
+void msm_media_latency_tag_fence(struct dma_fence *fence, u64 frame_id);
+
+/**
+ * msm_media_latency_fence_frame() - frame id carried by a fence
+ * @fence: fence passed in by the previous driver in the pipeline, for a
+ *	fence array the first tagged child is used
+ *
+ * Returns the id, or 0 if the fence is not tagged.
+ */
+u64 msm_media_latency_fence_frame(struct dma_fence *fence);
+
+/**
+ * msm_media_latency_mark_fence() - timestamp the frame carried by a fence
+ * @fence: tagged fence
+ * @hop: pipeline point reached
+ * @data: driver defined
+ *
+ * Returns the frame id so the caller can tag its own output fence.
+ */
+u64 msm_media_latency_mark_fence(struct dma_fence *fence,
+	enum msm_media_latency_hop hop, u32 data);
+
+#else
+
+static inline u64 msm_media_latency_new_frame(void)
+{
+	return 0;
+}
+
+static inline void msm_media_latency_mark(u64 frame_id,
+	enum msm_media_latency_hop hop, u32 data)
+{
+}
+
+static inline void msm_media_latency_tag_fence(struct dma_fence *fence,
+	u64 frame_id)
+{
+}
+
+static inline u64 msm_media_latency_fence_frame(struct dma_fence *fence)
+{
+	return 0;
+}
+
+static inline u64 msm_media_latency_mark_fence(struct dma_fence *fence,
+	enum msm_media_latency_hop hop, u32 data)
+{
+	return 0;
+}
+
+#endif /* CONFIG_MSM_MEDIA_LATENCY */
+
+#endif /* __MSM_MEDIA_LATENCY_H */
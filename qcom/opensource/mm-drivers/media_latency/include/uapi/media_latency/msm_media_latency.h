@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _UAPI_MSM_MEDIA_LATENCY_H
+#define _UAPI_MSM_MEDIA_LATENCY_H
+
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+/**
+ * enum msm_media_latency_hop - pipeline points a frame is timestamped at
+ * @MSM_MEDIA_LATENCY_HOP_LOST: not a hop, records were overwritten before
+ *	they were read; data holds how many were lost on that cpu
+ * @MSM_MEDIA_LATENCY_HOP_CAM_SOF: sensor start of frame
+ * @MSM_MEDIA_LATENCY_HOP_CAM_BUF_DONE: camera output buffer done
+ * @MSM_MEDIA_LATENCY_HOP_GPU_SUBMIT: gpu command submitted
+ * @MSM_MEDIA_LATENCY_HOP_GPU_RETIRE: gpu command retired
+ * @MSM_MEDIA_LATENCY_HOP_VIDC_ETB: buffer queued to the video encoder/decoder
+ * @MSM_MEDIA_LATENCY_HOP_VIDC_EBD: input buffer done by the video firmware
+ * @MSM_MEDIA_LATENCY_HOP_VIDC_FBD: output buffer done by the video firmware
+ * @MSM_MEDIA_LATENCY_HOP_CVP_SUBMIT: frame submitted to cvp
+ * @MSM_MEDIA_LATENCY_HOP_CVP_DONE: cvp frame done
+ * @MSM_MEDIA_LATENCY_HOP_DISP_COMMIT: display commit received
+ * @MSM_MEDIA_LATENCY_HOP_DISP_KICKOFF: display hardware kicked off
+ * @MSM_MEDIA_LATENCY_HOP_DISP_RETIRE: frame presented, retire fence signaled
+ * @MSM_MEDIA_LATENCY_HOP_FENCE_SIGNAL: a tagged fence was signaled
+ * @MSM_MEDIA_LATENCY_HOP_MAX: number of hops
+ */
+enum msm_media_latency_hop {
+	MSM_MEDIA_LATENCY_HOP_LOST,
+	MSM_MEDIA_LATENCY_HOP_CAM_SOF,
+	MSM_MEDIA_LATENCY_HOP_CAM_BUF_DONE,
+	MSM_MEDIA_LATENCY_HOP_GPU_SUBMIT,
+	MSM_MEDIA_LATENCY_HOP_GPU_RETIRE,
+	MSM_MEDIA_LATENCY_HOP_VIDC_ETB,
+	MSM_MEDIA_LATENCY_HOP_VIDC_EBD,
+	MSM_MEDIA_LATENCY_HOP_VIDC_FBD,
+	MSM_MEDIA_LATENCY_HOP_CVP_SUBMIT,
+	MSM_MEDIA_LATENCY_HOP_CVP_DONE,
+	MSM_MEDIA_LATENCY_HOP_DISP_COMMIT,
+	MSM_MEDIA_LATENCY_HOP_DISP_KICKOFF,
+	MSM_MEDIA_LATENCY_HOP_DISP_RETIRE,
+	MSM_MEDIA_LATENCY_HOP_FENCE_SIGNAL,
+	MSM_MEDIA_LATENCY_HOP_MAX,
+};
+
+/**
+ * struct msm_media_latency_record - one timestamp read from the device
+ * @timestamp:	qtimer ticks, same clock as the hw fence timestamps
+ * @frame_id:	correlation id of the frame, 0 for a LOST record
+ * @hop:	enum msm_media_latency_hop
+ * @cpu:	cpu the record was taken on
+ * @data:	driver defined, e.g. session or stream id
+ *
+ * read() on /dev/msm_media_latency returns whole records, cpu by cpu, each
+ * cpu's records in the order they were taken. Records of different cpus
+ * are not ordered against each other, readers sort by timestamp.
+ */
+struct msm_media_latency_record {
+	__u64	timestamp;
+	__u64	frame_id;
+	__u16	hop;
+	__u16	cpu;
+	__u32	data;
+};
+
+/**
+ * struct msm_media_latency_info - tracer parameters
+ * @timer_freq:	qtimer frequency in Hz, to convert timestamps
+ * @ring_size:	records kept per cpu
+ * @nr_cpus:	number of possible cpus
+ * @version:	MSM_MEDIA_LATENCY_VERSION
+ */
+struct msm_media_latency_info {
+	__u64	timer_freq;
+	__u32	ring_size;
+	__u32	nr_cpus;
+	__u32	version;
+	__u32	reserved;
+};
+
+#define MSM_MEDIA_LATENCY_VERSION	1
+
+#define MSM_MEDIA_LATENCY_MAGIC		'L'
+
+/**
+ * DOC: MSM_MEDIA_LATENCY_IOC_GET_INFO - get tracer parameters
+ *
+ * Takes a struct msm_media_latency_info and fills it.
+ */
+#define MSM_MEDIA_LATENCY_IOC_GET_INFO	_IOR(MSM_MEDIA_LATENCY_MAGIC, 1, \
+	struct msm_media_latency_info)
+
+#endif /* _UAPI_MSM_MEDIA_LATENCY_H */
@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2022 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#define pr_fmt(fmt)	"%s: " fmt, __func__
+
+#include <linux/atomic.h>
+#include <linux/dma-fence.h>
+#include <linux/dma-fence-array.h>
+#include <linux/fs.h>
+#include <linux/hash.h>
+#include <linux/miscdevice.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/uaccess.h>
+#include <asm/arch_timer.h>
+#include <clocksource/arm_arch_timer.h>
+
+#include "msm_media_latency.h"
+
+#define DRV_NAME		"msm_media_latency"
+
+#define ML_RING_SIZE		1024
+#define ML_RING_MASK		(ML_RING_SIZE - 1)
+
+#define ML_FENCE_TAG_BITS	10
+
+static bool enable = true;
+module_param(enable, bool, 0644);
+MODULE_PARM_DESC(enable, "record frame timestamps");
+
+/**
+ * struct ml_ring - records taken on one cpu
+ * @head: records ever written, only advanced by the owning cpu with irqs off
+ * @recs: ML_RING_SIZE records, slot head & ML_RING_MASK is written next
+ */
+struct ml_ring {
+	u64 head;
+	struct msm_media_latency_record *recs;
+};
+
+/**
+ * struct ml_fence_tag - frame id carried by a fence
+ * @context: fence context
+ * @seqno: fence seqno
+ * @frame_id: frame id, 0 for a free slot
+ */
+struct ml_fence_tag {
+	u64 context;
+	u64 seqno;
+	u64 frame_id;
+};
+
+/**
+ * struct ml_reader - per open file read state
+ * @lock: serializes reads on the file
+ * @pos: next record to read of each cpu's ring
+ * @bounce: page the records are copied to before copy_to_user(), so that
+ *	no fault is taken while they may be overwritten
+ */
+struct ml_reader {
+	struct mutex lock;
+	u64 *pos;
+	struct msm_media_latency_record *bounce;
+};
+
+#define ML_BOUNCE_RECS	(PAGE_SIZE / sizeof(struct msm_media_latency_record))
+
+static DEFINE_PER_CPU(struct ml_ring, ml_rings);
+static atomic64_t ml_next_frame = ATOMIC64_INIT(0);
+static struct ml_fence_tag ml_fence_tags[1 << ML_FENCE_TAG_BITS];
+static DEFINE_SPINLOCK(ml_fence_tag_lock);
+
+u64 msm_media_latency_new_frame(void)
+{
+	return atomic64_inc_return(&ml_next_frame);
+}
+EXPORT_SYMBOL(msm_media_latency_new_frame);
+
+void msm_media_latency_mark(u64 frame_id, enum msm_media_latency_hop hop,
+	u32 data)
+{
+	struct msm_media_latency_record *rec;
+	struct ml_ring *ring;
+	unsigned long flags;
+	u64 head;
+
+	if (!frame_id || !READ_ONCE(enable))
+		return;
+
+	local_irq_save(flags);
+	ring = this_cpu_ptr(&ml_rings);
+	head = ring->head;
+	rec = &ring->recs[head & ML_RING_MASK];
+
+	/* order the previous head update before the slot is overwritten */
+	smp_wmb();
+	rec->timestamp = arch_timer_read_counter();
+	rec->frame_id = frame_id;
+	rec->hop = hop;
+	rec->cpu = smp_processor_id();
+	rec->data = data;
+	smp_store_release(&ring->head, head + 1);
+	local_irq_restore(flags);
+}
+EXPORT_SYMBOL(msm_media_latency_mark);
+
+static inline struct ml_fence_tag *ml_fence_tag_slot(struct dma_fence *fence)
+{
+	return &ml_fence_tags[hash_64(fence->context ^ rol64(fence->seqno, 32),
+		ML_FENCE_TAG_BITS)];
+}
+
+void msm_media_latency_tag_fence(struct dma_fence *fence, u64 frame_id)
+{
+	struct ml_fence_tag *tag;
+	unsigned long flags;
+
+	if (!fence || !frame_id)
+		return;
+
+	tag = ml_fence_tag_slot(fence);
+	spin_lock_irqsave(&ml_fence_tag_lock, flags);
+	tag->context = fence->context;
+	tag->seqno = fence->seqno;
+	tag->frame_id = frame_id;
+	spin_unlock_irqrestore(&ml_fence_tag_lock, flags);
+}
+EXPORT_SYMBOL(msm_media_latency_tag_fence);
+
+static u64 ml_fence_tag_lookup(struct dma_fence *fence)
+{
+	struct ml_fence_tag *tag = ml_fence_tag_slot(fence);
+	unsigned long flags;
+	u64 frame_id = 0;
+
+	spin_lock_irqsave(&ml_fence_tag_lock, flags);
+	if (tag->context == fence->context && tag->seqno == fence->seqno)
+		frame_id = tag->frame_id;
+	spin_unlock_irqrestore(&ml_fence_tag_lock, flags);
+
+	return frame_id;
+}
+
+u64 msm_media_latency_fence_frame(struct dma_fence *fence)
+{
+	struct dma_fence_array *array;
+	u64 frame_id;
+	int i;
+
+	if (!fence)
+		return 0;
+
+	if (!dma_fence_is_array(fence))
+		return ml_fence_tag_lookup(fence);
+
+	array = to_dma_fence_array(fence);
+	for (i = 0; i < array->num_fences; i++) {
+		frame_id = ml_fence_tag_lookup(array->fences[i]);
+		if (frame_id)
+			return frame_id;
+	}
+
+	/* the array itself may have been tagged when it was created */
+	return ml_fence_tag_lookup(fence);
+}
+EXPORT_SYMBOL(msm_media_latency_fence_frame);
+
+u64 msm_media_latency_mark_fence(struct dma_fence *fence,
+	enum msm_media_latency_hop hop, u32 data)
+{
+	u64 frame_id = msm_media_latency_fence_frame(fence);
+
+	msm_media_latency_mark(frame_id, hop, data);
+
+	return frame_id;
+}
+EXPORT_SYMBOL(msm_media_latency_mark_fence);
+
+/*
+ * Copy up to @max records of @cpu's ring to @buf. The writer never waits for
+ * readers: records overwritten before or while they are copied are dropped
+ * and reported with a single LOST record ahead of the rest, so @max must
+ * leave room for it.
+ */
+static ssize_t ml_read_cpu(struct ml_reader *reader, int cpu,
+	char __user *buf, size_t max)
+{
+	struct ml_ring *ring = per_cpu_ptr(&ml_rings, cpu);
+	struct msm_media_latency_record *out = reader->bounce + 1;
+	u64 head, pos, lost = 0, torn;
+	size_t n, i;
+
+	head = smp_load_acquire(&ring->head);
+	pos = reader->pos[cpu];
+	if (head == pos)
+		return 0;
+
+	if (head - pos > ML_RING_SIZE) {
+		lost = head - ML_RING_SIZE - pos;
+		pos = head - ML_RING_SIZE;
+	}
+
+	n = min_t(u64, head - pos, min_t(size_t, max, ML_BOUNCE_RECS) - 1);
+	for (i = 0; i < n; i++)
+		out[i] = ring->recs[(pos + i) & ML_RING_MASK];
+
+	/* drop what the writer reached meanwhile, incl. the slot it may be in */
+	smp_rmb();
+	head = READ_ONCE(ring->head);
+	if (head + 1 > pos + ML_RING_SIZE) {
+		torn = min_t(u64, head + 1 - ML_RING_SIZE - pos, n);
+		out += torn;
+		n -= torn;
+		pos += torn;
+		lost += torn;
+	}
+	reader->pos[cpu] = pos + n;
+
+	if (lost) {
+		out--;
+		out->timestamp = arch_timer_read_counter();
+		out->frame_id = 0;
+		out->hop = MSM_MEDIA_LATENCY_HOP_LOST;
+		out->cpu = cpu;
+		out->data = min_t(u64, lost, U32_MAX);
+		n++;
+	}
+
+	if (copy_to_user(buf, out, n * sizeof(*out)))
+		return -EFAULT;
+
+	return n * sizeof(*out);
+}
+
+static ssize_t ml_read(struct file *file, char __user *buf, size_t count,
+	loff_t *ppos)
+{
+	struct ml_reader *reader = file->private_data;
+	size_t rec_size = sizeof(struct msm_media_latency_record);
+	ssize_t len, total = 0;
+	int cpu;
+
+	if (count < 2 * rec_size)
+		return -EINVAL;
+
+	mutex_lock(&reader->lock);
+	for_each_possible_cpu(cpu) {
+		if (count - total < 2 * rec_size)
+			break;
+
+		len = ml_read_cpu(reader, cpu, buf + total,
+			(count - total) / rec_size);
+		if (len < 0) {
+			if (!total)
+				total = len;
+			break;
+		}
+		total += len;
+	}
+	mutex_unlock(&reader->lock);
+
+	return total;
+}
+
+static long ml_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+	struct msm_media_latency_info info = {0};
+
+	switch (cmd) {
+	case MSM_MEDIA_LATENCY_IOC_GET_INFO:
+		info.timer_freq = arch_timer_get_cntfrq();
+		info.ring_size = ML_RING_SIZE;
+		info.nr_cpus = nr_cpu_ids;
+		info.version = MSM_MEDIA_LATENCY_VERSION;
+		if (copy_to_user((void __user *)arg, &info, sizeof(info)))
+			return -EFAULT;
+		return 0;
+	default:
+		return -ENOTTY;
+	}
+}
+
+static int ml_open(struct inode *inode, struct file *file)
+{
+	struct ml_reader *reader;
+	u64 head;
+	int cpu;
+
+	reader = kzalloc(sizeof(*reader), GFP_KERNEL);
+	if (!reader)
+		return -ENOMEM;
+
+	reader->pos = kcalloc(nr_cpu_ids, sizeof(*reader->pos), GFP_KERNEL);
+	reader->bounce = (void *)__get_free_page(GFP_KERNEL);
+	if (!reader->pos || !reader->bounce) {
+		kfree(reader->pos);
+		free_page((unsigned long)reader->bounce);
+		kfree(reader);
+		return -ENOMEM;
+	}
+
+	/* start from the oldest record still held, not reported as lost */
+	for_each_possible_cpu(cpu) {
+		head = smp_load_acquire(&per_cpu_ptr(&ml_rings, cpu)->head);
+		reader->pos[cpu] = head > ML_RING_SIZE ? head - ML_RING_SIZE : 0;
+	}
+
+	mutex_init(&reader->lock);
+	file->private_data = reader;
+
+	return nonseekable_open(inode, file);
+}
+
+static int ml_release(struct inode *inode, struct file *file)
+{
+	struct ml_reader *reader = file->private_data;
+
+	mutex_destroy(&reader->lock);
+	free_page((unsigned long)reader->bounce);
+	kfree(reader->pos);
+	kfree(reader);
+
+	return 0;
+}
+
+static const struct file_operations ml_fops = {
+	.owner = THIS_MODULE,
+	.open = ml_open,
+	.release = ml_release,
+	.read = ml_read,
+	.unlocked_ioctl = ml_ioctl,
+	.compat_ioctl = compat_ptr_ioctl,
+	.llseek = no_llseek,
+};
+
+static struct miscdevice ml_miscdev = {
+	.minor = MISC_DYNAMIC_MINOR,
+	.name = DRV_NAME,
+	.fops = &ml_fops,
+	.mode = 0440,
+};
+
+static void ml_free_rings(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		kvfree(per_cpu_ptr(&ml_rings, cpu)->recs);
+		per_cpu_ptr(&ml_rings, cpu)->recs = NULL;
+	}
+}
+
+static int __init msm_media_latency_init(void)
+{
+	struct ml_ring *ring;
+	int cpu, rc;
+
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(&ml_rings, cpu);
+		ring->recs = kvzalloc_node(ML_RING_SIZE * sizeof(*ring->recs),
+			GFP_KERNEL, cpu_to_node(cpu));
+		if (!ring->recs) {
+			ml_free_rings();
+			return -ENOMEM;
+		}
+	}
+
+	rc = misc_register(&ml_miscdev);
+	if (rc) {
+		pr_err("failed to register misc device, rc=%d\n", rc);
+		ml_free_rings();
+		return rc;
+	}
+
+	return 0;
+}
+
+static void __exit msm_media_latency_exit(void)
+{
+	misc_deregister(&ml_miscdev);
+	ml_free_rings();
+}
+
+module_init(msm_media_latency_init);
+module_exit(msm_media_latency_exit);
+
+MODULE_LICENSE("GPL v2");
+MODULE_DESCRIPTION("MSM media pipeline latency tracer");
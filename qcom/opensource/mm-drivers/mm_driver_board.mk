@@ -10,9 +10,15 @@ endif
 ifeq ($(MM_DRV_DLKM_ENABLE), true)
 	ifneq ($(TARGET_BOARD_AUTO),true)
 		ifeq ($(call is-board-platform-in-list,$(TARGET_BOARD_PLATFORM)),true)
-			BOARD_VENDOR_KERNEL_MODULES += $(KERNEL_MODULES_OUT)/msm_ext_display.ko
-			BOARD_VENDOR_RAMDISK_KERNEL_MODULES += $(KERNEL_MODULES_OUT)/msm_ext_display.ko
-			BOARD_VENDOR_RAMDISK_RECOVERY_KERNEL_MODULES_LOAD += $(KERNEL_MODULES_OUT)/msm_ext_display.ko
+			BOARD_VENDOR_KERNEL_MODULES += $(KERNEL_MODULES_OUT)/msm_ext_display.ko \
+				$(KERNEL_MODULES_OUT)/msm_dma_map_cache.ko \
+				$(KERNEL_MODULES_OUT)/msm_media_latency.ko
+			BOARD_VENDOR_RAMDISK_KERNEL_MODULES += $(KERNEL_MODULES_OUT)/msm_ext_display.ko \
+				$(KERNEL_MODULES_OUT)/msm_dma_map_cache.ko \
+				$(KERNEL_MODULES_OUT)/msm_media_latency.ko
+			BOARD_VENDOR_RAMDISK_RECOVERY_KERNEL_MODULES_LOAD += $(KERNEL_MODULES_OUT)/msm_ext_display.ko \
+				$(KERNEL_MODULES_OUT)/msm_dma_map_cache.ko \
+				$(KERNEL_MODULES_OUT)/msm_media_latency.ko
 			ifneq ($(TARGET_BOARD_PLATFORM), taro)
 				BOARD_VENDOR_KERNEL_MODULES += $(KERNEL_MODULES_OUT)/sync_fence.ko \
 					       $(KERNEL_MODULES_OUT)/msm_hw_fence.ko
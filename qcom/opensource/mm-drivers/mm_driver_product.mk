@@ -1,5 +1,5 @@
 
-PRODUCT_PACKAGES += msm_ext_display.ko
+PRODUCT_PACKAGES += msm_ext_display.ko msm_dma_map_cache.ko msm_media_latency.ko
 
 MM_DRV_DLKM_ENABLE := true
 ifeq ($(TARGET_KERNEL_DLKM_DISABLE), true)
@@ -14,4 +14,4 @@ ifeq ($(MM_DRV_DLKM_ENABLE), true)
 	endif
 endif
 
-DISPLAY_MM_DRIVER := msm_ext_display.ko sync_fence.ko msm_hw_fence.ko
\ No newline at end of file
+DISPLAY_MM_DRIVER := msm_ext_display.ko msm_dma_map_cache.ko msm_media_latency.ko sync_fence.ko msm_hw_fence.ko
\ No newline at end of file
@@ -44,8 +44,8 @@ def run_headers_install(verbose, gen_dir, headers_install, unifdef, prefix, h):
 def gen_mm_drivers_headers(verbose, gen_dir, headers_install, unifdef, mm_drivers_include_uapi):
     error_count = 0
     for h in mm_drivers_include_uapi:
-        mm_drivers_uapi_include_prefix = os.path.join(h.split('sync_fence/include/uapi')[0],
-			'sync_fence', 'include', 'uapi') + os.sep
+        mm_drivers_uapi_include_prefix = os.path.join(h.split('/include/uapi')[0],
+			'include', 'uapi') + os.sep
         if not run_headers_install(
                 verbose, gen_dir, headers_install, unifdef,
                 mm_drivers_uapi_include_prefix, h): error_count += 1
@@ -12,6 +12,7 @@
 
 #define SPEC_FENCE_SIGNAL_ANY 0x1
 #define SPEC_FENCE_SIGNAL_ALL 0x2
+#define SPEC_FENCE_BATCH_MERGE 0x4
 
 /**
  * struct fence_bind_data - data passed to bind ioctl
@@ -35,6 +36,23 @@ struct fence_create_data {
 	__u32	out_bind_fd;
 };
 
+/**
+ * struct fence_batch_data - data passed to batch ioctl
+ * @fds:	pointer to the list of file descriptors of the fences
+ * @num_fences:	number of fences in the list
+ * @flags:	SPEC_FENCE_SIGNAL_ANY or SPEC_FENCE_SIGNAL_ALL, optionally with
+ *		SPEC_FENCE_BATCH_MERGE to merge the fences instead of waiting
+ * @timeout_ms:	wait timeout in ms, negative to wait indefinitely
+ * @out_fd:	returns the merged fence fd when SPEC_FENCE_BATCH_MERGE is set
+ */
+struct fence_batch_data {
+	__u64	fds;
+	__u32	num_fences;
+	__u32	flags;
+	__s32	timeout_ms;
+	__s32	out_fd;
+};
+
 #define SPEC_SYNC_MAGIC		'>'
 
 /**
@@ -60,4 +78,13 @@ struct fence_create_data {
  */
 #define SPEC_SYNC_IOC_GET_VER	_IOWR(SPEC_SYNC_MAGIC, 5, __u64)
 
+/**
+ * DOC: SPEC_SYNC_IOC_BATCH - wait on or merge a list of fences
+ *
+ * Takes a struct fence_batch_data. Waits with a single wakeup until any or all
+ * the fences in fds are signaled, or if SPEC_FENCE_BATCH_MERGE is set, returns
+ * in out_fd a single fence that signals when any or all of them are signaled.
+ */
+#define SPEC_SYNC_IOC_BATCH	_IOWR(SPEC_SYNC_MAGIC, 6, struct fence_batch_data)
+
 #endif /* _UAPI_LINUX_SPEC_SYNC_H */
@@ -24,7 +24,7 @@
 
 #define CLASS_NAME	"sync"
 #define DRV_NAME	"spec_sync"
-#define DRV_VERSION	1
+#define DRV_VERSION	2
 #define NAME_LEN	32
 
 #define FENCE_MIN	1
@@ -456,6 +456,167 @@ static int spec_sync_ioctl_bind(struct sync_device *obj, unsigned long __user ar
 	return spec_sync_bind_array(&sync_bind_info);
 }
 
+static int spec_sync_batch_wait(struct dma_fence **fences, u32 num_fences, bool signal_any,
+	s32 timeout_ms)
+{
+	struct dma_fence_array *fence_array;
+	struct dma_fence *fence;
+	long timeout;
+	int i, pending = 0, ret = 0;
+
+	/* drop the fences that are already signaled, these don't need a wait */
+	for (i = 0; i < num_fences; i++) {
+		if (dma_fence_is_signaled(fences[i])) {
+			if (!ret && fences[i]->error < 0)
+				ret = fences[i]->error;
+			dma_fence_put(fences[i]);
+			continue;
+		}
+		fences[pending++] = fences[i];
+	}
+
+	if (!pending || (signal_any && pending < num_fences)) {
+		for (i = 0; i < pending; i++)
+			dma_fence_put(fences[i]);
+		kfree(fences);
+		return ret;
+	}
+
+	if (pending == 1) {
+		fence = fences[0];
+		kfree(fences);
+	} else {
+		/* the fence-array takes ownership of the fences and their refcount */
+		fence_array = dma_fence_array_create(pending, fences, dma_fence_context_alloc(1),
+			0, signal_any);
+		if (!fence_array) {
+			for (i = 0; i < pending; i++)
+				dma_fence_put(fences[i]);
+			kfree(fences);
+			return -ENOMEM;
+		}
+		fence = &fence_array->base;
+	}
+
+	timeout = timeout_ms < 0 ? MAX_SCHEDULE_TIMEOUT : msecs_to_jiffies(timeout_ms);
+	timeout = dma_fence_wait_timeout(fence, true, timeout);
+	if (timeout < 0)
+		ret = timeout;
+	else if (!timeout)
+		ret = -ETIMEDOUT;
+	else if (!ret && fence->error < 0)
+		ret = fence->error;
+
+	dma_fence_put(fence);
+
+	return ret;
+}
+
+static int spec_sync_batch_merge(struct dma_fence **fences, u32 num_fences, bool signal_any)
+{
+	int fd = get_unused_fd_flags(O_CLOEXEC);
+	struct dma_fence_array *fence_array;
+	struct sync_file *sync_file;
+	int i;
+
+	if (fd < 0) {
+		pr_err("failed to get_unused_fd_flags\n");
+		for (i = 0; i < num_fences; i++)
+			dma_fence_put(fences[i]);
+		kfree(fences);
+		return fd;
+	}
+
+	/* the fence-array takes ownership of the fences and their refcount */
+	fence_array = dma_fence_array_create(num_fences, fences, dma_fence_context_alloc(1), 0,
+		signal_any);
+	if (!fence_array) {
+		for (i = 0; i < num_fences; i++)
+			dma_fence_put(fences[i]);
+		kfree(fences);
+		put_unused_fd(fd);
+		return -ENOMEM;
+	}
+
+	sync_file = sync_file_create(&fence_array->base);
+	dma_fence_put(&fence_array->base);
+	if (!sync_file) {
+		pr_err("sync_file_create fail\n");
+		put_unused_fd(fd);
+		return -EINVAL;
+	}
+
+	fd_install(fd, sync_file->file);
+
+	return fd;
+}
+
+static int spec_sync_ioctl_batch(struct sync_device *obj, unsigned long __user arg)
+{
+	struct fence_batch_data b;
+	struct dma_fence **fences;
+	bool signal_any;
+	int *user_fds, i, ret = 0;
+
+	if (copy_from_user(&b, (void __user *)arg, sizeof(b)))
+		return -EFAULT;
+
+	if (b.num_fences < FENCE_MIN || b.num_fences > FENCE_MAX) {
+		pr_err("invalid arguments num_fences:%d\n", b.num_fences);
+		return -ERANGE;
+	}
+
+	user_fds = kmalloc_array(b.num_fences, sizeof(int), GFP_KERNEL);
+	if (!user_fds)
+		return -ENOMEM;
+
+	if (copy_from_user(user_fds, u64_to_user_ptr(b.fds), b.num_fences * sizeof(int))) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	fences = kmalloc_array(b.num_fences, sizeof(void *), GFP_KERNEL|__GFP_ZERO);
+	if (!fences) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < b.num_fences; i++) {
+		fences[i] = sync_file_get_fence(user_fds[i]);
+		if (!fences[i]) {
+			pr_err("invalid fence fd:%d idx:%d\n", user_fds[i], i);
+			while (i--)
+				dma_fence_put(fences[i]);
+			kfree(fences);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	signal_any = b.flags & SPEC_FENCE_SIGNAL_ALL ? false : true;
+
+	/* the helpers below consume the fences list and its refcounts */
+	if (b.flags & SPEC_FENCE_BATCH_MERGE) {
+		ret = spec_sync_batch_merge(fences, b.num_fences, signal_any);
+		if (ret < 0)
+			goto out;
+
+		b.out_fd = ret;
+		ret = 0;
+		if (copy_to_user((void __user *)arg, &b, sizeof(b))) {
+			/* fd is already installed, userspace owns it from here */
+			ret = -EFAULT;
+		}
+	} else {
+		ret = spec_sync_batch_wait(fences, b.num_fences, signal_any, b.timeout_ms);
+	}
+
+	pr_debug("batch num_fences:%u flags:0x%x ret:%d\n", b.num_fences, b.flags, ret);
+out:
+	kfree(user_fds);
+	return ret;
+}
+
 static long spec_sync_ioctl(struct file *file, unsigned int cmd,
 			  unsigned long arg)
 {
@@ -472,6 +633,9 @@ static long spec_sync_ioctl(struct file *file, unsigned int cmd,
 	case SPEC_SYNC_IOC_GET_VER:
 		ret = spec_sync_ioctl_get_ver(obj, arg);
 		break;
+	case SPEC_SYNC_IOC_BATCH:
+		ret = spec_sync_ioctl_batch(obj, arg);
+		break;
 	default:
 		ret = -ENOTTY;
 	}
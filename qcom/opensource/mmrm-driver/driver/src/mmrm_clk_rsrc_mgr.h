@@ -66,6 +66,10 @@ struct mmrm_sw_clk_client_tbl_entry {
 	bool reserve;
 	u32 ref_count;
 	u32 num_hw_blocks;
+
+	/* last clk rate to vdd level lookup */
+	u64 lookup_rate;
+	u32 lookup_level;
 };
 
 struct mmrm_sw_throttled_clients_data {
@@ -84,6 +88,13 @@ struct mmrm_sw_peak_current_data {
 	u32 aggreg_level;
 };
 
+struct mmrm_sw_arb_cache {
+	/* number of enabled clients at each vdd level */
+	u32 level_cnt[MMRM_VDD_LEVEL_MAX];
+	/* current in ma of all enabled clients for each mmcx voltage level */
+	u32 level_cur[MMRM_VDD_LEVEL_MAX];
+};
+
 struct mmrm_throttle_info {
 	u32 csid_throttle_client;
 	u16 tbl_entry_id;
@@ -102,6 +113,9 @@ struct mmrm_sw_clk_mgr_info {
 	/* peak current data */
 	struct mmrm_sw_peak_current_data peak_cur_data;
 
+	/* per level aggregates of the enabled clients, updated incrementally */
+	struct mmrm_sw_arb_cache arb_cache;
+
 	/* HEAD of list of clients throttled */
 	struct list_head throttled_clients;
 
@@ -174,6 +174,31 @@ static int mmrm_sw_update_curr(struct mmrm_sw_clk_mgr_info *sinfo,
 	return 0;
 }
 
+static inline bool mmrm_sw_entry_enabled(struct mmrm_sw_clk_client_tbl_entry *tbl_entry)
+{
+	return !IS_ERR_OR_NULL(tbl_entry->clk) && tbl_entry->clk_rate;
+}
+
+/*
+ * Adds (sign = 1) or removes (sign = -1) the contribution of an enabled client to the
+ * arbitration cache. Must be called with the clk mgr lock held, before and after any change
+ * to clk_rate, vdd_level or num_hw_blocks of the entry.
+ */
+static void mmrm_sw_arb_cache_update(struct mmrm_sw_clk_mgr_info *sinfo,
+	struct mmrm_sw_clk_client_tbl_entry *tbl_entry, int sign)
+{
+	struct mmrm_sw_arb_cache *cache = &sinfo->arb_cache;
+	u32 level;
+
+	if (!mmrm_sw_entry_enabled(tbl_entry) || tbl_entry->vdd_level >= MMRM_VDD_LEVEL_MAX)
+		return;
+
+	cache->level_cnt[tbl_entry->vdd_level] += sign;
+	for (level = 0; level < MMRM_VDD_LEVEL_MAX; level++)
+		cache->level_cur[level] += sign * (int)(tbl_entry->current_ma
+			[tbl_entry->vdd_level][level] * tbl_entry->num_hw_blocks);
+}
+
 static struct mmrm_client *mmrm_sw_clk_client_register(
 	struct mmrm_clk_mgr *sw_clk_mgr,
 	struct mmrm_clk_client_desc clk_desc,
@@ -332,9 +357,11 @@ static int mmrm_sw_clk_client_deregister(struct mmrm_clk_mgr *sw_clk_mgr,
 
 	if (tbl_entry->ref_count == 0) {
 
+		mmrm_sw_arb_cache_update(sinfo, tbl_entry, -1);
 		kfree(tbl_entry->client);
 		tbl_entry->vdd_level = 0;
 		tbl_entry->clk_rate = 0;
+		tbl_entry->lookup_rate = 0;
 		tbl_entry->client = NULL;
 		tbl_entry->clk = NULL;
 		tbl_entry->pri = 0x0;
@@ -409,13 +436,13 @@ err_invalid_corner:
 
 static int mmrm_sw_check_req_level(
 	struct mmrm_sw_clk_mgr_info *sinfo,
-	u32 clk_src_id, u32 req_level, u32 *adj_level)
+	u32 client_uid, u32 req_level, u32 *adj_level)
 {
 	int rc = 0;
 	struct mmrm_sw_peak_current_data *peak_data = &sinfo->peak_cur_data;
-	struct mmrm_sw_clk_client_tbl_entry *tbl_entry = NULL;
-	struct mmrm_sw_clk_client_tbl_entry *next_max_entry = NULL;
-	u32 c, level = req_level;
+	struct mmrm_sw_arb_cache *cache = &sinfo->arb_cache;
+	struct mmrm_sw_clk_client_tbl_entry *tbl_entry = &sinfo->clk_client_tbl[client_uid];
+	u32 level = req_level, l, cnt;
 
 	if (req_level >= MMRM_VDD_LEVEL_MAX) {
 		d_mpr_e("%s: invalid level %lu\n", __func__, req_level);
@@ -423,30 +450,19 @@ static int mmrm_sw_check_req_level(
 		goto err_invalid_level;
 	}
 	d_mpr_h("%s: csid(0x%x) level(%d) peak_data->aggreg_level(%d)\n",
-		__func__, clk_src_id, level, peak_data->aggreg_level);
-
-	/* req_level is rejected when another client has a higher level */
-	if (req_level < peak_data->aggreg_level) {
-		for (c = 0; c < sinfo->tot_clk_clients; c++) {
-			tbl_entry = &sinfo->clk_client_tbl[c];
-			if (IS_ERR_OR_NULL(tbl_entry->clk) || !tbl_entry->clk_rate ||
-				(tbl_entry->clk_src_id == clk_src_id)) {
-				continue;
-			}
-			if (tbl_entry->vdd_level == peak_data->aggreg_level) {
-				break;
-			}
-			if  ((tbl_entry->vdd_level < peak_data->aggreg_level)
-					&& (tbl_entry->vdd_level > req_level ))
-				next_max_entry = tbl_entry;
+		__func__, tbl_entry->clk_src_id, level, peak_data->aggreg_level);
 
-		}
-		/* reject req level */
-		if (c < sinfo->tot_clk_clients) {
-			level = peak_data->aggreg_level;
-		} else if (!IS_ERR_OR_NULL(next_max_entry)
-			&& next_max_entry->vdd_level > req_level) {
-			level = next_max_entry->vdd_level;
+	/*
+	 * req_level is rejected when another client has a higher level, the level is raised
+	 * to the highest level voted by the other enabled clients
+	 */
+	for (l = peak_data->aggreg_level; l > req_level && l < MMRM_VDD_LEVEL_MAX; l--) {
+		cnt = cache->level_cnt[l];
+		if (mmrm_sw_entry_enabled(tbl_entry) && tbl_entry->vdd_level == l)
+			cnt--;
+		if (cnt) {
+			level = l;
+			break;
 		}
 	}
 
@@ -463,8 +479,7 @@ static int mmrm_sw_calculate_total_current(
 	u32 req_level, u32 *total_cur, struct mmrm_sw_clk_client_tbl_entry *tbl_entry_new)
 {
 	int rc = 0;
-	struct mmrm_sw_clk_client_tbl_entry *tbl_entry;
-	u32 c, sum_cur = 0;
+	u32 sum_cur = 0;
 
 	if (req_level >= MMRM_VDD_LEVEL_MAX) {
 		d_mpr_e("%s: invalid level %lu\n", __func__, req_level);
@@ -472,16 +487,11 @@ static int mmrm_sw_calculate_total_current(
 		goto err_invalid_level;
 	}
 
-	/* calculate sum of values (scaled by volt) */
-	for (c = 0; c < sinfo->tot_clk_clients; c++) {
-		tbl_entry = &sinfo->clk_client_tbl[c];
-		if (IS_ERR_OR_NULL(tbl_entry->clk) || !tbl_entry->clk_rate
-			|| (tbl_entry == tbl_entry_new)) {
-			continue;
-		}
-		sum_cur += (tbl_entry->current_ma[tbl_entry->vdd_level][req_level]
-			* tbl_entry->num_hw_blocks);
-	}
+	/* sum of values (scaled by volt) of the other clients, from the cached aggregate */
+	sum_cur = sinfo->arb_cache.level_cur[req_level];
+	if (mmrm_sw_entry_enabled(tbl_entry_new))
+		sum_cur -= tbl_entry_new->current_ma[tbl_entry_new->vdd_level][req_level]
+			* tbl_entry_new->num_hw_blocks;
 
 	*total_cur = sum_cur;
 	d_mpr_h("%s: total_cur(%lu)\n", __func__, *total_cur);
@@ -491,122 +501,189 @@ err_invalid_level:
 	return rc;
 }
 
-static int mmrm_sw_throttle_low_priority_client(
-	struct mmrm_sw_clk_mgr_info *sinfo, int *delta_cur)
+static int mmrm_sw_throttle_one_client(struct mmrm_sw_clk_mgr_info *sinfo,
+	int throttle_idx, u32 now_cur_ma, u32 min_cur_ma)
 {
-	int rc = 0, i;
+	int rc = 0;
 	u64 start_ts = 0, end_ts = 0;
-	bool found_client_throttle = false;
 	struct mmrm_sw_clk_client_tbl_entry *tbl_entry_throttle_client;
 	struct mmrm_client_notifier_data notifier_data;
-	struct completion timeout;
-	struct mmrm_sw_peak_current_data *peak_data = &sinfo->peak_cur_data;
 	struct mmrm_sw_throttled_clients_data *tc_data;
-
-	u32 now_cur_ma, min_cur_ma;
 	long clk_min_level = MMRM_VDD_LEVEL_LOW_SVS;
 
-	init_completion(&timeout);
+	tbl_entry_throttle_client =
+		&sinfo->clk_client_tbl[sinfo->throttle_clients_info[throttle_idx].tbl_entry_id];
 
-	for (i = 0; i < sinfo->throttle_clients_data_length ; i++) {
-		tbl_entry_throttle_client =
-			&sinfo->clk_client_tbl[sinfo->throttle_clients_info[i].tbl_entry_id];
-		if (!IS_ERR_OR_NULL(tbl_entry_throttle_client)) {
-			now_cur_ma = tbl_entry_throttle_client->current_ma
-				[tbl_entry_throttle_client->vdd_level]
-				[peak_data->aggreg_level];
-			min_cur_ma = tbl_entry_throttle_client->current_ma[clk_min_level]
-				[peak_data->aggreg_level];
-
-			d_mpr_h("%s:csid(0x%x) name(%s)\n",
-				__func__, tbl_entry_throttle_client->clk_src_id,
-				tbl_entry_throttle_client->name);
-			d_mpr_h("%s:now_cur_ma(%llu) min_cur_ma(%llu) delta_cur(%d)\n",
-				__func__, now_cur_ma, min_cur_ma, *delta_cur);
-
-			if ((now_cur_ma > min_cur_ma)
-				&& (now_cur_ma - min_cur_ma > *delta_cur)) {
-				found_client_throttle = true;
-				d_mpr_h("%s: Throttle client csid(0x%x) name(%s)\n",
-					__func__, tbl_entry_throttle_client->clk_src_id,
-					tbl_entry_throttle_client->name);
-				d_mpr_h("%s:now_cur_ma %llu-min_cur_ma %llu>delta_cur %d\n",
-					__func__, now_cur_ma, min_cur_ma, *delta_cur);
-				/* found client to throttle, break from here. */
-				break;
-			}
-		}
-	}
+	/* Setup notifier */
+	notifier_data.cb_type = MMRM_CLIENT_RESOURCE_VALUE_CHANGE;
+	notifier_data.cb_data.val_chng.old_val =
+		tbl_entry_throttle_client->freq[tbl_entry_throttle_client->vdd_level];
+	notifier_data.cb_data.val_chng.new_val =
+		tbl_entry_throttle_client->freq[clk_min_level];
+	notifier_data.pvt_data = tbl_entry_throttle_client->pvt_data;
+	start_ts = ktime_get_ns();
 
-	/*Client to throttle is found, Throttle this client now to minimum clock rate*/
-	if (found_client_throttle) {
-		/* Setup notifier */
+	if (tbl_entry_throttle_client->notifier_cb_fn)
+		rc = tbl_entry_throttle_client->notifier_cb_fn(&notifier_data);
 
-		notifier_data.cb_type = MMRM_CLIENT_RESOURCE_VALUE_CHANGE;
-		notifier_data.cb_data.val_chng.old_val =
-			tbl_entry_throttle_client->freq[tbl_entry_throttle_client->vdd_level];
-		notifier_data.cb_data.val_chng.new_val =
-			tbl_entry_throttle_client->freq[clk_min_level];
-		notifier_data.pvt_data = tbl_entry_throttle_client->pvt_data;
-		start_ts = ktime_get_ns();
+	end_ts = ktime_get_ns();
+	d_mpr_h("%s: Client notifier cbk processing time %llu ns\n",
+		__func__, (end_ts - start_ts));
 
-		if (tbl_entry_throttle_client->notifier_cb_fn)
-			rc = tbl_entry_throttle_client->notifier_cb_fn(&notifier_data);
+	if (rc) {
+		d_mpr_e("%s: Client failed to send SUCCESS in callback(%d)\n",
+			__func__, tbl_entry_throttle_client->clk_src_id);
+		return -EINVAL;
+	}
 
-		end_ts = ktime_get_ns();
-		d_mpr_h("%s: Client notifier cbk processing time %llu ns\n",
-			__func__, (end_ts - start_ts));
+	if ((end_ts - start_ts) > NOTIFY_TIMEOUT)
+		d_mpr_e("%s:Client notifier cbk took %llu ns more than timeout %llu ns\n",
+			__func__, (end_ts - start_ts), NOTIFY_TIMEOUT);
 
+	if (tbl_entry_throttle_client->reserve == false) {
+		rc = clk_set_rate(tbl_entry_throttle_client->clk,
+					tbl_entry_throttle_client->freq[clk_min_level]);
 		if (rc) {
-			d_mpr_e("%s: Client failed to send SUCCESS in callback(%d)\n",
+			d_mpr_e("%s: Failed to throttle the clk csid(%d)\n",
 				__func__, tbl_entry_throttle_client->clk_src_id);
-			rc = -EINVAL;
-			goto err_clk_set_fail;
+			return -EINVAL;
 		}
+	}
 
-		if ((end_ts - start_ts) > NOTIFY_TIMEOUT)
-			d_mpr_e("%s:Client notifier cbk took %llu ns more than timeout %llu ns\n",
-				__func__, (end_ts - start_ts), NOTIFY_TIMEOUT);
-
-		if (tbl_entry_throttle_client->reserve == false) {
-			rc = clk_set_rate(tbl_entry_throttle_client->clk,
-						tbl_entry_throttle_client->freq[clk_min_level]);
-			if (rc) {
-				d_mpr_e("%s: Failed to throttle the clk csid(%d)\n",
-					__func__, tbl_entry_throttle_client->clk_src_id);
-				rc = -EINVAL;
-				goto err_clk_set_fail;
+	d_mpr_h("%s: %s throttled to %llu\n",
+		__func__, tbl_entry_throttle_client->name,
+		tbl_entry_throttle_client->freq[clk_min_level]);
+
+	/* Store this client for bookkeeping */
+	tc_data = kzalloc(sizeof(*tc_data), GFP_KERNEL);
+	if (IS_ERR_OR_NULL(tc_data)) {
+		d_mpr_e("%s: Failed to allocate memory\n", __func__);
+		return -ENOMEM;
+	}
+	tc_data->table_id = throttle_idx;
+	tc_data->delta_cu_ma = now_cur_ma - min_cur_ma;
+	tc_data->prev_vdd_level = tbl_entry_throttle_client->vdd_level;
+	// Add throttled client to list to access it later
+	list_add_tail(&tc_data->list, &sinfo->throttled_clients);
+
+	/* Store the throttled clock rate of client */
+	mmrm_sw_arb_cache_update(sinfo, tbl_entry_throttle_client, -1);
+	tbl_entry_throttle_client->clk_rate =
+				tbl_entry_throttle_client->freq[clk_min_level];
+
+	/* Store the corner level of throttled client */
+	tbl_entry_throttle_client->vdd_level = clk_min_level;
+	mmrm_sw_arb_cache_update(sinfo, tbl_entry_throttle_client, 1);
+
+	/* Clearing the reserve flag */
+	tbl_entry_throttle_client->reserve = false;
+
+	return 0;
+}
+
+/*
+ * Plans which of the throttle clients must go to their minimum level to absorb delta_cur,
+ * before any of them is touched. Low priority clients are picked first and, within the same
+ * priority, the ones that release the most current, so the fewest clients are throttled.
+ * If a single client can absorb the delta, only that client is throttled.
+ */
+static int mmrm_sw_throttle_low_priority_client(
+	struct mmrm_sw_clk_mgr_info *sinfo, struct mmrm_sw_clk_client_tbl_entry *tbl_entry_req,
+	int *delta_cur)
+{
+	int rc = 0, i, j, best, num_cand = 0, num_plan = 0;
+	struct mmrm_sw_clk_client_tbl_entry *tbl_entry_throttle_client;
+	struct mmrm_sw_peak_current_data *peak_data = &sinfo->peak_cur_data;
+	struct {
+		int idx;
+		u32 now_cur_ma;
+		u32 min_cur_ma;
+		bool low_pri;
+	} cand[MMRM_MAX_THROTTLE_CLIENTS], tmp;
+	u32 now_cur_ma, min_cur_ma, planned = 0;
+	long clk_min_level = MMRM_VDD_LEVEL_LOW_SVS;
+
+	for (i = 0; i < sinfo->throttle_clients_data_length ; i++) {
+		tbl_entry_throttle_client =
+			&sinfo->clk_client_tbl[sinfo->throttle_clients_info[i].tbl_entry_id];
+		if (IS_ERR_OR_NULL(tbl_entry_throttle_client) ||
+			tbl_entry_throttle_client == tbl_entry_req ||
+			!tbl_entry_throttle_client->clk_rate)
+			continue;
+
+		now_cur_ma = tbl_entry_throttle_client->current_ma
+			[tbl_entry_throttle_client->vdd_level]
+			[peak_data->aggreg_level];
+		min_cur_ma = tbl_entry_throttle_client->current_ma[clk_min_level]
+			[peak_data->aggreg_level];
+
+		d_mpr_h("%s:csid(0x%x) name(%s)\n",
+			__func__, tbl_entry_throttle_client->clk_src_id,
+			tbl_entry_throttle_client->name);
+		d_mpr_h("%s:now_cur_ma(%llu) min_cur_ma(%llu) delta_cur(%d)\n",
+			__func__, now_cur_ma, min_cur_ma, *delta_cur);
+
+		if (now_cur_ma <= min_cur_ma)
+			continue;
+
+		cand[num_cand].idx = i;
+		cand[num_cand].now_cur_ma = now_cur_ma;
+		cand[num_cand].min_cur_ma = min_cur_ma;
+		cand[num_cand].low_pri = tbl_entry_throttle_client->pri != MMRM_CLIENT_PRIOR_HIGH;
+		num_cand++;
+	}
+
+	/* a single client of the lowest priority that absorbs the delta is preferred */
+	for (best = -1, i = 0; i < num_cand; i++) {
+		if (cand[i].now_cur_ma - cand[i].min_cur_ma <= *delta_cur)
+			continue;
+		if (best < 0 || (cand[i].low_pri && !cand[best].low_pri))
+			best = i;
+	}
+	if (best >= 0) {
+		tmp = cand[0];
+		cand[0] = cand[best];
+		cand[best] = tmp;
+		num_plan = 1;
+		planned = cand[0].now_cur_ma - cand[0].min_cur_ma;
+	} else {
+		/* otherwise order by priority, then by released current, and accumulate */
+		for (i = 0; i < num_cand; i++) {
+			for (j = i + 1; j < num_cand; j++) {
+				if ((cand[j].low_pri && !cand[i].low_pri) ||
+					(cand[j].low_pri == cand[i].low_pri &&
+					 cand[j].now_cur_ma - cand[j].min_cur_ma >
+					 cand[i].now_cur_ma - cand[i].min_cur_ma)) {
+					tmp = cand[i];
+					cand[i] = cand[j];
+					cand[j] = tmp;
+				}
 			}
 		}
 
-		d_mpr_h("%s: %s throttled to %llu\n",
-			__func__, tbl_entry_throttle_client->name,
-			tbl_entry_throttle_client->freq[clk_min_level]);
-		*delta_cur -= now_cur_ma - min_cur_ma;
+		for (i = 0; i < num_cand && planned <= *delta_cur; i++)
+			planned += cand[i].now_cur_ma - cand[i].min_cur_ma;
 
-		/* Store this client for bookkeeping */
-		tc_data = kzalloc(sizeof(*tc_data), GFP_KERNEL);
-		if (IS_ERR_OR_NULL(tc_data)) {
-			d_mpr_e("%s: Failed to allocate memory\n", __func__);
-			return -ENOMEM;
-		}
-		tc_data->table_id = i;
-		tc_data->delta_cu_ma = now_cur_ma - min_cur_ma;
-		tc_data->prev_vdd_level = tbl_entry_throttle_client->vdd_level;
-		// Add throttled client to list to access it later
-		list_add_tail(&tc_data->list, &sinfo->throttled_clients);
+		/* keep current behavior when the whole list cannot absorb the delta */
+		if (planned <= *delta_cur)
+			return 0;
+		num_plan = i;
+	}
 
-		/* Store the throttled clock rate of client */
-		tbl_entry_throttle_client->clk_rate =
-					tbl_entry_throttle_client->freq[clk_min_level];
+	/* Clients to throttle are found, throttle them now to minimum clock rate */
+	for (i = 0; i < num_plan; i++) {
+		d_mpr_h("%s: Throttle client idx(%d) cur released(%llu) delta_cur(%d)\n",
+			__func__, cand[i].idx, cand[i].now_cur_ma - cand[i].min_cur_ma,
+			*delta_cur);
 
-		/* Store the corner level of throttled client */
-		tbl_entry_throttle_client->vdd_level = clk_min_level;
+		rc = mmrm_sw_throttle_one_client(sinfo, cand[i].idx, cand[i].now_cur_ma,
+			cand[i].min_cur_ma);
+		if (rc)
+			break;
 
-		/* Clearing the reserve flag */
-		tbl_entry_throttle_client->reserve = false;
+		*delta_cur -= cand[i].now_cur_ma - cand[i].min_cur_ma;
 	}
-err_clk_set_fail:
+
 	return rc;
 }
 
@@ -704,7 +781,8 @@ static int mmrm_sw_check_peak_current(struct mmrm_sw_clk_mgr_info *sinfo,
 	int delta_cur = 0;
 
 	/* check the req level and adjust according to tbl entries */
-	rc = mmrm_sw_check_req_level(sinfo, tbl_entry->clk_src_id, req_level, &adj_level);
+	rc = mmrm_sw_check_req_level(sinfo, tbl_entry - sinfo->clk_client_tbl, req_level,
+		&adj_level);
 	if (rc) {
 		goto err_invalid_level;
 	}
@@ -755,7 +833,7 @@ static int mmrm_sw_check_peak_current(struct mmrm_sw_clk_mgr_info *sinfo,
 
 		if ((tbl_entry->pri == MMRM_CLIENT_PRIOR_HIGH)
 			&& (msm_mmrm_enable_throttle_feature > 0)) {
-			rc = mmrm_sw_throttle_low_priority_client(sinfo, &delta_cur);
+			rc = mmrm_sw_throttle_low_priority_client(sinfo, tbl_entry, &delta_cur);
 			if (rc != 0) {
 				d_mpr_e("%s: Failed to throttle the low priority client\n",
 						__func__);
@@ -861,8 +939,10 @@ static int mmrm_sw_clk_client_setval(struct mmrm_clk_mgr *sw_clk_mgr,
 			goto set_clk_rate;
 	}
 
-	/* get corresponding level */
-	if (clk_val) {
+	/* get corresponding level, the voltage corner of a given rate does not change */
+	if (clk_val && clk_val == tbl_entry->lookup_rate) {
+		req_level = tbl_entry->lookup_level;
+	} else if (clk_val) {
 		rc = mmrm_sw_get_req_level(tbl_entry, clk_val, &req_level);
 		if (rc || req_level >= MMRM_VDD_LEVEL_MAX) {
 			d_mpr_e("%s: csid(0x%x) unable to get level for clk rate %llu\n",
@@ -870,6 +950,11 @@ static int mmrm_sw_clk_client_setval(struct mmrm_clk_mgr *sw_clk_mgr,
 			rc = -EINVAL;
 			goto err_invalid_clk_val;
 		}
+		tbl_entry->lookup_rate = clk_val;
+		tbl_entry->lookup_level = req_level;
+	}
+
+	if (clk_val) {
 		if (!((client_data->num_hw_blocks >= 1) &&
 			   (client_data->num_hw_blocks <= tbl_entry->max_num_hw_blocks))) {
 			d_mpr_e("%s: csid(0x%x) num_hw_block:%d\n",
@@ -895,10 +980,12 @@ static int mmrm_sw_clk_client_setval(struct mmrm_clk_mgr *sw_clk_mgr,
 	}
 
 	/* update table entry */
+	mmrm_sw_arb_cache_update(sinfo, tbl_entry, -1);
 	tbl_entry->clk_rate = clk_val;
 	tbl_entry->vdd_level = req_level;
 	tbl_entry->reserve = req_reserve;
 	tbl_entry->num_hw_blocks = client_data->num_hw_blocks;
+	mmrm_sw_arb_cache_update(sinfo, tbl_entry, 1);
 
 	mutex_unlock(&sw_clk_mgr->lock);
 
@@ -15,11 +15,13 @@
 
 #include <linux/slab.h>
 #include <linux/clk.h>
+#include <linux/ktime.h>
 
 #include "mmrm_test_internal.h"
 
 #define MMRM_TEST_MAX_CLK_CLIENTS 30
 #define MMRM_TEST_NUM_CASES 3
+#define MMRM_TEST_BENCH_ITERATIONS 1000
 
 enum mmrm_test_result {
 	TEST_MMRM_SUCCESS = 0,
@@ -1004,3 +1006,91 @@ err_fail_alloc_result_ptr:
 
 }
 
+
+/*
+ * Measures the cost of mmrm_client_set_value() with all the clients of a testcase
+ * enabled, by toggling the last client of the case between low svs and its testcase
+ * level. Values are reserved only, so the measured time is the arbitration cost.
+ */
+static void test_mmrm_setval_benchmark_one_case(struct platform_device *pdev,
+	test_case_info_t *pcase, int index)
+{
+	struct mmrm_client_data client_data;
+	test_case_info_t *p = pcase, *last = NULL;
+	u64 start_ts, delta, total = 0, min = U64_MAX, max = 0;
+	unsigned long val[2];
+	int i, n = 0, rc = 0;
+
+	client_data = (struct mmrm_client_data){1, MMRM_CLIENT_DATA_FLAG_RESERVE_ONLY};
+
+	/* enable all the clients of the case */
+	while (p->vdd_level != MMRM_TEST_VDD_LEVEL_MAX) {
+		rc = test_mmrm_testcase_client_register(pdev, p);
+		if ((rc != TEST_MMRM_SUCCESS) || IS_ERR_OR_NULL(p->client)) {
+			pr_info("%s: client(%s) fail register\n", __func__, p->name);
+			goto exit;
+		}
+
+		client_data.num_hw_blocks = p->num_hw_blocks ? p->num_hw_blocks : 1;
+		rc = mmrm_client_set_value(p->client, &client_data,
+			p->clk_rate[p->vdd_level]);
+		if (rc) {
+			pr_info("%s: client(%s) fail set value\n", __func__, p->name);
+			goto exit;
+		}
+
+		last = p++;
+		n++;
+	}
+
+	if (!last)
+		goto exit;
+
+	val[0] = last->clk_rate[MMRM_TEST_VDD_LEVEL_LOW_SVS];
+	val[1] = last->clk_rate[last->vdd_level];
+	client_data.num_hw_blocks = last->num_hw_blocks ? last->num_hw_blocks : 1;
+
+	for (i = 0; i < MMRM_TEST_BENCH_ITERATIONS; i++) {
+		start_ts = ktime_get_ns();
+		rc = mmrm_client_set_value(last->client, &client_data, val[i & 1]);
+		delta = ktime_get_ns() - start_ts;
+		if (rc) {
+			pr_info("%s: client(%s) fail set value iteration:%d\n", __func__,
+				last->name, i);
+			goto exit;
+		}
+
+		total += delta;
+		min = min(min, delta);
+		max = max(max, delta);
+	}
+
+	pr_info("%s: testcase:%d clients:%d set_value avg(%llu ns) min(%llu ns) max(%llu ns)\n",
+		__func__, index, n, div_u64(total, MMRM_TEST_BENCH_ITERATIONS), min, max);
+
+exit:
+	p = pcase;
+	while (p->vdd_level != MMRM_TEST_VDD_LEVEL_MAX) {
+		if (!IS_ERR_OR_NULL(p->client)) {
+			mmrm_client_set_value(p->client, &client_data, 0);
+			test_mmrm_client_deregister(p->client);
+			p->client = NULL;
+		}
+		p++;
+	}
+}
+
+void test_mmrm_setval_benchmark(struct platform_device *pdev,
+	test_case_info_t **testcases, int count)
+{
+	int i;
+
+	pr_info("%s: Started\n", __func__);
+
+	test_mmrm_populate_testcase(pdev, testcases, count);
+
+	for (i = 0; i < count; i++)
+		test_mmrm_setval_benchmark_one_case(pdev, testcases[i], i);
+
+	pr_info("%s: Finish set value benchmark (%d cases)\n", __func__, count);
+}
@@ -22,6 +22,7 @@
 #include <linux/crypto.h>
 #include <linux/bitops.h>
 #include "linux/qcrypto.h"
+#include <crypto/algapi.h>
 #include <crypto/hash.h>
 #include <crypto/sha1.h>
 #include <soc/qcom/socinfo.h>
@@ -297,28 +298,12 @@ static int qce_crypto_config(struct qce_device *pce_dev,
 {
 	uint32_t config_be = 0;
 
-	switch (offload_op) {
-	case QCE_OFFLOAD_NONE:
-		config_be = qce_get_config_be(pce_dev,
-		pce_dev->ce_bam_info.pipe_pair_index[QCE_OFFLOAD_NONE]);
-		break;
-	case QCE_OFFLOAD_HLOS_HLOS:
-		config_be = qce_get_config_be(pce_dev,
-		pce_dev->ce_bam_info.pipe_pair_index[QCE_OFFLOAD_HLOS_HLOS]);
-		break;
-	case QCE_OFFLOAD_HLOS_CPB:
-		config_be = qce_get_config_be(pce_dev,
-		pce_dev->ce_bam_info.pipe_pair_index[QCE_OFFLOAD_HLOS_CPB]);
-		break;
-	case QCE_OFFLOAD_CPB_HLOS:
-		config_be = qce_get_config_be(pce_dev,
-		pce_dev->ce_bam_info.pipe_pair_index[QCE_OFFLOAD_CPB_HLOS]);
-		break;
-	default:
+	if ((unsigned int)offload_op >= QCE_OFFLOAD_OPER_LAST) {
 		pr_err("%s: Valid pipe config not set, offload op = %d\n",
 					__func__, offload_op);
 		return -EINVAL;
 	}
+	config_be = pce_dev->reg.crypto_cfg_be_op[offload_op];
 
 	pce_dev->reg.crypto_cfg_be = config_be;
 	pce_dev->reg.crypto_cfg_le = (config_be |
@@ -326,6 +311,28 @@ static int qce_crypto_config(struct qce_device *pce_dev,
 	return 0;
 }
 
+/*
+ * Command lists are reused across requests, so if the list still carries
+ * the same software key the key elements do not need to be patched again.
+ * Returns true on a hit, otherwise remembers the key the caller is about to
+ * write.
+ */
+static bool _ce_cmdlist_key_cached(struct qce_cmdlist_info *cmdlistinfo,
+		const unsigned char *key, uint32_t klen)
+{
+	if (!key || !klen || klen > sizeof(cmdlistinfo->key_cache)) {
+		cmdlistinfo->key_cache_len = 0;
+		return false;
+	}
+	if (cmdlistinfo->key_cache_len == klen &&
+			!crypto_memneq(cmdlistinfo->key_cache, key, klen))
+		return true;
+
+	memcpy(cmdlistinfo->key_cache, key, klen);
+	cmdlistinfo->key_cache_len = klen;
+	return false;
+}
+
 static void qce_enable_clock_gating(struct qce_device *pce_dev)
 {
 	/* This feature might cause some HW issues, noop till resolved. */
@@ -562,7 +569,9 @@ static int _ce_setup_hash(struct qce_device *pce_dev,
 			pce->addr = (uint32_t)(CRYPTO_GOPROC_REG +
 							pce_dev->phy_iobase);
 			pce = cmdlistinfo->auth_key;
-			if (!use_pipe_key) {
+			if (!use_pipe_key && !_ce_cmdlist_key_cached(
+					cmdlistinfo, sreq->authkey,
+					sreq->authklen)) {
 				_byte_stream_to_net_words(mackey32,
 						sreq->authkey,
 						sreq->authklen);
@@ -925,6 +934,7 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 	int i;
 	struct sps_command_element *pce = NULL;
 	bool is_des_cipher = false;
+	bool key_cached = false;
 
 	if (creq->mode == QCE_MODE_XTS)
 		key_size = creq->encklen/2;
@@ -955,8 +965,15 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 		pce->addr = (uint32_t)(CRYPTO_GOPROC_REG +
 						pce_dev->phy_iobase);
 	if (!use_pipe_key && !use_hw_key) {
-		_byte_stream_to_net_words(enckey32, creq->enckey, key_size);
+		key_cached = _ce_cmdlist_key_cached(cmdlistinfo, creq->enckey,
+							creq->encklen);
+		if (!key_cached)
+			_byte_stream_to_net_words(enckey32, creq->enckey,
+							key_size);
 		enck_size_in_word = key_size/sizeof(uint32_t);
+	} else {
+		/* pipe key requests overwrite the key elements with zeroes */
+		cmdlistinfo->key_cache_len = 0;
 	}
 
 	if ((creq->op == QCE_REQ_AEAD) && (creq->mode == QCE_MODE_CCM)) {
@@ -987,10 +1004,12 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 			auth_cfg |= (1 << CRYPTO_USE_HW_KEY_AUTH);
 		} else {
 			auth_cfg &= ~(1 << CRYPTO_USE_HW_KEY_AUTH);
-			/* write auth key */
-			pce = cmdlistinfo->auth_key;
-			for (i = 0; i < authklen32; i++, pce++)
-				pce->data = enckey32[i];
+			if (!key_cached) {
+				/* write auth key */
+				pce = cmdlistinfo->auth_key;
+				for (i = 0; i < authklen32; i++, pce++)
+					pce->data = enckey32[i];
+			}
 		}
 
 		pce = cmdlistinfo->auth_seg_cfg;
@@ -1059,7 +1078,7 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 			pce++;
 			pce->data = enciv32[1];
 		}
-		if (!use_hw_key) {
+		if (!use_hw_key && !key_cached) {
 			pce = cmdlistinfo->encr_key;
 			pce->data = enckey32[0];
 			pce++;
@@ -1080,7 +1099,7 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 			pce++;
 			pce->data = enciv32[1];
 		}
-		if (!use_hw_key) {
+		if (!use_hw_key && !key_cached) {
 			/* write encr key */
 			pce = cmdlistinfo->encr_key;
 			for (i = 0; i < 6; i++, pce++)
@@ -1096,7 +1115,7 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 			uint32_t xtsklen =
 					creq->encklen/(2 * sizeof(uint32_t));
 
-			if (!use_hw_key && !use_pipe_key) {
+			if (!use_hw_key && !use_pipe_key && !key_cached) {
 				_byte_stream_to_net_words(xtskey32,
 					(creq->enckey + creq->encklen/2),
 							creq->encklen/2);
@@ -1155,7 +1174,7 @@ static int _ce_setup_cipher(struct qce_device *pce_dev, struct qce_req *creq,
 			encr_cfg |= (CRYPTO_ENCR_KEY_SZ_AES128 <<
 					CRYPTO_ENCR_KEY_SZ);
 		} else {
-			if (!use_hw_key) {
+			if (!use_hw_key && !key_cached) {
 				/* write encr key */
 				pce = cmdlistinfo->encr_key;
 				for (i = 0; i < enck_size_in_word; i++, pce++)
@@ -4865,6 +4884,11 @@ static int qce_init_ce_cfg_val(struct qce_device *pce_dev)
 {
 	uint32_t pipe_pair =
 		pce_dev->ce_bam_info.pipe_pair_index[QCE_OFFLOAD_NONE];
+	int i;
+
+	for (i = 0; i < QCE_OFFLOAD_OPER_LAST; i++)
+		pce_dev->reg.crypto_cfg_be_op[i] = qce_get_config_be(pce_dev,
+				pce_dev->ce_bam_info.pipe_pair_index[i]);
 
 	pce_dev->reg.crypto_cfg_be = qce_get_config_be(pce_dev, pipe_pair);
 
@@ -6737,7 +6761,8 @@ int qce_close(void *handle)
 	qce_disable_clk(pce_dev);
 	__qce_deinit_clk(pce_dev);
 	mutex_unlock(&qce_iomap_mutex);
-	kfree(handle);
+	/* the command list key caches hold key material */
+	kfree_sensitive(handle);
 
 	return 0;
 }
@@ -97,6 +97,10 @@ struct qce_cmdlist_info {
 	struct sps_command_element *seg_size;
 	struct sps_command_element *go_proc;
 	ptrdiff_t size;
+
+	/* Software key currently patched into the list, 0 length if none */
+	uint8_t key_cache[SHA_HMAC_KEY_SIZE];
+	uint32_t key_cache_len;
 };
 
 struct qce_cmdlistptr_ops {
@@ -137,6 +141,8 @@ struct qce_cmdlistptr_ops {
 struct qce_ce_cfg_reg_setting {
 	uint32_t crypto_cfg_be;
 	uint32_t crypto_cfg_le;
+	/* crypto_cfg_be per offload op, computed once at probe */
+	uint32_t crypto_cfg_be_op[QCE_OFFLOAD_OPER_LAST];
 
 	uint32_t encr_cfg_aes_cbc_128;
 	uint32_t encr_cfg_aes_cbc_256;
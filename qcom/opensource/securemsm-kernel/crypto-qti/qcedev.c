@@ -55,6 +55,14 @@
 
 #define MAX_REQUEST_TIME 5000
 
+/*
+ * Max number of requests in flight in qce at once, 0 lets the engine
+ * decide (ce_hw_support.max_request). 1 restores one job at a time.
+ */
+static unsigned int max_inflight;
+module_param(max_inflight, uint, 0444);
+MODULE_PARM_DESC(max_inflight, "Max qcedev requests in flight in qce");
+
 enum qcedev_req_status {
 	QCEDEV_REQ_CURRENT = 0,
 	QCEDEV_REQ_WAITING = 1,
@@ -79,7 +87,6 @@ static uint8_t _std_init_vector_sha256_uint8[] = {
 #define QCEDEV_CTX_USE_HW_KEY		0x00000001
 #define QCEDEV_CTX_USE_PIPE_KEY		0x00000002
 
-static DEFINE_MUTEX(send_cmd_lock);
 static DEFINE_MUTEX(qcedev_sent_bw_req);
 static DEFINE_MUTEX(hash_access_lock);
 
@@ -250,10 +257,13 @@ exit_unlock_mutex:
 static int qcedev_open(struct inode *inode, struct file *file);
 static int qcedev_release(struct inode *inode, struct file *file);
 static int start_cipher_req(struct qcedev_control *podev,
+			    struct qcedev_async_req *qcedev_areq,
 			    int *current_req_info);
 static int start_offload_cipher_req(struct qcedev_control *podev,
+				struct qcedev_async_req *qcedev_areq,
 				int *current_req_info);
 static int start_sha_req(struct qcedev_control *podev,
+			 struct qcedev_async_req *qcedev_areq,
 			 int *current_req_info);
 
 static struct qcedev_control qce_dev[] = {
@@ -273,6 +283,9 @@ struct qcedev_stat {
 	u32 qcedev_enc_fail;
 	u32 qcedev_sha_success;
 	u32 qcedev_sha_fail;
+	u32 qcedev_inflight_peak;
+	u32 qcedev_pipe_req[QCE_OFFLOAD_OPER_LAST];
+	u32 qcedev_pipe_peak[QCE_OFFLOAD_OPER_LAST];
 };
 
 static struct qcedev_stat _qcedev_stat;
@@ -340,31 +353,67 @@ static int qcedev_release(struct inode *inode, struct file *file)
 	return 0;
 }
 
+/*
+ * Hand free in-flight slots to queued requests in arrival order. The slot
+ * is reserved here so a newly arriving request cannot overtake a waiter
+ * that has been woken but not yet run. Called with podev->lock held.
+ */
+static void qcedev_admit_ready(struct qcedev_control *podev)
+{
+	struct qcedev_async_req *new_req;
+
+	while (podev->active_cnt < podev->max_active &&
+			!list_empty(&podev->ready_commands)) {
+		new_req = list_first_entry(&podev->ready_commands,
+					struct qcedev_async_req, list);
+		list_del_init(&new_req->list);
+		new_req->state = QCEDEV_REQ_CURRENT;
+		podev->active_cnt++;
+		wake_up_interruptible(&new_req->wait_q);
+	}
+}
+
+/* Release the slot of a submitted request. Called with podev->lock held. */
+static void qcedev_retire_req(struct qcedev_control *podev,
+			struct qcedev_async_req *areq)
+{
+	list_del_init(&areq->list);
+	areq->state = QCEDEV_REQ_DONE;
+	podev->active_cnt--;
+	podev->pipe_active_cnt[areq->pipe]--;
+}
+
+/* qce completion context: queue the request for done_tasklet */
+static void qcedev_req_complete(struct qcedev_control *podev,
+			struct qcedev_async_req *areq)
+{
+	unsigned long flags = 0;
+
+	spin_lock_irqsave(&podev->lock, flags);
+	/* Requests already retired by the timeout path are left alone */
+	if (areq->state == QCEDEV_REQ_SUBMITTED)
+		list_move_tail(&areq->list, &podev->done_commands);
+	spin_unlock_irqrestore(&podev->lock, flags);
+
+	tasklet_schedule(&podev->done_tasklet);
+}
+
 static void req_done(unsigned long data)
 {
 	struct qcedev_control *podev = (struct qcedev_control *)data;
-	struct qcedev_async_req *areq;
+	struct qcedev_async_req *areq, *tmp;
 	unsigned long flags = 0;
-	struct qcedev_async_req *new_req = NULL;
 
 	spin_lock_irqsave(&podev->lock, flags);
-	areq = podev->active_command;
-	podev->active_command = NULL;
 
-	if (areq) {
-		areq->state = QCEDEV_REQ_DONE;
+	/* Wake up the waiters in the order qce completed their requests */
+	list_for_each_entry_safe(areq, tmp, &podev->done_commands, list) {
+		qcedev_retire_req(podev, areq);
 		if (!areq->timed_out)
 			complete(&areq->complete);
 	}
 
-	/* Look through queued requests and wake up the corresponding thread */
-	if (!list_empty(&podev->ready_commands)) {
-		new_req = container_of(podev->ready_commands.next,
-						struct qcedev_async_req, list);
-		list_del(&new_req->list);
-		new_req->state = QCEDEV_REQ_CURRENT;
-		wake_up_interruptible(&new_req->wait_q);
-	}
+	qcedev_admit_ready(podev);
 
 	spin_unlock_irqrestore(&podev->lock, flags);
 }
@@ -375,6 +424,7 @@ void qcedev_sha_req_cb(void *cookie, unsigned char *digest,
 	struct qcedev_sha_req *areq;
 	struct qcedev_control *pdev;
 	struct qcedev_handle *handle;
+	struct qcedev_async_req *qcedev_areq;
 
 	uint32_t *auth32 = (uint32_t *)authdata;
 
@@ -394,7 +444,8 @@ void qcedev_sha_req_cb(void *cookie, unsigned char *digest,
 		handle->sha_ctxt.auth_data[1] = auth32[1];
 	}
 
-	tasklet_schedule(&pdev->done_tasklet);
+	qcedev_areq = container_of(areq, struct qcedev_async_req, sha_req);
+	qcedev_req_complete(pdev, qcedev_areq);
 };
 
 
@@ -413,29 +464,23 @@ void qcedev_cipher_req_cb(void *cookie, unsigned char *icv,
 	podev = handle->cntl;
 	if (!podev)
 		return;
-	qcedev_areq = podev->active_command;
+	qcedev_areq = container_of(areq, struct qcedev_async_req, cipher_req);
 
-	if (iv && qcedev_areq)
+	if (iv && qcedev_areq->state == QCEDEV_REQ_SUBMITTED)
 		memcpy(&qcedev_areq->cipher_op_req.iv[0], iv,
 					qcedev_areq->cipher_op_req.ivlen);
-	tasklet_schedule(&podev->done_tasklet);
+	qcedev_req_complete(podev, qcedev_areq);
 };
 
 static int start_cipher_req(struct qcedev_control *podev,
+			    struct qcedev_async_req *qcedev_areq,
 			    int *current_req_info)
 {
-	struct qcedev_async_req *qcedev_areq;
 	struct qce_req creq;
 	int ret = 0;
 
 	memset(&creq, 0, sizeof(creq));
-	/* start the command on the podev->active_command */
-	qcedev_areq = podev->active_command;
 	qcedev_areq->cipher_req.cookie = qcedev_areq->handle;
-	if (qcedev_areq->cipher_op_req.use_pmem == QCEDEV_USE_PMEM) {
-		pr_err("%s: Use of PMEM is not supported\n", __func__);
-		goto unsupported;
-	}
 	creq.pmem = NULL;
 	switch (qcedev_areq->cipher_op_req.alg) {
 	case QCEDEV_ALG_DES:
@@ -541,26 +586,24 @@ void qcedev_offload_cipher_req_cb(void *cookie, unsigned char *icv,
 	podev = handle->cntl;
 	if (!podev)
 		return;
-	qcedev_areq = podev->active_command;
+	qcedev_areq = container_of(areq, struct qcedev_async_req, cipher_req);
 
-	if (iv && qcedev_areq)
+	if (iv && qcedev_areq->state == QCEDEV_REQ_SUBMITTED)
 		memcpy(&qcedev_areq->offload_cipher_op_req.iv[0], iv,
 			qcedev_areq->offload_cipher_op_req.ivlen);
 
-	tasklet_schedule(&podev->done_tasklet);
+	qcedev_req_complete(podev, qcedev_areq);
 }
 
 static int start_offload_cipher_req(struct qcedev_control *podev,
+				struct qcedev_async_req *qcedev_areq,
 				int *current_req_info)
 {
-	struct qcedev_async_req *qcedev_areq;
 	struct qce_req creq;
 	u8 patt_sz = 0, proc_data_sz = 0;
 	int ret = 0;
 
 	memset(&creq, 0, sizeof(creq));
-	/* Start the command on the podev->active_command */
-	qcedev_areq = podev->active_command;
 	qcedev_areq->cipher_req.cookie = qcedev_areq->handle;
 
 	switch (qcedev_areq->offload_cipher_op_req.alg) {
@@ -640,15 +683,13 @@ static int start_offload_cipher_req(struct qcedev_control *podev,
 }
 
 static int start_sha_req(struct qcedev_control *podev,
+			 struct qcedev_async_req *qcedev_areq,
 			 int *current_req_info)
 {
-	struct qcedev_async_req *qcedev_areq;
 	struct qce_sha_req sreq;
 	int ret = 0;
 	struct qcedev_handle *handle;
 
-	/* start the command on the podev->active_command */
-	qcedev_areq = podev->active_command;
 	handle = qcedev_areq->handle;
 
 	switch (qcedev_areq->sha_op_req.alg) {
@@ -749,83 +790,88 @@ static int submit_req(struct qcedev_async_req *qcedev_areq,
 	struct qcedev_stat *pstat;
 	int current_req_info = 0;
 	int wait = MAX_CRYPTO_WAIT_TIME;
-	struct qcedev_async_req *new_req = NULL;
 	int retries = 0;
 	int req_wait = MAX_REQUEST_TIME;
 	unsigned int crypto_wait = 0;
+	uint32_t pipe_cnt;
 
 	qcedev_areq->err = 0;
+	qcedev_areq->timed_out = false;
 	podev = handle->cntl;
 	init_waitqueue_head(&qcedev_areq->wait_q);
 
+	qcedev_areq->pipe = QCE_OFFLOAD_NONE;
+	if (qcedev_areq->op_type == QCEDEV_CRYPTO_OPER_OFFLOAD_CIPHER &&
+		qcedev_areq->offload_cipher_op_req.op < QCE_OFFLOAD_OPER_LAST)
+		qcedev_areq->pipe = qcedev_areq->offload_cipher_op_req.op;
+
 	spin_lock_irqsave(&podev->lock, flags);
 
 	/*
-	 * Service only one crypto request at a time.
-	 * Any other new requests are queued in ready_commands and woken up
-	 * only when the active command has finished successfully or when the
-	 * request times out or when the command failed when setting up.
+	 * Up to max_active requests are handed to qce at once, qce queues
+	 * them on the BAM pipes of their pipe pair and completes them from
+	 * its BAM callbacks. Any other new requests are queued in
+	 * ready_commands and woken up in arrival order whenever an in-flight
+	 * request finishes, times out or fails when setting up.
 	 */
-	do {
-		if (podev->active_command == NULL) {
-			podev->active_command = qcedev_areq;
-			qcedev_areq->state = QCEDEV_REQ_SUBMITTED;
-			switch (qcedev_areq->op_type) {
-			case QCEDEV_CRYPTO_OPER_CIPHER:
-				ret = start_cipher_req(podev,
-						&current_req_info);
-				crypto_wait = MAX_CRYPTO_WAIT_TIME;
-				break;
-			case QCEDEV_CRYPTO_OPER_OFFLOAD_CIPHER:
-				ret = start_offload_cipher_req(podev,
-						&current_req_info);
-				crypto_wait = MAX_OFFLOAD_CRYPTO_WAIT_TIME;
-				break;
-			default:
-				crypto_wait = MAX_CRYPTO_WAIT_TIME;
+	if (podev->active_cnt < podev->max_active &&
+			list_empty(&podev->ready_commands)) {
+		podev->active_cnt++;
+	} else {
+		list_add_tail(&qcedev_areq->list, &podev->ready_commands);
+		qcedev_areq->state = QCEDEV_REQ_WAITING;
+		req_wait = wait_event_interruptible_lock_irq_timeout(
+			qcedev_areq->wait_q,
+			(qcedev_areq->state == QCEDEV_REQ_CURRENT),
+			podev->lock,
+			msecs_to_jiffies(MAX_REQUEST_TIME));
+		/* qcedev_admit_ready() reserved our slot if we are CURRENT */
+		if (qcedev_areq->state != QCEDEV_REQ_CURRENT) {
+			pr_err("%s: request timed out, req_wait = %d\n",
+					__func__, req_wait);
+			list_del(&qcedev_areq->list);
+			spin_unlock_irqrestore(&podev->lock, flags);
+			return qcedev_areq->err;
+		}
+	}
+
+	qcedev_areq->state = QCEDEV_REQ_SUBMITTED;
+	list_add_tail(&qcedev_areq->list, &podev->active_commands);
 
-				ret = start_sha_req(podev,
-						&current_req_info);
-				break;
-			}
-		} else {
-			list_add_tail(&qcedev_areq->list,
-					&podev->ready_commands);
-			qcedev_areq->state = QCEDEV_REQ_WAITING;
-			req_wait = wait_event_interruptible_lock_irq_timeout(
-				qcedev_areq->wait_q,
-				(qcedev_areq->state == QCEDEV_REQ_CURRENT),
-				podev->lock,
-				msecs_to_jiffies(MAX_REQUEST_TIME));
-			if ((req_wait == 0) || (req_wait == -ERESTARTSYS)) {
-				pr_err("%s: request timed out, req_wait = %d\n",
-						__func__, req_wait);
-				list_del(&qcedev_areq->list);
-				podev->active_command = NULL;
-				spin_unlock_irqrestore(&podev->lock, flags);
-				return qcedev_areq->err;
-			}
-		}
-	} while (qcedev_areq->state != QCEDEV_REQ_SUBMITTED);
+	pstat = &_qcedev_stat;
+	pipe_cnt = ++podev->pipe_active_cnt[qcedev_areq->pipe];
+	pstat->qcedev_pipe_req[qcedev_areq->pipe]++;
+	if (pipe_cnt > pstat->qcedev_pipe_peak[qcedev_areq->pipe])
+		pstat->qcedev_pipe_peak[qcedev_areq->pipe] = pipe_cnt;
+	if (podev->active_cnt > pstat->qcedev_inflight_peak)
+		pstat->qcedev_inflight_peak = podev->active_cnt;
+
+	switch (qcedev_areq->op_type) {
+	case QCEDEV_CRYPTO_OPER_CIPHER:
+		ret = start_cipher_req(podev, qcedev_areq,
+				&current_req_info);
+		crypto_wait = MAX_CRYPTO_WAIT_TIME;
+		break;
+	case QCEDEV_CRYPTO_OPER_OFFLOAD_CIPHER:
+		ret = start_offload_cipher_req(podev, qcedev_areq,
+				&current_req_info);
+		crypto_wait = MAX_OFFLOAD_CRYPTO_WAIT_TIME;
+		break;
+	default:
+		crypto_wait = MAX_CRYPTO_WAIT_TIME;
+
+		ret = start_sha_req(podev, qcedev_areq,
+				&current_req_info);
+		break;
+	}
 
 	if (ret != 0) {
-		podev->active_command = NULL;
-		/*
-		 * Look through queued requests and wake up the corresponding
-		 * thread.
-		 */
-		if (!list_empty(&podev->ready_commands)) {
-			new_req = container_of(podev->ready_commands.next,
-						struct qcedev_async_req, list);
-			list_del(&new_req->list);
-			new_req->state = QCEDEV_REQ_CURRENT;
-			wake_up_interruptible(&new_req->wait_q);
-		}
+		qcedev_retire_req(podev, qcedev_areq);
+		qcedev_admit_ready(podev);
 	}
 
 	spin_unlock_irqrestore(&podev->lock, flags);
 
-	qcedev_areq->timed_out = false;
 	if (ret == 0)
 		wait = wait_for_completion_timeout(&qcedev_areq->complete,
 				msecs_to_jiffies(crypto_wait));
@@ -859,7 +905,12 @@ static int submit_req(struct qcedev_async_req *qcedev_areq,
 		if (ret)
 			pr_err("%s: error during manage timeout", __func__);
 
-		req_done((unsigned long) podev);
+		spin_lock_irqsave(&podev->lock, flags);
+		if (qcedev_areq->state != QCEDEV_REQ_DONE) {
+			qcedev_retire_req(podev, qcedev_areq);
+			qcedev_admit_ready(podev);
+		}
+		spin_unlock_irqrestore(&podev->lock, flags);
 		if (qcedev_areq->offload_cipher_op_req.err !=
 						QCEDEV_OFFLOAD_NO_ERROR)
 			return 0;
@@ -1714,6 +1765,233 @@ static int qcedev_vbuf_ablk_cipher(struct qcedev_async_req *areq,
 
 }
 
+/*
+ * Cipher on dma-buf fds: the engine reads and writes the buffer pages
+ * directly, one QCE_MAX_OPER_DATA sized request at a time.
+ */
+static int qcedev_pmem_ablk_cipher(struct qcedev_async_req *areq,
+				struct qcedev_handle *handle)
+{
+	struct qcedev_cipher_op_req *creq = &areq->cipher_op_req;
+	struct qcedev_reg_buf_info *src_binfo = NULL;
+	struct qcedev_reg_buf_info *dst_binfo = NULL;
+	struct sg_table sgt_src;
+	struct sg_table sgt_dst;
+	uint32_t data_len = creq->data_len;
+	unsigned long src_off, dst_off;
+	uint32_t i, len, xfer;
+	bool in_place;
+	int err = 0;
+
+	src_binfo = qcedev_get_buffer(handle, creq->pmem.fd_src);
+	if (IS_ERR(src_binfo))
+		return PTR_ERR(src_binfo);
+
+	if (creq->in_place_op) {
+		dst_binfo = src_binfo;
+	} else {
+		dst_binfo = qcedev_get_buffer(handle, creq->pmem.fd_dst);
+		if (IS_ERR(dst_binfo)) {
+			qcedev_put_buffer(handle, src_binfo);
+			return PTR_ERR(dst_binfo);
+		}
+	}
+
+	for (i = 0; i < creq->entries && !err; i++) {
+		src_off = creq->pmem.src[i].offset;
+		dst_off = creq->in_place_op ? src_off :
+					creq->pmem.dst[i].offset;
+		in_place = (dst_binfo == src_binfo) && (dst_off == src_off);
+		len = creq->pmem.src[i].len;
+
+		while (len) {
+			xfer = min_t(uint32_t, len, QCE_MAX_OPER_DATA);
+			err = qcedev_buffer_to_sg(src_binfo, src_off, xfer,
+							&sgt_src, 0);
+			if (err)
+				break;
+			if (!in_place) {
+				err = qcedev_buffer_to_sg(dst_binfo, dst_off,
+							xfer, &sgt_dst, 0);
+				if (err) {
+					sg_free_table(&sgt_src);
+					break;
+				}
+			}
+
+			areq->cipher_req.creq.src = sgt_src.sgl;
+			areq->cipher_req.creq.dst = in_place ? sgt_src.sgl :
+							sgt_dst.sgl;
+			areq->cipher_req.creq.cryptlen = xfer;
+			areq->cipher_req.creq.iv = creq->iv;
+			creq->data_len = xfer;
+
+			err = submit_req(areq, handle);
+
+			if (!in_place)
+				sg_free_table(&sgt_dst);
+			sg_free_table(&sgt_src);
+			if (err) {
+				pr_err("%s: Error processing req, err = %d\n",
+						__func__, err);
+				break;
+			}
+
+			len -= xfer;
+			src_off += xfer;
+			dst_off += xfer;
+		}
+	}
+
+	creq->data_len = data_len;
+	areq->cipher_req.creq.src = NULL;
+	areq->cipher_req.creq.dst = NULL;
+
+	if (dst_binfo != src_binfo)
+		qcedev_put_buffer(handle, dst_binfo);
+	qcedev_put_buffer(handle, src_binfo);
+
+	return err;
+}
+
+/*
+ * Hash update on a dma-buf fd, mirrors qcedev_sha_update_max_xfer(): only
+ * whole blocks go to the engine and the last (possibly full) block is kept
+ * in trailing_buf for the next update or final. Apart from that block the
+ * data is never copied.
+ */
+static int qcedev_sha_update_fd(struct qcedev_async_req *qcedev_areq,
+				struct qcedev_handle *handle, int fd)
+{
+	struct qcedev_sha_op_req *sreq = &qcedev_areq->sha_op_req;
+	struct qcedev_sha_ctxt *sha_ctxt = &handle->sha_ctxt;
+	struct qcedev_reg_buf_info *binfo = NULL;
+	uint8_t new_trailing[CE_SHA_BLOCK_SIZE];
+	struct scatterlist sg_one;
+	struct sg_table sgt;
+	uint32_t i, len, seg, total, keep, t_buf;
+	unsigned long off;
+	bool has_sgt;
+	int err = 0;
+
+	binfo = qcedev_get_buffer(handle, fd);
+	if (IS_ERR(binfo))
+		return PTR_ERR(binfo);
+
+	for (i = 0; i < sreq->entries && !err; i++) {
+		off = sreq->data[i].offset;
+		len = sreq->data[i].len;
+
+		while (len) {
+			t_buf = sha_ctxt->trailing_buf_len;
+			seg = min_t(uint32_t, len, QCE_MAX_OPER_DATA);
+			total = t_buf + seg;
+
+			if (total <= CE_SHA_BLOCK_SIZE) {
+				err = qcedev_buffer_copy(binfo, off,
+					&sha_ctxt->trailing_buf[t_buf], seg);
+				if (err)
+					break;
+				sha_ctxt->trailing_buf_len = total;
+				len -= seg;
+				off += seg;
+				continue;
+			}
+
+			keep = total % CE_SHA_BLOCK_SIZE;
+			if (!keep)
+				keep = CE_SHA_BLOCK_SIZE;
+
+			err = qcedev_buffer_copy(binfo, off + seg - keep,
+						new_trailing, keep);
+			if (err)
+				break;
+
+			has_sgt = (seg > keep);
+			if (has_sgt) {
+				err = qcedev_buffer_to_sg(binfo, off,
+						seg - keep, &sgt, t_buf ? 1 : 0);
+				if (err)
+					break;
+				if (t_buf)
+					sg_set_buf(sgt.sgl,
+						&sha_ctxt->trailing_buf[0],
+						t_buf);
+				qcedev_areq->sha_req.sreq.src = sgt.sgl;
+			} else {
+				/* Only the pending block is complete */
+				sg_init_one(&sg_one,
+					&sha_ctxt->trailing_buf[0], t_buf);
+				qcedev_areq->sha_req.sreq.src = &sg_one;
+			}
+			qcedev_areq->sha_req.sreq.nbytes = total - keep;
+
+			err = submit_req(qcedev_areq, handle);
+
+			sha_ctxt->last_blk = 0;
+			sha_ctxt->first_blk = 0;
+			if (has_sgt)
+				sg_free_table(&sgt);
+			if (err)
+				break;
+
+			memset(&sha_ctxt->trailing_buf[0], 0,
+					sizeof(sha_ctxt->trailing_buf));
+			memcpy(&sha_ctxt->trailing_buf[0], new_trailing, keep);
+			sha_ctxt->trailing_buf_len = keep;
+
+			len -= seg;
+			off += seg;
+		}
+	}
+
+	memset(new_trailing, 0, sizeof(new_trailing));
+	qcedev_areq->sha_req.sreq.src = NULL;
+	qcedev_put_buffer(handle, binfo);
+
+	return err;
+}
+
+static int qcedev_hash_cmac_fd(struct qcedev_async_req *qcedev_areq,
+				struct qcedev_handle *handle, int fd)
+{
+	struct qcedev_sha_op_req *sreq = &qcedev_areq->sha_op_req;
+	struct qcedev_reg_buf_info *binfo = NULL;
+	struct sg_table sgt;
+	int err = 0;
+
+	/* The engine sees one contiguous CMAC message per request */
+	if (sreq->entries != 1) {
+		pr_err("%s: fd CMAC needs a single data entry\n", __func__);
+		return -EINVAL;
+	}
+
+	if (copy_from_user(&handle->sha_ctxt.authkey[0],
+				(void __user *)sreq->authkey,
+				sreq->authklen))
+		return -EFAULT;
+
+	binfo = qcedev_get_buffer(handle, fd);
+	if (IS_ERR(binfo))
+		return PTR_ERR(binfo);
+
+	err = qcedev_buffer_to_sg(binfo, sreq->data[0].offset,
+					sreq->data_len, &sgt, 0);
+	if (err)
+		goto exit;
+
+	qcedev_areq->sha_req.sreq.src = sgt.sgl;
+	qcedev_areq->sha_req.sreq.nbytes = sreq->data_len;
+	handle->sha_ctxt.diglen = sreq->diglen;
+	err = submit_req(qcedev_areq, handle);
+
+	sg_free_table(&sgt);
+	qcedev_areq->sha_req.sreq.src = NULL;
+exit:
+	qcedev_put_buffer(handle, binfo);
+	return err;
+}
+
 static int qcedev_smmu_ablk_offload_cipher(struct qcedev_async_req *areq,
 				       struct qcedev_handle *handle)
 {
@@ -1837,14 +2115,49 @@ error:
 	return -EINVAL;
 }
 
+static int qcedev_check_cipher_pmem(struct qcedev_cipher_op_req *req)
+{
+	uint32_t total = 0;
+	uint32_t i;
+
+	if (req->pmem.fd_src < 0 ||
+		(!req->in_place_op && req->pmem.fd_dst < 0)) {
+		pr_err("%s: Invalid buffer fd\n", __func__);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < req->entries; i++) {
+		if (!req->in_place_op &&
+			req->pmem.dst[i].len != req->pmem.src[i].len) {
+			pr_err("%s: src/dst[%d] length mismatch\n",
+							__func__, i);
+			return -EINVAL;
+		}
+		if (req->pmem.src[i].len > U32_MAX - total) {
+			pr_err("%s: Integer overflow on total src length\n",
+							__func__);
+			return -EINVAL;
+		}
+		total += req->pmem.src[i].len;
+	}
+
+	if (total != req->data_len) {
+		pr_err("%s: Total src(%d) buf size != data_len (%d)\n",
+				__func__, total, req->data_len);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int qcedev_check_cipher_params(struct qcedev_cipher_op_req *req,
 						struct qcedev_control *podev)
 {
 	uint32_t total = 0;
 	uint32_t i;
 
-	if (req->use_pmem) {
-		pr_err("%s: Use of PMEM is not supported\n", __func__);
+	if (req->use_pmem && req->use_pmem != QCEDEV_USE_PMEM) {
+		pr_err("%s: Invalid use_pmem %d\n", __func__, req->use_pmem);
 		goto error;
 	}
 	if ((req->entries == 0) || (req->data_len == 0) ||
@@ -1879,6 +2192,11 @@ static int qcedev_check_cipher_params(struct qcedev_cipher_op_req *req,
 			pr_err("%s: Invalid byte offset\n", __func__);
 			goto error;
 		}
+		if (req->use_pmem) {
+			pr_err("%s: byte offset not supported on fd buffers\n",
+								__func__);
+			goto error;
+		}
 		total = req->byteoffset;
 		for (i = 0; i < req->entries; i++) {
 			if (total > U32_MAX - req->vbuf.src[i].len) {
@@ -1922,6 +2240,9 @@ static int qcedev_check_cipher_params(struct qcedev_cipher_op_req *req,
 			goto error;
 		}
 	}
+	if (req->use_pmem)
+		return qcedev_check_cipher_pmem(req);
+
 	/* Check for sum of all dst length is equal to data_len  */
 	for (i = 0, total = 0; i < req->entries; i++) {
 		if (!req->vbuf.dst[i].vaddr && req->vbuf.dst[i].len) {
@@ -2209,7 +2530,10 @@ long qcedev_ioctl(struct file *file,
 			goto exit_free_qcedev_areq;
 		}
 
-		err = qcedev_vbuf_ablk_cipher(qcedev_areq, handle);
+		if (qcedev_areq->cipher_op_req.use_pmem == QCEDEV_USE_PMEM)
+			err = qcedev_pmem_ablk_cipher(qcedev_areq, handle);
+		else
+			err = qcedev_vbuf_ablk_cipher(qcedev_areq, handle);
 		if (err)
 			goto exit_free_qcedev_areq;
 		K_COPY_TO_USER(err, arg,
@@ -2340,6 +2664,59 @@ long qcedev_ioctl(struct file *file,
 		}
 		break;
 	}
+	case QCEDEV_IOCTL_SHA_UPDATE_FD_REQ: {
+		struct qcedev_sha_fd_op_req fd_req;
+
+		K_COPY_FROM_USER(err, &fd_req, arg, sizeof(fd_req));
+		if (err) {
+			err = -EFAULT;
+			goto exit_free_qcedev_areq;
+		}
+		memcpy(&qcedev_areq->sha_op_req, &fd_req.sha_op_req,
+					sizeof(struct qcedev_sha_op_req));
+		mutex_lock(&hash_access_lock);
+		if (qcedev_check_sha_params(&qcedev_areq->sha_op_req, podev)) {
+			mutex_unlock(&hash_access_lock);
+			err = -EINVAL;
+			goto exit_free_qcedev_areq;
+		}
+		qcedev_areq->op_type = QCEDEV_CRYPTO_OPER_SHA;
+
+		if (qcedev_areq->sha_op_req.alg == QCEDEV_ALG_AES_CMAC) {
+			err = qcedev_hash_cmac_fd(qcedev_areq, handle,
+							fd_req.fd);
+		} else if (!handle->sha_ctxt.init_done) {
+			pr_err("%s Init was not called\n", __func__);
+			err = -EINVAL;
+		} else {
+			err = qcedev_sha_update_fd(qcedev_areq, handle,
+							fd_req.fd);
+		}
+		if (err) {
+			mutex_unlock(&hash_access_lock);
+			goto exit_free_qcedev_areq;
+		}
+
+		if (handle->sha_ctxt.diglen > QCEDEV_MAX_SHA_DIGEST) {
+			pr_err("Invalid sha_ctxt.diglen %d\n",
+					handle->sha_ctxt.diglen);
+			mutex_unlock(&hash_access_lock);
+			err = -EINVAL;
+			goto exit_free_qcedev_areq;
+		}
+		memcpy(&qcedev_areq->sha_op_req.digest[0],
+				&handle->sha_ctxt.digest[0],
+				handle->sha_ctxt.diglen);
+		mutex_unlock(&hash_access_lock);
+		memcpy(&fd_req.sha_op_req, &qcedev_areq->sha_op_req,
+					sizeof(struct qcedev_sha_op_req));
+		K_COPY_TO_USER(err, arg, &fd_req, sizeof(fd_req));
+		if (err) {
+			err = -EFAULT;
+			goto exit_free_qcedev_areq;
+		}
+		break;
+	}
 	case QCEDEV_IOCTL_SHA_FINAL_REQ: {
 		if (!handle->sha_ctxt.init_done) {
 			pr_err("%s Init was not called\n", __func__);
@@ -2537,7 +2914,10 @@ static int qcedev_probe_device(struct platform_device *pdev)
 
 	podev->high_bw_req_count = 0;
 	INIT_LIST_HEAD(&podev->ready_commands);
-	podev->active_command = NULL;
+	INIT_LIST_HEAD(&podev->active_commands);
+	INIT_LIST_HEAD(&podev->done_commands);
+	podev->active_cnt = 0;
+	memset(podev->pipe_active_cnt, 0, sizeof(podev->pipe_active_cnt));
 
 	INIT_LIST_HEAD(&podev->context_banks);
 
@@ -2602,6 +2982,12 @@ static int qcedev_probe_device(struct platform_device *pdev)
 	platform_set_drvdata(pdev, podev);
 
 	qce_hw_support(podev->qce, &podev->ce_support);
+	podev->max_active = max_inflight ? max_inflight :
+					podev->ce_support.max_request;
+	if (podev->ce_support.max_request)
+		podev->max_active = min(podev->max_active,
+					podev->ce_support.max_request);
+	podev->max_active = max_t(uint32_t, podev->max_active, 1);
 	if (podev->ce_support.bam) {
 		podev->platform_support.ce_shared = 0;
 		podev->platform_support.shared_ce_resource = 0;
@@ -2804,6 +3190,7 @@ static int _disp_stats(int id)
 {
 	struct qcedev_stat *pstat;
 	int len = 0;
+	int i;
 
 	pstat = &_qcedev_stat;
 	len = scnprintf(_debug_read_buf, DEBUG_MAX_RW_BUF - 1,
@@ -2824,6 +3211,18 @@ static int _disp_stats(int id)
 			"   Encryption operation fail          : %d\n",
 					pstat->qcedev_dec_fail);
 
+	len += scnprintf(_debug_read_buf + len, DEBUG_MAX_RW_BUF - len - 1,
+			"   Max in flight (peak)        : %u (%u)\n",
+					qce_dev[id].max_active,
+					pstat->qcedev_inflight_peak);
+	for (i = 0; i < QCE_OFFLOAD_OPER_LAST; i++)
+		len += scnprintf(_debug_read_buf + len,
+			DEBUG_MAX_RW_BUF - len - 1,
+			"   Pipe %d requests/in flight/peak : %u/%u/%u\n",
+					i, pstat->qcedev_pipe_req[i],
+					qce_dev[id].pipe_active_cnt[i],
+					pstat->qcedev_pipe_peak[i]);
+
 	return len;
 }
 
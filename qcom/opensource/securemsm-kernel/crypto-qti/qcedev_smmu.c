@@ -189,6 +189,7 @@ static int ion_map_buffer(struct qcedev_handle *qce_hndl,
 		binfo->ion_buf.mapping_info.attach = attach;
 		binfo->ion_buf.mapping_info.buf = buf;
 		binfo->ion_buf.ion_fd = fd;
+		binfo->ion_buf.is_secure = cb->is_secure;
 	} else {
 		pr_err("%s: err: smmu not enabled\n", __func__);
 		rc = -EIO;
@@ -403,6 +404,181 @@ int qcedev_check_and_unmap_buffer(void *handle, int fd)
 	return 0;
 }
 
+/*
+ * qcedev_get_buffer - look up or map a dma-buf fd in the handle registry
+ *
+ * Buffers registered through QCEDEV_IOCTL_MAP_BUF_REQ stay mapped, so
+ * repeated requests on them only take a reference. Unregistered fds are
+ * mapped here and unmapped again by the matching qcedev_put_buffer().
+ */
+struct qcedev_reg_buf_info *qcedev_get_buffer(void *handle, int fd)
+{
+	struct qcedev_handle *qce_hndl = handle;
+	struct qcedev_reg_buf_info *binfo = NULL, *temp = NULL;
+	struct qcedev_mem_client *mem_client = NULL;
+	struct dma_buf *buf = NULL;
+	int rc = 0;
+
+	if (!handle || fd < 0)
+		return ERR_PTR(-EINVAL);
+
+	if (!qce_hndl->cntl || !qce_hndl->cntl->mem_client)
+		return ERR_PTR(-EINVAL);
+	mem_client = qce_hndl->cntl->mem_client;
+
+	if (mem_client->mtype != MEM_ION)
+		return ERR_PTR(-EPERM);
+
+	/* fd numbers get reused, match on the dma-buf behind them too */
+	buf = dma_buf_get(fd);
+	if (IS_ERR_OR_NULL(buf))
+		return ERR_PTR(-EINVAL);
+
+	mutex_lock(&qce_hndl->registeredbufs.lock);
+	list_for_each_entry(temp, &qce_hndl->registeredbufs.list, list) {
+		if (temp->ion_buf.ion_fd == fd &&
+			temp->ion_buf.mapping_info.buf == buf) {
+			atomic_inc(&temp->ref_count);
+			binfo = temp;
+			break;
+		}
+	}
+	mutex_unlock(&qce_hndl->registeredbufs.lock);
+	dma_buf_put(buf);
+
+	if (binfo)
+		return binfo;
+
+	binfo = kzalloc(sizeof(*binfo), GFP_KERNEL);
+	if (!binfo)
+		return ERR_PTR(-ENOMEM);
+
+	rc = qcedev_map_buffer(qce_hndl, mem_client, fd, 0, binfo);
+	if (rc) {
+		pr_err("%s: err: failed to map fd (%d) error = %d\n",
+			__func__, fd, rc);
+		kfree(binfo);
+		return ERR_PTR(rc);
+	}
+	atomic_set(&binfo->ref_count, 1);
+
+	mutex_lock(&qce_hndl->registeredbufs.lock);
+	list_add_tail(&binfo->list, &qce_hndl->registeredbufs.list);
+	mutex_unlock(&qce_hndl->registeredbufs.lock);
+
+	return binfo;
+}
+
+void qcedev_put_buffer(void *handle, struct qcedev_reg_buf_info *binfo)
+{
+	struct qcedev_handle *qce_hndl = handle;
+
+	mutex_lock(&qce_hndl->registeredbufs.lock);
+	if (atomic_dec_and_test(&binfo->ref_count)) {
+		qcedev_unmap_buffer(qce_hndl, qce_hndl->cntl->mem_client,
+				binfo);
+		list_del(&binfo->list);
+		kfree(binfo);
+	}
+	mutex_unlock(&qce_hndl->registeredbufs.lock);
+}
+
+/*
+ * qcedev_buffer_to_sg - describe a byte range of a mapped buffer as pages
+ *
+ * The table references the buffer pages directly so qce can DMA map them
+ * for the engine, no data is copied. The first @prefix entries are left
+ * for the caller to fill in (e.g. a pending hash block).
+ */
+int qcedev_buffer_to_sg(struct qcedev_reg_buf_info *binfo,
+		unsigned long offset, unsigned int len,
+		struct sg_table *sgt, unsigned int prefix)
+{
+	struct sg_table *table = binfo->ion_buf.mapping_info.table;
+	struct scatterlist *sg = NULL, *out = NULL;
+	unsigned long skip, pos;
+	unsigned int nents = 0, seg, i;
+	size_t remain;
+	int rc;
+
+	/* HLOS has no access to the pages of secure buffers */
+	if (binfo->ion_buf.is_secure)
+		return -EPERM;
+
+	if (!len || offset > binfo->ion_buf.mapping_info.buf->size ||
+		len > binfo->ion_buf.mapping_info.buf->size - offset)
+		return -ERANGE;
+
+	skip = offset;
+	remain = len;
+	for_each_sg(table->sgl, sg, table->orig_nents, i) {
+		if (skip >= sg->length) {
+			skip -= sg->length;
+			continue;
+		}
+		seg = min_t(size_t, sg->length - skip, remain);
+		remain -= seg;
+		skip = 0;
+		nents++;
+		if (!remain)
+			break;
+	}
+	if (remain)
+		return -ERANGE;
+
+	rc = sg_alloc_table(sgt, nents + prefix, GFP_KERNEL);
+	if (rc)
+		return rc;
+
+	out = sgt->sgl;
+	for (i = 0; i < prefix; i++)
+		out = sg_next(out);
+
+	skip = offset;
+	remain = len;
+	for_each_sg(table->sgl, sg, table->orig_nents, i) {
+		if (skip >= sg->length) {
+			skip -= sg->length;
+			continue;
+		}
+		if (!sg_page(sg)) {
+			sg_free_table(sgt);
+			return -EINVAL;
+		}
+		seg = min_t(size_t, sg->length - skip, remain);
+		pos = sg->offset + skip;
+		sg_set_page(out, nth_page(sg_page(sg), pos >> PAGE_SHIFT),
+				seg, offset_in_page(pos));
+		out = sg_next(out);
+		remain -= seg;
+		skip = 0;
+		if (!remain)
+			break;
+	}
+
+	return 0;
+}
+
+/* qcedev_buffer_copy - copy a small byte range out of a mapped buffer */
+int qcedev_buffer_copy(struct qcedev_reg_buf_info *binfo,
+		unsigned long offset, void *dst, unsigned int len)
+{
+	struct sg_table *table = binfo->ion_buf.mapping_info.table;
+
+	if (binfo->ion_buf.is_secure)
+		return -EPERM;
+
+	if (offset > binfo->ion_buf.mapping_info.buf->size ||
+		len > binfo->ion_buf.mapping_info.buf->size - offset)
+		return -ERANGE;
+
+	if (sg_pcopy_to_buffer(table->sgl, table->orig_nents, dst, len,
+			offset) != len)
+		return -EINVAL;
+
+	return 0;
+}
+
 int qcedev_unmap_all_buffers(void *handle)
 {
 	struct qcedev_reg_buf_info *binfo = NULL;
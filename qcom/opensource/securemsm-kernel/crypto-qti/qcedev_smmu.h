@@ -51,6 +51,7 @@ struct qcedev_ion_buf_info {
 	dma_addr_t iova;
 	unsigned long mapped_buf_size;
 	int ion_fd;
+	bool is_secure;
 };
 
 struct qcedev_reg_buf_info {
@@ -74,6 +75,13 @@ int qcedev_check_and_map_buffer(void *qce_hndl,
 		unsigned long long *vaddr);
 int qcedev_check_and_unmap_buffer(void *handle, int fd);
 int qcedev_unmap_all_buffers(void *handle);
+struct qcedev_reg_buf_info *qcedev_get_buffer(void *handle, int fd);
+void qcedev_put_buffer(void *handle, struct qcedev_reg_buf_info *binfo);
+int qcedev_buffer_to_sg(struct qcedev_reg_buf_info *binfo,
+		unsigned long offset, unsigned int len,
+		struct sg_table *sgt, unsigned int prefix);
+int qcedev_buffer_copy(struct qcedev_reg_buf_info *binfo,
+		unsigned long offset, void *dst, unsigned int len);
 
 extern struct qcedev_reg_buf_info *global_binfo_in;
 extern struct qcedev_reg_buf_info *global_binfo_out;
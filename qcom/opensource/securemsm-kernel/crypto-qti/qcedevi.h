@@ -69,6 +69,8 @@ struct qcedev_async_req {
 	wait_queue_head_t			wait_q;
 	uint16_t				state;
 	bool					timed_out;
+	/* qce pipe pair class (enum qce_offload_op_enum) this job runs on */
+	uint16_t				pipe;
 };
 
 /**********************************************************************
@@ -110,7 +112,13 @@ struct qcedev_control {
 	unsigned int magic;
 
 	struct list_head ready_commands;
-	struct qcedev_async_req *active_command;
+	/* submitted to qce, completion pending */
+	struct list_head active_commands;
+	/* completed by qce, waiting for done_tasklet */
+	struct list_head done_commands;
+	uint32_t active_cnt;
+	uint32_t max_active;
+	uint32_t pipe_active_cnt[QCE_OFFLOAD_OPER_LAST];
 	spinlock_t lock;
 	struct tasklet_struct done_tasklet;
 	struct list_head context_banks;
@@ -225,6 +225,7 @@ struct crypto_priv {
 	unsigned int queue_work_not_eng3_nz;
 	unsigned int max_resp_qlen;
 	unsigned int max_reorder_cnt;
+	unsigned int max_issue_batch;
 	unsigned int cpu_req[MAX_SMP_CPU+1];
 };
 static struct crypto_priv qcrypto_dev;
@@ -1268,6 +1269,9 @@ static int _disp_stats(int id)
 	len += scnprintf(_debug_read_buf + len, DEBUG_MAX_RW_BUF - len - 1,
 			"   max queue length, no avail          : %u %u\n",
 					cp->max_qlen, cp->no_avail);
+	len += scnprintf(_debug_read_buf + len, DEBUG_MAX_RW_BUF - len - 1,
+			"   max requests issued per call        : %u\n",
+					cp->max_issue_batch);
 	len += scnprintf(_debug_read_buf + len, DEBUG_MAX_RW_BUF - len - 1,
 			"   work queue                          : %u %u %u\n",
 					cp->queue_work_eng3,
@@ -2237,6 +2241,7 @@ static int _start_qcrypto_process(struct crypto_priv *cp,
 	struct qcrypto_resp_ctx *arsp;
 	struct qcrypto_req_control *pqcrypto_req_control;
 	unsigned int cpu = MAX_SMP_CPU;
+	unsigned int issued = 0;
 
 	if (READ_ONCE(cp->ce_req_proc_sts) == STOPPED)
 		return 0;
@@ -2250,21 +2255,24 @@ static int _start_qcrypto_process(struct crypto_priv *cp,
 
 	pstat = &_qcrypto_stat;
 
+	/*
+	 * Keep issuing until the engine is full or both queues are empty,
+	 * so requests queued while another context held issue_req go to
+	 * qce back to back instead of waiting for the next completion.
+	 */
 again:
+	backlog_cp = NULL;
 	spin_lock_irqsave(&cp->lock, flags);
 	if (pengine->issue_req ||
-		atomic_read(&pengine->req_count) >= (pengine->max_req)) {
-		spin_unlock_irqrestore(&cp->lock, flags);
-		return 0;
-	}
+		atomic_read(&pengine->req_count) >= (pengine->max_req) ||
+		READ_ONCE(cp->ce_req_proc_sts) == STOPPED)
+		goto out;
 
 	backlog_eng = crypto_get_backlog(&pengine->req_queue);
 
 	/* make sure it is in high bandwidth state */
-	if (pengine->bw_state != BUS_HAS_BANDWIDTH) {
-		spin_unlock_irqrestore(&cp->lock, flags);
-		return 0;
-	}
+	if (pengine->bw_state != BUS_HAS_BANDWIDTH)
+		goto out;
 
 	/* try to get request from request queue of the engine first */
 	async_req = crypto_dequeue_request(&pengine->req_queue);
@@ -2275,16 +2283,13 @@ again:
 		 */
 		backlog_cp = crypto_get_backlog(&cp->req_queue);
 		async_req = crypto_dequeue_request(&cp->req_queue);
-		if (!async_req) {
-			spin_unlock_irqrestore(&cp->lock, flags);
-			return 0;
-		}
+		if (!async_req)
+			goto out;
 	}
 	pqcrypto_req_control = qcrypto_alloc_req_control(pengine);
 	if (pqcrypto_req_control == NULL) {
 		pr_err("Allocation of request failed\n");
-		spin_unlock_irqrestore(&cp->lock, flags);
-		return 0;
+		goto out;
 	}
 
 	/* add associated rsp entry to tfm response queue */
@@ -2374,7 +2379,14 @@ again:
 		_qcrypto_tfm_complete(pengine, type, tfm_ctx, arsp, ret);
 		goto again;
 	}
-	return ret;
+	issued++;
+	goto again;
+
+out:
+	if (issued > cp->max_issue_batch)
+		cp->max_issue_batch = issued;
+	spin_unlock_irqrestore(&cp->lock, flags);
+	return 0;
 }
 
 static inline struct crypto_engine *_next_eng(struct crypto_priv *cp,
@@ -22,6 +22,8 @@
 #include <linux/completion.h>
 #include <linux/errno.h>
 #include <linux/kthread.h>
+#include <linux/workqueue.h>
+#include <linux/ktime.h>
 #include <linux/hdcp_qseecom.h>
 #if IS_ENABLED(CONFIG_QSEECOM_PROXY)
 #include <linux/qseecom_kernel.h>
@@ -575,6 +577,25 @@ static struct qseecom_handle *hdcpsrm_qseecom_handle_g;
 static int hdcp2_app_started;
 static DEFINE_MUTEX(hdcp2_mutex_g);
 
+/*
+ * Once the last HDCP 2.x user stops, the TAs are kept loaded and
+ * initialized for hdcp2_app_linger_ms before they are shut down. A sink
+ * reconnecting or a display resuming within that window restarts on the
+ * live TA, skipping the TA load and init, and still finds the pairing
+ * state the TA keeps for receivers it has authenticated. This lets the
+ * TA answer AKE_Send_Cert with AKE_Stored_km. Zero restores the
+ * immediate unload.
+ */
+static uint hdcp2_app_linger_ms = 30000;
+module_param(hdcp2_app_linger_ms, uint, 0644);
+MODULE_PARM_DESC(hdcp2_app_linger_ms,
+	"time in ms to keep the HDCP 2.x TA loaded after its last user stops");
+
+static bool hdcp2_app_lingering;
+static void hdcp2_app_release_work_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(hdcp2_app_release_work,
+		hdcp2_app_release_work_fn);
+
 static struct qseecom_handle *hdcp1_qseecom_handle_g;
 static int hdcp1_app_started;
 static DEFINE_MUTEX(hdcp1_mutex_g);
@@ -812,6 +833,7 @@ error:
 static int hdcp2_app_load(struct hdcp2_handle *handle)
 {
 	int rc = 0;
+	ktime_t start = ktime_get();
 
 	if (!handle) {
 		pr_err("invalid input\n");
@@ -861,7 +883,11 @@ static int hdcp2_app_load(struct hdcp2_handle *handle)
 		handle->tx_init = hdcp2_app_tx_init;
 	}
 
-	if (!hdcp2_app_started) {
+	if (!hdcp2_app_started && hdcp2_app_lingering) {
+		/* TAs were left initialized by the last unload, reuse them */
+		cancel_delayed_work(&hdcp2_app_release_work);
+		hdcp2_app_lingering = false;
+	} else if (!hdcp2_app_started) {
 		rc = handle->app_init(handle);
 		if (rc) {
 			pr_err("app init failed\n");
@@ -872,9 +898,12 @@ static int hdcp2_app_load(struct hdcp2_handle *handle)
 	hdcp2_app_started++;
 
 	handle->hdcp_state |= HDCP_STATE_APP_LOADED;
+	pr_debug("%s app loaded in %lld us\n", handle->app_name,
+		ktime_us_delta(ktime_get(), start));
 	return rc;
 get_version_error:
 	if (!hdcp2_app_started) {
+		hdcp2_app_lingering = false;
 		qseecom_shutdown_app(&hdcpsrm_qseecom_handle_g);
 		hdcpsrm_qseecom_handle_g = NULL;
 	}
@@ -889,29 +918,60 @@ error:
 	return rc;
 }
 
-static int hdcp2_app_unload(struct hdcp2_handle *handle)
+static int hdcp2_app_shutdown(struct hdcp2_handle *handle)
 {
 	int rc = 0;
 
 	hdcp2_app_init_var(deinit);
 
-	hdcp2_app_started--;
-	if (!hdcp2_app_started) {
+	hdcp2_app_process_cmd(deinit);
+	/* deallocate the resources for qseecom HDCPSRM handle */
+	rc = qseecom_shutdown_app(&handle->hdcpsrm_qseecom_handle);
+	if (rc)
+		pr_err("qseecom_shutdown_app failed for HDCPSRM (%d)\n", rc);
 
-		hdcp2_app_process_cmd(deinit);
-		/* deallocate the resources for qseecom HDCPSRM handle */
-		rc = qseecom_shutdown_app(&handle->hdcpsrm_qseecom_handle);
-		if (rc)
-			pr_err("qseecom_shutdown_app failed for HDCPSRM (%d)\n", rc);
+	hdcpsrm_qseecom_handle_g = NULL;
+	/* deallocate the resources for qseecom HDCP2P2 handle */
+	rc = qseecom_shutdown_app(&handle->qseecom_handle);
+	if (rc) {
+		pr_err("qseecom_shutdown_app failed for HDCP2P2 (%d)\n", rc);
+		return rc;
+	}
+	qseecom_handle_g = NULL;
+	return rc;
+error:
+	qseecom_shutdown_app(&handle->hdcpsrm_qseecom_handle);
+	return rc;
+}
 
-		hdcpsrm_qseecom_handle_g = NULL;
-		/* deallocate the resources for qseecom HDCP2P2 handle */
-		rc = qseecom_shutdown_app(&handle->qseecom_handle);
-		if (rc) {
-			pr_err("qseecom_shutdown_app failed for HDCP2P2 (%d)\n", rc);
+static void hdcp2_app_release_work_fn(struct work_struct *work)
+{
+	struct hdcp2_handle handle = {0};
+
+	mutex_lock(&hdcp2_mutex_g);
+	if (hdcp2_app_lingering && !hdcp2_app_started) {
+		handle.qseecom_handle = qseecom_handle_g;
+		handle.hdcpsrm_qseecom_handle = hdcpsrm_qseecom_handle_g;
+		hdcp2_app_shutdown(&handle);
+		hdcp2_app_lingering = false;
+		pr_debug("%s app released\n", HDCP2P2_APP_NAME);
+	}
+	mutex_unlock(&hdcp2_mutex_g);
+}
+
+static int hdcp2_app_unload(struct hdcp2_handle *handle)
+{
+	int rc = 0;
+
+	hdcp2_app_started--;
+	if (!hdcp2_app_started && hdcp2_app_linger_ms) {
+		hdcp2_app_lingering = true;
+		mod_delayed_work(system_wq, &hdcp2_app_release_work,
+				msecs_to_jiffies(hdcp2_app_linger_ms));
+	} else if (!hdcp2_app_started) {
+		rc = hdcp2_app_shutdown(handle);
+		if (rc)
 			return rc;
-		}
-		qseecom_handle_g = NULL;
 	}
 	handle->qseecom_handle = NULL;
 	handle->hdcpsrm_qseecom_handle = NULL;
@@ -920,10 +980,6 @@ static int hdcp2_app_unload(struct hdcp2_handle *handle)
 	pr_debug("%s app unloaded\n", handle->app_name);
 
 	return rc;
-error:
-	if (!hdcp2_app_started)
-		qseecom_shutdown_app(&handle->hdcpsrm_qseecom_handle);
-	return rc;
 }
 
 static int hdcp2_verify_key(struct hdcp2_handle *handle)
@@ -2040,7 +2096,12 @@ void hdcp1_stop(void *data)
 EXPORT_SYMBOL(hdcp1_stop);
 
 static int __init hdcp_module_init(void){ return 0; }
-static void __exit hdcp_module_exit(void){ return; }
+static void __exit hdcp_module_exit(void)
+{
+	/* drop a TA still lingering after its last user */
+	if (cancel_delayed_work_sync(&hdcp2_app_release_work))
+		hdcp2_app_release_work_fn(&hdcp2_app_release_work.work);
+}
 
 MODULE_LICENSE("GPL v2");
 MODULE_DESCRIPTION("HDCP driver");
@@ -146,11 +146,10 @@ struct	qcedev_vbuf_info {
 
 /**
  * struct qcedev_pmem_info - Stores PMEM buffer information
- * @fd_src:			Handle to /dev/adsp_pmem used to allocate
- *				memory for input/src buffer
+ * @fd_src:			dma-buf fd of the input/src buffer
  * @src:				Array of buf_info for input/source
- * @fd_dst:			Handle to /dev/adsp_pmem used to allocate
- *				memory for output/dst buffer
+ * @fd_dst:			dma-buf fd of the output/dst buffer
+ *				(ignored for in_place_op)
  * @dst:				Array of buf_info for output/destination
  * @pmem_src_offset:		The offset from input/src buffer
  *				(allocated by PMEM)
@@ -196,13 +195,11 @@ struct	qcedev_pmem_info {
  * space buffer (data_src/dta_dst) and process accordingly and copy data back
  * to the user space buffer
  *
- * If use_pmem is set to 1, the driver assumes that memory was allocated via
- * PMEM.
- * The kernel driver will use the fd_src to determine the kernel virtual address
- * base that maps to the user space virtual address base for the  buffer
- * allocated in user space.
- * The final input/src and output/dst buffer pointer will be determined
- * by adding the offsets to the kernel virtual addr.
+ * If use_pmem is set to 1, the driver assumes that memory was allocated as
+ * a dma-buf (fd_src/fd_dst) and hands the buffer pages to the engine at
+ * the given offsets without copying. Buffers mapped with
+ * QCEDEV_IOCTL_MAP_BUF_REQ stay mapped across requests. byteoffset is not
+ * supported with use_pmem, each dst entry must match its src entry length.
  *
  * If use of hardware key is supported in the target, user can configure the
  * key parameters (encklen, enckey) to use the hardware key.
@@ -250,6 +247,20 @@ struct	qcedev_sha_op_req {
 	enum qcedev_sha_alg_enum	alg;
 };
 
+/**
+ * struct qcedev_sha_fd_op_req - Holds a hashing request on a dma-buf
+ * @sha_op_req (IN/OUT):	Hashing request information, data[].offset is
+ *				the offset of each segment within the buffer
+ * @fd (IN):			dma-buf fd holding the data to be hashed
+ *
+ * Handled like QCEDEV_IOCTL_SHA_UPDATE_REQ/QCEDEV_IOCTL_GET_CMAC_REQ but
+ * the buffer pages are handed to the engine without copying.
+ */
+struct	qcedev_sha_fd_op_req {
+	struct qcedev_sha_op_req	sha_op_req;
+	int				fd;
+};
+
 /**
  * struct pattern_info - Holds pattern information for pattern-based
  * decryption/encryption for AES ECB, counter, and CBC modes.
@@ -381,4 +392,6 @@ struct file;
 	_IOWR(QCEDEV_IOC_MAGIC, 11, struct qcedev_unmap_buf_req)
 #define QCEDEV_IOCTL_OFFLOAD_OP_REQ		\
 	_IOWR(QCEDEV_IOC_MAGIC, 12, struct qcedev_offload_cipher_op_req)
+#define QCEDEV_IOCTL_SHA_UPDATE_FD_REQ	\
+	_IOWR(QCEDEV_IOC_MAGIC, 13, struct qcedev_sha_fd_op_req)
 #endif /* _QCEDEV__H */
@@ -24,6 +24,8 @@
 #include <crypto/internal/rng.h>
 #include <linux/interconnect.h>
 #include <linux/sched/signal.h>
+#include <linux/kfifo.h>
+#include <linux/workqueue.h>
 
 #define DRIVER_NAME "msm_rng"
 
@@ -45,12 +47,28 @@
 #define RETRY_MAX_CNT		5	/* max retry times to read register */
 #define RETRY_DELAY_INTERVAL	440	/* retry delay interval in us */
 
+#define MSM_RNG_POOL_SIZE	1024	/* must be a power of 2 */
+
+/*
+ * hwrng reads are served from a pool refilled in bulk by a worker once it
+ * drops below pool_watermark bytes. Every byte is handed out only once.
+ * 0 disables the pool and reads go to the FIFO directly.
+ */
+static unsigned int pool_watermark = MSM_RNG_POOL_SIZE / 2;
+module_param(pool_watermark, uint, 0644);
+MODULE_PARM_DESC(pool_watermark, "Refill the entropy pool below this many bytes");
+
 struct msm_rng_device {
 	struct platform_device *pdev;
 	void __iomem *base;
 	struct clk *prng_clk;
 	struct mutex rng_lock;
 	struct icc_path *icc_path;
+	/* single producer (refill_work), single consumer (hwrng core) */
+	struct kfifo pool;
+	u8 *pool_buf;
+	u8 *refill_buf;
+	struct work_struct refill_work;
 };
 
 static struct msm_rng_device msm_rng_device_info;
@@ -157,12 +175,38 @@ bus_err:
 	val = 0L;
 	return currsize;
 }
+
+static void msm_rng_refill_work(struct work_struct *work)
+{
+	struct msm_rng_device *msm_rng_dev = container_of(work,
+			struct msm_rng_device, refill_work);
+	unsigned int room = kfifo_avail(&msm_rng_dev->pool) & ~3U;
+	int len;
+
+	if (!room)
+		return;
+
+	/* one clock/bus vote for the whole refill */
+	len = msm_rng_direct_read(msm_rng_dev, msm_rng_dev->refill_buf, room);
+	if (len > 0)
+		kfifo_in(&msm_rng_dev->pool, msm_rng_dev->refill_buf, len);
+	memzero_explicit(msm_rng_dev->refill_buf, room);
+}
+
 static int msm_rng_read(struct hwrng *rng, void *data, size_t max, bool wait)
 {
 	struct msm_rng_device *msm_rng_dev;
+	unsigned int watermark = READ_ONCE(pool_watermark);
 	int rv = 0;
 
 	msm_rng_dev = (struct msm_rng_device *)rng->priv;
+	if (watermark && msm_rng_dev->pool_buf) {
+		rv = kfifo_out(&msm_rng_dev->pool, data, max);
+		if (kfifo_len(&msm_rng_dev->pool) < watermark)
+			schedule_work(&msm_rng_dev->refill_work);
+		if (rv)
+			return rv;
+	}
 	rv = msm_rng_direct_read(msm_rng_dev, data, max);
 
 	return rv;
@@ -312,6 +356,19 @@ static int msm_rng_probe(struct platform_device *pdev)
 	mutex_init(&msm_rng_dev->rng_lock);
 	mutex_init(&cached_rng_lock);
 
+	/* the pool is an optimization, fall back to direct reads without it */
+	INIT_WORK(&msm_rng_dev->refill_work, msm_rng_refill_work);
+	msm_rng_dev->pool_buf = kzalloc(MSM_RNG_POOL_SIZE, GFP_KERNEL);
+	msm_rng_dev->refill_buf = kzalloc(MSM_RNG_POOL_SIZE, GFP_KERNEL);
+	if (!msm_rng_dev->pool_buf || !msm_rng_dev->refill_buf ||
+			kfifo_init(&msm_rng_dev->pool, msm_rng_dev->pool_buf,
+				MSM_RNG_POOL_SIZE)) {
+		kfree(msm_rng_dev->pool_buf);
+		kfree(msm_rng_dev->refill_buf);
+		msm_rng_dev->pool_buf = NULL;
+		msm_rng_dev->refill_buf = NULL;
+	}
+
 	/* register with hwrng framework */
 	msm_rng.priv = (unsigned long) msm_rng_dev;
 	error = hwrng_register(&msm_rng);
@@ -350,6 +407,9 @@ err_create_cls:
 err_reg_chrdev:
 	hwrng_unregister(&msm_rng);
 err_reg_hwrng:
+	cancel_work_sync(&msm_rng_dev->refill_work);
+	kfree_sensitive(msm_rng_dev->pool_buf);
+	kfree_sensitive(msm_rng_dev->refill_buf);
 	if (msm_rng_dev->icc_path)
 		icc_put(msm_rng_dev->icc_path);
 err_icc_get:
@@ -369,6 +429,9 @@ static int msm_rng_remove(struct platform_device *pdev)
 
 	unregister_chrdev(QRNG_IOC_MAGIC, DRIVER_NAME);
 	hwrng_unregister(&msm_rng);
+	cancel_work_sync(&msm_rng_dev->refill_work);
+	kfree_sensitive(msm_rng_dev->pool_buf);
+	kfree_sensitive(msm_rng_dev->refill_buf);
 	if (msm_rng_dev->prng_clk)
 		clk_put(msm_rng_dev->prng_clk);
 	iounmap(msm_rng_dev->base);
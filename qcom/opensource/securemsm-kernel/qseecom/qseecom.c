@@ -15,6 +15,7 @@
 #include <linux/reboot.h>
 #include <linux/platform_device.h>
 #include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <linux/cdev.h>
 #include <linux/uaccess.h>
 #include <linux/sched.h>
@@ -63,6 +64,8 @@
 #endif
 
 #define QSEECOM_DEV			"qseecom"
+/* listener round trip histogram, bucket n counts [2^(n-1), 2^n) usec */
+#define QSEECOM_LSTNR_LAT_BUCKETS	20
 #define QSEOS_VERSION_14		0x14
 #define QSEEE_VERSION_00		0x400000
 #define QSEE_VERSION_01			0x401000
@@ -257,6 +260,10 @@ struct qseecom_registered_listener_list {
 	uint32_t                   sglist_cnt;
 	int                        abort;
 	bool                       unregister_pending;
+	/* time the current request was handed to the listener */
+	ktime_t                    req_start;
+	u64                        lat_hist[QSEECOM_LSTNR_LAT_BUCKETS];
+	u64                        lat_max_us;
 };
 
 struct qseecom_unregister_pending_list {
@@ -378,6 +385,7 @@ struct qseecom_control {
 	wait_queue_head_t unload_app_kthread_wq;
 	atomic_t unload_app_kthread_state;
 	uint32_t qseecom_ds_state;
+	struct dentry *debugfs_root;
 };
 
 struct qseecom_unload_app_pending_list {
@@ -2132,6 +2140,20 @@ static int __qseecom_reentrancy_listener_has_sent_rsp(
 	return ret || data->abort || ptr_svc->abort;
 }
 
+/* call with listener_access_lock held */
+static void __qseecom_lstnr_lat_record(
+			struct qseecom_registered_listener_list *ptr_svc)
+{
+	u64 us = ktime_us_delta(ktime_get(), ptr_svc->req_start);
+	unsigned int bucket = fls64(us);
+
+	if (bucket >= QSEECOM_LSTNR_LAT_BUCKETS)
+		bucket = QSEECOM_LSTNR_LAT_BUCKETS - 1;
+	ptr_svc->lat_hist[bucket]++;
+	if (us > ptr_svc->lat_max_us)
+		ptr_svc->lat_max_us = us;
+}
+
 static void __qseecom_clean_listener_sglistinfo(
 			struct qseecom_registered_listener_list *ptr_svc)
 {
@@ -2170,6 +2192,7 @@ static int __qseecom_process_incomplete_cmd(struct qseecom_dev_handle *data,
 			if (ptr_svc->svc.listener_id == lstnr) {
 				ptr_svc->listener_in_use = true;
 				ptr_svc->rcv_req_flag = 1;
+				ptr_svc->req_start = ktime_get();
 				ret = qseecom_dmabuf_cache_operations(
 					ptr_svc->dmabuf,
 					QSEECOM_CACHE_INVALIDATE);
@@ -2248,6 +2271,7 @@ static int __qseecom_process_incomplete_cmd(struct qseecom_dev_handle *data,
 			rc = -ENODEV;
 			status = QSEOS_RESULT_FAILURE;
 		} else {
+			__qseecom_lstnr_lat_record(ptr_svc);
 			status = QSEOS_RESULT_SUCCESS;
 		}
 err_resp:
@@ -2502,6 +2526,7 @@ static int __qseecom_reentrancy_process_incomplete_cmd(
 			if (ptr_svc->svc.listener_id == lstnr) {
 				ptr_svc->listener_in_use = true;
 				ptr_svc->rcv_req_flag = 1;
+				ptr_svc->req_start = ktime_get();
 				ret = qseecom_dmabuf_cache_operations(
 					ptr_svc->dmabuf,
 					QSEECOM_CACHE_INVALIDATE);
@@ -2576,6 +2601,7 @@ static int __qseecom_reentrancy_process_incomplete_cmd(
 			rc = -ENODEV;
 			status  = QSEOS_RESULT_FAILURE;
 		} else {
+			__qseecom_lstnr_lat_record(ptr_svc);
 			status  = QSEOS_RESULT_SUCCESS;
 		}
 err_resp:
@@ -9785,6 +9811,39 @@ static int qseecom_parse_dt(struct platform_device *pdev)
 	return 0;
 }
 
+static int qseecom_listener_latency_show(struct seq_file *s, void *unused)
+{
+	struct qseecom_registered_listener_list *ptr_svc = NULL;
+	int i;
+
+	mutex_lock(&listener_access_lock);
+	list_for_each_entry(ptr_svc,
+			&qseecom.registered_listener_list_head, list) {
+		seq_printf(s, "listener %u max %llu us\n",
+				ptr_svc->svc.listener_id, ptr_svc->lat_max_us);
+		for (i = 0; i < QSEECOM_LSTNR_LAT_BUCKETS; i++) {
+			if (!ptr_svc->lat_hist[i])
+				continue;
+			seq_printf(s, "  < %8llu us : %llu\n",
+					1ULL << i, ptr_svc->lat_hist[i]);
+		}
+	}
+	mutex_unlock(&listener_access_lock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(qseecom_listener_latency);
+
+static void qseecom_debugfs_init(void)
+{
+	qseecom.debugfs_root = debugfs_create_dir(QSEECOM_DEV, NULL);
+	if (IS_ERR_OR_NULL(qseecom.debugfs_root)) {
+		qseecom.debugfs_root = NULL;
+		return;
+	}
+	debugfs_create_file("listener_latency", 0400, qseecom.debugfs_root,
+			NULL, &qseecom_listener_latency_fops);
+}
+
 static int qseecom_create_kthreads(void)
 {
 	int rc = 0;
@@ -9962,6 +10021,7 @@ static int qseecom_probe(struct platform_device *pdev)
 	if (rc)
 		pr_err("failed to provide qseecom ops %d", rc);
 #endif
+	qseecom_debugfs_init();
 	qseecom.qseecom_ds_state = DS_EXITED;
 	atomic_set(&qseecom.qseecom_state, QSEECOM_STATE_READY);
 	return 0;
@@ -10016,6 +10076,7 @@ static int qseecom_remove(struct platform_device *pdev)
 	if (qseecom.qseos_version > QSEEE_VERSION_00)
 		qseecom_unload_commonlib_image();
 
+	debugfs_remove_recursive(qseecom.debugfs_root);
 	qseecom_deregister_shmbridge();
 	kthread_stop(qseecom.unload_app_kthread_task);
 	kthread_stop(qseecom.unregister_lsnr_kthread_task);
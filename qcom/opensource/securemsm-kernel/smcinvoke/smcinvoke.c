@@ -177,6 +177,9 @@ static DEFINE_MUTEX(g_smcinvoke_lock);
 #define POST_KT_WAKEUP          1
 #define MAX_CHAR_NAME           50
 
+/* bridges kept registered after their mem obj is gone, for reuse */
+#define SMCINVOKE_SHMB_CACHE_MAX	16
+
 enum worker_thread_type {
 	SHMB_WORKER_THREAD      = 0,
 	OBJECT_WORKER_THREAD,
@@ -185,7 +188,9 @@ enum worker_thread_type {
 };
 
 static DEFINE_HASHTABLE(g_cb_servers, 8);
-static LIST_HEAD(g_mem_objs);
+/* mem objs indexed by mem_region_id and, once mapped, by mem_map_obj_id */
+static DEFINE_HASHTABLE(g_mem_rgn_objs, 8);
+static DEFINE_HASHTABLE(g_mem_map_objs, 8);
 static uint16_t g_last_cb_server_id = CBOBJ_SERVER_ID_START;
 static uint16_t g_last_mem_rgn_id, g_last_mem_map_obj_id;
 static size_t g_max_cb_buf_size = SMCINVOKE_TZ_MIN_BUF_SIZE;
@@ -299,8 +304,12 @@ struct smcinvoke_mem_obj {
 	struct kref mem_map_obj_ref_cnt;
 	uint64_t p_addr;
 	size_t p_addr_len;
-	struct list_head list;
+	struct hlist_node rgn_hash;
+	struct hlist_node map_hash;
 	uint64_t shmbridge_handle;
+	/* range shmbridge_handle was registered for, outlives the mapping */
+	uint64_t shmbridge_p_addr;
+	size_t shmbridge_len;
 };
 
 static LIST_HEAD(g_bridge_postprocess);
@@ -309,6 +318,22 @@ DEFINE_MUTEX(bridge_postprocess_lock);
 static LIST_HEAD(g_object_postprocess);
 DEFINE_MUTEX(object_postprocess_lock);
 
+/*
+ * Registered shm bridges whose mem obj has been released. Each entry holds
+ * the dma_buf reference of the old mem obj, so the memory stays put while
+ * TZ can still see it. Most recently parked first.
+ */
+struct smcinvoke_shmb_cache_entry {
+	struct list_head list;
+	struct dma_buf *dmabuf;
+	uint64_t p_addr;
+	size_t p_addr_len;
+	uint64_t shmbridge_handle;
+};
+
+static LIST_HEAD(g_shmb_cache);
+static DEFINE_MUTEX(shmb_cache_lock);
+
 struct bridge_deregister {
 	uint64_t shmbridge_handle;
 	struct dma_buf *dmabuf_to_free;
@@ -420,15 +445,18 @@ static struct smcinvoke_mem_obj *find_mem_obj_locked(uint16_t mem_obj_id,
 {
 	struct smcinvoke_mem_obj *mem_obj = NULL;
 
-	if (list_empty(&g_mem_objs))
-		return NULL;
-
-	list_for_each_entry(mem_obj, &g_mem_objs, list) {
-		if ((is_mem_rgn_obj &&
-				(mem_obj->mem_region_id == mem_obj_id)) ||
-				(!is_mem_rgn_obj &&
-				(mem_obj->mem_map_obj_id == mem_obj_id)))
-			return mem_obj;
+	if (is_mem_rgn_obj) {
+		hash_for_each_possible(g_mem_rgn_objs, mem_obj, rgn_hash,
+								mem_obj_id) {
+			if (mem_obj->mem_region_id == mem_obj_id)
+				return mem_obj;
+		}
+	} else {
+		hash_for_each_possible(g_mem_map_objs, mem_obj, map_hash,
+								mem_obj_id) {
+			if (mem_obj->mem_map_obj_id == mem_obj_id)
+				return mem_obj;
+		}
 	}
 	return NULL;
 }
@@ -739,18 +767,12 @@ static void smcinvoke_destroy_kthreads(void)
 	}
 }
 
-static inline void free_mem_obj_locked(struct smcinvoke_mem_obj *mem_obj)
+static void smcinvoke_deregister_bridge(uint64_t shmbridge_handle,
+					struct dma_buf *dmabuf_to_free)
 {
 	int ret = 0;
-	struct dma_buf *dmabuf_to_free = mem_obj->dma_buf;
-	uint64_t shmbridge_handle = mem_obj->shmbridge_handle;
 	struct smcinvoke_shmbridge_deregister_pending_list *entry = NULL;
 
-	list_del(&mem_obj->list);
-	kfree(mem_obj);
-	mem_obj = NULL;
-	mutex_unlock(&g_smcinvoke_lock);
-
 	if (shmbridge_handle)
 		ret = qtee_shmbridge_deregister(shmbridge_handle);
 	if (ret) {
@@ -775,6 +797,110 @@ static inline void free_mem_obj_locked(struct smcinvoke_mem_obj *mem_obj)
 	} else {
 		dma_buf_put(dmabuf_to_free);
 	}
+}
+
+/* Deregister every cached bridge, or only those nobody else can reuse */
+static void smcinvoke_shmb_cache_trim(bool all)
+{
+	struct smcinvoke_shmb_cache_entry *entry, *tmp;
+	unsigned int kept = 0;
+	LIST_HEAD(evict);
+
+	mutex_lock(&shmb_cache_lock);
+	list_for_each_entry_safe(entry, tmp, &g_shmb_cache, list) {
+		/* our reference is the last one: the buffer cannot come back */
+		if (all || kept >= SMCINVOKE_SHMB_CACHE_MAX ||
+				file_count(entry->dmabuf->file) == 1) {
+			list_move_tail(&entry->list, &evict);
+		} else {
+			kept++;
+		}
+	}
+	mutex_unlock(&shmb_cache_lock);
+
+	list_for_each_entry_safe(entry, tmp, &evict, list) {
+		list_del(&entry->list);
+		smcinvoke_deregister_bridge(entry->shmbridge_handle,
+						entry->dmabuf);
+		kfree(entry);
+	}
+}
+
+/* Park a bridge instead of deregistering it, takes over the dma_buf ref */
+static bool smcinvoke_shmb_cache_put(struct smcinvoke_mem_obj *mem_obj)
+{
+	struct smcinvoke_shmb_cache_entry *entry;
+
+	if (!mem_obj->shmbridge_handle ||
+			!mem_buf_dma_buf_exclusive_owner(mem_obj->dma_buf))
+		return false;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return false;
+
+	entry->dmabuf = mem_obj->dma_buf;
+	entry->p_addr = mem_obj->shmbridge_p_addr;
+	entry->p_addr_len = mem_obj->shmbridge_len;
+	entry->shmbridge_handle = mem_obj->shmbridge_handle;
+
+	mutex_lock(&shmb_cache_lock);
+	list_add(&entry->list, &g_shmb_cache);
+	mutex_unlock(&shmb_cache_lock);
+
+	smcinvoke_shmb_cache_trim(false);
+	return true;
+}
+
+/* Reuse a parked bridge registered for the same buffer and range */
+static bool smcinvoke_shmb_cache_get(struct smcinvoke_mem_obj *mem_obj)
+{
+	struct smcinvoke_shmb_cache_entry *entry;
+	bool found = false;
+
+	/* a buffer shared with other VMs may have changed owners since */
+	if (!mem_buf_dma_buf_exclusive_owner(mem_obj->dma_buf))
+		return false;
+
+	mutex_lock(&shmb_cache_lock);
+	list_for_each_entry(entry, &g_shmb_cache, list) {
+		if (entry->dmabuf == mem_obj->dma_buf &&
+				entry->p_addr == mem_obj->p_addr &&
+				entry->p_addr_len == mem_obj->p_addr_len) {
+			list_del(&entry->list);
+			found = true;
+			break;
+		}
+	}
+	mutex_unlock(&shmb_cache_lock);
+
+	if (!found)
+		return false;
+
+	mem_obj->shmbridge_handle = entry->shmbridge_handle;
+	mem_obj->shmbridge_p_addr = entry->p_addr;
+	mem_obj->shmbridge_len = entry->p_addr_len;
+	/* mem_obj holds its own reference to the same dma_buf */
+	dma_buf_put(entry->dmabuf);
+	kfree(entry);
+	return true;
+}
+
+static inline void free_mem_obj_locked(struct smcinvoke_mem_obj *mem_obj)
+{
+	struct dma_buf *dmabuf_to_free = mem_obj->dma_buf;
+	uint64_t shmbridge_handle = mem_obj->shmbridge_handle;
+	bool parked;
+
+	hash_del(&mem_obj->rgn_hash);
+	hash_del(&mem_obj->map_hash);
+	mutex_unlock(&g_smcinvoke_lock);
+
+	parked = smcinvoke_shmb_cache_put(mem_obj);
+	kfree(mem_obj);
+	mem_obj = NULL;
+	if (!parked)
+		smcinvoke_deregister_bridge(shmbridge_handle, dmabuf_to_free);
 
 	mutex_lock(&g_smcinvoke_lock);
 }
@@ -798,6 +924,8 @@ static void del_mem_map_obj_locked(struct kref *kref)
 	struct smcinvoke_mem_obj *mem_obj = container_of(kref,
 			struct smcinvoke_mem_obj, mem_map_obj_ref_cnt);
 
+	/* the map id is reallocated if the region is mapped again */
+	hash_del(&mem_obj->map_hash);
 	mem_obj->p_addr_len = 0;
 	mem_obj->p_addr = 0;
 	if (mem_obj->sgt)
@@ -1065,7 +1193,8 @@ static int create_mem_obj(struct dma_buf *dma_buf, int32_t *mem_obj)
 	t_mem_obj->dma_buf = dma_buf;
 	mutex_lock(&g_smcinvoke_lock);
 	t_mem_obj->mem_region_id = next_mem_region_obj_id_locked();
-	list_add_tail(&t_mem_obj->list, &g_mem_objs);
+	hash_add(g_mem_rgn_objs, &t_mem_obj->rgn_hash,
+			t_mem_obj->mem_region_id);
 	mutex_unlock(&g_smcinvoke_lock);
 	*mem_obj = TZHANDLE_MAKE_LOCAL(MEM_RGN_SRVR_ID,
 			t_mem_obj->mem_region_id);
@@ -1219,6 +1348,12 @@ static int smcinvoke_create_bridge(struct smcinvoke_mem_obj *mem_obj)
 	if (!qtee_shmbridge_is_enabled())
 		return 0;
 
+	if (smcinvoke_shmb_cache_get(mem_obj)) {
+		trace_smcinvoke_create_bridge(mem_obj->shmbridge_handle,
+				mem_obj->mem_region_id);
+		return 0;
+	}
+
 	ret = mem_buf_dma_buf_copy_vmperm(dmabuf, (int **)&vmid_list,
 			(int **)&perms_list, (int *)&nelems);
 	if (ret) {
@@ -1237,6 +1372,8 @@ static int smcinvoke_create_bridge(struct smcinvoke_mem_obj *mem_obj)
 				mem_obj->mem_region_id, ret);
 		goto exit;
 	}
+	mem_obj->shmbridge_p_addr = phys;
+	mem_obj->shmbridge_len = size;
 
 	trace_smcinvoke_create_bridge(mem_obj->shmbridge_handle, mem_obj->mem_region_id);
 exit:
@@ -1355,6 +1492,8 @@ static int32_t smcinvoke_map_mem_region(void *buf, size_t buf_len)
 		}
 
 		mem_obj->mem_map_obj_id = next_mem_map_obj_id_locked();
+		hash_add(g_mem_map_objs, &mem_obj->map_hash,
+				mem_obj->mem_map_obj_id);
 	} else {
 		kref_get(&mem_obj->mem_map_obj_ref_cnt);
 	}
@@ -2857,6 +2996,7 @@ static int smcinvoke_remove(struct platform_device *pdev)
 {
 	int count = 1;
 
+	smcinvoke_shmb_cache_trim(true);
 	smcinvoke_destroy_kthreads();
 	cdev_del(&smcinvoke_cdev);
 	device_destroy(driver_class, smcinvoke_device_no);
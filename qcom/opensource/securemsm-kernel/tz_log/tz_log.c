@@ -13,6 +13,7 @@
 #include <linux/msm_ion.h>
 #include <linux/kernel.h>
 #include <linux/module.h>
+#include <linux/mutex.h>
 #include <linux/platform_device.h>
 #include <linux/slab.h>
 #include <linux/string.h>
@@ -413,6 +414,8 @@ struct tzdbg_stat {
 	char *name;
 	char *data;
 	bool avail;
+	/* position the last text reader stopped at, for the next open */
+	struct tzdbg_log_pos_v2_t log_pos;
 };
 
 struct tzdbg {
@@ -465,6 +468,43 @@ struct encrypted_log_info {
 	uint64_t shmb_handle;
 };
 
+/*
+ * Per-open state of the TZ and QSEE log ring readers. Each reader keeps
+ * its own ring position, so concurrent collectors do not consume each
+ * other's data and a poll only transfers what was logged since the
+ * previous one.
+ */
+struct tzdbg_log_reader {
+	int tz_id;
+	bool binary;
+	bool synced;
+	struct mutex lock;
+	struct tzdbg_log_pos_v2_t pos;
+	uint32_t ring_off;
+	uint32_t ring_len;
+	char *bounce;
+};
+
+#define TZDBG_LOG_BIN_MAGIC		0x544c4f47 /* "TLOG" */
+#define TZDBG_LOG_BIN_VERSION		1
+#define TZDBG_LOG_BOUNCE_SIZE		PAGE_SIZE
+#define TZDBG_LOG_POLL_MS		50
+
+/*
+ * Header preceding the payload of every read on a binary log node:
+ * ring position of the first payload byte, payload length and the
+ * number of bytes TZ overwrote before this reader could fetch them.
+ */
+struct tzdbg_log_bin_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t hdr_len;
+	uint32_t wrap;
+	uint32_t offset;
+	uint32_t len;
+	uint32_t lost;
+};
+
 static struct tzdbg tzdbg = {
 	.stat[TZDBG_BOOT].name = "boot",
 	.stat[TZDBG_RESET].name = "reset",
@@ -734,157 +774,6 @@ static int _disp_tz_log_stats_legacy(void)
 	return len;
 }
 
-static int _disp_log_stats(struct tzdbg_log_t *log,
-			struct tzdbg_log_pos_t *log_start, uint32_t log_len,
-			size_t count, uint32_t buf_idx)
-{
-	uint32_t wrap_start;
-	uint32_t wrap_end;
-	uint32_t wrap_cnt;
-	int max_len;
-	int len = 0;
-	int i = 0;
-
-	wrap_start = log_start->wrap;
-	wrap_end = log->log_pos.wrap;
-
-	/* Calculate difference in # of buffer wrap-arounds */
-	if (wrap_end >= wrap_start)
-		wrap_cnt = wrap_end - wrap_start;
-	else {
-		/* wrap counter has wrapped around, invalidate start position */
-		wrap_cnt = 2;
-	}
-
-	if (wrap_cnt > 1) {
-		/* end position has wrapped around more than once, */
-		/* current start no longer valid                   */
-		log_start->wrap = log->log_pos.wrap - 1;
-		log_start->offset = (log->log_pos.offset + 1) % log_len;
-	} else if ((wrap_cnt == 1) &&
-		(log->log_pos.offset > log_start->offset)) {
-		/* end position has overwritten start */
-		log_start->offset = (log->log_pos.offset + 1) % log_len;
-	}
-
-	pr_debug("diag_buf wrap = %u, offset = %u\n",
-		log->log_pos.wrap, log->log_pos.offset);
-	while (log_start->offset == log->log_pos.offset) {
-		/*
-		 * No data in ring buffer,
-		 * so we'll hang around until something happens
-		 */
-		unsigned long t = msleep_interruptible(50);
-
-		if (t != 0) {
-			/* Some event woke us up, so let's quit */
-			return 0;
-}
-
-		if (buf_idx == TZDBG_LOG)
-			memcpy_fromio((void *)tzdbg.diag_buf, tzdbg.virt_iobase,
-						debug_rw_buf_size);
-
-	}
-
-	max_len = (count > debug_rw_buf_size) ? debug_rw_buf_size : count;
-
-	pr_debug("diag_buf wrap = %u, offset = %u\n",
-		log->log_pos.wrap, log->log_pos.offset);
-	/*
-	 *  Read from ring buff while there is data and space in return buff
-	 */
-	while ((log_start->offset != log->log_pos.offset) && (len < max_len)) {
-		tzdbg.disp_buf[i++] = log->log_buf[log_start->offset];
-		log_start->offset = (log_start->offset + 1) % log_len;
-		if (log_start->offset == 0)
-			++log_start->wrap;
-		++len;
-	}
-
-	/*
-	 * return buffer to caller
-	 */
-	tzdbg.stat[buf_idx].data = tzdbg.disp_buf;
-	return len;
-}
-
-static int _disp_log_stats_v2(struct tzdbg_log_v2_t *log,
-			struct tzdbg_log_pos_v2_t *log_start, uint32_t log_len,
-			size_t count, uint32_t buf_idx)
-{
-	uint32_t wrap_start;
-	uint32_t wrap_end;
-	uint32_t wrap_cnt;
-	int max_len;
-	int len = 0;
-	int i = 0;
-
-	wrap_start = log_start->wrap;
-	wrap_end = log->log_pos.wrap;
-
-	/* Calculate difference in # of buffer wrap-arounds */
-	if (wrap_end >= wrap_start)
-		wrap_cnt = wrap_end - wrap_start;
-	else {
-		/* wrap counter has wrapped around, invalidate start position */
-		wrap_cnt = 2;
-}
-
-	if (wrap_cnt > 1) {
-		/* end position has wrapped around more than once, */
-		/* current start no longer valid                   */
-		log_start->wrap = log->log_pos.wrap - 1;
-		log_start->offset = (log->log_pos.offset + 1) % log_len;
-	} else if ((wrap_cnt == 1) &&
-		(log->log_pos.offset > log_start->offset)) {
-		/* end position has overwritten start */
-		log_start->offset = (log->log_pos.offset + 1) % log_len;
-	}
-	pr_debug("diag_buf wrap = %u, offset = %u\n",
-		log->log_pos.wrap, log->log_pos.offset);
-
-	while (log_start->offset == log->log_pos.offset) {
-		/*
-		 * No data in ring buffer,
-		 * so we'll hang around until something happens
-		 */
-		unsigned long t = msleep_interruptible(50);
-
-		if (t != 0) {
-			/* Some event woke us up, so let's quit */
-			return 0;
-		}
-
-		if (buf_idx == TZDBG_LOG)
-			memcpy_fromio((void *)tzdbg.diag_buf, tzdbg.virt_iobase,
-						debug_rw_buf_size);
-
-	}
-
-	max_len = (count > debug_rw_buf_size) ? debug_rw_buf_size : count;
-
-	pr_debug("diag_buf wrap = %u, offset = %u\n",
-		log->log_pos.wrap, log->log_pos.offset);
-
-	/*
-	 *  Read from ring buff while there is data and space in return buff
-	 */
-	while ((log_start->offset != log->log_pos.offset) && (len < max_len)) {
-		tzdbg.disp_buf[i++] = log->log_buf[log_start->offset];
-		log_start->offset = (log_start->offset + 1) % log_len;
-		if (log_start->offset == 0)
-			++log_start->wrap;
-		++len;
-	}
-
-	/*
-	 * return buffer to caller
-	 */
-	tzdbg.stat[buf_idx].data = tzdbg.disp_buf;
-	return len;
-}
-
 static int __disp_hyp_log_stats(uint8_t *log,
 			struct hypdbg_log_pos_t *log_start, uint32_t log_len,
 			size_t count, uint32_t buf_idx)
@@ -1058,29 +947,6 @@ static int _disp_encrpted_log_stats(struct encrypted_log_info *enc_log_info,
 	return len;
 }
 
-static int _disp_tz_log_stats(size_t count)
-{
-	static struct tzdbg_log_pos_v2_t log_start_v2 = {0};
-	static struct tzdbg_log_pos_t log_start = {0};
-	struct tzdbg_log_v2_t *log_v2_ptr;
-	struct tzdbg_log_t *log_ptr;
-
-	log_ptr = (struct tzdbg_log_t *)((unsigned char *)tzdbg.diag_buf +
-			tzdbg.diag_buf->ring_off -
-			offsetof(struct tzdbg_log_t, log_buf));
-
-	log_v2_ptr = (struct tzdbg_log_v2_t *)((unsigned char *)tzdbg.diag_buf +
-			tzdbg.diag_buf->ring_off -
-			offsetof(struct tzdbg_log_v2_t, log_buf));
-
-	if (!tzdbg.is_enlarged_buf)
-		return _disp_log_stats(log_ptr, &log_start,
-				tzdbg.diag_buf->ring_len, count, TZDBG_LOG);
-
-	return _disp_log_stats_v2(log_v2_ptr, &log_start_v2,
-			tzdbg.diag_buf->ring_len, count, TZDBG_LOG);
-}
-
 static int _disp_hyp_log_stats(size_t count)
 {
 	static struct hypdbg_log_pos_t log_start = {0};
@@ -1144,21 +1010,6 @@ static int _disp_rm_log_stats(size_t count)
 	return __disp_rm_log_stats(log_ptr, log_len);
 }
 
-static int _disp_qsee_log_stats(size_t count)
-{
-	static struct tzdbg_log_pos_t log_start = {0};
-	static struct tzdbg_log_pos_v2_t log_start_v2 = {0};
-
-	if (!tzdbg.is_enlarged_buf)
-		return _disp_log_stats(g_qsee_log, &log_start,
-			QSEE_LOG_BUF_SIZE - sizeof(struct tzdbg_log_pos_t),
-			count, TZDBG_QSEE_LOG);
-
-	return _disp_log_stats_v2(g_qsee_log_v2, &log_start_v2,
-		QSEE_LOG_BUF_SIZE_V2 - sizeof(struct tzdbg_log_pos_v2_t),
-		count, TZDBG_QSEE_LOG);
-}
-
 static int _disp_hyp_general_stats(size_t count)
 {
 	int len = 0;
@@ -1250,6 +1101,244 @@ static int _disp_tme_log_stats(size_t count)
 }
 #endif
 
+static bool tzdbg_log_is_ring(int tz_id)
+{
+	uint32_t version;
+
+	if (tz_id == TZDBG_QSEE_LOG)
+		return true;
+	if (tz_id != TZDBG_LOG)
+		return false;
+
+	version = readl_relaxed(tzdbg.virt_iobase +
+			offsetof(struct tzdbg_t, version));
+	return TZBSP_DIAG_MAJOR_VERSION_LEGACY < (version >> 16);
+}
+
+static int tzdbg_log_reader_init(struct tzdbg_log_reader *reader)
+{
+	if (reader->tz_id == TZDBG_QSEE_LOG) {
+		if (!tzdbg.is_enlarged_buf)
+			reader->ring_len = QSEE_LOG_BUF_SIZE -
+					sizeof(struct tzdbg_log_pos_t);
+		else
+			reader->ring_len = QSEE_LOG_BUF_SIZE_V2 -
+					sizeof(struct tzdbg_log_pos_v2_t);
+		return 0;
+	}
+
+	/*
+	 * Only the ring layout is needed from the diag area, the rest of
+	 * it is never copied for ring reads.
+	 */
+	reader->ring_off = readl_relaxed(tzdbg.virt_iobase +
+			offsetof(struct tzdbg_t, ring_off));
+	reader->ring_len = readl_relaxed(tzdbg.virt_iobase +
+			offsetof(struct tzdbg_t, ring_len));
+	if (!reader->ring_len ||
+		reader->ring_off < sizeof(struct tzdbg_log_pos_v2_t) ||
+		reader->ring_off > debug_rw_buf_size ||
+		reader->ring_len > debug_rw_buf_size - reader->ring_off) {
+		pr_err("invalid tz log ring, off %u len %u\n",
+			reader->ring_off, reader->ring_len);
+		return -EINVAL;
+	}
+
+	reader->bounce = kmalloc(TZDBG_LOG_BOUNCE_SIZE, GFP_KERNEL);
+	if (!reader->bounce)
+		return -ENOMEM;
+	return 0;
+}
+
+static void tzdbg_log_get_pos(struct tzdbg_log_reader *reader,
+			struct tzdbg_log_pos_v2_t *pos)
+{
+	struct tzdbg_log_pos_t pos_v1;
+	void __iomem *log_io;
+
+	if (reader->tz_id == TZDBG_QSEE_LOG) {
+		if (tzdbg.is_enlarged_buf) {
+			pos->wrap = READ_ONCE(g_qsee_log_v2->log_pos.wrap);
+			pos->offset = READ_ONCE(g_qsee_log_v2->log_pos.offset);
+		} else {
+			pos->wrap = READ_ONCE(g_qsee_log->log_pos.wrap);
+			pos->offset = READ_ONCE(g_qsee_log->log_pos.offset);
+		}
+		return;
+	}
+
+	/* fetch the ring header only, not the whole diag area */
+	log_io = tzdbg.virt_iobase + reader->ring_off;
+	if (tzdbg.is_enlarged_buf) {
+		memcpy_fromio(pos, log_io -
+			offsetof(struct tzdbg_log_v2_t, log_buf), sizeof(*pos));
+	} else {
+		memcpy_fromio(&pos_v1, log_io -
+			offsetof(struct tzdbg_log_t, log_buf), sizeof(pos_v1));
+		pos->wrap = pos_v1.wrap;
+		pos->offset = pos_v1.offset;
+	}
+}
+
+/*
+ * Move the reader past data overwritten by the producer and return how
+ * many bytes were lost.
+ */
+static uint32_t tzdbg_log_sync_reader(struct tzdbg_log_reader *reader,
+			const struct tzdbg_log_pos_v2_t *end)
+{
+	struct tzdbg_log_pos_v2_t *start = &reader->pos;
+	uint32_t log_len = reader->ring_len;
+	uint32_t wrap_cnt;
+	uint64_t lost = 0;
+
+	if (end->offset >= log_len)
+		return 0;
+
+	/* Calculate difference in # of buffer wrap-arounds */
+	if (end->wrap >= start->wrap)
+		wrap_cnt = end->wrap - start->wrap;
+	else {
+		/* wrap counter has wrapped around, invalidate start position */
+		wrap_cnt = 2;
+		lost = U32_MAX;
+	}
+
+	if (wrap_cnt > 1) {
+		/* end position has wrapped around more than once, */
+		/* current start no longer valid                   */
+		if (!lost)
+			lost = (uint64_t)(wrap_cnt - 1) * log_len +
+				end->offset + 1 - start->offset;
+		start->wrap = end->wrap - 1;
+		start->offset = (end->offset + 1) % log_len;
+	} else if ((wrap_cnt == 1) && (end->offset > start->offset)) {
+		/* end position has overwritten start */
+		lost = end->offset + 1 - start->offset;
+		start->offset = (end->offset + 1) % log_len;
+	}
+
+	/* a fresh reader starting at the oldest entry lost nothing */
+	if (!reader->synced)
+		return 0;
+	return min_t(uint64_t, lost, U32_MAX);
+}
+
+static int tzdbg_log_copy(struct tzdbg_log_reader *reader,
+			char __user *buf, uint32_t offset, uint32_t len)
+{
+	void __iomem *log_io;
+	uint8_t *log_buf;
+	uint32_t chunk;
+
+	if (reader->tz_id == TZDBG_QSEE_LOG) {
+		log_buf = tzdbg.is_enlarged_buf ? g_qsee_log_v2->log_buf :
+				g_qsee_log->log_buf;
+		if (copy_to_user(buf, log_buf + offset, len))
+			return -EFAULT;
+		return 0;
+	}
+
+	log_io = tzdbg.virt_iobase + reader->ring_off + offset;
+	while (len) {
+		chunk = min_t(uint32_t, len, TZDBG_LOG_BOUNCE_SIZE);
+		memcpy_fromio(reader->bounce, log_io, chunk);
+		if (copy_to_user(buf, reader->bounce, chunk))
+			return -EFAULT;
+		buf += chunk;
+		log_io += chunk;
+		len -= chunk;
+	}
+	return 0;
+}
+
+/*
+ * Incremental read of the TZ or QSEE log ring: hand out only what was
+ * logged since this reader's previous read, straight from the ring. In
+ * binary mode the payload is preceded by a struct tzdbg_log_bin_hdr and
+ * O_NONBLOCK is honoured instead of polling for new data.
+ */
+static ssize_t tzdbg_log_read(struct tzdbg_log_reader *reader,
+			struct file *file, char __user *buf, size_t count)
+{
+	struct tzdbg_log_bin_hdr hdr = {0};
+	struct tzdbg_log_pos_v2_t end;
+	uint32_t log_len = reader->ring_len;
+	size_t hdr_len = 0;
+	size_t avail;
+	size_t chunk;
+	size_t len = 0;
+	uint32_t lost;
+	int ret;
+
+	if (reader->binary) {
+		hdr_len = sizeof(hdr);
+		if (count <= hdr_len)
+			return -EINVAL;
+		count -= hdr_len;
+	}
+
+	tzdbg_log_get_pos(reader, &end);
+	lost = tzdbg_log_sync_reader(reader, &end);
+	reader->synced = true;
+	pr_debug("log %d wrap = %u, offset = %u\n",
+		reader->tz_id, end.wrap, end.offset);
+
+	while (reader->pos.offset == end.offset || end.offset >= log_len) {
+		if (reader->binary && (file->f_flags & O_NONBLOCK))
+			return -EAGAIN;
+		/*
+		 * No data in ring buffer, so we'll hang around until
+		 * something happens. Only the ring header is refetched.
+		 */
+		if (msleep_interruptible(TZDBG_LOG_POLL_MS))
+			return 0;
+
+		tzdbg_log_get_pos(reader, &end);
+		lost += tzdbg_log_sync_reader(reader, &end);
+	}
+
+	hdr.wrap = reader->pos.wrap;
+	hdr.offset = reader->pos.offset;
+
+	if (end.offset >= reader->pos.offset)
+		avail = end.offset - reader->pos.offset;
+	else
+		avail = log_len - reader->pos.offset + end.offset;
+	count = min(count, avail);
+
+	while (len < count) {
+		chunk = min_t(size_t, count - len,
+				log_len - reader->pos.offset);
+		ret = tzdbg_log_copy(reader, buf + hdr_len + len,
+				reader->pos.offset, chunk);
+		if (ret)
+			return ret;
+		len += chunk;
+		reader->pos.offset = (reader->pos.offset + chunk) % log_len;
+		if (reader->pos.offset == 0) {
+			++reader->pos.wrap;
+			/* keep in step with the 16 bit producer counter */
+			if (!tzdbg.is_enlarged_buf)
+				reader->pos.wrap &= U16_MAX;
+		}
+	}
+
+	if (reader->binary) {
+		hdr.magic = TZDBG_LOG_BIN_MAGIC;
+		hdr.version = TZDBG_LOG_BIN_VERSION;
+		hdr.hdr_len = hdr_len;
+		hdr.len = len;
+		hdr.lost = lost;
+		if (copy_to_user(buf, &hdr, hdr_len))
+			return -EFAULT;
+	} else {
+		tzdbg.stat[reader->tz_id].log_pos = reader->pos;
+	}
+
+	return hdr_len + len;
+}
+
 static ssize_t tzdbg_fs_read_unencrypted(int tz_id, char __user *buf,
 	size_t count, loff_t *offp)
 {
@@ -1283,17 +1372,8 @@ static ssize_t tzdbg_fs_read_unencrypted(int tz_id, char __user *buf,
 		len = _disp_tz_vmid_stats();
 		break;
 	case TZDBG_LOG:
-		if (TZBSP_DIAG_MAJOR_VERSION_LEGACY <
-				(tzdbg.diag_buf->version >> 16)) {
-			len = _disp_tz_log_stats(count);
-			*offp = 0;
-		} else {
-			len = _disp_tz_log_stats_legacy();
-		}
-		break;
-	case TZDBG_QSEE_LOG:
-		len = _disp_qsee_log_stats(count);
-		*offp = 0;
+		/* ring formats are served by tzdbg_log_read() */
+		len = _disp_tz_log_stats_legacy();
 		break;
 	case TZDBG_HYP_GENERAL:
 		len = _disp_hyp_general_stats(count);
@@ -1365,15 +1445,26 @@ static ssize_t tzdbg_fs_read(struct file *file, char __user *buf,
 	size_t count, loff_t *offp)
 {
 	struct seq_file *seq = file->private_data;
+	struct tzdbg_log_reader *reader;
 	int tz_id = TZDBG_STATS_MAX;
+	ssize_t ret;
 
-	if (seq)
-		tz_id = *(int *)(seq->private);
-	else {
+	if (!seq) {
 		pr_err("%s: Seq data null unable to proceed\n", __func__);
 		return 0;
 	}
 
+	/* ring log nodes carry a reader instead of the plain stat id */
+	if (seq->private != PDE_DATA(file_inode(file))) {
+		reader = seq->private;
+		mutex_lock(&reader->lock);
+		ret = tzdbg_log_read(reader, file, buf, count);
+		mutex_unlock(&reader->lock);
+		return ret;
+	}
+
+	tz_id = *(int *)(seq->private);
+
 	if (!tzdbg.is_encrypted_log_enabled ||
 	    (tz_id == TZDBG_HYP_GENERAL || tz_id == TZDBG_HYP_LOG)
 	    || tz_id == TZDBG_RM_LOG || tz_id == TZDBG_TME_LOG)
@@ -1382,14 +1473,76 @@ static ssize_t tzdbg_fs_read(struct file *file, char __user *buf,
 		return tzdbg_fs_read_encrypted(tz_id, buf, count, offp);
 }
 
+static void tzdbg_log_reader_free(struct tzdbg_log_reader *reader)
+{
+	mutex_destroy(&reader->lock);
+	kfree(reader->bounce);
+	kfree(reader);
+}
+
+static int __tzdbg_procfs_open(struct inode *inode, struct file *file,
+			bool binary)
+{
+	int tz_id = *(int *)PDE_DATA(inode);
+	struct tzdbg_log_reader *reader;
+	int ret;
+
+	if (tzdbg.is_encrypted_log_enabled || !tzdbg_log_is_ring(tz_id)) {
+		if (binary)
+			return -EOPNOTSUPP;
+		return single_open(file, NULL, PDE_DATA(inode));
+	}
+
+	reader = kzalloc(sizeof(*reader), GFP_KERNEL);
+	if (!reader)
+		return -ENOMEM;
+
+	reader->tz_id = tz_id;
+	reader->binary = binary;
+	mutex_init(&reader->lock);
+	ret = tzdbg_log_reader_init(reader);
+	if (ret)
+		goto err;
+
+	/*
+	 * Text readers carry on where the previous one stopped, like the
+	 * single shared position used to; binary readers start from the
+	 * oldest data still in the ring and report their position anyway.
+	 */
+	if (!binary) {
+		reader->pos = tzdbg.stat[tz_id].log_pos;
+		reader->synced = true;
+	}
+
+	ret = single_open(file, NULL, reader);
+	if (ret)
+		goto err;
+	return 0;
+err:
+	tzdbg_log_reader_free(reader);
+	return ret;
+}
+
 static int tzdbg_procfs_open(struct inode *inode, struct file *file)
 {
-	return single_open(file, NULL, PDE_DATA(inode));
+	return __tzdbg_procfs_open(inode, file, false);
+}
+
+static int tzdbg_procfs_bin_open(struct inode *inode, struct file *file)
+{
+	return __tzdbg_procfs_open(inode, file, true);
 }
 
 static int tzdbg_procfs_release(struct inode *inode, struct file *file)
 {
-	return single_release(inode, file);
+	struct seq_file *seq = file->private_data;
+	void *private = seq->private;
+	int ret;
+
+	ret = single_release(inode, file);
+	if (private != PDE_DATA(inode))
+		tzdbg_log_reader_free(private);
+	return ret;
 }
 
 struct proc_ops tzdbg_fops = {
@@ -1399,6 +1552,13 @@ struct proc_ops tzdbg_fops = {
 	.proc_release = tzdbg_procfs_release,
 };
 
+struct proc_ops tzdbg_bin_fops = {
+	.proc_flags   = PROC_ENTRY_PERMANENT,
+	.proc_read    = tzdbg_fs_read,
+	.proc_open    = tzdbg_procfs_bin_open,
+	.proc_release = tzdbg_procfs_release,
+};
+
 static int tzdbg_init_tme_log(struct platform_device *pdev, void __iomem *virt_iobase)
 {
 	/*
@@ -1571,6 +1731,7 @@ static int  tzdbg_fs_init(struct platform_device *pdev)
 	int i;
 	struct proc_dir_entry *dent_dir;
 	struct proc_dir_entry *dent;
+	char name[32];
 
 	dent_dir = proc_mkdir(TZDBG_DIR_NAME, NULL);
 	if (dent_dir == NULL) {
@@ -1591,6 +1752,20 @@ static int  tzdbg_fs_init(struct platform_device *pdev)
 			rc = -ENOMEM;
 			goto err;
 		}
+
+		/* raw ring access with position headers for log collectors */
+		if (tzdbg.is_encrypted_log_enabled ||
+			(i != TZDBG_LOG && i != TZDBG_QSEE_LOG))
+			continue;
+
+		scnprintf(name, sizeof(name), "%s_bin", tzdbg.stat[i].name);
+		dent = proc_create_data(name, 0444, dent_dir,
+				&tzdbg_bin_fops, &tzdbg.debug_tz[i]);
+		if (dent == NULL) {
+			dev_err(&pdev->dev, "TZ proc_create_data failed\n");
+			rc = -ENOMEM;
+			goto err;
+		}
 	}
 	platform_set_drvdata(pdev, dent_dir);
 	return 0;
@@ -332,6 +332,16 @@ static struct msm_platform_inst_capability instance_cap_data_kalama[] = {
 		INVALID_FD, INT_MAX, 1, INVALID_FD,
 		V4L2_CID_MPEG_VIDC_SW_FENCE_FD},
 
+	/*
+	 * Client to do set_ctrl with INPUT_FENCE_FD before queueing an
+	 * input buffer that is still being written by its producer.
+	 */
+	{INPUT_FENCE_FD, ENC, H264|HEVC,
+		INVALID_FD, INT_MAX, 1, INVALID_FD,
+		V4L2_CID_MPEG_VIDC_INPUT_FENCE_FD,
+		0,
+		CAP_FLAG_DYNAMIC_ALLOWED | CAP_FLAG_INPUT_PORT},
+
 	{TS_REORDER, DEC, H264|HEVC,
 		V4L2_MPEG_MSM_VIDC_DISABLE, V4L2_MPEG_MSM_VIDC_ENABLE,
 		1, V4L2_MPEG_MSM_VIDC_DISABLE,
@@ -7,6 +7,8 @@
 #define _MSM_VIDC_CORE_H_
 
 #include <linux/platform_device.h>
+#include <linux/hashtable.h>
+#include <linux/shrinker.h>
 
 #include "msm_vidc_internal.h"
 
@@ -71,6 +73,7 @@ struct msm_vidc_core {
 	struct media_device                    media_dev;
 	struct list_head                       instances;
 	struct list_head                       dangling_instances;
+	DECLARE_HASHTABLE(session_table, MSM_VIDC_SESSION_HASH_BITS);
 	struct dentry                         *debugfs_parent;
 	struct dentry                         *debugfs_root;
 	char                                   fw_version[MAX_NAME_LENGTH];
@@ -92,10 +95,14 @@ struct msm_vidc_core {
 	struct delayed_work                    pm_work;
 	struct workqueue_struct               *pm_workq;
 	struct workqueue_struct               *batch_workq;
+	struct workqueue_struct               *response_workq;
 	struct delayed_work                    fw_unload_work;
 	struct work_struct                     ssr_work;
 	struct msm_vidc_core_power             power;
 	struct msm_vidc_ssr                    ssr;
+	struct msm_vidc_core_sched             sched;
+	struct shrinker                        ibuf_shrinker;
+	atomic64_t                             ibuf_pool_bytes;
 	bool                                   smmu_fault_handled;
 	u32                                    skip_pc_count;
 	u32                                    last_packet_type;
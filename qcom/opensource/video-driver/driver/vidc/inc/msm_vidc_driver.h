@@ -483,6 +483,7 @@ int cancel_stability_work_sync(struct msm_vidc_inst *inst);
 void msm_vidc_fw_unload_handler(struct work_struct *work);
 int msm_vidc_suspend(struct msm_vidc_core *core);
 void msm_vidc_batch_handler(struct work_struct *work);
+void msm_vidc_sched_pace_handler(struct work_struct *work);
 int msm_vidc_event_queue_init(struct msm_vidc_inst *inst);
 int msm_vidc_event_queue_deinit(struct msm_vidc_inst *inst);
 int msm_vidc_vb2_queue_init(struct msm_vidc_inst *inst);
@@ -514,6 +515,9 @@ void msm_vidc_update_stats(struct msm_vidc_inst *inst,
 void msm_vidc_stats_handler(struct work_struct *work);
 int schedule_stats_work(struct msm_vidc_inst *inst);
 int cancel_stats_work_sync(struct msm_vidc_inst *inst);
+int cancel_sched_work_sync(struct msm_vidc_inst *inst);
+int msm_vidc_ibuf_shrinker_init(struct msm_vidc_core *core);
+void msm_vidc_ibuf_shrinker_deinit(struct msm_vidc_core *core);
 void msm_vidc_print_stats(struct msm_vidc_inst *inst);
 enum msm_vidc_buffer_type v4l2_type_to_driver(u32 type,
 	const char *func);
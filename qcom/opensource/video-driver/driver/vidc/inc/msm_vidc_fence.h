@@ -19,6 +19,13 @@ int msm_vidc_fence_signal(struct msm_vidc_inst *inst,
 		u32 fence_id);
 void msm_vidc_fence_destroy(struct msm_vidc_inst *inst,
 		u32 fence_id);
+int msm_vidc_fence_attach_input(struct msm_vidc_inst *inst,
+		struct msm_vidc_buffer *buf);
+void msm_vidc_fence_detach_input(struct msm_vidc_inst *inst,
+		struct msm_vidc_buffer *buf);
+bool msm_vidc_fence_input_blocked(struct msm_vidc_inst *inst,
+		struct msm_vidc_buffer *buf);
+void msm_vidc_input_fence_handler(struct work_struct *work);
 int msm_vidc_fence_init(struct msm_vidc_inst *inst);
 void msm_vidc_fence_deinit(struct msm_vidc_inst *inst);
 
@@ -108,6 +108,7 @@ struct buf_queue {
 
 struct msm_vidc_inst {
 	struct list_head                   list;
+	struct hlist_node                  session_node;
 	struct mutex                       lock;
 	struct mutex                       request_lock;
 	struct mutex                       client_lock;
@@ -140,6 +141,9 @@ struct msm_vidc_inst {
 	struct msm_memory_pool             pool[MSM_MEM_POOL_MAX];
 	struct msm_vidc_buffers_info       buffers;
 	struct msm_vidc_mappings_info      mappings;
+	struct msm_vidc_map_cache          map_cache;
+	struct msm_vidc_ibuf_pool          ibuf_pool;
+	struct msm_vidc_cmdq_batch         cmdq_batch;
 	struct msm_vidc_allocations_info   allocations;
 	struct msm_vidc_timestamps         timestamps;
 	struct msm_vidc_timestamps         ts_reorder; /* list of struct msm_vidc_timestamp */
@@ -150,12 +154,16 @@ struct msm_vidc_inst {
 	struct msm_vidc_subscription_params       subcr_params[MAX_PORT];
 	struct msm_vidc_hfi_frame_info     hfi_frame_info;
 	struct msm_vidc_decode_batch       decode_batch;
+	struct msm_vidc_sched              sched;
 	struct msm_vidc_decode_vpp_delay   decode_vpp_delay;
 	struct msm_vidc_session_idle       session_idle;
 	struct delayed_work                stats_work;
 	struct work_struct                 stability_work;
 	struct msm_vidc_stability          stability;
 	struct workqueue_struct           *workq;
+	struct work_struct                 response_work;
+	struct list_head                   response_list; /* list of struct msm_vidc_inst_response */
+	spinlock_t                         response_lock;
 	struct list_head                   enc_input_crs;
 	struct list_head                   dmabuf_tracker; /* list of struct msm_memory_dmabuf */
 	struct list_head                   input_timer_list; /* list of struct msm_vidc_input_timer */
@@ -164,6 +172,7 @@ struct msm_vidc_inst {
 	struct list_head                   firmware_list; /* struct msm_vidc_inst_cap_entry */
 	struct list_head                   pending_pkts; /* list of struct hfi_pending_packet */
 	struct list_head                   fence_list; /* list of struct msm_vidc_fence */
+	struct work_struct                 input_fence_work;
 	struct list_head                   buffer_stats_list; /* struct msm_vidc_buffer_stats */
 	bool                               once_per_session_set;
 	bool                               ipsc_properties_set;
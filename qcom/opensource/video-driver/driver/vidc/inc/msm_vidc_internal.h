@@ -39,6 +39,7 @@
 #define MAX_CAP_CHILDREN         20
 #define DEFAULT_MAX_HOST_BUF_COUNT  64
 #define DEFAULT_MAX_HOST_BURST_BUF_COUNT 256
+#define MAX_MAP_CACHE_COUNT         64
 #define BIT_DEPTH_8 (8 << 16 | 8)
 #define BIT_DEPTH_10 (10 << 16 | 10)
 #define CODED_FRAMES_PROGRESSIVE 0x0
@@ -422,6 +423,7 @@ enum msm_vidc_inst_capability_type {
 	SECURE_MODE,
 	FENCE_ID,
 	FENCE_FD,
+	INPUT_FENCE_FD,
 	TS_REORDER,
 	HFLIP,
 	VFLIP,
@@ -793,6 +795,34 @@ struct msm_vidc_decode_vpp_delay {
 	u32                    size;
 };
 
+#define MSM_VIDC_SCHED_UPDATE_INTERVAL_NS (100 * NSEC_PER_MSEC)
+#define MSM_VIDC_SCHED_MIN_NRT_FPS 1
+
+enum msm_vidc_sched_class {
+	MSM_VIDC_SCHED_CRITICAL          = 0,
+	MSM_VIDC_SCHED_REALTIME          = 1,
+	MSM_VIDC_SCHED_NON_REALTIME      = 2,
+};
+
+struct msm_vidc_sched {
+	enum msm_vidc_sched_class   class;
+	u32                         load_mbps;
+	u32                         avg_load_mbps;
+	u32                         max_fps; /* input pacing limit, 0: unthrottled */
+	u64                         last_update_ns;
+	u64                         last_etb_ns;
+	u64                         throttled;
+	struct delayed_work         pace_work;
+};
+
+struct msm_vidc_core_sched {
+	u32                         rt_load_mbps;
+	u32                         nrt_load_mbps;
+	u32                         avg_rt_load_mbps;
+	u32                         avg_nrt_load_mbps;
+	u32                         num_nrt_sessions;
+};
+
 struct msm_vidc_decode_batch {
 	bool                   enable;
 	u32                    size;
@@ -828,6 +858,19 @@ struct vidc_bus_vote_data {
 	bool vpss_preprocessing_enabled;
 };
 
+/* state of the firmware feedback driven (content adaptive) dcvs */
+struct msm_vidc_dcvs_feedback {
+	u64                    last_done_us;
+	u64                    busy_us;          /* filtered fw time per frame */
+	u64                    actual_cycles;    /* filtered fw cycles per frame */
+	u64                    predicted_cycles; /* cycles expected for next frame */
+	u32                    complexity;       /* Q16, last reported by fw */
+	u32                    avg_complexity;   /* Q16, running average */
+	s32                    integral;
+	s32                    prev_error;
+	u32                    frames;
+};
+
 struct msm_vidc_power {
 	enum msm_vidc_power_mode power_mode;
 	u32                    buffer_counter;
@@ -843,6 +886,7 @@ struct msm_vidc_power {
 	u32                    dcvs_flags;
 	u32                    fw_cr;
 	u32                    fw_cf;
+	struct msm_vidc_dcvs_feedback fb;
 };
 
 struct msm_vidc_fence_context {
@@ -888,12 +932,60 @@ struct msm_vidc_map {
 	struct sg_table            *table;
 	struct dma_buf_attachment  *attach;
 	u32                         skip_delayed_unmap:1;
+	u32                         cached:1;
+};
+
+/* session lookup table used by the response handler */
+#define MSM_VIDC_SESSION_HASH_BITS 4
+
+/* copy of one session response packet, handled by inst->response_work */
+struct msm_vidc_inst_response {
+	struct list_head            list;
+	u32                         size;
+	u8                          data[];
+};
+
+struct msm_vidc_cmdq_batch {
+	bool                        active;
+	bool                        intr_pending;
+	u32                         count;
+};
+
+/* released internal buffer kept mapped for reuse on reconfig */
+struct msm_vidc_ibuf_pool_entry {
+	struct list_head            list;
+	struct msm_vidc_alloc      *alloc;
+	struct msm_vidc_map        *map;
+};
+
+struct msm_vidc_ibuf_pool {
+	struct list_head            list; /* list of struct msm_vidc_ibuf_pool_entry */
+	u32                         count;
+	u64                         bytes;
+	u32                         max_size[MSM_VIDC_BUF_PARTIAL_DATA + 1];
+	u64                         hits;
+	u64                         misses;
+	u64                         shrunk;
+};
+
+struct msm_vidc_map_cache {
+	u32                         count;
+	u64                         hits;
+	u64                         misses;
+	u64                         evictions;
 };
 
 struct msm_vidc_mappings {
 	struct list_head            list; // list of "struct msm_vidc_map"
 };
 
+/* producer fence an encoder input buffer waits on before etb */
+struct msm_vidc_input_fence {
+	struct dma_fence                  *fence;
+	struct dma_fence_cb                cb;
+	void                              *inst;
+};
+
 struct msm_vidc_buffer {
 	struct list_head                   list;
 	enum msm_vidc_buffer_type          type;
@@ -911,6 +1003,7 @@ struct msm_vidc_buffer {
 	u32                                end_time_ms;
 	u64                                fence_id[MAX_FENCE_COUNT];
 	u32                                fence_count;
+	struct msm_vidc_input_fence        in_fence;
 };
 
 struct msm_vidc_buffers {
@@ -927,6 +1020,7 @@ struct msm_vidc_buffer_stats {
 	u32                                frame_num;
 	u64                                timestamp;
 	u32                                etb_time_ms;
+	u64                                etb_time_us;
 	u32                                ebd_time_ms;
 	u32                                ftb_time_ms;
 	u32                                fbd_time_ms;
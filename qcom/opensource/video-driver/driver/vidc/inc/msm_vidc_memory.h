@@ -6,6 +6,10 @@
 #ifndef _MSM_VIDC_MEMORY_H_
 #define _MSM_VIDC_MEMORY_H_
 
+#include <linux/llist.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+
 #include "msm_vidc_internal.h"
 
 struct msm_vidc_core;
@@ -32,17 +36,26 @@ enum msm_memory_pool_type {
 };
 
 struct msm_memory_alloc_header {
-	struct list_head       list;
+	struct list_head       list; /* all_pool entry, for the lifetime of hdr */
+	struct llist_node      node; /* free_pool entry, while not in use */
 	u32                    type;
-	bool                   busy;
+	atomic_t               busy;
 	void                  *buf;
 };
 
+/*
+ * free_pool is a lock-free list: frees only push, so they never take a
+ * lock. Pops take pool->lock just to keep llist_del_first() single
+ * consumer; it is never held across anything but the pop itself.
+ */
 struct msm_memory_pool {
 	u32                    size;
 	char                  *name;
-	struct list_head       free_pool; /* list of struct msm_memory_alloc_header */
-	struct list_head       busy_pool; /* list of struct msm_memory_alloc_header */
+	struct llist_head      free_pool; /* list of struct msm_memory_alloc_header */
+	struct list_head       all_pool;  /* list of struct msm_memory_alloc_header */
+	spinlock_t             lock;
+	atomic_t               busy_count;
+	u32                    total_count;
 };
 
 int msm_vidc_memory_alloc(struct msm_vidc_core *core,
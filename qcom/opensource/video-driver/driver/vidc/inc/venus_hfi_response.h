@@ -19,5 +19,6 @@ bool is_valid_hfi_buffer_type(struct msm_vidc_inst *inst,
 int handle_system_error(struct msm_vidc_core *core,
 	struct hfi_packet *pkt);
 void fw_coredump(struct msm_vidc_core *core);
+void handle_session_response_work_handler(struct work_struct *work);
 
 #endif // __VENUS_HFI_RESPONSE_H__
@@ -958,6 +958,7 @@ void *msm_vidc_open(void *vidc_core, u32 session_type)
 	INIT_LIST_HEAD(&inst->pending_pkts);
 	INIT_LIST_HEAD(&inst->fence_list);
 	INIT_LIST_HEAD(&inst->buffer_stats_list);
+	INIT_LIST_HEAD(&inst->ibuf_pool.list);
 	for (i = 0; i < MAX_SIGNAL; i++)
 		init_completion(&inst->completions[i]);
 
@@ -969,6 +970,12 @@ void *msm_vidc_open(void *vidc_core, u32 session_type)
 
 	INIT_DELAYED_WORK(&inst->stats_work, msm_vidc_stats_handler);
 	INIT_WORK(&inst->stability_work, msm_vidc_stability_handler);
+	INIT_DELAYED_WORK(&inst->sched.pace_work, msm_vidc_sched_pace_handler);
+	INIT_WORK(&inst->input_fence_work, msm_vidc_input_fence_handler);
+	INIT_HLIST_NODE(&inst->session_node);
+	INIT_LIST_HEAD(&inst->response_list);
+	spin_lock_init(&inst->response_lock);
+	INIT_WORK(&inst->response_work, handle_session_response_work_handler);
 
 	rc = msm_vidc_vmem_alloc(sizeof(struct msm_vidc_inst_capability),
 		(void **)&inst->capabilities, "inst capability");
@@ -1045,6 +1052,8 @@ int msm_vidc_close(void *instance)
 	client_unlock(inst, __func__);
 	cancel_stability_work_sync(inst);
 	cancel_stats_work_sync(inst);
+	cancel_sched_work_sync(inst);
+	cancel_work_sync(&inst->input_fence_work);
 	msm_vidc_show_stats(inst);
 	put_inst(inst);
 	msm_vidc_schedule_core_deinit(core);
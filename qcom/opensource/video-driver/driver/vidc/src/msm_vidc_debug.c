@@ -127,6 +127,7 @@ bool msm_vidc_syscache_disable = !true;
 EXPORT_SYMBOL(msm_vidc_syscache_disable);
 
 int msm_vidc_clock_voting = !1;
+bool msm_vidc_content_dcvs = !true;
 int msm_vidc_ddr_bw = !1;
 int msm_vidc_llc_bw = !1;
 
@@ -231,6 +232,11 @@ static ssize_t core_info_read(struct file* file, char __user* buf,
 	cur += write_str(cur, end - cur,
 		"register_size: %u\n", core->dt->register_size);
 	cur += write_str(cur, end - cur, "irq: %u\n", core->dt->irq);
+	cur += write_str(cur, end - cur, "rt load: %u mbps (avg %u)\n",
+		core->sched.rt_load_mbps, core->sched.avg_rt_load_mbps);
+	cur += write_str(cur, end - cur, "nrt load: %u mbps (avg %u) sessions %u\n",
+		core->sched.nrt_load_mbps, core->sched.avg_nrt_load_mbps,
+		core->sched.num_nrt_sessions);
 
 	len = simple_read_from_buffer(buf, count, ppos,
 		dbuf, cur - dbuf);
@@ -399,6 +405,8 @@ struct dentry* msm_vidc_debugfs_init_drv(void)
 			&msm_vidc_syscache_disable);
 	debugfs_create_bool("lossless_encoding", 0644, dir,
 			&msm_vidc_lossless_encode);
+	debugfs_create_bool("content_dcvs", 0644, dir,
+			&msm_vidc_content_dcvs);
 	debugfs_create_u32("enable_bugon", 0644, dir,
 			&msm_vidc_enable_bugon);
 
@@ -542,6 +550,32 @@ static ssize_t inst_info_read(struct file *file, char __user *buf,
 		inst->debug_count.ftb);
 	cur += write_str(cur, end - cur, "FBD Count: %d\n",
 		inst->debug_count.fbd);
+	cur += write_str(cur, end - cur, "-------------------------------\n");
+	cur += write_str(cur, end - cur, "Map cache count: %u\n",
+		inst->map_cache.count);
+	cur += write_str(cur, end - cur, "Map cache hits: %llu\n",
+		inst->map_cache.hits);
+	cur += write_str(cur, end - cur, "Map cache misses: %llu\n",
+		inst->map_cache.misses);
+	cur += write_str(cur, end - cur, "Map cache evictions: %llu\n",
+		inst->map_cache.evictions);
+	cur += write_str(cur, end - cur, "-------------------------------\n");
+	cur += write_str(cur, end - cur, "Internal buf pool: %u bufs %llu bytes\n",
+		inst->ibuf_pool.count, inst->ibuf_pool.bytes);
+	cur += write_str(cur, end - cur, "Internal buf pool hits: %llu misses: %llu shrunk: %llu\n",
+		inst->ibuf_pool.hits, inst->ibuf_pool.misses, inst->ibuf_pool.shrunk);
+	cur += write_str(cur, end - cur, "Sched class: %d\n",
+		inst->sched.class);
+	cur += write_str(cur, end - cur, "Sched load: %u mbps (avg %u)\n",
+		inst->sched.load_mbps, inst->sched.avg_load_mbps);
+	cur += write_str(cur, end - cur, "Sched max fps: %u throttled: %llu\n",
+		inst->sched.max_fps, inst->sched.throttled);
+	cur += write_str(cur, end - cur, "DCVS predicted cycles: %llu\n",
+		inst->power.fb.predicted_cycles);
+	cur += write_str(cur, end - cur, "DCVS actual cycles: %llu\n",
+		inst->power.fb.actual_cycles);
+	cur += write_str(cur, end - cur, "DCVS complexity: %#x (avg %#x)\n",
+		inst->power.fb.complexity, inst->power.fb.avg_complexity);
 
 	publish_unreleased_reference(inst, &cur, end);
 	len = simple_read_from_buffer(buf, count, ppos,
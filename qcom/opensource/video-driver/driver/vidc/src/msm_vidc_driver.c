@@ -114,6 +114,7 @@ static const struct msm_vidc_cap_name cap_name_arr[] = {
 	{SECURE_MODE,                    "SECURE_MODE"                },
 	{FENCE_ID,                       "FENCE_ID"                   },
 	{FENCE_FD,                       "FENCE_FD"                   },
+	{INPUT_FENCE_FD,                 "INPUT_FENCE_FD"             },
 	{TS_REORDER,                     "TS_REORDER"                 },
 	{HFLIP,                          "HFLIP"                      },
 	{VFLIP,                          "VFLIP"                      },
@@ -566,6 +567,7 @@ int msm_vidc_add_buffer_stats(struct msm_vidc_inst *inst,
 	stats->frame_num = inst->debug_count.etb;
 	stats->timestamp = buf->timestamp;
 	stats->etb_time_ms = buf->start_time_ms;
+	stats->etb_time_us = ktime_get_ns() / 1000;
 	if (is_decode_session(inst))
 		stats->data_size =  buf->data_size;
 
@@ -619,6 +621,7 @@ int msm_vidc_remove_buffer_stats(struct msm_vidc_inst *inst,
 					stats->data_size = buf->data_size;
 
 				print_buffer_stats(VIDC_STAT, "stat", inst, stats);
+				msm_vidc_dcvs_frame_done(inst, stats->etb_time_us);
 
 				msm_memory_pool_free(inst, stats);
 			}
@@ -1607,6 +1610,7 @@ bool msm_vidc_allow_s_ctrl(struct msm_vidc_inst *inst, u32 id)
 			case V4L2_CID_MPEG_VIDC_INPUT_METADATA_FD:
 			case V4L2_CID_MPEG_VIDC_INTRA_REFRESH_PERIOD:
 			case V4L2_CID_MPEG_VIDC_RESERVE_DURATION:
+			case V4L2_CID_MPEG_VIDC_INPUT_FENCE_FD:
 				allow = true;
 				break;
 			default:
@@ -2679,6 +2683,11 @@ int msm_vidc_memory_unmap_completely(struct msm_vidc_inst *inst,
 	if (!map->refcount)
 		return 0;
 
+	if (map->cached) {
+		map->cached = 0;
+		inst->map_cache.count--;
+	}
+
 	while (map->refcount) {
 		rc = msm_vidc_memory_unmap(inst->core, map);
 		if (rc)
@@ -3164,6 +3173,94 @@ int msm_vidc_put_delayed_unmap(struct msm_vidc_inst *inst, struct msm_vidc_map *
 	return rc;
 }
 
+static bool msm_vidc_is_map_cacheable(struct msm_vidc_inst *inst,
+	enum msm_vidc_buffer_type type)
+{
+	/* decoder output buffers stay mapped through delayed unmap */
+	if (is_decode_session(inst) && type == MSM_VIDC_BUF_OUTPUT)
+		return false;
+
+	return type == MSM_VIDC_BUF_INPUT || type == MSM_VIDC_BUF_INPUT_META ||
+		type == MSM_VIDC_BUF_OUTPUT || type == MSM_VIDC_BUF_OUTPUT_META;
+}
+
+static void msm_vidc_map_cache_drop(struct msm_vidc_inst *inst,
+	struct msm_vidc_map *map)
+{
+	if (map->refcount > 1) {
+		map->cached = 0;
+		inst->map_cache.count--;
+		msm_vidc_memory_unmap(inst->core, map);
+		return;
+	}
+
+	msm_vidc_memory_unmap_completely(inst, map);
+}
+
+/*
+ * unmap least recently used idle mappings until at most max
+ * mappings are held by the cache
+ */
+static void msm_vidc_map_cache_trim(struct msm_vidc_inst *inst, u32 max)
+{
+	static const enum msm_vidc_buffer_type types[] = {
+		MSM_VIDC_BUF_INPUT, MSM_VIDC_BUF_INPUT_META,
+		MSM_VIDC_BUF_OUTPUT, MSM_VIDC_BUF_OUTPUT_META,
+	};
+	struct msm_vidc_mappings *mappings;
+	struct msm_vidc_map *map, *dummy;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		if (inst->map_cache.count <= max)
+			return;
+
+		mappings = msm_vidc_get_mappings(inst, types[i], __func__);
+		if (!mappings)
+			continue;
+
+		list_for_each_entry_safe(map, dummy, &mappings->list, list) {
+			if (inst->map_cache.count <= max)
+				return;
+			/* skip mappings still used by a queued buffer */
+			if (!map->cached || map->refcount > 1)
+				continue;
+			msm_vidc_map_cache_drop(inst, map);
+			inst->map_cache.evictions++;
+		}
+	}
+}
+
+/*
+ * Keep one extra reference on a newly mapped client buffer, so that it
+ * stays mapped after being dequeued. Clients rotating through a fixed
+ * buffer pool then find the mapping on the next queue and skip the
+ * attach and SMMU map. Mappings are kept in LRU order on the mappings
+ * list and unmapped when the cache is full or a new map runs out of
+ * memory.
+ */
+static int msm_vidc_map_cache_get(struct msm_vidc_inst *inst,
+	struct msm_vidc_map *map)
+{
+	int rc = 0;
+
+	inst->map_cache.misses++;
+	msm_vidc_map_cache_trim(inst, MAX_MAP_CACHE_COUNT - 1);
+
+	rc = msm_vidc_memory_map(inst->core, map);
+	if (rc == -ENOMEM) {
+		msm_vidc_map_cache_trim(inst, 0);
+		rc = msm_vidc_memory_map(inst->core, map);
+	}
+	if (rc)
+		return rc;
+
+	map->cached = 1;
+	inst->map_cache.count++;
+
+	return 0;
+}
+
 int msm_vidc_unmap_buffers(struct msm_vidc_inst *inst,
 	enum msm_vidc_buffer_type type)
 {
@@ -3280,7 +3377,14 @@ int msm_vidc_map_driver_buf(struct msm_vidc_inst *inst,
 			rc = msm_vidc_get_delayed_unmap(inst, map);
 			if (rc)
 				goto error;
+		} else if (msm_vidc_is_map_cacheable(inst, buf->type)) {
+			rc = msm_vidc_map_cache_get(inst, map);
+			if (rc)
+				goto error;
 		}
+	} else if (map->cached) {
+		inst->map_cache.hits++;
+		list_move_tail(&map->list, &mappings->list);
 	}
 	rc = msm_vidc_memory_map(inst->core, map);
 	if (rc)
@@ -3293,6 +3397,11 @@ error:
 	if (!found) {
 		if (is_decode_session(inst) && is_output_buffer(buf->type))
 			msm_vidc_put_delayed_unmap(inst, map);
+		else if (map->cached) {
+			map->cached = 0;
+			inst->map_cache.count--;
+			msm_vidc_memory_unmap(inst->core, map);
+		}
 		msm_vidc_memory_put_dmabuf(inst, map->dmabuf);
 		list_del_init(&map->list);
 		msm_memory_pool_free(inst, map);
@@ -3310,6 +3419,8 @@ int msm_vidc_put_driver_buf(struct msm_vidc_inst *inst,
 		return -EINVAL;
 	}
 
+	msm_vidc_fence_detach_input(inst, buf);
+
 	msm_vidc_unmap_driver_buf(inst, buf);
 
 	msm_vidc_memory_put_dmabuf(inst, buf->dmabuf);
@@ -3706,6 +3817,17 @@ int schedule_stats_work(struct msm_vidc_inst *inst)
 	return 0;
 }
 
+int cancel_sched_work_sync(struct msm_vidc_inst *inst)
+{
+	if (!inst) {
+		d_vpr_e("%s: Invalid arguments\n", __func__);
+		return -EINVAL;
+	}
+	cancel_delayed_work_sync(&inst->sched.pace_work);
+
+	return 0;
+}
+
 int cancel_stats_work_sync(struct msm_vidc_inst *inst)
 {
 	if (!inst) {
@@ -3922,15 +4044,217 @@ int msm_vidc_queue_deferred_buffers(struct msm_vidc_inst *inst, enum msm_vidc_bu
 
 	msm_vidc_scale_power(inst, true);
 
+	venus_hfi_queue_buffer_batch_start(inst);
 	list_for_each_entry(buf, &buffers->list, list) {
 		if (!(buf->attr & MSM_VIDC_ATTR_DEFERRED))
 			continue;
+		/* rest is queued from input_fence_work once signalled */
+		if (msm_vidc_fence_input_blocked(inst, buf))
+			break;
 		rc = msm_vidc_queue_buffer(inst, buf);
 		if (rc)
-			return rc;
+			break;
 	}
+	/* raise the interrupt for the buffers written so far even on error */
+	if (venus_hfi_queue_buffer_batch_end(inst) && !rc)
+		rc = -EINVAL;
 
-	return 0;
+	return rc;
+}
+
+static enum msm_vidc_sched_class msm_vidc_get_sched_class(
+	struct msm_vidc_inst *inst)
+{
+	if (is_critical_priority_session(inst))
+		return MSM_VIDC_SCHED_CRITICAL;
+
+	if (msm_vidc_ignore_session_load(inst))
+		return MSM_VIDC_SCHED_NON_REALTIME;
+
+	return MSM_VIDC_SCHED_REALTIME;
+}
+
+static u32 msm_vidc_get_nrt_load(struct msm_vidc_inst *inst)
+{
+	/* nrt sessions run as fast as they are fed, use the queuing rate */
+	return msm_vidc_get_mbs_per_frame(inst) * msm_vidc_get_input_rate(inst);
+}
+
+/*
+ * Refresh the core load split between realtime and non realtime sessions
+ * and derive the input rate a non realtime session may use without eating
+ * into the capacity needed by the realtime ones.
+ */
+static void msm_vidc_sched_update(struct msm_vidc_inst *inst)
+{
+	struct msm_vidc_core *core;
+	struct msm_vidc_sched *sched;
+	struct msm_vidc_inst *instance;
+	u32 rt_mbps = 0, nrt_mbps = 0, num_nrt = 0;
+	u32 max_mbps, budget, mbpf;
+	u64 now;
+
+	core = inst->core;
+	sched = &inst->sched;
+
+	now = ktime_get_ns();
+	if (now - sched->last_update_ns < MSM_VIDC_SCHED_UPDATE_INTERVAL_NS)
+		return;
+	sched->last_update_ns = now;
+	sched->class = msm_vidc_get_sched_class(inst);
+
+	core_lock(core, __func__);
+	list_for_each_entry(instance, &core->instances, list) {
+		if (is_session_error(instance) || is_thumbnail_session(instance) ||
+			is_image_session(instance))
+			continue;
+
+		if (msm_vidc_get_sched_class(instance) == MSM_VIDC_SCHED_NON_REALTIME) {
+			nrt_mbps += msm_vidc_get_nrt_load(instance);
+			num_nrt++;
+		} else {
+			rt_mbps += msm_vidc_get_inst_load(instance);
+		}
+	}
+
+	/* avg = 7/8 * avg + 1/8 * sample */
+	core->sched.rt_load_mbps = rt_mbps;
+	core->sched.nrt_load_mbps = nrt_mbps;
+	core->sched.num_nrt_sessions = num_nrt;
+	core->sched.avg_rt_load_mbps =
+		(core->sched.avg_rt_load_mbps * 7 + rt_mbps) >> 3;
+	core->sched.avg_nrt_load_mbps =
+		(core->sched.avg_nrt_load_mbps * 7 + nrt_mbps) >> 3;
+	max_mbps = core->capabilities[MAX_MBPS].value;
+	core_unlock(core, __func__);
+
+	if (sched->class == MSM_VIDC_SCHED_NON_REALTIME)
+		sched->load_mbps = msm_vidc_get_nrt_load(inst);
+	else
+		sched->load_mbps = msm_vidc_get_inst_load(inst);
+	sched->avg_load_mbps = (sched->avg_load_mbps * 7 + sched->load_mbps) >> 3;
+
+	sched->max_fps = 0;
+	if (sched->class != MSM_VIDC_SCHED_NON_REALTIME || !num_nrt ||
+		rt_mbps + nrt_mbps <= max_mbps)
+		return;
+
+	/* share what realtime sessions leave over among nrt sessions */
+	budget = max_mbps > rt_mbps ? (max_mbps - rt_mbps) / num_nrt : 0;
+	mbpf = msm_vidc_get_mbs_per_frame(inst);
+	sched->max_fps = max_t(u32, mbpf ? budget / mbpf : 0,
+		MSM_VIDC_SCHED_MIN_NRT_FPS);
+
+	i_vpr_h(inst,
+		"%s: pacing nrt input to %u fps, rt load %u nrt load %u max %u\n",
+		__func__, sched->max_fps, rt_mbps, nrt_mbps, max_mbps);
+}
+
+/* returns true if the input buffer has to wait for the pacing work */
+static bool msm_vidc_sched_throttle_input(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buf)
+{
+	struct msm_vidc_core *core;
+	struct msm_vidc_sched *sched;
+	u64 now, interval_ns, next_ns;
+
+	if (!is_input_buffer(buf->type) || is_image_session(inst) ||
+		is_thumbnail_session(inst))
+		return false;
+
+	core = inst->core;
+	sched = &inst->sched;
+
+	msm_vidc_sched_update(inst);
+	if (!sched->max_fps)
+		return false;
+
+	now = ktime_get_ns();
+	interval_ns = div_u64(NSEC_PER_SEC, sched->max_fps);
+	next_ns = sched->last_etb_ns + interval_ns;
+
+	/* keep input order: wait behind buffers already held for pacing */
+	if (now >= next_ns && msm_vidc_num_buffers(inst,
+			MSM_VIDC_BUF_INPUT, MSM_VIDC_ATTR_DEFERRED) <= 1) {
+		sched->last_etb_ns = now;
+		return false;
+	}
+
+	sched->throttled++;
+	queue_delayed_work(core->batch_workq, &sched->pace_work,
+		nsecs_to_jiffies(next_ns > now ? next_ns - now : 0));
+
+	return true;
+}
+
+void msm_vidc_sched_pace_handler(struct work_struct *work)
+{
+	struct msm_vidc_inst *inst;
+	struct msm_vidc_core *core;
+	struct msm_vidc_buffer *buf;
+	enum msm_vidc_allow allow;
+	bool pending = false, queued = false;
+	int rc = 0;
+
+	inst = container_of(work, struct msm_vidc_inst, sched.pace_work.work);
+	inst = get_inst_ref(g_core, inst);
+	if (!inst || !inst->core) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+
+	core = inst->core;
+	inst_lock(inst, __func__);
+	if (is_session_error(inst)) {
+		i_vpr_e(inst, "%s: failled. Session error\n", __func__);
+		goto exit;
+	}
+
+	if (core->pm_suspended) {
+		i_vpr_h(inst, "%s: device in pm suspend state\n", __func__);
+		goto exit;
+	}
+
+	allow = msm_vidc_allow_qbuf(inst, INPUT_MPLANE);
+	if (allow != MSM_VIDC_ALLOW)
+		goto exit;
+
+	/* release one held input per pacing interval */
+	list_for_each_entry(buf, &inst->buffers.input.list, list) {
+		if (!(buf->attr & MSM_VIDC_ATTR_DEFERRED))
+			continue;
+		/* input_fence_work takes over once the producer signals */
+		if (msm_vidc_fence_input_blocked(inst, buf))
+			break;
+		if (queued) {
+			pending = true;
+			break;
+		}
+		msm_vidc_scale_power(inst, true);
+		rc = msm_vidc_queue_buffer(inst, buf);
+		if (rc) {
+			i_vpr_e(inst, "%s: paced qbuf failed\n", __func__);
+			msm_vidc_change_state(inst, MSM_VIDC_ERROR, __func__);
+			goto exit;
+		}
+		inst->sched.last_etb_ns = ktime_get_ns();
+		queued = true;
+	}
+
+	if (pending && inst->sched.max_fps)
+		queue_delayed_work(core->batch_workq, &inst->sched.pace_work,
+			nsecs_to_jiffies(div_u64(NSEC_PER_SEC, inst->sched.max_fps)));
+	else if (pending)
+		rc = msm_vidc_queue_deferred_buffers(inst, MSM_VIDC_BUF_INPUT);
+
+	if (rc) {
+		i_vpr_e(inst, "%s: deferred qbufs failed\n", __func__);
+		msm_vidc_change_state(inst, MSM_VIDC_ERROR, __func__);
+	}
+
+exit:
+	inst_unlock(inst, __func__);
+	put_inst(inst);
 }
 
 int msm_vidc_queue_buffer_single(struct msm_vidc_inst *inst, struct vb2_buffer *vb2)
@@ -3959,6 +4283,12 @@ int msm_vidc_queue_buffer_single(struct msm_vidc_inst *inst, struct vb2_buffer *
 			return rc;
 	}
 
+	if (is_input_buffer(buf->type)) {
+		rc = msm_vidc_fence_attach_input(inst, buf);
+		if (rc)
+			return rc;
+	}
+
 	allow = msm_vidc_allow_qbuf(inst, vb2->type);
 	if (allow == MSM_VIDC_DISALLOW) {
 		i_vpr_e(inst, "%s: qbuf not allowed\n", __func__);
@@ -3970,6 +4300,20 @@ int msm_vidc_queue_buffer_single(struct msm_vidc_inst *inst, struct vb2_buffer *
 		goto exit;
 	}
 
+	/* producer still owns this or an earlier input buffer */
+	if (msm_vidc_fence_input_blocked(inst, buf)) {
+		print_vidc_buffer(VIDC_LOW, "low ", "qbuf fenced", inst, buf);
+		rc = 0;
+		goto exit;
+	}
+
+	/* hold back nrt input so that realtime sessions keep their share */
+	if (msm_vidc_sched_throttle_input(inst, buf)) {
+		print_vidc_buffer(VIDC_LOW, "low ", "qbuf paced", inst, buf);
+		rc = 0;
+		goto exit;
+	}
+
 	msm_vidc_scale_power(inst, is_input_buffer(buf->type));
 
 	rc = msm_vidc_queue_buffer(inst, buf);
@@ -3984,6 +4328,209 @@ exit:
 	return rc;
 }
 
+static bool msm_vidc_is_ibuf_poolable(enum msm_vidc_buffer_type type)
+{
+	switch (type) {
+	case MSM_VIDC_BUF_BIN:
+	case MSM_VIDC_BUF_COMV:
+	case MSM_VIDC_BUF_NON_COMV:
+	case MSM_VIDC_BUF_LINE:
+	case MSM_VIDC_BUF_DPB:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void msm_vidc_ibuf_pool_free_entry(struct msm_vidc_inst *inst,
+	struct msm_vidc_ibuf_pool_entry *entry)
+{
+	struct msm_vidc_core *core = inst->core;
+	struct msm_vidc_ibuf_pool *pool = &inst->ibuf_pool;
+
+	i_vpr_h(inst, "%s: type: %8s, size: %9u, device_addr %#x\n", __func__,
+		buf_name(entry->alloc->type), entry->alloc->size,
+		entry->map->device_addr);
+
+	list_del(&entry->list);
+	pool->count--;
+	pool->bytes -= entry->alloc->size;
+	atomic64_sub(entry->alloc->size, &core->ibuf_pool_bytes);
+
+	msm_vidc_memory_unmap(core, entry->map);
+	msm_memory_pool_free(inst, entry->map);
+	msm_vidc_memory_free(core, entry->alloc);
+	msm_memory_pool_free(inst, entry->alloc);
+	msm_vidc_vmem_free((void **)&entry);
+}
+
+/* returns number of bytes released */
+static u64 msm_vidc_ibuf_pool_drain(struct msm_vidc_inst *inst, u64 nr_bytes)
+{
+	struct msm_vidc_ibuf_pool_entry *entry, *dummy;
+	u64 freed = 0;
+
+	list_for_each_entry_safe(entry, dummy, &inst->ibuf_pool.list, list) {
+		if (freed >= nr_bytes)
+			break;
+		freed += entry->alloc->size;
+		msm_vidc_ibuf_pool_free_entry(inst, entry);
+	}
+
+	return freed;
+}
+
+/*
+ * Park a released internal buffer together with its mapping instead of
+ * freeing it, so that the next reconfig can pick it up without another
+ * dma heap allocation and iommu map.
+ */
+static bool msm_vidc_ibuf_pool_put(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buffer, struct msm_vidc_allocations *allocations,
+	struct msm_vidc_mappings *mappings)
+{
+	struct msm_vidc_core *core = inst->core;
+	struct msm_vidc_ibuf_pool_entry *entry = NULL;
+	struct msm_vidc_alloc *alloc, *found_alloc = NULL;
+	struct msm_vidc_map *map, *found_map = NULL;
+
+	if (!msm_vidc_is_ibuf_poolable(buffer->type) || is_session_error(inst))
+		return false;
+
+	list_for_each_entry(map, &mappings->list, list) {
+		if (map->dmabuf == buffer->dmabuf) {
+			found_map = map;
+			break;
+		}
+	}
+	list_for_each_entry(alloc, &allocations->list, list) {
+		if (alloc->dmabuf == buffer->dmabuf) {
+			found_alloc = alloc;
+			break;
+		}
+	}
+	if (!found_map || !found_alloc || found_alloc->map_kernel)
+		return false;
+
+	if (msm_vidc_vmem_alloc(sizeof(*entry), (void **)&entry, __func__))
+		return false;
+
+	list_del_init(&found_map->list);
+	list_del_init(&found_alloc->list);
+	entry->map = found_map;
+	entry->alloc = found_alloc;
+	list_add_tail(&entry->list, &inst->ibuf_pool.list);
+	inst->ibuf_pool.count++;
+	inst->ibuf_pool.bytes += found_alloc->size;
+	atomic64_add(found_alloc->size, &core->ibuf_pool_bytes);
+
+	return true;
+}
+
+/* best fit: smallest parked buffer of the same type and region */
+static struct msm_vidc_ibuf_pool_entry *msm_vidc_ibuf_pool_get(
+	struct msm_vidc_inst *inst, enum msm_vidc_buffer_type type,
+	enum msm_vidc_buffer_region region, u32 size)
+{
+	struct msm_vidc_core *core = inst->core;
+	struct msm_vidc_ibuf_pool *pool = &inst->ibuf_pool;
+	struct msm_vidc_ibuf_pool_entry *entry, *best = NULL;
+
+	list_for_each_entry(entry, &pool->list, list) {
+		if (entry->alloc->type != type || entry->alloc->region != region ||
+			entry->alloc->size < size)
+			continue;
+		if (!best || entry->alloc->size < best->alloc->size)
+			best = entry;
+	}
+
+	if (!best) {
+		pool->misses++;
+		return NULL;
+	}
+
+	list_del_init(&best->list);
+	pool->count--;
+	pool->bytes -= best->alloc->size;
+	atomic64_sub(best->alloc->size, &core->ibuf_pool_bytes);
+	pool->hits++;
+
+	return best;
+}
+
+static unsigned long msm_vidc_ibuf_shrink_count(struct shrinker *shrinker,
+	struct shrink_control *sc)
+{
+	struct msm_vidc_core *core;
+
+	core = container_of(shrinker, struct msm_vidc_core, ibuf_shrinker);
+
+	return atomic64_read(&core->ibuf_pool_bytes) >> PAGE_SHIFT;
+}
+
+static unsigned long msm_vidc_ibuf_shrink_scan(struct shrinker *shrinker,
+	struct shrink_control *sc)
+{
+	struct msm_vidc_core *core;
+	struct msm_vidc_inst *inst;
+	u64 target, freed = 0, bytes;
+
+	core = container_of(shrinker, struct msm_vidc_core, ibuf_shrinker);
+	target = (u64)sc->nr_to_scan << PAGE_SHIFT;
+
+	/* reclaim can run under any of these locks, never wait on them */
+	if (!mutex_trylock(&core->lock))
+		return SHRINK_STOP;
+
+	list_for_each_entry(inst, &core->instances, list) {
+		if (freed >= target)
+			break;
+		if (!mutex_trylock(&inst->lock))
+			continue;
+		bytes = msm_vidc_ibuf_pool_drain(inst, target - freed);
+		if (bytes) {
+			inst->ibuf_pool.shrunk += bytes;
+			/* do not grow buffers to the old max again */
+			memset(inst->ibuf_pool.max_size, 0,
+				sizeof(inst->ibuf_pool.max_size));
+		}
+		freed += bytes;
+		mutex_unlock(&inst->lock);
+	}
+	mutex_unlock(&core->lock);
+
+	return freed ? freed >> PAGE_SHIFT : SHRINK_STOP;
+}
+
+int msm_vidc_ibuf_shrinker_init(struct msm_vidc_core *core)
+{
+	if (!core) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return -EINVAL;
+	}
+
+	atomic64_set(&core->ibuf_pool_bytes, 0);
+	core->ibuf_shrinker.count_objects = msm_vidc_ibuf_shrink_count;
+	core->ibuf_shrinker.scan_objects = msm_vidc_ibuf_shrink_scan;
+	core->ibuf_shrinker.seeks = DEFAULT_SEEKS;
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0))
+	return register_shrinker(&core->ibuf_shrinker, "msm_vidc_ibuf");
+#else
+	return register_shrinker(&core->ibuf_shrinker);
+#endif
+}
+
+void msm_vidc_ibuf_shrinker_deinit(struct msm_vidc_core *core)
+{
+	if (!core) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+
+	unregister_shrinker(&core->ibuf_shrinker);
+}
+
 int msm_vidc_destroy_internal_buffer(struct msm_vidc_inst *inst,
 	struct msm_vidc_buffer *buffer)
 {
@@ -4018,6 +4565,9 @@ int msm_vidc_destroy_internal_buffer(struct msm_vidc_inst *inst,
 	if (!mappings)
 		return -EINVAL;
 
+	if (msm_vidc_ibuf_pool_put(inst, buffer, allocations, mappings))
+		goto remove_buffer;
+
 	list_for_each_entry_safe(map, map_dummy, &mappings->list, list) {
 		if (map->dmabuf == buffer->dmabuf) {
 			msm_vidc_memory_unmap(inst->core, map);
@@ -4036,6 +4586,7 @@ int msm_vidc_destroy_internal_buffer(struct msm_vidc_inst *inst,
 		}
 	}
 
+remove_buffer:
 	list_for_each_entry_safe(buf, dummy, &buffers->list, list) {
 		if (buf->dmabuf == buffer->dmabuf) {
 			list_del(&buf->list);
@@ -4100,6 +4651,9 @@ int msm_vidc_create_internal_buffer(struct msm_vidc_inst *inst,
 	struct msm_vidc_buffer *buffer;
 	struct msm_vidc_alloc *alloc;
 	struct msm_vidc_map *map;
+	struct msm_vidc_ibuf_pool_entry *entry = NULL;
+	enum msm_vidc_buffer_region region;
+	u32 alloc_size;
 
 	if (!inst || !inst->core) {
 		d_vpr_e("%s: invalid params\n", __func__);
@@ -4135,6 +4689,25 @@ int msm_vidc_create_internal_buffer(struct msm_vidc_inst *inst,
 	buffer->buffer_size = buffers->size;
 	list_add_tail(&buffer->list, &buffers->list);
 
+	region = msm_vidc_get_buffer_region(inst, buffer_type, __func__);
+	alloc_size = buffers->size;
+	if (msm_vidc_is_ibuf_poolable(buffer_type)) {
+		entry = msm_vidc_ibuf_pool_get(inst, buffer_type, region,
+			buffers->size);
+		/* size new buffers for the largest config seen so far */
+		inst->ibuf_pool.max_size[buffer_type] =
+			max(inst->ibuf_pool.max_size[buffer_type], buffers->size);
+		alloc_size = inst->ibuf_pool.max_size[buffer_type];
+	}
+	if (entry) {
+		alloc = entry->alloc;
+		map = entry->map;
+		msm_vidc_vmem_free((void **)&entry);
+		list_add_tail(&alloc->list, &allocations->list);
+		list_add_tail(&map->list, &mappings->list);
+		goto done;
+	}
+
 	alloc = msm_memory_pool_alloc(inst, MSM_MEM_POOL_ALLOC);
 	if (!alloc) {
 		i_vpr_e(inst, "%s: alloc failed\n", __func__);
@@ -4142,9 +4715,8 @@ int msm_vidc_create_internal_buffer(struct msm_vidc_inst *inst,
 	}
 	INIT_LIST_HEAD(&alloc->list);
 	alloc->type = buffer_type;
-	alloc->region = msm_vidc_get_buffer_region(inst,
-		buffer_type, __func__);
-	alloc->size = buffer->buffer_size;
+	alloc->region = region;
+	alloc->size = alloc_size;
 	alloc->secure = is_secure_region(alloc->region);
 	rc = msm_vidc_memory_alloc(inst->core, alloc);
 	if (rc)
@@ -4165,6 +4737,7 @@ int msm_vidc_create_internal_buffer(struct msm_vidc_inst *inst,
 		return -ENOMEM;
 	list_add_tail(&map->list, &mappings->list);
 
+done:
 	buffer->dmabuf = alloc->dmabuf;
 	buffer->device_addr = map->device_addr;
 	i_vpr_h(inst, "%s: create: type: %8s, size: %9u, device_addr %#x\n", __func__,
@@ -4239,6 +4812,7 @@ int msm_vidc_queue_internal_buffers(struct msm_vidc_inst *inst,
 		return 0;
 	}
 
+	venus_hfi_queue_buffer_batch_start(inst);
 	list_for_each_entry_safe(buffer, dummy, &buffers->list, list) {
 		/* do not queue pending release buffers */
 		if (buffer->flags & MSM_VIDC_ATTR_PENDING_RELEASE)
@@ -4248,15 +4822,17 @@ int msm_vidc_queue_internal_buffers(struct msm_vidc_inst *inst,
 			continue;
 		rc = venus_hfi_queue_buffer(inst, buffer, NULL);
 		if (rc)
-			return rc;
+			break;
 		/* mark queued */
 		buffer->attr |= MSM_VIDC_ATTR_QUEUED;
 
 		i_vpr_h(inst, "%s: queue: type: %8s, size: %9u, device_addr %#x\n", __func__,
 			buf_name(buffer->type), buffer->buffer_size, buffer->device_addr);
 	}
+	if (venus_hfi_queue_buffer_batch_end(inst) && !rc)
+		rc = -EINVAL;
 
-	return 0;
+	return rc;
 }
 
 int msm_vidc_alloc_and_queue_session_internal_buffers(struct msm_vidc_inst *inst,
@@ -4650,6 +5226,8 @@ int msm_vidc_add_session(struct msm_vidc_inst *inst)
 
 	if (count < core->capabilities[MAX_SESSION_COUNT].value) {
 		list_add_tail(&inst->list, &core->instances);
+		hash_add_rcu(core->session_table, &inst->session_node,
+			inst->session_id);
 	} else {
 		i_vpr_e(inst, "%s: max limit %d already running %d sessions\n",
 			__func__, core->capabilities[MAX_SESSION_COUNT].value, count);
@@ -4676,6 +5254,7 @@ int msm_vidc_remove_session(struct msm_vidc_inst *inst)
 	core_lock(core, __func__);
 	list_for_each_entry_safe(i, temp, &core->instances, list) {
 		if (i->session_id == inst->session_id) {
+			hash_del_rcu(&i->session_node);
 			list_del_init(&i->list);
 			list_add_tail(&i->list, &core->dangling_instances);
 			i_vpr_h(inst, "%s: removed session %#x\n",
@@ -5248,6 +5827,7 @@ int msm_vidc_core_deinit_locked(struct msm_vidc_core *core, bool force)
 	/* unlink all sessions from core, if any */
 	list_for_each_entry_safe(inst, dummy, &core->instances, list) {
 		msm_vidc_change_state(inst, MSM_VIDC_ERROR, __func__);
+		hash_del_rcu(&inst->session_node);
 		list_del_init(&inst->list);
 		list_add_tail(&inst->list, &core->dangling_instances);
 	}
@@ -5860,6 +6440,11 @@ int msm_vidc_flush_delayed_unmap_buffers(struct msm_vidc_inst *inst,
 			return -EINVAL;
 
 		list_for_each_entry_safe(map, dummy, &maps->list, list) {
+			/* no more queued buffers, drop the cached mappings */
+			if (map->cached) {
+				msm_vidc_map_cache_drop(inst, map);
+				continue;
+			}
 			/*
 			 * decoder output bufs will have skip_delayed_unmap = true
 			 * unmap all decoder output buffers except those present in
@@ -5937,6 +6522,7 @@ void msm_vidc_destroy_buffers(struct msm_vidc_inst *inst)
 			msm_vidc_destroy_internal_buffer(inst, buf);
 		}
 	}
+	msm_vidc_ibuf_pool_drain(inst, U64_MAX);
 
 	/* read_only and release list does not take dma ref_count using dma_buf_get().
 	   dma_buf ptr will be obselete when its ref_count reaches zero. Hence print
@@ -6027,12 +6613,41 @@ void msm_vidc_destroy_buffers(struct msm_vidc_inst *inst)
 	msm_memory_pools_deinit(inst);
 }
 
+static void msm_vidc_flush_session_table(struct msm_vidc_inst *inst)
+{
+	struct msm_vidc_inst_response *resp, *dummy;
+	struct msm_vidc_core *core;
+	unsigned long flags;
+
+	core = inst->core;
+
+	core_lock(core, __func__);
+	hash_del_rcu(&inst->session_node);
+	core_unlock(core, __func__);
+	/* wait for lockless get_inst() readers still walking this node */
+	synchronize_rcu();
+
+	/*
+	 * every queued response holds an inst reference, so the list is
+	 * expected to be empty here; this is a safety net only
+	 */
+	spin_lock_irqsave(&inst->response_lock, flags);
+	list_for_each_entry_safe(resp, dummy, &inst->response_list, list) {
+		i_vpr_e(inst, "%s: dropping response of size %u\n",
+			__func__, resp->size);
+		list_del(&resp->list);
+		kfree(resp);
+	}
+	spin_unlock_irqrestore(&inst->response_lock, flags);
+}
+
 static void msm_vidc_close_helper(struct kref *kref)
 {
 	struct msm_vidc_inst *inst = container_of(kref,
 		struct msm_vidc_inst, kref);
 
 	i_vpr_h(inst, "%s()\n", __func__);
+	msm_vidc_flush_session_table(inst);
 	msm_vidc_fence_deinit(inst);
 	msm_vidc_event_queue_deinit(inst);
 	msm_vidc_vb2_queue_deinit(inst);
@@ -6086,15 +6701,21 @@ struct msm_vidc_inst *get_inst(struct msm_vidc_core *core,
 		return NULL;
 	}
 
-	mutex_lock(&core->lock);
-	list_for_each_entry(inst, &core->instances, list) {
+	/*
+	 * called for every firmware response, so look the session up
+	 * locklessly; writers update the table under core->lock and the
+	 * inst is only freed after a grace period.
+	 */
+	rcu_read_lock();
+	hash_for_each_possible_rcu(core->session_table, inst,
+			session_node, session_id) {
 		if (inst->session_id == session_id) {
 			matches = true;
 			break;
 		}
 	}
 	inst = (matches && kref_get_unless_zero(&inst->kref)) ? inst : NULL;
-	mutex_unlock(&core->lock);
+	rcu_read_unlock();
 	return inst;
 }
 
@@ -192,6 +192,161 @@ void msm_vidc_fence_destroy(struct msm_vidc_inst *inst, u32 fence_id)
 	dma_fence_put(&fence->dma_fence);
 }
 
+static void msm_vidc_input_fence_cb(struct dma_fence *df,
+	struct dma_fence_cb *cb)
+{
+	struct msm_vidc_input_fence *in_fence;
+	struct msm_vidc_inst *inst;
+	struct msm_vidc_core *core;
+
+	in_fence = container_of(cb, struct msm_vidc_input_fence, cb);
+	inst = in_fence->inst;
+	core = inst->core;
+
+	/* runs in the producer signalling context, etb from a worker */
+	queue_work(core->batch_workq, &inst->input_fence_work);
+}
+
+int msm_vidc_fence_attach_input(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buf)
+{
+	struct dma_fence *fence;
+	int fd, rc = 0;
+
+	if (!inst || !buf || !inst->capabilities) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return -EINVAL;
+	}
+
+	if (inst->capabilities->cap[INPUT_FENCE_FD].cap_id != INPUT_FENCE_FD)
+		return 0;
+
+	fd = inst->capabilities->cap[INPUT_FENCE_FD].value;
+	if (fd == INVALID_FD)
+		return 0;
+
+	/* fence fd applies to the next queued input buffer only */
+	inst->capabilities->cap[INPUT_FENCE_FD].value = INVALID_FD;
+
+	fence = sync_file_get_fence(fd);
+	if (!fence) {
+		i_vpr_e(inst, "%s: invalid input fence fd %d\n", __func__, fd);
+		return -EINVAL;
+	}
+
+	buf->in_fence.fence = fence;
+	buf->in_fence.inst = inst;
+	rc = dma_fence_add_callback(fence, &buf->in_fence.cb,
+		msm_vidc_input_fence_cb);
+	if (rc) {
+		/* -ENOENT: already signalled, nothing to wait for */
+		dma_fence_put(fence);
+		buf->in_fence.fence = NULL;
+		return rc == -ENOENT ? 0 : rc;
+	}
+
+	i_vpr_l(inst, "%s: input fence %llu:%llu\n", __func__,
+		fence->context, fence->seqno);
+
+	return 0;
+}
+
+void msm_vidc_fence_detach_input(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buf)
+{
+	struct dma_fence *fence;
+
+	if (!inst || !buf) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+
+	fence = buf->in_fence.fence;
+	if (!fence)
+		return;
+
+	dma_fence_remove_callback(fence, &buf->in_fence.cb);
+	if (fence->error)
+		i_vpr_e(inst, "%s: input fence %llu:%llu error %d\n", __func__,
+			fence->context, fence->seqno, fence->error);
+	dma_fence_put(fence);
+	buf->in_fence.fence = NULL;
+}
+
+static bool msm_vidc_fence_input_pending(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buf)
+{
+	if (!buf->in_fence.fence)
+		return false;
+
+	if (!dma_fence_is_signaled(buf->in_fence.fence))
+		return true;
+
+	msm_vidc_fence_detach_input(inst, buf);
+	return false;
+}
+
+bool msm_vidc_fence_input_blocked(struct msm_vidc_inst *inst,
+	struct msm_vidc_buffer *buf)
+{
+	struct msm_vidc_buffer *temp;
+
+	if (!inst || !buf) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return false;
+	}
+
+	if (!is_input_buffer(buf->type))
+		return false;
+
+	/* keep input order: also wait behind earlier fenced buffers */
+	list_for_each_entry(temp, &inst->buffers.input.list, list) {
+		if (!(temp->attr & MSM_VIDC_ATTR_DEFERRED))
+			continue;
+		if (msm_vidc_fence_input_pending(inst, temp))
+			return true;
+		if (temp == buf)
+			break;
+	}
+
+	return false;
+}
+
+void msm_vidc_input_fence_handler(struct work_struct *work)
+{
+	struct msm_vidc_inst *inst;
+	enum msm_vidc_allow allow;
+	int rc = 0;
+
+	inst = container_of(work, struct msm_vidc_inst, input_fence_work);
+	inst = get_inst_ref(g_core, inst);
+	if (!inst) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+
+	inst_lock(inst, __func__);
+	if (is_session_error(inst)) {
+		i_vpr_e(inst, "%s: failled. Session error\n", __func__);
+		goto exit;
+	}
+
+	/* deferred buffers get queued on streamon otherwise */
+	allow = msm_vidc_allow_qbuf(inst, INPUT_MPLANE);
+	if (allow != MSM_VIDC_ALLOW)
+		goto exit;
+
+	rc = msm_vidc_queue_deferred_buffers(inst, MSM_VIDC_BUF_INPUT);
+	if (rc) {
+		i_vpr_e(inst, "%s: fenced qbufs failed\n", __func__);
+		msm_vidc_change_state(inst, MSM_VIDC_ERROR, __func__);
+	}
+
+exit:
+	inst_unlock(inst, __func__);
+	put_inst(inst);
+}
+
 int msm_vidc_fence_init(struct msm_vidc_inst *inst)
 {
 	int rc = 0;
@@ -477,10 +477,35 @@ int msm_vidc_memory_free(struct msm_vidc_core *core, struct msm_vidc_alloc *mem)
 	return rc;
 };
 
+static struct msm_memory_alloc_header *msm_memory_pool_new(
+	struct msm_memory_pool *pool, enum msm_memory_pool_type type)
+{
+	struct msm_memory_alloc_header *hdr = NULL;
+	unsigned long flags;
+
+	if (msm_vidc_vmem_alloc(pool->size + sizeof(struct msm_memory_alloc_header),
+			(void **)&hdr, __func__))
+		return NULL;
+
+	INIT_LIST_HEAD(&hdr->list);
+	hdr->type = type;
+	atomic_set(&hdr->busy, 0);
+	hdr->buf = (void *)(hdr + 1);
+
+	spin_lock_irqsave(&pool->lock, flags);
+	list_add_tail(&hdr->list, &pool->all_pool);
+	pool->total_count++;
+	spin_unlock_irqrestore(&pool->lock, flags);
+
+	return hdr;
+}
+
 void *msm_memory_pool_alloc(struct msm_vidc_inst *inst, enum msm_memory_pool_type type)
 {
 	struct msm_memory_alloc_header *hdr = NULL;
 	struct msm_memory_pool *pool;
+	struct llist_node *node;
+	unsigned long flags;
 
 	if (!inst || type < 0 || type >= MSM_MEM_POOL_MAX) {
 		d_vpr_e("%s: Invalid params\n", __func__);
@@ -488,33 +513,25 @@ void *msm_memory_pool_alloc(struct msm_vidc_inst *inst, enum msm_memory_pool_typ
 	}
 	pool = &inst->pool[type];
 
-	if (!list_empty(&pool->free_pool)) {
-		/* get 1st node from free pool */
-		hdr = list_first_entry(&pool->free_pool,
-			struct msm_memory_alloc_header, list);
-		list_del_init(&hdr->list);
+	/* get 1st node from free pool */
+	spin_lock_irqsave(&pool->lock, flags);
+	node = llist_del_first(&pool->free_pool);
+	spin_unlock_irqrestore(&pool->lock, flags);
 
+	if (node) {
+		hdr = llist_entry(node, struct msm_memory_alloc_header, node);
 		/* reset existing data */
 		memset((char *)hdr->buf, 0, pool->size);
-
-		/* add to busy pool */
-		list_add_tail(&hdr->list, &pool->busy_pool);
-
-		/* set busy flag to true. This is to catch double free request */
-		hdr->busy = true;
-
-		return hdr->buf;
+	} else {
+		/* free pool exhausted, grow it */
+		hdr = msm_memory_pool_new(pool, type);
+		if (!hdr)
+			return NULL;
 	}
 
-	if (msm_vidc_vmem_alloc(pool->size + sizeof(struct msm_memory_alloc_header),
-			(void **)&hdr, __func__))
-		return NULL;
-
-	INIT_LIST_HEAD(&hdr->list);
-	hdr->type = type;
-	hdr->busy = true;
-	hdr->buf = (void *)(hdr + 1);
-	list_add_tail(&hdr->list, &pool->busy_pool);
+	/* set busy flag to true. This is to catch double free request */
+	atomic_set(&hdr->busy, 1);
+	atomic_inc(&pool->busy_count);
 
 	return hdr->buf;
 }
@@ -544,18 +561,15 @@ void msm_memory_pool_free(struct msm_vidc_inst *inst, void *vidc_buf)
 	pool = &inst->pool[hdr->type];
 
 	/* catch double-free request */
-	if (!hdr->busy) {
+	if (atomic_cmpxchg(&hdr->busy, 1, 0) != 1) {
 		i_vpr_e(inst, "%s: double free request. type %s, addr %#x\n", __func__,
 			pool->name, vidc_buf);
 		return;
 	}
-	hdr->busy = false;
-
-	/* remove from busy pool */
-	list_del_init(&hdr->list);
+	atomic_dec(&pool->busy_count);
 
 	/* add to free pool */
-	list_add_tail(&hdr->list, &pool->free_pool);
+	llist_add(&hdr->node, &pool->free_pool);
 }
 
 static void msm_vidc_destroy_pool_buffers(struct msm_vidc_inst *inst,
@@ -572,23 +586,22 @@ static void msm_vidc_destroy_pool_buffers(struct msm_vidc_inst *inst,
 	pool = &inst->pool[type];
 
 	/* detect memleak: busy pool is expected to be empty here */
-	if (!list_empty(&pool->busy_pool))
+	if (atomic_read(&pool->busy_count))
 		i_vpr_e(inst, "%s: destroy request on active buffer. type %s\n",
 			__func__, pool->name);
 
-	/* destroy all free buffers */
-	list_for_each_entry_safe(hdr, dummy, &pool->free_pool, list) {
-		list_del(&hdr->list);
-		msm_vidc_vmem_free((void **)&hdr);
-		fcount++;
-	}
-
-	/* destroy all busy buffers */
-	list_for_each_entry_safe(hdr, dummy, &pool->busy_pool, list) {
+	/* no users left, destroy all free and busy buffers */
+	llist_del_all(&pool->free_pool);
+	list_for_each_entry_safe(hdr, dummy, &pool->all_pool, list) {
 		list_del(&hdr->list);
+		if (atomic_read(&hdr->busy))
+			bcount++;
+		else
+			fcount++;
 		msm_vidc_vmem_free((void **)&hdr);
-		bcount++;
 	}
+	pool->total_count = 0;
+	atomic_set(&pool->busy_count, 0);
 
 	i_vpr_h(inst, "%s: type: %23s, count: free %2u, busy %2u\n",
 		__func__, pool->name, fcount, bcount);
@@ -612,20 +625,40 @@ struct msm_vidc_type_size_name {
 	enum msm_memory_pool_type type;
 	u32                       size;
 	char                     *name;
+	u32                       prefill;
 };
 
+/* prefill: objects allocated up front at session open */
 static const struct msm_vidc_type_size_name buftype_size_name_arr[] = {
-	{MSM_MEM_POOL_BUFFER,     sizeof(struct msm_vidc_buffer),     "MSM_MEM_POOL_BUFFER"     },
-	{MSM_MEM_POOL_MAP,        sizeof(struct msm_vidc_map),        "MSM_MEM_POOL_MAP"        },
-	{MSM_MEM_POOL_ALLOC,      sizeof(struct msm_vidc_alloc),      "MSM_MEM_POOL_ALLOC"      },
-	{MSM_MEM_POOL_TIMESTAMP,  sizeof(struct msm_vidc_timestamp),  "MSM_MEM_POOL_TIMESTAMP"  },
-	{MSM_MEM_POOL_DMABUF,     sizeof(struct msm_memory_dmabuf),   "MSM_MEM_POOL_DMABUF"     },
+	{MSM_MEM_POOL_BUFFER,     sizeof(struct msm_vidc_buffer),     "MSM_MEM_POOL_BUFFER",     64},
+	{MSM_MEM_POOL_MAP,        sizeof(struct msm_vidc_map),        "MSM_MEM_POOL_MAP",        64},
+	{MSM_MEM_POOL_ALLOC,      sizeof(struct msm_vidc_alloc),      "MSM_MEM_POOL_ALLOC",      16},
+	{MSM_MEM_POOL_TIMESTAMP,  sizeof(struct msm_vidc_timestamp),  "MSM_MEM_POOL_TIMESTAMP",  64},
+	{MSM_MEM_POOL_DMABUF,     sizeof(struct msm_memory_dmabuf),   "MSM_MEM_POOL_DMABUF",     64},
 	{MSM_MEM_POOL_PACKET,     sizeof(struct hfi_pending_packet) + MSM_MEM_POOL_PACKET_SIZE,
-		"MSM_MEM_POOL_PACKET"},
-	{MSM_MEM_POOL_BUF_TIMER,  sizeof(struct msm_vidc_input_timer), "MSM_MEM_POOL_BUF_TIMER" },
-	{MSM_MEM_POOL_BUF_STATS,  sizeof(struct msm_vidc_buffer_stats), "MSM_MEM_POOL_BUF_STATS"},
+		"MSM_MEM_POOL_PACKET", 4},
+	{MSM_MEM_POOL_BUF_TIMER,  sizeof(struct msm_vidc_input_timer), "MSM_MEM_POOL_BUF_TIMER", 32},
+	{MSM_MEM_POOL_BUF_STATS,  sizeof(struct msm_vidc_buffer_stats), "MSM_MEM_POOL_BUF_STATS", 32},
 };
 
+static void msm_memory_pool_prefill(struct msm_vidc_inst *inst,
+	enum msm_memory_pool_type type, u32 count)
+{
+	struct msm_memory_alloc_header *hdr;
+	struct msm_memory_pool *pool;
+	u32 i;
+
+	pool = &inst->pool[type];
+	for (i = 0; i < count; i++) {
+		hdr = msm_memory_pool_new(pool, type);
+		/* not fatal, alloc grows the pool on demand */
+		if (!hdr)
+			break;
+		llist_add(&hdr->node, &pool->free_pool);
+	}
+	i_vpr_l(inst, "%s: type: %23s, prefilled %u\n", __func__, pool->name, i);
+}
+
 int msm_memory_pools_init(struct msm_vidc_inst *inst)
 {
 	u32 i;
@@ -649,8 +682,12 @@ int msm_memory_pools_init(struct msm_vidc_inst *inst)
 		}
 		inst->pool[i].size = buftype_size_name_arr[i].size;
 		inst->pool[i].name = buftype_size_name_arr[i].name;
-		INIT_LIST_HEAD(&inst->pool[i].free_pool);
-		INIT_LIST_HEAD(&inst->pool[i].busy_pool);
+		init_llist_head(&inst->pool[i].free_pool);
+		INIT_LIST_HEAD(&inst->pool[i].all_pool);
+		spin_lock_init(&inst->pool[i].lock);
+		atomic_set(&inst->pool[i].busy_count, 0);
+		inst->pool[i].total_count = 0;
+		msm_memory_pool_prefill(inst, i, buftype_size_name_arr[i].prefill);
 	}
 
 	return 0;
@@ -22,6 +22,18 @@
 #define MSM_VIDC_MIN_UBWC_COMPRESSION_RATIO (1 << 16)
 #define MSM_VIDC_MAX_UBWC_COMPRESSION_RATIO (5 << 16)
 
+/* content adaptive dcvs: fw busy time target, percent of frame deadline */
+#define DCVS_FB_TARGET_LOAD 85
+/* PID gains, in 1/1000 units */
+#define DCVS_FB_KP 500
+#define DCVS_FB_KI 50
+#define DCVS_FB_KD 250
+/* limits of the error, its integral and the correction, in permille */
+#define DCVS_FB_ERROR_MAX 3000
+#define DCVS_FB_INTEGRAL_MAX 4000
+#define DCVS_FB_CORR_MIN (-500)
+#define DCVS_FB_CORR_MAX 1000
+
 u64 msm_vidc_max_freq(struct msm_vidc_inst *inst)
 {
 	struct msm_vidc_core* core;
@@ -477,6 +489,119 @@ exit:
 	return rc;
 }
 
+void msm_vidc_dcvs_frame_done(struct msm_vidc_inst *inst, u64 etb_time_us)
+{
+	struct msm_vidc_core *core;
+	struct msm_vidc_dcvs_feedback *fb;
+	u64 now_us, start_us, busy_us, cycles;
+
+	if (!inst || !inst->core) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+	core = inst->core;
+	fb = &inst->power.fb;
+
+	if (!msm_vidc_content_dcvs)
+		return;
+
+	/*
+	 * fw works on one frame at a time per session, so a frame is being
+	 * processed from its etb or from the previous fbd, whichever is later
+	 */
+	now_us = ktime_get_ns() / 1000;
+	start_us = max(etb_time_us, fb->last_done_us);
+	fb->last_done_us = now_us;
+	if (now_us <= start_us || !core->power.clk_freq)
+		return;
+
+	busy_us = now_us - start_us;
+	cycles = div_u64(busy_us * core->power.clk_freq, USEC_PER_SEC);
+
+	/* smooth out per frame jitter: avg = 3/4 * avg + 1/4 * sample */
+	if (fb->frames) {
+		fb->busy_us = (fb->busy_us * 3 + busy_us) >> 2;
+		fb->actual_cycles = (fb->actual_cycles * 3 + cycles) >> 2;
+	} else {
+		fb->busy_us = busy_us;
+		fb->actual_cycles = cycles;
+	}
+	fb->frames++;
+}
+
+static u32 msm_vidc_get_content_complexity(struct msm_vidc_inst *inst)
+{
+	struct vidc_bus_vote_data *vote_data = &inst->bus_data;
+
+	fill_dynamic_stats(inst, vote_data);
+
+	/* decoder: fw reported complexity factor, Q16 [1, 4] */
+	if (is_decode_session(inst))
+		return vote_data->complexity_factor;
+
+	/* encoder: poorly compressible input is harder to encode, Q16 [1, 5] */
+	return (u32)div_u64((u64)MSM_VIDC_MAX_UBWC_COMPRESSION_RATIO << 16,
+		vote_data->input_cr);
+}
+
+static bool msm_vidc_apply_content_dcvs(struct msm_vidc_inst *inst)
+{
+	struct msm_vidc_dcvs_feedback *fb;
+	u64 freq, max_freq, target_us;
+	s32 error, corr;
+	u32 fps;
+
+	if (!msm_vidc_content_dcvs || !inst->power.dcvs_mode)
+		return false;
+
+	fb = &inst->power.fb;
+	fps = inst->max_rate;
+	/* not enough history yet, stay with the buffer based dcvs */
+	if (!fps || fb->frames < DCVS_WINDOW || !fb->actual_cycles)
+		return false;
+
+	/*
+	 * feed forward: scale the cycles fw spent on recent frames by how
+	 * complex the current content is compared to the running average,
+	 * so that clocks go up before a complex scene rather than after.
+	 */
+	fb->complexity = msm_vidc_get_content_complexity(inst);
+	if (fb->avg_complexity)
+		fb->avg_complexity = (fb->avg_complexity * 7 + fb->complexity) >> 3;
+	else
+		fb->avg_complexity = fb->complexity;
+	fb->predicted_cycles = div_u64(fb->actual_cycles * fb->complexity,
+		fb->avg_complexity);
+
+	/* feedback: PID on fw busy time against the frame deadline */
+	target_us = div_u64((u64)USEC_PER_SEC * DCVS_FB_TARGET_LOAD, fps * 100);
+	if (!target_us)
+		return false;
+	error = (s32)min_t(u64, div_u64(fb->busy_us * 1000, target_us),
+		DCVS_FB_ERROR_MAX + 1000) - 1000;
+	fb->integral = clamp_t(s32, fb->integral + error,
+		-DCVS_FB_INTEGRAL_MAX, DCVS_FB_INTEGRAL_MAX);
+	corr = (DCVS_FB_KP * error + DCVS_FB_KI * fb->integral +
+		DCVS_FB_KD * (error - fb->prev_error)) / 1000;
+	corr = clamp_t(s32, corr, DCVS_FB_CORR_MIN, DCVS_FB_CORR_MAX);
+	fb->prev_error = error;
+
+	freq = div_u64(fb->predicted_cycles * fps * 100, DCVS_FB_TARGET_LOAD);
+	freq = div_u64(freq * (1000 + corr), 1000);
+	max_freq = msm_vidc_max_freq(inst);
+	freq = min(freq, max_freq);
+
+	inst->power.min_freq = freq;
+	inst->power.dcvs_flags = 0;
+
+	i_vpr_p(inst,
+		"dcvs: content: cycles predicted %llu actual %llu cf %#x avg %#x busy %lluus target %lluus err %d corr %d freq %llu\n",
+		fb->predicted_cycles, fb->actual_cycles, fb->complexity,
+		fb->avg_complexity, fb->busy_us, target_us, error, corr, freq);
+
+	return true;
+}
+
 int msm_vidc_scale_clocks(struct msm_vidc_inst *inst)
 {
 	struct msm_vidc_core *core;
@@ -503,7 +628,8 @@ int msm_vidc_scale_clocks(struct msm_vidc_inst *inst)
 	} else {
 		inst->power.min_freq =
 			call_session_op(core, calc_freq, inst, inst->max_input_data_size);
-		msm_vidc_apply_dcvs(inst);
+		if (!msm_vidc_apply_content_dcvs(inst))
+			msm_vidc_apply_dcvs(inst);
 	}
 	inst->power.curr_freq = inst->power.min_freq;
 	msm_vidc_set_clocks(inst);
@@ -644,6 +770,7 @@ void msm_vidc_dcvs_data_reset(struct msm_vidc_inst *inst)
 	dcvs->dcvs_window = min_count < max_count ? max_count - min_count : 0;
 	dcvs->nom_threshold = dcvs->min_threshold + (dcvs->dcvs_window / 2);
 	dcvs->dcvs_flags = 0;
+	memset(&dcvs->fb, 0, sizeof(dcvs->fb));
 
 	i_vpr_p(inst, "%s: dcvs: thresholds [%d %d %d] flags %#x\n",
 		__func__, dcvs->min_threshold,
@@ -257,6 +257,7 @@ static int msm_vidc_deinitialize_core(struct msm_vidc_core *core)
 	}
 	d_vpr_h("%s()\n", __func__);
 
+	msm_vidc_ibuf_shrinker_deinit(core);
 	mutex_destroy(&core->lock);
 	msm_vidc_change_core_state(core, MSM_VIDC_CORE_DEINIT, __func__);
 
@@ -265,12 +266,16 @@ static int msm_vidc_deinitialize_core(struct msm_vidc_core *core)
 	core->response_packet = NULL;
 	core->packet = NULL;
 
+	if (core->response_workq)
+		destroy_workqueue(core->response_workq);
+
 	if (core->batch_workq)
 		destroy_workqueue(core->batch_workq);
 
 	if (core->pm_workq)
 		destroy_workqueue(core->pm_workq);
 
+	core->response_workq = NULL;
 	core->batch_workq = NULL;
 	core->pm_workq = NULL;
 
@@ -303,6 +308,15 @@ static int msm_vidc_initialize_core(struct msm_vidc_core *core)
 		goto exit;
 	}
 
+	/* unbound so that responses of different sessions run in parallel */
+	core->response_workq = alloc_workqueue("response_workq",
+		WQ_UNBOUND | WQ_HIGHPRI, 0);
+	if (!core->response_workq) {
+		d_vpr_e("%s: create response workq failed\n", __func__);
+		rc = -EINVAL;
+		goto exit;
+	}
+
 	core->packet_size = VIDC_IFACEQ_VAR_HUGE_PKT_SIZE;
 	rc = msm_vidc_vmem_alloc(core->packet_size,
 			(void **)&core->packet, "core packet");
@@ -317,21 +331,29 @@ static int msm_vidc_initialize_core(struct msm_vidc_core *core)
 	mutex_init(&core->lock);
 	INIT_LIST_HEAD(&core->instances);
 	INIT_LIST_HEAD(&core->dangling_instances);
+	hash_init(core->session_table);
 
 	INIT_DELAYED_WORK(&core->pm_work, venus_hfi_pm_work_handler);
 	INIT_DELAYED_WORK(&core->fw_unload_work, msm_vidc_fw_unload_handler);
 	INIT_WORK(&core->ssr_work, msm_vidc_ssr_handler);
 
+	/* pooled internal buffers are only an optimization, not fatal */
+	if (msm_vidc_ibuf_shrinker_init(core))
+		d_vpr_e("%s: register internal buffer shrinker failed\n", __func__);
+
 	return 0;
 exit:
 	msm_vidc_vmem_free((void **)&core->response_packet);
 	msm_vidc_vmem_free((void **)&core->packet);
 	core->response_packet = NULL;
 	core->packet = NULL;
+	if (core->response_workq)
+		destroy_workqueue(core->response_workq);
 	if (core->batch_workq)
 		destroy_workqueue(core->batch_workq);
 	if (core->pm_workq)
 		destroy_workqueue(core->pm_workq);
+	core->response_workq = NULL;
 	core->batch_workq = NULL;
 	core->pm_workq = NULL;
 
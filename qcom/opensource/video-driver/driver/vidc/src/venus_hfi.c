@@ -3697,6 +3697,54 @@ static int venus_hfi_add_pending_packets(struct msm_vidc_inst *inst)
 	return rc;
 }
 
+/*
+ * Buffers queued between batch start and batch end are written to the
+ * command queue right away, but the host to FW interrupt is raised once
+ * at batch end. Queueing all deferred buffers at streamon or after a
+ * flush then wakes up FW once instead of once per buffer.
+ */
+void venus_hfi_queue_buffer_batch_start(struct msm_vidc_inst *inst)
+{
+	if (!inst) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return;
+	}
+
+	inst->cmdq_batch.active = true;
+	inst->cmdq_batch.intr_pending = false;
+	inst->cmdq_batch.count = 0;
+}
+
+int venus_hfi_queue_buffer_batch_end(struct msm_vidc_inst *inst)
+{
+	int rc = 0;
+	struct msm_vidc_core *core;
+
+	if (!inst || !inst->core) {
+		d_vpr_e("%s: invalid params\n", __func__);
+		return -EINVAL;
+	}
+	core = inst->core;
+	core_lock(core, __func__);
+
+	if (inst->cmdq_batch.intr_pending) {
+		if (__core_in_valid_state(core))
+			call_venus_op(core, raise_interrupt, core);
+		else
+			rc = -EINVAL;
+	}
+	if (inst->cmdq_batch.count)
+		i_vpr_l(inst, "%s: queued %u buffers, interrupt %d\n", __func__,
+			inst->cmdq_batch.count, inst->cmdq_batch.intr_pending);
+
+	inst->cmdq_batch.active = false;
+	inst->cmdq_batch.intr_pending = false;
+	inst->cmdq_batch.count = 0;
+
+	core_unlock(core, __func__);
+	return rc;
+}
+
 int venus_hfi_queue_buffer(struct msm_vidc_inst *inst,
 	struct msm_vidc_buffer *buffer, struct msm_vidc_buffer *metabuf)
 {
@@ -3704,6 +3752,7 @@ int venus_hfi_queue_buffer(struct msm_vidc_inst *inst,
 	struct msm_vidc_core *core;
 	struct hfi_buffer hfi_buffer;
 	enum hfi_packet_payload_info payload_type;
+	bool needs_interrupt = false;
 
 	if (!inst || !inst->core || !inst->packet || !inst->capabilities) {
 		d_vpr_e("%s: invalid params\n", __func__);
@@ -3783,9 +3832,18 @@ int venus_hfi_queue_buffer(struct msm_vidc_inst *inst,
 	if (rc)
 		goto unlock;
 
-	rc = __iface_cmdq_write(inst->core, inst->packet);
-	if (rc)
-		goto unlock;
+	if (inst->cmdq_batch.active) {
+		rc = __iface_cmdq_write_relaxed(inst->core, inst->packet,
+			&needs_interrupt);
+		if (rc)
+			goto unlock;
+		inst->cmdq_batch.intr_pending |= needs_interrupt;
+		inst->cmdq_batch.count++;
+	} else {
+		rc = __iface_cmdq_write(inst->core, inst->packet);
+		if (rc)
+			goto unlock;
+	}
 
 unlock:
 	core_unlock(core, __func__);
@@ -2059,26 +2059,14 @@ static int __handle_session_response(struct msm_vidc_inst *inst,
 	return rc;
 }
 
-static int handle_session_response(struct msm_vidc_core *core,
+static int __handle_inst_response(struct msm_vidc_inst *inst,
 	struct hfi_header *hdr)
 {
-	struct msm_vidc_inst *inst;
 	struct hfi_packet *packet;
 	u8 *pkt;
 	int i, rc = 0;
 	bool found_ipsc = false;
 
-	if (!core || !hdr) {
-		d_vpr_e("%s: Invalid params\n", __func__);
-		return -EINVAL;
-	}
-
-	inst = get_inst(core, hdr->session_id);
-	if (!inst) {
-		d_vpr_e("%s: Invalid inst\n", __func__);
-		return -EINVAL;
-	}
-
 	inst_lock(inst, __func__);
 	/* search for cmd settings change pkt */
 	pkt = (u8 *)((u8 *)hdr + sizeof(struct hfi_header));
@@ -2103,6 +2091,95 @@ static int handle_session_response(struct msm_vidc_core *core,
 
 exit:
 	inst_unlock(inst, __func__);
+	return rc;
+}
+
+void handle_session_response_work_handler(struct work_struct *work)
+{
+	struct msm_vidc_inst *inst;
+	struct msm_vidc_inst_response *resp;
+	unsigned long flags;
+	u32 count = 0, i;
+
+	inst = container_of(work, struct msm_vidc_inst, response_work);
+
+	spin_lock_irqsave(&inst->response_lock, flags);
+	while (!list_empty(&inst->response_list)) {
+		resp = list_first_entry(&inst->response_list,
+			struct msm_vidc_inst_response, list);
+		list_del(&resp->list);
+		spin_unlock_irqrestore(&inst->response_lock, flags);
+
+		__handle_inst_response(inst, (struct hfi_header *)resp->data);
+		kfree(resp);
+		count++;
+
+		spin_lock_irqsave(&inst->response_lock, flags);
+	}
+	spin_unlock_irqrestore(&inst->response_lock, flags);
+
+	/*
+	 * drop the references taken while queueing; the last one may free
+	 * inst (and this work item), so nothing can touch inst afterwards
+	 */
+	for (i = 0; i < count; i++)
+		put_inst(inst);
+}
+
+static int queue_session_response(struct msm_vidc_core *core,
+	struct msm_vidc_inst *inst, struct hfi_header *hdr)
+{
+	struct msm_vidc_inst_response *resp;
+	unsigned long flags;
+
+	if (!core->response_workq || hdr->size > core->packet_size)
+		return -EINVAL;
+
+	/* response_packet is reused for the next msgq read, keep a copy */
+	resp = kmalloc(struct_size(resp, data, hdr->size), GFP_KERNEL);
+	if (!resp)
+		return -ENOMEM;
+
+	resp->size = hdr->size;
+	memcpy(resp->data, hdr, hdr->size);
+
+	spin_lock_irqsave(&inst->response_lock, flags);
+	list_add_tail(&resp->list, &inst->response_list);
+	spin_unlock_irqrestore(&inst->response_lock, flags);
+
+	queue_work(core->response_workq, &inst->response_work);
+
+	return 0;
+}
+
+static int handle_session_response(struct msm_vidc_core *core,
+	struct hfi_header *hdr)
+{
+	struct msm_vidc_inst *inst;
+	int rc = 0;
+
+	if (!core || !hdr) {
+		d_vpr_e("%s: Invalid params\n", __func__);
+		return -EINVAL;
+	}
+
+	inst = get_inst(core, hdr->session_id);
+	if (!inst) {
+		d_vpr_e("%s: Invalid inst\n", __func__);
+		return -EINVAL;
+	}
+
+	/*
+	 * hand the response over to the per session worker so that a slow
+	 * session does not hold up the message queue for the others; the
+	 * inst reference is released by the worker.
+	 */
+	if (!queue_session_response(core, inst, hdr))
+		return 0;
+
+	/* fall back to handling the response inline, after the queued ones */
+	flush_work(&inst->response_work);
+	rc = __handle_inst_response(inst, hdr);
 	put_inst(inst);
 	return rc;
 }
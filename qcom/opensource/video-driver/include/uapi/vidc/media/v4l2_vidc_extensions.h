@@ -280,6 +280,13 @@ enum v4l2_h264_encode_delivery_mode {
 #define V4L2_CID_MPEG_VIDC_EARLY_NOTIFY_LINE_COUNT                            \
 	(V4L2_CID_MPEG_VIDC_BASE + 0x45)
 
+/*
+ * Control to set the fence fd the next queued encoder input buffer
+ * has to wait on before it is handed to firmware
+ */
+#define V4L2_CID_MPEG_VIDC_INPUT_FENCE_FD                                     \
+	(V4L2_CID_MPEG_VIDC_BASE + 0x46)
+
 /* add new controls above this line */
 /* Deprecate below controls once availble in gki and gsi bionic header */
 #ifndef V4L2_CID_MPEG_VIDEO_BASELAYER_PRIORITY_ID
@@ -694,6 +694,55 @@ static const struct file_operations cnss_runtime_pm_debug_fops = {
 	.llseek		= seq_lseek,
 };
 
+static int cnss_link_policy_debug_show(struct seq_file *s, void *data)
+{
+	struct cnss_plat_data *plat_priv = s->private;
+	struct cnss_pci_data *pci_priv;
+	struct cnss_link_policy *lp;
+	u32 transitions;
+
+	if (!plat_priv)
+		return -ENODEV;
+
+	pci_priv = plat_priv->bus_priv;
+	if (!pci_priv)
+		return -ENODEV;
+
+	lp = &pci_priv->link_policy;
+
+	mutex_lock(&lp->lock);
+	transitions = lp->up_count + lp->down_count;
+	seq_printf(s, "enabled: %d\n",
+		   test_bit(ENABLE_PCIE_LINK_POLICY,
+			    &plat_priv->ctrl_params.quirks));
+	seq_printf(s, "bw_level: %d\n", lp->bw_level);
+	seq_printf(s, "link: gen%u x%u (max gen%u x%u)\n",
+		   lp->cur_speed, lp->cur_width,
+		   pci_priv->def_link_speed, pci_priv->def_link_width);
+	seq_printf(s, "l1_prevented: %d\n", lp->l1_prevented);
+	seq_printf(s, "transitions: up %u down %u failed %u\n",
+		   lp->up_count, lp->down_count, lp->fail_count);
+	seq_printf(s, "latency(us): last %llu max %llu avg %llu\n",
+		   lp->last_latency_us, lp->max_latency_us,
+		   transitions ? div_u64(lp->total_latency_us, transitions) :
+		   0);
+	mutex_unlock(&lp->lock);
+
+	return 0;
+}
+
+static int cnss_link_policy_debug_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, cnss_link_policy_debug_show, inode->i_private);
+}
+
+static const struct file_operations cnss_link_policy_debug_fops = {
+	.read		= seq_read,
+	.open		= cnss_link_policy_debug_open,
+	.owner		= THIS_MODULE,
+	.llseek		= seq_lseek,
+};
+
 static int process_drv(struct cnss_plat_data *plat_priv, bool enabled)
 {
 	if (test_bit(CNSS_QMI_WLFW_CONNECTED, &plat_priv->driver_state)) {
@@ -849,6 +898,9 @@ static int cnss_show_quirks_state(struct seq_file *s,
 		case FORCE_ONE_MSI:
 			seq_puts(s, "FORCE_ONE_MSI");
 			continue;
+		case ENABLE_PCIE_LINK_POLICY:
+			seq_puts(s, "ENABLE_PCIE_LINK_POLICY");
+			continue;
 		default:
 			continue;
 		}
@@ -995,6 +1047,8 @@ static int cnss_create_debug_only_node(struct cnss_plat_data *plat_priv)
 			    &cnss_reg_write_debug_fops);
 	debugfs_create_file("runtime_pm", 0600, root_dentry, plat_priv,
 			    &cnss_runtime_pm_debug_fops);
+	debugfs_create_file("link_policy", 0400, root_dentry, plat_priv,
+			    &cnss_link_policy_debug_fops);
 	debugfs_create_file("control_params", 0600, root_dentry, plat_priv,
 			    &cnss_control_params_debug_fops);
 	debugfs_create_file("dynamic_feature", 0600, root_dentry, plat_priv,
@@ -890,6 +890,11 @@ static int cnss_fw_mem_ready_hdlr(struct cnss_plat_data *plat_priv)
 	if (ret)
 		goto out;
 
+	if (plat_priv->device_id == QCN7605_DEVICE_ID)
+		plat_priv->ctrl_params.bdf_type = CNSS_BDF_BIN;
+
+	cnss_wlfw_bdf_prefetch(plat_priv);
+
 	cnss_bus_load_tme_patch(plat_priv);
 
 	cnss_wlfw_tme_patch_dnld_send_sync(plat_priv,
@@ -900,9 +905,6 @@ static int cnss_fw_mem_ready_hdlr(struct cnss_plat_data *plat_priv)
 
 	cnss_wlfw_bdf_dnld_send_sync(plat_priv, CNSS_BDF_REGDB);
 
-	if (plat_priv->device_id == QCN7605_DEVICE_ID)
-		plat_priv->ctrl_params.bdf_type = CNSS_BDF_BIN;
-
 	ret = cnss_wlfw_bdf_dnld_send_sync(plat_priv,
 					   plat_priv->ctrl_params.bdf_type);
 	if (ret)
@@ -4712,6 +4714,7 @@ static int cnss_misc_init(struct cnss_plat_data *plat_priv)
 	init_completion(&plat_priv->daemon_connected);
 	mutex_init(&plat_priv->dev_lock);
 	mutex_init(&plat_priv->driver_ops_lock);
+	cnss_bdf_cache_init(plat_priv);
 
 	plat_priv->reboot_nb.notifier_call = cnss_reboot_notifier;
 	ret = register_reboot_notifier(&plat_priv->reboot_nb);
@@ -4771,6 +4774,7 @@ static void cnss_misc_deinit(struct cnss_plat_data *plat_priv)
 	wakeup_source_unregister(plat_priv->recovery_ws);
 	cnss_deinit_sol_gpio(plat_priv);
 	cnss_sram_dump_deinit(plat_priv);
+	cnss_bdf_cache_deinit(plat_priv);
 	kfree(plat_priv->on_chip_pmic_board_ids);
 }
 
@@ -394,6 +394,7 @@ enum cnss_debug_quirks {
 	IGNORE_PCI_LINK_FAILURE,
 	DISABLE_TIME_SYNC,
 	FORCE_ONE_MSI,
+	ENABLE_PCIE_LINK_POLICY,
 	QUIRK_MAX_VALUE
 };
 
@@ -552,6 +553,9 @@ struct cnss_plat_data {
 	struct cnss_fw_mem aux_mem;
 	u64 cal_time;
 	bool cbc_file_download;
+	struct list_head bdf_cache;
+	struct mutex bdf_cache_lock;
+	struct work_struct bdf_prefetch_work;
 	u32 cal_file_size;
 	struct completion daemon_connected;
 	u32 qdss_mem_seg_len;
@@ -1132,6 +1132,197 @@ static int cnss_pci_force_wake_put(struct cnss_pci_data *pci_priv)
 	return ret;
 }
 
+/* Time a lower bandwidth level has to hold before the link is scaled down */
+#define CNSS_LINK_POLICY_DOWN_HOLD_MS	3000
+
+/**
+ * cnss_pci_link_policy_target() - Get target link state for bandwidth level
+ * @pci_priv: driver PCI bus context pointer
+ * @bw_level: bus bandwidth level requested by the WLAN driver
+ * @speed: target link speed
+ * @width: target link width
+ * @prevent_l1: L1 and L1ss should be prevented
+ *
+ * The target never exceeds the link speed and width the device trained
+ * at, or later requested through MHI bandwidth scaling.
+ *
+ * Return: None
+ */
+static void cnss_pci_link_policy_target(struct cnss_pci_data *pci_priv,
+					int bw_level, u16 *speed, u16 *width,
+					bool *prevent_l1)
+{
+	*speed = pci_priv->def_link_speed;
+	*width = pci_priv->def_link_width;
+	*prevent_l1 = false;
+
+	switch (bw_level) {
+	case CNSS_BUS_WIDTH_NONE:
+	case CNSS_BUS_WIDTH_IDLE:
+	case CNSS_BUS_WIDTH_LOW:
+		*speed = PCI_EXP_LNKSTA_CLS_2_5GB;
+		*width = 1;
+		break;
+	case CNSS_BUS_WIDTH_MEDIUM:
+		*speed = min_t(u16, *speed, PCI_EXP_LNKSTA_CLS_5_0GB);
+		*width = 1;
+		break;
+	case CNSS_BUS_WIDTH_LOW_LATENCY:
+		*prevent_l1 = true;
+		break;
+	default:
+		break;
+	}
+
+	*speed = min_t(u16, *speed, pci_priv->def_link_speed);
+	*width = min_t(u16, *width, pci_priv->def_link_width);
+}
+
+static void cnss_pci_link_policy_work(struct work_struct *work)
+{
+	struct cnss_link_policy *lp =
+		container_of(to_delayed_work(work), struct cnss_link_policy,
+			     work);
+	struct cnss_pci_data *pci_priv =
+		container_of(lp, struct cnss_pci_data, link_policy);
+	struct cnss_plat_data *plat_priv = pci_priv->plat_priv;
+	struct device *dev = &pci_priv->pci_dev->dev;
+	u16 speed, width, link_status;
+	bool prevent_l1;
+	ktime_t start;
+	int bw_level, ret;
+
+	mutex_lock(&lp->lock);
+	bw_level = READ_ONCE(lp->bw_level);
+	cnss_pci_link_policy_target(pci_priv, bw_level, &speed, &width,
+				    &prevent_l1);
+
+	if (prevent_l1 != lp->l1_prevented) {
+		if (!prevent_l1) {
+			cnss_pci_allow_l1(dev);
+			lp->l1_prevented = false;
+		} else if (!cnss_pci_prevent_l1(dev)) {
+			lp->l1_prevented = true;
+		}
+	}
+
+	/* Link retrains at its default state when the device comes back */
+	if (bw_level == CNSS_BUS_WIDTH_NONE || !pci_priv->def_link_speed ||
+	    pci_priv->pci_link_state == PCI_LINK_DOWN ||
+	    atomic_read(&pci_priv->auto_suspended))
+		goto out;
+
+	/*
+	 * Read back the trained state rather than trusting the last one set,
+	 * a link resume or MHI bandwidth scaling retrains the link.
+	 */
+	ret = pcie_capability_read_word(pci_priv->pci_dev, PCI_EXP_LNKSTA,
+					&link_status);
+	if (ret)
+		goto out;
+
+	lp->cur_speed = link_status & PCI_EXP_LNKSTA_CLS;
+	lp->cur_width = (link_status & PCI_EXP_LNKSTA_NLW) >>
+			PCI_EXP_LNKSTA_NLW_SHIFT;
+	if (speed == lp->cur_speed && width == lp->cur_width)
+		goto out;
+
+	start = ktime_get();
+	if (speed > lp->cur_speed) {
+		ret = cnss_pci_set_max_link_speed(pci_priv, plat_priv->rc_num,
+						  speed);
+		if (ret)
+			cnss_pr_err("Failed to set target link speed to 0x%x, err = %d\n",
+				    speed, ret);
+	}
+
+	ret = cnss_pci_set_link_bandwidth(pci_priv, speed, width);
+	lp->last_latency_us = ktime_us_delta(ktime_get(), start);
+	if (ret) {
+		lp->fail_count++;
+		cnss_pr_err("Link policy failed to set gen%u x%u, err = %d\n",
+			    speed, width, ret);
+		goto out;
+	}
+
+	if (speed > lp->cur_speed || width > lp->cur_width)
+		lp->up_count++;
+	else
+		lp->down_count++;
+	lp->total_latency_us += lp->last_latency_us;
+	if (lp->last_latency_us > lp->max_latency_us)
+		lp->max_latency_us = lp->last_latency_us;
+
+	cnss_pr_dbg("Link policy: bw level %d, gen%u x%u -> gen%u x%u in %llu us\n",
+		    bw_level, lp->cur_speed, lp->cur_width, speed, width,
+		    lp->last_latency_us);
+
+	lp->cur_speed = speed;
+	lp->cur_width = width;
+out:
+	mutex_unlock(&lp->lock);
+}
+
+/**
+ * cnss_pci_link_policy_update() - Feed a bandwidth level to the link policy
+ * @plat_priv: Platform private data struct
+ * @bw_level: bus bandwidth level requested by the WLAN driver
+ *
+ * The WLAN driver bus bandwidth manager votes a new level whenever its
+ * throughput samples cross a threshold. Scaling up is applied right away,
+ * scaling down only once the lower level held for
+ * CNSS_LINK_POLICY_DOWN_HOLD_MS so that bursty traffic does not make the
+ * link flip back and forth.
+ *
+ * Return: None
+ */
+static void cnss_pci_link_policy_update(struct cnss_plat_data *plat_priv,
+					int bw_level)
+{
+	struct cnss_pci_data *pci_priv;
+	struct cnss_link_policy *lp;
+	unsigned long delay = 0;
+
+	if (plat_priv->bus_type != CNSS_BUS_PCI ||
+	    !test_bit(ENABLE_PCIE_LINK_POLICY, &plat_priv->ctrl_params.quirks))
+		return;
+
+	pci_priv = plat_priv->bus_priv;
+	if (!pci_priv)
+		return;
+
+	lp = &pci_priv->link_policy;
+	if (bw_level < READ_ONCE(lp->bw_level) &&
+	    bw_level != CNSS_BUS_WIDTH_NONE)
+		delay = msecs_to_jiffies(CNSS_LINK_POLICY_DOWN_HOLD_MS);
+
+	WRITE_ONCE(lp->bw_level, bw_level);
+	mod_delayed_work(system_wq, &lp->work, delay);
+}
+
+static void cnss_pci_link_policy_init(struct cnss_pci_data *pci_priv)
+{
+	struct cnss_link_policy *lp = &pci_priv->link_policy;
+
+	mutex_init(&lp->lock);
+	INIT_DELAYED_WORK(&lp->work, cnss_pci_link_policy_work);
+	lp->bw_level = CNSS_BUS_WIDTH_NONE;
+	lp->cur_speed = pci_priv->def_link_speed;
+	lp->cur_width = pci_priv->def_link_width;
+}
+
+static void cnss_pci_link_policy_deinit(struct cnss_pci_data *pci_priv)
+{
+	struct cnss_link_policy *lp = &pci_priv->link_policy;
+
+	cancel_delayed_work_sync(&lp->work);
+	if (lp->l1_prevented) {
+		cnss_pci_allow_l1(&pci_priv->pci_dev->dev);
+		lp->l1_prevented = false;
+	}
+	mutex_destroy(&lp->lock);
+}
+
 #if IS_ENABLED(CONFIG_INTERCONNECT)
 /**
  * cnss_setup_bus_bandwidth() - Setup interconnect vote for given bandwidth
@@ -1186,6 +1377,8 @@ int cnss_request_bus_bandwidth(struct device *dev, int bandwidth)
 	if (bandwidth < 0)
 		return -EINVAL;
 
+	cnss_pci_link_policy_update(plat_priv, bandwidth);
+
 	return cnss_setup_bus_bandwidth(plat_priv, (u32)bandwidth, true);
 }
 #else
@@ -1197,6 +1390,11 @@ static int cnss_setup_bus_bandwidth(struct cnss_plat_data *plat_priv,
 
 int cnss_request_bus_bandwidth(struct device *dev, int bandwidth)
 {
+	struct cnss_plat_data *plat_priv = cnss_bus_dev_to_plat_priv(dev);
+
+	if (plat_priv && bandwidth >= 0)
+		cnss_pci_link_policy_update(plat_priv, bandwidth);
+
 	return 0;
 }
 #endif
@@ -7307,6 +7505,7 @@ static int cnss_pci_probe(struct pci_dev *pci_dev,
 		INIT_DELAYED_WORK(&pci_priv->time_sync_work,
 				  cnss_pci_time_sync_work_hdlr);
 		cnss_pci_get_link_status(pci_priv);
+		cnss_pci_link_policy_init(pci_priv);
 		cnss_pci_set_wlaon_pwr_ctrl(pci_priv, false, true, false);
 		cnss_pci_wake_gpio_init(pci_priv);
 		init_completion(&pci_priv->wake_event_complete);
@@ -7372,6 +7571,7 @@ static void cnss_pci_remove(struct pci_dev *pci_dev)
 	case KIWI_DEVICE_ID:
 	case MANGO_DEVICE_ID:
 	case PEACH_DEVICE_ID:
+		cnss_pci_link_policy_deinit(pci_priv);
 		cnss_pci_wake_gpio_deinit(pci_priv);
 		del_timer(&pci_priv->boot_debug_timer);
 		del_timer(&pci_priv->dev_rddm_timer);
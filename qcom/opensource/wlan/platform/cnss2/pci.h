@@ -123,6 +123,36 @@ struct cnss_pm_stats {
 	u64 runtime_put_timestamp_id[RTPM_ID_MAX];
 };
 
+/**
+ * struct cnss_link_policy - traffic driven PCIe link state policy
+ * @work: applies the target link state for @bw_level
+ * @lock: serializes link state transitions
+ * @bw_level: last bus bandwidth level requested by the WLAN driver
+ * @cur_speed: link speed currently set by the policy
+ * @cur_width: link width currently set by the policy
+ * @l1_prevented: the policy holds a vote preventing L1 and L1ss
+ * @up_count: transitions to a faster or wider link
+ * @down_count: transitions to a slower or narrower link
+ * @fail_count: transitions rejected by the root complex driver
+ * @last_latency_us: duration of the last transition
+ * @max_latency_us: longest transition seen
+ * @total_latency_us: sum of all transition durations
+ */
+struct cnss_link_policy {
+	struct delayed_work work;
+	struct mutex lock; /* serializes link state transitions */
+	int bw_level;
+	u16 cur_speed;
+	u16 cur_width;
+	bool l1_prevented;
+	u32 up_count;
+	u32 down_count;
+	u32 fail_count;
+	u64 last_latency_us;
+	u64 max_latency_us;
+	u64 total_latency_us;
+};
+
 struct cnss_print_optimize {
 	int msi_log_chk[MSI_USERS];
 	int msi_addr_chk;
@@ -173,6 +203,7 @@ struct cnss_pci_data {
 	struct timer_list dev_rddm_timer;
 	struct timer_list boot_debug_timer;
 	struct delayed_work time_sync_work;
+	struct cnss_link_policy link_policy;
 	u8 disable_pc;
 	struct mutex bus_lock; /* mutex for suspend and resume bus */
 	struct cnss_pci_debug_reg *debug_reg;
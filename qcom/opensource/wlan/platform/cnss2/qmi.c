@@ -761,6 +761,145 @@ static int cnss_get_bdf_file_name(struct cnss_plat_data *plat_priv,
 	return ret;
 }
 
+/**
+ * struct cnss_bdf_cache_entry - BDF file kept in memory across SSR
+ * @list: entry in plat_priv->bdf_cache
+ * @filename: name of the file including any FW prefix
+ * @size: size of @data
+ * @data: file contents
+ */
+struct cnss_bdf_cache_entry {
+	struct list_head list;
+	char filename[MAX_FIRMWARE_NAME_LEN];
+	size_t size;
+	u8 data[];
+};
+
+/**
+ * cnss_bdf_cache_get() - Get BDF file contents, loading it on first use
+ * @plat_priv: Platform private data struct
+ * @bdf_type: type of the BDF file
+ * @filename: name of the BDF file
+ * @err: error code if the file could not be loaded
+ *
+ * Board data does not change while the device stays the same, so the
+ * file is read from the file system only once and then served from
+ * memory on every later FW boot, including SSR recovery. Entries are
+ * only freed on driver removal, so the returned entry can be used
+ * without holding the lock.
+ *
+ * Return: cache entry, or NULL on failure
+ */
+static const struct cnss_bdf_cache_entry *
+cnss_bdf_cache_get(struct cnss_plat_data *plat_priv, u32 bdf_type,
+		   const char *filename, int *err)
+{
+	struct cnss_bdf_cache_entry *entry;
+	const struct firmware *fw_entry = NULL;
+	int ret;
+
+	mutex_lock(&plat_priv->bdf_cache_lock);
+	list_for_each_entry(entry, &plat_priv->bdf_cache, list) {
+		if (!strcmp(entry->filename, filename))
+			goto out;
+	}
+
+	cnss_pr_dbg("Invoke firmware_request_nowarn for %s\n", filename);
+	if (bdf_type == CNSS_BDF_REGDB)
+		ret = cnss_request_firmware_direct(plat_priv, &fw_entry,
+						   filename);
+	else
+		ret = firmware_request_nowarn(&fw_entry, filename,
+					      &plat_priv->plat_dev->dev);
+	if (ret) {
+		entry = NULL;
+		*err = ret;
+		goto out;
+	}
+
+	entry = kvmalloc(struct_size(entry, data, fw_entry->size), GFP_KERNEL);
+	if (!entry) {
+		release_firmware(fw_entry);
+		*err = -ENOMEM;
+		goto out;
+	}
+
+	strlcpy(entry->filename, filename, sizeof(entry->filename));
+	entry->size = fw_entry->size;
+	memcpy(entry->data, fw_entry->data, fw_entry->size);
+	release_firmware(fw_entry);
+	list_add_tail(&entry->list, &plat_priv->bdf_cache);
+out:
+	mutex_unlock(&plat_priv->bdf_cache_lock);
+	return entry;
+}
+
+static void cnss_wlfw_bdf_prefetch_file(struct cnss_plat_data *plat_priv,
+					u32 bdf_type)
+{
+	char filename[MAX_FIRMWARE_NAME_LEN];
+	int err = 0;
+
+	if (cnss_get_bdf_file_name(plat_priv, bdf_type,
+				   filename, sizeof(filename)))
+		return;
+
+	if (!cnss_bdf_cache_get(plat_priv, bdf_type, filename, &err))
+		cnss_pr_dbg("Failed to prefetch %s: %s, err: %d\n",
+			    cnss_bdf_type_to_str(bdf_type), filename, err);
+}
+
+static void cnss_wlfw_bdf_prefetch_work(struct work_struct *work)
+{
+	struct cnss_plat_data *plat_priv =
+		container_of(work, struct cnss_plat_data, bdf_prefetch_work);
+
+	if (plat_priv->hds_enabled)
+		cnss_wlfw_bdf_prefetch_file(plat_priv, CNSS_BDF_HDS);
+
+	cnss_wlfw_bdf_prefetch_file(plat_priv, CNSS_BDF_REGDB);
+
+	cnss_wlfw_bdf_prefetch_file(plat_priv, plat_priv->ctrl_params.bdf_type);
+}
+
+/**
+ * cnss_wlfw_bdf_prefetch() - Start loading BDF files in the background
+ * @plat_priv: Platform private data struct
+ *
+ * File names depend on the board ID reported in the target capability
+ * response, so this is kicked off right after it. The file system reads
+ * then overlap with the TME patch and earlier BDF downloads instead of
+ * running between them.
+ *
+ * Return: None
+ */
+void cnss_wlfw_bdf_prefetch(struct cnss_plat_data *plat_priv)
+{
+	queue_work(system_unbound_wq, &plat_priv->bdf_prefetch_work);
+}
+
+void cnss_bdf_cache_init(struct cnss_plat_data *plat_priv)
+{
+	INIT_LIST_HEAD(&plat_priv->bdf_cache);
+	mutex_init(&plat_priv->bdf_cache_lock);
+	INIT_WORK(&plat_priv->bdf_prefetch_work, cnss_wlfw_bdf_prefetch_work);
+}
+
+void cnss_bdf_cache_deinit(struct cnss_plat_data *plat_priv)
+{
+	struct cnss_bdf_cache_entry *entry, *tmp;
+
+	cancel_work_sync(&plat_priv->bdf_prefetch_work);
+
+	mutex_lock(&plat_priv->bdf_cache_lock);
+	list_for_each_entry_safe(entry, tmp, &plat_priv->bdf_cache, list) {
+		list_del(&entry->list);
+		kvfree(entry);
+	}
+	mutex_unlock(&plat_priv->bdf_cache_lock);
+	mutex_destroy(&plat_priv->bdf_cache_lock);
+}
+
 int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 				 u32 bdf_type)
 {
@@ -768,7 +907,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	struct wlfw_bdf_download_resp_msg_v01 *resp;
 	struct qmi_txn txn;
 	char filename[MAX_FIRMWARE_NAME_LEN];
-	const struct firmware *fw_entry = NULL;
+	const struct cnss_bdf_cache_entry *entry;
 	const u8 *temp;
 	unsigned int remaining;
 	int ret = 0;
@@ -789,24 +928,17 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	ret = cnss_get_bdf_file_name(plat_priv, bdf_type,
 				     filename, sizeof(filename));
 	if (ret)
-		goto err_req_fw;
+		goto err_dnld;
 
-	cnss_pr_dbg("Invoke firmware_request_nowarn for %s\n", filename);
-	if (bdf_type == CNSS_BDF_REGDB)
-		ret = cnss_request_firmware_direct(plat_priv, &fw_entry,
-						   filename);
-	else
-		ret = firmware_request_nowarn(&fw_entry, filename,
-					      &plat_priv->plat_dev->dev);
-
-	if (ret) {
+	entry = cnss_bdf_cache_get(plat_priv, bdf_type, filename, &ret);
+	if (!entry) {
 		cnss_pr_err("Failed to load %s: %s, ret: %d\n",
 			    cnss_bdf_type_to_str(bdf_type), filename, ret);
-		goto err_req_fw;
+		goto err_dnld;
 	}
 
-	temp = fw_entry->data;
-	remaining = fw_entry->size;
+	temp = entry->data;
+	remaining = entry->size;
 
 	cnss_pr_dbg("Downloading %s: %s, size: %u\n",
 		    cnss_bdf_type_to_str(bdf_type), filename, remaining);
@@ -837,7 +969,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 		if (ret < 0) {
 			cnss_pr_err("Failed to initialize txn for QMI_WLFW_BDF_DOWNLOAD_REQ_V01 request for %s, error: %d\n",
 				    cnss_bdf_type_to_str(bdf_type), ret);
-			goto err_send;
+			goto err_dnld;
 		}
 
 		ret = qmi_send_request
@@ -849,14 +981,14 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 			qmi_txn_cancel(&txn);
 			cnss_pr_err("Failed to send QMI_WLFW_BDF_DOWNLOAD_REQ_V01 request for %s, error: %d\n",
 				    cnss_bdf_type_to_str(bdf_type), ret);
-			goto err_send;
+			goto err_dnld;
 		}
 
 		ret = qmi_txn_wait(&txn, QMI_WLFW_TIMEOUT_JF);
 		if (ret < 0) {
 			cnss_pr_err("Timeout while waiting for FW response for QMI_WLFW_BDF_DOWNLOAD_REQ_V01 request for %s, err: %d\n",
 				    cnss_bdf_type_to_str(bdf_type), ret);
-			goto err_send;
+			goto err_dnld;
 		}
 
 		if (resp->resp.result != QMI_RESULT_SUCCESS_V01) {
@@ -864,7 +996,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 				    cnss_bdf_type_to_str(bdf_type), resp->resp.result,
 				    resp->resp.error);
 			ret = -resp->resp.result;
-			goto err_send;
+			goto err_dnld;
 		}
 
 		remaining -= req->data_len;
@@ -872,8 +1004,6 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 		req->seg_id++;
 	}
 
-	release_firmware(fw_entry);
-
 	if (resp->host_bdf_data_valid) {
 		/* QCA6490 enable S3E regulator for IPA configuration only */
 		if (!(resp->host_bdf_data & QMI_WLFW_HW_XPA_V01))
@@ -889,9 +1019,7 @@ int cnss_wlfw_bdf_dnld_send_sync(struct cnss_plat_data *plat_priv,
 	kfree(resp);
 	return 0;
 
-err_send:
-	release_firmware(fw_entry);
-err_req_fw:
+err_dnld:
 	if (!(bdf_type == CNSS_BDF_REGDB ||
 	      test_bit(CNSS_IN_REBOOT, &plat_priv->driver_state) ||
 	      ret == -EAGAIN))
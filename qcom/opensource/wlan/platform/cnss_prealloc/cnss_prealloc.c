@@ -11,6 +11,8 @@
 #include <linux/err.h>
 #include <linux/of.h>
 #include <linux/version.h>
+#include <linux/atomic.h>
+#include <linux/workqueue.h>
 #include "cnss_common.h"
 #ifdef CONFIG_CNSS_OUT_OF_TREE
 #include "cnss_prealloc.h"
@@ -37,14 +39,48 @@ MODULE_DESCRIPTION("CNSS prealloc driver");
  * features: memorypool and kmem cache.
  */
 
+/**
+ * struct cnss_pool - cnss memory pool of one size class
+ * @size: size of one allocation unit in bytes
+ * @min: number of units currently reserved
+ * @name: name of the cache/pool
+ * @mp: memory pool handle
+ * @cache: kmem cache handle
+ * @min_default: reserve from the pool table, recorded at first init
+ * @in_use: number of units currently handed out from this pool
+ * @hwm: high water mark of @in_use, kept across driver loads
+ * @win_hwm: high water mark of @in_use since the last rebalance
+ * @spill: requests of this size class served by a larger pool
+ * @win_spill: @spill since the last rebalance
+ * @fail: requests of this size class no pool could serve
+ */
 struct cnss_pool {
 	size_t size;
 	int min;
 	const char name[50];
 	mempool_t *mp;
 	struct kmem_cache *cache;
+	int min_default;
+	atomic_t in_use;
+	atomic_t hwm;
+	atomic_t win_hwm;
+	atomic_t spill;
+	atomic_t win_spill;
+	atomic_t fail;
 };
 
+/* Size pools and rebalance them from the recorded usage */
+static bool adaptive;
+module_param(adaptive, bool, 0600);
+MODULE_PARM_DESC(adaptive, "Size the prealloc pools from recorded usage");
+
+#define CNSS_POOL_HWM_HEADROOM 2
+#define CNSS_POOL_MAX_SCALE 2
+#define CNSS_POOL_REBALANCE_MS 60000
+
+static void cnss_pool_rebalance_work(struct work_struct *work);
+static DECLARE_DELAYED_WORK(cnss_pool_rebalance, cnss_pool_rebalance_work);
+
 /**
  * Memory pool
  * -----------
@@ -96,6 +132,113 @@ static struct cnss_pool cnss_pools_wcn6750[] = {
 struct cnss_pool *cnss_pools;
 unsigned int cnss_prealloc_pool_size = ARRAY_SIZE(cnss_pools_default);
 
+/**
+ * cnss_pool_size_reserve() - Reserve to create a pool with
+ * @pool: Memory pool
+ *
+ * The pool tables are static to this module, which stays loaded across WLAN
+ * driver loads, so the usage recorded during previous loads is available at
+ * the next init. In adaptive mode the reserve follows the recorded high water
+ * mark plus a small headroom, bounded by CNSS_POOL_MAX_SCALE times the table
+ * value.
+ *
+ * Return: Number of units to reserve
+ */
+static int cnss_pool_size_reserve(struct cnss_pool *pool)
+{
+	int hwm = atomic_read(&pool->hwm);
+
+	if (!pool->min_default)
+		pool->min_default = pool->min;
+
+	if (!adaptive || !hwm)
+		return pool->min_default;
+
+	return clamp(hwm + CNSS_POOL_HWM_HEADROOM, 1,
+		     pool->min_default * CNSS_POOL_MAX_SCALE);
+}
+
+/**
+ * cnss_pool_update_hwm() - Update the high water marks of a pool
+ * @pool: Memory pool
+ * @in_use: Units currently handed out
+ *
+ * Return: None
+ */
+static void cnss_pool_update_hwm(struct cnss_pool *pool, int in_use)
+{
+	int old;
+
+	old = atomic_read(&pool->hwm);
+	while (in_use > old && !atomic_try_cmpxchg(&pool->hwm, &old, in_use))
+		;
+
+	old = atomic_read(&pool->win_hwm);
+	while (in_use > old &&
+	       !atomic_try_cmpxchg(&pool->win_hwm, &old, in_use))
+		;
+}
+
+/**
+ * cnss_pool_rebalance_work() - Move idle reserve between size classes
+ * @work: Work struct
+ *
+ * Pools whose usage stayed below their reserve during the last window give
+ * the idle units back to the slab. The bytes released are then used to grow
+ * the reserve of pools that spilled into a larger size class, smallest class
+ * first, so the total reserved memory never increases.
+ *
+ * Return: None
+ */
+static void cnss_pool_rebalance_work(struct work_struct *work)
+{
+	size_t freed = 0;
+	int i, win_hwm, spill, new_min, add;
+
+	if (!cnss_pools)
+		return;
+
+	for (i = 0; i < cnss_prealloc_pool_size; i++) {
+		if (!cnss_pools[i].mp)
+			continue;
+
+		win_hwm = atomic_xchg(&cnss_pools[i].win_hwm,
+				      atomic_read(&cnss_pools[i].in_use));
+		new_min = max(win_hwm + CNSS_POOL_HWM_HEADROOM, 1);
+		if (new_min >= cnss_pools[i].min)
+			continue;
+
+		if (mempool_resize(cnss_pools[i].mp, new_min))
+			continue;
+
+		freed += (cnss_pools[i].min - new_min) * cnss_pools[i].size;
+		cnss_pools[i].min = new_min;
+	}
+
+	for (i = 0; i < cnss_prealloc_pool_size && freed; i++) {
+		spill = atomic_xchg(&cnss_pools[i].win_spill, 0);
+		if (!spill || !cnss_pools[i].mp)
+			continue;
+
+		add = min_t(size_t, spill, freed / cnss_pools[i].size);
+		add = min(add, cnss_pools[i].min_default * CNSS_POOL_MAX_SCALE -
+			  cnss_pools[i].min);
+		if (add <= 0)
+			continue;
+
+		if (mempool_resize(cnss_pools[i].mp, cnss_pools[i].min + add))
+			continue;
+
+		freed -= add * cnss_pools[i].size;
+		cnss_pools[i].min += add;
+		pr_debug("cnss_prealloc: %s reserve grown to %d\n",
+			 cnss_pools[i].name, cnss_pools[i].min);
+	}
+
+	schedule_delayed_work(&cnss_pool_rebalance,
+			      msecs_to_jiffies(CNSS_POOL_REBALANCE_MS));
+}
+
 /**
  * cnss_pool_alloc_threshold() - Allocation threshold
  *
@@ -125,6 +268,11 @@ static int cnss_pool_init(void)
 	int i;
 
 	for (i = 0; i < cnss_prealloc_pool_size; i++) {
+		cnss_pools[i].min = cnss_pool_size_reserve(&cnss_pools[i]);
+		atomic_set(&cnss_pools[i].in_use, 0);
+		atomic_set(&cnss_pools[i].win_hwm, 0);
+		atomic_set(&cnss_pools[i].win_spill, 0);
+
 		/* Create the slab cache */
 		cnss_pools[i].cache =
 			kmem_cache_create_usercopy(cnss_pools[i].name,
@@ -155,6 +303,10 @@ static int cnss_pool_init(void)
 			cnss_pools[i].size);
 	}
 
+	if (adaptive)
+		schedule_delayed_work(&cnss_pool_rebalance,
+				      msecs_to_jiffies(CNSS_POOL_REBALANCE_MS));
+
 	return 0;
 }
 
@@ -172,9 +324,14 @@ static void cnss_pool_deinit(void)
 	if (!cnss_pools)
 		return;
 
+	cancel_delayed_work_sync(&cnss_pool_rebalance);
+
 	for (i = 0; i < cnss_prealloc_pool_size; i++) {
-		pr_info("cnss_prealloc: destroy mempool %s\n",
-			cnss_pools[i].name);
+		pr_info("cnss_prealloc: destroy mempool %s reserve %d hwm %d spill %d fail %d\n",
+			cnss_pools[i].name, cnss_pools[i].min,
+			atomic_read(&cnss_pools[i].hwm),
+			atomic_read(&cnss_pools[i].spill),
+			atomic_read(&cnss_pools[i].fail));
 		mempool_destroy(cnss_pools[i].mp);
 		kmem_cache_destroy(cnss_pools[i].cache);
 		cnss_pools[i].mp = NULL;
@@ -299,7 +456,7 @@ void *wcnss_prealloc_get(size_t size)
 
 	void *mem = NULL;
 	gfp_t gfp_mask = __GFP_ZERO;
-	int i;
+	int i, fit = -1;
 
 	if (!cnss_pools)
 		return mem;
@@ -313,6 +470,8 @@ void *wcnss_prealloc_get(size_t size)
 
 		for (i = 0; i < cnss_prealloc_pool_size; i++) {
 			if (cnss_pools[i].size >= size && cnss_pools[i].mp) {
+				if (fit < 0)
+					fit = i;
 				mem = mempool_alloc(cnss_pools[i].mp, gfp_mask);
 				if (mem)
 					break;
@@ -320,6 +479,18 @@ void *wcnss_prealloc_get(size_t size)
 		}
 	}
 
+	if (mem) {
+		cnss_pool_update_hwm(&cnss_pools[i],
+				     atomic_inc_return(&cnss_pools[i].in_use));
+		if (i != fit) {
+			atomic_inc(&cnss_pools[fit].spill);
+			atomic_inc(&cnss_pools[fit].win_spill);
+		}
+	} else if (fit >= 0) {
+		atomic_inc(&cnss_pools[fit].fail);
+		atomic_inc(&cnss_pools[fit].win_spill);
+	}
+
 	if (!mem && size >= cnss_pool_alloc_threshold()) {
 		pr_debug("cnss_prealloc: not available for size %zu, flag %x\n",
 			 size, gfp_mask);
@@ -349,6 +520,7 @@ int wcnss_prealloc_put(void *mem)
 	i = cnss_pool_get_index(mem);
 	if (i >= 0 && i < cnss_prealloc_pool_size && cnss_pools[i].mp) {
 		mempool_free(mem, cnss_pools[i].mp);
+		atomic_dec(&cnss_pools[i].in_use);
 		return 1;
 	}
 
@@ -98,4 +98,27 @@ struct cdp_hist_stats {
 	int min;
 	int avg;
 };
+
+/*
+ * cdp_hist_pct_index: Percentiles computed from a histogram
+ * @CDP_HIST_PCT_50: 50th percentile
+ * @CDP_HIST_PCT_90: 90th percentile
+ * @CDP_HIST_PCT_99: 99th percentile
+ */
+enum cdp_hist_pct_index {
+	CDP_HIST_PCT_50,
+	CDP_HIST_PCT_90,
+	CDP_HIST_PCT_99,
+	CDP_HIST_PCT_MAX,
+};
+
+/*
+ * cdp_hist_percentiles: Percentiles of a histogram
+ * @val: Percentile values in the unit of the histogram
+ * @count: Number of samples the percentiles are computed from
+ */
+struct cdp_hist_percentiles {
+	uint32_t val[CDP_HIST_PCT_MAX];
+	uint64_t count;
+};
 #endif /* _CDP_TXRX_HIST_STRUCT_H_ */
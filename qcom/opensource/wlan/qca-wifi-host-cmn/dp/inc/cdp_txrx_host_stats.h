@@ -822,6 +822,67 @@ cdp_get_peer_jitter_stats(ol_txrx_soc_handle soc,
 								    tid_stats);
 }
 
+/**
+ * cdp_get_peer_delay_percentiles() - Call to get per peer per tid delay
+ *				      percentiles
+ * @soc: soc handle
+ * @vdev_id: id of dp_vdev handle
+ * @peer_mac: peer mac address
+ * @pct: user allocated buffer of CDP_MAX_DATA_TIDS entries
+ *
+ * return: status Success/Failure
+ */
+static inline QDF_STATUS
+cdp_get_peer_delay_percentiles(ol_txrx_soc_handle soc,
+			       uint8_t vdev_id,
+			       uint8_t *peer_mac,
+			       struct cdp_delay_tid_percentiles *pct)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		QDF_BUG(0);
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->host_stats_ops ||
+	    !soc->ops->host_stats_ops->txrx_get_peer_delay_percentiles)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->host_stats_ops->txrx_get_peer_delay_percentiles(
+							soc, vdev_id,
+							peer_mac, pct);
+}
+
+/**
+ * cdp_set_delay_hist_buckets() - Call to set the bucket bounds of a
+ *				  delay histogram type
+ * @soc: soc handle
+ * @hist_type: histogram type
+ * @bounds: CDP_HIST_BUCKET_MAX lower bounds, starting at 0 and strictly
+ *	    increasing
+ *
+ * return: status Success/Failure
+ */
+static inline QDF_STATUS
+cdp_set_delay_hist_buckets(ol_txrx_soc_handle soc,
+			   enum cdp_hist_types hist_type,
+			   const uint16_t *bounds)
+{
+	if (!soc || !soc->ops) {
+		dp_cdp_debug("Invalid Instance");
+		QDF_BUG(0);
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (!soc->ops->host_stats_ops ||
+	    !soc->ops->host_stats_ops->txrx_set_delay_hist_buckets)
+		return QDF_STATUS_E_FAILURE;
+
+	return soc->ops->host_stats_ops->txrx_set_delay_hist_buckets(soc,
+								     hist_type,
+								     bounds);
+}
+
 /**
  * cdp_mon_pdev_get_rx_stats() - Call to get monitor pdev rx stats
  * @soc: soc handle
@@ -1187,6 +1187,17 @@ struct cdp_host_stats_ops {
 				      uint8_t vdev_id, uint8_t *peer_mac,
 				      struct cdp_peer_tid_stats *tid_stats);
 
+	QDF_STATUS
+	(*txrx_get_peer_delay_percentiles)(
+			struct cdp_soc_t *soc, uint8_t vdev_id,
+			uint8_t *peer_mac,
+			struct cdp_delay_tid_percentiles *pct);
+
+	QDF_STATUS
+	(*txrx_set_delay_hist_buckets)(struct cdp_soc_t *soc,
+				       enum cdp_hist_types hist_type,
+				       const uint16_t *bounds);
+
 	QDF_STATUS
 	(*txrx_alloc_vdev_stats_id)(struct cdp_soc_t *soc,
 				    uint8_t *vdev_stats_id);
@@ -1128,6 +1128,18 @@ struct cdp_delay_tid_stats {
 	struct cdp_delay_rx_stats  rx_delay;
 };
 
+/*
+ * struct cdp_delay_tid_percentiles: Delay percentiles of a tid
+ * @tx_swq_delay: Stack to TCL enqueue delay percentiles
+ * @hwtx_delay: TCL enqueue to completion delay percentiles
+ * @to_stack_delay: REO reap to stack delivery delay percentiles
+ */
+struct cdp_delay_tid_percentiles {
+	struct cdp_hist_percentiles tx_swq_delay;
+	struct cdp_hist_percentiles hwtx_delay;
+	struct cdp_hist_percentiles to_stack_delay;
+};
+
 /* struct cdp_pkt_info - packet info
  * @num: no of packets
  * @bytes: total no of bytes
@@ -3015,6 +3027,8 @@ struct cdp_peer_hmwds_ast_add_status {
  * @DP_SOC_PARAM_MULTI_PEER_GRP_CMD_SUPPORT: For sending bulk AST delete
  * @DP_SOC_PARAM_RSSI_DBM_CONV_SUPPORT: To set the rssi dbm support bit
  * @DP_SOC_PARAM_UMAC_HW_RESET_SUPPORT: Whether target supports UMAC HW reset
+ * @DP_SOC_PARAM_RX_INTR_PROFILE: REO destination ring interrupt profile,
+ *				  one of enum cdp_rx_intr_profile
  */
 enum cdp_soc_param_t {
 	DP_SOC_PARAM_MSDU_EXCEPTION_DESC,
@@ -3024,9 +3038,26 @@ enum cdp_soc_param_t {
 	DP_SOC_PARAM_MULTI_PEER_GRP_CMD_SUPPORT,
 	DP_SOC_PARAM_RSSI_DBM_CONV_SUPPORT,
 	DP_SOC_PARAM_UMAC_HW_RESET_SUPPORT,
+	DP_SOC_PARAM_RX_INTR_PROFILE,
 	DP_SOC_PARAM_MAX,
 };
 
+/*
+ * Enumeration of REO destination ring interrupt profiles
+ * @CDP_RX_INTR_PROFILE_STATIC: interrupt thresholds from wlan_cfg, full budget
+ * @CDP_RX_INTR_PROFILE_LOW_LATENCY: interrupt per entry, small ring budget
+ * @CDP_RX_INTR_PROFILE_HIGH_TPUT: coalesced interrupts, full budget
+ * @CDP_RX_INTR_PROFILE_ADAPTIVE: pick low latency or high throughput per
+ *				  ring from the measured packet rate
+ */
+enum cdp_rx_intr_profile {
+	CDP_RX_INTR_PROFILE_STATIC,
+	CDP_RX_INTR_PROFILE_LOW_LATENCY,
+	CDP_RX_INTR_PROFILE_HIGH_TPUT,
+	CDP_RX_INTR_PROFILE_ADAPTIVE,
+	CDP_RX_INTR_PROFILE_MAX,
+};
+
 #ifdef QCA_ENH_V3_STATS_SUPPORT
 /*
  * Enumeration of PDEV Configuration parameter
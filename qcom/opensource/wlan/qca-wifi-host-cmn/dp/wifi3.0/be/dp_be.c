@@ -2319,6 +2319,12 @@ dp_initialize_arch_ops_be_mlo_multi_chip(struct dp_arch_ops *arch_ops)
 	arch_ops->dp_partner_chips_map = dp_mlo_partner_chips_map;
 	arch_ops->dp_partner_chips_unmap = dp_mlo_partner_chips_unmap;
 	arch_ops->dp_soc_get_by_idle_bm_id = dp_soc_get_by_idle_bm_id;
+#ifdef DP_MLO_TX_LINK_STEER
+	arch_ops->dp_tx_link_steer = dp_tx_mlo_link_steer_be;
+	arch_ops->dp_tx_link_steer_comp = dp_tx_mlo_link_steer_comp_be;
+	arch_ops->print_mlo_tx_steer_stats =
+		dp_tx_mlo_link_steer_print_stats_be;
+#endif
 }
 #else
 static inline void
@@ -354,15 +354,91 @@ struct dp_soc_be {
  * @monitor_pdev_be: BE specific monitor object
  * @mlo_link_id: MLO link id for PDEV
  * @delta_tsf2: delta_tsf2
+ * @tx_steer_comp_delay_us: moving average of the HW TX completion delay,
+ *			    used by MLO TX link steering
  */
 struct dp_pdev_be {
 	struct dp_pdev pdev;
 #ifdef WLAN_MLO_MULTI_CHIP
 	uint8_t mlo_link_id;
 	uint64_t delta_tsf2;
+#ifdef DP_MLO_TX_LINK_STEER
+	uint32_t tx_steer_comp_delay_us;
 #endif
+#endif
+};
+
+#if defined(WLAN_MLO_MULTI_CHIP) && defined(DP_MLO_TX_LINK_STEER)
+/* Links a vdev can steer unicast flows to, indexed by chip and pdev id */
+#define DP_MLO_STEER_MAX_LINKS \
+	(WLAN_MAX_MLO_CHIPS * WLAN_MAX_MLO_LINKS_PER_SOC)
+/* Flow table size, flows are hashed into it by their skb flow hash */
+#define DP_MLO_STEER_FLOW_TBL_SIZE 128
+/* A flow can only move to another link after being idle this long */
+#define DP_MLO_STEER_FLOW_IDLE_MS 200
+/* Per link metrics refresh interval */
+#define DP_MLO_STEER_EVAL_MS 20
+/* PHY rate assumed for a link which has not reported a TX rate yet */
+#define DP_MLO_STEER_DEF_RATE_KBPS 100000
+#define DP_MLO_STEER_INVALID_LINK 0xff
+
+/**
+ * struct dp_mlo_steer_link - steering state of one link of an MLO vdev
+ * @soc: soc of the link vdev
+ * @vdev_id: link vdev id on @soc, CDP_INVALID_VDEV_ID if not present
+ * @cost: expected time to drain the link TX backlog, lower is better
+ * @tcl_used: TCL data ring entries in use at the last evaluation
+ * @outstanding: TX descriptors outstanding on the link pdev
+ * @comp_delay_us: average HW TX completion delay of the link pdev
+ * @phy_rate: last unicast TX rate of the link pdev in kbps
+ * @flows: number of flow table entries pinned to the link
+ * @tx_pkts: frames steered to the link
+ */
+struct dp_mlo_steer_link {
+	struct dp_soc *soc;
+	uint8_t vdev_id;
+	uint32_t cost;
+	uint32_t tcl_used;
+	uint32_t outstanding;
+	uint32_t comp_delay_us;
+	uint32_t phy_rate;
+	uint32_t flows;
+	uint64_t tx_pkts;
+};
+
+/**
+ * struct dp_mlo_steer_flow - unicast TX flow pinned to a link
+ * @link: index of the link in dp_mlo_tx_steer.link
+ * @last_ts: time in ms a frame of the flow was last steered
+ */
+struct dp_mlo_steer_flow {
+	uint8_t link;
+	uint32_t last_ts;
 };
 
+/**
+ * struct dp_mlo_tx_steer - MLO TX link steering state of a vdev
+ * @num_links: number of links present at the last evaluation
+ * @best_link: lowest cost link at the last evaluation
+ * @last_eval_ts: time in ms of the last link evaluation
+ * @evaluating: set while a CPU refreshes the link metrics
+ * @flow_assign: flows assigned to a link
+ * @flow_moves: flows which moved to a different link after being idle
+ * @link: per link state
+ * @flow: flow table
+ */
+struct dp_mlo_tx_steer {
+	uint8_t num_links;
+	uint8_t best_link;
+	uint32_t last_eval_ts;
+	unsigned long evaluating;
+	uint32_t flow_assign;
+	uint32_t flow_moves;
+	struct dp_mlo_steer_link link[DP_MLO_STEER_MAX_LINKS];
+	struct dp_mlo_steer_flow flow[DP_MLO_STEER_FLOW_TBL_SIZE];
+};
+#endif
+
 /**
  * struct dp_vdev_be - Extended DP vdev for BE targets
  * @vdev: dp vdev structure
@@ -370,6 +446,7 @@ struct dp_pdev_be {
  * @vdev_id_check_en: flag if HW vdev_id check is enabled for vdev
  * @ppe_vp_enabled: flag to check if PPE VP is enabled for vdev
  * @ppe_vp_profile: PPE VP profile
+ * @tx_steer: MLO TX link steering state
  */
 struct dp_vdev_be {
 	struct dp_vdev vdev;
@@ -386,6 +463,9 @@ struct dp_vdev_be {
 	bool mcast_primary;
 #endif
 #endif
+#ifdef DP_MLO_TX_LINK_STEER
+	struct dp_mlo_tx_steer tx_steer;
+#endif
 #endif
 	unsigned long ppe_vp_enabled;
 #ifdef WLAN_SUPPORT_PPEDS
@@ -167,6 +167,7 @@ uint32_t dp_rx_process_be(struct dp_intr *int_ctx,
 	hal_soc_handle_t hal_soc;
 	struct dp_rx_desc *rx_desc = NULL;
 	struct dp_rx_desc *last_prefetched_sw_desc = NULL;
+	struct hal_srng_dst_batch batch;
 	qdf_nbuf_t nbuf, next;
 	bool near_full;
 	union dp_rx_desc_list_elem_t *head[WLAN_MAX_MLO_CHIPS][MAX_PDEV_CNT];
@@ -280,7 +281,8 @@ more_data:
 	if (num_pending > quota)
 		num_pending = quota;
 
-	dp_srng_dst_inv_cached_descs(soc, hal_ring_hdl, num_pending);
+	num_pending = dp_rx_srng_batch_begin(soc, hal_ring_hdl, &batch,
+					     num_pending);
 	last_prefetched_hw_desc = dp_srng_dst_prefetch_32_byte_desc(hal_soc,
 							    hal_ring_hdl,
 							    num_pending);
@@ -290,7 +292,7 @@ more_data:
 	 * Process the received pkts in a different per vdev loop.
 	 */
 	while (qdf_likely(num_pending)) {
-		ring_desc = dp_srng_dst_get_next(soc, hal_ring_hdl);
+		ring_desc = dp_rx_srng_batch_get_next(soc, hal_ring_hdl, &batch);
 
 		if (qdf_unlikely(!ring_desc))
 			break;
@@ -516,6 +518,7 @@ more_data:
 						  max_reap_limit))
 			break;
 	}
+	dp_rx_srng_batch_end(soc, hal_ring_hdl, &batch);
 done:
 	dp_rx_srng_access_end(int_ctx, soc, hal_ring_hdl);
 	qdf_dsb();
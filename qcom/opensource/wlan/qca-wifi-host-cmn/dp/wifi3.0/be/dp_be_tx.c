@@ -1116,7 +1116,9 @@ dp_tx_hw_enqueue_be(struct dp_soc *soc, struct dp_vdev *vdev,
 				 hal_ring_hdl, soc, ring_id);
 
 ring_access_fail:
-	dp_tx_ring_access_end_wrapper(soc, hal_ring_hdl, coalesce);
+	dp_tx_ring_access_end_wrapper_hold(soc, hal_ring_hdl, coalesce,
+					   QDF_IS_STATUS_SUCCESS(status) ?
+					   tx_desc->nbuf : NULL, tid);
 	dp_pkt_add_timestamp(vdev, QDF_PKT_TX_DRIVER_EXIT,
 			     qdf_get_log_timestamp(), tx_desc->nbuf);
 	return status;
@@ -1525,6 +1527,344 @@ QDF_STATUS dp_tx_compute_tx_delay_be(struct dp_soc *soc,
 	return dp_mlo_compute_hw_delay_us(soc, vdev, ts, delay_us);
 }
 
+#if defined(WLAN_FEATURE_11BE_MLO) && defined(WLAN_MLO_MULTI_CHIP) && \
+	defined(DP_MLO_TX_LINK_STEER)
+/**
+ * dp_tx_mlo_steer_tcl_used() - Get TCL data ring entries in use on a soc
+ * @soc: DP soc handle
+ *
+ * Return: number of TCL data ring entries not yet consumed by HW
+ */
+static uint32_t dp_tx_mlo_steer_tcl_used(struct dp_soc *soc)
+{
+	hal_ring_handle_t hal_ring_hdl;
+	uint32_t used = 0;
+	uint8_t i;
+
+	for (i = 0; i < soc->num_tcl_data_rings; i++) {
+		hal_ring_hdl = soc->tcl_data_ring[i].hal_srng;
+		if (!hal_ring_hdl)
+			continue;
+
+		used += hal_srng_get_num_entries(soc->hal_soc, hal_ring_hdl) -
+			hal_srng_src_num_avail(soc->hal_soc, hal_ring_hdl,
+					       false);
+	}
+
+	return used;
+}
+
+/**
+ * dp_tx_mlo_steer_link_update() - Refresh the metrics of one link
+ * @link: link steering state
+ * @soc: DP soc of the link
+ * @vdev_id: link vdev id on @soc
+ *
+ * Return: true if the link vdev is present
+ */
+static bool dp_tx_mlo_steer_link_update(struct dp_mlo_steer_link *link,
+					struct dp_soc *soc, uint8_t vdev_id)
+{
+	struct dp_vdev *vdev;
+	struct dp_pdev *pdev;
+	uint32_t rate;
+
+	vdev = soc->vdev_id_map[vdev_id];
+	if (!vdev || vdev->delete.pending) {
+		link->vdev_id = CDP_INVALID_VDEV_ID;
+		return false;
+	}
+
+	pdev = vdev->pdev;
+	rate = pdev->stats.tx.last_tx_rate;
+	if (!rate)
+		rate = DP_MLO_STEER_DEF_RATE_KBPS;
+	else if (rate < 1000)
+		rate = 1000;
+
+	link->soc = soc;
+	link->vdev_id = vdev_id;
+	link->tcl_used = dp_tx_mlo_steer_tcl_used(soc);
+	link->outstanding = qdf_atomic_read(&pdev->num_tx_outstanding);
+	link->phy_rate = rate;
+	link->comp_delay_us =
+		dp_get_be_pdev_from_dp_pdev(pdev)->tx_steer_comp_delay_us;
+
+	/*
+	 * Time to drain the frames queued on the link, taking a 1500 byte
+	 * frame as the unit, on top of the time HW takes to complete one.
+	 */
+	link->cost = (link->tcl_used + link->outstanding) *
+		     (12000 * 1000 / rate) + link->comp_delay_us;
+
+	return true;
+}
+
+/**
+ * dp_tx_mlo_steer_eval() - Refresh the metrics of all links of a vdev
+ * @be_soc: BE soc of the vdev
+ * @be_vdev: BE vdev the frames are given to
+ * @now: current time in ms
+ *
+ * Only one CPU refreshes the metrics at a time, others keep using the
+ * previous values.
+ *
+ * Return: None
+ */
+static void dp_tx_mlo_steer_eval(struct dp_soc_be *be_soc,
+				 struct dp_vdev_be *be_vdev, uint32_t now)
+{
+	struct dp_mlo_tx_steer *steer = &be_vdev->tx_steer;
+	struct dp_mlo_steer_link *link;
+	struct dp_soc *soc;
+	uint8_t chip, j, idx, vdev_id;
+	uint8_t num_links = 0;
+	uint8_t best = DP_MLO_STEER_INVALID_LINK;
+
+	if (qdf_atomic_test_and_set_bit(0, &steer->evaluating))
+		return;
+
+	for (chip = 0; chip < WLAN_MAX_MLO_CHIPS; chip++) {
+		for (j = 0; j < WLAN_MAX_MLO_LINKS_PER_SOC; j++) {
+			idx = chip * WLAN_MAX_MLO_LINKS_PER_SOC + j;
+			link = &steer->link[idx];
+			link->vdev_id = CDP_INVALID_VDEV_ID;
+
+			if (chip == be_soc->mlo_chip_id &&
+			    j == be_vdev->vdev.pdev->pdev_id) {
+				soc = &be_soc->soc;
+				vdev_id = be_vdev->vdev.vdev_id;
+			} else {
+				vdev_id = be_vdev->partner_vdev_list[chip][j];
+				if (vdev_id == CDP_INVALID_VDEV_ID)
+					continue;
+
+				soc = dp_mlo_get_soc_ref_by_chip_id(
+							be_soc->ml_ctxt, chip);
+				if (!soc)
+					continue;
+				/* soc lifetime is tied to the MLO context */
+				qdf_atomic_dec(&soc->ref_count);
+			}
+
+			if (!dp_tx_mlo_steer_link_update(link, soc, vdev_id))
+				continue;
+
+			num_links++;
+			if (best == DP_MLO_STEER_INVALID_LINK ||
+			    link->cost < steer->link[best].cost)
+				best = idx;
+		}
+	}
+
+	steer->num_links = num_links;
+	steer->best_link = best;
+	steer->last_eval_ts = now;
+
+	qdf_atomic_clear_bit(0, &steer->evaluating);
+}
+
+/**
+ * dp_tx_mlo_steer_link_ok() - Check if a frame can be sent on a link
+ * @vdev: DP vdev the frame was given to
+ * @link: candidate link
+ * @da: destination MAC address of the frame
+ * @chip: MLO chip id of the link
+ *
+ * In AP mode the destination must be associated on the link, a STA vdev
+ * always reaches the AP MLD on each of its links.
+ *
+ * Return: true if the frame can be sent on the link
+ */
+static bool dp_tx_mlo_steer_link_ok(struct dp_vdev *vdev,
+				    struct dp_mlo_steer_link *link,
+				    uint8_t *da, uint8_t chip)
+{
+	struct dp_peer *peer;
+
+	if (link->vdev_id == CDP_INVALID_VDEV_ID)
+		return false;
+
+	if (vdev->opmode != wlan_op_mode_ap)
+		return true;
+
+	peer = dp_link_peer_hash_find_by_chip_id(link->soc, da, 0,
+						 link->vdev_id, chip,
+						 DP_MOD_ID_TX);
+	if (!peer)
+		return false;
+
+	dp_peer_unref_delete(peer, DP_MOD_ID_TX);
+
+	return true;
+}
+
+struct dp_vdev *dp_tx_mlo_link_steer_be(struct dp_soc *soc,
+					struct dp_vdev *vdev,
+					qdf_nbuf_t nbuf)
+{
+	struct dp_soc_be *be_soc = dp_get_be_soc_from_dp_soc(soc);
+	struct dp_vdev_be *be_vdev = dp_get_be_vdev_from_dp_vdev(vdev);
+	struct dp_mlo_tx_steer *steer = &be_vdev->tx_steer;
+	struct dp_mlo_steer_flow *flow;
+	struct dp_mlo_steer_link *link;
+	struct dp_vdev *link_vdev;
+	qdf_ether_header_t *eh;
+	uint32_t now;
+	uint8_t idx, best, chip;
+
+	if (!be_soc->mlo_enabled ||
+	    vdev->tx_encap_type != htt_cmn_pkt_type_ethernet)
+		return vdev;
+
+	eh = (qdf_ether_header_t *)qdf_nbuf_data(nbuf);
+	if (DP_FRAME_IS_MULTICAST(eh->ether_dhost))
+		return vdev;
+
+	now = qdf_system_ticks_to_msecs(qdf_system_ticks());
+	if (now - steer->last_eval_ts >= DP_MLO_STEER_EVAL_MS)
+		dp_tx_mlo_steer_eval(be_soc, be_vdev, now);
+
+	if (steer->num_links < 2)
+		return vdev;
+
+	flow = &steer->flow[qdf_nbuf_get_tx_flow_hash(nbuf) &
+			    (DP_MLO_STEER_FLOW_TBL_SIZE - 1)];
+
+	/*
+	 * Keep a busy flow on its link so that its frames are not
+	 * reordered across links, only an idle flow can move.
+	 */
+	if (flow->link != DP_MLO_STEER_INVALID_LINK &&
+	    flow->link < DP_MLO_STEER_MAX_LINKS &&
+	    steer->link[flow->link].vdev_id != CDP_INVALID_VDEV_ID &&
+	    now - flow->last_ts < DP_MLO_STEER_FLOW_IDLE_MS) {
+		idx = flow->link;
+		goto send;
+	}
+
+	best = DP_MLO_STEER_INVALID_LINK;
+	for (idx = 0; idx < DP_MLO_STEER_MAX_LINKS; idx++) {
+		link = &steer->link[idx];
+		chip = idx / WLAN_MAX_MLO_LINKS_PER_SOC;
+
+		if (best != DP_MLO_STEER_INVALID_LINK &&
+		    link->cost >= steer->link[best].cost)
+			continue;
+
+		if (!dp_tx_mlo_steer_link_ok(vdev, link, eh->ether_dhost,
+					     chip))
+			continue;
+
+		best = idx;
+	}
+
+	if (best == DP_MLO_STEER_INVALID_LINK)
+		return vdev;
+
+	steer->flow_assign++;
+	if (flow->last_ts && flow->link != best)
+		steer->flow_moves++;
+
+	flow->link = best;
+	idx = best;
+
+send:
+	flow->last_ts = now;
+	link = &steer->link[idx];
+
+	link_vdev = link->soc->vdev_id_map[link->vdev_id];
+	if (!link_vdev)
+		return vdev;
+
+	link->tx_pkts++;
+
+	return link_vdev;
+}
+
+void dp_tx_mlo_link_steer_comp_be(struct dp_soc *soc,
+				  struct dp_tx_desc_s *tx_desc,
+				  struct hal_tx_completion_status *ts)
+{
+	struct dp_pdev_be *be_pdev;
+	uint32_t delay_us;
+
+	if (!tx_desc->pdev)
+		return;
+
+	if (dp_mlo_compute_hw_delay_us(soc, NULL, ts, &delay_us) !=
+	    QDF_STATUS_SUCCESS)
+		return;
+
+	be_pdev = dp_get_be_pdev_from_dp_pdev(tx_desc->pdev);
+	/* EWMA with a weight of 1/8 for the new sample */
+	be_pdev->tx_steer_comp_delay_us =
+		be_pdev->tx_steer_comp_delay_us -
+		(be_pdev->tx_steer_comp_delay_us >> 3) + (delay_us >> 3);
+}
+
+void dp_tx_mlo_link_steer_print_stats_be(struct dp_soc *soc)
+{
+	struct dp_vdev *vdev;
+	struct dp_vdev_be *be_vdev;
+	struct dp_mlo_tx_steer *steer;
+	struct dp_mlo_steer_link *link;
+	uint64_t total;
+	uint32_t now, flows;
+	uint8_t vdev_id, idx, i;
+
+	now = qdf_system_ticks_to_msecs(qdf_system_ticks());
+
+	for (vdev_id = 0; vdev_id < MAX_VDEV_CNT; vdev_id++) {
+		vdev = dp_vdev_get_ref_by_id(soc, vdev_id,
+					     DP_MOD_ID_GENERIC_STATS);
+		if (!vdev)
+			continue;
+
+		be_vdev = dp_get_be_vdev_from_dp_vdev(vdev);
+		steer = &be_vdev->tx_steer;
+
+		if (steer->num_links < 2) {
+			dp_vdev_unref_delete(soc, vdev,
+					     DP_MOD_ID_GENERIC_STATS);
+			continue;
+		}
+
+		total = 0;
+		for (idx = 0; idx < DP_MLO_STEER_MAX_LINKS; idx++)
+			total += steer->link[idx].tx_pkts;
+
+		DP_PRINT_STATS("vdev %u: links = %u best = %u flow_assign = %u flow_moves = %u",
+			       vdev_id, steer->num_links, steer->best_link,
+			       steer->flow_assign, steer->flow_moves);
+
+		for (idx = 0; idx < DP_MLO_STEER_MAX_LINKS; idx++) {
+			link = &steer->link[idx];
+			if (link->vdev_id == CDP_INVALID_VDEV_ID)
+				continue;
+
+			flows = 0;
+			for (i = 0; i < DP_MLO_STEER_FLOW_TBL_SIZE; i++) {
+				if (steer->flow[i].link == idx &&
+				    now - steer->flow[i].last_ts <
+				    DP_MLO_STEER_FLOW_IDLE_MS)
+					flows++;
+			}
+			link->flows = flows;
+
+			DP_PRINT_STATS("	link %u: vdev %u tx_pkts = %llu (%llu%%) cost = %u tcl_used = %u outstanding = %u comp_delay_us = %u rate = %u flows = %u",
+				       idx, link->vdev_id, link->tx_pkts,
+				       total ? (link->tx_pkts * 100) / total : 0,
+				       link->cost, link->tcl_used,
+				       link->outstanding, link->comp_delay_us,
+				       link->phy_rate, link->flows);
+		}
+
+		dp_vdev_unref_delete(soc, vdev, DP_MOD_ID_GENERIC_STATS);
+	}
+}
+#endif
+
 static inline
 qdf_dma_addr_t dp_tx_nbuf_map_be(struct dp_vdev *vdev,
 				 struct dp_tx_desc_s *tx_desc,
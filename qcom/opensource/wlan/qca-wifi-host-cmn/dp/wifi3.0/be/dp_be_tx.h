@@ -305,4 +305,43 @@ QDF_STATUS dp_tx_compute_tx_delay_be(struct dp_soc *soc,
 				     struct dp_vdev *vdev,
 				     struct hal_tx_completion_status *ts,
 				     uint32_t *delay_us);
+
+#if defined(WLAN_FEATURE_11BE_MLO) && defined(WLAN_MLO_MULTI_CHIP) && \
+	defined(DP_MLO_TX_LINK_STEER)
+/**
+ * dp_tx_mlo_link_steer_be() - Select the MLO link for a unicast frame
+ * @soc: DP soc handle
+ * @vdev: DP vdev the frame was given to
+ * @nbuf: skb
+ *
+ * The frame flow is pinned to the link with the lowest expected drain
+ * time, based on TCL ring fill, outstanding descriptors, PHY rate and
+ * HW completion delay of each link. A flow only moves once idle.
+ *
+ * Return: DP vdev of the selected link, @vdev if not steered
+ */
+struct dp_vdev *dp_tx_mlo_link_steer_be(struct dp_soc *soc,
+					struct dp_vdev *vdev,
+					qdf_nbuf_t nbuf);
+
+/**
+ * dp_tx_mlo_link_steer_comp_be() - Update link completion delay
+ * @soc: DP soc handle
+ * @tx_desc: software TX descriptor
+ * @ts: TX completion status
+ *
+ * Return: None
+ */
+void dp_tx_mlo_link_steer_comp_be(struct dp_soc *soc,
+				  struct dp_tx_desc_s *tx_desc,
+				  struct hal_tx_completion_status *ts);
+
+/**
+ * dp_tx_mlo_link_steer_print_stats_be() - Print MLO TX link steering stats
+ * @soc: DP soc handle
+ *
+ * Return: None
+ */
+void dp_tx_mlo_link_steer_print_stats_be(struct dp_soc *soc);
+#endif
 #endif
@@ -192,6 +192,18 @@ const char *dp_hist_delay_percentile_str(uint8_t index)
 	return dp_hist_delay_percentile_dbucket_str[index];
 }
 
+/*
+ * dp_hist_dbucket: Bucket lower bounds of each histogram type, indexed by
+ * enum cdp_hist_types. Can be overridden with dp_hist_set_buckets().
+ */
+static uint16_t *dp_hist_dbucket[CDP_HIST_TYPE_MAX] = {
+	[CDP_HIST_TYPE_SW_ENQEUE_DELAY] = dp_hist_sw_enq_dbucket,
+	[CDP_HIST_TYPE_HW_COMP_DELAY] = dp_hist_fw2hw_dbucket,
+	[CDP_HIST_TYPE_REAP_STACK] = dp_hist_reap2stack_bucket,
+	[CDP_HIST_TYPE_HW_TX_COMP_DELAY] = dp_hist_hw_tx_comp_dbucket,
+	[CDP_HIST_TYPE_DELAY_PERCENTILE] = dp_hist_delay_percentile_dbucket,
+};
+
 /*
  * dp_hist_find_bucket_idx: Find the bucket index
  * @bucket_array: Bucket array
@@ -199,7 +211,7 @@ const char *dp_hist_delay_percentile_str(uint8_t index)
  *
  * Return: The bucket index
  */
-static int dp_hist_find_bucket_idx(int16_t *bucket_array, int value)
+static int dp_hist_find_bucket_idx(uint16_t *bucket_array, int value)
 {
 	uint8_t idx = CDP_HIST_BUCKET_0;
 
@@ -221,42 +233,18 @@ static int dp_hist_find_bucket_idx(int16_t *bucket_array, int value)
 static void dp_hist_fill_buckets(struct cdp_hist_bucket *hist_bucket, int value)
 {
 	enum cdp_hist_types hist_type;
-	int idx = CDP_HIST_BUCKET_MAX;
+	int idx;
 
 	if (qdf_unlikely(!hist_bucket))
 		return;
 
 	hist_type = hist_bucket->hist_type;
-
-	/* Identify the bucket the bucket and update. */
-	switch (hist_type) {
-	case CDP_HIST_TYPE_SW_ENQEUE_DELAY:
-		idx =  dp_hist_find_bucket_idx(&dp_hist_sw_enq_dbucket[0],
-					       value);
-		break;
-	case CDP_HIST_TYPE_HW_COMP_DELAY:
-		idx =  dp_hist_find_bucket_idx(&dp_hist_fw2hw_dbucket[0],
-					       value);
-		break;
-	case CDP_HIST_TYPE_REAP_STACK:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_reap2stack_bucket[0], value);
-		break;
-	case CDP_HIST_TYPE_HW_TX_COMP_DELAY:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_hw_tx_comp_dbucket[0], value);
-		break;
-	case CDP_HIST_TYPE_DELAY_PERCENTILE:
-		idx =  dp_hist_find_bucket_idx(
-				&dp_hist_delay_percentile_dbucket[0], value);
-		break;
-	default:
-		break;
-	}
-
-	if (idx == CDP_HIST_BUCKET_MAX)
+	if (qdf_unlikely(hist_type >= CDP_HIST_TYPE_MAX))
 		return;
 
+	/* Identify the bucket and update. */
+	idx = dp_hist_find_bucket_idx(dp_hist_dbucket[hist_type], value);
+
 	hist_bucket->freq[idx]++;
 }
 
@@ -345,6 +333,115 @@ void dp_accumulate_hist_stats(struct cdp_hist_stats *src_hist_stats,
 	}
 }
 
+/*
+ * dp_hist_set_buckets(): Override the bucket bounds of a histogram type
+ * @hist_type: Histogram type
+ * @bounds: CDP_HIST_BUCKET_MAX lower bounds, starting at 0 and strictly
+ *	    increasing
+ *
+ * Counts already collected are not rescaled, so the delay stats should be
+ * cleared after the bounds are changed.
+ *
+ * Return: QDF_STATUS_SUCCESS on success, QDF_STATUS_E_INVAL on bad input
+ */
+QDF_STATUS dp_hist_set_buckets(enum cdp_hist_types hist_type,
+			       const uint16_t *bounds)
+{
+	uint8_t idx;
+
+	if (hist_type >= CDP_HIST_TYPE_MAX || !bounds || bounds[0])
+		return QDF_STATUS_E_INVAL;
+
+	for (idx = 1; idx < CDP_HIST_BUCKET_MAX; idx++) {
+		if (bounds[idx] <= bounds[idx - 1])
+			return QDF_STATUS_E_INVAL;
+	}
+
+	qdf_mem_copy(dp_hist_dbucket[hist_type], bounds,
+		     sizeof(uint16_t) * CDP_HIST_BUCKET_MAX);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/*
+ * dp_hist_get_percentile(): Estimate a percentile from a histogram
+ * @hist_stats: Hist stats object
+ * @hist_type: Histogram type the frequencies were collected with
+ * @pct: Percentile, 1 to 100
+ * @total: Sum of all bucket frequencies, non zero
+ *
+ * The value is interpolated linearly inside the bucket holding the
+ * percentile. The open ended last bucket is bounded by the recorded max.
+ *
+ * Return: Estimated percentile value in the unit of the histogram
+ */
+static uint32_t dp_hist_get_percentile(struct cdp_hist_stats *hist_stats,
+				       enum cdp_hist_types hist_type,
+				       uint8_t pct, uint64_t total)
+{
+	uint16_t *bounds = dp_hist_dbucket[hist_type];
+	uint64_t target, cum = 0, freq;
+	uint32_t low, high;
+	uint8_t idx;
+
+	target = qdf_do_div(total * pct + 99, 100);
+
+	for (idx = 0; idx < CDP_HIST_BUCKET_MAX; idx++) {
+		freq = hist_stats->hist.freq[idx];
+		if (cum + freq >= target)
+			break;
+		cum += freq;
+	}
+
+	if (idx >= CDP_HIST_BUCKET_MAX - 1) {
+		idx = CDP_HIST_BUCKET_MAX - 1;
+		low = bounds[idx];
+		high = QDF_MAX((uint32_t)hist_stats->max, low);
+	} else {
+		low = bounds[idx];
+		high = bounds[idx + 1];
+	}
+
+	if (!freq)
+		return low;
+
+	return low + (uint32_t)qdf_do_div((uint64_t)(high - low) *
+					  (target - cum), freq);
+}
+
+/*
+ * dp_hist_compute_percentiles(): Compute the percentiles of a histogram
+ * @hist_stats: Hist stats object
+ * @hist_type: Histogram type the frequencies were collected with
+ * @pct: Output percentiles
+ *
+ * Return: void
+ */
+void dp_hist_compute_percentiles(struct cdp_hist_stats *hist_stats,
+				 enum cdp_hist_types hist_type,
+				 struct cdp_hist_percentiles *pct)
+{
+	static const uint8_t pct_val[CDP_HIST_PCT_MAX] = {50, 90, 99};
+	uint64_t total = 0;
+	uint8_t idx;
+
+	qdf_mem_zero(pct, sizeof(*pct));
+
+	if (hist_type >= CDP_HIST_TYPE_MAX)
+		return;
+
+	for (idx = 0; idx < CDP_HIST_BUCKET_MAX; idx++)
+		total += hist_stats->hist.freq[idx];
+
+	pct->count = total;
+	if (!total)
+		return;
+
+	for (idx = 0; idx < CDP_HIST_PCT_MAX; idx++)
+		pct->val[idx] = dp_hist_get_percentile(hist_stats, hist_type,
+						       pct_val[idx], total);
+}
+
 /*
  * dp_hist_init(): Initialize the histogram object
  * @hist_stats: Hist stats object
@@ -43,4 +43,9 @@ void dp_copy_hist_stats(struct cdp_hist_stats *src_hist_stats,
 			struct cdp_hist_stats *dst_hist_stats);
 const char *dp_hist_tx_hw_delay_str(uint8_t index);
 const char *dp_hist_delay_percentile_str(uint8_t index);
+QDF_STATUS dp_hist_set_buckets(enum cdp_hist_types hist_type,
+			       const uint16_t *bounds);
+void dp_hist_compute_percentiles(struct cdp_hist_stats *hist_stats,
+				 enum cdp_hist_types hist_type,
+				 struct cdp_hist_percentiles *pct);
 #endif /* __DP_HIST_H_ */
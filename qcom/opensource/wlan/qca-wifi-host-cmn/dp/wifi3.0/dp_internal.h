@@ -2077,6 +2077,26 @@ extern void dp_peer_find_detach(struct dp_soc *soc);
 extern void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer);
 extern void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer);
 extern void dp_peer_find_hash_erase(struct dp_soc *soc);
+
+#ifdef DP_PEER_HASH_RCU
+/**
+ * dp_peer_hash_free_peer() - free peer memory once lockless lookups are done
+ * @soc: SoC handle
+ * @peer: peer whose last reference was dropped
+ *
+ * The peer is released after it is flushed from the per CPU lookup cache
+ * and no RCU reader can still be looking at it.
+ *
+ * Return: None
+ */
+void dp_peer_hash_free_peer(struct dp_soc *soc, struct dp_peer *peer);
+#else
+static inline
+void dp_peer_hash_free_peer(struct dp_soc *soc, struct dp_peer *peer)
+{
+	qdf_mem_free(peer);
+}
+#endif
 void dp_peer_vdev_list_add(struct dp_soc *soc, struct dp_vdev *vdev,
 			   struct dp_peer *peer);
 void dp_peer_vdev_list_remove(struct dp_soc *soc, struct dp_vdev *vdev,
@@ -4057,6 +4077,37 @@ dp_txrx_get_peer_jitter_stats(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 			      uint8_t vdev_id, uint8_t *peer_mac,
 			      struct cdp_peer_tid_stats *tid_stats);
 
+/**
+ * dp_txrx_get_peer_delay_percentiles() - to get peer delay percentiles
+ *					  per TIDs
+ * @soc_hdl: soc handle
+ * @vdev_id: id of vdev handle
+ * @peer_mac: mac of DP_PEER handle
+ * @pct: pointer to percentiles array of CDP_MAX_DATA_TIDS entries
+ *
+ * Return: QDF_STATUS_SUCCESS: Success
+ *         QDF_STATUS_E_FAILURE: Error
+ */
+QDF_STATUS
+dp_txrx_get_peer_delay_percentiles(struct cdp_soc_t *soc_hdl,
+				   uint8_t vdev_id, uint8_t *peer_mac,
+				   struct cdp_delay_tid_percentiles *pct);
+
+/**
+ * dp_txrx_set_delay_hist_buckets() - to set the bucket bounds of a delay
+ *				      histogram type
+ * @soc_hdl: soc handle
+ * @hist_type: histogram type
+ * @bounds: CDP_HIST_BUCKET_MAX lower bounds
+ *
+ * Return: QDF_STATUS_SUCCESS: Success
+ *         QDF_STATUS_E_INVAL: Invalid bounds
+ */
+QDF_STATUS
+dp_txrx_set_delay_hist_buckets(struct cdp_soc_t *soc_hdl,
+			       enum cdp_hist_types hist_type,
+			       const uint16_t *bounds);
+
 /* dp_peer_get_tx_capture_stats - to get peer Tx Capture stats
  * @soc_hdl: soc handle
  * @vdev_id: id of vdev handle
@@ -2047,10 +2047,54 @@ void dp_ipa_deregister_op_cb(struct cdp_soc_t *soc_hdl, uint8_t pdev_id)
 
 QDF_STATUS dp_ipa_get_stat(struct cdp_soc_t *soc_hdl, uint8_t pdev_id)
 {
-	/* TBD */
+	struct dp_soc *soc = cdp_soc_t_to_dp_soc(soc_hdl);
+	struct dp_ipa_flow_stats *stats = &soc->ipa_flow_cache.stats;
+	uint32_t fwd = stats->fwd_slow + stats->fwd_fast;
+
+	dp_info("IPA exception: pkts %u fwd slow %u fast %u (%u%%) flows learned %u evicted %u",
+		stats->exception_pkts, stats->fwd_slow, stats->fwd_fast,
+		fwd ? (stats->fwd_fast * 100) / fwd : 0,
+		stats->flows_learned, stats->flows_evicted);
+
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * dp_ipa_flow_cache_init() - init the IPA exception path flow cache
+ * @soc: data path soc handle
+ *
+ * Return: none
+ */
+static void dp_ipa_flow_cache_init(struct dp_soc *soc)
+{
+	struct dp_ipa_flow_cache *cache = &soc->ipa_flow_cache;
+
+	if (cache->initialized)
+		return;
+
+	qdf_mem_zero(cache->entry, sizeof(cache->entry));
+	qdf_mem_zero(&cache->stats, sizeof(cache->stats));
+	qdf_spinlock_create(&cache->lock);
+	cache->initialized = true;
+}
+
+/**
+ * dp_ipa_flow_cache_deinit() - deinit the IPA exception path flow cache
+ * @soc: data path soc handle
+ *
+ * Return: none
+ */
+static void dp_ipa_flow_cache_deinit(struct dp_soc *soc)
+{
+	struct dp_ipa_flow_cache *cache = &soc->ipa_flow_cache;
+
+	if (!cache->initialized)
+		return;
+
+	cache->initialized = false;
+	qdf_spinlock_destroy(&cache->lock);
+}
+
 /**
  * dp_tx_send_ipa_data_frame() - send IPA data frame
  * @soc_hdl: datapath soc handle
@@ -2767,6 +2811,7 @@ QDF_STATUS dp_ipa_setup(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 
 	qdf_spinlock_create(&soc->ipa_rx_buf_map_lock);
 	soc->ipa_rx_buf_map_lock_initialized = true;
+	dp_ipa_flow_cache_init(soc);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -3136,6 +3181,7 @@ QDF_STATUS dp_ipa_setup(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 
 	qdf_spinlock_create(&soc->ipa_rx_buf_map_lock);
 	soc->ipa_rx_buf_map_lock_initialized = true;
+	dp_ipa_flow_cache_init(soc);
 
 	QDF_TRACE(QDF_MODULE_ID_TXRX, QDF_TRACE_LEVEL_DEBUG,
 		  "%s: Tx: %s=%pK, %s=%d, %s=%pK, %s=%pK, %s=%d, %s=%pK, %s=%d, %s=%pK",
@@ -3280,6 +3326,7 @@ QDF_STATUS dp_ipa_cleanup(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 		qdf_spinlock_destroy(&soc->ipa_rx_buf_map_lock);
 		soc->ipa_rx_buf_map_lock_initialized = false;
 	}
+	dp_ipa_flow_cache_deinit(soc);
 
 	pdev = dp_get_pdev_from_soc_pdev_id_wifi3(soc, pdev_id);
 	if (qdf_unlikely(!pdev)) {
@@ -3623,6 +3670,114 @@ static inline bool dp_ipa_peer_check(struct dp_soc *soc,
 }
 #endif
 
+/*
+ * A flow is promoted to the fast path once DP_IPA_FLOW_LEARN_PKTS packets
+ * were validated within DP_IPA_FLOW_LEARN_WINDOW_MS. Learned flows still
+ * go through full peer validation every DP_IPA_FLOW_REVALIDATE_MS so that
+ * a peer leaving the BSS is noticed.
+ */
+#define DP_IPA_FLOW_LEARN_PKTS 32
+#define DP_IPA_FLOW_LEARN_WINDOW_MS 1000
+#define DP_IPA_FLOW_REVALIDATE_MS 200
+
+static inline struct dp_ipa_flow_entry *
+dp_ipa_flow_entry_get(struct dp_soc *soc, struct ethhdr *eh, uint8_t vdev_id)
+{
+	uint32_t idx;
+
+	idx = (eh->h_source[5] ^ eh->h_dest[5]) +
+	      (eh->h_source[4] ^ eh->h_dest[4]) * 31 + vdev_id;
+
+	return &soc->ipa_flow_cache.entry[idx & (DP_IPA_FLOW_CACHE_SIZE - 1)];
+}
+
+static inline bool
+dp_ipa_flow_entry_match(struct dp_ipa_flow_entry *entry, struct ethhdr *eh,
+			uint8_t vdev_id)
+{
+	return entry->vdev_id == vdev_id &&
+	       !qdf_mem_cmp(entry->src, eh->h_source, QDF_MAC_ADDR_SIZE) &&
+	       !qdf_mem_cmp(entry->dst, eh->h_dest, QDF_MAC_ADDR_SIZE);
+}
+
+/**
+ * dp_ipa_flow_is_learned() - check if an exception flow uses the fast path
+ * @soc: data path soc handle
+ * @eh: ethernet header of the packet
+ * @vdev_id: vdev id the packet was received on
+ *
+ * Return: true if both peers of the flow were validated recently enough
+ */
+static bool
+dp_ipa_flow_is_learned(struct dp_soc *soc, struct ethhdr *eh, uint8_t vdev_id)
+{
+	struct dp_ipa_flow_cache *cache = &soc->ipa_flow_cache;
+	struct dp_ipa_flow_entry *entry;
+	bool learned = false;
+
+	if (qdf_unlikely(!cache->initialized))
+		return false;
+
+	entry = dp_ipa_flow_entry_get(soc, eh, vdev_id);
+
+	qdf_spin_lock_bh(&cache->lock);
+	if (entry->learned && dp_ipa_flow_entry_match(entry, eh, vdev_id) &&
+	    qdf_system_ticks_to_msecs(qdf_system_ticks() - entry->ts) <
+	    DP_IPA_FLOW_REVALIDATE_MS) {
+		cache->stats.fwd_fast++;
+		learned = true;
+	}
+	qdf_spin_unlock_bh(&cache->lock);
+
+	return learned;
+}
+
+/**
+ * dp_ipa_flow_learn() - account a fully validated exception packet
+ * @soc: data path soc handle
+ * @eh: ethernet header of the packet
+ * @vdev_id: vdev id the packet was received on
+ *
+ * Return: none
+ */
+static void
+dp_ipa_flow_learn(struct dp_soc *soc, struct ethhdr *eh, uint8_t vdev_id)
+{
+	struct dp_ipa_flow_cache *cache = &soc->ipa_flow_cache;
+	struct dp_ipa_flow_entry *entry;
+	qdf_time_t now;
+
+	if (qdf_unlikely(!cache->initialized))
+		return;
+
+	entry = dp_ipa_flow_entry_get(soc, eh, vdev_id);
+	now = qdf_system_ticks();
+
+	qdf_spin_lock_bh(&cache->lock);
+	cache->stats.fwd_slow++;
+	if (!dp_ipa_flow_entry_match(entry, eh, vdev_id)) {
+		if (entry->learned)
+			cache->stats.flows_evicted++;
+		qdf_mem_copy(entry->src, eh->h_source, QDF_MAC_ADDR_SIZE);
+		qdf_mem_copy(entry->dst, eh->h_dest, QDF_MAC_ADDR_SIZE);
+		entry->vdev_id = vdev_id;
+		entry->learned = false;
+		entry->hits = 1;
+		entry->ts = now;
+	} else if (entry->learned) {
+		entry->ts = now;
+	} else if (qdf_system_ticks_to_msecs(now - entry->ts) >
+		   DP_IPA_FLOW_LEARN_WINDOW_MS) {
+		entry->hits = 1;
+		entry->ts = now;
+	} else if (++entry->hits >= DP_IPA_FLOW_LEARN_PKTS) {
+		entry->learned = true;
+		entry->ts = now;
+		cache->stats.flows_learned++;
+	}
+	qdf_spin_unlock_bh(&cache->lock);
+}
+
 bool dp_ipa_rx_intrabss_fwd(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 			    qdf_nbuf_t nbuf, bool *fwd_success)
 {
@@ -3674,11 +3829,21 @@ bool dp_ipa_rx_intrabss_fwd(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 	if (!qdf_mem_cmp(eh->h_dest, vdev->mac_addr.raw, QDF_MAC_ADDR_SIZE))
 		goto out;
 
-	if (!dp_ipa_peer_check(soc, eh->h_dest, vdev->vdev_id))
-		goto out;
+	soc->ipa_flow_cache.stats.exception_pkts++;
 
-	if (!dp_ipa_peer_check(soc, eh->h_source, vdev->vdev_id))
-		goto out;
+	/*
+	 * Heavy intra-BSS flows skip the per packet AST lookups once both
+	 * peers have been validated for enough packets.
+	 */
+	if (!dp_ipa_flow_is_learned(soc, eh, vdev->vdev_id)) {
+		if (!dp_ipa_peer_check(soc, eh->h_dest, vdev->vdev_id))
+			goto out;
+
+		if (!dp_ipa_peer_check(soc, eh->h_source, vdev->vdev_id))
+			goto out;
+
+		dp_ipa_flow_learn(soc, eh, vdev->vdev_id);
+	}
 
 	/*
 	 * In intra-bss forwarding scenario, skb is allocated by IPA driver.
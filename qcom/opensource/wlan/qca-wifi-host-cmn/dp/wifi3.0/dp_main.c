@@ -2795,6 +2795,139 @@ static inline int dp_srng_get_cpu(void)
 	return smp_processor_id();
 }
 
+/* Packet rate sampling window of the adaptive REO ring interrupt profile */
+#define DP_RX_INTR_ADAPT_WIN_MS 100
+/* Switch a ring to low latency below / high throughput above these rates */
+#define DP_RX_INTR_ADAPT_LL_PPS 2000
+#define DP_RX_INTR_ADAPT_HT_PPS 20000
+
+/**
+ * enum dp_rx_intr_level - Interrupt level programmed in a REO ring
+ * @DP_RX_INTR_LVL_CFG: thresholds from wlan_cfg, full budget
+ * @DP_RX_INTR_LVL_LOW_LATENCY: interrupt on every entry, small budget
+ * @DP_RX_INTR_LVL_HIGH_TPUT: coalesced interrupts, full budget
+ */
+enum dp_rx_intr_level {
+	DP_RX_INTR_LVL_CFG,
+	DP_RX_INTR_LVL_LOW_LATENCY,
+	DP_RX_INTR_LVL_HIGH_TPUT,
+};
+
+/**
+ * dp_rx_intr_set_level() - Program interrupt thresholds and budget of a
+ *			    REO destination ring
+ * @soc: DP SOC handle
+ * @ring: REO destination ring number
+ * @level: interrupt level to program
+ *
+ * Return: none
+ */
+static void dp_rx_intr_set_level(struct dp_soc *soc, int ring, uint8_t level)
+{
+	struct dp_rx_intr_adapt *adapt = &soc->rx_intr_adapt[ring];
+	uint32_t timer_us, batch;
+
+	switch (level) {
+	case DP_RX_INTR_LVL_LOW_LATENCY:
+		timer_us = 8;
+		batch = 1;
+		adapt->budget = 32;
+		break;
+	case DP_RX_INTR_LVL_HIGH_TPUT:
+		timer_us = 128;
+		batch = 32;
+		adapt->budget = 0;
+		break;
+	default:
+		timer_us = wlan_cfg_get_int_timer_threshold_rx(
+							soc->wlan_cfg_ctx);
+		batch = wlan_cfg_get_int_batch_threshold_rx(soc->wlan_cfg_ctx);
+		adapt->budget = 0;
+		break;
+	}
+
+	hal_srng_dst_update_int_setup(soc->hal_soc,
+				      soc->reo_dest_ring[ring].hal_srng,
+				      timer_us, batch);
+	adapt->level = level;
+	dp_debug("REO ring %d: level %u pps %u timer %u batch %u budget %u",
+		 ring, level, adapt->pps, timer_us, batch, adapt->budget);
+}
+
+/**
+ * dp_rx_intr_adapt() - Track the packet rate of a REO destination ring and
+ *			move it between interrupt levels
+ * @soc: DP SOC handle
+ * @ring: REO destination ring number
+ * @work_done: entries reaped from the ring in this poll
+ *
+ * Return: none
+ */
+static inline void
+dp_rx_intr_adapt(struct dp_soc *soc, int ring, uint32_t work_done)
+{
+	struct dp_rx_intr_adapt *adapt = &soc->rx_intr_adapt[ring];
+	qdf_time_t now, elapsed;
+	uint8_t level;
+
+	if (qdf_likely(soc->rx_intr_profile == CDP_RX_INTR_PROFILE_STATIC &&
+		       adapt->level == DP_RX_INTR_LVL_CFG))
+		return;
+
+	adapt->win_pkts += work_done;
+	now = qdf_get_system_timestamp();
+	elapsed = now - adapt->win_start_ms;
+	if (elapsed < DP_RX_INTR_ADAPT_WIN_MS)
+		return;
+
+	adapt->pps = (uint32_t)((uint64_t)adapt->win_pkts * 1000 / elapsed);
+	adapt->win_pkts = 0;
+	adapt->win_start_ms = now;
+
+	switch (soc->rx_intr_profile) {
+	case CDP_RX_INTR_PROFILE_LOW_LATENCY:
+		level = DP_RX_INTR_LVL_LOW_LATENCY;
+		break;
+	case CDP_RX_INTR_PROFILE_HIGH_TPUT:
+		level = DP_RX_INTR_LVL_HIGH_TPUT;
+		break;
+	case CDP_RX_INTR_PROFILE_ADAPTIVE:
+		level = adapt->level;
+		if (adapt->pps < DP_RX_INTR_ADAPT_LL_PPS)
+			level = DP_RX_INTR_LVL_LOW_LATENCY;
+		else if (adapt->pps > DP_RX_INTR_ADAPT_HT_PPS)
+			level = DP_RX_INTR_LVL_HIGH_TPUT;
+		else if (level == DP_RX_INTR_LVL_CFG)
+			level = DP_RX_INTR_LVL_LOW_LATENCY;
+		break;
+	default:
+		level = DP_RX_INTR_LVL_CFG;
+		break;
+	}
+
+	if (level != adapt->level)
+		dp_rx_intr_set_level(soc, ring, level);
+}
+
+/**
+ * dp_rx_intr_ring_quota() - Quota a REO destination ring may use in a poll
+ * @soc: DP SOC handle
+ * @ring: REO destination ring number
+ * @remaining_quota: quota left in this NAPI poll
+ *
+ * Return: quota for the ring
+ */
+static inline uint32_t
+dp_rx_intr_ring_quota(struct dp_soc *soc, int ring, uint32_t remaining_quota)
+{
+	uint32_t budget = soc->rx_intr_adapt[ring].budget;
+
+	if (budget && budget < remaining_quota)
+		return budget;
+
+	return remaining_quota;
+}
+
 /*
  * dp_service_srngs() - Top level interrupt handler for DP Ring interrupts
  * @dp_ctx: DP SOC handle
@@ -2895,7 +3028,9 @@ static uint32_t dp_service_srngs(void *dp_ctx, uint32_t dp_budget, int cpu)
 			work_done = soc->arch_ops.dp_rx_process(int_ctx,
 						  soc->reo_dest_ring[ring].hal_srng,
 						  ring,
-						  remaining_quota);
+						  dp_rx_intr_ring_quota(soc, ring,
+									remaining_quota));
+			dp_rx_intr_adapt(soc, ring, work_done);
 			if (work_done) {
 				intr_stats->num_rx_ring_masks[ring]++;
 				dp_verbose_debug("rx mask 0x%x ring %d, work_done %d budget %d",
@@ -6495,6 +6630,7 @@ static void dp_soc_detach(struct cdp_soc_t *txrx_soc)
 
 	soc->arch_ops.txrx_soc_detach(soc);
 
+	dp_tx_rtpm_hold_deinit(soc);
 	dp_runtime_deinit();
 
 	dp_sysfs_deinitialize_stats(soc);
@@ -6948,6 +7084,7 @@ dp_soc_attach_target_wifi3(struct cdp_soc_t *cdp_soc)
 	DP_STATS_INIT(soc);
 
 	dp_runtime_init(soc);
+	dp_tx_rtpm_hold_init(soc);
 
 	/* Enable HW vdev offload stats if feature is supported */
 	dp_vdev_stats_hw_offload_target_config(soc, INVALID_PDEV_ID, true);
@@ -9035,7 +9172,7 @@ void dp_peer_unref_delete(struct dp_peer *peer, enum dp_mod_id mod_id)
 		dp_txrx_peer_detach(soc, peer);
 		dp_cfg_event_record_peer_evt(soc, DP_CFG_EVENT_PEER_UNREF_DEL,
 					     peer, vdev, 0);
-		qdf_mem_free(peer);
+		dp_peer_hash_free_peer(soc, peer);
 
 		/*
 		 * Decrement ref count taken at peer create
@@ -10373,6 +10510,7 @@ dp_print_host_stats(struct dp_vdev *vdev,
 	case TXRX_TX_HOST_STATS:
 		dp_print_pdev_tx_stats(pdev);
 		dp_print_soc_tx_stats(pdev->soc);
+		dp_tx_rtpm_hold_print_stats(pdev->soc);
 		break;
 	case TXRX_RX_HOST_STATS:
 		dp_print_pdev_rx_stats(pdev);
@@ -13172,6 +13310,13 @@ static QDF_STATUS dp_soc_set_param(struct cdp_soc_t  *soc_hdl,
 		dp_info("UMAC HW reset support :%u",
 			soc->features.umac_hw_reset_support);
 		break;
+	case DP_SOC_PARAM_RX_INTR_PROFILE:
+		if (value >= CDP_RX_INTR_PROFILE_MAX)
+			return QDF_STATUS_E_INVAL;
+		soc->rx_intr_profile = value;
+		dp_info("REO ring interrupt profile: %u",
+			soc->rx_intr_profile);
+		break;
 	default:
 		dp_info("not handled param %d ", param);
 		break;
@@ -14403,6 +14548,8 @@ static struct cdp_host_stats_ops dp_ops_host_stats = {
 	.txrx_update_vdev_stats = dp_txrx_update_vdev_host_stats,
 	.txrx_get_peer_delay_stats = dp_txrx_get_peer_delay_stats,
 	.txrx_get_peer_jitter_stats = dp_txrx_get_peer_jitter_stats,
+	.txrx_get_peer_delay_percentiles = dp_txrx_get_peer_delay_percentiles,
+	.txrx_set_delay_hist_buckets = dp_txrx_set_delay_hist_buckets,
 #ifdef QCA_VDEV_STATS_HW_OFFLOAD_SUPPORT
 	.txrx_alloc_vdev_stats_id = dp_txrx_alloc_vdev_stats_id,
 	.txrx_reset_vdev_stats_id = dp_txrx_reset_vdev_stats_id,
@@ -14719,6 +14866,7 @@ static QDF_STATUS dp_runtime_resume(struct cdp_soc_t *soc_hdl, uint8_t pdev_id)
 		dp_flush_ring_hptp(soc, soc->tcl_data_ring[i].hal_srng);
 	}
 	qdf_atomic_set(&soc->tx_pending_rtpm, 0);
+	dp_tx_rtpm_hold_flush(soc);
 
 	dp_flush_ring_hptp(soc, soc->reo_cmd_ring.hal_srng);
 	dp_rx_fst_update_pm_suspend_status(soc, false);
@@ -393,6 +393,247 @@ dp_peer_find_hash_index(struct dp_soc *soc,
 	return index;
 }
 
+#ifdef DP_PEER_HASH_RCU
+/*
+ * The link peer hash is walked under rcu_read_lock() only; peer_hash_lock
+ * serializes insert/remove. A peer found locklessly is validated by taking
+ * a reference (a hashed peer always holds the DP_MOD_ID_CONFIG one) before
+ * its vdev is looked at. Each CPU also caches the last peers it resolved,
+ * so the per packet lookup for an active client usually skips the bin walk.
+ *
+ * A peer may still be referenced from a lookup cache or a reader after its
+ * last reference is dropped, so its memory is released in two RCU steps:
+ * the first grace period flushes it from the caches, the second one waits
+ * out readers which picked it from a cache just before the flush.
+ */
+#define dp_peer_hash_bin_empty(_soc, _index) \
+	hlist_empty(&(_soc)->peer_hash.bins[_index])
+#define dp_peer_hash_bin_for_each(_peer, _soc, _index) \
+	hlist_for_each_entry(_peer, &(_soc)->peer_hash.bins[_index], \
+			     hash_rcu_elem)
+#define dp_peer_hash_bin_for_each_safe(_peer, _tmp, _soc, _index) \
+	hlist_for_each_entry_safe(_peer, _tmp, \
+				  &(_soc)->peer_hash.bins[_index], \
+				  hash_rcu_elem)
+
+static QDF_STATUS dp_peer_hash_bins_alloc(struct dp_soc *soc, int hash_elems)
+{
+	int i;
+
+	soc->peer_hash.bins = qdf_mem_malloc(hash_elems *
+					     sizeof(struct hlist_head));
+	if (!soc->peer_hash.bins)
+		return QDF_STATUS_E_NOMEM;
+
+	for (i = 0; i < hash_elems; i++)
+		INIT_HLIST_HEAD(&soc->peer_hash.bins[i]);
+
+	qdf_mem_zero(soc->peer_hash_cache, sizeof(soc->peer_hash_cache));
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static void dp_peer_hash_bins_free(struct dp_soc *soc)
+{
+	/*
+	 * Wait for the cache flush callbacks, which touch soc, and then for
+	 * the frees they queued.
+	 */
+	rcu_barrier();
+	rcu_barrier();
+
+	qdf_mem_free(soc->peer_hash.bins);
+	soc->peer_hash.bins = NULL;
+}
+
+static inline void dp_peer_hash_bin_insert(struct dp_soc *soc, uint32_t index,
+					   struct dp_peer *peer)
+{
+	hlist_add_tail_rcu(&peer->hash_rcu_elem, &soc->peer_hash.bins[index]);
+}
+
+static inline bool dp_peer_hash_bin_remove(struct dp_soc *soc, uint32_t index,
+					   struct dp_peer *peer)
+{
+	if (hlist_unhashed(&peer->hash_rcu_elem))
+		return false;
+
+	hlist_del_init_rcu(&peer->hash_rcu_elem);
+	return true;
+}
+
+/*
+ * dp_peer_hash_get_ref() - take a reference on a peer found locklessly
+ * @soc: soc handle
+ * @peer: peer found in the hash bin or the lookup cache
+ * @vdev_id: vdev_id to match or DP_VDEV_ALL
+ * @mod_id: id of module requesting reference
+ *
+ * Return: true if the reference is held and the peer belongs to @vdev_id
+ */
+static inline bool dp_peer_hash_get_ref(struct dp_soc *soc,
+					struct dp_peer *peer, uint8_t vdev_id,
+					enum dp_mod_id mod_id)
+{
+	if (dp_peer_get_ref(soc, peer, mod_id) != QDF_STATUS_SUCCESS)
+		return false;
+
+	if (vdev_id == DP_VDEV_ALL || peer->vdev->vdev_id == vdev_id)
+		return true;
+
+	dp_peer_unref_delete(peer, mod_id);
+	return false;
+}
+
+static struct dp_peer *
+dp_peer_hash_bin_find(struct dp_soc *soc, union dp_align_mac_addr *mac_addr,
+		      uint32_t index, uint8_t vdev_id, enum dp_mod_id mod_id)
+{
+	struct dp_peer **cache;
+	struct dp_peer *peer;
+
+	rcu_read_lock();
+
+	cache = &soc->peer_hash_cache[qdf_get_cpu()]
+				     [index & (DP_PEER_HASH_CACHE_SIZE - 1)];
+	peer = READ_ONCE(*cache);
+	if (peer && !hlist_unhashed_lockless(&peer->hash_rcu_elem) &&
+	    dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
+	    dp_peer_hash_get_ref(soc, peer, vdev_id, mod_id)) {
+		rcu_read_unlock();
+		return peer;
+	}
+
+	hlist_for_each_entry_rcu(peer, &soc->peer_hash.bins[index],
+				 hash_rcu_elem) {
+		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) ||
+		    !dp_peer_hash_get_ref(soc, peer, vdev_id, mod_id))
+			continue;
+
+		WRITE_ONCE(*cache, peer);
+		rcu_read_unlock();
+		return peer;
+	}
+
+	rcu_read_unlock();
+	return NULL;
+}
+
+static void dp_peer_hash_free_rcu(struct rcu_head *rcu)
+{
+	qdf_mem_free(container_of(rcu, struct dp_peer, rcu));
+}
+
+static void dp_peer_hash_cache_flush_rcu(struct rcu_head *rcu)
+{
+	struct dp_peer *peer = container_of(rcu, struct dp_peer, rcu);
+	struct dp_soc *soc = peer->rcu_soc;
+	int cpu, i;
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++)
+		for (i = 0; i < DP_PEER_HASH_CACHE_SIZE; i++)
+			cmpxchg(&soc->peer_hash_cache[cpu][i], peer, NULL);
+
+	call_rcu(&peer->rcu, dp_peer_hash_free_rcu);
+}
+
+void dp_peer_hash_free_peer(struct dp_soc *soc, struct dp_peer *peer)
+{
+	peer->rcu_soc = soc;
+	call_rcu(&peer->rcu, dp_peer_hash_cache_flush_rcu);
+}
+#else
+#define dp_peer_hash_bin_empty(_soc, _index) \
+	TAILQ_EMPTY(&(_soc)->peer_hash.bins[_index])
+#define dp_peer_hash_bin_for_each(_peer, _soc, _index) \
+	TAILQ_FOREACH(_peer, &(_soc)->peer_hash.bins[_index], hash_list_elem)
+#define dp_peer_hash_bin_for_each_safe(_peer, _tmp, _soc, _index) \
+	TAILQ_FOREACH_SAFE(_peer, &(_soc)->peer_hash.bins[_index], \
+			   hash_list_elem, _tmp)
+
+static QDF_STATUS dp_peer_hash_bins_alloc(struct dp_soc *soc, int hash_elems)
+{
+	int i;
+
+	/* allocate an array of TAILQ peer object lists */
+	soc->peer_hash.bins = qdf_mem_malloc(
+		hash_elems * sizeof(TAILQ_HEAD(anonymous_tail_q, dp_peer)));
+	if (!soc->peer_hash.bins)
+		return QDF_STATUS_E_NOMEM;
+
+	for (i = 0; i < hash_elems; i++)
+		TAILQ_INIT(&soc->peer_hash.bins[i]);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+static void dp_peer_hash_bins_free(struct dp_soc *soc)
+{
+	qdf_mem_free(soc->peer_hash.bins);
+	soc->peer_hash.bins = NULL;
+}
+
+static inline void dp_peer_hash_bin_insert(struct dp_soc *soc, uint32_t index,
+					   struct dp_peer *peer)
+{
+	/*
+	 * It is important to add the new peer at the tail of the peer list
+	 * with the bin index.  Together with having the hash_find function
+	 * search from head to tail, this ensures that if two entries with
+	 * the same MAC address are stored, the one added first will be
+	 * found first.
+	 */
+	TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer, hash_list_elem);
+}
+
+static inline bool dp_peer_hash_bin_remove(struct dp_soc *soc, uint32_t index,
+					   struct dp_peer *peer)
+{
+	struct dp_peer *tmppeer = NULL;
+	bool found = false;
+
+	/* Check if tail is not empty before delete*/
+	QDF_ASSERT(!TAILQ_EMPTY(&soc->peer_hash.bins[index]));
+
+	TAILQ_FOREACH(tmppeer, &soc->peer_hash.bins[index], hash_list_elem) {
+		if (tmppeer == peer) {
+			found = true;
+			break;
+		}
+	}
+
+	if (found)
+		TAILQ_REMOVE(&soc->peer_hash.bins[index], peer,
+			     hash_list_elem);
+
+	return found;
+}
+
+static struct dp_peer *
+dp_peer_hash_bin_find(struct dp_soc *soc, union dp_align_mac_addr *mac_addr,
+		      uint32_t index, uint8_t vdev_id, enum dp_mod_id mod_id)
+{
+	struct dp_peer *peer;
+
+	qdf_spin_lock_bh(&soc->peer_hash_lock);
+	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
+		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
+		    ((peer->vdev->vdev_id == vdev_id) ||
+		     (vdev_id == DP_VDEV_ALL))) {
+			/* take peer reference before returning */
+			if (dp_peer_get_ref(soc, peer, mod_id) !=
+						QDF_STATUS_SUCCESS)
+				peer = NULL;
+
+			qdf_spin_unlock_bh(&soc->peer_hash_lock);
+			return peer;
+		}
+	}
+	qdf_spin_unlock_bh(&soc->peer_hash_lock);
+	return NULL; /* failure */
+}
+#endif /* DP_PEER_HASH_RCU */
+
 /*
  * dp_peer_find_hash_find() - returns legacy or mlo link peer from
  *			      peer_hash_table matching vdev_id and mac_address
@@ -412,7 +653,6 @@ struct dp_peer *dp_peer_find_hash_find(
 {
 	union dp_align_mac_addr local_mac_addr_aligned, *mac_addr;
 	uint32_t index;
-	struct dp_peer *peer;
 
 	if (!soc->peer_hash.bins)
 		return NULL;
@@ -426,22 +666,8 @@ struct dp_peer *dp_peer_find_hash_find(
 		mac_addr = &local_mac_addr_aligned;
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
-	qdf_spin_lock_bh(&soc->peer_hash_lock);
-	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
-		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
-		    ((peer->vdev->vdev_id == vdev_id) ||
-		     (vdev_id == DP_VDEV_ALL))) {
-			/* take peer reference before returning */
-			if (dp_peer_get_ref(soc, peer, mod_id) !=
-						QDF_STATUS_SUCCESS)
-				peer = NULL;
 
-			qdf_spin_unlock_bh(&soc->peer_hash_lock);
-			return peer;
-		}
-	}
-	qdf_spin_unlock_bh(&soc->peer_hash_lock);
-	return NULL; /* failure */
+	return dp_peer_hash_bin_find(soc, mac_addr, index, vdev_id, mod_id);
 }
 
 qdf_export_symbol(dp_peer_find_hash_find);
@@ -456,8 +682,7 @@ qdf_export_symbol(dp_peer_find_hash_find);
 static void dp_peer_find_hash_detach(struct dp_soc *soc)
 {
 	if (soc->peer_hash.bins) {
-		qdf_mem_free(soc->peer_hash.bins);
-		soc->peer_hash.bins = NULL;
+		dp_peer_hash_bins_free(soc);
 		qdf_spinlock_destroy(&soc->peer_hash_lock);
 	}
 
@@ -473,7 +698,7 @@ static void dp_peer_find_hash_detach(struct dp_soc *soc)
  */
 static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 {
-	int i, hash_elems, log2;
+	int hash_elems, log2;
 
 	/* allocate the peer MAC address -> peer object hash table */
 	hash_elems = soc->max_peers;
@@ -484,15 +709,9 @@ static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 
 	soc->peer_hash.mask = hash_elems - 1;
 	soc->peer_hash.idx_bits = log2;
-	/* allocate an array of TAILQ peer object lists */
-	soc->peer_hash.bins = qdf_mem_malloc(
-		hash_elems * sizeof(TAILQ_HEAD(anonymous_tail_q, dp_peer)));
-	if (!soc->peer_hash.bins)
+	if (dp_peer_hash_bins_alloc(soc, hash_elems) != QDF_STATUS_SUCCESS)
 		return QDF_STATUS_E_NOMEM;
 
-	for (i = 0; i < hash_elems; i++)
-		TAILQ_INIT(&soc->peer_hash.bins[i]);
-
 	qdf_spinlock_create(&soc->peer_hash_lock);
 
 	if (soc->arch_ops.mlo_peer_find_hash_attach &&
@@ -528,15 +747,7 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 			return;
 		}
 
-		/*
-		 * It is important to add the new peer at the tail of
-		 * peer list with the bin index. Together with having
-		 * the hash_find function search from head to tail,
-		 * this ensures that if two entries with the same MAC address
-		 * are stored, the one added first will be found first.
-		 */
-		TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer,
-				  hash_list_elem);
+		dp_peer_hash_bin_insert(soc, index, peer);
 
 		qdf_spin_unlock_bh(&soc->peer_hash_lock);
 	} else if (peer->peer_type == CDP_MLD_PEER_TYPE) {
@@ -557,26 +768,14 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 {
 	unsigned index;
-	struct dp_peer *tmppeer = NULL;
-	int found = 0;
+	bool found;
 
 	index = dp_peer_find_hash_index(soc, &peer->mac_addr);
 
 	if (peer->peer_type == CDP_LINK_PEER_TYPE) {
-		/* Check if tail is not empty before delete*/
-		QDF_ASSERT(!TAILQ_EMPTY(&soc->peer_hash.bins[index]));
-
 		qdf_spin_lock_bh(&soc->peer_hash_lock);
-		TAILQ_FOREACH(tmppeer, &soc->peer_hash.bins[index],
-			      hash_list_elem) {
-			if (tmppeer == peer) {
-				found = 1;
-				break;
-			}
-		}
+		found = dp_peer_hash_bin_remove(soc, index, peer);
 		QDF_ASSERT(found);
-		TAILQ_REMOVE(&soc->peer_hash.bins[index], peer,
-			     hash_list_elem);
 
 		dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
 		qdf_spin_unlock_bh(&soc->peer_hash_lock);
@@ -590,7 +789,7 @@ void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 #else
 static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 {
-	int i, hash_elems, log2;
+	int hash_elems, log2;
 
 	/* allocate the peer MAC address -> peer object hash table */
 	hash_elems = soc->max_peers;
@@ -601,15 +800,9 @@ static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 
 	soc->peer_hash.mask = hash_elems - 1;
 	soc->peer_hash.idx_bits = log2;
-	/* allocate an array of TAILQ peer object lists */
-	soc->peer_hash.bins = qdf_mem_malloc(
-		hash_elems * sizeof(TAILQ_HEAD(anonymous_tail_q, dp_peer)));
-	if (!soc->peer_hash.bins)
+	if (dp_peer_hash_bins_alloc(soc, hash_elems) != QDF_STATUS_SUCCESS)
 		return QDF_STATUS_E_NOMEM;
 
-	for (i = 0; i < hash_elems; i++)
-		TAILQ_INIT(&soc->peer_hash.bins[i]);
-
 	qdf_spinlock_create(&soc->peer_hash_lock);
 	return QDF_STATUS_SUCCESS;
 }
@@ -617,8 +810,7 @@ static QDF_STATUS dp_peer_find_hash_attach(struct dp_soc *soc)
 static void dp_peer_find_hash_detach(struct dp_soc *soc)
 {
 	if (soc->peer_hash.bins) {
-		qdf_mem_free(soc->peer_hash.bins);
-		soc->peer_hash.bins = NULL;
+		dp_peer_hash_bins_free(soc);
 		qdf_spinlock_destroy(&soc->peer_hash_lock);
 	}
 }
@@ -637,14 +829,7 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 		return;
 	}
 
-	/*
-	 * It is important to add the new peer at the tail of the peer list
-	 * with the bin index.  Together with having the hash_find function
-	 * search from head to tail, this ensures that if two entries with
-	 * the same MAC address are stored, the one added first will be
-	 * found first.
-	 */
-	TAILQ_INSERT_TAIL(&soc->peer_hash.bins[index], peer, hash_list_elem);
+	dp_peer_hash_bin_insert(soc, index, peer);
 
 	qdf_spin_unlock_bh(&soc->peer_hash_lock);
 }
@@ -652,22 +837,13 @@ void dp_peer_find_hash_add(struct dp_soc *soc, struct dp_peer *peer)
 void dp_peer_find_hash_remove(struct dp_soc *soc, struct dp_peer *peer)
 {
 	unsigned index;
-	struct dp_peer *tmppeer = NULL;
-	int found = 0;
+	bool found;
 
 	index = dp_peer_find_hash_index(soc, &peer->mac_addr);
-	/* Check if tail is not empty before delete*/
-	QDF_ASSERT(!TAILQ_EMPTY(&soc->peer_hash.bins[index]));
 
 	qdf_spin_lock_bh(&soc->peer_hash_lock);
-	TAILQ_FOREACH(tmppeer, &soc->peer_hash.bins[index], hash_list_elem) {
-		if (tmppeer == peer) {
-			found = 1;
-			break;
-		}
-	}
+	found = dp_peer_hash_bin_remove(soc, index, peer);
 	QDF_ASSERT(found);
-	TAILQ_REMOVE(&soc->peer_hash.bins[index], peer, hash_list_elem);
 
 	dp_peer_unref_delete(peer, DP_MOD_ID_CONFIG);
 	qdf_spin_unlock_bh(&soc->peer_hash_lock);
@@ -1088,7 +1264,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
 	qdf_spin_lock_bh(&soc->peer_hash_lock);
-	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
+	dp_peer_hash_bin_for_each(peer, soc, index) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
 		    (peer->vdev->pdev == pdev)) {
 			found = true;
@@ -1132,7 +1308,7 @@ static bool dp_peer_exist_on_pdev(struct dp_soc *soc,
 	}
 	index = dp_peer_find_hash_index(soc, mac_addr);
 	qdf_spin_lock_bh(&soc->peer_hash_lock);
-	TAILQ_FOREACH(peer, &soc->peer_hash.bins[index], hash_list_elem) {
+	dp_peer_hash_bin_for_each(peer, soc, index) {
 		if (dp_peer_find_mac_addr_cmp(mac_addr, &peer->mac_addr) == 0 &&
 		    (peer->vdev->pdev == pdev)) {
 			found = true;
@@ -2575,15 +2751,15 @@ void dp_peer_find_hash_erase(struct dp_soc *soc)
 	 * it's known that the soc is no longer in use.
 	 */
 	for (i = 0; i <= soc->peer_hash.mask; i++) {
-		if (!TAILQ_EMPTY(&soc->peer_hash.bins[i])) {
+		if (!dp_peer_hash_bin_empty(soc, i)) {
 			struct dp_peer *peer, *peer_next;
 
 			/*
 			 * TAILQ_FOREACH_SAFE must be used here to avoid any
 			 * memory access violation after peer is freed
 			 */
-			TAILQ_FOREACH_SAFE(peer, &soc->peer_hash.bins[i],
-				hash_list_elem, peer_next) {
+			dp_peer_hash_bin_for_each_safe(peer, peer_next,
+						       soc, i) {
 				/*
 				 * Don't remove the peer from the hash table -
 				 * that would modify the list we are currently
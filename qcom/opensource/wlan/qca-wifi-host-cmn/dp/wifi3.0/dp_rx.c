@@ -43,6 +43,9 @@
 #include "dp_ratetable.h"
 #endif
 #include "enet.h"
+#ifdef WLAN_DP_FEATURE_SW_LATENCY_MGR
+#include <wlan_dp_swlm.h>
+#endif
 
 #ifdef DUP_RX_DESC_WAR
 void dp_rx_dump_info_and_assert(struct dp_soc *soc,
@@ -708,6 +711,56 @@ void dp_rx_desc_reuse(struct dp_soc *soc, qdf_nbuf_t *nbuf_list)
 }
 #endif
 
+#ifdef WLAN_DP_FEATURE_SW_LATENCY_MGR
+/**
+ * dp_rx_refill_ring_access_end() - End refill ring access, coalescing the
+ *				    HP write through SWLM when possible
+ * @soc: core txrx main context
+ * @lmac_id: lmac id of the ring
+ * @dp_rxdma_srng: rxdma ring being replenished
+ * @count: number of buffers added to the ring
+ *
+ * Return: None
+ */
+static inline void
+dp_rx_refill_ring_access_end(struct dp_soc *soc, uint8_t lmac_id,
+			     struct dp_srng *dp_rxdma_srng, uint32_t count)
+{
+	struct dp_swlm *swlm = &soc->swlm;
+	hal_ring_handle_t rxdma_srng = dp_rxdma_srng->hal_srng;
+	struct dp_swlm_refill_data refill_data;
+	union swlm_data swlm_query_data;
+
+	if (!swlm->is_enabled || !count || lmac_id >= MAX_PDEV_CNT ||
+	    dp_rxdma_srng != &soc->rx_refill_buf_ring[lmac_id]) {
+		hal_srng_access_end(soc->hal_soc, rxdma_srng);
+		return;
+	}
+
+	refill_data.lmac_id = lmac_id;
+	refill_data.count = count;
+	refill_data.num_entries = dp_rxdma_srng->num_entries;
+	refill_data.num_posted = dp_rxdma_srng->num_entries -
+		hal_srng_src_num_avail(soc->hal_soc, rxdma_srng, 0);
+	swlm_query_data.refill_data = &refill_data;
+
+	if (dp_swlm_query_policy(soc, RXDMA_BUF, swlm_query_data)) {
+		DP_STATS_INC(swlm, refill[lmac_id].coalesce_success, 1);
+		hal_srng_access_end_reap(soc->hal_soc, rxdma_srng);
+	} else {
+		DP_STATS_INC(swlm, refill[lmac_id].coalesce_fail, 1);
+		hal_srng_access_end(soc->hal_soc, rxdma_srng);
+	}
+}
+#else
+static inline void
+dp_rx_refill_ring_access_end(struct dp_soc *soc, uint8_t lmac_id,
+			     struct dp_srng *dp_rxdma_srng, uint32_t count)
+{
+	hal_srng_access_end(soc->hal_soc, dp_rxdma_srng->hal_srng);
+}
+#endif
+
 /*
  * dp_rx_buffers_replenish() - replenish rxdma ring with rx nbufs
  *			       called during dp rx initialization
@@ -907,7 +960,8 @@ QDF_STATUS __dp_rx_buffers_replenish(struct dp_soc *dp_soc, uint32_t mac_id,
 	dp_rx_refill_ring_record_entry(dp_soc, dp_pdev->lmac_id, rxdma_srng,
 				       num_req_buffers, count);
 
-	hal_srng_access_end(dp_soc->hal_soc, rxdma_srng);
+	dp_rx_refill_ring_access_end(dp_soc, dp_pdev->lmac_id, dp_rxdma_srng,
+				     count);
 
 	dp_rx_schedule_refill_thread(dp_soc);
 
@@ -1114,6 +1114,28 @@ void dp_2k_jump_handle(struct dp_soc *soc, qdf_nbuf_t nbuf, uint8_t *rx_tlv_hdr,
 		qdf_nbuf_set_next((ptail), NULL);                     \
 	} while (0)
 
+/**
+ * dp_rx_nbuf_unmap_single() - Unmap an rx nbuf, or hand it to the CPU when
+ *			       it is DMA mapped by a page pool
+ * @osdev: qdf device handle
+ * @nbuf: rx nbuf
+ * @dir: DMA direction the nbuf was mapped with
+ * @buf_size: mapped size
+ *
+ * Return: none
+ */
+static inline
+void dp_rx_nbuf_unmap_single(qdf_device_t osdev, qdf_nbuf_t nbuf,
+			     qdf_dma_dir_t dir, uint32_t buf_size)
+{
+	if (qdf_nbuf_is_page_pool(nbuf)) {
+		qdf_nbuf_page_pool_sync_for_cpu(osdev, nbuf, buf_size);
+		return;
+	}
+
+	qdf_nbuf_unmap_nbytes_single(osdev, nbuf, dir, buf_size);
+}
+
 #if defined(QCA_PADDR_CHECK_ON_3TH_PLATFORM)
 /*
  * on some third-party platform, the memory below 0x2000
@@ -1172,10 +1194,10 @@ int dp_check_paddr(struct dp_soc *dp_soc,
 			 *.Add such buffer to invalid list and free
 			 *.them when driver unload.
 			 **/
-			qdf_nbuf_unmap_nbytes_single(dp_soc->osdev,
-						     *rx_netbuf,
-						     QDF_DMA_FROM_DEVICE,
-						     rx_desc_pool->buf_size);
+			dp_rx_nbuf_unmap_single(dp_soc->osdev,
+						*rx_netbuf,
+						QDF_DMA_FROM_DEVICE,
+						rx_desc_pool->buf_size);
 			qdf_nbuf_queue_add(&dp_soc->invalid_buf_queue,
 					   *rx_netbuf);
 		}
@@ -1941,6 +1963,61 @@ dp_rx_srng_access_end(struct dp_intr *int_ctx, struct dp_soc *soc,
 }
 #endif
 
+#ifdef QCA_DP_RX_HW_SW_NBUF_DESC_PREFETCH
+/* HW descs are already prefetched along with their SW descs and nbufs */
+#define DP_RX_SRNG_BATCH_PREFETCH_DEPTH 0
+#else
+#define DP_RX_SRNG_BATCH_PREFETCH_DEPTH HAL_SRNG_BATCH_PREFETCH_DEPTH
+#endif
+
+/*
+ * dp_rx_srng_batch_begin()- Begin a batched walk of a rx destination ring
+ * @soc - DP soc structure pointer
+ * @hal_ring_hdl - HAL ring handle
+ * @batch - batch context
+ * @max_entries - maximum number of descriptors to reap
+ *
+ * Return - number of descriptors in the batch
+ */
+static inline uint32_t
+dp_rx_srng_batch_begin(struct dp_soc *soc, hal_ring_handle_t hal_ring_hdl,
+		       struct hal_srng_dst_batch *batch, uint32_t max_entries)
+{
+	return hal_srng_dst_batch_begin(soc->hal_soc, hal_ring_hdl, batch,
+					max_entries,
+					DP_RX_SRNG_BATCH_PREFETCH_DEPTH);
+}
+
+/*
+ * dp_rx_srng_batch_get_next()- Get next descriptor of a batched walk
+ * @soc - DP soc structure pointer
+ * @hal_ring_hdl - HAL ring handle
+ * @batch - batch context
+ *
+ * Return - ring descriptor, NULL once the batch is exhausted
+ */
+static inline hal_ring_desc_t
+dp_rx_srng_batch_get_next(struct dp_soc *soc, hal_ring_handle_t hal_ring_hdl,
+			  struct hal_srng_dst_batch *batch)
+{
+	return hal_srng_dst_batch_get_next(soc->hal_soc, hal_ring_hdl, batch);
+}
+
+/*
+ * dp_rx_srng_batch_end()- End a batched walk of a rx destination ring
+ * @soc - DP soc structure pointer
+ * @hal_ring_hdl - HAL ring handle
+ * @batch - batch context
+ *
+ * Return - number of descriptors reaped in the batch
+ */
+static inline uint32_t
+dp_rx_srng_batch_end(struct dp_soc *soc, hal_ring_handle_t hal_ring_hdl,
+		     struct hal_srng_dst_batch *batch)
+{
+	return hal_srng_dst_batch_end(soc->hal_soc, hal_ring_hdl, batch);
+}
+
 #endif /* QCA_HOST_MODE_WIFI_DISABLED */
 
 /*
@@ -2651,9 +2728,9 @@ void dp_rx_nbuf_unmap(struct dp_soc *soc,
 	dp_ipa_handle_rx_buf_smmu_mapping(soc, rx_desc->nbuf,
 					  rx_desc_pool->buf_size,
 					  false, __func__, __LINE__);
-	qdf_nbuf_unmap_nbytes_single(soc->osdev, rx_desc->nbuf,
-				     QDF_DMA_FROM_DEVICE,
-				     rx_desc_pool->buf_size);
+	dp_rx_nbuf_unmap_single(soc->osdev, rx_desc->nbuf,
+				QDF_DMA_FROM_DEVICE,
+				rx_desc_pool->buf_size);
 	rx_desc->unmapped = 1;
 
 	dp_ipa_reo_ctx_buf_mapping_unlock(soc, reo_ring_num);
@@ -2669,8 +2746,8 @@ void dp_rx_nbuf_unmap_pool(struct dp_soc *soc,
 	dp_ipa_handle_rx_buf_smmu_mapping(soc, nbuf,
 					  rx_desc_pool->buf_size,
 					  false, __func__, __LINE__);
-	qdf_nbuf_unmap_nbytes_single(soc->osdev, nbuf, QDF_DMA_FROM_DEVICE,
-				     rx_desc_pool->buf_size);
+	dp_rx_nbuf_unmap_single(soc->osdev, nbuf, QDF_DMA_FROM_DEVICE,
+				rx_desc_pool->buf_size);
 }
 
 static inline
@@ -101,9 +101,13 @@ void dp_rx_buffer_pool_nbuf_free(struct dp_soc *soc, qdf_nbuf_t nbuf, u8 mac_id)
 	rx_desc_pool = &soc->rx_desc_buf[mac_id];
 	buff_pool = &soc->rx_buff_pool[mac_id];
 
+	/*
+	 * Page pool nbufs go back to their pool, which keeps them mapped and
+	 * syncs them for the device.
+	 */
 	if (qdf_likely(qdf_nbuf_queue_head_qlen(&buff_pool->emerg_nbuf_q) >=
 		       DP_RX_BUFFER_POOL_SIZE) ||
-	    !buff_pool->is_initialized)
+	    !buff_pool->is_initialized || qdf_nbuf_is_page_pool(nbuf))
 		return qdf_nbuf_free(nbuf);
 
 	qdf_nbuf_reset(nbuf, RX_BUFFER_RESERVATION,
@@ -111,13 +115,64 @@ void dp_rx_buffer_pool_nbuf_free(struct dp_soc *soc, qdf_nbuf_t nbuf, u8 mac_id)
 	qdf_nbuf_queue_head_enqueue_tail(&buff_pool->emerg_nbuf_q, nbuf);
 }
 
+/**
+ * dp_rx_refill_buff_pool_nbuf_alloc() - Allocate a DMA mapped refill buffer
+ * @soc: DP SOC handle
+ * @buff_pool: RX refill buffer pool
+ * @rx_desc_pool: RX descriptor pool the buffers are sized for
+ *
+ * Buffers come from the pool's page pool when there is one, so a page
+ * recycled by the stack is handed out again without allocation or IOMMU
+ * mapping. Otherwise a new nbuf is allocated and mapped.
+ *
+ * Return: mapped nbuf or NULL
+ */
+static qdf_nbuf_t
+dp_rx_refill_buff_pool_nbuf_alloc(struct dp_soc *soc,
+				  struct rx_refill_buff_pool *buff_pool,
+				  struct rx_desc_pool *rx_desc_pool)
+{
+	qdf_device_t dev = soc->osdev;
+	qdf_nbuf_t nbuf;
+	QDF_STATUS ret;
+
+	if (buff_pool->pp) {
+		nbuf = qdf_nbuf_page_pool_alloc(dev, buff_pool->pp,
+						rx_desc_pool->buf_size,
+						RX_BUFFER_RESERVATION,
+						rx_desc_pool->buf_alignment);
+		if (qdf_likely(nbuf))
+			goto mapped;
+	}
+
+	nbuf = qdf_nbuf_alloc(dev, rx_desc_pool->buf_size,
+			      RX_BUFFER_RESERVATION,
+			      rx_desc_pool->buf_alignment, FALSE);
+	if (qdf_unlikely(!nbuf))
+		return NULL;
+
+	ret = qdf_nbuf_map_nbytes_single(dev, nbuf, QDF_DMA_FROM_DEVICE,
+					 rx_desc_pool->buf_size);
+	if (qdf_unlikely(QDF_IS_STATUS_ERROR(ret))) {
+		qdf_nbuf_free(nbuf);
+		return NULL;
+	}
+
+mapped:
+	dp_audio_smmu_map(dev,
+			  qdf_mem_paddr_from_dmaaddr(dev,
+						     QDF_NBUF_CB_PADDR(nbuf)),
+			  QDF_NBUF_CB_PADDR(nbuf),
+			  rx_desc_pool->buf_size);
+
+	return nbuf;
+}
+
 void dp_rx_refill_buff_pool_enqueue(struct dp_soc *soc)
 {
 	struct rx_desc_pool *rx_desc_pool;
 	struct rx_refill_buff_pool *buff_pool;
-	qdf_device_t dev;
 	qdf_nbuf_t nbuf;
-	QDF_STATUS ret;
 	int count, i;
 	uint16_t num_refill;
 	uint16_t total_num_refill;
@@ -127,7 +182,6 @@ void dp_rx_refill_buff_pool_enqueue(struct dp_soc *soc)
 	if (!soc)
 		return;
 
-	dev = soc->osdev;
 	buff_pool = &soc->rx_refill_buff_pool;
 	rx_desc_pool = &soc->rx_desc_buf[0];
 	if (!buff_pool->is_initialized)
@@ -149,27 +203,11 @@ void dp_rx_refill_buff_pool_enqueue(struct dp_soc *soc)
 
 		count = 0;
 		for (i = 0; i < num_refill; i++) {
-			nbuf = qdf_nbuf_alloc(dev, rx_desc_pool->buf_size,
-					      RX_BUFFER_RESERVATION,
-					      rx_desc_pool->buf_alignment,
-					      FALSE);
+			nbuf = dp_rx_refill_buff_pool_nbuf_alloc(soc, buff_pool,
+								 rx_desc_pool);
 			if (qdf_unlikely(!nbuf))
 				continue;
 
-			ret = qdf_nbuf_map_nbytes_single(dev, nbuf,
-							 QDF_DMA_FROM_DEVICE,
-							 rx_desc_pool->buf_size);
-			if (qdf_unlikely(QDF_IS_STATUS_ERROR(ret))) {
-				qdf_nbuf_free(nbuf);
-				continue;
-			}
-
-			dp_audio_smmu_map(dev,
-					  qdf_mem_paddr_from_dmaaddr(dev,
-								     QDF_NBUF_CB_PADDR(nbuf)),
-					  QDF_NBUF_CB_PADDR(nbuf),
-					  rx_desc_pool->buf_size);
-
 			buff_pool->buf_elem[head++] = nbuf;
 			head &= (buff_pool->max_bufq_len - 1);
 			count++;
@@ -285,7 +323,6 @@ static void dp_rx_refill_buff_pool_init(struct dp_soc *soc, u8 mac_id)
 	struct rx_desc_pool *rx_desc_pool = &soc->rx_desc_buf[mac_id];
 	qdf_nbuf_t nbuf;
 	struct rx_refill_buff_pool *buff_pool = &soc->rx_refill_buff_pool;
-	QDF_STATUS ret;
 	uint16_t head = 0;
 	int i;
 
@@ -299,37 +336,24 @@ static void dp_rx_refill_buff_pool_init(struct dp_soc *soc, u8 mac_id)
 		wlan_cfg_get_rx_refill_buf_pool_size(soc->wlan_cfg_ctx);
 	buff_pool->dp_pdev = dp_get_pdev_for_lmac_id(soc, 0);
 	buff_pool->tail = 0;
+	buff_pool->pp = qdf_nbuf_page_pool_create(soc->osdev,
+						  buff_pool->max_bufq_len);
 
 	for (i = 0; i < (buff_pool->max_bufq_len - 1); i++) {
-		nbuf = qdf_nbuf_alloc(soc->osdev, rx_desc_pool->buf_size,
-				      RX_BUFFER_RESERVATION,
-				      rx_desc_pool->buf_alignment, FALSE);
+		nbuf = dp_rx_refill_buff_pool_nbuf_alloc(soc, buff_pool,
+							 rx_desc_pool);
 		if (!nbuf)
 			continue;
 
-		ret = qdf_nbuf_map_nbytes_single(soc->osdev, nbuf,
-						 QDF_DMA_FROM_DEVICE,
-						 rx_desc_pool->buf_size);
-		if (qdf_unlikely(QDF_IS_STATUS_ERROR(ret))) {
-			qdf_nbuf_free(nbuf);
-			continue;
-		}
-
-		dp_audio_smmu_map(soc->osdev,
-				  qdf_mem_paddr_from_dmaaddr(soc->osdev,
-							     QDF_NBUF_CB_PADDR(nbuf)),
-				  QDF_NBUF_CB_PADDR(nbuf),
-				  rx_desc_pool->buf_size);
-
 		buff_pool->buf_elem[head] = nbuf;
 		head++;
 	}
 
 	buff_pool->head =  head;
 
-	dp_info("RX refill buffer pool required allocation: %u actual allocation: %u",
+	dp_info("RX refill buffer pool required allocation: %u actual allocation: %u page pool: %d",
 		buff_pool->max_bufq_len,
-		buff_pool->head);
+		buff_pool->head, !!buff_pool->pp);
 
 	buff_pool->is_initialized = true;
 }
@@ -385,9 +409,9 @@ static void dp_rx_refill_buff_pool_deinit(struct dp_soc *soc, u8 mac_id)
 		dp_audio_smmu_unmap(soc->osdev,
 				    QDF_NBUF_CB_PADDR(nbuf),
 				    rx_desc_pool->buf_size);
-		qdf_nbuf_unmap_nbytes_single(soc->osdev, nbuf,
-					     QDF_DMA_BIDIRECTIONAL,
-					     rx_desc_pool->buf_size);
+		dp_rx_nbuf_unmap_single(soc->osdev, nbuf,
+					QDF_DMA_BIDIRECTIONAL,
+					rx_desc_pool->buf_size);
 		qdf_nbuf_free(nbuf);
 		count++;
 	}
@@ -395,6 +419,11 @@ static void dp_rx_refill_buff_pool_deinit(struct dp_soc *soc, u8 mac_id)
 	dp_info("Rx refill buffers freed during deinit %u head: %u, tail: %u",
 		count, buff_pool->head, buff_pool->tail);
 
+	if (buff_pool->pp) {
+		qdf_nbuf_page_pool_destroy(buff_pool->pp);
+		buff_pool->pp = NULL;
+	}
+
 	buff_pool->is_initialized = false;
 }
 
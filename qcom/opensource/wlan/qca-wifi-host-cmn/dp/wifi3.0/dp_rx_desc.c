@@ -230,8 +230,8 @@ static void dp_rx_desc_nbuf_cleanup(struct dp_soc *soc,
 						__LINE__))
 			dp_info_rl("Unable to unmap nbuf: %pK", nbuf);
 
-		qdf_nbuf_unmap_nbytes_single(soc->osdev, nbuf,
-					     QDF_DMA_BIDIRECTIONAL, buf_size);
+		dp_rx_nbuf_unmap_single(soc->osdev, nbuf,
+					QDF_DMA_BIDIRECTIONAL, buf_size);
 		dp_rx_nbuf_free(nbuf);
 		nbuf = next;
 	}
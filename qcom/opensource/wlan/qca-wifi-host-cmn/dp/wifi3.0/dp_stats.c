@@ -7757,6 +7757,19 @@ void dp_print_tx_ppeds_stats(struct dp_soc *soc)
 }
 #endif
 
+#if defined(WLAN_FEATURE_11BE_MLO) && defined(WLAN_MLO_MULTI_CHIP) && \
+	defined(DP_MLO_TX_LINK_STEER)
+static void dp_print_tx_mlo_steer_stats(struct dp_soc *soc)
+{
+	if (soc->arch_ops.print_mlo_tx_steer_stats)
+		soc->arch_ops.print_mlo_tx_steer_stats(soc);
+}
+#else
+static inline void dp_print_tx_mlo_steer_stats(struct dp_soc *soc)
+{
+}
+#endif
+
 void
 dp_print_soc_tx_stats(struct dp_soc *soc)
 {
@@ -7801,6 +7814,7 @@ dp_print_soc_tx_stats(struct dp_soc *soc)
 	DP_PRINT_STATS("Tx comp HP out of sync2 = %d",
 		       soc->stats.tx.hp_oos2);
 	dp_print_tx_ppeds_stats(soc);
+	dp_print_tx_mlo_steer_stats(soc);
 }
 
 static
@@ -9122,6 +9136,53 @@ dp_txrx_get_peer_delay_stats(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 
 	return QDF_STATUS_SUCCESS;
 }
+
+QDF_STATUS
+dp_txrx_get_peer_delay_percentiles(struct cdp_soc_t *soc_hdl,
+				   uint8_t vdev_id, uint8_t *peer_mac,
+				   struct cdp_delay_tid_percentiles *pct)
+{
+	struct cdp_delay_tid_stats *delay_stats;
+	QDF_STATUS status;
+	uint8_t tid;
+
+	delay_stats = qdf_mem_malloc(sizeof(*delay_stats) *
+				     CDP_MAX_DATA_TIDS);
+	if (!delay_stats)
+		return QDF_STATUS_E_NOMEM;
+
+	status = dp_txrx_get_peer_delay_stats(soc_hdl, vdev_id, peer_mac,
+					      delay_stats);
+	if (QDF_IS_STATUS_ERROR(status))
+		goto out;
+
+	for (tid = 0; tid < CDP_MAX_DATA_TIDS; tid++) {
+		dp_hist_compute_percentiles(
+				&delay_stats[tid].tx_delay.tx_swq_delay,
+				CDP_HIST_TYPE_SW_ENQEUE_DELAY,
+				&pct[tid].tx_swq_delay);
+		dp_hist_compute_percentiles(
+				&delay_stats[tid].tx_delay.hwtx_delay,
+				CDP_HIST_TYPE_HW_COMP_DELAY,
+				&pct[tid].hwtx_delay);
+		dp_hist_compute_percentiles(
+				&delay_stats[tid].rx_delay.to_stack_delay,
+				CDP_HIST_TYPE_REAP_STACK,
+				&pct[tid].to_stack_delay);
+	}
+
+out:
+	qdf_mem_free(delay_stats);
+	return status;
+}
+
+QDF_STATUS
+dp_txrx_set_delay_hist_buckets(struct cdp_soc_t *soc_hdl,
+			       enum cdp_hist_types hist_type,
+			       const uint16_t *bounds)
+{
+	return dp_hist_set_buckets(hist_type, bounds);
+}
 #else
 QDF_STATUS
 dp_txrx_get_peer_delay_stats(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
@@ -9130,6 +9191,22 @@ dp_txrx_get_peer_delay_stats(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 {
 	return QDF_STATUS_E_FAILURE;
 }
+
+QDF_STATUS
+dp_txrx_get_peer_delay_percentiles(struct cdp_soc_t *soc_hdl,
+				   uint8_t vdev_id, uint8_t *peer_mac,
+				   struct cdp_delay_tid_percentiles *pct)
+{
+	return QDF_STATUS_E_FAILURE;
+}
+
+QDF_STATUS
+dp_txrx_set_delay_hist_buckets(struct cdp_soc_t *soc_hdl,
+			       enum cdp_hist_types hist_type,
+			       const uint16_t *bounds)
+{
+	return QDF_STATUS_E_FAILURE;
+}
 #endif /* QCA_PEER_EXT_STATS */
 
 #ifdef WLAN_PEER_JITTER
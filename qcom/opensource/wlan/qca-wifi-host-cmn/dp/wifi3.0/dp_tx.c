@@ -1660,6 +1660,204 @@ dp_tx_ring_access_end_wrapper(struct dp_soc *soc,
 		dp_runtime_put(soc);
 	}
 }
+
+#ifdef DP_TX_RTPM_HOLD
+/* Max time the oldest held frame waits before a resume is requested */
+#define DP_TX_RTPM_HOLD_TIMEOUT_MS 100
+/* Max frames batched before the link is woken up right away */
+#define DP_TX_RTPM_HOLD_MAX_FRAMES 128
+/* Highest TID treated as low priority (BE/BK) */
+#define DP_TX_RTPM_HOLD_MAX_TID 3
+
+/**
+ * dp_tx_rtpm_hold_eligible() - Check if a frame may wait for a resume
+ * @nbuf: frame being transmitted
+ * @tid: TID classified for the frame, HTT_TX_EXT_TID_INVALID if none
+ *
+ * Only best effort and background traffic is held. Frames without a
+ * host classified TID use the skb priority; EAPOL, ARP and DHCP frames
+ * are never held since connection setup is latency sensitive.
+ *
+ * Return: true if the frame can be held
+ */
+static bool dp_tx_rtpm_hold_eligible(qdf_nbuf_t nbuf, uint8_t tid)
+{
+	if (tid == HTT_TX_EXT_TID_INVALID) {
+		if (qdf_nbuf_get_priority(nbuf) > DP_TX_RTPM_HOLD_MAX_TID)
+			return false;
+	} else if (tid > DP_TX_RTPM_HOLD_MAX_TID) {
+		return false;
+	}
+
+	if (qdf_unlikely(qdf_nbuf_is_ipv4_eapol_pkt(nbuf) ||
+			 qdf_nbuf_is_ipv4_arp_pkt(nbuf) ||
+			 qdf_nbuf_is_ipv4_dhcp_pkt(nbuf)))
+		return false;
+
+	return true;
+}
+
+/**
+ * dp_tx_rtpm_hold() - Account a frame in the current hold batch
+ * @soc: Datapath soc handle
+ *
+ * The first frame of a batch arms the hold timer. Once the batch limit is
+ * reached the frame is not held and the caller falls back to the regular
+ * path, which requests a resume.
+ *
+ * Return: true if the frame was added to the batch
+ */
+static bool dp_tx_rtpm_hold(struct dp_soc *soc)
+{
+	struct dp_tx_rtpm_hold *hold = &soc->tx_rtpm_hold;
+	bool held = true;
+
+	qdf_spin_lock_bh(&hold->lock);
+	if (hold->num_held >= DP_TX_RTPM_HOLD_MAX_FRAMES) {
+		if (!hold->resume_requested) {
+			hold->resume_requested = true;
+			hold->stats.limit_resumes++;
+		}
+		held = false;
+	} else {
+		if (!hold->num_held++) {
+			hold->start_ts = qdf_system_ticks();
+			qdf_timer_mod(&hold->timer, DP_TX_RTPM_HOLD_TIMEOUT_MS);
+		}
+		hold->stats.held++;
+	}
+	qdf_spin_unlock_bh(&hold->lock);
+
+	return held;
+}
+
+/**
+ * dp_tx_rtpm_hold_timeout() - Hold timer handler
+ * @arg: Datapath soc handle
+ *
+ * Return: None
+ */
+static void dp_tx_rtpm_hold_timeout(void *arg)
+{
+	struct dp_soc *soc = (struct dp_soc *)arg;
+	struct dp_tx_rtpm_hold *hold = &soc->tx_rtpm_hold;
+	bool request = false;
+
+	qdf_spin_lock_bh(&hold->lock);
+	if (hold->num_held && !hold->resume_requested) {
+		hold->resume_requested = true;
+		hold->stats.timer_resumes++;
+		request = true;
+	}
+	qdf_spin_unlock_bh(&hold->lock);
+
+	if (request)
+		hif_rtpm_request_resume();
+}
+
+void
+dp_tx_ring_access_end_wrapper_hold(struct dp_soc *soc,
+				   hal_ring_handle_t hal_ring_hdl,
+				   int coalesce, qdf_nbuf_t nbuf,
+				   uint8_t tid)
+{
+	if (qdf_likely(!nbuf ||
+		       hif_rtpm_get_state() != HIF_RTPM_STATE_SUSPENDED))
+		goto ring_access_end;
+
+	if (!dp_tx_rtpm_hold_eligible(nbuf, tid)) {
+		soc->tx_rtpm_hold.stats.bypassed++;
+		goto ring_access_end;
+	}
+
+	if (!dp_tx_rtpm_hold(soc))
+		goto ring_access_end;
+
+	/*
+	 * Write the descriptor without moving HP and without requesting a
+	 * resume; dp_runtime_resume() flushes the ring once the link is up.
+	 */
+	dp_runtime_get(soc);
+	dp_tx_hal_ring_access_end_reap(soc, hal_ring_hdl);
+	hal_srng_set_event(hal_ring_hdl, HAL_SRNG_FLUSH_EVENT);
+	qdf_atomic_inc(&soc->tx_pending_rtpm);
+	hal_srng_inc_flush_cnt(hal_ring_hdl);
+	dp_runtime_put(soc);
+	return;
+
+ring_access_end:
+	dp_tx_ring_access_end_wrapper(soc, hal_ring_hdl, coalesce);
+}
+
+void dp_tx_rtpm_hold_flush(struct dp_soc *soc)
+{
+	struct dp_tx_rtpm_hold *hold = &soc->tx_rtpm_hold;
+	uint32_t hold_ms;
+	uint8_t bucket;
+
+	qdf_spin_lock_bh(&hold->lock);
+	if (!hold->num_held)
+		goto unlock;
+
+	qdf_timer_stop(&hold->timer);
+	hold_ms = qdf_system_ticks_to_msecs(qdf_system_ticks() -
+					    hold->start_ts);
+	if (hold_ms < 10)
+		bucket = DP_TX_RTPM_HOLD_BUCKET_10MS;
+	else if (hold_ms < 25)
+		bucket = DP_TX_RTPM_HOLD_BUCKET_25MS;
+	else if (hold_ms < 50)
+		bucket = DP_TX_RTPM_HOLD_BUCKET_50MS;
+	else if (hold_ms < 100)
+		bucket = DP_TX_RTPM_HOLD_BUCKET_100MS;
+	else
+		bucket = DP_TX_RTPM_HOLD_BUCKET_MORE;
+	hold->stats.hold_time[bucket]++;
+
+	if (!hold->resume_requested)
+		hold->stats.other_resumes++;
+
+	hold->num_held = 0;
+	hold->resume_requested = false;
+unlock:
+	qdf_spin_unlock_bh(&hold->lock);
+}
+
+void dp_tx_rtpm_hold_init(struct dp_soc *soc)
+{
+	struct dp_tx_rtpm_hold *hold = &soc->tx_rtpm_hold;
+
+	qdf_mem_zero(hold, sizeof(*hold));
+	qdf_spinlock_create(&hold->lock);
+	qdf_timer_init(soc->osdev, &hold->timer, dp_tx_rtpm_hold_timeout,
+		       (void *)soc, QDF_TIMER_TYPE_WAKE_APPS);
+}
+
+void dp_tx_rtpm_hold_deinit(struct dp_soc *soc)
+{
+	struct dp_tx_rtpm_hold *hold = &soc->tx_rtpm_hold;
+
+	qdf_timer_free(&hold->timer);
+	qdf_spinlock_destroy(&hold->lock);
+}
+
+void dp_tx_rtpm_hold_print_stats(struct dp_soc *soc)
+{
+	struct dp_tx_rtpm_hold_stats *stats = &soc->tx_rtpm_hold.stats;
+
+	DP_PRINT_STATS("Tx RTPM hold: held = %u bypassed = %u",
+		       stats->held, stats->bypassed);
+	DP_PRINT_STATS("Tx RTPM hold resumes: timer = %u limit = %u other = %u",
+		       stats->timer_resumes, stats->limit_resumes,
+		       stats->other_resumes);
+	DP_PRINT_STATS("Tx RTPM hold time(ms): <10 = %u <25 = %u <50 = %u <100 = %u >=100 = %u",
+		       stats->hold_time[DP_TX_RTPM_HOLD_BUCKET_10MS],
+		       stats->hold_time[DP_TX_RTPM_HOLD_BUCKET_25MS],
+		       stats->hold_time[DP_TX_RTPM_HOLD_BUCKET_50MS],
+		       stats->hold_time[DP_TX_RTPM_HOLD_BUCKET_100MS],
+		       stats->hold_time[DP_TX_RTPM_HOLD_BUCKET_MORE]);
+}
+#endif /* DP_TX_RTPM_HOLD */
 #else
 
 #ifdef DP_POWER_SAVE
@@ -3626,6 +3824,62 @@ static inline void dp_vdev_tx_mark_to_fw(qdf_nbuf_t nbuf, struct dp_vdev *vdev)
 }
 #endif
 
+#if defined(WLAN_FEATURE_11BE_MLO) && defined(WLAN_MLO_MULTI_CHIP) && \
+	defined(DP_MLO_TX_LINK_STEER)
+/**
+ * dp_tx_mlo_link_steer() - Select the MLO link to send a frame on
+ * @soc: DP soc handle, updated to the soc of the selected link
+ * @vdev: DP vdev the frame was given to
+ * @nbuf: skb
+ *
+ * Return: DP vdev of the link to send the frame on
+ */
+static inline struct dp_vdev *
+dp_tx_mlo_link_steer(struct dp_soc **soc, struct dp_vdev *vdev,
+		     qdf_nbuf_t nbuf)
+{
+	struct dp_vdev *link_vdev;
+
+	if (!(*soc)->arch_ops.dp_tx_link_steer)
+		return vdev;
+
+	link_vdev = (*soc)->arch_ops.dp_tx_link_steer(*soc, vdev, nbuf);
+	if (link_vdev != vdev)
+		*soc = link_vdev->pdev->soc;
+
+	return link_vdev;
+}
+
+/**
+ * dp_tx_mlo_link_steer_comp() - Feed a TX completion to MLO link steering
+ * @soc: DP soc handle
+ * @tx_desc: software TX descriptor
+ * @ts: TX completion status
+ *
+ * Return: None
+ */
+static inline void
+dp_tx_mlo_link_steer_comp(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
+			  struct hal_tx_completion_status *ts)
+{
+	if (soc->arch_ops.dp_tx_link_steer_comp)
+		soc->arch_ops.dp_tx_link_steer_comp(soc, tx_desc, ts);
+}
+#else
+static inline struct dp_vdev *
+dp_tx_mlo_link_steer(struct dp_soc **soc, struct dp_vdev *vdev,
+		     qdf_nbuf_t nbuf)
+{
+	return vdev;
+}
+
+static inline void
+dp_tx_mlo_link_steer_comp(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
+			  struct hal_tx_completion_status *ts)
+{
+}
+#endif
+
 /*
  * dp_tx_send() - Transmit a frame on a given VAP
  * @soc: DP soc handle
@@ -3666,6 +3920,8 @@ qdf_nbuf_t dp_tx_send(struct cdp_soc_t *soc_hdl, uint8_t vdev_id,
 	if (qdf_unlikely(!vdev))
 		return nbuf;
 
+	vdev = dp_tx_mlo_link_steer(&soc, vdev, nbuf);
+
 	dp_vdev_tx_mark_to_fw(nbuf, vdev);
 
 	/*
@@ -4985,18 +5241,21 @@ void dp_send_completion_to_pkt_capture(struct dp_soc *soc,
 #endif
 
 /**
- * dp_tx_comp_process_desc() - Process tx descriptor and free associated nbuf
+ * __dp_tx_comp_process_desc() - Process tx descriptor and release its nbuf
  * @soc: DP Soc handle
  * @tx_desc: software Tx descriptor
  * @ts : Tx completion status from HAL/HTT descriptor
+ * @txrx_peer: txrx peer handle
+ * @delayed_free: return the nbuf to the caller instead of freeing it
  *
- * Return: none
+ * Return: nbuf to be freed by the caller if @delayed_free is set
  */
-void
-dp_tx_comp_process_desc(struct dp_soc *soc,
-			struct dp_tx_desc_s *desc,
-			struct hal_tx_completion_status *ts,
-			struct dp_txrx_peer *txrx_peer)
+static inline qdf_nbuf_t
+__dp_tx_comp_process_desc(struct dp_soc *soc,
+			  struct dp_tx_desc_s *desc,
+			  struct hal_tx_completion_status *ts,
+			  struct dp_txrx_peer *txrx_peer,
+			  bool delayed_free)
 {
 	uint64_t time_latency = 0;
 	uint16_t peer_id = DP_INVALID_PEER_ID;
@@ -5025,7 +5284,7 @@ dp_tx_comp_process_desc(struct dp_soc *soc,
 
 		if (QDF_STATUS_SUCCESS ==
 		    dp_monitor_tx_add_to_comp_queue(soc, desc, ts, peer_id)) {
-			return;
+			return NULL;
 		}
 
 		if (QDF_STATUS_SUCCESS ==
@@ -5039,12 +5298,29 @@ dp_tx_comp_process_desc(struct dp_soc *soc,
 						    ts->peer_id,
 						    ts->ppdu_id,
 						    desc->nbuf);
-			return;
+			return NULL;
 		}
 	}
 
 	desc->flags |= DP_TX_DESC_FLAG_COMPLETED_TX;
-	dp_tx_comp_free_buf(soc, desc, false);
+	return dp_tx_comp_free_buf(soc, desc, delayed_free);
+}
+
+/**
+ * dp_tx_comp_process_desc() - Process tx descriptor and free associated nbuf
+ * @soc: DP Soc handle
+ * @tx_desc: software Tx descriptor
+ * @ts : Tx completion status from HAL/HTT descriptor
+ *
+ * Return: none
+ */
+void
+dp_tx_comp_process_desc(struct dp_soc *soc,
+			struct dp_tx_desc_s *desc,
+			struct hal_tx_completion_status *ts,
+			struct dp_txrx_peer *txrx_peer)
+{
+	__dp_tx_comp_process_desc(soc, desc, ts, txrx_peer, false);
 }
 
 #ifdef DISABLE_DP_STATS
@@ -5386,6 +5662,7 @@ void dp_tx_comp_process_tx_status(struct dp_soc *soc,
 	op_mode = vdev->qdf_opmode;
 	dp_tx_update_connectivity_stats(soc, vdev, tx_desc, ts->status);
 	dp_tx_update_uplink_delay(soc, vdev, ts);
+	dp_tx_mlo_link_steer_comp(soc, tx_desc, ts);
 
 	/* check tx complete notification */
 	if (qdf_nbuf_tx_notify_comp_get(nbuf))
@@ -5600,6 +5877,7 @@ dp_tx_nbuf_dev_kfree_list(qdf_nbuf_queue_head_t *nbuf_queue_head)
 static inline void
 dp_tx_nbuf_queue_head_init(qdf_nbuf_queue_head_t *nbuf_queue_head)
 {
+	qdf_nbuf_queue_head_init(nbuf_queue_head);
 }
 
 static inline void
@@ -5612,6 +5890,7 @@ dp_tx_nbuf_dev_queue_free(qdf_nbuf_queue_head_t *nbuf_queue_head,
 static inline void
 dp_tx_nbuf_dev_kfree_list(qdf_nbuf_queue_head_t *nbuf_queue_head)
 {
+	qdf_nbuf_dev_kfree_list(nbuf_queue_head);
 }
 #endif
 
@@ -5637,6 +5916,11 @@ dp_tx_comp_process_desc_list(struct dp_soc *soc,
 	uint16_t peer_id = DP_INVALID_PEER;
 	dp_txrx_ref_handle txrx_ref_handle = NULL;
 	qdf_nbuf_queue_head_t h;
+	struct dp_tx_desc_s *free_head = NULL;
+	struct dp_tx_desc_s *free_tail = NULL;
+	uint16_t free_cnt = 0;
+	uint8_t free_pool_id = 0;
+	qdf_nbuf_t nbuf;
 
 	desc = comp_head;
 
@@ -5693,7 +5977,24 @@ dp_tx_comp_process_desc_list(struct dp_soc *soc,
 					       desc->id, DP_TX_COMP_UNMAP);
 			dp_tx_nbuf_unmap(soc, desc);
 			dp_tx_nbuf_dev_queue_free(&h, desc);
-			dp_tx_desc_free(soc, desc, desc->pool_id);
+
+			/*
+			 * Return descriptors to their pool in runs so the
+			 * pool lock is taken once per run, not per packet.
+			 */
+			if (free_cnt && free_pool_id != desc->pool_id) {
+				dp_tx_desc_free_list(soc, free_head, free_tail,
+						     free_cnt, free_pool_id);
+				free_cnt = 0;
+			}
+			if (!free_cnt) {
+				free_head = desc;
+				free_pool_id = desc->pool_id;
+			} else {
+				free_tail->next = desc;
+			}
+			free_tail = desc;
+			free_cnt++;
 			desc = next;
 			continue;
 		}
@@ -5703,11 +6004,18 @@ dp_tx_comp_process_desc_list(struct dp_soc *soc,
 		dp_tx_comp_process_tx_status(soc, desc, &ts, txrx_peer,
 					     ring_id);
 
-		dp_tx_comp_process_desc(soc, desc, &ts, txrx_peer);
+		/* Completed nbufs are bulk freed once the list is walked */
+		nbuf = __dp_tx_comp_process_desc(soc, desc, &ts, txrx_peer,
+						 true);
+		if (nbuf)
+			qdf_nbuf_dev_queue_head(&h, nbuf);
 
 		dp_tx_desc_release(desc, desc->pool_id);
 		desc = next;
 	}
+	if (free_cnt)
+		dp_tx_desc_free_list(soc, free_head, free_tail, free_cnt,
+				     free_pool_id);
 	dp_tx_nbuf_dev_kfree_list(&h);
 	if (txrx_peer)
 		dp_txrx_peer_unref_delete(txrx_ref_handle, DP_MOD_ID_TX_COMP);
@@ -923,8 +923,90 @@ dp_set_rtpm_tput_policy_requirement(struct cdp_soc_t *soc_hdl,
 				    bool is_high_tput)
 { }
 #endif
+
+#if defined(FEATURE_RUNTIME_PM) && defined(DP_TX_RTPM_HOLD)
+/**
+ * dp_tx_ring_access_end_wrapper_hold() - Ring access end with TX hold
+ * @soc: Datapath soc handle
+ * @hal_ring_hdl: HAL ring handle
+ * @coalesce: Coalesce the current write or not
+ * @nbuf: frame written to the ring, NULL if the write failed
+ * @tid: TID of the frame, HTT_TX_EXT_TID_INVALID if not classified
+ *
+ * While the link is runtime suspended, low priority frames are written
+ * to the ring without requesting a resume. The batch is flushed by the
+ * next resume, which is requested at the latest after a bounded delay.
+ * All other frames take dp_tx_ring_access_end_wrapper().
+ *
+ * Return: none
+ */
+void
+dp_tx_ring_access_end_wrapper_hold(struct dp_soc *soc,
+				   hal_ring_handle_t hal_ring_hdl,
+				   int coalesce, qdf_nbuf_t nbuf,
+				   uint8_t tid);
+#else
+static inline void
+dp_tx_ring_access_end_wrapper_hold(struct dp_soc *soc,
+				   hal_ring_handle_t hal_ring_hdl,
+				   int coalesce, qdf_nbuf_t nbuf,
+				   uint8_t tid)
+{
+	dp_tx_ring_access_end_wrapper(soc, hal_ring_hdl, coalesce);
+}
+#endif
 #endif /* QCA_HOST_MODE_WIFI_DISABLED */
 
+#if defined(FEATURE_RUNTIME_PM) && defined(DP_TX_RTPM_HOLD)
+/**
+ * dp_tx_rtpm_hold_flush() - Close the current TX hold batch on resume
+ * @soc: Datapath soc handle
+ *
+ * Return: none
+ */
+void dp_tx_rtpm_hold_flush(struct dp_soc *soc);
+
+/**
+ * dp_tx_rtpm_hold_init() - Initialize TX runtime PM hold state
+ * @soc: Datapath soc handle
+ *
+ * Return: none
+ */
+void dp_tx_rtpm_hold_init(struct dp_soc *soc);
+
+/**
+ * dp_tx_rtpm_hold_deinit() - Deinitialize TX runtime PM hold state
+ * @soc: Datapath soc handle
+ *
+ * Return: none
+ */
+void dp_tx_rtpm_hold_deinit(struct dp_soc *soc);
+
+/**
+ * dp_tx_rtpm_hold_print_stats() - Print TX runtime PM hold stats
+ * @soc: Datapath soc handle
+ *
+ * Return: none
+ */
+void dp_tx_rtpm_hold_print_stats(struct dp_soc *soc);
+#else
+static inline void dp_tx_rtpm_hold_flush(struct dp_soc *soc)
+{
+}
+
+static inline void dp_tx_rtpm_hold_init(struct dp_soc *soc)
+{
+}
+
+static inline void dp_tx_rtpm_hold_deinit(struct dp_soc *soc)
+{
+}
+
+static inline void dp_tx_rtpm_hold_print_stats(struct dp_soc *soc)
+{
+}
+#endif
+
 #ifdef DP_TX_HW_DESC_HISTORY
 static inline void
 dp_tx_hw_desc_update_evt(uint8_t *hal_tx_desc_cached,
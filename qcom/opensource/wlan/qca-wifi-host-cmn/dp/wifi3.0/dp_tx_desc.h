@@ -390,29 +390,26 @@ dp_tx_desc_alloc(struct dp_soc *soc, uint8_t desc_pool_id)
 }
 
 /**
- * dp_tx_desc_free() - Fee a tx descriptor and attach it to free list
+ * dp_tx_flow_pool_resume() - Wake netif queues as descriptors are returned
  *
  * @soc: Handle to DP SoC structure
- * @tx_desc: the tx descriptor to be freed
- * @desc_pool_id: ID of the flow control fool
+ * @pool: flow pool descriptors were returned to
+ * @desc_pool_id: ID of the flow control pool
+ * @unpause_time: timestamp used for the pause duration statistics
  *
- * Return: None
+ * Must be called with the flow pool lock held. Advances the pool by at most
+ * one pause level per call.
+ *
+ * Return: true if the pool was freed, in which case the lock is released
  */
-static inline void
-dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
-		uint8_t desc_pool_id)
+static inline bool
+dp_tx_flow_pool_resume(struct dp_soc *soc, struct dp_tx_desc_pool_s *pool,
+		       uint8_t desc_pool_id, qdf_time_t unpause_time)
 {
-	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
-	qdf_time_t unpause_time = qdf_get_system_timestamp(), pause_dur;
+	qdf_time_t pause_dur;
 	enum netif_action_type act = WLAN_WAKE_ALL_NETIF_QUEUE;
 	enum netif_reason_type reason;
 
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
-	tx_desc->vdev_id = DP_INVALID_VDEV_ID;
-	tx_desc->nbuf = NULL;
-	tx_desc->flags = 0;
-	dp_tx_desc_set_magic(tx_desc, DP_TX_MAGIC_PATTERN_FREE);
-	dp_tx_put_desc_flow_pool(pool, tx_desc);
 	switch (pool->status) {
 	case FLOW_POOL_ACTIVE_PAUSED:
 		if (pool->avail_desc > pool->start_th[DP_TH_HI]) {
@@ -474,7 +471,7 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 			QDF_TRACE(QDF_MODULE_ID_DP, QDF_TRACE_LEVEL_ERROR,
 				  "%s %d pool is freed!!",
 				  __func__, __LINE__);
-			return;
+			return true;
 		}
 		break;
 
@@ -490,6 +487,82 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	if (act != WLAN_WAKE_ALL_NETIF_QUEUE)
 		soc->pause_cb(pool->flow_pool_id,
 			      act, reason);
+
+	return false;
+}
+
+/**
+ * dp_tx_desc_free() - Fee a tx descriptor and attach it to free list
+ *
+ * @soc: Handle to DP SoC structure
+ * @tx_desc: the tx descriptor to be freed
+ * @desc_pool_id: ID of the flow control fool
+ *
+ * Return: None
+ */
+static inline void
+dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
+		uint8_t desc_pool_id)
+{
+	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
+	qdf_time_t unpause_time = qdf_get_system_timestamp();
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	tx_desc->vdev_id = DP_INVALID_VDEV_ID;
+	tx_desc->nbuf = NULL;
+	tx_desc->flags = 0;
+	dp_tx_desc_set_magic(tx_desc, DP_TX_MAGIC_PATTERN_FREE);
+	dp_tx_put_desc_flow_pool(pool, tx_desc);
+	if (dp_tx_flow_pool_resume(soc, pool, desc_pool_id, unpause_time))
+		return;
+	qdf_spin_unlock_bh(&pool->flow_pool_lock);
+}
+
+/**
+ * dp_tx_desc_free_list() - Free a chain of tx descriptors to a flow pool
+ *
+ * @soc: Handle to DP SoC structure
+ * @head: first descriptor of the chain, linked through next
+ * @tail: last descriptor of the chain
+ * @count: number of descriptors in the chain
+ * @desc_pool_id: ID of the flow control pool all descriptors belong to
+ *
+ * Batched dp_tx_desc_free() for the tx completion path. The chain is put
+ * back under a single flow pool lock acquisition and the queue wake-up
+ * levels are then stepped until no further start threshold is crossed,
+ * so the AC thresholds observe the same avail_desc as with single frees.
+ *
+ * Return: None
+ */
+static inline void
+dp_tx_desc_free_list(struct dp_soc *soc, struct dp_tx_desc_s *head,
+		     struct dp_tx_desc_s *tail, uint16_t count,
+		     uint8_t desc_pool_id)
+{
+	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
+	qdf_time_t unpause_time = qdf_get_system_timestamp();
+	struct dp_tx_desc_s *tx_desc;
+	enum flow_pool_status status;
+
+	for (tx_desc = head; ; tx_desc = tx_desc->next) {
+		tx_desc->vdev_id = DP_INVALID_VDEV_ID;
+		tx_desc->nbuf = NULL;
+		tx_desc->flags = 0;
+		dp_tx_desc_set_magic(tx_desc, DP_TX_MAGIC_PATTERN_FREE);
+		if (tx_desc == tail)
+			break;
+	}
+
+	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	tail->next = pool->freelist;
+	pool->freelist = head;
+	pool->avail_desc += count;
+	do {
+		status = pool->status;
+		if (dp_tx_flow_pool_resume(soc, pool, desc_pool_id,
+					   unpause_time))
+			return;
+	} while (pool->status != status);
 	qdf_spin_unlock_bh(&pool->flow_pool_lock);
 }
 #else /* QCA_AC_BASED_FLOW_CONTROL */
@@ -599,6 +672,32 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	qdf_spin_unlock_bh(&pool->flow_pool_lock);
 }
 
+/**
+ * dp_tx_desc_free_list() - Free a chain of tx descriptors to a flow pool
+ *
+ * @soc: Handle to DP SoC structure
+ * @head: first descriptor of the chain, linked through next
+ * @tail: last descriptor of the chain
+ * @count: number of descriptors in the chain
+ * @desc_pool_id: ID of the flow control pool all descriptors belong to
+ *
+ * Return: None
+ */
+static inline void
+dp_tx_desc_free_list(struct dp_soc *soc, struct dp_tx_desc_s *head,
+		     struct dp_tx_desc_s *tail, uint16_t count,
+		     uint8_t desc_pool_id)
+{
+	struct dp_tx_desc_s *tx_desc = head;
+	struct dp_tx_desc_s *next;
+
+	while (count--) {
+		next = tx_desc->next;
+		dp_tx_desc_free(soc, tx_desc, desc_pool_id);
+		tx_desc = next;
+	}
+}
+
 #endif /* QCA_AC_BASED_FLOW_CONTROL */
 
 static inline bool
@@ -765,6 +864,41 @@ dp_tx_desc_free(struct dp_soc *soc, struct dp_tx_desc_s *tx_desc,
 	TX_DESC_LOCK_UNLOCK(&pool->lock);
 }
 
+/**
+ * dp_tx_desc_free_list() - Free a chain of tx descriptors to the pool
+ *
+ * @soc: Handle to DP SoC structure
+ * @head: first descriptor of the chain, linked through next
+ * @tail: last descriptor of the chain
+ * @count: number of descriptors in the chain
+ * @desc_pool_id: pool all descriptors belong to
+ *
+ * Return: None
+ */
+static inline void
+dp_tx_desc_free_list(struct dp_soc *soc, struct dp_tx_desc_s *head,
+		     struct dp_tx_desc_s *tail, uint16_t count,
+		     uint8_t desc_pool_id)
+{
+	struct dp_tx_desc_pool_s *pool = &soc->tx_desc[desc_pool_id];
+	struct dp_tx_desc_s *tx_desc;
+
+	for (tx_desc = head; ; tx_desc = tx_desc->next) {
+		tx_desc->vdev_id = DP_INVALID_VDEV_ID;
+		tx_desc->nbuf = NULL;
+		tx_desc->flags = 0;
+		if (tx_desc == tail)
+			break;
+	}
+
+	TX_DESC_LOCK_LOCK(&pool->lock);
+	tail->next = pool->freelist;
+	pool->freelist = head;
+	pool->num_allocated -= count;
+	pool->num_free += count;
+	TX_DESC_LOCK_UNLOCK(&pool->lock);
+}
+
 #endif /* QCA_LL_TX_FLOW_CONTROL_V2 */
 
 #ifdef QCA_DP_TX_DESC_ID_CHECK
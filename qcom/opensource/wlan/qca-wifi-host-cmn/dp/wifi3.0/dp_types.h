@@ -56,6 +56,9 @@
 #include <pktlog.h>
 #endif
 #include <dp_umac_reset.h>
+#ifdef DP_PEER_HASH_RCU
+#include <linux/rculist.h>
+#endif
 
 //#include "dp_tx.h"
 
@@ -74,6 +77,9 @@
 #define MAX_MON_LINK_DESC_BANKS 2
 #define DP_VDEV_ALL 0xff
 
+/* Number of last-hit peers cached per CPU for MAC based peer lookup */
+#define DP_PEER_HASH_CACHE_SIZE 4
+
 #if defined(WLAN_MAX_PDEVS) && (WLAN_MAX_PDEVS == 1)
 #define WLAN_DP_RESET_MON_BUF_RING_FILTER
 #define MAX_TXDESC_POOLS 6
@@ -989,6 +995,22 @@ struct dp_intr {
 	uint8_t umac_reset_intr_mask;  /* UMAC reset interrupt mask */
 };
 
+/**
+ * struct dp_rx_intr_adapt - Adaptive REO destination ring interrupt state
+ * @win_start_ms: start of the current packet rate sampling window
+ * @win_pkts: packets reaped from the ring in the current window
+ * @pps: packet rate measured over the last window
+ * @budget: per poll ring budget, 0 to use the remaining NAPI quota
+ * @level: interrupt level currently programmed in the ring
+ */
+struct dp_rx_intr_adapt {
+	qdf_time_t win_start_ms;
+	uint32_t win_pkts;
+	uint32_t pps;
+	uint32_t budget;
+	uint8_t level;
+};
+
 #define REO_DESC_FREELIST_SIZE 64
 #define REO_DESC_FREE_DEFER_MS 1000
 struct reo_desc_list_node {
@@ -1382,6 +1404,8 @@ struct rx_refill_buff_pool {
 	uint16_t tail;
 	struct dp_pdev *dp_pdev;
 	uint16_t max_bufq_len;
+	/* Page pool keeping refill buffers DMA mapped across recycling */
+	qdf_page_pool_t *pp;
 	qdf_nbuf_t buf_elem[2048];
 };
 
@@ -1821,22 +1845,43 @@ struct dp_swlm_tcl_data {
 	uint32_t pkt_len;
 };
 
+/**
+ * struct dp_swlm_refill_data - params for RX refill register write
+ *				coalescing decision making
+ * @lmac_id: lmac id of the refill ring
+ * @num_posted: Num buffers owned by HW after the current replenish
+ * @num_entries: Num entries of the refill ring
+ * @count: Num buffers added in the current replenish
+ */
+struct dp_swlm_refill_data {
+	uint8_t lmac_id;
+	uint32_t num_posted;
+	uint32_t num_entries;
+	uint32_t count;
+};
+
 /**
  * union swlm_data - SWLM query data
  * @tcl_data: data for TCL query in SWLM
+ * @refill_data: data for RX refill ring query in SWLM
  */
 union swlm_data {
 	struct dp_swlm_tcl_data *tcl_data;
+	struct dp_swlm_refill_data *refill_data;
 };
 
 /**
  * struct dp_swlm_ops - SWLM ops
  * @tcl_wr_coalesce_check: handler to check if the current TCL register
  *			   write can be coalesced or not
+ * @refill_wr_coalesce_check: handler to check if the current RX refill
+ *			      ring register write can be coalesced or not
  */
 struct dp_swlm_ops {
 	int (*tcl_wr_coalesce_check)(struct dp_soc *soc,
 				     struct dp_swlm_tcl_data *tcl_data);
+	int (*refill_wr_coalesce_check)(struct dp_soc *soc,
+					struct dp_swlm_refill_data *refill_data);
 };
 
 /**
@@ -1857,6 +1902,16 @@ struct dp_swlm_ops {
  *			   throughput did not meet session threshold
  * @tcl.coalesce_success: Num of TCL HP writes coalesced successfully.
  * @tcl.coalesce_fail: Num of TCL HP writes coalesces failed
+ * @tcl.sessions: Num of coalescing sessions flushed
+ * @tcl.latency_us: Total time HP writes were delayed by coalescing
+ * @refill.coalesce_success: Num of refill HP writes coalesced
+ * @refill.coalesce_fail: Num of refill HP writes done immediately
+ * @refill.timer_flush_success: Num refill HP writes from timer context
+ * @refill.timer_flush_fail: Num refill HP write failures from timer context
+ * @refill.sessions: Num of refill coalescing sessions flushed
+ * @refill.latency_us: Total time refill HP writes were delayed
+ * @last_print_ts: Timestamp in us of the last stats print
+ * @last_saved: Num of HP writes saved at the last stats print
  */
 struct dp_swlm_stats {
 	struct {
@@ -1870,7 +1925,19 @@ struct dp_swlm_stats {
 		uint32_t tput_criteria_fail;
 		uint32_t coalesce_success;
 		uint32_t coalesce_fail;
+		uint32_t sessions;
+		uint64_t latency_us;
 	} tcl[MAX_TCL_DATA_RINGS];
+	struct {
+		uint32_t coalesce_success;
+		uint32_t coalesce_fail;
+		uint32_t timer_flush_success;
+		uint32_t timer_flush_fail;
+		uint32_t sessions;
+		uint64_t latency_us;
+	} refill[MAX_PDEV_CNT];
+	uint64_t last_print_ts;
+	uint64_t last_saved;
 };
 
 /**
@@ -1888,6 +1955,9 @@ struct dp_swlm_stats {
  * @prev_rx_bytes: Previous RX bytes accounted
  * @expire_time: expiry time for sample
  * @tput_pass_cnt: threshold throughput pass counter
+ * @avg_tx_bytes: Moving average of the TX bytes per sampling period
+ * @time_flush_thresh: Session time threshold adapted from the TX rate
+ * @session_start_time: Timestamp of the first coalesced write in session
  */
 struct dp_swlm_tcl_params {
 	struct dp_soc *soc;
@@ -1902,6 +1972,26 @@ struct dp_swlm_tcl_params {
 	uint32_t prev_rx_bytes;
 	uint64_t expire_time;
 	uint32_t tput_pass_cnt;
+	uint32_t avg_tx_bytes;
+	uint32_t time_flush_thresh;
+	uint64_t session_start_time;
+};
+
+/**
+ * struct dp_swlm_refill_params: Parameters for RX refill ring HP write
+ *				 coalescing in the Software latency manager.
+ * @soc: DP soc reference
+ * @lmac_id: lmac id of the refill ring
+ * @flush_timer: Timer for flushing the coalesced refill HP writes
+ * @num_pending: Num buffers added to the ring without an HP write
+ * @session_start_time: Timestamp of the first coalesced write in session
+ */
+struct dp_swlm_refill_params {
+	struct dp_soc *soc;
+	uint8_t lmac_id;
+	qdf_timer_t flush_timer;
+	uint32_t num_pending;
+	uint64_t session_start_time;
 };
 
 /**
@@ -1919,6 +2009,7 @@ struct dp_swlm_tcl_params {
  * @tx_pkt_thresh: Threshold for TX packet count, to begin TCL register
  *		       write coalescing
  * @tcl: TCL ring specific params
+ * @refill: RX refill ring specific params
  */
 
 struct dp_swlm_params {
@@ -1929,6 +2020,7 @@ struct dp_swlm_params {
 	uint32_t tx_thresh_multiplier;
 	uint32_t tx_pkt_thresh;
 	struct dp_swlm_tcl_params tcl[MAX_TCL_DATA_RINGS];
+	struct dp_swlm_refill_params refill[MAX_PDEV_CNT];
 };
 
 /**
@@ -1985,6 +2077,56 @@ struct ipa_dp_rx_rsc {
 	uint32_t ipa_rx_refill_buf_ring_size;
 	qdf_dma_addr_t ipa_rx_refill_buf_hp_paddr;
 };
+
+#define DP_IPA_FLOW_CACHE_SIZE 64
+
+/**
+ * struct dp_ipa_flow_entry - intra-BSS flow seen on the IPA exception path
+ * @src: source MAC address
+ * @dst: destination MAC address
+ * @vdev_id: vdev the flow was received on
+ * @learned: both peers validated often enough to use the fast path
+ * @hits: packets seen in the current learning window
+ * @ts: learning window start, or last peer validation once learned (ticks)
+ */
+struct dp_ipa_flow_entry {
+	uint8_t src[QDF_MAC_ADDR_SIZE];
+	uint8_t dst[QDF_MAC_ADDR_SIZE];
+	uint8_t vdev_id;
+	bool learned;
+	uint16_t hits;
+	qdf_time_t ts;
+};
+
+/**
+ * struct dp_ipa_flow_stats - IPA exception path flow learning stats
+ * @exception_pkts: unicast intra-BSS candidates sent to host by IPA
+ * @fwd_slow: packets forwarded after full peer validation
+ * @fwd_fast: packets forwarded through a learned flow
+ * @flows_learned: flows promoted to the fast path
+ * @flows_evicted: learned flows replaced by another flow
+ */
+struct dp_ipa_flow_stats {
+	uint32_t exception_pkts;
+	uint32_t fwd_slow;
+	uint32_t fwd_fast;
+	uint32_t flows_learned;
+	uint32_t flows_evicted;
+};
+
+/**
+ * struct dp_ipa_flow_cache - learned IPA exception path flows
+ * @lock: protects @entry
+ * @initialized: @lock has been created
+ * @entry: direct mapped flow entries
+ * @stats: flow learning stats
+ */
+struct dp_ipa_flow_cache {
+	qdf_spinlock_t lock;
+	bool initialized;
+	struct dp_ipa_flow_entry entry[DP_IPA_FLOW_CACHE_SIZE];
+	struct dp_ipa_flow_stats stats;
+};
 #endif
 
 struct dp_tx_msdu_info_s;
@@ -2149,6 +2291,15 @@ struct dp_arch_ops {
 				    struct dp_txrx_peer *peer, qdf_nbuf_t nbuf);
 	bool (*dp_tx_is_mcast_primary)(struct dp_soc *soc,
 				       struct dp_vdev *vdev);
+#endif
+#if defined(WLAN_MLO_MULTI_CHIP) && defined(DP_MLO_TX_LINK_STEER)
+	struct dp_vdev * (*dp_tx_link_steer)(struct dp_soc *soc,
+					     struct dp_vdev *vdev,
+					     qdf_nbuf_t nbuf);
+	void (*dp_tx_link_steer_comp)(struct dp_soc *soc,
+				      struct dp_tx_desc_s *tx_desc,
+				      struct hal_tx_completion_status *ts);
+	void (*print_mlo_tx_steer_stats)(struct dp_soc *soc);
 #endif
 	struct dp_soc * (*dp_soc_get_by_idle_bm_id)(struct dp_soc *soc,
 						    uint8_t bm_id);
@@ -2282,6 +2433,62 @@ struct sysfs_stats_config {
 #endif
 
 /* SOC level structure for data path */
+#if defined(FEATURE_RUNTIME_PM) && defined(DP_TX_RTPM_HOLD)
+/**
+ * enum dp_tx_rtpm_hold_bucket - hold time histogram buckets
+ * @DP_TX_RTPM_HOLD_BUCKET_10MS: held for less than 10 ms
+ * @DP_TX_RTPM_HOLD_BUCKET_25MS: held for 10 to 25 ms
+ * @DP_TX_RTPM_HOLD_BUCKET_50MS: held for 25 to 50 ms
+ * @DP_TX_RTPM_HOLD_BUCKET_100MS: held for 50 to 100 ms
+ * @DP_TX_RTPM_HOLD_BUCKET_MORE: held for 100 ms or more
+ * @DP_TX_RTPM_HOLD_BUCKET_MAX: max number of buckets
+ */
+enum dp_tx_rtpm_hold_bucket {
+	DP_TX_RTPM_HOLD_BUCKET_10MS,
+	DP_TX_RTPM_HOLD_BUCKET_25MS,
+	DP_TX_RTPM_HOLD_BUCKET_50MS,
+	DP_TX_RTPM_HOLD_BUCKET_100MS,
+	DP_TX_RTPM_HOLD_BUCKET_MORE,
+	DP_TX_RTPM_HOLD_BUCKET_MAX,
+};
+
+/**
+ * struct dp_tx_rtpm_hold_stats - TX runtime PM hold statistics
+ * @held: frames written to TCL without waking the link
+ * @bypassed: latency sensitive frames sent while suspended without holding
+ * @timer_resumes: resumes requested on hold timer expiry
+ * @limit_resumes: resumes requested because the hold limit was reached
+ * @other_resumes: held batches flushed by a resume triggered elsewhere
+ * @hold_time: histogram of batch hold time, see enum dp_tx_rtpm_hold_bucket
+ */
+struct dp_tx_rtpm_hold_stats {
+	uint32_t held;
+	uint32_t bypassed;
+	uint32_t timer_resumes;
+	uint32_t limit_resumes;
+	uint32_t other_resumes;
+	uint32_t hold_time[DP_TX_RTPM_HOLD_BUCKET_MAX];
+};
+
+/**
+ * struct dp_tx_rtpm_hold - TX batching state while runtime suspended
+ * @lock: protects the batch state below
+ * @timer: bounds the time the oldest held frame waits for a resume
+ * @num_held: frames in the current batch
+ * @start_ts: time in ticks at which the current batch started
+ * @resume_requested: a resume has been requested for the current batch
+ * @stats: hold statistics
+ */
+struct dp_tx_rtpm_hold {
+	qdf_spinlock_t lock;
+	qdf_timer_t timer;
+	uint32_t num_held;
+	qdf_time_t start_ts;
+	bool resume_requested;
+	struct dp_tx_rtpm_hold_stats stats;
+};
+#endif
+
 struct dp_soc {
 	/**
 	 * re-use memory section starts
@@ -2441,6 +2648,11 @@ struct dp_soc {
 	/* Number of REO destination rings */
 	uint8_t num_reo_dest_rings;
 
+	/* REO destination ring interrupt profile, enum cdp_rx_intr_profile */
+	uint8_t rx_intr_profile;
+	/* Per REO destination ring adaptive interrupt state */
+	struct dp_rx_intr_adapt rx_intr_adapt[MAX_REO_DEST_RINGS];
+
 #ifdef QCA_LL_TX_FLOW_CONTROL_V2
 	/* lock to control access to soc TX descriptors */
 	qdf_spinlock_t flow_pool_array_lock;
@@ -2476,7 +2688,11 @@ struct dp_soc {
 	struct {
 		unsigned mask;
 		unsigned idx_bits;
+#ifdef DP_PEER_HASH_RCU
+		struct hlist_head *bins;
+#else
 		TAILQ_HEAD(, dp_peer) * bins;
+#endif
 	} peer_hash;
 
 	/* rx defrag state – TBD: do we need this per radio? */
@@ -2514,6 +2730,11 @@ struct dp_soc {
 
 	/* Protect peer hash table */
 	DP_MUTEX_TYPE peer_hash_lock;
+#ifdef DP_PEER_HASH_RCU
+	/* last peers found through the peer hash, per CPU, RCU protected */
+	struct dp_peer *peer_hash_cache[QDF_MAX_AVAILABLE_CPU]
+				       [DP_PEER_HASH_CACHE_SIZE];
+#endif
 	/* Protect peer_id_to_objmap */
 	DP_MUTEX_TYPE peer_map_lock;
 
@@ -2616,6 +2837,7 @@ struct dp_soc {
 	qdf_spinlock_t ipa_rx_buf_map_lock;
 	bool ipa_rx_buf_map_lock_initialized;
 	uint8_t ipa_reo_ctx_lock_required[MAX_REO_DEST_RINGS];
+	struct dp_ipa_flow_cache ipa_flow_cache;
 #endif
 
 #ifdef WLAN_FEATURE_STATS_EXT
@@ -2734,6 +2956,10 @@ struct dp_soc {
 	qdf_atomic_t dp_runtime_refcount;
 	/* Dp tx pending count in RTPM */
 	qdf_atomic_t tx_pending_rtpm;
+#ifdef DP_TX_RTPM_HOLD
+	/* Low priority TX held back while the link is runtime suspended */
+	struct dp_tx_rtpm_hold tx_rtpm_hold;
+#endif
 #endif
 	/* Invalid buffer that allocated for RX buffer */
 	qdf_nbuf_queue_t invalid_buf_queue;
@@ -4423,6 +4649,13 @@ struct dp_peer {
 	TAILQ_ENTRY(dp_peer) peer_list_elem;
 	/* node in the hash table bin's list of peers */
 	TAILQ_ENTRY(dp_peer) hash_list_elem;
+#ifdef DP_PEER_HASH_RCU
+	/* node in the RCU protected link peer hash bin */
+	struct hlist_node hash_rcu_elem;
+	/* deferred free of the peer past concurrent lockless lookups */
+	struct rcu_head rcu;
+	struct dp_soc *rcu_soc;
+#endif
 
 	/* TID structures pointer */
 	struct dp_rx_tid *rx_tid;
@@ -4600,6 +4833,8 @@ struct dp_fisa_stats {
 	uint32_t invalid_flow_index;
 	/* workqueue deferred due to suspend */
 	uint32_t update_deferred;
+	/* flows added to SW FT from RX context ahead of HW FSE setup */
+	uint32_t inline_flow_add;
 	struct dp_fisa_reo_mismatch_stats reo_mismatch;
 };
 
@@ -4668,6 +4903,8 @@ struct dp_fisa_rx_sw_ft {
 	uint32_t reo_dest_indication;
 	qdf_time_t flow_init_ts;
 	qdf_time_t last_accessed_ts;
+	/* SW FT entry added inline, HW FSE not yet programmed */
+	uint8_t hw_fse_pending;
 #ifdef WLAN_SUPPORT_RX_FISA_HIST
 	struct fisa_pkt_hist pkt_hist;
 #endif
@@ -4730,6 +4967,14 @@ struct dp_rx_fst {
 	bool fst_wq_defer;
 	/* Hash based routing supported */
 	bool rx_hash_enabled;
+	/* Deliver UDP aggregates as GSO fraglist skbs */
+	bool udp_fraglist;
+	/* Aggregate ESP-in-UDP flows */
+	bool esp_in_udp;
+#ifdef WLAN_DEBUGFS
+	qdf_dentry_t debugfs_dir;
+	struct qdf_debugfs_fops debugfs_fops;
+#endif
 };
 
 #endif /* WLAN_SUPPORT_RX_FISA */
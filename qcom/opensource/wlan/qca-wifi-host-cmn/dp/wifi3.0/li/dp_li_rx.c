@@ -210,6 +210,7 @@ uint32_t dp_rx_process_li(struct dp_intr *int_ctx,
 	hal_soc_handle_t hal_soc;
 	struct dp_rx_desc *rx_desc = NULL;
 	struct dp_rx_desc *last_prefetched_sw_desc = NULL;
+	struct hal_srng_dst_batch batch;
 	qdf_nbuf_t nbuf, next;
 	bool near_full;
 	union dp_rx_desc_list_elem_t *head[MAX_PDEV_CNT];
@@ -310,11 +311,11 @@ more_data:
 	if (!num_pending)
 		num_pending = hal_srng_dst_num_valid(hal_soc, hal_ring_hdl, 0);
 
-	dp_srng_dst_inv_cached_descs(soc, hal_ring_hdl, num_pending);
-
 	if (num_pending > quota)
 		num_pending = quota;
 
+	num_pending = dp_rx_srng_batch_begin(soc, hal_ring_hdl, &batch,
+					     num_pending);
 	last_prefetched_hw_desc = dp_srng_dst_prefetch(hal_soc, hal_ring_hdl,
 						       num_pending);
 
@@ -326,7 +327,7 @@ more_data:
 	 * Process the received pkts in a different per vdev loop.
 	 */
 	while (qdf_likely(num_pending)) {
-		ring_desc = dp_srng_dst_get_next(soc, hal_ring_hdl);
+		ring_desc = dp_rx_srng_batch_get_next(soc, hal_ring_hdl, &batch);
 
 		if (qdf_unlikely(!ring_desc))
 			break;
@@ -530,6 +531,7 @@ more_data:
 						  max_reap_limit))
 			break;
 	}
+	dp_rx_srng_batch_end(soc, hal_ring_hdl, &batch);
 done:
 	dp_rx_srng_access_end(int_ctx, soc, hal_ring_hdl);
 
@@ -549,7 +549,9 @@ dp_tx_hw_enqueue_li(struct dp_soc *soc, struct dp_vdev *vdev,
 				 hal_ring_hdl, soc, ring_id);
 
 ring_access_fail:
-	dp_tx_ring_access_end_wrapper(soc, hal_ring_hdl, coalesce);
+	dp_tx_ring_access_end_wrapper_hold(soc, hal_ring_hdl, coalesce,
+					   QDF_IS_STATUS_SUCCESS(status) ?
+					   tx_desc->nbuf : NULL, tid);
 	dp_pkt_add_timestamp(vdev, QDF_PKT_TX_DRIVER_EXIT,
 			     qdf_get_log_timestamp(), tx_desc->nbuf);
 
@@ -36,6 +36,7 @@
 #endif
 #ifdef QCA_SUPPORT_LITE_MONITOR
 #include "dp_lite_mon.h"
+#include "dp_mon_cap_ring.h"
 #endif
 
 #define DP_INTR_POLL_TIMER_MS	5
@@ -1074,6 +1075,7 @@ dp_print_pdev_rx_mon_stats(struct dp_pdev *pdev)
 
 	dp_pdev_get_undecoded_capture_stats(mon_pdev, rx_mon_stats);
 	dp_mon_rx_print_advanced_stats(pdev->soc, pdev);
+	dp_mon_cap_ring_print_stats(pdev);
 
 	dp_print_pdev_mpdu_stats(pdev);
 	dp_print_pdev_eht_ppdu_cnt(pdev);
@@ -5539,6 +5541,9 @@ QDF_STATUS dp_mon_pdev_init(struct dp_pdev *pdev)
 	if (mon_ops->mon_pdev_ext_init)
 		mon_ops->mon_pdev_ext_init(pdev);
 
+	if (dp_mon_cap_ring_attach(pdev) != QDF_STATUS_SUCCESS)
+		dp_mon_info("%pK: monitor capture ring not available", pdev);
+
 	mon_pdev->is_dp_mon_pdev_initialized = true;
 
 	return QDF_STATUS_SUCCESS;
@@ -5581,6 +5586,7 @@ QDF_STATUS dp_mon_pdev_deinit(struct dp_pdev *pdev)
 		return QDF_STATUS_SUCCESS;
 
 	dp_mon_filters_reset(pdev);
+	dp_mon_cap_ring_detach(pdev);
 
 	/* mon pdev extended deinit */
 	if (mon_ops->mon_pdev_ext_deinit)
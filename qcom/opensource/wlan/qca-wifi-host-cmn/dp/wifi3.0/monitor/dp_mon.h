@@ -1145,6 +1145,9 @@ struct  dp_mon_pdev {
 
 	bool rssi_dbm_conv_support;
 	struct dp_rx_mon_rssi_offset rssi_offsets;
+#ifdef WLAN_DP_MON_CAP_RING
+	struct dp_mon_cap_ring *cap_ring;
+#endif
 };
 
 struct  dp_mon_vdev {
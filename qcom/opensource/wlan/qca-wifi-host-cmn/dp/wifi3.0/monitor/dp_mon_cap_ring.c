@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <qdf_types.h>
+#include <qdf_mem.h>
+#include <qdf_lock.h>
+#include <qdf_time.h>
+#include <qdf_util.h>
+#include <qdf_debugfs.h>
+#include <qdf_streamfs.h>
+#include <dp_types.h>
+#include <dp_internal.h>
+#include <dp_mon.h>
+#include "dp_mon_cap_ring.h"
+
+#define DP_MON_CAP_RING_MAX_SNAPLEN \
+	(DP_MON_CAP_RING_SUBBUF_SIZE - sizeof(struct dp_mon_cap_pkt_hdr) - \
+	 RADIOTAP_HEADER_LEN - DP_MON_CAP_RING_ALIGN)
+
+/**
+ * struct dp_mon_cap_ring - per pdev monitor capture ring
+ * @dir: streamfs directory of the pdev
+ * @chan: streamfs channel records are written to
+ * @lock: serializes writers of the global channel buffer
+ * @enable: capture is diverted to the ring while non zero
+ * @pending: the current sub-buffer holds records not yet handed over
+ * @pending_ts_us: timestamp of the first record of the current sub-buffer
+ * @written: number of frames written
+ * @dropped: number of frames dropped because the ring was full
+ * @truncated: number of frames truncated to DP_MON_CAP_RING_MAX_SNAPLEN
+ * @rtap_err: number of frames dropped on radiotap build failure
+ */
+struct dp_mon_cap_ring {
+	qdf_dentry_t dir;
+	qdf_streamfs_chan_t chan;
+	qdf_spinlock_t lock;
+	qdf_atomic_t enable;
+	bool pending;
+	uint64_t pending_ts_us;
+	uint64_t written;
+	uint64_t dropped;
+	uint64_t truncated;
+	uint64_t rtap_err;
+};
+
+QDF_STATUS dp_mon_cap_ring_attach(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_cap_ring *ring;
+	char name[32];
+
+	ring = qdf_mem_malloc(sizeof(*ring));
+	if (!ring)
+		return QDF_STATUS_E_NOMEM;
+
+	qdf_snprintf(name, sizeof(name), "mon_cap_ring_pdev%d",
+		     pdev->pdev_id);
+	ring->dir = qdf_streamfs_create_dir(name, NULL);
+	if (!ring->dir) {
+		dp_mon_err("%pK: capture ring dir create failed", pdev);
+		goto fail_free;
+	}
+
+	ring->chan = qdf_streamfs_open("data", ring->dir,
+				       DP_MON_CAP_RING_SUBBUF_SIZE,
+				       DP_MON_CAP_RING_NUM_SUBBUFS, NULL);
+	if (!ring->chan) {
+		dp_mon_err("%pK: capture ring chan create failed", pdev);
+		goto fail_dir;
+	}
+
+	qdf_atomic_init(&ring->enable);
+	qdf_debugfs_create_atomic("enable", QDF_FILE_USR_READ |
+				  QDF_FILE_USR_WRITE, ring->dir,
+				  &ring->enable);
+	qdf_spinlock_create(&ring->lock);
+	mon_pdev->cap_ring = ring;
+
+	return QDF_STATUS_SUCCESS;
+
+fail_dir:
+	qdf_streamfs_remove_dir_recursive(ring->dir);
+fail_free:
+	qdf_mem_free(ring);
+	return QDF_STATUS_E_FAILURE;
+}
+
+void dp_mon_cap_ring_detach(struct dp_pdev *pdev)
+{
+	struct dp_mon_pdev *mon_pdev = pdev->monitor_pdev;
+	struct dp_mon_cap_ring *ring = mon_pdev->cap_ring;
+
+	if (!ring)
+		return;
+
+	qdf_spin_lock_bh(&ring->lock);
+	mon_pdev->cap_ring = NULL;
+	qdf_spin_unlock_bh(&ring->lock);
+
+	qdf_streamfs_close(ring->chan);
+	qdf_streamfs_remove_dir_recursive(ring->dir);
+	qdf_spinlock_destroy(&ring->lock);
+	qdf_mem_free(ring);
+}
+
+bool dp_mon_cap_ring_active(struct dp_pdev *pdev)
+{
+	struct dp_mon_cap_ring *ring = pdev->monitor_pdev->cap_ring;
+
+	return ring && qdf_atomic_read(&ring->enable);
+}
+
+QDF_STATUS dp_mon_cap_ring_write(struct dp_pdev *pdev,
+				 struct mon_rx_status *rx_status,
+				 qdf_nbuf_t mpdu)
+{
+	struct dp_mon_cap_ring *ring = pdev->monitor_pdev->cap_ring;
+	struct dp_mon_cap_pkt_hdr *hdr;
+	uint32_t len = qdf_nbuf_len(mpdu);
+	uint32_t snaplen = len;
+	uint32_t rec_len;
+	uint64_t now_us;
+	uint8_t *rtap;
+	uint16_t flags = 0;
+
+	if (qdf_unlikely(!ring))
+		return QDF_STATUS_E_INVAL;
+
+	if (qdf_unlikely(snaplen > DP_MON_CAP_RING_MAX_SNAPLEN)) {
+		snaplen = DP_MON_CAP_RING_MAX_SNAPLEN;
+		flags |= DP_MON_CAP_PKT_TRUNCATED;
+	}
+
+	rec_len = qdf_roundup(sizeof(*hdr) + RADIOTAP_HEADER_LEN + snaplen,
+			      DP_MON_CAP_RING_ALIGN);
+	now_us = qdf_get_log_timestamp_usecs();
+
+	qdf_spin_lock_bh(&ring->lock);
+
+	hdr = qdf_streamfs_reserve(ring->chan, rec_len);
+	if (!hdr) {
+		ring->dropped++;
+		qdf_spin_unlock_bh(&ring->lock);
+		return QDF_STATUS_E_RESOURCES;
+	}
+
+	/* radiotap and frame are built in place in the channel buffer */
+	rtap = (uint8_t *)(hdr + 1);
+	qdf_mem_zero(rtap, RADIOTAP_HEADER_LEN);
+	hdr->rtap_len = qdf_nbuf_build_radiotap(rx_status, rtap);
+	if (!hdr->rtap_len)
+		ring->rtap_err++;
+	else
+		qdf_nbuf_copy_bits(mpdu, 0, snaplen, rtap + hdr->rtap_len);
+
+	/*
+	 * The space is already reserved, so a record with a failed
+	 * radiotap build is kept with snaplen 0 for the reader to skip.
+	 */
+	hdr->magic = DP_MON_CAP_PKT_MAGIC;
+	hdr->rec_len = rec_len;
+	hdr->len = len;
+	hdr->snaplen = hdr->rtap_len ? snaplen : 0;
+	hdr->flags = flags;
+	hdr->ts_us = now_us;
+
+	if (hdr->rtap_len) {
+		ring->written++;
+		if (flags & DP_MON_CAP_PKT_TRUNCATED)
+			ring->truncated++;
+	}
+
+	if (!ring->pending) {
+		ring->pending = true;
+		ring->pending_ts_us = now_us;
+	} else if (now_us - ring->pending_ts_us >=
+		   DP_MON_CAP_RING_RETIRE_MS * 1000) {
+		/* hand a partially filled sub-buffer over to the reader */
+		qdf_streamfs_flush(ring->chan);
+		ring->pending = false;
+	}
+
+	qdf_spin_unlock_bh(&ring->lock);
+
+	return hdr->rtap_len ? QDF_STATUS_SUCCESS : QDF_STATUS_E_FAILURE;
+}
+
+void dp_mon_cap_ring_print_stats(struct dp_pdev *pdev)
+{
+	struct dp_mon_cap_ring *ring = pdev->monitor_pdev->cap_ring;
+
+	if (!ring)
+		return;
+
+	DP_PRINT_STATS("Monitor capture ring:");
+	DP_PRINT_STATS("enable = %d", qdf_atomic_read(&ring->enable));
+	DP_PRINT_STATS("written = %llu", ring->written);
+	DP_PRINT_STATS("dropped = %llu", ring->dropped);
+	DP_PRINT_STATS("truncated = %llu", ring->truncated);
+	DP_PRINT_STATS("rtap_err = %llu", ring->rtap_err);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef _DP_MON_CAP_RING_H_
+#define _DP_MON_CAP_RING_H_
+
+#include <qdf_types.h>
+#include <qdf_nbuf.h>
+#include <qdf_streamfs.h>
+
+/*
+ * Monitor capture ring
+ *
+ * Monitor MPDUs are written into a per pdev streamfs (relay) channel
+ * instead of being delivered as an skb to the monitor netdev. The
+ * channel is exposed as debugfs file mon_cap_ring_pdev<id>/data0 and
+ * can be consumed with read() or mmap() of its sub-buffers. The driver
+ * builds each record directly in the channel: a dp_mon_cap_pkt_hdr,
+ * the radiotap header and the 802.11 frame, copied once from the nbuf.
+ * Records never span sub-buffers. A partially filled sub-buffer is
+ * handed to the reader after DP_MON_CAP_RING_RETIRE_MS so that low rate
+ * captures are not held back. Frames that do not fit because the reader
+ * is behind are dropped and accounted.
+ *
+ * Capture is diverted to the channel only while the "enable" file in
+ * the same directory is non zero.
+ */
+
+#define DP_MON_CAP_RING_NUM_SUBBUFS 32
+#define DP_MON_CAP_RING_SUBBUF_SIZE (128 * 1024)
+#define DP_MON_CAP_RING_RETIRE_MS 50
+#define DP_MON_CAP_RING_ALIGN 4
+
+#define DP_MON_CAP_PKT_MAGIC 0x4d4f4e31
+
+/* set in dp_mon_cap_pkt_hdr flags when snaplen < len */
+#define DP_MON_CAP_PKT_TRUNCATED 0x1
+
+/**
+ * struct dp_mon_cap_pkt_hdr - header of each record in the capture ring
+ * @magic: DP_MON_CAP_PKT_MAGIC
+ * @rec_len: total record length including this header and padding
+ * @len: original length of the frame
+ * @snaplen: number of frame bytes stored after the radiotap header
+ * @rtap_len: length of the radiotap header following this header
+ * @flags: DP_MON_CAP_PKT_* flags
+ * @ts_us: capture timestamp in microseconds
+ */
+struct dp_mon_cap_pkt_hdr {
+	uint32_t magic;
+	uint32_t rec_len;
+	uint32_t len;
+	uint32_t snaplen;
+	uint16_t rtap_len;
+	uint16_t flags;
+	uint64_t ts_us;
+};
+
+struct dp_pdev;
+struct dp_mon_cap_ring;
+
+#ifdef WLAN_DP_MON_CAP_RING
+/**
+ * dp_mon_cap_ring_attach() - create the capture ring channel of a pdev
+ * @pdev: DP pdev handle
+ *
+ * Return: QDF_STATUS_SUCCESS on success, error code otherwise
+ */
+QDF_STATUS dp_mon_cap_ring_attach(struct dp_pdev *pdev);
+
+/**
+ * dp_mon_cap_ring_detach() - close the capture ring channel of a pdev
+ * @pdev: DP pdev handle
+ *
+ * Return: None
+ */
+void dp_mon_cap_ring_detach(struct dp_pdev *pdev);
+
+/**
+ * dp_mon_cap_ring_active() - check if capture to the ring is enabled
+ * @pdev: DP pdev handle
+ *
+ * Return: true if monitor frames should be written to the ring
+ */
+bool dp_mon_cap_ring_active(struct dp_pdev *pdev);
+
+/**
+ * dp_mon_cap_ring_write() - write a monitor MPDU into the capture ring
+ * @pdev: DP pdev handle
+ * @rx_status: rx status used to build the radiotap header
+ * @mpdu: restitched MPDU, not consumed by this function
+ *
+ * The radiotap header is built in place in the ring and the frame is
+ * copied once from the nbuf.
+ *
+ * Return: QDF_STATUS_SUCCESS if the frame was written, error otherwise
+ */
+QDF_STATUS dp_mon_cap_ring_write(struct dp_pdev *pdev,
+				 struct mon_rx_status *rx_status,
+				 qdf_nbuf_t mpdu);
+
+/**
+ * dp_mon_cap_ring_print_stats() - print capture ring statistics
+ * @pdev: DP pdev handle
+ *
+ * Return: None
+ */
+void dp_mon_cap_ring_print_stats(struct dp_pdev *pdev);
+#else
+static inline QDF_STATUS dp_mon_cap_ring_attach(struct dp_pdev *pdev)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline void dp_mon_cap_ring_detach(struct dp_pdev *pdev)
+{
+}
+
+static inline bool dp_mon_cap_ring_active(struct dp_pdev *pdev)
+{
+	return false;
+}
+
+static inline QDF_STATUS
+dp_mon_cap_ring_write(struct dp_pdev *pdev, struct mon_rx_status *rx_status,
+		      qdf_nbuf_t mpdu)
+{
+	return QDF_STATUS_E_NOSUPPORT;
+}
+
+static inline void dp_mon_cap_ring_print_stats(struct dp_pdev *pdev)
+{
+}
+#endif /* WLAN_DP_MON_CAP_RING */
+#endif /* _DP_MON_CAP_RING_H_ */
@@ -31,6 +31,7 @@
 #include "dp_htt.h"
 #include "dp_mon.h"
 #include "dp_rx_mon.h"
+#include "dp_mon_cap_ring.h"
 
 #include "htt.h"
 #ifdef FEATURE_PERPKT_INFO
@@ -1844,6 +1845,20 @@ QDF_STATUS dp_rx_mon_deliver(struct dp_soc *soc, uint32_t mac_id,
 	if (mon_pdev->mcopy_mode)
 		return dp_send_mgmt_packet_to_stack(soc, mon_mpdu, pdev);
 
+	if (dp_mon_cap_ring_active(pdev)) {
+		mon_pdev->ppdu_info.rx_status.ppdu_id =
+			mon_pdev->ppdu_info.com_info.ppdu_id;
+		mon_pdev->ppdu_info.rx_status.device_id = soc->device_id;
+		mon_pdev->ppdu_info.rx_status.chan_noise_floor =
+			pdev->chan_noise_floor;
+		if (dp_mon_cap_ring_write(pdev,
+					  &mon_pdev->ppdu_info.rx_status,
+					  mon_mpdu) != QDF_STATUS_SUCCESS)
+			DP_STATS_INC(pdev, dropped.mon_rx_drop, 1);
+		qdf_nbuf_free(mon_mpdu);
+		return QDF_STATUS_SUCCESS;
+	}
+
 	if (mon_mpdu && mon_pdev->mvdev &&
 	    mon_pdev->mvdev->osif_vdev &&
 	    mon_pdev->mvdev->monitor_vdev &&
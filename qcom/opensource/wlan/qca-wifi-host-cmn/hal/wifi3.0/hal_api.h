@@ -1223,6 +1223,21 @@ void hal_reo_read_write_ctrl_ix(hal_soc_handle_t hal_soc_hdl, bool read,
 extern void hal_srng_dst_set_hp_paddr_confirm(struct hal_srng *sring,
 					      uint64_t paddr);
 
+/**
+ * hal_srng_dst_update_int_setup() - Reprogram interrupt mitigation of a
+ *				     destination ring
+ * @hal_soc_hdl: HAL SoC handle
+ * @hal_ring_hdl: Destination ring handle
+ * @intr_timer_thres_us: interrupt timer threshold in us
+ * @intr_batch_cntr_thres_entries: interrupt batch counter threshold in entries
+ *
+ * Return: None
+ */
+void hal_srng_dst_update_int_setup(hal_soc_handle_t hal_soc_hdl,
+				   hal_ring_handle_t hal_ring_hdl,
+				   uint32_t intr_timer_thres_us,
+				   uint32_t intr_batch_cntr_thres_entries);
+
 /**
  * hal_srng_dst_init_hp() - Initilaize head pointer with cached head pointer
  * @hal_soc: hal_soc handle
@@ -3414,6 +3429,146 @@ void *hal_srng_dst_get_next_32_byte_desc(hal_soc_handle_t hal_soc_hdl,
 	return (void *)last_prefetched_hw_desc;
 }
 
+/* Number of descriptors prefetched ahead of the one being processed */
+#define HAL_SRNG_BATCH_PREFETCH_DEPTH 4
+
+/**
+ * struct hal_srng_dst_batch - context of a batched destination ring walk
+ * @prefetch_desc: next descriptor to be prefetched
+ * @num_left: descriptors left in the batch
+ * @num_prefetch_left: descriptors of the batch not prefetched yet
+ * @num_reaped: descriptors handed out so far
+ */
+struct hal_srng_dst_batch {
+	uint8_t *prefetch_desc;
+	uint32_t num_left;
+	uint32_t num_prefetch_left;
+	uint32_t num_reaped;
+};
+
+/**
+ * hal_srng_dst_batch_prefetch() - prefetch the next descriptor of a batch
+ * @srng: destination ring
+ * @batch: batch context
+ *
+ * Return: None
+ */
+static inline void hal_srng_dst_batch_prefetch(struct hal_srng *srng,
+					       struct hal_srng_dst_batch *batch)
+{
+	if (!batch->num_prefetch_left)
+		return;
+
+	qdf_prefetch(batch->prefetch_desc);
+	batch->num_prefetch_left--;
+
+	batch->prefetch_desc += srng->entry_size * sizeof(uint32_t);
+	if (batch->prefetch_desc == (uint8_t *)srng->ring_vaddr_end)
+		batch->prefetch_desc = (uint8_t *)&srng->ring_base_vaddr[0];
+}
+
+/**
+ * hal_srng_dst_batch_begin() - begin a batched walk of a destination ring
+ * @hal_soc_hdl: HAL SOC handle
+ * @hal_ring_hdl: destination ring pointer
+ * @batch: batch context to be initialized
+ * @max_entries: maximum number of descriptors to walk
+ * @prefetch_depth: number of descriptors to keep prefetched ahead
+ *
+ * Must be called after ring access start. The batch is sized from the
+ * head pointer snapshot taken at access start, so the HW pointer in DDR
+ * is read only once per batch instead of being checked per descriptor.
+ * For rings with cached descriptors the whole batch is invalidated here.
+ *
+ * Return: number of descriptors in the batch
+ */
+static inline
+uint32_t hal_srng_dst_batch_begin(hal_soc_handle_t hal_soc_hdl,
+				  hal_ring_handle_t hal_ring_hdl,
+				  struct hal_srng_dst_batch *batch,
+				  uint32_t max_entries,
+				  uint32_t prefetch_depth)
+{
+	struct hal_srng *srng = (struct hal_srng *)hal_ring_hdl;
+	uint32_t num_valid;
+	uint32_t i;
+
+	num_valid = hal_srng_dst_num_valid(hal_soc_hdl, hal_ring_hdl, 0);
+	if (num_valid > max_entries)
+		num_valid = max_entries;
+
+	hal_srng_dst_inv_cached_descs(hal_soc_hdl, hal_ring_hdl, num_valid);
+
+	batch->prefetch_desc =
+		(uint8_t *)&srng->ring_base_vaddr[srng->u.dst_ring.tp];
+	batch->num_left = num_valid;
+	batch->num_prefetch_left = num_valid;
+	batch->num_reaped = 0;
+
+	for (i = 0; i < prefetch_depth; i++)
+		hal_srng_dst_batch_prefetch(srng, batch);
+
+	return num_valid;
+}
+
+/**
+ * hal_srng_dst_batch_get_next() - get next descriptor of a batched walk
+ * @hal_soc_hdl: HAL SOC handle
+ * @hal_ring_hdl: destination ring pointer
+ * @batch: batch context
+ *
+ * Moves the tail pointer without reading the HW head pointer and keeps
+ * the prefetch window the given depth ahead of the returned descriptor.
+ * hal_srng_dst_dec_tp() can still be used to give the last descriptor
+ * back before ending the batch.
+ *
+ * Return: next descriptor, NULL once the batch is exhausted
+ */
+static inline
+void *hal_srng_dst_batch_get_next(hal_soc_handle_t hal_soc_hdl,
+				  hal_ring_handle_t hal_ring_hdl,
+				  struct hal_srng_dst_batch *batch)
+{
+	struct hal_srng *srng = (struct hal_srng *)hal_ring_hdl;
+	uint32_t *desc;
+
+	if (qdf_unlikely(!batch->num_left))
+		return NULL;
+
+	desc = &srng->ring_base_vaddr[srng->u.dst_ring.tp];
+	srng->u.dst_ring.tp += srng->entry_size;
+	if (srng->u.dst_ring.tp == srng->ring_size)
+		srng->u.dst_ring.tp = 0;
+
+	batch->num_left--;
+	batch->num_reaped++;
+	hal_srng_dst_batch_prefetch(srng, batch);
+
+	return (void *)desc;
+}
+
+/**
+ * hal_srng_dst_batch_end() - end a batched walk of a destination ring
+ * @hal_soc_hdl: HAL SOC handle
+ * @hal_ring_hdl: destination ring pointer
+ * @batch: batch context
+ *
+ * The tail pointer is not written to HW here, that is still done by
+ * ring access end.
+ *
+ * Return: number of descriptors handed out by the batch
+ */
+static inline
+uint32_t hal_srng_dst_batch_end(hal_soc_handle_t hal_soc_hdl,
+				hal_ring_handle_t hal_ring_hdl,
+				struct hal_srng_dst_batch *batch)
+{
+	batch->num_left = 0;
+	batch->num_prefetch_left = 0;
+
+	return batch->num_reaped;
+}
+
 /**
  * hal_srng_src_set_hp() - set head idx.
  * @hal_soc_hdl: HAL SOC handle
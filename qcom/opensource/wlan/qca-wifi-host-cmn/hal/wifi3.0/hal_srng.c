@@ -1398,6 +1398,45 @@ void hal_srng_dst_set_hp_paddr_confirm(struct hal_srng *srng, uint64_t paddr)
 
 qdf_export_symbol(hal_srng_dst_set_hp_paddr_confirm);
 
+/**
+ * hal_srng_dst_update_int_setup() - Reprogram interrupt mitigation of a
+ *				     destination ring
+ * @hal_soc_hdl: HAL SoC handle
+ * @hal_ring_hdl: Destination ring handle
+ * @intr_timer_thres_us: interrupt timer threshold in us
+ * @intr_batch_cntr_thres_entries: interrupt batch counter threshold in entries
+ *
+ * Return: None
+ */
+void hal_srng_dst_update_int_setup(hal_soc_handle_t hal_soc_hdl,
+				   hal_ring_handle_t hal_ring_hdl,
+				   uint32_t intr_timer_thres_us,
+				   uint32_t intr_batch_cntr_thres_entries)
+{
+	struct hal_srng *srng = (struct hal_srng *)hal_ring_hdl;
+	uint32_t reg_val = 0;
+
+	srng->intr_timer_thres_us = intr_timer_thres_us;
+	srng->intr_batch_cntr_thres_entries = intr_batch_cntr_thres_entries;
+
+	if (srng->intr_timer_thres_us) {
+		reg_val |= SRNG_SM(SRNG_DST_FLD(PRODUCER_INT_SETUP,
+			INTERRUPT_TIMER_THRESHOLD),
+			srng->intr_timer_thres_us >> 3);
+	}
+
+	if (srng->intr_batch_cntr_thres_entries) {
+		reg_val |= SRNG_SM(SRNG_DST_FLD(PRODUCER_INT_SETUP,
+			BATCH_COUNTER_THRESHOLD),
+			srng->intr_batch_cntr_thres_entries *
+			srng->entry_size);
+	}
+
+	SRNG_DST_REG_WRITE(srng, PRODUCER_INT_SETUP, reg_val);
+}
+
+qdf_export_symbol(hal_srng_dst_update_int_setup);
+
 /**
  * hal_srng_dst_init_hp() - Initialize destination ring head
  * pointer
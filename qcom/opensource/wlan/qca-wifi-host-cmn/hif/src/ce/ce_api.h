@@ -175,6 +175,40 @@ QDF_STATUS ce_send_single(struct CE_handle *ce_tx_hdl,
 			  qdf_nbuf_t msdu,
 			  uint32_t transfer_id,
 			  uint32_t len);
+/**
+ * ce_send_deferred() - Queue a source buffer without ringing the doorbell
+ * @copyeng: copy engine handle
+ * @per_transfer_send_context: context returned with the send completion
+ * @buffer: dma address of the buffer to send
+ * @nbytes: number of bytes to send
+ * @transfer_id: transfer id passed to the target as meta data
+ * @flags: CE_SEND_FLAG_* flags
+ * @user_flags: user flags
+ *
+ * Same as ce_send(), except that the source ring HP register update is
+ * held back until ce_send_flush() is called, so that a burst of sends
+ * costs a single register write. The HP is still written out once
+ * CE_SRC_DB_BATCH_MAX posts are pending. Copy engines without SRNG
+ * support fall back to ce_send().
+ *
+ * Return: QDF_STATUS_SUCCESS if the buffer was queued
+ */
+QDF_STATUS ce_send_deferred(struct CE_handle *copyeng,
+			    void *per_transfer_send_context,
+			    qdf_dma_addr_t buffer,
+			    unsigned int nbytes,
+			    unsigned int transfer_id,
+			    unsigned int flags,
+			    unsigned int user_flags);
+
+/**
+ * ce_send_flush() - Ring the doorbell for sends queued by ce_send_deferred()
+ * @copyeng: copy engine handle
+ *
+ * Return: None
+ */
+void ce_send_flush(struct CE_handle *copyeng);
+
 /*
  * Register a Send Callback function.
  * This function is called as soon as the contents of a Send
@@ -567,6 +601,14 @@ struct ce_ops {
 				       void *per_transfer_context,
 				       struct ce_sendlist *sendlist,
 				       unsigned int transfer_id);
+	QDF_STATUS (*ce_send_deferred_nolock)(struct CE_handle *copyeng,
+					      void *per_transfer_context,
+					      qdf_dma_addr_t buffer,
+					      uint32_t nbytes,
+					      uint32_t transfer_id,
+					      uint32_t flags,
+					      uint32_t user_flags);
+	void (*ce_send_flush_nolock)(struct CE_handle *copyeng);
 	QDF_STATUS (*ce_revoke_recv_next)(struct CE_handle *copyeng,
 			void **per_CE_contextp,
 			void **per_transfer_contextp,
@@ -141,6 +141,11 @@ struct CE_state {
 	/* Flag to indicate whether to break out the DPC context */
 	bool force_break;
 
+	/* SRC ring posts whose HP update is deferred to ce_send_flush */
+	unsigned int src_db_pending;
+	/* Number of SRC ring HP register writes avoided by batching */
+	uint32_t src_db_saved;
+
 	/* time in nanoseconds to yield control of napi poll */
 	unsigned long long ce_service_yield_time;
 	/* CE service start time in nanoseconds */
@@ -165,6 +170,9 @@ struct CE_state {
 
 /* Descriptor rings must be aligned to this boundary */
 #define CE_DESC_RING_ALIGN 8
+
+/* Max SRC ring posts held back before the HP register is written anyway */
+#define CE_SRC_DB_BATCH_MAX 16
 #define CLOCK_OVERRIDE 0x2
 
 #ifdef QCA_WIFI_3_0
@@ -465,6 +465,47 @@ ce_send(struct CE_handle *copyeng,
 }
 qdf_export_symbol(ce_send);
 
+QDF_STATUS
+ce_send_deferred(struct CE_handle *copyeng,
+		 void *per_transfer_context,
+		 qdf_dma_addr_t buffer,
+		 uint32_t nbytes,
+		 uint32_t transfer_id,
+		 uint32_t flags,
+		 uint32_t user_flag)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	QDF_STATUS status;
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(CE_state->scn);
+
+	if (!hif_state->ce_services->ce_send_deferred_nolock)
+		return ce_send(copyeng, per_transfer_context, buffer, nbytes,
+			       transfer_id, flags, user_flag);
+
+	qdf_spin_lock_bh(&CE_state->ce_index_lock);
+	status = hif_state->ce_services->ce_send_deferred_nolock(copyeng,
+			per_transfer_context, buffer, nbytes,
+			transfer_id, flags, user_flag);
+	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+
+	return status;
+}
+qdf_export_symbol(ce_send_deferred);
+
+void ce_send_flush(struct CE_handle *copyeng)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct HIF_CE_state *hif_state = HIF_GET_CE_STATE(CE_state->scn);
+
+	if (!hif_state->ce_services->ce_send_flush_nolock)
+		return;
+
+	qdf_spin_lock_bh(&CE_state->ce_index_lock);
+	hif_state->ce_services->ce_send_flush_nolock(copyeng);
+	qdf_spin_unlock_bh(&CE_state->ce_index_lock);
+}
+qdf_export_symbol(ce_send_flush);
+
 unsigned int ce_sendlist_sizeof(void)
 {
 	return sizeof(struct ce_sendlist);
@@ -157,14 +157,42 @@ void hif_record_ce_srng_desc_event(struct hif_softc *scn, int ce_id,
 }
 #endif /* HIF_CONFIG_SLUB_DEBUG_ON || HIF_CE_DEBUG_DATA_BUF */
 
+/**
+ * ce_srng_src_ring_db() - Finish SRC ring access after a post
+ * @CE_state: copy engine state
+ * @defer: hold back the HP register update if possible
+ *
+ * When @defer is set the post only moves the cached HP and the
+ * register write is left to a later post or ce_send_flush(), unless
+ * CE_SRC_DB_BATCH_MAX posts are already pending.
+ *
+ * Return: None
+ */
+static inline void ce_srng_src_ring_db(struct CE_state *CE_state, bool defer)
+{
+	struct hif_softc *scn = CE_state->scn;
+	hal_ring_handle_t srng = CE_state->src_ring->srng_ctx;
+
+	if (defer && CE_state->src_db_pending < CE_SRC_DB_BATCH_MAX - 1) {
+		CE_state->src_db_pending++;
+		hal_srng_access_end_reap(scn->hal_soc, srng);
+		return;
+	}
+
+	CE_state->src_db_saved += CE_state->src_db_pending;
+	CE_state->src_db_pending = 0;
+	hal_srng_access_end(scn->hal_soc, srng);
+}
+
 static QDF_STATUS
-ce_send_nolock_srng(struct CE_handle *copyeng,
-			   void *per_transfer_context,
-			   qdf_dma_addr_t buffer,
-			   uint32_t nbytes,
-			   uint32_t transfer_id,
-			   uint32_t flags,
-			   uint32_t user_flags)
+__ce_send_nolock_srng(struct CE_handle *copyeng,
+		      void *per_transfer_context,
+		      qdf_dma_addr_t buffer,
+		      uint32_t nbytes,
+		      uint32_t transfer_id,
+		      uint32_t flags,
+		      uint32_t user_flags,
+		      bool defer_db)
 {
 	QDF_STATUS status;
 	struct CE_state *CE_state = (struct CE_state *)copyeng;
@@ -194,6 +222,8 @@ ce_send_nolock_srng(struct CE_handle *copyeng,
 		src_desc = hal_srng_src_get_next_reaped(scn->hal_soc,
 				src_ring->srng_ctx);
 		if (!src_desc) {
+			hal_srng_access_end_reap(scn->hal_soc,
+						 src_ring->srng_ctx);
 			Q_TARGET_ACCESS_END(scn);
 			return QDF_STATUS_E_INVAL;
 		}
@@ -222,7 +252,7 @@ ce_send_nolock_srng(struct CE_handle *copyeng,
 			per_transfer_context;
 		write_index = CE_RING_IDX_INCR(nentries_mask, write_index);
 
-		hal_srng_access_end(scn->hal_soc, src_ring->srng_ctx);
+		ce_srng_src_ring_db(CE_state, defer_db);
 
 		/* src_ring->write index hasn't been updated event though
 		 * the register has already been written to.
@@ -240,6 +270,57 @@ ce_send_nolock_srng(struct CE_handle *copyeng,
 	return status;
 }
 
+static QDF_STATUS
+ce_send_nolock_srng(struct CE_handle *copyeng,
+		    void *per_transfer_context,
+		    qdf_dma_addr_t buffer,
+		    uint32_t nbytes,
+		    uint32_t transfer_id,
+		    uint32_t flags,
+		    uint32_t user_flags)
+{
+	return __ce_send_nolock_srng(copyeng, per_transfer_context, buffer,
+				     nbytes, transfer_id, flags, user_flags,
+				     false);
+}
+
+static QDF_STATUS
+ce_send_deferred_nolock_srng(struct CE_handle *copyeng,
+			     void *per_transfer_context,
+			     qdf_dma_addr_t buffer,
+			     uint32_t nbytes,
+			     uint32_t transfer_id,
+			     uint32_t flags,
+			     uint32_t user_flags)
+{
+	return __ce_send_nolock_srng(copyeng, per_transfer_context, buffer,
+				     nbytes, transfer_id, flags, user_flags,
+				     true);
+}
+
+static void ce_send_flush_nolock_srng(struct CE_handle *copyeng)
+{
+	struct CE_state *CE_state = (struct CE_state *)copyeng;
+	struct CE_ring_state *src_ring = CE_state->src_ring;
+	struct hif_softc *scn = CE_state->scn;
+
+	if (!CE_state->src_db_pending)
+		return;
+
+	if (Q_TARGET_ACCESS_BEGIN(scn) < 0)
+		return;
+
+	if (hal_srng_access_start(scn->hal_soc, src_ring->srng_ctx)) {
+		Q_TARGET_ACCESS_END(scn);
+		return;
+	}
+
+	/* the flush write itself covers one of the pending posts */
+	CE_state->src_db_pending--;
+	ce_srng_src_ring_db(CE_state, false);
+	Q_TARGET_ACCESS_END(scn);
+}
+
 static QDF_STATUS
 ce_sendlist_send_srng(struct CE_handle *copyeng,
 		 void *per_transfer_context,
@@ -270,7 +351,7 @@ ce_sendlist_send_srng(struct CE_handle *copyeng,
 			item = &sl->item[i];
 			/* TBDXXX: Support extensible sendlist_types? */
 			QDF_ASSERT(item->send_type == CE_SIMPLE_BUFFER_TYPE);
-			status = ce_send_nolock_srng(copyeng,
+			status = ce_send_deferred_nolock_srng(copyeng,
 					CE_SENDLIST_ITEM_CTXT,
 				(qdf_dma_addr_t) item->data,
 				item->u.nbytes, transfer_id,
@@ -1296,6 +1377,8 @@ static struct ce_ops ce_service_srng = {
 	.ce_recv_buf_enqueue = ce_recv_buf_enqueue_srng,
 	.ce_per_engine_handler_adjust = ce_per_engine_handler_adjust_srng,
 	.ce_send_nolock = ce_send_nolock_srng,
+	.ce_send_deferred_nolock = ce_send_deferred_nolock_srng,
+	.ce_send_flush_nolock = ce_send_flush_nolock_srng,
 	.watermark_int = ce_check_int_watermark_srng,
 	.ce_completed_send_next_nolock = ce_completed_send_next_nolock_srng,
 	.ce_recv_entries_done_nolock = ce_recv_entries_done_nolock_srng,
@@ -645,6 +645,15 @@ void hif_display_ce_stats(struct hif_softc *hif_ctx)
 		qdf_debug("CE id[%2d] - %s", i, str_buffer);
 	}
 
+	for (i = 0; i < hif_ctx->ce_count && i < CE_COUNT_MAX; i++) {
+		struct CE_state *ce_state = hif_ctx->ce_id_to_state[i];
+
+		if (ce_state && ce_state->src_ring && ce_state->src_db_saved)
+			qdf_debug("CE id[%2d] - src doorbells saved %u pending %u",
+				  i, ce_state->src_db_saved,
+				  ce_state->src_db_pending);
+	}
+
 	if (hif_ctx->ce_latency_stats)
 		hif_ce_latency_stats(hif_ctx);
 #undef STR_SIZE
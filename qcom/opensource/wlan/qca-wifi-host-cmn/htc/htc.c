@@ -1242,6 +1242,16 @@ void htc_clear_bundle_stats(HTC_HANDLE HTCHandle)
 }
 #endif
 
+uint8_t htc_get_max_tx_bundle_msgs(HTC_HANDLE HTCHandle)
+{
+	HTC_TARGET *target = GET_HTC_TARGET_FROM_HANDLE(HTCHandle);
+
+	if (!target || !HTC_TX_BUNDLE_ENABLED(target))
+		return 1;
+
+	return target->MaxMsgsPerHTCBundle;
+}
+
 /**
  * htc_can_suspend_link - API to query HIF for link status
  * @htc_handle: HTC Handle
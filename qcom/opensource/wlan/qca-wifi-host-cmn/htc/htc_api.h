@@ -528,6 +528,21 @@ void htc_ce_tasklet_debug_dump(HTC_HANDLE htc_handle);
  */
 QDF_STATUS htc_send_pkt(HTC_HANDLE HTCHandle, HTC_PACKET *pPacket);
 
+/**
+ * htc_send_pkt_queue - Send a queue of HTC packets in one pass
+ * @HTCHandle - HTC handle
+ * @pPktQueue - packets to send, all on the same endpoint
+ *
+ * Packets are given their HTC header and handed to the endpoint together,
+ * so that they can share a TX bundle and a single credit check. Caller
+ * must initialize the packets using SET_HTC_PACKET_INFO_TX() macro. A
+ * packet which cannot be sent is passed to the registered Endpoint
+ * callback with an error status, the queue is empty on return.
+ * Return: QDF_STATUS_SUCCESS, or an error if nothing was consumed
+ */
+QDF_STATUS htc_send_pkt_queue(HTC_HANDLE HTCHandle,
+			      HTC_PACKET_QUEUE *pPktQueue);
+
 /**
  * htc_send_data_pkt - Send an HTC packet containing a tx descriptor and data
  * @HTCHandle - HTC handle
@@ -812,6 +827,15 @@ void htc_dump_bundle_stats(HTC_HANDLE HTCHandle);
 void htc_clear_bundle_stats(HTC_HANDLE HTCHandle);
 #endif
 
+/**
+ * htc_get_max_tx_bundle_msgs() - get the number of messages per TX bundle
+ * @HTCHandle: htc handle
+ *
+ * Return: max messages the target accepts in one TX bundle, 1 if TX
+ *         bundling is not enabled
+ */
+uint8_t htc_get_max_tx_bundle_msgs(HTC_HANDLE HTCHandle);
+
 #ifdef FEATURE_RUNTIME_PM
 int htc_pm_runtime_get(HTC_HANDLE htc_handle);
 int htc_pm_runtime_put(HTC_HANDLE htc_handle);
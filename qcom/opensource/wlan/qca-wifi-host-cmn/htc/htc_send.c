@@ -1873,28 +1873,23 @@ static A_STATUS htc_send_pkts_sched_queue(HTC_TARGET *target,
 
 #endif
 
-static inline QDF_STATUS __htc_send_pkt(HTC_HANDLE HTCHandle,
-				HTC_PACKET *pPacket)
+/**
+ * htc_send_pkt_prepare() - Add the HTC header to a packet before queueing
+ * @target: HTC target
+ * @pPacket: packet to send
+ * @ep: filled with the endpoint of the packet
+ *
+ * Return: QDF_STATUS_SUCCESS if the packet can be handed to htc_try_send
+ */
+static QDF_STATUS htc_send_pkt_prepare(HTC_TARGET *target,
+				       HTC_PACKET *pPacket,
+				       HTC_ENDPOINT **ep)
 {
-	HTC_TARGET *target = GET_HTC_TARGET_FROM_HANDLE(HTCHandle);
 	HTC_ENDPOINT *pEndpoint;
-	HTC_PACKET_QUEUE pPktQueue;
 	qdf_nbuf_t netbuf;
 	HTC_FRAME_HDR *htc_hdr;
 	QDF_STATUS status;
 
-	AR_DEBUG_PRINTF(ATH_DEBUG_SEND,
-			("+__htc_send_pkt\n"));
-
-	/* get packet at head to figure out which endpoint these packets will
-	 * go into
-	 */
-	if (!pPacket) {
-		OL_ATH_HTC_PKT_ERROR_COUNT_INCR(target, GET_HTC_PKT_Q_FAIL);
-		AR_DEBUG_PRINTF(ATH_DEBUG_SEND, ("-__htc_send_pkt\n"));
-		return QDF_STATUS_E_INVAL;
-	}
-
 	if ((pPacket->Endpoint >= ENDPOINT_MAX) ||
 	    (pPacket->Endpoint <= ENDPOINT_UNUSED)) {
 		AR_DEBUG_PRINTF(ATH_DEBUG_SEND,
@@ -1967,19 +1962,40 @@ static inline QDF_STATUS __htc_send_pkt(HTC_HANDLE HTCHandle,
 		}
 	}
 
-	INIT_HTC_PACKET_QUEUE_AND_ADD(&pPktQueue, pPacket);
+	*ep = pEndpoint;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * htc_send_pkt_queue_try() - Hand prepared packets of an endpoint to HTC
+ * @HTCHandle: HTC handle
+ * @pEndpoint: endpoint of all the packets in @pPktQueue
+ * @pPktQueue: prepared packets
+ *
+ * Packets which could not be queued are completed with an error.
+ *
+ * Return: None
+ */
+static void htc_send_pkt_queue_try(HTC_HANDLE HTCHandle,
+				   HTC_ENDPOINT *pEndpoint,
+				   HTC_PACKET_QUEUE *pPktQueue)
+{
+	HTC_TARGET *target = GET_HTC_TARGET_FROM_HANDLE(HTCHandle);
+	HTC_PACKET *pPacket;
+
 #ifdef USB_HIF_SINGLE_PIPE_DATA_SCHED
 	if (!htc_send_pkts_sched_check(HTCHandle, pEndpoint->Id))
-		htc_send_pkts_sched_queue(HTCHandle, &pPktQueue, pEndpoint->Id);
+		htc_send_pkts_sched_queue(HTCHandle, pPktQueue, pEndpoint->Id);
 	else
-		htc_try_send(target, pEndpoint, &pPktQueue);
+		htc_try_send(target, pEndpoint, pPktQueue);
 #else
-	htc_try_send(target, pEndpoint, &pPktQueue);
+	htc_try_send(target, pEndpoint, pPktQueue);
 #endif
 
 	/* do completion on any packets that couldn't get in */
-	while (!HTC_QUEUE_EMPTY(&pPktQueue)) {
-		pPacket = htc_packet_dequeue(&pPktQueue);
+	while (!HTC_QUEUE_EMPTY(pPktQueue)) {
+		pPacket = htc_packet_dequeue(pPktQueue);
 
 		if (HTC_STOPPING(target))
 			pPacket->Status = QDF_STATUS_E_CANCELED;
@@ -1988,6 +2004,34 @@ static inline QDF_STATUS __htc_send_pkt(HTC_HANDLE HTCHandle,
 
 		send_packet_completion(target, pPacket);
 	}
+}
+
+static inline QDF_STATUS __htc_send_pkt(HTC_HANDLE HTCHandle,
+				HTC_PACKET *pPacket)
+{
+	HTC_TARGET *target = GET_HTC_TARGET_FROM_HANDLE(HTCHandle);
+	HTC_ENDPOINT *pEndpoint;
+	HTC_PACKET_QUEUE pPktQueue;
+	QDF_STATUS status;
+
+	AR_DEBUG_PRINTF(ATH_DEBUG_SEND,
+			("+__htc_send_pkt\n"));
+
+	/* get packet at head to figure out which endpoint these packets will
+	 * go into
+	 */
+	if (!pPacket) {
+		OL_ATH_HTC_PKT_ERROR_COUNT_INCR(target, GET_HTC_PKT_Q_FAIL);
+		AR_DEBUG_PRINTF(ATH_DEBUG_SEND, ("-__htc_send_pkt\n"));
+		return QDF_STATUS_E_INVAL;
+	}
+
+	status = htc_send_pkt_prepare(target, pPacket, &pEndpoint);
+	if (QDF_IS_STATUS_ERROR(status))
+		return status;
+
+	INIT_HTC_PACKET_QUEUE_AND_ADD(&pPktQueue, pPacket);
+	htc_send_pkt_queue_try(HTCHandle, pEndpoint, &pPktQueue);
 
 	AR_DEBUG_PRINTF(ATH_DEBUG_SEND, ("-__htc_send_pkt\n"));
 
@@ -2017,6 +2061,56 @@ QDF_STATUS htc_send_pkt(HTC_HANDLE htc_handle, HTC_PACKET *htc_packet)
 }
 qdf_export_symbol(htc_send_pkt);
 
+QDF_STATUS htc_send_pkt_queue(HTC_HANDLE htc_handle,
+			      HTC_PACKET_QUEUE *pkt_queue)
+{
+	HTC_TARGET *target = GET_HTC_TARGET_FROM_HANDLE(htc_handle);
+	HTC_ENDPOINT *endpoint = NULL;
+	HTC_PACKET_QUEUE send_queue;
+	HTC_ENDPOINT_ID ep_id;
+	HTC_PACKET *pkt;
+	QDF_STATUS status;
+
+	if (!htc_handle || !pkt_queue || HTC_QUEUE_EMPTY(pkt_queue)) {
+		AR_DEBUG_PRINTF(ATH_DEBUG_ERR,
+				("%s: invalid handle or empty queue\n",
+				 __func__));
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	/* all packets must go to the same valid endpoint */
+	ep_id = htc_get_pkt_at_head(pkt_queue)->Endpoint;
+	if (ep_id >= ENDPOINT_MAX || ep_id <= ENDPOINT_UNUSED)
+		return QDF_STATUS_E_INVAL;
+
+	HTC_PACKET_QUEUE_ITERATE_ALLOW_REMOVE(pkt_queue, pkt) {
+		if (pkt->Endpoint != ep_id)
+			return QDF_STATUS_E_INVAL;
+	}
+	HTC_PACKET_QUEUE_ITERATE_END;
+
+	INIT_HTC_PACKET_QUEUE(&send_queue);
+
+	while (!HTC_QUEUE_EMPTY(pkt_queue)) {
+		pkt = htc_packet_dequeue(pkt_queue);
+
+		status = htc_send_pkt_prepare(target, pkt, &endpoint);
+		if (QDF_IS_STATUS_ERROR(status)) {
+			pkt->Status = status;
+			send_packet_completion(target, pkt);
+			continue;
+		}
+
+		HTC_PACKET_ENQUEUE(&send_queue, pkt);
+	}
+
+	if (!HTC_QUEUE_EMPTY(&send_queue))
+		htc_send_pkt_queue_try(htc_handle, endpoint, &send_queue);
+
+	return QDF_STATUS_SUCCESS;
+}
+qdf_export_symbol(htc_send_pkt_queue);
+
 #ifdef ATH_11AC_TXCOMPACT
 /**
  * htc_send_data_pkt() - send single data packet on an endpoint
@@ -47,6 +47,304 @@ static inline void os_if_spectral_remove_nbuf_debug_entry(qdf_nbuf_t nbuf)
 	qdf_net_buf_debug_release_skb(nbuf);
 }
 
+#if defined(WLAN_SPECTRAL_STREAM) && defined(WLAN_STREAMFS)
+#include <qdf_debugfs.h>
+#include <qdf_streamfs.h>
+
+#define OS_IF_SPECTRAL_STREAM_SUBBUF_SIZE	(64 * 1024)
+#define OS_IF_SPECTRAL_STREAM_NUM_SUBBUFS	16
+/* a partially filled sub-buffer is handed to the reader after this time */
+#define OS_IF_SPECTRAL_STREAM_RETIRE_MS		20
+#define OS_IF_SPECTRAL_STREAM_MAGIC		0x53505452
+
+/**
+ * struct os_if_spectral_stream_hdr - header of a spectral stream record
+ * @magic: OS_IF_SPECTRAL_STREAM_MAGIC
+ * @rec_len: length of the record including this header
+ * @msg_type: enum spectral_msg_type of the SAMP message
+ * @reserved: reserved
+ * @ts_us: log timestamp at which the record was written
+ *
+ * The header is followed by a struct spectral_samp_msg.
+ */
+struct os_if_spectral_stream_hdr {
+	uint32_t magic;
+	uint32_t rec_len;
+	uint16_t msg_type;
+	uint16_t reserved[3];
+	uint64_t ts_us;
+};
+
+/**
+ * struct os_if_spectral_stream - shared memory ring for SAMP messages
+ * @dir: streamfs directory of the pdev
+ * @chan: streamfs channel records are written to
+ * @lock: serializes writers of the global channel buffer
+ * @enable: SAMP messages go to the ring instead of netlink while non zero
+ * @msg: per message type staging buffer used instead of an skb
+ * @msg_busy: @msg of this type holds a message being built
+ * @pending: the current sub-buffer holds records not yet handed over
+ * @pending_ts_us: timestamp of the first record of the current sub-buffer
+ * @written: number of SAMP messages written to the ring
+ * @dropped: number of SAMP messages dropped because the ring was full
+ */
+struct os_if_spectral_stream {
+	qdf_dentry_t dir;
+	qdf_streamfs_chan_t chan;
+	qdf_spinlock_t lock;
+	qdf_atomic_t enable;
+	struct spectral_samp_msg *msg[SPECTRAL_MSG_TYPE_MAX];
+	bool msg_busy[SPECTRAL_MSG_TYPE_MAX];
+	bool pending;
+	uint64_t pending_ts_us;
+	uint64_t written;
+	uint64_t dropped;
+};
+
+/**
+ * os_if_spectral_stream_attach() - create the spectral stream of a pdev
+ * @pdev: Pointer to pdev
+ * @ps: pdev spectral object
+ *
+ * Creates spectral_stream_pdev<id>/ with the data0 ring, an enable knob
+ * and the written/dropped counters. Failure is not fatal, SAMP messages
+ * then keep going over netlink only.
+ *
+ * Return: void
+ */
+static void
+os_if_spectral_stream_attach(struct wlan_objmgr_pdev *pdev,
+			     struct pdev_spectral *ps)
+{
+	struct os_if_spectral_stream *stream;
+	enum spectral_msg_type msg_type;
+	char name[32];
+
+	stream = qdf_mem_malloc(sizeof(*stream));
+	if (!stream)
+		return;
+
+	for (msg_type = 0; msg_type < SPECTRAL_MSG_TYPE_MAX; msg_type++) {
+		stream->msg[msg_type] =
+			qdf_mem_malloc(sizeof(struct spectral_samp_msg));
+		if (!stream->msg[msg_type])
+			goto fail_free;
+	}
+
+	qdf_snprintf(name, sizeof(name), "spectral_stream_pdev%d",
+		     wlan_objmgr_pdev_get_pdev_id(pdev));
+	stream->dir = qdf_streamfs_create_dir(name, NULL);
+	if (!stream->dir) {
+		osif_err("spectral stream dir create failed");
+		goto fail_free;
+	}
+
+	stream->chan = qdf_streamfs_open("data", stream->dir,
+					 OS_IF_SPECTRAL_STREAM_SUBBUF_SIZE,
+					 OS_IF_SPECTRAL_STREAM_NUM_SUBBUFS,
+					 NULL);
+	if (!stream->chan) {
+		osif_err("spectral stream chan create failed");
+		goto fail_dir;
+	}
+
+	qdf_atomic_init(&stream->enable);
+	qdf_debugfs_create_atomic("enable", QDF_FILE_USR_READ |
+				  QDF_FILE_USR_WRITE, stream->dir,
+				  &stream->enable);
+	qdf_debugfs_create_u64("written", QDF_FILE_USR_READ, stream->dir,
+			       &stream->written);
+	qdf_debugfs_create_u64("dropped", QDF_FILE_USR_READ, stream->dir,
+			       &stream->dropped);
+	qdf_spinlock_create(&stream->lock);
+	ps->stream = stream;
+
+	return;
+
+fail_dir:
+	qdf_streamfs_remove_dir_recursive(stream->dir);
+fail_free:
+	for (msg_type = 0; msg_type < SPECTRAL_MSG_TYPE_MAX; msg_type++)
+		qdf_mem_free(stream->msg[msg_type]);
+	qdf_mem_free(stream);
+}
+
+/**
+ * os_if_spectral_stream_detach() - destroy the spectral stream of a pdev
+ * @ps: pdev spectral object
+ *
+ * Return: void
+ */
+static void os_if_spectral_stream_detach(struct pdev_spectral *ps)
+{
+	struct os_if_spectral_stream *stream = ps->stream;
+	enum spectral_msg_type msg_type;
+
+	if (!stream)
+		return;
+
+	qdf_spin_lock_bh(&stream->lock);
+	ps->stream = NULL;
+	qdf_spin_unlock_bh(&stream->lock);
+
+	qdf_streamfs_close(stream->chan);
+	qdf_streamfs_remove_dir_recursive(stream->dir);
+	qdf_spinlock_destroy(&stream->lock);
+	for (msg_type = 0; msg_type < SPECTRAL_MSG_TYPE_MAX; msg_type++)
+		qdf_mem_free(stream->msg[msg_type]);
+	qdf_mem_free(stream);
+}
+
+/**
+ * os_if_spectral_stream_get_buf() - get a SAMP message buffer of the stream
+ * @ps: pdev spectral object
+ * @smsg_type: Spectral message type
+ * @buf_type: Spectral message buffer type
+ *
+ * A new message is only built in the staging buffer while the stream is
+ * enabled, a saved one wherever it was started.
+ *
+ * Return: buffer to build the SAMP message in, NULL to use an skb
+ */
+static void *
+os_if_spectral_stream_get_buf(struct pdev_spectral *ps,
+			      enum spectral_msg_type smsg_type,
+			      enum spectral_msg_buf_type buf_type)
+{
+	struct os_if_spectral_stream *stream = ps->stream;
+
+	if (!stream)
+		return NULL;
+
+	if (buf_type == SPECTRAL_MSG_BUF_SAVED)
+		return stream->msg_busy[smsg_type] ?
+			stream->msg[smsg_type] : NULL;
+
+	if (!qdf_atomic_read(&stream->enable))
+		return NULL;
+
+	QDF_ASSERT(!stream->msg_busy[smsg_type]);
+	stream->msg_busy[smsg_type] = true;
+	qdf_mem_zero(stream->msg[smsg_type],
+		     sizeof(struct spectral_samp_msg));
+
+	return stream->msg[smsg_type];
+}
+
+/**
+ * os_if_spectral_stream_send() - write a built SAMP message to the ring
+ * @ps: pdev spectral object
+ * @smsg_type: Spectral message type
+ *
+ * Records are handed over to the reader a sub-buffer at a time, which
+ * batches reader wakeups. A partially filled sub-buffer is flushed once
+ * it is older than OS_IF_SPECTRAL_STREAM_RETIRE_MS.
+ *
+ * Return: 0 if sent, -ENOBUFS if the ring was full, 1 if the message is
+ * not a stream message and has to go over netlink
+ */
+static int
+os_if_spectral_stream_send(struct pdev_spectral *ps,
+			   enum spectral_msg_type smsg_type)
+{
+	struct os_if_spectral_stream *stream = ps->stream;
+	struct os_if_spectral_stream_hdr *hdr;
+	uint32_t rec_len;
+	uint64_t now_us;
+
+	if (!stream || !stream->msg_busy[smsg_type])
+		return 1;
+
+	stream->msg_busy[smsg_type] = false;
+	rec_len = qdf_roundup(sizeof(*hdr) + sizeof(struct spectral_samp_msg),
+			      sizeof(uint64_t));
+	now_us = qdf_get_log_timestamp_usecs();
+
+	qdf_spin_lock_bh(&stream->lock);
+
+	hdr = qdf_streamfs_reserve(stream->chan, rec_len);
+	if (!hdr) {
+		stream->dropped++;
+		qdf_spin_unlock_bh(&stream->lock);
+		return -ENOBUFS;
+	}
+
+	hdr->magic = OS_IF_SPECTRAL_STREAM_MAGIC;
+	hdr->rec_len = rec_len;
+	hdr->msg_type = smsg_type;
+	hdr->ts_us = now_us;
+	qdf_mem_copy(hdr + 1, stream->msg[smsg_type],
+		     sizeof(struct spectral_samp_msg));
+	stream->written++;
+
+	if (!stream->pending) {
+		stream->pending = true;
+		stream->pending_ts_us = now_us;
+	} else if (now_us - stream->pending_ts_us >=
+		   OS_IF_SPECTRAL_STREAM_RETIRE_MS * 1000) {
+		qdf_streamfs_flush(stream->chan);
+		stream->pending = false;
+	}
+
+	qdf_spin_unlock_bh(&stream->lock);
+
+	return 0;
+}
+
+/**
+ * os_if_spectral_stream_free() - drop a SAMP message of the stream
+ * @ps: pdev spectral object
+ * @smsg_type: Spectral message type
+ *
+ * Return: true if the message was a stream message
+ */
+static bool
+os_if_spectral_stream_free(struct pdev_spectral *ps,
+			   enum spectral_msg_type smsg_type)
+{
+	struct os_if_spectral_stream *stream = ps->stream;
+
+	if (!stream || !stream->msg_busy[smsg_type])
+		return false;
+
+	stream->msg_busy[smsg_type] = false;
+
+	return true;
+}
+#else
+static inline void
+os_if_spectral_stream_attach(struct wlan_objmgr_pdev *pdev,
+			     struct pdev_spectral *ps)
+{
+}
+
+static inline void os_if_spectral_stream_detach(struct pdev_spectral *ps)
+{
+}
+
+static inline void *
+os_if_spectral_stream_get_buf(struct pdev_spectral *ps,
+			      enum spectral_msg_type smsg_type,
+			      enum spectral_msg_buf_type buf_type)
+{
+	return NULL;
+}
+
+static inline int
+os_if_spectral_stream_send(struct pdev_spectral *ps,
+			   enum spectral_msg_type smsg_type)
+{
+	return 1;
+}
+
+static inline bool
+os_if_spectral_stream_free(struct pdev_spectral *ps,
+			   enum spectral_msg_type smsg_type)
+{
+	return false;
+}
+#endif /* WLAN_SPECTRAL_STREAM && WLAN_STREAMFS */
+
 #ifndef CNSS_GENL
 static struct sock *os_if_spectral_nl_sock;
 static atomic_t spectral_nl_users = ATOMIC_INIT(0);
@@ -276,6 +574,10 @@ os_if_spectral_prep_skb(struct wlan_objmgr_pdev *pdev,
 		return NULL;
 	}
 
+	buf = os_if_spectral_stream_get_buf(ps, smsg_type, buf_type);
+	if (buf)
+		return buf;
+
 	if (buf_type == SPECTRAL_MSG_BUF_NEW) {
 		QDF_ASSERT(!ps->skb[smsg_type]);
 		ps->skb[smsg_type] =
@@ -385,6 +687,10 @@ os_if_spectral_nl_unicast_msg(struct wlan_objmgr_pdev *pdev,
 		return -EINVAL;
 	}
 
+	status = os_if_spectral_stream_send(ps, smsg_type);
+	if (status <= 0)
+		return status;
+
 	if (!ps->skb[smsg_type]) {
 		osif_err("Socket buffer is null, msg_type= %u", smsg_type);
 		return -EINVAL;
@@ -442,6 +748,10 @@ os_if_spectral_nl_unicast_msg(struct wlan_objmgr_pdev *pdev,
 		return -EINVAL;
 	}
 
+	status = os_if_spectral_stream_send(ps, smsg_type);
+	if (status <= 0)
+		return status;
+
 	if (!ps->skb[smsg_type]) {
 		osif_err("Socket buffer is null, msg_type= %u", smsg_type);
 		return -EINVAL;
@@ -504,6 +814,10 @@ os_if_spectral_nl_bcast_msg(struct wlan_objmgr_pdev *pdev,
 		return -EINVAL;
 	}
 
+	status = os_if_spectral_stream_send(ps, smsg_type);
+	if (status <= 0)
+		return status;
+
 	if (!ps->skb[smsg_type]) {
 		osif_err("Socket buffer is null, msg_type= %u", smsg_type);
 		return -EINVAL;
@@ -559,6 +873,9 @@ os_if_spectral_free_skb(struct wlan_objmgr_pdev *pdev,
 		return;
 	}
 
+	if (os_if_spectral_stream_free(ps, smsg_type))
+		return;
+
 	if (!ps->skb[smsg_type]) {
 		osif_info("Socket buffer is null, msg_type= %u", smsg_type);
 		return;
@@ -576,6 +893,7 @@ os_if_spectral_netlink_init(struct wlan_objmgr_pdev *pdev)
 {
 	struct spectral_nl_cb nl_cb = {0};
 	struct spectral_context *sptrl_ctx;
+	struct pdev_spectral *ps;
 
 	if (!pdev) {
 		osif_err("PDEV is NULL!");
@@ -596,6 +914,11 @@ os_if_spectral_netlink_init(struct wlan_objmgr_pdev *pdev)
 
 	os_if_spectral_init_nl(pdev);
 
+	ps = wlan_objmgr_pdev_get_comp_private_obj(pdev,
+						   WLAN_UMAC_COMP_SPECTRAL);
+	if (ps)
+		os_if_spectral_stream_attach(pdev, ps);
+
 	/* Register Netlink handlers */
 	nl_cb.get_sbuff = os_if_spectral_prep_skb;
 	nl_cb.send_nl_bcast = os_if_spectral_nl_bcast_msg;
@@ -613,6 +936,7 @@ void os_if_spectral_netlink_deinit(struct wlan_objmgr_pdev *pdev)
 {
 	struct spectral_context *sptrl_ctx;
 	enum spectral_msg_type msg_type = SPECTRAL_MSG_NORMAL_MODE;
+	struct pdev_spectral *ps;
 
 	if (!pdev) {
 		osif_err("PDEV is NULL!");
@@ -637,6 +961,11 @@ void os_if_spectral_netlink_deinit(struct wlan_objmgr_pdev *pdev)
 	if (sptrl_ctx->sptrlc_deregister_netlink_cb)
 		sptrl_ctx->sptrlc_deregister_netlink_cb(pdev);
 
+	ps = wlan_objmgr_pdev_get_comp_private_obj(pdev,
+						   WLAN_UMAC_COMP_SPECTRAL);
+	if (ps)
+		os_if_spectral_stream_detach(ps);
+
 	os_if_spectral_destroy_netlink(pdev);
 }
 qdf_export_symbol(os_if_spectral_netlink_deinit);
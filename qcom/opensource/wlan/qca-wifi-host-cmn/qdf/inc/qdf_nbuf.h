@@ -1131,6 +1131,11 @@ typedef struct qdf_nbuf_track_t QDF_NBUF_TRACK;
  */
 typedef __qdf_nbuf_queue_head_t qdf_nbuf_queue_head_t;
 
+/**
+ * typedef qdf_page_pool_t - Platform independent DMA mapping page pool
+ */
+typedef __qdf_page_pool_t qdf_page_pool_t;
+
 /**
  * @qdf_dma_map_cb_t - Dma map callback prototype
  */
@@ -2287,19 +2292,112 @@ qdf_nbuf_t
 qdf_nbuf_page_frag_alloc_debug(qdf_device_t osdev, qdf_size_t size, int reserve,
 			       int align, qdf_frag_cache_t *pf_cache,
 			       const char *func, uint32_t line);
+
+#define qdf_nbuf_page_pool_alloc(d, p, s, r, a) \
+	qdf_nbuf_page_pool_alloc_debug(d, p, s, r, a, __func__, __LINE__)
+
+qdf_nbuf_t
+qdf_nbuf_page_pool_alloc_debug(qdf_device_t osdev, qdf_page_pool_t *pp,
+			       qdf_size_t size, int reserve, int align,
+			       const char *func, uint32_t line);
 #else /* NBUF_MEMORY_DEBUG */
 
-static inline void qdf_net_buf_debug_init(void) {}
-static inline void qdf_net_buf_debug_exit(void) {}
+#ifdef NBUF_SAMPLED_TRACKING
+/* Default 1 in N sampling rate of the sampled nbuf tracking */
+#define QDF_NBUF_SAMPLE_RATE_DEFAULT 1024
+
+/**
+ * qdf_nbuf_sampled_track() - Sample an nbuf for leak tracking
+ * @nbuf: allocated or acquired nbuf
+ * @func: function name of the call site
+ * @line: line number of the call site
+ *
+ * Production builds track one in nbuf_sample_rate nbufs in a small hash
+ * table, with per CPU record pools and per alloc site in flight counters,
+ * so leaks can be diagnosed with a bounded per packet cost.
+ *
+ * Return: none
+ */
+void qdf_nbuf_sampled_track(qdf_nbuf_t nbuf, const char *func, uint32_t line);
+
+/**
+ * qdf_nbuf_sampled_untrack() - Stop tracking an nbuf if it was sampled
+ * @nbuf: nbuf being freed or released to the network stack
+ *
+ * Does nothing while other users still hold a reference to @nbuf.
+ *
+ * Return: none
+ */
+void qdf_nbuf_sampled_untrack(qdf_nbuf_t nbuf);
+
+/**
+ * qdf_nbuf_sampled_tracking_dump() - Print sampled tracking state
+ * @min_age_ms: only print sampled nbufs in flight for at least this long
+ *
+ * Prints the per alloc site in flight counters, with the estimated total
+ * in flight, and the sampled nbufs older than @min_age_ms as suspected
+ * leaks.
+ *
+ * Return: none
+ */
+void qdf_nbuf_sampled_tracking_dump(uint32_t min_age_ms);
+
+/**
+ * qdf_nbuf_sampled_tracking_init() - Initialize sampled nbuf tracking
+ *
+ * Return: none
+ */
+void qdf_nbuf_sampled_tracking_init(void);
+
+/**
+ * qdf_nbuf_sampled_tracking_exit() - Report leaks and free sampled tracking
+ *
+ * Return: none
+ */
+void qdf_nbuf_sampled_tracking_exit(void);
+#else
+static inline void
+qdf_nbuf_sampled_track(qdf_nbuf_t nbuf, const char *func, uint32_t line)
+{
+}
+
+static inline void qdf_nbuf_sampled_untrack(qdf_nbuf_t nbuf)
+{
+}
+
+static inline void qdf_nbuf_sampled_tracking_dump(uint32_t min_age_ms)
+{
+}
+
+static inline void qdf_nbuf_sampled_tracking_init(void)
+{
+}
+
+static inline void qdf_nbuf_sampled_tracking_exit(void)
+{
+}
+#endif /* NBUF_SAMPLED_TRACKING */
+
+static inline void qdf_net_buf_debug_init(void)
+{
+	qdf_nbuf_sampled_tracking_init();
+}
+
+static inline void qdf_net_buf_debug_exit(void)
+{
+	qdf_nbuf_sampled_tracking_exit();
+}
 
 static inline void qdf_net_buf_debug_acquire_skb(qdf_nbuf_t net_buf,
 						 const char *func_name,
 						 uint32_t line_num)
 {
+	qdf_nbuf_sampled_track(net_buf, func_name, line_num);
 }
 
 static inline void qdf_net_buf_debug_release_skb(qdf_nbuf_t net_buf)
 {
+	qdf_nbuf_sampled_untrack(net_buf);
 }
 
 static inline void
@@ -2338,7 +2436,13 @@ static inline qdf_nbuf_t
 qdf_nbuf_alloc_fl(qdf_device_t osdev, qdf_size_t size, int reserve, int align,
 		  int prio, const char *func, uint32_t line)
 {
-	return __qdf_nbuf_alloc(osdev, size, reserve, align, prio, func, line);
+	qdf_nbuf_t nbuf;
+
+	nbuf = __qdf_nbuf_alloc(osdev, size, reserve, align, prio, func, line);
+	if (qdf_likely(nbuf))
+		qdf_nbuf_sampled_track(nbuf, func, line);
+
+	return nbuf;
 }
 
 /**
@@ -2358,15 +2462,23 @@ static inline qdf_nbuf_t
 qdf_nbuf_alloc_no_recycler_fl(size_t size, int reserve, int align,
 			      const char *func, uint32_t line)
 {
-	return __qdf_nbuf_alloc_no_recycler(size, reserve, align, func, line);
+	qdf_nbuf_t nbuf;
+
+	nbuf = __qdf_nbuf_alloc_no_recycler(size, reserve, align, func, line);
+	if (qdf_likely(nbuf))
+		qdf_nbuf_sampled_track(nbuf, func, line);
+
+	return nbuf;
 }
 
 #define qdf_nbuf_free_simple(d) qdf_nbuf_free(d)
 
 static inline void qdf_nbuf_free(qdf_nbuf_t buf)
 {
-	if (qdf_likely(buf))
+	if (qdf_likely(buf)) {
+		qdf_nbuf_sampled_untrack(buf);
 		__qdf_nbuf_free(buf);
+	}
 }
 
 /**
@@ -2443,8 +2555,73 @@ qdf_nbuf_page_frag_alloc_fl(qdf_device_t osdev, qdf_size_t size, int reserve,
 	return __qdf_nbuf_page_frag_alloc(osdev, size, reserve, align, pf_cache,
 					  func, line);
 }
+
+#define qdf_nbuf_page_pool_alloc(osdev, pp, size, reserve, align) \
+	qdf_nbuf_page_pool_alloc_fl(osdev, pp, size, reserve, align, \
+				    __func__, __LINE__)
+
+static inline qdf_nbuf_t
+qdf_nbuf_page_pool_alloc_fl(qdf_device_t osdev, qdf_page_pool_t *pp,
+			    qdf_size_t size, int reserve, int align,
+			    const char *func, uint32_t line)
+{
+	return __qdf_nbuf_page_pool_alloc(osdev, pp, size, reserve, align,
+					  func, line);
+}
 #endif /* NBUF_MEMORY_DEBUG */
 
+/**
+ * qdf_nbuf_page_pool_create() - Create a DMA mapping page pool for rx nbufs
+ * @osdev: Device handle
+ * @pool_size: Number of pages the pool keeps for recycling
+ *
+ * Return: page pool or %NULL if not supported or on failure
+ */
+static inline qdf_page_pool_t *
+qdf_nbuf_page_pool_create(qdf_device_t osdev, uint32_t pool_size)
+{
+	return __qdf_nbuf_page_pool_create(osdev, pool_size);
+}
+
+/**
+ * qdf_nbuf_page_pool_destroy() - Destroy a page pool
+ * @pp: page pool
+ *
+ * Return: none
+ */
+static inline void qdf_nbuf_page_pool_destroy(qdf_page_pool_t *pp)
+{
+	__qdf_nbuf_page_pool_destroy(pp);
+}
+
+/**
+ * qdf_nbuf_is_page_pool() - Check if nbuf was allocated from a page pool
+ * @buf: Pointer to network buffer
+ *
+ * Such nbufs are DMA mapped by the pool and must not be unmapped.
+ *
+ * Return: true if the nbuf head is recycled to a page pool
+ */
+static inline bool qdf_nbuf_is_page_pool(qdf_nbuf_t buf)
+{
+	return __qdf_nbuf_is_page_pool(buf);
+}
+
+/**
+ * qdf_nbuf_page_pool_sync_for_cpu() - Hand a page pool nbuf to the CPU
+ * @osdev: Device handle
+ * @buf: Pointer to network buffer
+ * @size: number of bytes the device may have written
+ *
+ * Return: none
+ */
+static inline void
+qdf_nbuf_page_pool_sync_for_cpu(qdf_device_t osdev, qdf_nbuf_t buf,
+				qdf_size_t size)
+{
+	__qdf_nbuf_page_pool_sync_for_cpu(osdev, buf, size);
+}
+
 /**
  * qdf_nbuf_dev_queue_head() - Queue a buffer at the list head
  * @nbuf_queue_head: Pointer to buffer list head
@@ -4453,6 +4630,42 @@ static inline void qdf_nbuf_set_gso_type_udp_l4(qdf_nbuf_t nbuf)
 	__qdf_nbuf_set_gso_type_udp_l4(nbuf);
 }
 
+/**
+ * qdf_nbuf_set_gso_type_udp_l4_fraglist() - set the gso type to GSO UDP L4
+ * with frag_list segmentation
+ * @nbuf: Network buffer
+ *
+ * Return: None
+ */
+static inline void qdf_nbuf_set_gso_type_udp_l4_fraglist(qdf_nbuf_t nbuf)
+{
+	__qdf_nbuf_set_gso_type_udp_l4_fraglist(nbuf);
+}
+
+/**
+ * qdf_nbuf_set_network_header() - set the network header offset
+ * @nbuf: Network buffer
+ * @offset: offset of the network header from the nbuf data
+ *
+ * Return: None
+ */
+static inline void qdf_nbuf_set_network_header(qdf_nbuf_t nbuf, int offset)
+{
+	__qdf_nbuf_set_network_header(nbuf, offset);
+}
+
+/**
+ * qdf_nbuf_set_transport_header() - set the transport header offset
+ * @nbuf: Network buffer
+ * @offset: offset of the transport header from the nbuf data
+ *
+ * Return: None
+ */
+static inline void qdf_nbuf_set_transport_header(qdf_nbuf_t nbuf, int offset)
+{
+	__qdf_nbuf_set_transport_header(nbuf, offset);
+}
+
 /**
  * qdf_nbuf_set_ip_summed_partial() - set the ip summed to CHECKSUM_PARTIAL
  * @nbuf: Network buffer
@@ -4716,6 +4929,12 @@ qdf_nbuf_set_queue_mapping(qdf_nbuf_t buf, uint16_t val)
 	__qdf_nbuf_set_queue_mapping(buf, val);
 }
 
+static inline uint32_t
+qdf_nbuf_get_tx_flow_hash(qdf_nbuf_t buf)
+{
+	return __qdf_nbuf_get_tx_flow_hash(buf);
+}
+
 static inline char *
 qdf_nbuf_get_priv_ptr(qdf_nbuf_t buf)
 {
@@ -4733,6 +4952,16 @@ qdf_nbuf_get_priv_ptr(qdf_nbuf_t buf)
 unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
 				      qdf_nbuf_t nbuf, uint32_t headroom_sz);
 
+/**
+ * qdf_nbuf_build_radiotap() - build a radiotap header into a buffer
+ * @rx_status: rx_status containing required info to build radiotap
+ * @rtap_buf: zeroed buffer of at least RADIOTAP_HEADER_LEN bytes
+ *
+ * Return: radiotap length, 0 on failure.
+ */
+unsigned int qdf_nbuf_build_radiotap(struct mon_rx_status *rx_status,
+				     uint8_t *rtap_buf);
+
 /**
  * qdf_nbuf_mark_wakeup_frame() - mark wakeup frame.
  * @buf: Pointer to nbuf
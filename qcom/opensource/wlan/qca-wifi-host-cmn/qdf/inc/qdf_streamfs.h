@@ -149,6 +149,19 @@ void qdf_streamfs_subbufs_consumed(qdf_streamfs_chan_t chan,
  */
 void qdf_streamfs_write(qdf_streamfs_chan_t chan, const void *data,
 			size_t length);
+
+/**
+ * qdf_streamfs_reserve() - reserve space in the channel for in place write
+ * @chan: relay channel
+ * @length: number of bytes to reserve
+ *
+ * Reserves length bytes in the current cpu's channel buffer so that the
+ * caller can build the record directly in the buffer without an
+ * intermediate copy. Writers of a global buffer must serialize.
+ *
+ * Return: pointer to the reserved space, NULL if the buffer is full
+ */
+void *qdf_streamfs_reserve(qdf_streamfs_chan_t chan, size_t length);
 #else
 static inline qdf_dentry_t qdf_streamfs_create_dir(
 			const char *name, qdf_dentry_t parent)
@@ -204,5 +217,11 @@ qdf_streamfs_write(qdf_streamfs_chan_t chan, const void *data,
 		   size_t length)
 {
 }
+
+static inline void *
+qdf_streamfs_reserve(qdf_streamfs_chan_t chan, size_t length)
+{
+	return NULL;
+}
 #endif /* WLAN_STREAMFS */
 #endif /* _QDF_STREAMFS_H */
@@ -213,6 +213,17 @@ void qdf_cpumask_copy(qdf_cpu_mask *dstp,
 void qdf_cpumask_or(qdf_cpu_mask *dstp, qdf_cpu_mask *src1p,
 		    qdf_cpu_mask *src2p);
 
+/**
+ * qdf_cpumask_and - set *dstp = *src1p & *src2p
+ * @dstp: the cpumask result
+ * @src1p: the first input
+ * @src2p: the second input
+ *
+ * Return: false if the result is empty, true otherwise
+ */
+bool qdf_cpumask_and(qdf_cpu_mask *dstp, const qdf_cpu_mask *src1p,
+		     const qdf_cpu_mask *src2p);
+
 /**
  * qdf_thread_cpumap_print_to_pagebuf  - copies the cpumask into the buffer
  * either as comma-separated list of cpus or hex values of cpumask
@@ -74,6 +74,19 @@ typedef struct sk_buff_head __qdf_nbuf_queue_head_t;
  */
 typedef struct skb_shared_info *__qdf_nbuf_shared_info_t;
 
+/**
+ * typedef __qdf_page_pool_t - abstraction for page_pool linux struct
+ *
+ * This is used for rx buffers whose pages stay DMA mapped while they are
+ * recycled between the stack and the driver
+ */
+typedef struct page_pool __qdf_page_pool_t;
+
+#if IS_ENABLED(CONFIG_PAGE_POOL) && \
+	(LINUX_VERSION_CODE >= KERNEL_VERSION(5, 14, 0))
+#define QDF_NBUF_PAGE_POOL_SUPPORT
+#endif
+
 #define QDF_NBUF_CB_TX_MAX_OS_FRAGS 1
 
 #define QDF_SHINFO_SIZE    SKB_DATA_ALIGN(sizeof(struct skb_shared_info))
@@ -853,6 +866,108 @@ __qdf_nbuf_t __qdf_nbuf_alloc_no_recycler(size_t size, int reserve, int align,
  *
  * Return: nbuf or %NULL if no memory
  */
+#ifdef QDF_NBUF_PAGE_POOL_SUPPORT
+/**
+ * __qdf_nbuf_page_pool_create() - Create a DMA mapping page pool
+ * @osdev: Device handle
+ * @pool_size: Number of pages the pool keeps for recycling
+ *
+ * Return: page pool or %NULL on failure
+ */
+__qdf_page_pool_t *__qdf_nbuf_page_pool_create(qdf_device_t osdev,
+					       uint32_t pool_size);
+
+/**
+ * __qdf_nbuf_page_pool_destroy() - Destroy a page pool
+ * @pp: page pool
+ *
+ * Pages still held by the stack are released to the kernel as they are
+ * freed.
+ *
+ * Return: none
+ */
+void __qdf_nbuf_page_pool_destroy(__qdf_page_pool_t *pp);
+
+/**
+ * __qdf_nbuf_page_pool_alloc() - Allocate a DMA mapped nbuf from @pp
+ * @osdev: Device handle
+ * @pp: page pool
+ * @size: Netbuf requested size
+ * @reserve: headroom to start with
+ * @align: Align
+ * @func: Function name of the call site
+ * @line: line number of the call site
+ *
+ * The nbuf head is a page of @pp marked for recycling, so it returns to
+ * the pool with its DMA mapping intact when the nbuf is freed. The DMA
+ * address of the data is stored in QDF_NBUF_CB_PADDR.
+ *
+ * Return: nbuf or %NULL if no memory or @size does not fit in a page
+ */
+__qdf_nbuf_t
+__qdf_nbuf_page_pool_alloc(qdf_device_t osdev, __qdf_page_pool_t *pp,
+			   size_t size, int reserve, int align,
+			   const char *func, uint32_t line);
+
+/**
+ * __qdf_nbuf_is_page_pool() - Check if nbuf head comes from a page pool
+ * @skb: Pointer to network buffer
+ *
+ * Return: true if the nbuf head is recycled to a page pool
+ */
+static inline bool __qdf_nbuf_is_page_pool(struct sk_buff *skb)
+{
+	return skb->pp_recycle;
+}
+
+/**
+ * __qdf_nbuf_page_pool_sync_for_cpu() - Hand a page pool nbuf to the CPU
+ * @osdev: Device handle
+ * @skb: Pointer to network buffer
+ * @size: number of bytes the device may have written
+ *
+ * Used instead of unmapping, the page pool keeps the mapping.
+ *
+ * Return: none
+ */
+static inline void
+__qdf_nbuf_page_pool_sync_for_cpu(qdf_device_t osdev, struct sk_buff *skb,
+				  size_t size)
+{
+	dma_sync_single_for_cpu(osdev->dev, QDF_NBUF_CB_PADDR(skb), size,
+				DMA_FROM_DEVICE);
+}
+#else
+static inline __qdf_page_pool_t *
+__qdf_nbuf_page_pool_create(qdf_device_t osdev, uint32_t pool_size)
+{
+	return NULL;
+}
+
+static inline void __qdf_nbuf_page_pool_destroy(__qdf_page_pool_t *pp)
+{
+}
+
+static inline __qdf_nbuf_t
+__qdf_nbuf_page_pool_alloc(qdf_device_t osdev, __qdf_page_pool_t *pp,
+			   size_t size, int reserve, int align,
+			   const char *func, uint32_t line)
+{
+	return NULL;
+}
+
+static inline bool __qdf_nbuf_is_page_pool(struct sk_buff *skb)
+{
+	return false;
+}
+
+static inline void
+__qdf_nbuf_page_pool_sync_for_cpu(qdf_device_t osdev, struct sk_buff *skb,
+				  size_t size)
+{
+}
+#endif /* QDF_NBUF_PAGE_POOL_SUPPORT */
+
 __qdf_nbuf_t
 __qdf_nbuf_page_frag_alloc(__qdf_device_t osdev, size_t size, int reserve,
 			   int align, __qdf_frag_cache_t *pf_cache,
@@ -2371,6 +2486,19 @@ __qdf_nbuf_get_queue_mapping(struct sk_buff *skb)
 	return skb->queue_mapping;
 }
 
+/**
+ * __qdf_nbuf_get_tx_flow_hash() - get the flow hash of a frame
+ *
+ * @skb: sk buff
+ *
+ * Return: flow hash, computed by the stack if not already set
+ */
+static inline uint32_t
+__qdf_nbuf_get_tx_flow_hash(struct sk_buff *skb)
+{
+	return skb_get_hash(skb);
+}
+
 /**
  * __qdf_nbuf_set_queue_mapping() - get the queue mapping set by linux kernel
  *
@@ -2914,6 +3042,51 @@ static inline void __qdf_nbuf_set_gso_type_udp_l4(struct sk_buff *skb)
 	skb_shinfo(skb)->gso_type = SKB_GSO_UDP_L4;
 }
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+/**
+ * __qdf_nbuf_set_gso_type_udp_l4_fraglist() - set the gso type to GSO UDP L4
+ * with frag_list segmentation
+ * @skb: Pointer to network buffer
+ *
+ * Return: None
+ */
+static inline void __qdf_nbuf_set_gso_type_udp_l4_fraglist(struct sk_buff *skb)
+{
+	skb_shinfo(skb)->gso_type = SKB_GSO_UDP_L4 | SKB_GSO_FRAGLIST;
+}
+#else
+static inline void __qdf_nbuf_set_gso_type_udp_l4_fraglist(struct sk_buff *skb)
+{
+	skb_shinfo(skb)->gso_type = SKB_GSO_UDP_L4;
+}
+#endif
+
+/**
+ * __qdf_nbuf_set_network_header() - set the network header offset
+ * @skb: Pointer to network buffer
+ * @offset: offset of the network header from skb->data
+ *
+ * Return: None
+ */
+static inline void __qdf_nbuf_set_network_header(struct sk_buff *skb,
+						 int offset)
+{
+	skb_set_network_header(skb, offset);
+}
+
+/**
+ * __qdf_nbuf_set_transport_header() - set the transport header offset
+ * @skb: Pointer to network buffer
+ * @offset: offset of the transport header from skb->data
+ *
+ * Return: None
+ */
+static inline void __qdf_nbuf_set_transport_header(struct sk_buff *skb,
+						   int offset)
+{
+	skb_set_transport_header(skb, offset);
+}
+
 /**
  * __qdf_nbuf_set_ip_summed_partial() - set the ip summed to CHECKSUM_PARTIAL
  * @skb: Pointer to network buffer
@@ -2965,7 +3138,9 @@ static inline void __qdf_nbuf_kfree(struct sk_buff *skb)
  * __qdf_nbuf_dev_kfree_list() - Free nbuf list using dev based os call
  * @skb_queue_head: Pointer to nbuf queue head
  *
- * This function is called to free the nbuf list on failure cases
+ * This function is called to free the nbuf list on failure cases and
+ * to bulk free completed tx nbufs. Without dev_kfree_skb_list_fast the
+ * list is released through the napi skb cache when called from softirq.
  *
  * Return: None
  */
@@ -786,6 +786,86 @@ skb_alloc:
 
 qdf_export_symbol(__qdf_nbuf_page_frag_alloc);
 
+#ifdef QDF_NBUF_PAGE_POOL_SUPPORT
+#include <net/page_pool.h>
+
+__qdf_page_pool_t *__qdf_nbuf_page_pool_create(qdf_device_t osdev,
+					       uint32_t pool_size)
+{
+	struct page_pool_params pp_params = {0};
+	struct page_pool *pp;
+
+	pp_params.order = 0;
+	pp_params.flags = PP_FLAG_DMA_MAP | PP_FLAG_DMA_SYNC_DEV;
+	pp_params.pool_size = pool_size;
+	pp_params.nid = NUMA_NO_NODE;
+	pp_params.dev = osdev->dev;
+	pp_params.dma_dir = DMA_FROM_DEVICE;
+	pp_params.offset = 0;
+	pp_params.max_len = PAGE_SIZE;
+
+	pp = page_pool_create(&pp_params);
+	if (IS_ERR(pp)) {
+		qdf_nofl_err("page pool create failed %ld", PTR_ERR(pp));
+		return NULL;
+	}
+
+	return pp;
+}
+
+qdf_export_symbol(__qdf_nbuf_page_pool_create);
+
+void __qdf_nbuf_page_pool_destroy(__qdf_page_pool_t *pp)
+{
+	page_pool_destroy(pp);
+}
+
+qdf_export_symbol(__qdf_nbuf_page_pool_destroy);
+
+__qdf_nbuf_t
+__qdf_nbuf_page_pool_alloc(qdf_device_t osdev, __qdf_page_pool_t *pp,
+			   size_t size, int reserve, int align,
+			   const char *func, uint32_t line)
+{
+	struct sk_buff *skb;
+	struct page *page;
+
+	if (align)
+		size += (align - 1);
+
+	if (SKB_DATA_ALIGN(size + reserve) + QDF_SHINFO_SIZE > PAGE_SIZE)
+		return NULL;
+
+	page = page_pool_dev_alloc_pages(pp);
+	if (!page) {
+		qdf_rl_nofl_err("page pool alloc failed %zuB @ %s:%d",
+				size, func, line);
+		return NULL;
+	}
+
+	skb = build_skb(page_address(page), PAGE_SIZE);
+	if (!skb) {
+		page_pool_put_full_page(pp, page, false);
+		qdf_rl_nofl_err("NBUF alloc failed %zuB @ %s:%d",
+				size, func, line);
+		return NULL;
+	}
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 15, 0)
+	skb_mark_for_recycle(skb);
+#else
+	skb_mark_for_recycle(skb, page, pp);
+#endif
+	qdf_nbuf_set_defaults(skb, align, reserve);
+	QDF_NBUF_CB_PADDR(skb) = page_pool_get_dma_addr(page) +
+				 (skb->data - skb->head);
+
+	return skb;
+}
+
+qdf_export_symbol(__qdf_nbuf_page_pool_alloc);
+#endif /* QDF_NBUF_PAGE_POOL_SUPPORT */
+
 #ifdef QCA_DP_TX_NBUF_LIST_FREE
 void
 __qdf_nbuf_dev_kfree_list(__qdf_nbuf_queue_head_t *nbuf_queue_head)
@@ -796,6 +876,22 @@ __qdf_nbuf_dev_kfree_list(__qdf_nbuf_queue_head_t *nbuf_queue_head)
 void
 __qdf_nbuf_dev_kfree_list(__qdf_nbuf_queue_head_t *nbuf_queue_head)
 {
+	struct sk_buff *skb;
+	/* napi skb cache can only be used from softirq context */
+	int budget = in_serving_softirq();
+
+	while ((skb = __skb_dequeue(nbuf_queue_head))) {
+		if (pld_nbuf_pre_alloc_free(skb))
+			continue;
+
+		qdf_nbuf_frag_count_dec(skb);
+
+		qdf_nbuf_count_dec(skb);
+		if (nbuf_free_cb)
+			nbuf_free_cb(skb);
+		else
+			napi_consume_skb(skb, budget);
+	}
 }
 #endif
 
@@ -4000,6 +4096,33 @@ qdf_nbuf_page_frag_alloc_debug(qdf_device_t osdev, qdf_size_t size, int reserve,
 
 qdf_export_symbol(qdf_nbuf_page_frag_alloc_debug);
 
+qdf_nbuf_t
+qdf_nbuf_page_pool_alloc_debug(qdf_device_t osdev, qdf_page_pool_t *pp,
+			       qdf_size_t size, int reserve, int align,
+			       const char *func, uint32_t line)
+{
+	qdf_nbuf_t nbuf;
+
+	if (is_initial_mem_debug_disabled)
+		return __qdf_nbuf_page_pool_alloc(osdev, pp, size, reserve,
+						  align, func, line);
+
+	nbuf = __qdf_nbuf_page_pool_alloc(osdev, pp, size, reserve, align,
+					  func, line);
+
+	/* Store SKB in internal QDF tracking table */
+	if (qdf_likely(nbuf)) {
+		qdf_net_buf_debug_add_node(nbuf, size, func, line);
+		qdf_nbuf_history_add(nbuf, func, line, QDF_NBUF_ALLOC);
+	} else {
+		qdf_nbuf_history_add(nbuf, func, line, QDF_NBUF_ALLOC_FAILURE);
+	}
+
+	return nbuf;
+}
+
+qdf_export_symbol(qdf_nbuf_page_pool_alloc_debug);
+
 qdf_nbuf_t qdf_nbuf_copy_debug(qdf_nbuf_t buf, const char *func, uint32_t line)
 {
 	qdf_nbuf_t copied_buf = __qdf_nbuf_copy(buf);
@@ -4128,6 +4251,292 @@ qdf_nbuf_dev_kfree_list_debug(__qdf_nbuf_queue_head_t *nbuf_queue_head,
 qdf_export_symbol(qdf_nbuf_dev_kfree_list_debug);
 #endif /* NBUF_MEMORY_DEBUG */
 
+#if defined(NBUF_SAMPLED_TRACKING) && !defined(NBUF_MEMORY_DEBUG)
+/* Track 1 in nbuf_sample_rate nbufs, 0 disables sampled tracking */
+static uint32_t nbuf_sample_rate = QDF_NBUF_SAMPLE_RATE_DEFAULT;
+qdf_declare_param(nbuf_sample_rate, uint);
+
+#define QDF_NBUF_SAMPLE_HASH_SIZE 1024
+#define QDF_NBUF_SAMPLE_RECORDS_PER_CPU 128
+#define QDF_NBUF_SAMPLE_MAX_SITES 64
+#define QDF_NBUF_SAMPLE_INVALID_SITE 0xffff
+
+/**
+ * struct qdf_nbuf_sample - record of a sampled nbuf
+ * @nbuf: sampled nbuf
+ * @func: allocating function
+ * @line: allocating line
+ * @cpu: CPU whose pool the record belongs to
+ * @site: index in the alloc site table
+ * @time: allocation timestamp in ticks
+ * @next: next record in the hash bucket or the free list
+ */
+struct qdf_nbuf_sample {
+	qdf_nbuf_t nbuf;
+	const char *func;
+	uint32_t line;
+	uint16_t cpu;
+	uint16_t site;
+	qdf_time_t time;
+	struct qdf_nbuf_sample *next;
+};
+
+/**
+ * struct qdf_nbuf_sample_pool - per CPU pool of sample records
+ * @lock: protects @free_list
+ * @free_list: free records
+ * @exhausted: samples dropped because the pool was empty
+ * @records: record storage
+ */
+struct qdf_nbuf_sample_pool {
+	spinlock_t lock;
+	struct qdf_nbuf_sample *free_list;
+	uint32_t exhausted;
+	struct qdf_nbuf_sample records[QDF_NBUF_SAMPLE_RECORDS_PER_CPU];
+};
+
+/**
+ * struct qdf_nbuf_sample_site - in flight counter of an alloc site
+ * @func: allocating function, compared by address
+ * @in_flight: sampled nbufs from this site not yet freed
+ */
+struct qdf_nbuf_sample_site {
+	const char *func;
+	qdf_atomic_t in_flight;
+};
+
+static DEFINE_PER_CPU(uint32_t, qdf_nbuf_sample_tick);
+static struct qdf_nbuf_sample_pool *qdf_nbuf_sample_pools;
+static struct qdf_nbuf_sample *qdf_nbuf_sample_tbl[QDF_NBUF_SAMPLE_HASH_SIZE];
+static spinlock_t qdf_nbuf_sample_lock[QDF_NBUF_SAMPLE_HASH_SIZE];
+static struct qdf_nbuf_sample_site qdf_nbuf_sample_sites[QDF_NBUF_SAMPLE_MAX_SITES];
+static qdf_atomic_t qdf_nbuf_sample_in_flight;
+
+static inline uint32_t qdf_nbuf_sample_hash(qdf_nbuf_t nbuf)
+{
+	uint32_t i;
+
+	i = (uint32_t)(((uintptr_t)nbuf) >> 4);
+	i += (uint32_t)(((uintptr_t)nbuf) >> 14);
+
+	return i & (QDF_NBUF_SAMPLE_HASH_SIZE - 1);
+}
+
+/**
+ * qdf_nbuf_sample_site_get() - find or claim the site slot of @func
+ * @func: allocating function
+ *
+ * Return: site index, QDF_NBUF_SAMPLE_INVALID_SITE if the table is full
+ */
+static uint16_t qdf_nbuf_sample_site_get(const char *func)
+{
+	uint32_t start = ((uintptr_t)func >> 3) % QDF_NBUF_SAMPLE_MAX_SITES;
+	uint32_t i, idx;
+	const char *cur;
+
+	for (i = 0; i < QDF_NBUF_SAMPLE_MAX_SITES; i++) {
+		idx = (start + i) % QDF_NBUF_SAMPLE_MAX_SITES;
+		cur = READ_ONCE(qdf_nbuf_sample_sites[idx].func);
+		if (cur == func)
+			return idx;
+		if (!cur && !cmpxchg(&qdf_nbuf_sample_sites[idx].func,
+				     NULL, func))
+			return idx;
+		if (READ_ONCE(qdf_nbuf_sample_sites[idx].func) == func)
+			return idx;
+	}
+
+	return QDF_NBUF_SAMPLE_INVALID_SITE;
+}
+
+void qdf_nbuf_sampled_track(qdf_nbuf_t nbuf, const char *func, uint32_t line)
+{
+	struct qdf_nbuf_sample_pool *pool;
+	struct qdf_nbuf_sample *rec;
+	uint32_t rate = READ_ONCE(nbuf_sample_rate);
+	unsigned long irq_flag;
+	uint32_t i;
+	int cpu;
+
+	if (!rate || !qdf_nbuf_sample_pools)
+		return;
+
+	if (this_cpu_inc_return(qdf_nbuf_sample_tick) % rate)
+		return;
+
+	cpu = get_cpu();
+	pool = &qdf_nbuf_sample_pools[cpu];
+	spin_lock_irqsave(&pool->lock, irq_flag);
+	rec = pool->free_list;
+	if (rec)
+		pool->free_list = rec->next;
+	else
+		pool->exhausted++;
+	spin_unlock_irqrestore(&pool->lock, irq_flag);
+	put_cpu();
+
+	if (!rec)
+		return;
+
+	rec->nbuf = nbuf;
+	rec->func = func;
+	rec->line = line;
+	rec->cpu = cpu;
+	rec->time = qdf_system_ticks();
+	rec->site = qdf_nbuf_sample_site_get(func);
+	if (rec->site != QDF_NBUF_SAMPLE_INVALID_SITE)
+		qdf_atomic_inc(&qdf_nbuf_sample_sites[rec->site].in_flight);
+	qdf_atomic_inc(&qdf_nbuf_sample_in_flight);
+
+	i = qdf_nbuf_sample_hash(nbuf);
+	spin_lock_irqsave(&qdf_nbuf_sample_lock[i], irq_flag);
+	rec->next = qdf_nbuf_sample_tbl[i];
+	WRITE_ONCE(qdf_nbuf_sample_tbl[i], rec);
+	spin_unlock_irqrestore(&qdf_nbuf_sample_lock[i], irq_flag);
+}
+qdf_export_symbol(qdf_nbuf_sampled_track);
+
+void qdf_nbuf_sampled_untrack(qdf_nbuf_t nbuf)
+{
+	struct qdf_nbuf_sample_pool *pool;
+	struct qdf_nbuf_sample **pp, *rec = NULL;
+	unsigned long irq_flag;
+	uint32_t i;
+
+	if (!qdf_nbuf_sample_pools)
+		return;
+
+	/* Most buckets are empty, keep the common free path lockless */
+	i = qdf_nbuf_sample_hash(nbuf);
+	if (!READ_ONCE(qdf_nbuf_sample_tbl[i]))
+		return;
+
+	if (qdf_nbuf_get_users(nbuf) > 1)
+		return;
+
+	spin_lock_irqsave(&qdf_nbuf_sample_lock[i], irq_flag);
+	for (pp = &qdf_nbuf_sample_tbl[i]; *pp; pp = &(*pp)->next) {
+		if ((*pp)->nbuf == nbuf) {
+			rec = *pp;
+			*pp = rec->next;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&qdf_nbuf_sample_lock[i], irq_flag);
+
+	if (!rec)
+		return;
+
+	if (rec->site != QDF_NBUF_SAMPLE_INVALID_SITE)
+		qdf_atomic_dec(&qdf_nbuf_sample_sites[rec->site].in_flight);
+	qdf_atomic_dec(&qdf_nbuf_sample_in_flight);
+
+	pool = &qdf_nbuf_sample_pools[rec->cpu];
+	spin_lock_irqsave(&pool->lock, irq_flag);
+	rec->next = pool->free_list;
+	pool->free_list = rec;
+	spin_unlock_irqrestore(&pool->lock, irq_flag);
+}
+qdf_export_symbol(qdf_nbuf_sampled_untrack);
+
+void qdf_nbuf_sampled_tracking_dump(uint32_t min_age_ms)
+{
+	uint32_t rate = READ_ONCE(nbuf_sample_rate);
+	struct qdf_nbuf_sample *rec;
+	unsigned long irq_flag;
+	uint32_t i, age_ms, exhausted = 0;
+	int in_flight, cpu;
+
+	if (!qdf_nbuf_sample_pools)
+		return;
+
+	for_each_possible_cpu(cpu)
+		exhausted += qdf_nbuf_sample_pools[cpu].exhausted;
+
+	qdf_nofl_info("nbuf sampling 1/%u: in flight %d, pool exhausted %u",
+		      rate, qdf_atomic_read(&qdf_nbuf_sample_in_flight),
+		      exhausted);
+
+	for (i = 0; i < QDF_NBUF_SAMPLE_MAX_SITES; i++) {
+		if (!qdf_nbuf_sample_sites[i].func)
+			continue;
+
+		in_flight = qdf_atomic_read(&qdf_nbuf_sample_sites[i].in_flight);
+		if (in_flight)
+			qdf_nofl_info("site %s: sampled %d est in flight %llu",
+				      qdf_nbuf_sample_sites[i].func, in_flight,
+				      (uint64_t)in_flight * rate);
+	}
+
+	for (i = 0; i < QDF_NBUF_SAMPLE_HASH_SIZE; i++) {
+		if (!READ_ONCE(qdf_nbuf_sample_tbl[i]))
+			continue;
+
+		spin_lock_irqsave(&qdf_nbuf_sample_lock[i], irq_flag);
+		for (rec = qdf_nbuf_sample_tbl[i]; rec; rec = rec->next) {
+			age_ms = qdf_system_ticks_to_msecs(qdf_system_ticks() -
+							   rec->time);
+			if (age_ms < min_age_ms)
+				continue;
+
+			qdf_nofl_info("nbuf suspected leak: %pK %s:%u age %u ms",
+				      rec->nbuf, rec->func, rec->line, age_ms);
+		}
+		spin_unlock_irqrestore(&qdf_nbuf_sample_lock[i], irq_flag);
+	}
+}
+qdf_export_symbol(qdf_nbuf_sampled_tracking_dump);
+
+void qdf_nbuf_sampled_tracking_init(void)
+{
+	struct qdf_nbuf_sample_pool *pool;
+	uint32_t i;
+	int cpu;
+
+	for (i = 0; i < QDF_NBUF_SAMPLE_HASH_SIZE; i++) {
+		qdf_nbuf_sample_tbl[i] = NULL;
+		spin_lock_init(&qdf_nbuf_sample_lock[i]);
+	}
+
+	for (i = 0; i < QDF_NBUF_SAMPLE_MAX_SITES; i++) {
+		qdf_nbuf_sample_sites[i].func = NULL;
+		qdf_atomic_init(&qdf_nbuf_sample_sites[i].in_flight);
+	}
+	qdf_atomic_init(&qdf_nbuf_sample_in_flight);
+
+	pool = kcalloc(nr_cpu_ids, sizeof(*pool), GFP_KERNEL);
+	if (!pool) {
+		qdf_err("nbuf sampled tracking disabled, no memory");
+		return;
+	}
+
+	for_each_possible_cpu(cpu) {
+		spin_lock_init(&pool[cpu].lock);
+		for (i = 0; i < QDF_NBUF_SAMPLE_RECORDS_PER_CPU; i++) {
+			pool[cpu].records[i].next = pool[cpu].free_list;
+			pool[cpu].free_list = &pool[cpu].records[i];
+		}
+	}
+
+	qdf_nbuf_sample_pools = pool;
+}
+qdf_export_symbol(qdf_nbuf_sampled_tracking_init);
+
+void qdf_nbuf_sampled_tracking_exit(void)
+{
+	struct qdf_nbuf_sample_pool *pool = qdf_nbuf_sample_pools;
+
+	if (!pool)
+		return;
+
+	/* Everything still tracked at unload is leaked */
+	qdf_nbuf_sampled_tracking_dump(0);
+	qdf_nbuf_sample_pools = NULL;
+	kfree(pool);
+}
+qdf_export_symbol(qdf_nbuf_sampled_tracking_exit);
+#endif /* NBUF_SAMPLED_TRACKING && !NBUF_MEMORY_DEBUG */
+
 #if defined(FEATURE_TSO)
 
 /**
@@ -5781,18 +6190,9 @@ static unsigned int qdf_nbuf_update_radiotap_tx_flags(
 	return rtap_len;
 }
 
-/**
- * qdf_nbuf_update_radiotap() - Update radiotap header from rx_status
- * @rx_status: Pointer to rx_status.
- * @nbuf:      nbuf pointer to which radiotap has to be updated
- * @headroom_sz: Available headroom size.
- *
- * Return: length of rtap_len updated.
- */
-unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
-				      qdf_nbuf_t nbuf, uint32_t headroom_sz)
+unsigned int qdf_nbuf_build_radiotap(struct mon_rx_status *rx_status,
+				     uint8_t *rtap_buf)
 {
-	uint8_t rtap_buf[RADIOTAP_HEADER_LEN] = {0};
 	struct ieee80211_radiotap_header *rthdr =
 		(struct ieee80211_radiotap_header *)rtap_buf;
 	uint32_t rtap_hdr_len = sizeof(struct ieee80211_radiotap_header);
@@ -6093,6 +6493,27 @@ unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
 	put_unaligned_le32(it_present_val, it_present);
 	rthdr->it_len = cpu_to_le16(rtap_len);
 
+	return rtap_len;
+}
+
+/**
+ * qdf_nbuf_update_radiotap() - Update radiotap header from rx_status
+ * @rx_status: Pointer to rx_status.
+ * @nbuf:      nbuf pointer to which radiotap has to be updated
+ * @headroom_sz: Available headroom size.
+ *
+ * Return: length of rtap_len updated.
+ */
+unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
+				      qdf_nbuf_t nbuf, uint32_t headroom_sz)
+{
+	uint8_t rtap_buf[RADIOTAP_HEADER_LEN] = {0};
+	unsigned int rtap_len;
+
+	rtap_len = qdf_nbuf_build_radiotap(rx_status, rtap_buf);
+	if (!rtap_len)
+		return 0;
+
 	if (headroom_sz < rtap_len) {
 		qdf_debug("DEBUG: Not enough space to update radiotap");
 		return 0;
@@ -6128,6 +6549,13 @@ static unsigned int qdf_nbuf_update_radiotap_ampdu_flags(
 	return 0;
 }
 
+unsigned int qdf_nbuf_build_radiotap(struct mon_rx_status *rx_status,
+				     uint8_t *rtap_buf)
+{
+	qdf_err("ERROR: struct ieee80211_radiotap_header not supported");
+	return 0;
+}
+
 unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
 				      qdf_nbuf_t nbuf, uint32_t headroom_sz)
 {
@@ -6135,6 +6563,7 @@ unsigned int qdf_nbuf_update_radiotap(struct mon_rx_status *rx_status,
 	return 0;
 }
 #endif
+qdf_export_symbol(qdf_nbuf_build_radiotap);
 qdf_export_symbol(qdf_nbuf_update_radiotap);
 
 /**
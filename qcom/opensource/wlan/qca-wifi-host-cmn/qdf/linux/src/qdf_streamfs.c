@@ -147,3 +147,13 @@ void qdf_streamfs_write(qdf_streamfs_chan_t chan,
 }
 
 qdf_export_symbol(qdf_streamfs_write);
+
+void *qdf_streamfs_reserve(qdf_streamfs_chan_t chan, size_t length)
+{
+	if (!chan)
+		return NULL;
+
+	return relay_reserve(chan, length);
+}
+
+qdf_export_symbol(qdf_streamfs_reserve);
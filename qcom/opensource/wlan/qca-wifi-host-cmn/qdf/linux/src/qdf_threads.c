@@ -314,6 +314,14 @@ void qdf_cpumask_or(qdf_cpu_mask *dstp, qdf_cpu_mask *src1p,
 
 qdf_export_symbol(qdf_cpumask_or);
 
+bool qdf_cpumask_and(qdf_cpu_mask *dstp, const qdf_cpu_mask *src1p,
+		     const qdf_cpu_mask *src2p)
+{
+	return cpumask_and(dstp, src1p, src2p);
+}
+
+qdf_export_symbol(qdf_cpumask_and);
+
 void
 qdf_thread_cpumap_print_to_pagebuf(bool list, char *new_mask_str,
 				   qdf_cpu_mask *new_mask)
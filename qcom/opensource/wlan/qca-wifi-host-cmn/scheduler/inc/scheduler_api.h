@@ -25,6 +25,7 @@
 #include <qdf_lock.h>
 #include <qdf_mc_timer.h>
 #include <qdf_status.h>
+#include <linux/llist.h>
 
 /* Controller thread various event masks
  * MC_POST_EVENT_MASK: wake up thread after posting message
@@ -77,7 +78,7 @@ typedef void (*hdd_suspend_callback)(void);
  *   like PSOC, PDEV, VDEV and PEER. A component needs to populate flush
  *   callback in message body pointer for those messages which have taken ref
  *   count for above mentioned common objects.
- * @node: list node for queue membership
+ * @node: lockless list node for queue and message cache membership
  * @queue_id: Id of the queue the message was added to
  * @queue_depth: depth of the queue when the message was queued
  * @queued_at_us: timestamp when the message was queued in microseconds
@@ -89,7 +90,7 @@ struct scheduler_msg {
 	void *bodyptr;
 	scheduler_msg_process_fn_t callback;
 	scheduler_msg_process_fn_t flush_callback;
-	qdf_list_node_t node;
+	struct llist_node node;
 #ifdef WLAN_SCHED_HISTORY_SIZE
 	QDF_MODULE_ID queue_id;
 	uint32_t queue_depth;
@@ -23,6 +23,7 @@
 #include <qdf_timer.h>
 #include <scheduler_api.h>
 #include <qdf_list.h>
+#include <qdf_atomic.h>
 
 #ifndef SCHEDULER_CORE_MAX_MESSAGES
 #define SCHEDULER_CORE_MAX_MESSAGES 4000
@@ -33,6 +34,11 @@
 #define SCHEDULER_NUMBER_OF_MSG_QUEUE 6
 #define SCHEDULER_WRAPPER_MAX_FAIL_COUNT (SCHEDULER_CORE_MAX_MESSAGES * 3)
 #define SCHEDULER_WATCHDOG_TIMEOUT (10 * 1000) /* 10s */
+/* Free messages kept per CPU, moved from/to the pool in batches */
+#define SCHEDULER_MSG_PCPU_CACHE_SIZE 32
+#define SCHEDULER_MSG_PCPU_BATCH 16
+/* Latency histogram buckets: <100us, <1ms, <10ms, <100ms, <1s, >=1s */
+#define SCHEDULER_LAT_HIST_BUCKETS 6
 
 #ifdef CONFIG_AP_PLATFORM
 #define SCHED_DEBUG_PANIC(msg)
@@ -67,14 +73,40 @@
 
 /**
  * struct scheduler_mq_type -  scheduler message queue
- * @mq_lock: message queue lock
- * @mq_list: message queue list
+ * @mq_in: messages posted by any context, newest first
+ * @mq_in_front: high priority messages posted by any context, newest first
+ * @mq_out: messages owned by the scheduler thread, oldest first
+ * @mq_out_front: high priority messages owned by the scheduler thread
+ * @mq_depth: number of messages in the queue
  * @qid: queue id
+ * @queue_hist: histogram of the time messages waited in the queue
+ * @run_hist: histogram of the time messages took to execute
+ *
+ * Producers push with llist_add() and never take a lock. The scheduler
+ * thread is the only consumer: it moves @mq_in to @mq_out in one
+ * llist_del_all() and reverses it to restore posting order.
  */
 struct scheduler_mq_type {
-	qdf_spinlock_t mq_lock;
-	qdf_list_t mq_list;
+	struct llist_head mq_in;
+	struct llist_head mq_in_front;
+	struct llist_node *mq_out;
+	struct llist_node *mq_out_front;
+	qdf_atomic_t mq_depth;
 	QDF_MODULE_ID qid;
+#ifdef WLAN_SCHED_HISTORY_SIZE
+	uint32_t queue_hist[SCHEDULER_LAT_HIST_BUCKETS];
+	uint32_t run_hist[SCHEDULER_LAT_HIST_BUCKETS];
+#endif
+};
+
+/**
+ * struct scheduler_msg_cache - per CPU cache of free scheduler messages
+ * @head: free messages linked through their node
+ * @count: number of messages in @head
+ */
+struct scheduler_msg_cache {
+	struct llist_node *head;
+	uint32_t count;
 };
 
 /**
@@ -210,7 +242,8 @@ void scheduler_mq_put_front(struct scheduler_mq_type *msg_q,
  * scheduler_mq_get() - to get message from message queue
  * @msg_q: Pointer to the message queue
  *
- * This function is used to get message from given message queue
+ * This function is used to get message from given message queue. It must
+ * only be called by the scheduler thread, or once the thread has exited.
  *
  *  Return: none
  */
@@ -245,4 +278,15 @@ QDF_STATUS scheduler_queues_deinit(struct scheduler_ctx *gp_sch_ctx);
  * Return: none
  */
 void scheduler_queues_flush(struct scheduler_ctx *sched_ctx);
+
+/**
+ * scheduler_mq_depth() - get the number of messages in a queue
+ * @msg_q: Pointer to the message queue
+ *
+ * Return: number of queued messages
+ */
+static inline uint32_t scheduler_mq_depth(struct scheduler_mq_type *msg_q)
+{
+	return qdf_atomic_read(&msg_q->mq_depth);
+}
 #endif
@@ -771,7 +771,7 @@ QDF_STATUS scheduler_get_queue_size(QDF_MODULE_ID qid, uint32_t *size)
 
 	target_mq = &(sched_ctx->queue_ctx.sch_msg_q[qidx]);
 
-	*size = qdf_list_size(&target_mq->mq_list);
+	*size = scheduler_mq_depth(target_mq);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -19,6 +19,7 @@
 
 #include <scheduler_core.h>
 #include <qdf_atomic.h>
+#include <qdf_defer.h>
 #include "qdf_flex_mem.h"
 
 static struct scheduler_ctx g_sched_ctx;
@@ -27,6 +28,8 @@ static struct scheduler_ctx *gp_sched_ctx;
 DEFINE_QDF_FLEX_MEM_POOL(sched_pool, sizeof(struct scheduler_msg),
 			 WLAN_SCHED_REDUCTION_LIMIT);
 
+static struct scheduler_msg_cache sched_msg_cache[QDF_MAX_AVAILABLE_CPU];
+
 #ifdef WLAN_SCHED_HISTORY_SIZE
 
 #define SCHEDULER_HISTORY_HEADER "|Callback                               "\
@@ -63,15 +66,40 @@ struct sched_history_item {
 static struct sched_history_item sched_history[WLAN_SCHED_HISTORY_SIZE];
 static uint32_t sched_history_index;
 
+static const char * const sched_lat_hist_name[SCHEDULER_LAT_HIST_BUCKETS] = {
+	"<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+};
+
+/**
+ * sched_lat_hist_bucket() - get the latency histogram bucket of a duration
+ * @duration_us: duration in microseconds
+ *
+ * Return: bucket index
+ */
+static uint32_t sched_lat_hist_bucket(uint32_t duration_us)
+{
+	uint32_t bucket = 0;
+	uint32_t limit = 100;
+
+	while (bucket < SCHEDULER_LAT_HIST_BUCKETS - 1 &&
+	       duration_us >= limit) {
+		bucket++;
+		limit *= 10;
+	}
+
+	return bucket;
+}
+
 static void sched_history_queue(struct scheduler_mq_type *queue,
 				struct scheduler_msg *msg)
 {
 	msg->queue_id = queue->qid;
-	msg->queue_depth = qdf_list_size(&queue->mq_list);
+	msg->queue_depth = scheduler_mq_depth(queue);
 	msg->queued_at_us = qdf_get_log_timestamp_usecs();
 }
 
-static void sched_history_start(struct scheduler_msg *msg)
+static void sched_history_start(struct scheduler_mq_type *queue,
+				struct scheduler_msg *msg)
 {
 	uint64_t started_at_us = qdf_get_log_timestamp_usecs();
 	struct sched_history_item hist = {
@@ -84,19 +112,46 @@ static void sched_history_start(struct scheduler_msg *msg)
 	};
 
 	sched_history[sched_history_index] = hist;
+	queue->queue_hist[sched_lat_hist_bucket(hist.queue_duration_us)]++;
 }
 
-static void sched_history_stop(void)
+static void sched_history_stop(struct scheduler_mq_type *queue)
 {
 	struct sched_history_item *hist = &sched_history[sched_history_index];
 	uint64_t stopped_at_us = qdf_get_log_timestamp_usecs();
 
 	hist->run_duration_us = stopped_at_us - hist->run_start_us;
+	queue->run_hist[sched_lat_hist_bucket(hist->run_duration_us)]++;
 
 	sched_history_index++;
 	sched_history_index %= WLAN_SCHED_HISTORY_SIZE;
 }
 
+/**
+ * sched_lat_hist_print() - print the per queue latency histograms
+ *
+ * Return: None
+ */
+static void sched_lat_hist_print(void)
+{
+	struct scheduler_mq_type *queue;
+	uint32_t i, b;
+
+	if (!gp_sched_ctx)
+		return;
+
+	for (i = 0; i < SCHEDULER_NUMBER_OF_MSG_QUEUE; i++) {
+		queue = &gp_sched_ctx->queue_ctx.sch_msg_q[i];
+		sched_nofl_fatal("Queue %d (qid %d) depth %u",
+				 i, queue->qid, scheduler_mq_depth(queue));
+		for (b = 0; b < SCHEDULER_LAT_HIST_BUCKETS; b++)
+			sched_nofl_fatal("  %7s: queued %10u run %10u",
+					 sched_lat_hist_name[b],
+					 queue->queue_hist[b],
+					 queue->run_hist[b]);
+	}
+}
+
 void sched_history_print(void)
 {
 	struct sched_history_item *history, *item;
@@ -135,13 +190,16 @@ void sched_history_print(void)
 	sched_nofl_fatal(SCHEDULER_HISTORY_LINE);
 
 	qdf_mem_free(history);
+
+	sched_lat_hist_print();
 }
 #else /* WLAN_SCHED_HISTORY_SIZE */
 
 static inline void sched_history_queue(struct scheduler_mq_type *queue,
 				       struct scheduler_msg *msg) { }
-static inline void sched_history_start(struct scheduler_msg *msg) { }
-static inline void sched_history_stop(void) { }
+static inline void sched_history_start(struct scheduler_mq_type *queue,
+				       struct scheduler_msg *msg) { }
+static inline void sched_history_stop(struct scheduler_mq_type *queue) { }
 void sched_history_print(void) { }
 
 #endif /* WLAN_SCHED_HISTORY_SIZE */
@@ -154,9 +212,34 @@ QDF_STATUS scheduler_create_ctx(void)
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * scheduler_msg_cache_drain() - return the messages of all per CPU caches
+ *                               to the pool
+ *
+ * Return: None
+ */
+static void scheduler_msg_cache_drain(void)
+{
+	struct scheduler_msg_cache *cache;
+	struct scheduler_msg *msg;
+	int cpu;
+
+	for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+		cache = &sched_msg_cache[cpu];
+		while (cache->head) {
+			msg = llist_entry(cache->head, struct scheduler_msg,
+					  node);
+			cache->head = cache->head->next;
+			qdf_flex_mem_free(&sched_pool, msg);
+		}
+		cache->count = 0;
+	}
+}
+
 QDF_STATUS scheduler_destroy_ctx(void)
 {
 	gp_sched_ctx = NULL;
+	scheduler_msg_cache_drain();
 	qdf_flex_mem_deinit(&sched_pool);
 
 	return QDF_STATUS_SUCCESS;
@@ -173,8 +256,11 @@ static QDF_STATUS scheduler_mq_init(struct scheduler_mq_type *msg_q)
 {
 	sched_enter();
 
-	qdf_spinlock_create(&msg_q->mq_lock);
-	qdf_list_create(&msg_q->mq_list, SCHEDULER_CORE_MAX_MESSAGES);
+	init_llist_head(&msg_q->mq_in);
+	init_llist_head(&msg_q->mq_in_front);
+	msg_q->mq_out = NULL;
+	msg_q->mq_out_front = NULL;
+	qdf_atomic_init(&msg_q->mq_depth);
 
 	sched_exit();
 
@@ -185,8 +271,9 @@ static void scheduler_mq_deinit(struct scheduler_mq_type *msg_q)
 {
 	sched_enter();
 
-	qdf_list_destroy(&msg_q->mq_list);
-	qdf_spinlock_destroy(&msg_q->mq_lock);
+	if (scheduler_mq_depth(msg_q))
+		sched_err("qid %d deinit with %u messages", msg_q->qid,
+			  scheduler_mq_depth(msg_q));
 
 	sched_exit();
 }
@@ -251,34 +338,57 @@ static QDF_STATUS scheduler_all_queues_deinit(struct scheduler_ctx *sched_ctx)
 void scheduler_mq_put(struct scheduler_mq_type *msg_q,
 		      struct scheduler_msg *msg)
 {
-	qdf_spin_lock_irqsave(&msg_q->mq_lock);
 	sched_history_queue(msg_q, msg);
-	qdf_list_insert_back(&msg_q->mq_list, &msg->node);
-	qdf_spin_unlock_irqrestore(&msg_q->mq_lock);
+	qdf_atomic_inc(&msg_q->mq_depth);
+	llist_add(&msg->node, &msg_q->mq_in);
 }
 
 void scheduler_mq_put_front(struct scheduler_mq_type *msg_q,
 			    struct scheduler_msg *msg)
 {
-	qdf_spin_lock_irqsave(&msg_q->mq_lock);
 	sched_history_queue(msg_q, msg);
-	qdf_list_insert_front(&msg_q->mq_list, &msg->node);
-	qdf_spin_unlock_irqrestore(&msg_q->mq_lock);
+	qdf_atomic_inc(&msg_q->mq_depth);
+	llist_add(&msg->node, &msg_q->mq_in_front);
 }
 
-struct scheduler_msg *scheduler_mq_get(struct scheduler_mq_type *msg_q)
+/**
+ * scheduler_mq_pop() - pop the oldest message of a producer list
+ * @in: producer list, newest first
+ * @out: consumer list, oldest first
+ *
+ * Return: list node of the message, NULL if both lists are empty
+ */
+static struct llist_node *scheduler_mq_pop(struct llist_head *in,
+					   struct llist_node **out)
 {
-	QDF_STATUS status;
-	qdf_list_node_t *node;
+	struct llist_node *node = *out;
+
+	if (!node) {
+		node = llist_del_all(in);
+		if (!node)
+			return NULL;
+
+		node = llist_reverse_order(node);
+	}
+
+	*out = node->next;
 
-	qdf_spin_lock_irqsave(&msg_q->mq_lock);
-	status = qdf_list_remove_front(&msg_q->mq_list, &node);
-	qdf_spin_unlock_irqrestore(&msg_q->mq_lock);
+	return node;
+}
 
-	if (QDF_IS_STATUS_ERROR(status))
+struct scheduler_msg *scheduler_mq_get(struct scheduler_mq_type *msg_q)
+{
+	struct llist_node *node;
+
+	node = scheduler_mq_pop(&msg_q->mq_in_front, &msg_q->mq_out_front);
+	if (!node)
+		node = scheduler_mq_pop(&msg_q->mq_in, &msg_q->mq_out);
+	if (!node)
 		return NULL;
 
-	return qdf_container_of(node, struct scheduler_msg, node);
+	qdf_atomic_dec(&msg_q->mq_depth);
+
+	return llist_entry(node, struct scheduler_msg, node);
 }
 
 QDF_STATUS scheduler_queues_deinit(struct scheduler_ctx *sched_ctx)
@@ -310,6 +420,77 @@ QDF_STATUS scheduler_queues_init(struct scheduler_ctx *sched_ctx)
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * scheduler_msg_alloc() - allocate a message from the per CPU cache
+ *
+ * An empty cache is refilled with a batch of messages from the pool.
+ *
+ * Return: message, NULL if the pool is exhausted
+ */
+static struct scheduler_msg *scheduler_msg_alloc(void)
+{
+	struct scheduler_msg_cache *cache;
+	struct scheduler_msg *msg = NULL;
+
+	qdf_local_bh_disable();
+	cache = &sched_msg_cache[qdf_get_cpu()];
+
+	if (!cache->count) {
+		while (cache->count < SCHEDULER_MSG_PCPU_BATCH) {
+			msg = qdf_flex_mem_alloc(&sched_pool);
+			if (!msg)
+				break;
+
+			msg->node.next = cache->head;
+			cache->head = &msg->node;
+			cache->count++;
+		}
+	}
+
+	msg = NULL;
+	if (cache->head) {
+		msg = llist_entry(cache->head, struct scheduler_msg, node);
+		cache->head = cache->head->next;
+		cache->count--;
+	}
+	qdf_local_bh_enable();
+
+	return msg;
+}
+
+/**
+ * scheduler_msg_release() - release a message to the per CPU cache
+ * @msg: message to release
+ *
+ * A full cache returns a batch of messages to the pool first.
+ *
+ * Return: None
+ */
+static void scheduler_msg_release(struct scheduler_msg *msg)
+{
+	struct scheduler_msg_cache *cache;
+	struct scheduler_msg *first;
+
+	qdf_local_bh_disable();
+	cache = &sched_msg_cache[qdf_get_cpu()];
+
+	if (cache->count >= SCHEDULER_MSG_PCPU_CACHE_SIZE) {
+		while (cache->count > SCHEDULER_MSG_PCPU_CACHE_SIZE -
+				      SCHEDULER_MSG_PCPU_BATCH) {
+			first = llist_entry(cache->head, struct scheduler_msg,
+					    node);
+			cache->head = cache->head->next;
+			cache->count--;
+			qdf_flex_mem_free(&sched_pool, first);
+		}
+	}
+
+	msg->node.next = cache->head;
+	cache->head = &msg->node;
+	cache->count++;
+	qdf_local_bh_enable();
+}
+
 struct scheduler_msg *scheduler_core_msg_dup(struct scheduler_msg *msg)
 {
 	struct scheduler_msg *dup;
@@ -318,7 +499,7 @@ struct scheduler_msg *scheduler_core_msg_dup(struct scheduler_msg *msg)
 	    SCHEDULER_CORE_MAX_MESSAGES)
 		goto buffer_full;
 
-	dup = qdf_flex_mem_alloc(&sched_pool);
+	dup = scheduler_msg_alloc();
 	if (!dup) {
 		sched_err("out of memory");
 		goto dec_queue_count;
@@ -344,7 +525,7 @@ dec_queue_count:
 
 void scheduler_core_msg_free(struct scheduler_msg *msg)
 {
-	qdf_flex_mem_free(&sched_pool, msg);
+	scheduler_msg_release(msg);
 	qdf_atomic_dec(&__sched_queue_depth);
 }
 
@@ -391,13 +572,14 @@ static void scheduler_thread_process_queues(struct scheduler_ctx *sch_ctx,
 			sch_ctx->watchdog_msg_type = msg->type;
 			sch_ctx->watchdog_callback = msg->callback;
 
-			sched_history_start(msg);
+			sched_history_start(&sch_ctx->queue_ctx.sch_msg_q[i],
+					    msg);
 			qdf_timer_start(&sch_ctx->watchdog_timer,
 					sch_ctx->timeout);
 			status = sch_ctx->queue_ctx.
 					scheduler_msg_process_fn[i](msg);
 			qdf_timer_stop(&sch_ctx->watchdog_timer);
-			sched_history_stop();
+			sched_history_stop(&sch_ctx->queue_ctx.sch_msg_q[i]);
 
 			if (QDF_IS_STATUS_ERROR(status))
 				sched_err("Failed processing Qid[%d] message",
@@ -84,6 +84,8 @@
  * @psptrl_target_handle: reference to spectral lmac object
  * @skb:                  Socket buffer for sending samples to applications
  * @spectral_pid :        Spectral port ID
+ * @stream:               Shared memory ring for samples, see
+ *                        os_if_spectral_netlink.c
  */
 struct pdev_spectral {
 	struct wlan_objmgr_pdev *psptrl_pdev;
@@ -91,6 +93,7 @@ struct pdev_spectral {
 	void *psptrl_target_handle;
 	struct sk_buff *skb[SPECTRAL_MSG_TYPE_MAX];
 	uint32_t spectral_pid;
+	struct os_if_spectral_stream *stream;
 };
 
 struct spectral_wmi_ops;
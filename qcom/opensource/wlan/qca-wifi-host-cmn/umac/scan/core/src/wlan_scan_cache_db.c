@@ -298,6 +298,11 @@ static QDF_STATUS scm_del_scan_node_from_db(struct scan_dbs *scan_db,
 	if (!scan_node)
 		return QDF_STATUS_E_INVAL;
 
+	hash_idx = scm_get_ssid_hash(&scan_node->entry->ssid);
+	qdf_list_remove_node(&scan_db->ssid_hash_tbl[hash_idx],
+			     &scan_node->ssid_node);
+	qdf_list_remove_node(&scan_db->age_list, &scan_node->age_node);
+
 	hash_idx = SCAN_GET_HASH(scan_node->entry->bssid.bytes);
 	scm_del_scan_node(&scan_db->scan_hash_tbl[hash_idx], scan_node);
 	scan_db->num_entries--;
@@ -421,6 +426,11 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
 		qdf_list_insert_before(&scan_db->scan_hash_tbl[hash_idx],
 				       &scan_node->node, &dup_node->node);
 
+	hash_idx = scm_get_ssid_hash(&scan_node->entry->ssid);
+	qdf_list_insert_back(&scan_db->ssid_hash_tbl[hash_idx],
+			     &scan_node->ssid_node);
+	qdf_list_insert_back(&scan_db->age_list, &scan_node->age_node);
+
 	scan_db->num_entries++;
 }
 
@@ -430,6 +440,7 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
  * the list
  * @list: hash list
  * @cur_node: current node pointer
+ * @offset: offset of the list node in struct scan_cache_node
  *
  * API to get next active node from the list. If cur_node is NULL
  * it will return first node of the list.
@@ -439,7 +450,7 @@ static void scm_add_scan_node(struct scan_dbs *scan_db,
  */
 static qdf_list_node_t *
 scm_get_next_valid_node(qdf_list_t *list,
-	qdf_list_node_t *cur_node)
+	qdf_list_node_t *cur_node, size_t offset)
 {
 	qdf_list_node_t *next_node = NULL;
 	qdf_list_node_t *temp_node = NULL;
@@ -451,8 +462,8 @@ scm_get_next_valid_node(qdf_list_t *list,
 		qdf_list_peek_front(list, &next_node);
 
 	while (next_node) {
-		scan_node = qdf_container_of(next_node,
-			struct scan_cache_node, node);
+		scan_node = (struct scan_cache_node *)
+				((uint8_t *)next_node - offset);
 		if (scan_node->cookie == SCAN_NODE_ACTIVE_COOKIE)
 			return next_node;
 		/*
@@ -468,11 +479,12 @@ scm_get_next_valid_node(qdf_list_t *list,
 }
 
 /**
- * scm_get_next_node() - API get the next scan node from
- * the list
+ * scm_get_next_node_in() - API get the next scan node from
+ * one of the scan db lists
  * @scan_db: scan data base
- * @list: hash list
+ * @list: hash or age list
  * @cur_node: current node pointer
+ * @offset: offset of the list node of @list in struct scan_cache_node
  *
  * API get the next node from the list. If cur_node is NULL
  * it will return first node of the list
@@ -480,25 +492,27 @@ scm_get_next_valid_node(qdf_list_t *list,
  * Return: next scan cache node
  */
 static struct scan_cache_node *
-scm_get_next_node(struct scan_dbs *scan_db,
-	qdf_list_t *list, struct scan_cache_node *cur_node)
+scm_get_next_node_in(struct scan_dbs *scan_db, qdf_list_t *list,
+		     struct scan_cache_node *cur_node, size_t offset)
 {
 	struct scan_cache_node *next_node = NULL;
 	qdf_list_node_t *next_list = NULL;
 
 	qdf_spin_lock_bh(&scan_db->scan_db_lock);
 	if (cur_node) {
-		next_list = scm_get_next_valid_node(list, &cur_node->node);
+		next_list = scm_get_next_valid_node(list,
+				(qdf_list_node_t *)((uint8_t *)cur_node +
+						    offset), offset);
 		/* Decrement the ref count of the previous node */
 		scm_scan_entry_put_ref(scan_db,
 			cur_node, false);
 	} else {
-		next_list = scm_get_next_valid_node(list, NULL);
+		next_list = scm_get_next_valid_node(list, NULL, offset);
 	}
 	/* Increase the ref count of the obtained node */
 	if (next_list) {
-		next_node = qdf_container_of(next_list,
-			struct scan_cache_node, node);
+		next_node = (struct scan_cache_node *)
+				((uint8_t *)next_list - offset);
 		scm_scan_entry_get_ref(next_node);
 	}
 	qdf_spin_unlock_bh(&scan_db->scan_db_lock);
@@ -506,6 +520,38 @@ scm_get_next_node(struct scan_dbs *scan_db,
 	return next_node;
 }
 
+/**
+ * scm_get_next_node() - API get the next scan node from
+ * the bssid hash list
+ * @scan_db: scan data base
+ * @list: hash list
+ * @cur_node: current node pointer
+ *
+ * Return: next scan cache node
+ */
+static struct scan_cache_node *
+scm_get_next_node(struct scan_dbs *scan_db,
+	qdf_list_t *list, struct scan_cache_node *cur_node)
+{
+	return scm_get_next_node_in(scan_db, list, cur_node,
+			qdf_offsetof(struct scan_cache_node, node));
+}
+
+/**
+ * scm_get_next_age_node() - API get the next scan node in receive order
+ * @scan_db: scan data base
+ * @cur_node: current node pointer, NULL for the oldest node
+ *
+ * Return: next scan cache node
+ */
+static struct scan_cache_node *
+scm_get_next_age_node(struct scan_dbs *scan_db,
+		      struct scan_cache_node *cur_node)
+{
+	return scm_get_next_node_in(scan_db, &scan_db->age_list, cur_node,
+			qdf_offsetof(struct scan_cache_node, age_node));
+}
+
 /**
  * scm_check_and_age_out() - check and age out the old entries
  * @scan_db: scan db
@@ -581,11 +627,11 @@ scm_bss_is_nontx_of_conn_bss(struct scan_cache_node *conn_node,
 void scm_age_out_entries(struct wlan_objmgr_psoc *psoc,
 	struct scan_dbs *scan_db)
 {
-	int i;
 	struct scan_cache_node *cur_node = NULL;
 	struct scan_cache_node *next_node = NULL;
 	struct scan_cache_node *conn_node = NULL;
 	struct scan_default_params *def_param;
+	bool conn_lookup_done = false;
 
 	def_param = wlan_scan_psoc_get_def_params(psoc);
 	if (!def_param) {
@@ -593,26 +639,34 @@ void scm_age_out_entries(struct wlan_objmgr_psoc *psoc,
 		return;
 	}
 
-	conn_node = scm_get_conn_node(scan_db);
-	for (i = 0 ; i < SCAN_HASH_SIZE; i++) {
-		cur_node = scm_get_next_node(scan_db,
-			&scan_db->scan_hash_tbl[i], NULL);
-		while (cur_node) {
-			if (!conn_node /* if there is no connected node */ ||
-			    /* OR cur_node is not part of the MBSSID of the
-			     * connected node
-			     */
-			    (!scm_bss_is_connected(cur_node->entry) &&
-			     !scm_bss_is_nontx_of_conn_bss(conn_node,
-							  cur_node))) {
-				scm_check_and_age_out(scan_db, cur_node,
-					def_param->scan_cache_aging_time);
-			}
-			next_node = scm_get_next_node(scan_db,
-				&scan_db->scan_hash_tbl[i], cur_node);
-			cur_node = next_node;
-			next_node = NULL;
+	/*
+	 * age_list is in receive order, so only its aged out head has to be
+	 * visited. The walk stops at the first entry that is still fresh.
+	 */
+	cur_node = scm_get_next_age_node(scan_db, NULL);
+	while (cur_node) {
+		if (util_scan_entry_age(cur_node->entry) <
+		    def_param->scan_cache_aging_time) {
+			scm_scan_entry_put_ref(scan_db, cur_node, true);
+			break;
 		}
+		/* only look the connected node up if there is work to do */
+		if (!conn_lookup_done) {
+			conn_node = scm_get_conn_node(scan_db);
+			conn_lookup_done = true;
+		}
+		if (!conn_node /* if there is no connected node */ ||
+		    /* OR cur_node is not part of the MBSSID of the
+		     * connected node
+		     */
+		    (!scm_bss_is_connected(cur_node->entry) &&
+		     !scm_bss_is_nontx_of_conn_bss(conn_node, cur_node))) {
+			scm_check_and_age_out(scan_db, cur_node,
+				def_param->scan_cache_aging_time);
+		}
+		next_node = scm_get_next_age_node(scan_db, cur_node);
+		cur_node = next_node;
+		next_node = NULL;
 	}
 
 	if (conn_node)
@@ -628,38 +682,10 @@ void scm_age_out_entries(struct wlan_objmgr_psoc *psoc,
  */
 static QDF_STATUS scm_flush_oldest_entry(struct scan_dbs *scan_db)
 {
-	int i;
-	struct scan_cache_node *oldest_node = NULL;
-	struct scan_cache_node *cur_node;
-
-	for (i = 0 ; i < SCAN_HASH_SIZE; i++) {
-		/* Get the first valid node for the hash */
-		cur_node = scm_get_next_node(scan_db,
-					     &scan_db->scan_hash_tbl[i],
-					     NULL);
-		 /* Iterate scan db and flush out oldest node
-		  * take ref_cnt for oldest_node
-		  */
+	struct scan_cache_node *oldest_node;
 
-		while (cur_node) {
-			if (!oldest_node ||
-			   (util_scan_entry_age(oldest_node->entry) <
-			    util_scan_entry_age(cur_node->entry))) {
-				if (oldest_node)
-					scm_scan_entry_put_ref(scan_db,
-							       oldest_node,
-							       true);
-				qdf_spin_lock_bh(&scan_db->scan_db_lock);
-				oldest_node = cur_node;
-				scm_scan_entry_get_ref(oldest_node);
-				qdf_spin_unlock_bh(&scan_db->scan_db_lock);
-			}
-
-			cur_node = scm_get_next_node(scan_db,
-					&scan_db->scan_hash_tbl[i],
-					cur_node);
-		};
-	}
+	/* The head of age_list is the oldest node, take ref_cnt for it */
+	oldest_node = scm_get_next_age_node(scan_db, NULL);
 
 	if (oldest_node) {
 		scm_debug("Flush oldest BSSID: "QDF_MAC_ADDR_FMT" with age %lu ms",
@@ -1453,36 +1479,141 @@ scm_scan_apply_filter_get_entry(struct wlan_objmgr_psoc *psoc,
 }
 
 /**
- * scm_get_results() - Iterate and get scan results
+ * scm_get_results_from_list() - Iterate one scan db list and get results
  * @psoc: psoc ptr
  * @scan_db: scan db
  * @filter: filter to be applied
  * @scan_list: scan list to which entry is added
+ * @list: bssid or ssid hash list to walk
+ * @offset: offset of the list node of @list in struct scan_cache_node
  *
  * Return: void
  */
-static void scm_get_results(struct wlan_objmgr_psoc *psoc,
+static void scm_get_results_from_list(struct wlan_objmgr_psoc *psoc,
 	struct scan_dbs *scan_db, struct scan_filter *filter,
-	qdf_list_t *scan_list)
+	qdf_list_t *scan_list, qdf_list_t *list, size_t offset)
 {
-	int i, count;
 	struct scan_cache_node *cur_node;
 	struct scan_cache_node *next_node = NULL;
 
-	for (i = 0 ; i < SCAN_HASH_SIZE; i++) {
-		cur_node = scm_get_next_node(scan_db,
-			   &scan_db->scan_hash_tbl[i], NULL);
-		count = qdf_list_size(&scan_db->scan_hash_tbl[i]);
-		if (!count)
+	if (!qdf_list_size(list))
+		return;
+
+	cur_node = scm_get_next_node_in(scan_db, list, NULL, offset);
+	while (cur_node) {
+		scm_scan_apply_filter_get_entry(psoc,
+			cur_node->entry, filter, scan_list);
+		next_node = scm_get_next_node_in(scan_db, list, cur_node,
+						 offset);
+		cur_node = next_node;
+	}
+}
+
+/**
+ * scm_get_results_by_ssid() - get scan results through the ssid index
+ * @psoc: psoc ptr
+ * @scan_db: scan db
+ * @filter: filter with at least one ssid
+ * @scan_list: scan list to which entry is added
+ *
+ * An entry can only match such a filter if its ssid is in the filter or,
+ * for OWE transition mode, if it is hidden. So only the buckets of the
+ * filter ssids and the hidden ssid bucket have to be visited.
+ *
+ * Return: void
+ */
+static void scm_get_results_by_ssid(struct wlan_objmgr_psoc *psoc,
+	struct scan_dbs *scan_db, struct scan_filter *filter,
+	qdf_list_t *scan_list)
+{
+	struct wlan_ssid hidden_ssid = {0};
+	struct wlan_ssid *ssid;
+	/* one bit per bucket, SCAN_SSID_HASH_SIZE is 64 */
+	uint64_t visited = 0;
+	uint8_t hash_idx;
+	int i;
+
+	for (i = 0; i <= filter->num_of_ssid; i++) {
+		if (i < filter->num_of_ssid)
+			ssid = &filter->ssid_list[i];
+		else
+			ssid = &hidden_ssid;
+		hash_idx = scm_get_ssid_hash(ssid);
+		if (visited & (1ULL << hash_idx))
 			continue;
-		while (cur_node) {
-			scm_scan_apply_filter_get_entry(psoc,
-				cur_node->entry, filter, scan_list);
-			next_node = scm_get_next_node(scan_db,
-				&scan_db->scan_hash_tbl[i], cur_node);
-			cur_node = next_node;
-		}
+		visited |= 1ULL << hash_idx;
+		scm_get_results_from_list(psoc, scan_db, filter, scan_list,
+			&scan_db->ssid_hash_tbl[hash_idx],
+			qdf_offsetof(struct scan_cache_node, ssid_node));
+	}
+}
+
+/**
+ * scm_get_results_by_bssid() - get scan results through the bssid hash
+ * @psoc: psoc ptr
+ * @scan_db: scan db
+ * @filter: filter with at least one bssid
+ * @scan_list: scan list to which entry is added
+ *
+ * Return: false if the filter has a wildcard bssid and the whole db has
+ * to be walked instead
+ */
+static bool scm_get_results_by_bssid(struct wlan_objmgr_psoc *psoc,
+	struct scan_dbs *scan_db, struct scan_filter *filter,
+	qdf_list_t *scan_list)
+{
+	/* one bit per bucket, SCAN_HASH_SIZE is 64 */
+	uint64_t visited = 0;
+	uint8_t hash_idx;
+	int i;
+
+	for (i = 0; i < filter->num_of_bssid; i++) {
+		if (qdf_is_macaddr_zero(&filter->bssid_list[i]) ||
+		    qdf_is_macaddr_broadcast(&filter->bssid_list[i]))
+			return false;
+	}
+
+	for (i = 0; i < filter->num_of_bssid; i++) {
+		hash_idx = SCAN_GET_HASH(filter->bssid_list[i].bytes);
+		if (visited & (1ULL << hash_idx))
+			continue;
+		visited |= 1ULL << hash_idx;
+		scm_get_results_from_list(psoc, scan_db, filter, scan_list,
+			&scan_db->scan_hash_tbl[hash_idx],
+			qdf_offsetof(struct scan_cache_node, node));
+	}
+
+	return true;
+}
+
+/**
+ * scm_get_results() - Iterate and get scan results
+ * @psoc: psoc ptr
+ * @scan_db: scan db
+ * @filter: filter to be applied
+ * @scan_list: scan list to which entry is added
+ *
+ * Return: void
+ */
+static void scm_get_results(struct wlan_objmgr_psoc *psoc,
+	struct scan_dbs *scan_db, struct scan_filter *filter,
+	qdf_list_t *scan_list)
+{
+	int i;
+
+	if (filter && filter->num_of_ssid) {
+		scm_get_results_by_ssid(psoc, scan_db, filter, scan_list);
+		return;
 	}
+
+	if (filter && filter->num_of_bssid &&
+	    scm_get_results_by_bssid(psoc, scan_db, filter, scan_list))
+		return;
+
+	for (i = 0 ; i < SCAN_HASH_SIZE; i++)
+		scm_get_results_from_list(psoc, scan_db, filter, scan_list,
+			&scan_db->scan_hash_tbl[i],
+			qdf_offsetof(struct scan_cache_node, node));
 }
 
 QDF_STATUS scm_purge_scan_results(qdf_list_t *scan_list)
@@ -1862,6 +1993,10 @@ QDF_STATUS scm_db_init(struct wlan_objmgr_psoc *psoc)
 		for (j = 0; j < SCAN_HASH_SIZE; j++)
 			qdf_list_create(&scan_db->scan_hash_tbl[j],
 				MAX_SCAN_CACHE_SIZE);
+		for (j = 0; j < SCAN_SSID_HASH_SIZE; j++)
+			qdf_list_create(&scan_db->ssid_hash_tbl[j],
+				MAX_SCAN_CACHE_SIZE);
+		qdf_list_create(&scan_db->age_list, MAX_SCAN_CACHE_SIZE);
 	}
 	return QDF_STATUS_SUCCESS;
 }
@@ -1887,6 +2022,9 @@ QDF_STATUS scm_db_deinit(struct wlan_objmgr_psoc *psoc)
 		scm_flush_scan_entries(psoc, scan_db, NULL);
 		for (j = 0; j < SCAN_HASH_SIZE; j++)
 			qdf_list_destroy(&scan_db->scan_hash_tbl[j]);
+		for (j = 0; j < SCAN_SSID_HASH_SIZE; j++)
+			qdf_list_destroy(&scan_db->ssid_hash_tbl[j]);
+		qdf_list_destroy(&scan_db->age_list);
 		qdf_spinlock_destroy(&scan_db->scan_db_lock);
 	}
 
@@ -34,17 +34,42 @@
 #define SCAN_GET_HASH(addr) \
 	(((const uint8_t *)(addr))[QDF_MAC_ADDR_SIZE - 1] % SCAN_HASH_SIZE)
 
+#define SCAN_SSID_HASH_SIZE 64
+
 #define ADJACENT_CHANNEL_RSSI_THRESHOLD -80
 
+/**
+ * scm_get_ssid_hash() - get the ssid index bucket of an ssid
+ * @ssid: ssid, hidden ssids (length 0) all land in bucket 0
+ *
+ * Return: bucket index in scan_dbs->ssid_hash_tbl
+ */
+static inline uint8_t scm_get_ssid_hash(const struct wlan_ssid *ssid)
+{
+	uint32_t hash = 0;
+	uint8_t i;
+
+	for (i = 0; i < ssid->length; i++)
+		hash = hash * 31 + ssid->ssid[i];
+
+	return hash % SCAN_SSID_HASH_SIZE;
+}
+
 /**
  * struct scan_dbs - scan cache data base definition
  * @num_entries: number of scan entries
  * @scan_hash_tbl: link list of bssid hashed scan cache entries for a pdev
+ * @ssid_hash_tbl: the same entries hashed by ssid, used for candidate lookup
+ * @age_list: the same entries in insertion order, oldest first. Every
+ *  beacon/probe update inserts a new node, so this is also receive order
+ *  and aging only has to look at the head.
  */
 struct scan_dbs {
 	uint32_t num_entries;
 	qdf_spinlock_t scan_db_lock;
 	qdf_list_t scan_hash_tbl[SCAN_HASH_SIZE];
+	qdf_list_t ssid_hash_tbl[SCAN_SSID_HASH_SIZE];
+	qdf_list_t age_list;
 };
 
 /**
@@ -25,13 +25,32 @@
 #define _I_WBUFF_H
 
 #include <qdf_nbuf.h>
+#include <qdf_atomic.h>
+#include <qdf_defer.h>
+#include <qdf_util.h>
 #include <wbuff.h>
 
-#define WBUFF_MODULE_ID_SHIFT 4
-#define WBUFF_MODULE_ID_BITMASK 0xF0
+#define WBUFF_MODULE_ID_SHIFT 5
+#define WBUFF_MODULE_ID_BITMASK 0x1E0
 
 #define WBUFF_POOL_ID_SHIFT 1
-#define WBUFF_POOL_ID_BITMASK 0xE
+#define WBUFF_POOL_ID_BITMASK 0x1E
+
+/* Max number of buffers held in the per CPU cache of a pool */
+#define WBUFF_PCPU_CACHE_SIZE 8
+/* Number of buffers moved between a per CPU cache and its pool at once */
+#define WBUFF_PCPU_BATCH (WBUFF_PCPU_CACHE_SIZE / 2)
+/* Pools smaller than this are not fronted by per CPU caches */
+#define WBUFF_PCPU_MIN_POOL_SIZE 64
+
+/* Number of misses after which a pool is grown */
+#define WBUFF_GROW_MISS_THRESH 8
+/* Number of buffers a pool is grown or shrunk by at once */
+#define WBUFF_RESIZE_STEP 16
+/* A pool can grow up to this factor of its registered size */
+#define WBUFF_GROW_MAX_FACTOR 4
+/* Time without misses after which a grown pool is shrunk */
+#define WBUFF_SHRINK_IDLE_MS 10000
 
 /**
  * struct wbuff_handle - wbuff handle to the registered module
@@ -41,23 +60,53 @@ struct wbuff_handle {
 	uint8_t id;
 };
 
+/**
+ * struct wbuff_pcpu_cache - per CPU front cache of a wbuff pool
+ * @head: list of cached buffers
+ * @count: number of buffers in @head
+ */
+struct wbuff_pcpu_cache {
+	qdf_nbuf_t head;
+	uint16_t count;
+};
+
 /**
  * struct wbuff_pool - structure representing wbuff pool
  * @initialized: To identify whether pool is initialized
+ * @pcpu_enabled: To identify whether per CPU caches are used for this pool
  * @pool: nbuf pool
  * @buffer_size: size of the buffer in this @pool
  * @pool_id: pool identifier
+ * @pool_size: number of buffers registered for this pool
+ * @cur_size: number of buffers currently owned by this pool
+ * @free_count: number of buffers in @pool
+ * @miss_cnt: misses since the pool was last grown
+ * @last_miss_ts: system timestamp (ms) of the last miss
+ * @pcpu_cache: per CPU front caches of @pool
  * @alloc_success: Successful allocations for this pool
  * @alloc_fail: Failed allocations for this pool
+ * @pcpu_hit: Allocations served by the per CPU caches
+ * @grow_cnt: Number of times this pool has been grown
+ * @shrink_cnt: Number of times this pool has been shrunk
  * @mem_alloc: Memory allocated for this pool
  */
 struct wbuff_pool {
 	bool initialized;
+	bool pcpu_enabled;
 	qdf_nbuf_t pool;
 	uint16_t buffer_size;
 	uint8_t pool_id;
+	uint16_t pool_size;
+	uint16_t cur_size;
+	uint16_t free_count;
+	uint16_t miss_cnt;
+	unsigned long last_miss_ts;
+	struct wbuff_pcpu_cache pcpu_cache[QDF_MAX_AVAILABLE_CPU];
 	uint64_t alloc_success;
 	uint64_t alloc_fail;
+	uint64_t pcpu_hit;
+	uint32_t grow_cnt;
+	uint32_t shrink_cnt;
 	uint64_t mem_alloc;
 };
 
@@ -74,7 +123,7 @@ struct wbuff_pool {
  */
 struct wbuff_module {
 	bool registered;
-	uint16_t pending_returns;
+	qdf_atomic_t pending_returns;
 	qdf_spinlock_t lock;
 	struct wbuff_handle handle;
 	int reserve;
@@ -86,6 +135,7 @@ struct wbuff_module {
  * struct wbuff_holder - allocation holder for wbuff
  * @initialized: to identified whether module is initialized
  * @pf_cache: Reference to page frag cache, used for nbuf allocations
+ * @resize_work: work to grow or shrink the pools
  * @wbuff_debugfs_dir: wbuff debugfs root directory
  * @wbuff_stats_dentry: wbuff debugfs stats file
  */
@@ -93,6 +143,7 @@ struct wbuff_holder {
 	bool initialized;
 	struct wbuff_module mod[WBUFF_MAX_MODULES];
 	qdf_frag_cache_t pf_cache;
+	qdf_work_t resize_work;
 	struct dentry *wbuff_debugfs_dir;
 	struct dentry *wbuff_stats_dentry;
 };
@@ -25,7 +25,10 @@
 #include <wbuff.h>
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
+#include <linux/rcupdate.h>
+#include <linux/math64.h>
 #include <qdf_debugfs.h>
+#include <qdf_time.h>
 #include "i_wbuff.h"
 
 /**
@@ -132,6 +135,258 @@ static bool wbuff_is_valid_handle(struct wbuff_handle *handle)
 	return false;
 }
 
+/**
+ * wbuff_pool_pop() - take a buffer out of the pool
+ * @wbuff_pool: wbuff pool, caller holds the module lock
+ *
+ * Return: nbuf if the pool is not empty
+ *         NULL otherwise
+ */
+static qdf_nbuf_t wbuff_pool_pop(struct wbuff_pool *wbuff_pool)
+{
+	qdf_nbuf_t buf = wbuff_pool->pool;
+
+	if (buf) {
+		wbuff_pool->pool = qdf_nbuf_next(buf);
+		wbuff_pool->free_count--;
+	}
+
+	return buf;
+}
+
+/**
+ * wbuff_pool_push() - put a buffer back into the pool
+ * @wbuff_pool: wbuff pool, caller holds the module lock
+ * @buf: buffer to be added
+ *
+ * Return: None
+ */
+static void wbuff_pool_push(struct wbuff_pool *wbuff_pool, qdf_nbuf_t buf)
+{
+	qdf_nbuf_set_next(buf, wbuff_pool->pool);
+	wbuff_pool->pool = buf;
+	wbuff_pool->free_count++;
+}
+
+/**
+ * wbuff_pcpu_cache_get() - get a buffer from the per CPU cache of a pool
+ * @mod: wbuff module reference
+ * @wbuff_pool: wbuff pool
+ * @cache: per CPU cache of the current CPU, called with bottom halves
+ *  disabled
+ *
+ * An empty cache is refilled with a batch of buffers from the pool, so
+ * that the module lock is only taken once for WBUFF_PCPU_BATCH buffers.
+ *
+ * Return: nbuf if success
+ *         NULL if both the cache and the pool are empty
+ */
+static qdf_nbuf_t wbuff_pcpu_cache_get(struct wbuff_module *mod,
+				       struct wbuff_pool *wbuff_pool,
+				       struct wbuff_pcpu_cache *cache)
+{
+	qdf_nbuf_t buf;
+
+	if (cache->count) {
+		wbuff_pool->pcpu_hit++;
+	} else {
+		qdf_spin_lock_bh(&mod->lock);
+		while (cache->count < WBUFF_PCPU_BATCH) {
+			buf = wbuff_pool_pop(wbuff_pool);
+			if (!buf)
+				break;
+
+			qdf_nbuf_set_next(buf, cache->head);
+			cache->head = buf;
+			cache->count++;
+		}
+		qdf_spin_unlock_bh(&mod->lock);
+
+		if (!cache->count)
+			return NULL;
+	}
+
+	buf = cache->head;
+	cache->head = qdf_nbuf_next(buf);
+	cache->count--;
+
+	return buf;
+}
+
+/**
+ * wbuff_pcpu_cache_put() - put a buffer into the per CPU cache of a pool
+ * @mod: wbuff module reference
+ * @wbuff_pool: wbuff pool
+ * @cache: per CPU cache of the current CPU, called with bottom halves
+ *  disabled
+ * @buf: buffer to be cached
+ *
+ * A full cache returns a batch of buffers to the pool first.
+ *
+ * Return: None
+ */
+static void wbuff_pcpu_cache_put(struct wbuff_module *mod,
+				 struct wbuff_pool *wbuff_pool,
+				 struct wbuff_pcpu_cache *cache,
+				 qdf_nbuf_t buf)
+{
+	qdf_nbuf_t first;
+
+	if (cache->count >= WBUFF_PCPU_CACHE_SIZE) {
+		qdf_spin_lock_bh(&mod->lock);
+		while (cache->count > WBUFF_PCPU_CACHE_SIZE -
+				      WBUFF_PCPU_BATCH) {
+			first = cache->head;
+			cache->head = qdf_nbuf_next(first);
+			cache->count--;
+			wbuff_pool_push(wbuff_pool, first);
+		}
+		qdf_spin_unlock_bh(&mod->lock);
+	}
+
+	qdf_nbuf_set_next(buf, cache->head);
+	cache->head = buf;
+	cache->count++;
+}
+
+/**
+ * wbuff_pool_need_shrink() - check if a grown pool has been idle long enough
+ *  to be shrunk
+ * @wbuff_pool: wbuff pool
+ *
+ * Return: true if the pool can be shrunk
+ */
+static bool wbuff_pool_need_shrink(struct wbuff_pool *wbuff_pool)
+{
+	return wbuff_pool->cur_size > wbuff_pool->pool_size &&
+	       wbuff_pool->free_count > wbuff_pool->cur_size / 2 &&
+	       qdf_get_system_timestamp() - wbuff_pool->last_miss_ts >
+	       WBUFF_SHRINK_IDLE_MS;
+}
+
+/**
+ * wbuff_pool_grow() - grow a pool which keeps running dry
+ * @module_id: module ID
+ * @pool_id: pool ID
+ *
+ * Return: None
+ */
+static void wbuff_pool_grow(uint8_t module_id, uint8_t pool_id)
+{
+	struct wbuff_module *mod = &wbuff.mod[module_id];
+	struct wbuff_pool *wbuff_pool = &mod->wbuff_pool[pool_id];
+	qdf_nbuf_t first = NULL, buf;
+	uint16_t max_size, num;
+	int i;
+
+	max_size = wbuff_pool->pool_size * WBUFF_GROW_MAX_FACTOR;
+	if (wbuff_pool->cur_size >= max_size)
+		return;
+
+	num = QDF_MIN(WBUFF_RESIZE_STEP, max_size - wbuff_pool->cur_size);
+	for (i = 0; i < num; i++) {
+		buf = wbuff_prepare_nbuf(module_id, pool_id,
+					 wbuff_pool->buffer_size,
+					 mod->reserve, mod->align);
+		if (!buf)
+			break;
+
+		qdf_nbuf_set_next(buf, first);
+		first = buf;
+	}
+
+	qdf_spin_lock_bh(&mod->lock);
+	if (mod->registered) {
+		while (first) {
+			buf = first;
+			first = qdf_nbuf_next(buf);
+			wbuff_pool_push(wbuff_pool, buf);
+			wbuff_pool->cur_size++;
+		}
+		wbuff_pool->miss_cnt = 0;
+		wbuff_pool->grow_cnt++;
+	}
+	qdf_spin_unlock_bh(&mod->lock);
+
+	while (first) {
+		buf = first;
+		first = qdf_nbuf_next(buf);
+		qdf_nbuf_free(buf);
+	}
+}
+
+/**
+ * wbuff_pool_shrink() - release the idle buffers of a grown pool
+ * @module_id: module ID
+ * @pool_id: pool ID
+ *
+ * Return: None
+ */
+static void wbuff_pool_shrink(uint8_t module_id, uint8_t pool_id)
+{
+	struct wbuff_module *mod = &wbuff.mod[module_id];
+	struct wbuff_pool *wbuff_pool = &mod->wbuff_pool[pool_id];
+	qdf_nbuf_t first = NULL, buf;
+	int i;
+
+	qdf_spin_lock_bh(&mod->lock);
+	if (!mod->registered || !wbuff_pool_need_shrink(wbuff_pool)) {
+		qdf_spin_unlock_bh(&mod->lock);
+		return;
+	}
+
+	for (i = 0; i < WBUFF_RESIZE_STEP &&
+	     wbuff_pool->cur_size > wbuff_pool->pool_size; i++) {
+		buf = wbuff_pool_pop(wbuff_pool);
+		if (!buf)
+			break;
+
+		wbuff_pool->cur_size--;
+		wbuff_pool->mem_alloc -= qdf_nbuf_get_allocsize(buf);
+		qdf_nbuf_set_next(buf, first);
+		first = buf;
+	}
+	wbuff_pool->shrink_cnt++;
+	qdf_spin_unlock_bh(&mod->lock);
+
+	while (first) {
+		buf = first;
+		first = qdf_nbuf_next(buf);
+		qdf_nbuf_free(buf);
+	}
+}
+
+/**
+ * wbuff_resize_work_handler() - grow or shrink the pools based on their
+ *  miss counters
+ * @arg: unused
+ *
+ * Return: None
+ */
+static void wbuff_resize_work_handler(void *arg)
+{
+	struct wbuff_module *mod;
+	struct wbuff_pool *wbuff_pool;
+	uint8_t module_id, pool_id;
+
+	for (module_id = 0; module_id < WBUFF_MAX_MODULES; module_id++) {
+		mod = &wbuff.mod[module_id];
+		if (!mod->registered)
+			continue;
+
+		for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++) {
+			wbuff_pool = &mod->wbuff_pool[pool_id];
+			if (!wbuff_pool->initialized)
+				continue;
+
+			if (wbuff_pool->miss_cnt >= WBUFF_GROW_MISS_THRESH)
+				wbuff_pool_grow(module_id, pool_id);
+			else if (wbuff_pool_need_shrink(wbuff_pool))
+				wbuff_pool_shrink(module_id, pool_id);
+		}
+	}
+}
+
 static char *wbuff_get_mod_name(enum wbuff_module_id module_id)
 {
 	char *str;
@@ -164,6 +419,7 @@ static int wbuff_stats_debugfs_show(qdf_debugfs_file_t file, void *data)
 {
 	struct wbuff_module *mod;
 	struct wbuff_pool *wbuff_pool;
+	uint64_t total, miss_rate;
 	int i, j;
 
 	wbuff_debugfs_print(file, "WBUFF POOL STATS:\n");
@@ -178,10 +434,16 @@ static int wbuff_stats_debugfs_show(qdf_debugfs_file_t file, void *data)
 		wbuff_debugfs_print(file, "Module (%d) : %s\n", i,
 				    wbuff_get_mod_name(i));
 
-		wbuff_debugfs_print(file, "%s %25s %20s %20s\n", "Pool ID",
+		wbuff_debugfs_print(file, "%s %25s %20s %20s %15s %15s %10s %10s %10s\n",
+				    "Pool ID",
 				    "Mem Allocated (In Bytes)",
 				    "Wbuff Success Count",
-				    "Wbuff Fail Count");
+				    "Wbuff Fail Count",
+				    "Miss Rate (%%)",
+				    "Per CPU Hits",
+				    "Size",
+				    "Grow",
+				    "Shrink");
 
 		for (j = 0; j < WBUFF_MAX_POOLS; j++) {
 			wbuff_pool = &mod->wbuff_pool[j];
@@ -189,10 +451,22 @@ static int wbuff_stats_debugfs_show(qdf_debugfs_file_t file, void *data)
 			if (!wbuff_pool->initialized)
 				continue;
 
-			wbuff_debugfs_print(file, "%d %30llu %20llu %20llu\n",
+			total = wbuff_pool->alloc_success +
+				wbuff_pool->alloc_fail;
+			miss_rate = total ?
+				div64_u64(wbuff_pool->alloc_fail * 100,
+					  total) : 0;
+
+			wbuff_debugfs_print(file, "%d %30llu %20llu %20llu %15llu %15llu %5u/%-4u %10u %10u\n",
 					    j, wbuff_pool->mem_alloc,
 					    wbuff_pool->alloc_success,
-					    wbuff_pool->alloc_fail);
+					    wbuff_pool->alloc_fail,
+					    miss_rate,
+					    wbuff_pool->pcpu_hit,
+					    wbuff_pool->cur_size,
+					    wbuff_pool->pool_size,
+					    wbuff_pool->grow_cnt,
+					    wbuff_pool->shrink_cnt);
 		}
 		wbuff_debugfs_print(file, "\n");
 	}
@@ -256,9 +530,12 @@ QDF_STATUS wbuff_module_init(void)
 		qdf_spinlock_create(&mod->lock);
 		for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++)
 			mod->wbuff_pool[pool_id].pool = NULL;
+		qdf_atomic_init(&mod->pending_returns);
 		mod->registered = false;
 	}
 
+	qdf_create_work(0, &wbuff.resize_work, wbuff_resize_work_handler,
+			NULL);
 	wbuff_debugfs_init();
 
 	wbuff.initialized = true;
@@ -282,9 +559,13 @@ QDF_STATUS wbuff_module_deinit(void)
 		if (mod->registered)
 			wbuff_module_deregister((struct wbuff_mod_handle *)
 						&mod->handle);
-		qdf_spinlock_destroy(&mod->lock);
 	}
 
+	qdf_destroy_work(0, &wbuff.resize_work);
+
+	for (module_id = 0; module_id < WBUFF_MAX_MODULES; module_id++)
+		qdf_spinlock_destroy(&wbuff.mod[module_id].lock);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -344,10 +625,15 @@ wbuff_module_register(struct wbuff_alloc_request *req, uint8_t num_pools,
 				qdf_nbuf_set_next(buf, wbuff_pool->pool);
 
 			wbuff_pool->pool = buf;
+			wbuff_pool->free_count++;
 		}
 
 		wbuff_pool->pool_id = pool_id;
 		wbuff_pool->buffer_size = len;
+		wbuff_pool->pool_size = pool_size;
+		wbuff_pool->cur_size = wbuff_pool->free_count;
+		wbuff_pool->pcpu_enabled =
+			pool_size >= WBUFF_PCPU_MIN_POOL_SIZE;
 		wbuff_pool->initialized = true;
 	}
 
@@ -366,6 +652,8 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 	uint8_t module_id = 0, pool_id = 0;
 	qdf_nbuf_t first = NULL, buf = NULL;
 	struct wbuff_pool *wbuff_pool;
+	struct wbuff_pcpu_cache *cache;
+	int cpu;
 
 	handle = (struct wbuff_handle *)hdl;
 
@@ -379,6 +667,16 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 
 	mod = &wbuff.mod[module_id];
 
+	qdf_spin_lock_bh(&mod->lock);
+	mod->registered = false;
+	qdf_spin_unlock_bh(&mod->lock);
+
+	/*
+	 * The per CPU caches are accessed with bottom halves disabled, wait
+	 * for the users which have seen the module as registered to leave.
+	 */
+	synchronize_rcu();
+
 	qdf_spin_lock_bh(&mod->lock);
 	for (pool_id = 0; pool_id < WBUFF_MAX_POOLS; pool_id++) {
 		wbuff_pool = &mod->wbuff_pool[pool_id];
@@ -386,19 +684,34 @@ QDF_STATUS wbuff_module_deregister(struct wbuff_mod_handle *hdl)
 		if (!wbuff_pool->initialized)
 			continue;
 
+		for (cpu = 0; cpu < QDF_MAX_AVAILABLE_CPU; cpu++) {
+			cache = &wbuff_pool->pcpu_cache[cpu];
+			while (cache->head) {
+				buf = cache->head;
+				cache->head = qdf_nbuf_next(buf);
+				wbuff_pool_push(wbuff_pool, buf);
+			}
+			cache->count = 0;
+		}
+
 		first = wbuff_pool->pool;
 		while (first) {
 			buf = first;
 			first = qdf_nbuf_next(buf);
 			qdf_nbuf_free(buf);
 		}
+		wbuff_pool->pool = NULL;
+		wbuff_pool->free_count = 0;
+		wbuff_pool->cur_size = 0;
+		wbuff_pool->miss_cnt = 0;
 
 		wbuff_pool->mem_alloc = 0;
 		wbuff_pool->alloc_success = 0;
 		wbuff_pool->alloc_fail = 0;
-
+		wbuff_pool->pcpu_hit = 0;
+		wbuff_pool->grow_cnt = 0;
+		wbuff_pool->shrink_cnt = 0;
 	}
-	mod->registered = false;
 	qdf_spin_unlock_bh(&mod->lock);
 
 	return QDF_STATUS_SUCCESS;
@@ -413,6 +726,7 @@ wbuff_buff_get(struct wbuff_mod_handle *hdl, uint8_t pool_id, uint32_t len,
 	struct wbuff_pool *wbuff_pool;
 	uint8_t module_id = 0;
 	qdf_nbuf_t buf = NULL;
+	int cpu;
 
 	handle = (struct wbuff_handle *)hdl;
 
@@ -437,20 +751,28 @@ wbuff_buff_get(struct wbuff_mod_handle *hdl, uint8_t pool_id, uint32_t len,
 	if (!wbuff_pool->initialized)
 		return NULL;
 
-	qdf_spin_lock_bh(&mod->lock);
-	if (wbuff_pool->pool) {
-		buf = wbuff_pool->pool;
-		wbuff_pool->pool = qdf_nbuf_next(buf);
-		mod->pending_returns++;
+	if (wbuff_pool->pcpu_enabled) {
+		qdf_local_bh_disable();
+		cpu = qdf_get_cpu();
+		buf = wbuff_pcpu_cache_get(mod, wbuff_pool,
+					   &wbuff_pool->pcpu_cache[cpu]);
+		qdf_local_bh_enable();
+	} else {
+		qdf_spin_lock_bh(&mod->lock);
+		buf = wbuff_pool_pop(wbuff_pool);
+		qdf_spin_unlock_bh(&mod->lock);
 	}
-	qdf_spin_unlock_bh(&mod->lock);
 
 	if (buf) {
+		qdf_atomic_inc(&mod->pending_returns);
 		qdf_nbuf_set_next(buf, NULL);
 		qdf_net_buf_debug_update_node(buf, func_name, line_num);
 		wbuff_pool->alloc_success++;
 	} else {
 		wbuff_pool->alloc_fail++;
+		wbuff_pool->last_miss_ts = qdf_get_system_timestamp();
+		if (++wbuff_pool->miss_cnt == WBUFF_GROW_MISS_THRESH)
+			qdf_sched_work(0, &wbuff.resize_work);
 	}
 
 	return buf;
@@ -461,7 +783,10 @@ qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf)
 	qdf_nbuf_t buffer = buf;
 	unsigned long pool_info = 0;
 	uint8_t module_id = 0, pool_id = 0;
+	struct wbuff_module *mod;
 	struct wbuff_pool *wbuff_pool;
+	bool need_shrink = false;
+	int cpu;
 
 	if (!wbuff.initialized)
 		return buffer;
@@ -477,21 +802,36 @@ qdf_nbuf_t wbuff_buff_put(qdf_nbuf_t buf)
 	if (module_id >= WBUFF_MAX_MODULES || pool_id >= WBUFF_MAX_POOLS)
 		return buffer;
 
-	wbuff_pool = &wbuff.mod[module_id].wbuff_pool[pool_id];
+	mod = &wbuff.mod[module_id];
+	wbuff_pool = &mod->wbuff_pool[pool_id];
 	if (!wbuff_pool->initialized)
 		return buffer;
 
-	qdf_nbuf_reset(buffer, wbuff.mod[module_id].reserve,
-		       wbuff.mod[module_id].align);
+	qdf_nbuf_reset(buffer, mod->reserve, mod->align);
 
-	qdf_spin_lock_bh(&wbuff.mod[module_id].lock);
-	if (wbuff.mod[module_id].registered) {
-		qdf_nbuf_set_next(buffer, wbuff_pool->pool);
-		wbuff_pool->pool = buffer;
-		wbuff.mod[module_id].pending_returns--;
+	qdf_local_bh_disable();
+	cpu = qdf_get_cpu();
+	if (mod->registered && wbuff_pool->pcpu_enabled) {
+		wbuff_pcpu_cache_put(mod, wbuff_pool,
+				     &wbuff_pool->pcpu_cache[cpu], buffer);
+		qdf_atomic_dec(&mod->pending_returns);
 		buffer = NULL;
+	} else {
+		qdf_spin_lock_bh(&mod->lock);
+		if (mod->registered) {
+			wbuff_pool_push(wbuff_pool, buffer);
+			qdf_atomic_dec(&mod->pending_returns);
+			buffer = NULL;
+		}
+		qdf_spin_unlock_bh(&mod->lock);
 	}
-	qdf_spin_unlock_bh(&wbuff.mod[module_id].lock);
+
+	if (!buffer)
+		need_shrink = wbuff_pool_need_shrink(wbuff_pool);
+	qdf_local_bh_enable();
+
+	if (need_shrink)
+		qdf_sched_work(0, &wbuff.resize_work);
 
 	return buffer;
 }
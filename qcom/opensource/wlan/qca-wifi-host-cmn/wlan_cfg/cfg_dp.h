@@ -1358,6 +1358,51 @@
 	CFG_INI_BOOL("dp_rx_fisa_lru_del_enable", true, \
 		     "Enable/Disable DP Rx FISA LRU deletion")
 
+/*
+ * <ini>
+ * dp_rx_fisa_udp_fraglist - Deliver FISA UDP aggregates as GSO fraglist
+ * @Min: 0
+ * @Max: 1
+ * @Default: 0
+ *
+ * This ini is used to mark FISA UDP aggregates as GSO fraglist skbs, so
+ * that the stack segments them back into the original datagrams by just
+ * unchaining the frag_list instead of copying the payload.
+ *
+ * Related: dp_rx_fisa_enable
+ *
+ * Supported Feature: STA,P2P and SAP IPA disabled terminating
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_FISA_UDP_FRAGLIST \
+	CFG_INI_BOOL("dp_rx_fisa_udp_fraglist", false, \
+		     "Enable/Disable DP Rx FISA UDP fraglist delivery")
+
+/*
+ * <ini>
+ * dp_rx_fisa_esp_in_udp - Control FISA aggregation of ESP-in-UDP flows
+ * @Min: 0
+ * @Max: 1
+ * @Default: 0
+ *
+ * This ini is used to allow FISA aggregation of UDP encapsulated ESP
+ * flows on the NAT-T port. IKE flows are never aggregated.
+ *
+ * Related: dp_rx_fisa_enable
+ *
+ * Supported Feature: STA,P2P and SAP IPA disabled terminating
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_FISA_ESP_IN_UDP \
+	CFG_INI_BOOL("dp_rx_fisa_esp_in_udp", false, \
+		     "Enable/Disable DP Rx FISA for ESP-in-UDP flows")
+
 #define CFG_DP_RXDMA_MONITOR_RX_DROP_THRESHOLD \
 		CFG_INI_UINT("mon_drop_thresh", \
 		WLAN_CFG_RXDMA_MONITOR_RX_DROP_THRESH_SIZE_MIN, \
@@ -1932,6 +1977,8 @@
 		CFG(CFG_DP_PKTLOG_BUFFER_SIZE) \
 		CFG(CFG_DP_RX_FISA_ENABLE) \
 		CFG(CFG_DP_RX_FISA_LRU_DEL_ENABLE) \
+		CFG(CFG_DP_RX_FISA_UDP_FRAGLIST) \
+		CFG(CFG_DP_RX_FISA_ESP_IN_UDP) \
 		CFG(CFG_DP_FULL_MON_MODE) \
 		CFG(CFG_DP_REO_RINGS_MAP) \
 		CFG(CFG_DP_PEER_EXT_STATS) \
@@ -3022,6 +3022,10 @@ wlan_cfg_soc_attach(struct cdp_ctrl_objmgr_psoc *psoc)
 	wlan_cfg_ctx->is_rx_fisa_enabled = cfg_get(psoc, CFG_DP_RX_FISA_ENABLE);
 	wlan_cfg_ctx->is_rx_fisa_lru_del_enabled =
 				cfg_get(psoc, CFG_DP_RX_FISA_LRU_DEL_ENABLE);
+	wlan_cfg_ctx->is_rx_fisa_udp_fraglist_enabled =
+				cfg_get(psoc, CFG_DP_RX_FISA_UDP_FRAGLIST);
+	wlan_cfg_ctx->is_rx_fisa_esp_in_udp_enabled =
+				cfg_get(psoc, CFG_DP_RX_FISA_ESP_IN_UDP);
 	wlan_cfg_ctx->reo_rings_mapping = cfg_get(psoc, CFG_DP_REO_RINGS_MAP);
 	wlan_cfg_ctx->pext_stats_enabled = cfg_get(psoc, CFG_DP_PEER_EXT_STATS);
 	wlan_cfg_ctx->jitter_stats_enabled =
@@ -3997,6 +4001,17 @@ bool wlan_cfg_is_rx_fisa_lru_del_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
 {
 	return cfg->is_rx_fisa_lru_del_enabled;
 }
+
+bool
+wlan_cfg_is_rx_fisa_udp_fraglist_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
+{
+	return cfg->is_rx_fisa_udp_fraglist_enabled;
+}
+
+bool wlan_cfg_is_rx_fisa_esp_in_udp_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
+{
+	return cfg->is_rx_fisa_esp_in_udp_enabled;
+}
 #else
 bool wlan_cfg_is_rx_fisa_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
 {
@@ -4007,6 +4022,17 @@ bool wlan_cfg_is_rx_fisa_lru_del_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
 {
 	return false;
 }
+
+bool
+wlan_cfg_is_rx_fisa_udp_fraglist_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
+{
+	return false;
+}
+
+bool wlan_cfg_is_rx_fisa_esp_in_udp_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
+{
+	return false;
+}
 #endif
 
 bool wlan_cfg_is_poll_mode_enabled(struct wlan_cfg_dp_soc_ctxt *cfg)
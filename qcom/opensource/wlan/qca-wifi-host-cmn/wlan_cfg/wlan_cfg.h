@@ -273,6 +273,9 @@ struct wlan_srng_cfg {
  * @pktlog_buffer_size: packet log buffer size
  * @is_rx_fisa_enabled: flag to enable/disable FISA Rx
  * @is_rx_fisa_lru_del_enabled:
+ * @is_rx_fisa_udp_fraglist_enabled: flag to deliver FISA UDP aggregates as
+ *				     GSO fraglist skbs
+ * @is_rx_fisa_esp_in_udp_enabled: flag to allow FISA for ESP-in-UDP flows
  * @is_tso_desc_attach_defer:
  * @delayed_replenish_entries:
  * @reo_rings_mapping:
@@ -452,6 +455,8 @@ struct wlan_cfg_dp_soc_ctxt {
 	uint8_t pktlog_buffer_size;
 	uint8_t is_rx_fisa_enabled;
 	bool is_rx_fisa_lru_del_enabled;
+	bool is_rx_fisa_udp_fraglist_enabled;
+	bool is_rx_fisa_esp_in_udp_enabled;
 	bool is_tso_desc_attach_defer;
 	uint32_t delayed_replenish_entries;
 	uint32_t reo_rings_mapping;
@@ -1902,6 +1907,25 @@ bool wlan_cfg_is_rx_fisa_enabled(struct wlan_cfg_dp_soc_ctxt *cfg);
  */
 bool wlan_cfg_is_rx_fisa_lru_del_enabled(struct wlan_cfg_dp_soc_ctxt *cfg);
 
+/**
+ * wlan_cfg_is_rx_fisa_udp_fraglist_enabled() - Get Rx FISA UDP fraglist
+ *						delivery enabled flag
+ * @cfg: soc configuration context
+ *
+ * Return: true if enabled, false otherwise.
+ */
+bool
+wlan_cfg_is_rx_fisa_udp_fraglist_enabled(struct wlan_cfg_dp_soc_ctxt *cfg);
+
+/**
+ * wlan_cfg_is_rx_fisa_esp_in_udp_enabled() - Get Rx FISA ESP-in-UDP
+ *					      enabled flag
+ * @cfg: soc configuration context
+ *
+ * Return: true if enabled, false otherwise.
+ */
+bool wlan_cfg_is_rx_fisa_esp_in_udp_enabled(struct wlan_cfg_dp_soc_ctxt *cfg);
+
 /**
  * wlan_cfg_is_rx_buffer_pool_enabled() - Get RX buffer pool enabled flag
  *
@@ -319,6 +319,45 @@ wmi_unified_cmd_send_fl(wmi_unified_t wmi_handle, wmi_buf_t buf,
 			uint32_t buflen, uint32_t cmd_id,
 			const char *func, uint32_t line);
 
+/**
+ * struct wmi_cmd_batch_entry - one command of a WMI command batch
+ * @buf: wmi command buffer
+ * @len: wmi command buffer length
+ * @cmd_id: WMI cmd id
+ */
+struct wmi_cmd_batch_entry {
+	wmi_buf_t buf;
+	uint32_t len;
+	uint32_t cmd_id;
+};
+
+/**
+ * wmi_unified_cmd_send_batch() - send several WMI commands in one pass
+ * @wmi_handle: handle to WMI.
+ * @cmds: commands to send, in order
+ * @num_cmds: number of entries in @cmds
+ * @num_sent: filled with the number of commands consumed
+ *
+ * The commands are handed to HTC as one packet queue so that they share
+ * the credit check and can be bundled into a single HTC transfer, each
+ * command is still a separate WMI message for the target. On failure the
+ * commands from index @num_sent onward are not sent and the caller must
+ * free their buffers.
+ *
+ * Note, it is NOT safe to access a consumed buf after calling this!
+ *
+ * Return: QDF_STATUS
+ */
+#define wmi_unified_cmd_send_batch(wmi_handle, cmds, num_cmds, num_sent) \
+	wmi_unified_cmd_send_batch_fl(wmi_handle, cmds, num_cmds, num_sent, \
+				      __func__, __LINE__)
+
+QDF_STATUS
+wmi_unified_cmd_send_batch_fl(wmi_unified_t wmi_handle,
+			      struct wmi_cmd_batch_entry *cmds,
+			      uint32_t num_cmds, uint32_t *num_sent,
+			      const char *func, uint32_t line);
+
 #ifdef WLAN_FEATURE_WMI_SEND_RECV_QMI
 /**
  * wmi_unified_cmd_send_over_qmi() -  generic function to send unified WMI command
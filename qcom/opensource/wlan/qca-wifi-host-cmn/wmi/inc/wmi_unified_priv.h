@@ -3289,6 +3289,12 @@ struct wmi_unified {
 	qdf_nbuf_queue_t diag_event_queue;
 	qdf_work_t rx_diag_event_work;
 	uint32_t wmi_rx_diag_events_dropped;
+	/* events waiting for the scheduler thread, drained in bulk */
+	qdf_spinlock_t sched_eventq_lock;
+	qdf_nbuf_queue_t sched_event_queue;
+	bool sched_event_posted;
+	uint32_t sched_event_msgs;
+	uint32_t sched_event_bulk_max;
 	int wmi_stop_in_progress;
 	struct wmi_host_abi_version fw_abi_version;
 	struct wmi_host_abi_version final_abi_vers;
@@ -3395,16 +3401,6 @@ struct wmi_soc {
 #endif /*WMI_INTERFACE_EVENT_LOGGING */
 };
 
-/**
- * struct wmi_process_fw_event_params - fw event parameters
- * @wmi_handle: wmi handle
- * @evt_buf: event buffer
- */
-struct wmi_process_fw_event_params {
-	void *wmi_handle;
-	void *evt_buf;
-};
-
 /**
  * wmi_mtrace() - Wrappper function for qdf_mtrace api
  * @message_id: 32-Bit Wmi message ID
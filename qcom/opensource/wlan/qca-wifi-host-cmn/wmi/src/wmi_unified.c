@@ -99,20 +99,26 @@ typedef PREPACK struct {
 #define WMI_MIN_HEAD_ROOM 64
 
 /* WBUFF pool sizes for WMI */
+/* Allocation of size 128 bytes */
+#define WMI_WBUFF_POOL_0_SIZE 64
 /* Allocation of size 256 bytes */
-#define WMI_WBUFF_POOL_0_SIZE 128
+#define WMI_WBUFF_POOL_1_SIZE 128
 /* Allocation of size 512 bytes */
-#define WMI_WBUFF_POOL_1_SIZE 16
+#define WMI_WBUFF_POOL_2_SIZE 16
 /* Allocation of size 1024 bytes */
-#define WMI_WBUFF_POOL_2_SIZE 8
-/* Allocation of size 2048 bytes */
 #define WMI_WBUFF_POOL_3_SIZE 8
+/* Allocation of size 1536 bytes */
+#define WMI_WBUFF_POOL_4_SIZE 8
+/* Allocation of size 2048 bytes */
+#define WMI_WBUFF_POOL_5_SIZE 8
 
 /* wbuff pool buffer lengths in bytes for WMI*/
-#define WMI_WBUFF_LEN_POOL0 256
-#define WMI_WBUFF_LEN_POOL1 512
-#define WMI_WBUFF_LEN_POOL2 1024
-#define WMI_WBUFF_LEN_POOL3 2048
+#define WMI_WBUFF_LEN_POOL0 128
+#define WMI_WBUFF_LEN_POOL1 256
+#define WMI_WBUFF_LEN_POOL2 512
+#define WMI_WBUFF_LEN_POOL3 1024
+#define WMI_WBUFF_LEN_POOL4 1536
+#define WMI_WBUFF_LEN_POOL5 2048
 
 #define RX_DIAG_EVENT_WORK_PROCESS_MAX_COUNT 500
 
@@ -1941,6 +1947,39 @@ static inline QDF_STATUS wmi_htc_send_pkt(struct wmi_unified *wmi_handle,
 	return status;
 }
 
+static QDF_STATUS wmi_htc_send_pkt_queue(struct wmi_unified *wmi_handle,
+					 HTC_PACKET_QUEUE *pkt_queue,
+					 const char *func, uint32_t line)
+{
+	HTC_PACKET *pkt;
+	uint32_t seq;
+	QDF_STATUS status;
+
+	qdf_spin_lock_bh(&wmi_handle->wmi_seq_lock);
+	/*
+	 * HTC consumes the queue, so record the sequence numbers up front;
+	 * the completions cannot run before the lock is released.
+	 */
+	seq = wmi_handle->wmi_sequence;
+	HTC_PACKET_QUEUE_ITERATE_ALLOW_REMOVE(pkt_queue, pkt) {
+		qdf_nbuf_set_mark(GET_HTC_PACKET_NET_BUF_CONTEXT(pkt), seq);
+		seq = (seq + 1) & (wmi_handle->wmi_max_cmds - 1);
+	}
+	HTC_PACKET_QUEUE_ITERATE_END;
+
+	status = htc_send_pkt_queue(wmi_handle->htc_handle, pkt_queue);
+	if (QDF_STATUS_SUCCESS != status) {
+		qdf_spin_unlock_bh(&wmi_handle->wmi_seq_lock);
+		wmi_nofl_err("%s:%d, htc_send_pkt_queue failed, status:%d",
+			     func, line, status);
+		return status;
+	}
+	wmi_handle->wmi_sequence = seq;
+	qdf_spin_unlock_bh(&wmi_handle->wmi_seq_lock);
+
+	return status;
+}
+
 static inline void wmi_interface_sequence_check(struct wmi_unified *wmi_handle,
 						wmi_buf_t buf)
 {
@@ -2002,6 +2041,20 @@ static inline QDF_STATUS wmi_htc_send_pkt(struct wmi_unified *wmi_handle,
 	return status;
 }
 
+static QDF_STATUS wmi_htc_send_pkt_queue(struct wmi_unified *wmi_handle,
+					 HTC_PACKET_QUEUE *pkt_queue,
+					 const char *func, uint32_t line)
+{
+	QDF_STATUS status;
+
+	status = htc_send_pkt_queue(wmi_handle->htc_handle, pkt_queue);
+	if (QDF_STATUS_SUCCESS != status)
+		wmi_nofl_err("%s:%d, htc_send_pkt_queue failed, status:%d",
+			     func, line, status);
+
+	return status;
+}
+
 static inline void wmi_interface_sequence_check(struct wmi_unified *wmi_handle,
 						wmi_buf_t buf)
 {
@@ -2018,6 +2071,9 @@ static inline void wmi_unified_debug_dump(wmi_unified_t wmi_handle)
 		     (wmi_handle->target_type ==
 		      WMI_TLV_TARGET ? "WMI_TLV_TARGET" :
 						"WMI_NON_TLV_TARGET"));
+	wmi_nofl_err("Scheduler event msgs = %u, max events per msg = %u",
+		     wmi_handle->sched_event_msgs,
+		     wmi_handle->sched_event_bulk_max);
 }
 
 #ifdef SYSTEM_PM_CHECK
@@ -2058,9 +2114,23 @@ static inline void wmi_set_system_pm_pkt_tag(uint16_t *htc_tag, wmi_buf_t buf,
 }
 #endif
 
-QDF_STATUS wmi_unified_cmd_send_fl(wmi_unified_t wmi_handle, wmi_buf_t buf,
-				   uint32_t len, uint32_t cmd_id,
-				   const char *func, uint32_t line)
+/**
+ * wmi_unified_cmd_prepare_fl() - Validate a WMI command and wrap it in an
+ *                                HTC packet
+ * @wmi_handle: handle to WMI
+ * @buf: wmi command buffer
+ * @len: wmi command buffer length
+ * @cmd_id: WMI cmd id
+ * @out_pkt: filled with the HTC packet to send
+ * @func: caller function
+ * @line: caller line
+ *
+ * Return: QDF_STATUS_SUCCESS if @out_pkt is ready to be sent
+ */
+static QDF_STATUS
+wmi_unified_cmd_prepare_fl(wmi_unified_t wmi_handle, wmi_buf_t buf,
+			   uint32_t len, uint32_t cmd_id, HTC_PACKET **out_pkt,
+			   const char *func, uint32_t line)
 {
 	HTC_PACKET *pkt;
 	uint16_t htc_tag = 0;
@@ -2167,10 +2237,72 @@ QDF_STATUS wmi_unified_cmd_send_fl(wmi_unified_t wmi_handle, wmi_buf_t buf,
 		qdf_spin_unlock_bh(&wmi_handle->log_info.wmi_record_lock);
 	}
 #endif
+	*out_pkt = pkt;
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS wmi_unified_cmd_send_fl(wmi_unified_t wmi_handle, wmi_buf_t buf,
+				   uint32_t len, uint32_t cmd_id,
+				   const char *func, uint32_t line)
+{
+	HTC_PACKET *pkt;
+	QDF_STATUS status;
+
+	status = wmi_unified_cmd_prepare_fl(wmi_handle, buf, len, cmd_id,
+					    &pkt, func, line);
+	if (QDF_IS_STATUS_ERROR(status))
+		return status;
+
 	return wmi_htc_send_pkt(wmi_handle, pkt, func, line);
 }
 qdf_export_symbol(wmi_unified_cmd_send_fl);
 
+QDF_STATUS wmi_unified_cmd_send_batch_fl(wmi_unified_t wmi_handle,
+					 struct wmi_cmd_batch_entry *cmds,
+					 uint32_t num_cmds, uint32_t *num_sent,
+					 const char *func, uint32_t line)
+{
+	HTC_PACKET_QUEUE pkt_queue;
+	HTC_PACKET *pkt;
+	QDF_STATUS status = QDF_STATUS_SUCCESS;
+	uint32_t i;
+
+	*num_sent = 0;
+	INIT_HTC_PACKET_QUEUE(&pkt_queue);
+
+	for (i = 0; i < num_cmds; i++) {
+		status = wmi_unified_cmd_prepare_fl(wmi_handle, cmds[i].buf,
+						    cmds[i].len, cmds[i].cmd_id,
+						    &pkt, func, line);
+		if (QDF_IS_STATUS_ERROR(status))
+			break;
+
+		HTC_PACKET_ENQUEUE(&pkt_queue, pkt);
+	}
+
+	if (HTC_QUEUE_EMPTY(&pkt_queue))
+		return status;
+
+	if (QDF_IS_STATUS_ERROR(wmi_htc_send_pkt_queue(wmi_handle, &pkt_queue,
+						       func, line))) {
+		/* nothing was consumed, give the buffers back to the caller */
+		while (!HTC_QUEUE_EMPTY(&pkt_queue)) {
+			pkt = htc_packet_dequeue(&pkt_queue);
+			qdf_nbuf_pull_head(GET_HTC_PACKET_NET_BUF_CONTEXT(pkt),
+					   sizeof(WMI_CMD_HDR));
+			qdf_atomic_dec(&wmi_handle->pending_cmds);
+			qdf_mem_free(pkt);
+		}
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	*num_sent = i;
+
+	return status;
+}
+qdf_export_symbol(wmi_unified_cmd_send_batch_fl);
+
 /**
  * wmi_unified_get_event_handler_ix() - gives event handler's index
  * @wmi_handle: handle to wmi
@@ -2458,16 +2590,38 @@ wmi_is_event_critical(struct wmi_unified *wmi_handle, uint32_t event_id)
 	return false;
 }
 
-static QDF_STATUS wmi_discard_fw_event(struct scheduler_msg *msg)
+/**
+ * wmi_sched_event_queue_purge() - drop the events waiting for the
+ *                                 scheduler thread
+ * @wmi_handle: handle to wmi
+ *
+ * Return: none
+ */
+static void wmi_sched_event_queue_purge(struct wmi_unified *wmi_handle)
 {
-	struct wmi_process_fw_event_params *event_param;
+	wmi_buf_t buf;
+	uint32_t event_id;
+
+	qdf_spin_lock_bh(&wmi_handle->sched_eventq_lock);
+	buf = qdf_nbuf_queue_remove(&wmi_handle->sched_event_queue);
+	while (buf) {
+		event_id = WMI_GET_FIELD(qdf_nbuf_data(buf), WMI_CMD_HDR,
+					 COMMANDID);
+		if (wmi_is_event_critical(wmi_handle, event_id))
+			qdf_atomic_dec(&wmi_handle->critical_events_in_flight);
+		qdf_nbuf_free(buf);
+		buf = qdf_nbuf_queue_remove(&wmi_handle->sched_event_queue);
+	}
+	wmi_handle->sched_event_posted = false;
+	qdf_spin_unlock_bh(&wmi_handle->sched_eventq_lock);
+}
 
+static QDF_STATUS wmi_discard_fw_event(struct scheduler_msg *msg)
+{
 	if (!msg->bodyptr)
 		return QDF_STATUS_E_INVAL;
 
-	event_param = (struct wmi_process_fw_event_params *)msg->bodyptr;
-	qdf_nbuf_free(event_param->evt_buf);
-	qdf_mem_free(msg->bodyptr);
+	wmi_sched_event_queue_purge((struct wmi_unified *)msg->bodyptr);
 	msg->bodyptr = NULL;
 	msg->bodyval = 0;
 	msg->type = 0;
@@ -2475,32 +2629,84 @@ static QDF_STATUS wmi_discard_fw_event(struct scheduler_msg *msg)
 	return QDF_STATUS_SUCCESS;
 }
 
+/* Max events handled per scheduler message before yielding the thread */
+#define WMI_SCHED_EVENT_BULK_MAX 32
+
+static QDF_STATUS wmi_post_fw_event_msg(struct wmi_unified *wmi_handle);
+
 static QDF_STATUS wmi_process_fw_event_handler(struct scheduler_msg *msg)
 {
-	struct wmi_process_fw_event_params *params =
-		(struct wmi_process_fw_event_params *)msg->bodyptr;
-	struct wmi_unified *wmi_handle;
+	struct wmi_unified *wmi_handle = (struct wmi_unified *)msg->bodyptr;
+	wmi_buf_t buf;
 	uint32_t event_id;
+	uint32_t count = 0;
+
+	while (1) {
+		qdf_spin_lock_bh(&wmi_handle->sched_eventq_lock);
+		if (count >= WMI_SCHED_EVENT_BULK_MAX &&
+		    !qdf_nbuf_is_queue_empty(&wmi_handle->sched_event_queue)) {
+			qdf_spin_unlock_bh(&wmi_handle->sched_eventq_lock);
+			/* let other scheduler queues run, then continue */
+			if (QDF_IS_STATUS_SUCCESS(
+					wmi_post_fw_event_msg(wmi_handle)))
+				break;
+			qdf_spin_lock_bh(&wmi_handle->sched_eventq_lock);
+		}
 
-	wmi_handle = (struct wmi_unified *)params->wmi_handle;
-	event_id = WMI_GET_FIELD(qdf_nbuf_data(params->evt_buf),
-				 WMI_CMD_HDR, COMMANDID);
-	wmi_process_fw_event(wmi_handle, params->evt_buf);
+		buf = qdf_nbuf_queue_remove(&wmi_handle->sched_event_queue);
+		if (!buf) {
+			wmi_handle->sched_event_posted = false;
+			qdf_spin_unlock_bh(&wmi_handle->sched_eventq_lock);
+			break;
+		}
+		qdf_spin_unlock_bh(&wmi_handle->sched_eventq_lock);
 
-	if (wmi_is_event_critical(wmi_handle, event_id))
-		qdf_atomic_dec(&wmi_handle->critical_events_in_flight);
+		event_id = WMI_GET_FIELD(qdf_nbuf_data(buf), WMI_CMD_HDR,
+					 COMMANDID);
+		wmi_process_fw_event(wmi_handle, buf);
 
-	qdf_mem_free(msg->bodyptr);
+		if (wmi_is_event_critical(wmi_handle, event_id))
+			qdf_atomic_dec(&wmi_handle->critical_events_in_flight);
+		count++;
+	}
+
+	if (count > wmi_handle->sched_event_bulk_max)
+		wmi_handle->sched_event_bulk_max = count;
 
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * wmi_post_fw_event_msg() - post a message to drain the event queue from
+ *                           the scheduler thread
+ * @wmi_handle: handle to wmi
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS wmi_post_fw_event_msg(struct wmi_unified *wmi_handle)
+{
+	struct scheduler_msg msg = { 0 };
+
+	msg.bodyptr = wmi_handle;
+	msg.bodyval = 0;
+	msg.callback = wmi_process_fw_event_handler;
+	msg.flush_callback = wmi_discard_fw_event;
+
+	wmi_handle->sched_event_msgs++;
+
+	return scheduler_post_message(QDF_MODULE_ID_TARGET_IF,
+				      QDF_MODULE_ID_TARGET_IF,
+				      QDF_MODULE_ID_TARGET_IF, &msg);
+}
+
 /**
  * wmi_process_fw_event_sched_thread_ctx() - common event handler to serialize
  *                                  event processing through scheduler thread
- * @ctx: wmi context
+ * @wmi: wmi context
  * @ev: event buffer
- * @rx_ctx: rx execution context
+ *
+ * Events are queued on the wmi handle and a scheduler message is only
+ * posted when none is pending, the handler then drains all queued events.
  *
  * Return: 0 on success, errno on failure
  */
@@ -2508,36 +2714,24 @@ static QDF_STATUS
 wmi_process_fw_event_sched_thread_ctx(struct wmi_unified *wmi,
 				      void *ev)
 {
-	struct wmi_process_fw_event_params *params_buf;
-	struct scheduler_msg msg = { 0 };
 	uint32_t event_id;
+	bool post;
 
-	params_buf = qdf_mem_malloc(sizeof(struct wmi_process_fw_event_params));
-	if (!params_buf) {
-		wmi_err("malloc failed");
-		qdf_nbuf_free(ev);
-		return QDF_STATUS_E_NOMEM;
-	}
-
-	params_buf->wmi_handle = wmi;
-	params_buf->evt_buf = ev;
-
-	event_id = WMI_GET_FIELD(qdf_nbuf_data(params_buf->evt_buf),
-				 WMI_CMD_HDR, COMMANDID);
+	event_id = WMI_GET_FIELD(qdf_nbuf_data(ev), WMI_CMD_HDR, COMMANDID);
 	if (wmi_is_event_critical(wmi, event_id))
 		qdf_atomic_inc(&wmi->critical_events_in_flight);
 
-	msg.bodyptr = params_buf;
-	msg.bodyval = 0;
-	msg.callback = wmi_process_fw_event_handler;
-	msg.flush_callback = wmi_discard_fw_event;
+	qdf_spin_lock_bh(&wmi->sched_eventq_lock);
+	qdf_nbuf_queue_add(&wmi->sched_event_queue, ev);
+	post = !wmi->sched_event_posted;
+	wmi->sched_event_posted = true;
+	qdf_spin_unlock_bh(&wmi->sched_eventq_lock);
+
+	if (!post)
+		return QDF_STATUS_SUCCESS;
 
-	if (QDF_STATUS_SUCCESS !=
-		scheduler_post_message(QDF_MODULE_ID_TARGET_IF,
-				       QDF_MODULE_ID_TARGET_IF,
-				       QDF_MODULE_ID_TARGET_IF, &msg)) {
-		qdf_nbuf_free(ev);
-		qdf_mem_free(params_buf);
+	if (QDF_STATUS_SUCCESS != wmi_post_fw_event_msg(wmi)) {
+		wmi_sched_event_queue_purge(wmi);
 		return QDF_STATUS_E_FAULT;
 	}
 
@@ -3168,6 +3362,8 @@ static QDF_STATUS wmi_initialize_worker_context(struct wmi_unified *wmi_handle)
 	}
 	qdf_spinlock_create(&wmi_handle->diag_eventq_lock);
 	qdf_nbuf_queue_init(&wmi_handle->diag_event_queue);
+	qdf_spinlock_create(&wmi_handle->sched_eventq_lock);
+	qdf_nbuf_queue_init(&wmi_handle->sched_event_queue);
 	qdf_create_work(0, &wmi_handle->rx_diag_event_work,
 			wmi_rx_diag_event_work, wmi_handle);
 	wmi_handle->wmi_rx_diag_events_dropped = 0;
@@ -3265,7 +3461,7 @@ qdf_export_symbol(wmi_unified_register_module);
  */
 static void wmi_wbuff_register(struct wmi_unified *wmi_handle)
 {
-	struct wbuff_alloc_request wbuff_alloc[4];
+	struct wbuff_alloc_request wbuff_alloc[6];
 	uint8_t reserve = WMI_MIN_HEAD_ROOM;
 
 	wbuff_alloc[0].pool_id = 0;
@@ -3284,6 +3480,14 @@ static void wmi_wbuff_register(struct wmi_unified *wmi_handle)
 	wbuff_alloc[3].pool_size = WMI_WBUFF_POOL_3_SIZE;
 	wbuff_alloc[3].buffer_size = roundup(WMI_WBUFF_LEN_POOL3 + reserve, 4);
 
+	wbuff_alloc[4].pool_id = 4;
+	wbuff_alloc[4].pool_size = WMI_WBUFF_POOL_4_SIZE;
+	wbuff_alloc[4].buffer_size = roundup(WMI_WBUFF_LEN_POOL4 + reserve, 4);
+
+	wbuff_alloc[5].pool_id = 5;
+	wbuff_alloc[5].pool_size = WMI_WBUFF_POOL_5_SIZE;
+	wbuff_alloc[5].buffer_size = roundup(WMI_WBUFF_LEN_POOL5 + reserve, 4);
+
 	wmi_handle->wbuff_handle =
 		wbuff_module_register(wbuff_alloc, QDF_ARRAY_SIZE(wbuff_alloc),
 				      reserve, 4, WBUFF_MODULE_WMI_TX);
@@ -3444,6 +3648,8 @@ void wmi_unified_detach(struct wmi_unified *wmi_handle)
 					&soc->wmi_pdev[i]->diag_event_queue);
 			}
 
+			wmi_sched_event_queue_purge(soc->wmi_pdev[i]);
+
 			wmi_log_buffer_free(soc->wmi_pdev[i]);
 
 			/* Free events logs list */
@@ -3454,6 +3660,8 @@ void wmi_unified_detach(struct wmi_unified *wmi_handle)
 			qdf_spinlock_destroy(&soc->wmi_pdev[i]->eventq_lock);
 			qdf_spinlock_destroy(
 					&soc->wmi_pdev[i]->diag_eventq_lock);
+			qdf_spinlock_destroy(
+					&soc->wmi_pdev[i]->sched_eventq_lock);
 
 			wmi_interface_sequence_deinit(soc->wmi_pdev[i]);
 			wmi_ext_dbgfs_deinit(soc->wmi_pdev[i]);
@@ -109,6 +109,7 @@ struct dp_rtpm_tput_policy_context {
  * @enable_tcp_param_update: enable tcp parameter update
  * @bus_low_cnt_threshold: Threshold count to trigger low Tput GRO flush skip
  * @enable_latency_crit_clients: Enable the handling of latency critical clients
+ * @bus_bw_forecast_enable: Vote bus bandwidth from the throughput forecast
  * * @del_ack_enable: enable Dynamic Configuration of Tcp Delayed Ack
  * @del_ack_threshold_high: High Threshold inorder to trigger TCP delay ack
  * @del_ack_threshold_low: Low Threshold inorder to trigger TCP delay ack
@@ -167,6 +168,7 @@ struct wlan_dp_psoc_cfg {
 	bool     enable_tcp_param_update;
 	uint32_t bus_low_cnt_threshold;
 	bool enable_latency_crit_clients;
+	bool bus_bw_forecast_enable;
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
 
 #ifdef QCA_SUPPORT_TXRX_DRIVER_TCP_DEL_ACK
@@ -228,14 +230,46 @@ struct wlan_dp_psoc_cfg {
 struct tx_rx_histogram {
 	uint64_t interval_rx;
 	uint64_t interval_tx;
+	uint64_t forecast_pkts;
 	uint32_t next_vote_level;
 	uint32_t next_rx_level;
 	uint32_t next_tx_level;
+	uint8_t vote_src;
 	bool is_rx_pm_qos_high;
 	bool is_tx_pm_qos_high;
 	uint64_t qtime;
 };
 
+/**
+ * enum dp_bus_bw_vote_src - Input the bus bandwidth vote was decided on
+ * @DP_BUS_BW_VOTE_SRC_MEASURED: throughput measured in the last interval
+ * @DP_BUS_BW_VOTE_SRC_FORECAST: throughput forecast of the next interval
+ * @DP_BUS_BW_VOTE_SRC_HINT: throughput hint given by user space
+ */
+enum dp_bus_bw_vote_src {
+	DP_BUS_BW_VOTE_SRC_MEASURED,
+	DP_BUS_BW_VOTE_SRC_FORECAST,
+	DP_BUS_BW_VOTE_SRC_HINT,
+};
+
+/**
+ * struct dp_bus_bw_forecast - Bus bandwidth forecast context
+ * @prev_tx_pkts: TX packets of the previous bus bandwidth interval
+ * @prev_rx_pkts: RX packets of the previous bus bandwidth interval
+ * @hint_level: throughput level hinted by user space
+ * @hint_expiry_ts: system timestamp (ms) the hint expires at
+ * @forecast_upvotes: number of votes raised by the forecast
+ * @hint_upvotes: number of votes raised by the throughput hint
+ */
+struct dp_bus_bw_forecast {
+	uint64_t prev_tx_pkts;
+	uint64_t prev_rx_pkts;
+	enum tput_level hint_level;
+	uint64_t hint_expiry_ts;
+	uint32_t forecast_upvotes;
+	uint32_t hint_upvotes;
+};
+
 /**
  * struct dp_stats - DP stats
  * @tx_rx_stats : Tx/Rx debug stats
@@ -502,6 +536,7 @@ struct dp_direct_link_context {
  * @bus_bw_lock: Bus bandwidth work lock
  * @cur_rx_level: Current Rx level
  * @bus_low_vote_cnt: bus low level count
+ * @bw_forecast: bus bandwidth forecast context
  * @disable_rx_ol_in_concurrency: disable RX offload in concurrency scenarios
  * @disable_rx_ol_in_low_tput: disable RX offload in tput scenarios
  * @txrx_hist_idx: txrx histogram index
@@ -562,6 +597,7 @@ struct wlan_dp_psoc_context {
 	uint64_t prev_tx;
 	qdf_atomic_t low_tput_gro_enable;
 	uint32_t bus_low_vote_cnt;
+	struct dp_bus_bw_forecast bw_forecast;
 #ifdef FEATURE_RUNTIME_PM
 	struct dp_rtpm_tput_policy_context rtpm_tput_policy_ctx;
 #endif
@@ -37,6 +37,44 @@
 /* Number of DP RX threads supported */
 #define DP_MAX_RX_THREADS WLAN_CFG_NUM_REO_DEST_RING
 
+/**
+ * enum dp_rx_tm_qdepth_hist - buckets of the RX thread queue depth histogram
+ * @DP_RX_TM_QDEPTH_0_7: 0 to 7 nbuf_lists queued
+ * @DP_RX_TM_QDEPTH_8_31: 8 to 31 nbuf_lists queued
+ * @DP_RX_TM_QDEPTH_32_127: 32 to 127 nbuf_lists queued
+ * @DP_RX_TM_QDEPTH_128_511: 128 to 511 nbuf_lists queued
+ * @DP_RX_TM_QDEPTH_512_PLUS: 512 or more nbuf_lists queued
+ * @DP_RX_TM_QDEPTH_HIST_MAX: number of histogram buckets
+ */
+enum dp_rx_tm_qdepth_hist {
+	DP_RX_TM_QDEPTH_0_7,
+	DP_RX_TM_QDEPTH_8_31,
+	DP_RX_TM_QDEPTH_32_127,
+	DP_RX_TM_QDEPTH_128_511,
+	DP_RX_TM_QDEPTH_512_PLUS,
+	DP_RX_TM_QDEPTH_HIST_MAX
+};
+
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+/* Flow buckets per REO ring, a flow is moved between threads by bucket */
+#define DP_RX_TM_STEAL_BUCKETS 64
+/* Queue length of the home thread above which its flows are moved away */
+#define DP_RX_TM_STEAL_HIGH_QLEN 64
+/* Queue length of a thread below which it may take over flows */
+#define DP_RX_TM_STEAL_LOW_QLEN 8
+
+/**
+ * struct dp_rx_tm_flow_bucket - RX thread ownership of a flow bucket
+ * @owner: id of the RX thread the bucket is queued to
+ * @last_pos: enqueue position of the owner after the last nbuf of the
+ *	      bucket was queued
+ */
+struct dp_rx_tm_flow_bucket {
+	uint8_t owner;
+	uint32_t last_pos;
+};
+#endif
+
 /*
  * struct dp_rx_tm_handle_cmn - Opaque handle for rx_threads to store
  * rx_tm_handle. This handle will be common for all the threads.
@@ -63,6 +101,12 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
  * @rx_nbufq_loop_yield: rx loop yield counter
+ * @nbufq_depth_hist: histogram of the nbuf queue depth seen at enqueue
+ * @nbuf_stolen: packets of other threads' REO rings handled by this thread
+ * @flow_migrations: flow buckets moved to this thread
+ * @cross_cluster_wakeups: wakeups where the thread ran on another cluster
+ *			   than the NAPI context that queued the packets
+ * @cluster_migrations: times the thread moved to the cluster of its NAPI
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -79,6 +123,11 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
 	unsigned int rx_nbufq_loop_yield;
+	unsigned int nbufq_depth_hist[DP_RX_TM_QDEPTH_HIST_MAX];
+	unsigned int nbuf_stolen;
+	unsigned int flow_migrations;
+	unsigned int cross_cluster_wakeups;
+	unsigned int cluster_migrations;
 };
 
 /**
@@ -117,6 +166,14 @@ enum dp_rx_refill_thread_state {
  * @napi: napi to deliver packet to stack via GRO
  * @wait_q: wait queue to conditionally wait on events for DP Rx thread
  * @netdev: dummy netdev to initialize the napi structure with
+ * @enq_pos: number of nbufs queued into the thread
+ * @deq_pos: number of nbufs delivered by the thread and flushed out of GRO
+ * @deq_pending: nbufs delivered by the thread since the last GRO flush
+ * @stolen_pending: nbufs of other threads' REO rings delivered since the
+ *		    last GRO flush
+ * @enq_cpu: CPU of the NAPI context that last queued packets to the thread
+ * @coloc_wakeups: wakeups seen in the current co-location window
+ * @coloc_cross: cross cluster wakeups seen in the current window
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -135,6 +192,17 @@ struct dp_rx_thread {
 	qdf_napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	qdf_dummy_netdev_t netdev;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+	qdf_atomic_t enq_pos;
+	qdf_atomic_t deq_pos;
+	uint32_t deq_pending;
+	bool stolen_pending;
+#endif
+#ifdef WLAN_DP_RX_THREAD_COLOCATE
+	qdf_atomic_t enq_cpu;
+	uint16_t coloc_wakeups;
+	uint16_t coloc_cross;
+#endif
 };
 
 /**
@@ -185,6 +253,10 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @flow_bucket: RX thread ownership of the flow buckets of each REO ring
+ * @base_mask: CPU mask applied with dp_rx_tm_set_cpu_mask(), co-location
+ *	       keeps the threads within it
+ * @base_mask_valid: @base_mask has been set
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -192,6 +264,14 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+	struct dp_rx_tm_flow_bucket
+		flow_bucket[DP_RX_TM_MAX_REO_RINGS][DP_RX_TM_STEAL_BUCKETS];
+#endif
+#ifdef WLAN_DP_RX_THREAD_COLOCATE
+	qdf_cpu_mask base_mask;
+	bool base_mask_valid;
+#endif
 };
 
 /**
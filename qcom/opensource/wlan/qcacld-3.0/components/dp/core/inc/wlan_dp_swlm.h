@@ -29,8 +29,21 @@
 /* Traffic test time is in us */
 #define DP_SWLM_TCL_TRAFFIC_SAMPLING_TIME 250
 #define DP_SWLM_TCL_TIME_FLUSH_THRESH 1000
+#define DP_SWLM_TCL_TIME_FLUSH_MIN_THRESH 250
 #define DP_SWLM_TCL_TX_THRESH_MULTIPLIER 2
 
+/*
+ * TX bytes per sampling period (~1 Gbps) at and above which the full
+ * session time threshold is used; below it the threshold is scaled down
+ * linearly to the min so that low rate traffic is delayed less.
+ */
+#define DP_SWLM_TCL_HIGH_TRAFFIC_THRESH 31250
+/* Weight shift of the TX bytes moving average */
+#define DP_SWLM_TCL_AVG_WEIGHT_SHIFT 2
+
+/* Max refill buffers posted to the ring without an HP update */
+#define DP_SWLM_REFILL_MAX_PENDING 64
+
 /* Inline Functions */
 
 /**
@@ -69,10 +82,19 @@ bool dp_tx_is_special_frame(qdf_nbuf_t nbuf, uint32_t frame_mask)
 static inline QDF_STATUS
 dp_swlm_tcl_reset_session_data(struct dp_soc *soc, uint8_t ring_id)
 {
+	struct dp_swlm *swlm = &soc->swlm;
 	struct dp_swlm_params *params = &soc->swlm.params;
+	u64 curr_time = qdf_get_log_timestamp_usecs();
 
-	params->tcl[ring_id].coalesce_end_time = qdf_get_log_timestamp_usecs() +
-		params->time_flush_thresh;
+	if (params->tcl[ring_id].session_start_time) {
+		DP_STATS_INC(swlm, tcl[ring_id].sessions, 1);
+		DP_STATS_INC(swlm, tcl[ring_id].latency_us,
+			     curr_time - params->tcl[ring_id].session_start_time);
+		params->tcl[ring_id].session_start_time = 0;
+	}
+
+	params->tcl[ring_id].coalesce_end_time = curr_time +
+		params->tcl[ring_id].time_flush_thresh;
 	params->tcl[ring_id].bytes_coalesced = 0;
 	params->tcl[ring_id].bytes_flush_thresh =
 				params->tcl[ring_id].sampling_session_tx_bytes *
@@ -82,6 +104,33 @@ dp_swlm_tcl_reset_session_data(struct dp_soc *soc, uint8_t ring_id)
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * dp_swlm_refill_reset_session_data() - Reset the refill coalescing session
+ * @soc: DP soc handle
+ * @lmac_id: lmac id of the refill ring
+ *
+ * Called with the refill ring lock held, right before the HP is written.
+ *
+ * Returns: QDF_STATUS
+ */
+static inline QDF_STATUS
+dp_swlm_refill_reset_session_data(struct dp_soc *soc, uint8_t lmac_id)
+{
+	struct dp_swlm *swlm = &soc->swlm;
+	struct dp_swlm_refill_params *refill = &swlm->params.refill[lmac_id];
+
+	if (refill->session_start_time) {
+		DP_STATS_INC(swlm, refill[lmac_id].sessions, 1);
+		DP_STATS_INC(swlm, refill[lmac_id].latency_us,
+			     qdf_get_log_timestamp_usecs() -
+			     refill->session_start_time);
+		refill->session_start_time = 0;
+	}
+	refill->num_pending = 0;
+
+	return QDF_STATUS_SUCCESS;
+}
+
 /**
  * dp_swlm_tcl_pre_check() - Pre checks for current packet to be transmitted
  * @soc: Datapath soc handle
@@ -137,6 +186,9 @@ static inline int dp_swlm_query_policy(struct dp_soc *soc, int ring_type,
 	case TCL_DATA:
 		return swlm->ops->tcl_wr_coalesce_check(soc,
 							query_data.tcl_data);
+	case RXDMA_BUF:
+		return swlm->ops->refill_wr_coalesce_check(soc,
+						query_data.refill_data);
 	default:
 		dp_err("Ring type %d not supported by SW latency manager",
 		       ring_type);
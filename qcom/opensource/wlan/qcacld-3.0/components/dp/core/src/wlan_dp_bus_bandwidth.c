@@ -963,6 +963,26 @@ static uint8_t *dp_tp_level_to_str(uint32_t level)
 	}
 }
 
+/**
+ * dp_bus_bw_vote_src_to_str() - Convert bus bandwidth vote source to string
+ * @src: vote source
+ *
+ * Return: converted string
+ */
+static uint8_t *dp_bus_bw_vote_src_to_str(uint8_t src)
+{
+	switch (src) {
+	case DP_BUS_BW_VOTE_SRC_MEASURED:
+		return "MEAS";
+	case DP_BUS_BW_VOTE_SRC_FORECAST:
+		return "FCST";
+	case DP_BUS_BW_VOTE_SRC_HINT:
+		return "HINT";
+	default:
+		return "INVAL";
+	}
+}
+
 void wlan_dp_display_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 {
 	struct wlan_dp_psoc_context *dp_ctx = dp_psoc_get_priv(psoc);
@@ -989,12 +1009,17 @@ void wlan_dp_display_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 		     dp_ctx->dp_cfg.tcp_delack_thres_low);
 	dp_nofl_info("TCP TX HIGH TP TH: %d (Use to set tcp_output_bytes_lim)",
 		     dp_ctx->dp_cfg.tcp_tx_high_tput_thres);
+	dp_nofl_info("BW forecast: %d upvotes(forecast: %u hint: %u) hint level: %d",
+		     dp_ctx->dp_cfg.bus_bw_forecast_enable,
+		     dp_ctx->bw_forecast.forecast_upvotes,
+		     dp_ctx->bw_forecast.hint_upvotes,
+		     dp_ctx->bw_forecast.hint_level);
 
 	dp_nofl_info("Total entries: %d Current index: %d",
 		     NUM_TX_RX_HISTOGRAM, dp_ctx->txrx_hist_idx);
 
 	if (dp_ctx->txrx_hist) {
-		dp_nofl_info("[index][timestamp]: interval_rx, interval_tx, bus_bw_level, RX TP Level, TX TP Level, Rx:Tx pm_qos");
+		dp_nofl_info("[index][timestamp]: interval_rx, interval_tx, vote_pkts, bus_bw_level, vote src, RX TP Level, TX TP Level, Rx:Tx pm_qos");
 
 		for (i = 0; i < NUM_TX_RX_HISTOGRAM; i++) {
 			struct tx_rx_histogram *hist;
@@ -1003,10 +1028,11 @@ void wlan_dp_display_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 			if (dp_ctx->txrx_hist[i].qtime <= 0)
 				continue;
 			hist = &dp_ctx->txrx_hist[i];
-			dp_nofl_info("[%3d][%15llu]: %6llu, %6llu, %s, %s, %s, %s:%s",
+			dp_nofl_info("[%3d][%15llu]: %6llu, %6llu, %6llu, %s, %s, %s, %s, %s:%s",
 				     i, hist->qtime, hist->interval_rx,
-				     hist->interval_tx,
+				     hist->interval_tx, hist->forecast_pkts,
 				     pld_bus_width_type_to_str(hist->next_vote_level),
+				     dp_bus_bw_vote_src_to_str(hist->vote_src),
 				     dp_tp_level_to_str(hist->next_rx_level),
 				     dp_tp_level_to_str(hist->next_tx_level),
 				     hist->is_rx_pm_qos_high ? "HIGH" : "LOW",
@@ -1024,6 +1050,8 @@ void wlan_dp_clear_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 		return;
 	}
 
+	dp_ctx->bw_forecast.forecast_upvotes = 0;
+	dp_ctx->bw_forecast.hint_upvotes = 0;
 	dp_ctx->txrx_hist_idx = 0;
 	if (dp_ctx->txrx_hist)
 		qdf_mem_zero(dp_ctx->txrx_hist,
@@ -1239,6 +1267,7 @@ static inline void dp_pm_qos_update_cpu_mask(qdf_cpu_mask *mask,
  * @next_rx_level: pointer to next_rx_level to be filled
  * @cpu_mask: pm_qos cpu_mask needed for RX, to be filled
  * @is_rx_pm_qos_high: pointer indicating if high qos is needed, to be filled
+ * @pre_vote: RX packets are forecasted, skip the high level debounce
  *
  * The function tunes various aspects of driver based on a running average
  * of RX packets received in last bus bandwidth interval.
@@ -1251,7 +1280,8 @@ bool dp_bus_bandwidth_work_tune_rx(struct wlan_dp_psoc_context *dp_ctx,
 				   uint64_t diff_us,
 				   enum wlan_tp_level *next_rx_level,
 				   qdf_cpu_mask *cpu_mask,
-				   bool *is_rx_pm_qos_high)
+				   bool *is_rx_pm_qos_high,
+				   bool pre_vote)
 {
 	bool rx_level_change = false;
 	bool rxthread_high_tput_req;
@@ -1315,7 +1345,8 @@ bool dp_bus_bandwidth_work_tune_rx(struct wlan_dp_psoc_context *dp_ctx,
 	/* fine-tuning parameters for RX Flows */
 	if (avg_rx > dp_ctx->dp_cfg.tcp_delack_thres_high) {
 		if (dp_ctx->cur_rx_level != WLAN_SVC_TP_HIGH &&
-		    ++dp_ctx->rx_high_ind_cnt == delack_timer_cnt) {
+		    (++dp_ctx->rx_high_ind_cnt == delack_timer_cnt ||
+		     pre_vote)) {
 			*next_rx_level = WLAN_SVC_TP_HIGH;
 		}
 	} else {
@@ -1460,6 +1491,110 @@ bool dp_sap_p2p_update_mid_high_tput(struct wlan_dp_psoc_context *dp_ctx,
 	return false;
 }
 
+/**
+ * dp_tput_level_to_bus_width() - Convert throughput level to bus width vote
+ * @tput_level: throughput level
+ *
+ * Return: PLD bus width vote
+ */
+static enum pld_bus_width_type
+dp_tput_level_to_bus_width(enum tput_level tput_level)
+{
+	switch (tput_level) {
+	case TPUT_LEVEL_SUPER_HIGH:
+		return PLD_BUS_WIDTH_MAX;
+	case TPUT_LEVEL_ULTRA_HIGH:
+		return PLD_BUS_WIDTH_ULTRA_HIGH;
+	case TPUT_LEVEL_VERY_HIGH:
+		return PLD_BUS_WIDTH_VERY_HIGH;
+	case TPUT_LEVEL_MID_HIGH:
+		return PLD_BUS_WIDTH_MID_HIGH;
+	case TPUT_LEVEL_HIGH:
+		return PLD_BUS_WIDTH_HIGH;
+	case TPUT_LEVEL_MEDIUM:
+		return PLD_BUS_WIDTH_MEDIUM;
+	case TPUT_LEVEL_LOW:
+		return PLD_BUS_WIDTH_LOW;
+	default:
+		return PLD_BUS_WIDTH_IDLE;
+	}
+}
+
+/**
+ * dp_bus_bw_forecast_pkts() - Forecast the packets of the next interval
+ * @dp_ctx: DP context
+ * @tx_packets: TX packets measured in the last interval
+ * @rx_packets: RX packets measured in the last interval
+ * @fc_tx_packets: forecasted TX packets, to be filled
+ * @fc_rx_packets: forecasted RX packets, to be filled
+ *
+ * A rising rate is linearly extrapolated by the change from the previous
+ * interval, so that the votes ramp up one interval earlier. A falling rate
+ * is not extrapolated, the votes still ramp down on the measured rate.
+ *
+ * Return: source of the packet counts
+ */
+static enum dp_bus_bw_vote_src
+dp_bus_bw_forecast_pkts(struct wlan_dp_psoc_context *dp_ctx,
+			uint64_t tx_packets, uint64_t rx_packets,
+			uint64_t *fc_tx_packets, uint64_t *fc_rx_packets)
+{
+	struct dp_bus_bw_forecast *fc = &dp_ctx->bw_forecast;
+	enum dp_bus_bw_vote_src src = DP_BUS_BW_VOTE_SRC_MEASURED;
+
+	*fc_tx_packets = tx_packets;
+	*fc_rx_packets = rx_packets;
+
+	if (!dp_ctx->dp_cfg.bus_bw_forecast_enable)
+		return src;
+
+	if (tx_packets > fc->prev_tx_pkts) {
+		*fc_tx_packets += tx_packets - fc->prev_tx_pkts;
+		src = DP_BUS_BW_VOTE_SRC_FORECAST;
+	}
+
+	if (rx_packets > fc->prev_rx_pkts) {
+		*fc_rx_packets += rx_packets - fc->prev_rx_pkts;
+		src = DP_BUS_BW_VOTE_SRC_FORECAST;
+	}
+
+	fc->prev_tx_pkts = tx_packets;
+	fc->prev_rx_pkts = rx_packets;
+
+	return src;
+}
+
+/**
+ * dp_bus_bw_apply_tput_hint() - Raise the throughput level to the user space
+ *  hint
+ * @dp_ctx: DP context
+ * @tput_level: throughput level, updated if raised
+ * @next_vote_level: bus width vote, updated if raised
+ * @vote_src: source of the vote, updated if raised
+ *
+ * Return: None
+ */
+static void
+dp_bus_bw_apply_tput_hint(struct wlan_dp_psoc_context *dp_ctx,
+			  enum tput_level *tput_level,
+			  enum pld_bus_width_type *next_vote_level,
+			  enum dp_bus_bw_vote_src *vote_src)
+{
+	struct dp_bus_bw_forecast *fc = &dp_ctx->bw_forecast;
+
+	if (fc->hint_level <= *tput_level)
+		return;
+
+	if (qdf_get_system_timestamp() >= fc->hint_expiry_ts) {
+		fc->hint_level = TPUT_LEVEL_NONE;
+		return;
+	}
+
+	*tput_level = fc->hint_level;
+	*next_vote_level = dp_tput_level_to_bus_width(fc->hint_level);
+	*vote_src = DP_BUS_BW_VOTE_SRC_HINT;
+}
+
 /**
  * dp_pld_request_bus_bandwidth() - Function to control bus bandwidth
  * @dp_ctx: handle to DP context
@@ -1483,6 +1618,8 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 	bool tx_level_change;
 	bool dptrace_high_tput_req;
 	u64 total_pkts = tx_packets + rx_packets;
+	uint64_t fc_tx_packets, fc_rx_packets, vote_pkts;
+	enum dp_bus_bw_vote_src vote_src;
 	enum pld_bus_width_type next_vote_level = PLD_BUS_WIDTH_IDLE;
 	static enum wlan_tp_level next_rx_level = WLAN_SVC_TP_NONE;
 	enum wlan_tp_level next_tx_level = WLAN_SVC_TP_NONE;
@@ -1503,29 +1640,33 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 	if (!soc)
 		return;
 
+	vote_src = dp_bus_bw_forecast_pkts(dp_ctx, tx_packets, rx_packets,
+					   &fc_tx_packets, &fc_rx_packets);
+	vote_pkts = fc_tx_packets + fc_rx_packets;
+
 	if (dp_ctx->high_bus_bw_request) {
 		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
 		tput_level = TPUT_LEVEL_VERY_HIGH;
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_super_high_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_super_high_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_MAX;
 		tput_level = TPUT_LEVEL_SUPER_HIGH;
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_ultra_high_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_ultra_high_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_ULTRA_HIGH;
 		tput_level = TPUT_LEVEL_ULTRA_HIGH;
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_very_high_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_very_high_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
 		tput_level = TPUT_LEVEL_VERY_HIGH;
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_high_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_high_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_HIGH;
 		tput_level = TPUT_LEVEL_HIGH;
-		if (dp_sap_p2p_update_mid_high_tput(dp_ctx, total_pkts)) {
+		if (dp_sap_p2p_update_mid_high_tput(dp_ctx, vote_pkts)) {
 			next_vote_level = PLD_BUS_WIDTH_MID_HIGH;
 			tput_level = TPUT_LEVEL_MID_HIGH;
 		}
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_medium_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_medium_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_MEDIUM;
 		tput_level = TPUT_LEVEL_MEDIUM;
-	} else if (total_pkts > dp_ctx->dp_cfg.bus_bw_low_threshold) {
+	} else if (vote_pkts > dp_ctx->dp_cfg.bus_bw_low_threshold) {
 		next_vote_level = PLD_BUS_WIDTH_LOW;
 		tput_level = TPUT_LEVEL_LOW;
 	} else {
@@ -1540,12 +1681,30 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 	 */
 	if (!ucfg_ipa_is_fw_wdi_activated(dp_ctx->pdev) &&
 	    policy_mgr_is_current_hwmode_dbs(dp_ctx->psoc) &&
-	    (total_pkts > dp_ctx->dp_cfg.bus_bw_dbs_threshold) &&
+	    (vote_pkts > dp_ctx->dp_cfg.bus_bw_dbs_threshold) &&
 	    (tput_level < TPUT_LEVEL_SUPER_HIGH)) {
 		next_vote_level = PLD_BUS_WIDTH_ULTRA_HIGH;
 		tput_level = TPUT_LEVEL_ULTRA_HIGH;
 	}
 
+	dp_bus_bw_apply_tput_hint(dp_ctx, &tput_level, &next_vote_level,
+				  &vote_src);
+
+	/*
+	 * Only count the intervals in which the forecast or the hint raised
+	 * the vote above the one of the measured throughput.
+	 */
+	if (next_vote_level > dp_ctx->cur_vote_level) {
+		if (vote_src == DP_BUS_BW_VOTE_SRC_HINT)
+			dp_ctx->bw_forecast.hint_upvotes++;
+		else if (vote_src == DP_BUS_BW_VOTE_SRC_FORECAST)
+			dp_ctx->bw_forecast.forecast_upvotes++;
+	}
+
+	/*
+	 * The runtime PM and TCP RX/TX levels below follow the same forecast
+	 * so that they are ramped up in the same interval as the bus vote.
+	 */
 	param.policy = BBM_TPUT_POLICY;
 	param.policy_info.tput_level = tput_level;
 	dp_bbm_apply_independent_policy(dp_ctx->psoc, &param);
@@ -1624,14 +1783,16 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 	qdf_dp_trace_apply_tput_policy(dptrace_high_tput_req);
 
 	rx_level_change = dp_bus_bandwidth_work_tune_rx(dp_ctx,
-							rx_packets,
+							fc_rx_packets,
 							diff_us,
 							&next_rx_level,
 							&pm_qos_cpu_mask_rx,
-							&is_rx_pm_qos_high);
+							&is_rx_pm_qos_high,
+							vote_src !=
+							DP_BUS_BW_VOTE_SRC_MEASURED);
 
 	tx_level_change = dp_bus_bandwidth_work_tune_tx(dp_ctx,
-							tx_packets,
+							fc_tx_packets,
 							diff_us,
 							&next_tx_level,
 							&pm_qos_cpu_mask_tx,
@@ -1696,6 +1857,8 @@ static void dp_pld_request_bus_bandwidth(struct wlan_dp_psoc_context *dp_ctx,
 				next_vote_level;
 			dp_ctx->txrx_hist[index].interval_rx = rx_packets;
 			dp_ctx->txrx_hist[index].interval_tx = tx_packets;
+			dp_ctx->txrx_hist[index].forecast_pkts = vote_pkts;
+			dp_ctx->txrx_hist[index].vote_src = vote_src;
 			dp_ctx->txrx_hist[index].qtime =
 				qdf_get_log_timestamp();
 			dp_ctx->txrx_hist_idx++;
@@ -2102,6 +2265,28 @@ static void __dp_bus_bw_compute_timer_start(struct wlan_objmgr_psoc *psoc)
 	dp_ctx->bw_vote_time = qdf_get_log_timestamp();
 }
 
+void dp_bus_bw_set_tput_hint(struct wlan_objmgr_psoc *psoc,
+			     enum tput_level tput_level,
+			     uint32_t duration_ms)
+{
+	struct wlan_dp_psoc_context *dp_ctx = dp_psoc_get_priv(psoc);
+
+	if (!dp_ctx) {
+		dp_err("Unable to get DP context");
+		return;
+	}
+
+	if (tput_level >= TPUT_LEVEL_MAX) {
+		dp_err("invalid tput level %d", tput_level);
+		return;
+	}
+
+	dp_ctx->bw_forecast.hint_expiry_ts = qdf_get_system_timestamp() +
+					     duration_ms;
+	dp_ctx->bw_forecast.hint_level = tput_level;
+	dp_info("tput hint level %d for %u ms", tput_level, duration_ms);
+}
+
 void dp_bus_bw_compute_timer_start(struct wlan_objmgr_psoc *psoc)
 {
 	dp_enter();
@@ -2160,6 +2345,8 @@ static void __dp_bus_bw_compute_timer_stop(struct wlan_objmgr_psoc *psoc)
 
 	cdp_set_bus_vote_lvl_high(soc, false);
 	dp_ctx->bw_vote_time = 0;
+	dp_ctx->bw_forecast.prev_tx_pkts = 0;
+	dp_ctx->bw_forecast.prev_rx_pkts = 0;
 
 exit:
 	/**
@@ -2171,6 +2358,7 @@ exit:
 		uint64_t interval_us =
 			dp_ctx->dp_cfg.bus_bw_compute_interval * 1000;
 		qdf_atomic_set(&dp_ctx->num_latency_critical_clients, 0);
+		dp_ctx->bw_forecast.hint_level = TPUT_LEVEL_NONE;
 		dp_pld_request_bus_bandwidth(dp_ctx, 0, 0, interval_us);
 	}
 	param.policy = BBM_TPUT_POLICY;
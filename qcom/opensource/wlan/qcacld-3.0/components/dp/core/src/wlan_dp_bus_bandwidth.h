@@ -271,6 +271,21 @@ void wlan_dp_display_tx_rx_histogram(struct wlan_objmgr_psoc *psoc);
  */
 void wlan_dp_clear_tx_rx_histogram(struct wlan_objmgr_psoc *psoc);
 
+/**
+ * dp_bus_bw_set_tput_hint() - Set the throughput level expected by user space
+ * @psoc: psoc handle
+ * @tput_level: expected throughput level
+ * @duration_ms: duration of the hint in ms
+ *
+ * The bus bandwidth, runtime PM and TCP levels are voted for at least the
+ * hinted throughput level until the hint expires.
+ *
+ * Return: None
+ */
+void dp_bus_bw_set_tput_hint(struct wlan_objmgr_psoc *psoc,
+			     enum tput_level tput_level,
+			     uint32_t duration_ms);
+
 /**
  * dp_bus_bandwidth_init() - Initialize bus bandwidth data structures.
  * @psoc: psoc handle
@@ -403,6 +418,13 @@ void wlan_dp_clear_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 {
 }
 
+static inline
+void dp_bus_bw_set_tput_hint(struct wlan_objmgr_psoc *psoc,
+			     enum tput_level tput_level,
+			     uint32_t duration_ms)
+{
+}
+
 static inline
 void dp_bus_bandwidth_init(struct wlan_objmgr_psoc *psoc)
 {
@@ -199,6 +199,29 @@ dp_fisa_is_ipsec_connection(struct cdp_rx_flow_tuple_info *flow_tuple_info)
 	return false;
 }
 
+/**
+ * dp_fisa_is_esp_in_udp_connection() - Check if the flow is ESP-in-UDP
+ * @flow_tuple_info: flow tuple of the msdu
+ *
+ * UDP encapsulated ESP uses the NAT-T port, IKE runs on its own port
+ * and is never aggregated.
+ *
+ * Return: true if the flow is a NAT-T flow, false otherwise
+ */
+static bool
+dp_fisa_is_esp_in_udp_connection(struct cdp_rx_flow_tuple_info *flow_tuple_info)
+{
+	if (flow_tuple_info->dest_port == IPSEC_PORT ||
+	    flow_tuple_info->src_port == IPSEC_PORT)
+		return false;
+
+	if (flow_tuple_info->dest_port == IPSEC_NAT_PORT ||
+	    flow_tuple_info->src_port == IPSEC_NAT_PORT)
+		return true;
+
+	return false;
+}
+
 /**
  * get_flow_tuple_from_nbuf() - Get the flow tuple from msdu
  * @soc: DP soc handle
@@ -245,7 +268,10 @@ get_flow_tuple_from_nbuf(struct dp_soc *soc,
 
 	flow_tuple_info->dest_port = qdf_ntohs(tcph->dest);
 	flow_tuple_info->src_port = qdf_ntohs(tcph->source);
-	if (dp_fisa_is_ipsec_connection(flow_tuple_info))
+	if (dp_fisa_is_ipsec_connection(flow_tuple_info) &&
+	    !(soc->rx_fst->esp_in_udp && 
+	      iph->ip_proto == QDF_NBUF_TRAC_UDP_TYPE &&
+	      dp_fisa_is_esp_in_udp_connection(flow_tuple_info)))
 		flow_tuple_info->is_exception = 1;
 	else
 		flow_tuple_info->is_exception = 0;
@@ -788,6 +814,27 @@ dp_fisa_rx_get_hw_ft_timestamp(struct dp_rx_fst *fisa_hdl,
 	return ((struct rx_flow_search_entry *)sw_ft_entry->hw_fse)->timestamp;
 }
 
+/**
+ * dp_fisa_rx_fse_cache_flush_post() - Arm the FSE cache flush timer
+ * @fisa_hdl: handle to FISA context
+ *
+ * Send HTT cache invalidation command to firmware on timer expiry to
+ * reflect the flow update
+ *
+ * Return: None
+ */
+static void dp_fisa_rx_fse_cache_flush_post(struct dp_rx_fst *fisa_hdl)
+{
+	if (fisa_hdl->fse_cache_flush_allow &&
+	    (qdf_atomic_inc_return(&fisa_hdl->fse_cache_flush_posted) == 1)) {
+		/* return 1 after increment implies FSE cache flush message
+		 * already posted. so start restart the timer
+		 */
+		qdf_timer_start(&fisa_hdl->fse_cache_flush_timer,
+				FSE_CACHE_FLUSH_TIME_OUT);
+	}
+}
+
 /**
  * dp_fisa_rx_fst_update() - Core logic which helps in Addition/Deletion
  * of flows
@@ -864,12 +911,19 @@ static void dp_fisa_rx_fst_update(struct dp_rx_fst *fisa_hdl,
 			      fisa_hdl->hash_collision_cnt);
 		fisa_hdl->hash_collision_cnt++;
 
+		/* Entries still waiting for their HW FSE have no valid
+		 * timestamp and must not be picked for eviction.
+		 */
+		if (sw_ft_entry->hw_fse_pending)
+			goto next_entry;
+
 		timestamp = dp_fisa_rx_get_hw_ft_timestamp(fisa_hdl,
 							   hashed_flow_idx);
 		if (timestamp < lru_ft_entry_time) {
 			lru_ft_entry_time = timestamp;
 			lru_ft_entry_idx = hashed_flow_idx;
 		}
+next_entry:
 		skid_count++;
 		hashed_flow_idx++;
 		hashed_flow_idx &= fisa_hdl->hash_mask;
@@ -880,26 +934,54 @@ static void dp_fisa_rx_fst_update(struct dp_rx_fst *fisa_hdl,
 	 * Remove LRU flow from HW FT
 	 * Remove LRU flow from SW FT
 	 */
+	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
+				fisa_hdl->base)[lru_ft_entry_idx]);
 	if ((skid_count > max_skid_length) &&
+	    !sw_ft_entry->hw_fse_pending &&
 	    wlan_cfg_is_rx_fisa_lru_del_enabled(cfg_ctx)) {
 		dp_fisa_debug("Max skid length reached flow cannot be added, evict exiting flow");
 		dp_fisa_rx_delete_flow(fisa_hdl, elem, lru_ft_entry_idx);
 		is_fst_updated = true;
 	}
 
-	/**
-	 * Send HTT cache invalidation command to firmware to
-	 * reflect the flow update
-	 */
-	if (is_fst_updated &&
-	    fisa_hdl->fse_cache_flush_allow &&
-	    (qdf_atomic_inc_return(&fisa_hdl->fse_cache_flush_posted) == 1)) {
-		/* return 1 after increment implies FSE cache flush message
-		 * already posted. so start restart the timer
-		 */
-		qdf_timer_start(&fisa_hdl->fse_cache_flush_timer,
-				FSE_CACHE_FLUSH_TIME_OUT);
-	}
+	if (is_fst_updated)
+		dp_fisa_rx_fse_cache_flush_post(fisa_hdl);
+}
+
+/**
+ * dp_fisa_rx_fst_update_hw_fse() - Program the HW FSE for a flow whose
+ * SW FT entry was already added from RX context
+ * @fisa_hdl: handle to FISA context
+ * @elem: details of the flow which is being added
+ *
+ * Return: true if the HW FSE was programmed, false if the inline SW FT
+ *	   entry is gone and the flow has to take the regular add path
+ */
+static bool dp_fisa_rx_fst_update_hw_fse(struct dp_rx_fst *fisa_hdl,
+					 struct dp_fisa_rx_fst_update_elem *elem)
+{
+	struct dp_fisa_rx_sw_ft *sw_ft_entry;
+	uint32_t hashed_flow_idx;
+
+	hashed_flow_idx = elem->flow_idx & fisa_hdl->hash_mask;
+	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
+				fisa_hdl->base)[hashed_flow_idx]);
+
+	if (!sw_ft_entry->is_populated || !sw_ft_entry->hw_fse_pending ||
+	    !is_same_flow(&sw_ft_entry->rx_flow_tuple_info,
+			  &elem->flow_tuple_info))
+		return false;
+
+	sw_ft_entry->cmem_offset =
+		dp_rx_fisa_setup_cmem_fse(fisa_hdl, hashed_flow_idx,
+					  &elem->flow_tuple_info,
+					  elem->reo_dest_indication);
+	sw_ft_entry->hw_fse_pending = false;
+	fisa_hdl->add_flow_count++;
+
+	dp_fisa_rx_fse_cache_flush_post(fisa_hdl);
+
+	return true;
 }
 
 /**
@@ -931,7 +1013,9 @@ void dp_fisa_rx_fst_update_work(void *arg)
 	while (qdf_list_peek_front(&fisa_hdl->fst_update_list, &node) ==
 	       QDF_STATUS_SUCCESS) {
 		elem = (struct dp_fisa_rx_fst_update_elem *)node;
-		dp_fisa_rx_fst_update(fisa_hdl, elem);
+		if (!elem->sw_ft_populated ||
+		    !dp_fisa_rx_fst_update_hw_fse(fisa_hdl, elem))
+			dp_fisa_rx_fst_update(fisa_hdl, elem);
 		qdf_list_remove_front(&fisa_hdl->fst_update_list, &node);
 		qdf_mem_free(elem);
 	}
@@ -976,6 +1060,52 @@ dp_fisa_rx_is_fst_work_queued(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx)
 	return false;
 }
 
+/**
+ * dp_fisa_rx_add_sw_ft_entry_inline() - Add SW FT entry from RX context
+ * @fisa_hdl: Handle to FISA context
+ * @elem: details of the flow which is being added
+ *
+ * Claim the hashed SW FT slot for a new flow right away, so that the
+ * packets received before the FST update work runs can be aggregated.
+ * Only the HW FSE programming, which needs the target awake, is left to
+ * the work. Hash collisions and LRU eviction stay with the work as well.
+ * Caller must hold dp_rx_fst_lock.
+ *
+ * Return: true if the SW FT entry was added, false otherwise
+ */
+static bool
+dp_fisa_rx_add_sw_ft_entry_inline(struct dp_rx_fst *fisa_hdl,
+				  struct dp_fisa_rx_fst_update_elem *elem)
+{
+	struct dp_fisa_rx_sw_ft *sw_ft_entry;
+	uint32_t hashed_flow_idx;
+
+	hashed_flow_idx = elem->flow_idx & fisa_hdl->hash_mask;
+	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
+				fisa_hdl->base)[hashed_flow_idx]);
+	if (sw_ft_entry->is_populated)
+		return false;
+
+	dp_rx_fisa_update_sw_ft_entry(sw_ft_entry, elem->flow_idx, elem->vdev,
+				      fisa_hdl->soc_hdl, hashed_flow_idx);
+	sw_ft_entry->napi_id = elem->reo_id;
+	sw_ft_entry->reo_dest_indication = elem->reo_dest_indication;
+	qdf_mem_copy(&sw_ft_entry->rx_flow_tuple_info, &elem->flow_tuple_info,
+		     sizeof(struct cdp_rx_flow_tuple_info));
+	sw_ft_entry->flow_init_ts = qdf_get_log_timestamp();
+	sw_ft_entry->is_flow_tcp = elem->is_tcp_flow;
+	sw_ft_entry->is_flow_udp = elem->is_udp_flow;
+	sw_ft_entry->hw_fse_pending = true;
+	/* Publish the entry only after it is fully set up */
+	qdf_wmb();
+	sw_ft_entry->is_populated = true;
+
+	elem->sw_ft_populated = true;
+	DP_STATS_INC(fisa_hdl, inline_flow_add, 1);
+
+	return true;
+}
+
 /**
  * dp_fisa_rx_queue_fst_update_work() - Queue FST update work
  * @fisa_hdl: Handle to FISA context
@@ -996,7 +1126,7 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 	struct dp_fisa_rx_sw_ft *sw_ft_entry;
 	uint32_t hashed_flow_idx;
 	uint32_t reo_dest_indication;
-	bool found;
+	bool found, sw_ft_added;
 	struct hal_proto_params proto_params;
 
 	if (hal_rx_get_proto_params(fisa_hdl->soc_hdl->hal_soc, rx_tlv_hdr,
@@ -1011,11 +1141,6 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 
 	hal_rx_msdu_get_reo_destination_indication(hal_soc_hdl, rx_tlv_hdr,
 						   &reo_dest_indication);
-	qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
-	found = dp_fisa_rx_is_fst_work_queued(fisa_hdl, flow_idx);
-	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
-	if (found)
-		return NULL;
 
 	hashed_flow_idx = flow_idx & fisa_hdl->hash_mask;
 	sw_ft_entry = &(((struct dp_fisa_rx_sw_ft *)
@@ -1026,10 +1151,17 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 	if (flow_tuple_info.bypass_fisa)
 		return NULL;
 
+	/* Also covers flows added inline whose HW FSE is still pending */
 	if (sw_ft_entry->is_populated && is_same_flow(
 			&sw_ft_entry->rx_flow_tuple_info, &flow_tuple_info))
 		return sw_ft_entry;
 
+	qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
+	found = dp_fisa_rx_is_fst_work_queued(fisa_hdl, flow_idx);
+	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
+	if (found)
+		return NULL;
+
 	elem = qdf_mem_malloc(sizeof(*elem));
 	if (!elem) {
 		dp_fisa_debug("failed to allocate memory for FST update");
@@ -1046,6 +1178,12 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 	elem->vdev = vdev;
 
 	qdf_spin_lock_bh(&fisa_hdl->dp_rx_fst_lock);
+	if (dp_fisa_rx_is_fst_work_queued(fisa_hdl, flow_idx)) {
+		qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
+		qdf_mem_free(elem);
+		return NULL;
+	}
+	sw_ft_added = dp_fisa_rx_add_sw_ft_entry_inline(fisa_hdl, elem);
 	qdf_list_insert_back(&fisa_hdl->fst_update_list, &elem->node);
 	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_fst_lock);
 
@@ -1058,7 +1196,7 @@ dp_fisa_rx_queue_fst_update_work(struct dp_rx_fst *fisa_hdl, uint32_t flow_idx,
 			       &fisa_hdl->fst_update_work);
 	}
 
-	return NULL;
+	return sw_ft_added ? sw_ft_entry : NULL;
 }
 
 /**
@@ -1379,6 +1517,15 @@ dp_rx_fisa_aggr_udp(struct dp_rx_fst *fisa_hdl,
 		get_transport_payload_offset(fisa_hdl, l3_hdr_offset,
 					     l4_hdr_offset);
 
+	/* Fraglist segmentation rebuilds each datagram from the headers
+	 * kept in front of the payload of the frag_list skb.
+	 */
+	if (fisa_hdl->udp_fraglist) {
+		qdf_nbuf_set_network_header(nbuf, l3_hdr_offset);
+		qdf_nbuf_set_transport_header(nbuf, l3_hdr_offset +
+					      l4_hdr_offset);
+	}
+
 	hex_dump_skb_data(nbuf, false);
 	qdf_nbuf_pull_head(nbuf, transport_payload_offset);
 	hex_dump_skb_data(nbuf, false);
@@ -1519,7 +1666,10 @@ dp_rx_fisa_flush_udp_flow(struct dp_vdev *vdev,
 			      qdf_nbuf_get_gso_size(head_skb),
 			      qdf_ntohs(head_skb_udp_hdr->udp_len));
 		qdf_nbuf_set_gso_segs(head_skb, fisa_flow->cur_aggr);
-		qdf_nbuf_set_gso_type_udp_l4(head_skb);
+		if (fisa_flow->soc_hdl->rx_fst->udp_fraglist)
+			qdf_nbuf_set_gso_type_udp_l4_fraglist(head_skb);
+		else
+			qdf_nbuf_set_gso_type_udp_l4(head_skb);
 		qdf_nbuf_set_ip_summed_partial(head_skb);
 	}
 
@@ -434,6 +434,8 @@ static void dp_ini_bus_bandwidth(struct wlan_dp_psoc_cfg *config,
 		cfg_get(psoc, CFG_DP_BUS_LOW_BW_CNT_THRESHOLD);
 	config->enable_latency_crit_clients =
 		cfg_get(psoc, CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS);
+	config->bus_bw_forecast_enable =
+		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_FORECAST_ENABLE);
 }
 
 /**
@@ -26,6 +26,7 @@
 #include "dp_internal.h"
 #include "hif.h"
 #include "wlan_dp_rx_thread.h"
+#include "qdf_debugfs.h"
 
 /* Timeout in milliseconds to wait for CMEM FST HTT response */
 #define DP_RX_FST_CMEM_RESP_TIMEOUT 2000
@@ -82,6 +83,7 @@ void dp_print_fisa_stats(struct dp_soc *soc)
 
 	dp_info("invalid flow index: %u", fst->stats.invalid_flow_index);
 	dp_info("workqueue update deferred: %u", fst->stats.update_deferred);
+	dp_info("inline flow add: %u", fst->stats.inline_flow_add);
 	dp_info("reo_mismatch: cce_match: %u",
 		fst->stats.reo_mismatch.allow_cce_match);
 	dp_info("reo_mismatch: allow_fse_metdata_mismatch: %u",
@@ -90,6 +92,115 @@ void dp_print_fisa_stats(struct dp_soc *soc)
 		fst->stats.reo_mismatch.allow_non_aggr);
 }
 
+#ifdef WLAN_DEBUGFS
+#define DP_FISA_DEBUGFS_DIR "fisa"
+#define DP_FISA_DEBUGFS_FLOW_STATS "flow_stats"
+#define DP_FISA_DEBUGFS_PERM (QDF_FILE_USR_READ | QDF_FILE_GRP_READ | \
+			      QDF_FILE_OTH_READ)
+
+/**
+ * dp_rx_fst_debugfs_flow_stats_show() - Show per flow FISA aggregation stats
+ * @file: debugfs file handle
+ * @arg: FISA context
+ *
+ * The aggregation ratio is the number of msdus delivered per aggregate,
+ * in hundredths.
+ *
+ * Return: QDF_STATUS_SUCCESS
+ */
+static QDF_STATUS
+dp_rx_fst_debugfs_flow_stats_show(qdf_debugfs_file_t file, void *arg)
+{
+	struct dp_rx_fst *fst = arg;
+	struct dp_fisa_rx_sw_ft *sw_ft_entry;
+	uint64_t msdu_count;
+	int i;
+
+	qdf_debugfs_printf(file, "udp fraglist %d esp-in-udp %d flows added %u evicted %u inline %u\n",
+			   fst->udp_fraglist, fst->esp_in_udp,
+			   fst->add_flow_count, fst->del_flow_count,
+			   fst->stats.inline_flow_add);
+	qdf_debugfs_printf(file, "%-6s %-4s %-8s %-6s %-8s %-6s %-4s %-10s %-10s %-8s %-12s\n",
+			   "flow", "l4", "src_ip", "sport", "dst_ip", "dport",
+			   "ring", "msdus", "flushes", "ratio", "bytes");
+
+	sw_ft_entry = (struct dp_fisa_rx_sw_ft *)fst->base;
+	for (i = 0; i < fst->max_entries; i++, sw_ft_entry++) {
+		if (!sw_ft_entry->is_populated)
+			continue;
+
+		/* The head msdu of each aggregate is not in aggr_count */
+		msdu_count = (uint64_t)sw_ft_entry->aggr_count +
+			     sw_ft_entry->flush_count;
+		qdf_debugfs_printf(file, "%-6u %-4s %08x %-6u %08x %-6u %-4u %-10llu %-10u %-8llu %-12llu\n",
+				   sw_ft_entry->flow_id,
+				   sw_ft_entry->is_flow_udp ? "udp" : "tcp",
+				   sw_ft_entry->rx_flow_tuple_info.src_ip_31_0,
+				   sw_ft_entry->rx_flow_tuple_info.src_port,
+				   sw_ft_entry->rx_flow_tuple_info.dest_ip_31_0,
+				   sw_ft_entry->rx_flow_tuple_info.dest_port,
+				   sw_ft_entry->napi_id, msdu_count,
+				   sw_ft_entry->flush_count,
+				   sw_ft_entry->flush_count ?
+				   qdf_do_div(msdu_count * 100,
+					      sw_ft_entry->flush_count) : 0,
+				   sw_ft_entry->bytes_aggregated);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * dp_rx_fst_debugfs_init() - Create the FISA debugfs entries
+ * @fst: FISA context
+ *
+ * Return: None
+ */
+static void dp_rx_fst_debugfs_init(struct dp_rx_fst *fst)
+{
+	fst->debugfs_fops.show = dp_rx_fst_debugfs_flow_stats_show;
+	fst->debugfs_fops.write = NULL;
+	fst->debugfs_fops.priv = fst;
+
+	fst->debugfs_dir = qdf_debugfs_create_dir(DP_FISA_DEBUGFS_DIR, NULL);
+	if (!fst->debugfs_dir) {
+		dp_err("failed to create FISA debugfs dir");
+		return;
+	}
+
+	if (!qdf_debugfs_create_file(DP_FISA_DEBUGFS_FLOW_STATS,
+				     DP_FISA_DEBUGFS_PERM, fst->debugfs_dir,
+				     &fst->debugfs_fops)) {
+		dp_err("failed to create FISA flow stats debugfs entry");
+		qdf_debugfs_remove_dir_recursive(fst->debugfs_dir);
+		fst->debugfs_dir = NULL;
+	}
+}
+
+/**
+ * dp_rx_fst_debugfs_deinit() - Remove the FISA debugfs entries
+ * @fst: FISA context
+ *
+ * Return: None
+ */
+static void dp_rx_fst_debugfs_deinit(struct dp_rx_fst *fst)
+{
+	if (!fst->debugfs_dir)
+		return;
+
+	qdf_debugfs_remove_dir_recursive(fst->debugfs_dir);
+	fst->debugfs_dir = NULL;
+}
+#else
+static inline void dp_rx_fst_debugfs_init(struct dp_rx_fst *fst)
+{
+}
+
+static inline void dp_rx_fst_debugfs_deinit(struct dp_rx_fst *fst)
+{
+}
+#endif
+
 /**
  * dp_rx_flow_send_htt_operation_cmd() - Invalidate FSE cache on FT change
  * @pdev: handle to DP pdev
@@ -371,6 +482,8 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 
 	fst->fse_cache_flush_allow = true;
 	fst->rx_hash_enabled = wlan_cfg_is_rx_hash_enabled(soc->wlan_cfg_ctx);
+	fst->udp_fraglist = wlan_cfg_is_rx_fisa_udp_fraglist_enabled(cfg);
+	fst->esp_in_udp = wlan_cfg_is_rx_fisa_esp_in_udp_enabled(cfg);
 	fst->soc_hdl = soc;
 	soc->rx_fst = fst;
 	soc->fisa_enable = true;
@@ -379,6 +492,8 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 	qdf_atomic_init(&soc->skip_fisa_param.skip_fisa);
 	qdf_atomic_init(&fst->pm_suspended);
 
+	dp_rx_fst_debugfs_init(fst);
+
 	QDF_TRACE(QDF_MODULE_ID_ANY, QDF_TRACE_LEVEL_ERROR,
 		  "Rx FST attach successful, #entries:%d\n",
 		  fst->max_entries);
@@ -501,6 +616,7 @@ void dp_rx_fst_detach(struct dp_soc *soc, struct dp_pdev *pdev)
 
 	dp_fst = soc->rx_fst;
 	if (qdf_likely(dp_fst)) {
+		dp_rx_fst_debugfs_deinit(dp_fst);
 		qdf_timer_sync_cancel(&dp_fst->fse_cache_flush_timer);
 		if (dp_fst->fst_in_cmem)
 			dp_rx_fst_cmem_deinit(dp_fst);
@@ -72,6 +72,272 @@ static inline void dp_rx_tm_walk_skb_list(qdf_nbuf_t nbuf_list)
 { }
 #endif /* DP_RX_TM_DEBUG */
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+/**
+ * dp_rx_tm_steal_thread_init() - Initialize the work stealing state of a
+ * thread
+ * @rx_thread: rx_thread to be initialized
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_steal_thread_init(struct dp_rx_thread *rx_thread)
+{
+	qdf_atomic_init(&rx_thread->enq_pos);
+	qdf_atomic_init(&rx_thread->deq_pos);
+	rx_thread->deq_pending = 0;
+	rx_thread->stolen_pending = false;
+}
+
+/**
+ * dp_rx_tm_steal_init() - Map all flow buckets to the home thread of their
+ * REO ring
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ *
+ * Return: None
+ */
+static void dp_rx_tm_steal_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	int ring, idx;
+
+	for (ring = 0; ring < DP_RX_TM_MAX_REO_RINGS; ring++) {
+		for (idx = 0; idx < DP_RX_TM_STEAL_BUCKETS; idx++) {
+			/* home thread of the ring, see dp_rx_tm_select_thread */
+			rx_tm_hdl->flow_bucket[ring][idx].owner =
+				ring % rx_tm_hdl->num_dp_rx_threads;
+			rx_tm_hdl->flow_bucket[ring][idx].last_pos = 0;
+		}
+	}
+}
+
+/**
+ * dp_rx_tm_steal_account_enq() - Account nbufs queued into a thread
+ * @rx_thread: rx_thread the nbufs are queued to
+ * @num_nbufs: number of nbufs queued
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_steal_account_enq(struct dp_rx_thread *rx_thread,
+					      uint32_t num_nbufs)
+{
+	qdf_atomic_add(num_nbufs, &rx_thread->enq_pos);
+}
+
+/**
+ * dp_rx_tm_steal_account_deq() - Account nbufs handled by a thread
+ * @rx_thread: rx_thread which handled the nbufs
+ * @num_nbufs: number of nbufs delivered or dropped
+ * @reo_ring_num: REO ring the nbufs were received on
+ *
+ * The nbufs may still be held in the GRO context of the thread, so they
+ * are only published to the flow buckets on the next GRO flush.
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_steal_account_deq(struct dp_rx_thread *rx_thread,
+					      uint32_t num_nbufs,
+					      uint8_t reo_ring_num)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+
+	rx_thread->deq_pending += num_nbufs;
+	/* The home thread gets GRO flush indications for its REO ring */
+	if (reo_ring_num % rx_tm_hdl->num_dp_rx_threads != rx_thread->id)
+		rx_thread->stolen_pending = true;
+}
+
+/**
+ * dp_rx_tm_steal_gro_flushed() - Publish the nbufs handled by a thread
+ * after a GRO flush
+ * @rx_thread: rx_thread which flushed its GRO context
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_steal_gro_flushed(struct dp_rx_thread *rx_thread)
+{
+	qdf_atomic_add(rx_thread->deq_pending, &rx_thread->deq_pos);
+	rx_thread->deq_pending = 0;
+	rx_thread->stolen_pending = false;
+}
+
+/**
+ * dp_rx_tm_steal_need_gro_flush() - Check if the thread has to flush GRO
+ * for the flows it took over
+ * @rx_thread: rx_thread to be checked
+ *
+ * Return: true if GRO flush is needed
+ */
+static inline bool
+dp_rx_tm_steal_need_gro_flush(struct dp_rx_thread *rx_thread)
+{
+	return rx_thread->stolen_pending &&
+	       !qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue);
+}
+#else
+static inline void dp_rx_tm_steal_thread_init(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_tm_steal_init(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+}
+
+static inline void dp_rx_tm_steal_account_enq(struct dp_rx_thread *rx_thread,
+					      uint32_t num_nbufs)
+{
+}
+
+static inline void dp_rx_tm_steal_account_deq(struct dp_rx_thread *rx_thread,
+					      uint32_t num_nbufs,
+					      uint8_t reo_ring_num)
+{
+}
+
+static inline void dp_rx_tm_steal_gro_flushed(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline bool
+dp_rx_tm_steal_need_gro_flush(struct dp_rx_thread *rx_thread)
+{
+	return false;
+}
+#endif /* WLAN_DP_RX_THREAD_WORK_STEAL */
+
+#ifdef WLAN_DP_RX_THREAD_COLOCATE
+/*
+ * An RX thread follows the cluster of the NAPI context feeding it. HIF moves
+ * the exec group IRQs of the REO rings between clusters with the throughput
+ * level, and a thread left on the other cluster pays an IPI for every wakeup
+ * and pulls every skb across the cluster caches. Wakeups are sampled in
+ * windows of DP_RX_TM_COLOC_WINDOW, and the thread moves itself to the NAPI
+ * cluster when more than half of a window was cross cluster.
+ */
+#define DP_RX_TM_COLOC_WINDOW 64
+
+/**
+ * dp_rx_tm_coloc_thread_init() - Initialize co-location state of a thread
+ * @rx_thread: rx_thread pointer
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_coloc_thread_init(struct dp_rx_thread *rx_thread)
+{
+	qdf_atomic_set(&rx_thread->enq_cpu, -1);
+	rx_thread->coloc_wakeups = 0;
+	rx_thread->coloc_cross = 0;
+}
+
+/**
+ * dp_rx_tm_coloc_account_enq() - Record the CPU queueing to a thread
+ * @rx_thread: rx_thread the nbufs are queued to
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_coloc_account_enq(struct dp_rx_thread *rx_thread)
+{
+	qdf_atomic_set(&rx_thread->enq_cpu, qdf_get_cpu());
+}
+
+/**
+ * dp_rx_tm_coloc_migrate() - Move a thread to the cluster of a CPU
+ * @rx_thread: rx_thread pointer
+ * @cpu: CPU whose cluster the thread moves to
+ *
+ * The new mask is restricted to the base mask set through
+ * dp_rx_tm_set_cpu_mask(), the thread stays put if they do not intersect.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_coloc_migrate(struct dp_rx_thread *rx_thread, int cpu)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	int cluster = qdf_topology_physical_package_id(cpu);
+	qdf_cpu_mask new_mask;
+	unsigned int cpus;
+
+	qdf_cpumask_clear(&new_mask);
+	qdf_for_each_online_cpu(cpus) {
+		if (qdf_topology_physical_package_id(cpus) == cluster)
+			qdf_cpumask_set_cpu(cpus, &new_mask);
+	}
+
+	if (rx_tm_hdl->base_mask_valid &&
+	    !qdf_cpumask_and(&new_mask, &new_mask, &rx_tm_hdl->base_mask))
+		return;
+
+	if (qdf_cpumask_empty(&new_mask))
+		return;
+
+	qdf_thread_set_cpus_allowed_mask(rx_thread->task, &new_mask);
+	rx_thread->stats.cluster_migrations++;
+	dp_debug("thread %u moved to cluster %d", rx_thread->id, cluster);
+}
+
+/**
+ * dp_rx_tm_coloc_wakeup() - Sample a wakeup of a thread for co-location
+ * @rx_thread: rx_thread pointer, called from the thread itself
+ *
+ * Return: None
+ */
+static void dp_rx_tm_coloc_wakeup(struct dp_rx_thread *rx_thread)
+{
+	int enq_cpu = qdf_atomic_read(&rx_thread->enq_cpu);
+
+	if (enq_cpu < 0)
+		return;
+
+	if (qdf_topology_physical_package_id(enq_cpu) !=
+	    qdf_topology_physical_package_id(qdf_get_cpu())) {
+		rx_thread->stats.cross_cluster_wakeups++;
+		rx_thread->coloc_cross++;
+	}
+
+	if (++rx_thread->coloc_wakeups < DP_RX_TM_COLOC_WINDOW)
+		return;
+
+	if (rx_thread->coloc_cross > DP_RX_TM_COLOC_WINDOW / 2)
+		dp_rx_tm_coloc_migrate(rx_thread, enq_cpu);
+
+	rx_thread->coloc_wakeups = 0;
+	rx_thread->coloc_cross = 0;
+}
+
+/**
+ * dp_rx_tm_coloc_set_base_mask() - Record the base CPU mask of the threads
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @new_mask: CPU mask applied to the threads
+ *
+ * Return: None
+ */
+static inline void
+dp_rx_tm_coloc_set_base_mask(struct dp_rx_tm_handle *rx_tm_hdl,
+			     qdf_cpu_mask *new_mask)
+{
+	qdf_cpumask_copy(&rx_tm_hdl->base_mask, new_mask);
+	rx_tm_hdl->base_mask_valid = true;
+}
+#else
+static inline void dp_rx_tm_coloc_thread_init(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_tm_coloc_account_enq(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void dp_rx_tm_coloc_wakeup(struct dp_rx_thread *rx_thread)
+{
+}
+
+static inline void
+dp_rx_tm_coloc_set_base_mask(struct dp_rx_tm_handle *rx_tm_hdl,
+			     qdf_cpu_mask *new_mask)
+{
+}
+#endif /* WLAN_DP_RX_THREAD_COLOCATE */
+
 #ifdef DP_RX_REFILL_CPU_PERF_AFFINE_MASK
 /**
  * dp_rx_refill_thread_set_affinity - Affine Rx refill threads
@@ -173,6 +439,18 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 		rx_thread->stats.dropped_invalid_os_rx_handles,
 		rx_thread->stats.dropped_others,
 		rx_thread->stats.dropped_enq_fail);
+
+	dp_info("thread:%u - qdepth hist:(0-7:%u 8-31:%u 32-127:%u 128-511:%u 512+:%u) stolen:%u flow_migrations:%u cross_cluster_wakeups:%u cluster_migrations:%u",
+		rx_thread->id,
+		rx_thread->stats.nbufq_depth_hist[DP_RX_TM_QDEPTH_0_7],
+		rx_thread->stats.nbufq_depth_hist[DP_RX_TM_QDEPTH_8_31],
+		rx_thread->stats.nbufq_depth_hist[DP_RX_TM_QDEPTH_32_127],
+		rx_thread->stats.nbufq_depth_hist[DP_RX_TM_QDEPTH_128_511],
+		rx_thread->stats.nbufq_depth_hist[DP_RX_TM_QDEPTH_512_PLUS],
+		rx_thread->stats.nbuf_stolen,
+		rx_thread->stats.flow_migrations,
+		rx_thread->stats.cross_cluster_wakeups,
+		rx_thread->stats.cluster_migrations);
 }
 
 QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
@@ -264,6 +542,32 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
 }
 #endif
 
+/**
+ * dp_rx_tm_update_qdepth_hist() - Update the queue depth histogram
+ * @rx_thread: rx_thread whose nbuf queue depth is recorded
+ * @qlen: number of nbuf_lists in the queue
+ *
+ * Return: None
+ */
+static inline void dp_rx_tm_update_qdepth_hist(struct dp_rx_thread *rx_thread,
+					       uint32_t qlen)
+{
+	enum dp_rx_tm_qdepth_hist idx;
+
+	if (qlen < 8)
+		idx = DP_RX_TM_QDEPTH_0_7;
+	else if (qlen < 32)
+		idx = DP_RX_TM_QDEPTH_8_31;
+	else if (qlen < 128)
+		idx = DP_RX_TM_QDEPTH_32_127;
+	else if (qlen < 512)
+		idx = DP_RX_TM_QDEPTH_128_511;
+	else
+		idx = DP_RX_TM_QDEPTH_512_PLUS;
+
+	rx_thread->stats.nbufq_depth_hist[idx]++;
+}
+
 /**
  * dp_rx_tm_thread_enqueue() - enqueue nbuf list into rx_thread
  * @rx_thread: rx_thread in which the nbuf needs to be queued
@@ -319,6 +623,8 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 	}
 
 	dp_rx_tm_walk_skb_list(nbuf_list);
+	dp_rx_tm_steal_account_enq(rx_thread, num_elements_in_nbuf);
+	dp_rx_tm_coloc_account_enq(rx_thread);
 
 	head_ptr = nbuf_list;
 
@@ -363,6 +669,7 @@ enq_done:
 
 	if (temp_qlen > rx_thread->stats.nbufq_max_len)
 		rx_thread->stats.nbufq_max_len = temp_qlen;
+	dp_rx_tm_update_qdepth_hist(rx_thread, temp_qlen);
 
 	dp_debug("enqueue packet thread %pK wait queue %pK qlen %u",
 		 rx_thread, wait_q_ptr,
@@ -476,6 +783,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	ol_osif_vdev_handle osif_vdev;
 	ol_txrx_soc_handle soc;
 	uint32_t num_list_elements = 0;
+	uint32_t num_nbufs;
+	uint8_t reo_ring_num;
 	uint32_t iterates = 0;
 
 	struct dp_txrx_handle_cmn *txrx_handle_cmn;
@@ -497,6 +806,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	while (nbuf_list) {
 		num_list_elements =
 			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+		num_nbufs = num_list_elements;
+		reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
 		/* count aggregated RX frame into stats */
 		num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
 		rx_thread->stats.nbuf_dequeued += num_list_elements;
@@ -516,6 +827,7 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 			rx_thread->stats.nbuf_sent_to_stack +=
 							num_list_elements;
 		}
+		dp_rx_tm_steal_account_deq(rx_thread, num_nbufs, reo_ring_num);
 		if (qdf_unlikely(dp_rx_thread_should_yield(rx_thread,
 							   iterates))) {
 			rx_thread->stats.rx_nbufq_loop_yield++;
@@ -553,6 +865,7 @@ static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
 						   gro_flush_code);
 	qdf_local_bh_enable();
 	rx_thread->stats.gro_flushes++;
+	dp_rx_tm_steal_gro_flushed(rx_thread);
 }
 
 /**
@@ -570,6 +883,11 @@ dp_rx_should_flush(struct dp_rx_thread *rx_thread)
 	if (qdf_atomic_test_bit(RX_VDEV_DEL_EVENT, &rx_thread->event_flag))
 		gro_flush_code = DP_RX_GRO_NORMAL_FLUSH;
 
+	/* Nobody else flushes GRO for flows taken over from other threads */
+	if (gro_flush_code == DP_RX_GRO_NOT_FLUSH &&
+	    dp_rx_tm_steal_need_gro_flush(rx_thread))
+		gro_flush_code = DP_RX_GRO_NORMAL_FLUSH;
+
 	return gro_flush_code;
 }
 
@@ -684,6 +1002,7 @@ static int dp_rx_thread_loop(void *arg)
 			break;
 		}
 		qdf_atomic_clear_bit(RX_POST_EVENT, &rx_thread->event_flag);
+		dp_rx_tm_coloc_wakeup(rx_thread);
 		dp_rx_thread_sub_loop(rx_thread, &shutdown);
 	}
 
@@ -845,6 +1164,8 @@ static QDF_STATUS dp_rx_tm_thread_init(struct dp_rx_thread *rx_thread,
 	qdf_event_create(&rx_thread->vdev_del_event);
 	qdf_atomic_init(&rx_thread->gro_flush_ind);
 	qdf_init_waitqueue_head(&rx_thread->wait_q);
+	dp_rx_tm_steal_thread_init(rx_thread);
+	dp_rx_tm_coloc_thread_init(rx_thread);
 	qdf_scnprintf(thread_name, sizeof(thread_name), "dp_rx_thread_%u", id);
 	dp_info("%s %u", thread_name, id);
 
@@ -990,10 +1311,12 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 			break;
 	}
 ret:
-	if (!QDF_IS_STATUS_SUCCESS(qdf_status))
+	if (!QDF_IS_STATUS_SUCCESS(qdf_status)) {
 		dp_rx_tm_deinit(rx_tm_hdl);
-	else
+	} else {
+		dp_rx_tm_steal_init(rx_tm_hdl);
 		rx_tm_hdl->state = DP_RX_THREADS_RUNNING;
+	}
 
 	return qdf_status;
 }
@@ -1145,6 +1468,9 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 		num_list_elements =
 			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list_head);
 		rx_thread->stats.rx_flushed += num_list_elements;
+		/* published on the GRO flush done for the vdev delete */
+		dp_rx_tm_steal_account_deq(rx_thread, num_list_elements,
+					   QDF_NBUF_CB_RX_CTX_ID(nbuf_list_head));
 		qdf_nbuf_list_free(nbuf_list_head);
 		nbuf_list_head = nbuf_list_next;
 	}
@@ -1387,6 +1713,130 @@ static uint8_t dp_rx_tm_select_thread(struct dp_rx_tm_handle *rx_tm_hdl,
 	return selected_rx_thread;
 }
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+/**
+ * dp_rx_tm_steal_select_thread() - Select the thread idle flow buckets of a
+ * REO ring are moved to
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @home_id: id of the thread the REO ring is mapped to
+ *
+ * Flows stay on the home thread of their REO ring unless its queue backs
+ * up. In that case the least loaded thread below DP_RX_TM_STEAL_LOW_QLEN
+ * takes them over.
+ *
+ * Return: id of the selected thread
+ */
+static uint8_t dp_rx_tm_steal_select_thread(struct dp_rx_tm_handle *rx_tm_hdl,
+					    uint8_t home_id)
+{
+	uint32_t qlen, min_qlen = DP_RX_TM_STEAL_LOW_QLEN;
+	uint8_t selected_rx_thread = home_id;
+	int i;
+
+	qlen = qdf_nbuf_queue_head_qlen(
+			&rx_tm_hdl->rx_thread[home_id]->nbuf_queue);
+	if (qlen <= DP_RX_TM_STEAL_HIGH_QLEN)
+		return home_id;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (i == home_id || !rx_tm_hdl->rx_thread[i])
+			continue;
+
+		qlen = qdf_nbuf_queue_head_qlen(
+				&rx_tm_hdl->rx_thread[i]->nbuf_queue);
+		if (qlen < min_qlen) {
+			min_qlen = qlen;
+			selected_rx_thread = i;
+		}
+	}
+
+	return selected_rx_thread;
+}
+
+/**
+ * dp_rx_tm_flow_bucket_idle() - Check if a flow bucket can change thread
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @bucket: flow bucket to be checked
+ *
+ * A bucket is idle once its owner has delivered and GRO flushed every nbuf
+ * of it, so moving it cannot reorder the flows it carries.
+ *
+ * Return: true if the bucket is idle
+ */
+static inline bool
+dp_rx_tm_flow_bucket_idle(struct dp_rx_tm_handle *rx_tm_hdl,
+			  struct dp_rx_tm_flow_bucket *bucket)
+{
+	struct dp_rx_thread *owner = rx_tm_hdl->rx_thread[bucket->owner];
+
+	return (int32_t)(qdf_atomic_read(&owner->deq_pos) -
+			 bucket->last_pos) >= 0;
+}
+
+/**
+ * dp_rx_tm_steal_enqueue_pkt() - Spread an nbuf list over the RX threads
+ * by flow bucket
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @home_id: id of the thread the REO ring is mapped to
+ * @nbuf_list: list of packets to be queued
+ *
+ * Flow buckets of a REO ring are only updated from the RX context of that
+ * ring, so no locking is needed for them.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_steal_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
+				       uint8_t home_id, qdf_nbuf_t nbuf_list)
+{
+	qdf_nbuf_t head[DP_MAX_RX_THREADS] = {NULL};
+	qdf_nbuf_t tail[DP_MAX_RX_THREADS] = {NULL};
+	uint64_t bucket_map[DP_MAX_RX_THREADS] = {0};
+	uint8_t reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
+	struct dp_rx_tm_flow_bucket *flow_bucket;
+	struct dp_rx_thread *rx_thread;
+	qdf_nbuf_t nbuf, next;
+	uint32_t enq_pos, idx;
+	uint8_t target_id, owner;
+	int i;
+
+	flow_bucket = rx_tm_hdl->flow_bucket[reo_ring_num];
+	target_id = dp_rx_tm_steal_select_thread(rx_tm_hdl, home_id);
+
+	nbuf = nbuf_list;
+	while (nbuf) {
+		next = qdf_nbuf_next(nbuf);
+		idx = QDF_NBUF_CB_RX_FLOW_ID(nbuf) % DP_RX_TM_STEAL_BUCKETS;
+		owner = flow_bucket[idx].owner;
+		if (owner != target_id &&
+		    !(bucket_map[owner] & (1ULL << idx)) &&
+		    dp_rx_tm_flow_bucket_idle(rx_tm_hdl, &flow_bucket[idx])) {
+			owner = target_id;
+			flow_bucket[idx].owner = owner;
+			rx_tm_hdl->rx_thread[owner]->stats.flow_migrations++;
+		}
+		DP_RX_LIST_APPEND(head[owner], tail[owner], nbuf);
+		bucket_map[owner] |= (1ULL << idx);
+		nbuf = next;
+	}
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (!head[i])
+			continue;
+
+		rx_thread = rx_tm_hdl->rx_thread[i];
+		if (i != home_id)
+			rx_thread->stats.nbuf_stolen +=
+				QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(head[i]);
+		dp_rx_tm_thread_enqueue(rx_thread, head[i]);
+
+		enq_pos = qdf_atomic_read(&rx_thread->enq_pos);
+		for (idx = 0; idx < DP_RX_TM_STEAL_BUCKETS; idx++) {
+			if (bucket_map[i] & (1ULL << idx))
+				flow_bucket[idx].last_pos = enq_pos;
+		}
+	}
+}
+
 QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 				qdf_nbuf_t nbuf_list)
 {
@@ -1395,10 +1845,31 @@ QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 	selected_thread_id =
 		dp_rx_tm_select_thread(rx_tm_hdl,
 				       QDF_NBUF_CB_RX_CTX_ID(nbuf_list));
+	if (rx_tm_hdl->num_dp_rx_threads > 1 &&
+	    QDF_NBUF_CB_RX_CTX_ID(nbuf_list) < DP_RX_TM_MAX_REO_RINGS) {
+		dp_rx_tm_steal_enqueue_pkt(rx_tm_hdl, selected_thread_id,
+					   nbuf_list);
+		return QDF_STATUS_SUCCESS;
+	}
+
 	dp_rx_tm_thread_enqueue(rx_tm_hdl->rx_thread[selected_thread_id],
 				nbuf_list);
 	return QDF_STATUS_SUCCESS;
 }
+#else
+QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
+				qdf_nbuf_t nbuf_list)
+{
+	uint8_t selected_thread_id;
+
+	selected_thread_id =
+		dp_rx_tm_select_thread(rx_tm_hdl,
+				       QDF_NBUF_CB_RX_CTX_ID(nbuf_list));
+	dp_rx_tm_thread_enqueue(rx_tm_hdl->rx_thread[selected_thread_id],
+				nbuf_list);
+	return QDF_STATUS_SUCCESS;
+}
+#endif /* WLAN_DP_RX_THREAD_WORK_STEAL */
 
 QDF_STATUS
 dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
@@ -1418,6 +1889,19 @@ qdf_napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 {
 	uint8_t selected_thread_id;
 
+#ifdef WLAN_DP_RX_THREAD_WORK_STEAL
+	int i;
+
+	/* Flows taken over by another thread use the GRO context of the
+	 * thread delivering them.
+	 */
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		if (rx_tm_hdl->rx_thread[i] &&
+		    rx_tm_hdl->rx_thread[i]->task == qdf_get_current_task())
+			return &rx_tm_hdl->rx_thread[i]->napi;
+	}
+#endif
+
 	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
 
 	return &rx_tm_hdl->rx_thread[selected_thread_id]->napi;
@@ -1428,6 +1912,8 @@ QDF_STATUS dp_rx_tm_set_cpu_mask(struct dp_rx_tm_handle *rx_tm_hdl,
 {
 	int i = 0;
 
+	dp_rx_tm_coloc_set_base_mask(rx_tm_hdl, new_mask);
+
 	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
 		if (!rx_tm_hdl->rx_thread[i])
 			continue;
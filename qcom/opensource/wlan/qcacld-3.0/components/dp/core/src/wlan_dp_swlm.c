@@ -29,6 +29,42 @@
 #include <qdf_status.h>
 #include <qdf_nbuf.h>
 
+/**
+ * dp_swlm_tcl_adapt_thresh() - Adapt the TCL coalescing thresholds to the
+ *				current TX rate
+ * @params: SWLM params
+ * @rid: TCL ring id
+ * @tx_delta: TX bytes on this ring in the last sampling period
+ *
+ * Keeps a moving average of the TX bytes per sampling period and scales
+ * the session time threshold with it, so that the window is widened at
+ * high rate, where many writes are saved, and kept short at low rate,
+ * where the added latency would buy little.
+ *
+ * Returns: none
+ */
+static void dp_swlm_tcl_adapt_thresh(struct dp_swlm_params *params,
+				     uint8_t rid, uint32_t tx_delta)
+{
+	struct dp_swlm_tcl_params *tcl = &params->tcl[rid];
+	uint32_t avg = tcl->avg_tx_bytes;
+	uint32_t min_thresh = DP_SWLM_TCL_TIME_FLUSH_MIN_THRESH;
+
+	avg = avg - (avg >> DP_SWLM_TCL_AVG_WEIGHT_SHIFT) +
+	      (tx_delta >> DP_SWLM_TCL_AVG_WEIGHT_SHIFT);
+	tcl->avg_tx_bytes = avg;
+
+	if (min_thresh > params->time_flush_thresh)
+		min_thresh = params->time_flush_thresh;
+
+	if (avg >= DP_SWLM_TCL_HIGH_TRAFFIC_THRESH)
+		tcl->time_flush_thresh = params->time_flush_thresh;
+	else
+		tcl->time_flush_thresh = min_thresh +
+			(params->time_flush_thresh - min_thresh) * avg /
+			DP_SWLM_TCL_HIGH_TRAFFIC_THRESH;
+}
+
 /**
  * dp_swlm_is_tput_thresh_reached() - Calculate the current tx and rx TPUT
  *				      and check if it passes the pre-set
@@ -51,6 +87,7 @@ static bool dp_swlm_is_tput_thresh_reached(struct dp_soc *soc, uint8_t rid)
 	tx_delta = soc->stats.tx.egress[rid].bytes -
 			params->tcl[rid].prev_tx_bytes;
 	params->tcl[rid].prev_tx_bytes = soc->stats.tx.egress[rid].bytes;
+	dp_swlm_tcl_adapt_thresh(params, rid, tx_delta > 0 ? tx_delta : 0);
 	if (tx_delta > params->tx_traffic_thresh) {
 		params->tcl[rid].sampling_session_tx_bytes = tx_delta;
 		result = true;
@@ -130,14 +167,81 @@ coalescing_fail:
 		return 0;
 	}
 
+	if (!params->tcl[rid].session_start_time)
+		params->tcl[rid].session_start_time = curr_time;
+
 	qdf_timer_mod(&params->tcl[rid].flush_timer, 1);
 
 	return 1;
 }
 
+/**
+ * dp_swlm_can_refill_wr_coalesce() - To check if current RX refill ring
+ *				      register write can be coalesced or not.
+ * @soc: Datapath global soc handle
+ * @refill_data: priv data for refill coalescing
+ *
+ * The refill HP write is deferred only while HW still owns at least half
+ * of the ring, so RXDMA never runs short of buffers because of it. The
+ * session ends once the pending buffers or the session time threshold is
+ * reached, or from the flush timer.
+ *
+ * Returns: 1 if the current refill ring write is to be coalesced
+ *	    0, if the current refill ring write is to be processed.
+ */
+static int
+dp_swlm_can_refill_wr_coalesce(struct dp_soc *soc,
+			       struct dp_swlm_refill_data *refill_data)
+{
+	struct dp_swlm_params *params = &soc->swlm.params;
+	struct dp_swlm_refill_params *refill =
+				&params->refill[refill_data->lmac_id];
+	u64 curr_time = qdf_get_log_timestamp_usecs();
+
+	if (refill_data->num_posted < refill_data->num_entries / 2)
+		goto coalescing_fail;
+
+	if (refill->num_pending + refill_data->count >
+	    DP_SWLM_REFILL_MAX_PENDING)
+		goto coalescing_fail;
+
+	if (!refill->session_start_time)
+		refill->session_start_time = curr_time;
+	else if (curr_time - refill->session_start_time >
+		 params->time_flush_thresh)
+		goto coalescing_fail;
+
+	refill->num_pending += refill_data->count;
+	qdf_timer_mod(&refill->flush_timer, 1);
+
+	return 1;
+
+coalescing_fail:
+	dp_swlm_refill_reset_session_data(soc, refill_data->lmac_id);
+	return 0;
+}
+
+/**
+ * dp_print_swlm_avg_latency() - Print the avg delay added per session
+ * @name: ring name
+ * @id: ring id
+ * @sessions: Num sessions flushed
+ * @latency_us: Total delay added in us
+ *
+ * Returns: none
+ */
+static void dp_print_swlm_avg_latency(const char *name, int id,
+				      uint32_t sessions, uint64_t latency_us)
+{
+	dp_info("%s: %d Coalescing sessions: %u avg added latency(us): %llu",
+		name, id, sessions,
+		sessions ? qdf_do_div(latency_us, sessions) : 0);
+}
+
 QDF_STATUS dp_print_swlm_stats(struct dp_soc *soc)
 {
 	struct dp_swlm *swlm = &soc->swlm;
+	uint64_t saved = 0, curr_time, elapsed_ms;
 	int i;
 
 	for (i = 0; i < soc->num_tcl_data_rings; i++) {
@@ -162,13 +266,50 @@ QDF_STATUS dp_print_swlm_stats(struct dp_soc *soc)
 			swlm->stats.tcl[i].time_thresh_reached);
 		dp_info("Coalesce fail (TPUT sampling fail): %d",
 			swlm->stats.tcl[i].tput_criteria_fail);
+		dp_info("Adapted time thresh(us): %u bytes thresh: %u",
+			swlm->params.tcl[i].time_flush_thresh,
+			swlm->params.tcl[i].bytes_flush_thresh);
+		dp_print_swlm_avg_latency("TCL", i,
+					  swlm->stats.tcl[i].sessions,
+					  swlm->stats.tcl[i].latency_us);
+		saved += swlm->stats.tcl[i].coalesce_success;
 	}
 
+	for (i = 0; i < MAX_PDEV_CNT; i++) {
+		if (!swlm->stats.refill[i].coalesce_success &&
+		    !swlm->stats.refill[i].coalesce_fail)
+			continue;
+
+		dp_info("REFILL: %u Coalescing stats:", i);
+		dp_info("Num coalesce success: %d",
+			swlm->stats.refill[i].coalesce_success);
+		dp_info("Num coalesce fail: %d",
+			swlm->stats.refill[i].coalesce_fail);
+		dp_info("Timer flush success: %d",
+			swlm->stats.refill[i].timer_flush_success);
+		dp_info("Timer flush fail: %d",
+			swlm->stats.refill[i].timer_flush_fail);
+		dp_print_swlm_avg_latency("REFILL", i,
+					  swlm->stats.refill[i].sessions,
+					  swlm->stats.refill[i].latency_us);
+		saved += swlm->stats.refill[i].coalesce_success;
+	}
+
+	curr_time = qdf_get_log_timestamp_usecs();
+	elapsed_ms = qdf_do_div(curr_time - swlm->stats.last_print_ts, 1000);
+	if (elapsed_ms && saved >= swlm->stats.last_saved)
+		dp_info("HP writes saved: %llu (%llu/s since last print)",
+			saved, qdf_do_div((saved - swlm->stats.last_saved) *
+					  1000, elapsed_ms));
+	swlm->stats.last_print_ts = curr_time;
+	swlm->stats.last_saved = saved;
+
 	return QDF_STATUS_SUCCESS;
 }
 
 static struct dp_swlm_ops dp_latency_mgr_ops = {
 	.tcl_wr_coalesce_check = dp_swlm_can_tcl_wr_coalesce,
+	.refill_wr_coalesce_check = dp_swlm_can_refill_wr_coalesce,
 };
 
 /**
@@ -205,6 +346,89 @@ fail:
 	DP_STATS_INC(swlm, tcl[tcl->ring_id].timer_flush_fail, 1);
 }
 
+/**
+ * dp_swlm_refill_flush_timer() - Timer handler for refill ring register
+ *				  write coalescing
+ * @arg: private data of the timer
+ *
+ * Returns: none
+ */
+static void dp_swlm_refill_flush_timer(void *arg)
+{
+	struct dp_swlm_refill_params *refill = arg;
+	struct dp_soc *soc = refill->soc;
+	struct dp_swlm *swlm = &soc->swlm;
+	hal_ring_handle_t hal_ring_hdl =
+			soc->rx_refill_buf_ring[refill->lmac_id].hal_srng;
+
+	if (!hal_ring_hdl ||
+	    hal_srng_try_access_start(soc->hal_soc, hal_ring_hdl) < 0)
+		goto fail;
+
+	/*
+	 * Leave the session open if the link is not up, the next replenish
+	 * writes the HP once the session time threshold is crossed.
+	 */
+	if (hif_rtpm_get(HIF_RTPM_GET_ASYNC, HIF_RTPM_ID_DP)) {
+		hal_srng_access_end_reap(soc->hal_soc, hal_ring_hdl);
+		goto fail;
+	}
+
+	dp_swlm_refill_reset_session_data(soc, refill->lmac_id);
+	DP_STATS_INC(swlm, refill[refill->lmac_id].timer_flush_success, 1);
+	hal_srng_access_end(soc->hal_soc, hal_ring_hdl);
+	hif_rtpm_put(HIF_RTPM_PUT_ASYNC, HIF_RTPM_ID_DP);
+
+	return;
+
+fail:
+	DP_STATS_INC(swlm, refill[refill->lmac_id].timer_flush_fail, 1);
+}
+
+/**
+ * dp_soc_swlm_refill_attach() - attach the RX refill ring resources for
+ *				 the software latency manager.
+ * @soc: Datapath global soc handle
+ *
+ * Returns: QDF_STATUS
+ */
+static inline QDF_STATUS dp_soc_swlm_refill_attach(struct dp_soc *soc)
+{
+	struct dp_swlm *swlm = &soc->swlm;
+	int i;
+
+	for (i = 0; i < MAX_PDEV_CNT; i++) {
+		swlm->params.refill[i].soc = soc;
+		swlm->params.refill[i].lmac_id = i;
+		qdf_timer_init(soc->osdev,
+			       &swlm->params.refill[i].flush_timer,
+			       dp_swlm_refill_flush_timer,
+			       (void *)&swlm->params.refill[i],
+			       QDF_TIMER_TYPE_WAKE_APPS);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * dp_soc_swlm_refill_detach() - detach the RX refill ring resources for
+ *				 the software latency manager.
+ * @swlm: SWLM data pointer
+ *
+ * Returns: QDF_STATUS
+ */
+static inline QDF_STATUS dp_soc_swlm_refill_detach(struct dp_swlm *swlm)
+{
+	int i;
+
+	for (i = 0; i < MAX_PDEV_CNT; i++) {
+		qdf_timer_stop(&swlm->params.refill[i].flush_timer);
+		qdf_timer_free(&swlm->params.refill[i].flush_timer);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
 /**
  * dp_soc_swlm_tcl_attach() - attach the TCL resources for the software
  *			      latency manager.
@@ -228,6 +452,8 @@ static inline QDF_STATUS dp_soc_swlm_tcl_attach(struct dp_soc *soc)
 		swlm->params.tcl[i].soc = soc;
 		swlm->params.tcl[i].ring_id = i;
 		swlm->params.tcl[i].bytes_flush_thresh = 0;
+		swlm->params.tcl[i].time_flush_thresh =
+					DP_SWLM_TCL_TIME_FLUSH_MIN_THRESH;
 		qdf_timer_init(soc->osdev,
 			       &swlm->params.tcl[i].flush_timer,
 			       dp_swlm_tcl_flush_timer,
@@ -260,6 +486,7 @@ QDF_STATUS dp_soc_swlm_attach(struct dp_soc *soc)
 	struct wlan_cfg_dp_soc_ctxt *cfg = soc->wlan_cfg_ctx;
 	struct dp_swlm *swlm = &soc->swlm;
 	QDF_STATUS ret;
+	int i;
 
 	/* Check if it is enabled in the INI */
 	if (!wlan_cfg_is_swlm_enabled(cfg)) {
@@ -275,11 +502,18 @@ QDF_STATUS dp_soc_swlm_attach(struct dp_soc *soc)
 	if (QDF_IS_STATUS_ERROR(ret))
 		goto swlm_tcl_setup_fail;
 
+	ret = dp_soc_swlm_refill_attach(soc);
+	if (QDF_IS_STATUS_ERROR(ret))
+		goto swlm_refill_setup_fail;
+
 	swlm->is_init = true;
 	swlm->is_enabled = true;
 
 	return QDF_STATUS_SUCCESS;
 
+swlm_refill_setup_fail:
+	for (i = 0; i < soc->num_tcl_data_rings; i++)
+		dp_soc_swlm_tcl_detach(swlm, i);
 swlm_tcl_setup_fail:
 	swlm->is_enabled = false;
 	return ret;
@@ -302,6 +536,10 @@ QDF_STATUS dp_soc_swlm_detach(struct dp_soc *soc)
 			return ret;
 	}
 
+	ret = dp_soc_swlm_refill_detach(swlm);
+	if (QDF_IS_STATUS_ERROR(ret))
+		return ret;
+
 	swlm->ops = NULL;
 
 	return QDF_STATUS_SUCCESS;
@@ -539,6 +539,29 @@
 		false, \
 		"Control to enable latency critical clients")
 
+/*
+ * <ini>
+ * gBusBandwidthForecastEnable - Enable bus bandwidth forecasting
+ * @Default: false
+ *
+ * This ini enables voting the bus bandwidth, runtime PM and TCP RX/TX
+ * levels from a throughput forecast built from the rate change between
+ * the last two bus bandwidth intervals, instead of using the throughput
+ * measured in the last interval only. Throughput hints given by user
+ * space are taken into account as well.
+ *
+ * Supported Feature: Bus bandwidth
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BANDWIDTH_FORECAST_ENABLE \
+		CFG_INI_BOOL( \
+		"gBusBandwidthForecastEnable", \
+		false, \
+		"Control to enable bus bandwidth forecasting")
+
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
 
 #ifdef QCA_SUPPORT_TXRX_DRIVER_TCP_DEL_ACK
@@ -1257,7 +1280,8 @@
 	CFG(CFG_DP_TCP_DELACK_TIMER_COUNT) \
 	CFG(CFG_DP_TCP_TX_HIGH_TPUT_THRESHOLD) \
 	CFG(CFG_DP_BUS_LOW_BW_CNT_THRESHOLD) \
-	CFG(CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS)
+	CFG(CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS) \
+	CFG(CFG_DP_BUS_BANDWIDTH_FORECAST_ENABLE)
 
 #else
 #define CFG_DP_BUS_BANDWIDTH
@@ -649,6 +649,19 @@ ucfg_dp_set_high_bus_bw_request(struct wlan_objmgr_psoc *psoc,
 				uint8_t vdev_id,
 				bool high_bus_bw);
 
+/**
+ * ucfg_dp_bus_bw_set_tput_hint() - Set the throughput level expected by an
+ *  application
+ * @psoc: psoc handle
+ * @tput_level: expected throughput level
+ * @duration_ms: duration of the hint in ms
+ *
+ * Return: None
+ */
+void ucfg_dp_bus_bw_set_tput_hint(struct wlan_objmgr_psoc *psoc,
+				  enum tput_level tput_level,
+				  uint32_t duration_ms);
+
 /**
  * ucfg_dp_bus_bw_compute_timer_start() - start the bandwidth timer
  * @psoc: psoc handle
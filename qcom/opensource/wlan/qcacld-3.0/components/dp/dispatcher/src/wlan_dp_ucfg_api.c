@@ -1472,6 +1472,13 @@ ucfg_dp_set_high_bus_bw_request(struct wlan_objmgr_psoc *psoc,
 	dp_set_high_bus_bw_request(psoc, vdev_id, high_bus_bw);
 }
 
+void ucfg_dp_bus_bw_set_tput_hint(struct wlan_objmgr_psoc *psoc,
+				  enum tput_level tput_level,
+				  uint32_t duration_ms)
+{
+	dp_bus_bw_set_tput_hint(psoc, tput_level, duration_ms);
+}
+
 void ucfg_wlan_dp_display_tx_rx_histogram(struct wlan_objmgr_psoc *psoc)
 {
 	wlan_dp_display_tx_rx_histogram(psoc);
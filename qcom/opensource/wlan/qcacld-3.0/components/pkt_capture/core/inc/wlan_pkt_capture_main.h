@@ -230,6 +230,55 @@ void pkt_capture_mon(struct pkt_capture_cb_context *cb_ctx, qdf_nbuf_t msdu,
 QDF_STATUS pkt_capture_set_filter(struct pkt_capture_frame_filter frame_filter,
 				  struct wlan_objmgr_vdev *vdev);
 
+/**
+ * pkt_capture_set_match_filter() - Set data frame match filter and snap length
+ * @vdev: pointer to vdev
+ * @filter: header match filter, applied before frames are copied
+ * @snaplen: bytes of each data frame captured, 0 for full frame
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS
+pkt_capture_set_match_filter(struct wlan_objmgr_vdev *vdev,
+			     struct pkt_capture_match_filter *filter,
+			     uint32_t snaplen);
+
+/**
+ * pkt_capture_get_filter_stats() - Get data frame match filter stats
+ * @vdev: pointer to vdev
+ * @stats: filled with the match filter stats
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS
+pkt_capture_get_filter_stats(struct wlan_objmgr_vdev *vdev,
+			     struct pkt_capture_filter_stats *stats);
+
+/**
+ * pkt_capture_match_frame() - Run the match filter on a data frame
+ * @vdev_priv: packet capture vdev private object
+ * @data: start of the 802.3 header
+ * @len: bytes available from @data
+ *
+ * Return: true if the frame should be captured
+ */
+bool pkt_capture_match_frame(struct pkt_capture_vdev_priv *vdev_priv,
+			     uint8_t *data, uint32_t len);
+
+/**
+ * pkt_capture_copy_frame() - Make a private copy of a frame for capture
+ * @vdev_priv: packet capture vdev private object
+ * @nbuf: frame to be captured
+ * @hdr_len: bytes between nbuf data and the 802.3 header
+ *
+ * If a snap length is configured only the headroom and the first
+ * @hdr_len + snaplen bytes are copied.
+ *
+ * Return: private copy of @nbuf, NULL on failure
+ */
+qdf_nbuf_t pkt_capture_copy_frame(struct pkt_capture_vdev_priv *vdev_priv,
+				  qdf_nbuf_t nbuf, uint32_t hdr_len);
+
 /**
  * pkt_capture_is_tx_mgmt_enable - Check if tx mgmt frames enabled
  * @pdev: pointer to pdev
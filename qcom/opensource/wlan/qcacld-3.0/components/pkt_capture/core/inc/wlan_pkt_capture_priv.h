@@ -36,10 +36,12 @@
  * struct pkt_capture_cfg - struct to store config values
  * @pkt_capture_mode: packet capture mode
  * @pkt_capture_config: config for trigger, qos and beacon frames
+ * @snaplen: bytes of each data frame payload captured, 0 for full frame
  */
 struct pkt_capture_cfg {
 	enum pkt_capture_mode pkt_capture_mode;
 	enum pkt_capture_config pkt_capture_config;
+	uint32_t snaplen;
 };
 
 /**
@@ -58,6 +60,8 @@ struct pkt_capture_cb_context {
  * @mon_ctx: pointer to packet capture mon context
  * @cb_ctx: pointer to packet capture mon callback context
  * @frame_filter: config filter set by vendor command
+ * @match_filter: header match filter applied before data frames are copied
+ * @filter_stats: data frame match filter / snap length stats
  * @cfg_params: packet capture config params
  * @rx_avg_rssi: avg rssi of rx data packets
  * @ppdu_stats_q: list used for storing smu related ppdu stats
@@ -71,6 +75,8 @@ struct pkt_capture_vdev_priv {
 	struct pkt_capture_mon_context *mon_ctx;
 	struct pkt_capture_cb_context *cb_ctx;
 	struct pkt_capture_frame_filter frame_filter;
+	struct pkt_capture_match_filter match_filter;
+	struct pkt_capture_filter_stats filter_stats;
 	struct pkt_capture_cfg cfg_params;
 	int32_t rx_avg_rssi;
 	qdf_list_t ppdu_stats_q;
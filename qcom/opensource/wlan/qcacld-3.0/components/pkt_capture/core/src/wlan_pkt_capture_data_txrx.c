@@ -612,11 +612,30 @@ void pkt_capture_msdu_process_pkts(
 {
 	qdf_nbuf_t loop_msdu, pktcapture_msdu, offload_msdu = NULL;
 	qdf_nbuf_t msdu, prev = NULL;
+	struct pkt_capture_vdev_priv *vdev_priv;
+	struct wlan_objmgr_vdev *vdev;
+
+	vdev = pkt_capture_get_vdev();
+	if (QDF_IS_STATUS_ERROR(pkt_capture_vdev_get_ref(vdev)))
+		goto free_offload;
+
+	vdev_priv = pkt_capture_vdev_get_priv(vdev);
+	if (!vdev_priv) {
+		pkt_capture_vdev_put_ref(vdev);
+		goto free_offload;
+	}
 
 	pktcapture_msdu = NULL;
 	loop_msdu = head_msdu;
 	while (loop_msdu) {
-		msdu = qdf_nbuf_copy(loop_msdu);
+		/* msdu data points to the 802.3 header, TLVs are in headroom */
+		if (pkt_capture_match_frame(vdev_priv,
+					    qdf_nbuf_data(loop_msdu),
+					    qdf_nbuf_len(loop_msdu)))
+			msdu = pkt_capture_copy_frame(vdev_priv,
+						      loop_msdu, 0);
+		else
+			msdu = NULL;
 
 		if (msdu) {
 			qdf_nbuf_set_next(msdu, NULL);
@@ -640,6 +659,8 @@ void pkt_capture_msdu_process_pkts(
 		}
 	}
 
+	pkt_capture_vdev_put_ref(vdev);
+
 	if (!pktcapture_msdu)
 		return;
 
@@ -648,6 +669,12 @@ void pkt_capture_msdu_process_pkts(
 			TXRX_PROCESS_TYPE_DATA_RX, 0, 0,
 			TXRX_PKTCAPTURE_PKT_FORMAT_8023,
 			bssid, psoc, 0);
+	return;
+
+free_offload:
+	/* Free offload msdus as they are delivered only to pkt capture */
+	if (status == RX_OFFLOAD_PKT)
+		qdf_nbuf_list_free(head_msdu);
 }
 #endif
 
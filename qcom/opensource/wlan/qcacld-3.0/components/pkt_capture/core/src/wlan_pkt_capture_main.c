@@ -162,12 +162,187 @@ pkt_capture_get_pktcap_mode_v2()
 
 #define RX_OFFLOAD_PKT 1
 #define PPDU_STATS_Q_MAX_SIZE 500
+#define PKT_CAPTURE_SNAPLEN_MIN 128
+#define PKT_CAPTURE_ETH_HDR_LEN 14
+#define PKT_CAPTURE_VLAN_HDR_LEN 4
+#define PKT_CAPTURE_IPV4_MIN_HDR_LEN 20
+
+bool pkt_capture_match_frame(struct pkt_capture_vdev_priv *vdev_priv,
+			     uint8_t *data, uint32_t len)
+{
+	struct pkt_capture_match_filter *filter = &vdev_priv->match_filter;
+	uint32_t l3_off = PKT_CAPTURE_ETH_HDR_LEN;
+	uint32_t l4_off, saddr, daddr;
+	uint16_t ether_type, sport, dport;
+	uint8_t ip_proto;
+
+	if (!filter->enable)
+		return true;
+
+	if (len < PKT_CAPTURE_ETH_HDR_LEN)
+		goto filtered;
+
+	ether_type = qdf_ntohs(*(uint16_t *)(data +
+					     QDF_NBUF_TRAC_ETH_TYPE_OFFSET));
+	if (ether_type == QDF_ETH_TYPE_8021Q) {
+		if (len < PKT_CAPTURE_ETH_HDR_LEN + PKT_CAPTURE_VLAN_HDR_LEN)
+			goto filtered;
+		ether_type = qdf_ntohs(*(uint16_t *)(data +
+					QDF_NBUF_TRAC_VLAN_ETH_TYPE_OFFSET));
+		l3_off += PKT_CAPTURE_VLAN_HDR_LEN;
+	}
+
+	if (filter->ether_type && filter->ether_type != ether_type)
+		goto filtered;
+
+	if (!filter->ip_proto && !filter->port && !filter->ipv4_mask)
+		goto matched;
+
+	if (ether_type == QDF_NBUF_TRAC_IPV4_ETH_TYPE) {
+		if (len < l3_off + PKT_CAPTURE_IPV4_MIN_HDR_LEN)
+			goto filtered;
+		ip_proto = data[l3_off + QDF_NBUF_TRAC_IPV4_PROTO_TYPE_OFFSET -
+				QDF_NBUF_TRAC_IPV4_OFFSET];
+		l4_off = l3_off + ((data[l3_off] &
+				    QDF_NBUF_TRAC_IPV4_HEADER_MASK) << 2);
+
+		if (filter->ipv4_mask) {
+			qdf_mem_copy(&saddr, data + l3_off +
+				     QDF_NBUF_TRAC_IPV4_SRC_ADDR_OFFSET -
+				     QDF_NBUF_TRAC_IPV4_OFFSET, sizeof(saddr));
+			qdf_mem_copy(&daddr, data + l3_off +
+				     QDF_NBUF_TRAC_IPV4_DEST_ADDR_OFFSET -
+				     QDF_NBUF_TRAC_IPV4_OFFSET, sizeof(daddr));
+			if ((saddr & filter->ipv4_mask) !=
+			    (filter->ipv4_addr & filter->ipv4_mask) &&
+			    (daddr & filter->ipv4_mask) !=
+			    (filter->ipv4_addr & filter->ipv4_mask))
+				goto filtered;
+		}
+	} else if (ether_type == QDF_NBUF_TRAC_IPV6_ETH_TYPE &&
+		   !filter->ipv4_mask) {
+		if (len < l3_off + QDF_NBUF_TRAC_IPV6_HEADER_SIZE)
+			goto filtered;
+		ip_proto = data[l3_off + QDF_NBUF_TRAC_IPV6_PROTO_TYPE_OFFSET -
+				QDF_NBUF_TRAC_IPV6_OFFSET];
+		l4_off = l3_off + QDF_NBUF_TRAC_IPV6_HEADER_SIZE;
+	} else {
+		goto filtered;
+	}
+
+	if (filter->ip_proto && filter->ip_proto != ip_proto)
+		goto filtered;
+
+	if (filter->port) {
+		if ((ip_proto != QDF_NBUF_TRAC_TCP_TYPE &&
+		     ip_proto != QDF_NBUF_TRAC_UDP_TYPE) ||
+		    len < l4_off + 2 * sizeof(uint16_t))
+			goto filtered;
+		sport = qdf_ntohs(*(uint16_t *)(data + l4_off));
+		dport = qdf_ntohs(*(uint16_t *)(data + l4_off +
+						sizeof(uint16_t)));
+		if (filter->port != sport && filter->port != dport)
+			goto filtered;
+	}
+
+matched:
+	vdev_priv->filter_stats.matched++;
+	return true;
+
+filtered:
+	vdev_priv->filter_stats.filtered++;
+	return false;
+}
+
+qdf_nbuf_t pkt_capture_copy_frame(struct pkt_capture_vdev_priv *vdev_priv,
+				  qdf_nbuf_t nbuf, uint32_t hdr_len)
+{
+	uint32_t snaplen = vdev_priv->cfg_params.snaplen;
+	qdf_nbuf_t msdu;
+
+	if (!snaplen || qdf_nbuf_is_nonlinear(nbuf) ||
+	    qdf_nbuf_len(nbuf) <= hdr_len + snaplen)
+		return qdf_nbuf_copy(nbuf);
+
+	/*
+	 * Clone and trim the clone to the snap length so that the unshare
+	 * below copies only the headroom and the snapped bytes instead of
+	 * the whole frame. The capture path rewrites the L2 header and
+	 * pushes the radiotap header in place, so a private copy is needed.
+	 */
+	msdu = qdf_nbuf_clone(nbuf);
+	if (!msdu)
+		return NULL;
+
+	qdf_nbuf_trim_tail(msdu, qdf_nbuf_len(msdu) - hdr_len - snaplen);
+	msdu = qdf_nbuf_unshare(msdu);
+	if (msdu)
+		vdev_priv->filter_stats.snapped++;
+
+	return msdu;
+}
+
+QDF_STATUS
+pkt_capture_set_match_filter(struct wlan_objmgr_vdev *vdev,
+			     struct pkt_capture_match_filter *filter,
+			     uint32_t snaplen)
+{
+	struct pkt_capture_vdev_priv *vdev_priv;
+
+	if (!vdev) {
+		pkt_capture_err("vdev is NULL");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	vdev_priv = pkt_capture_vdev_get_priv(vdev);
+	if (!vdev_priv) {
+		pkt_capture_err("vdev_priv is NULL");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	if (snaplen && snaplen < PKT_CAPTURE_SNAPLEN_MIN)
+		snaplen = PKT_CAPTURE_SNAPLEN_MIN;
+
+	vdev_priv->match_filter = *filter;
+	vdev_priv->cfg_params.snaplen = snaplen;
+	qdf_mem_zero(&vdev_priv->filter_stats,
+		     sizeof(vdev_priv->filter_stats));
+
+	pkt_capture_debug("match filter %d ether_type 0x%x proto %u port %u snaplen %u",
+			  filter->enable, filter->ether_type, filter->ip_proto,
+			  filter->port, snaplen);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+QDF_STATUS
+pkt_capture_get_filter_stats(struct wlan_objmgr_vdev *vdev,
+			     struct pkt_capture_filter_stats *stats)
+{
+	struct pkt_capture_vdev_priv *vdev_priv;
+
+	if (!vdev) {
+		pkt_capture_err("vdev is NULL");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	vdev_priv = pkt_capture_vdev_get_priv(vdev);
+	if (!vdev_priv) {
+		pkt_capture_err("vdev_priv is NULL");
+		return QDF_STATUS_E_FAILURE;
+	}
+
+	*stats = vdev_priv->filter_stats;
+
+	return QDF_STATUS_SUCCESS;
+}
 
 static void
 pkt_capture_process_rx_data_no_peer(void *soc, uint16_t vdev_id, uint8_t *bssid,
-				    uint32_t status, qdf_nbuf_t nbuf)
+				    uint32_t status, qdf_nbuf_t nbuf,
+				    struct pkt_capture_vdev_priv *vdev_priv)
 {
-	uint32_t pkt_len, l3_hdr_pad, nbuf_len;
+	uint32_t pkt_len, l3_hdr_pad, nbuf_len, hdr_len;
 	struct dp_soc *psoc = soc;
 	qdf_nbuf_t msdu;
 	uint8_t *rx_tlv_hdr;
@@ -176,9 +351,17 @@ pkt_capture_process_rx_data_no_peer(void *soc, uint16_t vdev_id, uint8_t *bssid,
 	rx_tlv_hdr = qdf_nbuf_data(nbuf);
 	l3_hdr_pad = hal_rx_msdu_end_l3_hdr_padding_get(psoc->hal_soc,
 							rx_tlv_hdr);
-	pkt_len = nbuf_len + l3_hdr_pad + psoc->rx_pkt_tlv_size;
+	hdr_len = l3_hdr_pad + psoc->rx_pkt_tlv_size;
+	pkt_len = nbuf_len + hdr_len;
 	qdf_nbuf_set_pktlen(nbuf, pkt_len);
 
+	if (!pkt_capture_match_frame(vdev_priv, rx_tlv_hdr + hdr_len,
+				     nbuf_len)) {
+		if (status == RX_OFFLOAD_PKT)
+			qdf_nbuf_free(nbuf);
+		return;
+	}
+
 	/*
 	 * Offload rx packets are delivered only to pkt capture component, so
 	 * can modify the received nbuf, in other cases create a private copy
@@ -188,7 +371,7 @@ pkt_capture_process_rx_data_no_peer(void *soc, uint16_t vdev_id, uint8_t *bssid,
 	if (status == RX_OFFLOAD_PKT)
 		msdu = nbuf;
 	else
-		msdu = qdf_nbuf_copy(nbuf);
+		msdu = pkt_capture_copy_frame(vdev_priv, nbuf, hdr_len);
 
 	if (!msdu)
 		return;
@@ -264,7 +447,8 @@ pkt_capture_process_ppdu_stats(void *log_data)
 
 static void
 pkt_capture_process_tx_data(void *soc, void *log_data, u_int16_t vdev_id,
-			    uint32_t status)
+			    uint32_t status,
+			    struct pkt_capture_vdev_priv *vdev_priv)
 {
 	struct dp_soc *psoc = soc;
 	uint8_t tid = 0;
@@ -277,8 +461,9 @@ pkt_capture_process_tx_data(void *soc, void *log_data, u_int16_t vdev_id,
 			sizeof(struct pkt_capture_tx_hdr_elem_t);
 
 	struct dp_tx_desc_s *desc = log_data;
+	uint32_t snaplen = vdev_priv->cfg_params.snaplen;
 	qdf_nbuf_t netbuf;
-	int nbuf_len;
+	int nbuf_len, copy_len;
 
 	hal_tx_comp_get_status(&desc->comp, &tx_comp_status,
 			       psoc->hal_soc);
@@ -316,6 +501,12 @@ pkt_capture_process_tx_data(void *soc, void *log_data, u_int16_t vdev_id,
 		nbuf_len = qdf_nbuf_len(desc->nbuf);
 	}
 
+	/* Only the snapped bytes are allocated and copied */
+	if (snaplen && nbuf_len > snaplen) {
+		nbuf_len = snaplen;
+		vdev_priv->filter_stats.snapped++;
+	}
+
 	netbuf = qdf_nbuf_alloc(NULL,
 				roundup(nbuf_len + RESERVE_BYTES, 4),
 				RESERVE_BYTES, 4, false);
@@ -348,13 +539,15 @@ pkt_capture_process_tx_data(void *soc, void *log_data, u_int16_t vdev_id,
 		ip_len = tso_seg->seg.tso_flags.ip_len;
 		ip_len = qdf_cpu_to_be16(ip_len);
 
-		for (frag_cnt = 0; frag_cnt <= num_frags; frag_cnt++) {
+		for (frag_cnt = 0; frag_cnt <= num_frags &&
+		     frag_len < nbuf_len; frag_cnt++) {
+			copy_len = qdf_min_t(int, nbuf_len - frag_len,
+				tso_seg->seg.tso_frags[frag_cnt].length);
 			qdf_mem_copy(
 			qdf_nbuf_data(netbuf) + frag_len,
 			tso_seg->seg.tso_frags[frag_cnt].vaddr,
-			tso_seg->seg.tso_frags[frag_cnt].length);
-			frag_len +=
-				tso_seg->seg.tso_frags[frag_cnt].length;
+			copy_len);
+			frag_len += copy_len;
 		}
 
 		qdf_mem_copy((qdf_nbuf_data(netbuf) +
@@ -513,14 +706,21 @@ void pkt_capture_callback(void *soc, enum WDI_EVENT event, void *log_data,
 			return;
 		}
 
+		if (!pkt_capture_match_frame(vdev_priv,
+					     qdf_nbuf_data(desc->nbuf),
+					     qdf_nbuf_len(desc->nbuf)))
+			break;
+
 		if (frame_filter->data_tx_frame_filter &
 		    PKT_CAPTURE_DATA_FRAME_TYPE_ALL) {
 			pkt_capture_process_tx_data(soc, log_data,
-						    vdev_id, status);
+						    vdev_id, status,
+						    vdev_priv);
 		} else if (pkt_capture_is_frame_filter_set(
 			   desc->nbuf, frame_filter, IEEE80211_FC1_DIR_TODS)) {
 			pkt_capture_process_tx_data(soc, log_data,
-						    vdev_id, status);
+						    vdev_id, status,
+						    vdev_priv);
 		}
 		break;
 	}
@@ -576,11 +776,13 @@ void pkt_capture_callback(void *soc, enum WDI_EVENT event, void *log_data,
 		if (frame_filter->data_rx_frame_filter &
 		    PKT_CAPTURE_DATA_FRAME_TYPE_ALL) {
 			pkt_capture_process_rx_data_no_peer(soc, vdev_id, bssid,
-							    status, nbuf);
+							    status, nbuf,
+							    vdev_priv);
 		} else if (pkt_capture_is_frame_filter_set(
 			   nbuf, frame_filter, IEEE80211_FC1_DIR_FROMDS)) {
 			pkt_capture_process_rx_data_no_peer(soc, vdev_id, bssid,
-							    status, nbuf);
+							    status, nbuf,
+							    vdev_priv);
 		} else {
 			if (status == RX_OFFLOAD_PKT)
 				qdf_nbuf_free(nbuf);
@@ -1041,6 +1243,9 @@ pkt_capture_cfg_init(struct pkt_psoc_priv *psoc_priv)
 
 	cfg_param->pkt_capture_mode = cfg_get(psoc_priv->psoc,
 					      CFG_PKT_CAPTURE_MODE);
+	cfg_param->snaplen = cfg_get(psoc_priv->psoc, CFG_PKT_CAPTURE_SNAPLEN);
+	if (cfg_param->snaplen && cfg_param->snaplen < PKT_CAPTURE_SNAPLEN_MIN)
+		cfg_param->snaplen = PKT_CAPTURE_SNAPLEN_MIN;
 }
 
 QDF_STATUS
@@ -1048,6 +1253,7 @@ pkt_capture_vdev_create_notification(struct wlan_objmgr_vdev *vdev, void *arg)
 {
 	struct pkt_capture_mon_context *mon_ctx;
 	struct pkt_capture_vdev_priv *vdev_priv;
+	struct pkt_psoc_priv *psoc_priv;
 	QDF_STATUS status;
 
 	if ((wlan_vdev_mlme_get_opmode(vdev) != QDF_STA_MODE) ||
@@ -1068,6 +1274,9 @@ pkt_capture_vdev_create_notification(struct wlan_objmgr_vdev *vdev, void *arg)
 	}
 
 	vdev_priv->vdev = vdev;
+	psoc_priv = pkt_capture_psoc_get_priv(wlan_vdev_get_psoc(vdev));
+	if (psoc_priv)
+		vdev_priv->cfg_params.snaplen = psoc_priv->cfg_param.snaplen;
 	gp_pkt_capture_vdev = vdev;
 
 	status = pkt_capture_callback_ctx_create(vdev_priv);
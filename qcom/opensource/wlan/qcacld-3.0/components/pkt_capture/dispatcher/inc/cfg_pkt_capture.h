@@ -55,8 +55,36 @@
 			CFG_VALUE_OR_DEFAULT, \
 			"Value for packet capture mode")
 
+/*
+ * <ini>
+ * packet_capture_snaplen - Packet capture data frame snap length
+ * @Min: 0
+ * @Max: 2048
+ * Default: 0 - Capture full frames
+ *
+ * This ini is used to limit the number of bytes of each captured data
+ * frame, counted from the start of the 802.3 header, that are copied to
+ * the monitor interface. Only the snapped bytes are copied, which keeps
+ * the capture overhead low when only headers are of interest.
+ * Non-zero values lower than 128 are raised to 128.
+ *
+ * Supported Feature: packet capture
+ *
+ * Usage: External
+ *
+ * </ini>
+ */
+#define CFG_PKT_CAPTURE_SNAPLEN \
+			CFG_INI_UINT("packet_capture_snaplen", \
+			0, \
+			2048, \
+			0, \
+			CFG_VALUE_OR_DEFAULT, \
+			"Packet capture data frame snap length")
+
 #define CFG_PKT_CAPTURE_MODE_ALL \
-	CFG(CFG_PKT_CAPTURE_MODE)
+	CFG(CFG_PKT_CAPTURE_MODE) \
+	CFG(CFG_PKT_CAPTURE_SNAPLEN)
 #else
 #define CFG_PKT_CAPTURE_MODE_ALL
 #endif /* WLAN_FEATURE_PKT_CAPTURE */
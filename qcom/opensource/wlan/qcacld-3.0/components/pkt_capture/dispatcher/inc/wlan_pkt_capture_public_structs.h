@@ -254,4 +254,37 @@ struct pkt_capture_frame_filter {
 	uint32_t connected_beacon_interval;
 	uint8_t vendor_attr_to_set;
 };
+
+/**
+ * struct pkt_capture_match_filter - header match applied before data
+ * frames are copied to the monitor interface
+ * @enable: match filter is active
+ * @ether_type: ethertype to match (host order), 0 matches any
+ * @ip_proto: IPv4 protocol / IPv6 next header to match, 0 matches any
+ * @port: TCP/UDP source or destination port to match, 0 matches any
+ * @ipv4_addr: IPv4 source or destination address to match (network order)
+ * @ipv4_mask: mask applied to @ipv4_addr, 0 matches any
+ *
+ * A frame is captured only if every non-zero field matches.
+ */
+struct pkt_capture_match_filter {
+	bool enable;
+	uint16_t ether_type;
+	uint8_t ip_proto;
+	uint16_t port;
+	uint32_t ipv4_addr;
+	uint32_t ipv4_mask;
+};
+
+/**
+ * struct pkt_capture_filter_stats - data frame capture filter stats
+ * @matched: frames that passed the match filter and were captured
+ * @filtered: frames dropped by the match filter without being copied
+ * @snapped: captured frames truncated to the snap length
+ */
+struct pkt_capture_filter_stats {
+	uint32_t matched;
+	uint32_t filtered;
+	uint32_t snapped;
+};
 #endif /* _WLAN_PKT_CAPTURE_PUBLIC_STRUCTS_H_ */
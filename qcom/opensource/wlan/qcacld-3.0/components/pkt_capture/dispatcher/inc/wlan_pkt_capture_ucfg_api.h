@@ -297,6 +297,31 @@ QDF_STATUS
 ucfg_pkt_capture_set_filter(struct pkt_capture_frame_filter frame_filter,
 			    struct wlan_objmgr_vdev *vdev);
 
+/**
+ * ucfg_pkt_capture_set_match_filter() - ucfg API to set data frame match
+ * filter and snap length
+ * @vdev: pointer to vdev
+ * @filter: header match filter, applied before frames are copied
+ * @snaplen: bytes of each data frame captured, 0 for full frame
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS
+ucfg_pkt_capture_set_match_filter(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_match_filter *filter,
+				  uint32_t snaplen);
+
+/**
+ * ucfg_pkt_capture_get_filter_stats() - ucfg API to get match filter stats
+ * @vdev: pointer to vdev
+ * @stats: filled with the match filter stats
+ *
+ * Return: QDF_STATUS
+ */
+QDF_STATUS
+ucfg_pkt_capture_get_filter_stats(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_filter_stats *stats);
+
 #else
 static inline
 QDF_STATUS ucfg_pkt_capture_init(void)
@@ -446,5 +471,20 @@ ucfg_pkt_capture_set_filter(struct pkt_capture_frame_filter frame_filter,
 	return QDF_STATUS_SUCCESS;
 }
 
+static inline QDF_STATUS
+ucfg_pkt_capture_set_match_filter(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_match_filter *filter,
+				  uint32_t snaplen)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
+static inline QDF_STATUS
+ucfg_pkt_capture_get_filter_stats(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_filter_stats *stats)
+{
+	return QDF_STATUS_E_NOSUPPORT;
+}
+
 #endif /* WLAN_FEATURE_PKT_CAPTURE */
 #endif /* _WLAN_PKT_CAPTURE_UCFG_API_H_ */
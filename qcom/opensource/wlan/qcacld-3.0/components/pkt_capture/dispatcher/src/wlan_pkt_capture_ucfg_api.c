@@ -342,3 +342,18 @@ ucfg_pkt_capture_set_filter(struct pkt_capture_frame_filter frame_filter,
 {
 	return pkt_capture_set_filter(frame_filter, vdev);
 }
+
+QDF_STATUS
+ucfg_pkt_capture_set_match_filter(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_match_filter *filter,
+				  uint32_t snaplen)
+{
+	return pkt_capture_set_match_filter(vdev, filter, snaplen);
+}
+
+QDF_STATUS
+ucfg_pkt_capture_get_filter_stats(struct wlan_objmgr_vdev *vdev,
+				  struct pkt_capture_filter_stats *stats)
+{
+	return pkt_capture_get_filter_stats(vdev, stats);
+}
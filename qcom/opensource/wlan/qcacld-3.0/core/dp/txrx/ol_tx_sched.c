@@ -32,6 +32,8 @@
 #include <qdf_types.h>
 #include <qdf_mem.h>         /* qdf_os_mem_alloc_consistent et al */
 #include <cdp_txrx_handle.h>
+#include <htc_api.h>         /* htc_get_max_tx_bundle_msgs */
+#include <htt_types.h>       /* htt_pdev_t */
 #if defined(CONFIG_HL_SUPPORT)
 
 #if defined(DEBUG_HL_LOGGING)
@@ -67,6 +69,69 @@ struct ol_tx_sched_ctx {
 	int frms;
 };
 
+/**
+ * ol_tx_sched_bundle_bin() - histogram bin of a download bundle
+ * @num_msdus: number of frames in the bundle
+ *
+ * Return: index into ol_tx_sched_bundle_stats::hist
+ */
+static inline int ol_tx_sched_bundle_bin(int num_msdus)
+{
+	int bin = 0;
+
+	num_msdus--;
+	while (num_msdus && bin < OL_TX_SCHED_BUNDLE_HIST_BINS - 1) {
+		num_msdus >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+/**
+ * ol_tx_sched_send_bundle() - hand a bundle of frames to HTT
+ * @pdev: Pointer to the PDEV structure.
+ * @head_msdu: first frame of the bundle, frames are chained via next
+ * @num_msdus: number of frames in the bundle
+ *
+ * HTT passes the number of frames still to come in the batch to HTC as
+ * a more data hint, so HTC holds the frames of one bundle until the last
+ * of them is queued and then downloads them together.
+ *
+ * Return: none
+ */
+static void
+ol_tx_sched_send_bundle(struct ol_txrx_pdev_t *pdev,
+			qdf_nbuf_t head_msdu, int num_msdus)
+{
+	struct ol_tx_sched_bundle_stats *stats = &pdev->tx_sched.bundle_stats;
+
+	stats->bundles++;
+	stats->frames += num_msdus;
+	stats->hist[ol_tx_sched_bundle_bin(num_msdus)]++;
+
+	ol_tx_send_batch(pdev, head_msdu, num_msdus);
+}
+
+/**
+ * ol_tx_sched_bundle_stats_display() - display download bundle stats
+ * @pdev: Pointer to the PDEV structure.
+ *
+ * Return: none
+ */
+static void ol_tx_sched_bundle_stats_display(struct ol_txrx_pdev_t *pdev)
+{
+	struct ol_tx_sched_bundle_stats *stats = &pdev->tx_sched.bundle_stats;
+
+	txrx_nofl_info("Tx sched bundles: size %u bundles %u frames %u paced %u",
+		       pdev->tx_sched.bundle_size, stats->bundles,
+		       stats->frames, stats->paced);
+	txrx_nofl_info("  1: %u 2: %u 3-4: %u 5-8: %u 9-16: %u 17-32: %u >32: %u",
+		       stats->hist[0], stats->hist[1], stats->hist[2],
+		       stats->hist[3], stats->hist[4], stats->hist[5],
+		       stats->hist[6]);
+}
+
 typedef TAILQ_HEAD(ol_tx_frms_queue_list_s, ol_tx_frms_queue_t)
 	ol_tx_frms_queue_list;
 
@@ -443,6 +508,7 @@ ol_txrx_set_wmm_param(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
  */
 void ol_tx_sched_stats_display(struct ol_txrx_pdev_t *pdev)
 {
+	ol_tx_sched_bundle_stats_display(pdev);
 }
 
 /**
@@ -463,6 +529,8 @@ void ol_tx_sched_cur_state_display(struct ol_txrx_pdev_t *pdev)
  */
 void ol_tx_sched_stats_clear(struct ol_txrx_pdev_t *pdev)
 {
+	qdf_mem_zero(&pdev->tx_sched.bundle_stats,
+		     sizeof(pdev->tx_sched.bundle_stats));
 }
 
 #endif /* OL_TX_SCHED == OL_TX_SCHED_RR */
@@ -1182,6 +1250,7 @@ ol_txrx_set_wmm_param(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 void ol_tx_sched_stats_display(struct ol_txrx_pdev_t *pdev)
 {
 	OL_TX_SCHED_WRR_ADV_CAT_STAT_DUMP(pdev->tx_sched.scheduler);
+	ol_tx_sched_bundle_stats_display(pdev);
 }
 
 /**
@@ -1204,6 +1273,8 @@ void ol_tx_sched_cur_state_display(struct ol_txrx_pdev_t *pdev)
 void ol_tx_sched_stats_clear(struct ol_txrx_pdev_t *pdev)
 {
 	OL_TX_SCHED_WRR_ADV_CAT_STAT_CLEAR(pdev->tx_sched.scheduler);
+	qdf_mem_zero(&pdev->tx_sched.bundle_stats,
+		     sizeof(pdev->tx_sched.bundle_stats));
 }
 
 #endif /* OL_TX_SCHED == OL_TX_SCHED_WRR_ADV */
@@ -1362,6 +1433,8 @@ ol_tx_sched_dispatch(
 	u_int16_t *msdu_id_storage;
 	u_int16_t msdu_id;
 	int num_msdus = 0;
+	int bundle_size = pdev->tx_sched.bundle_size;
+	void *txq = NULL;
 
 	TX_SCHED_DEBUG_PRINT("Enter");
 	while (sctx->frms) {
@@ -1375,6 +1448,22 @@ ol_tx_sched_dispatch(
 		}
 		msdu = tx_desc->netbuf;
 		TAILQ_REMOVE(&sctx->head, tx_desc, tx_desc_list_elem);
+
+		/*
+		 * Frames are dequeued one tx queue (peer-TID) at a time.
+		 * Close the current bundle when the tx queue changes or the
+		 * bundle is as large as the HTC bundle, so each download
+		 * carries frames of a single TID.
+		 */
+		if (head_msdu &&
+		    (tx_desc->txq != txq || num_msdus >= bundle_size)) {
+			ol_tx_sched_send_bundle(pdev, head_msdu, num_msdus);
+			prev = NULL;
+			head_msdu = NULL;
+			num_msdus = 0;
+		}
+		txq = tx_desc->txq;
+
 		if (!head_msdu)
 			head_msdu = msdu;
 
@@ -1418,7 +1507,8 @@ ol_tx_sched_dispatch(
 			 * then resume handling the remaining frames.
 			 */
 			if (head_msdu)
-				ol_tx_send_batch(pdev, head_msdu, num_msdus);
+				ol_tx_sched_send_bundle(pdev, head_msdu,
+							num_msdus);
 
 			prev = NULL;
 			head_msdu = prev;
@@ -1438,7 +1528,7 @@ ol_tx_sched_dispatch(
 
 	/*Send Batch Of Frames*/
 	if (head_msdu)
-		ol_tx_send_batch(pdev, head_msdu, num_msdus);
+		ol_tx_sched_send_bundle(pdev, head_msdu, num_msdus);
 	TX_SCHED_DEBUG_PRINT("Leave");
 }
 
@@ -1510,6 +1600,10 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 	TAILQ_INIT(&sctx.head);
 	sctx.frms = 0;
 
+	if (qdf_unlikely(!pdev->tx_sched.bundle_size))
+		pdev->tx_sched.bundle_size =
+			htc_get_max_tx_bundle_msgs(pdev->htt_pdev->htc_pdev);
+
 	ol_tx_sched_select_init(pdev);
 	while (qdf_atomic_read(&pdev->target_tx_credit) > 0) {
 		int num_credits;
@@ -1540,6 +1634,20 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 
 		if (num_credits == 0)
 			break;
+
+		/*
+		 * Credit-aware pacing: once at least one full bundle has been
+		 * selected, don't spend the leftover credit on a runt bundle.
+		 * The frames being dispatched now return credit on completion,
+		 * which reschedules the remaining frames in fuller bundles.
+		 */
+		if (pdev->tx_sched.bundle_size > 1 &&
+		    sctx.frms >= pdev->tx_sched.bundle_size &&
+		    qdf_atomic_read(&pdev->target_tx_credit) <
+		    pdev->tx_sched.bundle_size) {
+			pdev->tx_sched.bundle_stats.paced++;
+			break;
+		}
 	}
 	ol_tx_sched_dispatch(pdev, &sctx);
 
@@ -1559,6 +1667,7 @@ ol_tx_sched_attach(
 	struct ol_txrx_pdev_t *pdev)
 {
 	pdev->tx_sched.tx_sched_status = ol_tx_scheduler_idle;
+	pdev->tx_sched.bundle_size = 0;
 	return ol_tx_sched_init(pdev);
 }
 
@@ -391,6 +391,26 @@ struct ol_mac_addr {
 
 struct ol_tx_sched_t;
 
+/*
+ * Bundle size histogram bins used by the HL tx scheduler:
+ * 1, 2, 3-4, 5-8, 9-16, 17-32, >32 frames per download bundle.
+ */
+#define OL_TX_SCHED_BUNDLE_HIST_BINS 7
+
+/**
+ * struct ol_tx_sched_bundle_stats - HL tx scheduler download bundle stats
+ * @bundles: number of bundles handed to HTT
+ * @frames: number of frames sent in those bundles
+ * @paced: scheduler runs that held back a partial bundle to wait for credit
+ * @hist: bundle size distribution, see OL_TX_SCHED_BUNDLE_HIST_BINS
+ */
+struct ol_tx_sched_bundle_stats {
+	uint32_t bundles;
+	uint32_t frames;
+	uint32_t paced;
+	uint32_t hist[OL_TX_SCHED_BUNDLE_HIST_BINS];
+};
+
 #ifndef ol_txrx_local_peer_id_t
 #define ol_txrx_local_peer_id_t uint8_t /* default */
 #endif
@@ -938,6 +958,8 @@ struct ol_txrx_pdev_t {
 	struct {
 		enum ol_tx_scheduler_status tx_sched_status;
 		struct ol_tx_sched_t *scheduler;
+		uint8_t bundle_size;
+		struct ol_tx_sched_bundle_stats bundle_stats;
 	} tx_sched;
 	/*
 	 * tx_queue only applies for HL, but is defined unconditionally to avoid
@@ -9828,6 +9828,11 @@ static void hdd_set_wlm_host_latency_level(struct hdd_context *hdd_ctx,
 	else
 		wlan_hdd_set_pm_qos_request(hdd_ctx, false);
 
+	cdp_soc_set_param(soc_hdl, DP_SOC_PARAM_RX_INTR_PROFILE,
+			  hdd_ctx->pm_qos_request_flags ?
+			  CDP_RX_INTR_PROFILE_LOW_LATENCY :
+			  CDP_RX_INTR_PROFILE_STATIC);
+
 	if (latency_host_flags & WLM_HOST_HBB_FLAG)
 		ucfg_dp_set_high_bus_bw_request(hdd_ctx->psoc,
 						adapter->vdev_id, true);